@@ -61,6 +61,7 @@ let notSyncServerSources: [String] = [
     "realm/array_unsigned.cpp",
     "realm/backup_restore.cpp",
     "realm/bplustree.cpp",
+    "realm/change_journal.cpp",
     "realm/chunked_binary.cpp",
     "realm/cluster.cpp",
     "realm/cluster_tree.cpp",
@@ -79,6 +80,9 @@ let notSyncServerSources: [String] = [
     "realm/group_writer.cpp",
     "realm/history.cpp",
     "realm/impl",
+    "realm/index_compound.cpp",
+    "realm/index_geo.cpp",
+    "realm/index_sorted.cpp",
     "realm/index_string.cpp",
     "realm/link_translator.cpp",
     "realm/list.cpp",
@@ -111,6 +115,7 @@ let notSyncServerSources: [String] = [
     "realm/sync/network/http.cpp",
     "realm/sync/network/network.cpp",
     "realm/sync/network/network_ssl.cpp",
+    "realm/sync/network/service_pool.cpp",
     "realm/sync/network/websocket.cpp",
     "realm/sync/noinst/changeset_index.cpp",
     "realm/sync/noinst/client_history_impl.cpp",
@@ -119,6 +124,7 @@ let notSyncServerSources: [String] = [
     "realm/sync/noinst/client_reset_operation.cpp",
     "realm/sync/noinst/client_reset_recovery.cpp",
     "realm/sync/noinst/compact_changesets.cpp",
+    "realm/sync/noinst/integration_worker_pool.cpp",
     "realm/sync/noinst/migration_store.cpp",
     "realm/sync/noinst/pending_bootstrap_store.cpp",
     "realm/sync/noinst/protocol_codec.cpp",
@@ -130,6 +136,7 @@ let notSyncServerSources: [String] = [
     "realm/sync/transform.cpp",
     "realm/table.cpp",
     "realm/table_ref.cpp",
+    "realm/table_statistics.cpp",
     "realm/table_view.cpp",
     "realm/tokenizer.cpp",
     "realm/to_json.cpp",
@@ -139,6 +146,7 @@ let notSyncServerSources: [String] = [
     "realm/utilities.cpp",
     "realm/uuid.cpp",
     "realm/version.cpp",
+    "realm/zone_map.cpp",
 ] + syncExcludes
 
 let bidExcludes: [String] = [
@@ -89,7 +89,9 @@ typedef struct realm_dictionary realm_dictionary_t;
 
 /* Query types */
 typedef struct realm_query realm_query_t;
+typedef struct realm_prepared_query realm_prepared_query_t;
 typedef struct realm_results realm_results_t;
+typedef struct realm_group_by_result realm_group_by_result_t;
 
 /* Config types */
 typedef struct realm_config realm_config_t;
@@ -362,6 +364,11 @@ typedef struct realm_websocket_endpoint {
     bool is_ssl;            // true if SSL should be used
 } realm_websocket_endpoint_t;
 
+typedef struct realm_sync_socket_buffer {
+    const char* data; // Message data
+    size_t size;      // Number of bytes in the message
+} realm_sync_socket_buffer_t;
+
 // The following definitions are intended for internal state and structures
 // used by the Sync Client. These values should be retained by the Platform
 // Networking CAPI implementation so they can be provided back to the Platform
@@ -422,6 +429,15 @@ typedef void (*realm_sync_socket_websocket_async_write_func_t)(realm_userdata_t
                                                                const char* data, size_t size,
                                                                realm_sync_socket_write_callback_t* write_callback);
 
+// Optional. Called by a connection in the Sync Client instead of the async_write function when it has
+// several messages to send to the server at once. Each buffer must be sent as a separate binary websocket
+// message, in the order given, and the write_callback is used once with realm_sync_socket_write_complete()
+// after all of them have been transferred, or with the first error that occurs. The buffers remain valid
+// until the write_callback is called.
+typedef void (*realm_sync_socket_websocket_async_write_batch_func_t)(
+    realm_userdata_t userdata, realm_sync_socket_websocket_t websocket, const realm_sync_socket_buffer_t* buffers,
+    size_t num_buffers, realm_sync_socket_write_callback_t* write_callback);
+
 // Called when the websocket has been destroyed in the Sync Client - no more write callbacks or observer
 // functions should be called when this function is called.
 typedef void (*realm_sync_socket_websocket_free_func_t)(realm_userdata_t userdata,
@@ -838,6 +854,22 @@ RLM_API bool realm_config_get_automatic_change_notifications(const realm_config_
  */
 RLM_API void realm_config_set_automatic_change_notifications(realm_config_t*, bool);
 
+/**
+ * True if the notifications for a write are delivered before the commit returns.
+ *
+ * This function cannot fail.
+ */
+RLM_API bool realm_config_get_deliver_notifications_on_commit(const realm_config_t*);
+
+/**
+ * Run the notifiers and deliver the notifications for the changes made by a
+ * write on the committing thread before realm_commit() returns, rather than
+ * after the background notifier thread has run them (default: false).
+ *
+ * This function cannot fail.
+ */
+RLM_API void realm_config_set_deliver_notifications_on_commit(realm_config_t*, bool);
+
 /**
  * The scheduler which this realm should be bound to (default: NULL).
  *
@@ -925,6 +957,12 @@ RLM_API bool realm_config_get_cached(realm_config_t*) RLM_API_NOEXCEPT;
  */
 RLM_API void realm_config_set_automatic_backlink_handling(realm_config_t*, bool) RLM_API_NOEXCEPT;
 
+/**
+ * Store a fingerprint of the schema in the file, so that opening it again with an unchanged schema skips
+ * validating the schema and comparing it to the one in the file.
+ */
+RLM_API void realm_config_set_cache_schema_fingerprint(realm_config_t*, bool) RLM_API_NOEXCEPT;
+
 /**
  * Create a custom scheduler object from callback functions.
  *
@@ -1483,6 +1521,50 @@ RLM_API bool realm_get_num_objects(const realm_t*, realm_class_key_t, size_t* ou
  */
 RLM_API bool realm_get_num_versions(const realm_t*, uint64_t* out_versions_count);
 
+/**
+ * Metrics of the storage engine. The counters are cumulative since the file
+ * was opened by this process, unless noted otherwise. Durations are in
+ * nanoseconds.
+ */
+typedef struct realm_storage_metrics {
+    uint64_t commits;
+    uint64_t bytes_written;
+    uint64_t last_commit_bytes_written;
+    uint64_t write_group_time;
+    uint64_t free_list_time;
+    uint64_t sync_time;
+    uint64_t max_commit_time;
+    uint64_t write_lock_acquisitions;
+    uint64_t write_lock_wait_time;
+    uint64_t write_lock_max_wait_time;
+    uint64_t local_read_lock_acquisitions;
+    uint64_t lock_file_read_lock_acquisitions;
+    /* The current number of live versions and of entries in the version list */
+    uint64_t live_versions;
+    uint64_t version_list_capacity;
+    /* The current memory mappings of the file */
+    uint64_t num_mappings;
+    uint64_t mapped_size;
+    uint64_t num_old_mappings;
+    uint64_t old_mapped_size;
+    /* Process-wide */
+    uint64_t total_slab_size;
+    uint64_t decrypted_pages;
+    uint64_t decryption_page_faults;
+} realm_storage_metrics_t;
+
+/**
+ * Get the metrics of the storage engine for the Realm file.
+ *
+ * The counters are cheap enough to always be maintained, so this can be
+ * called periodically in production.
+ *
+ * @param out_metrics A pointer to the struct that will contain the metrics,
+ *                    if successful.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_get_storage_metrics(const realm_t*, realm_storage_metrics_t* out_metrics);
+
 /**
  * Get an object with a particular object key.
  *
@@ -1527,6 +1609,31 @@ RLM_API realm_results_t* realm_object_find_all(const realm_t*, realm_class_key_t
  */
 RLM_API realm_object_t* realm_object_create(realm_t*, realm_class_key_t);
 
+/**
+ * Create several objects in a class without a primary key, setting the values
+ * of some of their properties.
+ *
+ * This is equivalent to calling `realm_object_create()` and
+ * `realm_set_values()` for each object, but all values are validated first and
+ * the objects are written together, in whole clusters where possible.
+ * Properties not given get their default values.
+ *
+ * @param num_objects The number of objects to create.
+ * @param num_properties The number of elements in @a properties.
+ * @param properties The keys of the properties to set. Collection properties
+ *                   are not supported, and each property may only be given
+ *                   once.
+ * @param values The values of the properties, column by column: the value of
+ *               property `p` for object `i` is `values[p * num_objects + i]`.
+ * @param out_keys If non-NULL, receives the keys of the created objects. It
+ *                 must have room for @a num_objects elements.
+ * @return True if no exception occurred. No objects are created if a value
+ *         cannot be assigned to its property.
+ */
+RLM_API bool realm_object_create_many(realm_t*, realm_class_key_t, size_t num_objects, size_t num_properties,
+                                      const realm_property_key_t* properties, const realm_value_t* values,
+                                      realm_object_key_t* out_keys);
+
 /**
  * Create an object in a class with a primary key. Will not succeed if an
  * object with the given primary key value already exists.
@@ -1838,6 +1945,18 @@ RLM_API bool realm_list_set(realm_list_t*, size_t index, realm_value_t value);
  */
 RLM_API bool realm_list_insert(realm_list_t*, size_t index, realm_value_t value);
 
+/**
+ * Insert @a num_values values starting at @a index.
+ *
+ * Inserting at the end of the list is faster than inserting the values one at
+ * a time.
+ *
+ * @param values The values to insert.
+ * @param num_values The number of values in @a values.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_list_insert_many(realm_list_t*, size_t index, const realm_value_t* values, size_t num_values);
+
 /**
  * Insert a collection inside a list (only available for mixed types)
  *
@@ -2201,6 +2320,20 @@ RLM_API bool realm_set_find(const realm_set_t*, realm_value_t value, size_t* out
  */
 RLM_API bool realm_set_insert(realm_set_t*, realm_value_t value, size_t* out_index, bool* out_inserted);
 
+/**
+ * Insert several elements in a set.
+ *
+ * Elements already in the set are skipped.
+ *
+ * @param values The values to insert.
+ * @param num_values The number of values in @a values.
+ * @param out_num_inserted If non-null, will be set to the number of elements
+ *                         which did not already exist in the set.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_set_insert_many(realm_set_t*, const realm_value_t* values, size_t num_values,
+                                   size_t* out_num_inserted);
+
 /**
  * Erase an element from a set.
  *
@@ -2352,6 +2485,21 @@ RLM_API bool realm_dictionary_get(const realm_dictionary_t*, size_t index, realm
 RLM_API bool realm_dictionary_insert(realm_dictionary_t*, realm_value_t key, realm_value_t value, size_t* out_index,
                                      bool* out_inserted);
 
+/**
+ * Insert or update several elements in a dictionary.
+ *
+ * If a key occurs more than once, the last value given for it is stored.
+ *
+ * @param keys The lookup keys.
+ * @param values The values to insert, one for each key.
+ * @param num_values The number of keys and values.
+ * @param out_num_inserted If non-null, will be set to the number of keys which
+ *                         did not already exist.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_dictionary_insert_many(realm_dictionary_t*, const realm_value_t* keys, const realm_value_t* values,
+                                          size_t num_values, size_t* out_num_inserted);
+
 /**
  * Insert an embedded object.
  *
@@ -2468,6 +2616,45 @@ RLM_API realm_dictionary_t* realm_dictionary_from_thread_safe_reference(const re
 RLM_API realm_query_t* realm_query_parse(const realm_t*, realm_class_key_t target_table, const char* query_string,
                                          size_t num_args, const realm_query_arg_t* args);
 
+/**
+ * Parse a query string once, so that it can be run many times with different
+ * argument values without being parsed again.
+ *
+ * The arguments given here are only used to check that the query is valid;
+ * new values are given to `realm_query_bind_and_run()`. If the query failed to
+ * parse, the parser error is available from `realm_get_last_error()`.
+ *
+ * Queries which use arguments for key paths (`$K0`), list indexes or
+ * coordinates are parsed again on each run, as their structure depends on the
+ * argument values.
+ *
+ * @param target_table The table on which to run this query.
+ * @param query_string A zero-terminated string in the Realm Query Language,
+ *                     optionally containing argument placeholders (`$0`, `$1`,
+ *                     etc.).
+ * @param num_args The number of arguments for this query.
+ * @param args A pointer to a list of argument values.
+ * @return A non-null pointer if the query was successfully parsed and no
+ *         exception occurred.
+ */
+RLM_API realm_prepared_query_t* realm_query_prepare(const realm_t*, realm_class_key_t target_table,
+                                                    const char* query_string, size_t num_args,
+                                                    const realm_query_arg_t* args);
+
+/**
+ * Bind new argument values to a prepared query and find all objects matching
+ * it in the current version of the Realm.
+ *
+ * This may be called from any thread which may use the Realm the query was
+ * prepared for.
+ *
+ * @param num_args The number of arguments for this query.
+ * @param args A pointer to a list of argument values.
+ * @return A non-null pointer if no exception occurred.
+ */
+RLM_API realm_results_t* realm_query_bind_and_run(const realm_prepared_query_t*, size_t num_args,
+                                                  const realm_query_arg_t* args);
+
 
 /**
  * Get textual representation of query
@@ -2476,6 +2663,17 @@ RLM_API realm_query_t* realm_query_parse(const realm_t*, realm_class_key_t targe
  */
 RLM_API const char* realm_query_get_description(realm_query_t*);
 
+/**
+ * Count the objects matching the query, and describe how the query was evaluated: the strategy that was used,
+ * and how many rows each of the top level conditions visited and matched.
+ *
+ * This is meant for diagnosing slow queries. The sort, distinct and limit clauses of the query are not applied.
+ *
+ * @return a string containing the explanation, or null if an error occurred. The string memory is managed by the
+ *         query object.
+ */
+RLM_API const char* realm_query_explain_analyze(realm_query_t*);
+
 
 /**
  * Parse a query string and append it to an existing query via logical &&.
@@ -2677,6 +2875,41 @@ RLM_API realm_results_t* realm_results_limit(realm_results_t* results, size_t ma
  */
 RLM_API bool realm_results_get(realm_results_t*, size_t index, realm_value_t* out_value);
 
+/**
+ * Get the elements at [start, start + count) in the results.
+ *
+ * This is equivalent to calling `realm_results_get()` for each index, but
+ * checks the results and brings them up to date only once, and then reads the
+ * elements in order.
+ *
+ * @param out_values Where to write the elements. It must have room for @a count
+ *                   elements. May be NULL.
+ * @return True if no exception occurred (including out-of-bounds).
+ */
+RLM_API bool realm_results_get_range(realm_results_t*, size_t start, size_t count, realm_value_t* out_values);
+
+/**
+ * Get the values of several properties for the objects at [begin, end) in the
+ * results, which must be results of objects.
+ *
+ * This is equivalent to calling `realm_get_values()` on each object, but reads
+ * the objects one cluster at a time instead of looking up each object.
+ *
+ * @param begin The index of the first object to read.
+ * @param end One past the index of the last object to read.
+ * @param num_properties The number of elements in @a properties.
+ * @param properties The keys of the properties to read. Collection properties
+ *                   are not supported.
+ * @param out_values Where to write the values. It must have room for
+ *                   `num_properties * (end - begin)` elements, and is filled
+ *                   column by column: the value of property `p` for the
+ *                   object at `begin + i` is written to
+ *                   `out_values[p * (end - begin) + i]`. May be NULL.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_results_get_values(realm_results_t*, size_t begin, size_t end, size_t num_properties,
+                                      const realm_property_key_t* properties, realm_value_t* out_values);
+
 /**
  * Returns an instance of realm_list at the index passed as argument.
  * @return A valid ptr to a list instance or nullptr in case of errors
@@ -2715,6 +2948,21 @@ RLM_API bool realm_results_find(realm_results_t*, realm_value_t* value, size_t*
  */
 RLM_API realm_object_t* realm_results_get_object(realm_results_t*, size_t index);
 
+/**
+ * Get the objects at [start, start + count) in the results, which must be
+ * results of objects.
+ *
+ * This is equivalent to calling `realm_results_get_object()` for each index,
+ * but checks the results and brings them up to date only once, and then reads
+ * the objects in order.
+ *
+ * @param out_objects Where to write the objects. It must have room for @a count
+ *                    elements. Each object written must be released with
+ *                    `realm_release()`. Nothing is written if an error occurs.
+ * @return True if no exception occurred (including out-of-bounds).
+ */
+RLM_API bool realm_results_get_objects(realm_results_t*, size_t start, size_t count, realm_object_t** out_objects);
+
 /**
  * Return the query associated to the results passed as argument.
  *
@@ -2798,6 +3046,54 @@ RLM_API bool realm_results_sum(realm_results_t*, realm_property_key_t, realm_val
 RLM_API bool realm_results_average(realm_results_t*, realm_property_key_t, realm_value_t* out_average,
                                    bool* out_found);
 
+typedef enum realm_aggregate_type {
+    RLM_AGGREGATE_SUM,
+    RLM_AGGREGATE_MIN,
+    RLM_AGGREGATE_MAX,
+    RLM_AGGREGATE_AVERAGE,
+} realm_aggregate_type_e;
+
+typedef struct realm_aggregate {
+    realm_aggregate_type_e type;
+    realm_property_key_t property;
+} realm_aggregate_t;
+
+/**
+ * Group the objects in the results by the value of a property, and compute the given aggregates for each group in a
+ * single pass over the objects.
+ *
+ * The property cannot be a collection, nor of type Mixed or Decimal128. Sorting the results does not change the
+ * groups, but distinct and limit do.
+ *
+ * @param group_property The property to group by.
+ * @param aggregates The aggregates to compute for each group.
+ * @param num_aggregates The number of elements in @a aggregates.
+ * @return A non-null pointer if no exception occurred. Must be released with realm_release().
+ */
+RLM_API realm_group_by_result_t* realm_results_group_by(realm_results_t*, realm_property_key_t group_property,
+                                                        const realm_aggregate_t* aggregates, size_t num_aggregates);
+
+/**
+ * Get the number of groups in the result of realm_results_group_by().
+ */
+RLM_API size_t realm_group_by_result_size(const realm_group_by_result_t*);
+
+/**
+ * Get a group in the result of realm_results_group_by(). The groups are in the order of the first object of each
+ * group in the results. Strings and binary values point into the Realm, so they are only valid until the Realm is
+ * refreshed or written to.
+ *
+ * @param index The index of the group.
+ * @param out_key Where to write the value of the grouping property shared by the objects of the group.
+ * @param out_count Where to write the number of objects in the group.
+ * @param out_values Where to write the value of each aggregate, in the order they were requested. Must have room for
+ *                   as many values as there were aggregates. As for realm_results_sum() and the like, sums of no
+ *                   values are zero and the others are null.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_group_by_result_get(const realm_group_by_result_t*, size_t index, realm_value_t* out_key,
+                                       size_t* out_count, realm_value_t* out_values);
+
 RLM_API realm_notification_token_t* realm_results_add_notification_callback(realm_results_t*,
                                                                             realm_userdata_t userdata,
                                                                             realm_free_userdata_func_t userdata_free,
@@ -3765,6 +4061,8 @@ RLM_API void realm_sync_client_config_set_max_resumption_delay_interval(realm_sy
                                                                         uint64_t) RLM_API_NOEXCEPT;
 RLM_API void realm_sync_client_config_set_resumption_delay_backoff_multiplier(realm_sync_client_config_t*,
                                                                               int) RLM_API_NOEXCEPT;
+RLM_API void realm_sync_client_config_set_max_batched_messages(realm_sync_client_config_t*,
+                                                               size_t) RLM_API_NOEXCEPT;
 RLM_API void realm_sync_client_config_set_sync_socket(realm_sync_client_config_t*,
                                                       realm_sync_socket_t*) RLM_API_NOEXCEPT;
 RLM_API void realm_sync_client_config_set_default_binding_thread_observer(
@@ -4398,6 +4696,16 @@ RLM_API realm_sync_socket_t* realm_sync_socket_new(
     realm_sync_socket_websocket_async_write_func_t websocket_write_func,
     realm_sync_socket_websocket_free_func_t websocket_free_func);
 
+/**
+ * Set the function that sends several messages over a websocket at once. If this is not set, the sync client
+ * sends the messages of a batch one at a time using the websocket_write_func passed to realm_sync_socket_new().
+ * Batches are only formed when realm_sync_client_config_set_max_batched_messages() is used.
+ * @param sync_socket the sync socket instance returned by realm_sync_socket_new().
+ * @param websocket_write_batch_func function that will be called when the sync client sends several messages.
+ */
+RLM_API void realm_sync_socket_set_websocket_async_write_batch(
+    realm_sync_socket_t* sync_socket, realm_sync_socket_websocket_async_write_batch_func_t websocket_write_batch_func);
+
 /**
  * To be called to execute the callback handler provided to the create_timer_func when the timer is
  * complete or an error occurs while processing the timer.
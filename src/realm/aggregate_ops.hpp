@@ -178,6 +178,18 @@ public:
         return false;
     }
 
+    // Add the sum of `count` values which have already been filtered with valid_for_agg()
+    void accumulate_bulk(ResultType sum, size_t count)
+    {
+        if constexpr (std::is_integral_v<ResultType> && std::is_signed_v<ResultType>) {
+            m_result = std::make_unsigned_t<ResultType>(m_result) + std::make_unsigned_t<ResultType>(sum);
+        }
+        else {
+            m_result += sum;
+        }
+        m_count += count;
+    }
+
     bool is_null() const
     {
         return false;
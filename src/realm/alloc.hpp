@@ -22,6 +22,9 @@
 #include <cstdint>
 #include <cstddef>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <realm/util/features.h>
 #include <realm/util/terminate.hpp>
@@ -322,6 +325,18 @@ protected:
 private:
     bool m_is_read_only = false; // prevent any alloc or free operations
 
+    // Decompressed copies of the compressed blobs read through this allocator
+    // (see ArrayBlob). They are released when the storage or instance version
+    // changes, as the refs they are looked up by may then have been reused.
+    struct DecompressedBlobs {
+        std::mutex mutex;
+        uint_fast64_t storage_version = 0;
+        uint_fast64_t instance_version = 0;
+        std::unordered_map<ref_type, std::unique_ptr<char[]>> blobs;
+    };
+    DecompressedBlobs m_decompressed_blobs;
+
+    friend class ArrayBlob;
     friend class Table;
     friend class ClusterTree;
     friend class Group;
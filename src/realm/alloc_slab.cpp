@@ -40,6 +40,7 @@
 #include <realm/util/terminate.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/util/scope_exit.hpp>
+#include <realm/util/sha_crypto.hpp>
 #include <realm/array.hpp>
 #include <realm/alloc_slab.hpp>
 #include <realm/group.hpp>
@@ -107,7 +108,7 @@ void SlabAlloc::init_streaming_header(Header* streaming_header, int file_format_
     };
 }
 
-inline SlabAlloc::Slab::Slab(ref_type r, size_t s)
+inline SlabAlloc::Slab::Slab(ref_type r, size_t s, bool huge_pages)
     : ref_end(r)
     , size(s)
 {
@@ -115,7 +116,16 @@ inline SlabAlloc::Slab::Slab(ref_type r, size_t s)
     static_assert(__STDCPP_DEFAULT_NEW_ALIGNMENT__ >= 8);
 
     total_slab_allocated.fetch_add(s, std::memory_order_relaxed);
-    addr = new char[size];
+    if (huge_pages && size >= huge_page_size) {
+        // Anonymous mappings are page aligned, which lets the kernel back
+        // them with huge pages
+        addr = static_cast<char*>(util::mmap_anon(size)); // Throws
+        mapped = true;
+        util::advise_huge_pages(addr, size);
+    }
+    else {
+        addr = new char[size];
+    }
     REALM_ASSERT((reinterpret_cast<size_t>(addr) & 0x7ULL) == 0);
 #if REALM_ENABLE_ALLOC_SET_ZERO
     std::fill(addr, addr + size, 0);
@@ -125,8 +135,19 @@ inline SlabAlloc::Slab::Slab(ref_type r, size_t s)
 SlabAlloc::Slab::~Slab()
 {
     total_slab_allocated.fetch_sub(size, std::memory_order_relaxed);
-    if (addr)
+    if (!addr)
+        return;
+    if (mapped) {
+        try {
+            util::munmap(addr, size);
+        }
+        catch (...) {
+            // Nothing more can be done about it here
+        }
+    }
+    else {
         delete[] addr;
+    }
 }
 
 void SlabAlloc::detach(bool keep_file_open) noexcept
@@ -168,6 +189,8 @@ void SlabAlloc::detach(bool keep_file_open) noexcept
     m_realm_file_info = nullptr;
 #endif
 
+    // Refs translated before this are not valid after reattaching
+    m_mapping_version++;
     m_attach_mode = attach_None;
 }
 
@@ -180,6 +203,7 @@ SlabAlloc::~SlabAlloc() noexcept
         if (m_attach_mode != attach_SharedFile) {
             // No point inchecking if free space info is invalid
             if (m_free_space_state != free_space_Invalid) {
+                release_small_blocks();
                 if (REALM_COVER_NEVER(!is_all_free())) {
                     print();
 #ifndef REALM_SLAB_ALLOC_DEBUG
@@ -217,6 +241,7 @@ MemRef SlabAlloc::do_alloc(size_t size)
 
     m_free_space_state = free_space_Dirty;
     m_commit_size += size;
+    ++m_counters.allocs;
 
     // minimal allocation is sizeof(FreeListEntry)
     if (size < sizeof(FreeBlock))
@@ -225,8 +250,16 @@ MemRef SlabAlloc::do_alloc(size_t size)
     if (size & 0x7)
         size = (size + 7) & ~0x7;
 
-    FreeBlock* entry = allocate_block(static_cast<int>(size));
-    mark_allocated(entry);
+    FreeBlock* entry = nullptr;
+    int size_class = get_small_block_class(size);
+    if (size_class >= 0) {
+        size = size_t(min_small_block) << size_class;
+        entry = pop_small_block(size_class);
+    }
+    if (!entry) {
+        entry = allocate_block(static_cast<int>(size));
+        mark_allocated(entry);
+    }
     ref_type ref = entry->ref;
 
 #ifdef REALM_DEBUG
@@ -380,6 +413,11 @@ SlabAlloc::FreeBlock* SlabAlloc::allocate_block(int size)
     if (list.found_something()) {
         block = pop_freelist_entry(list);
     }
+    else if (m_small_block_bytes > 0) {
+        // Merge the blocks kept for reuse before resorting to a new slab
+        release_small_blocks();
+        return allocate_block(size);
+    }
     else {
         block = grow_slab(size);
     }
@@ -408,6 +446,67 @@ SlabAlloc::FreeBlock* SlabAlloc::slab_to_entry(const Slab& slab, ref_type ref_st
 void SlabAlloc::clear_freelists()
 {
     m_block_map.clear();
+    for (auto& list : m_small_blocks)
+        list = {};
+    m_small_block_bytes = 0;
+}
+
+SlabAlloc::FreeBlock* SlabAlloc::pop_small_block(int size_class) noexcept
+{
+    auto& list = m_small_blocks[size_class];
+    FreeBlock* entry = list.head;
+    if (!entry)
+        return nullptr;
+    list.head = entry->next;
+    list.bytes -= min_small_block << size_class;
+    m_small_block_bytes -= min_small_block << size_class;
+    entry->clear_links();
+    ++m_counters.small_block_hits;
+    return entry;
+}
+
+bool SlabAlloc::push_small_block(int size_class, ref_type ref, FreeBlock* entry) noexcept
+{
+    int size = min_small_block << size_class;
+    auto& list = m_small_blocks[size_class];
+    if (list.bytes + size > max_small_block_cache)
+        return false;
+    REALM_ASSERT_DEBUG(-bb_before(entry)->block_after_size >= size);
+    entry->ref = ref;
+    entry->prev = nullptr;
+    entry->next = list.head;
+    list.head = entry;
+    list.bytes += size;
+    m_small_block_bytes += size;
+    ++m_counters.small_block_parks;
+    return true;
+}
+
+void SlabAlloc::release_small_blocks() noexcept
+{
+    for (int size_class = 0; size_class < num_small_block_classes; ++size_class) {
+        auto& list = m_small_blocks[size_class];
+        FreeBlock* entry = list.head;
+        while (entry) {
+            FreeBlock* next = entry->next;
+            mark_freed(entry, min_small_block << size_class);
+            free_block(entry->ref, entry);
+            entry = next;
+        }
+        list = {};
+    }
+    m_small_block_bytes = 0;
+}
+
+std::vector<ref_type> SlabAlloc::get_small_block_refs() const
+{
+    std::vector<ref_type> refs;
+    for (auto& list : m_small_blocks) {
+        for (FreeBlock* entry = list.head; entry; entry = entry->next)
+            refs.push_back(entry->ref);
+    }
+    std::sort(refs.begin(), refs.end());
+    return refs;
 }
 
 void SlabAlloc::rebuild_freelists_from_slab()
@@ -490,9 +589,10 @@ SlabAlloc::FreeBlock* SlabAlloc::grow_slab(int size)
 
     REALM_ASSERT(matches_section_boundary(ref));
 
+    ++m_counters.slab_grows;
     std::lock_guard<std::mutex> lock(m_mapping_mutex);
     // Create new slab and add to list of slabs
-    m_slabs.emplace_back(ref_end, new_size); // Throws
+    m_slabs.emplace_back(ref_end, new_size, m_cfg.huge_pages); // Throws
     const Slab& slab = m_slabs.back();
     extend_fast_mapping_with_slab(slab.addr);
 
@@ -571,6 +671,7 @@ void SlabAlloc::do_free(ref_type ref, char* addr)
     }
     else {
         m_commit_size -= size;
+        ++m_counters.frees;
 
         // fixup size to take into account the allocator's need to store a FreeBlock in a freed block
         if (size < sizeof(FreeBlock))
@@ -580,6 +681,13 @@ void SlabAlloc::do_free(ref_type ref, char* addr)
             size = (size + 7) & ~0x7;
 
         FreeBlock* e = reinterpret_cast<FreeBlock*>(addr);
+        int size_class = get_small_block_class(size);
+        if (size_class >= 0) {
+            // Same rounding as in do_alloc()
+            size = size_t(min_small_block) << size_class;
+            if (push_small_block(size_class, ref, e))
+                return;
+        }
         REALM_ASSERT_RELEASE_EX(size < 2UL * 1024 * 1024 * 1024, size, get_file_path_for_assertions());
         mark_freed(e, static_cast<int>(size));
         free_block(ref, e);
@@ -594,11 +702,13 @@ void SlabAlloc::free_block(ref_type ref, SlabAlloc::FreeBlock* block)
     if (prev) {
         remove_freelist_entry(prev);
         block = merge_blocks(prev, block);
+        ++m_counters.merges;
     }
     FreeBlock* next = get_next_block_if_mergeable(block);
     if (next) {
         remove_freelist_entry(next);
         block = merge_blocks(block, next);
+        ++m_counters.merges;
     }
     push_freelist_entry(block);
 }
@@ -863,6 +973,13 @@ ref_type SlabAlloc::attach_file(const std::string& path, Config& cfg, util::Writ
     }
 
     ref_type top_ref = read_and_validate_header(m_file, path, size, cfg.session_initiator, m_write_observer);
+    // Only the data of a bundle is mapped. Bundles are never encrypted, so the
+    // pages mapped are those of the file itself, which every process mapping
+    // the bundle shares.
+    if (cfg.read_only && !cfg.encryption_key) {
+        if (auto footer = read_bundle_footer(m_file, size))
+            size = size_t(footer->m_data_size);
+    }
     m_attach_mode = cfg.is_shared ? attach_SharedFile : attach_UnsharedFile;
     // m_data not valid at this point!
     m_baseline = 0;
@@ -919,6 +1036,83 @@ void SlabAlloc::convert_from_streaming_form(ref_type top_ref)
     }
 }
 
+void SlabAlloc::convert_to_bundle(File& file, size_t checksum_block_size)
+{
+    auto fd = file.get_descriptor();
+    size_t file_size = size_t(file.get_size());
+    REALM_ASSERT(file_size >= sizeof(Header) + sizeof(StreamingFooter));
+    Header header;
+    StreamingFooter streaming_footer;
+    File::read_at_static(fd, 0, reinterpret_cast<char*>(&header), sizeof header); // Throws
+    File::read_at_static(fd, file_size - sizeof streaming_footer, reinterpret_cast<char*>(&streaming_footer),
+                         sizeof streaming_footer); // Throws
+    REALM_ASSERT(is_file_on_streaming_form(header));
+    REALM_ASSERT(streaming_footer.m_magic_cookie == footer_magic_cookie);
+
+    header.m_top_ref[0] = streaming_footer.m_top_ref;
+    header.m_top_ref[1] = 0;
+    header.m_flags = flags_Bundle;
+    File::write_at_static(fd, 0, reinterpret_cast<const char*>(&header), sizeof header); // Throws
+
+    BundleFooter footer;
+    footer.m_top_ref = streaming_footer.m_top_ref;
+    footer.m_data_size = file_size - sizeof(StreamingFooter);
+    footer.m_checksum_block_size = checksum_block_size;
+    footer.m_num_checksums = 0;
+    footer.m_magic_cookie = bundle_magic_cookie;
+
+    // The checksums are of the data as it is after the header has been updated
+    std::vector<unsigned char> checksums;
+    if (checksum_block_size) {
+        auto buffer = std::make_unique<char[]>(checksum_block_size); // Throws
+        for (uint64_t pos = 0; pos < footer.m_data_size; pos += checksum_block_size) {
+            size_t n = size_t(std::min<uint64_t>(checksum_block_size, footer.m_data_size - pos));
+            n = File::read_at_static(fd, pos, buffer.get(), n); // Throws
+            checksums.resize(checksums.size() + bundle_checksum_size);
+            util::sha256(buffer.get(), n, checksums.data() + checksums.size() - bundle_checksum_size);
+        }
+        footer.m_num_checksums = checksums.size() / bundle_checksum_size;
+    }
+
+    file.resize(footer.m_data_size); // Throws
+    File::write_at_static(fd, footer.m_data_size, reinterpret_cast<const char*>(checksums.data()),
+                          checksums.size()); // Throws
+    File::write_at_static(fd, footer.m_data_size + checksums.size(), reinterpret_cast<const char*>(&footer),
+                          sizeof footer); // Throws
+}
+
+util::Optional<SlabAlloc::BundleFooter> SlabAlloc::read_bundle_footer(File& file, size_t file_size)
+{
+    if (file_size < sizeof(Header) + sizeof(BundleFooter))
+        return util::none;
+    auto fd = file.get_descriptor();
+    Header header;
+    if (File::read_at_static(fd, 0, reinterpret_cast<char*>(&header), sizeof header) != sizeof header)
+        return util::none;
+    if ((header.m_flags & flags_Bundle) == 0 || is_file_on_streaming_form(header))
+        return util::none;
+    BundleFooter footer;
+    if (File::read_at_static(fd, file_size - sizeof footer, reinterpret_cast<char*>(&footer), sizeof footer) !=
+        sizeof footer)
+        return util::none;
+
+    // A commit made to the file since it was written changes the top ref, and
+    // usually leaves the footer somewhere other than at the end
+    int slot_selector = ((header.m_flags & flags_SelectBit) != 0 ? 1 : 0);
+    if (footer.m_magic_cookie != bundle_magic_cookie || footer.m_top_ref != header.m_top_ref[slot_selector])
+        return util::none;
+    if (footer.m_data_size > file_size - sizeof footer || footer.m_data_size % 8 != 0 ||
+        footer.m_top_ref >= footer.m_data_size)
+        return util::none;
+    uint64_t checksums_size = file_size - sizeof footer - footer.m_data_size;
+    uint64_t num_blocks = 0;
+    if (footer.m_checksum_block_size)
+        num_blocks = (footer.m_data_size + footer.m_checksum_block_size - 1) / footer.m_checksum_block_size;
+    if (footer.m_num_checksums != num_blocks || checksums_size != num_blocks * bundle_checksum_size)
+        return util::none;
+    return footer;
+}
+
 void SlabAlloc::note_reader_start(const void* reader_id)
 {
 #if REALM_ENABLE_ENCRYPTION
@@ -1224,6 +1418,116 @@ inline bool randomly_false_in_debug(bool x)
   * The old one is held in a waiting area until it is no longer relevant because no
     live transaction can refer to it any more.
  */
+size_t SlabAlloc::prefetch_tree(ref_type ref)
+{
+    // Madvise is of no use for encrypted files, whose mappings hold decrypted
+    // copies of the pages. The read barrier in translate() decrypts each array
+    // instead.
+    const bool advise = !m_cfg.encryption_key;
+    const size_t page_mask = ~(util::page_size() - 1);
+    auto will_need = [&](const char* addr, size_t size) {
+        auto begin = reinterpret_cast<size_t>(addr) & page_mask;
+        auto end = reinterpret_cast<size_t>(addr) + size;
+        util::advise_mapping(reinterpret_cast<void*>(begin), end - begin, util::MappingAdvice::WillNeed);
+    };
+
+    size_t bytes = 0;
+    std::vector<ref_type> level = {ref};
+    std::vector<ref_type> next;
+    while (!level.empty()) {
+        std::sort(level.begin(), level.end());
+        if (advise) {
+            for (auto r : level) {
+                if (r < m_baseline)
+                    will_need(translate(r), NodeHeader::header_size);
+            }
+        }
+        next.clear();
+        for (auto r : level) {
+            const char* header = translate(r);
+            size_t size = NodeHeader::get_byte_size_from_header(header);
+            bytes += size;
+            if (advise && r < m_baseline)
+                will_need(header, size);
+            if (!NodeHeader::get_hasrefs_from_header(header))
+                continue;
+            Array arr(*this);
+            arr.init_from_mem(MemRef(const_cast<char*>(header), r, *this));
+            for (size_t i = 0, n = arr.size(); i < n; ++i) {
+                int64_t value = arr.get(i);
+                // Odd values are tagged integers rather than refs
+                if (value != 0 && (value & 1) == 0)
+                    next.push_back(ref_type(value));
+            }
+        }
+        level.swap(next);
+    }
+    return bytes;
+}
+
+size_t SlabAlloc::pin_tree(ref_type ref, size_t max_pages)
+{
+    size_t pages = 0;
+#if REALM_ENABLE_ENCRYPTION
+    if (!is_encrypted())
+        return 0;
+    const size_t page_size = util::page_size();
+    std::vector<ref_type> level = {ref};
+    std::vector<ref_type> next;
+    while (!level.empty()) {
+        std::sort(level.begin(), level.end());
+        next.clear();
+        for (auto r : level) {
+            // Arrays in the slab are not encrypted
+            if (r >= m_baseline.load(std::memory_order_relaxed))
+                continue;
+            // Translation decrypts the whole array
+            const char* header = translate(r);
+            size_t size = NodeHeader::get_byte_size_from_header(header);
+            auto begin = reinterpret_cast<size_t>(header);
+            size_t num_pages = (begin + size - 1) / page_size - begin / page_size + 1;
+            if (pages + num_pages > max_pages)
+                return pages;
+            size_t idx = get_section_index(r);
+            const RefTranslation& txl = m_ref_translation_ptr.load(std::memory_order_acquire)[idx];
+            bool in_primary_mapping =
+                header >= txl.mapping_addr && header < txl.mapping_addr + (size_t(1) << section_shift);
+            auto mapping = in_primary_mapping ? txl.encrypted_mapping : txl.xover_encrypted_mapping;
+            if (mapping)
+                pages += util::encryption_pin(header, size, mapping);
+            if (!NodeHeader::get_hasrefs_from_header(header))
+                continue;
+            Array arr(*this);
+            arr.init_from_mem(MemRef(const_cast<char*>(header), r, *this));
+            for (size_t i = 0, n = arr.size(); i < n; ++i) {
+                int64_t value = arr.get(i);
+                // Odd values are tagged integers rather than refs
+                if (value != 0 && (value & 1) == 0)
+                    next.push_back(ref_type(value));
+            }
+        }
+        level.swap(next);
+    }
+#else
+    static_cast<void>(ref);
+    static_cast<void>(max_pages);
+#endif
+    return pages;
+}
+
+void SlabAlloc::unpin_all() noexcept
+{
+#if REALM_ENABLE_ENCRYPTION
+    std::lock_guard<std::mutex> lock(m_mapping_mutex);
+    for (auto& entry : m_mappings) {
+        if (auto mapping = entry.primary_mapping.get_encrypted_mapping())
+            util::encryption_unpin_all(mapping);
+        if (auto mapping = entry.xover_mapping.get_encrypted_mapping())
+            util::encryption_unpin_all(mapping);
+    }
+#endif
+}
+
 void SlabAlloc::update_reader_view(size_t file_size)
 {
     std::lock_guard<std::mutex> lock(m_mapping_mutex);
@@ -1250,6 +1554,7 @@ void SlabAlloc::update_reader_view(size_t file_size)
 
         std::vector<MapEntry> new_mappings;
         REALM_ASSERT(m_mappings.size() == old_num_mappings);
+        size_t first_changed_mapping = old_num_mappings;
 
         {
             // If the old slab base was greater than the old baseline then the final
@@ -1266,6 +1571,9 @@ void SlabAlloc::update_reader_view(size_t file_size)
                     replace_last_mapping = true;
                     --old_num_mappings;
                 }
+                else {
+                    first_changed_mapping = old_num_mappings - 1;
+                }
             }
 
             // Create new mappings covering from the end of the last complete
@@ -1313,6 +1621,14 @@ void SlabAlloc::update_reader_view(size_t file_size)
         }
 
         std::move(new_mappings.begin(), new_mappings.end(), std::back_inserter(m_mappings));
+
+        if (m_cfg.mapping_advice != util::MappingAdvice::Normal && !m_cfg.encryption_key) {
+            first_changed_mapping = std::min(first_changed_mapping, old_num_mappings);
+            for (size_t i = first_changed_mapping; i < m_mappings.size(); ++i) {
+                auto& mapping = m_mappings[i].primary_mapping;
+                util::advise_mapping(mapping.get_addr(), mapping.get_size(), m_cfg.mapping_advice);
+            }
+        }
     }
 
     m_baseline.store(file_size, std::memory_order_relaxed);
@@ -1373,6 +1689,27 @@ size_t SlabAlloc::get_allocated_size() const noexcept
     return sz;
 }
 
+SlabAlloc::MappingStats SlabAlloc::get_mapping_stats()
+{
+    MappingStats stats;
+    std::lock_guard<std::mutex> lock(m_mapping_mutex);
+    for (auto& entry : m_mappings) {
+        for (auto mapping : {&entry.primary_mapping, &entry.xover_mapping}) {
+            if (mapping->is_attached()) {
+                stats.num_mappings++;
+                stats.mapped_size += mapping->get_size();
+            }
+        }
+    }
+    for (auto& old_mapping : m_old_mappings) {
+        if (old_mapping.mapping.is_attached()) {
+            stats.num_old_mappings++;
+            stats.old_mapped_size += old_mapping.mapping.get_size();
+        }
+    }
+    return stats;
+}
+
 void SlabAlloc::extend_fast_mapping_with_slab(char* address)
 {
     ++m_translation_table_size;
@@ -29,9 +29,12 @@
 #include <realm/util/checked_mutex.hpp>
 #include <realm/util/features.h>
 #include <realm/util/file.hpp>
+#include <realm/util/file_mapper.hpp>
 #include <realm/util/functional.hpp>
+#include <realm/util/optional.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/alloc.hpp>
+#include <realm/node_header.hpp>
 #include <realm/disable_sync_to_disk.hpp>
 #include <realm/version_id.hpp>
 
@@ -112,6 +115,12 @@ public:
     /// \var Config::clear_file_on_error
     /// If the file being opened is not a valid Realm file (possibly due to a
     /// decryption failure), reinitialize it as if clear_file was set.
+    ///
+    /// \var Config::mapping_advice
+    /// The access pattern to advise the OS of for the mappings of the file.
+    ///
+    /// \var Config::huge_pages
+    /// Request transparent huge pages for slabs which are large enough.
     struct Config {
         const char* encryption_key = nullptr;
         bool is_shared = false;
@@ -122,6 +131,8 @@ public:
         bool clear_file = false;
         bool clear_file_on_error = false;
         bool disable_sync = false;
+        util::MappingAdvice mapping_advice = util::MappingAdvice::Normal;
+        bool huge_pages = false;
     };
 
     struct Retry {};
@@ -306,6 +317,26 @@ public:
     /// allocator. Doing so will result in undefined behavior.
     size_t get_total_size() const noexcept;
 
+    /// Read the tree of arrays rooted at \a ref into memory ahead of use. The
+    /// tree is walked one level at a time, and the OS is asked to read in the
+    /// pages of all the arrays of a level before any of them are accessed, so
+    /// that many reads are in flight at once. Returns the number of bytes of
+    /// arrays in the tree. The tree must be part of a version which is kept
+    /// alive by the caller.
+    size_t prefetch_tree(ref_type ref);
+
+    /// Keep the pages of the tree of arrays rooted at \a ref decrypted in
+    /// memory, so that the page reclaimer does not release them, until
+    /// unpin_all() is called. The tree is walked one level at a time, and
+    /// walking stops before more than \a max_pages pages would be pinned.
+    /// Returns the number of pages which were pinned, not counting those which
+    /// were pinned already. Does nothing for files which are not encrypted.
+    /// The tree must be part of a version which is kept alive by the caller.
+    size_t pin_tree(ref_type ref, size_t max_pages);
+
+    /// Let the page reclaimer release all pages pinned by pin_tree() again.
+    void unpin_all() noexcept;
+
     /// Mark all mutable memory (ref-space outside the attached file) as free
     /// space.
     void reset_free_space_tracking();
@@ -335,12 +366,19 @@ public:
     /// Get an ID for the current mapping version. This ID changes whenever any part
     /// of an existing mapping is changed. Such a change requires all refs to be
     /// retranslated to new pointers. This will happen whenever the reader view
-    /// is extended unless the old size was aligned to a section boundary.
+    /// is extended unless the old size was aligned to a section boundary, and
+    /// when the allocator is detached.
     uint64_t get_mapping_version()
     {
         return m_mapping_version;
     }
 
+    /// Returns true if the attached file is encrypted.
+    bool is_encrypted() const noexcept
+    {
+        return m_cfg.encryption_key != nullptr;
+    }
+
     /// Returns true initially, and after a call to reset_free_space_tracking()
     /// up until the point of the first call to SlabAlloc::alloc(). Note that a
     /// call to SlabAlloc::alloc() corresponds to a mutation event.
@@ -363,6 +401,38 @@ public:
     /// Returns total amount of slab for all slab allocators
     static size_t get_total_slab_size() noexcept;
 
+    struct MappingStats {
+        /// Mappings of the file used by the newest version, including the
+        /// mappings covering arrays which cross a section boundary
+        size_t num_mappings = 0;
+        size_t mapped_size = 0;
+        /// Mappings kept open for transactions on older versions
+        size_t num_old_mappings = 0;
+        size_t old_mapped_size = 0;
+    };
+    /// Returns the number and size of the memory mappings of the attached
+    /// file. Thread-safe.
+    MappingStats get_mapping_stats();
+
+    /// Counts of the operations carried out on the slab area since the
+    /// allocator was created, or since the last call to reset_counters().
+    struct Counters {
+        uint64_t allocs = 0;
+        uint64_t frees = 0;
+        uint64_t small_block_hits = 0;  // Allocations served from a size class list
+        uint64_t small_block_parks = 0; // Frees kept on a size class list for reuse
+        uint64_t merges = 0;            // Free blocks merged with a neighbouring block
+        uint64_t slab_grows = 0;
+    };
+    const Counters& get_counters() const noexcept
+    {
+        return m_counters;
+    }
+    void reset_counters() noexcept
+    {
+        m_counters = {};
+    }
+
     /// Hooks used to keep the encryption layer informed of the start and stop
     /// of transactions.
     void note_reader_start(const void* reader_id);
@@ -428,12 +498,16 @@ private:
     // (a.k.a. "refs"), and each slab creates an apparently seamless extension
     // of this file offset addressable space. Slabs are stored as rows in the
     // Slabs table in order of ascending file offsets.
+    // Slabs of at least this size may be backed by transparent huge pages
+    static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
     struct Slab {
         ref_type ref_end;
         char* addr;
         size_t size;
+        bool mapped = false; // Allocated with mmap_anon() rather than new[]
 
-        Slab(ref_type r, size_t s);
+        Slab(ref_type r, size_t s, bool huge_pages = false);
         ~Slab();
 
         Slab(const Slab&) = delete;
@@ -441,10 +515,12 @@ private:
             : ref_end(other.ref_end)
             , addr(other.addr)
             , size(other.size)
+            , mapped(other.mapped)
         {
             other.addr = nullptr;
             other.size = 0;
             other.ref_end = 0;
+            other.mapped = false;
         }
 
         Slab& operator=(const Slab&) = delete;
@@ -511,6 +587,23 @@ private:
     using FreeListMap = std::map<int, FreeBlock*>; // log(N) addressing for larger blocks
     FreeListMap m_block_map;
 
+    // Small blocks are handed out in power of two size classes. A freed small
+    // block is kept on a LIFO list for its size class, still marked as in use
+    // in the bordering BetweenBlocks, so that it can be reused without searching
+    // m_block_map or merging. Only up to max_small_block_cache bytes are kept
+    // per size class, the rest is freed as any other block.
+    static constexpr int min_small_block = 32;
+    static constexpr int max_small_block = 1024;
+    static constexpr int num_small_block_classes = 6;
+    static constexpr int max_small_block_cache = 64 * 1024;
+    struct SmallBlockList {
+        FreeBlock* head = nullptr; // singly linked through 'next'
+        int bytes = 0;
+    };
+    SmallBlockList m_small_blocks[num_small_block_classes];
+    size_t m_small_block_bytes = 0;
+    Counters m_counters;
+
     // abstract notion of a freelist - used to hide whether a freelist
     // is residing in the small blocks or the large blocks structures.
     struct FreeList {
@@ -577,6 +670,23 @@ private:
     void rebuild_freelists_from_slab();
     void clear_freelists();
 
+    // Size class lists. get_small_block_class() returns -1 for sizes above
+    // max_small_block.
+    static int get_small_block_class(size_t size) noexcept
+    {
+        if (size > size_t(max_small_block))
+            return -1;
+        int size_class = 0;
+        while (size > size_t(min_small_block << size_class))
+            ++size_class;
+        return size_class;
+    }
+    FreeBlock* pop_small_block(int size_class) noexcept;
+    bool push_small_block(int size_class, ref_type ref, FreeBlock* entry) noexcept;
+    // Free all blocks kept on the size class lists, so that they may be merged
+    void release_small_blocks() noexcept;
+    std::vector<ref_type> get_small_block_refs() const;
+
     // grow the slab area.
     // returns a free block large enough to handle the request.
     FreeBlock* grow_slab(int size);
@@ -596,6 +706,9 @@ private:
     // Values of each used bit in m_flags
     enum {
         flags_SelectBit = 1,
+        // Set in files written by Group::write_bundle(), which end with a
+        // BundleFooter.
+        flags_Bundle = 2,
     };
 
     // 24 bytes
@@ -615,6 +728,17 @@ private:
         uint64_t m_magic_cookie;
     };
 
+    // 40 bytes. The footer of an immutable bundle, which is preceded by the
+    // Realm data and then by the SHA-256 checksums of each block of
+    // `m_checksum_block_size` bytes of the data, if there are any.
+    struct BundleFooter {
+        uint64_t m_top_ref;
+        uint64_t m_data_size;
+        uint64_t m_checksum_block_size;
+        uint64_t m_num_checksums;
+        uint64_t m_magic_cookie;
+    };
+
     // Description of to-be-deleted memory mapping
     struct OldMapping {
         uint64_t replaced_at_version;
@@ -633,11 +757,25 @@ private:
     };
     static_assert(sizeof(Header) == 24, "Bad header size");
     static_assert(sizeof(StreamingFooter) == 16, "Bad footer size");
+    static_assert(sizeof(BundleFooter) == 40, "Bad bundle footer size");
 
     static const Header empty_file_header;
     static void init_streaming_header(Header*, int file_format_version);
 
     static const uint_fast64_t footer_magic_cookie = 0x3034125237E526C8ULL;
+    static const uint_fast64_t bundle_magic_cookie = 0x454C444E55424D52ULL; // "RMBUNDLE"
+    static constexpr size_t bundle_checksum_size = 32;
+
+    /// Turn a file just written on streaming form into an immutable bundle.
+    /// The header is made to refer to the top ref directly, and the streaming
+    /// footer is replaced by the checksums, unless `checksum_block_size` is
+    /// zero, and a BundleFooter.
+    static void convert_to_bundle(util::File&, size_t checksum_block_size);
+
+    /// The footer of the bundle in the unencrypted file `file`, of
+    /// `file_size` bytes, or none if it is not a bundle. A bundle which has
+    /// been opened for writing and committed to no longer counts as one.
+    static util::Optional<BundleFooter> read_bundle_footer(util::File& file, size_t file_size);
 
     util::RaceDetector changes;
 
@@ -834,6 +972,10 @@ inline bool SlabAlloc::matches_section_boundary(size_t pos) const noexcept
 template <typename Func>
 void SlabAlloc::for_all_free_entries(Func f) const
 {
+    // Blocks kept on the size class lists are marked as in use, but are free
+    // as far as the validator is concerned
+    std::vector<ref_type> small_blocks = get_small_block_refs();
+    auto next_small_block = small_blocks.begin();
     ref_type ref = align_size_to_section_boundary(m_baseline.load(std::memory_order_relaxed));
     for (const auto& e : m_slabs) {
         BetweenBlocks* bb = reinterpret_cast<BetweenBlocks*>(e.addr);
@@ -851,6 +993,18 @@ void SlabAlloc::for_all_free_entries(Func f) const
                 ref += size;
             }
             else {
+                if (next_small_block != small_blocks.end() && *next_small_block == ref) {
+                    f(ref, -size);
+                    ++next_small_block;
+                }
+                else {
+                    // The block may be larger than the capacity of the array
+                    // placed in it. Report the slack as free.
+                    size_t used = NodeHeader::get_capacity_from_header(reinterpret_cast<char*>(bb + 1));
+                    used = (used + 7) & ~size_t(7);
+                    if (used < size_t(-size))
+                        f(ref + used, -size - used);
+                }
                 bb = reinterpret_cast<BetweenBlocks*>(reinterpret_cast<char*>(bb) + sizeof(BetweenBlocks) - size);
                 ref -= size;
             }
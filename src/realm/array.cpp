@@ -25,6 +25,7 @@
 #include <realm/array_integer.hpp>
 #include <realm/array_key.hpp>
 #include <realm/impl/array_writer.hpp>
+#include <realm/util/safe_int_ops.hpp>
 
 #include <array>
 #include <cstring> // std::memcpy
@@ -314,6 +315,97 @@ ref_type Array::do_write_deep(_impl::ArrayWriterBase& out, bool only_if_modified
 }
 
 
+ref_type Array::write_encoded(_impl::ArrayWriterBase& out) const
+{
+    REALM_ASSERT(is_attached());
+    REALM_ASSERT(!m_has_refs);
+
+    const char* header = get_header_from_data(m_data);
+    if (m_is_encoded || m_size == 0 || get_wtype_from_header(header) != wtype_Bits)
+        return do_write_shallow(out); // Throws
+
+    int64_t min = get(0);
+    int64_t max = min;
+    for (size_t i = 1; i < m_size; ++i) {
+        int64_t v = get(i);
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+
+    // Find the smallest width that can hold the span of the values. The
+    // differences from the base use the same representation as ordinary
+    // elements of that width, so for 8 bits and up they are signed.
+    uint64_t span = uint64_t(max) - uint64_t(min);
+    static constexpr size_t widths[] = {0, 1, 2, 4, 8, 16, 32};
+    size_t width = 64;
+    for (size_t w : widths) {
+        if (span <= uint64_t(ubound_for_width(w) - lbound_for_width(w))) {
+            width = w;
+            break;
+        }
+    }
+    size_t byte_size = calc_byte_size(wtype_Delta, m_size, uint_least8_t(width));
+    if (width >= m_width || byte_size >= get_byte_size())
+        return do_write_shallow(out); // Throws
+
+    // Place the base so that the smallest value becomes the lowest delta, or,
+    // if that overflows, so that the largest value becomes the highest delta.
+    int64_t base = min;
+    if (util::int_subtract_with_overflow_detect(base, lbound_for_width(width)))
+        base = max - ubound_for_width(width);
+
+    std::unique_ptr<char[]> buffer(new char[byte_size]());
+    char* new_header = buffer.get();
+    init_header(new_header, false, false, m_context_flag, wtype_Delta, int(width), m_size, byte_size);
+    char* data = get_data_from_header(new_header);
+    for (size_t i = 0; i < m_size; ++i)
+        set_direct(data, width, i, get(i) - base);
+    set_base_in_header(base, new_header);
+
+    uint32_t dummy_checksum = 0x41414141UL;                                   // "AAAA" in ASCII
+    ref_type new_ref = out.write_array(new_header, byte_size, dummy_checksum); // Throws
+    REALM_ASSERT_3(new_ref % 8, ==, 0);                                       // 8-byte alignment
+    return new_ref;
+}
+
+
+void Array::decode()
+{
+    REALM_ASSERT(m_is_encoded);
+
+    size_t width = std::max(bit_width(m_lbound), bit_width(m_ubound));
+    size_t byte_size = std::max(calc_byte_size(wtype_Bits, m_size, uint_least8_t(width)), initial_capacity + 0);
+    MemRef mem = m_alloc.alloc(byte_size); // Throws
+    char* header = mem.get_addr();
+    init_header(header, m_is_inner_bptree_node, m_has_refs, m_context_flag, wtype_Bits, int(width), m_size,
+                byte_size);
+    char* data = get_data_from_header(header);
+    for (size_t i = 0; i < m_size; ++i)
+        set_direct(data, width, i, get(i));
+
+    ref_type old_ref = m_ref;
+    const char* old_header = get_header_from_data(m_data);
+    init_from_mem(mem);
+    update_parent();
+
+    // Mark original as deleted, so that the space can be reclaimed in
+    // future commits, when no versions are using it anymore
+    m_alloc.free_(old_ref, old_header);
+}
+
+
+int64_t Array::delta_for(int64_t value) const noexcept
+{
+    REALM_ASSERT_DEBUG(m_is_encoded);
+    int64_t lbound = lbound_for_width(m_width);
+    int64_t ubound = ubound_for_width(m_width);
+    int64_t delta = value;
+    if (util::int_subtract_with_overflow_detect(delta, m_base))
+        return value < m_base ? lbound - 1 : ubound + 1;
+    return std::min(std::max(delta, lbound - 1), ubound + 1);
+}
+
+
 void Array::move(size_t begin, size_t end, size_t dest_begin)
 {
     REALM_ASSERT_3(begin, <=, end);
@@ -429,6 +521,9 @@ void Array::insert(size_t ndx, int_fast64_t value)
 {
     REALM_ASSERT_DEBUG(ndx <= m_size);
 
+    if (m_is_encoded)
+        decode(); // Throws
+
     const auto old_width = m_width;
     const auto old_size = m_size;
     const Getter old_getter = m_getter; // Save old getter before potential width expansion
@@ -532,6 +627,8 @@ void Array::truncate_and_destroy_children(size_t new_size)
 
 void Array::do_ensure_minimum_width(int_fast64_t value)
 {
+    if (m_is_encoded)
+        decode(); // Throws
 
     // Make room for the new value
     const size_t width = bit_width(value);
@@ -552,7 +649,15 @@ void Array::do_ensure_minimum_width(int_fast64_t value)
 
 int64_t Array::sum(size_t start, size_t end) const
 {
-    REALM_TEMPEX(return sum, m_width, (start, end));
+    int64_t s;
+    REALM_TEMPEX(s = sum, m_width, (start, end));
+    if (m_is_encoded) {
+        if (end == size_t(-1))
+            end = m_size;
+        // Wrap around on overflow like the sum of the decoded elements would
+        s = int64_t(uint64_t(s) + uint64_t(m_base) * (end - start));
+    }
+    return s;
 }
 
 template <size_t w>
@@ -718,8 +823,47 @@ int64_t Array::sum(size_t start, size_t end) const
     return s;
 }
 
+template <bool max>
+bool Array::minmax(size_t start, size_t end, int64_t* result, size_t* return_ndx) const
+{
+    REALM_TEMPEX2(return minmax, max, m_width, (start, end, result, return_ndx));
+}
+
+template <bool max, size_t w>
+bool Array::minmax(size_t start, size_t end, int64_t* result, size_t* return_ndx) const
+{
+    if (end == size_t(-1))
+        end = m_size;
+    REALM_ASSERT_EX(end <= m_size && start <= end, start, end, m_size);
+
+    if (start == end)
+        return false;
+
+    // Reduce without tracking the position first, so that the loop can be vectorized, and then locate the first
+    // occurrence of the result with the (vectorized) finder.
+    int64_t m = get<w>(start);
+    for (size_t i = start + 1; i < end; ++i) {
+        int64_t v = get<w>(i);
+        m = max ? std::max(m, v) : std::min(m, v);
+    }
+
+    *result = m + m_base;
+    if (return_ndx)
+        *return_ndx = find_first(*result, start, end);
+    return true;
+}
+
+template bool Array::minmax<true>(size_t, size_t, int64_t*, size_t*) const;
+template bool Array::minmax<false>(size_t, size_t, int64_t*, size_t*) const;
+
 size_t Array::count(int64_t value) const noexcept
 {
+    if (m_is_encoded) {
+        value = delta_for(value);
+        if (value < lbound_for_width(m_width) || value > ubound_for_width(m_width))
+            return 0;
+    }
+
     const uint64_t* next = reinterpret_cast<uint64_t*>(m_data);
     size_t value_count = 0;
     const size_t end = m_size;
@@ -888,7 +1032,7 @@ size_t Array::count(int64_t value) const noexcept
 
     // Check remaining elements
     for (; i < end; ++i)
-        if (value == get(i))
+        if (value == get_direct(m_data, m_width, i))
             ++value_count;
 
     return value_count;
@@ -1056,14 +1200,56 @@ struct Array::VTableForWidth {
 template <size_t width>
 const typename Array::VTableForWidth<width>::PopulatedVTable Array::VTableForWidth<width>::vtable;
 
+// The finders translate the searched value to a difference from the base, see
+// ArrayWithFind::find_optimized().
+template <size_t width>
+struct Array::VTableForDelta {
+    struct PopulatedVTable : Array::VTable {
+        PopulatedVTable()
+        {
+            getter = &Array::get_delta<width>;
+            setter = &Array::set<width>;
+            chunk_getter = &Array::get_chunk_delta<width>;
+            finder[cond_Equal] = &Array::find_vtable<Equal, width>;
+            finder[cond_NotEqual] = &Array::find_vtable<NotEqual, width>;
+            finder[cond_Greater] = &Array::find_vtable<Greater, width>;
+            finder[cond_Less] = &Array::find_vtable<Less, width>;
+        }
+    };
+    static const PopulatedVTable vtable;
+};
+
+template <size_t width>
+const typename Array::VTableForDelta<width>::PopulatedVTable Array::VTableForDelta<width>::vtable;
+
 void Array::update_width_cache_from_header() noexcept
 {
-    auto width = get_width_from_header(get_header());
+    const char* header = get_header();
+    auto width = get_width_from_header(header);
+    m_width = width;
+
+    m_is_encoded = get_wtype_from_header(header) == wtype_Delta;
+    if (m_is_encoded) {
+        // The bounds are those of the width needed for the decoded values
+        m_base = get_base_from_header(header);
+        int64_t lbound = m_base;
+        int64_t ubound = m_base;
+        size_t value_width = 64;
+        if (!util::int_add_with_overflow_detect(lbound, lbound_for_width(width)) &&
+            !util::int_add_with_overflow_detect(ubound, ubound_for_width(width)))
+            value_width = std::max(bit_width(lbound), bit_width(ubound));
+        m_lbound = lbound_for_width(value_width);
+        m_ubound = ubound_for_width(value_width);
+
+        REALM_TEMPEX(m_vtable = &VTableForDelta, width, ::vtable);
+        m_getter = m_vtable->getter;
+        return;
+    }
+
+    m_base = 0;
     m_lbound = lbound_for_width(width);
     m_ubound = ubound_for_width(width);
 
-    m_width = width;
-
     REALM_TEMPEX(m_vtable = &VTableForWidth, width, ::vtable);
     m_getter = m_vtable->getter;
 }
@@ -1138,6 +1324,14 @@ void Array::get_chunk<0>(size_t ndx, int64_t res[8]) const noexcept
     memset(res, 0, sizeof(int64_t) * 8);
 }
 
+template <size_t w>
+void Array::get_chunk_delta(size_t ndx, int64_t res[8]) const noexcept
+{
+    get_chunk<w>(ndx, res);
+    for (size_t i = 0; i + ndx < m_size && i < 8; i++)
+        res[i] += m_base;
+}
+
 
 template <size_t width>
 void Array::set(size_t ndx, int64_t value)
@@ -1263,11 +1457,15 @@ void Array::verify() const
 
 size_t Array::lower_bound_int(int64_t value) const noexcept
 {
+    if (m_is_encoded)
+        value = delta_for(value);
     REALM_TEMPEX(return lower_bound, m_width, (m_data, m_size, value));
 }
 
 size_t Array::upper_bound_int(int64_t value) const noexcept
 {
+    if (m_is_encoded)
+        value = delta_for(value);
     REALM_TEMPEX(return upper_bound, m_width, (m_data, m_size, value));
 }
 
@@ -1282,7 +1480,10 @@ int_fast64_t Array::get(const char* header, size_t ndx) noexcept
 {
     const char* data = get_data_from_header(header);
     uint_least8_t width = get_width_from_header(header);
-    return get_direct(data, width, ndx);
+    int64_t value = get_direct(data, width, ndx);
+    if (get_wtype_from_header(header) == wtype_Delta)
+        value += get_base_from_header(header);
+    return value;
 }
 
 
@@ -1291,6 +1492,11 @@ std::pair<int64_t, int64_t> Array::get_two(const char* header, size_t ndx) noexc
     const char* data = get_data_from_header(header);
     uint_least8_t width = get_width_from_header(header);
     std::pair<int64_t, int64_t> p = ::get_two(data, width, ndx);
+    if (get_wtype_from_header(header) == wtype_Delta) {
+        int64_t base = get_base_from_header(header);
+        p.first += base;
+        p.second += base;
+    }
     return std::make_pair(p.first, p.second);
 }
 
@@ -198,6 +198,8 @@ public:
 
     void alloc(size_t init_size, size_t new_width)
     {
+        if (m_is_encoded)
+            decode(); // Throws
         REALM_ASSERT_3(m_width, ==, get_width_from_header(get_header()));
         REALM_ASSERT_3(m_size, ==, get_size_from_header(get_header()));
         Node::alloc(init_size, new_width);
@@ -329,6 +331,13 @@ public:
         return sum(start, end);
     }
 
+    /// Find the smallest (or, if `max` is true, the largest) element in the
+    /// range [start, end). If `return_ndx` is specified, it receives the index
+    /// of the first occurrence of that element. Returns false if the range is
+    /// empty.
+    template <bool max>
+    bool minmax(size_t start, size_t end, int64_t* result, size_t* return_ndx = nullptr) const;
+
     /// This information is guaranteed to be cached in the array accessor.
     bool is_inner_bptree_node() const noexcept;
 
@@ -385,6 +394,19 @@ public:
     /// cases where you do not already have an array accessor available.
     static ref_type write(ref_type, Allocator&, _impl::ArrayWriterBase&, bool only_if_modified);
 
+    /// Same as non-recursive write(), but the elements are written as packed
+    /// differences from a common base (width type wtype_Delta) if that makes
+    /// the written array smaller. This is only valid for arrays of plain
+    /// integers. An encoded array can be read like any other, and it is
+    /// decoded again the first time it is modified.
+    ref_type write_encoded(_impl::ArrayWriterBase& out) const;
+
+    /// True if the elements are stored as differences from a common base.
+    bool is_encoded() const noexcept
+    {
+        return m_is_encoded;
+    }
+
     size_t find_first(int64_t value, size_t begin = 0, size_t end = size_t(-1)) const;
 
     // Wrappers for backwards compatibility and for simple use without
@@ -471,16 +493,43 @@ protected:
     // This will have to be eventually used, exposing this here for testing.
     size_t count(int64_t value) const noexcept;
 
+    // Encoded arrays must be decoded before they can be modified, so these
+    // hide the versions in Node.
+    void copy_on_write()
+    {
+        if (m_is_encoded)
+            decode(); // Throws
+        Node::copy_on_write(); // Throws
+    }
+    void copy_on_write(size_t min_size)
+    {
+        if (m_is_encoded)
+            decode(); // Throws
+        Node::copy_on_write(min_size); // Throws
+    }
+
 private:
     void update_width_cache_from_header() noexcept;
 
     void do_ensure_minimum_width(int_fast64_t);
 
+    /// Replace an encoded array by a copy in the ordinary representation. The
+    /// copy is wide enough for any value in [m_lbound, m_ubound].
+    void decode();
+
+    /// Translate a value to the difference from the base of an encoded
+    /// array. Values outside the range of the current width are clamped to
+    /// one below or above it, so that they still compare correctly.
+    int64_t delta_for(int64_t value) const noexcept;
+
     int64_t sum(size_t start, size_t end) const;
 
     template <size_t w>
     int64_t sum(size_t start, size_t end) const;
 
+    template <bool max, size_t w>
+    bool minmax(size_t start, size_t end, int64_t* result, size_t* return_ndx) const;
+
 protected:
     /// It is an error to specify a non-zero value unless the width
     /// type is wtype_Bits. It is also an error to specify a non-zero
@@ -510,6 +559,14 @@ protected:
     };
     template <size_t w>
     struct VTableForWidth;
+    template <size_t w>
+    struct VTableForDelta;
+
+    template <size_t w>
+    int64_t get_delta(size_t ndx) const noexcept;
+
+    template <size_t w>
+    void get_chunk_delta(size_t ndx, int64_t res[8]) const noexcept;
 
     // This is the one installed into the m_vtable->finder slots.
     template <class cond, size_t bitwidth>
@@ -531,6 +588,8 @@ protected:
     uint_least8_t m_width = 0; // Size of an element (meaning depend on type of array).
     int64_t m_lbound;          // min number that can be stored with current m_width
     int64_t m_ubound;          // max number that can be stored with current m_width
+    int64_t m_base = 0;        // added to every element if the array is encoded
+    bool m_is_encoded = false; // elements are differences from m_base (wtype_Delta)
 
     bool m_is_inner_bptree_node; // This array is an inner node of B+-tree.
     bool m_has_refs;             // Elements whose first bit is zero are refs to subarrays.
@@ -550,6 +609,7 @@ private:
     friend class SlabAlloc;
     friend class GroupWriter;
     friend class ArrayWithFind;
+    friend class NodeTree;
 };
 
 // Implementation:
@@ -985,6 +1045,12 @@ inline void Array::ensure_minimum_width(int_fast64_t value)
     do_ensure_minimum_width(value);
 }
 
+template <size_t w>
+int64_t Array::get_delta(size_t ndx) const noexcept
+{
+    return m_base + get_universal<w>(m_data, ndx);
+}
+
 
 } // namespace realm
 
@@ -26,6 +26,50 @@
 
 using namespace realm;
 
+namespace {
+
+// Backlink lists are kept sorted by key, so that a backlink can be found with a binary search.
+size_t lower_bound_backlink(const BPlusTree<int64_t>& backlink_list, int64_t key)
+{
+    size_t lo = 0;
+    size_t hi = backlink_list.size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (backlink_list.get(mid) < key) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+size_t find_backlink(BPlusTree<int64_t>& backlink_list, int64_t key)
+{
+    size_t ndx = lower_bound_backlink(backlink_list, key);
+    if (ndx < backlink_list.size() && backlink_list.get(ndx) == key) {
+        return ndx;
+    }
+    // Lists written by earlier versions are not sorted. Sort such a list the first time
+    // a search in it fails, so that later searches are fast.
+    auto values = backlink_list.get_all();
+    if (std::is_sorted(values.begin(), values.end())) {
+        return not_found;
+    }
+    std::sort(values.begin(), values.end());
+    for (size_t i = 0; i < values.size(); i++) {
+        backlink_list.set(i, values[i]);
+    }
+    ndx = lower_bound_backlink(backlink_list, key);
+    if (ndx < backlink_list.size() && backlink_list.get(ndx) == key) {
+        return ndx;
+    }
+    return not_found;
+}
+
+} // anonymous namespace
+
 // nullify forward links corresponding to any backward links at index 'ndx'.
 void ArrayBacklink::nullify_fwd_links(size_t ndx, CascadeState& state)
 {
@@ -62,11 +106,10 @@ void ArrayBacklink::nullify_fwd_links(size_t ndx, CascadeState& state)
         BPlusTree<int64_t> backlink_list(m_alloc);
         backlink_list.init_from_ref(ref);
 
-        size_t sz = backlink_list.size();
-        for (size_t i = 0; i < sz; i++) {
-            state.enqueue_for_nullification(*source_table, src_col_key, ObjKey(backlink_list.get(i)),
+        backlink_list.for_all([&](int64_t key_value) {
+            state.enqueue_for_nullification(*source_table, src_col_key, ObjKey(key_value),
                                             {target_table->get_key(), target_key});
-        }
+        });
     }
 }
 
@@ -95,7 +138,14 @@ void ArrayBacklink::add(size_t ndx, ObjKey key)
         backlink_list.set_parent(this, ndx);
         backlink_list.split_if_needed();
     }
-    backlink_list.add(key.value); // Throws
+    // Sources are mostly created after the target, so most new keys go at the end
+    size_t sz = backlink_list.size();
+    if (backlink_list.get(sz - 1) <= key.value) {
+        backlink_list.add(key.value); // Throws
+    }
+    else {
+        backlink_list.insert(lower_bound_backlink(backlink_list, key.value), key.value); // Throws
+    }
 }
 
 // Return true if the last link was removed
@@ -125,12 +175,10 @@ bool ArrayBacklink::remove(size_t ndx, ObjKey key)
     backlink_list.split_if_needed();
 
     size_t last_ndx = backlink_list.size() - 1;
-    size_t backlink_ndx = backlink_list.find_first(key.value);
+    size_t backlink_ndx = find_backlink(backlink_list, key.value);
     REALM_ASSERT_DEBUG(backlink_ndx != not_found);
     if (backlink_ndx != not_found) {
-        if (backlink_ndx != last_ndx)
-            backlink_list.set(backlink_ndx, backlink_list.get(last_ndx));
-        backlink_list.erase(last_ndx); // Throws
+        backlink_list.erase(backlink_ndx); // Throws
     }
 
     // If there is only one backlink left we can inline it as tagged value
@@ -190,6 +238,28 @@ ObjKey ArrayBacklink::get_backlink(size_t ndx, size_t index) const
     return ObjKey(backlink_list.get(index));
 }
 
+std::vector<ObjKey> ArrayBacklink::get_backlinks(size_t ndx) const
+{
+    std::vector<ObjKey> keys;
+    uint64_t value = Array::get(ndx);
+    if (value == 0) {
+        return keys;
+    }
+
+    if ((value & 1) != 0) {
+        keys.emplace_back(int64_t(value >> 1));
+        return keys;
+    }
+
+    BPlusTree<int64_t> backlink_list(m_alloc);
+    backlink_list.init_from_ref(ref_type(value));
+    keys.reserve(backlink_list.size());
+    backlink_list.for_all([&keys](int64_t key_value) {
+        keys.emplace_back(key_value);
+    });
+    return keys;
+}
+
 void ArrayBacklink::verify() const
 {
 #ifdef REALM_DEBUG
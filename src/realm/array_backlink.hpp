@@ -75,6 +75,8 @@ public:
     void erase(size_t ndx);
     size_t get_backlink_count(size_t ndx) const;
     ObjKey get_backlink(size_t ndx, size_t index) const;
+    // All backlinks at index 'ndx', ordered by key
+    std::vector<ObjKey> get_backlinks(size_t ndx) const;
     void move(ArrayBacklink& dst, size_t ndx)
     {
         Array::move(dst, ndx);
@@ -84,6 +84,15 @@ public:
 
     size_t find_first(T value, size_t begin = 0, size_t end = npos) const;
 
+    /// Sum of the elements in [begin, end) that are neither null nor NaN.
+    /// `value_count` receives the number of such elements.
+    double sum(size_t begin, size_t end, size_t& value_count) const;
+
+    /// Find the smallest (or, if `max` is true, the largest) element in
+    /// [begin, end), ignoring null and NaN. Returns false if there is none.
+    template <bool max>
+    bool minmax(size_t begin, size_t end, T* result, size_t* return_ndx = nullptr) const;
+
     /// Get the specified element without the cost of constructing an
     /// array instance. If an array instance is already available, or
     /// you need to get multiple values, then this method will be
@@ -20,6 +20,7 @@
 #define REALM_ARRAY_BASIC_TPL_HPP
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include <realm/array_basic.hpp>
@@ -200,6 +201,55 @@ inline size_t BasicArray<T>::find_first(T value, size_t begin, size_t end) const
     return i == data + end ? not_found : size_t(i - data);
 }
 
+template <class T>
+double BasicArray<T>::sum(size_t begin, size_t end, size_t& value_count) const
+{
+    if (end == npos)
+        end = m_size;
+    REALM_ASSERT(begin <= m_size && end <= m_size && begin <= end);
+
+    // Null is stored as a NaN, so a single NaN test excludes both. The additions are kept in element order so that
+    // the result is exactly the same as when accumulating one value at a time.
+    const T* data = reinterpret_cast<const T*>(m_data);
+    double s = 0;
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i) {
+        T v = data[i];
+        if (!std::isnan(v)) {
+            s += v;
+            ++count;
+        }
+    }
+    value_count = count;
+    return s;
+}
+
+template <class T>
+template <bool max>
+bool BasicArray<T>::minmax(size_t begin, size_t end, T* result, size_t* return_ndx) const
+{
+    if (end == npos)
+        end = m_size;
+    REALM_ASSERT(begin <= m_size && end <= m_size && begin <= end);
+
+    const T* data = reinterpret_cast<const T*>(m_data);
+    size_t ndx = npos;
+    T m{};
+    for (size_t i = begin; i < end; ++i) {
+        T v = data[i];
+        if (!std::isnan(v) && (ndx == npos || (max ? v > m : v < m))) {
+            m = v;
+            ndx = i;
+        }
+    }
+    if (ndx == npos)
+        return false;
+    *result = m;
+    if (return_ndx)
+        *return_ndx = ndx;
+    return true;
+}
+
 template <class T>
 size_t BasicArrayNull<T>::find_first_null(size_t begin, size_t end) const
 {
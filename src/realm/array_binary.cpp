@@ -173,7 +173,7 @@ void ArrayBinary::clear()
     }
 }
 
-size_t ArrayBinary::find_first(BinaryData value, size_t begin, size_t end) const noexcept
+size_t ArrayBinary::find_first(BinaryData value, size_t begin, size_t end) const
 {
     if (!m_is_big) {
         return static_cast<ArraySmallBlobs*>(m_arr)->find_first(value, false, begin, end);
@@ -76,13 +76,13 @@ public:
     void move(ArrayBinary& dst, size_t ndx);
     void clear();
 
-    size_t find_first(BinaryData value, size_t begin, size_t end) const noexcept;
+    size_t find_first(BinaryData value, size_t begin, size_t end) const;
 
     /// Get the specified element without the cost of constructing an
     /// array instance. If an array instance is already available, or
     /// you need to get multiple values, then this method will be
     /// slower.
-    static BinaryData get(const char* header, size_t ndx, Allocator& alloc) noexcept;
+    static BinaryData get(const char* header, size_t ndx, Allocator& alloc);
 
     void verify() const;
 
@@ -97,7 +97,7 @@ private:
     bool upgrade_leaf(size_t value_size);
 };
 
-inline BinaryData ArrayBinary::get(const char* header, size_t ndx, Allocator& alloc) noexcept
+inline BinaryData ArrayBinary::get(const char* header, size_t ndx, Allocator& alloc)
 {
     bool is_big = Array::get_context_flag_from_header(header);
     if (!is_big) {
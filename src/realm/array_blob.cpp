@@ -20,12 +20,96 @@
 
 #include <realm/array.hpp>
 #include <realm/array_blob.hpp>
+#include <realm/impl/destroy_guard.hpp>
+#include <realm/util/compression.hpp>
 
 using namespace realm;
 
-BinaryData ArrayBlob::get_at(size_t& pos) const noexcept
+namespace {
+
+// Codecs of compressed blobs
+constexpr uint64_t codec_zlib = 0;
+
+} // anonymous namespace
+
+bool ArrayBlob::is_compressed(const char* header) noexcept
+{
+    return get_context_flag_from_header(header) && get_size_from_header(header) == 3 &&
+           (Array::get(header, 0) & 1) != 0;
+}
+
+BinaryData ArrayBlob::get_decompressed(ref_type ref, const char* header, Allocator& alloc)
+{
+    REALM_ASSERT_DEBUG(is_compressed(header));
+    size_t size = size_t(uint64_t(Array::get(header, 1)) >> 1);
+
+    auto& cache = alloc.m_decompressed_blobs;
+    std::lock_guard lock(cache.mutex);
+    auto storage_version = alloc.get_storage_version();
+    auto instance_version = alloc.get_instance_version();
+    if (cache.storage_version != storage_version || cache.instance_version != instance_version) {
+        cache.blobs.clear();
+        cache.storage_version = storage_version;
+        cache.instance_version = instance_version;
+    }
+
+    auto& buffer = cache.blobs[ref];
+    if (!buffer) {
+        if (uint64_t(Array::get(header, 0)) >> 1 != codec_zlib)
+            throw std::system_error(make_error_code(util::compression::error::decompress_unsupported));
+        const char* data_header = alloc.translate(to_ref(Array::get(header, 2)));
+        auto data = std::make_unique<char[]>(size); // Throws
+        util::Span<const char> compressed(get_data_from_header(data_header), get_size_from_header(data_header));
+        if (auto ec = util::compression::decompress(compressed, util::Span<char>(data.get(), size)))
+            throw std::system_error(ec);
+        buffer = std::move(data);
+    }
+    return {buffer.get(), size};
+}
+
+ref_type ArrayBlob::write_compressed(const char* header, _impl::ArrayWriterBase& out)
+{
+    REALM_ASSERT_DEBUG(!get_context_flag_from_header(header));
+    const char* data = get_data_from_header(header);
+    size_t size = get_size_from_header(header);
+
+    // Require a saving of at least the size of the extra array
+    size_t bound = util::compression::compress_bound(size);
+    if (bound == 0)
+        return 0;
+    auto buffer = std::make_unique<char[]>(bound); // Throws
+    size_t compressed_size = 0;
+    if (util::compression::compress(util::Span<const char>(data, size), util::Span<char>(buffer.get(), bound), compressed_size))
+        return 0;
+    if (compressed_size + 2 * header_size + 3 * 8 >= size)
+        return 0;
+
+    ArrayBlob blob(Allocator::get_default());
+    blob.create(); // Throws
+    _impl::ShallowArrayDestroyGuard blob_dg(&blob);
+    blob.add(buffer.get(), compressed_size);           // Throws
+    ref_type data_ref = blob.write(out, false, false); // Throws
+
+    Array top(Allocator::get_default());
+    top.create(type_HasRefs, true); // Throws
+    _impl::ShallowArrayDestroyGuard top_dg(&top);
+    top.add(RefOrTagged::make_tagged(codec_zlib)); // Throws
+    top.add(RefOrTagged::make_tagged(size));       // Throws
+    top.add(from_ref(data_ref));                   // Throws
+    return top.write(out, false, false);           // Throws
+}
+
+BinaryData ArrayBlob::get_at(size_t& pos) const
 {
     size_t offset = pos;
+    if (get_context_flag() && is_compressed(get_header())) {
+        BinaryData data = get_decompressed(get_ref(), get_header(), m_alloc); // Throws
+        pos = 0;
+        if (offset < data.size()) {
+            return {data.data() + offset, data.size() - offset};
+        }
+        return {"", 0};
+    }
     if (get_context_flag()) {
         size_t ndx = 0;
         size_t current_size = Array::get_size_from_header(m_alloc.translate(Array::get_as_ref(ndx)));
@@ -176,7 +260,13 @@ ref_type ArrayBlob::replace(size_t begin, size_t end, const char* data, size_t d
 void ArrayBlob::verify() const
 {
 #ifdef REALM_DEBUG
-    if (get_context_flag()) {
+    if (is_compressed(get_header())) {
+        REALM_ASSERT(has_refs());
+        ArrayBlob blob(m_alloc);
+        blob.init_from_ref(Array::get_as_ref(2));
+        blob.verify();
+    }
+    else if (get_context_flag()) {
         REALM_ASSERT(has_refs());
         for (size_t i = 0; i < size(); ++i) {
             ref_type blob_ref = Array::get_as_ref(i);
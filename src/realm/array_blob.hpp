@@ -38,7 +38,7 @@ public:
     ArrayBlob(const ArrayBlob&) = delete;
 
     const char* get(size_t index) const noexcept;
-    BinaryData get_at(size_t& pos) const noexcept;
+    BinaryData get_at(size_t& pos) const;
     bool is_null(size_t index) const noexcept;
     ref_type add(const char* data, size_t data_size, bool add_zero_term = false);
     void insert(size_t pos, const char* data, size_t data_size, bool add_zero_term = false);
@@ -51,6 +51,24 @@ public:
     /// slower.
     static const char* get(const char* header, size_t index) noexcept;
 
+    //@{
+    /// Blobs of columns with `col_attr_Compressed` which hold at least
+    /// `compression_threshold` bytes are compressed when they are written to
+    /// the file by a commit. A compressed blob is an array with the context
+    /// flag set, like a split blob, but holding the tagged codec and
+    /// uncompressed size followed by a reference to the compressed data.
+    ///
+    /// get_decompressed() returns the contents of a compressed blob. The
+    /// decompressed data is owned by the allocator and remains valid as long
+    /// as data read from the file would. write_compressed() writes the blob
+    /// with the specified header in compressed form and returns its ref, or
+    /// zero if compression would not make it smaller.
+    static constexpr size_t compression_threshold = 1024;
+    static bool is_compressed(const char* header) noexcept;
+    static BinaryData get_decompressed(ref_type, const char* header, Allocator&);
+    static ref_type write_compressed(const char* header, _impl::ArrayWriterBase&);
+    //@}
+
     /// Create a new empty blob (binary) array and attach this
     /// accessor to it. This does not modify the parent reference
     /// information of this accessor.
@@ -20,11 +20,12 @@
 
 #include <realm/array_blobs_big.hpp>
 #include <realm/column_integer.hpp>
+#include <realm/impl/destroy_guard.hpp>
 
 
 using namespace realm;
 
-BinaryData ArrayBigBlobs::get_at(size_t ndx, size_t& pos) const noexcept
+BinaryData ArrayBigBlobs::get_at(size_t ndx, size_t& pos) const
 {
     ref_type ref = get_as_ref(ndx);
     if (ref == 0)
@@ -71,8 +72,25 @@ void ArrayBigBlobs::set(size_t ndx, BinaryData value, bool add_zero_term)
         return;
     }
     else if (ref != 0 && value.data() != nullptr) {
+        // Storing the value again must not copy the blob, which would
+        // otherwise be written to the file anew by the commit
+        BinaryData current = get(ndx); // Throws
+        size_t stored_size = value.size() + (add_zero_term ? 1 : 0);
+        if (current.data() && current.size() == stored_size &&
+            std::equal(value.data(), value.data() + value.size(), current.data())) {
+            return;
+        }
+
         char* header = m_alloc.translate(ref);
-        if (Array::get_context_flag_from_header(header)) {
+        if (ArrayBlob::is_compressed(header)) {
+            // Compressed blobs are never modified in place
+            ArrayBlob new_blob(m_alloc);
+            new_blob.create();                                                      // Throws
+            ref_type new_ref = new_blob.add(value.data(), value.size(), add_zero_term); // Throws
+            Array::set_as_ref(ndx, new_ref);
+            Array::destroy_deep(ref, m_alloc);
+        }
+        else if (Array::get_context_flag_from_header(header)) {
             Array arr(m_alloc);
             arr.init_from_mem(MemRef(header, ref, m_alloc));
             arr.set_parent(this, ndx);
@@ -120,7 +138,7 @@ void ArrayBigBlobs::insert(size_t ndx, BinaryData value, bool add_zero_term)
 }
 
 
-size_t ArrayBigBlobs::count(BinaryData value, bool is_string, size_t begin, size_t end) const noexcept
+size_t ArrayBigBlobs::count(BinaryData value, bool is_string, size_t begin, size_t end) const
 {
     size_t num_matches = 0;
 
@@ -137,7 +155,7 @@ size_t ArrayBigBlobs::count(BinaryData value, bool is_string, size_t begin, size
 }
 
 
-size_t ArrayBigBlobs::find_first(BinaryData value, bool is_string, size_t begin, size_t end) const noexcept
+size_t ArrayBigBlobs::find_first(BinaryData value, bool is_string, size_t begin, size_t end) const
 {
     if (end == npos)
         end = m_size;
@@ -160,6 +178,15 @@ size_t ArrayBigBlobs::find_first(BinaryData value, bool is_string, size_t begin,
             ref_type ref = get_as_ref(i);
             if (ref) {
                 const char* blob_header = get_alloc().translate(ref);
+                if (get_context_flag_from_header(blob_header)) {
+                    if (ArrayBlob::is_compressed(blob_header) &&
+                        size_t(uint64_t(Array::get(blob_header, 1)) >> 1) == full_size) {
+                        BinaryData blob = ArrayBlob::get_decompressed(ref, blob_header, get_alloc()); // Throws
+                        if (std::equal(blob.data(), blob.data() + value_size, value.data()))
+                            return i;
+                    }
+                    continue;
+                }
                 size_t sz = get_size_from_header(blob_header);
                 if (sz == full_size) {
                     const char* blob_value = ArrayBlob::get(blob_header, 0);
@@ -188,6 +215,38 @@ void ArrayBigBlobs::find_all(IntegerColumn& result, BinaryData value, bool is_st
 }
 
 
+ref_type ArrayBigBlobs::write_compressed(ref_type ref, Allocator& alloc, _impl::ArrayWriterBase& out)
+{
+    if (alloc.is_read_only(ref))
+        return ref;
+
+    Array leaf(alloc);
+    leaf.init_from_ref(ref);
+
+    // Temp array for updated refs
+    Array new_leaf(Allocator::get_default());
+    new_leaf.create(leaf.get_type(), leaf.get_context_flag()); // Throws
+    _impl::ShallowArrayDestroyGuard dg(&new_leaf);
+
+    for (size_t i = 0, n = leaf.size(); i < n; ++i) {
+        ref_type blob_ref = leaf.get_as_ref(i);
+        if (blob_ref != 0) {
+            ref_type new_ref = 0;
+            if (!alloc.is_read_only(blob_ref)) {
+                const char* blob_header = alloc.translate(blob_ref);
+                if (!get_context_flag_from_header(blob_header) &&
+                    get_size_from_header(blob_header) >= ArrayBlob::compression_threshold)
+                    new_ref = ArrayBlob::write_compressed(blob_header, out); // Throws
+            }
+            blob_ref = new_ref ? new_ref : Array::write(blob_ref, alloc, out, true); // Throws
+        }
+        new_leaf.add(from_ref(blob_ref)); // Throws
+    }
+
+    return new_leaf.write(out, false, false); // Throws
+}
+
+
 void ArrayBigBlobs::verify() const
 {
 #ifdef REALM_DEBUG
@@ -34,9 +34,9 @@ public:
     ArrayBigBlobs& operator=(const ArrayBigBlobs&) = delete;
     ArrayBigBlobs(const ArrayBigBlobs&) = delete;
 
-    BinaryData get(size_t ndx) const noexcept;
+    BinaryData get(size_t ndx) const;
     bool is_null(size_t ndx) const;
-    BinaryData get_at(size_t ndx, size_t& pos) const noexcept;
+    BinaryData get_at(size_t ndx, size_t& pos) const;
     void set(size_t ndx, BinaryData value, bool add_zero_term = false);
     void add(BinaryData value, bool add_zero_term = false);
     void insert(size_t ndx, BinaryData value, bool add_zero_term = false);
@@ -45,8 +45,8 @@ public:
     void clear();
     void destroy();
 
-    size_t count(BinaryData value, bool is_string = false, size_t begin = 0, size_t end = npos) const noexcept;
-    size_t find_first(BinaryData value, bool is_string = false, size_t begin = 0, size_t end = npos) const noexcept;
+    size_t count(BinaryData value, bool is_string = false, size_t begin = 0, size_t end = npos) const;
+    size_t find_first(BinaryData value, bool is_string = false, size_t begin = 0, size_t end = npos) const;
     void find_all(IntegerColumn& result, BinaryData value, bool is_string = false, size_t add_offset = 0,
                   size_t begin = 0, size_t end = npos);
 
@@ -54,19 +54,24 @@ public:
     /// array instance. If an array instance is already available, or
     /// you need to get multiple values, then this method will be
     /// slower.
-    static BinaryData get(const char* header, size_t ndx, Allocator&) noexcept;
+    static BinaryData get(const char* header, size_t ndx, Allocator&);
 
     //@{
     /// Those that return a string, discard the terminating zero from
     /// the stored value. Those that accept a string argument, add a
     /// terminating zero before storing the value.
-    StringData get_string(size_t ndx) const noexcept;
+    StringData get_string(size_t ndx) const;
     void add_string(StringData value);
     void set_string(size_t ndx, StringData value);
     void insert_string(size_t ndx, StringData value);
-    static StringData get_string(const char* header, size_t ndx, Allocator&, bool nullable) noexcept;
+    static StringData get_string(const char* header, size_t ndx, Allocator&, bool nullable);
     //@}
 
+    /// Write the modified leaf at the specified ref in the same way as
+    /// `Array::write(ref, alloc, out, true)`, but write the modified blobs
+    /// which are large enough in compressed form (see ArrayBlob).
+    static ref_type write_compressed(ref_type, Allocator&, _impl::ArrayWriterBase&);
+
     /// Create a new empty big blobs array and attach this accessor to
     /// it. This does not modify the parent reference information of
     /// this accessor.
@@ -90,7 +95,7 @@ inline ArrayBigBlobs::ArrayBigBlobs(Allocator& allocator, bool nullable) noexcep
 {
 }
 
-inline BinaryData ArrayBigBlobs::get(size_t ndx) const noexcept
+inline BinaryData ArrayBigBlobs::get(size_t ndx) const
 {
     ref_type ref = get_as_ref(ndx);
     if (ref == 0)
@@ -102,6 +107,8 @@ inline BinaryData ArrayBigBlobs::get(size_t ndx) const noexcept
         size_t sz = get_size_from_header(blob_header);
         return BinaryData(value, sz);
     }
+    if (ArrayBlob::is_compressed(blob_header))
+        return ArrayBlob::get_decompressed(ref, blob_header, get_alloc()); // Throws
     return {};
 }
 
@@ -111,7 +118,7 @@ inline bool ArrayBigBlobs::is_null(size_t ndx) const
     return ref == 0;
 }
 
-inline BinaryData ArrayBigBlobs::get(const char* header, size_t ndx, Allocator& alloc) noexcept
+inline BinaryData ArrayBigBlobs::get(const char* header, size_t ndx, Allocator& alloc)
 {
     ref_type blob_ref = to_ref(Array::get(header, ndx));
     if (blob_ref == 0)
@@ -123,6 +130,8 @@ inline BinaryData ArrayBigBlobs::get(const char* header, size_t ndx, Allocator&
         size_t sz = Array::get_size_from_header(blob_header);
         return BinaryData(blob_data, sz);
     }
+    if (ArrayBlob::is_compressed(blob_header))
+        return ArrayBlob::get_decompressed(blob_ref, blob_header, alloc); // Throws
     return {};
 }
 
@@ -150,7 +159,7 @@ inline void ArrayBigBlobs::destroy()
     Array::destroy_deep();
 }
 
-inline StringData ArrayBigBlobs::get_string(size_t ndx) const noexcept
+inline StringData ArrayBigBlobs::get_string(size_t ndx) const
 {
     BinaryData bin = get(ndx);
     if (bin.is_null())
@@ -184,7 +193,7 @@ inline void ArrayBigBlobs::insert_string(size_t ndx, StringData value)
 }
 
 inline StringData ArrayBigBlobs::get_string(const char* header, size_t ndx, Allocator& alloc,
-                                            bool nullable = true) noexcept
+                                            bool nullable = true)
 {
     static_cast<void>(nullable);
     BinaryData bin = get(header, ndx, alloc);
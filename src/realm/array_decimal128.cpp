@@ -234,6 +234,65 @@ size_t ArrayDecimal128::find_first(Decimal128 value, size_t start, size_t end) c
     return realm::npos;
 }
 
+Decimal128 ArrayDecimal128::sum(size_t begin, size_t end, size_t& value_count) const
+{
+    if (end == npos)
+        end = m_size;
+    REALM_ASSERT(begin <= m_size && end <= m_size && begin <= end);
+
+    // A zero width leaf holds either zeros or nulls only. Null is a NaN, so a single test excludes both. The values
+    // are added in element order, so that the result is exactly the same as when accumulating one value at a time.
+    Decimal128 s;
+    size_t count = 0;
+    if (m_width == 0) {
+        count = get_context_flag() ? end - begin : 0;
+    }
+    else {
+        for (size_t i = begin; i < end; ++i) {
+            Decimal128 v = get(i);
+            if (!v.is_nan()) {
+                s += v;
+                ++count;
+            }
+        }
+    }
+    value_count = count;
+    return s;
+}
+
+template <bool max>
+bool ArrayDecimal128::minmax(size_t begin, size_t end, Decimal128* result, size_t* return_ndx) const
+{
+    if (end == npos)
+        end = m_size;
+    REALM_ASSERT(begin <= m_size && end <= m_size && begin <= end);
+
+    size_t ndx = npos;
+    Decimal128 m;
+    if (m_width == 0) {
+        if (get_context_flag() && begin != end)
+            ndx = begin;
+    }
+    else {
+        for (size_t i = begin; i < end; ++i) {
+            Decimal128 v = get(i);
+            if (!v.is_nan() && (ndx == npos || (max ? v > m : v < m))) {
+                m = v;
+                ndx = i;
+            }
+        }
+    }
+    if (ndx == npos)
+        return false;
+    *result = m;
+    if (return_ndx)
+        *return_ndx = ndx;
+    return true;
+}
+
+template bool ArrayDecimal128::minmax<false>(size_t, size_t, Decimal128*, size_t*) const;
+template bool ArrayDecimal128::minmax<true>(size_t, size_t, Decimal128*, size_t*) const;
+
 Mixed ArrayDecimal128::get_any(size_t ndx) const
 {
     return Mixed(get(ndx));
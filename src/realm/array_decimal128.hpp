@@ -112,6 +112,15 @@ public:
 
     size_t find_first(Decimal128 value, size_t begin = 0, size_t end = npos) const noexcept;
 
+    /// Sum of the elements in [begin, end) that are neither null nor NaN.
+    /// `value_count` receives the number of such elements.
+    Decimal128 sum(size_t begin, size_t end, size_t& value_count) const;
+
+    /// Find the smallest (or, if `max` is true, the largest) element in
+    /// [begin, end), ignoring null and NaN. Returns false if there is none.
+    template <bool max>
+    bool minmax(size_t begin, size_t end, Decimal128* result, size_t* return_ndx = nullptr) const;
+
     uint8_t get_width() const noexcept
     {
         return m_width;
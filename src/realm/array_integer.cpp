@@ -113,6 +113,24 @@ void ArrayIntNull::replace_nulls_with(int64_t new_null)
 }
 
 
+bool ArrayIntNull::choose_null_in_width(size_t width, int64_t incoming, int64_t& new_null) const
+{
+    // Try the bounds of the range first, as values cluster in the middle or
+    // at zero. Only a few candidates are tried, as each costs a search.
+    int64_t lbound = Array::lbound_for_width(width);
+    int64_t ubound = Array::ubound_for_width(width);
+    int64_t candidates[] = {ubound, lbound, ubound - 1, lbound + 1};
+    for (int64_t candidate : candidates) {
+        if (candidate < lbound || candidate > ubound || candidate == incoming || candidate == null_value())
+            continue;
+        if (can_use_as_null(candidate)) {
+            new_null = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
 void ArrayIntNull::avoid_null_collision(int64_t value)
 {
     if (m_width == 64) {
@@ -120,32 +138,39 @@ void ArrayIntNull::avoid_null_collision(int64_t value)
             int_fast64_t new_null = choose_random_null(value);
             replace_nulls_with(new_null);
         }
+        return;
     }
-    else {
-        if (value < m_lbound || value >= m_ubound) {
-            size_t new_width = bit_width(value);
-            int64_t new_upper_bound = Array::ubound_for_width(new_width);
-
-            // We're using upper bound as magic NULL value, so we have to check
-            // explicitly that the incoming value doesn't happen to be the new
-            // NULL value. If it is, we upgrade one step further.
-            if (new_width < 64 && value == new_upper_bound) {
-                new_width = (new_width == 0 ? 1 : new_width * 2);
-                new_upper_bound = Array::ubound_for_width(new_width);
-            }
 
-            int64_t new_null;
-            if (new_width == 64) {
-                // Width will be upgraded to 64, so we need to pick a random NULL.
-                new_null = choose_random_null(value);
-            }
-            else {
-                new_null = new_upper_bound;
-            }
-
-            replace_nulls_with(new_null); // Expands array
+    size_t new_width;
+    if (value >= m_lbound && value <= m_ubound) {
+        if (value != null_value())
+            return;
+        // The value fits, but collides with the null value. Rather than
+        // widening the array, pick another null value of the current width
+        // if one is unused.
+        int64_t new_null;
+        if (choose_null_in_width(m_width, value, new_null)) {
+            replace_nulls_with(new_null);
+            return;
         }
+        new_width = (m_width == 0 ? 1 : m_width * 2);
+    }
+    else {
+        new_width = bit_width(value);
+    }
+
+    int64_t new_null;
+    if (new_width == 64) {
+        // Width will be upgraded to 64, so we need to pick a random NULL.
+        new_null = choose_random_null(value);
     }
+    else if (!choose_null_in_width(new_width, value, new_null)) {
+        // Every candidate is in use, so go one step further
+        new_width *= 2;
+        new_null = new_width == 64 ? choose_random_null(value) : Array::ubound_for_width(new_width);
+    }
+
+    replace_nulls_with(new_null); // Expands array
 }
 
 void ArrayIntNull::find_all(IntegerColumn* result, value_type value, size_t col_offset, size_t begin,
@@ -177,6 +202,58 @@ size_t ArrayIntNull::find_first(value_type value, size_t begin, size_t end) cons
     return find_first<Equal>(value, begin, end);
 }
 
+int64_t ArrayIntNull::sum(size_t start, size_t end, size_t& value_count) const
+{
+    if (end == npos)
+        end = size();
+    REALM_ASSERT(start <= end && end <= size());
+
+    // Physical indexes are one higher than the logical ones, as element 0 holds the null value
+    const int64_t null = null_value();
+    QueryStateCount nulls;
+    ArrayWithFind(*this).find<Equal>(null, start + 1, end + 1, 0, &nulls);
+    const size_t null_count = nulls.get_count();
+    value_count = end - start - null_count;
+
+    // Null elements are stored as `null`, so take them out again afterwards. This wraps around on overflow in the
+    // same way as aggregate_operations::Sum.
+    uint64_t s = uint64_t(get_sum(start + 1, end + 1)) - uint64_t(null) * uint64_t(null_count);
+    return int64_t(s);
+}
+
+template <bool max>
+bool ArrayIntNull::minmax(size_t start, size_t end, int64_t* result, size_t* return_ndx) const
+{
+    if (end == npos)
+        end = size();
+    REALM_ASSERT(start <= end && end <= size());
+
+    // Reduce each run of non-null elements in bulk, with the runs separated by the nulls found with the finder
+    const int64_t null = null_value();
+    const size_t phys_end = end + 1;
+    bool found = false;
+    for (size_t pos = start + 1; pos < phys_end;) {
+        size_t next_null = Array::find_first(null, pos, phys_end);
+        if (next_null == not_found)
+            next_null = phys_end;
+        int64_t v;
+        size_t ndx;
+        if (Array::minmax<max>(pos, next_null, &v, return_ndx ? &ndx : nullptr)) {
+            if (!found || (max ? v > *result : v < *result)) {
+                *result = v;
+                if (return_ndx)
+                    *return_ndx = ndx - 1;
+                found = true;
+            }
+        }
+        pos = next_null + 1;
+    }
+    return found;
+}
+
+template bool ArrayIntNull::minmax<true>(size_t, size_t, int64_t*, size_t*) const;
+template bool ArrayIntNull::minmax<false>(size_t, size_t, int64_t*, size_t*) const;
+
 void ArrayIntNull::get_chunk(size_t ndx, value_type res[8]) const noexcept
 {
     // FIXME: Optimize this
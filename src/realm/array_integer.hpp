@@ -70,6 +70,16 @@ public:
     }
     template <class cond>
     bool find(value_type value, size_t start, size_t end, QueryStateBase* state) const;
+
+    /// Sum of the elements in [start, end). `value_count` receives the number
+    /// of elements that were summed, which for this type is all of them.
+    int64_t sum(size_t start, size_t end, size_t& value_count) const
+    {
+        if (end == npos)
+            end = size();
+        value_count = end - start;
+        return get_sum(start, end);
+    }
 };
 
 class ArrayIntNull : public Array, public ArrayPayload {
@@ -139,11 +149,21 @@ public:
 
     size_t find_first(value_type value, size_t begin = 0, size_t end = npos) const;
 
+    /// Sum of the non-null elements in [start, end). `value_count` receives
+    /// the number of non-null elements.
+    int64_t sum(size_t start, size_t end, size_t& value_count) const;
+
+    /// Like Array::minmax(), but ignoring null elements. Returns false if
+    /// there are no non-null elements in the range.
+    template <bool max>
+    bool minmax(size_t start, size_t end, int64_t* result, size_t* return_ndx = nullptr) const;
+
 protected:
     void avoid_null_collision(int64_t value);
 
 private:
     int_fast64_t choose_random_null(int64_t incoming) const;
+    bool choose_null_in_width(size_t width, int64_t incoming, int64_t& new_null) const;
     void replace_nulls_with(int64_t new_null);
     bool can_use_as_null(int64_t value) const;
 
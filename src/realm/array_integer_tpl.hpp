@@ -78,6 +78,45 @@ bool ArrayIntNull::find_impl(value_type opt_value, size_t start, size_t end, Que
         // Fall back to plain Array find.
         return ArrayWithFind(*this).find<cond>(value, start2, end2, baseindex2, state);
     }
+    else if constexpr (std::is_same_v<cond, NotNull>) {
+        return ArrayWithFind(*this).find<NotEqual>(null_value, start2, end2, baseindex2, state);
+    }
+    else if constexpr (std::is_same_v<cond, NotEqual>) {
+        // Nulls differ from every value and values differ from null, so this
+        // is a plain search for elements different from the stored value.
+        // The exception is a value equal to the null value, which no element
+        // holds, so every element matches.
+        if (find_null || *opt_value != null_value) {
+            value = find_null ? null_value : *opt_value;
+            return ArrayWithFind(*this).find<NotEqual>(value, start2, end2, baseindex2, state);
+        }
+        for (size_t i = start2; i < end2; ++i) {
+            if (!state->match(i + baseindex2))
+                return false;
+        }
+        return true;
+    }
+    else if constexpr (std::is_same_v<cond, Greater> || std::is_same_v<cond, Less>) {
+        // Null elements never match an ordering, and nothing matches null
+        if (find_null)
+            return true;
+        value = *opt_value;
+        if (!cond()(null_value, value)) {
+            // The null value doesn't satisfy the condition either, so the
+            // plain search gives the exact result
+            return ArrayWithFind(*this).find<cond>(value, start2, end2, baseindex2, state);
+        }
+        // Search the runs of non-null elements between the nulls
+        for (size_t pos = start2; pos < end2;) {
+            size_t next_null = Array::find_first(null_value, pos, end2);
+            if (next_null == not_found)
+                next_null = end2;
+            if (pos < next_null && !ArrayWithFind(*this).find<cond>(value, pos, next_null, baseindex2, state))
+                return false;
+            pos = next_null + 1;
+        }
+        return true;
+    }
     else {
         cond c;
 
@@ -272,6 +272,29 @@ size_t ArrayMixed::find_first(Mixed value, size_t begin, size_t end) const noexc
     DataType type = value.get_type();
     if (end == realm::npos)
         end = size();
+    if (type == type_Int && !may_hold_payload_numbers()) {
+        // Every number in the leaf is an integer stored in the composite
+        // array, so a vectorized search for the encoded value finds them all
+        int64_t int_val = value.get_int();
+        if (int_val < std::numeric_limits<int32_t>::min() || int_val > std::numeric_limits<int32_t>::max()) {
+            return realm::npos;
+        }
+        return m_composite.find_first(int64_t(static_cast<uint64_t>(int_val) << s_data_shift) + int(type_Int) + 1,
+                                      begin, end);
+    }
+    if (type == type_String) {
+        // Only strings compare equal to a string
+        StringData str = value.get_string();
+        for (size_t i = begin; i < end; i++) {
+            int64_t val = m_composite.get(i);
+            if ((val & s_data_type_mask) == int(type_String) + 1) {
+                ensure_string_array();
+                if (m_strings.get(size_t(val >> s_data_shift)) == str)
+                    return i;
+            }
+        }
+        return realm::npos;
+    }
     for (size_t i = begin; i < end; i++) {
         if (Mixed::data_types_are_comparable(this->get_type(i), type) && get(i) == value) {
             return i;
@@ -280,6 +303,19 @@ size_t ArrayMixed::find_first(Mixed value, size_t begin, size_t end) const noexc
     return realm::npos;
 }
 
+bool ArrayMixed::may_hold_payload_numbers() const
+{
+    // Floats, doubles and big integers are stored in the int payload array, and
+    // decimals in the pair array. Empty or missing arrays hold none of them.
+    for (size_t payload_idx : {size_t(payload_idx_int), size_t(payload_idx_pair)}) {
+        if (ref_type ref = get_as_ref(payload_idx)) {
+            if (NodeHeader::get_size_from_header(Array::get_alloc().translate(ref)) > 0)
+                return true;
+        }
+    }
+    return false;
+}
+
 bool ArrayMixed::ensure_keys()
 {
     if (Array::size() < payload_idx_key + 1 || Array::get(payload_idx_key) == 0) {
@@ -88,6 +88,22 @@ public:
     {
         return m_composite.get(ndx) == 0;
     }
+    // If the element is an integer, store it in `value` and return true. This
+    // is cheaper than get() for leaves where most of the values are integers.
+    bool get_int(size_t ndx, int64_t& value) const
+    {
+        int64_t val = m_composite.get(ndx);
+        if ((val & s_data_type_mask) != int64_t(type_Int) + 1)
+            return false;
+        if (val & s_payload_idx_mask) {
+            ensure_int_array();
+            value = m_ints.get(size_t(val >> s_data_shift));
+        }
+        else {
+            value = val >> s_data_shift;
+        }
+        return true;
+    }
 
     void clear();
     void erase(size_t ndx);
@@ -145,6 +161,9 @@ private:
     void ensure_int_pair_array() const;
     void ensure_string_array() const;
     void ensure_ref_array() const;
+    // True if an element may be a float, double, decimal or an integer not
+    // stored in the composite array
+    bool may_hold_payload_numbers() const;
     void replace_index(size_t old_ndx, size_t new_ndx, size_t payload_index);
     void erase_linked_payload(size_t ndx, bool free_linked_arrays);
 };
@@ -298,7 +298,7 @@ void ArrayString::clear()
     }
 }
 
-size_t ArrayString::find_first(StringData value, size_t begin, size_t end) const noexcept
+size_t ArrayString::find_first(StringData value, size_t begin, size_t end) const
 {
     switch (m_type) {
         case Type::small_strings:
@@ -314,8 +314,7 @@ size_t ArrayString::find_first(StringData value, size_t begin, size_t end) const
             break;
         }
         case Type::enum_strings: {
-            size_t sz = m_string_enum_values->size();
-            size_t res = m_string_enum_values->find_first(value, 0, sz);
+            size_t res = find_enum_index(value);
             if (res != realm::not_found) {
                 return static_cast<Array*>(m_arr)->find_first(res, begin, end);
             }
@@ -325,6 +324,12 @@ size_t ArrayString::find_first(StringData value, size_t begin, size_t end) const
     return not_found;
 }
 
+size_t ArrayString::find_enum_index(StringData value) const noexcept
+{
+    REALM_ASSERT_DEBUG(is_enumerated());
+    return m_string_enum_values->find_first(value, 0, m_string_enum_values->size());
+}
+
 namespace {
 
 template <class T>
@@ -107,7 +107,29 @@ public:
     void move(ArrayString& dst, size_t ndx);
     void clear();
 
-    size_t find_first(StringData value, size_t begin, size_t end) const noexcept;
+    size_t find_first(StringData value, size_t begin, size_t end) const;
+
+    /// Leaves of enumerated columns store an index into the column's keys
+    /// (the distinct values) instead of the string itself. Comparing these
+    /// indexes is much cheaper than comparing strings, so queries resolve
+    /// their arguments once with find_enum_index() and then search on the
+    /// indexes. find_enum_index() returns realm::not_found if the value does
+    /// not occur in the column.
+    bool is_enumerated() const noexcept
+    {
+        return m_type == Type::enum_strings;
+    }
+    size_t find_enum_index(StringData value) const noexcept;
+    size_t get_enum_index(size_t ndx) const noexcept
+    {
+        REALM_ASSERT_DEBUG(is_enumerated());
+        return size_t(m_arr->get(ndx));
+    }
+    size_t find_first_enum_index(size_t enum_ndx, size_t begin, size_t end) const noexcept
+    {
+        REALM_ASSERT_DEBUG(is_enumerated());
+        return m_arr->find_first(int64_t(enum_ndx), begin, end);
+    }
 
     size_t lower_bound(StringData value);
 
@@ -115,7 +137,7 @@ public:
     /// array instance. If an array instance is already available, or
     /// you need to get multiple values, then this method will be
     /// slower.
-    static StringData get(const char* header, size_t ndx, Allocator& alloc) noexcept;
+    static StringData get(const char* header, size_t ndx, Allocator& alloc);
 
     void verify() const;
 
@@ -143,7 +165,7 @@ private:
     Type upgrade_leaf(size_t value_size);
 };
 
-inline StringData ArrayString::get(const char* header, size_t ndx, Allocator& alloc) noexcept
+inline StringData ArrayString::get(const char* header, size_t ndx, Allocator& alloc)
 {
     bool long_strings = Array::get_hasrefs_from_header(header);
     if (!long_strings) {
@@ -31,6 +31,7 @@ public:
 
     explicit ArrayTimestamp(Allocator&);
 
+    using Array::get_alloc;
     using Array::update_parent;
     using Array::get_parent;
     using Array::get_ndx_in_parent;
@@ -110,6 +111,8 @@ public:
     void verify() const;
 
 private:
+    friend class ZoneMap;
+
     ArrayIntNull m_seconds;
     ArrayInteger m_nanoseconds;
 };
@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <realm/array_with_find.hpp>
+#include <realm/mixed.hpp>
 
 namespace realm {
 
@@ -60,6 +61,26 @@ bool ArrayWithFind::find(int cond, int64_t value, size_t start, size_t end, size
     return false;
 }
 
+bool QueryStateRebase::match(size_t index, Mixed value) noexcept
+{
+    // A state aggregating another column takes its values from that column,
+    // so only the index is passed on.
+    if (m_state.has_payload_column())
+        return match(index);
+    if (value.is_type(type_Int))
+        value = Mixed(value.get_int() + m_base);
+    bool cont = m_state.match(index, value);
+    m_match_count = m_state.match_count();
+    return cont;
+}
+
+bool QueryStateRebase::match(size_t index) noexcept
+{
+    bool cont = m_state.match(index);
+    m_match_count = m_state.match_count();
+    return cont;
+}
+
 size_t ArrayWithFind::first_set_bit(uint32_t v) const
 {
     // (v & -v) is UB when v is INT_MIN
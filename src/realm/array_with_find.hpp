@@ -48,6 +48,12 @@ Searching: The main finding function is:
 #include <emmintrin.h>             // SSE2
 #include <realm/realm_nmmintrin.h> // SSE42
 #endif
+#ifdef REALM_COMPILER_AVX
+#include <immintrin.h> // AVX2, only used from functions marked REALM_TARGET_AVX2
+#endif
+#ifdef REALM_COMPILER_NEON
+#include <arm_neon.h>
+#endif
 
 namespace realm {
 
@@ -81,6 +87,25 @@ inline constexpr uint64_t lower_bits()
 }
 } // namespace
 
+// Forwards the matches found in an encoded array to another state, adding the
+// base of the array to the values that the finders report.
+class QueryStateRebase : public QueryStateBase {
+public:
+    QueryStateRebase(QueryStateBase& state, int64_t base) noexcept
+        : QueryStateBase(state.limit())
+        , m_state(state)
+        , m_base(base)
+    {
+        m_match_count = state.match_count();
+    }
+    bool match(size_t index, Mixed value) noexcept final;
+    bool match(size_t index) noexcept final;
+
+private:
+    QueryStateBase& m_state;
+    const int64_t m_base;
+};
+
 class ArrayWithFind {
 public:
     ArrayWithFind(const Array& array) noexcept
@@ -131,6 +156,19 @@ public:
 
 #endif
 
+// AVX2 find for the four functions Equal/NotEqual/Less/Greater. Unlike SSE, this also covers Less on 64 bit values
+#ifdef REALM_COMPILER_AVX
+    template <class cond, size_t width>
+    REALM_TARGET_AVX2 bool find_avx2(int64_t value, size_t start, size_t end, size_t baseindex,
+                                     QueryStateBase* state) const;
+#endif
+
+// NEON find for the four functions Equal/NotEqual/Less/Greater
+#ifdef REALM_COMPILER_NEON
+    template <class cond, size_t width>
+    bool find_neon(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const;
+#endif
+
     template <size_t width>
     inline bool test_zero(uint64_t value) const; // Tests value for 0-elements
 
@@ -158,6 +196,11 @@ public:
     template <class cond, size_t bitwidth>
     bool find_optimized(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const;
 
+    // Same as find_optimized(), but 'value' is compared directly with the
+    // stored elements, also when the array is encoded
+    template <class cond, size_t bitwidth>
+    bool find_packed(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const;
+
 private:
     const Array& m_array;
 
@@ -296,6 +339,20 @@ REALM_NOINLINE bool ArrayWithFind::find_all_will_match(size_t start2, size_t end
 template <class cond, size_t bitwidth>
 bool ArrayWithFind::find_optimized(int64_t value, size_t start, size_t end, size_t baseindex,
                                    QueryStateBase* state) const
+{
+    if (REALM_LIKELY(!m_array.m_is_encoded))
+        return find_packed<cond, bitwidth>(value, start, end, baseindex, state);
+
+    // The elements of an encoded array are differences from a common base,
+    // so the kernels below can run directly on them when the searched value
+    // is translated in the same way.
+    QueryStateRebase rebased(*state, m_array.m_base);
+    return find_packed<cond, bitwidth>(m_array.delta_for(value), start, end, baseindex, &rebased);
+}
+
+template <class cond, size_t bitwidth>
+bool ArrayWithFind::find_packed(int64_t value, size_t start, size_t end, size_t baseindex,
+                                QueryStateBase* state) const
 {
     REALM_ASSERT_DEBUG(start <= m_array.m_size && (end <= m_array.m_size || end == size_t(-1)) && start <= end);
 
@@ -324,6 +381,23 @@ bool ArrayWithFind::find_optimized(int64_t value, size_t start, size_t end, size
     // finder cannot handle this bitwidth
     REALM_ASSERT_3(m_array.m_width, !=, 0);
 
+    constexpr bool simd_cond = std::is_same_v<cond, Equal> || std::is_same_v<cond, NotEqual> ||
+                               std::is_same_v<cond, Greater> || std::is_same_v<cond, Less>;
+
+#if defined(REALM_COMPILER_AVX)
+    // Prefer AVX2 when available and the payload spans at least one 256 bit chunk
+    if constexpr (simd_cond && bitwidth >= 8) {
+        if (end - start2 >= 256 / bitwidth && sseavx<2>())
+            return find_avx2<cond, bitwidth>(value, start2, end, baseindex, state);
+    }
+#endif
+#if defined(REALM_COMPILER_NEON)
+    if constexpr (simd_cond && bitwidth >= 8) {
+        if (end - start2 >= 128 / bitwidth)
+            return find_neon<cond, bitwidth>(value, start2, end, baseindex, state);
+    }
+#endif
+
 #if defined(REALM_COMPILER_SSE)
     // Only use SSE if payload is at least one SSE chunk (128 bits) in size. Also note taht SSE doesn't support
     // Less-than comparison for 64-bit values.
@@ -738,6 +812,151 @@ REALM_FORCEINLINE bool ArrayWithFind::find_sse_intern(__m128i* action_data, __m1
 }
 #endif // REALM_COMPILER_SSE
 
+#ifdef REALM_COMPILER_AVX
+// Searches [start, end) using 256 bit compares on the 32-byte aligned part of the range and compare() on the
+// unaligned head and tail.
+template <class cond, size_t width>
+REALM_TARGET_AVX2 bool ArrayWithFind::find_avx2(int64_t value, size_t start, size_t end, size_t baseindex,
+                                                QueryStateBase* state) const
+{
+    char* const a = static_cast<char*>(round_up(m_array.m_data + start * width / 8, sizeof(__m256i)));
+    char* const b = static_cast<char*>(round_down(m_array.m_data + end * width / 8, sizeof(__m256i)));
+    if (b <= a)
+        return compare<cond, width>(value, start, end, baseindex, state);
+
+    const size_t a_ndx = (a - m_array.m_data) * 8 / width;
+    const size_t b_ndx = (b - m_array.m_data) * 8 / width;
+    if (!compare<cond, width>(value, start, a_ndx, baseindex, state))
+        return false;
+
+    __m256i search;
+    if constexpr (width == 8)
+        search = _mm256_set1_epi8(static_cast<char>(value));
+    else if constexpr (width == 16)
+        search = _mm256_set1_epi16(static_cast<short int>(value));
+    else if constexpr (width == 32)
+        search = _mm256_set1_epi32(static_cast<int>(value));
+    else
+        search = _mm256_set1_epi64x(value);
+
+    const __m256i* data = reinterpret_cast<const __m256i*>(a);
+    const size_t items = (b - a) / sizeof(__m256i);
+    for (size_t i = 0; i < items; ++i) {
+        __m256i chunk = _mm256_load_si256(data + i);
+        __m256i compare_result;
+        if constexpr (std::is_same_v<cond, Equal> || std::is_same_v<cond, NotEqual>) {
+            if constexpr (width == 8)
+                compare_result = _mm256_cmpeq_epi8(chunk, search);
+            else if constexpr (width == 16)
+                compare_result = _mm256_cmpeq_epi16(chunk, search);
+            else if constexpr (width == 32)
+                compare_result = _mm256_cmpeq_epi32(chunk, search);
+            else
+                compare_result = _mm256_cmpeq_epi64(chunk, search);
+        }
+        else {
+            // Less is Greater with the operands swapped
+            __m256i lhs = std::is_same_v<cond, Greater> ? chunk : search;
+            __m256i rhs = std::is_same_v<cond, Greater> ? search : chunk;
+            if constexpr (width == 8)
+                compare_result = _mm256_cmpgt_epi8(lhs, rhs);
+            else if constexpr (width == 16)
+                compare_result = _mm256_cmpgt_epi16(lhs, rhs);
+            else if constexpr (width == 32)
+                compare_result = _mm256_cmpgt_epi32(lhs, rhs);
+            else
+                compare_result = _mm256_cmpgt_epi64(lhs, rhs);
+        }
+
+        // One bit per byte. Kept in 64 bits so that shifting past the last element is well defined.
+        uint64_t resmask = uint32_t(_mm256_movemask_epi8(compare_result));
+        if constexpr (std::is_same_v<cond, NotEqual>)
+            resmask = ~resmask & 0xffffffffULL;
+
+        size_t s = a_ndx + i * sizeof(__m256i) * 8 / width;
+        while (resmask != 0) {
+            size_t idx = first_set_bit64(resmask) * 8 / width;
+            s += idx;
+            if (!state->match(s + baseindex))
+                return false;
+            resmask >>= (idx + 1) * width / 8;
+            ++s;
+        }
+    }
+
+    return compare<cond, width>(value, b_ndx, end, baseindex, state);
+}
+#endif // REALM_COMPILER_AVX
+
+#ifdef REALM_COMPILER_NEON
+// Searches [start, end) using 128 bit NEON compares. Loads don't need to be aligned, but we align anyway so that no
+// block straddles a cache line.
+template <class cond, size_t width>
+bool ArrayWithFind::find_neon(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const
+{
+    char* const a = static_cast<char*>(round_up(m_array.m_data + start * width / 8, 16));
+    char* const b = static_cast<char*>(round_down(m_array.m_data + end * width / 8, 16));
+    if (b <= a)
+        return compare<cond, width>(value, start, end, baseindex, state);
+
+    const size_t a_ndx = (a - m_array.m_data) * 8 / width;
+    const size_t b_ndx = (b - m_array.m_data) * 8 / width;
+    if (!compare<cond, width>(value, start, a_ndx, baseindex, state))
+        return false;
+
+    constexpr bool eq = std::is_same_v<cond, Equal> || std::is_same_v<cond, NotEqual>;
+    constexpr bool gt = std::is_same_v<cond, Greater>;
+    for (const char* p = a; p < b; p += 16) {
+        uint8x16_t compare_result;
+        if constexpr (width == 8) {
+            int8x16_t chunk = vld1q_s8(reinterpret_cast<const int8_t*>(p));
+            int8x16_t search = vdupq_n_s8(int8_t(value));
+            compare_result = eq ? vceqq_s8(chunk, search) : gt ? vcgtq_s8(chunk, search) : vcltq_s8(chunk, search);
+        }
+        else if constexpr (width == 16) {
+            int16x8_t chunk = vld1q_s16(reinterpret_cast<const int16_t*>(p));
+            int16x8_t search = vdupq_n_s16(int16_t(value));
+            compare_result = vreinterpretq_u8_u16(eq   ? vceqq_s16(chunk, search)
+                                                  : gt ? vcgtq_s16(chunk, search)
+                                                       : vcltq_s16(chunk, search));
+        }
+        else if constexpr (width == 32) {
+            int32x4_t chunk = vld1q_s32(reinterpret_cast<const int32_t*>(p));
+            int32x4_t search = vdupq_n_s32(int32_t(value));
+            compare_result = vreinterpretq_u8_u32(eq   ? vceqq_s32(chunk, search)
+                                                  : gt ? vcgtq_s32(chunk, search)
+                                                       : vcltq_s32(chunk, search));
+        }
+        else {
+            int64x2_t chunk = vld1q_s64(reinterpret_cast<const int64_t*>(p));
+            int64x2_t search = vdupq_n_s64(value);
+            compare_result = vreinterpretq_u8_u64(eq   ? vceqq_s64(chunk, search)
+                                                  : gt ? vcgtq_s64(chunk, search)
+                                                       : vcltq_s64(chunk, search));
+        }
+
+        // NEON has no movemask, so narrow every byte of the comparison result to 4 bits instead
+        uint64_t resmask =
+            vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(compare_result), 4)), 0);
+        if constexpr (std::is_same_v<cond, NotEqual>)
+            resmask = ~resmask;
+
+        size_t s = a_ndx + (p - a) * 8 / width;
+        while (resmask != 0) {
+            size_t idx = first_set_bit64(resmask) * 2 / width;
+            s += idx;
+            if (!state->match(s + baseindex))
+                return false;
+            size_t shift = (idx + 1) * width / 2;
+            resmask = shift < 64 ? resmask >> shift : 0;
+            ++s;
+        }
+    }
+
+    return compare<cond, width>(value, b_ndx, end, baseindex, state);
+}
+#endif // REALM_COMPILER_NEON
+
 template <class cond>
 bool ArrayWithFind::compare_leafs(const Array* foreign, size_t start, size_t end, size_t baseindex,
                                   QueryStateBase* state) const
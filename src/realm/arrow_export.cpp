@@ -0,0 +1,632 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/arrow_export.hpp>
+
+#include <realm/array_basic.hpp>
+#include <realm/array_binary.hpp>
+#include <realm/array_bool.hpp>
+#include <realm/array_fixed_bytes.hpp>
+#include <realm/array_integer.hpp>
+#include <realm/array_string.hpp>
+#include <realm/array_timestamp.hpp>
+#include <realm/cluster.hpp>
+#include <realm/table.hpp>
+#include <realm/table_view.hpp>
+#include <realm/transaction.hpp>
+#include <realm/util/function_ref.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+using namespace realm;
+
+namespace {
+
+// Buffers of one exported column of a batch. Buffers are either owned, or
+// point into the file mapping of the snapshot held on to.
+struct ColumnData {
+    std::vector<std::vector<char>> owned;
+    const void* buffers[3] = {nullptr, nullptr, nullptr};
+    TransactionRef snapshot;
+};
+
+struct BatchData {
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray*> child_ptrs;
+    const void* buffers[1] = {nullptr};
+};
+
+struct SchemaData {
+    std::vector<std::string> names;
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema*> child_ptrs;
+};
+
+void release_column(ArrowArray* array)
+{
+    delete static_cast<ColumnData*>(array->private_data);
+    array->release = nullptr;
+}
+
+void release_batch(ArrowArray* array)
+{
+    auto data = static_cast<BatchData*>(array->private_data);
+    // Consumers may have moved children out of the batch and released them
+    for (auto& child : data->children) {
+        if (child.release)
+            child.release(&child);
+    }
+    delete data;
+    array->release = nullptr;
+}
+
+void release_child_schema(ArrowSchema* schema)
+{
+    schema->release = nullptr;
+}
+
+void release_schema(ArrowSchema* schema)
+{
+    auto data = static_cast<SchemaData*>(schema->private_data);
+    for (auto& child : data->children) {
+        if (child.release)
+            child.release(&child);
+    }
+    delete data;
+    schema->release = nullptr;
+}
+
+const char* arrow_format(DataType type)
+{
+    switch (type) {
+        case type_Int:
+            return "l";
+        case type_Bool:
+            return "b";
+        case type_Float:
+            return "f";
+        case type_Double:
+            return "g";
+        case type_Timestamp:
+            return "tsn:";
+        case type_String:
+            return "U";
+        case type_Binary:
+            return "Z";
+        case type_ObjectId:
+            return "w:12";
+        case type_UUID:
+            return "w:16";
+        default:
+            return nullptr;
+    }
+}
+
+// Fills in the ArrowArray of one column of a batch
+class ColumnBuilder {
+public:
+    ColumnBuilder(ArrowArray* out, size_t length)
+        : m_out(out)
+        , m_data(new ColumnData)
+        , m_length(length)
+    {
+    }
+    ~ColumnBuilder()
+    {
+        delete m_data;
+    }
+
+    template <class T>
+    T* alloc(size_t buffer_ndx, size_t count)
+    {
+        auto& buffer = m_data->owned.emplace_back(count * sizeof(T));
+        m_data->buffers[buffer_ndx] = buffer.data();
+        return reinterpret_cast<T*>(buffer.data());
+    }
+    void reference(size_t buffer_ndx, const void* data, const TransactionRef& snapshot)
+    {
+        m_data->buffers[buffer_ndx] = data;
+        m_data->snapshot = snapshot;
+    }
+    void set_null(size_t ndx)
+    {
+        if (!m_validity) {
+            m_validity = alloc<uint8_t>(0, (m_length + 7) / 8);
+            memset(m_validity, 0xff, (m_length + 7) / 8);
+        }
+        m_validity[ndx / 8] &= uint8_t(~(1 << (ndx % 8)));
+        ++m_null_count;
+    }
+    void finish(size_t n_buffers)
+    {
+        m_out->length = int64_t(m_length);
+        m_out->null_count = int64_t(m_null_count);
+        m_out->offset = 0;
+        m_out->n_buffers = int64_t(n_buffers);
+        m_out->n_children = 0;
+        m_out->buffers = m_data->buffers;
+        m_out->children = nullptr;
+        m_out->dictionary = nullptr;
+        m_out->release = release_column;
+        m_out->private_data = m_data;
+        m_data = nullptr;
+    }
+
+private:
+    ArrowArray* m_out;
+    ColumnData* m_data;
+    size_t m_length;
+    uint8_t* m_validity = nullptr;
+    size_t m_null_count = 0;
+};
+
+using ValueGetter = util::FunctionRef<Mixed(size_t)>;
+
+int64_t timestamp_to_nanoseconds(Timestamp ts)
+{
+    constexpr int64_t max_seconds = std::numeric_limits<int64_t>::max() / 1000000000 - 1;
+    int64_t seconds = ts.get_seconds();
+    if (seconds > max_seconds)
+        return std::numeric_limits<int64_t>::max();
+    if (seconds < -max_seconds)
+        return std::numeric_limits<int64_t>::min();
+    return seconds * 1000000000 + ts.get_nanoseconds();
+}
+
+template <class T>
+void transcode_values(ColumnBuilder& builder, size_t length, ValueGetter get)
+{
+    T* values = builder.alloc<T>(1, length);
+    for (size_t i = 0; i < length; ++i) {
+        Mixed value = get(i);
+        if (value.is_null()) {
+            builder.set_null(i);
+            values[i] = T();
+        }
+        else if constexpr (std::is_same_v<T, int64_t>) {
+            if (value.get_type() == type_Timestamp)
+                values[i] = timestamp_to_nanoseconds(value.get<Timestamp>());
+            else
+                values[i] = value.get<Int>();
+        }
+        else {
+            values[i] = value.get<T>();
+        }
+    }
+    builder.finish(2);
+}
+
+void transcode_bools(ColumnBuilder& builder, size_t length, ValueGetter get)
+{
+    uint8_t* bits = builder.alloc<uint8_t>(1, (length + 7) / 8);
+    for (size_t i = 0; i < length; ++i) {
+        Mixed value = get(i);
+        if (value.is_null())
+            builder.set_null(i);
+        else if (value.get<bool>())
+            bits[i / 8] |= uint8_t(1 << (i % 8));
+    }
+    builder.finish(2);
+}
+
+void transcode_blobs(ColumnBuilder& builder, size_t length, ValueGetter get)
+{
+    int64_t* offsets = builder.alloc<int64_t>(1, length + 1);
+    std::vector<char> bytes;
+    offsets[0] = 0;
+    for (size_t i = 0; i < length; ++i) {
+        Mixed value = get(i);
+        if (value.is_null()) {
+            builder.set_null(i);
+        }
+        else {
+            if (value.get_type() == type_String) {
+                StringData str = value.get<StringData>();
+                bytes.insert(bytes.end(), str.data(), str.data() + str.size());
+            }
+            else {
+                BinaryData bin = value.get<BinaryData>();
+                bytes.insert(bytes.end(), bin.data(), bin.data() + bin.size());
+            }
+        }
+        offsets[i + 1] = int64_t(bytes.size());
+    }
+    char* data = builder.alloc<char>(2, bytes.size());
+    if (!bytes.empty())
+        memcpy(data, bytes.data(), bytes.size());
+    builder.finish(3);
+}
+
+template <class T>
+void transcode_fixed_bytes(ColumnBuilder& builder, size_t length, ValueGetter get)
+{
+    constexpr size_t width = T::num_bytes;
+    char* data = builder.alloc<char>(1, length * width);
+    for (size_t i = 0; i < length; ++i) {
+        Mixed value = get(i);
+        if (value.is_null()) {
+            builder.set_null(i);
+        }
+        else {
+            auto bytes = value.get<T>().to_bytes();
+            memcpy(data + i * width, bytes.data(), width);
+        }
+    }
+    builder.finish(2);
+}
+
+void transcode(DataType type, ArrowArray* out, size_t length, ValueGetter get)
+{
+    ColumnBuilder builder(out, length);
+    switch (type) {
+        case type_Int:
+        case type_Timestamp:
+            transcode_values<int64_t>(builder, length, get);
+            break;
+        case type_Bool:
+            transcode_bools(builder, length, get);
+            break;
+        case type_Float:
+            transcode_values<float>(builder, length, get);
+            break;
+        case type_Double:
+            transcode_values<double>(builder, length, get);
+            break;
+        case type_String:
+        case type_Binary:
+            transcode_blobs(builder, length, get);
+            break;
+        case type_ObjectId:
+            transcode_fixed_bytes<ObjectId>(builder, length, get);
+            break;
+        case type_UUID:
+            transcode_fixed_bytes<UUID>(builder, length, get);
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+// Reference the values of `leaf` in place, building only the validity bitmap
+// of nullable leaves. Returns false if the layout of the leaf does not match.
+template <class Leaf>
+bool reference_values(const Leaf& leaf, size_t data_offset, ArrowArray* out, const TransactionRef& snapshot)
+{
+    size_t length = leaf.size();
+    ColumnBuilder builder(out, length);
+    const char* data = NodeHeader::get_data_from_header(leaf.get_header());
+    builder.reference(1, data + data_offset, snapshot);
+    for (size_t i = 0; i < length; ++i) {
+        if (leaf.is_null(i))
+            builder.set_null(i);
+    }
+    builder.finish(2);
+    return true;
+}
+
+bool reference_leaf(const Cluster& cluster, ColKey col, ArrowArray* out, const TransactionRef& snapshot)
+{
+    Allocator& alloc = cluster.get_alloc();
+    bool nullable = col.is_nullable();
+    switch (col.get_type()) {
+        case col_type_Int:
+            if (nullable) {
+                ArrayIntNull leaf(alloc);
+                cluster.init_leaf(col, &leaf);
+                if (leaf.get_width() != 64 || leaf.is_encoded())
+                    return false;
+                // The first element holds the null value
+                return reference_values(leaf, sizeof(int64_t), out, snapshot);
+            }
+            else {
+                ArrayInteger leaf(alloc);
+                cluster.init_leaf(col, &leaf);
+                if (leaf.get_width() != 64 || leaf.is_encoded())
+                    return false;
+                return reference_values(leaf, 0, out, snapshot);
+            }
+        case col_type_Bool:
+            if (!nullable) {
+                ArrayBool leaf(alloc);
+                cluster.init_leaf(col, &leaf);
+                // Bits are packed from the least significant bit, as in Arrow
+                if (leaf.get_width() != 1)
+                    return false;
+                return reference_values(leaf, 0, out, snapshot);
+            }
+            return false;
+        case col_type_Float:
+            if (nullable) {
+                ArrayFloatNull leaf(alloc);
+                cluster.init_leaf(col, &leaf);
+                return reference_values(leaf, 0, out, snapshot);
+            }
+            else {
+                ArrayFloat leaf(alloc);
+                cluster.init_leaf(col, &leaf);
+                return reference_values(leaf, 0, out, snapshot);
+            }
+        case col_type_Double:
+            if (nullable) {
+                ArrayDoubleNull leaf(alloc);
+                cluster.init_leaf(col, &leaf);
+                return reference_values(leaf, 0, out, snapshot);
+            }
+            else {
+                ArrayDouble leaf(alloc);
+                cluster.init_leaf(col, &leaf);
+                return reference_values(leaf, 0, out, snapshot);
+            }
+        default:
+            return false;
+    }
+}
+
+std::unique_ptr<ArrayPayload> create_leaf(Allocator& alloc, ColKey col)
+{
+    switch (col.get_type()) {
+        case col_type_Int:
+            if (col.is_nullable())
+                return std::make_unique<ArrayIntNull>(alloc);
+            return std::make_unique<ArrayInteger>(alloc);
+        case col_type_Bool:
+            return std::make_unique<ArrayBoolNull>(alloc);
+        case col_type_Float:
+            return std::make_unique<ArrayFloatNull>(alloc);
+        case col_type_Double:
+            return std::make_unique<ArrayDoubleNull>(alloc);
+        case col_type_Timestamp:
+            return std::make_unique<ArrayTimestamp>(alloc);
+        case col_type_String:
+            return std::make_unique<ArrayString>(alloc);
+        case col_type_Binary:
+            return std::make_unique<ArrayBinary>(alloc);
+        case col_type_ObjectId:
+            return std::make_unique<ArrayObjectIdNull>(alloc);
+        case col_type_UUID:
+            return std::make_unique<ArrayUUIDNull>(alloc);
+        default:
+            break;
+    }
+    REALM_UNREACHABLE();
+}
+
+void make_batch(ArrowArray* out, size_t length, size_t num_columns,
+                util::FunctionRef<void(size_t, ArrowArray*)> fill_column)
+{
+    auto data = std::make_unique<BatchData>();
+    data->children.resize(num_columns);
+    for (auto& child : data->children)
+        child.release = nullptr;
+    try {
+        for (size_t i = 0; i < num_columns; ++i) {
+            fill_column(i, &data->children[i]);
+            data->child_ptrs.push_back(&data->children[i]);
+        }
+    }
+    catch (...) {
+        for (auto& child : data->children) {
+            if (child.release)
+                child.release(&child);
+        }
+        throw;
+    }
+    out->length = int64_t(length);
+    out->null_count = 0;
+    out->offset = 0;
+    out->n_buffers = 1;
+    out->n_children = int64_t(num_columns);
+    out->buffers = data->buffers;
+    out->children = data->child_ptrs.data();
+    out->dictionary = nullptr;
+    out->release = release_batch;
+    out->private_data = data.release();
+}
+
+} // anonymous namespace
+
+ArrowExporter::ArrowExporter(const TransactionRef& tr, ConstTableRef table, std::vector<ColKey> columns)
+    : m_tr(tr->is_frozen() ? tr : tr->freeze())
+    , m_table(m_tr->import_copy_of(table))
+{
+    init_columns(std::move(columns));
+    m_table->traverse_clusters([&](const Cluster* cluster) {
+        if (cluster->node_size() > 0)
+            m_cluster_keys.push_back(cluster->get_real_key(0));
+        return IteratorControl::AdvanceToNext;
+    });
+    m_zero_copy = m_tr->get_db()->get_encryption_key() == nullptr;
+}
+
+ArrowExporter::ArrowExporter(const TransactionRef& tr, TableView& view, std::vector<ColKey> columns,
+                             size_t batch_size)
+    : m_tr(tr->is_frozen() ? tr : tr->freeze())
+    , m_view(m_tr->import_copy_of(view, PayloadPolicy::Copy))
+    , m_batch_size(batch_size)
+{
+    if (batch_size == 0)
+        throw InvalidArgument("Batch size must be positive");
+    m_table = m_view->get_target_table();
+    init_columns(std::move(columns));
+}
+
+ArrowExporter::~ArrowExporter() = default;
+
+bool ArrowExporter::type_supported(ColKey col) noexcept
+{
+    return !col.is_collection() && arrow_format(DataType(col.get_type())) != nullptr;
+}
+
+void ArrowExporter::init_columns(std::vector<ColKey> columns)
+{
+    if (columns.empty()) {
+        for (auto col : m_table->get_column_keys()) {
+            if (type_supported(col))
+                m_columns.push_back(col);
+        }
+        return;
+    }
+    for (auto col : columns) {
+        m_table->check_column(col);
+        if (!type_supported(col))
+            throw IllegalOperation(util::format("Cannot export column '%1' of type %2 to Arrow",
+                                                m_table->get_column_name(col), col.get_type()));
+    }
+    m_columns = std::move(columns);
+}
+
+size_t ArrowExporter::get_num_batches() const noexcept
+{
+    if (m_view)
+        return (m_view->size() + m_batch_size - 1) / m_batch_size;
+    return m_cluster_keys.size();
+}
+
+void ArrowExporter::get_schema(ArrowSchema* out) const
+{
+    auto data = std::make_unique<SchemaData>();
+    size_t num_columns = m_columns.size();
+    data->names.reserve(num_columns);
+    data->children.resize(num_columns);
+    for (size_t i = 0; i < num_columns; ++i) {
+        ColKey col = m_columns[i];
+        auto& child = data->children[i];
+        data->names.emplace_back(m_table->get_column_name(col));
+        child.format = arrow_format(DataType(col.get_type()));
+        child.name = data->names.back().c_str();
+        child.metadata = nullptr;
+        child.flags = col.is_nullable() || m_view ? ARROW_FLAG_NULLABLE : 0;
+        child.n_children = 0;
+        child.children = nullptr;
+        child.dictionary = nullptr;
+        child.release = release_child_schema;
+        child.private_data = nullptr;
+        data->child_ptrs.push_back(&child);
+    }
+    out->format = "+s";
+    out->name = "";
+    out->metadata = nullptr;
+    out->flags = 0;
+    out->n_children = int64_t(num_columns);
+    out->children = data->child_ptrs.data();
+    out->dictionary = nullptr;
+    out->release = release_schema;
+    out->private_data = data.release();
+}
+
+bool ArrowExporter::get_next(ArrowArray* out)
+{
+    out->release = nullptr;
+    if (m_next_batch >= get_num_batches())
+        return false;
+    size_t batch = m_next_batch++;
+    if (m_view) {
+        size_t begin = batch * m_batch_size;
+        export_view_range(begin, std::min(begin + m_batch_size, m_view->size()), out);
+    }
+    else {
+        export_cluster(m_cluster_keys[batch], out);
+    }
+    return true;
+}
+
+void ArrowExporter::export_cluster(ObjKey first_key, ArrowArray* out)
+{
+    const ClusterTree& tree = m_table->m_clusters;
+    Cluster cluster(0, m_table->get_alloc(), tree);
+    ClusterNode::IteratorState state(cluster);
+    bool found = tree.get_leaf(first_key, state);
+    REALM_ASSERT(found);
+    size_t length = cluster.node_size();
+
+    make_batch(out, length, m_columns.size(), [&](size_t i, ArrowArray* child) {
+        ColKey col = m_columns[i];
+        if (m_zero_copy && reference_leaf(cluster, col, child, m_tr))
+            return;
+        auto leaf = create_leaf(cluster.get_alloc(), col);
+        cluster.init_leaf(col, leaf.get());
+        transcode(DataType(col.get_type()), child, length, [&](size_t ndx) {
+            return leaf->get_any(ndx);
+        });
+    });
+}
+
+void ArrowExporter::export_view_range(size_t begin, size_t end, ArrowArray* out)
+{
+    size_t length = end - begin;
+    std::vector<Obj> objects;
+    objects.reserve(length);
+    for (size_t i = begin; i < end; ++i)
+        objects.push_back(m_view->is_obj_valid(i) ? m_view->get_object(i) : Obj());
+
+    make_batch(out, length, m_columns.size(), [&](size_t i, ArrowArray* child) {
+        ColKey col = m_columns[i];
+        transcode(DataType(col.get_type()), child, length, [&](size_t ndx) {
+            auto& obj = objects[ndx];
+            return obj.is_valid() ? obj.get_any(col) : Mixed();
+        });
+    });
+}
+
+namespace {
+
+struct StreamData {
+    std::unique_ptr<ArrowExporter> exporter;
+    std::string last_error;
+};
+
+template <class F>
+int stream_call(ArrowArrayStream* stream, F&& func)
+{
+    auto data = static_cast<StreamData*>(stream->private_data);
+    try {
+        func(*data->exporter);
+        return 0;
+    }
+    catch (const std::exception& e) {
+        data->last_error = e.what();
+        return EIO;
+    }
+}
+
+} // anonymous namespace
+
+void ArrowExporter::export_stream(std::unique_ptr<ArrowExporter> exporter, ArrowArrayStream* out)
+{
+    out->get_schema = [](ArrowArrayStream* stream, ArrowSchema* schema) {
+        return stream_call(stream, [&](ArrowExporter& e) {
+            e.get_schema(schema);
+        });
+    };
+    out->get_next = [](ArrowArrayStream* stream, ArrowArray* array) {
+        return stream_call(stream, [&](ArrowExporter& e) {
+            e.get_next(array);
+        });
+    };
+    out->get_last_error = [](ArrowArrayStream* stream) {
+        auto data = static_cast<StreamData*>(stream->private_data);
+        return data->last_error.empty() ? static_cast<const char*>(nullptr) : data->last_error.c_str();
+    };
+    out->release = [](ArrowArrayStream* stream) {
+        delete static_cast<StreamData*>(stream->private_data);
+        stream->release = nullptr;
+    };
+    out->private_data = new StreamData{std::move(exporter), {}};
+}
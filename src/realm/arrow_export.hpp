@@ -0,0 +1,182 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_ARROW_EXPORT_HPP
+#define REALM_ARROW_EXPORT_HPP
+
+#include <realm/keys.hpp>
+#include <realm/table_ref.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The Apache Arrow C data interface and C stream interface. These definitions
+// are ABI stable and meant to be copied verbatim, so that libraries can
+// exchange data without depending on each other.
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+    // Callbacks providing stream functionality
+    int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+    int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+    const char* (*get_last_error)(struct ArrowArrayStream*);
+
+    // Release callback
+    void (*release)(struct ArrowArrayStream*);
+
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif // ARROW_C_STREAM_INTERFACE
+
+namespace realm {
+
+class TableView;
+class Transaction;
+using TransactionRef = std::shared_ptr<Transaction>;
+
+/// Export of the objects of a table or a table view as Apache Arrow record
+/// batches, using the Arrow C data interface.
+///
+/// Each batch is a struct array with one child per exported column. The
+/// columns are exported as follows:
+///
+///     Int        int64 ("l")
+///     Bool       boolean ("b")
+///     Float      float32 ("f")
+///     Double     float64 ("g")
+///     Timestamp  timestamp with nanoseconds since the epoch ("tsn:"), values
+///                outside the range of int64 nanoseconds are clamped
+///     String     large utf8 ("U")
+///     Binary     large binary ("Z")
+///     ObjectId   fixed size binary of 12 bytes ("w:12")
+///     UUID       fixed size binary of 16 bytes ("w:16")
+///
+/// Other column types, and collection columns, are not supported.
+///
+/// The export works on a frozen transaction, which is created when the
+/// transaction passed in is not frozen already. Arrays of a batch hold on to
+/// that transaction, so they stay valid after the exporter is destroyed, and
+/// until they are released.
+///
+/// When exporting a table, there is one batch per cluster of the table.
+/// Leaves whose layout matches the Arrow layout are referenced in place rather
+/// than copied. These are the leaves of non-encoded 64 bit integer columns,
+/// float and double columns, and 1 bit wide leaves of non-nullable bool
+/// columns. Other leaves are transcoded. The leaves of encrypted files are
+/// always transcoded, as their decrypted pages may be reclaimed.
+///
+/// When exporting a table view, the objects are exported in the order of the
+/// view in batches of `batch_size` objects, and all values are transcoded.
+class ArrowExporter {
+public:
+    static constexpr size_t default_batch_size = 0x10000;
+
+    /// Export the objects of `table`. If no columns are given, all the
+    /// columns of supported types are exported.
+    ArrowExporter(const TransactionRef& tr, ConstTableRef table, std::vector<ColKey> columns = {});
+    /// Export the objects of `view`, which must belong to `tr`.
+    ArrowExporter(const TransactionRef& tr, TableView& view, std::vector<ColKey> columns = {},
+                  size_t batch_size = default_batch_size);
+    ~ArrowExporter();
+
+    static bool type_supported(ColKey col) noexcept;
+
+    const std::vector<ColKey>& get_columns() const noexcept
+    {
+        return m_columns;
+    }
+    size_t get_num_batches() const noexcept;
+
+    /// Fill in the schema common to all batches.
+    void get_schema(ArrowSchema* out) const;
+    /// Fill in the next batch. Returns false after the last batch, and then
+    /// leaves `out` released.
+    bool get_next(ArrowArray* out);
+
+    /// Turn an exporter into an Arrow C stream, which takes over ownership of
+    /// it. Errors are reported through the stream as EIO with a message
+    /// from get_last_error().
+    static void export_stream(std::unique_ptr<ArrowExporter> exporter, ArrowArrayStream* out);
+
+private:
+    TransactionRef m_tr;
+    ConstTableRef m_table;
+    std::vector<ColKey> m_columns;
+    std::unique_ptr<TableView> m_view;
+    size_t m_batch_size = 0;
+    // Key of the first object of each cluster when exporting a table
+    std::vector<ObjKey> m_cluster_keys;
+    size_t m_next_batch = 0;
+    bool m_zero_copy = false;
+
+    void init_columns(std::vector<ColKey> columns);
+    void export_cluster(ObjKey first_key, ArrowArray* out);
+    void export_view_range(size_t begin, size_t end, ArrowArray* out);
+};
+
+} // namespace realm
+
+#endif // REALM_ARROW_EXPORT_HPP
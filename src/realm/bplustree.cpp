@@ -101,6 +101,7 @@ public:
     }
 
     ref_type bptree_insert(size_t n, State& state, InsertFunc) override;
+    ref_type bptree_append_leaf(ref_type leaf_ref, size_t leaf_size, State& state) override;
     void bptree_access(size_t n, AccessFunc) override;
     size_t bptree_erase(size_t n, EraseFunc) override;
     bool bptree_traverse(TraverseFunc) override;
@@ -207,6 +208,15 @@ ref_type BPlusTreeLeaf::bptree_insert(size_t ndx, State& state, InsertFunc func)
     return new_leaf->get_ref();
 }
 
+ref_type BPlusTreeLeaf::bptree_append_leaf(ref_type leaf_ref, size_t leaf_size, State& state)
+{
+    // The new leaf becomes the sibling of this one
+    size_t sz = get_node_size();
+    state.split_offset = sz;
+    state.split_size = sz + leaf_size;
+    return leaf_ref;
+}
+
 void BPlusTreeLeaf::bptree_access(size_t ndx, AccessFunc func)
 {
     func(this, ndx);
@@ -371,6 +381,45 @@ ref_type BPlusTreeInner::bptree_insert(size_t ndx, State& state, InsertFunc func
     return insert_bp_node(child_ndx, new_sibling_ref, state);
 }
 
+ref_type BPlusTreeInner::bptree_append_leaf(ref_type leaf_ref, size_t leaf_size, State& state)
+{
+    size_t child_ndx = get_node_size() - 1;
+    size_t child_offset;
+    if (m_offsets.is_attached()) {
+        child_offset = get_bp_node_offset(child_ndx);
+    }
+    else {
+        child_offset = child_ndx * get_elems_per_child();
+    }
+
+    ref_type child_ref = get_bp_node_ref(child_ndx);
+    char* child_header = m_alloc.translate(child_ref);
+    ref_type new_sibling_ref;
+    if (!Array::get_is_inner_bptree_node_from_header(child_header)) {
+        // The new leaf becomes the sibling of the last child
+        size_t child_size = get_tree_size() - child_offset;
+        state.split_offset = child_size;
+        state.split_size = child_size + leaf_size;
+        new_sibling_ref = leaf_ref;
+    }
+    else {
+        BPlusTreeInner node(m_tree);
+        node.set_parent(this, child_ndx + 1);
+        node.init_from_mem(MemRef(child_header, child_ref, m_alloc));
+        node.set_offset(child_offset + m_my_offset);
+        new_sibling_ref = node.bptree_append_leaf(leaf_ref, leaf_size, state);
+    }
+
+    if (!new_sibling_ref) {
+        adjust(size() - 1, 2 * int64_t(leaf_size)); // Throws
+        return 0;
+    }
+
+    // insert_bp_node() accounts for one element being added
+    adjust(size() - 1, 2 * (int64_t(leaf_size) - 1)); // Throws
+    return insert_bp_node(child_ndx, new_sibling_ref, state);
+}
+
 size_t BPlusTreeInner::bptree_erase(size_t n, EraseFunc func)
 {
     ensure_offsets();
@@ -778,22 +827,36 @@ void BPlusTreeBase::bptree_insert(size_t n, BPlusTreeNode::InsertFunc func)
     ref_type new_sibling_ref = m_root->bptree_insert(n, state, func);
     if (REALM_UNLIKELY(new_sibling_ref)) {
         bool compact_form = (n == npos) && m_root->is_compact();
-        auto new_root = std::make_unique<BPlusTreeInner>(this);
-        if (!compact_form) {
-            new_root->create(0);
-            new_root->ensure_offsets();
-        }
-        else {
-            new_root->create(size_t(state.split_offset));
-        }
+        add_root_sibling(new_sibling_ref, state, compact_form);
+    }
+}
 
-        new_root->add_bp_node_ref(m_root->get_ref());                   // Throws
-        new_root->add_bp_node_ref(new_sibling_ref, state.split_offset); // Throws
-        new_root->append_tree_size(state.split_size);
-        replace_root(std::move(new_root));
+void BPlusTreeBase::bptree_append_leaf(ref_type leaf_ref, size_t leaf_size)
+{
+    BPlusTreeNode::State state;
+    ref_type new_sibling_ref = m_root->bptree_append_leaf(leaf_ref, leaf_size, state);
+    if (new_sibling_ref) {
+        add_root_sibling(new_sibling_ref, state, m_root->is_compact());
     }
 }
 
+void BPlusTreeBase::add_root_sibling(ref_type new_sibling_ref, const BPlusTreeNode::State& state, bool compact_form)
+{
+    auto new_root = std::make_unique<BPlusTreeInner>(this);
+    if (!compact_form) {
+        new_root->create(0);
+        new_root->ensure_offsets();
+    }
+    else {
+        new_root->create(size_t(state.split_offset));
+    }
+
+    new_root->add_bp_node_ref(m_root->get_ref());                   // Throws
+    new_root->add_bp_node_ref(new_sibling_ref, state.split_offset); // Throws
+    new_root->append_tree_size(state.split_size);
+    replace_root(std::move(new_root));
+}
+
 void BPlusTreeBase::bptree_erase(size_t n, BPlusTreeNode::EraseFunc func)
 {
     size_t root_size = m_root->bptree_erase(n, func);
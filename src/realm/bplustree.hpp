@@ -83,6 +83,9 @@ public:
     virtual size_t get_tree_size() const = 0;
 
     virtual ref_type bptree_insert(size_t n, State& state, InsertFunc) = 0;
+    // Add the leaf 'leaf_ref' holding 'leaf_size' elements after the last
+    // leaf of the subtree. May cause node to be split
+    virtual ref_type bptree_append_leaf(ref_type leaf_ref, size_t leaf_size, State& state) = 0;
     virtual void bptree_access(size_t n, AccessFunc) = 0;
     virtual size_t bptree_erase(size_t n, EraseFunc) = 0;
     virtual bool bptree_traverse(TraverseFunc) = 0;
@@ -115,6 +118,7 @@ public:
     }
 
     ref_type bptree_insert(size_t n, State& state, InsertFunc) override;
+    ref_type bptree_append_leaf(ref_type leaf_ref, size_t leaf_size, State& state) override;
     void bptree_access(size_t n, AccessFunc) override;
     size_t bptree_erase(size_t n, EraseFunc) override;
     bool bptree_traverse(TraverseFunc) override;
@@ -251,7 +255,9 @@ protected:
     }
 
     void bptree_insert(size_t n, BPlusTreeNode::InsertFunc func);
+    void bptree_append_leaf(ref_type leaf_ref, size_t leaf_size);
     void bptree_erase(size_t n, BPlusTreeNode::EraseFunc func);
+    void add_root_sibling(ref_type new_sibling_ref, const BPlusTreeNode::State& state, bool compact_form);
 
     // Create an un-attached leaf node
     virtual std::unique_ptr<BPlusTreeLeaf> create_leaf_node() = 0;
@@ -362,6 +368,61 @@ public:
         m_size++;
     }
 
+    void insert_range(size_t n, const std::vector<T>& values)
+    {
+        if (n == m_size || n == npos) {
+            append(values);
+        }
+        else {
+            for (const T& value : values) {
+                insert(n++, value);
+            }
+        }
+    }
+
+    // Add 'values' at the end of the tree. The last leaf is filled up first.
+    // The remaining values are put in new leaves, each of which is linked
+    // into the tree with a single descent.
+    void append(const std::vector<T>& values)
+    {
+        size_t num_values = values.size();
+        size_t ndx = 0;
+        if (num_values == 0)
+            return;
+
+        if (m_root->is_leaf()) {
+            LeafNode* leaf = static_cast<LeafNode*>(m_root.get());
+            size_t leaf_size = leaf->size();
+            size_t end = std::min(num_values, size_t(REALM_MAX_BPNODE_SIZE) - leaf_size);
+            for (; ndx < end; ndx++) {
+                leaf->LeafArray::insert(leaf_size++, values[ndx]);
+            }
+            m_size += end;
+        }
+        else {
+            size_t room = 0;
+            m_root->bptree_access(m_size - 1, [&room](BPlusTreeNode*, size_t last) {
+                room = REALM_MAX_BPNODE_SIZE - (last + 1);
+            });
+            while (ndx < num_values && room--) {
+                add(values[ndx++]);
+            }
+        }
+        invalidate_leaf_cache();
+
+        while (ndx < num_values) {
+            size_t end = std::min(num_values, ndx + size_t(REALM_MAX_BPNODE_SIZE));
+            LeafNode leaf(this);
+            leaf.create();
+            for (size_t i = ndx; i < end; i++) {
+                leaf.LeafArray::insert(i - ndx, values[i]);
+            }
+            bptree_append_leaf(leaf.get_ref(), end - ndx);
+            m_size += end - ndx;
+            ndx = end;
+        }
+    }
+
     inline T get(size_t n) const
     {
         // Fast path
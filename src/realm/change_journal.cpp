@@ -0,0 +1,58 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/change_journal.hpp>
+
+#include <algorithm>
+
+using namespace realm;
+
+void ChangeJournal::add(ObjKey key)
+{
+    if (!is_tracking())
+        return;
+    if (m_keys.size() >= max_size) {
+        size_t dropped = m_keys.size() / 2;
+        m_keys.erase(m_keys.begin(), m_keys.begin() + dropped);
+        m_base += dropped;
+    }
+    m_keys.push_back(key);
+}
+
+void ChangeJournal::invalidate() noexcept
+{
+    // Skip a position, so that no tracker is up to date any more
+    m_base = get_position() + 1;
+    m_keys.clear();
+}
+
+void ChangeJournal::reset() noexcept
+{
+    m_num_trackers.store(0, std::memory_order_relaxed);
+    invalidate();
+}
+
+bool ChangeJournal::get_changes(uint64_t position, std::vector<ObjKey>& keys) const
+{
+    if (position < m_base || position > get_position())
+        return false;
+    keys.assign(m_keys.begin() + size_t(position - m_base), m_keys.end());
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return true;
+}
@@ -0,0 +1,88 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_CHANGE_JOURNAL_HPP
+#define REALM_CHANGE_JOURNAL_HPP
+
+#include <realm/keys.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace realm {
+
+/// The keys of the objects of a table which have been created, modified or
+/// removed, used by table views to update their results incrementally.
+///
+/// Changes are only recorded while at least one tracker is registered. They
+/// come from the transaction logs parsed when the transaction advances, and
+/// from the log of the current write transaction. Every recorded key has a
+/// position, and a tracker remembers the position it has seen changes up to.
+/// When the journal grows beyond `max_size` the oldest half is dropped, and
+/// trackers which have not seen those changes must start over. Changes which
+/// do not concern individual objects, like adding or removing a column,
+/// invalidate all positions seen so far.
+class ChangeJournal {
+public:
+    static constexpr size_t max_size = 4096;
+    static constexpr uint64_t npos = uint64_t(-1);
+
+    ChangeJournal() = default;
+    ChangeJournal(const ChangeJournal&) = delete;
+    ChangeJournal& operator=(const ChangeJournal&) = delete;
+
+    bool is_tracking() const noexcept
+    {
+        return m_num_trackers.load(std::memory_order_relaxed) > 0;
+    }
+    void add_tracker() noexcept
+    {
+        m_num_trackers.fetch_add(1, std::memory_order_relaxed);
+    }
+    void remove_tracker() noexcept
+    {
+        m_num_trackers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// The position following the most recently recorded change
+    uint64_t get_position() const noexcept
+    {
+        return m_base + m_keys.size();
+    }
+
+    void add(ObjKey key);
+    void invalidate() noexcept;
+    /// Forget all changes and trackers. Called when the table accessor is
+    /// detached.
+    void reset() noexcept;
+
+    /// Get the keys of the objects changed since `position`, sorted and
+    /// without duplicates. Returns false if those changes are no longer
+    /// known.
+    bool get_changes(uint64_t position, std::vector<ObjKey>& keys) const;
+
+private:
+    std::atomic<size_t> m_num_trackers{0};
+    uint64_t m_base = 0; // Position of m_keys[0]
+    std::vector<ObjKey> m_keys;
+};
+
+} // namespace realm
+
+#endif // REALM_CHANGE_JOURNAL_HPP
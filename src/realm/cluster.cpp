@@ -279,6 +279,26 @@ inline void Cluster::do_insert_row(size_t ndx, ColKey col, Mixed init_val, bool
     }
 }
 
+template <class T>
+inline void Cluster::do_append_rows(size_t ndx, ColKey col, const Mixed* values, size_t num_rows, bool nullable)
+{
+    using U = typename util::RemoveOptional<typename T::value_type>::type;
+
+    T arr(m_alloc);
+    auto col_ndx = col.get_index();
+    arr.set_parent(this, col_ndx.val + s_first_col_index);
+    set_spec<T>(arr, col_ndx);
+    arr.init_from_parent();
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (!values || values[i].is_null()) {
+            arr.insert(ndx + i, T::default_value(nullable));
+        }
+        else {
+            arr.insert(ndx + i, values[i].get<U>());
+        }
+    }
+}
+
 inline void Cluster::do_insert_key(size_t ndx, ColKey col_key, Mixed init_val, ObjKey origin_key)
 {
     ObjKey target_key = init_val.is_null() ? ObjKey{} : init_val.get<ObjKey>();
@@ -439,6 +459,117 @@ void Cluster::insert_row(size_t ndx, ObjKey k, const FieldValues& init_values)
     m_tree_top.m_owner->for_each_and_every_column(insert_in_column);
 }
 
+void Cluster::append_rows(const std::vector<ObjKey>& keys, size_t begin, size_t end,
+                          const std::vector<const Mixed*>& values)
+{
+    size_t num_rows = end - begin;
+    size_t ndx = node_size();
+
+    // Ensure the cluster array is big enough to hold 64 bit values.
+    copy_on_write(m_size * 8);
+
+    bool compact = !m_keys.is_attached();
+    for (size_t i = 0; compact && i < num_rows; ++i) {
+        compact = uint64_t(keys[begin + i].value) - m_offset == ndx + i;
+    }
+    if (compact) {
+        Array::set(s_key_ref_or_size_index, RefOrTagged::make_tagged(ndx + num_rows));
+    }
+    else {
+        ensure_general_form();
+        for (size_t i = begin; i < end; ++i) {
+            m_keys.add(uint64_t(keys[i].value) - m_offset);
+        }
+    }
+
+    auto append_to_column = [&](ColKey col_key) {
+        auto col_ndx = col_key.get_index();
+        auto attr = col_key.get_attrs();
+        const Mixed* col_values = col_ndx.val < values.size() ? values[col_ndx.val] : nullptr;
+        if (col_values)
+            col_values += begin;
+        auto value = [&](size_t i) {
+            return col_values ? col_values[i] : Mixed();
+        };
+
+        auto type = col_key.get_type();
+        if (attr.test(col_attr_Collection)) {
+            ArrayRef arr(m_alloc);
+            arr.set_parent(this, col_ndx.val + s_first_col_index);
+            arr.init_from_parent();
+            for (size_t i = 0; i < num_rows; ++i)
+                arr.insert(ndx + i, 0);
+            return IteratorControl::AdvanceToNext;
+        }
+
+        bool nullable = attr.test(col_attr_Nullable);
+        switch (type) {
+            case col_type_Int:
+                if (attr.test(col_attr_Nullable)) {
+                    do_append_rows<ArrayIntNull>(ndx, col_key, col_values, num_rows, nullable);
+                }
+                else {
+                    do_append_rows<ArrayInteger>(ndx, col_key, col_values, num_rows, nullable);
+                }
+                break;
+            case col_type_Bool:
+                do_append_rows<ArrayBoolNull>(ndx, col_key, col_values, num_rows, nullable);
+                break;
+            case col_type_Float:
+                do_append_rows<ArrayFloatNull>(ndx, col_key, col_values, num_rows, nullable);
+                break;
+            case col_type_Double:
+                do_append_rows<ArrayDoubleNull>(ndx, col_key, col_values, num_rows, nullable);
+                break;
+            case col_type_String:
+                do_append_rows<ArrayString>(ndx, col_key, col_values, num_rows, nullable);
+                break;
+            case col_type_Binary:
+                do_append_rows<ArrayBinary>(ndx, col_key, col_values, num_rows, nullable);
+                break;
+            case col_type_Timestamp:
+                do_append_rows<ArrayTimestamp>(ndx, col_key, col_values, num_rows, nullable);
+                break;
+            case col_type_Decimal:
+                do_append_rows<ArrayDecimal128>(ndx, col_key, col_values, num_rows, nullable);
+                break;
+            case col_type_ObjectId:
+                do_append_rows<ArrayObjectIdNull>(ndx, col_key, col_values, num_rows, nullable);
+                break;
+            case col_type_UUID:
+                do_append_rows<ArrayUUIDNull>(ndx, col_key, col_values, num_rows, nullable);
+                break;
+            // Values referring to other objects also update the backlinks of
+            // the targets, one object at a time
+            case col_type_Mixed:
+                for (size_t i = 0; i < num_rows; ++i)
+                    do_insert_mixed(ndx + i, col_key, value(i), keys[begin + i]);
+                break;
+            case col_type_Link:
+                for (size_t i = 0; i < num_rows; ++i)
+                    do_insert_key(ndx + i, col_key, value(i), keys[begin + i]);
+                break;
+            case col_type_TypedLink:
+                for (size_t i = 0; i < num_rows; ++i)
+                    do_insert_link(ndx + i, col_key, value(i), keys[begin + i]);
+                break;
+            case col_type_BackLink: {
+                ArrayBacklink arr(m_alloc);
+                arr.set_parent(this, col_ndx.val + s_first_col_index);
+                arr.init_from_parent();
+                for (size_t i = 0; i < num_rows; ++i)
+                    arr.insert(ndx + i, 0);
+                break;
+            }
+            default:
+                REALM_ASSERT(false);
+                break;
+        }
+        return IteratorControl::AdvanceToNext;
+    };
+    m_tree_top.m_owner->for_each_and_every_column(append_to_column);
+}
+
 template <class T>
 inline void Cluster::do_move(size_t ndx, ColKey col_key, Cluster* to)
 {
@@ -670,6 +801,7 @@ ref_type Cluster::insert(ObjKey k, const FieldValues& init_values, ClusterNode::
     size_t sz;
     size_t ndx;
     ref_type ret = 0;
+    const size_t max_size = m_tree_top.get_max_node_size();
 
     auto on_error = [&] {
         throw KeyAlreadyUsed(
@@ -693,13 +825,13 @@ ref_type Cluster::insert(ObjKey k, const FieldValues& init_values, ClusterNode::
         }
         // Key value is bigger than all other values, should be put last
         ndx = sz;
-        if (uint64_t(k.value) > sz && sz < cluster_node_size) {
+        if (uint64_t(k.value) > sz && sz < max_size) {
             ensure_general_form();
         }
     }
 
-    REALM_ASSERT_DEBUG(sz <= cluster_node_size);
-    if (REALM_LIKELY(sz < cluster_node_size)) {
+    // The size may have been set lower than that of existing leaves
+    if (REALM_LIKELY(sz < max_size)) {
         insert_row(ndx, k, init_values); // Throws
         state.mem = get_mem();
         state.index = ndx;
@@ -730,6 +862,15 @@ ref_type Cluster::insert(ObjKey k, const FieldValues& init_values, ClusterNode::
     return ret;
 }
 
+ref_type Cluster::append_leaf(ObjKey k, ref_type leaf_ref, size_t, ClusterNode::State& state)
+{
+    REALM_ASSERT_DEBUG(k.value > get_last_key_value());
+    // The new leaf becomes a sibling after this one, as when splitting a full
+    // leaf on insertion of a key greater than all others
+    state.split_key = k.value;
+    return leaf_ref;
+}
+
 bool Cluster::try_get(ObjKey k, ClusterNode::State& state) const noexcept
 {
     state.mem = get_mem();
@@ -1035,6 +1176,23 @@ void Cluster::init_leaf(ColKey col_key, ArrayPayload* leaf) const
     leaf->set_parent(const_cast<Cluster*>(this), col_ndx.val + 1);
 }
 
+void Cluster::prefetch_leaves(Allocator& alloc, const char* header, const std::vector<ColKey>& columns) noexcept
+{
+    auto prefetch = [&](size_t ndx) {
+        // The keys are a tagged size in compact form
+        RefOrTagged rot = Array::get_as_ref_or_tagged(header, ndx);
+        if (rot.is_ref() && rot.get_as_ref())
+            REALM_PREFETCH(alloc.translate(rot.get_as_ref()));
+    };
+    prefetch(s_key_ref_or_size_index);
+    size_t size = NodeHeader::get_size_from_header(header);
+    for (auto col_key : columns) {
+        size_t ndx = col_key.get_index().val + s_first_col_index;
+        if (ndx < size)
+            prefetch(ndx);
+    }
+}
+
 void Cluster::add_leaf(ColKey col_key, ref_type ref)
 {
     auto col_ndx = col_key.get_index();
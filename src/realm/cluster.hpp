@@ -75,6 +75,13 @@ private:
     std::vector<FieldValue> m_values;
 };
 
+/// The values of one column for all the objects created by
+/// Table::bulk_create_objects()
+struct BulkColumn {
+    ColKey col_key;
+    std::vector<Mixed> values;
+};
+
 class ClusterNode : public Array {
 public:
     // This structure is used to bring information back to the upper nodes when
@@ -158,6 +165,10 @@ public:
     /// Create a new object identified by 'key' and update 'state' accordingly
     /// Return reference to new node created (if any)
     virtual ref_type insert(ObjKey k, const FieldValues& init_values, State& state) = 0;
+    /// Add the leaf 'leaf_ref' holding 'leaf_size' objects after all existing
+    /// objects. 'k' is the first key of the leaf, which must be greater than
+    /// all keys in this subtree. Return reference to new node created (if any)
+    virtual ref_type append_leaf(ObjKey k, ref_type leaf_ref, size_t leaf_size, State& state) = 0;
     /// Locate object identified by 'key' and update 'state' accordingly
     void get(ObjKey key, State& state) const;
     /// Locate object identified by 'key' and update 'state' accordingly
@@ -299,6 +310,7 @@ public:
         return size() - s_first_col_index;
     }
     ref_type insert(ObjKey k, const FieldValues& init_values, State& state) override;
+    ref_type append_leaf(ObjKey k, ref_type leaf_ref, size_t leaf_size, State& state) override;
     bool try_get(ObjKey k, State& state) const noexcept override;
     ObjKey get(size_t, State& state) const override;
     size_t get_ndx(ObjKey key, size_t ndx) const noexcept override;
@@ -307,6 +319,9 @@ public:
     void upgrade_string_to_enum(ColKey col, ArrayString& keys);
 
     void init_leaf(ColKey col, ArrayPayload* leaf) const;
+    // Ask for the keys and the leaves of `columns` of the cluster with the given header to be loaded into the cache,
+    // ahead of reading them. Unlike initializing an accessor for the cluster, this does not wait for any of them.
+    static void prefetch_leaves(Allocator& alloc, const char* header, const std::vector<ColKey>& columns) noexcept;
     void add_leaf(ColKey col, ref_type ref);
 
     void verify() const;
@@ -327,6 +342,11 @@ private:
         return size_t(Array::get(s_key_ref_or_size_index)) >> 1; // Size is stored as tagged value
     }
     void insert_row(size_t ndx, ObjKey k, const FieldValues& init_values);
+    // Add the objects keys[begin..end) after the existing ones. values[i] is
+    // null for columns getting default values, or else points to an array
+    // holding the value of the column for each key.
+    void append_rows(const std::vector<ObjKey>& keys, size_t begin, size_t end,
+                     const std::vector<const Mixed*>& values);
     void move(size_t ndx, ClusterNode* new_node, int64_t key_adj) override;
     template <class T>
     void do_create(ColKey col);
@@ -335,6 +355,8 @@ private:
     template <class T>
     void do_insert_row(size_t ndx, ColKey col, Mixed init_val, bool nullable);
     template <class T>
+    void do_append_rows(size_t ndx, ColKey col, const Mixed* values, size_t num_rows, bool nullable);
+    template <class T>
     void do_move(size_t ndx, ColKey col, Cluster* to);
     template <class T>
     void do_erase(size_t ndx, ColKey col);
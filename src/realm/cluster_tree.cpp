@@ -28,8 +28,11 @@
 #include "realm/array_string.hpp"
 #include "realm/array_mixed.hpp"
 #include "realm/array_fixed_bytes.hpp"
+#include "realm/impl/destroy_guard.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 
 /*
  * Node-splitting is done in the way that if the new element comes after all the
@@ -71,7 +74,10 @@ public:
         return m_sub_tree_depth;
     }
 
-    bool traverse(ClusterTree::TraverseFunction func, int64_t) const;
+    bool traverse(ClusterTree::TraverseFunction func, int64_t, const std::vector<ColKey>& prefetch_columns) const;
+    // Only visit the leaves which may hold objects with keys in [begin, end)
+    bool traverse(ClusterTree::TraverseFunction func, int64_t, ObjKey begin, ObjKey end,
+                  const std::vector<ColKey>& prefetch_columns) const;
     void update(ClusterTree::UpdateFunction func, int64_t);
 
     size_t node_size() const override
@@ -95,6 +101,7 @@ public:
     void remove_column(ColKey col) override;
     size_t nb_columns() const override;
     ref_type insert(ObjKey k, const FieldValues& init_values, State& state) override;
+    ref_type append_leaf(ObjKey k, ref_type leaf_ref, size_t leaf_size, State& state) override;
     bool try_get(ObjKey k, State& state) const noexcept override;
     ObjKey get(size_t ndx, State& state) const override;
     size_t get_ndx(ObjKey key, size_t ndx) const noexcept override;
@@ -121,6 +128,8 @@ public:
     void dump_objects(int64_t key_offset, std::string lead) const override;
 
 private:
+    friend class ClusterTree;
+
     static constexpr size_t s_key_ref_index = 0;
     static constexpr size_t s_sub_tree_depth_index = 1;
     static constexpr size_t s_sub_tree_size = 2;
@@ -129,6 +138,11 @@ private:
     int m_sub_tree_depth = 0;
     int m_shift_factor = 0;
 
+    int64_t get_child_offset(size_t i, int64_t key_offset) const
+    {
+        return (m_keys.is_attached() ? m_keys.get(i) : int64_t(i << m_shift_factor)) + key_offset;
+    }
+
     struct ChildInfo {
         size_t ndx;
         uint64_t offset;
@@ -176,6 +190,10 @@ private:
     }
     void move(size_t ndx, ClusterNode* new_node, int64_t key_adj) override;
 
+    // Insert the node created when splitting the child 'child_info' (if any)
+    // after the child. Return reference to new node created (if any)
+    ref_type insert_sibling(ChildInfo& child_info, ref_type new_sibling_ref, State& state);
+
     template <class T, class F>
     T recurse(ObjKey key, F func);
 
@@ -296,48 +314,64 @@ ref_type ClusterNodeInner::insert(ObjKey key, const FieldValues& init_values, Cl
 
         set_tree_size(get_tree_size() + 1);
 
-        if (!new_sibling_ref) {
-            return ref_type(0);
-        }
+        return insert_sibling(child_info, new_sibling_ref, state);
+    });
+}
 
-        size_t new_ref_ndx = child_info.ndx + 1;
+ref_type ClusterNodeInner::append_leaf(ObjKey key, ref_type leaf_ref, size_t leaf_size, ClusterNode::State& state)
+{
+    return recurse<ref_type>(key, [&](ClusterNode* node, ChildInfo& child_info) {
+        ref_type new_sibling_ref = node->append_leaf(child_info.key, leaf_ref, leaf_size, state);
 
-        int64_t split_key_value = state.split_key + child_info.offset;
-        uint64_t sz = node_size();
-        if (sz < cluster_node_size) {
-            if (m_keys.is_attached()) {
-                m_keys.insert(new_ref_ndx, split_key_value);
-            }
-            else {
-                if (uint64_t(split_key_value) != sz << m_shift_factor) {
-                    ensure_general_form();
-                    m_keys.insert(new_ref_ndx, split_key_value);
-                }
-            }
-            _insert_child_ref(new_ref_ndx, new_sibling_ref);
-            return ref_type(0);
-        }
+        set_tree_size(get_tree_size() + leaf_size);
+
+        return insert_sibling(child_info, new_sibling_ref, state);
+    });
+}
+
+ref_type ClusterNodeInner::insert_sibling(ChildInfo& child_info, ref_type new_sibling_ref, ClusterNode::State& state)
+{
+    if (!new_sibling_ref) {
+        return ref_type(0);
+    }
+
+    size_t new_ref_ndx = child_info.ndx + 1;
 
-        ClusterNodeInner child(m_alloc, m_tree_top);
-        child.create(m_sub_tree_depth);
-        if (new_ref_ndx == sz) {
-            child.add(new_sibling_ref);
-            state.split_key = split_key_value;
+    int64_t split_key_value = state.split_key + child_info.offset;
+    uint64_t sz = node_size();
+    if (sz < m_tree_top.get_max_node_size()) {
+        if (m_keys.is_attached()) {
+            m_keys.insert(new_ref_ndx, split_key_value);
         }
         else {
-            int64_t first_key_value = m_keys.get(new_ref_ndx);
-            child.ensure_general_form();
-            move(new_ref_ndx, &child, first_key_value);
-            add(new_sibling_ref, split_key_value); // Throws
-            state.split_key = first_key_value;
+            if (uint64_t(split_key_value) != sz << m_shift_factor) {
+                ensure_general_form();
+                m_keys.insert(new_ref_ndx, split_key_value);
+            }
         }
+        _insert_child_ref(new_ref_ndx, new_sibling_ref);
+        return ref_type(0);
+    }
+
+    ClusterNodeInner child(m_alloc, m_tree_top);
+    child.create(m_sub_tree_depth);
+    if (new_ref_ndx == sz) {
+        child.add(new_sibling_ref);
+        state.split_key = split_key_value;
+    }
+    else {
+        int64_t first_key_value = m_keys.get(new_ref_ndx);
+        child.ensure_general_form();
+        move(new_ref_ndx, &child, first_key_value);
+        add(new_sibling_ref, split_key_value); // Throws
+        state.split_key = first_key_value;
+    }
 
-        // Some objects has been moved out of this tree - find out how many
-        size_t child_sub_tree_size = child.update_sub_tree_size();
-        set_tree_size(get_tree_size() - child_sub_tree_size);
+    // Some objects has been moved out of this tree - find out how many
+    size_t child_sub_tree_size = child.update_sub_tree_size();
+    set_tree_size(get_tree_size() - child_sub_tree_size);
 
-        return child.get_ref();
-    });
+    return child.get_ref();
 }
 
 bool ClusterNodeInner::try_get(ObjKey key, ClusterNode::State& state) const noexcept
@@ -455,6 +489,7 @@ size_t ClusterNodeInner::erase(ObjKey key, CascadeState& state)
     return recurse<size_t>(key, [this, &state](ClusterNode* erase_node, ChildInfo& child_info) {
         size_t erase_node_size = erase_node->erase(child_info.key, state);
         bool is_leaf = erase_node->is_leaf();
+        size_t max_size = m_tree_top.get_max_node_size();
         set_tree_size(get_tree_size() - 1);
 
         if (erase_node_size == 0) {
@@ -471,7 +506,7 @@ size_t ClusterNodeInner::erase(ObjKey key, CascadeState& state)
                 adjust_keys_first_child(first_offset);
             }
         }
-        else if (erase_node_size < cluster_node_size / 2 && child_info.ndx < (node_size() - 1)) {
+        else if (erase_node_size < max_size / 2 && child_info.ndx < (node_size() - 1)) {
             // Candidate for merge. First calculate if the combined size of current and
             // next sibling is small enough.
             size_t sibling_ndx = child_info.ndx + 1;
@@ -483,7 +518,7 @@ size_t ClusterNodeInner::erase(ObjKey key, CascadeState& state)
 
             size_t combined_size = sibling_node->node_size() + erase_node_size;
 
-            if (combined_size < cluster_node_size * 3 / 4) {
+            if (combined_size < max_size * 3 / 4) {
                 // Calculate value that must be subtracted from the moved keys
                 // (will be negative as the sibling has bigger keys)
                 int64_t key_adj = m_keys.is_attached() ? (m_keys.get(child_info.ndx) - m_keys.get(sibling_ndx))
@@ -683,16 +718,46 @@ size_t ClusterNodeInner::update_sub_tree_size()
     return sub_tree_size;
 }
 
-bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_offset) const
+bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_offset,
+                                const std::vector<ColKey>& prefetch_columns) const
+{
+    return traverse(func, key_offset, ObjKey(std::numeric_limits<int64_t>::min()),
+                    ObjKey(std::numeric_limits<int64_t>::max()), prefetch_columns);
+}
+
+bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_offset, ObjKey begin, ObjKey end,
+                                const std::vector<ColKey>& prefetch_columns) const
 {
     auto sz = node_size();
 
-    for (unsigned i = 0; i < sz; i++) {
+    // A child holds the keys from its own offset up to the offset of the next child
+    size_t first = 0;
+    if (begin.value > key_offset) {
+        uint64_t key_value = uint64_t(begin.value - key_offset);
+        first = m_keys.is_attached() ? m_keys.upper_bound(key_value) : size_t(key_value >> m_shift_factor) + 1;
+        first = std::min(first, sz);
+        if (first > 0)
+            first--;
+    }
+
+    if (first + 1 < sz)
+        REALM_PREFETCH(m_alloc.translate(_get_child_ref(first + 1)));
+    for (size_t i = first; i < sz; i++) {
+        int64_t offs = get_child_offset(i, key_offset);
+        if (offs >= end.value)
+            break;
         ref_type ref = _get_child_ref(i);
         char* header = m_alloc.translate(ref);
         bool child_is_leaf = !Array::get_is_inner_bptree_node_from_header(header);
         MemRef mem(header, ref, m_alloc);
-        int64_t offs = (m_keys.is_attached() ? m_keys.get(i) : i << m_shift_factor) + key_offset;
+
+        // Ask for the children ahead of visiting them, so that they are loaded while this one is visited: the node
+        // after the next one, and the leaves of the next one, the node of which was asked for in the previous step
+        if (i + 2 < sz)
+            REALM_PREFETCH(m_alloc.translate(_get_child_ref(i + 2)));
+        if (child_is_leaf && !prefetch_columns.empty() && i + 1 < sz)
+            Cluster::prefetch_leaves(m_alloc, m_alloc.translate(_get_child_ref(i + 1)), prefetch_columns);
+
         if (child_is_leaf) {
             Cluster leaf(offs, m_alloc, m_tree_top);
             leaf.init(mem);
@@ -703,7 +768,7 @@ bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_
         else {
             ClusterNodeInner node(m_alloc, m_tree_top);
             node.init(mem);
-            if (node.traverse(func, offs)) {
+            if (node.traverse(func, offs, begin, end, prefetch_columns)) {
                 return true;
             }
         }
@@ -766,6 +831,26 @@ ClusterTree::ClusterTree(Table* owner, Allocator& alloc, size_t top_position_for
 
 ClusterTree::~ClusterTree() {}
 
+size_t ClusterTree::get_max_node_size() const noexcept
+{
+    return m_owner ? m_owner->get_cluster_node_size() : Cluster::cluster_node_size;
+}
+
+size_t ClusterTree::get_default_node_size(size_t num_columns) noexcept
+{
+    // Wide tables get smaller leaves, as an update copies the whole leaf
+    // array of each column it changes on write. Builds with a small node size
+    // are meant to exercise splitting and merging, so they are left alone.
+    size_t size = Cluster::cluster_node_size;
+    if (size < 4 * Table::min_cluster_node_size)
+        return size;
+    if (num_columns >= 64)
+        return size / 4;
+    if (num_columns >= 32)
+        return size / 2;
+    return size;
+}
+
 std::unique_ptr<ClusterNode> ClusterTree::create_root_from_parent(ArrayParent* parent, size_t ndx_in_parent)
 {
     ref_type ref = parent->get_child_ref(ndx_in_parent);
@@ -816,11 +901,24 @@ std::unique_ptr<ClusterNode> ClusterTree::get_node(ArrayParent* parent, size_t n
     return node;
 }
 
+namespace {
+// True if any column of the table may hold a link, or a backlink
+bool has_link_columns(const Table& table)
+{
+    return table.for_each_and_every_column([](ColKey col_key) {
+        auto type = col_key.get_type();
+        bool may_link = type == col_type_Link || type == col_type_TypedLink || type == col_type_Mixed ||
+                        type == col_type_BackLink;
+        return may_link ? IteratorControl::Stop : IteratorControl::AdvanceToNext;
+    });
+}
+} // anonymous namespace
+
 void ClusterTree::clear(CascadeState& state)
 {
     m_owner->clear_indexes();
 
-    if (state.m_group) {
+    if (state.m_group && has_link_columns(*m_owner)) {
         remove_all_links(state); // This will also delete objects loosing their last strong link
     }
 
@@ -929,6 +1027,9 @@ void ClusterTree::insert_fast(ObjKey k, const FieldValues& init_values, ClusterN
         replace_root(std::move(new_root));
     }
     m_size++;
+    // The objects after the new one in its leaf have moved, and the search
+    // indexes may look them up before the caller is done
+    bump_storage_version();
 }
 
 Obj ClusterTree::insert(ObjKey k, const FieldValues& init_values)
@@ -953,6 +1054,85 @@ Obj ClusterTree::insert(ObjKey k, const FieldValues& init_values)
     return Obj(get_table_ref(), state.mem, k, state.index);
 }
 
+void ClusterTree::bulk_insert(const std::vector<ObjKey>& keys, const std::vector<const Mixed*>& values)
+{
+    size_t num_objects = keys.size();
+    const size_t max_leaf_size = get_max_node_size();
+    size_t ndx = 0;
+
+    auto insert_one = [&] {
+        FieldValues init_values;
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i])
+                init_values.insert(m_owner->m_leaf_ndx2colkey[i], values[i][ndx]);
+        }
+        ClusterNode::State state;
+        insert_fast(keys[ndx], init_values, state);
+        m_owner->update_indexes(keys[ndx], init_values);
+        ++ndx;
+    };
+
+    // Leaves filled here, as (offset, ref) pairs. Their values are added to
+    // the search indexes when all objects are created.
+    std::vector<std::pair<uint64_t, ref_type>> leaves;
+    if (m_size == 0 && m_root->is_leaf()) {
+        auto root = static_cast<Cluster*>(m_root.get());
+        ndx = std::min(num_objects, max_leaf_size);
+        root->append_rows(keys, 0, ndx, values);
+        m_size = ndx;
+        leaves.emplace_back(0, root->get_ref());
+    }
+    else if (num_objects > 0) {
+        // Fill up the last leaf one object at a time
+        if (m_size == 0)
+            insert_one();
+        Cluster last_leaf(0, m_alloc, *this);
+        ClusterNode::IteratorState state(last_leaf);
+        get_leaf(ObjKey(get_last_key_value()), state);
+        size_t room = max_leaf_size - std::min(max_leaf_size, last_leaf.node_size());
+        while (ndx < num_objects && room--)
+            insert_one();
+    }
+    size_t first_leaf_ndx = leaves.empty() ? ndx : 0;
+
+    while (ndx < num_objects) {
+        size_t end = std::min(num_objects, ndx + max_leaf_size);
+        uint64_t offset = uint64_t(keys[ndx].value);
+        Cluster leaf(offset, m_alloc, *this);
+        leaf.create();
+        leaf.append_rows(keys, ndx, end, values);
+
+        ClusterNode::State state;
+        ref_type new_sibling_ref = m_root->append_leaf(keys[ndx], leaf.get_ref(), end - ndx, state);
+        if (new_sibling_ref) {
+            auto new_root = std::make_unique<ClusterNodeInner>(m_root->get_alloc(), *this);
+            new_root->create(m_root->get_sub_tree_depth() + 1);
+
+            new_root->add(m_root->get_ref());                // Throws
+            new_root->add(new_sibling_ref, state.split_key); // Throws
+            new_root->update_sub_tree_size();
+
+            replace_root(std::move(new_root));
+        }
+        m_size += end - ndx;
+        leaves.emplace_back(offset, leaf.get_ref());
+        ndx = end;
+    }
+
+    if (!leaves.empty()) {
+        m_owner->bulk_update_indexes(keys, first_leaf_ndx, [&](TraverseFunction func) {
+            for (auto& [offset, ref] : leaves) {
+                Cluster leaf(offset, m_alloc, *this);
+                leaf.init(MemRef(ref, m_alloc));
+                func(&leaf);
+            }
+        });
+    }
+
+    bump_content_version();
+    bump_storage_version();
+}
+
 bool ClusterTree::is_valid(ObjKey k) const noexcept
 {
     if (m_size == 0)
@@ -965,11 +1145,37 @@ bool ClusterTree::is_valid(ObjKey k) const noexcept
 ClusterNode::State ClusterTree::try_get(ObjKey k) const noexcept
 {
     ClusterNode::State state;
-    if (!(k && m_root->try_get(k, state)))
+    if (!(k && lookup(k, state)))
         state.index = realm::npos;
     return state;
 }
 
+bool ClusterTree::lookup(ObjKey k, ClusterNode::State& state) const noexcept
+{
+    if (!m_lookup_cache_enabled)
+        return m_root->try_get(k, state);
+
+    if (!m_lookup_cache) {
+        m_lookup_cache.reset(new (std::nothrow) CachedLookup[s_lookup_cache_size]);
+        if (!m_lookup_cache)
+            return m_root->try_get(k, state);
+    }
+    auto version = m_alloc.get_storage_version();
+    CachedLookup& entry = m_lookup_cache[uint64_t(k.value) & (s_lookup_cache_size - 1)];
+    if (entry.key == k.value && entry.storage_version == version) {
+        state.mem = entry.mem;
+        state.index = entry.index;
+        return true;
+    }
+    if (!m_root->try_get(k, state))
+        return false;
+    entry.key = k.value;
+    entry.storage_version = version;
+    entry.mem = state.mem;
+    entry.index = state.index;
+    return true;
+}
+
 ClusterNode::State ClusterTree::get(size_t ndx, ObjKey& k) const
 {
     if (ndx >= m_size) {
@@ -1033,13 +1239,25 @@ bool ClusterTree::get_leaf(ObjKey key, ClusterNode::IteratorState& state) const
     }
 }
 
-bool ClusterTree::traverse(TraverseFunction func) const
+bool ClusterTree::traverse(TraverseFunction func, const std::vector<ColKey>& prefetch_columns) const
 {
     if (m_root->is_leaf()) {
         return func(static_cast<Cluster*>(m_root.get())) == IteratorControl::Stop;
     }
     else {
-        return static_cast<ClusterNodeInner*>(m_root.get())->traverse(func, 0);
+        return static_cast<ClusterNodeInner*>(m_root.get())->traverse(func, 0, prefetch_columns);
+    }
+}
+
+bool ClusterTree::traverse(ObjKey begin, ObjKey end, TraverseFunction func) const
+{
+    if (end.value <= begin.value)
+        return false;
+    if (m_root->is_leaf()) {
+        return func(static_cast<Cluster*>(m_root.get())) == IteratorControl::Stop;
+    }
+    else {
+        return static_cast<ClusterNodeInner*>(m_root.get())->traverse(func, 0, begin, end, {});
     }
 }
 
@@ -1086,6 +1304,228 @@ void ClusterTree::verify() const
 #endif
 }
 
+ref_type ClusterTree::typed_write(ref_type ref, _impl::ArrayWriterBase& out, Allocator& alloc,
+                                  const std::vector<LeafEncoding>& encoding)
+{
+    if (alloc.is_read_only(ref))
+        return ref;
+
+    Array node(alloc);
+    node.init_from_ref(ref);
+    bool is_inner = node.is_inner_bptree_node();
+
+    // Temp array for updated refs
+    Array new_node(Allocator::get_default());
+    new_node.create(node.get_type(), node.get_context_flag()); // Throws
+    _impl::ShallowArrayDestroyGuard dg(&new_node);
+
+    for (size_t i = 0, n = node.size(); i < n; ++i) {
+        int64_t value = node.get(i);
+        bool is_ref = (value != 0 && (value & 1) == 0);
+        if (is_ref) {
+            ref_type subref = to_ref(value);
+            auto leaf_encoding = LeafEncoding::Plain;
+            if (!is_inner && i >= Cluster::s_first_col_index && i - Cluster::s_first_col_index < encoding.size())
+                leaf_encoding = encoding[i - Cluster::s_first_col_index];
+            if (is_inner && i >= ClusterNodeInner::s_first_node_index) {
+                subref = typed_write(subref, out, alloc, encoding); // Throws
+            }
+            else if (leaf_encoding == LeafEncoding::Integers && !alloc.is_read_only(subref)) {
+                Array leaf(alloc);
+                leaf.init_from_ref(subref);
+                subref = leaf.write_encoded(out); // Throws
+            }
+            else if (leaf_encoding == LeafEncoding::CompressedBlobs &&
+                     NodeHeader::get_context_flag_from_header(alloc.translate(subref)) &&
+                     NodeHeader::get_hasrefs_from_header(alloc.translate(subref))) {
+                // Only leaves of big blobs hold values large enough to compress
+                subref = ArrayBigBlobs::write_compressed(subref, alloc, out); // Throws
+            }
+            else {
+                subref = Array::write(subref, alloc, out, true); // Throws
+            }
+            value = from_ref(subref);
+        }
+        new_node.add(value); // Throws
+    }
+
+    return new_node.write(out, false, false); // Throws
+}
+
+void ClusterTree::collect_leaves(ref_type ref, int64_t offset, std::vector<LeafRef>& leaves) const
+{
+    char* header = m_alloc.translate(ref);
+    if (!Array::get_is_inner_bptree_node_from_header(header)) {
+        leaves.push_back({ref, offset});
+        return;
+    }
+    ClusterNodeInner node(m_alloc, *this);
+    node.init(MemRef(header, ref, m_alloc));
+    for (size_t i = 0, sz = node.node_size(); i < sz; ++i) {
+        collect_leaves(node._get_child_ref(i), node.get_child_offset(i, offset), leaves);
+    }
+}
+
+void ClusterTree::diff_nodes(const ClusterTree& newer, ref_type ref, int64_t offset, ref_type newer_ref,
+                             int64_t newer_offset, std::vector<LeafRef>& leaves,
+                             std::vector<LeafRef>& newer_leaves) const
+{
+    // A node which has not been written to since the older snapshot keeps its ref
+    if (ref == newer_ref && offset == newer_offset)
+        return;
+
+    char* header = m_alloc.translate(ref);
+    char* newer_header = newer.m_alloc.translate(newer_ref);
+    if (Array::get_is_inner_bptree_node_from_header(header) &&
+        Array::get_is_inner_bptree_node_from_header(newer_header)) {
+        ClusterNodeInner node(m_alloc, *this);
+        node.init(MemRef(header, ref, m_alloc));
+        ClusterNodeInner newer_node(newer.m_alloc, newer);
+        newer_node.init(MemRef(newer_header, newer_ref, newer.m_alloc));
+
+        size_t sz = node.node_size();
+        bool same_shape = sz == newer_node.node_size();
+        for (size_t i = 0; same_shape && i < sz; ++i) {
+            same_shape = node.get_child_offset(i, offset) == newer_node.get_child_offset(i, newer_offset);
+        }
+        if (same_shape) {
+            for (size_t i = 0; i < sz; ++i) {
+                diff_nodes(newer, node._get_child_ref(i), node.get_child_offset(i, offset),
+                           newer_node._get_child_ref(i), newer_node.get_child_offset(i, newer_offset), leaves,
+                           newer_leaves);
+            }
+            return;
+        }
+    }
+
+    // The node has been split or merged. Leaves which just moved to another
+    // parent are weeded out by the caller.
+    collect_leaves(ref, offset, leaves);
+    newer.collect_leaves(newer_ref, newer_offset, newer_leaves);
+}
+
+ClusterTree::Diff ClusterTree::diff(const ClusterTree& newer) const
+{
+    Diff result;
+    auto table = get_owning_table();
+    auto newer_table = newer.get_owning_table();
+
+    // Columns in both tables are compared value by value
+    std::vector<ColKey> columns;
+    for (auto col : table->get_column_keys()) {
+        if (newer_table->valid_column(col))
+            columns.push_back(col);
+        else
+            result.columns.push_back(col);
+    }
+    for (auto col : newer_table->get_column_keys()) {
+        if (!table->valid_column(col))
+            result.columns.push_back(col);
+    }
+    std::vector<bool> column_changed(columns.size());
+
+    std::vector<LeafRef> leaves;
+    std::vector<LeafRef> newer_leaves;
+    diff_nodes(newer, m_root->get_ref(), 0, newer.m_root->get_ref(), 0, leaves, newer_leaves);
+    std::sort(leaves.begin(), leaves.end());
+    std::sort(newer_leaves.begin(), newer_leaves.end());
+    std::vector<LeafRef> changed;
+    std::vector<LeafRef> newer_changed;
+    std::set_difference(leaves.begin(), leaves.end(), newer_leaves.begin(), newer_leaves.end(),
+                        std::back_inserter(changed));
+    std::set_difference(newer_leaves.begin(), newer_leaves.end(), leaves.begin(), leaves.end(),
+                        std::back_inserter(newer_changed));
+
+    auto make_leaf = [](const ClusterTree& tree, const LeafRef& leaf) {
+        auto cluster = std::make_unique<Cluster>(leaf.offset, tree.m_alloc, tree);
+        cluster->init(MemRef(tree.m_alloc.translate(leaf.ref), leaf.ref, tree.m_alloc));
+        return cluster;
+    };
+    auto column_ref = [](const Cluster& cluster, ColKey col) {
+        return cluster.get_as_ref(col.get_index().val + Cluster::s_first_col_index);
+    };
+    auto values_equal = [&](const Cluster& cluster, size_t row, const Cluster& newer_cluster, size_t newer_row,
+                            ColKey col) {
+        if (col.is_collection()) {
+            Array arr(m_alloc);
+            arr.init_from_ref(column_ref(cluster, col));
+            Array newer_arr(newer.m_alloc);
+            newer_arr.init_from_ref(column_ref(newer_cluster, col));
+            return arr.get_as_ref(row) == newer_arr.get_as_ref(newer_row);
+        }
+        Obj obj(get_table_ref(), cluster.get_mem(), cluster.get_real_key(row), row);
+        Obj newer_obj(newer.get_table_ref(), newer_cluster.get_mem(), newer_cluster.get_real_key(newer_row),
+                      newer_row);
+        return obj.get_any(col) == newer_obj.get_any(col);
+    };
+
+    // The objects in the changed leaves of this tree
+    std::vector<std::unique_ptr<Cluster>> clusters;
+    std::map<int64_t, std::pair<const Cluster*, size_t>> rows;
+    for (auto& leaf : changed) {
+        clusters.push_back(make_leaf(*this, leaf));
+        const Cluster* cluster = clusters.back().get();
+        for (size_t row = 0, sz = cluster->node_size(); row < sz; ++row) {
+            rows.emplace(cluster->get_real_key(row).value, std::make_pair(cluster, row));
+        }
+    }
+
+    for (auto& leaf : newer_changed) {
+        auto newer_cluster = make_leaf(newer, leaf);
+        size_t sz = newer_cluster->node_size();
+
+        // If the leaf holds the same objects in both trees, columns whose
+        // leaves have the same ref hold the same values
+        const Cluster* same_objects = nullptr;
+        if (sz > 0) {
+            auto it = rows.find(newer_cluster->get_real_key(0).value);
+            if (it != rows.end() && it->second.second == 0 && it->second.first->node_size() == sz &&
+                it->second.first->get_offset() == newer_cluster->get_offset()) {
+                same_objects = it->second.first;
+                for (size_t row = 1; same_objects && row < sz; ++row) {
+                    if (same_objects->get_key_value(row) != newer_cluster->get_key_value(row))
+                        same_objects = nullptr;
+                }
+            }
+        }
+        std::vector<bool> compare(columns.size(), true);
+        if (same_objects) {
+            for (size_t c = 0; c < columns.size(); ++c) {
+                compare[c] = column_ref(*same_objects, columns[c]) != column_ref(*newer_cluster, columns[c]);
+            }
+        }
+
+        for (size_t newer_row = 0; newer_row < sz; ++newer_row) {
+            ObjKey key = newer_cluster->get_real_key(newer_row);
+            auto it = rows.find(key.value);
+            if (it == rows.end()) {
+                result.insertions.push_back(key);
+                continue;
+            }
+            auto [cluster, row] = it->second;
+            rows.erase(it);
+            bool modified = false;
+            for (size_t c = 0; c < columns.size(); ++c) {
+                if (compare[c] && !values_equal(*cluster, row, *newer_cluster, newer_row, columns[c])) {
+                    modified = true;
+                    column_changed[c] = true;
+                }
+            }
+            if (modified)
+                result.modifications.push_back(key);
+        }
+    }
+    for (auto& entry : rows) {
+        result.deletions.push_back(ObjKey(entry.first));
+    }
+    for (size_t c = 0; c < columns.size(); ++c) {
+        if (column_changed[c])
+            result.columns.push_back(columns[c]);
+    }
+
+    return result;
+}
+
 void ClusterTree::nullify_incoming_links(ObjKey obj_key, CascadeState& state)
 {
     REALM_ASSERT(state.m_group);
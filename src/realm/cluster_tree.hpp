@@ -129,12 +129,18 @@ public:
 
     // Create and return object
     Obj insert(ObjKey k, const FieldValues& values);
+    // Create the objects identified by 'keys', which must be ascending and
+    // greater than all existing keys. values[i] is null for columns getting
+    // default values, or else points to the values of the column for each
+    // key. Full leaves are built a column at a time and appended to the tree.
+    void bulk_insert(const std::vector<ObjKey>& keys, const std::vector<const Mixed*>& values);
 
     // Lookup and return object
     Obj get(ObjKey k) const
     {
         ClusterNode::State state;
-        m_root->get(k, state);
+        if (!(k && lookup(k, state)))
+            m_root->get(k, state); // Throws
         return Obj(get_table_ref(), state.mem, k, state.index);
     }
 
@@ -160,6 +166,13 @@ public:
         return m_owner;
     }
 
+    // The number of objects a leaf, or children an inner node, may hold before
+    // it is split, as given by the owning table
+    size_t get_max_node_size() const noexcept;
+    // The node size of a table with the given number of columns, if none has
+    // been set for it
+    static size_t get_default_node_size(size_t num_columns) noexcept;
+
     // Insert entry for object, but do not create and return the object accessor
     void insert_fast(ObjKey k, const FieldValues& init_values, ClusterNode::State& state);
     // Delete object with given key
@@ -170,13 +183,27 @@ public:
     ClusterNode::State try_get(ObjKey k) const noexcept;
     // Lookup by index
     ClusterNode::State get(size_t ndx, ObjKey& k) const;
+    // Remember where the most recently looked up objects were found, so that
+    // looking them up again while the tree is unchanged does not descend it.
+    // Must not be enabled for a tree which is read from several threads at
+    // once, such as the tree of a frozen table.
+    void set_lookup_cache_enabled(bool enabled) noexcept
+    {
+        m_lookup_cache_enabled = enabled;
+        if (!enabled)
+            m_lookup_cache.reset();
+    }
     // Get logical index of object identified by k
     size_t get_ndx(ObjKey k) const noexcept;
     // Find the leaf containing the requested object
     bool get_leaf(ObjKey key, ClusterNode::IteratorState& state) const noexcept;
     // Visit all leaves and call the supplied function. Stop when function returns IteratorControl::Stop.
-    // Not allowed to modify the tree
-    bool traverse(TraverseFunction func) const;
+    // Not allowed to modify the tree. The keys and the leaves of `prefetch_columns` of the next leaf are prefetched
+    // while the function is called for a leaf.
+    bool traverse(TraverseFunction func, const std::vector<ColKey>& prefetch_columns = {}) const;
+    // Visit the leaves which may hold objects with keys in [begin, end), in key order. The leaves
+    // may also hold objects outside the range.
+    bool traverse(ObjKey begin, ObjKey end, TraverseFunction func) const;
     // Visit all leaves and call the supplied function. The function can modify the leaf.
     void update(UpdateFunction func);
 
@@ -190,6 +217,44 @@ public:
     }
     void verify() const;
 
+    /// How typed_write() writes the leaves of a column
+    enum class LeafEncoding : uint8_t {
+        Plain,
+        Integers,       // Array::write_encoded()
+        CompressedBlobs // ArrayBigBlobs::write_compressed()
+    };
+
+    /// Write a modified cluster tree in the same way as `Array::write(ref,
+    /// alloc, out, true)`, but write the leaves of the columns according to
+    /// `encoding` (indexed by leaf index).
+    static ref_type typed_write(ref_type ref, _impl::ArrayWriterBase& out, Allocator& alloc,
+                                const std::vector<LeafEncoding>& encoding);
+
+    struct Diff {
+        // Objects only in the newer tree
+        std::vector<ObjKey> insertions;
+        // Objects only in this tree
+        std::vector<ObjKey> deletions;
+        // Objects in both trees with a different value in some column
+        std::vector<ObjKey> modifications;
+        // Columns with a different value in some object, and columns which
+        // are only in one of the trees
+        std::vector<ColKey> columns;
+
+        bool empty() const noexcept
+        {
+            return insertions.empty() && deletions.empty() && modifications.empty() && columns.empty();
+        }
+    };
+    /// Compare with `newer`, the same tree in a newer snapshot of the file.
+    /// Subtrees with the same ref at the same key offset in both trees are
+    /// unchanged and skipped without being read. Values are only compared in
+    /// the leaves which differ, and a column is only compared value by value
+    /// if its leaf differs. Backlink columns are not compared, and
+    /// collections are compared by ref, so a collection which was rewritten
+    /// without changing counts as modified.
+    Diff diff(const ClusterTree& newer) const;
+
 protected:
     friend class Obj;
     friend class Cluster;
@@ -202,6 +267,20 @@ protected:
     std::unique_ptr<ClusterNode> m_root;
     size_t m_size = 0;
 
+    // An entry is valid as long as the storage version of the allocator is
+    // the one it was found in, as the tree cannot have changed until then
+    struct CachedLookup {
+        int64_t key = -1;
+        uint_fast64_t storage_version = 0;
+        MemRef mem;
+        size_t index = 0;
+    };
+    static constexpr size_t s_lookup_cache_size = 128;
+    bool m_lookup_cache_enabled = false;
+    mutable std::unique_ptr<CachedLookup[]> m_lookup_cache;
+
+    bool lookup(ObjKey k, ClusterNode::State& state) const noexcept;
+
     void replace_root(std::unique_ptr<ClusterNode> leaf);
 
     std::unique_ptr<ClusterNode> create_root_from_parent(ArrayParent* parent, size_t ndx_in_parent);
@@ -209,6 +288,22 @@ protected:
     TableRef get_table_ref() const;
     bool is_string_enum_type(ColKey::Idx col_ndx) const;
     void remove_all_links(CascadeState&);
+
+    struct LeafRef {
+        ref_type ref;
+        int64_t offset;
+        bool operator<(const LeafRef& other) const noexcept
+        {
+            return offset < other.offset || (offset == other.offset && ref < other.ref);
+        }
+        bool operator==(const LeafRef& other) const noexcept
+        {
+            return ref == other.ref && offset == other.offset;
+        }
+    };
+    void collect_leaves(ref_type ref, int64_t offset, std::vector<LeafRef>& leaves) const;
+    void diff_nodes(const ClusterTree& newer, ref_type ref, int64_t offset, ref_type newer_ref, int64_t newer_offset,
+                    std::vector<LeafRef>& leaves, std::vector<LeafRef>& newer_leaves) const;
 };
 
 class ClusterTree::Iterator {
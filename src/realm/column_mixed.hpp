@@ -22,6 +22,8 @@
 #include <realm/bplustree.hpp>
 #include <realm/array_mixed.hpp>
 
+#include <unordered_map>
+
 namespace realm {
 
 class BPlusTreeMixed : public BPlusTree<Mixed> {
@@ -42,6 +44,14 @@ public:
     }
     size_t find_key(int64_t key) const noexcept
     {
+        // Every access through a path to a nested collection looks up its key,
+        // so remember where each key was found. Keys are unique, so a position
+        // which has become stale is detected by the key stored there.
+        if (auto it = m_key_positions.find(key); it != m_key_positions.end()) {
+            if (it->second < size() && get_key(it->second) == key)
+                return it->second;
+        }
+
         size_t ret = realm::npos;
         auto func = [&](BPlusTreeNode* node, size_t offset) {
             LeafNode* leaf = static_cast<LeafNode*>(node);
@@ -56,6 +66,16 @@ public:
         };
 
         m_root->bptree_traverse(func);
+        if (ret != realm::npos) {
+            try {
+                if (m_key_positions.size() > size())
+                    m_key_positions.clear();
+                m_key_positions[key] = ret;
+            }
+            catch (...) {
+                // The cache is only an optimization
+            }
+        }
         return ret;
     }
 
@@ -80,6 +100,9 @@ public:
         m_root->bptree_access(ndx, func);
         return ret;
     }
+
+private:
+    mutable std::unordered_map<int64_t, size_t> m_key_positions;
 };
 
 } // namespace realm
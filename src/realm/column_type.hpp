@@ -133,7 +133,7 @@ static_assert(!col_type_OldStringEnum.is_valid());
 static_assert(!col_type_OldTable.is_valid());
 static_assert(!col_type_OldDateTime.is_valid());
 
-enum class IndexType { None, General, Fulltext };
+enum class IndexType { None, General, Fulltext, Sorted, CaseInsensitive };
 
 inline std::ostream& operator<<(std::ostream& ostr, IndexType type)
 {
@@ -147,6 +147,12 @@ inline std::ostream& operator<<(std::ostream& ostr, IndexType type)
         case IndexType::Fulltext:
             ostr << "fulltext index";
             break;
+        case IndexType::Sorted:
+            ostr << "sorted index";
+            break;
+        case IndexType::CaseInsensitive:
+            ostr << "case insensitive index";
+            break;
     }
     return ostr;
 }
@@ -182,6 +188,17 @@ enum ColumnAttr {
     /// Specifies that elements in the column are full-text indexed
     col_attr_FullText_Indexed = 256,
 
+    /// Specifies that the column has a sorted index
+    col_attr_Sorted_Indexed = 512,
+
+    /// Specifies that large values of the column are stored compressed in the
+    /// file. Applies only to string and binary columns.
+    col_attr_Compressed = 1024,
+
+    /// Specifies that the column has a sorted index ordering strings without
+    /// regard to case
+    col_attr_CaseInsensitive_Indexed = 2048,
+
     /// Either list, dictionary, or set
     col_attr_Collection = 128 + 64 + 32
 };
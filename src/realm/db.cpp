@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cerrno>
+#include <cstddef>
 #include <fcntl.h>
 #include <iostream>
 #include <mutex>
@@ -43,6 +44,7 @@
 #include <realm/util/scope_exit.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/util/to_string.hpp>
+#include <realm/util/trace.hpp>
 
 #ifndef _WIN32
 #include <sys/wait.h>
@@ -80,7 +82,13 @@ namespace {
 //         with a lock.
 // 13      New impl of VersionList and added mutex for it (former RingBuffer)
 // 14      Added field for tracking ongoing encrypted writes
-const uint_fast16_t g_shared_info_version = 14;
+// 15      Per-priority write lock queues (next_ticket/next_served arrays)
+const uint_fast16_t g_shared_info_version = 15;
+
+uint64_t to_nanoseconds(std::chrono::steady_clock::duration d) noexcept
+{
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+}
 
 
 struct VersionList {
@@ -300,12 +308,30 @@ constexpr auto TransactionDeleter = [](Transaction* t) {
     delete t;
 };
 
+util::MappingAdvice to_mapping_advice(DBOptions::MappingAdvice advice) noexcept
+{
+    switch (advice) {
+        case DBOptions::MappingAdvice::Normal:
+            break;
+        case DBOptions::MappingAdvice::Random:
+            return util::MappingAdvice::Random;
+        case DBOptions::MappingAdvice::Sequential:
+            return util::MappingAdvice::Sequential;
+        case DBOptions::MappingAdvice::WillNeed:
+            return util::MappingAdvice::WillNeed;
+    }
+    return util::MappingAdvice::Normal;
+}
+
 template <typename... Args>
 TransactionRef make_transaction_ref(Args&&... args)
 {
     return TransactionRef(new Transaction(std::forward<Args>(args)...), TransactionDeleter);
 }
 
+// The innermost DB::PinTag of the current thread
+thread_local DB::PinTag* s_current_pin_tag = nullptr;
+
 } // anonymous namespace
 
 namespace realm {
@@ -434,8 +460,9 @@ struct alignas(8) DB::SharedInfo {
     InterprocessCondVar::SharedPart daemon_becomes_ready;
     InterprocessCondVar::SharedPart new_commit_available;
     InterprocessCondVar::SharedPart pick_next_writer;
-    std::atomic<uint32_t> next_ticket;
-    std::atomic<uint32_t> next_served = 0;
+    /// The write queue of each write priority, see DB::do_begin_write().
+    std::atomic<uint32_t> next_ticket[num_write_priorities];
+    std::atomic<uint32_t> next_served[num_write_priorities];
     std::atomic<uint64_t> writing_page_offset;
     std::atomic<uint64_t> write_counter;
 
@@ -450,6 +477,37 @@ struct alignas(8) DB::SharedInfo {
         // Create our first versioning entry:
         readers.init_versioning(top_ref, file_size, initial_version);
     }
+
+    /// Number of writers of the given priority which hold or wait for the
+    /// write lock.
+    uint32_t num_writers(size_t priority) const noexcept
+    {
+        // allow for comparison even after wrap around of ticket numbering
+        int32_t diff = int32_t(next_ticket[priority].load(std::memory_order_relaxed) -
+                               next_served[priority].load(std::memory_order_relaxed));
+        return diff > 0 ? uint32_t(diff) : 0;
+    }
+
+    uint32_t num_writers() const noexcept
+    {
+        uint32_t n = 0;
+        for (size_t priority = 0; priority < num_write_priorities; ++priority)
+            n += num_writers(priority);
+        return n;
+    }
+
+    /// True if the holder of `ticket` in the queue of `priority` must let
+    /// someone else have the write lock first.
+    bool must_yield_write_lock(size_t priority, uint32_t ticket) const noexcept
+    {
+        if (int32_t(ticket - next_served[priority].load(std::memory_order_relaxed)) > 0)
+            return true; // ticket is in the future
+        for (size_t higher = priority + 1; higher < num_write_priorities; ++higher) {
+            if (num_writers(higher) > 0)
+                return true;
+        }
+        return false;
+    }
 };
 
 
@@ -466,7 +524,10 @@ DB::SharedInfo::SharedInfo(Durability dura, Replication::HistoryType ht, int hsv
     history_schema_version = static_cast<uint16_t>(hsv);
     InterprocessCondVar::init_shared_part(new_commit_available); // Throws
     InterprocessCondVar::init_shared_part(pick_next_writer);     // Throws
-    next_ticket = 0;
+    for (size_t priority = 0; priority < num_write_priorities; ++priority) {
+        next_ticket[priority] = 0;
+        next_served[priority] = 0;
+    }
 
 // IMPORTANT: The offsets, types (, and meanings) of these members must
 // never change, not even when the SharedInfo layout version is bumped. The
@@ -525,7 +586,11 @@ public:
         : m_mutex(mutex)
     {
     }
-    virtual ~VersionManager() {}
+    virtual ~VersionManager()
+    {
+        for (auto& chunk : m_local_chunks)
+            delete[] chunk.load();
+    }
 
     void cleanup_versions(uint64_t& oldest_live_version, TopRefMap& top_refs, bool& any_new_unreachables)
         REQUIRES(!m_info_mutex)
@@ -549,14 +614,10 @@ public:
             // a stale value (acceptable for a racing write on one thread and
             // a read on another), or a new value which is guaranteed to not
             // be an active index in the local cache.
-            util::CheckedLockGuard lock(m_local_readers_mutex);
-            util::CheckedLockGuard info_lock(m_info_mutex);
-            auto index = m_info->readers.newest.load();
-            if (index < m_local_readers.size()) {
-                auto& r = m_local_readers[index];
-                if (r.is_active()) {
-                    return {r.version, index};
-                }
+            auto index = m_newest_index->load();
+            if (auto r = local_reader(index)) {
+                if (auto version = r->version.load(std::memory_order_acquire))
+                    return {version, index};
             }
         }
 
@@ -567,18 +628,31 @@ public:
         return {m_info->readers.get(index).version, index};
     }
 
+    // Releases a read lock which is not the last one of its type this process
+    // holds on the version, which only needs the local count to be decremented.
+    // Returns false without doing anything otherwise.
+    bool try_release_local_read_lock(const ReadLockInfo& read_lock) noexcept
+    {
+        auto& f = field_for_type(local_reader_for(read_lock), read_lock.m_type);
+        auto count = f.load(std::memory_order_relaxed);
+        while (count > 1) {
+            if (f.compare_exchange_weak(count, count - 1, std::memory_order_release, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
     void release_read_lock(const ReadLockInfo& read_lock) REQUIRES(!m_local_readers_mutex, !m_info_mutex)
     {
         {
             util::CheckedLockGuard lock(m_local_readers_mutex);
-            REALM_ASSERT(read_lock.m_reader_idx < m_local_readers.size());
-            auto& r = m_local_readers[read_lock.m_reader_idx];
-            auto& f = field_for_type(r, read_lock.m_type);
-            REALM_ASSERT(f > 0);
-            if (--f > 0)
+            auto& r = local_reader_for(read_lock);
+            auto count = field_for_type(r, read_lock.m_type).fetch_sub(1, std::memory_order_acq_rel);
+            REALM_ASSERT(count > 0);
+            if (count > 1)
                 return;
             if (r.count_live == 0 && r.count_full == 0 && r.count_frozen == 0)
-                r.version = 0;
+                r.version.store(0, std::memory_order_release);
         }
 
         std::lock_guard lock(m_mutex);
@@ -592,6 +666,61 @@ public:
         --field_for_type(r, read_lock.m_type);
     }
 
+    // Forget about a read lock without releasing it, so that the version it
+    // refers to stays locked in the lock file even after this process is gone.
+    void leak_read_lock(const ReadLockInfo& read_lock) REQUIRES(!m_local_readers_mutex, !m_info_mutex)
+    {
+        {
+            util::CheckedLockGuard lock(m_local_readers_mutex);
+            auto& r = local_reader_for(read_lock);
+            auto count = field_for_type(r, read_lock.m_type).fetch_sub(1, std::memory_order_acq_rel);
+            REALM_ASSERT(count > 0);
+            if (count == 1) {
+                // The entry in the lock file belonged to this lock alone, so
+                // we simply never release it
+                if (r.count_live == 0 && r.count_full == 0 && r.count_frozen == 0)
+                    r.version.store(0, std::memory_order_release);
+                return;
+            }
+        }
+
+        // Other read locks of this process still share the entry in the lock
+        // file, so take out one more for the leaked lock
+        std::lock_guard lock(m_mutex);
+        util::CheckedLockGuard info_lock(m_info_mutex);
+        ++field_for_type(m_info->readers.get(read_lock.m_reader_idx), read_lock.m_type);
+    }
+
+    // Release all read locks held by this process. Returns the number of read
+    // locks released.
+    size_t release_all_read_locks() REQUIRES(!m_local_readers_mutex, !m_info_mutex)
+    {
+        size_t num_released = 0;
+        std::lock_guard lock(m_mutex);
+        util::CheckedLockGuard info_lock(m_info_mutex);
+        util::CheckedLockGuard local_lock(m_local_readers_mutex);
+        for (size_t chunk = 0; chunk < s_num_local_chunks; ++chunk) {
+            auto entries = m_local_chunks[chunk].load();
+            if (!entries)
+                continue;
+            size_t first_index = s_local_chunk_size * ((size_t(1) << chunk) - 1);
+            for (size_t i = 0; i < (s_local_chunk_size << chunk); ++i) {
+                auto& r = entries[i];
+                if (!r.is_active())
+                    continue;
+                auto& shared = m_info->readers.get(uint_fast32_t(first_index + i));
+                for (auto type : {ReadLockInfo::Frozen, ReadLockInfo::Live, ReadLockInfo::Full}) {
+                    if (auto count = field_for_type(r, type).exchange(0)) {
+                        num_released += count;
+                        --field_for_type(shared, type);
+                    }
+                }
+                r.version.store(0, std::memory_order_release);
+            }
+        }
+        return num_released;
+    }
+
     ReadLockInfo grab_read_lock(ReadLockInfo::Type type, VersionID version_id = {})
         REQUIRES(!m_local_readers_mutex, !m_info_mutex)
     {
@@ -617,26 +746,66 @@ public:
                 if (type != ReadLockInfo::Frozen && r.count_live == 0)
                     throw BadVersion(version_id.version);
             }
-            populate_read_lock(read_lock, r, type);
-        }
 
-        {
+            m_lock_file_acquisitions.fetch_add(1, std::memory_order_relaxed);
+
+            // The local count for the entry is only taken from zero to one
+            // with m_mutex held, and the lock file is only told about the first
+            // lock of each type this process holds on the entry.
             util::CheckedLockGuard local_lock(m_local_readers_mutex);
-            grow_local_cache(read_lock.m_reader_idx + 1);
-            auto& r2 = m_local_readers[read_lock.m_reader_idx];
+            auto& r2 = grow_local_cache(read_lock.m_reader_idx);
+            auto& f = field_for_type(r2, type);
+            auto count = f.load(std::memory_order_relaxed);
+            while (count != 0) {
+                if (f.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    populate_read_lock(read_lock, r2, type);
+                    return read_lock;
+                }
+            }
+            populate_read_lock(read_lock, r, type);
             if (!r2.is_active()) {
-                r2.version = read_lock.m_version;
                 r2.filesize = read_lock.m_file_size;
                 r2.current_top = read_lock.m_top_ref;
-                r2.count_full = r2.count_live = r2.count_frozen = 0;
+                r2.version.store(read_lock.m_version, std::memory_order_release);
             }
-            REALM_ASSERT_EX(field_for_type(r2, type) == 0, type, r2.count_full, r2.count_live, r2.count_frozen);
-            field_for_type(r2, type) = 1;
+            f.store(1, std::memory_order_release);
         }
-
         return read_lock;
     }
 
+    // Grab a read lock of the given type on a version which this process
+    // already holds a read lock of the same type on. This only increments the
+    // local count and does not take any mutex. Returns false if there is no
+    // such lock.
+    bool try_grab_local_read_lock(ReadLockInfo& read_lock, ReadLockInfo::Type type, VersionID version_id) noexcept
+    {
+        const bool pick_specific = version_id.version != VersionID().version;
+        auto index = static_cast<uint_fast32_t>(pick_specific ? version_id.index : m_newest_index->load());
+        auto r = local_reader(index);
+        if (!r)
+            return false;
+
+        // A local count only goes from zero to one in grab_read_lock() after the
+        // lock file entry has been locked, so while it is not zero the entry
+        // can't be reused for another version.
+        auto& f = field_for_type(*r, type);
+        auto count = f.load(std::memory_order_relaxed);
+        do {
+            if (count == 0)
+                return false;
+        } while (!f.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed));
+
+        read_lock.m_reader_idx = index;
+        populate_read_lock(read_lock, *r, type);
+        if (pick_specific && read_lock.m_version != version_id.version) {
+            if (!try_release_local_read_lock(read_lock))
+                release_read_lock(read_lock);
+            return false;
+        }
+        m_local_acquisitions.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
     void init_versioning(ref_type top_ref, size_t file_size, uint64_t initial_version) REQUIRES(!m_info_mutex)
     {
         std::lock_guard lock(m_mutex);
@@ -658,16 +827,82 @@ public:
         expand_version_list(new_entries);
         m_local_max_entry = new_entries;
         m_info->readers.reserve(new_entries);
+        m_version_list_expansions.fetch_add(1, std::memory_order_relaxed);
         auto success = m_info->readers.try_allocate_entry(new_top_ref, new_file_size, new_version);
         REALM_ASSERT_EX(success, new_entries, new_version);
     }
 
+    size_t get_version_list_capacity() REQUIRES(!m_info_mutex)
+    {
+        util::CheckedLockGuard info_lock(m_info_mutex);
+        return m_local_max_entry;
+    }
+
+    ReadLockStats get_read_lock_stats() const noexcept
+    {
+        ReadLockStats stats;
+        stats.local_acquisitions = m_local_acquisitions.load(std::memory_order_relaxed);
+        stats.lock_file_acquisitions = m_lock_file_acquisitions.load(std::memory_order_relaxed);
+        stats.version_list_expansions = m_version_list_expansions.load(std::memory_order_relaxed);
+        return stats;
+    }
 
 private:
-    void grow_local_cache(size_t new_size) REQUIRES(m_local_readers_mutex)
+    // The read locks held by this process on an entry in the VersionList.
+    // Entries never move once allocated, so that a lock on a version which is
+    // already locked can be grabbed and released without a mutex.
+    struct LocalReadCount {
+        std::atomic<uint64_t> version{0};
+        uint64_t filesize = 0;
+        uint64_t current_top = 0;
+        std::atomic<uint32_t> count_live{0};
+        std::atomic<uint32_t> count_frozen{0};
+        std::atomic<uint32_t> count_full{0};
+        bool is_active() const noexcept
+        {
+            return version.load(std::memory_order_relaxed) != 0;
+        }
+    };
+
+    // Chunk k holds the entries for the next (s_local_chunk_size << k) indexes,
+    // which is enough for any 32 bit index with s_num_local_chunks chunks.
+    static constexpr size_t s_local_chunk_size = VersionList::init_readers_size;
+    static constexpr size_t s_num_local_chunks = 32;
+
+    static std::pair<size_t, size_t> local_chunk_position(size_t index) noexcept
+    {
+        size_t chunk = 0;
+        for (size_t n = index / s_local_chunk_size + 1; n > 1; n >>= 1)
+            ++chunk;
+        return {chunk, index - s_local_chunk_size * ((size_t(1) << chunk) - 1)};
+    }
+
+    LocalReadCount* local_reader(size_t index) const noexcept
+    {
+        auto [chunk, offset] = local_chunk_position(index);
+        if (chunk >= s_num_local_chunks)
+            return nullptr;
+        auto entries = m_local_chunks[chunk].load(std::memory_order_acquire);
+        return entries ? entries + offset : nullptr;
+    }
+
+    LocalReadCount& local_reader_for(const ReadLockInfo& read_lock) const noexcept
+    {
+        auto r = local_reader(read_lock.m_reader_idx);
+        REALM_ASSERT(r);
+        return *r;
+    }
+
+    LocalReadCount& grow_local_cache(size_t index) REQUIRES(m_local_readers_mutex)
     {
-        if (new_size > m_local_readers.size())
-            m_local_readers.resize(new_size, VersionList::ReadCount{});
+        auto [chunk, offset] = local_chunk_position(index);
+        REALM_ASSERT(chunk < s_num_local_chunks);
+        auto entries = m_local_chunks[chunk].load(std::memory_order_relaxed);
+        if (!entries) {
+            entries = new LocalReadCount[s_local_chunk_size << chunk];
+            m_local_chunks[chunk].store(entries, std::memory_order_release);
+        }
+        return entries[offset];
     }
 
     void populate_read_lock(ReadLockInfo& read_lock, VersionList::ReadCount& r, ReadLockInfo::Type type)
@@ -679,33 +914,16 @@ private:
         read_lock.m_file_size = static_cast<size_t>(r.filesize);
     }
 
-    bool try_grab_local_read_lock(ReadLockInfo& read_lock, ReadLockInfo::Type type, VersionID version_id)
-        REQUIRES(!m_local_readers_mutex, !m_info_mutex)
+    static void populate_read_lock(ReadLockInfo& read_lock, const LocalReadCount& r, ReadLockInfo::Type type)
     {
-        const bool pick_specific = version_id.version != VersionID().version;
-        auto index = version_id.index;
-        if (!pick_specific) {
-            util::CheckedLockGuard lock(m_info_mutex);
-            index = m_info->readers.newest.load();
-        }
-        util::CheckedLockGuard local_lock(m_local_readers_mutex);
-        if (index >= m_local_readers.size())
-            return false;
-
-        auto& r = m_local_readers[index];
-        if (!r.is_active())
-            return false;
-        if (pick_specific && r.version != version_id.version)
-            return false;
-        if (field_for_type(r, type) == 0)
-            return false;
-
-        read_lock.m_reader_idx = index;
-        populate_read_lock(read_lock, r, type);
-        return true;
+        read_lock.m_type = type;
+        read_lock.m_version = r.version.load(std::memory_order_relaxed);
+        read_lock.m_top_ref = static_cast<ref_type>(r.current_top);
+        read_lock.m_file_size = static_cast<size_t>(r.filesize);
     }
 
-    static uint32_t& field_for_type(VersionList::ReadCount& r, ReadLockInfo::Type type)
+    template <typename ReadCount>
+    static auto field_for_type(ReadCount& r, ReadLockInfo::Type type) -> decltype(r.count_live)&
     {
         switch (type) {
             case ReadLockInfo::Frozen:
@@ -749,8 +967,13 @@ private:
 
 protected:
     util::InterprocessMutex& m_mutex;
-    util::CheckedMutex m_local_readers_mutex;
-    std::vector<VersionList::ReadCount> m_local_readers GUARDED_BY(m_local_readers_mutex);
+    util::CheckedMutex m_local_readers_mutex; // guards activating entries and allocating chunks
+    std::atomic<LocalReadCount*> m_local_chunks[s_num_local_chunks] = {};
+    // VersionList::newest, in a part of the lock file which is never remapped
+    const std::atomic<uint32_t>* m_newest_index = nullptr;
+    std::atomic<uint64_t> m_local_acquisitions{0};
+    std::atomic<uint64_t> m_lock_file_acquisitions{0};
+    std::atomic<uint64_t> m_version_list_expansions{0};
 
     util::CheckedMutex m_info_mutex;
     unsigned int m_local_max_entry GUARDED_BY(m_info_mutex) = 0;
@@ -784,6 +1007,8 @@ public:
             required_size = sizeof(SharedInfo) + m_info->readers.compute_required_space(m_local_max_entry);
             REALM_ASSERT(required_size >= size);
         }
+        m_header_map.map(m_file, File::access_ReadWrite, sizeof(SharedInfo), File::map_NoSync);
+        m_newest_index = &m_header_map.get_addr()->readers.newest;
     }
 
     void expand_version_list(unsigned new_entries) override REQUIRES(m_info_mutex)
@@ -815,6 +1040,7 @@ private:
 
     File& m_file;
     File::Map<DB::SharedInfo> m_reader_map;
+    File::Map<DB::SharedInfo> m_header_map; // never remapped
 
     friend class DB::EncryptionMarkerObserver;
 };
@@ -863,6 +1089,7 @@ public:
         : VersionManager(mutex)
     {
         m_info = info;
+        m_newest_index = &info->readers.newest;
         m_local_max_entry = m_info->readers.capacity();
     }
     void expand_version_list(unsigned) override
@@ -874,6 +1101,214 @@ private:
     void ensure_reader_mapping(unsigned int) override {}
 };
 
+// The pages of the file written since the start of the current backup epoch,
+// for write_incremental_backup(). The tracking file in the management
+// directory holds a header, followed by a bitmap with a bit per page. It is
+// shared by the DBs of all processes which have page tracking enabled, and
+// written with the write lock held, except for the fields describing the last
+// complete backup.
+//
+// Each commit extends the chain of recorded versions. A commit which finds
+// that the previous version was not recorded, because it was made by a DB
+// without page tracking, restarts the chain, as the pages written by the
+// versions in between are unknown.
+class DB::ChangedPageTracker {
+public:
+    static constexpr size_t page_size = 16 * 1024;
+
+    struct Backup {
+        version_type version = 0;
+        ref_type top_ref = 0;
+        size_t file_size = 0;
+    };
+
+    struct Epoch {
+        // The previous backup, which the new epoch may be copied on top of
+        Backup previous;
+        // The pages written since the previous backup, if all of them were
+        // recorded
+        std::optional<std::vector<char>> written_pages;
+    };
+
+    explicit ChangedPageTracker(const std::string& db_path)
+    {
+        m_file.open(get_path(db_path), File::access_ReadWrite, File::create_Auto, 0); // Throws
+    }
+
+    static std::string get_path(const std::string& db_path)
+    {
+        return get_core_file(db_path, CoreFileType::Management) + "/changed_pages";
+    }
+
+    // Forget everything recorded for a file which was rewritten as a whole,
+    // so that the next backup copies all of it.
+    static void reset(const std::string& db_path)
+    {
+        std::string path = get_path(db_path);
+        if (File::exists(path)) {
+            File file(path, File::mode_Update); // Throws
+            file.resize(0);                     // Throws
+        }
+    }
+
+    // Called by a commit creating `version` before the new top ref is written
+    // to the file header, with the ranges written by it.
+    void record_commit(const std::vector<std::pair<size_t, size_t>>& ranges, version_type version, ref_type top_ref,
+                       bool sync)
+    {
+        Header header = read_header(); // Throws
+        record_writes(ranges);         // Throws
+        if (header.tracked_version + 1 != version)
+            header.chain_start = version - 1;
+        header.tracked_version = version;
+        header.tracked_top_ref = top_ref;
+        write_fields(header, offsetof(Header, tracked_version), offsetof(Header, epoch_version)); // Throws
+        if (sync)
+            m_file.sync(); // Throws
+    }
+
+    // Called with the ranges written by a flush of a write transaction, which
+    // become part of the version it commits.
+    void record_flush(const std::vector<std::pair<size_t, size_t>>& ranges)
+    {
+        read_header();         // Throws
+        record_writes(ranges); // Throws
+    }
+
+    // Start a new epoch at `version`, which must be the latest version, and
+    // return the pages written since the previous one. The previous backup is
+    // forgotten until set_backup() is called for the new epoch.
+    Epoch start_epoch(version_type version, ref_type top_ref, bool sync)
+    {
+        Header header = read_header(); // Throws
+        Epoch epoch;
+        bool chain_intact = header.tracked_version == version && header.tracked_top_ref == top_ref;
+        if (chain_intact && header.chain_start <= header.epoch_version && header.backup_version != 0 &&
+            header.backup_version == header.epoch_version) {
+            epoch.previous = {version_type(header.backup_version), ref_type(header.backup_top_ref),
+                              size_t(header.backup_file_size)};
+            size_t bitmap_size = size_t(m_file.get_size()) - sizeof(Header);
+            std::vector<char> bitmap(bitmap_size);
+            File::read_at_static(m_file.get_descriptor(), sizeof(Header), bitmap.data(), bitmap_size); // Throws
+            epoch.written_pages = std::move(bitmap);
+        }
+        if (!chain_intact) {
+            header.tracked_version = version;
+            header.tracked_top_ref = top_ref;
+            header.chain_start = version;
+        }
+        header.epoch_version = version;
+        header.backup_version = 0;
+        header.backup_top_ref = 0;
+        header.backup_file_size = 0;
+        // The previous backup must be forgotten before the bitmap is cleared
+        write_fields(header, 0, sizeof(Header)); // Throws
+        if (sync)
+            m_file.sync();              // Throws
+        m_file.resize(sizeof(Header)); // Throws
+        return epoch;
+    }
+
+    // Record that the backup of the epoch which started at `backup.version`
+    // is complete, unless another epoch has started since.
+    void set_backup(const Backup& backup, bool sync)
+    {
+        Header header;
+        if (!try_read_header(header) || header.epoch_version != backup.version)
+            return;
+        header.backup_version = backup.version;
+        header.backup_top_ref = backup.top_ref;
+        header.backup_file_size = backup.file_size;
+        write_fields(header, offsetof(Header, backup_version), sizeof(Header)); // Throws
+        if (sync)
+            m_file.sync(); // Throws
+    }
+
+private:
+    static constexpr uint64_t s_magic = 0x5345474150474843; // "CHGPAGES"
+
+    struct Header {
+        uint64_t magic;
+        uint64_t page_size;
+        // The newest version recorded, and the version after which every
+        // commit was recorded
+        uint64_t tracked_version;
+        uint64_t tracked_top_ref;
+        uint64_t chain_start;
+        // The bitmap holds the pages written after this version
+        uint64_t epoch_version;
+        // The last complete backup, which is zero while one is being written
+        uint64_t backup_version;
+        uint64_t backup_top_ref;
+        uint64_t backup_file_size;
+    };
+
+    File m_file;
+
+    bool try_read_header(Header& header)
+    {
+        size_t n = File::read_at_static(m_file.get_descriptor(), 0, reinterpret_cast<char*>(&header),
+                                        sizeof header); // Throws
+        return n == sizeof header && header.magic == s_magic && header.page_size == page_size;
+    }
+
+    // Read the header, starting the file over if it does not hold one. Must
+    // be called with the write lock held.
+    Header read_header()
+    {
+        Header header;
+        if (try_read_header(header)) // Throws
+            return header;
+        header = Header{s_magic, page_size, 0, 0, 0, 0, 0, 0, 0};
+        m_file.resize(0);                        // Throws
+        write_fields(header, 0, sizeof(Header)); // Throws
+        return header;
+    }
+
+    void write_fields(const Header& header, size_t begin, size_t end)
+    {
+        File::write_at_static(m_file.get_descriptor(), begin, reinterpret_cast<const char*>(&header) + begin,
+                              end - begin); // Throws
+    }
+
+    void record_writes(const std::vector<std::pair<size_t, size_t>>& ranges)
+    {
+        // Runs of pages as (first, end), in file order
+        std::vector<std::pair<size_t, size_t>> runs;
+        runs.reserve(ranges.size()); // Throws
+        for (auto [ref, size] : ranges) {
+            if (size != 0)
+                runs.emplace_back(ref / page_size, (ref + size - 1) / page_size + 1);
+        }
+        std::sort(runs.begin(), runs.end());
+
+        // The bytes of the bitmap covering runs which are close to each other
+        // are updated with a single read and write
+        constexpr size_t max_gap = 64;
+        auto fd = m_file.get_descriptor();
+        std::vector<char> bytes;
+        auto run = runs.begin();
+        while (run != runs.end()) {
+            size_t begin = run->first / 8;
+            size_t end = (run->second + 7) / 8;
+            auto group_end = run + 1;
+            while (group_end != runs.end() && group_end->first / 8 <= end + max_gap) {
+                end = std::max(end, (group_end->second + 7) / 8);
+                ++group_end;
+            }
+            // The bitmap only covers the pages written so far, and reads
+            // beyond its end leave the bytes cleared
+            bytes.assign(end - begin, 0);                                                 // Throws
+            File::read_at_static(fd, sizeof(Header) + begin, bytes.data(), bytes.size()); // Throws
+            for (; run != group_end; ++run) {
+                for (size_t page = run->first; page < run->second; ++page)
+                    bytes[page / 8 - begin] |= char(1 << (page % 8));
+            }
+            File::write_at_static(fd, sizeof(Header) + begin, bytes.data(), bytes.size()); // Throws
+        }
+    }
+};
+
 #if REALM_HAVE_STD_FILESYSTEM
 std::string DBOptions::sys_tmp_dir = std::filesystem::temp_directory_path().string();
 #else
@@ -906,6 +1341,11 @@ void DB::open(const std::string& path, const DBOptions& options)
 
     REALM_ASSERT(!is_attached());
     REALM_ASSERT(path.size());
+    if (options.enable_background_compaction &&
+        !(options.background_compaction_duty_cycle > 0 && options.background_compaction_duty_cycle <= 1)) {
+        throw InvalidArgument(
+            format("Invalid background compaction duty cycle: %1", options.background_compaction_duty_cycle));
+    }
 
     m_db_path = path;
 
@@ -924,6 +1364,7 @@ void DB::open(const std::string& path, const DBOptions& options)
         cfg.read_only = true;
         cfg.no_create = true;
         cfg.encryption_key = options.encryption_key;
+        cfg.mapping_advice = to_mapping_advice(options.mapping_advice);
         top_ref = alloc.attach_file(path, cfg);
         SlabAlloc::DetachGuard dg(alloc);
         Group::read_only_version_check(alloc, top_ref, path);
@@ -942,6 +1383,11 @@ void DB::open(const std::string& path, const DBOptions& options)
         openers_hist_type = repl->get_history_type();
         openers_hist_schema_version = repl->get_history_schema_version();
     }
+    // A commit which leaves its sync to a later writer is visible before it is
+    // durable. The sync client would upload it and the server serve it in that
+    // window, so that a crash could lose a version already known to others.
+    if (openers_hist_type == Replication::hist_SyncClient || openers_hist_type == Replication::hist_SyncServer)
+        m_group_commit = false;
 
     int current_file_format_version;
     int target_file_format_version;
@@ -1156,6 +1602,8 @@ void DB::open(const std::string& path, const DBOptions& options)
             cfg.clear_file = (options.durability == Durability::MemOnly && begin_new_session);
 
             cfg.encryption_key = options.encryption_key;
+            cfg.mapping_advice = to_mapping_advice(options.mapping_advice);
+            cfg.huge_pages = options.use_huge_pages_for_slabs;
             m_marker_observer = std::make_unique<EncryptionMarkerObserver>(*version_manager);
             try {
                 top_ref = alloc.attach_file(path, cfg, m_marker_observer.get()); // Throws
@@ -1479,6 +1927,19 @@ void DB::open(const std::string& path, const DBOptions& options)
         throw;
     }
     m_alloc.set_read_only(true);
+
+    if (options.enable_background_compaction && options.durability != Durability::MemOnly) {
+        m_compactor = std::make_unique<BackgroundCompactor>(weak_from_this(), options);
+    }
+    if (options.track_changed_pages && options.durability != Durability::MemOnly && !options.encryption_key) {
+        m_page_tracker = std::make_unique<ChangedPageTracker>(path); // Throws
+    }
+    if (options.warm_up_on_open) {
+        warm_up();
+    }
+    if (!options.hot_tables.empty()) {
+        set_hot_tables(options.hot_tables, options.hot_tables_memory_limit);
+    }
 }
 
 void DB::open(BinaryData buffer, bool take_ownership)
@@ -1634,6 +2095,8 @@ bool DB::compact(bool bump_version_number, util::Optional<const char*> output_en
     if (is_attached() == false) {
         throw Exception(ErrorCodes::IllegalOperation, m_db_path + ": compact must be done on an open/attached DB");
     }
+    // The file is reattached, so no accessors can be kept across
+    discard_idle_reader();
     auto info = m_info;
     Durability dura = Durability(info->durability);
     const char* write_key = bool(output_encryption_key) ? *output_encryption_key : get_encryption_key();
@@ -1655,6 +2118,10 @@ bool DB::compact(bool bump_version_number, util::Optional<const char*> output_en
 
         // local lock blocking any transaction from starting (and stopping)
         CheckedLockGuard local_lock(m_mutex);
+        block_read_lock_fast_path();
+        auto unblock_fast_path = make_scope_exit([&]() noexcept {
+            unblock_read_lock_fast_path();
+        });
 
         // We should be the only transaction active - otherwise back out
         if (m_transaction_count != 1)
@@ -1697,6 +2164,7 @@ bool DB::compact(bool bump_version_number, util::Optional<const char*> output_en
         m_alloc.detach();
 
         util::File::move(tmp_path, m_db_path);
+        ChangedPageTracker::reset(m_db_path);
 
         SlabAlloc::Config cfg;
         cfg.session_initiator = true;
@@ -1706,6 +2174,8 @@ bool DB::compact(bool bump_version_number, util::Optional<const char*> output_en
         cfg.no_create = true;
         cfg.clear_file = false;
         cfg.encryption_key = write_key;
+        cfg.mapping_advice = m_alloc.m_cfg.mapping_advice;
+        cfg.huge_pages = m_alloc.m_cfg.huge_pages;
         ref_type top_ref;
         top_ref = m_alloc.attach_file(m_db_path, cfg, m_marker_observer.get());
         m_alloc.convert_from_streaming_form(top_ref);
@@ -1764,6 +2234,135 @@ void DB::write_copy(StringData path, const char* output_encryption_key)
     }
 }
 
+DB::IncrementalBackupResult DB::write_incremental_backup(const std::string& path)
+{
+    if (!m_page_tracker)
+        throw IllegalOperation("Changed page tracking is not enabled for this file");
+    if (path == m_db_path)
+        throw IllegalOperation("Cannot write a backup of a file to the file itself");
+
+    // Whether the file at `path` holds the given backup: the header must refer
+    // to its top ref, and the top array must hold its version
+    auto holds_backup = [&](File& file, const ChangedPageTracker::Backup& backup) {
+        if (backup.version == 0 || backup.top_ref == 0 || size_t(file.get_size()) != backup.file_size)
+            return false;
+        auto fd = file.get_descriptor();
+        SlabAlloc::Header header;
+        if (File::read_at_static(fd, 0, reinterpret_cast<char*>(&header), sizeof header) != sizeof header)
+            return false;
+        if (header.m_top_ref[header.m_flags & SlabAlloc::flags_SelectBit] != backup.top_ref)
+            return false;
+        char top_header[NodeHeader::header_size];
+        if (File::read_at_static(fd, backup.top_ref, top_header, sizeof top_header) != sizeof top_header)
+            return false;
+        if (NodeHeader::get_wtype_from_header(top_header) != NodeHeader::wtype_Bits ||
+            NodeHeader::get_size_from_header(top_header) <= Group::s_version_ndx)
+            return false;
+        std::vector<char> top(NodeHeader::get_byte_size_from_header(top_header));
+        if (File::read_at_static(fd, backup.top_ref, top.data(), top.size()) != top.size())
+            return false;
+        uint64_t value = uint64_t(get_direct(top.data() + NodeHeader::header_size,
+                                             NodeHeader::get_width_from_header(top_header), Group::s_version_ndx));
+        return (value & 1) != 0 && value >> 1 == backup.version;
+    };
+
+    bool disable_sync = get_disable_sync_to_disk() || Durability(m_info->durability) == Durability::Unsafe;
+    std::lock_guard lock(m_backup_mutex);
+
+    // The latest version is picked with the write lock held, so that the
+    // pages written after it are recorded in the next epoch
+    ReadLockInfo read_lock;
+    ChangedPageTracker::Epoch epoch;
+    {
+        do_begin_write(); // Throws
+        auto end_write = util::make_scope_exit([&]() noexcept {
+            do_end_write();
+        });
+        read_lock = grab_read_lock(ReadLockInfo::Live, VersionID()); // Throws
+        ReadLockGuard g(*this, read_lock);
+        epoch = m_page_tracker->start_epoch(read_lock.m_version, read_lock.m_top_ref, !disable_sync); // Throws
+        g.release();
+    }
+    // The read lock keeps the pages holding the version from being reused
+    // while they are copied
+    ReadLockGuard g(*this, read_lock);
+    auto t1 = std::chrono::steady_clock::now();
+
+    File source(m_db_path); // Throws
+    File target;
+    target.open(path, File::access_ReadWrite, File::create_Auto, 0); // Throws
+    IncrementalBackupResult result;
+    result.version = read_lock.m_version;
+    result.full_copy = !epoch.written_pages || !holds_backup(target, epoch.previous); // Throws
+    size_t file_size = read_lock.m_file_size;
+    target.resize(file_size); // Throws
+
+    std::unique_ptr<char[]> buffer = std::make_unique<char[]>(1024 * 1024); // Throws
+    auto copy = [&](size_t begin, size_t end) {
+        end = std::min(end, file_size);
+        while (begin < end) {
+            size_t n = std::min(end - begin, size_t(1024 * 1024));
+            n = File::read_at_static(source.get_descriptor(), begin, buffer.get(), n); // Throws
+            if (n == 0)
+                throw FileAccessError(ErrorCodes::FileOperationFailed,
+                                      util::format("'%1' ended unexpectedly at %2 bytes", m_db_path, begin),
+                                      m_db_path);
+            File::write_at_static(target.get_descriptor(), begin, buffer.get(), n); // Throws
+            begin += n;
+            result.bytes_copied += n;
+        }
+    };
+    if (result.full_copy) {
+        copy(0, file_size); // Throws
+    }
+    else {
+        // Copy each run of pages written since the previous backup
+        const std::vector<char>& bitmap = *epoch.written_pages;
+        auto is_written = [&](size_t page) {
+            return (bitmap[page / 8] & (1 << (page % 8))) != 0;
+        };
+        size_t num_pages = std::min(bitmap.size() * 8, (file_size + ChangedPageTracker::page_size - 1) /
+                                                           ChangedPageTracker::page_size);
+        size_t page = 0;
+        while (page < num_pages) {
+            if (!is_written(page)) {
+                ++page;
+                continue;
+            }
+            size_t run_end = page + 1;
+            while (run_end < num_pages && is_written(run_end))
+                ++run_end;
+            copy(page * ChangedPageTracker::page_size, run_end * ChangedPageTracker::page_size); // Throws
+            page = run_end;
+        }
+    }
+
+    // The header is written last, once the pages it refers to are in place.
+    // Both slots refer to the backed up version.
+    SlabAlloc::Header header;
+    File::read_at_static(source.get_descriptor(), 0, reinterpret_cast<char*>(&header), sizeof header); // Throws
+    int slot = header.m_flags & SlabAlloc::flags_SelectBit;
+    header.m_top_ref[0] = header.m_top_ref[1] = read_lock.m_top_ref;
+    header.m_file_format[0] = header.m_file_format[1] = header.m_file_format[slot];
+    header.m_flags &= ~SlabAlloc::flags_SelectBit;
+    if (!disable_sync)
+        target.sync(); // Throws
+    File::write_at_static(target.get_descriptor(), 0, reinterpret_cast<const char*>(&header), sizeof header); // Throws
+    if (!disable_sync)
+        target.sync(); // Throws
+    result.bytes_copied += sizeof header;
+
+    m_page_tracker->set_backup({read_lock.m_version, read_lock.m_top_ref, file_size}, !disable_sync); // Throws
+
+    if (m_logger) {
+        auto t2 = std::chrono::steady_clock::now();
+        m_logger->log(util::Logger::Level::info, "%1 backup of version %2 written to '%3': %4 of %5 bytes in %6 us",
+                      result.full_copy ? "Full" : "Incremental", result.version, path, result.bytes_copied,
+                      file_size, std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+    }
+    return result;
+}
+
 uint_fast64_t DB::get_number_of_versions()
 {
     if (m_fake_read_lock_if_immutable)
@@ -1779,19 +2378,29 @@ size_t DB::get_allocated_size() const
 void DB::release_all_read_locks() noexcept
 {
     REALM_ASSERT(!m_fake_read_lock_if_immutable);
-    CheckedLockGuard local_lock(m_mutex); // mx on m_local_locks_held
-    for (auto& read_lock : m_local_locks_held) {
-        --m_transaction_count;
-        m_version_manager->release_read_lock(read_lock);
-    }
-    m_local_locks_held.clear();
+    CheckedLockGuard local_lock(m_mutex);
+    block_read_lock_fast_path(); // never unblocked, as the DB is being closed
+    m_transaction_count -= int(m_version_manager->release_all_read_locks());
     REALM_ASSERT(m_transaction_count == 0);
 }
 
+DB::ReadLockStats DB::get_read_lock_stats() const
+{
+    CheckedLockGuard local_lock(m_mutex);
+    if (!m_version_manager)
+        return {};
+    return m_version_manager->get_read_lock_stats();
+}
+
 class DB::AsyncCommitHelper {
 public:
-    AsyncCommitHelper(DB* db)
+    // With a pipeline depth, the write lock is handed on to the next async
+    // writer while up to that many earlier commits are waiting to be synced to
+    // disk. The lock is kept by this process until all of them are synced, so
+    // the file header is only ever written by the syncs, in commit order.
+    AsyncCommitHelper(DB* db, size_t pipeline_depth)
         : m_db(db)
+        , m_pipeline_depth(pipeline_depth)
     {
     }
     ~AsyncCommitHelper()
@@ -1807,15 +2416,15 @@ public:
         m_thread.join();
     }
 
-    void begin_write(util::UniqueFunction<void()> fn)
+    void begin_write(util::UniqueFunction<void()> fn, WritePriority priority)
     {
         std::unique_lock lg(m_mutex);
         start_thread();
-        m_pending_writes.emplace_back(std::move(fn));
+        m_pending_writes.push_back({std::move(fn), priority});
         m_cv_worker.notify_one();
     }
 
-    void blocking_begin_write()
+    void blocking_begin_write(WritePriority priority)
     {
         std::unique_lock lg(m_mutex);
 
@@ -1836,7 +2445,7 @@ public:
         if (can_lock_on_caller) {
             m_waiting_for_write_mutex = true;
             lg.unlock();
-            m_db->do_begin_write();
+            m_db->do_begin_write(priority);
             lg.lock();
             m_waiting_for_write_mutex = false;
             m_has_write_mutex = true;
@@ -1848,6 +2457,7 @@ public:
         // for that
         start_thread();
         size_t ticket = ++m_write_lock_claim_ticket;
+        m_claim_priority = std::max(m_claim_priority, priority);
         m_cv_worker.notify_one();
         m_cv_callers.wait(lg, [this, ticket] {
             return ticket == m_write_lock_claim_fulfilled;
@@ -1862,7 +2472,7 @@ public:
 
         // If we acquired the write lock on the worker thread, also release it
         // there even if our mutex supports unlocking cross-thread as it simplifies things.
-        if (m_owns_write_mutex) {
+        if (m_owns_write_mutex || !m_pending_syncs.empty()) {
             m_pending_mx_release = true;
             m_cv_worker.notify_one();
         }
@@ -1882,7 +2492,8 @@ public:
 
         // If we acquired the write lock on the worker thread, also release it
         // there even if our mutex supports unlocking cross-thread as it simplifies things.
-        if (m_owns_write_mutex) {
+        // The same goes for when earlier commits are still to be synced.
+        if (m_owns_write_mutex || !m_pending_syncs.empty()) {
             m_pending_mx_release = true;
             m_cv_worker.notify_one();
             m_cv_callers.wait(lg, [this] {
@@ -1904,26 +2515,45 @@ public:
     }
 
 
+    // Sync the commits of the current writer to disk and release the write
+    // lock. Without pipelining, the write lock is held until the sync is done.
     void sync_to_disk(util::UniqueFunction<void()> fn)
     {
         REALM_ASSERT(fn);
         std::unique_lock lg(m_mutex);
-        REALM_ASSERT(!m_pending_sync);
+        REALM_ASSERT(m_pipeline_depth || m_pending_syncs.empty());
         start_thread();
-        m_pending_sync = std::move(fn);
+        m_pending_syncs.push_back(std::move(fn));
+        if (m_pipeline_depth)
+            m_pending_mx_release = true;
         m_cv_worker.notify_one();
     }
 
+    // The number of commits waiting to be synced to disk, or being synced.
+    size_t get_pipeline_depth()
+    {
+        std::unique_lock lg(m_mutex);
+        return m_pending_syncs.size();
+    }
+
 private:
     DB* m_db;
+    const size_t m_pipeline_depth;
     std::thread m_thread;
     std::mutex m_mutex;
     std::condition_variable m_cv_worker;
     std::condition_variable m_cv_callers;
-    std::deque<util::UniqueFunction<void()>> m_pending_writes;
-    util::UniqueFunction<void()> m_pending_sync;
+    struct PendingWrite {
+        util::UniqueFunction<void()> fn;
+        WritePriority priority;
+    };
+    std::deque<PendingWrite> m_pending_writes;
+    // The front entry stays in the queue while it runs
+    std::deque<util::UniqueFunction<void()>> m_pending_syncs;
     size_t m_write_lock_claim_ticket = 0;
     size_t m_write_lock_claim_fulfilled = 0;
+    // The highest priority of the outstanding claims
+    WritePriority m_claim_priority = WritePriority::Background;
     bool m_pending_mx_release = false;
     bool m_running = false;
     bool m_has_write_mutex = false;
@@ -1947,6 +2577,114 @@ private:
     {
         return m_write_lock_claim_fulfilled < m_write_lock_claim_ticket || !m_pending_writes.empty();
     }
+
+    // The write lock is acquired for everyone who is waiting for it, so at the
+    // highest priority any of them asked for.
+    WritePriority requested_priority()
+    {
+        WritePriority priority = WritePriority::Background;
+        if (m_write_lock_claim_fulfilled < m_write_lock_claim_ticket)
+            priority = m_claim_priority;
+        for (auto& write : m_pending_writes)
+            priority = std::max(priority, write.priority);
+        return priority;
+    }
+};
+
+// Carries on the online compaction of the file, by making steps of it in a
+// thread of its own for as long as commits report evacuation to be going on,
+// or the file to be larger than its logical size. The time spent holding the
+// write lock is kept to the configured duty cycle by pausing between steps.
+//
+// The thread only holds a strong reference to the DB while making a step. If
+// that turns out to be the last reference, the DB is destroyed on the thread
+// itself, which is why the state shared with the thread is reference counted.
+class DB::BackgroundCompactor {
+public:
+    BackgroundCompactor(std::weak_ptr<DB> db, const DBOptions& options)
+        : m_state(std::make_shared<State>())
+    {
+        m_thread = std::thread(main, m_state, std::move(db), options.background_compaction_duty_cycle,
+                               options.background_compaction_step_size);
+    }
+
+    ~BackgroundCompactor() noexcept
+    {
+        {
+            std::lock_guard lock(m_state->mutex);
+            m_state->stop = true;
+        }
+        m_state->cv.notify_one();
+        if (m_thread.get_id() == std::this_thread::get_id())
+            m_thread.detach();
+        else
+            m_thread.join();
+    }
+
+    // Called after commits which leave work to be done
+    void notify() noexcept
+    {
+        {
+            std::lock_guard lock(m_state->mutex);
+            m_state->notified = true;
+        }
+        m_state->cv.notify_one();
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stop = false;
+        bool notified = false;
+    };
+    std::shared_ptr<State> m_state;
+    std::thread m_thread;
+
+    static void main(std::shared_ptr<State> state, std::weak_ptr<DB> weak_db, double duty_cycle, size_t step_size)
+    {
+        using namespace std::chrono;
+        util::on_thread_start(util::ThreadRole::compaction);
+        // Commits made in other processes are not notified, so look for work
+        // now and then
+        constexpr auto poll_interval = seconds(1);
+        nanoseconds pause{0};
+        std::unique_lock lock(state->mutex);
+        while (!state->stop) {
+            if (pause.count()) {
+                state->cv.wait_for(lock, pause, [&] {
+                    return state->stop;
+                });
+            }
+            else {
+                state->cv.wait_for(lock, poll_interval, [&] {
+                    return state->stop || state->notified;
+                });
+            }
+            if (state->stop)
+                break;
+            state->notified = false;
+            lock.unlock();
+            pause = nanoseconds(0);
+            if (auto db = weak_db.lock()) {
+                auto t1 = steady_clock::now();
+                try {
+                    if (db->background_compaction_step(step_size)) {
+                        auto busy = steady_clock::now() - t1;
+                        pause = duration_cast<nanoseconds>(busy * ((1 - duty_cycle) / duty_cycle));
+                    }
+                }
+                catch (const std::exception& e) {
+                    if (auto logger = db->get_logger()) {
+                        logger->log(util::LogCategory::storage, util::Logger::Level::error,
+                                    "Background compaction failed: %1", e.what());
+                    }
+                }
+            }
+            // The DB may have been destroyed by now, along with the compactor
+            lock.lock();
+        }
+    }
 };
 
 DB::~DB() noexcept
@@ -1961,6 +2699,9 @@ void DB::close(bool allow_open_read_transactions)
 {
     // make helper thread(s) terminate
     m_commit_helper.reset();
+    m_compactor.reset();
+    m_page_tracker.reset();
+    discard_idle_reader();
 
     if (m_fake_read_lock_if_immutable) {
         if (!is_attached())
@@ -2005,6 +2746,7 @@ void DB::close_internal(std::unique_lock<InterprocessMutex> lock, bool allow_ope
             info->sync_agent_present = 0; // Set to false
         }
         release_all_read_locks();
+        m_durable_read_lock.reset();
         --info->num_participants;
         bool end_of_session = info->num_participants == 0;
         // std::cerr << "closing" << std::endl;
@@ -2048,33 +2790,60 @@ void DB::close_internal(std::unique_lock<InterprocessMutex> lock, bool allow_ope
 
 bool DB::other_writers_waiting_for_lock() const
 {
-    SharedInfo* info = m_info;
+    // When holding the write lock with a ticket, the queue of our priority
+    // counts us as well.
+    return m_info->num_writers() > (m_write_ticketed ? 1 : 0);
+}
 
-    uint32_t next_ticket = info->next_ticket.load(std::memory_order_relaxed);
-    uint32_t next_served = info->next_served.load(std::memory_order_relaxed);
-    // When holding the write lock, next_ticket = next_served + 1, hence, if the diference between 'next_ticket' and
-    // 'next_served' is greater than 1, there is at least one thread waiting to acquire the write lock.
-    return next_ticket > next_served + 1;
+bool DB::writers_waiting_for_lock(WritePriority priority) const
+{
+    uint32_t n = 0;
+    for (size_t p = size_t(priority); p < num_write_priorities; ++p)
+        n += m_info->num_writers(p);
+    bool counts_us = m_write_ticketed && m_write_priority >= priority;
+    return n > (counts_us ? 1 : 0);
 }
 
 void DB::AsyncCommitHelper::main()
 {
+    util::on_thread_start(util::ThreadRole::async_commit);
     std::unique_lock lg(m_mutex);
     while (m_running) {
 #if 0 // Enable for testing purposes
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
 #endif
         if (m_has_write_mutex) {
-            if (auto cb = std::move(m_pending_sync)) {
-                // Only one of sync_to_disk(), end_write(), or blocking_end_write()
-                // should be called, so we should never have both a pending sync
-                // and pending release.
-                REALM_ASSERT(!m_pending_mx_release);
+            // When pipelining, hand the write lock on to the next async writer
+            // before syncing the commits of the previous ones. Synchronous
+            // transactions commit to disk themselves, so they have to wait for
+            // the syncs and get the lock the usual way.
+            if (m_pending_mx_release && !m_pending_writes.empty() && !m_pending_syncs.empty() &&
+                m_pending_syncs.size() <= m_pipeline_depth &&
+                m_write_lock_claim_fulfilled == m_write_lock_claim_ticket) {
+                m_pending_mx_release = false;
+                auto callback = std::move(m_pending_writes.front().fn);
+                m_pending_writes.pop_front();
+                lg.unlock();
+                m_cv_callers.notify_all();
+                callback();
+                callback = nullptr;
+                lg.lock();
+                continue;
+            }
+            if (!m_pending_syncs.empty()) {
+                // Without pipelining, only one of sync_to_disk(), end_write(),
+                // or blocking_end_write() should be called, so we should never
+                // have both a pending sync and pending release.
+                REALM_ASSERT(m_pipeline_depth || !m_pending_mx_release);
+                auto cb = std::move(m_pending_syncs.front());
                 lg.unlock();
                 cb();
                 cb = nullptr; // Release things captured by the callback before reacquiring the lock
                 lg.lock();
-                m_pending_mx_release = true;
+                m_pending_syncs.pop_front();
+                if (!m_pipeline_depth)
+                    m_pending_mx_release = true;
+                continue;
             }
             if (m_pending_mx_release) {
                 REALM_ASSERT(!InterprocessMutex::is_thread_confined || m_owns_write_mutex);
@@ -2090,15 +2859,16 @@ void DB::AsyncCommitHelper::main()
             }
         }
         else {
-            REALM_ASSERT(!m_pending_sync && !m_pending_mx_release);
+            REALM_ASSERT(m_pending_syncs.empty() && !m_pending_mx_release);
 
             // Acquire the write lock if anyone has requested it, but only if
             // another thread is not already waiting for it. If there's another
             // thread requesting and they get it while we're waiting, we'll
             // deadlock if they ask us to perform the sync.
             if (!m_waiting_for_write_mutex && has_pending_write_requests()) {
+                WritePriority priority = requested_priority();
                 lg.unlock();
-                m_db->do_begin_write();
+                m_db->do_begin_write(priority);
                 lg.lock();
 
                 REALM_ASSERT(!m_has_write_mutex);
@@ -2107,13 +2877,14 @@ void DB::AsyncCommitHelper::main()
 
                 // Synchronous transaction requests get priority over async
                 if (m_write_lock_claim_fulfilled < m_write_lock_claim_ticket) {
-                    ++m_write_lock_claim_fulfilled;
+                    if (++m_write_lock_claim_fulfilled == m_write_lock_claim_ticket)
+                        m_claim_priority = WritePriority::Background;
                     m_cv_callers.notify_all();
                     continue;
                 }
 
                 REALM_ASSERT(!m_pending_writes.empty());
-                auto callback = std::move(m_pending_writes.front());
+                auto callback = std::move(m_pending_writes.front().fn);
                 m_pending_writes.pop_front();
                 lg.unlock();
                 callback();
@@ -2130,10 +2901,10 @@ void DB::AsyncCommitHelper::main()
     }
 }
 
-void DB::async_begin_write(util::UniqueFunction<void()> fn)
+void DB::async_begin_write(WritePriority priority, util::UniqueFunction<void()> fn)
 {
     REALM_ASSERT(m_commit_helper);
-    m_commit_helper->begin_write(std::move(fn));
+    m_commit_helper->begin_write(std::move(fn), priority);
 }
 
 void DB::async_end_write()
@@ -2148,6 +2919,11 @@ void DB::async_sync_to_disk(util::UniqueFunction<void()> fn)
     m_commit_helper->sync_to_disk(std::move(fn));
 }
 
+size_t DB::get_async_pipeline_depth()
+{
+    return m_commit_helper ? m_commit_helper->get_pipeline_depth() : 0;
+}
+
 bool DB::has_changed(TransactionRef& tr)
 {
     if (m_fake_read_lock_if_immutable)
@@ -2292,32 +3068,62 @@ void DB::upgrade_file_format(bool allow_file_format_upgrade, int target_file_for
     }
 }
 
+bool DB::enter_read_lock_fast_path() noexcept
+{
+    if (!(m_read_lock_fast_path.fetch_add(1) & s_read_lock_fast_path_blocked))
+        return true;
+    leave_read_lock_fast_path();
+    return false;
+}
+
+void DB::leave_read_lock_fast_path() noexcept
+{
+    m_read_lock_fast_path.fetch_sub(1);
+}
+
+void DB::block_read_lock_fast_path() noexcept
+{
+    m_read_lock_fast_path.fetch_or(s_read_lock_fast_path_blocked);
+    while (m_read_lock_fast_path.load() != s_read_lock_fast_path_blocked)
+        std::this_thread::yield();
+}
+
+void DB::unblock_read_lock_fast_path() noexcept
+{
+    m_read_lock_fast_path.fetch_and(~s_read_lock_fast_path_blocked);
+}
+
 void DB::release_read_lock(ReadLockInfo& read_lock) noexcept
 {
     // ignore if opened with immutable file (then we have no lockfile)
     if (m_fake_read_lock_if_immutable)
         return;
-    CheckedLockGuard lock(m_mutex); // mx on m_local_locks_held
-    do_release_read_lock(read_lock);
+    if (m_track_pinned_versions && !unpin_read_lock(read_lock))
+        return;
+    if (enter_read_lock_fast_path()) {
+        bool released = m_version_manager->try_release_local_read_lock(read_lock);
+        if (released)
+            --m_transaction_count;
+        leave_read_lock_fast_path();
+        if (released)
+            return;
+    }
+    CheckedLockGuard lock(m_mutex);
+    if (!is_attached()) {
+        // it's OK, someone called close() and all locks where released
+        return;
+    }
+    --m_transaction_count;
+    m_version_manager->release_read_lock(read_lock);
 }
 
 // this is called with m_mutex locked
 void DB::do_release_read_lock(ReadLockInfo& read_lock) noexcept
 {
     REALM_ASSERT(!m_fake_read_lock_if_immutable);
-    bool found_match = false;
-    // simple linear search and move-last-over if a match is found.
-    // common case should have only a modest number of transactions in play..
-    for (size_t j = 0; j < m_local_locks_held.size(); ++j) {
-        if (m_local_locks_held[j].m_version == read_lock.m_version) {
-            m_local_locks_held[j] = m_local_locks_held.back();
-            m_local_locks_held.pop_back();
-            found_match = true;
-            break;
-        }
-    }
-    if (!found_match) {
-        REALM_ASSERT(!is_attached());
+    if (m_track_pinned_versions && !unpin_read_lock(read_lock))
+        return;
+    if (!is_attached()) {
         // it's OK, someone called close() and all locks where released
         return;
     }
@@ -2328,44 +3134,156 @@ void DB::do_release_read_lock(ReadLockInfo& read_lock) noexcept
 
 DB::ReadLockInfo DB::grab_read_lock(ReadLockInfo::Type type, VersionID version_id)
 {
-    CheckedLockGuard lock(m_mutex); // mx on m_local_locks_held
-    REALM_ASSERT_RELEASE(is_attached());
-    auto read_lock = m_version_manager->grab_read_lock(type, version_id);
+    ReadLockInfo read_lock;
+    bool grabbed = false;
+    if (enter_read_lock_fast_path()) {
+        grabbed = m_version_manager->try_grab_local_read_lock(read_lock, type, version_id);
+        if (grabbed)
+            ++m_transaction_count;
+        leave_read_lock_fast_path();
+    }
+
+    if (!grabbed) {
+        CheckedLockGuard lock(m_mutex);
+        REALM_ASSERT_RELEASE(is_attached());
+        read_lock = m_version_manager->grab_read_lock(type, version_id);
+        ++m_transaction_count;
+        REALM_ASSERT(read_lock.m_file_size > read_lock.m_top_ref);
+    }
 
-    m_local_locks_held.emplace_back(read_lock);
-    ++m_transaction_count;
-    REALM_ASSERT(read_lock.m_file_size > read_lock.m_top_ref);
+    if (m_track_pinned_versions) {
+        ReadLockGuard g(*this, read_lock);
+        pin_read_lock(read_lock); // Throws
+        g.release();
+    }
     return read_lock;
 }
 
 void DB::leak_read_lock(ReadLockInfo& read_lock) noexcept
 {
-    CheckedLockGuard lock(m_mutex); // mx on m_local_locks_held
-    // simple linear search and move-last-over if a match is found.
-    // common case should have only a modest number of transactions in play..
-    for (size_t j = 0; j < m_local_locks_held.size(); ++j) {
-        if (m_local_locks_held[j].m_version == read_lock.m_version) {
-            m_local_locks_held[j] = m_local_locks_held.back();
-            m_local_locks_held.pop_back();
-            --m_transaction_count;
-            return;
+    if (m_track_pinned_versions && !unpin_read_lock(read_lock))
+        return;
+    CheckedLockGuard lock(m_mutex);
+    if (!is_attached())
+        return;
+    --m_transaction_count;
+    m_version_manager->leak_read_lock(read_lock);
+}
+
+void DB::pin_read_lock(ReadLockInfo& read_lock)
+{
+    PinnedReadLock pin;
+    pin.owner_thread = std::this_thread::get_id();
+    if (s_current_pin_tag)
+        pin.tag = s_current_pin_tag->m_tag;
+
+    CheckedLockGuard lock(m_pinned_versions_mutex);
+    pin.since = std::chrono::steady_clock::now();
+    read_lock.m_pin_id = ++m_last_pin_id;
+    pin.read_lock = read_lock;
+    m_pinned_read_locks.emplace(read_lock.m_pin_id, std::move(pin)); // Throws
+}
+
+bool DB::unpin_read_lock(const ReadLockInfo& read_lock) noexcept
+{
+    CheckedLockGuard lock(m_pinned_versions_mutex);
+    auto it = m_pinned_read_locks.find(read_lock.m_pin_id);
+    if (it == m_pinned_read_locks.end())
+        return true;
+    bool expired = it->second.expired;
+    m_pinned_read_locks.erase(it);
+    return !expired;
+}
+
+void DB::keep_read_lock(const ReadLockInfo& read_lock) noexcept
+{
+    if (!m_track_pinned_versions)
+        return;
+    CheckedLockGuard lock(m_pinned_versions_mutex);
+    auto it = m_pinned_read_locks.find(read_lock.m_pin_id);
+    if (it != m_pinned_read_locks.end())
+        it->second.may_expire = false;
+}
+
+bool DB::is_read_lock_expired(const ReadLockInfo& read_lock) const noexcept
+{
+    if (!m_track_pinned_versions)
+        return false;
+    CheckedLockGuard lock(m_pinned_versions_mutex);
+    auto it = m_pinned_read_locks.find(read_lock.m_pin_id);
+    return it != m_pinned_read_locks.end() && it->second.expired;
+}
+
+// this is called with the write lock held, from the commit of the write
+// transaction whose read lock is given
+void DB::expire_old_read_locks(const ReadLockInfo& writer_read_lock) noexcept
+{
+    auto oldest_allowed = std::chrono::steady_clock::now() - m_max_read_transaction_age;
+    CheckedLockGuard lock(m_pinned_versions_mutex);
+    for (auto& [id, pin] : m_pinned_read_locks) {
+        // Entries are in the order the read locks were taken
+        if (pin.since >= oldest_allowed)
+            break;
+        if (pin.expired || !pin.may_expire || pin.read_lock.m_type != ReadLockInfo::Live ||
+            id == writer_read_lock.m_pin_id)
+            continue;
+        if (m_logger) {
+            m_logger->log(util::Logger::Level::warn,
+                          "Releasing read lock on version %1 taken %2 ms ago%3%4", pin.read_lock.m_version,
+                          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                pin.since)
+                              .count(),
+                          pin.tag.empty() ? "" : " by ", pin.tag);
         }
+        pin.expired = true;
+        --m_transaction_count;
+        m_version_manager->release_read_lock(pin.read_lock);
     }
 }
 
-bool DB::do_try_begin_write()
+std::vector<DB::PinnedVersion> DB::get_pinned_versions() const
+{
+    std::vector<PinnedVersion> pinned_versions;
+    auto now = std::chrono::steady_clock::now();
+    CheckedLockGuard lock(m_pinned_versions_mutex);
+    for (auto& [id, pin] : m_pinned_read_locks) {
+        if (pin.expired)
+            continue;
+        pinned_versions.push_back({pin.read_lock.m_version, pin.read_lock.m_type == ReadLockInfo::Frozen,
+                                   now - pin.since, pin.owner_thread, pin.tag});
+    }
+    return pinned_versions;
+}
+
+DB::PinTag::PinTag(std::string tag)
+    : m_tag(std::move(tag))
+    , m_outer(s_current_pin_tag)
+{
+    s_current_pin_tag = this;
+}
+
+DB::PinTag::~PinTag()
+{
+    s_current_pin_tag = m_outer;
+}
+
+bool DB::do_try_begin_write(WritePriority priority)
 {
     // In the non-blocking case, we will only succeed if there is no contention for
     // the write mutex. For this case we are trivially fair and can ignore the
-    // fairness machinery.
+    // fairness machinery. We don't take a ticket, so must not count as served
+    // when we're done either.
     bool got_the_lock = m_writemutex.try_lock();
     if (got_the_lock) {
+        m_write_priority = priority;
+        m_write_ticketed = false;
+        record_write_lock_wait(priority, {});
         finish_begin_write();
     }
     return got_the_lock;
 }
 
-void DB::do_begin_write()
+void DB::do_begin_write(WritePriority priority)
 {
     if (m_logger) {
         m_logger->log(util::LogCategory::transaction, util::Logger::Level::trace, "acquire writemutex");
@@ -2376,14 +3294,17 @@ void DB::do_begin_write()
     // Get write lock - the write lock is held until do_end_write().
     //
     // We use a ticketing scheme to ensure fairness wrt performing write transactions.
+    // Each write priority has a queue of its own, and we also yield to anyone
+    // waiting in the queue of a higher priority. The time limit below keeps
+    // writers of low priority from starving.
     // (But cannot do that on Windows until we have interprocess condition variables there)
-    uint32_t my_ticket = info->next_ticket.fetch_add(1, std::memory_order_relaxed);
+    size_t queue = size_t(priority);
+    auto wait_start = std::chrono::steady_clock::now();
+    uint32_t my_ticket = info->next_ticket[queue].fetch_add(1, std::memory_order_relaxed);
     m_writemutex.lock(); // Throws
 
-    // allow for comparison even after wrap around of ticket numbering:
-    int32_t diff = int32_t(my_ticket - info->next_served.load(std::memory_order_relaxed));
-    bool should_yield = diff > 0; // ticket is in the future
-    // a) the above comparison is only guaranteed to be correct, if the distance
+    bool should_yield = info->must_yield_write_lock(queue, my_ticket);
+    // a) the comparison of tickets is only guaranteed to be correct, if the distance
     //    between my_ticket and info->next_served is less than 2^30. This will
     //    be the case since the distance will be bounded by the number of threads
     //    and each thread cannot ever hold more than one ticket.
@@ -2416,8 +3337,7 @@ void DB::do_begin_write()
             // Timeout!
             break;
         }
-        diff = int32_t(my_ticket - info->next_served);
-        should_yield = diff > 0; // ticket is in the future, so yield to someone else
+        should_yield = info->must_yield_write_lock(queue, my_ticket);
     }
 
     // we may get here because a) it's our turn, b) we timed out
@@ -2427,7 +3347,10 @@ void DB::do_begin_write()
     //
     // In doing so, we may bypass other waiters, hence the condition for yielding
     // should take this situation into account by comparing with '>' instead of '!='
-    info->next_served = my_ticket;
+    info->next_served[queue] = my_ticket;
+    m_write_priority = priority;
+    m_write_ticketed = true;
+    record_write_lock_wait(priority, std::chrono::steady_clock::now() - wait_start);
     finish_begin_write();
     if (m_logger) {
         m_logger->log(util::LogCategory::transaction, util::Logger::Level::trace, "writemutex acquired");
@@ -2449,9 +3372,74 @@ void DB::finish_begin_write()
     m_alloc.set_read_only(false);
 }
 
+void DB::record_write_lock_wait(WritePriority priority, std::chrono::steady_clock::duration wait) noexcept
+{
+    // Only the holder of the write lock gets here, so there are no concurrent
+    // updates.
+    size_t queue = size_t(priority);
+    uint64_t ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count());
+    m_write_lock_acquisitions[queue].fetch_add(1, std::memory_order_relaxed);
+    m_write_lock_wait_ns[queue].fetch_add(ns, std::memory_order_relaxed);
+    if (ns > m_write_lock_max_wait_ns[queue].load(std::memory_order_relaxed))
+        m_write_lock_max_wait_ns[queue].store(ns, std::memory_order_relaxed);
+}
+
+DB::WriteLockWaitStats DB::get_write_lock_wait_stats(WritePriority priority) const
+{
+    size_t queue = size_t(priority);
+    WriteLockWaitStats stats;
+    stats.acquisitions = m_write_lock_acquisitions[queue].load(std::memory_order_relaxed);
+    stats.total_wait = std::chrono::nanoseconds(m_write_lock_wait_ns[queue].load(std::memory_order_relaxed));
+    stats.max_wait = std::chrono::nanoseconds(m_write_lock_max_wait_ns[queue].load(std::memory_order_relaxed));
+    return stats;
+}
+
+DB::Metrics DB::get_metrics()
+{
+    Metrics metrics;
+    auto load_ns = [](const std::atomic<uint64_t>& counter) {
+        return std::chrono::nanoseconds(counter.load(std::memory_order_relaxed));
+    };
+    metrics.commits.commits = m_commit_count.load(std::memory_order_relaxed);
+    metrics.commits.bytes_written = m_commit_bytes_written.load(std::memory_order_relaxed);
+    metrics.commits.last_bytes_written = m_last_commit_bytes_written.load(std::memory_order_relaxed);
+    metrics.commits.write_group_time = load_ns(m_write_group_ns);
+    metrics.commits.free_list_time = load_ns(m_free_list_ns);
+    metrics.commits.sync_time = load_ns(m_commit_sync_ns);
+    metrics.commits.max_commit_time = load_ns(m_max_commit_ns);
+
+    for (size_t i = 0; i < num_write_priorities; ++i) {
+        auto stats = get_write_lock_wait_stats(WritePriority(i));
+        metrics.write_lock_wait.acquisitions += stats.acquisitions;
+        metrics.write_lock_wait.total_wait += stats.total_wait;
+        metrics.write_lock_wait.max_wait = std::max(metrics.write_lock_wait.max_wait, stats.max_wait);
+    }
+
+    metrics.total_slab_size = SlabAlloc::get_total_slab_size();
+    metrics.decrypted_pages = util::get_num_decrypted_pages();
+    metrics.decryption_page_faults = util::get_num_decryption_page_faults();
+    if (m_fake_read_lock_if_immutable) {
+        metrics.live_versions = 1;
+        return metrics;
+    }
+    metrics.mappings = m_alloc.get_mapping_stats();
+    metrics.live_versions = m_info->number_of_versions;
+    {
+        CheckedLockGuard local_lock(m_mutex);
+        if (m_version_manager) {
+            metrics.read_locks = m_version_manager->get_read_lock_stats();
+            metrics.version_list_capacity = m_version_manager->get_version_list_capacity();
+        }
+    }
+    return metrics;
+}
+
 void DB::do_end_write() noexcept
 {
-    m_info->next_served.fetch_add(1, std::memory_order_relaxed);
+    if (m_write_ticketed) {
+        m_info->next_served[size_t(m_write_priority)].fetch_add(1, std::memory_order_relaxed);
+        m_write_ticketed = false;
+    }
 
     CheckedLockGuard local_lock(m_mutex);
     REALM_ASSERT(m_write_transaction_open);
@@ -2465,8 +3453,9 @@ void DB::do_end_write() noexcept
 }
 
 
-Replication::version_type DB::do_commit(Transaction& transaction, bool commit_to_disk)
+Replication::version_type DB::do_commit(Transaction& transaction, bool commit_to_disk, bool allow_group_commit)
 {
+    REALM_TRACE_SCOPE("DB::do_commit");
     version_type current_version;
     {
         current_version = m_version_manager->get_newest_version();
@@ -2484,12 +3473,12 @@ Replication::version_type DB::do_commit(Transaction& transaction, bool commit_to
         // fails. The application then has the option of terminating the
         // transaction with a call to Transaction::Rollback(), which in turn
         // must call Replication::abort_transact().
-        new_version = repl->prepare_commit(current_version);        // Throws
-        low_level_commit(new_version, transaction, commit_to_disk); // Throws
+        new_version = repl->prepare_commit(current_version);                            // Throws
+        low_level_commit(new_version, transaction, commit_to_disk, allow_group_commit); // Throws
         repl->finalize_commit();
     }
     else {
-        low_level_commit(new_version, transaction); // Throws
+        low_level_commit(new_version, transaction, true, allow_group_commit); // Throws
     }
 
     {
@@ -2502,6 +3491,191 @@ Replication::version_type DB::do_commit(Transaction& transaction, bool commit_to
     return new_version;
 }
 
+void DB::wait_for_group_commit(Transaction& transaction, version_type version)
+{
+    if (!m_group_commit || m_durable_version.load() >= version)
+        return;
+
+    // The sync of this commit was left to the writers which were waiting for
+    // the write lock. Once they are done, one of them may have synced it.
+    // Otherwise sync the newest version, which covers all of their commits.
+    do_begin_write(); // Throws
+    auto end_write = util::make_scope_exit([&]() noexcept {
+        do_end_write();
+    });
+    if (m_durable_version.load() >= version)
+        return;
+
+    ReadLockInfo read_lock = grab_read_lock(ReadLockInfo::Live, VersionID()); // Throws
+    ReadLockGuard g(*this, read_lock);
+    if (m_logger) {
+        m_logger->log(util::LogCategory::transaction, util::Logger::Level::debug, "Group commit of versions %1 to %2",
+                      m_durable_read_lock ? m_durable_read_lock->m_version + 1 : version, read_lock.m_version);
+    }
+    GroupCommitter cm(transaction, Durability::Full, m_marker_observer.get());
+    cm.commit(read_lock.m_top_ref); // Throws
+    m_durable_version.store(read_lock.m_version);
+    if (m_durable_read_lock) {
+        release_read_lock(*m_durable_read_lock);
+        m_durable_read_lock.reset();
+    }
+}
+
+void DB::truncate_file_after_compaction(size_t logical_file_size, size_t reachable_file_size) noexcept
+{
+#ifndef _WIN32
+    // Mappings of the encrypted file are kept in sync with it by reading
+    // pages back from the file, which would fail beyond its end.
+    util::File& file = m_alloc.get_file();
+    if (file.get_encryption_key())
+        return;
+    try {
+        size_t file_size = size_t(file.get_size());
+        size_t new_size = util::round_up_to_page_size(logical_file_size);
+        // Readers of older versions, possibly in other processes, may still
+        // access the file beyond the current logical size
+        size_t safe_size = util::round_up_to_page_size(std::max(logical_file_size, reachable_file_size));
+        if (safe_size < file_size) {
+            file.resize(safe_size);
+            if (m_logger) {
+                m_logger->log(util::LogCategory::storage, util::Logger::Level::detail,
+                              "File truncated from %1 to %2", file_size, safe_size);
+            }
+            file_size = safe_size;
+        }
+        m_truncation_pending = new_size < file_size;
+    }
+    catch (const std::exception& e) {
+        m_truncation_pending = false;
+        if (m_logger) {
+            m_logger->log(util::LogCategory::storage, util::Logger::Level::error, "Failed to truncate file: %1",
+                          e.what());
+        }
+    }
+#else
+    static_cast<void>(logical_file_size);
+    static_cast<void>(reachable_file_size);
+#endif
+}
+
+size_t DB::warm_up(const std::vector<std::string>& table_names)
+{
+    return warm_up(table_names, [](size_t, size_t, size_t) {});
+}
+
+size_t DB::warm_up(const std::vector<std::string>& table_names, WarmUpProgress progress)
+{
+    auto tr = start_read();
+    Group& group = *tr;
+    std::vector<TableKey> keys;
+    if (table_names.empty()) {
+        for (auto key : group.get_table_keys())
+            keys.push_back(key);
+    }
+    else {
+        for (auto& name : table_names) {
+            auto key = group.find_table(name);
+            if (!key)
+                throw NoSuchTable();
+            keys.push_back(key);
+        }
+    }
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        ref_type ref = group.m_tables.get_as_ref(group.key2ndx_checked(keys[i]));
+        bytes += m_alloc.prefetch_tree(ref);
+        progress(i + 1, keys.size(), bytes);
+    }
+    if (m_logger) {
+        m_logger->log(util::Logger::Level::debug, "Warmed up %1 tables, %2 bytes", keys.size(), bytes);
+    }
+    return bytes;
+}
+
+void DB::set_hot_tables(std::vector<std::string> table_names, size_t memory_limit)
+{
+    bool has_hot_tables = !table_names.empty() && m_alloc.is_encrypted();
+    {
+        CheckedLockGuard lock(m_hot_tables_mutex);
+        m_alloc.unpin_all();
+        m_hot_tables = std::move(table_names);
+        m_hot_tables_memory_limit = memory_limit;
+        m_hot_table_states.clear();
+        m_hot_table_pages = 0;
+        m_hot_tables_version = 0;
+        m_has_hot_tables = has_hot_tables;
+    }
+    // Starting a read transaction chooses the pages
+    if (has_hot_tables)
+        start_read(); // Throws
+}
+
+size_t DB::get_hot_tables_memory() const
+{
+    CheckedLockGuard lock(m_hot_tables_mutex);
+    return m_hot_table_pages * util::page_size();
+}
+
+void DB::update_hot_tables(Transaction& tr)
+{
+    if (!m_has_hot_tables || m_hot_tables_version == tr.get_version())
+        return;
+
+    CheckedLockGuard lock(m_hot_tables_mutex);
+    std::vector<std::pair<ref_type, uint64_t>> states;
+    states.reserve(m_hot_tables.size());
+    for (auto& name : m_hot_tables) {
+        ref_type ref = 0;
+        uint64_t version = 0;
+        if (auto key = tr.find_table(name)) {
+            ref = tr.m_tables.get_as_ref(tr.key2ndx_checked(key));
+            version = Table::get_version_direct(m_alloc, ref);
+        }
+        states.emplace_back(ref, version);
+    }
+    m_hot_tables_version = tr.get_version();
+    if (states == m_hot_table_states)
+        return;
+
+    // Pages of the arrays which are no longer part of the tables are released
+    // along with the others, as it is not known which they are
+    m_alloc.unpin_all();
+    m_hot_table_pages = 0;
+    size_t max_pages = m_hot_tables_memory_limit / util::page_size();
+    for (auto& [ref, version] : states) {
+        if (ref)
+            m_hot_table_pages += m_alloc.pin_tree(ref, max_pages - m_hot_table_pages); // Throws
+    }
+    m_hot_table_states = std::move(states);
+    if (m_logger) {
+        m_logger->log(util::Logger::Level::debug, "Pinned %1 bytes of hot tables at version %2",
+                      m_hot_table_pages * util::page_size(), tr.get_version());
+    }
+}
+
+bool DB::background_compaction_step(size_t step_size)
+{
+    if (!is_attached())
+        return false;
+    auto stage = get_evacuation_stage();
+    if (stage != EvacStage::evacuating && stage != EvacStage::waiting && !m_truncation_pending)
+        return false;
+    // Leave the write lock to other writers, their commits make progress too
+    auto tr = start_write(true); // Throws
+    if (!tr)
+        return false;
+    m_compaction_step_size = step_size;
+    try {
+        tr->commit(); // Throws
+    }
+    catch (...) {
+        m_compaction_step_size = 0;
+        throw;
+    }
+    return true;
+}
+
 VersionID DB::get_version_id_of_latest_snapshot()
 {
     if (m_fake_read_lock_if_immutable)
@@ -2516,10 +3690,29 @@ DB::version_type DB::get_version_of_latest_snapshot()
 }
 
 
-void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, bool commit_to_disk)
+void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, bool commit_to_disk,
+                          bool allow_group_commit)
 {
     SharedInfo* info = m_info;
 
+    // With group commit, leave the sync to disk to one of the writers waiting
+    // for the write lock, so that it covers this commit as well as its own.
+    bool defer_sync = false;
+    bool synced = false;
+    if (allow_group_commit && m_group_commit && commit_to_disk &&
+        Durability(info->durability) == Durability::Full) {
+        defer_sync = other_writers_waiting_for_lock();
+        if (defer_sync && !m_durable_read_lock) {
+            // The version in the file header is the one we are based on. It
+            // must not be overwritten until a newer version has been synced.
+            m_durable_read_lock = grab_read_lock(ReadLockInfo::Live, VersionID());
+            keep_read_lock(*m_durable_read_lock);
+        }
+    }
+
+    if (m_max_read_transaction_age.count() > 0)
+        expire_old_read_locks(transaction.m_read_lock);
+
     // Version of oldest snapshot currently (or recently) bound in a transaction
     // of the current session.
     uint64_t oldest_version = 0, oldest_live_version = 0;
@@ -2540,11 +3733,23 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
     // save number of live versions for later:
     // (top_refs is std::moved into GroupWriter so we'll loose it in the call to set_versions below)
     auto live_versions = top_refs.size();
+    // Readers may access the file up to the largest logical size of the versions they can reach
+    size_t reachable_file_size = 0;
+    for (auto& [version, version_info] : top_refs)
+        reachable_file_size = std::max(reachable_file_size, size_t(version_info.logical_file_size));
+    size_t compaction_step_size = std::exchange(m_compaction_step_size, 0);
+    size_t logical_file_size = 0;
     // Do the actual commit
     REALM_ASSERT(oldest_version <= new_version);
 
     GroupWriter out(transaction, Durability(info->durability), m_marker_observer.get()); // Throws
     out.set_versions(new_version, top_refs, any_new_unreachables);
+    if (m_staged_commit_writes)
+        out.enable_staged_writes();
+    if (m_integer_compression)
+        out.enable_integer_compression();
+    if (m_page_tracker)
+        out.enable_write_tracking();
     out.prepare_evacuation();
     auto t1 = std::chrono::steady_clock::now();
     auto commit_size = m_alloc.get_commit_size();
@@ -2555,7 +3760,7 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
     if (auto limit = out.get_evacuation_limit()) {
         // Get a work limit based on the size of the transaction we're about to commit
         // Add 4k to ensure progress on small commits
-        size_t work_limit = commit_size / 2 + out.get_free_list_size() + 0x1000;
+        size_t work_limit = commit_size / 2 + out.get_free_list_size() + 0x1000 + compaction_step_size;
         transaction.cow_outliers(out.get_evacuation_progress(), limit, work_limit);
     }
 
@@ -2564,8 +3769,19 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
     {
         // protect against race with any other DB trying to attach to the file
         std::lock_guard<InterprocessMutex> lock(m_controlmutex); // Throws
-        new_top_ref = out.write_group();                         // Throws
+        auto write_start = std::chrono::steady_clock::now();
+        new_top_ref = out.write_group(); // Throws
+        m_write_group_ns.fetch_add(to_nanoseconds(std::chrono::steady_clock::now() - write_start),
+                                   std::memory_order_relaxed);
     }
+    if (m_page_tracker) {
+        // The pages must be recorded before the version becomes durable
+        bool sync = Durability(info->durability) == Durability::Full && !get_disable_sync_to_disk();
+        m_page_tracker->record_commit(out.get_written_ranges(), new_version, new_top_ref, sync); // Throws
+    }
+    m_free_list_ns.fetch_add(to_nanoseconds(out.get_free_list_time()), std::memory_order_relaxed);
+    m_commit_bytes_written.fetch_add(out.get_bytes_written(), std::memory_order_relaxed);
+    m_last_commit_bytes_written.store(out.get_bytes_written(), std::memory_order_relaxed);
     {
         // protect access to shared variables and m_reader_mapping from here
         CheckedLockGuard lock_guard(m_mutex);
@@ -2573,13 +3789,23 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
         m_locked_space = out.get_locked_space_size();
         m_used_space = out.get_logical_size() - m_free_space;
         m_evac_stage.store(EvacStage(out.get_evacuation_stage()));
-        out.sync_according_to_durability();
-        if (Durability(info->durability) == Durability::Full || Durability(info->durability) == Durability::Unsafe) {
-            if (commit_to_disk) {
-                GroupCommitter cm(transaction, Durability(info->durability), m_marker_observer.get());
-                cm.commit(new_top_ref);
+        auto sync_start = std::chrono::steady_clock::now();
+        if (defer_sync) {
+            out.flush_without_sync();
+        }
+        else {
+            out.sync_according_to_durability();
+            if (Durability(info->durability) == Durability::Full ||
+                Durability(info->durability) == Durability::Unsafe) {
+                if (commit_to_disk) {
+                    GroupCommitter cm(transaction, Durability(info->durability), m_marker_observer.get());
+                    cm.commit(new_top_ref);
+                    synced = true;
+                }
             }
         }
+        m_commit_sync_ns.fetch_add(to_nanoseconds(std::chrono::steady_clock::now() - sync_start),
+                                   std::memory_order_relaxed);
         size_t new_file_size = out.get_logical_size();
         // We must reset the allocators free space tracking before communicating the new
         // version through the ring buffer. If not, a reader may start updating the allocators
@@ -2599,6 +3825,19 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
         // At this point, the VersionList has been succesfully updated, and the next writer
         // can safely proceed once the writemutex has been lifted.
         info->commit_in_critical_phase = 0;
+        logical_file_size = new_file_size;
+    }
+    if (m_compactor) {
+        truncate_file_after_compaction(logical_file_size, reachable_file_size);
+        if (m_truncation_pending || (m_evac_stage != EvacStage::idle && m_evac_stage != EvacStage::blocked))
+            m_compactor->notify();
+    }
+    if (synced) {
+        m_durable_version.store(new_version);
+        if (m_durable_read_lock) {
+            release_read_lock(*m_durable_read_lock);
+            m_durable_read_lock.reset();
+        }
     }
     {
         // protect against concurrent updates to the .lock file.
@@ -2611,14 +3850,71 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
         m_new_commit_available.notify_all();
     }
     auto t2 = std::chrono::steady_clock::now();
+    m_commit_count.fetch_add(1, std::memory_order_relaxed);
+    if (auto ns = to_nanoseconds(t2 - t1); ns > m_max_commit_ns.load(std::memory_order_relaxed))
+        m_max_commit_ns.store(ns, std::memory_order_relaxed);
     if (m_logger) {
-        std::string to_disk_str = commit_to_disk ? util::format(" ref %1", new_top_ref) : " (no commit to disk)";
+        std::string to_disk_str = !commit_to_disk ? " (no commit to disk)"
+                                  : defer_sync    ? util::format(" ref %1 (sync deferred)", new_top_ref)
+                                                  : util::format(" ref %1", new_top_ref);
         m_logger->log(util::LogCategory::transaction, util::Logger::Level::debug, "Commit of size %1 done in %2 us%3",
                       commit_size, std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count(),
                       to_disk_str);
     }
 }
 
+void DB::flush_write_transaction(Transaction& transaction)
+{
+    // The arrays are written as part of the version the transaction is going
+    // to commit, so the space they free is locked like the space freed by the
+    // commit itself, and the commit later carries on from the free lists
+    // written here.
+    version_type new_version = m_version_manager->get_newest_version() + 1;
+    uint64_t oldest_live_version = 0;
+    TopRefMap top_refs;
+    bool any_new_unreachables;
+    {
+        CheckedLockGuard lock(m_mutex);
+        m_version_manager->cleanup_versions(oldest_live_version, top_refs, any_new_unreachables);
+    }
+
+    GroupWriter out(transaction, Durability(m_info->durability), m_marker_observer.get()); // Throws
+    out.set_versions(new_version, top_refs, any_new_unreachables);
+    if (m_staged_commit_writes)
+        out.enable_staged_writes();
+    if (m_integer_compression)
+        out.enable_integer_compression();
+    if (m_page_tracker)
+        out.enable_write_tracking();
+    // Carry the state of an ongoing compaction over to the commit
+    out.prepare_evacuation();
+    auto t1 = std::chrono::steady_clock::now();
+    auto flush_size = m_alloc.get_commit_size();
+
+    ref_type new_top_ref;
+    {
+        // protect against race with any other DB trying to attach to the file
+        std::lock_guard<InterprocessMutex> lock(m_controlmutex); // Throws
+        new_top_ref = out.write_group();                         // Throws
+    }
+    if (m_page_tracker)
+        m_page_tracker->record_flush(out.get_written_ranges()); // Throws
+    // Neither the file header nor the version list refers to what was written,
+    // so it's invisible to readers, and lost if the transaction is rolled
+    // back. The commit syncs it to disk along with its own changes.
+    out.flush_without_sync();
+    size_t new_file_size = out.get_logical_size();
+    reset_free_space_tracking();
+    transaction.remap_and_update_refs(new_top_ref, new_file_size, true); // Throws
+
+    if (m_logger) {
+        auto t2 = std::chrono::steady_clock::now();
+        m_logger->log(util::LogCategory::transaction, util::Logger::Level::debug,
+                      "Flush of size %1 for version %2 done in %3 us", flush_size, new_version,
+                      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+    }
+}
+
 #ifdef REALM_DEBUG
 void DB::reserve(size_t size)
 {
@@ -2676,12 +3972,38 @@ void DB::delete_files(const std::string& base_path, bool* did_delete, bool delet
 
 TransactionRef DB::start_read(VersionID version_id)
 {
+    REALM_TRACE_SCOPE("DB::start_read");
     if (!is_attached())
         throw StaleAccessor("Stale transaction");
     TransactionRef tr;
     if (m_fake_read_lock_if_immutable) {
         tr = make_transaction_ref(shared_from_this(), &m_alloc, *m_fake_read_lock_if_immutable, DB::transact_Reading);
     }
+    else if (m_reuse_read_transactions) {
+        ReadLockInfo read_lock = grab_read_lock(ReadLockInfo::Live, version_id);
+        ReadLockGuard g(*this, read_lock);
+        read_lock.check();
+        std::unique_ptr<Transaction> idle;
+        {
+            CheckedLockGuard lock(m_idle_reader_mutex);
+            idle = std::move(m_idle_reader);
+        }
+        if (idle) {
+            idle->resume_read(shared_from_this(), read_lock); // Throws
+        }
+        else {
+            idle.reset(new Transaction(shared_from_this(), &m_alloc, read_lock, DB::transact_Reading)); // Throws
+        }
+        tr = TransactionRef(idle.release(), [](Transaction* t) {
+            // The transaction lets go of the DB when it ends
+            DBRef db = t->db;
+            if (!db || !db->keep_idle_reader(t)) {
+                t->close();
+                delete t;
+            }
+        });
+        g.release();
+    }
     else {
         ReadLockInfo read_lock = grab_read_lock(ReadLockInfo::Live, version_id);
         ReadLockGuard g(*this, read_lock);
@@ -2690,9 +4012,45 @@ TransactionRef DB::start_read(VersionID version_id)
         g.release();
     }
     tr->set_file_format_version(get_file_format_version());
+    update_hot_tables(*tr); // Throws
     return tr;
 }
 
+bool DB::keep_idle_reader(Transaction* tr) noexcept
+{
+    {
+        CheckedLockGuard lock(m_idle_reader_mutex);
+        if (m_idle_reader || !is_attached())
+            return false;
+    }
+    if (!tr->end_read_for_reuse())
+        return false;
+
+    std::unique_ptr<Transaction> idle(tr);
+    {
+        CheckedLockGuard lock(m_idle_reader_mutex);
+        if (!m_idle_reader && is_attached()) {
+            m_idle_reader = std::move(idle);
+            return true;
+        }
+    }
+    // Another transaction was kept in the meantime. Its table accessors are
+    // only released by detach().
+    idle->detach();
+    return true;
+}
+
+void DB::discard_idle_reader() noexcept
+{
+    std::unique_ptr<Transaction> idle;
+    {
+        CheckedLockGuard lock(m_idle_reader_mutex);
+        idle = std::move(m_idle_reader);
+    }
+    if (idle)
+        idle->detach();
+}
+
 TransactionRef DB::start_frozen(VersionID version_id)
 {
     if (!is_attached())
@@ -2705,6 +4063,8 @@ TransactionRef DB::start_frozen(VersionID version_id)
         ReadLockInfo read_lock = grab_read_lock(ReadLockInfo::Frozen, version_id);
         ReadLockGuard g(*this, read_lock);
         read_lock.check();
+        if (m_share_frozen_transactions)
+            return start_shared_frozen(read_lock, g);
         tr = make_transaction_ref(shared_from_this(), &m_alloc, read_lock, DB::transact_Frozen);
         g.release();
     }
@@ -2712,19 +4072,53 @@ TransactionRef DB::start_frozen(VersionID version_id)
     return tr;
 }
 
-TransactionRef DB::start_write(bool nonblocking)
+TransactionRef DB::start_shared_frozen(ReadLockInfo& read_lock, ReadLockGuard& g)
+{
+    util::CheckedLockGuard lock(m_frozen_transactions_mutex);
+    auto it = m_frozen_transactions.find(read_lock.m_version);
+    if (it != m_frozen_transactions.end()) {
+        // The existing transaction has its own read lock on the version, so
+        // the guard releases ours
+        if (auto tr = it->second.lock())
+            return tr;
+    }
+
+    // Transactions are released without the mutex, so forget the ones which
+    // are gone while we're here
+    for (auto i = m_frozen_transactions.begin(); i != m_frozen_transactions.end();) {
+        if (i->second.expired())
+            i = m_frozen_transactions.erase(i);
+        else
+            ++i;
+    }
+
+    TransactionRef tr(new Transaction(shared_from_this(), &m_alloc, read_lock, DB::transact_Frozen),
+                      [](Transaction* t) {
+                          t->m_is_shared = false;
+                          t->close();
+                          delete t;
+                      });
+    g.release();
+    tr->set_file_format_version(get_file_format_version());
+    tr->m_is_shared = true;
+    m_frozen_transactions[read_lock.m_version] = tr;
+    return tr;
+}
+
+TransactionRef DB::start_write(bool nonblocking, WritePriority priority)
 {
+    REALM_TRACE_SCOPE("DB::start_write");
     if (m_fake_read_lock_if_immutable) {
         REALM_ASSERT(false && "Can't write an immutable DB");
     }
     if (nonblocking) {
-        bool success = do_try_begin_write();
+        bool success = do_try_begin_write(priority);
         if (!success) {
             return TransactionRef();
         }
     }
     else {
-        do_begin_write();
+        do_begin_write(priority);
     }
     {
         CheckedUniqueLock local_lock(m_mutex);
@@ -2743,6 +4137,7 @@ TransactionRef DB::start_write(bool nonblocking)
 
         tr = make_transaction_ref(shared_from_this(), &m_alloc, read_lock, DB::transact_Writing);
         tr->set_file_format_version(get_file_format_version());
+        tr->set_write_priority(priority);
         version_type current_version = read_lock.m_version;
         m_alloc.init_mapping_management(current_version);
         if (Replication* repl = get_replication()) {
@@ -2772,7 +4167,7 @@ void DB::async_request_write_mutex(TransactionRef& tr, util::UniqueFunction<void
         }
     }
     std::weak_ptr<Transaction> weak_tr = tr;
-    async_begin_write([weak_tr, cb = std::move(when_acquired)]() {
+    async_begin_write(tr->get_write_priority(), [weak_tr, cb = std::move(when_acquired)]() {
         if (auto tr = weak_tr.lock()) {
             util::CheckedLockGuard lck(tr->m_async_mutex);
             // If a synchronous transaction happened while we were pending
@@ -2801,11 +4196,24 @@ void DB::async_request_write_mutex(TransactionRef& tr, util::UniqueFunction<void
 
 inline DB::DB(Private, const DBOptions& options)
     : m_upgrade_callback(std::move(options.upgrade_callback))
+    , m_upgrade_progress_callback(std::move(options.upgrade_progress_callback))
     , m_log_id(util::gen_log_id(this))
 {
     if (options.enable_async_writes) {
-        m_commit_helper = std::make_unique<AsyncCommitHelper>(this);
+        // Async commits can only be synced while another writer runs when the
+        // header is the only thing written by the sync
+        bool can_pipeline = options.durability == Durability::Full && !options.encryption_key;
+        m_commit_helper =
+            std::make_unique<AsyncCommitHelper>(this, can_pipeline ? options.async_write_pipeline_depth : 0);
     }
+    m_group_commit = options.enable_group_commit && !options.enable_async_writes;
+    m_staged_commit_writes = options.enable_staged_commit_writes;
+    m_integer_compression = options.enable_integer_compression;
+    m_write_transaction_memory_limit = options.write_transaction_memory_limit;
+    m_share_frozen_transactions = options.share_frozen_transactions;
+    m_reuse_read_transactions = options.reuse_read_transactions;
+    m_max_read_transaction_age = options.max_read_transaction_age;
+    m_track_pinned_versions = options.track_pinned_versions || m_max_read_transaction_age.count() > 0;
 }
 
 DBRef DB::create(const std::string& file, const DBOptions& options) NO_THREAD_SAFETY_ANALYSIS
@@ -2879,13 +4287,13 @@ void DB::release_sync_agent()
     m_is_sync_agent = false;
 }
 
-void DB::do_begin_possibly_async_write()
+void DB::do_begin_possibly_async_write(WritePriority priority)
 {
     if (m_commit_helper) {
-        m_commit_helper->blocking_begin_write();
+        m_commit_helper->blocking_begin_write(priority);
     }
     else {
-        do_begin_write();
+        do_begin_write(priority);
     }
 }
 
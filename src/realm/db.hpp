@@ -36,7 +36,9 @@
 #include <functional>
 #include <cstdint>
 #include <limits>
+#include <optional>
 #include <condition_variable>
+#include <thread>
 
 namespace realm {
 
@@ -163,7 +165,7 @@ public:
     ///  * for read or write transactions - but not frozen transactions, explicitly call
     ///    close() at earliest time possible
     ///  * explicitly nullify any DBRefs you may have.
-    void close(bool allow_open_read_transactions = false) REQUIRES(!m_mutex);
+    void close(bool allow_open_read_transactions = false) REQUIRES(!m_mutex, !m_idle_reader_mutex);
 
     bool is_attached() const noexcept;
 
@@ -262,16 +264,25 @@ public:
     /// bound (AKA tethered) snapshot.
     struct BadVersion;
 
+    /// Priority classes for the write lock. A writer waiting for the write
+    /// lock is let in ahead of the waiting writers of lower priority, in any
+    /// process, unless they have been waiting for longer than half a second.
+    /// Writers of the same priority get the lock in the order they asked for it.
+    enum class WritePriority { Background, Normal, Interactive };
+    static constexpr size_t num_write_priorities = 3;
+
     /// Transactions are obtained from one of the following 3 methods:
-    TransactionRef start_read(VersionID = VersionID()) REQUIRES(!m_mutex);
-    TransactionRef start_frozen(VersionID = VersionID()) REQUIRES(!m_mutex);
+    TransactionRef start_read(VersionID = VersionID()) REQUIRES(!m_mutex, !m_idle_reader_mutex, !m_hot_tables_mutex);
+    TransactionRef start_frozen(VersionID = VersionID()) REQUIRES(!m_mutex, !m_frozen_transactions_mutex);
     // If nonblocking is true and a write transaction is already active,
     // an invalid TransactionRef is returned.
-    TransactionRef start_write(bool nonblocking = false) REQUIRES(!m_mutex);
+    TransactionRef start_write(bool nonblocking = false, WritePriority priority = WritePriority::Normal)
+        REQUIRES(!m_mutex);
 
     // ask for write mutex. Callback takes place when mutex has been acquired.
     // callback may occur on ANOTHER THREAD. Must not be called if write mutex
-    // has already been acquired.
+    // has already been acquired. The mutex is requested with the write
+    // priority of the transaction.
     void async_request_write_mutex(TransactionRef& tr, util::UniqueFunction<void()>&& when_acquired);
 
     // report statistics of last commit done on THIS DB.
@@ -284,8 +295,138 @@ public:
     // Notice that we will always have two live versions - the current and the
     // previous.
     void get_stats(size_t& free_space, size_t& used_space, size_t* locked_space = nullptr) const REQUIRES(!m_mutex);
+
+    struct ReadLockStats {
+        // Read locks taken on a version this process already had locked,
+        // which only touch process-local counters
+        uint64_t local_acquisitions = 0;
+        // Read locks which had to take the mutex for the version list in the
+        // lock file, because no thread of this process had the version locked
+        // or the fast path was blocked
+        uint64_t lock_file_acquisitions = 0;
+        // Number of times this process had to grow the version list
+        uint64_t version_list_expansions = 0;
+    };
+    // report how read locks have been obtained since this DB was opened.
+    ReadLockStats get_read_lock_stats() const;
+
+    // The number of async commits waiting to be synced to disk, including the
+    // one being synced. Can be more than one with
+    // DBOptions::async_write_pipeline_depth set.
+    size_t get_async_pipeline_depth();
+
+    struct WriteLockWaitStats {
+        // Number of times this DB got the write lock
+        uint64_t acquisitions = 0;
+        // Time spent waiting for it, in total and at most
+        std::chrono::nanoseconds total_wait{0};
+        std::chrono::nanoseconds max_wait{0};
+    };
+    // report how long writers of the given priority have waited for the write
+    // lock since this DB was opened.
+    WriteLockWaitStats get_write_lock_wait_stats(WritePriority) const;
+
+    struct CommitStats {
+        // Number of commits done through this DB
+        uint64_t commits = 0;
+        // Bytes of arrays written to the file, by all commits and by the last one
+        uint64_t bytes_written = 0;
+        uint64_t last_bytes_written = 0;
+        // Time spent in GroupWriter::write_group(), including the time spent
+        // recreating the free lists, which is also reported separately
+        std::chrono::nanoseconds write_group_time{0};
+        std::chrono::nanoseconds free_list_time{0};
+        // Time spent flushing and syncing the written data to disk
+        std::chrono::nanoseconds sync_time{0};
+        // The longest time any single commit took
+        std::chrono::nanoseconds max_commit_time{0};
+    };
+
+    struct Metrics {
+        CommitStats commits;
+        ReadLockStats read_locks;
+        // Summed over all write priorities
+        WriteLockWaitStats write_lock_wait;
+        // Memory mappings of the file by this DB
+        SlabAlloc::MappingStats mappings;
+        // Slab memory allocated by all DBs of this process
+        size_t total_slab_size = 0;
+        // Occupancy of the version list in the lock file: the number of
+        // versions kept alive by readers, and the current number of entries
+        uint64_t live_versions = 0;
+        size_t version_list_capacity = 0;
+        // Pages decrypted in memory right now, and the number of page faults
+        // which required decrypting a page, for all encrypted files of this
+        // process
+        size_t decrypted_pages = 0;
+        uint64_t decryption_page_faults = 0;
+    };
+    // Collect the metrics of the storage engine. The counters are maintained
+    // with relaxed atomics, so they are always on, and the values reported
+    // from different counters may not be entirely consistent with each other
+    // while commits are happening concurrently.
+    Metrics get_metrics() REQUIRES(!m_mutex);
+
+    struct PinnedVersion {
+        version_type version;
+        bool frozen;
+        // Time since the read lock was taken
+        std::chrono::steady_clock::duration age;
+        // The thread which took the read lock
+        std::thread::id owner_thread;
+        // The innermost PinTag of that thread at the time, if any
+        std::string tag;
+    };
+    // List the read locks held by transactions of this DB, oldest first. Only
+    // available with DBOptions::track_pinned_versions or
+    // DBOptions::max_read_transaction_age set, and empty otherwise.
+    std::vector<PinnedVersion> get_pinned_versions() const REQUIRES(!m_pinned_versions_mutex);
+
+    // Tags the read locks taken by the current thread while it is alive, to
+    // tell in get_pinned_versions() which part of the code holds on to a
+    // version. Tags nest, and the innermost one is used.
+    class PinTag {
+    public:
+        explicit PinTag(std::string tag);
+        ~PinTag();
+        PinTag(const PinTag&) = delete;
+        PinTag& operator=(const PinTag&) = delete;
+
+    private:
+        std::string m_tag;
+        PinTag* m_outer;
+        friend class DB;
+    };
     //@}
 
+    /// Called by warm_up() after each table with the number of tables done,
+    /// the number of tables to do, and the number of bytes read so far.
+    using WarmUpProgress = util::FunctionRef<void(size_t tables_done, size_t num_tables, size_t bytes_read)>;
+
+    /// Read the named tables, including their search indexes, into memory
+    /// ahead of use, so that the first queries after opening the file do not
+    /// have to wait for page faults. All tables are read if \a table_names is
+    /// empty. The arrays of each table are walked one level of the tree at a
+    /// time, asking the OS to read in all the pages of a level at once. Throws
+    /// NoSuchTable if one of the tables does not exist. Returns the number of
+    /// bytes read. May be called from any thread, and does not block writers.
+    size_t warm_up(const std::vector<std::string>& table_names = {});
+    size_t warm_up(const std::vector<std::string>& table_names, WarmUpProgress progress);
+
+    /// Keep the pages of the named tables, including their search indexes,
+    /// decrypted in memory, so that lookups in them do not have to decrypt
+    /// pages again after the page reclaimer has released them. The tables are
+    /// taken in the given order, and the arrays of each table one level of
+    /// the tree at a time, until pages of \a memory_limit bytes are kept.
+    /// When one of the tables has changed, the pages are chosen anew by the
+    /// next read transaction started or advanced on this DB. Tables which do
+    /// not exist are skipped. An empty list lets go of the pages again. Only
+    /// has an effect on encrypted files.
+    void set_hot_tables(std::vector<std::string> table_names, size_t memory_limit)
+        REQUIRES(!m_hot_tables_mutex, !m_mutex, !m_idle_reader_mutex);
+    /// The number of bytes of pages kept in memory for the hot tables.
+    size_t get_hot_tables_memory() const REQUIRES(!m_hot_tables_mutex);
+
     enum TransactStage {
         transact_Ready,
         transact_Reading,
@@ -333,10 +474,37 @@ public:
     ///
     /// WARNING: Compact() is not thread-safe with respect to a concurrent close()
     bool compact(bool bump_version_number = false, util::Optional<const char*> output_encryption_key = util::none)
-        REQUIRES(!m_mutex);
+        REQUIRES(!m_mutex, !m_idle_reader_mutex);
 
     void write_copy(StringData path, const char* output_encryption_key) REQUIRES(!m_mutex);
 
+    struct IncrementalBackupResult {
+        // The version of the database the backup now holds
+        version_type version = 0;
+        // Whether the whole file was copied, rather than only the pages
+        // written since the previous backup
+        bool full_copy = false;
+        size_t bytes_copied = 0;
+    };
+
+    /// Bring the backup at `path` up to date with the latest version of the
+    /// database, copying only the pages of the file which were written since
+    /// the previous backup to the same path. Unlike write_copy(), the backup
+    /// has the layout of the database file, free space included, so it is as
+    /// large as the file. It can be opened like any other Realm file.
+    ///
+    /// Requires DBOptions::track_changed_pages. The whole file is copied the
+    /// first time, and whenever an incremental update is not known to be
+    /// safe: when the file at `path` is not the previous backup, when a DB
+    /// without page tracking has committed since then, or after compact().
+    ///
+    /// The write lock is only held briefly to pick the version to back up,
+    /// so writers can carry on while the pages are copied. The backup is only
+    /// consistent once this returns. If it fails, the next call copies the
+    /// whole file. Only one backup of a file may be written at a time. Must
+    /// not be called by a thread holding a write transaction on this DB.
+    IncrementalBackupResult write_incremental_backup(const std::string& path) REQUIRES(!m_mutex);
+
 #ifdef REALM_DEBUG
     void test_ringbuf();
 #endif
@@ -442,6 +610,10 @@ public:
     /// Returns true if there are threads waiting to acquire the write lock, false otherwise.
     /// To be used only when already holding the lock.
     bool other_writers_waiting_for_lock() const;
+    /// Returns true if there are threads waiting to acquire the write lock
+    /// with at least the given priority. To be used only when already holding
+    /// the lock.
+    bool writers_waiting_for_lock(WritePriority) const;
 
     struct CommitListener {
         virtual ~CommitListener() = default;
@@ -453,6 +625,8 @@ public:
 
 private:
     class AsyncCommitHelper;
+    class BackgroundCompactor;
+    class ChangedPageTracker;
     class VersionManager;
     class EncryptionMarkerObserver;
     class FileVersionManager;
@@ -466,6 +640,8 @@ private:
         ref_type m_top_ref = 0;
         size_t m_file_size = 0;
         Type m_type = Live;
+        // Identifies the read lock among the pinned versions, if tracked
+        uint64_t m_pin_id = 0;
         // a little helper
         static std::unique_ptr<ReadLockInfo> make_fake(ref_type top_ref, size_t file_size)
         {
@@ -485,7 +661,49 @@ private:
 
     // Member variables
     util::CheckedMutex m_mutex;
-    int m_transaction_count GUARDED_BY(m_mutex) = 0;
+    std::atomic<int> m_transaction_count = 0;
+    // Read locks on versions this process already has locked are grabbed and
+    // released without m_mutex. The low bits count the threads inside such a
+    // fast path, and close() and compact() set the blocked bit with m_mutex
+    // held to wait for them and send everyone else down the slow path.
+    static constexpr uint32_t s_read_lock_fast_path_blocked = uint32_t(1) << 31;
+    std::atomic<uint32_t> m_read_lock_fast_path = 0;
+
+    // Read locks taken with version pinning tracking enabled. Entries which
+    // were released for being older than the maximum age stay in the map as
+    // `expired` until their owner releases them.
+    struct PinnedReadLock {
+        ReadLockInfo read_lock;
+        std::chrono::steady_clock::time_point since;
+        std::thread::id owner_thread;
+        std::string tag;
+        bool may_expire = true;
+        bool expired = false;
+    };
+    bool m_track_pinned_versions = false;
+    std::chrono::milliseconds m_max_read_transaction_age{0};
+    mutable util::CheckedMutex m_pinned_versions_mutex;
+    uint64_t m_last_pin_id GUARDED_BY(m_pinned_versions_mutex) = 0;
+    std::map<uint64_t, PinnedReadLock> m_pinned_read_locks GUARDED_BY(m_pinned_versions_mutex);
+    // Frozen transactions handed out by start_frozen(), by version, with
+    // DBOptions::share_frozen_transactions set
+    bool m_share_frozen_transactions = false;
+    util::CheckedMutex m_frozen_transactions_mutex;
+    std::map<version_type, std::weak_ptr<Transaction>> m_frozen_transactions GUARDED_BY(m_frozen_transactions_mutex);
+    // Read transaction kept for the next start_read(), with
+    // DBOptions::reuse_read_transactions set
+    bool m_reuse_read_transactions = false;
+    util::CheckedMutex m_idle_reader_mutex;
+    std::unique_ptr<Transaction> m_idle_reader GUARDED_BY(m_idle_reader_mutex);
+    // Tables of which the pages are pinned, see set_hot_tables(), with the top
+    // ref and version of each table when its pages were chosen
+    std::atomic<bool> m_has_hot_tables = false;
+    std::atomic<version_type> m_hot_tables_version = 0;
+    mutable util::CheckedMutex m_hot_tables_mutex;
+    std::vector<std::string> m_hot_tables GUARDED_BY(m_hot_tables_mutex);
+    size_t m_hot_tables_memory_limit GUARDED_BY(m_hot_tables_mutex) = 0;
+    std::vector<std::pair<ref_type, uint64_t>> m_hot_table_states GUARDED_BY(m_hot_tables_mutex);
+    size_t m_hot_table_pages GUARDED_BY(m_hot_tables_mutex) = 0;
     SlabAlloc m_alloc;
     std::unique_ptr<Replication> m_history;
     std::unique_ptr<VersionManager> m_version_manager;
@@ -494,7 +712,6 @@ private:
     size_t m_free_space GUARDED_BY(m_mutex) = 0;
     size_t m_locked_space GUARDED_BY(m_mutex) = 0;
     size_t m_used_space GUARDED_BY(m_mutex) = 0;
-    std::vector<ReadLockInfo> m_local_locks_held GUARDED_BY(m_mutex); // tracks all read locks held by this DB
     std::atomic<EvacStage> m_evac_stage = EvacStage::idle;
     util::File m_file;
     util::File::Map<SharedInfo> m_file_map; // Never remapped, provides access to everything but the ringbuffer
@@ -502,6 +719,21 @@ private:
     SharedInfo* m_info = nullptr;
     bool m_wait_for_change_enabled = true; // Initially wait_for_change is enabled
     bool m_write_transaction_open GUARDED_BY(m_mutex) = false;
+    // The priority of the current writer, and whether it took a ticket in the
+    // write queue. Only accessed while holding the write lock.
+    WritePriority m_write_priority = WritePriority::Normal;
+    bool m_write_ticketed = false;
+    std::atomic<uint64_t> m_write_lock_acquisitions[num_write_priorities] = {};
+    std::atomic<uint64_t> m_write_lock_wait_ns[num_write_priorities] = {};
+    std::atomic<uint64_t> m_write_lock_max_wait_ns[num_write_priorities] = {};
+    // Updated by low_level_commit(), which only runs while holding the write lock
+    std::atomic<uint64_t> m_commit_count{0};
+    std::atomic<uint64_t> m_commit_bytes_written{0};
+    std::atomic<uint64_t> m_last_commit_bytes_written{0};
+    std::atomic<uint64_t> m_write_group_ns{0};
+    std::atomic<uint64_t> m_free_list_ns{0};
+    std::atomic<uint64_t> m_commit_sync_ns{0};
+    std::atomic<uint64_t> m_max_commit_ns{0};
     std::string m_db_path;
     int m_file_format_version = 0;
     util::InterprocessMutex m_writemutex;
@@ -511,7 +743,31 @@ private:
     util::InterprocessCondVar m_new_commit_available;
     util::InterprocessCondVar m_pick_next_writer;
     std::function<void(int, int)> m_upgrade_callback;
+    std::function<void(size_t, size_t)> m_upgrade_progress_callback;
     std::unique_ptr<AsyncCommitHelper> m_commit_helper;
+    // Async commits synced to disk while other transactions write may finish
+    // in any order relative to direct syncs, so writing the file header is
+    // serialized, and skipped for versions older than the one written.
+    std::mutex m_async_sync_mutex;
+    version_type m_async_synced_version = 0;
+    // Group commit. The newest version known to be synced to disk, and while
+    // newer versions are not, a read lock keeping that version alive. The read
+    // lock is only accessed with the write mutex held.
+    bool m_group_commit = false;
+    std::atomic<version_type> m_durable_version{0};
+    std::optional<ReadLockInfo> m_durable_read_lock;
+    // Background compaction. The step size is set for the commits made by the
+    // compactor, and is only accessed with the write mutex held.
+    std::unique_ptr<BackgroundCompactor> m_compactor;
+    size_t m_compaction_step_size = 0;
+    std::atomic<bool> m_truncation_pending{false};
+    // Set with DBOptions::track_changed_pages. Only used with the write lock
+    // held, except by write_incremental_backup().
+    std::unique_ptr<ChangedPageTracker> m_page_tracker;
+    std::mutex m_backup_mutex;
+    bool m_staged_commit_writes = false;
+    bool m_integer_compression = false;
+    size_t m_write_transaction_memory_limit = 0;
     std::shared_ptr<util::Logger> m_logger;
     std::mutex m_commit_listener_mutex;
     std::vector<CommitListener*> m_commit_listeners;
@@ -582,28 +838,70 @@ private:
     /// As a side effect update memory mapping to ensure that the ringbuffer
     /// entries referenced in the readlock info is accessible.
     ReadLockInfo grab_read_lock(ReadLockInfo::Type, VersionID) REQUIRES(!m_mutex);
+    // Return the frozen transaction on the version of `read_lock`, creating it
+    // with the read lock held by the guard if there is none.
+    TransactionRef start_shared_frozen(ReadLockInfo& read_lock, ReadLockGuard&)
+        REQUIRES(!m_frozen_transactions_mutex);
+    // Keep a released read transaction for reuse by start_read(). Returns
+    // false if it was not kept, and must be closed and deleted instead.
+    bool keep_idle_reader(Transaction*) noexcept REQUIRES(!m_idle_reader_mutex);
+    void discard_idle_reader() noexcept REQUIRES(!m_idle_reader_mutex);
+    // Choose the pages to pin for the hot tables anew if any of them has
+    // changed in the version of the transaction
+    void update_hot_tables(Transaction&) REQUIRES(!m_hot_tables_mutex);
 
     // Release a specific read lock. The read lock MUST have been obtained by a
     // call to grab_read_lock().
     void release_read_lock(ReadLockInfo&) noexcept REQUIRES(!m_mutex);
     void do_release_read_lock(ReadLockInfo&) noexcept REQUIRES(m_mutex);
+    bool enter_read_lock_fast_path() noexcept;
+    void leave_read_lock_fast_path() noexcept;
+    void block_read_lock_fast_path() noexcept REQUIRES(m_mutex);
+    void unblock_read_lock_fast_path() noexcept REQUIRES(m_mutex);
     // Stop tracking a read lock without actually releasing it.
     void leak_read_lock(ReadLockInfo&) noexcept REQUIRES(!m_mutex);
 
+    // Pinned version tracking. unpin_read_lock() returns false if the read
+    // lock has already been released for being too old.
+    void pin_read_lock(ReadLockInfo&) REQUIRES(!m_pinned_versions_mutex);
+    bool unpin_read_lock(const ReadLockInfo&) noexcept REQUIRES(!m_pinned_versions_mutex);
+    // Exclude a read lock which is needed for durability from expiry.
+    void keep_read_lock(const ReadLockInfo&) noexcept REQUIRES(!m_pinned_versions_mutex);
+    bool is_read_lock_expired(const ReadLockInfo&) const noexcept REQUIRES(!m_pinned_versions_mutex);
+    void expire_old_read_locks(const ReadLockInfo& writer_read_lock) noexcept REQUIRES(!m_pinned_versions_mutex);
+
     // Release all read locks held by this DB object. After release, further calls to
     // release_read_lock for locks already released must be avoided.
     void release_all_read_locks() noexcept REQUIRES(!m_mutex);
 
     /// return true if write transaction can commence, false otherwise.
-    bool do_try_begin_write() REQUIRES(!m_mutex);
-    void do_begin_write() REQUIRES(!m_mutex);
-    void do_begin_possibly_async_write() REQUIRES(!m_mutex);
-    version_type do_commit(Transaction&, bool commit_to_disk = true) REQUIRES(!m_mutex);
+    bool do_try_begin_write(WritePriority priority = WritePriority::Normal) REQUIRES(!m_mutex);
+    void do_begin_write(WritePriority priority = WritePriority::Normal) REQUIRES(!m_mutex);
+    void do_begin_possibly_async_write(WritePriority priority = WritePriority::Normal) REQUIRES(!m_mutex);
+    void record_write_lock_wait(WritePriority, std::chrono::steady_clock::duration) noexcept;
+    // If `allow_group_commit` is set, the caller will release the write lock
+    // and then call wait_for_group_commit().
+    version_type do_commit(Transaction&, bool commit_to_disk = true, bool allow_group_commit = false)
+        REQUIRES(!m_mutex);
     void do_end_write() noexcept REQUIRES(!m_mutex);
     void end_write_on_correct_thread() noexcept REQUIRES(!m_mutex);
+    // Write the changes of the transaction to free space in the file without
+    // committing them. Must be called only by someone that has a lock on the
+    // write mutex.
+    void flush_write_transaction(Transaction&) REQUIRES(!m_mutex);
     // Must be called only by someone that has a lock on the write mutex.
-    void low_level_commit(uint_fast64_t new_version, Transaction& transaction, bool commit_to_disk = true)
-        REQUIRES(!m_mutex);
+    void low_level_commit(uint_fast64_t new_version, Transaction& transaction, bool commit_to_disk = true,
+                          bool allow_group_commit = false) REQUIRES(!m_mutex);
+    // Wait until the specified version has been synced to disk, syncing it if
+    // no other writer has done so. Must be called without the write lock.
+    void wait_for_group_commit(Transaction&, version_type) REQUIRES(!m_mutex);
+    // Commit an empty write transaction on behalf of the background compaction,
+    // if it has anything to do and no other writer holds the write lock.
+    // Returns false if no commit was made.
+    bool background_compaction_step(size_t step_size) REQUIRES(!m_mutex);
+    // Truncate the file to its logical size, once no reachable version extends
+    // beyond it. Must be called with the write lock.
+    void truncate_file_after_compaction(size_t logical_file_size, size_t reachable_file_size) noexcept;
 
     void do_async_commits();
 
@@ -624,7 +922,7 @@ private:
     void close_internal(std::unique_lock<util::InterprocessMutex>, bool allow_open_read_transactions)
         REQUIRES(!m_mutex);
 
-    void async_begin_write(util::UniqueFunction<void()> fn);
+    void async_begin_write(WritePriority priority, util::UniqueFunction<void()> fn);
     void async_end_write();
     void async_sync_to_disk(util::UniqueFunction<void()> fn);
 
@@ -19,6 +19,7 @@
 #ifndef REALM_GROUP_SHARED_OPTIONS_HPP
 #define REALM_GROUP_SHARED_OPTIONS_HPP
 
+#include <chrono>
 #include <functional>
 #include <string>
 #include <realm/backup_restore.hpp>
@@ -34,6 +35,14 @@ struct DBOptions {
         Unsafe // If you use this, you loose ACID property
     };
 
+    /// The expected pattern of access to the mapping of the Realm file.
+    enum class MappingAdvice {
+        Normal,
+        Random,     // Little use for readahead, e.g. point lookups in a large file
+        Sequential, // Aggressive readahead, e.g. full scans
+        WillNeed    // Read the whole mapping in ahead of use
+    };
+
     explicit DBOptions(Durability level = Durability::Full, const char* key = nullptr)
         : durability(level)
         , encryption_key(key)
@@ -73,6 +82,16 @@ struct DBOptions {
     /// upgrade (rollback the transaction) but the DB will not be opened.
     std::function<void(int, int)> upgrade_callback;
 
+    /// Optionally allows a custom function to be called while the Realm file
+    /// is upgraded, each time a step of the upgrade is done with a table. The
+    /// two parameters are the number of such steps done so far and the total
+    /// number of steps. Large upgrades should be combined with
+    /// `write_transaction_memory_limit`, which lets the upgrade write the
+    /// tables it has converted to the file as it goes, rather than holding
+    /// all of them in memory until it commits. If the callback function
+    /// throws, the upgrade is aborted like for `upgrade_callback`.
+    std::function<void(size_t, size_t)> upgrade_progress_callback;
+
     /// Optionally supply a logger
     std::shared_ptr<util::Logger> logger;
 
@@ -102,6 +121,131 @@ struct DBOptions {
     /// a performance impact.
     bool enable_async_writes = false;
 
+    /// The number of async commits which may be waiting to be synced to disk
+    /// while the next async write transaction runs. With 0, each async write
+    /// waits for the commits of the previous one to be synced. The write lock
+    /// is kept by this process until the commits are synced, and completion
+    /// callbacks are called in commit order. Only applies to Durability::Full
+    /// without encryption.
+    size_t async_write_pipeline_depth = 0;
+
+    /// If set, a commit made while other writers are waiting for the write
+    /// lock is not synced to disk right away. Instead one sync covers all the
+    /// commits of such a batch, and each commit returns once the version it
+    /// created is durable. This raises the write throughput when many threads
+    /// or processes write concurrently, as fewer syncs are needed. A commit
+    /// may have to wait for the write transactions which were waiting for the
+    /// write lock when it was made.
+    ///
+    /// A version of such a batch is published before it is durable: other
+    /// threads and processes may read it, and be notified of it, before the
+    /// commit that created it has returned. If the process or system crashes
+    /// before the batch is synced, the file is found at the last version that
+    /// was, which may be older than a version others have seen. No commit
+    /// that has returned is lost. As changesets must not be uploaded or served
+    /// before they are durable, the option is ignored for files with a sync
+    /// history. Only applies to Durability::Full, and is ignored if async
+    /// writes are enabled.
+    bool enable_group_commit = false;
+
+    /// If set, a background thread carries on the online compaction which a
+    /// commit starts when most of the file is free. Without it, the arrays at
+    /// the end of the file are only moved as part of other write transactions.
+    /// The thread commits empty write transactions, each moving up to
+    /// `background_compaction_step_size` bytes of arrays, when no other
+    /// writer holds the write lock. Once live versions no longer refer to the
+    /// end of the file, the file is truncated. Truncation is skipped for
+    /// encrypted files and on Windows. Ignored for in-memory files.
+    bool enable_background_compaction = false;
+
+    /// The fraction of the time the background compaction may hold the write
+    /// lock while it runs. Must be in the range (0, 1].
+    double background_compaction_duty_cycle = 0.1;
+
+    /// The number of bytes of arrays moved by each step of the background
+    /// compaction.
+    size_t background_compaction_step_size = 1024 * 1024;
+
+    /// The access pattern the mappings of the Realm file are advised to the
+    /// OS with, tuning readahead and paging. Only a hint, which is ignored
+    /// for encrypted files and on platforms without madvise().
+    MappingAdvice mapping_advice = MappingAdvice::Normal;
+
+    /// If set, the slabs holding the arrays of write transactions are
+    /// allocated with a request for transparent huge pages, lowering the TLB
+    /// cost of large write transactions. Only has an effect on Linux, and
+    /// only for slabs which are at least a huge page large.
+    bool use_huge_pages_for_slabs = false;
+
+    /// If set, a commit gathers the arrays it writes in a buffer and writes
+    /// each run of adjacent arrays to the file with a single positioned write,
+    /// instead of copying the arrays one by one into memory mappings of the
+    /// file. This saves page faults when a commit touches many small arrays.
+    /// Ignored for encrypted files.
+    bool enable_staged_commit_writes = false;
+
+    /// If set, a commit writes the modified leaves of integer columns, which
+    /// are neither nullable nor collections, as a base and packed differences
+    /// from it, when the values of a leaf span a range which is small compared
+    /// to their magnitude, like timestamps or increasing ids. Files written
+    /// with this option cannot be opened by versions of Realm without support
+    /// for it.
+    bool enable_integer_compression = false;
+
+    /// If not zero, Transaction::flush_changes_if_needed() writes the changes
+    /// of a write transaction to free space in the file once the memory held
+    /// for them exceeds this many bytes. See Transaction::flush_changes().
+    size_t write_transaction_memory_limit = 0;
+
+    /// If set, DB::start_frozen() hands out the same frozen transaction to
+    /// everyone asking for a version while any of them still holds on to it,
+    /// instead of building a new accessor tree each time. Such a transaction
+    /// is only closed once the last reference to it is gone, so close() on it
+    /// does nothing.
+    bool share_frozen_transactions = false;
+
+    /// If set, DB::start_read() hands out the read transaction which was
+    /// released last, if it is not in use anymore, instead of building a new
+    /// accessor tree. Only the accessors of the tables which have changed
+    /// since are refreshed, so short read transactions on a file with many
+    /// tables are much cheaper. At most one released transaction is kept, and
+    /// only if it was released while reading, without having been closed.
+    bool reuse_read_transactions = false;
+
+    /// If set, opening the file reads all tables into memory with
+    /// DB::warm_up() before returning.
+    bool warm_up_on_open = false;
+
+    /// Tables of which the pages are kept decrypted in memory, up to
+    /// `hot_tables_memory_limit` bytes, see DB::set_hot_tables(). Only used
+    /// for encrypted files.
+    std::vector<std::string> hot_tables;
+    size_t hot_tables_memory_limit = 0;
+
+    /// If set, the DB keeps a list of the read locks held by its transactions,
+    /// with when and by which thread each was taken, for
+    /// DB::get_pinned_versions(). Taking and releasing a read lock then takes
+    /// a mutex.
+    bool track_pinned_versions = false;
+
+    /// If not zero, a commit on the DB releases the read locks of read
+    /// transactions which have stayed on the same version for longer than
+    /// this, so that a forgotten transaction cannot keep old versions alive
+    /// and the file from reusing their space. Frozen transactions are left
+    /// alone. A transaction which lost its read lock this way throws
+    /// StaleAccessor when advanced or promoted to write, and its accessors
+    /// must not be used anymore. Implies `track_pinned_versions`.
+    std::chrono::milliseconds max_read_transaction_age{0};
+
+    /// If set, commits record which pages of the file they write, in the
+    /// management directory of the file, so that DB::write_incremental_backup()
+    /// only has to copy the pages written since the previous backup. With
+    /// Durability::Full, this costs a sync of the small tracking file per
+    /// commit. Commits made by DBs without this option are detected, and
+    /// make the next backup copy the whole file. Ignored for encrypted and
+    /// in-memory files.
+    bool track_changed_pages = false;
+
     /// If set, opening a file which is not a Realm file or cannot be decrypted
     /// will clear and reinitialize the file.
     bool clear_on_invalid_file = false;
@@ -18,6 +18,7 @@
 #include <realm/decimal128.hpp>
 
 #include <realm/string_data.hpp>
+#include <realm/util/safe_int_ops.hpp>
 #include <realm/util/to_string.hpp>
 
 #include <external/IntelRDFPMathLib20U2/LIBRARY/src/bid_conf.h>
@@ -43,6 +44,59 @@ BID_UINT128 to_BID_UINT128(const Decimal128& val)
     return ret;
 }
 
+constexpr uint64_t c_powers_of_ten[] = {1ull,
+                                        10ull,
+                                        100ull,
+                                        1000ull,
+                                        10000ull,
+                                        100000ull,
+                                        1000000ull,
+                                        10000000ull,
+                                        100000000ull,
+                                        1000000000ull,
+                                        10000000000ull,
+                                        100000000000ull,
+                                        1000000000000ull,
+                                        10000000000000ull,
+                                        100000000000000ull,
+                                        1000000000000000ull,
+                                        10000000000000000ull,
+                                        100000000000000000ull,
+                                        1000000000000000000ull,
+                                        10000000000000000000ull};
+
+// Multiply a coefficient by 10^n. Returns false if the result does not fit in 64 bits.
+bool scale_coefficient(uint64_t& coefficient, int n) noexcept
+{
+    if (coefficient == 0)
+        return true;
+    if (n >= int(std::size(c_powers_of_ten)))
+        return false;
+    return !util::int_multiply_with_overflow_detect(coefficient, c_powers_of_ten[n]);
+}
+
+// Compare coefficient_1 * 10^exponent_1 with coefficient_2 * 10^exponent_2, where neither coefficient is zero. A
+// coefficient which overflows when scaled to the smaller exponent is larger than the other one.
+int compare_magnitude(uint64_t coefficient_1, int exponent_1, uint64_t coefficient_2, int exponent_2) noexcept
+{
+    if (exponent_1 > exponent_2 && !scale_coefficient(coefficient_1, exponent_1 - exponent_2))
+        return 1;
+    if (exponent_2 > exponent_1 && !scale_coefficient(coefficient_2, exponent_2 - exponent_1))
+        return -1;
+    return coefficient_1 < coefficient_2 ? -1 : coefficient_1 > coefficient_2 ? 1 : 0;
+}
+
+// The layout of the 32 and 64 bit formats for coefficients which do not need the top bits of the combination
+// field, which are all the values of 4 and 8 byte wide leaves apart from null
+constexpr int c_coeff_bits_32 = 23;
+constexpr int c_exponent_bias_32 = 101;
+constexpr int c_max_exponent_32 = 191;
+constexpr uint32_t c_special_32 = 3u << 29;
+constexpr int c_coeff_bits_64 = 53;
+constexpr int c_exponent_bias_64 = 398;
+constexpr int c_max_exponent_64 = 767;
+constexpr uint64_t c_special_64 = 3ull << 61;
+
 } // namespace
 
 Decimal128::Decimal128() noexcept
@@ -1443,6 +1497,12 @@ Decimal128::Decimal128(Bid32 val) noexcept
         m_value = DECIMAL_NULL_128;
         return;
     }
+    if ((val.u & c_special_32) != c_special_32) {
+        uint64_t exponent = ((val.u >> c_coeff_bits_32) & 0xff) - c_exponent_bias_32 + DECIMAL_EXPONENT_BIAS_128;
+        m_value.w[0] = val.u & ((1u << c_coeff_bits_32) - 1);
+        m_value.w[1] = (val.u & (1u << 31) ? MASK_SIGN : 0) | (exponent << DECIMAL_COEFF_HIGH_BITS);
+        return;
+    }
     unsigned flags = 0;
     BID_UINT32 x(val.u);
     BID_UINT128 tmp;
@@ -1456,6 +1516,12 @@ Decimal128::Decimal128(Bid64 val) noexcept
         m_value = DECIMAL_NULL_128;
         return;
     }
+    if ((val.w & c_special_64) != c_special_64) {
+        uint64_t exponent = ((val.w >> c_coeff_bits_64) & 0x3ff) - c_exponent_bias_64 + DECIMAL_EXPONENT_BIAS_128;
+        m_value.w[0] = val.w & ((1ull << c_coeff_bits_64) - 1);
+        m_value.w[1] = (val.w & MASK_SIGN) | (exponent << DECIMAL_COEFF_HIGH_BITS);
+        return;
+    }
     unsigned flags = 0;
     BID_UINT64 x(val.w);
     BID_UINT128 tmp;
@@ -1522,6 +1588,14 @@ bool Decimal128::operator==(const Decimal128& rhs) const noexcept
     if (is_null() && rhs.is_null()) {
         return true;
     }
+    uint64_t coefficient_1, coefficient_2;
+    int exponent_1, exponent_2;
+    bool sign_1, sign_2;
+    if (unpack_small(coefficient_1, exponent_1, sign_1) && rhs.unpack_small(coefficient_2, exponent_2, sign_2)) {
+        if (coefficient_1 == 0 || coefficient_2 == 0)
+            return coefficient_1 == coefficient_2;
+        return sign_1 == sign_2 && compare_magnitude(coefficient_1, exponent_1, coefficient_2, exponent_2) == 0;
+    }
     unsigned flags = 0;
     int ret;
     BID_UINT128 l = to_BID_UINT128(*this);
@@ -1545,6 +1619,24 @@ bool Decimal128::operator!=(const Decimal128& rhs) const noexcept
 
 int Decimal128::compare(const Decimal128& rhs) const noexcept
 {
+    uint64_t coefficient_1, coefficient_2;
+    int exponent_1, exponent_2;
+    bool sign_1, sign_2;
+    if (unpack_small(coefficient_1, exponent_1, sign_1) && rhs.unpack_small(coefficient_2, exponent_2, sign_2)) {
+        // Zeros are equal whatever their sign and exponent
+        if (coefficient_1 == 0 || coefficient_2 == 0) {
+            if (coefficient_1 == coefficient_2)
+                return 0;
+            if (coefficient_1 == 0)
+                return sign_2 ? 1 : -1;
+            return sign_1 ? -1 : 1;
+        }
+        if (sign_1 != sign_2)
+            return sign_1 ? -1 : 1;
+        int cmp = compare_magnitude(coefficient_1, exponent_1, coefficient_2, exponent_2);
+        return sign_1 ? -cmp : cmp;
+    }
+
     unsigned flags = 0;
     int ret;
     BID_UINT128 l = to_BID_UINT128(*this);
@@ -1666,8 +1758,52 @@ Decimal128 Decimal128::operator/(Decimal128 div) const noexcept
     return do_divide(x, y);
 }
 
+bool Decimal128::add_small(Decimal128 rhs, bool negate) noexcept
+{
+    uint64_t coefficient_1, coefficient_2;
+    int exponent_1, exponent_2;
+    bool sign_1, sign_2;
+    if (!unpack_small(coefficient_1, exponent_1, sign_1) || !rhs.unpack_small(coefficient_2, exponent_2, sign_2))
+        return false;
+    sign_2 ^= negate;
+
+    // The exact sum has the smaller of the exponents, which is also what the library gives when the coefficient
+    // of the sum fits in 34 digits
+    if (exponent_1 > exponent_2) {
+        if (!scale_coefficient(coefficient_1, exponent_1 - exponent_2))
+            return false;
+        exponent_1 = exponent_2;
+    }
+    else if (!scale_coefficient(coefficient_2, exponent_2 - exponent_1)) {
+        return false;
+    }
+
+    uint64_t coefficient;
+    bool sign;
+    if (sign_1 == sign_2) {
+        coefficient = coefficient_1 + coefficient_2;
+        if (coefficient < coefficient_1)
+            return false;
+        sign = sign_1;
+    }
+    else if (coefficient_1 >= coefficient_2) {
+        // A difference of zero is positive
+        coefficient = coefficient_1 - coefficient_2;
+        sign = coefficient != 0 && sign_1;
+    }
+    else {
+        coefficient = coefficient_2 - coefficient_1;
+        sign = sign_2;
+    }
+    m_value.w[0] = coefficient;
+    m_value.w[1] = (sign ? MASK_SIGN : 0) | (uint64_t(exponent_1) << DECIMAL_COEFF_HIGH_BITS);
+    return true;
+}
+
 Decimal128& Decimal128::operator+=(Decimal128 rhs) noexcept
 {
+    if (add_small(rhs, false))
+        return *this;
     unsigned flags = 0;
     BID_UINT128 x = to_BID_UINT128(*this);
     BID_UINT128 y = to_BID_UINT128(rhs);
@@ -1680,6 +1816,8 @@ Decimal128& Decimal128::operator+=(Decimal128 rhs) noexcept
 
 Decimal128& Decimal128::operator-=(Decimal128 rhs) noexcept
 {
+    if (add_small(rhs, true))
+        return *this;
     unsigned flags = 0;
     BID_UINT128 x = to_BID_UINT128(*this);
     BID_UINT128 y = to_BID_UINT128(rhs);
@@ -1760,6 +1898,14 @@ auto Decimal128::to_bid32() const noexcept -> std::optional<Bid32>
     if (is_null()) {
         return DECIMAL_NULL_32;
     }
+    uint64_t coefficient;
+    int exponent;
+    bool sign;
+    if (unpack_small(coefficient, exponent, sign)) {
+        int exponent_32 = exponent - DECIMAL_EXPONENT_BIAS_128 + c_exponent_bias_32;
+        if (coefficient < (1u << c_coeff_bits_32) && exponent_32 >= 0 && exponent_32 <= c_max_exponent_32)
+            return Bid32((sign ? 1u << 31 : 0) | (uint32_t(exponent_32) << c_coeff_bits_32) | uint32_t(coefficient));
+    }
     unsigned flags = 0;
     BID_UINT32 buffer;
     BID_UINT128 tmp = to_BID_UINT128(*this);
@@ -1774,6 +1920,14 @@ auto Decimal128::to_bid64() const noexcept -> std::optional<Bid64>
     if (is_null()) {
         return DECIMAL_NULL_64;
     }
+    uint64_t coefficient;
+    int exponent;
+    bool sign;
+    if (unpack_small(coefficient, exponent, sign)) {
+        int exponent_64 = exponent - DECIMAL_EXPONENT_BIAS_128 + c_exponent_bias_64;
+        if (coefficient < (1ull << c_coeff_bits_64) && exponent_64 >= 0 && exponent_64 <= c_max_exponent_64)
+            return Bid64((sign ? MASK_SIGN : 0) | (uint64_t(exponent_64) << c_coeff_bits_64) | coefficient);
+    }
     unsigned flags = 0;
     BID_UINT64 buffer;
     BID_UINT128 tmp = to_BID_UINT128(*this);
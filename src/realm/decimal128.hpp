@@ -142,9 +142,25 @@ private:
     static constexpr uint64_t MASK_COEFF = (1ull << DECIMAL_COEFF_HIGH_BITS) - 1;
     static constexpr uint64_t MASK_EXP = ((1ull << DECIMAL_EXP_BITS) - 1) << DECIMAL_COEFF_HIGH_BITS;
     static constexpr uint64_t MASK_SIGN = 1ull << (DECIMAL_COEFF_HIGH_BITS + DECIMAL_EXP_BITS);
+    // Infinity, NaN and coefficients too large to be canonical have a combination field starting with 11
+    static constexpr uint64_t MASK_SPECIAL = 3ull << (DECIMAL_COEFF_HIGH_BITS + DECIMAL_EXP_BITS - 2);
 
     Bid128 m_value;
 
+    // Finite values whose coefficient fits in the low word, which include all values stored in 4 and 8 byte wide
+    // leaves, are compared, added and converted with 64 bit integer arithmetic rather than through the generic
+    // routines of the library. The exponent is biased.
+    bool unpack_small(uint64_t& coefficient, int& exponent, bool& sign) const noexcept
+    {
+        if ((m_value.w[1] & MASK_SPECIAL) == MASK_SPECIAL || get_coefficient_high() != 0)
+            return false;
+        coefficient = m_value.w[0];
+        exponent = int((m_value.w[1] & MASK_EXP) >> DECIMAL_COEFF_HIGH_BITS);
+        sign = (m_value.w[1] & MASK_SIGN) != 0;
+        return true;
+    }
+    bool add_small(Decimal128 rhs, bool negate) noexcept;
+
     uint64_t get_coefficient_high() const noexcept
     {
         return m_value.w[1] & MASK_COEFF;
@@ -26,6 +26,7 @@
 #include <realm/replication.hpp>
 
 #include <algorithm>
+#include <numeric>
 
 namespace realm {
 
@@ -48,6 +49,15 @@ void validate_key_value(const Mixed& key)
 
 /******************************** Dictionary *********************************/
 
+// The constructors are defined here rather than in the header as the key index
+// is an incomplete type there.
+Dictionary::Dictionary() = default;
+
+Dictionary::Dictionary(CollectionParent& parent, Index index)
+    : Base(parent, index)
+{
+}
+
 Dictionary::Dictionary(ColKey col_key, uint8_t level)
     : Base(col_key)
     , CollectionParent(level)
@@ -73,6 +83,14 @@ Dictionary::Dictionary(Allocator& alloc, ColKey col_key, ref_type ref)
     m_values->init_from_parent();
 }
 
+Dictionary::Dictionary(const Dictionary& other)
+    : Base(static_cast<const Base&>(other))
+    , CollectionParent(other.get_level())
+    , m_key_type(other.m_key_type)
+{
+    *this = other;
+}
+
 Dictionary::~Dictionary() = default;
 
 Dictionary& Dictionary::operator=(const Dictionary& other)
@@ -83,6 +101,7 @@ Dictionary& Dictionary::operator=(const Dictionary& other)
 
         // Back to scratch
         m_dictionary_top.reset();
+        m_key_index.reset();
         reset_content_version();
     }
 
@@ -501,7 +520,7 @@ Dictionary::Iterator Dictionary::end() const
     return Iterator(this, size());
 }
 
-std::pair<Dictionary::Iterator, bool> Dictionary::insert(Mixed key, Mixed value)
+void Dictionary::validate_entry(Mixed key, Mixed value) const
 {
     auto my_table = get_table_unchecked();
     if (key.get_type() != m_key_type) {
@@ -531,6 +550,12 @@ std::pair<Dictionary::Iterator, bool> Dictionary::insert(Mixed key, Mixed value)
     }
 
     validate_key_value(key);
+}
+
+std::pair<Dictionary::Iterator, bool> Dictionary::insert(Mixed key, Mixed value)
+{
+    auto my_table = get_table_unchecked();
+    validate_entry(key, value);
     ensure_created();
 
     ObjLink new_link;
@@ -555,7 +580,14 @@ std::pair<Dictionary::Iterator, bool> Dictionary::insert(Mixed key, Mixed value)
 
     bool set_nested_collection_key = value.is_type(type_Dictionary, type_List);
     bool old_entry = false;
-    auto [ndx, actual_key] = find_impl(key);
+    size_t ndx;
+    Mixed actual_key;
+    if (find_in_key_index(key, ndx) && ndx != realm::npos) {
+        actual_key = key;
+    }
+    else {
+        std::tie(ndx, actual_key) = find_impl(key);
+    }
     if (actual_key != key) {
         // key does not already exist
         switch (m_key_type) {
@@ -613,6 +645,81 @@ std::pair<Dictionary::Iterator, bool> Dictionary::insert(Mixed key, Mixed value)
     return {Iterator(this, ndx), !old_entry};
 }
 
+size_t Dictionary::insert_many(const std::vector<std::pair<Mixed, Mixed>>& entries)
+{
+    size_t num_entries = entries.size();
+    auto key_less = [this](Mixed a, Mixed b) {
+        if (m_key_type == type_String)
+            return a.get_string() < b.get_string();
+        return a.get_int() < b.get_int();
+    };
+
+    // Links need backlinks and nested collections need keys of their own, so
+    // only entries of other values can be appended to the trees directly.
+    bool plain_values = m_key_type == type_String || m_key_type == type_Int;
+    for (auto& [key, value] : entries) {
+        validate_entry(key, value);
+        if (value.is_type(type_Link, type_TypedLink, type_Dictionary, type_List))
+            plain_values = false;
+    }
+
+    // Order the entries by key, keeping the last of entries with the same key
+    std::vector<size_t> order(num_entries);
+    std::iota(order.begin(), order.end(), 0);
+    if (plain_values) {
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return key_less(entries[a].first, entries[b].first);
+        });
+        auto last = std::unique(order.rbegin(), order.rend(), [&](size_t a, size_t b) {
+            return !key_less(entries[a].first, entries[b].first) && !key_less(entries[b].first, entries[a].first);
+        });
+        order.erase(order.begin(), last.base());
+    }
+
+    size_t sz = size();
+    if (!plain_values || order.empty() || (sz && !key_less(do_get_key(sz - 1), entries[order.front()].first))) {
+        // Some of the keys may be present already
+        size_t num_inserted = 0;
+        for (auto& [key, value] : entries) {
+            num_inserted += insert(key, value).second;
+        }
+        return num_inserted;
+    }
+
+    // All keys go after the ones in the dictionary
+    ensure_created();
+    std::vector<Mixed> values;
+    values.reserve(order.size());
+    for (size_t i : order) {
+        values.push_back(entries[i].second);
+    }
+    if (Replication* repl = get_replication()) {
+        for (size_t i = 0; i < order.size(); ++i) {
+            repl->dictionary_insert(*this, sz + i, entries[order[i]].first, values[i]);
+        }
+    }
+    if (m_key_type == type_String) {
+        std::vector<StringData> keys;
+        keys.reserve(order.size());
+        for (size_t i : order) {
+            keys.push_back(entries[i].first.get_string());
+        }
+        static_cast<BPlusTree<StringData>*>(m_keys.get())->append(keys);
+    }
+    else {
+        std::vector<Int> keys;
+        keys.reserve(order.size());
+        for (size_t i : order) {
+            keys.push_back(entries[i].first.get_int());
+        }
+        static_cast<BPlusTree<Int>*>(m_keys.get())->append(keys);
+    }
+    m_values->append(values);
+    bump_content_version();
+
+    return order.size();
+}
+
 const Mixed Dictionary::operator[](Mixed key)
 {
     auto ret = try_get(key);
@@ -896,6 +1003,9 @@ UpdateStatus Dictionary::init_from_parent(bool allow_create) const
 
 size_t Dictionary::do_find_key(Mixed key) const noexcept
 {
+    if (size_t ndx; find_in_key_index(key, ndx)) {
+        return ndx;
+    }
     auto [ndx, actual_key] = find_impl(key);
     if (actual_key == key) {
         return ndx;
@@ -939,6 +1049,127 @@ std::pair<size_t, Mixed> Dictionary::find_impl(Mixed key) const noexcept
     return {sz, actual};
 }
 
+/*
+ * The key index is a hash table over the sorted keys, mapping each key to its
+ * position. It lives in the accessor only and is discarded whenever the
+ * content version changes, so the on-disk format and the ordering of the
+ * dictionary are unaffected. As building it costs a pass over all keys, it is
+ * only built once enough lookups have been made against the same version of
+ * a large dictionary.
+ */
+struct Dictionary::KeyIndex {
+    uint_fast64_t version = 0;
+    ref_type keys_ref = 0;
+    size_t size = 0;
+    size_t lookups = 0;
+    // Open addressing with linear probing. Each slot holds the hash of a key
+    // and its position plus one. A zero position marks an empty slot.
+    std::vector<std::pair<uint64_t, size_t>> slots;
+
+    static uint64_t hash(StringData key) noexcept
+    {
+        return key.hash();
+    }
+    static uint64_t hash(int64_t key) noexcept
+    {
+        uint64_t h = uint64_t(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    template <class T>
+    void build(const BPlusTree<T>& keys)
+    {
+        size_t capacity = 16;
+        while (capacity < 2 * size)
+            capacity <<= 1;
+        slots.assign(capacity, {0, 0});
+        size_t mask = capacity - 1;
+        size_t ndx = 0;
+        keys.for_all([&](T key) {
+            uint64_t h = hash(key);
+            size_t i = size_t(h) & mask;
+            while (slots[i].second)
+                i = (i + 1) & mask;
+            slots[i] = {h, ++ndx};
+        });
+    }
+
+    template <class T>
+    size_t find(const BPlusTree<T>& keys, T key) const noexcept
+    {
+        size_t mask = slots.size() - 1;
+        uint64_t h = hash(key);
+        for (size_t i = size_t(h) & mask; slots[i].second; i = (i + 1) & mask) {
+            if (slots[i].first == h && keys.get(slots[i].second - 1) == key)
+                return slots[i].second - 1;
+        }
+        return realm::npos;
+    }
+};
+
+auto Dictionary::get_key_index() const noexcept -> KeyIndex*
+{
+    auto sz = m_keys->size();
+    if (sz < s_key_index_min_size) {
+        m_key_index.reset();
+        return nullptr;
+    }
+    try {
+        if (!m_key_index) {
+            m_key_index = std::make_unique<KeyIndex>();
+        }
+        auto& index = *m_key_index;
+        auto keys_ref = m_keys->get_ref();
+        if (index.version != m_content_version || index.keys_ref != keys_ref || index.size != sz) {
+            index.version = m_content_version;
+            index.keys_ref = keys_ref;
+            index.size = sz;
+            index.lookups = 0;
+            index.slots.clear();
+        }
+        if (index.slots.empty()) {
+            if (++index.lookups * s_key_index_lookup_factor < sz) {
+                return nullptr;
+            }
+            if (m_key_type == type_String) {
+                index.build(*static_cast<BPlusTree<StringData>*>(m_keys.get()));
+            }
+            else {
+                index.build(*static_cast<BPlusTree<Int>*>(m_keys.get()));
+            }
+        }
+        return &index;
+    }
+    catch (...) {
+        // Building the index is only an optimization
+        m_key_index.reset();
+        return nullptr;
+    }
+}
+
+bool Dictionary::find_in_key_index(Mixed key, size_t& ndx) const noexcept
+{
+    if (!key.is_type(m_key_type) || (m_key_type != type_String && m_key_type != type_Int)) {
+        return false;
+    }
+    KeyIndex* index = get_key_index();
+    if (!index) {
+        return false;
+    }
+    if (m_key_type == type_String) {
+        ndx = index->find(*static_cast<BPlusTree<StringData>*>(m_keys.get()), key.get<StringData>());
+    }
+    else {
+        ndx = index->find(*static_cast<BPlusTree<Int>*>(m_keys.get()), key.get<Int>());
+    }
+    return true;
+}
+
 Mixed Dictionary::do_get(size_t ndx) const
 {
     Mixed val = m_values->get(ndx);
@@ -39,7 +39,7 @@ public:
     using Base = CollectionBaseImpl<DictionaryBase>;
     class Iterator;
 
-    Dictionary() = default;
+    Dictionary();
     ~Dictionary();
 
     Dictionary(const Obj& obj, ColKey col_key)
@@ -47,18 +47,9 @@ public:
     {
         this->set_owner(obj, col_key);
     }
-    Dictionary(CollectionParent& parent, Index index)
-        : Base(parent, index)
-    {
-    }
+    Dictionary(CollectionParent& parent, Index index);
     Dictionary(ColKey col_key, uint8_t level = 1);
-    Dictionary(const Dictionary& other)
-        : Base(static_cast<const Base&>(other))
-        , CollectionParent(other.get_level())
-        , m_key_type(other.m_key_type)
-    {
-        *this = other;
-    }
+    Dictionary(const Dictionary& other);
     Dictionary& operator=(const Dictionary& other);
 
     DataType get_key_data_type() const;
@@ -104,6 +95,10 @@ public:
     // second is true if the element was inserted
     std::pair<Iterator, bool> insert(Mixed key, Mixed value);
     std::pair<Iterator, bool> insert(Mixed key, const Obj& obj);
+    // Insert or update all 'entries', returning the number of keys added. When
+    // the new keys sort after all keys in the dictionary, and no value is a link
+    // or a collection, the entries are appended to the trees in one go.
+    size_t insert_many(const std::vector<std::pair<Mixed, Mixed>>& entries);
 
     template <typename T>
     void insert_json(const std::string&, const T&);
@@ -240,9 +235,19 @@ private:
     friend class DictionaryLinkValues;
     friend class Cluster;
 
+    struct KeyIndex;
+
+    // Dictionaries with at least this many entries get a hash index over the
+    // keys once they have been looked up often enough to pay for building it.
+    static constexpr size_t s_key_index_min_size = 64;
+    // The index is built when the number of lookups since the last change
+    // times this factor reaches the size of the dictionary.
+    static constexpr size_t s_key_index_lookup_factor = 16;
+
     mutable std::unique_ptr<Array> m_dictionary_top;
     mutable std::unique_ptr<BPlusTreeBase> m_keys;
     mutable std::unique_ptr<BPlusTreeMixed> m_values;
+    mutable std::unique_ptr<KeyIndex> m_key_index;
     DataType m_key_type = type_String;
 
     Dictionary(Allocator& alloc, ColKey col_key, ref_type ref);
@@ -253,6 +258,11 @@ private:
     Mixed do_get_key(size_t ndx) const;
     size_t do_find_key(Mixed key) const noexcept;
     std::pair<size_t, Mixed> find_impl(Mixed key) const noexcept;
+    void validate_entry(Mixed key, Mixed value) const;
+    // Returns true and sets 'ndx' to the position of 'key' (or npos if absent)
+    // if the lookup could be answered by the key index.
+    bool find_in_key_index(Mixed key, size_t& ndx) const noexcept;
+    KeyIndex* get_key_index() const noexcept;
     std::pair<Mixed, Mixed> do_get_pair(size_t ndx) const;
     bool clear_backlink(size_t ndx, CascadeState& state) const;
     void align_indices(std::vector<size_t>& indices) const;
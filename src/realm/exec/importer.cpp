@@ -18,13 +18,21 @@
 
 // Test tool in test/test_csv/test.pl
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <future>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <sstream>
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 #include <realm/util/assert.hpp>
+#include <realm/util/json_parser.hpp>
 #include "importer.hpp"
 
 using namespace realm;
@@ -133,12 +141,265 @@ bool is_null(const char* v)
     return false;
 }
 
+// Remove all columns so that user can call csv_import() on the table again
+void discard_import(Table& table)
+{
+    table.clear();
+
+    auto keys = table.get_column_keys();
+    for (size_t i = keys.size(); i != 0;)
+        table.remove_column(keys[--i]);
+}
+
+// Create the objects of rows [first_row, first_row + num_rows) from the first num_rows values of each column, and
+// clear the columns
+void create_objects(Table& table, std::vector<BulkColumn>& columns, size_t first_row, size_t num_rows, bool quiet)
+{
+    std::vector<ObjKey> keys;
+    keys.reserve(num_rows);
+    for (size_t r = 0; r < num_rows; ++r)
+        keys.push_back(ObjKey(first_row + r));
+    for (auto& column : columns)
+        column.values.resize(num_rows);
+    table.bulk_create_objects(keys, columns);
+    for (auto& column : columns)
+        column.values.clear();
+
+    size_t end_row = first_row + num_rows;
+    if (!quiet) {
+        for (size_t r = first_row; r < end_row && r < 10; ++r)
+            print_row(table, r);
+        if (first_row <= 11 && end_row > 11)
+            std::cout << "\nOnly showing first few rows...\n";
+        std::cout << end_row << " rows\r";
+    }
+}
+
+// Split csv records into fields. Unlike Importer::tokenize(), this cannot tell a line break in a field which is not
+// quoted from the end of the record, as the records preceding `text` may not have been parsed yet. `line` is the line
+// number of the first record, used for error messages.
+void tokenize_records(const std::string& text, char separator, size_t fields, size_t line,
+                      std::vector<std::vector<std::string>>& payload)
+{
+    const char* p = text.c_str();
+    const char* end = p + text.size();
+    while (p != end) {
+        auto& record = payload.emplace_back();
+        record.reserve(fields);
+        size_t record_line = line;
+        for (;;) {
+            auto& field = record.emplace_back();
+            while (*p == ' ')
+                ++p;
+
+            if (*p == '"') {
+                // Field in quotes - can only end with another quote, and a double-quote is a quote character
+                ++p;
+                for (;;) {
+                    auto q = static_cast<const char*>(memchr(p, '"', end - p));
+                    if (!q)
+                        q = end;
+                    line += std::count(p, q, '\n');
+                    field.append(p, q);
+                    p = q == end ? end : q + 1;
+                    if (*p != '"' || p == end)
+                        break;
+                    field.push_back('"');
+                    ++p;
+                }
+                while (*p == ' ')
+                    ++p;
+            }
+            else {
+                const char* q = p;
+                while (q != end && *q != separator && *q != 0xd && *q != 0xa)
+                    ++q;
+                field.assign(p, q);
+                p = q;
+            }
+
+            if (p == end || *p == 0xd || *p == 0xa)
+                break;
+            if (*p == separator)
+                ++p;
+        }
+
+        if (p != end) {
+            ++p;
+            ++line;
+            if (p != end && (*p == 0xd || *p == 0xa))
+                ++p;
+        }
+
+        if (record.size() != fields) {
+            std::string s = record[0].substr(0, 100);
+            std::stringstream sstm;
+            sstm << "Wrong number of delimitors around line " << record_line
+                 << " (+|- 3) in csv file. First few characters of line: " << s;
+            throw std::runtime_error(sstm.str());
+        }
+    }
+}
+
+// The type of column which can hold a json value, or none for null
+std::optional<DataType> json_type(const util::JSONParser::Event& event)
+{
+    using EventType = util::JSONParser::EventType;
+    switch (event.type) {
+        case EventType::null:
+            return std::nullopt;
+        case EventType::boolean:
+            return type_Bool;
+        case EventType::number: {
+            int64_t i;
+            auto text = event.range;
+            auto res = std::from_chars(text.data(), text.data() + text.size(), i);
+            if (res.ec == std::errc() && res.ptr == text.data() + text.size())
+                return type_Int;
+            return type_Double;
+        }
+        default:
+            return type_String;
+    }
+}
+
+// The type of column which can hold the values of both types
+std::optional<DataType> json_common_type(std::optional<DataType> type1, std::optional<DataType> type2)
+{
+    if (!type1 || type1 == type2)
+        return type2;
+    if (!type2)
+        return type1;
+    if ((type1 == type_Int && type2 == type_Double) || (type1 == type_Double && type2 == type_Int))
+        return type_Double;
+    return type_String;
+}
+
+// Call f(key, event, text) for each member of the json object on the line, with the event for the value and its
+// json text. The event of an object or array value is its object_end or array_end event, and its text the json text
+// of the whole value.
+template <class F>
+void parse_json_record(StringData line, size_t line_number, F&& f)
+{
+    using EventType = util::JSONParser::EventType;
+    int depth = 0;
+    bool expect_key = true;
+    const char* value_begin = nullptr;
+    std::string key;
+    util::JSONParser parser(line);
+    auto ec = parser.parse([&](const util::JSONParser::Event& event) -> std::error_condition {
+        bool begin = event.type == EventType::object_begin || event.type == EventType::array_begin;
+        bool end = event.type == EventType::object_end || event.type == EventType::array_end;
+        if (depth == 0) {
+            if (event.type != EventType::object_begin)
+                return util::JSONParser::Error::unexpected_token;
+            ++depth;
+        }
+        else if (depth == 1 && expect_key) {
+            if (event.type == EventType::object_end) {
+                --depth;
+                return {};
+            }
+            key.resize(event.range.size());
+            key.resize(event.unescape_string(key.data()).size());
+            expect_key = false;
+        }
+        else if (begin) {
+            if (depth++ == 1)
+                value_begin = event.range.data();
+        }
+        else if (end) {
+            if (--depth == 1) {
+                f(key, event, StringData(value_begin, event.range.data() + 1 - value_begin));
+                expect_key = true;
+            }
+        }
+        else if (depth == 1) {
+            f(key, event, event.range);
+            expect_key = true;
+        }
+        return {};
+    });
+    if (ec) {
+        std::stringstream sstm;
+        sstm << "Invalid json object on line " << line_number << ": " << ec.message();
+        throw std::runtime_error(sstm.str());
+    }
+}
+
+// Convert a json value to a value of a column of the given type. Returns false if the column cannot hold it. String
+// values which need unescaping are stored in `strings`.
+bool json_value(DataType type, const util::JSONParser::Event& event, StringData text, Mixed& value,
+                std::deque<std::string>& strings)
+{
+    using EventType = util::JSONParser::EventType;
+    auto value_type = json_type(event);
+    if (!value_type) {
+        value = Mixed();
+        return true;
+    }
+    switch (type) {
+        case type_Bool:
+            if (*value_type != type_Bool)
+                return false;
+            value = event.boolean;
+            return true;
+        case type_Int: {
+            if (*value_type != type_Int)
+                return false;
+            int64_t i;
+            std::from_chars(text.data(), text.data() + text.size(), i);
+            value = i;
+            return true;
+        }
+        case type_Double:
+            if (event.type != EventType::number)
+                return false;
+            value = event.number;
+            return true;
+        case type_String:
+            if (event.type == EventType::string) {
+                StringData escaped = event.escaped_string_value();
+                if (std::memchr(escaped.data(), '\\', escaped.size())) {
+                    auto& buffer = strings.emplace_back(escaped.size(), '\0');
+                    value = event.unescape_string(buffer.data());
+                }
+                else {
+                    value = escaped;
+                }
+            }
+            else {
+                value = text;
+            }
+            return true;
+        default:
+            REALM_ASSERT(false);
+            return false;
+    }
+}
+
 } // anonymous namespace
 
+struct Importer::Chunk {
+    std::string text;  // Complete records
+    size_t first_line; // Line number of the first record, for error messages
+    size_t num_rows = 0;
+    std::vector<BulkColumn> columns;
+    // The strings which the string values of `columns` refer to
+    std::vector<std::vector<std::string>> payload;
+    std::deque<std::string> strings;
+    // The first value which could not be converted, if any. The rows before it are in `columns`.
+    size_t failed_row = npos;
+    size_t failed_col = 0;
+    std::string failed_value;
+};
+
 
 Importer::Importer()
     : Quiet(false)
     , Separator(',')
+    , Empty_as_string(false)
+    , Threads(1)
 {
 }
 
@@ -229,7 +490,7 @@ bool Importer::parse_bool(const char* col, bool* success)
         for (size_t t = 0; t < sizeof(a) / sizeof(a[0]); t++) {
             if (strcmp(col, a[t]) == 0) {
                 *success = true;
-                return !((t & 0x1) == 0);
+                return (t & 0x1) == 0;
             }
         }
         *success = false;
@@ -664,91 +925,224 @@ size_t Importer::import_csv(FILE* file, Table& table, std::vector<DataType>* imp
         payload.clear();
     }
 
+    // The objects of a chunk of records are created together, a column at a time
+    std::vector<BulkColumn> columns;
+    for (auto key : table.get_column_keys())
+        columns.push_back({key, {}});
+    size_t first_row = 0;
+
+    // Throws the error for a field which could not be converted to the type of its column
+    auto type_error = [&](size_t col, const std::string& field, size_t row) {
+        discard_import(table);
+
+        std::stringstream sstm;
+
+        if (type_detection_rows > 0) {
+            if (scheme[col] != type_String && is_null(field.c_str()) && Empty_as_string)
+                sstm << "Column " << col << " was auto detected to be of type " << DataTypeToText(scheme[col])
+                     << " using the first " << type_detection_rows << " rows of CSV file, but in row " << row
+                     << " of cvs file the field contained the NULL value '" << field.c_str()
+                     << "'. Please increase the 'type_detection_rows' argument or set "
+                     << "Empty_as_string = false/void the -e flag to convert such fields to 0, 0.0 or "
+                        "false";
+            else
+                sstm << "Column " << col << " was auto detected to be of type " << DataTypeToText(scheme[col])
+                     << " using the first " << type_detection_rows << " rows of CSV file, but in row " << row
+                     << " of cvs file the field contained '" << field.c_str()
+                     << "' which is of another type. Please increase the 'type_detection_rows' argument";
+        }
+        else
+            sstm << "Column " << col << " was specified to be of type " << DataTypeToText(scheme[col])
+                 << ", but in row " << row << " of cvs file,"
+                 << "the field contained '" << field.c_str() << "' which is of another type";
+
+        throw std::runtime_error(sstm.str());
+    };
+
     do {
         for (size_t row = 0; row < payload.size(); row++) {
 
-            if (imported_rows == import_rows)
+            if (imported_rows == import_rows) {
+                create_objects(table, columns, first_row, imported_rows - first_row, Quiet);
                 return imported_rows;
+            }
 
             if (!Quiet && imported_rows % 123 == 0)
                 std::cout << imported_rows << " rows\r";
 
-            FieldValues values;
-            auto keys = table.get_column_keys();
-            size_t col = 0;
-            for (auto key = keys.begin(); key != keys.end(); ++key, ++col) {
-                bool success = true;
+            size_t col = convert_record(payload[row], scheme, columns);
+            if (col != npos)
+                type_error(col, payload[row][col], imported_rows);
 
-                switch (scheme[col]) {
-                    case type_String:
-                        values.insert(*key, StringData(payload[row][col]));
-                        break;
-                    case type_Int:
-                        values.insert(*key, parse_integer<true>(payload[row][col].c_str(), &success));
-                        break;
-                    case type_Double:
-                        values.insert(*key, parse_double<true>(payload[row][col].c_str(), &success));
-                        break;
-                    case type_Float:
-                        values.insert(*key, parse_float<true>(payload[row][col].c_str(), &success));
-                        break;
-                    case type_Bool:
-                        values.insert(*key, parse_bool<true>(payload[row][col].c_str(), &success));
-                        break;
-                    default:
-                        REALM_ASSERT(false);
-                        break;
-                }
+            imported_rows++;
+        }
+        create_objects(table, columns, first_row, imported_rows - first_row, Quiet);
+        first_row = imported_rows;
+        payload.clear();
 
-                if (!success) {
-                    // Remove all columns so that user can call csv_import() on it again
-                    table.clear();
+        if (Threads > 1 && imported_rows < import_rows) {
+            // Parse the rest of the file in parallel, starting with what is left in the buffer
+            std::string input(src + m_curpos, src + m_top);
+            auto parse = [&](Chunk& chunk) {
+                chunk.columns = columns;
+                parse_csv_chunk(chunk, scheme);
+            };
+            auto report = [&](const Chunk& chunk, size_t row) {
+                type_error(chunk.failed_col, chunk.failed_value, row);
+            };
+            return import_chunks(table, std::move(input), true, m_row, imported_rows, import_rows, parse, report);
+        }
 
-                    auto keys = table.get_column_keys();
-                    for (size_t i = keys.size(); i != 0;)
-                        table.remove_column(keys[--i]);
+        tokenize(payload, record_chunks);
+    } while (payload.size() > 0);
 
-                    std::stringstream sstm;
+    return imported_rows;
+}
 
-                    if (type_detection_rows > 0) {
-                        if (scheme[col] != type_String && is_null(payload[row][col].c_str()) && Empty_as_string)
-                            sstm << "Column " << col << " was auto detected to be of type "
-                                 << DataTypeToText(scheme[col]) << " using the first " << type_detection_rows
-                                 << " rows of CSV file, but in row " << imported_rows
-                                 << " of cvs file the field contained the NULL value '" << payload[row][col].c_str()
-                                 << "'. Please increase the 'type_detection_rows' argument or set "
-                                 << "Empty_as_string = false/void the -e flag to convert such fields to 0, 0.0 or "
-                                    "false";
-                        else
-                            sstm << "Column " << col << " was auto detected to be of type "
-                                 << DataTypeToText(scheme[col]) << " using the first " << type_detection_rows
-                                 << " rows of CSV file, but in row " << imported_rows
-                                 << " of cvs file the field contained '" << payload[row][col].c_str()
-                                 << "' which is of another type. Please increase the 'type_detection_rows' argument";
-                    }
-                    else
-                        sstm << "Column " << col << " was specified to be of type " << DataTypeToText(scheme[col])
-                             << ", but in row " << imported_rows << " of cvs file,"
-                             << "the field contained '" << payload[row][col].c_str() << "' which is of another type";
+// Convert the fields of a record to the types of the scheme, and append them to the columns. Returns the index of
+// the first field which could not be converted, or npos if there is none.
+size_t Importer::convert_record(const std::vector<std::string>& record, const std::vector<DataType>& scheme,
+                                std::vector<BulkColumn>& columns)
+{
+    for (size_t col = 0; col < columns.size(); ++col) {
+        bool success = true;
+        auto& values = columns[col].values;
+        const std::string& field = record[col];
 
-                    throw std::runtime_error(sstm.str());
-                }
-            }
+        switch (scheme[col]) {
+            case type_String:
+                values.push_back(StringData(field));
+                break;
+            case type_Int:
+                values.push_back(parse_integer<true>(field.c_str(), &success));
+                break;
+            case type_Double:
+                values.push_back(parse_double<true>(field.c_str(), &success));
+                break;
+            case type_Float:
+                values.push_back(parse_float<true>(field.c_str(), &success));
+                break;
+            case type_Bool:
+                values.push_back(parse_bool<true>(field.c_str(), &success));
+                break;
+            default:
+                REALM_ASSERT(false);
+                break;
+        }
+
+        if (!success)
+            return col;
+    }
+    return npos;
+}
 
-            (void)table.create_object(ObjKey(import_rows), values);
+// Tokenize the records of the chunk and convert their fields. Called by the parsing threads, so it must not modify
+// the importer.
+void Importer::parse_csv_chunk(Chunk& chunk, const std::vector<DataType>& scheme)
+{
+    tokenize_records(chunk.text, Separator, scheme.size(), chunk.first_line, chunk.payload);
+    for (auto& column : chunk.columns)
+        column.values.reserve(chunk.payload.size());
+
+    for (auto& record : chunk.payload) {
+        size_t col = convert_record(record, scheme, chunk.columns);
+        if (col != npos) {
+            chunk.failed_row = chunk.num_rows;
+            chunk.failed_col = col;
+            chunk.failed_value = record[col];
+            return;
+        }
+        ++chunk.num_rows;
+    }
+}
 
-            if (!Quiet) {
-                if (imported_rows < 10)
-                    print_row(table, imported_rows);
-                else if (imported_rows == 11)
-                    std::cout << "\nOnly showing first few rows...\n";
+// Append up to `size` bytes from the file to the input. Returns false if the end of the file was reached.
+bool Importer::read_input(std::string& input, size_t size)
+{
+    size_t old_size = input.size();
+    input.resize(old_size + size);
+    size_t r = fread(input.data() + old_size, 1, size, m_file);
+    input.resize(old_size + r);
+    return r == size;
+}
+
+// Import the rest of the file, starting with `input`, by splitting it into chunks of complete records which are
+// parsed by up to `Threads` threads at a time, while this thread creates the objects of the parsed chunks in order.
+//
+// Records end with a line break, which must not be inside a quoted field if `quoted_fields` is true. parse(chunk)
+// fills in the columns of a chunk. If it fails to convert a value, report(chunk, row) is called with the row number
+// of the value, and must throw.
+template <class Parse, class Report>
+size_t Importer::import_chunks(Table& table, std::string input, bool quoted_fields, size_t line,
+                               size_t imported_rows, size_t import_rows, Parse&& parse, Report&& report)
+{
+    std::deque<std::future<Chunk>> parsing;
+
+    auto insert_parsed = [&] {
+        Chunk chunk = parsing.front().get(); // Throws
+        parsing.pop_front();
+        size_t rows = std::min(chunk.num_rows, import_rows - imported_rows);
+        if (chunk.failed_row != npos && chunk.failed_row < import_rows - imported_rows)
+            report(chunk, imported_rows + chunk.failed_row);
+        create_objects(table, chunk.columns, imported_rows, rows, Quiet);
+        imported_rows += rows;
+    };
+
+    // Scanning state of `input`: `boundary` is the end of the last complete record, and `lines` and
+    // `lines_at_boundary` count the line breaks before the end of the scanned part and the boundary
+    bool eof = false;
+    bool in_quotes = false;
+    size_t scanned = 0;
+    size_t boundary = 0;
+    size_t lines = 0;
+    size_t lines_at_boundary = 0;
+
+    while (!eof && imported_rows < import_rows) {
+        while (!eof) {
+            size_t size = std::max(chunk_size, parallel_chunk_size - std::min(input.size(), parallel_chunk_size));
+            eof = !read_input(input, size);
+            for (; scanned < input.size(); ++scanned) {
+                char c = input[scanned];
+                if (c == '"') {
+                    in_quotes = quoted_fields && !in_quotes;
+                }
+                else if (c == 0xa) {
+                    ++lines;
+                    if (!in_quotes) {
+                        boundary = scanned + 1;
+                        lines_at_boundary = lines;
+                    }
+                }
             }
+            if (input.size() >= parallel_chunk_size && boundary > 0)
+                break;
+        }
 
-            imported_rows++;
+        Chunk chunk;
+        chunk.first_line = line;
+        if (eof) {
+            chunk.text = std::move(input);
         }
-        payload.clear();
-        tokenize(payload, record_chunks);
-    } while (payload.size() > 0);
+        else {
+            chunk.text.assign(input, 0, boundary);
+            input.erase(0, boundary);
+            scanned -= boundary;
+            lines -= lines_at_boundary;
+            line += lines_at_boundary;
+            boundary = 0;
+            lines_at_boundary = 0;
+        }
+
+        if (parsing.size() >= std::max<size_t>(Threads, 1))
+            insert_parsed(); // Throws
+        parsing.push_back(std::async(std::launch::async, [&parse, chunk = std::move(chunk)]() mutable {
+            parse(chunk); // Throws
+            return std::move(chunk);
+        }));
+    }
+
+    while (!parsing.empty() && imported_rows < import_rows)
+        insert_parsed(); // Throws
 
     return imported_rows;
 }
@@ -763,3 +1157,134 @@ size_t Importer::import_csv_manual(FILE* file, Table& table, std::vector<DataTyp
 {
     return import_csv(file, table, &scheme, &column_names, 0, skip_first_rows, import_rows);
 }
+
+size_t Importer::import_json_lines(FILE* file, Table& table, size_t type_detection_rows, size_t import_rows)
+{
+    m_file = file;
+
+    // Read the lines used for scheme detection
+    std::string input;
+    size_t detection_end = 0;
+    size_t detection_lines = 0;
+    bool eof = false;
+    while (detection_lines < type_detection_rows) {
+        size_t line_end = input.find('\n', detection_end);
+        if (line_end != std::string::npos) {
+            detection_end = line_end + 1;
+            ++detection_lines;
+        }
+        else if (!eof) {
+            eof = !read_input(input, chunk_size);
+        }
+        else {
+            detection_end = input.size();
+            break;
+        }
+    }
+
+    // Each line is a record. Blank lines are skipped.
+    auto for_each_record = [](StringData text, size_t line, auto&& f) {
+        const char* p = text.data();
+        const char* end = p + text.size();
+        for (; p != end; ++line) {
+            auto line_end = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (!line_end)
+                line_end = end;
+            StringData record(p, line_end - p);
+            p = line_end == end ? end : line_end + 1;
+            if (std::all_of(record.data(), record.data() + record.size(), [](char c) {
+                    return c == ' ' || c == '\t' || c == '\r';
+                }))
+                continue;
+            f(record, line);
+        }
+    };
+
+    // Columns are ordered by the first occurence of their member
+    std::vector<std::string> names;
+    std::vector<std::optional<DataType>> scheme;
+    std::unordered_map<std::string, size_t> column_ndx;
+    for_each_record(StringData(input.data(), detection_end), 1, [&](StringData record, size_t line) {
+        parse_json_record(record, line, [&](const std::string& key, const util::JSONParser::Event& event, StringData) {
+            auto [it, inserted] = column_ndx.emplace(key, names.size());
+            if (inserted) {
+                names.push_back(key);
+                scheme.push_back(std::nullopt);
+            }
+            scheme[it->second] = json_common_type(scheme[it->second], json_type(event));
+        });
+    });
+
+    std::vector<BulkColumn> columns;
+    for (size_t col = 0; col < names.size(); ++col) {
+        // Columns with only null values in the detection lines may hold anything
+        DataType type = scheme[col].value_or(type_String);
+        scheme[col] = type;
+        columns.push_back({table.add_column(type, names[col], true), {}});
+    }
+
+    if (!Quiet)
+        print_col_names(table);
+
+    // Called by the parsing threads, so it must not modify the importer
+    auto parse = [&](Chunk& chunk) {
+        chunk.columns = columns;
+        std::vector<Mixed> values(columns.size());
+        for_each_record(chunk.text, chunk.first_line, [&](StringData record, size_t line) {
+            if (chunk.failed_row != npos)
+                return;
+            std::fill(values.begin(), values.end(), Mixed());
+            parse_json_record(record, line, [&](const std::string& key, const util::JSONParser::Event& event,
+                                                StringData text) {
+                auto it = column_ndx.find(key);
+                if (it == column_ndx.end()) {
+                    std::stringstream sstm;
+                    sstm << "The object on line " << line << " of the json file has the member '" << key
+                         << "', which did not occur in the first " << type_detection_rows
+                         << " lines. Please increase the 'type_detection_rows' argument";
+                    throw std::runtime_error(sstm.str());
+                }
+                size_t col = it->second;
+                if (!json_value(*scheme[col], event, text, values[col], chunk.strings) &&
+                    chunk.failed_row == npos) {
+                    chunk.failed_row = chunk.num_rows;
+                    chunk.failed_col = col;
+                    chunk.failed_value = text;
+                }
+            });
+            if (chunk.failed_row != npos)
+                return;
+            for (size_t col = 0; col < values.size(); ++col)
+                chunk.columns[col].values.push_back(values[col]);
+            ++chunk.num_rows;
+        });
+    };
+
+    auto report = [&](const Chunk& chunk, size_t row) {
+        size_t col = chunk.failed_col;
+        discard_import(table);
+        std::stringstream sstm;
+        sstm << "Column '" << names[col] << "' was auto detected to be of type " << DataTypeToText(*scheme[col])
+             << " using the first " << type_detection_rows << " lines of the json file, but in row " << row
+             << " it held the value " << chunk.failed_value
+             << " which is of another type. Please increase the 'type_detection_rows' argument";
+        throw std::runtime_error(sstm.str());
+    };
+
+    // Import the detection lines on this thread, and the rest of the file in parallel
+    Chunk chunk;
+    chunk.text = input.substr(0, detection_end);
+    chunk.first_line = 1;
+    parse(chunk);
+    size_t imported_rows = std::min(chunk.num_rows, import_rows);
+    if (chunk.failed_row != npos && chunk.failed_row < import_rows)
+        report(chunk, chunk.failed_row);
+    create_objects(table, chunk.columns, 0, imported_rows, Quiet);
+    if (imported_rows == import_rows)
+        return imported_rows;
+
+    // JSON strings cannot hold line breaks, so every line break ends a record
+    input.erase(0, detection_end);
+    return import_chunks(table, std::move(input), false, detection_lines + 1, imported_rows, import_rows, parse,
+                         report);
+}
@@ -65,6 +65,19 @@ import_csv(csv file handle, realm table)
         rows and columns of the chunk payload
     Calls parse_float(), parse_bool(), etc, which tests for type and returns converted values
     Calls table.add_empty_row(), table.set_float(), table.set_bool()
+
+With Threads > 1, the records following the ones used for scheme detection are instead read in chunks of
+parallel_chunk_size bytes, split at the last line break which is not inside a double-quoted field. Each chunk is
+tokenized and converted to column values on a thread of its own, while the main thread creates the objects of the
+previous chunks with Table::bulk_create_objects(), in the order of the input. Line breaks inside fields must then be
+quoted, and fields which are not quoted cannot contain double-quotes.
+
+import_json_lines(json file handle, realm table)
+    Imports a file with a json object on each line, whose members become the columns of the table. The scheme is
+    detected from the first N lines: json booleans become Bool columns, integers Int columns, other numbers Double
+    columns and strings String columns. Columns holding more than one of these become String columns, and values
+    which are objects or arrays are stored as their json text. All columns are nullable, and members which are
+    missing from a line are null. The lines are parsed in parallel as above.
 */
 
 #include <cstddef>
@@ -79,6 +92,10 @@ static const size_t chunk_size = 32 * 1024;
 // Number of rows to csv-parse + insert into realm in each iteration.
 static const size_t record_chunks = 100;
 
+// Size of the chunks of input parsed by each thread when parsing in parallel. A chunk is rounded up to the end of
+// the record crossing this size.
+static const size_t parallel_chunk_size = 4 * 1024 * 1024;
+
 // Width of each column when printing them on screen (non-Quiet mode)
 const size_t print_width = 25;
 
@@ -97,11 +114,17 @@ public:
                              std::vector<std::string> column_names, size_t skip_first_rows = 0,
                              size_t import_rows = static_cast<size_t>(-1));
 
+    size_t import_json_lines(FILE* file, Table& table, size_t type_detection_rows = 1000,
+                             size_t import_rows = static_cast<size_t>(-1));
+
     bool Quiet;           // Quiet mode, only print to screen upon errors
     char Separator;       // csv delimitor/separator
     bool Empty_as_string; // Import columns that have occurences of empty strings as String type column
+    size_t Threads;       // Number of threads parsing the input in parallel (1 to parse it on the calling thread)
 
 private:
+    struct Chunk;
+
     size_t import_csv(FILE* file, Table& table, std::vector<DataType>* import_scheme,
                       std::vector<std::string>* column_names, size_t type_detection_rows, size_t skip_first_rows,
                       size_t import_rows);
@@ -117,6 +140,13 @@ private:
     size_t tokenize(std::vector<std::vector<std::string>>& payload, size_t records);
     std::vector<DataType> detect_scheme(std::vector<std::vector<std::string>> payload, size_t begin, size_t end);
     std::vector<DataType> lowest_common(std::vector<DataType> types1, std::vector<DataType> types2);
+    size_t convert_record(const std::vector<std::string>& record, const std::vector<DataType>& scheme,
+                          std::vector<BulkColumn>& columns);
+    void parse_csv_chunk(Chunk& chunk, const std::vector<DataType>& scheme);
+    bool read_input(std::string& input, size_t size);
+    template <class Parse, class Report>
+    size_t import_chunks(Table& table, std::string input, bool quoted_fields, size_t line, size_t imported_rows,
+                         size_t import_rows, Parse&& parse, Report&& report);
 
     char src[2 * chunk_size]; // .csv input buffer
     size_t m_top;             // points at top of buffer
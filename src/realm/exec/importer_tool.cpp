@@ -25,6 +25,7 @@
 #include <realm.hpp>
 #include <realm/utilities.hpp>
 #include <cstdarg>
+#include <thread>
 #include "importer.hpp"
 
 using namespace realm;
@@ -39,17 +40,22 @@ char separator_flag = ',';
 bool force_flag = false;
 bool quiet_flag = false;
 bool empty_as_string_flag = false;
+bool json_flag = false;
+size_t threads_flag = std::max(std::thread::hardware_concurrency(), 1u);
 
 const char* legend =
     "Simple auto-import (works in most cases):\n"
     "  csv <.csv file | -stdin> <.realm file>\n"
     "\n"
     "Advanced auto-detection of scheme:\n"
-    "  csv [-a=N] [-n=N] [-e] [-f] [-q] [-l tablename] <.csv file | -stdin> <.realm file>\n"
+    "  csv [-a=N] [-n=N] [-e] [-f] [-q] [-j=N] [-l tablename] <.csv file | -stdin> <.realm file>\n"
     "\n"
     "Manual specification of scheme:\n"
     "  csv -t={s|i|b|f|d}{s|i|b|f|d}... name1 name2 ... [-s=N] [-n=N] <.csv file | -stdin> <.realm file>\n"
     "\n"
+    "Import of json lines (a json object on each line):\n"
+    "  csv -json [-a=N] [-n=N] [-f] [-q] [-j=N] [-l tablename] <.json file | -stdin> <.realm file>\n"
+    "\n"
     " -a: Use the first N rows to auto-detect scheme (default =10000). Lower is faster but more error prone\n"
     " -e: Realm does not support null values. Set the -e flag to import a column as a String type column if\n"
     "     it has occurences of empty fields. Otherwise empty fields may be converted to 0, 0.0 or false\n"
@@ -59,7 +65,10 @@ const char* legend =
     " -q: Quiet, only print upon errors\n"
     " -f: Overwrite destination file if existing (default is to abort)\n"
     " -l: Name of the resulting table (default is 'table')\n"
-    " -p: Separator to use (default: ',')"
+    " -p: Separator to use (default: ',')\n"
+    " -j: Number of threads parsing the input (default is the number of cores). With more than one, line breaks\n"
+    "     inside fields must be quoted\n"
+    " -json: Import json lines rather than csv"
     "\n"
     "Examples:\n"
     "  csv file.csv file.realm\n"
@@ -125,6 +134,12 @@ int main(int argc, char* argv[])
             skip_rows_flag = atoi(&argv[a][3]);
             abort2(skip_rows_flag == 0, "Invalid value for -s flag");
         }
+        else if (strcmp(argv[a], "-json") == 0)
+            json_flag = true;
+        else if (strncmp(argv[a], "-j", 2) == 0) {
+            threads_flag = atoi(&argv[a][3]);
+            abort2(threads_flag == 0, "Invalid value for -j flag");
+        }
         else if (strncmp(argv[a], "-e", 2) == 0)
             empty_as_string_flag = true;
         else if (strncmp(argv[a], "-f", 2) == 0)
@@ -176,6 +191,8 @@ int main(int argc, char* argv[])
            "-a flag cannot be used when scheme is specified manually with -t flag");
     abort2(empty_as_string_flag && scheme.size() > 0,
            "-e flag cannot be used when scheme is specified manually with -t flag");
+    abort2(json_flag && (scheme.size() > 0 || skip_rows_flag > 0 || empty_as_string_flag),
+           "-t, -s and -e flags cannot be used with -json flag");
 
     abort2(!force_flag && util::File::exists(argv[argc - 1]), "Destination file '%s' already exists.",
            argv[argc - 1]);
@@ -195,9 +212,15 @@ int main(int argc, char* argv[])
     importer.Quiet = quiet_flag;
     importer.Separator = separator_flag;
     importer.Empty_as_string = empty_as_string_flag;
+    importer.Threads = threads_flag;
 
     try {
-        if (scheme.size() > 0) {
+        if (json_flag) {
+            imported_rows =
+                importer.import_json_lines(in_file, table, auto_detection_flag ? auto_detection_flag : 10000,
+                                           import_rows_flag ? import_rows_flag : static_cast<size_t>(-1));
+        }
+        else if (scheme.size() > 0) {
             // Manual specification of scheme
             imported_rows = importer.import_csv_manual(in_file, table, scheme, column_names, skip_rows_flag,
                                                        import_rows_flag ? import_rows_flag : static_cast<size_t>(-1));
@@ -16,6 +16,9 @@
  *
  * Lastly it is checked that all space is accounted for. The combination of the free list and the
  * table tree should cover the whole file. Any leaked areas are reported.
+ *
+ * The tables are walked on several threads (see --threads). For routine health checks of large files,
+ * --sample makes the verification (-v) check only a random part of the clusters of each table.
  */
 
 #include <realm/array_direct.hpp>
@@ -28,13 +31,24 @@
 #include <realm/impl/transact_log.hpp>
 #include <realm/collection_parent.hpp>
 
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <random>
 #include <sstream>
 #include <cstring>
+#include <thread>
 
 constexpr const int signature = 0x41414141;
 uint64_t current_logical_file_size;
+unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+unsigned sample_percent = 100;
+
+// Guards the output of the inconsistencies found, which may be reported by
+// several threads walking the tables at the same time
+std::mutex output_mutex;
+std::atomic<size_t> num_problems{0};
 
 struct Header {
     uint64_t m_top_ref[2]; // 2 * 8 bytes
@@ -65,6 +79,8 @@ void consolidate_lists(std::vector<T>& list, std::vector<T>& list2)
         for (auto it = list.begin() + 1; it != list.end(); ++it) {
             if (prev->start + prev->length != it->start) {
                 if (prev->start + prev->length > it->start) {
+                    std::lock_guard lock(output_mutex);
+                    ++num_problems;
                     std::cout << "*** Overlapping entries:" << std::endl;
                     std::cout << std::hex;
                     std::cout << "    0x" << prev->start << "..0x" << prev->start + prev->length << std::endl;
@@ -231,6 +247,8 @@ public:
 
         uint64_t ref = uint64_t(val);
         if (ref > current_logical_file_size || (ref & 7)) {
+            std::lock_guard lock(output_mutex);
+            ++num_problems;
             std::cout << "*** Invalid ref: 0x" << std::hex << ref << std::dec << std::endl;
             return 0;
         }
@@ -503,6 +521,8 @@ public:
         return ret;
     }
     std::vector<Entry> get_allocated_nodes() const;
+    // Get the nodes of the tables, or of a sample of their clusters
+    std::vector<Entry> get_table_nodes(bool sample) const;
     std::vector<FreeListEntry> get_free_list() const;
     void print_schema() const;
 
@@ -527,6 +547,9 @@ public:
     void node_scan();
     void schema_info();
     void memory_leaks();
+    // Check that the tables consist of valid nodes which do not overlap each
+    // other or the free list
+    void verify();
     void free_list_info() const;
     void changes() const;
 
@@ -671,7 +694,7 @@ void Node::init(realm::Allocator& alloc, uint64_t ref)
     }
 }
 
-std::vector<unsigned> path;
+thread_local std::vector<unsigned> path;
 
 static std::string print_path()
 {
@@ -689,6 +712,8 @@ static std::vector<Entry> get_nodes(realm::Allocator& alloc, uint64_t ref)
     if (ref != 0) {
         Array arr(alloc, ref);
         if (!arr.valid()) {
+            std::lock_guard lock(output_mutex);
+            ++num_problems;
             std::cout << "Not and array: 0x" << std::hex << ref << std::dec << ", path: " << print_path()
                       << std::endl;
             return {};
@@ -711,6 +736,130 @@ static std::vector<Entry> get_nodes(realm::Allocator& alloc, uint64_t ref)
     return nodes;
 }
 
+// Call `fn` for each index in [0, n) on up to `num_threads` threads, and
+// report the progress on stderr
+template <class F>
+static void for_each_parallel(size_t n, const char* what, F&& fn)
+{
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    auto work = [&] {
+        for (size_t i; (i = next++) < n;) {
+            fn(i);
+            size_t num_done = ++done;
+            std::lock_guard lock(output_mutex);
+            std::cerr << "\r" << what << ": " << num_done << "/" << n << std::flush;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < std::min<size_t>(num_threads, n); ++t)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+    if (n)
+        std::cerr << std::endl;
+}
+
+// Collect the leaves of the cluster tree at `ref`, adding the inner nodes to `nodes`
+static void get_clusters(realm::Allocator& alloc, uint64_t ref, std::vector<uint64_t>& clusters,
+                         std::vector<Entry>& nodes)
+{
+    Array node(alloc, ref);
+    if (!node.valid()) {
+        get_nodes(alloc, ref); // Reports the problem
+        return;
+    }
+    if (!node.is_inner_bptree_node()) {
+        clusters.push_back(ref);
+        return;
+    }
+    nodes.emplace_back(ref, node.size_in_bytes());
+    // The first two entries are the keys and the depth of the subtree
+    for (unsigned i = 2; i < node.size(); i++) {
+        if (uint64_t r = node.get_ref(i)) {
+            path.push_back(i);
+            get_clusters(alloc, r, clusters, nodes);
+            path.pop_back();
+        }
+    }
+}
+
+// Get the nodes of the table at `ref`, visiting only `sample_percent` of its clusters
+static std::vector<Entry> get_sampled_table_nodes(realm::Allocator& alloc, uint64_t ref)
+{
+    Array table(alloc, ref);
+    if (!table.valid() || table.size() <= 7)
+        return get_nodes(alloc, ref);
+
+    std::vector<Entry> nodes;
+    nodes.emplace_back(ref, table.size_in_bytes());
+    path.push_back(0);
+    for (unsigned i = 0; i < table.size(); i++) {
+        uint64_t r = table.get_ref(i);
+        if (!r)
+            continue;
+        path.back() = i;
+        if (i != 2) {
+            auto sub_nodes = get_nodes(alloc, r);
+            nodes.insert(nodes.end(), sub_nodes.begin(), sub_nodes.end());
+            continue;
+        }
+
+        std::vector<uint64_t> clusters;
+        get_clusters(alloc, r, clusters, nodes);
+        thread_local std::mt19937_64 random{std::random_device{}()};
+        std::shuffle(clusters.begin(), clusters.end(), random);
+        size_t num_sampled = (clusters.size() * sample_percent + 99) / 100;
+        for (size_t c = 0; c < num_sampled; c++) {
+            auto sub_nodes = get_nodes(alloc, clusters[c]);
+            nodes.insert(nodes.end(), sub_nodes.begin(), sub_nodes.end());
+        }
+    }
+    path.pop_back();
+    std::vector<Entry> sorted;
+    consolidate_lists(sorted, nodes);
+    return sorted;
+}
+
+// Get the nodes of all the tables in the tables array at `ref`, walking the
+// tables on several threads
+static std::vector<Entry> get_table_nodes(realm::Allocator& alloc, uint64_t ref, bool sample = false)
+{
+    Array tables(alloc, ref);
+    if (!ref || !tables.valid() || !tables.has_refs())
+        return get_nodes(alloc, ref);
+
+    size_t n = tables.size();
+    std::vector<std::vector<Entry>> table_nodes(n);
+    auto parent_path = path;
+    for_each_parallel(n, "Tables", [&](size_t i) {
+        if (uint64_t r = tables.get_ref(i)) {
+            path = parent_path;
+            path.push_back(unsigned(i));
+            table_nodes[i] = sample ? get_sampled_table_nodes(alloc, r) : get_nodes(alloc, r);
+        }
+    });
+
+    std::vector<Entry> nodes;
+    nodes.emplace_back(ref, tables.size_in_bytes());
+    for (auto& sub_nodes : table_nodes) {
+        nodes.insert(nodes.end(), sub_nodes.begin(), sub_nodes.end());
+        sub_nodes = {};
+    }
+    std::vector<Entry> sorted;
+    consolidate_lists(sorted, nodes);
+    return sorted;
+}
+
+std::vector<Entry> Group::get_table_nodes(bool sample) const
+{
+    path.push_back(1);
+    auto nodes = ::get_table_nodes(m_alloc, get_ref(1), sample);
+    path.pop_back();
+    return nodes;
+}
+
 std::vector<Entry> Group::get_allocated_nodes() const
 {
     std::vector<Entry> all_nodes;
@@ -721,7 +870,7 @@ std::vector<Entry> Group::get_allocated_nodes() const
     auto table_name_nodes = get_nodes(m_alloc, get_ref(0)); // Table names
     consolidate_lists(all_nodes, table_name_nodes);
     path.back() = 1;
-    auto table_nodes = get_nodes(m_alloc, get_ref(1)); // Tables
+    auto table_nodes = ::get_table_nodes(m_alloc, get_ref(1)); // Tables
     consolidate_lists(all_nodes, table_nodes);
     std::cout << "State size: " << human_readable(get_size(all_nodes)) << std::endl;
 
@@ -887,6 +1036,29 @@ void RealmFile::memory_leaks()
     }
 }
 
+void RealmFile::verify()
+{
+    if (!m_group->valid()) {
+        std::cout << "*** Invalid top array ***" << std::endl;
+        return;
+    }
+    num_problems = 0;
+    bool sample = sample_percent < 100;
+    if (sample)
+        std::cout << "Verifying " << sample_percent << "% of the clusters" << std::endl;
+    auto nodes = m_group->get_table_nodes(sample);
+    auto free_list = m_group->get_free_list();
+    std::vector<Entry> free_blocks;
+    for (auto& entry : free_list) {
+        free_blocks.emplace_back(entry.start, entry.length);
+    }
+    consolidate_lists(nodes, free_blocks);
+    if (num_problems)
+        std::cout << "*** Verification found " << num_problems << " problems ***" << std::endl;
+    else
+        std::cout << "No problems found" << std::endl;
+}
+
 void RealmFile::free_list_info() const
 {
     std::map<uint64_t, unsigned> free_sizes;
@@ -1083,6 +1255,7 @@ int main(int argc, const char* argv[])
             bool schema_info = false;
             bool node_scan = false;
             bool changes = false;
+            bool verify = false;
             uint64_t alternate_top = 0;
             const char* key_ptr = nullptr;
             char key[64];
@@ -1113,6 +1286,14 @@ int main(int argc, const char* argv[])
                         alternate_top = 0;
                     }
                 }
+                else if (strcmp(argv[curr_arg], "--threads") == 0) {
+                    curr_arg++;
+                    num_threads = std::max(1, atoi(argv[curr_arg]));
+                }
+                else if (strcmp(argv[curr_arg], "--sample") == 0) {
+                    curr_arg++;
+                    sample_percent = unsigned(std::clamp(atoi(argv[curr_arg]), 1, 100));
+                }
                 else if (argv[curr_arg][0] == '-') {
                     for (const char* command = argv[curr_arg] + 1; *command != '\0'; command++) {
                         switch (*command) {
@@ -1128,6 +1309,9 @@ int main(int argc, const char* argv[])
                             case 's':
                                 schema_info = true;
                                 break;
+                            case 'v':
+                                verify = true;
+                                break;
                             case 'w':
                                 node_scan = true;
                                 break;
@@ -1149,6 +1333,9 @@ int main(int argc, const char* argv[])
                     if (node_scan) {
                         rf.node_scan();
                     }
+                    if (verify) {
+                        rf.verify();
+                    }
                     if (changes) {
                         rf.changes();
                     }
@@ -1161,14 +1348,15 @@ int main(int argc, const char* argv[])
         }
     }
     else {
-        std::cout << "Usage: realm-trawler [-afmsw] [--keyfile file-with-binary-crypt-key] [--hexkey "
+        std::cout << "Usage: realm-trawler [-cfmsvw] [--keyfile file-with-binary-crypt-key] [--hexkey "
                      "crypt-key-in-hex] [--top "
-                     "top_ref] <realmfile>"
+                     "top_ref] [--threads number-of-threads] [--sample percent-of-clusters] <realmfile>"
                   << std::endl;
         std::cout << "   c : dump changelog" << std::endl;
         std::cout << "   f : free list analysis" << std::endl;
         std::cout << "   m : memory leak check" << std::endl;
         std::cout << "   s : schema dump" << std::endl;
+        std::cout << "   v : verify tables and free list" << std::endl;
         std::cout << "   w : node walk" << std::endl;
     }
 
@@ -0,0 +1,370 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/external_sort.hpp>
+
+#include <realm/db.hpp>
+#include <realm/table.hpp>
+#include <realm/transaction.hpp>
+#include <realm/util/file.hpp>
+
+#include <algorithm>
+
+namespace realm {
+
+namespace {
+
+// The number of keys read from or written to a run file at a time
+constexpr size_t c_buffer_size = 4096;
+
+} // anonymous namespace
+
+// A sorted sequence of object keys, either held in memory or written to a temporary file
+class ExternalSortCursor::Run {
+public:
+    explicit Run(std::vector<ObjKey>&& keys)
+    {
+        m_buffer.reserve(keys.size());
+        for (auto key : keys)
+            m_buffer.push_back(key.value);
+    }
+
+    Run(std::string path, util::File&& file)
+        : m_path(std::move(path))
+        , m_file(std::move(file))
+    {
+        m_buffer.reserve(c_buffer_size);
+    }
+
+    ~Run() noexcept
+    {
+        if (!m_path.empty()) {
+            m_file.close();
+            util::File::try_remove(m_path);
+        }
+    }
+
+    void write(ObjKey key)
+    {
+        m_buffer.push_back(key.value);
+        if (m_buffer.size() == c_buffer_size)
+            flush();
+    }
+
+    // Finish writing, and start reading from the beginning
+    void finish()
+    {
+        flush();
+        m_file.seek(0);
+        fill();
+    }
+
+    bool at_end() const noexcept
+    {
+        return m_pos == m_buffer.size();
+    }
+
+    ObjKey front() const noexcept
+    {
+        REALM_ASSERT_DEBUG(!at_end());
+        return ObjKey(m_buffer[m_pos]);
+    }
+
+    void pop()
+    {
+        if (++m_pos == m_buffer.size() && m_unread)
+            fill();
+    }
+
+    // The sort values of front()
+    Values head;
+
+private:
+    std::string m_path;
+    util::File m_file;
+    std::vector<int64_t> m_buffer;
+    size_t m_pos = 0;
+    size_t m_unread = 0;
+
+    void flush()
+    {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size() * sizeof(int64_t));
+        m_unread += m_buffer.size();
+        m_buffer.clear();
+    }
+
+    void fill()
+    {
+        size_t n = std::min(m_unread, c_buffer_size);
+        m_buffer.resize(n);
+        size_t bytes = m_file.read(reinterpret_cast<char*>(m_buffer.data()), n * sizeof(int64_t));
+        if (bytes != n * sizeof(int64_t))
+            throw RuntimeError(ErrorCodes::FileOperationFailed, "Unexpected end of temporary sort file");
+        m_unread -= n;
+        m_pos = 0;
+    }
+};
+
+ExternalSortCursor::ExternalSortCursor(ConstTableRef table, const SortDescriptor& sort, ExternalSortOptions options)
+    : m_table(table)
+    , m_sort(sort)
+    , m_options(std::move(options))
+{
+    if (!m_sort.is_valid())
+        throw InvalidArgument(ErrorCodes::InvalidSortDescriptor, "Missing property");
+
+    auto& column_lists = m_sort.get_column_keys();
+    m_columns.reserve(column_lists.size());
+    for (size_t i = 0; i < column_lists.size(); ++i) {
+        auto& columns = column_lists[i];
+        if (columns.empty())
+            throw InvalidArgument(ErrorCodes::InvalidSortDescriptor, "Missing property");
+        if (columns.back().is_collection())
+            throw InvalidArgument(ErrorCodes::InvalidSortDescriptor, "Cannot sort on a collection property");
+
+        Column& column = m_columns.emplace_back();
+        column.path = columns;
+        column.ascending = *m_sort.is_ascending(i);
+        column.tables.push_back(m_table.unchecked_ptr());
+        for (size_t j = 0; j + 1 < columns.size(); ++j) {
+            ColKey col = columns[j];
+            if (!column.tables[j]->valid_column(col))
+                throw InvalidArgument(ErrorCodes::InvalidSortDescriptor, "Invalid property");
+            if (!(col.get_type() == col_type_Link && !col.is_list()))
+                throw InvalidArgument(ErrorCodes::InvalidSortDescriptor, "All but last property must be a link");
+            column.tables.push_back(column.tables[j]->get_link_target(col).unchecked_ptr());
+        }
+    }
+
+    if (m_options.temp_directory.empty()) {
+        auto tr = dynamic_cast<Transaction*>(m_table->get_parent_group());
+        if (!tr || !tr->get_db())
+            throw InvalidArgument("A temporary directory must be given for a table which is not in a Realm file");
+        m_options.temp_directory = util::File::parent_dir(tr->get_db()->get_path());
+        if (m_options.temp_directory.empty())
+            m_options.temp_directory = ".";
+    }
+
+    // Sorting a run needs an IndexPair per object, and the sorter keeps a translated key and a value per column
+    size_t per_object =
+        sizeof(ObjKey) + sizeof(IndexPair) + m_columns.size() * (sizeof(Mixed) + sizeof(ObjKey) + sizeof(uint8_t));
+    m_run_capacity = std::max<size_t>(m_options.memory_budget / per_object, 16);
+    // Merging needs a read buffer per run
+    m_fan_in = std::max<size_t>(m_options.memory_budget / (c_buffer_size * sizeof(int64_t)), 2);
+}
+
+ExternalSortCursor::ExternalSortCursor(ExternalSortCursor&&) noexcept = default;
+
+ExternalSortCursor::~ExternalSortCursor() noexcept = default;
+
+void ExternalSortCursor::add(ObjKey key)
+{
+    REALM_ASSERT(!m_merging);
+    m_pending.push_back(key);
+    if (m_pending.size() >= m_run_capacity)
+        spill_pending();
+}
+
+ObjKey ExternalSortCursor::next()
+{
+    if (!m_merging)
+        start_merge();
+    return merge_next(m_heap);
+}
+
+void ExternalSortCursor::sort_pending()
+{
+    IndexPairs pairs;
+    pairs.reserve(m_pending.size());
+    for (size_t i = 0; i < m_pending.size(); ++i)
+        pairs.emplace_back(m_pending[i], i);
+    m_pending.clear();
+    m_pending.shrink_to_fit();
+
+    Sorter sorter = m_sort.sorter(*m_table, pairs);
+    sorter.cache_first_column(pairs);
+    m_sort.execute(pairs, sorter, nullptr);
+
+    m_pending.reserve(pairs.size());
+    for (auto& pair : pairs)
+        m_pending.push_back(pair.key_for_object);
+}
+
+void ExternalSortCursor::spill_pending()
+{
+    sort_pending();
+    auto run = create_run();
+    for (auto key : m_pending)
+        run->write(key);
+    run->finish();
+    m_runs.push_back(std::move(run));
+    ++m_num_spilled_runs;
+    m_pending.clear();
+}
+
+void ExternalSortCursor::start_merge()
+{
+    m_merging = true;
+    if (!m_pending.empty()) {
+        if (m_runs.empty()) {
+            // Everything fit in the budget, so nothing needs to be written
+            sort_pending();
+            m_runs.push_back(std::make_unique<Run>(std::move(m_pending)));
+            m_pending = {};
+        }
+        else {
+            spill_pending();
+        }
+    }
+
+    // Merge the oldest runs first, so that objects with equal values stay in the order they were added
+    while (m_runs.size() > m_fan_in)
+        merge_runs(0, m_fan_in);
+
+    m_heap = init_heap(0, m_runs.size());
+}
+
+void ExternalSortCursor::merge_runs(size_t begin, size_t end)
+{
+    auto out = create_run();
+    auto heap = init_heap(begin, end);
+    while (ObjKey key = merge_next(heap))
+        out->write(key);
+    out->finish();
+    m_has_last = false;
+
+    m_runs[begin] = std::move(out);
+    m_runs.erase(m_runs.begin() + begin + 1, m_runs.begin() + end);
+}
+
+std::vector<size_t> ExternalSortCursor::init_heap(size_t begin, size_t end)
+{
+    std::vector<size_t> heap;
+    heap.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        Run& run = *m_runs[i];
+        if (!run.at_end()) {
+            run.head = get_values(run.front());
+            heap.push_back(i);
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), [this](size_t a, size_t b) {
+        return comes_after(a, b);
+    });
+    return heap;
+}
+
+ObjKey ExternalSortCursor::merge_next(std::vector<size_t>& heap)
+{
+    auto cmp = [this](size_t a, size_t b) {
+        return comes_after(a, b);
+    };
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        Run& run = *m_runs[heap.back()];
+        ObjKey key = run.front();
+        Values values = std::move(run.head);
+        run.pop();
+        if (run.at_end()) {
+            heap.pop_back();
+        }
+        else {
+            run.head = get_values(run.front());
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        }
+
+        if (m_options.distinct) {
+            bool has_null_link = std::any_of(values.begin(), values.end(), [](auto& value) {
+                return !value;
+            });
+            if (has_null_link || (m_has_last && compare(values, m_last_values) == 0))
+                continue;
+            m_last_values = std::move(values);
+            m_has_last = true;
+        }
+        return key;
+    }
+    return ObjKey();
+}
+
+auto ExternalSortCursor::create_run() -> std::unique_ptr<Run>
+{
+    for (;;) {
+        std::string path =
+            util::File::resolve("realm_sort_" + std::to_string(m_next_file++) + ".run", m_options.temp_directory);
+        util::File file;
+        try {
+            file.open(path, util::File::access_ReadWrite, util::File::create_Must, 0); // Throws
+        }
+        catch (const FileAccessError& e) {
+            // Another cursor is using this name
+            if (e.code() == ErrorCodes::FileAlreadyExists)
+                continue;
+            throw;
+        }
+        return std::make_unique<Run>(std::move(path), std::move(file));
+    }
+}
+
+auto ExternalSortCursor::get_values(ObjKey key) const -> Values
+{
+    Values values;
+    values.reserve(m_columns.size());
+    for (auto& column : m_columns) {
+        ObjKey translated_key = key;
+        for (size_t j = 0; j + 1 < column.path.size(); ++j) {
+            translated_key = column.path[j].get_link_target(column.tables[j]->get_object(translated_key));
+            if (!translated_key || translated_key.is_unresolved()) {
+                translated_key = null_key;
+                break;
+            }
+        }
+        if (translated_key)
+            values.emplace_back(column.path.back().get_value(column.tables.back()->get_object(translated_key)));
+        else
+            values.emplace_back();
+    }
+    return values;
+}
+
+int ExternalSortCursor::compare(const Values& a, const Values& b) const
+{
+    // The same ordering as BaseDescriptor::Sorter, without the final tie break on the position in the view
+    for (size_t t = 0; t < m_columns.size(); ++t) {
+        bool ascending = m_columns[t].ascending;
+        if (!a[t] || !b[t]) {
+            if (!a[t] && !b[t])
+                continue;
+            // Sort null links at the end if ascending, else at beginning
+            return ascending == !a[t] ? 1 : -1;
+        }
+        int c = a[t]->compare(*b[t]);
+        if (c)
+            return ascending ? c : -c;
+    }
+    return 0;
+}
+
+bool ExternalSortCursor::comes_after(size_t a, size_t b) const
+{
+    int c = compare(m_runs[a]->head, m_runs[b]->head);
+    // Runs are in the order their objects were added
+    return c ? c > 0 : a > b;
+}
+
+} // namespace realm
@@ -0,0 +1,121 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_EXTERNAL_SORT_HPP
+#define REALM_EXTERNAL_SORT_HPP
+
+#include <realm/keys.hpp>
+#include <realm/mixed.hpp>
+#include <realm/sort_descriptor.hpp>
+#include <realm/table_ref.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace realm {
+
+struct ExternalSortOptions {
+    // Roughly the most memory to use for the keys of the objects being sorted and their sort values
+    size_t memory_budget = 64 * 1024 * 1024;
+    // Where to create the temporary files. Defaults to the directory of the Realm file.
+    std::string temp_directory;
+    // Only return the first object of each set of objects with equal values for all the sort columns. As for
+    // DistinctDescriptor, objects with a null link on the way to one of the columns are left out.
+    bool distinct = false;
+};
+
+/*
+ExternalSortCursor sorts a set of objects which may be too large to hold in memory, and returns them one at a time.
+
+The objects are added in chunks, which are sorted in memory as they fill the memory budget and then written to
+temporary files as runs of sorted object keys. The runs are merged while the cursor is read, after first merging
+them in several passes if there are too many to read at once. If all the objects fit in the budget, nothing is
+written. Only object keys are written, so the files reveal nothing about the content of encrypted Realms.
+
+Objects with equal sort values are returned in the order they were added. The cursor reads the sort values from
+the table while merging, so the table must stay at the same version until the cursor is no longer used.
+*/
+class ExternalSortCursor {
+public:
+    ExternalSortCursor(ConstTableRef table, const SortDescriptor& sort, ExternalSortOptions options = {});
+    ExternalSortCursor(ExternalSortCursor&&) noexcept;
+    ~ExternalSortCursor() noexcept;
+
+    // Add an object to sort. Must not be called once next() has been called.
+    void add(ObjKey key);
+
+    // Return the next object in sorted order, or a null key once all have been returned
+    ObjKey next();
+
+    // The number of runs which were written to temporary files
+    size_t get_num_spilled_runs() const noexcept
+    {
+        return m_num_spilled_runs;
+    }
+
+private:
+    struct Column {
+        // The link columns to follow and the column to sort on, with the table of each
+        std::vector<ExtendedColumnKey> path;
+        std::vector<const Table*> tables;
+        bool ascending;
+    };
+    // A sort value is none if following a link of the path gave a null link
+    using Values = std::vector<std::optional<Mixed>>;
+    using IndexPair = BaseDescriptor::IndexPair;
+    using IndexPairs = BaseDescriptor::IndexPairs;
+    using Sorter = BaseDescriptor::Sorter;
+    class Run;
+
+    ConstTableRef m_table;
+    SortDescriptor m_sort;
+    ExternalSortOptions m_options;
+    std::vector<Column> m_columns;
+    size_t m_run_capacity;
+    size_t m_fan_in;
+
+    std::vector<ObjKey> m_pending;
+    std::vector<std::unique_ptr<Run>> m_runs;
+    size_t m_num_spilled_runs = 0;
+    size_t m_next_file = 0;
+    bool m_merging = false;
+
+    // Indexes into m_runs of the runs which are not exhausted, as a heap with the next object on top
+    std::vector<size_t> m_heap;
+    // The sort values of the last object returned, for distinct
+    Values m_last_values;
+    bool m_has_last = false;
+
+    void sort_pending();
+    void spill_pending();
+    void start_merge();
+    // Replace the runs [begin, end) by a single run merging them
+    void merge_runs(size_t begin, size_t end);
+    std::vector<size_t> init_heap(size_t begin, size_t end);
+    ObjKey merge_next(std::vector<size_t>& heap);
+    std::unique_ptr<Run> create_run();
+    Values get_values(ObjKey key) const;
+    int compare(const Values& a, const Values& b) const;
+    bool comes_after(size_t run_a, size_t run_b) const;
+};
+
+} // namespace realm
+
+#endif // REALM_EXTERNAL_SORT_HPP
@@ -35,6 +35,8 @@
 #endif
 
 #include <s2/s2cap.h>
+#include <s2/s2cell.h>
+#include <s2/s2cellid.h>
 #include <s2/s2latlng.h>
 #include <s2/s2polygon.h>
 
@@ -51,6 +53,9 @@
 #include <realm/util/overload.hpp>
 #include <realm/util/scope_exit.hpp>
 
+#include <algorithm>
+#include <deque>
+
 namespace {
 
 static bool type_is_valid(realm::StringData str_type)
@@ -557,4 +562,65 @@ Status GeoRegion::get_conversion_status() const noexcept
     return m_status;
 }
 
+std::vector<std::pair<uint64_t, uint64_t>> GeoRegion::get_covering(size_t max_cells) const
+{
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    if (!m_status.is_ok()) {
+        return ranges;
+    }
+
+    // Starting from the faces of the cube, the cells intersecting the region
+    // are split breadth first, so that the largest cells are refined first,
+    // until the cells are contained by the region or the budget is spent.
+    std::vector<S2CellId> covering;
+    std::deque<S2CellId> candidates;
+    for (int face = 0; face < 6; ++face) {
+        S2CellId id = S2CellId::FromFacePosLevel(face, 0, 0);
+        if (m_region->MayIntersect(S2Cell(id))) {
+            candidates.push_back(id);
+        }
+    }
+    while (!candidates.empty()) {
+        S2CellId id = candidates.front();
+        candidates.pop_front();
+        if (id.is_leaf() || covering.size() + candidates.size() + 4 > max_cells ||
+            m_region->Contains(S2Cell(id))) {
+            covering.push_back(id);
+            continue;
+        }
+        for (S2CellId child = id.child_begin(); child != id.child_end(); child = child.next()) {
+            if (m_region->MayIntersect(S2Cell(child))) {
+                candidates.push_back(child);
+            }
+        }
+    }
+
+    std::sort(covering.begin(), covering.end());
+    for (auto& id : covering) {
+        uint64_t first = id.range_min().id();
+        uint64_t last = id.range_max().id();
+        // Leaf cell ids are odd, so adjacent cells leave a gap of one
+        if (!ranges.empty() && ranges.back().second + 2 >= first) {
+            ranges.back().second = last;
+        }
+        else {
+            ranges.emplace_back(first, last);
+        }
+    }
+    return ranges;
+}
+
+std::optional<uint64_t> GeoRegion::get_cell_id(const std::optional<GeoPoint>& geo_point) noexcept
+{
+    if (!geo_point) {
+        return {};
+    }
+    // Must agree with contains()
+    auto point = S2LatLng::FromDegrees(geo_point->latitude, geo_point->longitude);
+    if (!point.is_valid()) {
+        return {};
+    }
+    return S2CellId::FromPoint(point.ToPoint()).id();
+}
+
 } // namespace realm
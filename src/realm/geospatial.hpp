@@ -28,6 +28,7 @@
 #include <cmath>
 #include <optional>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 class S2Region;
@@ -139,6 +140,14 @@ public:
     bool contains(const std::optional<GeoPoint>& point) const noexcept;
     Status get_conversion_status() const noexcept;
 
+    // Return the ranges [first, last] of S2 leaf cell ids of a set of at most
+    // `max_cells` cells covering the region, in ascending order. Any point
+    // contained by the region is in one of the ranges.
+    std::vector<std::pair<uint64_t, uint64_t>> get_covering(size_t max_cells) const;
+    // Return the id of the S2 leaf cell holding the point, unless the point
+    // is not one the region could contain.
+    static std::optional<uint64_t> get_cell_id(const std::optional<GeoPoint>& point) noexcept;
+
 private:
     std::unique_ptr<S2Region> m_region;
     Status m_status;
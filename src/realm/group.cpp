@@ -18,6 +18,7 @@
 
 #include <new>
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 
 #ifdef REALM_DEBUG
@@ -25,8 +26,10 @@
 #include <iomanip>
 #endif
 
+#include <realm/util/alloc_tracking.hpp>
 #include <realm/util/file_mapper.hpp>
 #include <realm/util/memory_stream.hpp>
+#include <realm/util/sha_crypto.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/impl/destroy_guard.hpp>
 #include <realm/utilities.hpp>
@@ -306,8 +309,8 @@ void _impl::GroupFriend::fake_target_file_format(const std::optional<int> format
     Group::fake_target_file_format = format;
 }
 
-int Group::get_target_file_format_version_for_session(int current_file_format_version,
-                                                      int requested_history_type) noexcept
+int Group::get_target_file_format_version_for_session(int /* current_file_format_version */,
+                                                      int /* requested_history_type */) noexcept
 {
     if (Group::fake_target_file_format) {
         return *Group::fake_target_file_format;
@@ -324,13 +327,6 @@ int Group::get_target_file_format_version_for_session(int current_file_format_ve
     // Please see Group::get_file_format_version() for information about the
     // individual file format versions.
 
-    if (requested_history_type == Replication::hist_None) {
-        if (current_file_format_version == 24) {
-            // We are able to open these file formats in RO mode
-            return current_file_format_version;
-        }
-    }
-
     return g_current_file_format_version;
 }
 
@@ -410,15 +406,20 @@ int Group::read_only_version_check(SlabAlloc& alloc, ref_type top_ref, const std
     auto file_format_version = alloc.get_committed_file_format_version();
 
     bool file_format_ok = false;
-    // It is not possible to open prior file format versions without an upgrade.
-    // Since a Realm file cannot be upgraded when opened in this mode
-    // (we may be unable to write to the file), no earlier versions can be opened.
+    // It is not possible to open prior file format versions without an upgrade,
+    // unless the upgrade changes nothing in the file. Since a Realm file cannot
+    // be upgraded when opened in this mode (we may be unable to write to the
+    // file), no other earlier versions can be opened.
     // Please see Group::get_file_format_version() for information about the
     // individual file format versions.
     switch (file_format_version) {
         case 0:
             file_format_ok = (top_ref == 0);
             break;
+        case 24:
+            // Version 25 only added structures which a file of version 24
+            // does not contain, so it can be read as it is
+            [[fallthrough]];
         case g_current_file_format_version:
             file_format_ok = true;
             break;
@@ -445,8 +446,9 @@ void Group::open(ref_type top_ref, const std::string& file_path)
     else {
         // From a technical point of view, we could upgrade the Realm file
         // format in memory here, but since upgrading can be expensive, it is
-        // currently disallowed.
-        REALM_ASSERT(target_file_format_version == m_file_format_version);
+        // currently disallowed. A file of an older format which can be read
+        // as it is keeps its format, see read_only_version_check().
+        REALM_ASSERT(target_file_format_version >= m_file_format_version);
     }
 
     // Make all dynamically allocated memory (space beyond the attached file) as
@@ -483,11 +485,17 @@ void Group::remap_and_update_refs(ref_type new_top_ref, size_t new_file_size, bo
     update_allocator_wrappers(writable);
 
     // force update of all ref->ptr translations if the mapping has changed
+    update_refs(new_top_ref, update_mapping_version());
+}
+
+bool Group::update_mapping_version() noexcept
+{
     auto mapping_version = m_alloc.get_mapping_version();
-    if (mapping_version != m_last_seen_mapping_version) {
-        m_last_seen_mapping_version = mapping_version;
-    }
-    update_refs(new_top_ref);
+    bool remapped = mapping_version != m_last_seen_mapping_version;
+    m_last_seen_mapping_version = mapping_version;
+    // Pages of an encrypted file may be reclaimed unless they are accessed
+    // through a new translation
+    return remapped || m_alloc.is_encrypted();
 }
 
 void Group::validate_top_array(const Array& arr, const SlabAlloc& alloc, std::optional<size_t> read_lock_file_size,
@@ -564,6 +572,10 @@ void Group::attach(ref_type top_ref, bool writable, bool create_group_when_missi
     else if (create_group_when_missing) {
         create_empty_group(); // Throws
     }
+    if (!m_table_names.is_attached() || m_table_names.get_ref() != m_table_name_index_ref) {
+        update_table_name_index();
+        m_table_name_index_ref = m_table_names.is_attached() ? m_table_names.get_ref() : 0;
+    }
     m_attached = true;
     set_size();
 
@@ -589,6 +601,7 @@ void Group::detach() noexcept
     m_table_names.detach();
     m_tables.detach();
     m_top.detach();
+    m_table_name_index_ref = 0;
 
     m_attached = false;
 }
@@ -601,6 +614,7 @@ void Group::attach_shared(ref_type new_top_ref, size_t new_file_size, bool writa
     // update readers view of memory
     m_alloc.update_reader_view(new_file_size); // Throws
     update_allocator_wrappers(writable);
+    update_mapping_version();
 
     // When `new_top_ref` is null, ask attach() to create a new node structure
     // for an empty group, but only during the initiation of write
@@ -613,6 +627,44 @@ void Group::attach_shared(ref_type new_top_ref, size_t new_file_size, bool writa
     attach(new_top_ref, writable, create_group_when_missing, new_file_size, version.version); // Throws
 }
 
+void Group::detach_for_reuse() noexcept
+{
+    for (auto table_accessor : m_table_accessors) {
+        if (table_accessor)
+            table_accessor->detach(Table::cookie_transaction_ended);
+    }
+
+    m_table_names.detach();
+    m_tables.detach();
+    // The memory of this version may be reused once it is released
+    m_table_name_index_ref = 0;
+    m_top.detach();
+    m_notify_handler = nullptr;
+    m_schema_change_handler = nullptr;
+    m_tables_to_clear.clear();
+
+    m_attached = false;
+}
+
+void Group::attach_reused(ref_type new_top_ref, size_t new_file_size, VersionID version)
+{
+    REALM_ASSERT_3(new_top_ref, <, new_file_size);
+    REALM_ASSERT(!is_attached());
+
+    m_alloc.update_reader_view(new_file_size); // Throws
+    for (auto table_accessor : m_table_accessors) {
+        if (table_accessor) {
+            table_accessor->revive(get_repl(), m_alloc, false);
+            table_accessor->m_cookie = Table::cookie_initialized;
+        }
+    }
+    m_is_writable = false;
+
+    bool writable = false;
+    bool create_group_when_missing = false;
+    attach(new_top_ref, writable, create_group_when_missing, new_file_size, version.version); // Throws
+    refresh_dirty_accessors();                                                                // Throws
+}
 
 void Group::detach_table_accessors() noexcept
 {
@@ -660,15 +712,38 @@ Table* Group::do_get_table(size_t table_ndx)
         if (!table)
             table = create_table_accessor(table_ndx); // Throws
     }
+    touch_table_accessor(table);
     return table;
 }
 
+void Group::touch_table_accessor(Table* table) const noexcept
+{
+    // Lookups from several threads of a frozen transaction may race here, in
+    // which case some ticks are lost, but the order stays roughly right
+    uint64_t now = m_accessor_clock.load(std::memory_order_relaxed) + 1;
+    m_accessor_clock.store(now, std::memory_order_relaxed);
+    table->m_last_used.store(now, std::memory_order_relaxed);
+}
+
+
+void Group::update_table_name_index() noexcept
+{
+    // Rebuilt from scratch, as the names are rarely changed
+    m_table_name_index_ref = 0;
+    if (!m_table_names.is_attached()) {
+        m_table_name_index.clear();
+        return;
+    }
+    m_table_name_index.build(m_table_names.size(), [this](size_t ndx) {
+        return m_table_names.get(ndx);
+    });
+}
 
 Table* Group::do_get_table(StringData name)
 {
     if (!m_table_names.is_attached())
         return 0;
-    size_t table_ndx = m_table_names.find_first(name);
+    size_t table_ndx = find_table_index(name);
     if (table_ndx == not_found)
         return 0;
 
@@ -737,6 +812,7 @@ Table* Group::do_add_table(StringData name, Table::Type table_type, bool do_repl
         m_tables.set(table_ndx, rot);       // Throws
         m_table_names.set(table_ndx, name); // Throws
     }
+    update_table_name_index();
 
     Replication* repl = *get_repl();
     if (do_repl && repl)
@@ -752,6 +828,7 @@ Table* Group::do_add_table(StringData name, Table::Type table_type, bool do_repl
 
 Table* Group::create_table_accessor(size_t table_ndx)
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::accessor};
     REALM_ASSERT(m_tables.size() == m_table_accessors.size());
     REALM_ASSERT(table_ndx < m_table_accessors.size());
 
@@ -786,6 +863,7 @@ Table* Group::create_table_accessor(size_t table_ndx)
         table = new_table.release();
     }
     table->refresh_index_accessors();
+    touch_table_accessor(table);
     // must be atomic to allow concurrent probing of the m_table_accessors vector.
     store_atomic(m_table_accessors[table_ndx], table, std::memory_order_release);
     return table;
@@ -798,10 +876,56 @@ void Group::recycle_table_accessor(Table* to_be_recycled)
     g_table_recycler_1.push_back(to_be_recycled);
 }
 
+void Group::evict_table_accessors(size_t max_accessors)
+{
+    std::lock_guard<std::mutex> lock(m_accessor_mutex);
+    std::vector<size_t> table_ndxs;
+    for (size_t i = 0; i < m_table_accessors.size(); ++i) {
+        if (m_table_accessors[i])
+            table_ndxs.push_back(i);
+    }
+    if (table_ndxs.size() <= max_accessors)
+        return;
+
+    auto evicted_end = table_ndxs.end() - max_accessors;
+    std::nth_element(table_ndxs.begin(), evicted_end, table_ndxs.end(), [&](size_t a, size_t b) {
+        return m_table_accessors[a]->m_last_used.load(std::memory_order_relaxed) <
+               m_table_accessors[b]->m_last_used.load(std::memory_order_relaxed);
+    });
+    for (auto it = table_ndxs.begin(); it != evicted_end; ++it) {
+        Table* table = m_table_accessors[*it];
+        m_table_accessors[*it] = nullptr;
+        table->detach(Table::cookie_evicted);
+        // Release the subordinate accessors now rather than when the table
+        // accessor is reused, as the point is to free the memory
+        table->fully_detach();
+        recycle_table_accessor(table);
+    }
+}
+
+size_t Group::get_num_table_accessors() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_accessor_mutex);
+    return std::count_if(m_table_accessors.begin(), m_table_accessors.end(), [](Table* table) {
+        return table != nullptr;
+    });
+}
+
+size_t Group::get_table_accessor_memory() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_accessor_mutex);
+    size_t bytes = m_table_accessors.capacity() * sizeof(Table*);
+    for (Table* table : m_table_accessors) {
+        if (table)
+            bytes += table->get_accessor_memory();
+    }
+    return bytes;
+}
+
 void Group::remove_table(StringData name)
 {
     check_attached();
-    size_t table_ndx = m_table_names.find_first(name);
+    size_t table_ndx = find_table_index(name);
     if (table_ndx == not_found)
         throw NoSuchTable();
     auto key = ndx2key(table_ndx);
@@ -856,6 +980,7 @@ void Group::remove_table(size_t table_ndx, TableKey key)
     // Remove table
     m_tables.set(table_ndx, rot);     // Throws
     m_table_names.set(table_ndx, {}); // Throws
+    update_table_name_index();
     m_table_accessors[table_ndx] = nullptr;
     --m_num_tables;
 
@@ -869,7 +994,7 @@ void Group::remove_table(size_t table_ndx, TableKey key)
 void Group::rename_table(StringData name, StringData new_name, bool require_unique_name)
 {
     check_attached();
-    size_t table_ndx = m_table_names.find_first(name);
+    size_t table_ndx = find_table_index(name);
     if (table_ndx == not_found)
         throw NoSuchTable();
     rename_table(ndx2key(table_ndx), new_name, require_unique_name); // Throws
@@ -886,6 +1011,7 @@ void Group::rename_table(TableKey key, StringData new_name, bool require_unique_
         throw TableNameInUse();
     size_t table_ndx = key2ndx_checked(key);
     m_table_names.set(table_ndx, new_name);
+    update_table_name_index();
     if (Replication* repl = *get_repl())
         repl->rename_class(key, new_name); // Throws
 }
@@ -974,6 +1100,11 @@ void Group::write(std::ostream& out, bool pad) const
 void Group::write(std::ostream& out, bool pad_for_encryption, uint_fast64_t version_number, TableWriter& writer) const
 {
     REALM_ASSERT(is_attached());
+    // Tables with deferred index updates may not have applied them yet
+    for (auto& acc : m_table_accessors) {
+        if (acc && acc->get_deferred_index_updates())
+            acc->apply_deferred_index_updates(); // Throws
+    }
     writer.set_group(this);
     bool no_top_array = !m_top.is_attached();
     write(out, m_file_format_version, writer, no_top_array, pad_for_encryption, version_number); // Throws
@@ -1015,6 +1146,42 @@ void Group::write(const std::string& path, const char* encryption_key, uint64_t
     write(file, encryption_key, version_number, table_writer);
 }
 
+void Group::write_bundle(const std::string& path, size_t checksum_block_size) const
+{
+    File file;
+    file.open(path, File::access_ReadWrite, File::create_Must, 0); // Throws
+    DefaultTableWriter table_writer(false);
+    write(file, nullptr, 0, table_writer);                  // Throws
+    SlabAlloc::convert_to_bundle(file, checksum_block_size); // Throws
+}
+
+bool Group::verify_bundle(const std::string& path)
+{
+    File file(path); // Throws
+    size_t file_size = size_t(file.get_size());
+    auto footer = SlabAlloc::read_bundle_footer(file, file_size); // Throws
+    if (!footer)
+        return false;
+
+    auto fd = file.get_descriptor();
+    size_t block_size = size_t(footer->m_checksum_block_size);
+    auto buffer = std::make_unique<char[]>(block_size); // Throws
+    unsigned char checksum[SlabAlloc::bundle_checksum_size];
+    unsigned char expected[SlabAlloc::bundle_checksum_size];
+    for (uint64_t i = 0; i < footer->m_num_checksums; ++i) {
+        uint64_t pos = i * block_size;
+        size_t n = size_t(std::min<uint64_t>(block_size, footer->m_data_size - pos));
+        if (File::read_at_static(fd, pos, buffer.get(), n) != n) // Throws
+            return false;
+        util::sha256(buffer.get(), n, checksum);
+        uint64_t checksum_pos = footer->m_data_size + i * sizeof expected;
+        File::read_at_static(fd, checksum_pos, reinterpret_cast<char*>(expected), sizeof expected); // Throws
+        if (std::memcmp(checksum, expected, sizeof checksum) != 0)
+            return false;
+    }
+    return true;
+}
+
 
 BinaryData Group::write_to_mem() const
 {
@@ -1159,7 +1326,7 @@ void Group::write(std::ostream& out, int file_format_version, TableWriter& table
 }
 
 
-void Group::update_refs(ref_type top_ref) noexcept
+void Group::update_refs(ref_type top_ref, bool remapped) noexcept
 {
     // After Group::commit() we will always have free space tracking
     // info.
@@ -1170,11 +1337,15 @@ void Group::update_refs(ref_type top_ref) noexcept
     // Now we can update it's child arrays
     m_table_names.update_from_parent();
     m_tables.update_from_parent();
+    // The names are what the index was last built from
+    m_table_name_index_ref = m_table_names.get_ref();
 
-    // Update all attached table accessors.
-    for (auto& table_accessor : m_table_accessors) {
-        if (table_accessor) {
-            table_accessor->update_from_parent();
+    // Update all attached table accessors, except those of the tables which
+    // were not modified by the commit.
+    for (size_t i = 0; i < m_table_accessors.size(); ++i) {
+        if (Table* table_accessor = m_table_accessors[i]) {
+            if (remapped || !table_accessor->is_attached_at(m_tables.get_as_ref(i)))
+                table_accessor->update_from_parent();
         }
     }
 }
@@ -1221,20 +1392,52 @@ size_t Group::get_used_space() const noexcept
 namespace {
 class TransactAdvancer : public _impl::NullInstructionObserver {
 public:
-    TransactAdvancer(Group&, bool& schema_changed)
+    using Journals = std::vector<std::pair<TableKey, ChangeJournal*>>;
+
+    TransactAdvancer(Group&, bool& schema_changed, const Journals& journals)
         : m_schema_changed(schema_changed)
+        , m_journals(journals)
     {
     }
 
+    bool ignores_tables(const std::vector<TableKey>& tables) const noexcept
+    {
+        for (auto& [table_key, journal] : m_journals) {
+            if (std::find(tables.begin(), tables.end(), table_key) != tables.end())
+                return false;
+        }
+        return true;
+    }
+
+    bool select_table(TableKey key) noexcept
+    {
+        m_journal = nullptr;
+        for (auto& [table_key, journal] : m_journals) {
+            if (table_key == key)
+                m_journal = journal;
+        }
+        return true;
+    }
+
+    bool select_collection(ColKey, ObjKey key, const StablePath&)
+    {
+        record(key);
+        return true;
+    }
+
     bool insert_group_level_table(TableKey) noexcept
     {
         m_schema_changed = true;
         return true;
     }
 
-    bool erase_class(TableKey) noexcept
+    bool erase_class(TableKey key) noexcept
     {
         m_schema_changed = true;
+        for (auto& [table_key, journal] : m_journals) {
+            if (table_key == key)
+                journal->invalidate();
+        }
         return true;
     }
 
@@ -1244,15 +1447,35 @@ public:
         return true;
     }
 
+    bool create_object(ObjKey key)
+    {
+        record(key);
+        return true;
+    }
+
+    bool remove_object(ObjKey key)
+    {
+        record(key);
+        return true;
+    }
+
+    bool modify_object(ColKey, ObjKey key)
+    {
+        record(key);
+        return true;
+    }
+
     bool insert_column(ColKey)
     {
         m_schema_changed = true;
+        invalidate();
         return true;
     }
 
     bool erase_column(ColKey)
     {
         m_schema_changed = true;
+        invalidate();
         return true;
     }
 
@@ -1262,8 +1485,27 @@ public:
         return true; // No-op
     }
 
+    bool set_link_type(ColKey) noexcept
+    {
+        invalidate();
+        return true;
+    }
+
 private:
     bool& m_schema_changed;
+    const Journals& m_journals;
+    ChangeJournal* m_journal = nullptr; // Journal of the selected table, if tracked
+
+    void record(ObjKey key)
+    {
+        if (m_journal)
+            m_journal->add(key);
+    }
+    void invalidate() noexcept
+    {
+        if (m_journal)
+            m_journal->invalidate();
+    }
 };
 } // anonymous namespace
 
@@ -1288,6 +1530,7 @@ void Group::flush_accessors_for_commit()
 
 void Group::refresh_dirty_accessors()
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::accessor};
     if (!m_tables.is_attached()) {
         m_table_accessors.clear();
         return;
@@ -1301,6 +1544,10 @@ void Group::refresh_dirty_accessors()
         m_table_accessors.resize(m_tables.size());
     }
 
+    // Accessors of tables which are unchanged in the new version can be kept as
+    // they are, unless the memory they point into has been remapped
+    bool remapped = update_mapping_version();
+
     // Update all attached table accessors.
     for (size_t i = 0; i < m_table_accessors.size(); ++i) {
         auto& table_accessor = m_table_accessors[i];
@@ -1316,7 +1563,8 @@ void Group::refresh_dirty_accessors()
                     same_table = true;
             }
             if (same_table) {
-                table_accessor->refresh_accessor_tree();
+                if (remapped || !table_accessor->is_attached_at(rot.get_as_ref()))
+                    table_accessor->refresh_accessor_tree();
             }
             else {
                 table_accessor->detach(Table::cookie_removed);
@@ -1330,6 +1578,7 @@ void Group::refresh_dirty_accessors()
 
 void Group::advance_transact(ref_type new_top_ref, util::InputStream* in, bool writable)
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::accessor};
     REALM_ASSERT(is_attached());
     // Exception safety: If this function throws, the group accessor and all of
     // its subordinate accessors are left in a state that may not be fully
@@ -1365,8 +1614,9 @@ void Group::advance_transact(ref_type new_top_ref, util::InputStream* in, bool w
     // This is no longer needed in Core, but we need to compute "schema_changed",
     // for the benefit of ObjectStore.
     bool schema_changed = false;
-    if (in && has_schema_change_notification_handler()) {
-        TransactAdvancer advancer(*this, schema_changed);
+    auto journals = get_tracked_change_journals();
+    if (in && (has_schema_change_notification_handler() || !journals.empty())) {
+        TransactAdvancer advancer(*this, schema_changed, journals);
         _impl::TransactLogParser parser; // Throws
         parser.parse(*in, advancer);     // Throws
     }
@@ -1380,6 +1630,27 @@ void Group::advance_transact(ref_type new_top_ref, util::InputStream* in, bool w
         send_schema_change_notification();
 }
 
+std::vector<std::pair<TableKey, ChangeJournal*>> Group::get_tracked_change_journals() const
+{
+    std::vector<std::pair<TableKey, ChangeJournal*>> journals;
+    for (auto table_accessor : m_table_accessors) {
+        if (table_accessor && table_accessor->get_change_journal().is_tracking())
+            journals.emplace_back(table_accessor->get_key(), &table_accessor->get_change_journal());
+    }
+    return journals;
+}
+
+void Group::record_changes(util::InputStream& in)
+{
+    auto journals = get_tracked_change_journals();
+    if (journals.empty())
+        return;
+    bool schema_changed = false;
+    TransactAdvancer recorder(*this, schema_changed, journals);
+    _impl::TransactLogParser parser; // Throws
+    parser.parse(in, recorder);      // Throws
+}
+
 void Group::prepare_top_for_history(int history_type, int history_schema_version, uint64_t file_ident)
 {
     REALM_ASSERT(m_file_format_version >= 7);
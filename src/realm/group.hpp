@@ -34,6 +34,7 @@
 #include <realm/table.hpp>
 #include <realm/util/features.h>
 #include <realm/util/input_stream.hpp>
+#include <realm/util/name_index.hpp>
 
 namespace realm {
 
@@ -333,6 +334,12 @@ public:
 
     //@}
 
+    /// The number of tables which currently have an accessor, and an estimate
+    /// of the heap memory used by those accessors. Memory mapped from the file
+    /// is not included.
+    size_t get_num_table_accessors() const noexcept;
+    size_t get_table_accessor_memory() const noexcept;
+
     // Serialization
 
     /// Write this database to the specified output stream.
@@ -367,6 +374,32 @@ public:
     void write(const std::string& path, const char* encryption_key = nullptr, uint64_t version = 0,
                bool write_history = true) const;
 
+    /// Write this database to a new file as an immutable bundle, for read-only
+    /// data which many processes open with DBOptions::is_immutable.
+    ///
+    /// A bundle is a compacted copy without history, like one written by
+    /// write(), but it is never encrypted, and its header refers to the data
+    /// directly, so opening it only reads the header and a fixed size footer.
+    /// As the pages of the file are mapped as they are, rather than decrypted
+    /// into private memory, they are shared by every process which opens it.
+    /// A bundle can be opened as any other Realm file, but stops being one
+    /// once a transaction has been committed to it.
+    ///
+    /// \param checksum_block_size If not zero, the SHA-256 checksum of each
+    /// block of this many bytes is stored in the bundle, so that its integrity
+    /// can be checked with verify_bundle().
+    ///
+    /// \throw FileAccessError If the file could not be created. In particular
+    /// util::File::Exists is thrown if the file exists already.
+    void write_bundle(const std::string& path, size_t checksum_block_size = 0) const;
+
+    /// Check that the file at `path` is a bundle written by write_bundle(),
+    /// and that its data matches the checksums stored in it, if any. Returns
+    /// false otherwise. This reads the whole file, so a bundle which is
+    /// distributed to many readers would typically be checked once, when it
+    /// is installed.
+    static bool verify_bundle(const std::string& path);
+
     /// Write this database to a memory buffer.
     ///
     /// Ownership of the returned buffer is transferred to the
@@ -592,9 +625,19 @@ private:
     ArrayStringShort m_table_names;
     uint64_t m_last_seen_mapping_version = 0;
 
+    // Speeds up find_table_index() for groups with many tables. It is kept
+    // across read transactions as long as `m_table_names` is attached to the
+    // array it was built from, which is zero if the names have been modified
+    // since.
+    util::NameIndex m_table_name_index;
+    ref_type m_table_name_index_ref = 0;
+
     typedef std::vector<Table*> TableAccessors;
     mutable TableAccessors m_table_accessors;
     mutable std::mutex m_accessor_mutex;
+    // Incremented by every lookup of a table accessor, for finding the least
+    // recently used ones
+    mutable std::atomic<uint64_t> m_accessor_clock{0};
     mutable int m_num_tables = 0;
     bool m_attached = false;
     bool m_is_writable = true;
@@ -630,6 +673,16 @@ private:
     /// write transaction.
     void attach_shared(ref_type new_top_ref, size_t new_file_size, bool writable, VersionID version);
 
+    /// Detach this group accessor like detach(), but keep the table accessors
+    /// so that they can be reattached by attach_reused(). All accessors
+    /// obtained from them become invalid.
+    void detach_for_reuse() noexcept;
+
+    /// Attach a group accessor detached by detach_for_reuse() for reading.
+    /// Table accessors of the tables which are unchanged since then are reused
+    /// as they are.
+    void attach_reused(ref_type new_top_ref, size_t new_file_size, VersionID version);
+
     void create_empty_group();
     void remove_table(size_t table_ndx, TableKey key);
 
@@ -643,8 +696,14 @@ private:
     /// group instance itself, as well as any attached table accessor
     /// that exists across Transaction::commit() will remain valid. This
     /// function is not appropriate for use in conjunction with
-    /// commits via shared group.
-    void update_refs(ref_type top_ref) noexcept;
+    /// commits via shared group. Accessors of tables which were not modified
+    /// are left as they are, unless \a remapped is true.
+    void update_refs(ref_type top_ref, bool remapped) noexcept;
+
+    /// Record the current mapping version of the allocator, and return true
+    /// if accessors attached before cannot be kept as they are, because the
+    /// mapping has changed since the previous call.
+    bool update_mapping_version() noexcept;
 
     // Overriding method in ArrayParent
     void update_child_ref(size_t, ref_type) override;
@@ -667,6 +726,11 @@ private:
     void create_and_insert_table(TableKey key, StringData name);
     Table* create_table_accessor(size_t table_ndx);
     void recycle_table_accessor(Table*);
+    void touch_table_accessor(Table*) const noexcept;
+
+    /// Release the accessors of all but the `max_accessors` most recently used
+    /// tables. They are created again when the tables are next accessed.
+    void evict_table_accessors(size_t max_accessors);
 
     void detach_table_accessors() noexcept; // Idempotent
 
@@ -681,6 +745,13 @@ private:
     void refresh_dirty_accessors();
     void flush_accessors_for_commit();
 
+    /// The change journals of the table accessors which currently have
+    /// trackers (see ChangeJournal).
+    std::vector<std::pair<TableKey, ChangeJournal*>> get_tracked_change_journals() const;
+    /// Record the objects changed by the instructions in `in` in the change
+    /// journals of the tables.
+    void record_changes(util::InputStream& in);
+
     /// \brief The version of the format of the node structure (in file or in
     /// memory) in use by Realm objects associated with this group.
     ///
@@ -763,6 +834,13 @@ private:
     ///     Backlinks in BPlusTree
     ///     Sort order of Strings changed (affects sets and the string index)
     ///
+    ///  25 Integer leaves encoded as a base and packed differences (wtype_Delta).
+    ///     Compressed string and binary values.
+    ///     Sorted and case insensitive search indexes.
+    ///     Compound and geospatial indexes in the table top array.
+    ///     Files of version 24 are upgraded without changes, as they cannot
+    ///     contain any of these, and can be opened in read-only mode.
+    ///
     /// IMPORTANT: When introducing a new file format version, be sure to review
     /// the file validity checks in Group::open() and DB::do_open, the file
     /// format selection logic in
@@ -770,7 +848,7 @@ private:
     /// upgrade logic in Group::upgrade_file_format(), AND the lists of accepted
     /// file formats and the version deletion list residing in "backup_restore.cpp"
 
-    static constexpr int g_current_file_format_version = 24;
+    static constexpr int g_current_file_format_version = 25;
 
     int get_file_format_version() const noexcept;
     void set_file_format_version(int) noexcept;
@@ -806,6 +884,7 @@ private:
 
     Table* get_table_unchecked(TableKey);
     size_t find_table_index(StringData name) const noexcept;
+    void update_table_name_index() noexcept;
     TableKey ndx2key(size_t ndx) const;
     static size_t key2ndx(TableKey key);
     size_t key2ndx_checked(TableKey key) const;
@@ -813,7 +892,7 @@ private:
     std::map<TableRef, ColKey> get_primary_key_columns_from_pk_table(TableRef pk_table);
     void check_table_name_uniqueness(StringData name)
     {
-        if (m_table_names.find_first(name) != not_found)
+        if (find_table_index(name) != not_found)
             throw TableNameInUse();
     }
     void check_attached() const
@@ -930,9 +1009,14 @@ inline bool Group::has_table(StringData name) const noexcept
 
 inline size_t Group::find_table_index(StringData name) const noexcept
 {
-    if (m_table_names.is_attached())
-        return m_table_names.find_first(name);
-    return not_found;
+    if (!m_table_names.is_attached())
+        return not_found;
+    if (m_table_name_index.is_built() && name.size() != 0) {
+        return m_table_name_index.find(name, [this](size_t ndx) {
+            return m_table_names.get(ndx);
+        });
+    }
+    return m_table_names.find_first(name);
 }
 
 inline TableKey Group::find_table(StringData name) const noexcept
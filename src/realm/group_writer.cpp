@@ -29,6 +29,7 @@
 #include <realm/impl/destroy_guard.hpp>
 #include <realm/impl/simulated_failure.hpp>
 #include <realm/util/safe_int_ops.hpp>
+#include <realm/util/trace.hpp>
 
 using namespace realm;
 using namespace realm::util;
@@ -69,7 +70,7 @@ private:
 // Class controlling a memory mapped window into a file
 class WriteWindowMgr::MapWindow {
 public:
-    MapWindow(size_t alignment, util::File& f, ref_type start_ref, size_t initial_size,
+    MapWindow(size_t alignment, util::File& f, ref_type start_ref, size_t initial_size, bool sync_mapping,
               util::WriteMarker* write_marker = nullptr);
     ~MapWindow();
 
@@ -80,8 +81,11 @@ public:
     void encryption_write_barrier(void* start_addr, size_t size);
     // flush from private to shared cache
     void flush();
-    // sync to disk (including flush as needed)
+    // sync to disk (including flush as needed). Only flushes if the mapping
+    // is synced by syncing the file, which must then be done afterwards.
     void sync();
+    // flush and unmap, leaving the sync to disk to someone else
+    void close_without_sync();
     // return true if the specified range is fully visible through
     // the MapWindow
     bool matches(ref_type start_ref, size_t size);
@@ -95,6 +99,7 @@ private:
     ref_type aligned_to_mmap_block(ref_type start_ref);
     size_t get_window_size(util::File& f, ref_type start_ref, size_t size);
     size_t m_alignment;
+    bool m_sync_mapping;
 };
 
 // True if a requested block fall within a memory mapping.
@@ -149,15 +154,16 @@ bool WriteWindowMgr::MapWindow::extends_to_match(util::File& f, ref_type start_r
     if (aligned_ref != m_base_ref)
         return false;
     size_t window_size = get_window_size(f, start_ref, size);
-    m_map.sync();
+    sync();
     m_map.unmap();
     m_map.map(f, File::access_ReadWrite, window_size, 0, m_base_ref);
     return true;
 }
 
 WriteWindowMgr::MapWindow::MapWindow(size_t alignment, util::File& f, ref_type start_ref, size_t size,
-                                     util::WriteMarker* write_marker)
+                                     bool sync_mapping, util::WriteMarker* write_marker)
     : m_alignment(alignment)
+    , m_sync_mapping(sync_mapping)
 {
     m_base_ref = aligned_to_mmap_block(start_ref);
     size_t window_size = get_window_size(f, start_ref, size);
@@ -172,8 +178,10 @@ WriteWindowMgr::MapWindow::MapWindow(size_t alignment, util::File& f, ref_type s
 
 WriteWindowMgr::MapWindow::~MapWindow()
 {
-    m_map.sync();
-    m_map.unmap();
+    if (m_map.is_attached()) {
+        sync();
+        m_map.unmap();
+    }
 }
 
 void WriteWindowMgr::MapWindow::flush()
@@ -184,7 +192,14 @@ void WriteWindowMgr::MapWindow::flush()
 void WriteWindowMgr::MapWindow::sync()
 {
     flush();
-    m_map.sync();
+    if (m_sync_mapping)
+        m_map.sync();
+}
+
+void WriteWindowMgr::MapWindow::close_without_sync()
+{
+    flush();
+    m_map.unmap();
 }
 
 char* WriteWindowMgr::MapWindow::translate(ref_type ref)
@@ -207,6 +222,13 @@ WriteWindowMgr::WriteWindowMgr(SlabAlloc& alloc, Durability dura, WriteMarker* w
     , m_durability(dura)
     , m_write_marker(write_marker)
 {
+    // On Linux, pages written through a shared mapping are held in the page
+    // cache of the file, so syncing the file syncs them too. Unless they are
+    // encrypted, there is then no need to msync() each mapping, which would
+    // sync the file once per mapping.
+#if defined(__linux__)
+    m_sync_mappings = m_alloc.get_file().get_encryption_key() != nullptr;
+#endif
     m_map_windows.reserve(num_map_windows);
 #if REALM_PLATFORM_APPLE && REALM_MOBILE
     m_window_alignment = 1 * 1024 * 1024; // 1M
@@ -317,6 +339,11 @@ void GroupWriter::sync_according_to_durability()
     }
 }
 
+void GroupWriter::flush_without_sync()
+{
+    m_window_mgr.close_all_mappings_without_sync();
+}
+
 GroupWriter::~GroupWriter() = default;
 
 size_t GroupWriter::get_file_size() const noexcept
@@ -332,6 +359,14 @@ void WriteWindowMgr::flush_all_mappings()
     }
 }
 
+void WriteWindowMgr::close_all_mappings_without_sync()
+{
+    for (const auto& window : m_map_windows) {
+        window->close_without_sync();
+    }
+    m_map_windows.clear();
+}
+
 void WriteWindowMgr::sync_all_mappings()
 {
     if (m_durability == Durability::Unsafe)
@@ -360,8 +395,8 @@ WriteWindowMgr::MapWindow* WriteWindowMgr::get_window(ref_type start_ref, size_t
         m_map_windows.back()->flush();
         m_map_windows.pop_back();
     }
-    auto new_window =
-        std::make_unique<MapWindow>(m_window_alignment, m_alloc.get_file(), start_ref, size, m_write_marker);
+    auto new_window = std::make_unique<MapWindow>(m_window_alignment, m_alloc.get_file(), start_ref, size,
+                                                  m_sync_mappings, m_write_marker);
     m_map_windows.insert(m_map_windows.begin(), std::move(new_window));
     return m_map_windows[0].get();
 }
@@ -644,6 +679,7 @@ void GroupWriter::prepare_evacuation()
 
 ref_type GroupWriter::write_group()
 {
+    REALM_TRACE_SCOPE("GroupWriter::write_group");
     ALLOC_DBG_COUT("Commit nr " << m_current_version << "   ( from " << m_oldest_reachable_version << " )"
                                 << std::endl);
 
@@ -667,7 +703,7 @@ ref_type GroupWriter::write_group()
         writer = in_memory_writer.get();
     }
     ref_type names_ref = m_group.m_table_names.write(*writer, deep, only_if_modified); // Throws
-    ref_type tables_ref = m_group.m_tables.write(*writer, deep, only_if_modified);     // Throws
+    ref_type tables_ref = write_tables(*writer); // Throws
 
     int_fast64_t value_1 = from_ref(names_ref);
     int_fast64_t value_2 = from_ref(tables_ref);
@@ -712,6 +748,15 @@ ref_type GroupWriter::write_group()
         }
     }
 
+    // Arrays written so far may be read back from the file below, for example
+    // when the evacuation point array is destroyed, so the staged arrays must
+    // be in the file at this point. The remaining arrays are written through
+    // a window.
+    if (m_stage_writes) {
+        write_staged_arrays(); // Throws
+        m_stage_writes = false;
+    }
+
     ALLOC_DBG_COUT("  Freelist size after allocations: " << m_size_map.size() << std::endl);
     // We now back-date (if possible) any blocks freed in versions which
     // are becoming unreachable.
@@ -805,6 +850,7 @@ ref_type GroupWriter::write_group()
     // Now, let's update the realm-style freelists, which will later be written to file.
     // Function returns index of element holding the space reserved for the free
     // lists in the file.
+    auto free_list_start = std::chrono::steady_clock::now();
     size_t reserve_ndx = recreate_freelist(reserve_pos);
 
     ALLOC_DBG_COUT("  Freelist size after merge: " << m_free_positions.size() << "   freelist space required: "
@@ -888,6 +934,9 @@ ref_type GroupWriter::write_group()
     size_t rest = reserve_pos + reserve_size - size_t(end_ref);
     size_t used = size_t(end_ref) - reserve_pos;
     REALM_ASSERT_3(rest, >, 0);
+    m_bytes_written += used;
+    if (m_track_writes)
+        note_written(reserve_pos, used); // Throws
     int_fast64_t value_8 = from_ref(end_ref);
     int_fast64_t value_9 = to_int64(rest);
 
@@ -943,6 +992,7 @@ ref_type GroupWriter::write_group()
         write_array_at(window, top_ref, top.get_header(), top_byte_size); // Throws
         window->encryption_write_barrier(start_addr, used);
     }
+    m_free_list_time = std::chrono::steady_clock::now() - free_list_start;
     // Return top_ref so that it can be saved in lock file used for coordination
     return top_ref;
 }
@@ -1125,19 +1175,25 @@ void GroupWriter::merge_adjacent_entries_in_freelist(std::vector<GroupWriter::Fr
 }
 
 void GroupWriter::move_free_in_file_to_size_map(const std::vector<GroupWriter::FreeSpaceEntry>& list,
-                                                std::multimap<size_t, size_t>& size_map)
+                                                SizeMap& size_map)
 {
     ALLOC_DBG_COUT("  Freelist (true free): ");
+    std::vector<SizeMap::value_type> entries;
+    entries.reserve(list.size());
     for (auto& elem : list) {
         // Skip elements merged in 'merge_adjacent_entries_in_freelist'
         if (elem.size) {
             REALM_ASSERT_RELEASE_EX(!(elem.size & 7), elem.size);
             REALM_ASSERT_RELEASE_EX(!(elem.ref & 7), elem.ref);
-            size_map.emplace(elem.size, elem.ref);
+            entries.emplace_back(elem.size, elem.ref);
             ALLOC_DBG_COUT("[" << elem.ref << ", " << elem.size << "] ");
         }
     }
     ALLOC_DBG_COUT(std::endl);
+    // Inserting in order only takes constant time per entry
+    std::sort(entries.begin(), entries.end());
+    for (auto& entry : entries)
+        size_map.emplace_hint(size_map.end(), entry);
 }
 
 size_t GroupWriter::get_free_space(size_t size)
@@ -1145,6 +1201,7 @@ size_t GroupWriter::get_free_space(size_t size)
     REALM_ASSERT_3(size % 8, ==, 0); // 8-byte alignment
 
     auto p = reserve_free_space(size);
+    m_bytes_written += size;
 
     // Claim space from identified chunk
     size_t chunk_pos = p->second;
@@ -1177,7 +1234,7 @@ inline GroupWriter::FreeListElement GroupWriter::split_freelist_chunk(FreeListEl
     size_t size_first = alloc_pos - start_pos;
     size_t size_second = chunk_size - size_first;
     m_size_map.emplace(size_first, start_pos);
-    return m_size_map.emplace(size_second, alloc_pos);
+    return m_size_map.emplace(size_second, alloc_pos).first;
 }
 
 GroupWriter::FreeListElement GroupWriter::search_free_space_in_free_list_element(FreeListElement it, size_t size)
@@ -1205,7 +1262,7 @@ GroupWriter::FreeListElement GroupWriter::search_free_space_in_free_list_element
 
 GroupWriter::FreeListElement GroupWriter::search_free_space_in_part_of_freelist(size_t size)
 {
-    auto it = m_size_map.lower_bound(size);
+    auto it = m_size_map.lower_bound({size, 0});
     while (it != m_size_map.end()) {
         // Accept either a perfect match or a block that is twice the size. Tests have shown
         // that this is a good strategy.
@@ -1218,7 +1275,7 @@ GroupWriter::FreeListElement GroupWriter::search_free_space_in_part_of_freelist(
         }
         else {
             // If block was too small, search for the first that is at least twice as big.
-            it = m_size_map.lower_bound(2 * size);
+            it = m_size_map.lower_bound({2 * size, 0});
         }
     }
     // No match
@@ -1320,7 +1377,7 @@ GroupWriter::FreeListElement GroupWriter::extend_free_space(size_t requested_siz
     size_t chunk_size = new_file_size - logical_file_size;
     REALM_ASSERT_RELEASE_EX(!(chunk_size & 7), chunk_size);
     REALM_ASSERT_RELEASE(chunk_size != 0);
-    auto it = m_size_map.emplace(chunk_size, logical_file_size);
+    auto it = m_size_map.emplace(chunk_size, logical_file_size).first;
 
     // Update the logical file size
     m_logical_size = new_file_size;
@@ -1337,10 +1394,84 @@ bool inline is_aligned(char* addr)
     return (as_binary & 7) == 0;
 }
 
+ref_type GroupWriter::write_tables(_impl::ArrayWriterBase& out)
+{
+    Array& tables = m_group.m_tables;
+    if (m_alloc.is_read_only(tables.get_ref()))
+        return tables.get_ref();
+
+    // Temp array for updated refs
+    Array new_tables(Allocator::get_default());
+    new_tables.create(Array::type_HasRefs); // Throws
+    _impl::ShallowArrayDestroyGuard dg(&new_tables);
+
+    // Encoded leaves were introduced with file format version 25
+    bool encode_integers = m_compress_integers && m_group.get_file_format_version() >= 25;
+    for (size_t i = 0, n = tables.size(); i < n; ++i) {
+        int64_t value = tables.get(i);
+        // Entries of removed tables are tagged
+        if (value != 0 && (value & 1) == 0)
+            value = from_ref(Table::typed_write(to_ref(value), out, m_alloc, encode_integers)); // Throws
+        new_tables.add(value); // Throws
+    }
+
+    return new_tables.write(out, false, false); // Throws
+}
+
+void GroupWriter::enable_staged_writes() noexcept
+{
+    m_stage_writes = !m_alloc.is_in_memory() && !m_alloc.get_file().get_encryption_key();
+}
+
+void GroupWriter::stage_array(size_t pos, const char* data, size_t size, uint32_t checksum)
+{
+    if (m_staging_buffer.size() + size > max_staged_size)
+        write_staged_arrays(); // Throws
+    if (m_staging_buffer.capacity() == 0)
+        m_staging_buffer.reserve(max_staged_size); // Throws
+    if (m_staged_runs.empty() || m_staged_runs.back().first + m_staged_runs.back().second != pos)
+        m_staged_runs.emplace_back(pos, 0); // Throws
+    m_staged_runs.back().second += size;
+
+    size_t offset = m_staging_buffer.size();
+    m_staging_buffer.resize(offset + size); // Throws
+    char* dest_addr = m_staging_buffer.data() + offset;
+    memcpy(dest_addr, &checksum, 4);
+    memcpy(dest_addr + 4, data + 4, size - 4);
+}
+
+void GroupWriter::write_staged_arrays()
+{
+    auto fd = m_alloc.get_file().get_descriptor();
+    const char* data = m_staging_buffer.data();
+    for (auto [ref, size] : m_staged_runs) {
+        File::write_at_static(fd, ref, data, size); // Throws
+        data += size;
+    }
+    m_staged_runs.clear();
+    m_staging_buffer.clear();
+}
+
+void GroupWriter::note_written(size_t pos, size_t size)
+{
+    if (!m_written_ranges.empty() && m_written_ranges.back().first + m_written_ranges.back().second == pos) {
+        m_written_ranges.back().second += size;
+        return;
+    }
+    m_written_ranges.emplace_back(pos, size); // Throws
+}
+
 ref_type GroupWriter::write_array(const char* data, size_t size, uint32_t checksum)
 {
     // Get position of free space to write in (expanding file if needed)
     size_t pos = get_free_space(size);
+    if (m_track_writes)
+        note_written(pos, size); // Throws
+
+    if (m_stage_writes) {
+        stage_array(pos, data, size, checksum); // Throws
+        return to_ref(pos);
+    }
 
     // Write the block
     MapWindow* window = m_window_mgr.get_window(pos, size);
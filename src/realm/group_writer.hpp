@@ -19,9 +19,11 @@
 #ifndef REALM_GROUP_WRITER_HPP
 #define REALM_GROUP_WRITER_HPP
 
+#include <chrono>
 #include <cstdint> // unint8_t etc
 #include <utility>
 #include <map>
+#include <set>
 
 #include <realm/util/file.hpp>
 #include <realm/alloc.hpp>
@@ -62,10 +64,15 @@ public:
     using Durability = DBOptions::Durability;
     WriteWindowMgr(SlabAlloc& alloc, Durability dura, util::WriteMarker* write_marker);
     // Flush all cached memory mappings
-    // Sync all cached memory mappings to disk - includes flush if needed
+    // Sync all cached memory mappings to disk - includes flush if needed. On
+    // platforms where syncing the file covers the mappings, this only flushes
+    // them, and the data is synced by the file sync of the next commit.
     void sync_all_mappings();
     // Flush all cached memory mappings from private to shared cache.
     void flush_all_mappings();
+    // Flush and close all cached memory mappings without syncing them to
+    // disk. Used when the file will be synced to disk later on.
+    void close_all_mappings_without_sync();
     class MapWindow;
     // Get a suitable memory mapping for later access:
     // potentially adding it to the cache, potentially closing
@@ -85,6 +92,8 @@ protected:
     std::vector<std::unique_ptr<MapWindow>> m_map_windows;
     size_t m_window_alignment;
     util::WriteMarker* m_write_marker = nullptr;
+    // False if syncing the file also syncs the memory mappings
+    bool m_sync_mappings = true;
 };
 
 class GroupCommitter {
@@ -161,6 +170,19 @@ public:
         return m_backoff ? 0 : m_evacuation_limit;
     }
 
+    /// The number of bytes of arrays written to the file by write_group(),
+    /// including the free lists and the top array.
+    size_t get_bytes_written() const noexcept
+    {
+        return m_bytes_written;
+    }
+
+    /// The time write_group() spent recreating and writing the free lists.
+    std::chrono::nanoseconds get_free_list_time() const noexcept
+    {
+        return m_free_list_time;
+    }
+
     size_t get_free_list_size()
     {
         return m_free_positions.size() * size_per_free_list_entry();
@@ -194,6 +216,40 @@ public:
         }
     }
     void sync_according_to_durability();
+    /// Make the written data visible to other mappings of the file, leaving
+    /// the sync to disk to a later commit.
+    void flush_without_sync();
+
+    /// Gather the arrays written by write_group() in a staging buffer, laid
+    /// out as they are in the file, and write each run of adjacent arrays to
+    /// the file with one positioned write, instead of copying them one by one
+    /// into write windows. This saves the page faults of the windows for
+    /// commits touching many small arrays. Ignored for encrypted files, which
+    /// must be written through the encryption layer.
+    void enable_staged_writes() noexcept;
+
+    /// Write the modified leaves of plain integer columns as a base and
+    /// packed differences from it, where that is smaller (see
+    /// Array::write_encoded()).
+    void enable_integer_compression() noexcept
+    {
+        m_compress_integers = true;
+    }
+
+    /// Keep track of the ranges of the file written by write_group(), for
+    /// get_written_ranges().
+    void enable_write_tracking() noexcept
+    {
+        m_track_writes = true;
+    }
+
+    /// The (ref, size) of each range of the file written by write_group(),
+    /// in the order they were written, if enabled by enable_write_tracking().
+    /// Adjacent ranges are merged.
+    const std::vector<std::pair<size_t, size_t>>& get_written_ranges() const noexcept
+    {
+        return m_written_ranges;
+    }
 
 private:
     friend class InMemoryWriter;
@@ -209,9 +265,16 @@ private:
         uint64_t released_at_version;
     };
 
+    /// The chunks of free space which can be allocated from, as (size, ref)
+    /// pairs. Ordering on size first makes lower_bound() find the smallest
+    /// chunk which is large enough, and among chunks of the same size the one
+    /// closest to the start of the file.
+    using SizeMap = std::set<std::pair<size_t, size_t>>;
+    using FreeListElement = SizeMap::iterator;
+
     static void merge_adjacent_entries_in_freelist(std::vector<FreeSpaceEntry>& list);
     static void move_free_in_file_to_size_map(const std::vector<GroupWriter::FreeSpaceEntry>& list,
-                                              std::multimap<size_t, size_t>& size_map);
+                                              SizeMap& size_map);
 
     Transaction& m_group;
     SlabAlloc& m_alloc;
@@ -229,13 +292,33 @@ private:
     size_t m_evacuation_limit;
     int64_t m_backoff;
     size_t m_logical_size = 0;
+    size_t m_bytes_written = 0;
+    std::chrono::nanoseconds m_free_list_time{0};
 
     //  m_free_in_file;
     std::vector<FreeSpaceEntry> m_not_free_in_file;
     std::vector<FreeSpaceEntry> m_under_evacuation;
-    std::multimap<size_t, size_t> m_size_map;
+    SizeMap m_size_map;
     std::vector<size_t> m_evacuation_progress;
-    using FreeListElement = std::multimap<size_t, size_t>::iterator;
+
+    // Arrays waiting to be written to the file when staged writes are enabled,
+    // and the (ref, size) of each run of adjacent arrays in the buffer
+    static constexpr size_t max_staged_size = 1024 * 1024;
+    bool m_stage_writes = false;
+    std::vector<char> m_staging_buffer;
+    std::vector<std::pair<size_t, size_t>> m_staged_runs;
+
+    void stage_array(size_t pos, const char* data, size_t size, uint32_t checksum);
+    void write_staged_arrays();
+
+    bool m_compress_integers = false;
+
+    bool m_track_writes = false;
+    std::vector<std::pair<size_t, size_t>> m_written_ranges;
+
+    void note_written(size_t pos, size_t size);
+
+    ref_type write_tables(_impl::ArrayWriterBase& out);
 
     void read_in_freelist();
     size_t recreate_freelist(size_t reserve_pos);
@@ -21,100 +21,13 @@
 #include <realm/db.hpp>
 #include <realm/replication.hpp>
 #include <realm/history.hpp>
+#include <realm/impl/in_realm_history.hpp>
 #include <realm/array_key.hpp>
 
 using namespace realm;
 
 
-namespace {
-
-// As new schema versions come into existence, describe them here.
-// 0: legacy version
-// 1: nested collections
-constexpr int g_history_schema_version = 1;
-
-
-/// This class is a basis for implementing the Replication API for the purpose
-/// of supporting continuous transactions.
-///
-/// By ensuring that the root node of the history is correctly configured with
-/// Group::m_top as its parent, this class allows for modifications of the
-/// history as long as those modifications happen after the remainder of the
-/// Group accessor is updated to reflect the new snapshot (see
-/// History::update_early_from_top_ref()).
-class InRealmHistory : public _impl::History {
-public:
-    void initialize(Allocator* alloc)
-    {
-        m_alloc = alloc;
-        m_base_version = 0;
-        m_size = 0;
-        m_changesets = nullptr;
-    }
-
-    Allocator* get_alloc() const
-    {
-        return m_alloc;
-    }
-
-    void set_group(Group* group, bool updated) override
-    {
-        _impl::History::set_group(group, updated);
-        if (m_changesets)
-            _impl::GroupFriend::set_history_parent(*m_group, *m_changesets);
-    }
-
-    void prepare_for_write()
-    {
-        if (!m_changesets) {
-            using gf = _impl::GroupFriend;
-            m_changesets = std::make_unique<BinaryColumn>(*m_alloc); // Throws
-            gf::prepare_history_parent(*m_group, *m_changesets, Replication::hist_InRealm, g_history_schema_version,
-                                       0); // Throws
-            m_changesets->create();
-        }
-    }
-    /// Must never be called more than once per transaction. Returns the version
-    /// produced by the added changeset.
-    version_type add_changeset(BinaryData);
-
-    void update_from_parent(version_type) override;
-    void update_from_ref_and_version(ref_type, version_type) override;
-    // void update_early_from_top_ref(version_type, size_t, ref_type) override;
-    // void update_from_parent(version_type) override;
-    void get_changesets(version_type, version_type, BinaryIterator*) const noexcept override;
-    void set_oldest_bound_version(version_type) override;
-
-    void verify() const override;
-
-private:
-    Allocator* m_alloc = nullptr;
-    /// Version on which the first changeset in the history is based, or if the
-    /// history is empty, the version associated with currently bound
-    /// snapshot. In general, the version associated with currently bound
-    /// snapshot is equal to `m_base_version + m_size`, but after
-    /// add_changeset() is called, it is equal to one minus that.
-    version_type m_base_version = 0;
-
-    /// Current number of entries in the history. A cache of
-    /// `m_changesets->size()`.
-    size_t m_size = 0;
-
-    /// A list of changesets, one for each entry in the history. If null, the
-    /// history is empty.
-    ///
-    /// FIXME: Ideally, the B+tree accessor below should have been just
-    /// Bptree<BinaryData>, but Bptree<BinaryData> seems to not allow that yet.
-    ///
-    /// FIXME: The memory-wise indirection is an unfortunate consequence of the
-    /// fact that it is impossible to construct a BinaryColumn without already
-    /// having a ref to a valid underlying node structure. This, in turn, is an
-    /// unfortunate consequence of the fact that a column accessor contains a
-    /// dynamically allocated root node accessor, and the type of the required
-    /// root node accessor depends on the size of the B+-tree.
-    std::unique_ptr<BinaryColumn> m_changesets;
-};
-
+namespace realm::_impl {
 
 InRealmHistory::version_type InRealmHistory::add_changeset(BinaryData changeset)
 {
@@ -208,6 +121,12 @@ void InRealmHistory::update_from_ref_and_version(ref_type ref, version_type vers
     }
 }
 
+} // namespace realm::_impl
+
+
+namespace {
+
+using _impl::InRealmHistory;
 
 class InRealmHistoryImpl : public Replication {
 public:
@@ -235,7 +154,7 @@ public:
 
     int get_history_schema_version() const noexcept override
     {
-        return g_history_schema_version;
+        return InRealmHistory::schema_version;
     }
 
     bool is_upgradable_history_schema(int stored_schema_version) const noexcept override
@@ -0,0 +1,119 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_IMPL_IN_REALM_HISTORY_HPP
+#define REALM_IMPL_IN_REALM_HISTORY_HPP
+
+#include <realm/column_binary.hpp>
+#include <realm/group.hpp>
+#include <realm/impl/cont_transact_hist.hpp>
+#include <realm/replication.hpp>
+
+#include <memory>
+
+namespace realm::_impl {
+
+/// This class is a basis for implementing the Replication API for the purpose
+/// of supporting continuous transactions.
+///
+/// By ensuring that the root node of the history is correctly configured with
+/// Group::m_top as its parent, this class allows for modifications of the
+/// history as long as those modifications happen after the remainder of the
+/// Group accessor is updated to reflect the new snapshot (see
+/// History::update_early_from_top_ref()).
+class InRealmHistory : public History {
+public:
+    // As new schema versions come into existence, describe them here.
+    // 0: legacy version
+    // 1: nested collections
+    static constexpr int schema_version = 1;
+
+    void initialize(Allocator* alloc)
+    {
+        m_alloc = alloc;
+        m_base_version = 0;
+        m_size = 0;
+        m_changesets = nullptr;
+    }
+
+    Allocator* get_alloc() const
+    {
+        return m_alloc;
+    }
+
+    void set_group(Group* group, bool updated) override
+    {
+        History::set_group(group, updated);
+        if (m_changesets)
+            GroupFriend::set_history_parent(*m_group, *m_changesets);
+    }
+
+    void prepare_for_write()
+    {
+        if (!m_changesets) {
+            using gf = GroupFriend;
+            m_changesets = std::make_unique<BinaryColumn>(*m_alloc); // Throws
+            gf::prepare_history_parent(*m_group, *m_changesets, Replication::hist_InRealm, schema_version,
+                                       0); // Throws
+            m_changesets->create();
+        }
+    }
+    /// Must never be called more than once per transaction. Returns the version
+    /// produced by the added changeset.
+    version_type add_changeset(BinaryData);
+
+    void update_from_parent(version_type) override;
+    void update_from_ref_and_version(ref_type, version_type) override;
+    // void update_early_from_top_ref(version_type, size_t, ref_type) override;
+    // void update_from_parent(version_type) override;
+    void get_changesets(version_type, version_type, BinaryIterator*) const noexcept override;
+    void set_oldest_bound_version(version_type) override;
+
+    void verify() const override;
+
+private:
+    Allocator* m_alloc = nullptr;
+    /// Version on which the first changeset in the history is based, or if the
+    /// history is empty, the version associated with currently bound
+    /// snapshot. In general, the version associated with currently bound
+    /// snapshot is equal to `m_base_version + m_size`, but after
+    /// add_changeset() is called, it is equal to one minus that.
+    version_type m_base_version = 0;
+
+    /// Current number of entries in the history. A cache of
+    /// `m_changesets->size()`.
+    size_t m_size = 0;
+
+    /// A list of changesets, one for each entry in the history. If null, the
+    /// history is empty.
+    ///
+    /// FIXME: Ideally, the B+tree accessor below should have been just
+    /// Bptree<BinaryData>, but Bptree<BinaryData> seems to not allow that yet.
+    ///
+    /// FIXME: The memory-wise indirection is an unfortunate consequence of the
+    /// fact that it is impossible to construct a BinaryColumn without already
+    /// having a ref to a valid underlying node structure. This, in turn, is an
+    /// unfortunate consequence of the fact that a column accessor contains a
+    /// dynamically allocated root node accessor, and the type of the required
+    /// root node accessor depends on the size of the B+-tree.
+    std::unique_ptr<BinaryColumn> m_changesets;
+};
+
+} // namespace realm::_impl
+
+#endif // REALM_IMPL_IN_REALM_HISTORY_HPP
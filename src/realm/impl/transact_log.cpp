@@ -26,9 +26,37 @@ bool TransactLogEncoder::select_table(TableKey key)
 {
     size_t levels = 0;
     append_simple_instr(instr_SelectTable, levels, key.value); // Throws
+
+    auto tables_end = m_summary_tables.begin() + m_num_summary_tables;
+    if (!m_too_many_tables && std::find(m_summary_tables.begin(), tables_end, key) == tables_end) {
+        if (m_num_summary_tables < max_summary_tables)
+            m_summary_tables[m_num_summary_tables++] = key;
+        else
+            m_too_many_tables = true;
+    }
     return true;
 }
 
+char* TransactLogEncoder::write_summary(char* end, size_t body_size) const noexcept
+{
+    if (m_too_many_tables)
+        return nullptr;
+
+    char buffer[max_summary_size];
+    char* ptr = buffer;
+    *ptr++ = char(instr_ChangesetSummary);
+    ptr = encode_int(ptr, body_size);
+    ptr = encode_int(ptr, int(m_schema_changed));
+    ptr = encode_int(ptr, m_num_summary_tables);
+    for (size_t i = 0; i < m_num_summary_tables; ++i)
+        ptr = encode_int(ptr, m_summary_tables[i].value);
+    // The flag and the number of tables take one byte each, and a table key
+    // at most five
+    static_assert(1 + max_enc_bytes_per_int + 2 + max_summary_tables * 5 <= max_summary_size);
+
+    return std::copy_backward(buffer, ptr, end);
+}
+
 bool TransactLogEncoder::select_collection(ColKey col_key, ObjKey key, const StablePath& path)
 {
     auto path_size = path.size();
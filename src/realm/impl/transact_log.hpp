@@ -80,6 +80,12 @@ enum Instruction {
 
     // This instruction includes a path to the collection
     instr_SelectCollectionByPath = 45,
+
+    // Written in front of the instructions of a changeset by
+    // Replication::prepare_commit(). It holds the size of the rest of the
+    // changeset, whether it changes the schema and the tables it selects, so
+    // that a parser can skip changesets which do not matter to its handler.
+    instr_ChangesetSummary = 46,
 };
 
 class TransactLogStream {
@@ -268,6 +274,19 @@ public:
         return m_transact_log_free_begin;
     }
 
+    /// The space the summary of a changeset may need.
+    static constexpr size_t max_summary_size = 64;
+
+    /// Forget the tables and schema changes recorded for the summary of the
+    /// changeset. Must be called when a new changeset is begun.
+    void reset_summary() noexcept;
+
+    /// Write an instr_ChangesetSummary for the instructions encoded since
+    /// reset_summary(), which are the `body_size` bytes starting at `end`,
+    /// such that it ends at `end`. Returns where it begins, or nullptr if the
+    /// changeset selects too many tables for the summary to be useful.
+    char* write_summary(char* end, size_t body_size) const noexcept;
+
 private:
     // Make sure this is in agreement with the actual integer encoding
     // scheme (see encode_int()).
@@ -281,6 +300,12 @@ private:
 
     TransactLogStream& m_stream;
 
+    static constexpr size_t max_summary_tables = 8;
+    std::array<TableKey, max_summary_tables> m_summary_tables;
+    size_t m_num_summary_tables = 0;
+    bool m_too_many_tables = false;
+    bool m_schema_changed = false;
+
     // These two delimit a contiguous region of free space in a
     // transaction log buffer following the last written data. It may
     // be empty.
@@ -330,6 +355,10 @@ private:
     static char* encode_int(char*, T value);
 
     void encode_string(StringData string);
+    void schema_changed() noexcept
+    {
+        m_schema_changed = true;
+    }
 
     friend class TransactLogParser;
 };
@@ -338,11 +367,17 @@ private:
 class TransactLogParser {
 public:
     /// See `TransactLogEncoder` for a list of methods that the `InstructionHandler` must define.
+    ///
+    /// In addition, the handler may define `bool ignores_tables(const
+    /// std::vector<TableKey>&)`. Changesets which do not change the schema,
+    /// and only select tables for which it returns true, are then skipped
+    /// without being decoded.
     template <class InstructionHandler>
     void parse(util::InputStream&, InstructionHandler&);
 
 private:
     util::Buffer<char> m_input_buffer{1024};
+    std::vector<TableKey> m_summary_tables;
 
     // The input stream is assumed to consist of chunks of memory organised such that
     // every instruction resides in a single chunk only.
@@ -367,6 +402,7 @@ private:
     T read_int();
 
     void read_bytes(char* data, size_t size);
+    void skip_bytes(size_t size);
     BinaryData read_buffer(std::string&, size_t size);
 
     StringData read_string(std::string&);
@@ -377,6 +413,11 @@ private:
 
     // return true if input was available
     bool read_char(char&); // throws
+
+    template <class H, class = void>
+    struct CanIgnoreTables : std::false_type {};
+    template <class H>
+    struct CanIgnoreTables<H, std::void_t<decltype(&H::ignores_tables)>> : std::true_type {};
 };
 
 
@@ -428,6 +469,13 @@ inline void TransactLogEncoder::set_buffer(char* free_begin, char* free_end)
     m_transact_log_free_end = free_end;
 }
 
+inline void TransactLogEncoder::reset_summary() noexcept
+{
+    m_num_summary_tables = 0;
+    m_too_many_tables = false;
+    m_schema_changed = false;
+}
+
 inline char* TransactLogEncoder::reserve(size_t n)
 {
     if (size_t(m_transact_log_free_end - m_transact_log_free_begin) < n) {
@@ -588,36 +636,42 @@ void TransactLogEncoder::append_string_instr(Instruction instr, StringData strin
 inline bool TransactLogEncoder::insert_group_level_table(TableKey table_key)
 {
     append_simple_instr(instr_InsertGroupLevelTable, table_key); // Throws
+    schema_changed();
     return true;
 }
 
 inline bool TransactLogEncoder::erase_class(TableKey table_key)
 {
     append_simple_instr(instr_EraseGroupLevelTable, table_key); // Throws
+    schema_changed();
     return true;
 }
 
 inline bool TransactLogEncoder::rename_class(TableKey table_key)
 {
     append_simple_instr(instr_RenameGroupLevelTable, table_key); // Throws
+    schema_changed();
     return true;
 }
 
 inline bool TransactLogEncoder::insert_column(ColKey col_key)
 {
     append_simple_instr(instr_InsertColumn, col_key); // Throws
+    schema_changed();
     return true;
 }
 
 inline bool TransactLogEncoder::erase_column(ColKey col_key)
 {
     append_simple_instr(instr_EraseColumn, col_key); // Throws
+    schema_changed();
     return true;
 }
 
 inline bool TransactLogEncoder::rename_column(ColKey col_key)
 {
     append_simple_instr(instr_RenameColumn, col_key); // Throws
+    schema_changed();
     return true;
 }
 
@@ -668,6 +722,7 @@ inline bool TransactLogEncoder::collection_clear(size_t old_size)
 inline bool TransactLogEncoder::typed_link_change(ColKey col, TableKey dest)
 {
     append_simple_instr(instr_TypedLinkChange, col, dest);
+    schema_changed();
     return true;
 }
 
@@ -845,6 +900,19 @@ void TransactLogParser::parse_one(InstructionHandler& handler)
                 parser_error();
             return;
         }
+        case instr_ChangesetSummary: {
+            size_t body_size = read_int<size_t>();  // Throws
+            bool schema_changed = read_int<int>();  // Throws
+            size_t num_tables = read_int<size_t>(); // Throws
+            m_summary_tables.clear();
+            for (size_t i = 0; i < num_tables; ++i)
+                m_summary_tables.push_back(TableKey(read_int<uint32_t>())); // Throws
+            if constexpr (CanIgnoreTables<InstructionHandler>::value) {
+                if (!schema_changed && handler.ignores_tables(m_summary_tables))
+                    skip_bytes(body_size); // Throws
+            }
+            return;
+        }
     }
 
     parser_error();
@@ -907,6 +975,19 @@ inline void TransactLogParser::read_bytes(char* data, size_t size)
     m_input_begin = to;
 }
 
+inline void TransactLogParser::skip_bytes(size_t size)
+{
+    for (;;) {
+        const size_t avail = m_input_end - m_input_begin;
+        if (size <= avail)
+            break;
+        if (!next_input_buffer())
+            parser_error();
+        size -= avail;
+    }
+    m_input_begin += size;
+}
+
 inline BinaryData TransactLogParser::read_buffer(std::string& buf, size_t size)
 {
     const size_t avail = m_input_end - m_input_begin;
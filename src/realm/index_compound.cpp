@@ -0,0 +1,252 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/index_compound.hpp>
+#include <realm/table.hpp>
+
+#include <algorithm>
+
+using namespace realm;
+
+CompoundIndex::CompoundIndex(const Table& table, const std::vector<ColKey>& columns, Allocator& alloc)
+    : m_table(table)
+    , m_top(alloc)
+    , m_keys(alloc)
+    , m_columns(columns)
+{
+    m_top.create(Array::type_HasRefs, false, 2, 0); // Throws
+    Array cols(alloc);
+    cols.set_parent(&m_top, s_columns_ndx);
+    cols.create(Array::type_Normal); // Throws
+    cols.update_parent();
+    for (auto col : columns) {
+        cols.add(col.value); // Throws
+    }
+    m_keys.set_parent(&m_top, s_keys_ndx);
+    m_keys.create(); // Throws
+}
+
+CompoundIndex::CompoundIndex(ref_type ref, ArrayParent* parent, size_t ndx_in_parent, const Table& table,
+                             Allocator& alloc)
+    : m_table(table)
+    , m_top(alloc)
+    , m_keys(alloc)
+{
+    m_top.init_from_ref(ref);
+    m_top.set_parent(parent, ndx_in_parent);
+    m_keys.set_parent(&m_top, s_keys_ndx);
+    m_keys.init_from_parent();
+    load_columns();
+}
+
+bool CompoundIndex::type_supported(ColKey col)
+{
+    if (col.is_collection())
+        return false;
+    switch (col.get_type()) {
+        case col_type_Int:
+        case col_type_Bool:
+        case col_type_String:
+        case col_type_Timestamp:
+        case col_type_ObjectId:
+        case col_type_UUID:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void CompoundIndex::load_columns()
+{
+    Array cols(m_top.get_alloc());
+    cols.init_from_ref(m_top.get_as_ref(s_columns_ndx));
+    m_columns.clear();
+    for (size_t i = 0; i < cols.size(); ++i) {
+        m_columns.push_back(ColKey(cols.get(i)));
+    }
+}
+
+void CompoundIndex::update_from_parent() noexcept
+{
+    m_top.update_from_parent();
+    m_keys.init_from_parent();
+}
+
+void CompoundIndex::refresh_accessor_tree()
+{
+    m_top.init_from_parent();
+    m_keys.init_from_parent();
+    load_columns();
+}
+
+void CompoundIndex::destroy() noexcept
+{
+    m_top.destroy_deep();
+}
+
+bool CompoundIndex::covers(ColKey col) const noexcept
+{
+    return std::find(m_columns.begin(), m_columns.end(), col) != m_columns.end();
+}
+
+void CompoundIndex::get_values(ObjKey key, std::vector<Mixed>& values) const
+{
+    const Obj obj = m_table.get_object(key);
+    values.clear();
+    for (auto col : m_columns) {
+        values.push_back(obj.get_any(col));
+    }
+}
+
+// Compare the entry at `ndx` with the (possibly partial) tuple `values`. If
+// `key` is given, entries with equal tuples are ordered by key.
+int CompoundIndex::compare(size_t ndx, const std::vector<Mixed>& values, ObjKey key) const
+{
+    ObjKey k = get(ndx);
+    const Obj obj = m_table.get_object(k);
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (int c = obj.get_any(m_columns[i]).compare(values[i]))
+            return c;
+    }
+    if (key)
+        return (k < key) ? -1 : (key < k ? 1 : 0);
+    return 0;
+}
+
+// Position of the first entry ordered at or after (values, key)
+size_t CompoundIndex::find_position(const std::vector<Mixed>& values, ObjKey key) const
+{
+    size_t lo = 0;
+    size_t hi = size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compare(mid, values, key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Position of the first entry with a tuple ordered after `values`
+size_t CompoundIndex::upper_bound(const std::vector<Mixed>& values) const
+{
+    size_t lo = 0;
+    size_t hi = size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compare(mid, values, ObjKey()) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void CompoundIndex::build()
+{
+    REALM_ASSERT(size() == 0);
+    std::vector<std::pair<std::vector<Mixed>, ObjKey>> entries;
+    entries.reserve(m_table.size());
+    for (auto& obj : m_table) {
+        std::vector<Mixed> values;
+        values.reserve(m_columns.size());
+        for (auto col : m_columns) {
+            values.push_back(obj.get_any(col));
+        }
+        entries.emplace_back(std::move(values), obj.get_key());
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        for (size_t i = 0; i < a.first.size(); ++i) {
+            if (int c = a.first[i].compare(b.first[i]))
+                return c < 0;
+        }
+        return a.second < b.second;
+    });
+    for (auto& entry : entries) {
+        m_keys.add(entry.second.value); // Throws
+    }
+}
+
+void CompoundIndex::insert(ObjKey key)
+{
+    std::vector<Mixed> values;
+    get_values(key, values);
+    // Appending in order is the common case, so check the last entry first
+    size_t sz = size();
+    if (sz == 0 || compare(sz - 1, values, key) < 0) {
+        m_keys.add(key.value);
+        return;
+    }
+    m_keys.insert(find_position(values, key), key.value);
+}
+
+void CompoundIndex::set(ObjKey key, ColKey col, Mixed new_value)
+{
+    std::vector<Mixed> values;
+    get_values(key, values);
+    size_t ndx = find_position(values, key);
+    REALM_ASSERT_3(ndx, <, size());
+    REALM_ASSERT(get(ndx) == key);
+
+    auto it = std::find(m_columns.begin(), m_columns.end(), col);
+    REALM_ASSERT(it != m_columns.end());
+    Mixed& value = values[it - m_columns.begin()];
+    if (value.compare(new_value) == 0)
+        return;
+    value = new_value;
+
+    m_keys.erase(ndx);
+    m_keys.insert(find_position(values, key), key.value);
+}
+
+void CompoundIndex::erase(ObjKey key)
+{
+    std::vector<Mixed> values;
+    get_values(key, values);
+    size_t ndx = find_position(values, key);
+    REALM_ASSERT_3(ndx, <, size());
+    REALM_ASSERT(get(ndx) == key);
+    m_keys.erase(ndx);
+}
+
+void CompoundIndex::clear()
+{
+    m_keys.clear();
+}
+
+std::pair<size_t, size_t> CompoundIndex::find_prefix(const std::vector<Mixed>& values) const
+{
+    REALM_ASSERT(values.size() <= m_columns.size());
+    return {find_position(values, ObjKey()), upper_bound(values)};
+}
+
+void CompoundIndex::verify() const
+{
+#ifdef REALM_DEBUG
+    m_top.verify();
+    m_keys.verify();
+    REALM_ASSERT(m_columns.size() >= min_columns && m_columns.size() <= max_columns);
+    REALM_ASSERT(size() == m_table.size());
+    std::vector<Mixed> values;
+    for (size_t i = 1; i < size(); ++i) {
+        get_values(get(i), values);
+        REALM_ASSERT(compare(i - 1, values, get(i)) < 0);
+    }
+#endif
+}
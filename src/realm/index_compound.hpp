@@ -0,0 +1,115 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_INDEX_COMPOUND_HPP
+#define REALM_INDEX_COMPOUND_HPP
+
+#include <realm/column_integer.hpp>
+#include <realm/mixed.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace realm {
+
+class Table;
+
+/// An index over two or more columns of a table. It keeps the keys of all
+/// objects ordered by the tuple of values in the indexed columns (compared as
+/// by Mixed::compare()), with objects having equal tuples ordered by key.
+///
+/// This allows the objects matching equality conditions on any prefix of the
+/// indexed columns to be found as one contiguous range.
+///
+/// The index is stored as a top array holding a ref to an array of the column
+/// keys, and a ref to a B+-tree of object keys. The values themselves are not
+/// duplicated in the index, but looked up in the table when needed.
+class CompoundIndex {
+public:
+    static constexpr size_t min_columns = 2;
+    static constexpr size_t max_columns = 4;
+
+    /// Create a new, empty index
+    CompoundIndex(const Table& table, const std::vector<ColKey>& columns, Allocator&);
+    /// Attach to an existing index
+    CompoundIndex(ref_type, ArrayParent*, size_t ndx_in_parent, const Table& table, Allocator&);
+
+    static bool type_supported(ColKey col);
+
+    ref_type get_ref() const noexcept
+    {
+        return m_top.get_ref();
+    }
+    void set_parent(ArrayParent* parent, size_t ndx_in_parent) noexcept
+    {
+        m_top.set_parent(parent, ndx_in_parent);
+    }
+    void update_from_parent() noexcept;
+    void refresh_accessor_tree();
+    void destroy() noexcept;
+
+    const std::vector<ColKey>& get_columns() const noexcept
+    {
+        return m_columns;
+    }
+    bool covers(ColKey col) const noexcept;
+
+    /// Add all objects of the table to an empty index
+    void build();
+    /// Called after the object has been created
+    void insert(ObjKey key);
+    /// Called before the value of `col` of the object is changed
+    void set(ObjKey key, ColKey col, Mixed new_value);
+    /// Called before the object is removed
+    void erase(ObjKey key);
+    void clear();
+
+    size_t size() const noexcept
+    {
+        return m_keys.size();
+    }
+    ObjKey get(size_t ndx) const
+    {
+        return ObjKey(m_keys.get(ndx));
+    }
+
+    /// Return the range [begin, end) of positions holding the objects for which
+    /// the first `values.size()` indexed columns are equal to `values`.
+    std::pair<size_t, size_t> find_prefix(const std::vector<Mixed>& values) const;
+
+    void verify() const;
+
+private:
+    const Table& m_table;
+    Array m_top;
+    IntegerColumn m_keys;
+    std::vector<ColKey> m_columns;
+
+    static constexpr size_t s_columns_ndx = 0;
+    static constexpr size_t s_keys_ndx = 1;
+
+    void load_columns();
+    void get_values(ObjKey key, std::vector<Mixed>& values) const;
+    int compare(size_t ndx, const std::vector<Mixed>& values, ObjKey key) const;
+    size_t find_position(const std::vector<Mixed>& values, ObjKey key) const;
+    size_t upper_bound(const std::vector<Mixed>& values) const;
+};
+
+} // namespace realm
+
+#endif // REALM_INDEX_COMPOUND_HPP
@@ -0,0 +1,193 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/index_geo.hpp>
+#include <realm/table.hpp>
+
+#if REALM_ENABLE_GEOSPATIAL
+#include <realm/geospatial.hpp>
+#endif
+
+#include <algorithm>
+
+using namespace realm;
+
+GeoIndex::GeoIndex(const Table& table, ColKey type_col, ColKey coords_col, Allocator& alloc)
+    : m_table(table)
+    , m_top(alloc)
+    , m_cells(alloc)
+    , m_keys(alloc)
+    , m_type_col(type_col)
+    , m_coords_col(coords_col)
+{
+    m_top.create(Array::type_HasRefs, false, 3, 0); // Throws
+    Array cols(alloc);
+    cols.set_parent(&m_top, s_columns_ndx);
+    cols.create(Array::type_Normal); // Throws
+    cols.update_parent();
+    cols.add(type_col.value);   // Throws
+    cols.add(coords_col.value); // Throws
+    m_cells.set_parent(&m_top, s_cells_ndx);
+    m_cells.create(); // Throws
+    m_keys.set_parent(&m_top, s_keys_ndx);
+    m_keys.create(); // Throws
+}
+
+GeoIndex::GeoIndex(ref_type ref, ArrayParent* parent, size_t ndx_in_parent, const Table& table, Allocator& alloc)
+    : m_table(table)
+    , m_top(alloc)
+    , m_cells(alloc)
+    , m_keys(alloc)
+{
+    m_top.init_from_ref(ref);
+    m_top.set_parent(parent, ndx_in_parent);
+    m_cells.set_parent(&m_top, s_cells_ndx);
+    m_cells.init_from_parent();
+    m_keys.set_parent(&m_top, s_keys_ndx);
+    m_keys.init_from_parent();
+    load_columns();
+}
+
+void GeoIndex::load_columns()
+{
+    Array cols(m_top.get_alloc());
+    cols.init_from_ref(m_top.get_as_ref(s_columns_ndx));
+    m_type_col = ColKey(cols.get(0));
+    m_coords_col = ColKey(cols.get(1));
+}
+
+void GeoIndex::update_from_parent() noexcept
+{
+    m_top.update_from_parent();
+    m_cells.init_from_parent();
+    m_keys.init_from_parent();
+}
+
+void GeoIndex::refresh_accessor_tree()
+{
+    m_top.init_from_parent();
+    m_cells.init_from_parent();
+    m_keys.init_from_parent();
+    load_columns();
+}
+
+void GeoIndex::destroy() noexcept
+{
+    m_top.destroy_deep();
+}
+
+std::optional<int64_t> GeoIndex::get_cell(ObjKey key) const
+{
+#if REALM_ENABLE_GEOSPATIAL
+    const Obj obj = m_table.get_object(key);
+    if (auto cell_id = GeoRegion::get_cell_id(Geospatial::point_from_obj(obj, m_type_col, m_coords_col)))
+        return to_stored(*cell_id);
+#else
+    static_cast<void>(key);
+#endif
+    return {};
+}
+
+// Position of the first entry ordered at or after (cell, key)
+size_t GeoIndex::find_position(int64_t cell, ObjKey key) const
+{
+    size_t lo = 0;
+    size_t hi = size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int64_t c = m_cells.get(mid);
+        if (c < cell || (c == cell && get(mid) < key))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void GeoIndex::build()
+{
+    REALM_ASSERT(size() == 0);
+    std::vector<std::pair<int64_t, ObjKey>> entries;
+    for (auto& obj : m_table) {
+        if (auto cell = get_cell(obj.get_key()))
+            entries.emplace_back(*cell, obj.get_key());
+    }
+    std::sort(entries.begin(), entries.end());
+    for (auto& entry : entries) {
+        m_cells.add(entry.first);        // Throws
+        m_keys.add(entry.second.value); // Throws
+    }
+}
+
+void GeoIndex::insert(ObjKey key)
+{
+    auto cell = get_cell(key);
+    if (!cell)
+        return;
+    size_t ndx = find_position(*cell, key);
+    m_cells.insert(ndx, *cell);     // Throws
+    m_keys.insert(ndx, key.value); // Throws
+}
+
+void GeoIndex::erase(ObjKey key)
+{
+    auto cell = get_cell(key);
+    if (!cell)
+        return;
+    size_t ndx = find_position(*cell, key);
+    REALM_ASSERT_3(ndx, <, size());
+    REALM_ASSERT(get(ndx) == key);
+    m_cells.erase(ndx);
+    m_keys.erase(ndx);
+}
+
+void GeoIndex::clear()
+{
+    m_cells.clear();
+    m_keys.clear();
+}
+
+void GeoIndex::find_range(uint64_t first, uint64_t last, std::vector<ObjKey>& keys) const
+{
+    int64_t end = to_stored(last);
+    // The null key is ordered before the keys of all live objects
+    size_t sz = size();
+    for (size_t ndx = find_position(to_stored(first), ObjKey()); ndx < sz && m_cells.get(ndx) <= end; ++ndx) {
+        keys.push_back(get(ndx));
+    }
+}
+
+void GeoIndex::verify() const
+{
+#ifdef REALM_DEBUG
+    m_top.verify();
+    m_cells.verify();
+    m_keys.verify();
+    REALM_ASSERT(m_cells.size() == m_keys.size());
+    REALM_ASSERT(size() <= m_table.size());
+    for (size_t i = 0; i < size(); ++i) {
+        ObjKey key = get(i);
+        auto cell = get_cell(key);
+        REALM_ASSERT(cell && *cell == m_cells.get(i));
+        if (i > 0) {
+            int64_t prev = m_cells.get(i - 1);
+            REALM_ASSERT(prev < *cell || (prev == *cell && get(i - 1) < key));
+        }
+    }
+#endif
+}
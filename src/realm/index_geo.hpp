@@ -0,0 +1,115 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_INDEX_GEO_HPP
+#define REALM_INDEX_GEO_HPP
+
+#include <realm/column_integer.hpp>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace realm {
+
+class Table;
+
+/// An index over the points stored in an embedded table holding geospatial
+/// points, i.e. having a "type" and a "coordinates" column. Each valid point
+/// is mapped to the id of the S2 leaf cell holding it, and the keys of the
+/// objects are kept ordered by (cell id, key). Cell ids follow a space
+/// filling curve, so all the points inside a cell at any level are found as
+/// one contiguous range, and a region is searched by looking up the ranges of
+/// the cells covering it. Objects not holding a valid point are not indexed.
+///
+/// The index is stored as a top array holding a ref to an array of the column
+/// keys of the type and coordinates columns, and refs to two B+-trees of the
+/// same size holding the cell ids and the object keys. Cell ids are stored
+/// with the top bit flipped so that they order as signed integers.
+class GeoIndex {
+public:
+    /// Create a new, empty index
+    GeoIndex(const Table& table, ColKey type_col, ColKey coords_col, Allocator&);
+    /// Attach to an existing index
+    GeoIndex(ref_type, ArrayParent*, size_t ndx_in_parent, const Table& table, Allocator&);
+
+    ref_type get_ref() const noexcept
+    {
+        return m_top.get_ref();
+    }
+    void set_parent(ArrayParent* parent, size_t ndx_in_parent) noexcept
+    {
+        m_top.set_parent(parent, ndx_in_parent);
+    }
+    void update_from_parent() noexcept;
+    void refresh_accessor_tree();
+    void destroy() noexcept;
+
+    bool covers(ColKey col) const noexcept
+    {
+        return col == m_type_col || col == m_coords_col;
+    }
+
+    /// Add all objects of the table to an empty index
+    void build();
+    /// Called after the object has been created or its point has changed
+    void insert(ObjKey key);
+    /// Called before the object is removed or its point is changed
+    void erase(ObjKey key);
+    void clear();
+
+    size_t size() const noexcept
+    {
+        return m_keys.size();
+    }
+    ObjKey get(size_t ndx) const
+    {
+        return ObjKey(m_keys.get(ndx));
+    }
+
+    /// Add the keys of the objects having a point in the leaf cells with ids
+    /// in [first, last] to `keys`.
+    void find_range(uint64_t first, uint64_t last, std::vector<ObjKey>& keys) const;
+
+    void verify() const;
+
+private:
+    const Table& m_table;
+    Array m_top;
+    IntegerColumn m_cells;
+    IntegerColumn m_keys;
+    ColKey m_type_col;
+    ColKey m_coords_col;
+
+    static constexpr size_t s_columns_ndx = 0;
+    static constexpr size_t s_cells_ndx = 1;
+    static constexpr size_t s_keys_ndx = 2;
+
+    static int64_t to_stored(uint64_t cell_id) noexcept
+    {
+        return int64_t(cell_id ^ (uint64_t(1) << 63));
+    }
+
+    void load_columns();
+    std::optional<int64_t> get_cell(ObjKey key) const;
+    size_t find_position(int64_t cell, ObjKey key) const;
+};
+
+} // namespace realm
+
+#endif // REALM_INDEX_GEO_HPP
@@ -0,0 +1,389 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/index_sorted.hpp>
+#include <realm/array_unsigned.hpp>
+#include <realm/unicode.hpp>
+
+#include <algorithm>
+
+#ifdef REALM_DEBUG
+#include <iostream>
+#endif
+
+using namespace realm;
+
+SortedIndex::SortedIndex(const ClusterColumn& target_column, Allocator& alloc, bool case_insensitive)
+    : SearchIndex(target_column, &m_top)
+    , m_top(alloc)
+    , m_keys(alloc)
+    , m_case_insensitive(case_insensitive)
+{
+    m_top.create(Array::type_HasRefs, false, 1, 0); // Throws
+    m_keys.set_parent(&m_top, 0);
+    m_keys.create(); // Throws
+}
+
+SortedIndex::SortedIndex(ref_type ref, ArrayParent* parent, size_t ndx_in_parent, const ClusterColumn& target_column,
+                         Allocator& alloc, bool case_insensitive)
+    : SearchIndex(target_column, &m_top)
+    , m_top(alloc)
+    , m_keys(alloc)
+    , m_case_insensitive(case_insensitive)
+{
+    m_top.init_from_ref(ref);
+    m_top.set_parent(parent, ndx_in_parent);
+    m_keys.set_parent(&m_top, 0);
+    m_keys.init_from_parent();
+}
+
+void SortedIndex::refresh_accessor_tree(const ClusterColumn& target_column)
+{
+    SearchIndex::refresh_accessor_tree(target_column);
+    m_keys.init_from_parent();
+}
+
+void SortedIndex::update_from_parent() noexcept
+{
+    SearchIndex::update_from_parent();
+    m_keys.init_from_parent();
+}
+
+Mixed SortedIndex::to_index_value(const Mixed& value, std::string& buffer) const
+{
+    if (!m_case_insensitive || !value.is_type(type_String))
+        return value;
+    buffer = case_map(value.get_string(), false, IgnoreErrors); // Throws
+    return StringData(buffer);
+}
+
+int SortedIndex::compare(size_t ndx, const Mixed& index_value, ObjKey key) const
+{
+    ObjKey k = get(ndx);
+    std::string buffer;
+    int c = to_index_value(m_target_column.get_value(k), buffer).compare(index_value);
+    if (c == 0 && key) {
+        c = (k < key) ? -1 : (key < k ? 1 : 0);
+    }
+    return c;
+}
+
+// Position of the first entry ordered at or after (value, key)
+size_t SortedIndex::find_position(const Mixed& index_value, ObjKey key, size_t begin) const
+{
+    size_t lo = begin;
+    size_t hi = size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compare(mid, index_value, key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Position of the first entry ordered after all entries with the value
+size_t SortedIndex::find_end(const Mixed& index_value, size_t begin) const
+{
+    size_t lo = begin;
+    size_t hi = size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compare(mid, index_value, ObjKey()) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+size_t SortedIndex::find_entry(ObjKey key) const
+{
+    std::string buffer;
+    size_t ndx = find_position(to_index_value(m_target_column.get_value(key), buffer), key);
+    REALM_ASSERT_3(ndx, <, size());
+    REALM_ASSERT(get(ndx) == key);
+    return ndx;
+}
+
+std::pair<size_t, size_t> SortedIndex::find_equal_range(const Mixed& value) const
+{
+    std::string buffer;
+    Mixed index_value = to_index_value(value, buffer);
+    size_t begin = find_position(index_value, ObjKey());
+    return {begin, find_end(index_value, begin)};
+}
+
+size_t SortedIndex::lower_bound(const Mixed& value) const
+{
+    std::string buffer;
+    return find_position(to_index_value(value, buffer), ObjKey());
+}
+
+size_t SortedIndex::upper_bound(const Mixed& value) const
+{
+    std::string buffer;
+    return find_end(to_index_value(value, buffer));
+}
+
+std::pair<size_t, size_t> SortedIndex::find_prefix_range(StringData prefix) const
+{
+    REALM_ASSERT(m_case_insensitive);
+    std::string lower_prefix = case_map(prefix, false, IgnoreErrors);
+    size_t begin = find_position(StringData(lower_prefix), ObjKey());
+
+    // The strings starting with the prefix are the first ones ordered after it
+    size_t lo = begin;
+    size_t hi = size();
+    std::string buffer;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        Mixed value = to_index_value(get_value(mid), buffer);
+        if (value.is_type(type_String) && value.get_string().begins_with(lower_prefix))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return {begin, lo};
+}
+
+void SortedIndex::insert(ObjKey key, const Mixed& value)
+{
+    std::string buffer;
+    Mixed index_value = to_index_value(value, buffer);
+    // Appending in order is the common case, so check the last entry first
+    size_t sz = size();
+    if (sz == 0 || compare(sz - 1, index_value, key) < 0) {
+        m_keys.add(key.value);
+        return;
+    }
+    m_keys.insert(find_position(index_value, key), key.value);
+}
+
+void SortedIndex::set(ObjKey key, const Mixed& new_value)
+{
+    // Called before the column is updated, so the old value can still be used to locate the entry
+    Mixed old_value = m_target_column.get_value(key);
+    std::string old_buffer, new_buffer;
+    if (to_index_value(old_value, old_buffer).compare(to_index_value(new_value, new_buffer)) == 0)
+        return;
+    m_keys.erase(find_entry(key));
+    insert(key, new_value);
+}
+
+void SortedIndex::erase(ObjKey key)
+{
+    m_keys.erase(find_entry(key));
+}
+
+void SortedIndex::clear()
+{
+    m_keys.clear();
+}
+
+bool SortedIndex::is_empty() const
+{
+    return size() == 0;
+}
+
+ObjKey SortedIndex::find_first(const Mixed& value) const
+{
+    // With a case insensitive index, the range may also hold other strings
+    // which are only equal to the value regardless of case
+    auto [begin, end] = find_equal_range(value);
+    for (size_t i = begin; i < end; ++i) {
+        if (!m_case_insensitive || get_value(i) == value)
+            return get(i);
+    }
+    return {};
+}
+
+void SortedIndex::find_all(std::vector<ObjKey>& result, Mixed value, bool case_insensitive) const
+{
+    result.clear();
+    if (case_insensitive && value.is_type(type_String)) {
+        auto upper = case_map(value.get_string(), true);
+        auto lower = case_map(value.get_string(), false);
+        if (!upper || !lower)
+            return;
+        auto matches = [&](const Mixed& v) {
+            return v.is_type(type_String) && equal_case_fold(v.get_string(), upper->c_str(), lower->c_str());
+        };
+        if (m_case_insensitive) {
+            // The candidates are adjacent, and ordered by key
+            auto [begin, end] = find_equal_range(value);
+            for (size_t i = begin; i < end; ++i) {
+                if (matches(get_value(i)))
+                    result.push_back(get(i));
+            }
+            return;
+        }
+        // The ordering is of no help here, so check all entries
+        size_t sz = size();
+        for (size_t i = 0; i < sz; ++i) {
+            if (matches(get_value(i)))
+                result.push_back(get(i));
+        }
+        std::sort(result.begin(), result.end());
+        return;
+    }
+
+    auto [begin, end] = find_equal_range(value);
+    for (size_t i = begin; i < end; ++i) {
+        if (!m_case_insensitive || get_value(i) == value)
+            result.push_back(get(i));
+    }
+}
+
+FindRes SortedIndex::find_all_no_copy(Mixed value, InternalFindResult& result) const
+{
+    auto [begin, end] = find_equal_range(value);
+    if (m_case_insensitive) {
+        // The range can only be returned if it holds no strings differing
+        // from the value by case. The query engine only does exact lookups
+        // through general indexes, so anything else is not expected here.
+        size_t count = 0;
+        ObjKey first;
+        for (size_t i = begin; i < end; ++i) {
+            if (get_value(i) == value && count++ == 0)
+                first = get(i);
+        }
+        if (count == 1) {
+            result.payload = first.value;
+            return FindRes_single;
+        }
+        REALM_ASSERT_RELEASE(count == 0 || count == end - begin);
+    }
+    if (begin == end)
+        return FindRes_not_found;
+    if (end - begin == 1) {
+        result.payload = get(begin).value;
+        return FindRes_single;
+    }
+    // Keys of equal values are ordered, so the range can be used directly
+    result.payload = int64_t(m_keys.get_ref());
+    result.start_ndx = begin;
+    result.end_ndx = end;
+    return FindRes_column;
+}
+
+size_t SortedIndex::count(const Mixed& value) const
+{
+    auto [begin, end] = find_equal_range(value);
+    if (!m_case_insensitive)
+        return end - begin;
+    size_t n = 0;
+    for (size_t i = begin; i < end; ++i) {
+        if (get_value(i) == value)
+            ++n;
+    }
+    return n;
+}
+
+bool SortedIndex::has_duplicate_values() const noexcept
+{
+    size_t sz = size();
+    if (!m_case_insensitive) {
+        for (size_t i = 1; i < sz; ++i) {
+            if (get_value(i - 1) == get_value(i))
+                return true;
+        }
+        return false;
+    }
+
+    // Equal strings are only guaranteed to be in the same run of strings
+    // which are equal regardless of case
+    size_t run_begin = 0;
+    std::string buffer;
+    for (size_t i = 1; i <= sz; ++i) {
+        if (i < sz && compare(i, to_index_value(get_value(run_begin), buffer), ObjKey()) == 0)
+            continue;
+        for (size_t a = run_begin; a < i; ++a) {
+            for (size_t b = a + 1; b < i; ++b) {
+                if (get_value(a) == get_value(b))
+                    return true;
+            }
+        }
+        run_begin = i;
+    }
+    return false;
+}
+
+void SortedIndex::insert_bulk(const ArrayUnsigned* keys, uint64_t key_offset, size_t num_values, ArrayPayload& values)
+{
+    // Holds the lower case strings of a case insensitive index
+    std::vector<std::string> buffers(m_case_insensitive ? num_values : 0);
+    std::string unused;
+    std::vector<std::pair<Mixed, ObjKey>> entries;
+    entries.reserve(num_values);
+    for (size_t i = 0; i < num_values; ++i) {
+        ObjKey key(int64_t(keys ? keys->get(i) + key_offset : i + key_offset));
+        auto& buffer = m_case_insensitive ? buffers[i] : unused;
+        entries.emplace_back(to_index_value(values.get_any(i), buffer), key);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        int c = a.first.compare(b.first);
+        return c < 0 || (c == 0 && a.second < b.second);
+    });
+
+    // As the entries are sorted, each one goes after the previous one
+    size_t pos = 0;
+    for (auto& [value, key] : entries) {
+        size_t sz = size();
+        if (sz == 0 || compare(sz - 1, value, key) < 0) {
+            m_keys.add(key.value);
+            pos = sz + 1;
+        }
+        else {
+            pos = find_position(value, key, pos);
+            m_keys.insert(pos, key.value);
+            ++pos;
+        }
+    }
+}
+
+void SortedIndex::insert_bulk_list(const ArrayUnsigned*, uint64_t, size_t, ArrayInteger&)
+{
+    // Collections can't have a sorted index
+    REALM_UNREACHABLE();
+}
+
+void SortedIndex::verify() const
+{
+#ifdef REALM_DEBUG
+    m_top.verify();
+    m_keys.verify();
+    REALM_ASSERT(m_keys.size() == m_target_column.size());
+    size_t sz = size();
+    std::string buffer;
+    for (size_t i = 1; i < sz; ++i) {
+        REALM_ASSERT(compare(i - 1, to_index_value(get_value(i), buffer), get(i)) < 0);
+    }
+#endif
+}
+
+#ifdef REALM_DEBUG
+void SortedIndex::print() const
+{
+    size_t sz = size();
+    for (size_t i = 0; i < sz; ++i) {
+        std::cout << get(i) << ": " << get_value(i) << std::endl;
+    }
+}
+#endif // REALM_DEBUG
@@ -0,0 +1,159 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_INDEX_SORTED_HPP
+#define REALM_INDEX_SORTED_HPP
+
+#include <realm/column_integer.hpp>
+#include <realm/query_conditions.hpp>
+#include <realm/search_index.hpp>
+
+#include <utility>
+
+namespace realm {
+
+/// A search index which keeps the keys of all objects ordered by the value of
+/// the indexed column. Values are ordered as by Mixed::compare(), so nulls come
+/// first (followed by NaN for float and double columns), and entries with
+/// equal values are ordered by key.
+///
+/// In addition to the equality lookups supported by all search indexes, the
+/// ordering allows range lookups and iteration in value order, which the query
+/// engine uses for range conditions and for sorting.
+///
+/// The index is stored as a top array holding a single ref to a B+-tree of
+/// object keys. The values themselves are not duplicated in the index, but
+/// looked up in the indexed column when needed.
+///
+/// A case insensitive index on a string column orders the strings by their
+/// lower case form, so that strings differing only by case are adjacent. Case
+/// insensitive equality and prefix lookups are then range lookups, while exact
+/// lookups have to check the candidates in the range.
+class SortedIndex : public SearchIndex {
+public:
+    SortedIndex(const ClusterColumn& target_column, Allocator&, bool case_insensitive = false);
+    SortedIndex(ref_type, ArrayParent*, size_t ndx_in_parent, const ClusterColumn& target_column, Allocator&,
+                bool case_insensitive = false);
+
+    static bool type_supported(DataType type)
+    {
+        return (type == type_Int || type == type_String || type == type_Timestamp || type == type_Float ||
+                type == type_Double || type == type_ObjectId);
+    }
+
+    bool is_case_insensitive() const noexcept
+    {
+        return m_case_insensitive;
+    }
+
+    // SearchIndex interface:
+    void insert(ObjKey key, const Mixed& value) final;
+    void set(ObjKey key, const Mixed& new_value) final;
+    ObjKey find_first(const Mixed& value) const final;
+    void find_all(std::vector<ObjKey>& result, Mixed value, bool case_insensitive = false) const final;
+    FindRes find_all_no_copy(Mixed value, InternalFindResult& result) const final;
+    size_t count(const Mixed& value) const final;
+    void erase(ObjKey key) final;
+    void clear() final;
+    bool has_duplicate_values() const noexcept final;
+    bool is_empty() const final;
+    void insert_bulk(const ArrayUnsigned* keys, uint64_t key_offset, size_t num_values,
+                     ArrayPayload& values) final;
+    void insert_bulk_list(const ArrayUnsigned* keys, uint64_t key_offset, size_t num_values,
+                          ArrayInteger& ref_array) final;
+    void verify() const final;
+    void refresh_accessor_tree(const ClusterColumn& target_column) final;
+    void update_from_parent() noexcept final;
+
+#ifdef REALM_DEBUG
+    void print() const final;
+#endif // REALM_DEBUG
+
+    // Ordered access:
+    size_t size() const noexcept
+    {
+        return m_keys.size();
+    }
+    ObjKey get(size_t ndx) const
+    {
+        return ObjKey(m_keys.get(ndx));
+    }
+    Mixed get_value(size_t ndx) const
+    {
+        return m_target_column.get_value(get(ndx));
+    }
+
+    /// Position of the first entry with a value not less than `value`
+    size_t lower_bound(const Mixed& value) const;
+    /// Position of the first entry with a value greater than `value`
+    size_t upper_bound(const Mixed& value) const;
+
+    /// Return the range [begin, end) of positions holding the strings which
+    /// start with `prefix` regardless of case. Requires a case insensitive
+    /// index.
+    std::pair<size_t, size_t> find_prefix_range(StringData prefix) const;
+
+    /// Return the range [begin, end) of positions holding the entries matching
+    /// `Cond` against a non-null `value`. Only Greater, GreaterEqual, Less and
+    /// LessEqual are supported. Nulls never match.
+    template <class Cond>
+    std::pair<size_t, size_t> find_range(const Mixed& value) const;
+
+private:
+    Array m_top;
+    IntegerColumn m_keys;
+    bool m_case_insensitive;
+
+    // The value the index orders `value` by, which for a case insensitive
+    // index is the lower case form of a string, stored in `buffer`
+    Mixed to_index_value(const Mixed& value, std::string& buffer) const;
+
+    // These take values as returned by to_index_value()
+    int compare(size_t ndx, const Mixed& index_value, ObjKey key) const;
+    size_t find_position(const Mixed& index_value, ObjKey key, size_t begin = 0) const;
+    size_t find_end(const Mixed& index_value, size_t begin = 0) const;
+
+    size_t find_entry(ObjKey key) const;
+    // Range of the entries equal to `value`, regardless of case for a case
+    // insensitive index
+    std::pair<size_t, size_t> find_equal_range(const Mixed& value) const;
+};
+
+template <class Cond>
+std::pair<size_t, size_t> SortedIndex::find_range(const Mixed& value) const
+{
+    REALM_ASSERT(!value.is_null());
+    if constexpr (std::is_same_v<Cond, Greater>) {
+        return {upper_bound(value), size()};
+    }
+    else if constexpr (std::is_same_v<Cond, GreaterEqual>) {
+        return {lower_bound(value), size()};
+    }
+    else if constexpr (std::is_same_v<Cond, Less>) {
+        // Nulls are ordered before any other value
+        return {upper_bound(Mixed()), lower_bound(value)};
+    }
+    else {
+        static_assert(std::is_same_v<Cond, LessEqual>, "unsupported condition");
+        return {upper_bound(Mixed()), upper_bound(value)};
+    }
+}
+
+} // namespace realm
+
+#endif // REALM_INDEX_SORTED_HPP
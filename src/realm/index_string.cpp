@@ -16,9 +16,11 @@
  *
  **************************************************************************/
 
+#include <cmath>
 #include <cstdio>
 #include <iomanip>
 #include <list>
+#include <thread>
 
 #ifdef REALM_DEBUG
 #include <iostream>
@@ -107,6 +109,13 @@ Mixed ClusterColumn::get_value(ObjKey key) const
     return obj.get_any(m_column_key);
 }
 
+std::optional<Mixed> ClusterColumn::try_get_value(ObjKey key) const
+{
+    if (const Obj obj{m_cluster_tree->try_get_obj(key)})
+        return obj.get_any(m_column_key);
+    return {};
+}
+
 Lst<String> ClusterColumn::get_list(ObjKey key) const
 {
     const Obj obj{m_cluster_tree->get(key)};
@@ -662,7 +671,8 @@ void IndexArray::index_string_all(const Mixed& value, std::vector<ObjKey>& resul
     }
 }
 
-static void get_all_keys_below(std::set<int64_t>& result, ref_type ref, Allocator& alloc)
+template <class F>
+static void for_all_keys_below(ref_type ref, Allocator& alloc, F&& fn)
 {
     const char* sub_header = alloc.translate(ref_type(ref));
     const bool sub_isindex = NodeHeader::get_context_flag_from_header(sub_header);
@@ -675,21 +685,26 @@ static void get_all_keys_below(std::set<int64_t>& result, ref_type ref, Allocato
             auto rot = tree.get_as_ref_or_tagged(n);
             // Literal row index (tagged)
             if (rot.is_tagged()) {
-                result.insert(rot.get_as_int());
+                fn(rot.get_as_int());
             }
             else {
-                get_all_keys_below(result, rot.get_as_ref(), alloc);
+                for_all_keys_below(rot.get_as_ref(), alloc, fn);
             }
         }
     }
     else {
         IntegerColumn tree(alloc, ref);
-        tree.for_all([&result](int64_t i) {
-            result.insert(i);
-        });
+        tree.for_all(fn);
     }
 }
 
+static void get_all_keys_below(std::set<int64_t>& result, ref_type ref, Allocator& alloc)
+{
+    for_all_keys_below(ref, alloc, [&result](int64_t i) {
+        result.insert(i);
+    });
+}
+
 void IndexArray::_index_string_find_all_prefix(std::set<int64_t>& result, StringData str, const char* header) const
 {
     size_t stringoffset = 0;
@@ -774,6 +789,105 @@ void IndexArray::_index_string_find_all_prefix(std::set<int64_t>& result, String
     }
 }
 
+void IndexArray::find_all_prefix(std::vector<ObjKey>& result, StringData prefix, const ClusterColumn& column,
+                                 const char* header, size_t offset) const
+{
+    const char* data = NodeHeader::get_data_from_header(header);
+    uint_least8_t width = get_width_from_header(header);
+
+    // All the keys of strings having the next (up to) 4 bytes of the prefix
+    // at `offset` are in the range [lower, upper]. As the first byte is fixed,
+    // the range does not wrap around when the keys are compared as signed.
+    constexpr size_t key_length = StringIndex::s_index_key_length;
+    size_t n = std::min(prefix.size() - offset, key_length);
+    bool is_last_chunk = offset + n == prefix.size();
+    uint32_t chunk = 0;
+    for (size_t i = 0; i < n; ++i)
+        chunk = (chunk << 8) | static_cast<unsigned char>(prefix[offset + i]);
+    size_t shift = (key_length - n) * 8;
+    auto lower = int32_t(chunk << shift);
+    auto upper = int32_t((chunk << shift) | uint32_t((uint64_t(1) << shift) - 1));
+
+    const char* offsets_header = m_alloc.translate(to_ref(get_direct(data, width, 0)));
+    const char* offsets_data = get_data_from_header(offsets_header);
+    size_t offsets_size = get_size_from_header(offsets_header);
+    size_t pos = ::lower_bound<32>(offsets_data, offsets_size, lower); // keys are always 32 bits wide
+
+    if (NodeHeader::get_is_inner_bptree_node_from_header(header)) {
+        // The keys are the last keys of each child, so the children holding
+        // the range end with the first one whose last key is past it
+        for (; pos < offsets_size; ++pos) {
+            const char* child_header = m_alloc.translate(to_ref(get_direct(data, width, pos + 1)));
+            find_all_prefix(result, prefix, column, child_header, offset);
+            if (get_direct<32>(offsets_data, pos) > upper)
+                break;
+        }
+        return;
+    }
+
+    size_t end = ::upper_bound<32>(offsets_data, offsets_size, upper); // keys are always 32 bits wide
+    if (pos == end)
+        return;
+
+    auto starts_with_prefix = [&](ObjKey k) {
+        Mixed value = column.get_value(k);
+        return value.is_type(type_String) && value.get_string().begins_with(prefix);
+    };
+
+    if (!is_last_chunk) {
+        // The next 4 bytes are a whole key, so at most one entry matches
+        REALM_ASSERT(end == pos + 1);
+        uint64_t ref = get_direct(data, width, pos + 1);
+        if (ref & 1) {
+            // Only the first bytes of a single string are stored in the index
+            ObjKey k(int64_t(ref >> 1));
+            if (starts_with_prefix(k))
+                result.push_back(k);
+            return;
+        }
+        const char* sub_header = m_alloc.translate(ref_type(ref));
+        if (get_context_flag_from_header(sub_header)) {
+            find_all_prefix(result, prefix, column, sub_header, offset + key_length);
+            return;
+        }
+        // The strings in a list share the bytes up to here, but not
+        // necessarily the rest of the prefix
+        const IntegerColumn sub(m_alloc, ref_type(ref));
+        sub.for_all([&](int64_t k) {
+            if (starts_with_prefix(ObjKey(k)))
+                result.push_back(ObjKey(k));
+        });
+        return;
+    }
+
+    // Every string below the range starts with the prefix, except that a
+    // string ending in this chunk is keyed as if it was followed by 'X', and
+    // null is keyed as zero, so prefixes with those bytes must be checked.
+    // Below the maximum depth, lists may also hold strings which differ.
+    bool must_check = offset >= StringIndex::s_max_offset ||
+                      std::any_of(prefix.data() + offset, prefix.data() + prefix.size(), [](char c) {
+                          return c == 'X' || c == 0;
+                      });
+    size_t first_new = result.size();
+    for (size_t ndx = pos + 1; ndx <= end; ++ndx) {
+        uint64_t ref = get_direct(data, width, ndx);
+        if (ref & 1) {
+            result.push_back(ObjKey(int64_t(ref >> 1)));
+        }
+        else {
+            for_all_keys_below(ref_type(ref), m_alloc, [&](int64_t k) {
+                result.push_back(ObjKey(k));
+            });
+        }
+    }
+    if (must_check) {
+        auto it = std::remove_if(result.begin() + first_new, result.end(), [&](ObjKey k) {
+            return !starts_with_prefix(k);
+        });
+        result.erase(it, result.end());
+    }
+}
+
 ObjKey IndexArray::index_string_find_first(const Mixed& value, const ClusterColumn& column) const
 {
     InternalFindResult unused;
@@ -1342,8 +1456,224 @@ Mixed StringIndex::get(ObjKey key) const
     return m_target_column.get_value(key);
 }
 
+/*
+ * The unique lookup is a hash table over the values of a column in which each
+ * value occurs at most once, mapping each value to the key of its object, so
+ * that primary keys are found without descending the index. It lives in the
+ * accessor only, so the file format is unaffected.
+ *
+ * The table is kept up to date by the insertions made through this accessor.
+ * When an object is erased or its value is changed, the old entry is left in
+ * place, and a lookup only accepts an entry after checking that the object
+ * still exists and has the value looked for. Commits do not change the keys
+ * or values, so the table survives them, while a refresh of the accessor to
+ * another version discards it. As building it costs a pass over the column,
+ * it is only built once enough lookups have been made.
+ */
+struct StringIndex::UniqueLookup {
+    // Each bucket fills a cache line. An empty slot has a null key, and slots
+    // are filled in order, so a probe ends at the first bucket which is not
+    // full.
+    static constexpr size_t slots_per_bucket = 4;
+    struct alignas(64) Bucket {
+        uint64_t hashes[slots_per_bucket];
+        int64_t keys[slots_per_bucket];
+    };
+    static_assert(sizeof(Bucket) == 64);
+
+    std::vector<Bucket> buckets;
+    size_t entries = 0;
+    size_t lookups = 0;
+
+    static uint64_t hash(const Mixed& value) noexcept
+    {
+        uint64_t h = value.hash();
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    bool is_built() const noexcept
+    {
+        return !buckets.empty();
+    }
+
+    void build(const ClusterColumn& column)
+    {
+        size_t capacity = 4;
+        while (capacity * slots_per_bucket < 3 * column.size())
+            capacity <<= 1;
+        buckets.clear();
+        buckets.resize(capacity);
+        for (auto& bucket : buckets)
+            std::fill(std::begin(bucket.keys), std::end(bucket.keys), ObjKey().value);
+        entries = 0;
+        auto col_key = column.get_column_key();
+        for (auto it = column.begin(), end = column.end(); it != end; ++it)
+            insert(hash(it->get_any(col_key)), it->get_key());
+    }
+
+    void insert(uint64_t h, ObjKey key) noexcept
+    {
+        size_t mask = buckets.size() - 1;
+        for (size_t i = size_t(h) & mask;; i = (i + 1) & mask) {
+            Bucket& bucket = buckets[i];
+            for (size_t j = 0; j < slots_per_bucket; ++j) {
+                if (bucket.keys[j] == ObjKey().value) {
+                    bucket.hashes[j] = h;
+                    bucket.keys[j] = key.value;
+                    ++entries;
+                    return;
+                }
+            }
+        }
+    }
+
+    void add(ObjKey key, const Mixed& value, const ClusterColumn& column) noexcept
+    {
+        if (!is_built())
+            return;
+        try {
+            // Keep the table at most half full. Rebuilding it rather than
+            // growing it drops the entries which no longer match.
+            if (2 * (entries + 1) > buckets.size() * slots_per_bucket) {
+                build(column);
+                if (auto existing = find(value, column); existing == key)
+                    return;
+            }
+            insert(hash(value), key);
+        }
+        catch (...) {
+            // The table is only an optimization
+            buckets.clear();
+        }
+    }
+
+    ObjKey find(const Mixed& value, const ClusterColumn& column) const
+    {
+        uint64_t h = hash(value);
+        size_t mask = buckets.size() - 1;
+        for (size_t i = size_t(h) & mask;; i = (i + 1) & mask) {
+            const Bucket& bucket = buckets[i];
+            for (size_t j = 0; j < slots_per_bucket; ++j) {
+                if (bucket.keys[j] == ObjKey().value)
+                    return {};
+                if (bucket.hashes[j] == h) {
+                    ObjKey key(bucket.keys[j]);
+                    if (auto actual = column.try_get_value(key); actual && *actual == value)
+                        return key;
+                }
+            }
+        }
+    }
+};
+
+ObjKey StringIndex::find_unique(const Mixed& value) const
+{
+    if (m_target_column.full_word())
+        return find_first(value);
+    flush_pending();
+
+    size_t size = m_target_column.size();
+    if (size < s_unique_lookup_min_size) {
+        m_unique_lookup.reset();
+        return find_first(value);
+    }
+    if (!m_unique_lookup)
+        m_unique_lookup = std::make_unique<UniqueLookup>();
+    auto& lookup = *m_unique_lookup;
+    if (!lookup.is_built()) {
+        if (++lookup.lookups * s_unique_lookup_factor < size)
+            return find_first(value);
+        try {
+            lookup.build(m_target_column);
+        }
+        catch (...) {
+            // The table is only an optimization
+            m_unique_lookup.reset();
+            return find_first(value);
+        }
+    }
+    return lookup.find(value, m_target_column);
+}
+
+void StringIndex::refresh_accessor_tree(const ClusterColumn& target_column)
+{
+    SearchIndex::refresh_accessor_tree(target_column);
+    // The column may have changed in any way
+    m_unique_lookup.reset();
+    m_pending.clear();
+}
+
+void StringIndex::set_deferred(bool deferred)
+{
+    if (!deferred)
+        apply_pending_updates(); // Throws
+    m_deferred = deferred;
+}
+
+auto StringIndex::add_pending(ObjKey key, bool in_index) -> PendingUpdate&
+{
+    auto [it, inserted] = m_pending.try_emplace(key);
+    if (inserted && in_index) {
+        // The index still holds the value the column has before this change
+        StringConversionBuffer buffer;
+        StringData data = get(key).get_index_data(buffer);
+        it->second.in_index = true;
+        it->second.old_is_null = data.is_null();
+        it->second.old_data.assign(data.data(), data.size());
+    }
+    return it->second;
+}
+
+void StringIndex::apply_pending_updates()
+{
+    if (m_pending.empty())
+        return;
+    m_unique_lookup.reset();
+    auto pending = std::move(m_pending);
+    m_pending.clear();
+
+    StringConversionBuffer buffer;
+    // Values of different types may have the same index data, so only other columns can skip unchanged values
+    bool may_skip = m_target_column.get_column_key().get_type() != col_type_Mixed;
+    std::vector<std::pair<StringData, ObjKey>> erased;
+    std::vector<std::pair<Mixed, ObjKey>> inserted;
+    erased.reserve(pending.size());
+    inserted.reserve(pending.size());
+    for (auto& [key, update] : pending) {
+        StringData old_data(update.old_is_null ? nullptr : update.old_data.data(), update.old_data.size());
+        Mixed new_value;
+        if (!update.erased) {
+            new_value = get(key);
+            if (update.in_index && may_skip && new_value.get_index_data(buffer) == old_data)
+                continue;
+        }
+        if (update.in_index)
+            erased.emplace_back(old_data, key);
+        if (!update.erased)
+            inserted.emplace_back(new_value, key);
+    }
+
+    // All the stale entries are removed before anything is inserted, as inserting compares the new value with the
+    // column values of the objects already in the index
+    std::sort(erased.begin(), erased.end());
+    for (auto& [data, key] : erased)
+        erase_string(key, data); // Throws
+    std::sort(inserted.begin(), inserted.end());
+    for (auto& [value, key] : inserted)
+        insert_with_offset(key, value.get_index_data(buffer), value, 0); // Throws
+}
+
 void StringIndex::erase(ObjKey key)
 {
+    if (is_deferred()) {
+        add_pending(key, true).erased = true; // Throws
+        return;
+    }
     StringConversionBuffer buffer;
     if (m_target_column.full_word()) {
         if (m_target_column.tokenize()) {
@@ -1437,8 +1767,275 @@ struct FindResWrapper {
 };
 } // namespace
 
+// The values of an index being built, as (value, object key) entries. String
+// and binary values are copied, as the leaves they were read from may be
+// gone by the time the index is built.
+class StringIndex::Builder {
+public:
+    void add(ObjKey key, Mixed value);
+    // Returns the ref of the root of the index, or 0 if there are no entries
+    ref_type build(Allocator& alloc);
+
+private:
+    struct Entry {
+        Mixed value;
+        int64_t key;
+    };
+    static constexpr size_t s_block_size = 0x100000;
+    // Below this number of entries they are sorted on one thread
+    static constexpr size_t s_parallel_sort_threshold = 0x10000;
+
+    std::vector<Entry> m_entries;
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char* m_block_pos = nullptr;
+    size_t m_block_free = 0;
+
+    const char* copy_data(const char* data, size_t size);
+    void sort();
+    ref_type build_level(Allocator& alloc, size_t begin, size_t end, size_t offset);
+    ref_type build_list(Allocator& alloc, size_t begin, size_t end);
+
+    // Entries are ordered by the key of each level of the index, then by
+    // value, and then by object key, which is the order of the nodes and lists.
+    static bool less(const Entry& a, const Entry& b) noexcept
+    {
+        StringConversionBuffer buffer_a;
+        StringConversionBuffer buffer_b;
+        StringData data_a = a.value.get_index_data(buffer_a);
+        StringData data_b = b.value.get_index_data(buffer_b);
+        if (data_a != data_b) {
+            // The keys of the levels before the first differing byte are equal
+            size_t offset = 0;
+            if (!data_a.is_null() && !data_b.is_null()) {
+                size_t size = std::min(data_a.size(), data_b.size());
+                size_t pos = std::mismatch(data_a.data(), data_a.data() + size, data_b.data()).first - data_a.data();
+                offset = pos - pos % s_index_key_length;
+            }
+            for (; offset <= s_max_offset; offset += s_index_key_length) {
+                key_type key_a = create_key(data_a, offset);
+                key_type key_b = create_key(data_b, offset);
+                if (key_a != key_b)
+                    return key_a < key_b;
+            }
+        }
+        if (a.value.is_null() != b.value.is_null())
+            return a.value.is_null();
+        int cmp = a.value.compare(b.value);
+        if (cmp != 0)
+            return cmp < 0;
+        return a.key < b.key;
+    }
+};
+
+void StringIndex::Builder::add(ObjKey key, Mixed value)
+{
+    if (value.is_type(type_String)) {
+        StringData str = value.get_string();
+        value = StringData(copy_data(str.data(), str.size()), str.size());
+    }
+    else if (value.is_type(type_Binary)) {
+        BinaryData bin = value.get_binary();
+        value = BinaryData(copy_data(bin.data(), bin.size()), bin.size());
+    }
+    m_entries.push_back({value, key.value});
+}
+
+const char* StringIndex::Builder::copy_data(const char* data, size_t size)
+{
+    if (size == 0)
+        return "";
+    if (size > m_block_free) {
+        size_t block_size = std::max(size, s_block_size);
+        m_blocks.push_back(std::make_unique<char[]>(block_size));
+        m_block_pos = m_blocks.back().get();
+        m_block_free = block_size;
+    }
+    char* copy = m_block_pos;
+    std::memcpy(copy, data, size);
+    m_block_pos += size;
+    m_block_free -= size;
+    return copy;
+}
+
+void StringIndex::Builder::sort()
+{
+    size_t num_threads = std::thread::hardware_concurrency();
+    if (m_entries.size() < s_parallel_sort_threshold || num_threads < 2) {
+        std::sort(m_entries.begin(), m_entries.end(), less);
+        return;
+    }
+
+    // Distribute the entries in place into buckets by the first byte of their
+    // top level key, taken as signed like the key. Each bucket can then be
+    // sorted independently.
+    auto bucket_of = [](const Entry& entry) {
+        StringConversionBuffer buffer;
+        key_type key = create_key(entry.value.get_index_data(buffer), 0);
+        return size_t((key >> 24) + 128);
+    };
+    constexpr size_t num_buckets = 256;
+    std::array<size_t, num_buckets + 1> bucket_begin{};
+    for (auto& entry : m_entries)
+        ++bucket_begin[bucket_of(entry) + 1];
+    for (size_t b = 0; b < num_buckets; ++b)
+        bucket_begin[b + 1] += bucket_begin[b];
+    std::array<size_t, num_buckets> next;
+    std::copy_n(bucket_begin.begin(), num_buckets, next.begin());
+    for (size_t b = 0; b < num_buckets; ++b) {
+        while (next[b] < bucket_begin[b + 1]) {
+            size_t target = bucket_of(m_entries[next[b]]);
+            if (target == b)
+                ++next[b];
+            else
+                std::swap(m_entries[next[b]], m_entries[next[target]++]);
+        }
+    }
+
+    // Give each thread a run of buckets holding about the same number of entries
+    size_t per_thread = m_entries.size() / num_threads + 1;
+    std::vector<std::thread> threads;
+    auto sort_range = [this](size_t begin, size_t end) {
+        std::sort(m_entries.begin() + begin, m_entries.begin() + end, less);
+    };
+    size_t begin = 0;
+    for (size_t b = 1; b <= num_buckets; ++b) {
+        size_t end = bucket_begin[b];
+        if (end - begin < per_thread && b < num_buckets)
+            continue;
+        if (b == num_buckets) {
+            sort_range(begin, end);
+            break;
+        }
+        try {
+            threads.emplace_back(sort_range, begin, end);
+        }
+        catch (const std::system_error&) {
+            sort_range(begin, end);
+        }
+        begin = end;
+    }
+    for (auto& t : threads)
+        t.join();
+}
+
+ref_type StringIndex::Builder::build(Allocator& alloc)
+{
+    if (m_entries.empty())
+        return 0;
+    sort();
+    return build_level(alloc, 0, m_entries.size(), 0);
+}
+
+ref_type StringIndex::Builder::build_level(Allocator& alloc, size_t begin, size_t end, size_t offset)
+{
+    // The children of this level in the order of their keys. Like when values
+    // are inserted one at a time, a single object is stored literally, objects
+    // with the same data or beyond the maximum depth go in a list, and any
+    // others get a subindex for the rest of their data.
+    std::vector<std::pair<key_type, int64_t>> children;
+    StringConversionBuffer buffer;
+    StringConversionBuffer buffer_2;
+    size_t i = begin;
+    while (i < end) {
+        StringData index_data = m_entries[i].value.get_index_data(buffer);
+        key_type key = create_key(index_data, offset);
+        bool same_data = true;
+        size_t j = i + 1;
+        for (; j < end; ++j) {
+            StringData index_data_2 = m_entries[j].value.get_index_data(buffer_2);
+            if (create_key(index_data_2, offset) != key)
+                break;
+            same_data = same_data && index_data_2 == index_data;
+        }
+        int64_t child;
+        if (j - i == 1) {
+            child = int64_t((uint64_t(m_entries[i].key) << 1) + 1); // shift to indicate literal
+        }
+        else if (same_data || offset + s_index_key_length > s_max_offset) {
+            child = int64_t(build_list(alloc, i, j));
+        }
+        else {
+            child = int64_t(build_level(alloc, i, j, offset + s_index_key_length));
+        }
+        children.emplace_back(key, child);
+        i = j;
+    }
+
+    // Fill the leaves of the B-tree of this level, and then the inner nodes
+    // above them, until there is a single root
+    bool is_leaf = true;
+    while (true) {
+        std::vector<std::pair<key_type, int64_t>> nodes;
+        for (size_t n = 0; n < children.size(); n += REALM_MAX_BPNODE_SIZE) {
+            auto node = create_node(alloc, is_leaf);
+            Array keys(alloc);
+            get_child(*node, 0, keys);
+            size_t n_end = std::min(children.size(), n + REALM_MAX_BPNODE_SIZE);
+            for (size_t c = n; c < n_end; ++c) {
+                keys.add(children[c].first);
+                node->add(children[c].second);
+            }
+            nodes.emplace_back(children[n_end - 1].first, int64_t(node->get_ref()));
+        }
+        if (nodes.size() == 1)
+            return ref_type(nodes[0].second);
+        children = std::move(nodes);
+        is_leaf = false;
+    }
+}
+
+ref_type StringIndex::Builder::build_list(Allocator& alloc, size_t begin, size_t end)
+{
+    IntegerColumn list(alloc);
+    list.create();
+    for (size_t i = begin; i < end; ++i)
+        list.add(m_entries[i].key);
+    return list.get_ref();
+}
+
+StringIndex::StringIndex(const ClusterColumn& target_column, std::unique_ptr<IndexArray> root)
+    : SearchIndex(target_column, root.get())
+    , m_array(std::move(root))
+{
+}
+
+StringIndex::~StringIndex() noexcept = default;
+
+void StringIndex::build(util::FunctionRef<void()> insert_values)
+{
+    REALM_ASSERT(is_empty());
+    m_unique_lookup.reset();
+    if (m_target_column.full_word()) {
+        insert_values();
+        return;
+    }
+
+    m_builder = std::make_unique<Builder>();
+    try {
+        insert_values();
+    }
+    catch (...) {
+        m_builder.reset();
+        throw;
+    }
+    std::unique_ptr<Builder> builder = std::move(m_builder);
+    Allocator& alloc = m_array->get_alloc();
+    if (ref_type ref = builder->build(alloc)) {
+        Array::destroy_deep(m_array->get_ref(), alloc);
+        m_array->init_from_ref(ref);
+        m_array->update_parent();
+    }
+}
+
 void StringIndex::insert_bulk(const ArrayUnsigned* keys, uint64_t key_offset, size_t num_values, ArrayPayload& values)
 {
+    if (m_builder) {
+        for (size_t i = 0; i < num_values; ++i) {
+            ObjKey key(int64_t(keys ? keys->get(i) + key_offset : i + key_offset));
+            m_builder->add(key, values.get_any(i));
+        }
+        return;
+    }
     if (keys) {
         for (size_t i = 0; i < num_values; ++i) {
             ObjKey key(keys->get(i) + key_offset);
@@ -1475,6 +2072,32 @@ void StringIndex::insert_bulk_list(const ArrayUnsigned* keys, uint64_t key_offse
 }
 
 
+namespace {
+
+// Returns true if the words of `phrase` follow each other somewhere in the
+// text `info` was made from
+bool contains_phrase(const TokenInfoMap& info, const Phrase& phrase)
+{
+    std::vector<const TokenPositions*> positions;
+    for (auto& word : phrase) {
+        auto it = info.find(word);
+        if (it == info.end())
+            return false;
+        positions.push_back(&it->second.positions);
+    }
+    for (auto start : *positions[0]) {
+        bool match = true;
+        for (size_t i = 1; i < positions.size() && match; ++i) {
+            match = std::binary_search(positions[i]->begin(), positions[i]->end(), start + unsigned(i));
+        }
+        if (match)
+            return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
 void StringIndex::find_all_fulltext(std::vector<ObjKey>& result, StringData value) const
 {
     InternalFindResult res;
@@ -1482,9 +2105,11 @@ void StringIndex::find_all_fulltext(std::vector<ObjKey>& result, StringData valu
 
     auto tokenizer = Tokenizer::get_instance();
     tokenizer->reset({value.data(), value.size()});
-    auto [includes, excludes] = tokenizer->get_search_tokens();
+    auto tokens = tokenizer->get_search_tokens();
+    auto& includes = tokens.includes;
+    auto& excludes = tokens.excludes;
     if (includes.empty()) {
-        if (excludes.empty()) {
+        if (excludes.empty() && tokens.excluded_phrases.empty()) {
             throw InvalidArgument("Missing search token");
         }
         result = m_target_column.get_all_keys();
@@ -1531,12 +2156,39 @@ void StringIndex::find_all_fulltext(std::vector<ObjKey>& result, StringData valu
         }
     }
 
-    for (auto& token : excludes) {
-        if (token.back() == '*') {
-            throw IllegalOperation("Exclude by prefix is not implemented");
+    // The index only tells which objects hold all the words of a phrase, so
+    // whether they follow each other is checked on the text of the objects
+    auto has_phrase = [&](ObjKey key, const std::vector<Phrase>& phrases) {
+        Mixed text = m_target_column.get_value(key);
+        if (text.is_null())
+            return false;
+        StringData str = text.get_string();
+        auto info = tokenizer->reset({str.data(), str.size()}).get_token_info();
+        for (auto& phrase : phrases) {
+            if (contains_phrase(info, phrase))
+                return true;
         }
+        return false;
+    };
+    for (auto& phrase : tokens.phrases) {
+        auto is_missing = [&](ObjKey key) {
+            return !has_phrase(key, {phrase});
+        };
+        result.erase(std::remove_if(result.begin(), result.end(), is_missing), result.end());
+    }
+
+    for (auto& token : excludes) {
         if (result.empty())
             return;
+        if (token.back() == '*') {
+            std::set<int64_t> keys;
+            m_array->index_string_find_all_prefix(keys, StringData(token.data(), token.size() - 1));
+            auto is_excluded = [&](ObjKey key) {
+                return keys.count(key.value) > 0;
+            };
+            result.erase(std::remove_if(result.begin(), result.end(), is_excluded), result.end());
+            continue;
+        }
 
         switch (find_all_no_copy(StringData{token}, res)) {
             case FindRes_not_found:
@@ -1583,11 +2235,97 @@ void StringIndex::find_all_fulltext(std::vector<ObjKey>& result, StringData valu
             }
         }
     }
+
+    if (!tokens.excluded_phrases.empty()) {
+        auto is_excluded = [&](ObjKey key) {
+            return has_phrase(key, tokens.excluded_phrases);
+        };
+        result.erase(std::remove_if(result.begin(), result.end(), is_excluded), result.end());
+    }
+}
+
+
+std::vector<double> StringIndex::fulltext_scores(const std::vector<ObjKey>& keys, StringData value) const
+{
+    // The parameters usually chosen for BM25
+    constexpr double k1 = 1.2;
+    constexpr double b = 0.75;
+
+    auto tokenizer = Tokenizer::get_instance();
+    tokenizer->reset({value.data(), value.size()});
+    auto tokens = tokenizer->get_search_tokens();
+
+    // Inverse document frequency of each word searched for. The number of
+    // objects holding a word is the size of its postings in the index.
+    double num_objects = double(m_target_column.size());
+    std::vector<std::pair<std::string, double>> terms;
+    for (auto& token : tokens.includes) {
+        size_t num_matches;
+        if (token.back() == '*') {
+            std::set<int64_t> matches;
+            m_array->index_string_find_all_prefix(matches, StringData(token.data(), token.size() - 1));
+            num_matches = matches.size();
+        }
+        else {
+            num_matches = count(Mixed(StringData(token)));
+        }
+        double idf = std::log((num_objects - num_matches + 0.5) / (num_matches + 0.5) + 1);
+        terms.emplace_back(token, idf);
+    }
+
+    auto num_words = [&](StringData text) {
+        size_t n = 0;
+        tokenizer->reset({text.data(), text.size()});
+        while (tokenizer->next())
+            ++n;
+        return n;
+    };
+    size_t total_words = 0;
+    ColKey col_key = m_target_column.get_column_key();
+    for (auto it = m_target_column.begin(); it != m_target_column.end(); ++it) {
+        total_words += num_words(it->get<String>(col_key));
+    }
+    double avg_words = num_objects > 0 ? double(total_words) / num_objects : 0;
+
+    std::vector<double> scores;
+    scores.reserve(keys.size());
+    for (auto key : keys) {
+        Mixed text = key ? m_target_column.get_value(key) : Mixed();
+        if (text.is_null() || terms.empty()) {
+            scores.push_back(0);
+            continue;
+        }
+        StringData str = text.get_string();
+        auto info = tokenizer->reset({str.data(), str.size()}).get_token_info();
+        size_t words = 0;
+        for (auto& entry : info)
+            words += entry.second.positions.size();
+        double norm = k1 * (1 - b + (avg_words > 0 ? b * words / avg_words : b));
+        double score = 0;
+        for (auto& [token, idf] : terms) {
+            size_t frequency = 0;
+            if (token.back() == '*') {
+                std::string_view prefix(token.data(), token.size() - 1);
+                for (auto it = info.lower_bound(std::string(prefix));
+                     it != info.end() && std::string_view(it->first).substr(0, prefix.size()) == prefix; ++it) {
+                    frequency += it->second.positions.size();
+                }
+            }
+            else if (auto it = info.find(token); it != info.end()) {
+                frequency = it->second.positions.size();
+            }
+            score += idf * (frequency * (k1 + 1)) / (frequency + norm);
+        }
+        scores.push_back(score);
+    }
+    return scores;
 }
 
 
 void StringIndex::clear()
 {
+    m_unique_lookup.reset();
+    m_pending.clear();
     Array values(m_array->get_alloc());
     get_child(*m_array, 0, values);
     REALM_ASSERT(m_array->size() == values.size() + 1);
@@ -1769,11 +2507,17 @@ bool StringIndex::has_duplicate_values() const noexcept
 
 bool StringIndex::is_empty() const
 {
+    flush_pending();
     return m_array->size() == 1; // first entry in refs points to offsets
 }
 
 void StringIndex::insert(ObjKey key, const Mixed& value)
 {
+    if (is_deferred()) {
+        // The object may have been erased earlier in the same batch
+        add_pending(key, false).erased = false; // Throws
+        return;
+    }
     StringConversionBuffer buffer;
     constexpr size_t offset = 0; // First key from beginning of string
 
@@ -1789,11 +2533,17 @@ void StringIndex::insert(ObjKey key, const Mixed& value)
     }
     else {
         insert_with_offset(key, value.get_index_data(buffer), value, offset); // Throws
+        if (m_unique_lookup)
+            m_unique_lookup->add(key, value, m_target_column);
     }
 }
 
 void StringIndex::set(ObjKey key, const Mixed& new_value)
 {
+    if (is_deferred()) {
+        add_pending(key, true); // Throws
+        return;
+    }
     StringConversionBuffer buffer;
     Mixed old_value = get(key);
 
@@ -1850,6 +2600,8 @@ void StringIndex::set(ObjKey key, const Mixed& new_value)
 
             auto index_data = new_value.get_index_data(buffer);
             insert_with_offset(key, index_data, new_value, 0); // Throws
+            if (m_unique_lookup)
+                m_unique_lookup->add(key, new_value, m_target_column);
         }
     }
 }
@@ -1966,6 +2718,7 @@ IntegerColumn::const_iterator SortedListComparator::find_end_of_unsorted(const M
 void StringIndex::verify() const
 {
 #ifdef REALM_DEBUG
+    flush_pending();
     m_array->verify();
 
     Allocator& alloc = m_array->get_alloc();
@@ -23,6 +23,7 @@
 #include <memory>
 #include <array>
 #include <set>
+#include <unordered_map>
 
 #include <realm/array.hpp>
 #include <realm/column_integer.hpp>
@@ -91,6 +92,10 @@ public:
     {
         _index_string_find_all_prefix(result, str, NodeHeader::get_header_from_data(m_data));
     }
+    void index_string_find_all_prefix(std::vector<ObjKey>& result, StringData prefix, const ClusterColumn& column) const
+    {
+        find_all_prefix(result, prefix, column, NodeHeader::get_header_from_data(m_data), 0);
+    }
 
 private:
     template <IndexMethod>
@@ -110,6 +115,8 @@ private:
 
     void index_string_all_ins(StringData value, std::vector<ObjKey>& result, const ClusterColumn& column) const;
     void _index_string_find_all_prefix(std::set<int64_t>& result, StringData str, const char* header) const;
+    void find_all_prefix(std::vector<ObjKey>& result, StringData prefix, const ClusterColumn& column,
+                         const char* header, size_t offset) const;
 };
 
 // 16 is the biggest element size of any non-string/binary Realm type
@@ -123,7 +130,7 @@ class StringIndex : public SearchIndex {
 public:
     StringIndex(const ClusterColumn& target_column, Allocator&);
     StringIndex(ref_type, ArrayParent*, size_t ndx_in_parent, const ClusterColumn& target_column, Allocator&);
-    ~StringIndex() noexcept {}
+    ~StringIndex() noexcept;
 
     static bool type_supported(realm::DataType type)
     {
@@ -148,17 +155,48 @@ public:
     void erase_string(ObjKey key, StringData value);
 
     ObjKey find_first(const Mixed& value) const final;
+    ObjKey find_unique(const Mixed& value) const final;
     void find_all(std::vector<ObjKey>& result, Mixed value, bool case_insensitive = false) const final;
     FindRes find_all_no_copy(Mixed value, InternalFindResult& result) const final;
+    /// Find the objects whose string starts with `prefix`, in no particular
+    /// order. The prefix must not be empty, and the index must not be a
+    /// full text index or an index of a list.
+    void find_all_prefix(std::vector<ObjKey>& result, StringData prefix) const;
     size_t count(const Mixed& value) const final;
     void insert_bulk(const ArrayUnsigned* keys, uint64_t key_offset, size_t num_values, ArrayPayload& values) final;
     void insert_bulk_list(const ArrayUnsigned* keys, uint64_t key_offset, size_t num_values,
                           ArrayInteger& ref_array) final;
+    /// Build an empty index in one pass. The values given to insert_bulk()
+    /// while `insert_values` runs are only collected. They are then sorted,
+    /// and the nodes of the index are created bottom up rather than by
+    /// inserting one value at a time. Fulltext indexes and indexes on lists
+    /// are filled by inserting the values as usual.
+    void build(util::FunctionRef<void()> insert_values);
 
     void find_all_fulltext(std::vector<ObjKey>& result, StringData value) const;
+    /// The Okapi BM25 relevance of each of the objects `keys` for the search
+    /// string `value`. The words searched for, including those of phrases
+    /// and prefixes, are scored while excluded words are ignored.
+    std::vector<double> fulltext_scores(const std::vector<ObjKey>& keys, StringData value) const;
 
     void clear() override;
     bool has_duplicate_values() const noexcept override;
+    void refresh_accessor_tree(const ClusterColumn& target_column) override;
+
+    /// While deferred, insert(), set() and erase() only record which objects
+    /// changed, and the index is brought up to date by
+    /// apply_pending_updates(). An object changed several times is then
+    /// updated once, and the updates are applied in value order. Anything
+    /// reading the index applies the pending updates first, so it never sees
+    /// stale entries. Updates of full text indexes and of indexes of lists
+    /// are never deferred. Refreshing the accessor drops the pending updates,
+    /// as it happens on rollback.
+    void set_deferred(bool deferred);
+    bool has_pending_updates() const noexcept
+    {
+        return !m_pending.empty();
+    }
+    void apply_pending_updates();
 
     void verify() const final;
 #ifdef REALM_DEBUG
@@ -202,14 +240,41 @@ private:
     // References point to a list if the context header flag is NOT set.
     // If the header flag is set, references point to a sub-StringIndex (nesting).
     std::unique_ptr<IndexArray> m_array;
+    // Collects the values while the index is being built
+    class Builder;
+    std::unique_ptr<Builder> m_builder;
+    // Hash table over the values, used by find_unique()
+    struct UniqueLookup;
+    mutable std::unique_ptr<UniqueLookup> m_unique_lookup;
+    // Columns with at least this many objects get a hash table once they have
+    // been looked up often enough to pay for building it
+    static constexpr size_t s_unique_lookup_min_size = 64;
+    static constexpr size_t s_unique_lookup_factor = 16;
+
+    struct PendingUpdate {
+        // Whether the index has an entry for the object, and the index data of its value if so
+        bool in_index = false;
+        bool old_is_null = false;
+        std::string old_data;
+        bool erased = false;
+    };
+    bool m_deferred = false;
+    std::unordered_map<ObjKey, PendingUpdate> m_pending;
 
-    struct inner_node_tag {};
-    StringIndex(inner_node_tag, Allocator&);
-    StringIndex(const ClusterColumn& target_column, std::unique_ptr<IndexArray> root)
-        : SearchIndex(target_column, root.get())
-        , m_array(std::move(root))
+    bool is_deferred() const noexcept
     {
+        return m_deferred && !m_target_column.full_word();
     }
+    PendingUpdate& add_pending(ObjKey key, bool in_index);
+    void flush_pending() const
+    {
+        if (REALM_UNLIKELY(!m_pending.empty()))
+            const_cast<StringIndex*>(this)->apply_pending_updates(); // Throws
+    }
+
+    struct inner_node_tag {};
+    StringIndex(inner_node_tag, Allocator&);
+    StringIndex(const ClusterColumn& target_column, std::unique_ptr<IndexArray> root);
 
     static std::unique_ptr<IndexArray> create_node(Allocator&, bool is_leaf);
 
@@ -359,23 +424,34 @@ inline StringIndex::key_type StringIndex::create_key(StringData str, size_t offs
 
 inline ObjKey StringIndex::find_first(const Mixed& value) const
 {
+    flush_pending();
     // Use direct access method
     return m_array->index_string_find_first(value, m_target_column);
 }
 
 inline void StringIndex::find_all(std::vector<ObjKey>& result, Mixed value, bool case_insensitive) const
 {
+    flush_pending();
     // Use direct access method
     return m_array->index_string_find_all(result, value, m_target_column, case_insensitive);
 }
 
 inline FindRes StringIndex::find_all_no_copy(Mixed value, InternalFindResult& result) const
 {
+    flush_pending();
     return m_array->index_string_find_all_no_copy(value, m_target_column, result);
 }
 
+inline void StringIndex::find_all_prefix(std::vector<ObjKey>& result, StringData prefix) const
+{
+    REALM_ASSERT_DEBUG(prefix.size() != 0 && !m_target_column.full_word());
+    flush_pending();
+    m_array->index_string_find_all_prefix(result, prefix, m_target_column);
+}
+
 inline size_t StringIndex::count(const Mixed& value) const
 {
+    flush_pending();
     // Use direct access method
     return m_array->index_string_count(value, m_target_column);
 }
@@ -146,6 +146,13 @@ void CollectionBaseImpl<LstBase>::to_json(std::ostream& out, JSONOutputMode outp
     out << "]";
 }
 
+void LstBase::insert_range_any(size_t ndx, const std::vector<Mixed>& values)
+{
+    for (auto& val : values) {
+        insert_any(ndx++, val);
+    }
+}
+
 /***************************** Lst<Stringdata> ******************************/
 
 template <>
@@ -158,6 +165,17 @@ void Lst<StringData>::do_insert(size_t ndx, StringData value)
     m_tree->insert(ndx, value);
 }
 
+template <>
+void Lst<StringData>::do_insert_range(size_t ndx, const std::vector<StringData>& values)
+{
+    if (auto index = get_table_unchecked()->get_string_index(m_col_key)) {
+        for (auto& value : values) {
+            index->insert(get_owner_key(), value);
+        }
+    }
+    m_tree->insert_range(ndx, values);
+}
+
 template <>
 void Lst<StringData>::do_set(size_t ndx, StringData value)
 {
@@ -210,6 +228,87 @@ inline void Lst<StringData>::do_clear()
     m_tree->clear();
 }
 
+/******************************* Lst<double> ********************************/
+
+// The coordinates of geospatial points are lists of doubles. A change to them
+// moves the point of the owning object in the geospatial index, if any.
+template <class F>
+static void update_geospatial_index(Table* table, ColKey col_key, ObjKey key, F&& change)
+{
+    if (GeoIndex* index = table->get_geospatial_index(col_key)) {
+        index->erase(key);
+        change();
+        index->insert(key);
+    }
+    else {
+        change();
+    }
+}
+
+template <>
+void Lst<double>::do_set(size_t ndx, double value)
+{
+    update_geospatial_index(get_table_unchecked(), m_col_key, get_owner_key(), [&] {
+        m_tree->set(ndx, value);
+    });
+}
+
+template <>
+void Lst<double>::do_insert(size_t ndx, double value)
+{
+    update_geospatial_index(get_table_unchecked(), m_col_key, get_owner_key(), [&] {
+        m_tree->insert(ndx, value);
+    });
+}
+
+template <>
+void Lst<double>::do_insert_range(size_t ndx, const std::vector<double>& values)
+{
+    update_geospatial_index(get_table_unchecked(), m_col_key, get_owner_key(), [&] {
+        m_tree->insert_range(ndx, values);
+    });
+}
+
+template <>
+void Lst<double>::do_remove(size_t ndx)
+{
+    update_geospatial_index(get_table_unchecked(), m_col_key, get_owner_key(), [&] {
+        m_tree->erase(ndx);
+    });
+}
+
+template <>
+void Lst<double>::do_clear()
+{
+    update_geospatial_index(get_table_unchecked(), m_col_key, get_owner_key(), [&] {
+        m_tree->clear();
+    });
+}
+
+template <>
+void Lst<double>::do_move(size_t from, size_t to)
+{
+    update_geospatial_index(get_table_unchecked(), m_col_key, get_owner_key(), [&] {
+        if (to > from) {
+            to++;
+        }
+        else {
+            from++;
+        }
+        m_tree->insert(to, 0.0);
+        m_tree->swap(from, to);
+        m_tree->erase(from);
+    });
+}
+
+template <>
+void Lst<double>::do_swap(size_t ndx1, size_t ndx2)
+{
+    update_geospatial_index(get_table_unchecked(), m_col_key, get_owner_key(), [&] {
+        m_tree->swap(ndx1, ndx2);
+    });
+}
+
 /********************************* Lst<Key> *********************************/
 
 template <>
@@ -248,6 +347,15 @@ void Lst<ObjKey>::do_insert(size_t ndx, ObjKey target_key)
     }
 }
 
+template <>
+void Lst<ObjKey>::do_insert_range(size_t ndx, const std::vector<ObjKey>& target_keys)
+{
+    // Each link needs its backlink
+    for (auto& target_key : target_keys) {
+        do_insert(ndx++, target_key);
+    }
+}
+
 template <>
 void Lst<ObjKey>::do_remove(size_t ndx)
 {
@@ -329,6 +437,15 @@ void Lst<ObjLink>::do_insert(size_t ndx, ObjLink target_link)
     m_tree->insert(ndx, target_link);
 }
 
+template <>
+void Lst<ObjLink>::do_insert_range(size_t ndx, const std::vector<ObjLink>& target_links)
+{
+    // Each link needs its backlink
+    for (auto& target_link : target_links) {
+        do_insert(ndx++, target_link);
+    }
+}
+
 template <>
 void Lst<ObjLink>::do_remove(size_t ndx)
 {
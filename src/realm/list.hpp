@@ -62,6 +62,8 @@ public:
     virtual void set_any(size_t ndx, Mixed val) = 0;
     virtual void insert_null(size_t ndx) = 0;
     virtual void insert_any(size_t ndx, Mixed val) = 0;
+    // Insert 'values' starting at position 'ndx'
+    virtual void insert_range_any(size_t ndx, const std::vector<Mixed>& values);
     virtual void resize(size_t new_size) = 0;
     virtual void remove(size_t from, size_t to) = 0;
     virtual void move(size_t from, size_t to) = 0;
@@ -120,6 +122,9 @@ public:
     size_t find_first(const T& value) const;
     T set(size_t ndx, T value);
     void insert(size_t ndx, T value);
+    // Insert 'values' starting at position 'ndx'. Values added at the end of
+    // the list fill up whole leaves of the tree at a time.
+    void insert_range(size_t ndx, const std::vector<T>& values);
     T remove(size_t ndx);
 
     // Overriding members of CollectionBase:
@@ -145,6 +150,7 @@ public:
     }
     void insert_null(size_t ndx) final;
     void insert_any(size_t ndx, Mixed val) final;
+    void insert_range_any(size_t ndx, const std::vector<Mixed>& values) final;
     size_t find_any(Mixed val) const final;
     void resize(size_t new_size) final;
     void remove(size_t from, size_t to) final;
@@ -240,8 +246,11 @@ protected:
     // checked (bounds check, writability, etc.).
     void do_set(size_t ndx, T value);
     void do_insert(size_t ndx, T value);
+    void do_insert_range(size_t ndx, const std::vector<T>& values);
     void do_remove(size_t ndx);
     void do_clear();
+    void do_move(size_t from, size_t to);
+    void do_swap(size_t ndx1, size_t ndx2);
 
     // BPlusTree must be wrapped in an `std::unique_ptr` because it is not
     // default-constructible, due to its `Allocator&` member.
@@ -549,17 +558,36 @@ private:
 template <>
 void Lst<StringData>::do_insert(size_t, StringData);
 template <>
+void Lst<StringData>::do_insert_range(size_t, const std::vector<StringData>&);
+template <>
 void Lst<StringData>::do_set(size_t, StringData);
 template <>
 void Lst<StringData>::do_remove(size_t);
 template <>
 void Lst<StringData>::do_clear();
+// Specialization of Lst<double>:
+template <>
+void Lst<double>::do_set(size_t, double);
+template <>
+void Lst<double>::do_insert(size_t, double);
+template <>
+void Lst<double>::do_insert_range(size_t, const std::vector<double>&);
+template <>
+void Lst<double>::do_remove(size_t);
+template <>
+void Lst<double>::do_clear();
+template <>
+void Lst<double>::do_move(size_t, size_t);
+template <>
+void Lst<double>::do_swap(size_t, size_t);
 // Specialization of Lst<ObjKey>:
 template <>
 void Lst<ObjKey>::do_set(size_t, ObjKey);
 template <>
 void Lst<ObjKey>::do_insert(size_t, ObjKey);
 template <>
+void Lst<ObjKey>::do_insert_range(size_t, const std::vector<ObjKey>&);
+template <>
 void Lst<ObjKey>::do_remove(size_t);
 template <>
 void Lst<ObjKey>::do_clear();
@@ -572,6 +600,8 @@ void Lst<ObjLink>::do_set(size_t, ObjLink);
 template <>
 void Lst<ObjLink>::do_insert(size_t, ObjLink);
 template <>
+void Lst<ObjLink>::do_insert_range(size_t, const std::vector<ObjLink>&);
+template <>
 void Lst<ObjLink>::do_remove(size_t);
 extern template class Lst<ObjLink>;
 
@@ -888,6 +918,12 @@ inline void Lst<T>::do_insert(size_t ndx, T value)
     m_tree->insert(ndx, value);
 }
 
+template <class T>
+inline void Lst<T>::do_insert_range(size_t ndx, const std::vector<T>& values)
+{
+    m_tree->insert_range(ndx, values);
+}
+
 template <class T>
 inline void Lst<T>::do_remove(size_t ndx)
 {
@@ -900,6 +936,30 @@ inline void Lst<T>::do_clear()
     m_tree->clear();
 }
 
+template <class T>
+inline void Lst<T>::do_move(size_t from, size_t to)
+{
+    if (to > from) {
+        to++;
+    }
+    else {
+        from++;
+    }
+    // We use swap here as it handles the special case for StringData where
+    // 'to' and 'from' points into the same array. In this case you cannot
+    // set an entry with the result of a get from another entry in the same
+    // leaf.
+    m_tree->insert(to, BPlusTree<T>::default_value(m_nullable));
+    m_tree->swap(from, to);
+    m_tree->erase(from);
+}
+
+template <class T>
+inline void Lst<T>::do_swap(size_t ndx1, size_t ndx2)
+{
+    m_tree->swap(ndx1, ndx2);
+}
+
 template <typename U>
 inline Lst<U> Obj::get_list(ColKey col_key) const
 {
@@ -1045,6 +1105,22 @@ inline void Lst<T>::insert_any(size_t ndx, Mixed val)
     }
 }
 
+template <class T>
+void Lst<T>::insert_range_any(size_t ndx, const std::vector<Mixed>& values)
+{
+    std::vector<T> typed_values;
+    typed_values.reserve(values.size());
+    for (auto& val : values) {
+        if (val.is_null()) {
+            typed_values.push_back(BPlusTree<T>::default_value(m_nullable));
+        }
+        else {
+            typed_values.push_back(val.get<typename util::RemoveOptional<T>::type>());
+        }
+    }
+    insert_range(ndx, typed_values);
+}
+
 template <class T>
 size_t Lst<T>::find_any(Mixed val) const
 {
@@ -1089,20 +1165,7 @@ void Lst<T>::move(size_t from, size_t to)
         if (Replication* repl = Base::get_replication()) {
             repl->list_move(*this, from, to);
         }
-        if (to > from) {
-            to++;
-        }
-        else {
-            from++;
-        }
-        // We use swap here as it handles the special case for StringData where
-        // 'to' and 'from' points into the same array. In this case you cannot
-        // set an entry with the result of a get from another entry in the same
-        // leaf.
-        m_tree->insert(to, BPlusTree<T>::default_value(m_nullable));
-        m_tree->swap(from, to);
-        m_tree->erase(from);
-
+        do_move(from, to);
         bump_content_version();
     }
 }
@@ -1118,7 +1181,7 @@ void Lst<T>::swap(size_t ndx1, size_t ndx2)
         if (Replication* repl = Base::get_replication()) {
             LstBase::swap_repl(repl, ndx1, ndx2);
         }
-        m_tree->swap(ndx1, ndx2);
+        do_swap(ndx1, ndx2);
         bump_content_version();
     }
 }
@@ -1159,6 +1222,29 @@ void Lst<T>::insert(size_t ndx, T value)
     bump_content_version();
 }
 
+template <class T>
+void Lst<T>::insert_range(size_t ndx, const std::vector<T>& values)
+{
+    for (const T& value : values) {
+        if (value_is_null(value) && !m_nullable)
+            throw InvalidArgument(ErrorCodes::PropertyNotNullable,
+                                  util::format("List: %1", CollectionBase::get_property_name()));
+    }
+
+    auto sz = size();
+    CollectionBase::validate_index("insert_range()", ndx, sz + 1);
+    if (values.empty())
+        return;
+    ensure_created();
+    if (Replication* repl = Base::get_replication()) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            repl->list_insert(*this, ndx + i, T(values[i]), sz + i);
+        }
+    }
+    do_insert_range(ndx, values);
+    bump_content_version();
+}
+
 template <class T>
 T Lst<T>::remove(size_t ndx)
 {
@@ -19,6 +19,8 @@
 #ifndef REALM_NODE_HEADER_HPP
 #define REALM_NODE_HEADER_HPP
 
+#include <cstring>
+
 #include <realm/util/assert.hpp>
 
 namespace realm {
@@ -52,6 +54,7 @@ public:
         wtype_Bits = 0,     // width indicates how many bits every element occupies
         wtype_Multiply = 1, // width indicates how many bytes every element occupies
         wtype_Ignore = 2,   // each element is 1 byte
+        wtype_Delta = 3,    // width indicates how many bits every element occupies, relative to a 64 bit base
     };
 
     static const int header_size = 8; // Number of bytes used by header
@@ -159,6 +162,7 @@ public:
         // 0: bits      (width/8) * size
         // 1: multiply  width * size
         // 2: ignore    1 * size
+        // 3: delta     (width/8) * size + 8
         typedef unsigned char uchar;
         uchar* h = reinterpret_cast<uchar*>(header);
         h[4] = uchar((int(h[4]) & ~0x18) | int(value) << 3);
@@ -210,6 +214,23 @@ public:
         return num_bytes;
     }
 
+    /// The base of an array of width type wtype_Delta. Every element is
+    /// stored as its difference from the base.
+    static int64_t get_base_from_header(const char* header) noexcept
+    {
+        const char* base = header + calc_byte_size(wtype_Bits, get_size_from_header(header),
+                                                   get_width_from_header(header));
+        int64_t value;
+        memcpy(&value, base, sizeof value);
+        return value;
+    }
+
+    static void set_base_in_header(int64_t value, char* header) noexcept
+    {
+        char* base = header + calc_byte_size(wtype_Bits, get_size_from_header(header), get_width_from_header(header));
+        memcpy(base, &value, sizeof value);
+    }
+
     static size_t calc_byte_size(WidthType wtype, size_t size, uint_least8_t width) noexcept
     {
         size_t num_bytes = 0;
@@ -229,6 +250,15 @@ public:
             case wtype_Ignore:
                 num_bytes = size;
                 break;
+            case wtype_Delta: {
+                // The elements are packed like for wtype_Bits, and the base
+                // follows in the 8 bytes after the aligned elements.
+                REALM_ASSERT_3(size, <, 0x1000000);
+                size_t num_bits = size * width;
+                num_bytes = (((num_bits + 7) >> 3) + 7) & ~size_t(7);
+                num_bytes += 8;
+                break;
+            }
         }
 
         // Ensure 8-byte alignment
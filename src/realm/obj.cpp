@@ -42,6 +42,7 @@
 #include "realm/replication.hpp"
 #include "realm/spec.hpp"
 #include "realm/table_view.hpp"
+#include "realm/util/alloc_tracking.hpp"
 #include "realm/util/base64.hpp"
 #include "realm/util/overload.hpp"
 
@@ -554,7 +555,11 @@ int64_t Obj::_get<int64_t>(ColKey::Idx col_ndx) const
     char* header = alloc.translate(ref);
     int width = Array::get_width_from_header(header);
     char* data = Array::get_data_from_header(header);
-    REALM_TEMPEX(return get_direct, width, (data, m_row_ndx));
+    int64_t value;
+    REALM_TEMPEX(value = get_direct, width, (data, m_row_ndx));
+    if (Array::get_wtype_from_header(header) == Array::wtype_Delta)
+        value += Array::get_base_from_header(header);
+    return value;
 }
 
 template <>
@@ -637,6 +642,26 @@ BinaryData Obj::_get<BinaryData>(ColKey::Idx col_ndx) const
 Mixed Obj::get_any(ColKey col_key) const
 {
     m_table->check_column(col_key);
+    return _get_any(col_key);
+}
+
+std::vector<Mixed> Obj::get_many(const std::vector<ColKey>& col_keys) const
+{
+    for (auto col_key : col_keys) {
+        m_table->check_column(col_key);
+    }
+    checked_update_if_needed();
+
+    std::vector<Mixed> values;
+    values.reserve(col_keys.size());
+    for (auto col_key : col_keys) {
+        values.push_back(_get_any(col_key));
+    }
+    return values;
+}
+
+Mixed Obj::_get_any(ColKey col_key) const
+{
     auto col_ndx = col_key.get_index();
     if (col_key.is_collection()) {
         ref_type ref = to_ref(_get<int64_t>(col_ndx));
@@ -886,13 +911,7 @@ std::vector<ObjKey> Obj::get_all_backlinks(ColKey backlink_col) const
     backlinks.set_parent(&fields, backlink_col.get_index().val + 1);
     backlinks.init_from_parent();
 
-    auto cnt = backlinks.get_backlink_count(m_row_ndx);
-    std::vector<ObjKey> vec;
-    vec.reserve(cnt);
-    for (size_t i = 0; i < cnt; i++) {
-        vec.push_back(backlinks.get_backlink(m_row_ndx, i));
-    }
-    return vec;
+    return backlinks.get_backlinks(m_row_ndx);
 }
 
 size_t Obj::get_backlink_cnt(ColKey backlink_col) const
@@ -1306,6 +1325,7 @@ Obj& Obj::set<int64_t>(ColKey col_key, int64_t value, bool is_default)
     if (index && !m_key.is_unresolved()) {
         index->set(m_key, value);
     }
+    m_table->update_compound_indexes(m_key, col_key, value);
 
     Allocator& alloc = get_alloc();
     alloc.bump_content_version();
@@ -1385,6 +1405,7 @@ Obj& Obj::add_int(ColKey col_key, int64_t value)
                 if (SearchIndex* index = m_table->get_search_index(col_key)) {
                     index->set(m_key, new_val);
                 }
+                m_table->update_compound_indexes(m_key, col_key, new_val);
                 values.set(m_row_ndx, new_val);
             }
             else {
@@ -1400,6 +1421,7 @@ Obj& Obj::add_int(ColKey col_key, int64_t value)
             if (SearchIndex* index = m_table->get_search_index(col_key)) {
                 index->set(m_key, new_val);
             }
+            m_table->update_compound_indexes(m_key, col_key, new_val);
             values.set(m_row_ndx, new_val);
         }
     }
@@ -1678,6 +1700,10 @@ Obj& Obj::set(ColKey col_key, T value, bool is_default)
     if (index && !m_key.is_unresolved()) {
         index->set(m_key, value);
     }
+    m_table->update_compound_indexes(m_key, col_key, value);
+    GeoIndex* geo_index = m_table->get_geospatial_index(col_key);
+    if (geo_index)
+        geo_index->erase(m_key);
 
     Allocator& alloc = get_alloc();
     alloc.bump_content_version();
@@ -1692,6 +1718,8 @@ Obj& Obj::set(ColKey col_key, T value, bool is_default)
     values.set(m_row_ndx, value);
 
     sync(fields);
+    if (geo_index)
+        geo_index->insert(m_key);
 
     if (Replication* repl = get_replication())
         repl->set(m_table.unchecked_ptr(), col_key, m_key, value,
@@ -2095,6 +2123,7 @@ CollectionPtr Obj::get_collection_by_stable_path(const StablePath& path) const
 
 CollectionBasePtr Obj::get_collection_ptr(ColKey col_key) const
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::accessor};
     if (col_key.is_collection()) {
         auto collection = CollectionParent::get_collection_ptr(col_key, 0);
         collection->set_owner(*this, col_key);
@@ -2327,6 +2356,10 @@ Obj& Obj::set_null(ColKey col_key, bool is_default)
     if (index && !m_key.is_unresolved()) {
         index->set(m_key, null{});
     }
+    m_table->update_compound_indexes(m_key, col_key, Mixed());
+    GeoIndex* geo_index = m_table->get_geospatial_index(col_key);
+    if (geo_index)
+        geo_index->erase(m_key);
 
     switch (col_type) {
         case col_type_Int:
@@ -2365,6 +2398,8 @@ Obj& Obj::set_null(ColKey col_key, bool is_default)
         case col_type_TypedLink:
             REALM_UNREACHABLE();
     }
+    if (geo_index)
+        geo_index->insert(m_key);
 
     if (Replication* repl = get_replication())
         repl->set(m_table.unchecked_ptr(), col_key, m_key, util::none,
@@ -122,6 +122,9 @@ public:
     {
         return get_any(get_column_key(col_name));
     }
+    /// Get the values of several columns. The columns are checked and the object is brought up to date once,
+    /// before any value is read.
+    std::vector<Mixed> get_many(const std::vector<ColKey>& col_keys) const;
     Mixed get_primary_key() const;
 
     template <typename U>
@@ -352,6 +355,7 @@ private:
 
     template <typename U>
     U _get(ColKey::Idx col_ndx) const;
+    Mixed _get_any(ColKey col_key) const;
 
     ObjKey get_backlink(ColKey backlink_col, size_t backlink_ndx) const;
     // Return all backlinks from a specific backlink column
@@ -193,6 +193,16 @@ RLM_API void realm_config_set_automatic_change_notifications(realm_config_t* con
     config->automatic_change_notifications = b;
 }
 
+RLM_API bool realm_config_get_deliver_notifications_on_commit(const realm_config_t* config)
+{
+    return config->deliver_notifications_on_commit;
+}
+
+RLM_API void realm_config_set_deliver_notifications_on_commit(realm_config_t* config, bool b)
+{
+    config->deliver_notifications_on_commit = b;
+}
+
 RLM_API void realm_config_set_scheduler(realm_config_t* config, const realm_scheduler_t* scheduler)
 {
     config->scheduler = *scheduler;
@@ -243,3 +253,8 @@ RLM_API void realm_config_set_automatic_backlink_handling(realm_config_t* realm_
 {
     realm_config->automatically_handle_backlinks_in_migrations = enable_automatic_handling;
 }
+
+RLM_API void realm_config_set_cache_schema_fingerprint(realm_config_t* realm_config, bool enable) noexcept
+{
+    realm_config->cache_schema_fingerprint = enable;
+}
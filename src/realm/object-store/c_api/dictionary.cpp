@@ -86,6 +86,28 @@ RLM_API bool realm_dictionary_insert(realm_dictionary_t* dict, realm_value_t key
     });
 }
 
+RLM_API bool realm_dictionary_insert_many(realm_dictionary_t* dict, const realm_value_t* keys,
+                                          const realm_value_t* values, size_t num_values, size_t* out_num_inserted)
+{
+    return wrap_err([&]() {
+        std::vector<std::pair<Mixed, Mixed>> entries;
+        entries.reserve(num_values);
+        for (size_t i = 0; i < num_values; ++i) {
+            if (keys[i].type != RLM_TYPE_STRING) {
+                throw InvalidArgument{"Only string keys are supported in dictionaries"};
+            }
+            auto val = from_capi(values[i]);
+            check_value_assignable(*dict, val);
+            entries.emplace_back(StringData{keys[i].string.data, keys[i].string.size}, val);
+        }
+
+        auto num_inserted = dict->insert_many_any(entries);
+        if (out_num_inserted)
+            *out_num_inserted = num_inserted;
+        return true;
+    });
+}
+
 RLM_API realm_object_t* realm_dictionary_insert_embedded(realm_dictionary_t* dict, realm_value_t key)
 {
     return wrap_err([&]() {
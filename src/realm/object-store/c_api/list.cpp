@@ -83,6 +83,22 @@ RLM_API bool realm_list_insert(realm_list_t* list, size_t index, realm_value_t v
     });
 }
 
+RLM_API bool realm_list_insert_many(realm_list_t* list, size_t index, const realm_value_t* values, size_t num_values)
+{
+    return wrap_err([&]() {
+        std::vector<Mixed> vals;
+        vals.reserve(num_values);
+        for (size_t i = 0; i < num_values; ++i) {
+            auto val = from_capi(values[i]);
+            check_value_assignable(*list, val);
+            vals.push_back(val);
+        }
+
+        list->insert_range_any(index, vals);
+        return true;
+    });
+}
+
 RLM_API realm_list_t* realm_list_insert_list(realm_list_t* list, size_t index)
 {
     return wrap_err([&]() {
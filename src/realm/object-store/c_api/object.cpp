@@ -108,6 +108,54 @@ RLM_API realm_object_t* realm_object_create(realm_t* realm, realm_class_key_t ta
     });
 }
 
+RLM_API bool realm_object_create_many(realm_t* realm, realm_class_key_t table_key, size_t num_objects,
+                                      size_t num_properties, const realm_property_key_t* properties,
+                                      const realm_value_t* values, realm_object_key_t* out_keys)
+{
+    return wrap_err([&]() {
+        auto& shared_realm = *realm;
+        shared_realm->verify_in_write();
+        auto tblkey = TableKey(table_key);
+        auto table = shared_realm->read_group().get_table(tblkey);
+
+        if (table->get_primary_key_column()) {
+            auto& object_schema = schema_for_table(*realm, tblkey);
+            throw MissingPrimaryKeyException{object_schema.name};
+        }
+
+        // Validate all values before creating any object
+        std::vector<BulkColumn> columns;
+        columns.reserve(num_properties);
+        for (size_t p = 0; p < num_properties; ++p) {
+            auto col_key = ColKey(properties[p]);
+            table->check_column(col_key);
+            if (col_key.is_collection()) {
+                report_type_mismatch(*realm, *table, col_key);
+            }
+
+            BulkColumn column{col_key, {}};
+            column.values.reserve(num_objects);
+            for (size_t i = 0; i < num_objects; ++i) {
+                auto val = from_capi(values[p * num_objects + i]);
+                check_value_assignable(*realm, *table, col_key, val);
+                if (val.is_type(type_TypedLink) && col_key.get_type() == col_type_Link) {
+                    val = val.get<ObjLink>().get_obj_key();
+                }
+                column.values.push_back(val);
+            }
+            columns.push_back(std::move(column));
+        }
+
+        auto keys = table->bulk_create_objects(num_objects, columns);
+        if (out_keys) {
+            for (size_t i = 0; i < num_objects; ++i) {
+                out_keys[i] = keys[i].value;
+            }
+        }
+        return true;
+    });
+}
+
 RLM_API realm_object_t* realm_object_create_with_primary_key(realm_t* realm, realm_class_key_t table_key,
                                                              realm_value_t pk)
 {
@@ -266,6 +314,8 @@ RLM_API bool realm_get_values(const realm_object_t* obj, size_t num_values, cons
 
         auto o = obj->get_obj();
 
+        std::vector<ColKey> col_keys;
+        col_keys.reserve(num_values);
         for (size_t i = 0; i < num_values; ++i) {
             auto col_key = ColKey(properties[i]);
 
@@ -274,10 +324,13 @@ RLM_API bool realm_get_values(const realm_object_t* obj, size_t num_values, cons
                 auto& schema = schema_for_table(obj->get_realm(), table->get_key());
                 throw PropertyTypeMismatch{schema.name, table->get_column_name(col_key)};
             }
+            col_keys.push_back(col_key);
+        }
 
-            auto val = o.get_any(col_key);
-            if (out_values) {
-                auto converted = objkey_to_typed_link(val, col_key, *o.get_table());
+        auto values = o.get_many(col_keys);
+        if (out_values) {
+            for (size_t i = 0; i < num_values; ++i) {
+                auto converted = objkey_to_typed_link(values[i], col_keys[i], *o.get_table());
                 out_values[i] = to_capi(converted);
             }
         }
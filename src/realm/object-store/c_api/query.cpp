@@ -3,7 +3,6 @@
 #include <realm/object-store/c_api/types.hpp>
 #include <realm/object-store/c_api/util.hpp>
 
-#include <realm/object-store/keypath_helpers.hpp>
 #include <realm/parser/query_parser.hpp>
 #include <realm/parser/keypath_mapping.hpp>
 
@@ -180,10 +179,9 @@ struct QueryArgumentsAdapter : query_parser::Arguments {
 static Query parse_and_apply_query(const std::shared_ptr<Realm>& realm, ConstTableRef table, const char* query_string,
                                    size_t num_args, const realm_query_arg_t* args)
 {
-    query_parser::KeyPathMapping mapping;
-    realm::populate_keypath_mapping(mapping, *realm);
+    auto mapping = realm->get_keypath_mapping();
     QueryArgumentsAdapter arguments{num_args, args};
-    Query query = table->query(query_string, arguments, mapping);
+    Query query = table->query(query_string, arguments, *mapping);
     return query;
 }
 
@@ -198,6 +196,32 @@ RLM_API realm_query_t* realm_query_parse(const realm_t* realm, realm_class_key_t
     });
 }
 
+RLM_API realm_prepared_query_t* realm_query_prepare(const realm_t* realm, realm_class_key_t target_table_key,
+                                                    const char* query_string, size_t num_args,
+                                                    const realm_query_arg_t* args)
+{
+    return wrap_err([&]() {
+        auto table = (*realm)->read_group().get_table(TableKey(target_table_key));
+        auto mapping = (*realm)->get_keypath_mapping();
+        QueryArgumentsAdapter arguments{num_args, args};
+        return new realm_prepared_query_t{table, query_string, arguments, *mapping, *realm};
+    });
+}
+
+RLM_API realm_results_t* realm_query_bind_and_run(const realm_prepared_query_t* prepared, size_t num_args,
+                                                  const realm_query_arg_t* args)
+{
+    return wrap_err([&]() {
+        auto shared_realm = prepared->weak_realm.lock();
+        REALM_ASSERT_RELEASE(shared_realm);
+        auto table = shared_realm->read_group().get_table(prepared->table_key);
+        QueryArgumentsAdapter arguments{num_args, args};
+        Query query = prepared->prepared.bind(table, arguments);
+        auto ordering = query.get_ordering();
+        return new realm_results{Results{shared_realm, std::move(query), ordering ? *ordering : DescriptorOrdering()}};
+    });
+}
+
 RLM_API const char* realm_query_get_description(realm_query_t* query)
 {
     return wrap_err([&]() {
@@ -205,6 +229,13 @@ RLM_API const char* realm_query_get_description(realm_query_t* query)
     });
 }
 
+RLM_API const char* realm_query_explain_analyze(realm_query_t* query)
+{
+    return wrap_err([&]() {
+        return query->explain_analyze();
+    });
+}
+
 RLM_API realm_query_t* realm_query_append_query(const realm_query_t* existing_query, const char* query_string,
                                                 size_t num_args, const realm_query_arg_t* args)
 {
@@ -408,6 +439,48 @@ RLM_API bool realm_results_get(realm_results_t* results, size_t index, realm_val
     });
 }
 
+RLM_API bool realm_results_get_range(realm_results_t* results, size_t start, size_t count, realm_value_t* out_values)
+{
+    return wrap_err([&]() {
+        auto values = results->get_range(start, start + count);
+        if (out_values) {
+            for (size_t i = 0; i < count; ++i)
+                out_values[i] = to_capi(values[i]);
+        }
+        return true;
+    });
+}
+
+RLM_API bool realm_results_get_values(realm_results_t* results, size_t begin, size_t end, size_t num_properties,
+                                      const realm_property_key_t* properties, realm_value_t* out_values)
+{
+    return wrap_err([&]() {
+        auto table = results->get_table();
+        std::vector<ColKey> col_keys;
+        col_keys.reserve(num_properties);
+        for (size_t i = 0; i < num_properties; ++i) {
+            auto col_key = ColKey(properties[i]);
+            if (table && col_key.is_collection()) {
+                auto& schema = schema_for_table(results->get_realm(), table->get_key());
+                throw PropertyTypeMismatch{schema.name, table->get_column_name(col_key)};
+            }
+            col_keys.push_back(col_key);
+        }
+
+        auto values = results->get_values(begin, end, col_keys);
+        if (out_values) {
+            size_t num_objects = end - begin;
+            for (size_t c = 0; c < num_properties; ++c) {
+                for (size_t i = 0; i < num_objects; ++i) {
+                    size_t ndx = c * num_objects + i;
+                    out_values[ndx] = to_capi(objkey_to_typed_link(values[ndx], col_keys[c], *table));
+                }
+            }
+        }
+        return true;
+    });
+}
+
 RLM_API realm_list_t* realm_results_get_list(realm_results_t* results, size_t index)
 {
     return wrap_err([&]() {
@@ -458,6 +531,22 @@ RLM_API realm_object_t* realm_results_get_object(realm_results_t* results, size_
     });
 }
 
+RLM_API bool realm_results_get_objects(realm_results_t* results, size_t start, size_t count,
+                                       realm_object_t** out_objects)
+{
+    return wrap_err([&]() {
+        auto shared_realm = results->get_realm();
+        auto objects = results->get_objects(start, start + count);
+        std::vector<std::unique_ptr<realm_object_t>> out;
+        out.reserve(count);
+        for (auto& obj : objects)
+            out.push_back(std::make_unique<realm_object_t>(Object{shared_realm, std::move(obj)}));
+        for (size_t i = 0; i < count; ++i)
+            out_objects[i] = out[i].release();
+        return true;
+    });
+}
+
 RLM_API realm_query_t* realm_results_get_query(realm_results_t* results)
 {
     return wrap_err([&]() {
@@ -603,6 +692,60 @@ RLM_API bool realm_results_average(realm_results_t* results, realm_property_key_
     });
 }
 
+RLM_API realm_group_by_result_t* realm_results_group_by(realm_results_t* results, realm_property_key_t group_property,
+                                                        const realm_aggregate_t* aggregates, size_t num_aggregates)
+{
+    return wrap_err([&]() {
+        std::vector<GroupByAggregate> aggs;
+        aggs.reserve(num_aggregates);
+        for (size_t i = 0; i < num_aggregates; ++i) {
+            GroupByAggregate::Type type;
+            switch (aggregates[i].type) {
+                case RLM_AGGREGATE_SUM:
+                    type = GroupByAggregate::Type::Sum;
+                    break;
+                case RLM_AGGREGATE_MIN:
+                    type = GroupByAggregate::Type::Min;
+                    break;
+                case RLM_AGGREGATE_MAX:
+                    type = GroupByAggregate::Type::Max;
+                    break;
+                case RLM_AGGREGATE_AVERAGE:
+                    type = GroupByAggregate::Type::Average;
+                    break;
+                default:
+                    throw InvalidArgument(util::format("Invalid aggregate type %1", int(aggregates[i].type)));
+            }
+            aggs.push_back({type, ColKey(aggregates[i].property)});
+        }
+        return new realm_group_by_result_t{results->group_by(ColKey(group_property), aggs)};
+    });
+}
+
+RLM_API size_t realm_group_by_result_size(const realm_group_by_result_t* result)
+{
+    return result->groups.size();
+}
+
+RLM_API bool realm_group_by_result_get(const realm_group_by_result_t* result, size_t index, realm_value_t* out_key,
+                                       size_t* out_count, realm_value_t* out_values)
+{
+    return wrap_err([&]() {
+        if (index >= result->groups.size())
+            throw OutOfBounds("realm_group_by_result_get()", index, result->groups.size());
+        auto& group = result->groups[index];
+        if (out_key)
+            *out_key = to_capi(group.key);
+        if (out_count)
+            *out_count = group.count;
+        if (out_values) {
+            for (size_t i = 0; i < group.values.size(); ++i)
+                out_values[i] = to_capi(group.values[i]);
+        }
+        return true;
+    });
+}
+
 RLM_API realm_results_t* realm_results_from_thread_safe_reference(const realm_t* realm,
                                                                   realm_thread_safe_reference_t* tsr)
 {
@@ -54,6 +54,35 @@ RLM_API bool realm_get_num_versions(const realm_t* realm, uint64_t* out_versions
     });
 }
 
+RLM_API bool realm_get_storage_metrics(const realm_t* realm, realm_storage_metrics_t* out_metrics)
+{
+    return wrap_err([&]() {
+        auto metrics = (*realm)->get_storage_metrics();
+        out_metrics->commits = metrics.commits.commits;
+        out_metrics->bytes_written = metrics.commits.bytes_written;
+        out_metrics->last_commit_bytes_written = metrics.commits.last_bytes_written;
+        out_metrics->write_group_time = metrics.commits.write_group_time.count();
+        out_metrics->free_list_time = metrics.commits.free_list_time.count();
+        out_metrics->sync_time = metrics.commits.sync_time.count();
+        out_metrics->max_commit_time = metrics.commits.max_commit_time.count();
+        out_metrics->write_lock_acquisitions = metrics.write_lock_wait.acquisitions;
+        out_metrics->write_lock_wait_time = metrics.write_lock_wait.total_wait.count();
+        out_metrics->write_lock_max_wait_time = metrics.write_lock_wait.max_wait.count();
+        out_metrics->local_read_lock_acquisitions = metrics.read_locks.local_acquisitions;
+        out_metrics->lock_file_read_lock_acquisitions = metrics.read_locks.lock_file_acquisitions;
+        out_metrics->live_versions = metrics.live_versions;
+        out_metrics->version_list_capacity = metrics.version_list_capacity;
+        out_metrics->num_mappings = metrics.mappings.num_mappings;
+        out_metrics->mapped_size = metrics.mappings.mapped_size;
+        out_metrics->num_old_mappings = metrics.mappings.num_old_mappings;
+        out_metrics->old_mapped_size = metrics.mappings.old_mapped_size;
+        out_metrics->total_slab_size = metrics.total_slab_size;
+        out_metrics->decrypted_pages = metrics.decrypted_pages;
+        out_metrics->decryption_page_faults = metrics.decryption_page_faults;
+        return true;
+    });
+}
+
 RLM_API const char* realm_get_library_version()
 {
     return REALM_VERSION_STRING;
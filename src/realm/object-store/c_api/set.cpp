@@ -83,6 +83,25 @@ RLM_API bool realm_set_insert(realm_set_t* set, realm_value_t value, size_t* out
     });
 }
 
+RLM_API bool realm_set_insert_many(realm_set_t* set, const realm_value_t* values, size_t num_values,
+                                   size_t* out_num_inserted)
+{
+    return wrap_err([&]() {
+        std::vector<Mixed> vals;
+        vals.reserve(num_values);
+        for (size_t i = 0; i < num_values; ++i) {
+            auto val = from_capi(values[i]);
+            check_value_assignable(*set, val);
+            vals.push_back(val);
+        }
+
+        auto num_inserted = set->insert_many_any(vals);
+        if (out_num_inserted)
+            *out_num_inserted = num_inserted;
+        return true;
+    });
+}
+
 RLM_API bool realm_set_erase(realm_set_t* set, realm_value_t value, bool* out_erased)
 {
     return wrap_err([&]() {
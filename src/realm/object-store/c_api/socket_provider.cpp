@@ -81,12 +81,14 @@ struct CAPIWebSocket : sync::WebSocketInterface {
 public:
     CAPIWebSocket(realm_userdata_t userdata, realm_sync_socket_connect_func_t websocket_connect_func,
                   realm_sync_socket_websocket_async_write_func_t websocket_write_func,
+                  realm_sync_socket_websocket_async_write_batch_func_t websocket_write_batch_func,
                   realm_sync_socket_websocket_free_func_t websocket_free_func, realm_websocket_observer_t* observer,
                   sync::WebSocketEndpoint&& endpoint)
         : m_observer(observer)
         , m_userdata(userdata)
         , m_websocket_connect(websocket_connect_func)
         , m_websocket_async_write(websocket_write_func)
+        , m_websocket_async_write_batch(websocket_write_batch_func)
         , m_websocket_free(websocket_free_func)
     {
         realm_websocket_endpoint_t capi_endpoint;
@@ -120,6 +122,22 @@ public:
                                 new realm_sync_socket_write_callback_t(std::move(shared_handler)));
     }
 
+    void async_write_binary_batch(std::vector<util::Span<const char>> messages,
+                                  sync::SyncSocketProvider::FunctionHandler&& handler) final
+    {
+        if (!m_websocket_async_write_batch) {
+            sync::WebSocketInterface::async_write_binary_batch(std::move(messages), std::move(handler));
+            return;
+        }
+        std::vector<realm_sync_socket_buffer_t> buffers;
+        buffers.reserve(messages.size());
+        for (auto& message : messages)
+            buffers.push_back({message.data(), message.size()});
+        auto shared_handler = std::make_shared<sync::SyncSocketProvider::FunctionHandler>(std::move(handler));
+        m_websocket_async_write_batch(m_userdata, m_socket, buffers.data(), buffers.size(),
+                                      new realm_sync_socket_write_callback_t(std::move(shared_handler)));
+    }
+
 private:
     // A pointer to the CAPI implementation's websocket instance. This is provided by
     // the m_websocket_connect() function when this websocket instance is created.
@@ -134,6 +152,7 @@ private:
     realm_userdata_t m_userdata = nullptr;
     realm_sync_socket_connect_func_t m_websocket_connect = nullptr;
     realm_sync_socket_websocket_async_write_func_t m_websocket_async_write = nullptr;
+    realm_sync_socket_websocket_async_write_batch_func_t m_websocket_async_write_batch = nullptr; // Optional
     realm_sync_socket_websocket_free_func_t m_websocket_free = nullptr;
 };
 
@@ -186,6 +205,7 @@ struct CAPISyncSocketProvider : sync::SyncSocketProvider {
     realm_sync_socket_timer_free_func_t m_timer_free = nullptr;
     realm_sync_socket_connect_func_t m_websocket_connect = nullptr;
     realm_sync_socket_websocket_async_write_func_t m_websocket_async_write = nullptr;
+    realm_sync_socket_websocket_async_write_batch_func_t m_websocket_async_write_batch = nullptr; // Optional
     realm_sync_socket_websocket_free_func_t m_websocket_free = nullptr;
 
     CAPISyncSocketProvider() = default;
@@ -198,6 +218,7 @@ struct CAPISyncSocketProvider : sync::SyncSocketProvider {
         , m_timer_free(std::exchange(other.m_timer_free, nullptr))
         , m_websocket_connect(std::exchange(other.m_websocket_connect, nullptr))
         , m_websocket_async_write(std::exchange(other.m_websocket_async_write, nullptr))
+        , m_websocket_async_write_batch(std::exchange(other.m_websocket_async_write_batch, nullptr))
         , m_websocket_free(std::exchange(other.m_websocket_free, nullptr))
     {
         // userdata_free can be null if userdata is not used
@@ -228,8 +249,8 @@ struct CAPISyncSocketProvider : sync::SyncSocketProvider {
     {
         auto capi_observer = std::make_shared<CAPIWebSocketObserver>(std::move(observer));
         return std::make_unique<CAPIWebSocket>(m_userdata, m_websocket_connect, m_websocket_async_write,
-                                               m_websocket_free, new realm_websocket_observer_t(capi_observer),
-                                               std::move(endpoint));
+                                               m_websocket_async_write_batch, m_websocket_free,
+                                               new realm_websocket_observer_t(capi_observer), std::move(endpoint));
     }
 
     void post(FunctionHandler&& handler) final
@@ -272,6 +293,14 @@ RLM_API realm_sync_socket_t* realm_sync_socket_new(
     });
 }
 
+RLM_API void realm_sync_socket_set_websocket_async_write_batch(
+    realm_sync_socket_t* sync_socket, realm_sync_socket_websocket_async_write_batch_func_t websocket_write_batch_func)
+{
+    auto capi_socket_provider = dynamic_cast<CAPISyncSocketProvider*>(sync_socket->get());
+    REALM_ASSERT(capi_socket_provider);
+    capi_socket_provider->m_websocket_async_write_batch = websocket_write_batch_func;
+}
+
 RLM_API void realm_sync_socket_post_complete(realm_sync_socket_post_callback_t* post_handler,
                                              realm_sync_socket_callback_result_e result, const char* reason)
 {
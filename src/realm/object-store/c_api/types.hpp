@@ -13,6 +13,7 @@
 #include <realm/object-store/shared_realm.hpp>
 #include <realm/object-store/thread_safe_reference.hpp>
 #include <realm/object-store/util/scheduler.hpp>
+#include <realm/parser/query_cache.hpp>
 
 #if REALM_ENABLE_SYNC
 
@@ -536,13 +537,35 @@ struct realm_query : realm::c_api::WrapC {
         return m_description.c_str();
     }
 
+    const char* explain_analyze()
+    {
+        m_explanation = realm::Query(query).explain_analyze().to_string();
+        return m_explanation.c_str();
+    }
+
 private:
     realm::util::bind_ptr<realm::DescriptorOrdering> m_ordering;
     std::string m_description;
+    std::string m_explanation;
 
     realm_query(const realm_query&) = default;
 };
 
+struct realm_prepared_query : realm::c_api::WrapC {
+    std::weak_ptr<realm::Realm> weak_realm;
+    realm::TableKey table_key;
+    realm::query_parser::PreparedQuery prepared;
+
+    explicit realm_prepared_query(realm::ConstTableRef table, std::string query_string,
+                                  realm::query_parser::Arguments& args, realm::query_parser::KeyPathMapping mapping,
+                                  std::weak_ptr<realm::Realm> realm)
+        : weak_realm(std::move(realm))
+        , table_key(table->get_key())
+        , prepared(table, std::move(query_string), args, std::move(mapping))
+    {
+    }
+};
+
 struct realm_results : realm::c_api::WrapC, realm::Results {
     explicit realm_results(realm::Results results)
         : realm::Results(std::move(results))
@@ -572,6 +595,18 @@ struct realm_results : realm::c_api::WrapC, realm::Results {
     }
 };
 
+struct realm_group_by_result : realm::c_api::WrapC, realm::GroupByResult {
+    explicit realm_group_by_result(realm::GroupByResult result)
+        : realm::GroupByResult(std::move(result))
+    {
+    }
+
+    realm_group_by_result* clone() const override
+    {
+        return new realm_group_by_result{*this};
+    }
+};
+
 #if REALM_ENABLE_SYNC
 
 struct realm_async_open_task_progress_notification_token : realm::c_api::WrapC {
@@ -216,6 +216,12 @@ std::pair<size_t, bool> Dictionary::insert_any(StringData key, Mixed value)
     return std::make_pair(it.index(), inserted);
 }
 
+size_t Dictionary::insert_many_any(const std::vector<std::pair<Mixed, Mixed>>& entries)
+{
+    verify_in_transaction();
+    return dict().insert_many(entries);
+}
+
 void Dictionary::erase(StringData key)
 {
     verify_in_transaction();
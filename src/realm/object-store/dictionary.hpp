@@ -88,6 +88,7 @@ public:
     template <typename T>
     void insert(StringData key, T value);
     std::pair<size_t, bool> insert_any(StringData key, Mixed value);
+    size_t insert_many_any(const std::vector<std::pair<Mixed, Mixed>>& entries);
 
     template <typename T>
     T get(StringData key) const;
@@ -21,6 +21,7 @@
 
 #include <realm/db_options.hpp>
 #include <realm/util/fifo_helper.hpp>
+#include <realm/util/thread.hpp>
 
 #include <asl.h>
 #include <assert.h>
@@ -171,6 +172,7 @@ ExternalCommitHelper::ExternalCommitHelper(RealmCoordinator& parent, const Realm
     m_shutdown_write_fd = shutdown_pipe[1];
 
     m_thread = std::thread([this] {
+        util::on_thread_start(util::ThreadRole::commit_listener);
         try {
             listen();
         }
@@ -32,6 +32,13 @@ public:
 
     void notify_others();
 
+    // Wake up the notifier of this process only. All processes are woken up
+    // by this implementation.
+    void notify_self()
+    {
+        notify_others();
+    }
+
 private:
     // A RAII holder for a file descriptor which automatically closes the wrapped
     // fd when it's deallocated
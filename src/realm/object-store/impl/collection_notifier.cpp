@@ -71,9 +71,10 @@ util::UniqueFunction<bool(ObjKey)> CollectionNotifier::get_modification_checker(
         };
     }
 
+    util::UniqueFunction<bool(ObjKey)> checker;
     if (all_callbacks_filtered()) {
-        return CollectionKeyPathChangeChecker(info, *root_table, m_related_tables, m_key_path_array,
-                                              m_all_callbacks_filtered);
+        checker = CollectionKeyPathChangeChecker(info, *root_table, m_related_tables, m_key_path_array,
+                                                 m_all_callbacks_filtered);
     }
     else if (any_callbacks_filtered()) {
         // In case we have some callbacks, we need to combine the unfiltered `DeepChangeChecker` with
@@ -82,20 +83,34 @@ util::UniqueFunction<bool(ObjKey)> CollectionNotifier::get_modification_checker(
                                                         m_all_callbacks_filtered);
         DeepChangeChecker deep_change_checker(info, *root_table, m_related_tables, m_key_path_array,
                                               m_all_callbacks_filtered);
-        return [key_path_checker = std::move(key_path_checker),
-                deep_change_checker = std::move(deep_change_checker)](ObjKey object_key) mutable {
+        checker = [key_path_checker = std::move(key_path_checker),
+                   deep_change_checker = std::move(deep_change_checker)](ObjKey object_key) mutable {
             return key_path_checker(object_key) || deep_change_checker(object_key);
         };
     }
+    else {
+        checker = DeepChangeChecker(info, *root_table, m_related_tables, m_key_path_array, m_all_callbacks_filtered);
+    }
 
-    return DeepChangeChecker(info, *root_table, m_related_tables, m_key_path_array, m_all_callbacks_filtered);
+    // Unlike the single table lookup above, these may follow links, so they are timed
+    return [this, checker = std::move(checker)](ObjKey object_key) mutable {
+        auto start = std::chrono::steady_clock::now();
+        bool modified = checker(object_key);
+        m_run_times.deep_change_check += std::chrono::steady_clock::now() - start;
+        return modified;
+    };
 }
 
 util::UniqueFunction<std::vector<ColKey>(ObjKey)>
 CollectionNotifier::get_object_modification_checker(TransactionChangeInfo const& info, ConstTableRef root_table)
 {
-    return ObjectKeyPathChangeChecker(info, *root_table, m_related_tables, m_key_path_array,
-                                      m_all_callbacks_filtered);
+    return [this, checker = ObjectKeyPathChangeChecker(info, *root_table, m_related_tables, m_key_path_array,
+                                                       m_all_callbacks_filtered)](ObjKey object_key) mutable {
+        auto start = std::chrono::steady_clock::now();
+        auto changed_columns = checker(object_key);
+        m_run_times.deep_change_check += std::chrono::steady_clock::now() - start;
+        return changed_columns;
+    };
 }
 
 void CollectionNotifier::recalculate_key_path_array()
@@ -116,6 +131,21 @@ void CollectionNotifier::recalculate_key_path_array()
     }
 }
 
+std::vector<ObjKey> CollectionNotifier::get_callback_objects()
+{
+    std::vector<ObjKey> objects;
+    {
+        util::CheckedLockGuard lock(m_callback_mutex);
+        for (auto& callback : m_callbacks) {
+            if (callback.object_key)
+                objects.push_back(callback.object_key);
+        }
+    }
+    std::sort(objects.begin(), objects.end());
+    objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+    return objects;
+}
+
 bool CollectionNotifier::any_callbacks_filtered() const noexcept
 {
     return m_any_callbacks_filtered;
@@ -166,7 +196,7 @@ static bool all_have_filters(std::vector<NotificationCallback> const& callbacks)
 }
 
 uint64_t CollectionNotifier::add_callback(CollectionChangeCallback callback,
-                                          std::optional<KeyPathArray> key_path_array)
+                                          std::optional<KeyPathArray> key_path_array, ObjKey object_key)
 {
     m_realm->verify_thread();
 
@@ -179,7 +209,7 @@ uint64_t CollectionNotifier::add_callback(CollectionChangeCallback callback,
     }
 
     auto token = m_next_token++;
-    m_callbacks.push_back({std::move(callback), {}, {}, std::move(key_path_array), token, false, false});
+    m_callbacks.push_back({std::move(callback), {}, {}, std::move(key_path_array), token, false, false, object_key});
 
     if (m_callback_index == npos) { // Don't need to wake up if we're already sending notifications
         Realm::Internal::get_coordinator(*m_realm).wake_up_notifier_worker();
@@ -399,10 +429,61 @@ void CollectionNotifier::after_advance()
         auto elapsed = duration_cast<microseconds>(now - m_run_time_point);
         lock.unlock_unchecked();
         log_changeset(m_logger.get(), changes, m_description, elapsed);
+        m_callbacks_delivered.fetch_add(1, std::memory_order_relaxed);
         cb.after(changes);
     });
 }
 
+NotifierStats CollectionNotifier::get_stats() const
+{
+    std::lock_guard lock(m_stats_mutex);
+    NotifierStats stats = m_stats;
+    stats.callbacks_delivered = m_callbacks_delivered.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void CollectionNotifier::record_run(std::string_view name, std::chrono::steady_clock::duration run_time)
+{
+    using namespace std::chrono;
+    auto times = std::exchange(m_run_times, {});
+    auto run_us = duration_cast<microseconds>(run_time);
+    bool is_slow = m_slow_run_threshold.count() > 0 && run_us >= m_slow_run_threshold;
+    {
+        std::lock_guard lock(m_stats_mutex);
+        if (m_stats.runs == 0) {
+            m_stats.name = name;
+            m_stats.description = m_description;
+        }
+        ++m_stats.runs;
+        m_stats.slow_runs += is_slow;
+        m_stats.run_time += run_us;
+        m_stats.max_run_time = std::max(m_stats.max_run_time, run_us);
+        m_stats.query_time += duration_cast<microseconds>(times.query);
+        m_stats.change_calculation_time += duration_cast<microseconds>(times.change_calculation);
+        m_stats.deep_change_check_time += duration_cast<microseconds>(times.deep_change_check);
+    }
+
+    if (m_logger) {
+        m_logger->log(util::LogCategory::notification, util::Logger::Level::debug,
+                      "%1 %2 ran in %3 us (query %4 us, change calculation %5 us, deep change check %6 us)", name,
+                      m_description, run_us.count(), duration_cast<microseconds>(times.query).count(),
+                      duration_cast<microseconds>(times.change_calculation).count(),
+                      duration_cast<microseconds>(times.deep_change_check).count());
+    }
+    if (is_slow) {
+        if (auto logger = m_transaction->get_logger()) {
+            logger->log(util::LogCategory::notification, util::Logger::Level::warn,
+                        "Slow notifier: %1 %2 ran in %3 ms, which exceeds the threshold of %4 ms (query %5 us, "
+                        "change calculation %6 us, deep change check %7 us)",
+                        name, m_description, duration_cast<milliseconds>(run_us).count(),
+                        duration_cast<milliseconds>(m_slow_run_threshold).count(),
+                        duration_cast<microseconds>(times.query).count(),
+                        duration_cast<microseconds>(times.change_calculation).count(),
+                        duration_cast<microseconds>(times.deep_change_check).count());
+        }
+    }
+}
+
 bool CollectionNotifier::is_for_realm(Realm& realm) const noexcept
 {
     std::lock_guard<std::mutex> lock(m_realm_mutex);
@@ -485,6 +566,9 @@ void CollectionNotifier::add_changes(CollectionChangeBuilder change)
             REALM_ASSERT_DEBUG(callback.accumulated_changes.empty());
             callback.skip_next = false;
         }
+        else if (callback.object_key) {
+            callback.accumulated_changes.merge(get_object_changes(callback.object_key));
+        }
         else {
             // Only copy the changeset if there's more callbacks that need it
             if (&callback == &m_callbacks.back())
@@ -538,23 +622,19 @@ void NotifierPackage::after_advance()
         notifier->after_advance();
 }
 
-NotifierRunLogger::NotifierRunLogger(util::Logger* logger, std::string_view name, std::string_view description)
-    : m_logger(logger)
+NotifierRunLogger::NotifierRunLogger(CollectionNotifier& notifier, std::string_view name)
+    : m_notifier(notifier)
     , m_name(name)
-    , m_description(description)
+    , m_start(std::chrono::steady_clock::now())
 {
-    if (logger && logger->would_log(util::Logger::Level::debug)) {
-        m_logger = logger;
-        m_start = std::chrono::steady_clock::now();
-    }
 }
 
 NotifierRunLogger::~NotifierRunLogger()
 {
-    using namespace std::chrono;
-    if (m_logger) {
-        auto now = steady_clock::now();
-        m_logger->log(util::LogCategory::notification, util::Logger::Level::debug, "%1 %2 ran in %3 us", m_name,
-                      m_description, duration_cast<microseconds>(now - m_start).count());
+    try {
+        m_notifier.record_run(m_name, std::chrono::steady_clock::now() - m_start);
+    }
+    catch (...) {
+        // The stats and the logging are only diagnostics
     }
 }
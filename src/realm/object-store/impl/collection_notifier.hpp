@@ -32,6 +32,7 @@
 #include <exception>
 #include <functional>
 #include <mutex>
+#include <string>
 #include <unordered_set>
 #include <chrono>
 
@@ -71,6 +72,33 @@ struct NotificationCallback {
     // Set within a write transaction on the target thread if this callback
     // should not be called with changes for that write. requires m_callback_mutex.
     bool skip_next = false;
+    // For notifiers which observe multiple objects, the object this callback
+    // is for. The callback is then only given the changes to that object.
+    ObjKey object_key = {};
+};
+
+// Where the time of the runs of a notifier on the worker thread went, for
+// finding the notifiers which stall it. See RealmCoordinator::get_notifier_stats().
+struct NotifierStats {
+    // The notifier type and what it observes, e.g. the query of a Results.
+    std::string name;
+    std::string description;
+
+    size_t runs = 0;
+    // Runs which took longer than RealmConfig::slow_notifier_threshold.
+    size_t slow_runs = 0;
+    std::chrono::microseconds run_time{0};
+    std::chrono::microseconds max_run_time{0};
+
+    // The parts of `run_time` spent rerunning the query (or sorting the
+    // collection), calculating the changes to the collection, and, as part of
+    // that, checking whether objects were modified through links or key paths.
+    std::chrono::microseconds query_time{0};
+    std::chrono::microseconds change_calculation_time{0};
+    std::chrono::microseconds deep_change_check_time{0};
+
+    // The number of times a callback of the notifier was called.
+    size_t callbacks_delivered = 0;
 };
 
 // A base class for a notifier that keeps a collection up to date and/or
@@ -98,11 +126,12 @@ public:
      * @param key_path_array An array of all key paths that should be filtered for. If a changed
      *                       table/column combination is not part of the `key_path_array`, no
      *                       notification will be sent.
+     * @param object_key For notifiers observing multiple objects, the object the callback is for.
      *
      * @return A token which can be passed to `remove_callback()`.
      */
-    uint64_t add_callback(CollectionChangeCallback callback, std::optional<KeyPathArray> key_path_array)
-        REQUIRES(!m_callback_mutex);
+    uint64_t add_callback(CollectionChangeCallback callback, std::optional<KeyPathArray> key_path_array,
+                          ObjKey object_key = {}) REQUIRES(!m_callback_mutex);
 
     /**
      * Remove a previously added token.
@@ -187,6 +216,16 @@ public:
         return *m_transaction;
     }
 
+    // Runs which take longer than this are logged as slow. Zero disables this.
+    // precondition: RealmCoordinator::m_notifier_mutex is locked
+    void set_slow_run_threshold(std::chrono::microseconds threshold) noexcept
+    {
+        m_slow_run_threshold = threshold;
+    }
+
+    // Can be called from any thread.
+    NotifierStats get_stats() const;
+
 protected:
     void add_changes(CollectionChangeBuilder change) REQUIRES(!m_callback_mutex);
     std::unique_lock<std::mutex> lock_target();
@@ -197,6 +236,9 @@ protected:
 
     bool any_related_table_was_modified(TransactionChangeInfo const&) const noexcept;
 
+    // The distinct objects which callbacks were added for with an `object_key`.
+    std::vector<ObjKey> get_callback_objects() REQUIRES(!m_callback_mutex);
+
     // Creates and returns a `DeepChangeChecker` or `KeyPathChecker` depending on the given KeyPathArray.
     util::UniqueFunction<bool(ObjKey)> get_modification_checker(TransactionChangeInfo const&, ConstTableRef)
         REQUIRES(!m_callback_mutex);
@@ -220,6 +262,15 @@ protected:
     std::string m_description;
     std::chrono::steady_clock::time_point m_run_time_point;
 
+    // The parts of the run in progress, see NotifierStats. Only accessed by
+    // run() and the NotifierRunLogger it creates.
+    struct RunTimes {
+        std::chrono::steady_clock::duration query{0};
+        std::chrono::steady_clock::duration change_calculation{0};
+        std::chrono::steady_clock::duration deep_change_check{0};
+    };
+    RunTimes m_run_times;
+
     // The actual change, calculated in run() and delivered in prepare_handover()
     CollectionChangeBuilder m_change;
 
@@ -239,6 +290,12 @@ private:
     {
         return true;
     }
+    // The changes to deliver to the callbacks added for `object_key`, for
+    // notifiers which observe multiple objects.
+    virtual CollectionChangeBuilder get_object_changes(ObjKey)
+    {
+        return {};
+    }
     // Iterate over m_callbacks and call the given function on each one. This
     // does fancy locking things to allow fn to drop the lock before invoking
     // the callback (which must be done to avoid deadlocks).
@@ -290,6 +347,14 @@ private:
     size_t m_callback_count GUARDED_BY(m_callback_mutex) = -1;
 
     uint64_t m_next_token GUARDED_BY(m_callback_mutex) = 0;
+
+    std::chrono::microseconds m_slow_run_threshold{0};
+    mutable std::mutex m_stats_mutex;
+    NotifierStats m_stats; // Guarded by m_stats_mutex
+    std::atomic<size_t> m_callbacks_delivered = 0;
+
+    void record_run(std::string_view name, std::chrono::steady_clock::duration run_time);
+    friend class NotifierRunLogger;
 };
 
 // A smart pointer to a CollectionNotifier that unregisters the notifier when
@@ -381,15 +446,32 @@ private:
     RealmCoordinator* m_coordinator = nullptr;
 };
 
+// Times a run of a notifier, adds it to the notifier's stats, logs it at debug
+// level, and logs it as slow if it exceeds the notifier's slow run threshold.
 class NotifierRunLogger {
 public:
-    NotifierRunLogger(util::Logger* logger, std::string_view name, std::string_view description);
+    NotifierRunLogger(CollectionNotifier& notifier, std::string_view name);
     ~NotifierRunLogger();
 
+    // Time the given function as one of the parts of the run in
+    // CollectionNotifier::RunTimes
+    template <typename Fn>
+    decltype(auto) time(std::chrono::steady_clock::duration& part, Fn&& fn)
+    {
+        struct Timer {
+            std::chrono::steady_clock::duration& part;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            ~Timer()
+            {
+                part += std::chrono::steady_clock::now() - start;
+            }
+        } timer{part};
+        return fn();
+    }
+
 private:
-    util::Logger* m_logger;
+    CollectionNotifier& m_notifier;
     std::string_view m_name;
-    std::string_view m_description;
     std::chrono::steady_clock::time_point m_start;
 };
 
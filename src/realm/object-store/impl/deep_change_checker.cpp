@@ -369,6 +369,38 @@ CollectionKeyPathChangeChecker::CollectionKeyPathChangeChecker(TransactionChange
                                                                bool all_callbacks_filtered)
     : DeepChangeChecker(info, root_table, related_tables, key_path_array, all_callbacks_filtered)
 {
+    m_compiled_key_paths.reserve(key_path_array.size());
+    for (auto& key_path : key_path_array) {
+        m_compiled_key_paths.push_back(compile(key_path));
+    }
+}
+
+CollectionKeyPathChangeChecker::CompiledKeyPath
+CollectionKeyPathChangeChecker::compile(const KeyPath& key_path) const
+{
+    CompiledKeyPath compiled{&key_path, {}, std::vector<bool>(key_path.size() + 1, false)};
+    compiled.changes.reserve(key_path.size());
+    for (auto& [table_key, column_key] : key_path) {
+        auto it = m_info.tables.find(table_key);
+        compiled.changes.push_back(it != m_info.tables.end() ? &it->second : nullptr);
+    }
+
+    // For the special case of having a backlink at the end of a key path the origin table is checked too.
+    // Modifications to a backlink are found via the changes on the origin table.
+    if (!key_path.empty() && key_path.back().second.get_type() == col_type_BackLink) {
+        auto [table_key, column_key] = key_path.back();
+        auto table = m_root_table.get_parent_group()->get_table(table_key);
+        auto it = m_info.tables.find(table->get_opposite_table_key(column_key));
+        compiled.may_change_from.back() = it != m_info.tables.end() && !it->second.empty();
+    }
+
+    for (size_t depth = key_path.size(); depth > 0; --depth) {
+        auto changes = compiled.changes[depth - 1];
+        bool may_change = changes && (!changes->insertions_empty() ||
+                                      changes->column_maybe_modified(key_path[depth - 1].second));
+        compiled.may_change_from[depth - 1] = may_change || compiled.may_change_from[depth];
+    }
+    return compiled;
 }
 
 bool CollectionKeyPathChangeChecker::operator()(ObjKey object_key)
@@ -381,48 +413,41 @@ bool CollectionKeyPathChangeChecker::operator()(ObjKey object_key)
         return false;
     }
 
-    for (auto& key_path : m_key_path_array) {
-        find_changed_columns(changed_columns, key_path, 0, m_root_table, object_key);
+    for (auto& compiled_key_path : m_compiled_key_paths) {
+        find_changed_columns(changed_columns, compiled_key_path, 0, m_root_table, object_key);
+        if (changed_columns.size() > 0) {
+            return true;
+        }
     }
 
-    return changed_columns.size() > 0;
+    return false;
 }
 
 void CollectionKeyPathChangeChecker::find_changed_columns(std::vector<ColKey>& changed_columns,
-                                                          const KeyPath& key_path, size_t depth, const Table& table,
-                                                          const ObjKey& object_key)
+                                                          const CompiledKeyPath& compiled_key_path, size_t depth,
+                                                          const Table& table, const ObjKey& object_key)
 {
     REALM_ASSERT(!object_key.is_unresolved());
 
-    if (depth >= key_path.size()) {
-        // We've reached the end of the key path.
-
-        // For the special case of having a backlink at the end of a key path we need to check this level too.
-        // Modifications to a backlink are found via the insertions on the origin table (which we are in right
-        // now).
-        auto last_key_path_element = key_path[key_path.size() - 1];
-        auto last_column_key = last_key_path_element.second;
-        if (last_column_key.get_type() == col_type_BackLink) {
-            auto iterator = m_info.tables.find(table.get_key());
-            auto table_has_changed = [iterator] {
-                return !iterator->second.insertions_empty() || !iterator->second.modifications_empty() ||
-                       !iterator->second.deletions_empty();
-            };
-            if (iterator != m_info.tables.end() && table_has_changed()) {
-                ColKey root_column_key = key_path[0].second;
-                changed_columns.push_back(root_column_key);
-            }
-        }
+    // Nothing on the remainder of the key path was changed, so there is no need to traverse it.
+    if (!compiled_key_path.may_change_from[depth]) {
+        return;
+    }
 
+    const KeyPath& key_path = *compiled_key_path.key_path;
+    if (depth >= key_path.size()) {
+        // We've reached the end of the key path, which ends in a backlink whose origin table was changed.
+        ColKey root_column_key = key_path[0].second;
+        changed_columns.push_back(root_column_key);
         return;
     }
 
-    auto [table_key, column_key] = key_path.at(depth);
+    auto column_key = key_path[depth].second;
 
     // Check for a change on the current depth level.
-    auto iterator = m_info.tables.find(table_key);
-    if (iterator != m_info.tables.end() && (iterator->second.modifications_contains(object_key, {column_key}) ||
-                                            iterator->second.insertions_contains(object_key))) {
+    auto changes = compiled_key_path.changes[depth];
+    if (changes &&
+        (changes->modifications_contains_column(object_key, column_key) || changes->insertions_contains(object_key))) {
         // If an object linked to the root object was changed we only mark the
         // property of the root objects as changed.
         // This is also the reason why we can return right after doing so because we would only mark the same root
@@ -448,7 +473,7 @@ void CollectionKeyPathChangeChecker::find_changed_columns(std::vector<ColKey>& c
             auto target_table_key = mixed_object.get_link().get_table_key();
             Group* group = table.get_parent_group();
             auto target_table = group->get_table(target_table_key);
-            find_changed_columns(changed_columns, key_path, depth + 1, *target_table, object_key);
+            find_changed_columns(changed_columns, compiled_key_path, depth + 1, *target_table, object_key);
         }
     };
 
@@ -468,7 +493,7 @@ void CollectionKeyPathChangeChecker::find_changed_columns(std::vector<ColKey>& c
             auto target_table = table.get_link_target(column_key);
             for (size_t i = 0; i < list.size(); i++) {
                 auto target_object = list.get(i);
-                find_changed_columns(changed_columns, key_path, depth + 1, *target_table, target_object);
+                find_changed_columns(changed_columns, compiled_key_path, depth + 1, *target_table, target_object);
             }
         }
     }
@@ -484,7 +509,7 @@ void CollectionKeyPathChangeChecker::find_changed_columns(std::vector<ColKey>& c
             auto set = object.get_linkset(column_key);
             auto target_table = table.get_link_target(column_key);
             for (auto& target_object : set) {
-                find_changed_columns(changed_columns, key_path, depth + 1, *target_table, target_object);
+                find_changed_columns(changed_columns, compiled_key_path, depth + 1, *target_table, target_object);
             }
         }
     }
@@ -505,7 +530,7 @@ void CollectionKeyPathChangeChecker::find_changed_columns(std::vector<ColKey>& c
             return;
         }
         auto target_table = table.get_link_target(column_key);
-        find_changed_columns(changed_columns, key_path, depth + 1, *target_table, target_object);
+        find_changed_columns(changed_columns, compiled_key_path, depth + 1, *target_table, target_object);
     }
     else if (column_type == col_type_BackLink) {
         // A backlink can have multiple origin objects. We need to iterate over all of them.
@@ -514,7 +539,7 @@ void CollectionKeyPathChangeChecker::find_changed_columns(std::vector<ColKey>& c
         size_t backlink_count = object.get_backlink_count(*origin_table, origin_column_key);
         for (size_t i = 0; i < backlink_count; i++) {
             auto origin_object = object.get_backlink(*origin_table, origin_column_key, i);
-            find_changed_columns(changed_columns, key_path, depth + 1, *origin_table, origin_object);
+            find_changed_columns(changed_columns, compiled_key_path, depth + 1, *origin_table, origin_object);
         }
     }
     else {
@@ -534,8 +559,8 @@ std::vector<ColKey> ObjectKeyPathChangeChecker::operator()(ObjKey object_key)
 {
     std::vector<ColKey> changed_columns;
 
-    for (auto& key_path : m_key_path_array) {
-        find_changed_columns(changed_columns, key_path, 0, m_root_table, object_key);
+    for (auto& compiled_key_path : m_compiled_key_paths) {
+        find_changed_columns(changed_columns, compiled_key_path, 0, m_root_table, object_key);
     }
 
     return changed_columns;
@@ -219,18 +219,34 @@ public:
 private:
     friend class ObjectKeyPathChangeChecker;
 
+    /**
+     * A `KeyPath` prepared for the changes of the current transaction when the checker is created. It holds the
+     * `ObjectChangeSet` of the table at every step of the key path, so that it does not have to be looked up for
+     * every object, and `may_change_from[depth]` tells if any step from `depth` on can contain a change at all
+     * according to the column summaries of those change sets.
+     */
+    struct CompiledKeyPath {
+        const KeyPath* key_path;
+        std::vector<ObjectChangeSet const*> changes;
+        // Has one more entry than `key_path`, for a backlink at the end of the key path.
+        std::vector<bool> may_change_from;
+    };
+    std::vector<CompiledKeyPath> m_compiled_key_paths;
+
+    CompiledKeyPath compile(const KeyPath& key_path) const;
+
     /**
      * Traverses down a given `KeyPath` and checks the objects along the way for changes.
      *
      * @param changed_columns The list of `ColKeyType`s that was changed in the root object.
      *                        A key will be added to this list if it turns out to be changed.
-     * @param key_path The `KeyPath` used to traverse the given object with.
+     * @param compiled_key_path The `KeyPath` used to traverse the given object with.
      * @param depth The current depth in the key_path.
      * @param table The `TableKey` for the current depth.
      * @param object_key_value The `ObjKeyType` that is to be checked for changes.
      */
-    void find_changed_columns(std::vector<ColKey>& changed_columns, const KeyPath& key_path, size_t depth,
-                              const Table& table, const ObjKey& object_key_value);
+    void find_changed_columns(std::vector<ColKey>& changed_columns, const CompiledKeyPath& compiled_key_path,
+                              size_t depth, const Table& table, const ObjKey& object_key_value);
 };
 
 /**
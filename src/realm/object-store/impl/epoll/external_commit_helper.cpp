@@ -22,6 +22,7 @@
 
 #include <realm/util/assert.hpp>
 #include <realm/util/checked_mutex.hpp>
+#include <realm/util/thread.hpp>
 #include <realm/db.hpp>
 
 #include <algorithm>
@@ -30,6 +31,7 @@
 #include <sstream>
 #include <stdlib.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/time.h>
 #include <unistd.h>
 
@@ -81,6 +83,10 @@ void notify_fd(int fd, bool read_first = true)
                         break;
                     throw std::system_error(err, std::system_category());
                 }
+                // A read from a pipe returns less than requested only when it has emptied it, so there is no
+                // need for another read to find out
+                if (size_t(actual) < sizeof(buff))
+                    break;
             }
         }
 
@@ -105,8 +111,8 @@ public:
     DaemonThread();
     ~DaemonThread();
 
-    void add(int fd, RealmCoordinator*) REQUIRES(!m_mutex);
-    void remove(int fd, RealmCoordinator*) REQUIRES(!m_mutex, !m_running_on_change_mutex);
+    void add(std::initializer_list<int> fds, RealmCoordinator*) REQUIRES(!m_mutex);
+    void remove(std::initializer_list<int> fds, RealmCoordinator*) REQUIRES(!m_mutex, !m_running_on_change_mutex);
 
     static DaemonThread& shared();
 
@@ -168,6 +174,7 @@ DaemonThread::DaemonThread()
     }
 
     m_thread = std::thread([this] {
+        util::on_thread_start(util::ThreadRole::commit_listener);
         try {
             listen();
         }
@@ -197,24 +204,26 @@ DaemonThread& DaemonThread::shared()
     return daemon_thread;
 }
 
-void DaemonThread::add(int fd, RealmCoordinator* coordinator)
+void DaemonThread::add(std::initializer_list<int> fds, RealmCoordinator* coordinator)
 {
     {
         util::CheckedLockGuard lock(m_mutex);
         m_live_coordinators.push_back(coordinator);
     }
 
-    epoll_event event{};
-    event.events = EPOLLIN | EPOLLET;
-    event.data.ptr = coordinator;
-    int ret = epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event);
-    if (ret != 0) {
-        int err = errno;
-        throw std::system_error(err, std::system_category());
+    for (int fd : fds) {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = coordinator;
+        int ret = epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        if (ret != 0) {
+            int err = errno;
+            throw std::system_error(err, std::system_category());
+        }
     }
 }
 
-void DaemonThread::remove(int fd, RealmCoordinator* coordinator)
+void DaemonThread::remove(std::initializer_list<int> fds, RealmCoordinator* coordinator)
 {
     {
         util::CheckedLockGuard lock_1(m_running_on_change_mutex);
@@ -225,7 +234,8 @@ void DaemonThread::remove(int fd, RealmCoordinator* coordinator)
             m_live_coordinators.erase(it);
         }
     }
-    epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    for (int fd : fds)
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
 }
 
 void DaemonThread::listen()
@@ -332,15 +342,41 @@ ExternalCommitHelper::ExternalCommitHelper(RealmCoordinator& parent, const Realm
 
     make_non_blocking(m_notify_fd);
 
-    DaemonThread::shared().add(m_notify_fd, &m_parent);
+    m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wake_fd == -1) {
+        throw std::system_error(errno, std::system_category());
+    }
+
+    DaemonThread::shared().add({m_notify_fd, m_wake_fd}, &m_parent);
 }
 
 ExternalCommitHelper::~ExternalCommitHelper()
 {
-    DaemonThread::shared().remove(m_notify_fd, &m_parent);
+    DaemonThread::shared().remove({m_notify_fd, m_wake_fd}, &m_parent);
 }
 
 void ExternalCommitHelper::notify_others()
 {
     notify_fd(m_notify_fd);
 }
+
+void ExternalCommitHelper::notify_self()
+{
+    // Every write to an eventfd is reported by an edge-triggered epoll, even
+    // if the counter was already nonzero, so it never needs to be read.
+    // Wakeups which arrive before the listener has picked up the previous one
+    // are reported together, and so result in a single call to on_change().
+    uint64_t value = 1;
+    while (write(m_wake_fd, &value, sizeof(value)) < 0) {
+        int err = errno;
+        if (err == EINTR)
+            continue;
+        if (err == EAGAIN) {
+            // The counter is about to overflow, which needs ~2^64 wakeups
+            uint64_t discard;
+            static_cast<void>(read(m_wake_fd, &discard, sizeof(discard)));
+            continue;
+        }
+        throw std::system_error(err, std::system_category());
+    }
+}
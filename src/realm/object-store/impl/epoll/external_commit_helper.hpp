@@ -60,6 +60,9 @@ public:
     ~ExternalCommitHelper();
 
     void notify_others();
+    // Wake up the notifier of this process only, without making the other
+    // processes look for changes
+    void notify_self();
 
 private:
     RealmCoordinator& m_parent;
@@ -67,6 +70,10 @@ private:
     // Read-write file descriptor for the named pipe which is waited on for
     // changes and written to when a commit is made
     FdHolder m_notify_fd;
+
+    // Eventfd which is waited on along with the named pipe, and written to
+    // when only this process needs to be woken up
+    FdHolder m_wake_fd;
 };
 
 } // namespace _impl
@@ -34,6 +34,13 @@ public:
     // A no-op in this version, but needed for the Apple version
     void notify_others();
 
+    // Wake up the notifier of this process only. All processes are woken up
+    // by this implementation.
+    void notify_self()
+    {
+        notify_others();
+    }
+
 private:
     RealmCoordinator& m_parent;
 
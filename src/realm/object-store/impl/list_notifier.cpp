@@ -33,12 +33,11 @@ ListNotifier::ListNotifier(std::shared_ptr<Realm> realm, CollectionBase const& l
     , m_prev_size(list.size())
 {
     attach(list);
+    auto path = m_list->get_short_path();
+    auto prop_name = m_list->get_table()->get_column_name(path[0].get_col_key());
+    path[0] = PathElement(prop_name);
+    m_description = util::format("%1 %2%3", list.get_collection_type(), m_list->get_obj().get_id(), path);
     if (m_logger && m_logger->would_log(util::Logger::Level::debug)) {
-        auto path = m_list->get_short_path();
-        auto prop_name = m_list->get_table()->get_column_name(path[0].get_col_key());
-        path[0] = PathElement(prop_name);
-
-        m_description = util::format("%1 %2%3", list.get_collection_type(), m_list->get_obj().get_id(), path);
         m_logger->log(util::LogCategory::notification, util::Logger::Level::debug,
                       "Creating CollectionNotifier for %1", m_description);
     }
@@ -94,7 +93,7 @@ bool ListNotifier::do_add_required_change_info(TransactionChangeInfo& info)
 
 void ListNotifier::run()
 {
-    NotifierRunLogger log(m_logger.get(), "ListNotifier", m_description);
+    NotifierRunLogger log(*this, "ListNotifier");
 
     if (!m_list || !m_list->is_attached()) {
         // List was deleted, so report all of the rows being removed if this is
@@ -113,21 +112,23 @@ void ListNotifier::run()
     m_prev_size = m_list->size();
 
     if (m_info && m_type == PropertyType::Object) {
-        auto object_did_change = get_modification_checker(*m_info, m_list->get_target_table());
-        for (size_t i = 0; i < m_prev_size; ++i) {
-            if (m_change.modifications.contains(i))
-                continue;
-            auto m = m_list->get_any(i);
-            if (!m.is_null() && object_did_change(m.get<ObjKey>()))
-                m_change.modifications.add(i);
-        }
-
-        for (auto const& move : m_change.moves) {
-            if (m_change.modifications.contains(move.to))
-                continue;
-            if (object_did_change(m_list->get_any(move.to).get<ObjKey>()))
-                m_change.modifications.add(move.to);
-        }
+        log.time(m_run_times.change_calculation, [&] {
+            auto object_did_change = get_modification_checker(*m_info, m_list->get_target_table());
+            for (size_t i = 0; i < m_prev_size; ++i) {
+                if (m_change.modifications.contains(i))
+                    continue;
+                auto m = m_list->get_any(i);
+                if (!m.is_null() && object_did_change(m.get<ObjKey>()))
+                    m_change.modifications.add(i);
+            }
+
+            for (auto const& move : m_change.moves) {
+                if (m_change.modifications.contains(move.to))
+                    continue;
+                if (object_did_change(m_list->get_any(move.to).get<ObjKey>()))
+                    m_change.modifications.add(move.to);
+            }
+        });
     }
 
     // Modifications to nested values in Mixed are recorded in replication as
@@ -29,8 +29,8 @@ ObjectNotifier::ObjectNotifier(std::shared_ptr<Realm> realm, const Obj& obj)
     , m_table(obj.get_table())
     , m_obj_key(obj.get_key())
 {
+    m_description = obj.get_id();
     if (m_logger) {
-        m_description = obj.get_id();
         m_logger->log(util::LogCategory::notification, util::Logger::Level::debug, "Creating ObjectNotifier for %1",
                       m_description);
     }
@@ -64,7 +64,7 @@ void ObjectNotifier::run()
 {
     if (!m_table || !m_info)
         return;
-    NotifierRunLogger log(m_logger.get(), "ObjectNotifier", m_description);
+    NotifierRunLogger log(*this, "ObjectNotifier");
 
     auto it = m_info->tables.find(m_table->get_key());
     if (it != m_info->tables.end() && it->second.deletions_contains(m_obj_key)) {
@@ -110,3 +110,98 @@ void ObjectNotifier::run()
         m_change.columns[col.value].add(0);
     }
 }
+
+MultiObjectNotifier::MultiObjectNotifier(std::shared_ptr<Realm> realm, ConstTableRef table)
+    : CollectionNotifier(std::move(realm))
+    , m_table(table.cast_away_const())
+{
+    m_description = m_table->get_class_name();
+    if (m_logger) {
+        m_logger->log(util::LogCategory::notification, util::Logger::Level::debug,
+                      "Creating MultiObjectNotifier for %1", m_description);
+    }
+}
+
+void MultiObjectNotifier::reattach()
+{
+    REALM_ASSERT(m_table);
+    m_table = transaction().get_table(m_table->get_key());
+}
+
+bool MultiObjectNotifier::do_add_required_change_info(TransactionChangeInfo& info)
+{
+    m_info = &info;
+    info.tables[m_table->get_key()];
+
+    util::CheckedLockGuard lock(m_callback_mutex);
+    if (m_did_modify_callbacks) {
+        update_related_tables(*m_table);
+    }
+
+    return true;
+}
+
+CollectionChangeBuilder MultiObjectNotifier::get_object_changes(ObjKey object_key)
+{
+    auto it = m_object_changes.find(object_key);
+    return it != m_object_changes.end() ? it->second : CollectionChangeBuilder();
+}
+
+void MultiObjectNotifier::run()
+{
+    m_object_changes.clear();
+    if (!m_info)
+        return;
+    NotifierRunLogger log(*this, "MultiObjectNotifier");
+
+    auto it = m_info->tables.find(m_table->get_key());
+    const ObjectChangeSet* table_changes = it != m_info->tables.end() ? &it->second : nullptr;
+    bool filtered = any_callbacks_filtered();
+    // Without key path filters only changes to the observed objects themselves
+    // are reported, so there is nothing to do if the table was not changed.
+    if (!filtered && (!table_changes || table_changes->empty()))
+        return;
+    if (filtered && !any_related_table_was_modified(*m_info))
+        return;
+
+    util::UniqueFunction<std::vector<ColKey>(ObjKey)> object_change_checker;
+    if (filtered)
+        object_change_checker = get_object_modification_checker(*m_info, m_table);
+
+    auto objects = get_callback_objects();
+    // Forget about deleted objects which are no longer observed
+    for (auto deleted = m_deleted_objects.begin(); deleted != m_deleted_objects.end();) {
+        if (std::binary_search(objects.begin(), objects.end(), *deleted))
+            ++deleted;
+        else
+            deleted = m_deleted_objects.erase(deleted);
+    }
+
+    for (auto object_key : objects) {
+        if (m_deleted_objects.count(object_key))
+            continue;
+        if (table_changes && table_changes->deletions_contains(object_key)) {
+            m_object_changes[object_key].deletions.add(0);
+            m_deleted_objects.insert(object_key);
+            continue;
+        }
+
+        CollectionChangeBuilder change;
+        if (filtered) {
+            for (auto changed_column : object_change_checker(object_key)) {
+                change.modifications.add(0);
+                change.columns[changed_column.value].add(0);
+            }
+        }
+        if (!all_callbacks_filtered() && table_changes) {
+            if (auto column_modifications = table_changes->get_columns_modified(object_key)) {
+                change.modifications.add(0);
+                for (auto col : *column_modifications) {
+                    change.columns[col.value].add(0);
+                }
+            }
+        }
+        if (!change.empty())
+            m_object_changes.emplace(object_key, std::move(change));
+    }
+}
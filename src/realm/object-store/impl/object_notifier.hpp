@@ -38,6 +38,28 @@ private:
     void reattach() override;
     bool do_add_required_change_info(TransactionChangeInfo& info) override;
 };
+
+// Observes any number of objects in a single table. Each callback is added for
+// one object and receives the same changes as it would from an ObjectNotifier
+// for that object, but the changes for all of the objects are calculated by a
+// single notifier run per commit.
+class MultiObjectNotifier : public CollectionNotifier {
+public:
+    MultiObjectNotifier(std::shared_ptr<Realm> realm, ConstTableRef table);
+
+private:
+    TableRef m_table;
+    TransactionChangeInfo* m_info = nullptr;
+    // Changes calculated by run(), per observed object which was changed
+    std::unordered_map<ObjKey, CollectionChangeBuilder> m_object_changes;
+    // Observed objects which were deleted and have already been reported as such
+    std::unordered_set<ObjKey> m_deleted_objects;
+
+    void run() override REQUIRES(!m_callback_mutex);
+    void reattach() override;
+    bool do_add_required_change_info(TransactionChangeInfo& info) override;
+    CollectionChangeBuilder get_object_changes(ObjKey object_key) override;
+};
 } // namespace realm::_impl
 
 #endif // REALM_OS_OBJECT_NOTIFIER_HPP
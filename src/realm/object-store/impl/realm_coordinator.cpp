@@ -43,10 +43,15 @@
 #include <realm/db.hpp>
 #include <realm/history.hpp>
 #include <realm/string_data.hpp>
+#include <realm/util/alloc_tracking.hpp>
 #include <realm/util/fifo_helper.hpp>
+#include <realm/util/thread.hpp>
+#include <realm/util/trace.hpp>
 #include <realm/sync/config.hpp>
 
 #include <algorithm>
+#include <map>
+#include <thread>
 #include <unordered_map>
 
 using namespace realm;
@@ -426,6 +431,22 @@ std::shared_ptr<AsyncOpenTask> RealmCoordinator::get_synchronized_realm(Realm::C
                                            db_open_first_time);
 }
 
+void RealmCoordinator::prepare_for_async_open()
+{
+    std::shared_ptr<Realm> realm;
+    util::CheckedUniqueLock lock(m_realm_mutex);
+    RealmConfig config(m_config);
+    if (!config.schema || config.migration_function || config.initialization_function)
+        return;
+    // The subscription initializer is run once the Realm has been downloaded
+    if (config.sync_config && config.sync_config->subscription_initializer) {
+        config.sync_config = std::make_shared<SyncConfig>(*config.sync_config);
+        config.sync_config->subscription_initializer = nullptr;
+    }
+    do_get_realm(std::move(config), realm, none, lock);
+    realm->close();
+}
+
 #endif
 
 bool RealmCoordinator::open_db()
@@ -478,6 +499,8 @@ bool RealmCoordinator::open_db()
         options.durability = m_config.in_memory ? DBOptions::Durability::MemOnly : DBOptions::Durability::Full;
         options.is_immutable = m_config.immutable();
         options.logger = util::Logger::get_default_logger();
+        // Frozen Realms at the same version share their transaction
+        options.share_frozen_transactions = true;
 
         if (!m_config.fifo_files_fallback_path.empty()) {
             options.temp_dir = util::normalize_dir(m_config.fifo_files_fallback_path);
@@ -757,9 +780,7 @@ void RealmCoordinator::assert_no_open_realms() noexcept
 void RealmCoordinator::wake_up_notifier_worker()
 {
     if (m_notifier) {
-        // FIXME: this wakes up the notification workers for all processes and
-        // not just us. This might be worth optimizing in the future.
-        m_notifier->notify_others();
+        m_notifier->notify_self();
     }
 }
 
@@ -811,6 +832,33 @@ void RealmCoordinator::commit_write(Realm& realm, bool commit_to_disk)
     // did_change() may have closed the Realm.
 }
 
+void RealmCoordinator::deliver_commit_notifications(Realm& realm)
+{
+    // If callbacks close the Realm the last external reference may go away
+    // while we're in this function
+    auto self = shared_from_this();
+    auto version = realm.current_transaction_version();
+    if (!version)
+        return;
+
+    NotifierVector notifiers;
+    {
+        util::CheckedLockGuard lock(m_notifier_mutex);
+        notifiers = notifiers_for_realm(realm);
+    }
+    if (notifiers.empty())
+        return;
+
+    // Runs the notifiers if they aren't ready for the committed version yet.
+    // The transaction log of the commit was just written by this process, so
+    // advancing the notifier transaction over it doesn't need to wait for
+    // the worker thread to be woken up.
+    package_notifiers(notifiers, version->version);
+    if (notifiers.empty())
+        return;
+    process_available_async(realm);
+}
+
 void RealmCoordinator::enable_wait_for_change()
 {
     m_db->enable_wait_for_change();
@@ -839,10 +887,32 @@ void RealmCoordinator::register_notifier(std::shared_ptr<CollectionNotifier> not
     {
         util::CheckedLockGuard lock(self.m_notifier_mutex);
         notifier->set_initial_transaction(self.m_new_notifiers);
+        notifier->set_slow_run_threshold(self.m_config.slow_notifier_threshold);
         self.m_new_notifiers.push_back(std::move(notifier));
     }
 }
 
+std::vector<NotifierStats> RealmCoordinator::get_notifier_stats()
+{
+    std::vector<NotifierStats> stats;
+    {
+        util::CheckedLockGuard lock(m_notifier_mutex);
+        stats.reserve(m_notifiers.size() + m_new_notifiers.size());
+        for (auto& notifier : m_notifiers) {
+            if (notifier->is_alive())
+                stats.push_back(notifier->get_stats());
+        }
+        for (auto& notifier : m_new_notifiers) {
+            if (notifier->is_alive())
+                stats.push_back(notifier->get_stats());
+        }
+    }
+    std::sort(stats.begin(), stats.end(), [](const NotifierStats& a, const NotifierStats& b) {
+        return a.run_time > b.run_time;
+    });
+    return stats;
+}
+
 void RealmCoordinator::clean_up_dead_notifiers()
 {
     auto swap_remove = [&](auto& container) {
@@ -866,6 +936,7 @@ void RealmCoordinator::clean_up_dead_notifiers()
 
     if (swap_remove(m_notifiers) && m_notifiers.empty()) {
         m_notifier_transaction = nullptr;
+        m_notifier_worker_transactions.clear();
         m_notifier_handover_transaction = nullptr;
         m_notifier_skip_version.reset();
     }
@@ -900,8 +971,31 @@ void RealmCoordinator::on_change()
     }
 }
 
+// If there's multiple notifiers for a single collection, we only populate
+// the data for the first one during parsing and need to copy it to the
+// others. This is a reverse scan where each collection looks for the
+// first collection with the same id. It is O(N^2), but typically the
+// number of collections observed will be very small.
+static void copy_duplicate_collection_changes(TransactionChangeInfo& info)
+{
+    auto id = [](auto const& c) {
+        return std::tie(c.table_key, c.path, c.obj_key);
+    };
+    auto& collections = info.collections;
+    for (size_t i = collections.size(); i > 0; --i) {
+        for (size_t j = 0; j < i - 1; ++j) {
+            if (id(collections[i - 1]) == id(collections[j])) {
+                collections[i - 1].changes->merge(CollectionChangeBuilder{*collections[j].changes});
+                break;
+            }
+        }
+    }
+}
+
 void RealmCoordinator::run_async_notifiers()
 {
+    REALM_TRACE_SCOPE("RealmCoordinator::run_async_notifiers");
+    util::AllocTagScope alloc_tag{util::AllocTag::notifier};
     util::CheckedUniqueLock lock(m_notifier_mutex);
 
     clean_up_dead_notifiers();
@@ -959,18 +1053,19 @@ void RealmCoordinator::run_async_notifiers()
     m_notifiers.insert(m_notifiers.end(), new_notifiers.begin(), new_notifiers.end());
     lock.unlock();
 
-    // Advance all of the new notifiers to the most recent version, if any
-    std::vector<TransactionChangeInfo> new_notifier_change_info;
-    if (!new_notifiers.empty()) {
-        new_notifier_change_info.reserve(new_notifiers.size());
-        for (auto& notifier : new_notifiers) {
-            if (notifier->version() == version)
-                continue;
-            new_notifier_change_info.emplace_back();
-            notifier->add_required_change_info(new_notifier_change_info.back());
-            transaction::parse(*newest_transaction, new_notifier_change_info.back(), notifier->version().version,
-                               version.version);
-        }
+    // Advance all of the new notifiers to the most recent version, if any.
+    // Notifiers added at the same version (e.g. by many threads observing the
+    // same data) share the change info for their version range, so that the
+    // transaction log for each range is only parsed once.
+    std::map<VersionID::version_type, TransactionChangeInfo> new_notifier_change_info;
+    for (auto& notifier : new_notifiers) {
+        if (notifier->version() == version)
+            continue;
+        notifier->add_required_change_info(new_notifier_change_info[notifier->version().version]);
+    }
+    for (auto& [initial_version, info] : new_notifier_change_info) {
+        transaction::parse(*newest_transaction, info, initial_version, version.version);
+        copy_duplicate_collection_changes(info);
     }
 
     // If the skip version is set and we have more than one version to process,
@@ -987,8 +1082,8 @@ void RealmCoordinator::run_async_notifiers()
         for (auto& notifier : notifiers)
             notifier->add_required_change_info(info);
         transaction::advance(*m_notifier_transaction, info, skip_version->get_version_of_current_transaction());
-        for (auto& notifier : notifiers)
-            notifier->run();
+        advance_worker_transactions(skip_version->get_version_of_current_transaction());
+        run_notifiers(notifiers);
 
         util::CheckedLockGuard lock(m_notifier_mutex);
         for (auto& notifier : notifiers)
@@ -1002,46 +1097,24 @@ void RealmCoordinator::run_async_notifiers()
         notifier->add_required_change_info(change_info);
     }
     transaction::advance(*m_notifier_transaction, change_info, version);
+    advance_worker_transactions(version);
 
-    {
-        // If there's multiple notifiers for a single collection, we only populate
-        // the data for the first one during parsing and need to copy it to the
-        // others. This is a reverse scan where each collection looks for the
-        // first collection with the same id. It is O(N^2), but typically the
-        // number of collections observed will be very small.
-        auto id = [](auto const& c) {
-            return std::tie(c.table_key, c.path, c.obj_key);
-        };
-        auto& collections = change_info.collections;
-        for (size_t i = collections.size(); i > 0; --i) {
-            for (size_t j = 0; j < i - 1; ++j) {
-                if (id(collections[i - 1]) == id(collections[j])) {
-                    collections[i - 1].changes->merge(CollectionChangeBuilder{*collections[j].changes});
-                    break;
-                }
-            }
-        }
-    }
+    copy_duplicate_collection_changes(change_info);
 
     // Now that they're at the same version, switch the new notifiers over to
-    // the main Transaction used for background work rather than the temporary one
+    // one of the Transactions used for background work rather than the temporary one
     for (auto& notifier : new_notifiers) {
-        notifier->attach_to(m_notifier_transaction);
-        notifier->run();
+        notifier->attach_to(transaction_for_new_notifier(notifiers, version));
+        notifiers.push_back(notifier);
     }
 
     // Change info is now all ready, so the notifiers can now perform their
     // background work
-    for (auto& notifier : notifiers) {
-        notifier->run();
-    }
+    run_notifiers(notifiers);
 
     // Reacquire the lock while updating the fields that are actually read on
     // other threads
     util::CheckedLockGuard lock2(m_notifier_mutex);
-    for (auto& notifier : new_notifiers) {
-        notifier->prepare_handover();
-    }
     for (auto& notifier : notifiers) {
         notifier->prepare_handover();
     }
@@ -1050,6 +1123,88 @@ void RealmCoordinator::run_async_notifiers()
         m_notifier_handover_transaction = m_db->start_read(version);
 }
 
+std::shared_ptr<Transaction> RealmCoordinator::transaction_for_new_notifier(const NotifierVector& notifiers,
+                                                                           VersionID version)
+{
+    std::unordered_map<Transaction*, size_t> notifiers_per_transaction;
+    notifiers_per_transaction[m_notifier_transaction.get()];
+    for (auto& tr : m_notifier_worker_transactions)
+        notifiers_per_transaction[tr.get()];
+    for (auto& notifier : notifiers)
+        ++notifiers_per_transaction[&notifier->transaction()];
+
+    size_t max_transactions = std::min<size_t>(std::thread::hardware_concurrency(), s_max_notifier_threads);
+    size_t wanted_transactions = notifiers.size() / s_notifiers_per_thread + 1;
+    if (m_notifier_worker_transactions.size() + 1 < std::min(wanted_transactions, max_transactions)) {
+        m_notifier_worker_transactions.push_back(m_db->start_read(version));
+        return m_notifier_worker_transactions.back();
+    }
+
+    auto least_used = m_notifier_transaction;
+    for (auto& tr : m_notifier_worker_transactions) {
+        if (notifiers_per_transaction[tr.get()] < notifiers_per_transaction[least_used.get()])
+            least_used = tr;
+    }
+    return least_used;
+}
+
+void RealmCoordinator::advance_worker_transactions(VersionID version)
+{
+    // The change information comes from advancing m_notifier_transaction, so
+    // the others only have to be brought to the same version
+    for (auto& tr : m_notifier_worker_transactions)
+        tr->advance_read(version);
+}
+
+void RealmCoordinator::run_notifiers(const NotifierVector& notifiers)
+{
+    // A transaction can only be used by one thread at a time, so the notifiers
+    // attached to each transaction run in order on the same thread
+    std::vector<std::vector<CollectionNotifier*>> groups;
+    std::unordered_map<Transaction*, size_t> group_of_transaction;
+    for (auto& notifier : notifiers) {
+        auto [it, inserted] = group_of_transaction.emplace(&notifier->transaction(), groups.size());
+        if (inserted)
+            groups.emplace_back();
+        groups[it->second].push_back(notifier.get());
+    }
+    if (groups.empty())
+        return;
+
+    std::vector<std::exception_ptr> errors(groups.size());
+    auto run_group = [&](size_t g) {
+        try {
+            for (auto notifier : groups[g])
+                notifier->run();
+        }
+        catch (...) {
+            errors[g] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(groups.size() - 1);
+    for (size_t g = 1; g < groups.size(); ++g) {
+        try {
+            threads.emplace_back([&run_group, g] {
+                util::on_thread_start(util::ThreadRole::notifier_worker);
+                run_group(g);
+            });
+        }
+        catch (const std::system_error&) {
+            run_group(g);
+        }
+    }
+    run_group(0);
+    for (auto& t : threads)
+        t.join();
+
+    for (auto& error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
 void RealmCoordinator::advance_to_ready(Realm& realm)
 {
     // If callbacks close the Realm the last external reference may go away
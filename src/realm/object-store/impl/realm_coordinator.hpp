@@ -37,6 +37,7 @@ class Transaction;
 namespace _impl {
 class CollectionNotifier;
 class ExternalCommitHelper;
+struct NotifierStats;
 class WeakRealmNotifier;
 
 // RealmCoordinator manages the weak cache of Realm instances and communication
@@ -75,6 +76,12 @@ public:
     std::shared_ptr<AsyncOpenTask> get_synchronized_realm(Realm::Config config)
         REQUIRES(!m_realm_mutex, !m_schema_cache_mutex);
 
+    // Create the schema of the Realm in the file without running the
+    // subscription initializer, so that an AsyncOpenTask can do it while the
+    // Realm is downloaded. Does nothing if there is no schema, or if creating
+    // it would run user callbacks.
+    void prepare_for_async_open() REQUIRES(!m_realm_mutex, !m_schema_cache_mutex);
+
     std::shared_ptr<SyncSession> sync_session() REQUIRES(!m_realm_mutex)
     {
         util::CheckedLockGuard lock(m_realm_mutex);
@@ -117,6 +124,12 @@ public:
     {
         return m_db->get_number_of_versions();
     }
+    DB::Metrics get_storage_metrics() const
+    {
+        return m_db->get_metrics();
+    }
+    // The run time statistics of the live notifiers, slowest first.
+    std::vector<NotifierStats> get_notifier_stats() REQUIRES(!m_notifier_mutex);
 
     // To avoid having to re-read and validate the file's schema every time a
     // new read transaction is begun, RealmCoordinator maintains a cache of the
@@ -194,6 +207,11 @@ public:
     // other Realm instances for that path, including in other processes
     void commit_write(Realm& realm, bool commit_to_disk = true) REQUIRES(!m_notifier_mutex);
 
+    // Run the Realm's notifiers for the version it just committed on the
+    // calling thread if the worker thread hasn't already, and deliver their
+    // notifications, rather than waiting for the worker thread to wake up
+    void deliver_commit_notifications(Realm& realm) REQUIRES(!m_notifier_mutex, !m_running_notifiers_mutex);
+
     void enable_wait_for_change();
     bool wait_for_change(std::shared_ptr<Transaction> tr);
     void wait_for_change_release();
@@ -247,10 +265,19 @@ private:
     NotifierVector m_notifiers GUARDED_BY(m_notifier_mutex);
     TransactionRef m_notifier_skip_version GUARDED_BY(m_notifier_mutex);
 
+    // Notifiers run on up to this many threads, with a thread for about every
+    // s_notifiers_per_thread notifiers
+    static constexpr size_t s_max_notifier_threads = 8;
+    static constexpr size_t s_notifiers_per_thread = 16;
+
     util::CheckedMutex m_running_notifiers_mutex;
     // Transaction used for actually running async notifiers
     // Will be non-null iff m_notifiers is non-empty
     std::shared_ptr<Transaction> m_notifier_transaction;
+    // Transactions at the same version as m_notifier_transaction which some
+    // of the notifiers are attached to instead, so that the notifiers attached
+    // to each of them can run on a thread of their own
+    std::vector<std::shared_ptr<Transaction>> m_notifier_worker_transactions;
     // Transaction used to pin the version which notifiers are currently ready
     // to deliver to
     std::shared_ptr<Transaction> m_notifier_handover_transaction;
@@ -275,6 +302,13 @@ private:
     void do_get_realm(Realm::Config&& config, std::shared_ptr<Realm>& realm, util::Optional<VersionID> version,
                       util::CheckedUniqueLock& realm_lock, bool first_time_open = false) REQUIRES(m_realm_mutex);
     void run_async_notifiers() REQUIRES(!m_notifier_mutex, m_running_notifiers_mutex);
+    // Pick the transaction a new notifier runs in, spreading the notifiers over
+    // more transactions as their number grows
+    std::shared_ptr<Transaction> transaction_for_new_notifier(const NotifierVector& notifiers, VersionID version)
+        REQUIRES(m_running_notifiers_mutex);
+    void advance_worker_transactions(VersionID version) REQUIRES(m_running_notifiers_mutex);
+    // Run the notifiers, those attached to different transactions in parallel
+    void run_notifiers(const NotifierVector& notifiers) REQUIRES(m_running_notifiers_mutex);
     void clean_up_dead_notifiers() REQUIRES(m_notifier_mutex);
 
     NotifierVector notifiers_for_realm(Realm&) REQUIRES(m_notifier_mutex);
@@ -21,6 +21,7 @@
 #include <realm/object-store/shared_realm.hpp>
 #include <realm/util/scope_exit.hpp>
 
+#include <cmath>
 #include <numeric>
 
 using namespace realm;
@@ -57,6 +58,12 @@ using namespace realm::_impl;
 //     - Reads m_deliver_transaction
 //     - Reads m_deliver_handover
 //     - Reads m_results_were_used
+//
+// The live aggregates follow the same path as the TableView: run() writes
+// m_run_aggregates, do_prepare_handover() moves them to m_handover_aggregates,
+// prepare_to_deliver() to m_delivered_aggregates, and get_live_aggregates()
+// reads them. The set of columns to aggregate can be added to from any thread
+// and is guarded by m_live_aggregates_mutex.
 
 ResultsNotifier::ResultsNotifier(Results& target)
     : ResultsNotifierBase(target.get_realm())
@@ -64,12 +71,12 @@ ResultsNotifier::ResultsNotifier(Results& target)
     , m_descriptor_ordering(target.get_descriptor_ordering())
     , m_target_is_in_table_order(target.is_in_table_order())
 {
+    m_description = "'" + std::string(m_query->get_table()->get_class_name()) + "'";
+    if (m_query->has_conditions()) {
+        m_description += " where \"";
+        m_description += m_query->get_description_safe() + "\"";
+    }
     if (m_logger) {
-        m_description = "'" + std::string(m_query->get_table()->get_class_name()) + "'";
-        if (m_query->has_conditions()) {
-            m_description += " where \"";
-            m_description += m_query->get_description_safe() + "\"";
-        }
         m_logger->log(util::LogCategory::notification, util::Logger::Level::debug, "Creating ResultsNotifier for %1",
                       m_description);
     }
@@ -84,6 +91,10 @@ void ResultsNotifier::release_data() noexcept
     m_handover_transaction = {};
     m_delivered_tv = {};
     m_delivered_transaction = {};
+    m_live_aggregates = {};
+    m_run_aggregates = {};
+    m_handover_aggregates = {};
+    m_delivered_aggregates = {};
     CollectionNotifier::release_data();
 }
 
@@ -103,6 +114,30 @@ bool ResultsNotifier::get_tableview(TableView& out)
     return true;
 }
 
+void ResultsNotifier::add_live_aggregate(ColKey column)
+{
+    std::lock_guard lock(m_live_aggregates_mutex);
+    if (std::find(m_live_aggregate_columns.begin(), m_live_aggregate_columns.end(), column) ==
+        m_live_aggregate_columns.end())
+        m_live_aggregate_columns.push_back(column);
+}
+
+bool ResultsNotifier::get_live_aggregates(ColKey column, LiveAggregates& out)
+{
+    auto& transaction = source_shared_group();
+    if (transaction.get_transact_stage() != DB::transact_Reading)
+        return false;
+    if (m_delivered_aggregates_version != transaction.get_version_of_current_transaction())
+        return false;
+    for (auto& [col, aggregates] : m_delivered_aggregates) {
+        if (col == column) {
+            out = aggregates;
+            return true;
+        }
+    }
+    return false;
+}
+
 bool ResultsNotifier::do_add_required_change_info(TransactionChangeInfo& info)
 {
     m_info = &info;
@@ -117,7 +152,7 @@ bool ResultsNotifier::do_add_required_change_info(TransactionChangeInfo& info)
     return m_query->get_table() && has_run() && have_callbacks();
 }
 
-void ResultsNotifier::calculate_changes()
+bool ResultsNotifier::calculate_changes()
 {
     if (has_run() && have_callbacks()) {
         ObjKeys next_objs;
@@ -140,18 +175,212 @@ void ResultsNotifier::calculate_changes()
                                                       m_target_is_in_table_order);
 
         m_previous_objs = std::move(next_objs);
+        return true;
     }
     else {
         size_t sz = m_run_tv.size();
         m_previous_objs.resize(sz);
         for (size_t i = 0; i < sz; ++i)
             m_previous_objs[i] = m_run_tv.get_key(i);
+        return false;
+    }
+}
+
+bool ResultsNotifier::results_are_unaffected(const TableVersions& new_versions) const
+{
+    // The content versions are bumped by changes to any table, so they only
+    // tell that something changed. What changed comes from the change info,
+    // which only covers the table itself, so the results must not depend on
+    // other tables.
+    if (!m_info || m_info->schema_changed || new_versions.size() != 1)
+        return false;
+    auto it = m_info->tables.find(m_query->get_table()->get_key());
+    if (it == m_info->tables.end())
+        return false;
+    auto& changes = it->second;
+    if (!changes.insertions_empty() || !changes.deletions_empty())
+        return false;
+
+    std::vector<ColKey> columns;
+    if (!m_query->get_condition_columns(columns))
+        return false;
+    for (size_t i = 0; i < m_descriptor_ordering.size(); ++i) {
+        switch (m_descriptor_ordering.get_type(i)) {
+            case DescriptorType::Sort:
+            case DescriptorType::Distinct: {
+                auto descriptor = static_cast<const ColumnsDescriptor*>(m_descriptor_ordering[i]);
+                auto descriptor_columns = descriptor->get_table_columns();
+                if (descriptor_columns.empty())
+                    return false;
+                columns.insert(columns.end(), descriptor_columns.begin(), descriptor_columns.end());
+                break;
+            }
+            case DescriptorType::Limit:
+                break;
+            case DescriptorType::Filter:
+                return false;
+        }
+    }
+    return !changes.any_modifications_in(columns);
+}
+
+namespace {
+// The value of the property as counted by the aggregates, which skip nulls and NaNs
+Mixed get_aggregate_value(const Table& table, ObjKey key, ColKey column)
+{
+    Mixed value = table.get_object(key).get_any(column);
+    if (value.is_type(type_Float) && std::isnan(value.get_float()))
+        return {};
+    if (value.is_type(type_Double) && std::isnan(value.get_double()))
+        return {};
+    return value;
+}
+} // anonymous namespace
+
+void ResultsNotifier::LiveAggregateState::reset() noexcept
+{
+    values.clear();
+    initialized = true;
+    min_max_is_stale = false;
+    count = 0;
+    int_sum = 0;
+    double_sum = 0;
+    min = max = Mixed();
+}
+
+void ResultsNotifier::LiveAggregateState::add(Mixed value) noexcept
+{
+    if (value.is_null())
+        return;
+    ++count;
+    if (value.is_type(type_Int))
+        int_sum = int64_t(uint64_t(int_sum) + uint64_t(value.get_int()));
+    else
+        double_sum += value.is_type(type_Float) ? value.get_float() : value.get_double();
+    if (!min_max_is_stale) {
+        if (min.is_null() || value < min)
+            min = value;
+        if (max.is_null() || value > max)
+            max = value;
+    }
+}
+
+void ResultsNotifier::LiveAggregateState::remove(Mixed value) noexcept
+{
+    if (value.is_null())
+        return;
+    --count;
+    if (value.is_type(type_Int))
+        int_sum = int64_t(uint64_t(int_sum) - uint64_t(value.get_int()));
+    else
+        double_sum -= value.is_type(type_Float) ? value.get_float() : value.get_double();
+    // Only a scan of the remaining values can tell what the new extreme is
+    if (value == min || value == max)
+        min_max_is_stale = true;
+}
+
+void ResultsNotifier::LiveAggregateState::update_min_max() noexcept
+{
+    if (!min_max_is_stale)
+        return;
+    min_max_is_stale = false;
+    min = max = Mixed();
+    for (auto& value : values) {
+        if (value.is_null())
+            continue;
+        if (min.is_null() || value < min)
+            min = value;
+        if (max.is_null() || value > max)
+            max = value;
+    }
+}
+
+LiveAggregates ResultsNotifier::LiveAggregateState::get() const noexcept
+{
+    LiveAggregates ret;
+    ret.count = count;
+    ret.sum = column.get_type() == col_type_Int ? Mixed(int_sum) : Mixed(double_sum);
+    ret.min = min;
+    ret.max = max;
+    return ret;
+}
+
+void ResultsNotifier::update_live_aggregates(AggregateUpdate update)
+{
+    {
+        std::lock_guard lock(m_live_aggregates_mutex);
+        for (size_t i = m_live_aggregates.size(); i < m_live_aggregate_columns.size(); ++i)
+            m_live_aggregates.push_back({m_live_aggregate_columns[i]});
+    }
+    if (m_live_aggregates.empty())
+        return;
+
+    auto& table = *m_query->get_table();
+    // Modifications are taken from the changes to the table rather than from
+    // m_change, as the latter is filtered by the key paths of the callbacks
+    const ObjectChangeSet* table_changes = nullptr;
+    if (update == AggregateUpdate::Incremental) {
+        auto it = m_info->tables.find(table.get_key());
+        if (it == m_info->tables.end())
+            update = AggregateUpdate::Full;
+        else
+            table_changes = &it->second;
+    }
+
+    for (auto& state : m_live_aggregates) {
+        if (update == AggregateUpdate::Full || !state.initialized) {
+            state.reset();
+            state.values.reserve(m_previous_objs.size());
+            for (auto key : m_previous_objs) {
+                state.values.push_back(get_aggregate_value(table, key, state.column));
+                state.add(state.values.back());
+            }
+            continue;
+        }
+        if (update == AggregateUpdate::Unchanged)
+            continue;
+
+        // Objects which were neither inserted nor deleted keep their relative
+        // order, so walking the old values and skipping the deleted ones pairs
+        // each remaining object with its old value. Only the inserted objects
+        // and those with the column modified have to be read.
+        for (auto i : m_change.deletions.as_indexes())
+            state.remove(state.values[i]);
+        std::vector<Mixed> values;
+        values.reserve(m_previous_objs.size());
+        size_t old_ndx = 0;
+        for (size_t i = 0; i < m_previous_objs.size(); ++i) {
+            if (m_change.insertions.contains(i)) {
+                values.push_back(get_aggregate_value(table, m_previous_objs[i], state.column));
+                state.add(values.back());
+                continue;
+            }
+            while (m_change.deletions.contains(old_ndx))
+                ++old_ndx;
+            Mixed value = state.values[old_ndx++];
+            ObjKey key = m_previous_objs[i];
+            if (table_changes->modifications_contains_column(key, state.column) ||
+                table_changes->insertions_contains(key)) {
+                state.remove(value);
+                value = get_aggregate_value(table, key, state.column);
+                state.add(value);
+            }
+            values.push_back(value);
+        }
+        state.values = std::move(values);
+    }
+
+    m_run_aggregates.clear();
+    for (auto& state : m_live_aggregates) {
+        state.update_min_max();
+        m_run_aggregates.emplace_back(state.column, state.get());
     }
+    m_run_aggregates_version = transaction().get_version_of_current_transaction();
 }
 
 void ResultsNotifier::run()
 {
-    NotifierRunLogger log(m_logger.get(), "ResultsNotifier", m_description);
+    NotifierRunLogger log(*this, "ResultsNotifier");
 
     REALM_ASSERT(m_info || !has_run());
 
@@ -173,28 +402,53 @@ void ResultsNotifier::run()
     auto new_versions = m_query->sync_view_if_needed();
     m_descriptor_ordering.collect_dependencies(m_query->get_table().unchecked_ptr());
     m_descriptor_ordering.get_versions(m_query->get_table()->get_parent_group(), new_versions);
-    if (has_run() && new_versions == m_last_seen_version) {
-        // We've run previously and none of the tables involved in the query
-        // changed so we don't need to rerun the query, but we still need to
-        // check each object in the results to see if it was modified
+
+    // When the results are unchanged we still need to check each object in
+    // the results to see if it was modified
+    auto calculate_modifications = [&] {
         if (!any_related_table_was_modified(*m_info))
             return;
         REALM_ASSERT(m_change.empty());
-        auto checker = get_modification_checker(*m_info, m_query->get_table());
-        for (size_t i = 0; i < m_previous_objs.size(); ++i) {
-            if (checker(m_previous_objs[i])) {
-                m_change.modifications.add(i);
+        log.time(m_run_times.change_calculation, [&] {
+            auto checker = get_modification_checker(*m_info, m_query->get_table());
+            for (size_t i = 0; i < m_previous_objs.size(); ++i) {
+                if (checker(m_previous_objs[i])) {
+                    m_change.modifications.add(i);
+                }
             }
-        }
+        });
+    };
+
+    if (has_run() && new_versions == m_last_seen_version) {
+        // We've run previously and none of the tables involved in the query
+        // changed so we don't need to rerun the query
+        update_live_aggregates(AggregateUpdate::Unchanged);
+        calculate_modifications();
         return;
     }
 
-    m_run_tv = TableView(*m_query, size_t(-1));
-    // Syncing will be done here
-    m_run_tv.apply_descriptor_ordering(m_descriptor_ordering);
+    if (has_run() && results_are_unaffected(new_versions)) {
+        // Only columns which the query doesn't read changed, so hand over the
+        // previous results at the new version rather than rerunning the query
+        m_run_tv = TableView(*m_query, size_t(-1));
+        m_run_tv.apply_descriptor_ordering(m_descriptor_ordering, m_previous_objs);
+        m_last_seen_version = std::move(new_versions);
+        update_live_aggregates(AggregateUpdate::Incremental);
+        calculate_modifications();
+        return;
+    }
+
+    log.time(m_run_times.query, [&] {
+        m_run_tv = TableView(*m_query, size_t(-1));
+        // Syncing will be done here
+        m_run_tv.apply_descriptor_ordering(m_descriptor_ordering);
+    });
     m_last_seen_version = std::move(new_versions);
 
-    calculate_changes();
+    bool changes_are_known = log.time(m_run_times.change_calculation, [&] {
+        return calculate_changes();
+    });
+    update_live_aggregates(changes_are_known ? AggregateUpdate::Incremental : AggregateUpdate::Full);
 }
 
 void ResultsNotifier::do_prepare_handover(Transaction& sg)
@@ -210,6 +464,12 @@ void ResultsNotifier::do_prepare_handover(Transaction& sg)
         m_handover_tv = m_run_tv.clone_for_handover(m_handover_transaction.get(), PayloadPolicy::Move);
         m_run_tv = {};
     }
+
+    if (!m_run_aggregates.empty() && m_run_aggregates_version == sg.get_version_of_current_transaction()) {
+        m_handover_aggregates = std::move(m_run_aggregates);
+        m_handover_aggregates_version = m_run_aggregates_version;
+        m_run_aggregates.clear();
+    }
 }
 
 bool ResultsNotifier::prepare_to_deliver()
@@ -221,6 +481,11 @@ bool ResultsNotifier::prepare_to_deliver()
         m_delivered_tv.reset();
         return false;
     }
+    if (!m_handover_aggregates.empty()) {
+        m_delivered_aggregates = std::move(m_handover_aggregates);
+        m_delivered_aggregates_version = m_handover_aggregates_version;
+        m_handover_aggregates.clear();
+    }
     if (!m_handover_tv) {
         bool transaction_is_stale =
             m_delivered_transaction &&
@@ -264,17 +529,16 @@ ListResultsNotifier::ListResultsNotifier(Results& target)
         if (descr->get_type() == DescriptorType::Distinct)
             m_distinct = true;
     }
+    auto path = m_list->get_short_path();
+    auto prop_name = m_list->get_table()->get_column_name(path[0].get_col_key());
+    path[0] = PathElement(prop_name);
+    std::string_view sort_order = "";
+    if (m_sort_order) {
+        sort_order = *m_sort_order ? " sorted ascending" : " sorted descending";
+    }
+    m_description =
+        util::format("%1 %2%3%4", m_list->get_collection_type(), m_list->get_obj().get_id(), path, sort_order);
     if (m_logger) {
-        auto path = m_list->get_short_path();
-        auto prop_name = m_list->get_table()->get_column_name(path[0].get_col_key());
-        path[0] = PathElement(prop_name);
-        std::string_view sort_order = "";
-        if (m_sort_order) {
-            sort_order = *m_sort_order ? " sorted ascending" : " sorted descending";
-        }
-
-        m_description =
-            util::format("%1 %2%3%4", m_list->get_collection_type(), m_list->get_obj().get_id(), path, sort_order);
         m_logger->log(util::LogCategory::notification, util::Logger::Level::debug,
                       "Creating ListResultsNotifier for %1", m_description);
     }
@@ -361,17 +625,19 @@ void ListResultsNotifier::run()
         return;
     }
 
-    NotifierRunLogger log(m_logger.get(), "ListResultsNotifier", m_description);
-
-    m_run_indices = std::vector<size_t>();
-    if (m_distinct)
-        m_list->distinct(*m_run_indices, m_sort_order);
-    else if (m_sort_order)
-        m_list->sort(*m_run_indices, *m_sort_order);
-    else {
-        m_run_indices->resize(m_list->size());
-        std::iota(m_run_indices->begin(), m_run_indices->end(), 0);
-    }
+    NotifierRunLogger log(*this, "ListResultsNotifier");
+
+    log.time(m_run_times.query, [&] {
+        m_run_indices = std::vector<size_t>();
+        if (m_distinct)
+            m_list->distinct(*m_run_indices, m_sort_order);
+        else if (m_sort_order)
+            m_list->sort(*m_run_indices, *m_sort_order);
+        else {
+            m_run_indices->resize(m_list->size());
+            std::iota(m_run_indices->begin(), m_run_indices->end(), 0);
+        }
+    });
 
     // Modifications to nested values in Mixed are recorded in replication as
     // StableIndex and we have to look up the actual index afterwards
@@ -384,7 +650,9 @@ void ListResultsNotifier::run()
         }
     }
 
-    calculate_changes();
+    log.time(m_run_times.change_calculation, [&] {
+        calculate_changes();
+    });
 }
 
 void ListResultsNotifier::do_prepare_handover(Transaction& sg)
@@ -25,6 +25,18 @@
 #include <realm/db.hpp>
 
 namespace realm::_impl {
+// The aggregates of an int, float or double property over the objects in the
+// results of a ResultsNotifier.
+struct LiveAggregates {
+    // The number of values which are neither null nor NaN
+    size_t count = 0;
+    // int64_t for int properties and double for float and double properties
+    Mixed sum;
+    // Null if count is zero
+    Mixed min;
+    Mixed max;
+};
+
 class ResultsNotifierBase : public CollectionNotifier {
 public:
     using ListIndices = util::Optional<std::vector<size_t>>;
@@ -44,14 +56,48 @@ public:
     {
         return false;
     }
+    // Start maintaining the aggregates of `column` each time the notifier runs.
+    // Can be called from any thread.
+    virtual void add_live_aggregate(ColKey) {}
+    // If this notifier has aggregates of `column` for the version of the source
+    // Realm's read transaction, copy them to `out` and return true.
+    virtual bool get_live_aggregates(ColKey, LiveAggregates&)
+    {
+        return false;
+    }
 };
 
 class ResultsNotifier : public ResultsNotifierBase {
 public:
     ResultsNotifier(Results& target);
     bool get_tableview(TableView& out) override;
+    void add_live_aggregate(ColKey column) override;
+    bool get_live_aggregates(ColKey column, LiveAggregates& out) override;
 
 private:
+    // The state of the aggregates of one property, which is updated from the
+    // changes to the results each time the notifier runs
+    struct LiveAggregateState {
+        ColKey column;
+        // The value of the property for each object in m_previous_objs, or
+        // null if it is not counted by the aggregates
+        std::vector<Mixed> values;
+        bool initialized = false;
+        bool min_max_is_stale = false;
+        size_t count = 0;
+        int64_t int_sum = 0;
+        double double_sum = 0;
+        Mixed min;
+        Mixed max;
+
+        void reset() noexcept;
+        void add(Mixed value) noexcept;
+        void remove(Mixed value) noexcept;
+        void update_min_max() noexcept;
+        LiveAggregates get() const noexcept;
+    };
+    using LiveAggregateResults = std::vector<std::pair<ColKey, LiveAggregates>>;
+
     std::unique_ptr<Query> m_query;
     DescriptorOrdering m_descriptor_ordering;
     bool m_target_is_in_table_order;
@@ -75,7 +121,34 @@ private:
     TransactionChangeInfo* m_info = nullptr;
     bool m_results_were_used = true;
 
-    void calculate_changes();
+    std::mutex m_live_aggregates_mutex;
+    std::vector<ColKey> m_live_aggregate_columns; // Guarded by m_live_aggregates_mutex
+    std::vector<LiveAggregateState> m_live_aggregates;
+    // The aggregates computed by the last run, and the transaction version they
+    // are for, as they move from the worker thread to the target thread
+    VersionID m_run_aggregates_version;
+    LiveAggregateResults m_run_aggregates;
+    VersionID m_handover_aggregates_version;
+    LiveAggregateResults m_handover_aggregates;
+    VersionID m_delivered_aggregates_version;
+    LiveAggregateResults m_delivered_aggregates;
+
+    // Returns true if m_change was calculated as the changes since the previous run
+    bool calculate_changes();
+    // Returns true if the changes since the previous run cannot have changed
+    // which objects match the query or their order, because no objects were
+    // added or removed and none of the columns the query and the sort and
+    // distinct read were modified
+    bool results_are_unaffected(const TableVersions& new_versions) const;
+    enum class AggregateUpdate {
+        // None of the tables the results depend on have changed
+        Unchanged,
+        // m_change holds the insertions and deletions since the last update
+        Incremental,
+        // The changes are not known, so every value has to be read
+        Full,
+    };
+    void update_live_aggregates(AggregateUpdate);
 
     void run() override;
     void do_prepare_handover(Transaction&) override;
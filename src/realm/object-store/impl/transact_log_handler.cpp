@@ -318,6 +318,11 @@ public:
 // A transaction log handler that just validates that all operations made are
 // ones supported by the object store
 struct TransactLogValidator : public TransactLogValidationMixin {
+    // Only schema changes need to be validated
+    bool ignores_tables(const std::vector<TableKey>&) const noexcept
+    {
+        return true;
+    }
     bool modify_object(ColKey, ObjKey)
     {
         return true;
@@ -352,6 +357,19 @@ public:
         }
     }
 
+    bool ignores_tables(const std::vector<TableKey>& tables) const noexcept
+    {
+        for (auto key : tables) {
+            if (m_info.tables.count(key))
+                return false;
+            for (auto& c : m_info.collections) {
+                if (c.table_key == key)
+                    return false;
+            }
+        }
+        return true;
+    }
+
     bool select_table(TableKey key) noexcept
     {
         TransactLogValidationMixin::select_table(key);
@@ -37,13 +37,16 @@ WeakRealmNotifier::~WeakRealmNotifier() = default;
 
 void WeakRealmNotifier::notify()
 {
-    if (m_scheduler) {
-        m_scheduler->invoke([weak_realm = m_realm] {
-            if (auto realm = weak_realm.lock()) {
-                realm->notify();
-            }
-        });
-    }
+    if (!m_scheduler || m_notify_pending->exchange(true))
+        return;
+    m_scheduler->invoke([weak_realm = m_realm, pending = m_notify_pending] {
+        // Cleared before reading the newest version, so that a version which
+        // becomes available after this point results in a new invocation
+        pending->store(false);
+        if (auto realm = weak_realm.lock()) {
+            realm->notify();
+        }
+    });
 }
 
 void WeakRealmNotifier::bind_to_scheduler()
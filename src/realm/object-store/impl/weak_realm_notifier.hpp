@@ -19,6 +19,7 @@
 #ifndef REALM_WEAK_REALM_NOTIFIER_HPP
 #define REALM_WEAK_REALM_NOTIFIER_HPP
 
+#include <atomic>
 #include <memory>
 #include <thread>
 
@@ -60,7 +61,9 @@ public:
     bool is_cached_for_scheduler(std::shared_ptr<util::Scheduler> scheduler) const;
     bool scheduler_is_on_thread() const;
 
-    // Invoke m_realm.notify() on the Realm's thread via the scheduler.
+    // Invoke m_realm.notify() on the Realm's thread via the scheduler. Calls
+    // made while a previous invocation is waiting to run do nothing, as that
+    // invocation will advance the Realm to the newest version anyway.
     void notify();
 
     // Bind this notifier to the Realm's scheduler.
@@ -71,6 +74,8 @@ private:
     void* m_realm_key;
     bool m_cache = false;
     std::shared_ptr<util::Scheduler> m_scheduler;
+    // Set while an invocation of notify() is waiting to run on the scheduler
+    std::shared_ptr<std::atomic<bool>> m_notify_pending = std::make_shared<std::atomic<bool>>(false);
 };
 
 } // namespace _impl
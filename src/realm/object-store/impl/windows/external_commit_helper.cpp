@@ -19,6 +19,8 @@
 #include <realm/object-store/impl/external_commit_helper.hpp>
 #include <realm/object-store/impl/realm_coordinator.hpp>
 
+#include <realm/util/thread.hpp>
+
 #include <algorithm>
 
 using namespace realm;
@@ -67,6 +69,7 @@ ExternalCommitHelper::ExternalCommitHelper(RealmCoordinator& parent, const Realm
     }
 
     m_thread = std::thread([this]() {
+        util::on_thread_start(util::ThreadRole::commit_listener);
         listen();
     });
 }
@@ -107,6 +107,13 @@ public:
 
     void notify_others();
 
+    // Wake up the notifier of this process only. All processes are woken up
+    // by this implementation.
+    void notify_self()
+    {
+        notify_others();
+    }
+
 private:
     void listen();
 
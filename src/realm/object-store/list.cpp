@@ -177,6 +177,12 @@ void List::insert_any(size_t row_ndx, Mixed value)
     list_base().insert_any(row_ndx, value);
 }
 
+void List::insert_range_any(size_t row_ndx, const std::vector<Mixed>& values)
+{
+    verify_in_transaction();
+    list_base().insert_range_any(row_ndx, values);
+}
+
 void List::set_any(size_t row_ndx, Mixed value)
 {
     verify_in_transaction();
@@ -76,6 +76,7 @@ public:
     void set(size_t row_ndx, T value);
 
     void insert_any(size_t list_ndx, Mixed value);
+    void insert_range_any(size_t list_ndx, const std::vector<Mixed>& values);
     void set_any(size_t list_ndx, Mixed value);
     Mixed get_any(size_t list_ndx) const final;
     size_t find_any(Mixed value) const final;
@@ -172,6 +172,32 @@ NotificationToken Object::add_notification_callback(CollectionChangeCallback cal
     return {m_notifier, m_notifier->add_callback(std::move(callback), std::move(key_path_array))};
 }
 
+MultiObjectObserver::MultiObjectObserver(std::shared_ptr<Realm> realm, ConstTableRef table)
+    : m_realm(std::move(realm))
+    , m_table(std::move(table))
+{
+    REALM_ASSERT(m_table);
+}
+
+MultiObjectObserver::~MultiObjectObserver() = default;
+MultiObjectObserver::MultiObjectObserver(MultiObjectObserver&&) = default;
+MultiObjectObserver& MultiObjectObserver::operator=(MultiObjectObserver&&) = default;
+
+NotificationToken MultiObjectObserver::add_notification_callback(ObjKey object_key, CollectionChangeCallback callback,
+                                                                 std::optional<KeyPathArray> key_path_array)
+{
+    m_realm->verify_thread();
+    m_realm->verify_notifications_available();
+    if (!m_table->is_valid(object_key)) {
+        throw KeyNotFound(util::format("No object with key '%1' in '%2'", object_key, m_table->get_class_name()));
+    }
+    if (!m_notifier) {
+        m_notifier = std::make_shared<_impl::MultiObjectNotifier>(m_realm, m_table);
+        _impl::RealmCoordinator::register_notifier(m_notifier);
+    }
+    return {m_notifier, m_notifier->add_callback(std::move(callback), std::move(key_path_array), object_key)};
+}
+
 void Object::verify_attached() const
 {
     m_realm->verify_thread();
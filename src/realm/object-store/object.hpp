@@ -29,7 +29,8 @@ struct Property;
 
 namespace _impl {
 class ObjectNotifier;
-}
+class MultiObjectNotifier;
+} // namespace _impl
 
 /// Options for how objects should be unboxed by a context.
 ///
@@ -216,6 +217,41 @@ private:
     void validate_property_for_setter(Property const&) const;
 };
 
+/**
+ * Observes any number of objects of a single table with one shared notifier. Observing each object with
+ * `Object::add_notification_callback()` creates a notifier per object, which all have to be run separately after
+ * every commit; a `MultiObjectObserver` checks all of its objects in a single run instead.
+ *
+ * Notifications stop being delivered when the `MultiObjectObserver` is destroyed.
+ */
+class MultiObjectObserver {
+public:
+    MultiObjectObserver(std::shared_ptr<Realm> realm, ConstTableRef table);
+    ~MultiObjectObserver();
+
+    MultiObjectObserver(MultiObjectObserver&&);
+    MultiObjectObserver& operator=(MultiObjectObserver&&);
+
+    /**
+     * Adds a `CollectionChangeCallback` for the object identified by `object_key`. The callback receives the same
+     * changes as one added with `Object::add_notification_callback()` for that object.
+     *
+     * @param object_key The object to observe. Throws `KeyNotFound` if there is no such object in the table.
+     * @param callback The function to execute when the object was modified or deleted.
+     * @param key_path_array A filter that can be applied to make sure the `CollectionChangeCallback` is only executed
+     * when the property in the filter is changed but not otherwise.
+     *
+     * @return A `NotificationToken` that is used to identify this callback.
+     */
+    NotificationToken add_notification_callback(ObjKey object_key, CollectionChangeCallback callback,
+                                                std::optional<KeyPathArray> key_path_array = std::nullopt);
+
+private:
+    std::shared_ptr<Realm> m_realm;
+    ConstTableRef m_table;
+    _impl::CollectionNotifier::Handle<_impl::MultiObjectNotifier> m_notifier;
+};
+
 struct InvalidatedObjectException : public LogicError {
     InvalidatedObjectException(const std::string& object_type);
     const std::string object_type;
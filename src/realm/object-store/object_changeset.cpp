@@ -18,6 +18,8 @@
 
 #include <realm/object-store/object_changeset.hpp>
 
+#include <algorithm>
+
 using namespace realm;
 
 void ObjectChangeSet::insertions_add(ObjKey obj)
@@ -29,10 +31,23 @@ void ObjectChangeSet::modifications_add(ObjKey obj, ColKey col)
 {
     // don't report modifications on new objects
     if (m_insertions.find(obj) == m_insertions.end()) {
-        m_modifications[obj].insert(col);
+        if (m_modifications[obj].insert(col).second)
+            add_modified_column(col);
     }
 }
 
+void ObjectChangeSet::add_modified_column(ColKey col)
+{
+    auto it = std::lower_bound(m_modified_columns.begin(), m_modified_columns.end(), col);
+    if (it == m_modified_columns.end() || *it != col)
+        m_modified_columns.insert(it, col);
+}
+
+bool ObjectChangeSet::column_maybe_modified(ColKey col) const noexcept
+{
+    return std::binary_search(m_modified_columns.begin(), m_modified_columns.end(), col);
+}
+
 void ObjectChangeSet::deletions_add(ObjKey obj)
 {
     m_modifications.erase(obj);
@@ -75,14 +90,21 @@ bool ObjectChangeSet::modifications_contains(ObjKey obj, const std::vector<ColKe
         return m_modifications.count(obj) > 0;
     }
 
+    // Most filtered checks are for columns which were not modified in this table at all, which the column summary
+    // answers without having to look up `obj`.
+    if (!any_modifications_in(filtered_column_keys)) {
+        return false;
+    }
+
     // If a filter is set but the `obj` is not contained within the `m_modifcations` at all we do not need to check
     // further.
-    if (m_modifications.count(obj) == 0) {
+    auto it = m_modifications.find(obj);
+    if (it == m_modifications.end()) {
         return false;
     }
 
     // If a filter was set we need to check if the changed column is part of this filter.
-    const std::unordered_set<ColKey>& changed_columns_for_object = m_modifications.at(obj);
+    const std::unordered_set<ColKey>& changed_columns_for_object = it->second;
     for (const auto& column_key_in_filter : filtered_column_keys) {
         if (changed_columns_for_object.count(column_key_in_filter)) {
             return true;
@@ -92,6 +114,22 @@ bool ObjectChangeSet::modifications_contains(ObjKey obj, const std::vector<ColKe
     return false;
 }
 
+bool ObjectChangeSet::modifications_contains_column(ObjKey obj, ColKey col_key) const
+{
+    if (!column_maybe_modified(col_key)) {
+        return false;
+    }
+    auto it = m_modifications.find(obj);
+    return it != m_modifications.end() && it->second.count(col_key) > 0;
+}
+
+bool ObjectChangeSet::any_modifications_in(const std::vector<ColKey>& col_keys) const
+{
+    return std::any_of(col_keys.begin(), col_keys.end(), [&](ColKey col) {
+        return column_maybe_modified(col);
+    });
+}
+
 const ObjectChangeSet::ColumnSet* ObjectChangeSet::get_columns_modified(ObjKey obj) const
 {
     auto it = m_modifications.find(obj);
@@ -128,6 +166,9 @@ void ObjectChangeSet::merge(ObjectChangeSet&& other)
     for (auto& obj : other.m_modifications) {
         m_modifications[obj.first].merge(std::move(obj.second));
     }
+    for (auto col : other.m_modified_columns) {
+        add_modified_column(col);
+    }
 
     verify();
 
@@ -66,6 +66,18 @@ public:
      *         at least one changed column. False otherwise.
      */
     bool modifications_contains(ObjKey obj, const std::vector<ColKey>& filtered_col_keys) const;
+    // Same as above for a filter consisting of exactly one column, without requiring a vector for it.
+    bool modifications_contains_column(ObjKey obj, ColKey col_key) const;
+    /**
+     * Checks if any object in this table could have a modification in one of the given columns. This only looks
+     * at the table-wide column summary and is therefore independent of the number of modified objects.
+     *
+     * @return False if none of `col_keys` was modified on any object. True otherwise (including the case where
+     *         the modified object was deleted again later on).
+     */
+    bool any_modifications_in(const std::vector<ColKey>& col_keys) const;
+    // Same as above for a single column.
+    bool column_maybe_modified(ColKey col) const noexcept;
     bool deletions_contains(ObjKey obj) const;
     // if the specified object has not been modified, returns nullptr
     // if the object has been modified, returns a pointer to the ObjectSet
@@ -124,6 +136,11 @@ private:
     // `m_modifications` contains one entry per changed object.
     // It also includes the information about all columns changed in that object.
     ObjectMapToColumnSet m_modifications;
+    // Sorted union of all columns found in `m_modifications`. It is only ever grown, so it may contain columns
+    // whose modified objects have been deleted since; it must only be used to rule out modifications.
+    std::vector<ColKey> m_modified_columns;
+
+    void add_modified_column(ColKey col);
 };
 
 } // end namespace realm
@@ -43,6 +43,7 @@ constexpr uint64_t ObjectStore::NotVersioned;
 namespace {
 const char* const c_metadataTableName = "metadata";
 const char* const c_versionColumnName = "version";
+const char* const c_fingerprintColumnName = "schema_fingerprint";
 
 const char c_object_table_prefix[] = "class_";
 
@@ -239,6 +240,27 @@ uint64_t ObjectStore::get_schema_version(Group const& group)
     return table->get_object(0).get<int64_t>(c_versionColumnName);
 }
 
+uint64_t ObjectStore::get_schema_fingerprint(Group const& group)
+{
+    ConstTableRef table = group.get_table(c_metadataTableName);
+    if (!table || table->size() == 0)
+        return 0;
+    ColKey col = table->get_column_key(c_fingerprintColumnName);
+    if (!col)
+        return 0;
+    return table->get_object(0).get<int64_t>(col);
+}
+
+void ObjectStore::set_schema_fingerprint(Group& group, uint64_t fingerprint)
+{
+    ::create_metadata_tables(group);
+    TableRef table = group.get_table(c_metadataTableName);
+    ColKey col = table->get_column_key(c_fingerprintColumnName);
+    if (!col)
+        col = table->add_column(type_Int, c_fingerprintColumnName);
+    table->get_object(0).set<int64_t>(col, fingerprint);
+}
+
 StringData ObjectStore::object_type_for_table_name(StringData table_name)
 {
     if (table_name.begins_with(c_object_table_prefix)) {
@@ -646,7 +668,8 @@ static void create_initial_tables(Group& group, std::vector<SchemaChange> const&
     }
 }
 
-void ObjectStore::apply_additive_changes(Group& group, std::vector<SchemaChange> const& changes, bool update_indexes)
+static void do_apply_additive_changes(Group& group, std::vector<SchemaChange> const& changes, bool update_indexes,
+                                      Transaction* transaction, const AdditiveChangeOptions& options)
 {
     using namespace schema_change;
     struct Applier {
@@ -659,6 +682,9 @@ void ObjectStore::apply_additive_changes(Group& group, std::vector<SchemaChange>
         Group& group;
         TableHelper table;
         bool update_indexes;
+        // The number of objects of the tables to which columns and indexes
+        // were added since the last commit
+        size_t num_objects_touched = 0;
 
         void operator()(AddTable op)
         {
@@ -671,12 +697,16 @@ void ObjectStore::apply_additive_changes(Group& group, std::vector<SchemaChange>
         }
         void operator()(AddProperty op)
         {
-            add_column(group, table(op.object), *op.property);
+            Table& t = table(op.object);
+            add_column(group, t, *op.property);
+            num_objects_touched += t.size();
         }
         void operator()(AddIndex op)
         {
             if (update_indexes) {
-                add_search_index(table(op.object), *op.property, op.type);
+                Table& t = table(op.object);
+                add_search_index(t, *op.property, op.type);
+                num_objects_touched += t.size();
             }
         }
         void operator()(RemoveIndex op)
@@ -694,11 +724,34 @@ void ObjectStore::apply_additive_changes(Group& group, std::vector<SchemaChange>
         void operator()(MakePropertyRequired) {}
     } applier{group, update_indexes};
 
+    size_t num_applied = 0;
     for (auto& change : changes) {
         change.visit(applier);
+        ++num_applied;
+        // Committing while keeping the write lock bounds the memory used by
+        // the write transaction, and keeps the work done if the process is
+        // interrupted. Every additive change leaves a valid schema behind.
+        if (transaction && options.objects_per_commit != 0 &&
+            applier.num_objects_touched >= options.objects_per_commit && num_applied < changes.size()) {
+            transaction->commit_and_continue_writing(); // Throws
+            applier.num_objects_touched = 0;
+        }
+        if (options.progress)
+            options.progress(num_applied, changes.size());
     }
 }
 
+void ObjectStore::apply_additive_changes(Group& group, std::vector<SchemaChange> const& changes, bool update_indexes)
+{
+    do_apply_additive_changes(group, changes, update_indexes, nullptr, {});
+}
+
+void ObjectStore::apply_additive_changes(Transaction& transaction, std::vector<SchemaChange> const& changes,
+                                         bool update_indexes, const AdditiveChangeOptions& options)
+{
+    do_apply_additive_changes(transaction, changes, update_indexes, &transaction, options);
+}
+
 static void apply_pre_migration_changes(Group& group, std::vector<SchemaChange> const& changes)
 {
     using namespace schema_change;
@@ -867,7 +920,8 @@ static const char* schema_mode_to_string(SchemaMode mode)
 void ObjectStore::apply_schema_changes(Transaction& transaction, uint64_t schema_version, Schema& target_schema,
                                        uint64_t target_schema_version, SchemaMode mode,
                                        std::vector<SchemaChange> const& changes, bool handle_automatically_backlinks,
-                                       std::function<void()> migration_function)
+                                       std::function<void()> migration_function,
+                                       const AdditiveChangeOptions& additive_options)
 {
     using namespace std::chrono;
     auto t1 = steady_clock::now();
@@ -890,7 +944,7 @@ void ObjectStore::apply_schema_changes(Transaction& transaction, uint64_t schema
     if (mode == SchemaMode::AdditiveDiscovered || mode == SchemaMode::AdditiveExplicit) {
         // With sync v2.x, indexes are no longer synced, so there's no reason to avoid creating them.
         bool update_indexes = true;
-        apply_additive_changes(transaction, changes, update_indexes);
+        apply_additive_changes(transaction, changes, update_indexes, additive_options);
 
         set_schema_version(transaction, target_schema_version);
         set_schema_keys(transaction, target_schema);
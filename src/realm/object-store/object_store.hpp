@@ -44,6 +44,17 @@ template <typename... Args>
 std::string format(const char* fmt, Args&&... args);
 }
 
+// Options for applying additive schema changes to files with many objects
+struct AdditiveChangeOptions {
+    // If nonzero, the changes applied so far are committed, keeping the write
+    // transaction open, whenever the tables to which columns and search
+    // indexes were added since the last commit hold at least this many objects
+    size_t objects_per_commit = 0;
+    // Called after each change with the number of changes applied so far and
+    // the total number of changes
+    std::function<void(size_t applied, size_t total)> progress;
+};
+
 class ObjectStore {
 public:
     // Schema version used for uninitialized Realms
@@ -57,6 +68,15 @@ public:
     // NOTE: must be performed within a write transaction
     static void set_schema_version(Group& group, uint64_t version);
 
+    // get the fingerprint of the last schema that was found to need no changes
+    // when opening the file (see RealmConfig::cache_schema_fingerprint), or
+    // zero if none was stored
+    static uint64_t get_schema_fingerprint(Group const& group);
+
+    // store a schema fingerprint, replacing the previous one
+    // NOTE: must be performed within a write transaction
+    static void set_schema_fingerprint(Group& group, uint64_t fingerprint);
+
     // check if all of the changes in the list can be applied automatically, or
     // throw if any of them require a schema version bump and migration function
     static void verify_no_migration_required(std::vector<SchemaChange> const& changes);
@@ -86,9 +106,13 @@ public:
     static void apply_schema_changes(Transaction& group, uint64_t schema_version, Schema& target_schema,
                                      uint64_t target_schema_version, SchemaMode mode,
                                      std::vector<SchemaChange> const& changes, bool handle_automatically_backlinks,
-                                     std::function<void()> migration_function = {});
+                                     std::function<void()> migration_function = {},
+                                     const AdditiveChangeOptions& additive_options = {});
 
     static void apply_additive_changes(Group&, std::vector<SchemaChange> const&, bool update_indexes);
+    // Same as above, but may commit the transaction part way, see AdditiveChangeOptions
+    static void apply_additive_changes(Transaction&, std::vector<SchemaChange> const&, bool update_indexes,
+                                       const AdditiveChangeOptions& options);
 
     // get a table for an object type
     static realm::TableRef table_for_object_type(Group& group, StringData object_type);
@@ -177,6 +177,43 @@ size_t Results::do_size()
     REALM_COMPILER_HINT_UNREACHABLE();
 }
 
+void Results::set_evaluation_window(size_t window)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    m_evaluation_window = window;
+}
+
+bool Results::can_use_evaluation_window()
+{
+    // Once a notifier exists, it evaluates the whole query in the background
+    return m_evaluation_window != 0 && m_mode == Mode::Query && !m_notifier &&
+           m_update_policy == UpdatePolicy::Auto && m_descriptor_ordering.is_empty() && !m_query.get_ordering();
+}
+
+const TableView& Results::evaluate_window(size_t ndx)
+{
+    auto saturating_add = [](size_t a, size_t b) {
+        return a > std::numeric_limits<size_t>::max() - b ? std::numeric_limits<size_t>::max() : a + b;
+    };
+    bool is_complete = m_window_limit != 0 && m_window_view.size() < m_window_limit;
+    bool is_current = m_window_limit != 0 && m_window_view.is_in_sync();
+    if (is_current && (ndx < m_window_view.size() || is_complete))
+        return m_window_view;
+
+    // Rerun the query to cover the same prefix as before if it is merely out
+    // of date, or twice the previous one if it is too short, so that
+    // accessing the objects in order costs linear time overall
+    size_t limit = saturating_add(ndx, m_evaluation_window);
+    if (m_window_limit != 0)
+        limit = std::max(limit, is_current ? saturating_add(m_window_limit, m_window_limit) : m_window_limit);
+    m_query.sync_view_if_needed();
+    m_window_view = m_query.find_all(limit);
+    m_window_limit = limit;
+    if (auto audit = m_realm->audit_context())
+        audit->record_query(m_realm->read_transaction_version(), m_window_view);
+    return m_window_view;
+}
+
 const ObjectSchema& Results::get_object_schema() const
 {
     validate_read();
@@ -398,6 +435,12 @@ template <>
 util::Optional<Obj> Results::try_get(size_t row_ndx)
 {
     validate_read();
+    if (can_use_evaluation_window()) {
+        const TableView& tv = evaluate_window(row_ndx);
+        if (row_ndx < tv.size())
+            return tv.get_object(row_ndx);
+        return util::none;
+    }
     ensure_up_to_date();
     switch (m_mode) {
         case Mode::Empty:
@@ -431,6 +474,12 @@ Mixed Results::get_any(size_t ndx)
 {
     util::CheckedUniqueLock lock(m_mutex);
     validate_read();
+    if (can_use_evaluation_window()) {
+        const TableView& tv = evaluate_window(ndx);
+        if (ndx < tv.size())
+            return Mixed(ObjLink(m_table->get_key(), tv.get_key(ndx)));
+        throw OutOfBounds{"get_any() on Results", ndx, do_size()};
+    }
     ensure_up_to_date();
     switch (m_mode) {
         case Mode::Empty:
@@ -670,8 +719,42 @@ util::Optional<Mixed> Results::aggregate(ColKey column, const char* name, Aggreg
     }
 }
 
+void Results::track_aggregates(ColKey column)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    validate_read();
+    if (!m_table || do_get_type() != PropertyType::Object)
+        throw IllegalOperation("Aggregates can only be tracked for Results of objects");
+    m_table->check_column(column);
+    auto type = column.get_type();
+    if (column.is_collection() || (type != col_type_Int && type != col_type_Float && type != col_type_Double))
+        unsupported_operation(column, *m_table, "track_aggregates");
+
+    if (std::find(m_live_aggregate_columns.begin(), m_live_aggregate_columns.end(), column) !=
+        m_live_aggregate_columns.end())
+        return;
+    m_live_aggregate_columns.push_back(column);
+    if (m_notifier)
+        m_notifier->add_live_aggregate(column);
+}
+
+bool Results::get_live_aggregates(ColKey column, _impl::LiveAggregates& out)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    if (!m_notifier || m_live_aggregate_columns.empty() || m_update_policy == UpdatePolicy::Never)
+        return false;
+    validate_read();
+    // Changes made in the current write transaction are not seen by the notifier
+    if (m_realm->is_in_transaction())
+        return false;
+    return m_notifier->get_live_aggregates(column, out);
+}
+
 util::Optional<Mixed> Results::max(ColKey column)
 {
+    _impl::LiveAggregates live;
+    if (get_live_aggregates(column, live))
+        return live.count ? util::Optional<Mixed>(live.max) : util::none;
     return aggregate(column, "max", [column](auto&& helper) {
         return helper.max(column);
     });
@@ -679,6 +762,9 @@ util::Optional<Mixed> Results::max(ColKey column)
 
 util::Optional<Mixed> Results::min(ColKey column)
 {
+    _impl::LiveAggregates live;
+    if (get_live_aggregates(column, live))
+        return live.count ? util::Optional<Mixed>(live.min) : util::none;
     return aggregate(column, "min", [column](auto&& helper) {
         return helper.min(column);
     });
@@ -686,6 +772,9 @@ util::Optional<Mixed> Results::min(ColKey column)
 
 util::Optional<Mixed> Results::sum(ColKey column)
 {
+    _impl::LiveAggregates live;
+    if (get_live_aggregates(column, live))
+        return live.sum;
     return aggregate(column, "sum", [column](auto&& helper) {
         return helper.sum(column);
     });
@@ -693,11 +782,38 @@ util::Optional<Mixed> Results::sum(ColKey column)
 
 util::Optional<Mixed> Results::average(ColKey column)
 {
+    _impl::LiveAggregates live;
+    if (get_live_aggregates(column, live)) {
+        if (!live.count)
+            return util::none;
+        double sum = live.sum.is_type(type_Int) ? double(live.sum.get_int()) : live.sum.get_double();
+        return Mixed(sum / live.count);
+    }
     return aggregate(column, "average", [column](auto&& helper) {
         return helper.avg(column);
     });
 }
 
+GroupByResult Results::group_by(ColKey column, const std::vector<GroupByAggregate>& aggregates)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    validate_read();
+    if (!m_table && !m_collection)
+        return {};
+    if (do_get_type() != PropertyType::Object)
+        throw IllegalOperation("Only Results of objects can be grouped");
+
+    ensure_up_to_date();
+    // Distinct and limit change which objects are included, so the objects of
+    // the view are grouped rather than those matching the query
+    if (m_mode == Mode::TableView && (m_descriptor_ordering.will_apply_distinct() ||
+                                      m_descriptor_ordering.will_apply_limit() ||
+                                      m_descriptor_ordering.will_apply_filter())) {
+        return Query(m_table, std::make_unique<TableView>(m_table_view)).group_by(column, aggregates);
+    }
+    return do_get_query().group_by(column, aggregates);
+}
+
 void Results::clear()
 {
     util::CheckedUniqueLock lock(m_mutex);
@@ -838,6 +954,152 @@ TableView Results::get_tableview()
     REALM_COMPILER_HINT_UNREACHABLE();
 }
 
+util::Optional<TableView> Results::get_evaluated_tableview() const
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    if (m_mode != Mode::TableView || !m_table_view.is_attached() || !m_table_view.is_in_sync())
+        return util::none;
+    return m_table_view;
+}
+
+std::vector<double> Results::get_fulltext_scores(ColKey column, StringData terms)
+{
+    auto table = get_table();
+    if (!table) {
+        throw IllegalOperation("Fulltext scores are only available for Results of objects");
+    }
+    size_t sz = size();
+    std::vector<ObjKey> keys;
+    keys.reserve(sz);
+    for (size_t i = 0; i < sz; ++i) {
+        keys.push_back(get<Obj>(i).get_key());
+    }
+    return table->get_fulltext_scores(column, terms, keys);
+}
+
+std::vector<Mixed> Results::get_values(size_t begin, size_t end, const std::vector<ColKey>& columns)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    validate_read();
+    ensure_up_to_date();
+    if (!m_table || do_get_type() != PropertyType::Object) {
+        throw IllegalOperation("Batch reading of values is only available for Results of objects");
+    }
+    size_t sz = do_size();
+    if (begin > end || end > sz) {
+        throw OutOfBounds{"get_values() on Results", end, sz};
+    }
+
+    std::vector<ObjKey> keys;
+    keys.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        if (m_mode == Mode::TableView) {
+            bool valid = m_update_policy != UpdatePolicy::Never || m_table_view.is_obj_valid(i);
+            keys.push_back(valid ? m_table_view.get_key(i) : ObjKey());
+        }
+        else {
+            auto obj = try_get<Obj>(i);
+            keys.push_back(obj ? obj->get_key() : ObjKey());
+        }
+    }
+    return m_table->get_values(keys, columns);
+}
+
+std::vector<Mixed> Results::get_range(size_t begin, size_t end)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    validate_read();
+    std::vector<Mixed> values;
+    if (can_use_evaluation_window() && begin < end) {
+        const TableView& tv = evaluate_window(end - 1);
+        if (end <= tv.size()) {
+            values.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i)
+                values.push_back(ObjLink(m_table->get_key(), tv.get_key(i)));
+            return values;
+        }
+    }
+    ensure_up_to_date();
+    size_t sz = do_size();
+    if (begin > end || end > sz) {
+        throw OutOfBounds{"get_range() on Results", end, sz};
+    }
+
+    values.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        switch (m_mode) {
+            case Mode::Empty:
+            case Mode::Query:
+                REALM_UNREACHABLE();
+            case Mode::Table: {
+                auto table = m_table.unchecked_ptr();
+                values.push_back(ObjLink(table->get_key(), m_table_iterator.get(*table, i).get_key()));
+                break;
+            }
+            case Mode::Collection:
+                values.push_back(m_collection->get_any(actual_index(i)));
+                break;
+            case Mode::TableView:
+                if (m_update_policy == UpdatePolicy::Never && !m_table_view.is_obj_valid(i))
+                    values.push_back(Mixed());
+                else
+                    values.push_back(ObjLink(m_table->get_key(), m_table_view.get_key(i)));
+                break;
+        }
+    }
+    return values;
+}
+
+std::vector<Obj> Results::get_objects(size_t begin, size_t end)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    validate_read();
+    if (!m_table || do_get_type() != PropertyType::Object) {
+        throw IllegalOperation("get_objects() is only available for Results of objects");
+    }
+    std::vector<Obj> objects;
+    if (can_use_evaluation_window() && begin < end) {
+        const TableView& tv = evaluate_window(end - 1);
+        if (end <= tv.size()) {
+            objects.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i)
+                objects.push_back(tv.get_object(i));
+            return objects;
+        }
+    }
+    ensure_up_to_date();
+    size_t sz = do_size();
+    if (begin > end || end > sz) {
+        throw OutOfBounds{"get_objects() on Results", end, sz};
+    }
+
+    objects.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        switch (m_mode) {
+            case Mode::Empty:
+            case Mode::Query:
+                REALM_UNREACHABLE();
+            case Mode::Table:
+                objects.push_back(m_table_iterator.get(*m_table, i));
+                break;
+            case Mode::Collection: {
+                auto m = m_collection->get_any(i);
+                if (m.is_type(type_Link))
+                    objects.push_back(m_table->get_object(m.get<ObjKey>()));
+                else if (m.is_type(type_TypedLink))
+                    objects.push_back(m_table->get_parent_group()->get_object(m.get_link()));
+                else
+                    objects.push_back(Obj());
+                break;
+            }
+            case Mode::TableView:
+                objects.push_back(m_table_view.get_object(i));
+                break;
+        }
+    }
+    return objects;
+}
+
 static std::vector<ExtendedColumnKey> parse_keypath(StringData keypath, Schema const& schema,
                                                     const ObjectSchema* object_schema)
 {
@@ -1082,6 +1344,8 @@ void Results::prepare_async(ForCallback force) NO_THREAD_SAFETY_ANALYSIS
         m_notifier = std::make_shared<_impl::ListResultsNotifier>(*this);
     else
         m_notifier = std::make_shared<_impl::ResultsNotifier>(*this);
+    for (auto column : m_live_aggregate_columns)
+        m_notifier->add_live_aggregate(column);
     _impl::RealmCoordinator::register_notifier(m_notifier);
 }
 
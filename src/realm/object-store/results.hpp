@@ -42,7 +42,8 @@ class SectionedResults;
 
 namespace _impl {
 class ResultsNotifierBase;
-}
+struct LiveAggregates;
+} // namespace _impl
 
 namespace object_store {
 class Dictionary;
@@ -108,6 +109,27 @@ public:
     // Get a tableview containing the same rows as this Results
     TableView get_tableview() REQUIRES(!m_mutex);
 
+    // Get a copy of the TableView backing this Results if the query has
+    // already been evaluated and the TableView is up to date. Unlike
+    // get_tableview(), this never evaluates the query.
+    util::Optional<TableView> get_evaluated_tableview() const REQUIRES(!m_mutex);
+
+    // Get the BM25 relevance of each object in this Results for the fulltext
+    // search `terms` on `column`, which must have a fulltext index
+    std::vector<double> get_fulltext_scores(ColKey column, StringData terms) REQUIRES(!m_mutex);
+
+    // Read the values of `columns` for the objects at [begin, end) in this
+    // Results, which must be Results of objects. The result is column-major,
+    // as for Table::get_values(). Throws OutOfBounds if end > size()
+    std::vector<Mixed> get_values(size_t begin, size_t end, const std::vector<ColKey>& columns) REQUIRES(!m_mutex);
+
+    // Get the values or objects at [begin, end) in this Results, checking its
+    // validity and bringing it up to date only once rather than once per
+    // element. get_objects() requires Results of objects. Throws OutOfBounds
+    // if end > size()
+    std::vector<Mixed> get_range(size_t begin, size_t end) REQUIRES(!m_mutex);
+    std::vector<Obj> get_objects(size_t begin, size_t end) REQUIRES(!m_mutex);
+
     // Get the object type which will be returned by get()
     StringData get_object_type() const noexcept;
 
@@ -117,6 +139,15 @@ public:
     // Can be either O(1) or O(N) depending on the state of things
     size_t size() REQUIRES(!m_mutex);
 
+    // Evaluate the query lazily when getting objects by index. Rather than
+    // running the whole query, get(), get_any() and first() find the matches
+    // up to the requested index plus `window` more, and the evaluated prefix
+    // grows geometrically as later indexes are requested. This only applies to
+    // Results of objects based on a query with no sort, distinct or limit,
+    // until the Results is evaluated in full, for example by a notifier. Zero
+    // (the default) disables it.
+    void set_evaluation_window(size_t window) REQUIRES(!m_mutex);
+
     // Get the row accessor for the given index
     // Throws OutOfBoundsIndexException if index >= size()
     template <typename T = Obj>
@@ -227,6 +258,31 @@ public:
         return sum(key(column_name));
     }
 
+    // Group the objects by the value of the given column and compute the
+    // given aggregates for each group, in a single pass over the objects.
+    // Sorting does not change the result; distinct and limit do.
+    // Throws IllegalOperation for Results which are not of objects, for a
+    // column which cannot be grouped by, or for an aggregate which is not
+    // supported on its column
+    GroupByResult group_by(ColKey column, const std::vector<GroupByAggregate>& aggregates) REQUIRES(!m_mutex);
+
+    // Maintain the min/max/average/sum of the given int, float or double
+    // column in the background thread which runs the notifier for this Results,
+    // updating them from the objects inserted, deleted and modified by each
+    // commit instead of evaluating them again. While the notifier is up to date
+    // with the Realm, the functions above return those values rather than
+    // reading the column of every object. This takes effect once a
+    // notification callback has been added.
+    // Float and double sums are updated by subtracting the values removed, so
+    // they can differ from a newly computed sum by rounding.
+    // Throws IllegalOperation for Results which are not of objects, or for
+    // columns of any other type
+    void track_aggregates(ColKey column) REQUIRES(!m_mutex);
+    void track_aggregates(StringData column_name) REQUIRES(!m_mutex)
+    {
+        track_aggregates(key(column_name));
+    }
+
     enum class Mode {
         // A default-constructed Results which is backed by nothing. This
         // behaves as if it was backed by an empty table/collection, and is
@@ -350,6 +406,14 @@ private:
     UpdatePolicy m_update_policy = UpdatePolicy::Auto;
     uint64_t m_last_collection_content_version GUARDED_BY(m_mutex) = 0;
 
+    size_t m_evaluation_window GUARDED_BY(m_mutex) = 0;
+    // The first matches of m_query when evaluated through the evaluation
+    // window, and the limit used to find them
+    TableView m_window_view GUARDED_BY(m_mutex);
+    size_t m_window_limit GUARDED_BY(m_mutex) = 0;
+
+    std::vector<ColKey> m_live_aggregate_columns GUARDED_BY(m_mutex);
+
     void validate_read() const;
     void validate_write() const;
 
@@ -366,8 +430,13 @@ private:
     template <typename T>
     util::Optional<T> try_get(size_t) REQUIRES(m_mutex);
 
+    bool can_use_evaluation_window() REQUIRES(m_mutex);
+    const TableView& evaluate_window(size_t ndx) REQUIRES(m_mutex);
+
     template <typename AggregateFunction>
     util::Optional<Mixed> aggregate(ColKey column, const char* name, AggregateFunction&& func) REQUIRES(!m_mutex);
+    // The aggregates of `column` maintained by the notifier, if they are current
+    bool get_live_aggregates(ColKey column, _impl::LiveAggregates& out) REQUIRES(!m_mutex);
 
     template <typename Fn>
     auto dispatch(Fn&&) const REQUIRES(!m_mutex);
@@ -83,12 +83,13 @@ struct IndexSetAdder {
 struct SectionedResultsNotificationHandler {
 public:
     SectionedResultsNotificationHandler(SectionedResults& sectioned_results,
-                                        SectionedResultsNotificationCallback&& cb,
+                                        SectionedResultsNotificationCallback&& cb, bool has_key_path_filter,
                                         util::Optional<Mixed> section_filter = util::none)
         : m_cb(std::move(cb))
         , m_sectioned_results(sectioned_results)
         , m_prev_row_to_index_path(m_sectioned_results.m_row_to_index_path)
         , m_section_filter(section_filter)
+        , m_has_key_path_filter(has_key_path_filter)
     {
     }
 
@@ -96,7 +97,11 @@ public:
     {
         util::CheckedUniqueLock lock(m_sectioned_results.m_mutex);
 
-        m_sectioned_results.calculate_sections_if_required();
+        // After the initial notification, `c` covers every change since the sections were calculated for the
+        // previous notification. A key path filter may hide modifications which change the section keys.
+        bool changes_are_complete = !m_is_initial_notification && !m_has_key_path_filter;
+        m_is_initial_notification = false;
+        m_sectioned_results.calculate_sections_if_required(changes_are_complete ? &c : nullptr);
         section_initial_changes(c);
         m_prev_row_to_index_path = m_sectioned_results.m_row_to_index_path;
 
@@ -187,6 +192,8 @@ private:
     // change indices referring to the supplied section key.
     util::Optional<Mixed> m_section_filter;
     bool m_section_filter_should_deliver_initial_notification = true;
+    bool m_has_key_path_filter;
+    bool m_is_initial_notification = true;
 
     // Group the changes in the changeset by the section
     void section_initial_changes(CollectionChangeSet const& c) REQUIRES(m_sectioned_results.m_mutex)
@@ -294,6 +301,18 @@ void create_buffered_key(Mixed& key, std::list<std::string>& buffer, StringType
     }
 }
 
+template <typename StringType>
+void create_buffered_key(Mixed& key, std::string& buffer, StringType value)
+{
+    if (value.size() == 0) {
+        key = StringType("", 0);
+    }
+    else {
+        buffer.assign(value.data(), value.size());
+        key = StringType(buffer.data(), value.size());
+    }
+}
+
 template <typename Buffer>
 void create_buffered_key(Mixed& key, Buffer& buffer)
 {
@@ -385,10 +404,11 @@ SectionedResults::SectionedResults(Results results, SectionKeyFunc section_key_f
 SectionedResults::SectionedResults(Results results, Results::SectionedResultsOperator op, StringData prop_name)
     : m_results(results)
     , m_callback(builtin_comparison(results, op, prop_name))
+    , m_cache_section_keys(true)
 {
 }
 
-void SectionedResults::calculate_sections_if_required()
+void SectionedResults::calculate_sections_if_required(const CollectionChangeSet* changes)
 {
     if (m_results.m_update_policy == Results::UpdatePolicy::Never)
         return;
@@ -400,13 +420,24 @@ void SectionedResults::calculate_sections_if_required()
         m_results.ensure_up_to_date();
     }
 
-    calculate_sections();
+    calculate_sections(changes);
+}
+
+Mixed SectionedResults::compute_section_key(Mixed value)
+{
+    Mixed key = m_callback(value, m_results.get_realm());
+    // Disallow links as section keys. It would be uncommon to use them to begin with
+    // and if the object acting as the key was deleted bad things would happen.
+    if (key.is_type(type_Link, type_TypedLink)) {
+        throw InvalidArgument("Links are not supported as section keys.");
+    }
+    return key;
 }
 
 // This method will run in the following scenarios:
 // - SectionedResults is performing its initial evaluation.
 // - The underlying Table in the Results collection has changed
-void SectionedResults::calculate_sections()
+void SectionedResults::calculate_sections(const CollectionChangeSet* changes)
 {
     m_previous_str_buffers.clear();
     m_previous_str_buffers.swap(m_current_str_buffers);
@@ -422,12 +453,48 @@ void SectionedResults::calculate_sections()
     size_t size = m_results.size();
     m_row_to_index_path.resize(size);
 
+    auto get_obj_key = [](Mixed value) {
+        if (value.is_type(type_Link))
+            return value.get<ObjKey>();
+        if (value.is_type(type_TypedLink))
+            return value.get_link().get_obj_key();
+        return ObjKey();
+    };
+
+    // Objects are only identified by their key within a single table
+    bool use_cache = m_cache_section_keys && m_results.get_type() == PropertyType::Object;
+
+    // The cached keys are only known to be valid if the changes since they were computed are known. Otherwise
+    // start over. The objects inserted or modified since have to get their keys computed again.
+    if (!use_cache || !changes || !m_has_performed_initial_evaluation) {
+        m_section_key_cache.clear();
+    }
+    else if (!m_section_key_cache.empty()) {
+        for (const IndexSet* indexes : {&changes->insertions, &changes->modifications_new}) {
+            for (auto index : indexes->as_indexes()) {
+                if (index < size)
+                    m_section_key_cache.erase(get_obj_key(m_results.get_any(index)));
+            }
+        }
+    }
+    ++m_section_key_generation;
+
     for (size_t i = 0; i < size; ++i) {
-        Mixed key = m_callback(m_results.get_any(i), m_results.get_realm());
-        // Disallow links as section keys. It would be uncommon to use them to begin with
-        // and if the object acting as the key was deleted bad things would happen.
-        if (key.is_type(type_Link, type_TypedLink)) {
-            throw InvalidArgument("Links are not supported as section keys.");
+        Mixed value = m_results.get_any(i);
+        Mixed key;
+        ObjKey obj_key = use_cache ? get_obj_key(value) : ObjKey();
+        if (obj_key) {
+            auto cached = m_section_key_cache.find(obj_key);
+            if (cached == m_section_key_cache.end()) {
+                key = compute_section_key(value);
+                cached = m_section_key_cache.emplace(obj_key, CachedSectionKey{key, {}, 0}).first;
+                create_buffered_key(cached->second.key, cached->second.buffer);
+            }
+            cached->second.generation = m_section_key_generation;
+            key = cached->second.key;
+        }
+        else {
+            key = compute_section_key(value);
         }
 
         auto it = m_current_key_to_index.find(key);
@@ -444,6 +511,15 @@ void SectionedResults::calculate_sections()
             m_row_to_index_path[i] = {section.index, section.indices.size() - 1};
         }
     }
+    if (m_section_key_cache.size() > size) {
+        // Drop the keys of objects which are no longer in the results
+        for (auto it = m_section_key_cache.begin(); it != m_section_key_cache.end();) {
+            if (it->second.generation != m_section_key_generation)
+                it = m_section_key_cache.erase(it);
+            else
+                ++it;
+        }
+    }
     if (!m_has_performed_initial_evaluation) {
         REALM_ASSERT_EX(m_previous_key_to_index.size() == 0, m_previous_key_to_index.size());
         REALM_ASSERT_EX(m_previous_index_to_key.size() == 0, m_previous_index_to_key.size());
@@ -487,15 +563,19 @@ ResultsSection SectionedResults::operator[](Mixed key)
 NotificationToken SectionedResults::add_notification_callback(SectionedResultsNotificationCallback&& callback,
                                                               std::optional<KeyPathArray> key_path_array) &
 {
-    return m_results.add_notification_callback(SectionedResultsNotificationHandler(*this, std::move(callback)),
-                                               std::move(key_path_array));
+    bool has_key_path_filter = key_path_array.has_value();
+    return m_results.add_notification_callback(
+        SectionedResultsNotificationHandler(*this, std::move(callback), has_key_path_filter),
+        std::move(key_path_array));
 }
 
 NotificationToken SectionedResults::add_notification_callback_for_section(
     Mixed section_key, SectionedResultsNotificationCallback&& callback, std::optional<KeyPathArray> key_path_array)
 {
+    bool has_key_path_filter = key_path_array.has_value();
     return m_results.add_notification_callback(
-        SectionedResultsNotificationHandler(*this, std::move(callback), section_key), std::move(key_path_array));
+        SectionedResultsNotificationHandler(*this, std::move(callback), has_key_path_filter, section_key),
+        std::move(key_path_array));
 }
 
 // Thread-safety analysis doesn't work when creating a different instance of the
@@ -552,5 +632,13 @@ void SectionedResults::reset_section_callback(SectionKeyFunc section_callback)
     m_current_key_to_index.clear();
     m_previous_key_to_index.clear();
     m_row_to_index_path.clear();
+    m_section_key_cache.clear();
+}
+
+void SectionedResults::set_cache_section_keys(bool enable)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    m_cache_section_keys = enable;
+    m_section_key_cache.clear();
 }
 } // namespace realm
@@ -156,6 +156,13 @@ public:
     bool is_frozen() const REQUIRES(!m_mutex);
     /// Replaces the function which will perform the sectioning on the underlying results.
     void reset_section_callback(SectionKeyFunc section_callback) REQUIRES(!m_mutex);
+    /// Remember the section key of each object in the underlying results between evaluations. When a change
+    /// notification is delivered, only the keys of the objects it reports as inserted or modified are then computed
+    /// again, rather than the keys of all the objects. This is only correct if the key of an object can only change
+    /// when the object is reported as modified, i.e. it is computed from properties of the object or of objects
+    /// reachable through its links. Enabled by default for the builtin section algorithms. It has no effect on
+    /// results of primitive values, and on notification callbacks registered with a key path filter.
+    void set_cache_section_keys(bool enable) REQUIRES(!m_mutex);
 
 private:
     friend class Results;
@@ -168,8 +175,11 @@ private:
     friend struct SectionedResultsNotificationHandler;
     util::CheckedOptionalMutex m_mutex;
     SectionedResults copy(Results&&) REQUIRES(!m_mutex);
-    void calculate_sections_if_required() REQUIRES(m_mutex);
-    void calculate_sections() REQUIRES(m_mutex);
+    // `changes` are the changes to the underlying results since the sections were last calculated, or a superset
+    // of them, if they are known.
+    void calculate_sections_if_required(const CollectionChangeSet* changes = nullptr) REQUIRES(m_mutex);
+    void calculate_sections(const CollectionChangeSet* changes = nullptr) REQUIRES(m_mutex);
+    Mixed compute_section_key(Mixed value) REQUIRES(m_mutex);
     bool m_has_performed_initial_evaluation = false;
     NotificationToken
     add_notification_callback_for_section(Mixed section_key, SectionedResultsNotificationCallback&& callback,
@@ -199,6 +209,17 @@ private:
     // So we perform a deep copy to produce stable key values that will not change if the realm is modified.
     // The buffer will purge keys that are no longer used in the case that the `calculate_sections` method runs.
     std::list<std::string> m_previous_str_buffers, m_current_str_buffers GUARDED_BY(m_mutex);
+
+    // The section key of each object in the results as of the last calculation. `buffer` holds the
+    // string or binary data of the key, and `generation` is the last calculation the object was seen in.
+    struct CachedSectionKey {
+        Mixed key;
+        std::string buffer;
+        uint64_t generation = 0;
+    };
+    bool m_cache_section_keys GUARDED_BY(m_mutex) = false;
+    std::unordered_map<ObjKey, CachedSectionKey> m_section_key_cache GUARDED_BY(m_mutex);
+    uint64_t m_section_key_generation GUARDED_BY(m_mutex) = 0;
 };
 
 struct SectionedResultsChangeSet {
@@ -156,6 +156,12 @@ std::pair<size_t, bool> Set::insert_any(Mixed value)
     return set_base().insert_any(value);
 }
 
+size_t Set::insert_many_any(const std::vector<Mixed>& values)
+{
+    verify_in_transaction();
+    return set_base().insert_many_any(values);
+}
+
 Mixed Set::get_any(size_t ndx) const
 {
     verify_attached();
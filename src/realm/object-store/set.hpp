@@ -71,6 +71,7 @@ public:
     std::pair<size_t, bool> remove(Context&, T&&);
 
     std::pair<size_t, bool> insert_any(Mixed value);
+    size_t insert_many_any(const std::vector<Mixed>& values);
     Mixed get_any(size_t ndx) const final;
     std::pair<size_t, bool> remove_any(Mixed value);
     size_t find_any(Mixed value) const final;
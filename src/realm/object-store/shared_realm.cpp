@@ -24,6 +24,7 @@
 
 #include <realm/object-store/audit.hpp>
 #include <realm/object-store/binding_context.hpp>
+#include <realm/object-store/keypath_helpers.hpp>
 #include <realm/object-store/list.hpp>
 #include <realm/object-store/object.hpp>
 #include <realm/object-store/object_schema.hpp>
@@ -38,6 +39,7 @@
 #include <realm/util/fifo_helper.hpp>
 #include <realm/util/file.hpp>
 #include <realm/util/scope_exit.hpp>
+#include <realm/util/sha_crypto.hpp>
 
 #if REALM_ENABLE_SYNC
 #include <realm/object-store/sync/impl/sync_file.hpp>
@@ -54,6 +56,7 @@
 #include <iostream>
 #endif
 
+#include <cstring>
 #include <thread>
 
 using namespace realm;
@@ -75,6 +78,56 @@ public:
 private:
     size_t& m_count;
 };
+
+void append_schema(std::string& out, const Schema& schema)
+{
+    auto append = [&](std::string_view str) {
+        out += std::to_string(str.size());
+        out += ':';
+        out += str;
+    };
+    auto append_property = [&](const Property& prop) {
+        append(prop.name);
+        append(prop.public_name);
+        append(prop.object_type);
+        append(prop.link_origin_property_name);
+        out += std::to_string(int(prop.type));
+        out += prop.is_primary ? 'p' : '-';
+        out += prop.is_indexed ? 'i' : '-';
+        out += prop.is_fulltext_indexed ? 'f' : '-';
+    };
+    out += std::to_string(schema.size());
+    for (const ObjectSchema& object_schema : schema) {
+        append(object_schema.name);
+        append(object_schema.primary_key);
+        append(object_schema.alias);
+        out += std::to_string(int(object_schema.table_type));
+        out += '[';
+        for (const Property& prop : object_schema.persisted_properties)
+            append_property(prop);
+        out += '|';
+        for (const Property& prop : object_schema.computed_properties)
+            append_property(prop);
+        out += ']';
+    }
+}
+
+// A hash of everything that Realm::update_schema() looks at when deciding
+// whether the schema on disk needs to be changed. Never zero.
+uint64_t schema_fingerprint(const Schema& actual_schema, uint64_t actual_version, const Schema& schema,
+                            uint64_t version, SchemaMode mode, uint64_t validation_mode)
+{
+    std::string canonical = util::format("%1 %2 %3 %4 ", actual_version, version, int(mode), validation_mode);
+    append_schema(canonical, actual_schema);
+    canonical += '/';
+    append_schema(canonical, schema);
+
+    unsigned char digest[32];
+    util::sha256(canonical.data(), canonical.size(), digest);
+    uint64_t fingerprint;
+    std::memcpy(&fingerprint, digest, sizeof fingerprint);
+    return fingerprint == 0 ? 1 : fingerprint;
+}
 } // namespace
 
 bool RealmConfig::needs_file_format_upgrade() const
@@ -442,11 +495,27 @@ void Realm::update_schema(Schema schema, uint64_t version, MigrationFunction mig
         validation_mode |= SchemaValidationMode::RejectEmbeddedOrphans;
     }
 
-    schema.validate(static_cast<SchemaValidationMode>(validation_mode));
-
     bool was_in_read_transaction = is_in_read_transaction();
     Schema actual_schema = get_full_schema();
 
+    // If the same schema was found to need no changes on an earlier open, and
+    // neither it nor the schema on disk has changed since, the outcome of
+    // validating and comparing them is already known.
+    uint64_t fingerprint = 0;
+    if (m_config.cache_schema_fingerprint && !m_frozen_version && !m_config.immutable() &&
+        !m_config.read_only() && m_schema_version != ObjectStore::NotVersioned) {
+        fingerprint = schema_fingerprint(actual_schema, m_schema_version, schema, version, m_config.schema_mode,
+                                         validation_mode);
+        if (fingerprint == ObjectStore::get_schema_fingerprint(read_group())) {
+            if (!was_in_read_transaction)
+                m_transaction = nullptr;
+            set_schema(actual_schema, std::move(schema));
+            return;
+        }
+    }
+
+    schema.validate(static_cast<SchemaValidationMode>(validation_mode));
+
     // Frozen Realms never modify the schema on disk and we just need to verify
     // that the requested schema is compatible with what actually exists on disk
     // at that frozen version. Tables are allowed to be missing as those can be
@@ -461,6 +530,12 @@ void Realm::update_schema(Schema schema, uint64_t version, MigrationFunction mig
 
     std::vector<SchemaChange> required_changes = actual_schema.compare(schema, m_config.schema_mode);
     if (!schema_change_needs_write_transaction(schema, required_changes, version)) {
+        if (fingerprint && !in_transaction && !store_schema_fingerprint(fingerprint)) {
+            // The schema on disk was changed by someone else while we waited
+            // for the write lock, so start over with the new one.
+            return update_schema(std::move(schema), version, std::move(migration_function),
+                                 std::move(initialization_function), in_transaction);
+        }
         if (!was_in_read_transaction)
             m_transaction = nullptr;
         set_schema(actual_schema, std::move(schema));
@@ -517,10 +592,12 @@ void Realm::update_schema(Schema schema, uint64_t version, MigrationFunction mig
         // migration function needs to see the target schema on the "new" Realm
         std::swap(m_schema, schema);
         std::swap(m_schema_version, version);
+        m_keypath_mapping = nullptr;
         m_in_migration = true;
         auto restore = util::make_scope_exit([&]() noexcept {
             std::swap(m_schema, schema);
             std::swap(m_schema_version, version);
+            m_keypath_mapping = nullptr;
             m_in_migration = false;
         });
 
@@ -529,8 +606,13 @@ void Realm::update_schema(Schema schema, uint64_t version, MigrationFunction mig
                                           wrapper);
     }
     else {
+        AdditiveChangeOptions additive_options;
+        if (!in_transaction)
+            additive_options.objects_per_commit = m_config.schema_change_objects_per_commit;
+        additive_options.progress = m_config.schema_change_progress_function;
         ObjectStore::apply_schema_changes(transaction(), m_schema_version, schema, version, m_config.schema_mode,
-                                          required_changes, m_config.automatically_handle_backlinks_in_migrations);
+                                          required_changes, m_config.automatically_handle_backlinks_in_migrations,
+                                          nullptr, additive_options);
         REALM_ASSERT_DEBUG(additive ||
                            (required_changes = ObjectStore::schema_from_group(read_group()).compare(schema)).empty());
     }
@@ -540,9 +622,11 @@ void Realm::update_schema(Schema schema, uint64_t version, MigrationFunction mig
         uint64_t temp_version = ObjectStore::get_schema_version(read_group());
         std::swap(m_schema, schema);
         std::swap(m_schema_version, temp_version);
+        m_keypath_mapping = nullptr;
         auto restore = util::make_scope_exit([&]() noexcept {
             std::swap(m_schema, schema);
             std::swap(m_schema_version, temp_version);
+            m_keypath_mapping = nullptr;
         });
         initialization_function(shared_from_this());
     }
@@ -561,6 +645,20 @@ void Realm::update_schema(Schema schema, uint64_t version, MigrationFunction mig
     notify_schema_changed();
 }
 
+bool Realm::store_schema_fingerprint(uint64_t fingerprint)
+{
+    transaction().promote_to_write();
+    if (m_new_schema) {
+        cancel_transaction();
+        cache_new_schema();
+        return false;
+    }
+    ObjectStore::set_schema_fingerprint(read_group(), fingerprint);
+    m_coordinator->commit_write(*this);
+    cache_new_schema();
+    return true;
+}
+
 void Realm::rename_property(Schema schema, StringData object_type, StringData old_name, StringData new_name)
 {
     ObjectStore::rename_property(read_group(), schema, object_type, old_name, new_name);
@@ -568,7 +666,9 @@ void Realm::rename_property(Schema schema, StringData object_type, StringData ol
 
 void Realm::add_schema_change_handler()
 {
-    if (m_config.immutable())
+    // The schema of a frozen Realm can't change, and its transaction may be
+    // shared with other frozen Realms
+    if (m_config.immutable() || m_frozen_version)
         return;
     m_transaction->set_schema_change_notification_handler([&] {
         m_new_schema = ObjectStore::schema_from_group(read_group());
@@ -610,8 +710,21 @@ void Realm::translate_schema_error()
     throw;
 }
 
+std::shared_ptr<const query_parser::KeyPathMapping> Realm::get_keypath_mapping()
+{
+    // Frozen Realms may be used by several threads at once
+    std::lock_guard lock(m_keypath_mapping_mutex);
+    if (!m_keypath_mapping) {
+        auto mapping = std::make_shared<query_parser::KeyPathMapping>();
+        populate_keypath_mapping(*mapping, *this);
+        m_keypath_mapping = std::move(mapping);
+    }
+    return m_keypath_mapping;
+}
+
 void Realm::notify_schema_changed()
 {
+    m_keypath_mapping = nullptr;
     if (m_binding_context) {
         m_binding_context->schema_did_change(m_schema);
     }
@@ -696,6 +809,12 @@ uint_fast64_t Realm::get_number_of_versions() const
     return m_coordinator->get_number_of_versions();
 }
 
+DB::Metrics Realm::get_storage_metrics() const
+{
+    verify_open();
+    return m_coordinator->get_storage_metrics();
+}
+
 bool Realm::is_in_transaction() const noexcept
 {
     return !m_config.immutable() && !is_closed() && m_transaction &&
@@ -753,7 +872,8 @@ void Realm::wait_for_change_release()
 bool Realm::has_pending_async_work() const
 {
     verify_thread();
-    return !m_async_commit_q.empty() || !m_async_write_q.empty() || (m_transaction && m_transaction->is_async());
+    return !m_async_commit_q.empty() || !m_async_write_q.empty() || !m_batched_async_commits.empty() ||
+           (m_transaction && m_transaction->is_async());
 }
 
 void Realm::run_writes_on_proper_thread()
@@ -769,10 +889,14 @@ void Realm::call_completion_callbacks()
         return;
     }
 
-    CountGuard sending_completions(m_is_running_async_commit_completions);
-    auto error = m_transaction->get_commit_exception();
     auto completions = std::move(m_async_commit_q);
     m_async_commit_q.clear();
+    invoke_async_completions(completions, m_transaction->get_commit_exception());
+}
+
+void Realm::invoke_async_completions(std::vector<AsyncCommitDesc>& completions, std::exception_ptr error)
+{
+    CountGuard sending_completions(m_is_running_async_commit_completions);
     for (auto& cb : completions) {
         if (!cb.when_completed)
             continue;
@@ -790,6 +914,40 @@ void Realm::call_completion_callbacks()
     }
 }
 
+bool Realm::should_defer_async_commit() const
+{
+    // Only a write block run from the queue can be merged with the next one,
+    // which has to be a write block too
+    if (!m_async_write_batching || !m_is_running_async_writes || m_async_write_q.empty() ||
+        m_async_write_q.front().notify_only) {
+        return false;
+    }
+    if (m_batched_async_commits.size() + 1 >= m_async_write_batching->max_blocks) {
+        return false;
+    }
+    return std::chrono::steady_clock::now() - m_async_write_batch_start < m_async_write_batching->max_latency;
+}
+
+void Realm::take_batched_async_commits()
+{
+    // The deferred commits are completed by the commit of the whole batch
+    m_async_commit_q.insert(m_async_commit_q.end(), std::make_move_iterator(m_batched_async_commits.begin()),
+                            std::make_move_iterator(m_batched_async_commits.end()));
+    m_batched_async_commits.clear();
+}
+
+void Realm::abort_batched_async_commits()
+{
+    if (m_batched_async_commits.empty()) {
+        return;
+    }
+    auto aborted = std::move(m_batched_async_commits);
+    m_batched_async_commits.clear();
+    invoke_async_completions(aborted, std::make_exception_ptr(Exception(
+                                          ErrorCodes::OperationAborted,
+                                          "The batched write transaction was rolled back by a later write block")));
+}
+
 void Realm::run_async_completions()
 {
     call_completion_callbacks();
@@ -853,7 +1011,13 @@ void Realm::run_writes()
             return;
         }
 
-        do_begin_transaction();
+        // The transaction is still open if the previous write block deferred its commit
+        if (!is_in_transaction()) {
+            do_begin_transaction();
+        }
+        if (m_async_write_batching && m_batched_async_commits.empty()) {
+            m_async_write_batch_start = std::chrono::steady_clock::now();
+        }
 
         auto write_desc = std::move(m_async_write_q.front());
         m_async_write_q.pop_front();
@@ -870,6 +1034,8 @@ void Realm::run_writes()
                 transaction::cancel(*m_transaction, m_binding_context.get());
             }
             m_notify_only = false;
+            m_async_commit_deferred = false;
+            abort_batched_async_commits();
 
             if (m_async_exception_handler) {
                 m_async_exception_handler(write_desc.handle, std::current_exception());
@@ -891,6 +1057,12 @@ void Realm::run_writes()
             return;
         }
 
+        if (m_async_commit_deferred) {
+            // The next write block runs in the same transaction
+            m_async_commit_deferred = false;
+            continue;
+        }
+
         auto new_version = m_transaction->get_version();
         // if we've run the full transaction, there is follow up work to do:
         if (new_version > prev_version) {
@@ -903,12 +1075,20 @@ void Realm::run_writes()
             if (m_transaction->get_transact_stage() == DB::transact_Writing) {
                 // Still in writing stage - we make a rollback
                 transaction::cancel(transaction(), m_binding_context.get());
+                abort_batched_async_commits();
             }
         }
         if (m_async_commit_barrier_requested)
             break;
     }
 
+    // The queued write block which a batch was kept open for may have been
+    // cancelled, in which case the batch is committed on its own
+    if (!m_batched_async_commits.empty() && m_transaction && is_in_transaction()) {
+        take_batched_async_commits();
+        m_coordinator->commit_write(*this, /* commit_to_disk: */ false);
+    }
+
     end_current_write();
 }
 
@@ -952,9 +1132,18 @@ auto Realm::async_commit_transaction(util::UniqueFunction<void(std::exception_pt
     REALM_ASSERT(!m_notify_only);
     // auditing is not supported
     REALM_ASSERT(!audit_context());
+    auto handle = m_async_commit_handle++;
+    if (should_defer_async_commit()) {
+        // Keep the write transaction open for the next queued write block
+        m_batched_async_commits.push_back({std::move(completion), handle});
+        m_async_commit_deferred = true;
+        return handle;
+    }
+
     // grab a version lock on current version, push it along with the done block
     // do in-buffer-cache commit_transaction();
-    auto handle = m_async_commit_handle++;
+    size_t batch_begin = m_async_commit_q.size();
+    take_batched_async_commits();
     m_async_commit_q.push_back({std::move(completion), handle});
     try {
         m_coordinator->commit_write(*this, /* commit_to_disk: */ false);
@@ -964,14 +1153,13 @@ auto Realm::async_commit_transaction(util::UniqueFunction<void(std::exception_pt
         // transaction and remove the completion handler from the queue
         if (is_in_transaction()) {
             // Exception happened before the commit, so roll back the transaction
-            // and remove the completion handler from the queue
+            // and remove the completion handler from the queue. The earlier
+            // blocks of a batch are rolled back along with it.
+            auto batch_end = m_async_commit_q.end() - 1;
+            m_batched_async_commits.assign(std::make_move_iterator(m_async_commit_q.begin() + batch_begin),
+                                           std::make_move_iterator(batch_end));
+            m_async_commit_q.erase(m_async_commit_q.begin() + batch_begin, m_async_commit_q.end());
             cancel_transaction();
-            auto it = std::find_if(m_async_commit_q.begin(), m_async_commit_q.end(), [=](auto& e) {
-                return e.handle == handle;
-            });
-            if (it != m_async_commit_q.end()) {
-                m_async_commit_q.erase(it);
-            }
         }
         else if (m_transaction) {
             end_current_write(false);
@@ -1069,6 +1257,8 @@ void Realm::commit_transaction()
         audit->prepare_for_write(prev_version);
     }
 
+    // Write blocks whose async commit was deferred are committed along with this one
+    take_batched_async_commits();
     m_coordinator->commit_write(*this, /* commit_to_disk */ true);
     cache_new_schema();
 
@@ -1082,6 +1272,9 @@ void Realm::commit_transaction()
     if (auto audit = audit_context()) {
         audit->record_write(prev_version, transaction().get_version_of_current_transaction());
     }
+    if (m_config.deliver_notifications_on_commit && m_transaction && !m_is_sending_notifications) {
+        m_coordinator->deliver_commit_notifications(*this);
+    }
 }
 
 void Realm::cancel_transaction()
@@ -1096,6 +1289,8 @@ void Realm::cancel_transaction()
     }
 
     transaction::cancel(transaction(), m_binding_context.get());
+    m_async_commit_deferred = false;
+    abort_batched_async_commits();
 
     if (m_transaction && !m_is_running_async_writes) {
         if (m_async_write_q.empty()) {
@@ -1137,6 +1332,7 @@ void Realm::do_invalidate()
     m_transaction = nullptr;
     m_async_write_q.clear();
     m_async_commit_q.clear();
+    m_batched_async_commits.clear();
 }
 
 bool Realm::compact()
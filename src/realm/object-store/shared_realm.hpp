@@ -28,8 +28,10 @@
 #include <realm/transaction.hpp>
 #include <realm/version_id.hpp>
 
-#include <memory>
+#include <chrono>
 #include <deque>
+#include <memory>
+#include <mutex>
 
 namespace realm {
 class AuditInterface;
@@ -50,6 +52,10 @@ struct SyncConfig;
 typedef std::shared_ptr<Realm> SharedRealm;
 typedef std::weak_ptr<Realm> WeakRealm;
 
+namespace query_parser {
+class KeyPathMapping;
+}
+
 namespace sync {
 class SubscriptionSet;
 }
@@ -80,6 +86,11 @@ using MigrationFunction = std::function<void(SharedRealm old_realm, SharedRealm
 // schema creation in a single transaction.
 using DataInitializationFunction = std::function<void(SharedRealm realm)>;
 
+// A callback which is called while additive schema changes are applied when
+// opening a Realm, after each change, with the number of changes applied so far
+// and the total number of changes.
+using SchemaChangeProgressFunction = std::function<void(size_t applied, size_t total)>;
+
 // A callback function called when opening a SharedRealm when no cached
 // version of this Realm exists. It is passed the total bytes allocated for
 // the file (file size) and the total bytes used by data in the file.
@@ -177,6 +188,26 @@ struct RealmConfig {
     // it instead delete orphans and duplicate objects with multiple incoming links.
     bool automatically_handle_backlinks_in_migrations = false;
 
+    // Store a fingerprint of the schema in the file when opening it finds that
+    // no schema changes are needed, so that later opens with the same schema,
+    // schema version and schema mode can skip validating the schema and
+    // comparing it to the one in the file. Storing the fingerprint requires a
+    // write transaction, which is performed by the first such open only.
+    bool cache_schema_fingerprint = false;
+
+    // With the additive schema modes, adding columns and search indexes to
+    // tables that hold many objects can take a long time and use a lot of
+    // memory. If nonzero, the schema changes applied so far are committed,
+    // while keeping the write transaction open, each time the tables changed
+    // since the last commit hold at least this many objects. The schema
+    // version is only updated by the final commit, so changes that were not
+    // committed are applied again by the next open if the process is
+    // interrupted. Not used when update_schema() is called within a write
+    // transaction. The progress function is called within the write
+    // transaction, and must not use the Realm.
+    size_t schema_change_objects_per_commit = 0;
+    SchemaChangeProgressFunction schema_change_progress_function;
+
     // Only for internal testing. Not to be exposed by SDKs.
     //
     // Disable the background worker thread for producing change
@@ -185,6 +216,21 @@ struct RealmConfig {
     // speeds up tests that don't need notifications.
     bool automatic_change_notifications = true;
 
+    // Run the notifiers of a Realm which has callbacks registered on the
+    // calling thread at the end of commit_transaction(), and deliver their
+    // notifications before it returns, so that the callbacks see the changes
+    // made by the write without waiting for the background worker thread and
+    // the scheduler. This makes commits which are observed slower, as the
+    // notifiers' queries are rerun within commit_transaction().
+    bool deliver_notifications_on_commit = false;
+
+    // Runs of a notifier on the background worker thread which take at least
+    // this long are logged at warn level, along with what the notifier
+    // observes, e.g. the description of the query of a Results. Zero disables
+    // this. See RealmCoordinator::get_notifier_stats() for the timings of all
+    // notifiers.
+    std::chrono::milliseconds slow_notifier_threshold{0};
+
     // For internal use and should not be exposed by SDKs.
     //
     // If the file is invalid or can't be decrypted with the given encryption
@@ -258,6 +304,11 @@ public:
         return m_schema_version;
     }
 
+    // The mapping from the aliases and public names in the schema to the names
+    // used in the file, for the query parser. It is built when first needed
+    // and then shared by all queries until the schema changes.
+    std::shared_ptr<const query_parser::KeyPathMapping> get_keypath_mapping();
+
     void begin_transaction();
     void commit_transaction();
     void cancel_transaction();
@@ -309,6 +360,28 @@ public:
         m_async_exception_handler = std::move(hndlr);
     }
 
+    // Opt-in merging of queued asynchronous write blocks into a single write
+    // transaction.
+    // * When a write block calls async_commit_transaction() and the next queued
+    //   block is a write block too, the commit is deferred and the next block
+    //   runs in the same write transaction. The batch is committed once no
+    //   further block is queued, `max_blocks` blocks have been merged or
+    //   `max_latency` has passed since the first block of the batch ran.
+    // * The completion callback of every block is called once the batch has
+    //   been committed, with the outcome of that commit.
+    // * As the blocks share a transaction, a block which cancels the write
+    //   transaction or throws discards the changes of the earlier blocks of the
+    //   batch too; their completion callbacks are then called with an
+    //   OperationAborted error.
+    struct AsyncWriteBatching {
+        size_t max_blocks = 100;
+        std::chrono::milliseconds max_latency{10};
+    };
+    void set_async_write_batching(util::Optional<AsyncWriteBatching> batching)
+    {
+        m_async_write_batching = batching;
+    }
+
     // Returns a frozen copy for the current version of this Realm
     // If called from within a write transaction, the returned Realm will
     // reflect the state at the beginning of the write transaction. Any
@@ -334,6 +407,9 @@ public:
     // Returns the number of versions in the Realm file.
     uint_fast64_t get_number_of_versions() const;
 
+    // Returns the metrics of the storage engine for the Realm file.
+    DB::Metrics get_storage_metrics() const;
+
     VersionID read_transaction_version() const;
     Group& read_group();
     // Get the version of the current read or frozen transaction, or `none` if the Realm
@@ -525,6 +601,8 @@ private:
     Schema m_schema;
     util::Optional<Schema> m_new_schema;
     uint64_t m_schema_transaction_version = -1;
+    std::shared_ptr<const query_parser::KeyPathMapping> m_keypath_mapping;
+    std::mutex m_keypath_mapping_mutex;
 
     // FIXME: this should be a Dynamic schema mode instead, but only once
     // that's actually fully working
@@ -556,6 +634,11 @@ private:
     size_t m_is_running_async_commit_completions = 0;
     bool m_async_commit_barrier_requested = false;
     util::UniqueFunction<void(AsyncHandle, std::exception_ptr)> m_async_exception_handler;
+    util::Optional<AsyncWriteBatching> m_async_write_batching;
+    // Completions of the write blocks in the current batch whose commit was deferred
+    std::vector<AsyncCommitDesc> m_batched_async_commits;
+    std::chrono::steady_clock::time_point m_async_write_batch_start;
+    bool m_async_commit_deferred = false;
 
     void begin_read(VersionID);
     bool do_refresh();
@@ -565,6 +648,7 @@ private:
     void set_schema(Schema const& reference, Schema schema);
     bool reset_file(Schema& schema, std::vector<SchemaChange>& changes_required);
     bool schema_change_needs_write_transaction(Schema& schema, std::vector<SchemaChange>& changes, uint64_t version);
+    bool store_schema_fingerprint(uint64_t fingerprint);
     void verify_schema_version_not_decreasing(uint64_t version);
     Schema get_full_schema();
 
@@ -588,6 +672,10 @@ private:
     void call_completion_callbacks();
     void run_writes();
     void run_async_completions();
+    void invoke_async_completions(std::vector<AsyncCommitDesc>& completions, std::exception_ptr error);
+    bool should_defer_async_commit() const;
+    void take_batched_async_commits();
+    void abort_batched_async_commits();
 
 public:
     std::unique_ptr<BindingContext> m_binding_context;
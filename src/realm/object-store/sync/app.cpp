@@ -1046,8 +1046,16 @@ void App::request_location(UniqueFunction<void(std::optional<AppError>)>&& compl
         // If this is querying the new_hostname, then use that location
         else if (new_hostname)
             app_route = get_app_route(new_hostname);
-        else
+        else {
             app_route = get_app_route();
+            // Wait for the location request in flight, if any, rather than sending another one
+            m_location_waiters.push_back(std::move(completion));
+            if (m_location_waiters.size() > 1)
+                return;
+            completion = [self = shared_from_this()](std::optional<AppError> error) {
+                self->complete_location_request(error);
+            };
+        }
         REALM_ASSERT(!app_route.empty());
     }
 
@@ -1102,6 +1110,18 @@ void App::request_location(UniqueFunction<void(std::optional<AppError>)>&& compl
     });
 }
 
+void App::complete_location_request(const std::optional<AppError>& error)
+{
+    std::vector<util::UniqueFunction<void(std::optional<AppError>)>> waiters;
+    {
+        util::CheckedLockGuard guard(m_route_mutex);
+        waiters = std::move(m_location_waiters);
+        m_location_waiters.clear();
+    }
+    for (auto& waiter : waiters)
+        waiter(error);
+}
+
 std::optional<AppError> App::update_location(const Response& response, const std::string& base_url)
 {
     // Validate the location info response for errors and update the stored location info if it is
@@ -1301,6 +1321,19 @@ void App::refresh_access_token(const std::shared_ptr<User>& user, bool update_lo
         return;
     }
 
+    // Wait for the refresh of the token of this user in flight, if any, rather than sending another request. A
+    // refresh which updates the location does not, so that the location is updated.
+    if (!update_location) {
+        util::CheckedUniqueLock lock(m_refresh_mutex);
+        auto& waiters = m_refresh_waiters[user->user_id()];
+        waiters.push_back(std::move(completion));
+        if (waiters.size() > 1)
+            return;
+        completion = [self = shared_from_this(), user_id = user->user_id()](std::optional<AppError> error) {
+            self->complete_refresh(user_id, error);
+        };
+    }
+
     log_debug("App: refresh_access_token: user_id: %1%2", user->user_id(),
               update_location ? " (updating location)" : "");
 
@@ -1333,6 +1366,20 @@ void App::refresh_access_token(const std::shared_ptr<User>& user, bool update_lo
         update_location);
 }
 
+void App::complete_refresh(const std::string& user_id, const std::optional<AppError>& error)
+{
+    std::vector<util::UniqueFunction<void(std::optional<AppError>)>> waiters;
+    {
+        util::CheckedLockGuard lock(m_refresh_mutex);
+        auto it = m_refresh_waiters.find(user_id);
+        REALM_ASSERT(it != m_refresh_waiters.end());
+        waiters = std::move(it->second);
+        m_refresh_waiters.erase(it);
+    }
+    for (auto& waiter : waiters)
+        waiter(error);
+}
+
 std::string App::function_call_url_path() const
 {
     util::CheckedLockGuard guard(m_route_mutex);
@@ -146,10 +146,10 @@ public:
     /// @param update_location If true, the location metadata will be updated before refresh
     void refresh_custom_data(const std::shared_ptr<User>& user, bool update_location,
                              util::UniqueFunction<void(std::optional<AppError>)>&& completion)
-        REQUIRES(!m_route_mutex);
+        REQUIRES(!m_route_mutex, !m_refresh_mutex);
     void refresh_custom_data(const std::shared_ptr<User>& user,
                              util::UniqueFunction<void(std::optional<AppError>)>&& completion)
-        REQUIRES(!m_route_mutex);
+        REQUIRES(!m_route_mutex, !m_refresh_mutex);
 
     /// Log out the given user if they are not already logged out.
     void log_out(const std::shared_ptr<User>& user, util::UniqueFunction<void(std::optional<AppError>)>&& completion)
@@ -473,6 +473,15 @@ private:
     std::string m_host_url GUARDED_BY(m_route_mutex);
     // Base hostname for Device Sync websocket requests
     std::string m_ws_host_url GUARDED_BY(m_route_mutex);
+    // Completions waiting for the location request in flight, so that concurrent requests for the location share a
+    // single one. Empty if there is no such request.
+    std::vector<util::UniqueFunction<void(std::optional<AppError>)>> m_location_waiters GUARDED_BY(m_route_mutex);
+
+    util::CheckedMutex m_refresh_mutex;
+    // Completions waiting for the access token refresh in flight for each user id, so that concurrent refreshes,
+    // such as when several requests fail with an expired access token, share a single request
+    std::unordered_map<std::string, std::vector<util::UniqueFunction<void(std::optional<AppError>)>>>
+        m_refresh_waiters GUARDED_BY(m_refresh_mutex);
 
     const uint64_t m_request_timeout_ms;
     std::unique_ptr<SyncFileManager> m_file_manager;
@@ -497,7 +506,10 @@ private:
     /// @param update_location If true, the location metadata will be updated before refresh
     void refresh_access_token(const std::shared_ptr<User>& user, bool update_location,
                               util::UniqueFunction<void(std::optional<AppError>)>&& completion)
-        REQUIRES(!m_route_mutex);
+        REQUIRES(!m_route_mutex, !m_refresh_mutex);
+    /// Calls the completions waiting for the access token refresh of a user
+    void complete_refresh(const std::string& user_id, const std::optional<AppError>& error)
+        REQUIRES(!m_refresh_mutex);
 
     /// The completion type for all intermediate operations which occur before performing the original request
     using IntermediateCompletion = util::UniqueFunction<void(std::unique_ptr<Request>&&, const Response&)>;
@@ -510,7 +522,8 @@ private:
     /// occurs, if the refresh was a success the newly attempted response will be passed back
     void handle_auth_failure(const AppError& error, std::unique_ptr<Request>&& request, const Response& response,
                              const std::shared_ptr<User>& user, RequestTokenType token_type,
-                             util::UniqueFunction<void(const Response&)>&& completion) REQUIRES(!m_route_mutex);
+                             util::UniqueFunction<void(const Response&)>&& completion)
+        REQUIRES(!m_route_mutex, !m_refresh_mutex);
 
     std::string url_for_path(const std::string& path) const override REQUIRES(!m_route_mutex);
 
@@ -530,6 +543,9 @@ private:
                           std::optional<std::string>&& redir_location = std::nullopt, int redirect_count = 0)
         REQUIRES(!m_route_mutex);
 
+    /// Calls the completions waiting for the location request
+    void complete_location_request(const std::optional<AppError>& error) REQUIRES(!m_route_mutex);
+
     /// Update the location metadata from the location response
     /// @param response The response returned from the location request
     /// @param base_url The base URL to use when setting the location metadata
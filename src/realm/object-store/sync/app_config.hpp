@@ -26,6 +26,10 @@
 #include <realm/util/logger.hpp>
 
 namespace realm {
+namespace sync {
+struct SessionTelemetry;
+}
+
 struct SyncClientTimeouts {
     SyncClientTimeouts();
     // See sync::Client::Config for the meaning of these fields.
@@ -68,6 +72,25 @@ struct SyncClientConfig {
     // @}
 
     SyncClientTimeouts timeouts;
+
+    // The number of threads used to integrate downloaded changesets, see
+    // sync::ClientConfig::integration_worker_threads. Zero integrates on the
+    // event loop thread.
+    size_t integration_worker_threads = 0;
+
+    // The maximum number of messages a connection hands to the socket provider
+    // in a single write, see sync::ClientConfig::max_batched_messages. Only
+    // useful when `multiplex_sessions` is true.
+    size_t max_batched_messages = 1;
+
+    // Offer the permessage-deflate WebSocket extension when connecting with the
+    // default socket provider. Ignored if `socket_provider` is set.
+    bool websocket_permessage_deflate = false;
+
+    // Called on the sync client's event loop thread with a breakdown of the
+    // time spent on each DOWNLOAD and UPLOAD message, see
+    // sync::ClientConfig::session_telemetry_handler.
+    std::function<void(const sync::SessionTelemetry&)> session_telemetry_handler;
 };
 
 namespace app {
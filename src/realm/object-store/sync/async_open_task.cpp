@@ -40,10 +40,26 @@ void AsyncOpenTask::start(AsyncOpenCallback callback)
     if (!m_session)
         return;
     auto session = m_session;
+    // Create the schema of a new file while the Realm is downloaded rather
+    // than after. Any error is reported when the Realm is opened once
+    // downloaded. Existing files may have a schema migration pending, which
+    // is only known once downloaded.
+    if (m_db_first_open) {
+        m_preparation = std::async(std::launch::async, [coordinator = m_coordinator] {
+            try {
+                coordinator->prepare_for_async_open();
+            }
+            catch (...) {
+            }
+        });
+    }
     lock.unlock();
 
     std::shared_ptr<AsyncOpenTask> self(shared_from_this());
     session->wait_for_download_completion([callback = std::move(callback), self, this](Status status) mutable {
+        // The schema must not be created concurrently with a schema migration
+        wait_for_preparation();
+
         std::shared_ptr<_impl::RealmCoordinator> coordinator;
         {
             util::CheckedLockGuard lock(m_mutex);
@@ -64,6 +80,17 @@ void AsyncOpenTask::start(AsyncOpenCallback callback)
     session->revive_if_needed();
 }
 
+void AsyncOpenTask::wait_for_preparation()
+{
+    std::future<void> preparation;
+    {
+        util::CheckedLockGuard lock(m_mutex);
+        preparation = std::move(m_preparation);
+    }
+    if (preparation.valid())
+        preparation.wait();
+}
+
 void AsyncOpenTask::cancel()
 {
     std::shared_ptr<SyncSession> session;
@@ -130,9 +157,13 @@ void AsyncOpenTask::attach_to_subscription_initializer(AsyncOpenCallback&& callb
     const auto sub_state = init_subscription.state();
 
     if ((sub_state != sync::SubscriptionSet::State::Complete) || (m_db_first_open && rerun_on_launch)) {
-        // We need to wait until subscription initializer completes
+        // We need to wait until subscription initializer completes, or only
+        // until its data starts arriving if the caller opted in
+        auto notify_when = sync::SubscriptionSet::State::Complete;
+        if (shared_realm->config().sync_config->async_open_complete_on_first_bootstrap_batch)
+            notify_when = sync::SubscriptionSet::State::Bootstrapping;
         std::shared_ptr<AsyncOpenTask> self(shared_from_this());
-        init_subscription.get_state_change_notification(sync::SubscriptionSet::State::Complete)
+        init_subscription.get_state_change_notification(notify_when)
             .get_async([self, coordinator, callback = std::move(callback)](
                            StatusWith<realm::sync::SubscriptionSet::State> state) mutable {
                 self->async_open_complete(std::move(callback), coordinator, state.get_status());
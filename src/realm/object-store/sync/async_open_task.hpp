@@ -22,6 +22,7 @@
 #include <realm/util/checked_mutex.hpp>
 #include <realm/util/functional.hpp>
 
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -74,10 +75,13 @@ private:
         REQUIRES(!m_mutex);
     void wait_for_bootstrap_or_complete(AsyncOpenCallback&&, std::shared_ptr<_impl::RealmCoordinator>, Status)
         REQUIRES(!m_mutex);
+    void wait_for_preparation() REQUIRES(!m_mutex);
 
     std::shared_ptr<_impl::RealmCoordinator> m_coordinator GUARDED_BY(m_mutex);
     std::shared_ptr<SyncSession> m_session GUARDED_BY(m_mutex);
     std::vector<uint64_t> m_registered_callbacks GUARDED_BY(m_mutex);
+    // Creates the schema of the Realm while it is downloaded
+    std::future<void> m_preparation GUARDED_BY(m_mutex);
     util::CheckedMutex m_mutex;
     const bool m_db_first_open;
 };
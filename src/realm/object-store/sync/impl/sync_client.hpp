@@ -51,8 +51,11 @@ struct SyncClient {
 #else
             auto user_agent = util::format("RealmSync/%1 (%2) %3 %4", REALM_VERSION_STRING, util::get_platform_info(),
                                            config.user_agent_binding_info, config.user_agent_application_info);
-            return std::make_shared<sync::websocket::DefaultSocketProvider>(
-                logger, std::move(user_agent), config.default_socket_provider_thread_observer);
+            using DefaultSocketProvider = sync::websocket::DefaultSocketProvider;
+            return std::make_shared<DefaultSocketProvider>(
+                logger, std::move(user_agent), config.default_socket_provider_thread_observer,
+                DefaultSocketProvider::AutoStart{true},
+                DefaultSocketProvider::PermessageDeflate{config.websocket_permessage_deflate});
 #endif
         }())
         , m_client([&] {
@@ -61,6 +64,9 @@ struct SyncClient {
             c.socket_provider = m_socket_provider;
             c.reconnect_mode = config.reconnect_mode;
             c.one_connection_per_session = !config.multiplex_sessions;
+            c.integration_worker_threads = config.integration_worker_threads;
+            c.max_batched_messages = config.max_batched_messages;
+            c.session_telemetry_handler = config.session_telemetry_handler;
 
             // Only set the timeouts if they have sensible values
             if (config.timeouts.connect_timeout >= 1000)
@@ -906,6 +906,9 @@ void SyncSession::create_sync_session()
     session_config.proxy_config = sync_config.proxy_config;
     session_config.simulate_integration_error = sync_config.simulate_integration_error;
     session_config.flx_bootstrap_batch_size_bytes = sync_config.flx_bootstrap_batch_size_bytes;
+    session_config.flx_streaming_bootstrap = sync_config.flx_streaming_bootstrap;
+    session_config.transform_threads = sync_config.transform_threads;
+    session_config.history_compression_dictionary = sync_config.history_compression_dictionary;
     session_config.session_reason =
         client_reset::is_fresh_path(m_config.path) ? sync::SessionReason::ClientReset : sync::SessionReason::Sync;
     session_config.schema_version = m_config.schema_version;
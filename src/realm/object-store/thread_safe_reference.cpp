@@ -167,6 +167,13 @@ public:
                     "Cannot create a ThreadSafeReference to Results backed by a collection of objects "
                     "inside the write transaction which created the collection.");
             }
+            // If the query has already been evaluated then hand over the
+            // result along with the query, so that it does not have to be
+            // rerun if the target Realm is at the same version.
+            if (!r.get_realm()->is_in_transaction()) {
+                if (auto tv = r.get_evaluated_tableview())
+                    m_table_view = m_transaction->import_copy_of(*tv, PayloadPolicy::Move);
+            }
         }
     }
 
@@ -199,6 +206,12 @@ public:
             }
             return Results(r, std::move(collection), m_ordering);
         }
+        if (m_table_view && !r->is_in_transaction() &&
+            r->read_transaction_version() == m_transaction->get_version_of_current_transaction()) {
+            auto tv = r->import_copy_of(*m_table_view, PayloadPolicy::Move);
+            m_table_view.reset();
+            return Results(std::move(r), std::move(*tv), m_ordering);
+        }
         auto q = r->import_copy_of(*m_query, PayloadPolicy::Stay);
         return Results(std::move(r), std::move(*q), m_ordering);
     }
@@ -208,6 +221,7 @@ private:
     TransactionRef m_transaction;
     DescriptorOrdering m_ordering;
     std::unique_ptr<Query> m_query;
+    std::unique_ptr<TableView> m_table_view;
     ObjKey m_key;
     TableKey m_table_key;
     ColKey m_col_key;
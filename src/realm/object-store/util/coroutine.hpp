@@ -0,0 +1,262 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_OS_UTIL_COROUTINE_HPP
+#define REALM_OS_UTIL_COROUTINE_HPP
+
+#include <realm/db.hpp>
+#include <realm/transaction.hpp>
+#include <realm/util/future.hpp>
+#include <realm/object-store/util/scheduler.hpp>
+
+#if REALM_ENABLE_SYNC
+#include <realm/object-store/sync/sync_session.hpp>
+#endif
+
+// Realm itself is built as C++17, so these are only available to code
+// including this header which is built with coroutine support
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define REALM_HAVE_COROUTINES 1
+#else
+#define REALM_HAVE_COROUTINES 0
+#endif
+
+#if REALM_HAVE_COROUTINES
+#include <coroutine>
+
+namespace realm::util {
+
+// Awaitables suspending a C++20 coroutine until asynchronous work done by
+// Realm completes, as an alternative to chaining callbacks or Futures.
+//
+// The work completes on a thread of Realm's, such as the async commit helper
+// or the sync event loop. If a scheduler is given, the coroutine is resumed
+// on it, and otherwise it is resumed directly on the completing thread, which
+// it must then leave quickly. The write mutex and commit awaitables require a
+// scheduler, as the async commit helper cannot run write transactions. Each
+// awaitable may only be awaited once.
+
+namespace _impl {
+inline void resume_on(const std::shared_ptr<Scheduler>& scheduler, std::coroutine_handle<> handle)
+{
+    if (scheduler)
+        scheduler->invoke([handle] {
+            handle.resume();
+        });
+    else
+        handle.resume();
+}
+} // namespace _impl
+
+// Acquire the write mutex for `tr`, a read transaction of `db`, as
+// DB::async_request_write_mutex(). Once resumed, call tr->promote_to_write()
+// to start writing.
+class WriteMutexAwaitable {
+public:
+    WriteMutexAwaitable(DB& db, TransactionRef& tr, std::shared_ptr<Scheduler> scheduler)
+        : m_db(db)
+        , m_tr(tr)
+        , m_scheduler(std::move(scheduler))
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // Nothing in this object may be used once the request has been made,
+        // as the coroutine may already have been resumed on another thread
+        m_db.async_request_write_mutex(m_tr, [scheduler = std::move(m_scheduler), handle] {
+            _impl::resume_on(scheduler, handle);
+        });
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    DB& m_db;
+    TransactionRef& m_tr;
+    std::shared_ptr<Scheduler> m_scheduler;
+};
+
+inline WriteMutexAwaitable async_write_mutex(DB& db, TransactionRef& tr, std::shared_ptr<Scheduler> scheduler)
+{
+    REALM_ASSERT(scheduler);
+    return WriteMutexAwaitable(db, tr, std::move(scheduler));
+}
+
+// Wait for the commits made with commit_and_continue_as_read(false) while
+// holding a write mutex obtained asynchronously to be synced to disk, as
+// Transaction::async_complete_writes(), which also releases the write mutex.
+// Throws if syncing failed. Does not suspend if there is nothing to sync.
+class CompleteWritesAwaitable {
+public:
+    CompleteWritesAwaitable(Transaction& tr, std::shared_ptr<Scheduler> scheduler)
+        : m_tr(tr)
+        , m_scheduler(std::move(scheduler))
+    {
+    }
+
+    bool await_ready()
+    {
+        if (m_tr.has_unsynced_commits())
+            return false;
+        // Only releases the write mutex, without calling back
+        m_tr.async_complete_writes();
+        return true;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_tr.async_complete_writes([scheduler = std::move(m_scheduler), handle] {
+            _impl::resume_on(scheduler, handle);
+        });
+    }
+
+    void await_resume()
+    {
+        if (auto err = m_tr.get_commit_exception())
+            std::rethrow_exception(err);
+    }
+
+private:
+    Transaction& m_tr;
+    std::shared_ptr<Scheduler> m_scheduler;
+};
+
+inline CompleteWritesAwaitable async_complete_writes(Transaction& tr, std::shared_ptr<Scheduler> scheduler)
+{
+    REALM_ASSERT(scheduler);
+    return CompleteWritesAwaitable(tr, std::move(scheduler));
+}
+
+// Wait for a Future, such as the one returned by
+// SubscriptionSet::get_state_change_notification(), and produce its result as
+// a StatusWith<T> (or a Status for Future<void>).
+template <typename T>
+class FutureAwaitable {
+public:
+    using Result = StatusOrStatusWith<T>;
+
+    FutureAwaitable(Future<T>&& future, std::shared_ptr<Scheduler> scheduler)
+        : m_future(std::move(future))
+        , m_scheduler(std::move(scheduler))
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return m_future.is_ready();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) noexcept
+    {
+        // The callback may be called before get_async() returns, and resume
+        // the coroutine, so the future must not be a member of this object
+        auto future = std::move(m_future);
+        std::move(future).get_async(
+            [this, scheduler = std::move(m_scheduler), handle](Result result) mutable noexcept {
+                m_result.emplace(std::move(result));
+                _impl::resume_on(scheduler, handle);
+            });
+    }
+
+    Result await_resume()
+    {
+        if (m_result)
+            return std::move(*m_result);
+        return std::move(m_future).get_no_throw();
+    }
+
+private:
+    Future<T> m_future;
+    std::shared_ptr<Scheduler> m_scheduler;
+    std::optional<Result> m_result;
+};
+
+template <typename T>
+FutureAwaitable<T> awaitable(Future<T>&& future, std::shared_ptr<Scheduler> scheduler = nullptr)
+{
+    return FutureAwaitable<T>(std::move(future), std::move(scheduler));
+}
+
+#if REALM_ENABLE_SYNC
+// Wait for all the changes made locally before the call to be uploaded, or
+// for all the changes made on the server before the call to be downloaded,
+// as SyncSession::wait_for_upload_completion() and
+// SyncSession::wait_for_download_completion().
+class SyncProgressAwaitable {
+public:
+    enum class Direction { upload, download };
+
+    SyncProgressAwaitable(SyncSession& session, Direction direction, std::shared_ptr<Scheduler> scheduler)
+        : m_session(session)
+        , m_direction(direction)
+        , m_scheduler(std::move(scheduler))
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        auto callback = [this, scheduler = std::move(m_scheduler), handle](Status status) {
+            m_status = std::move(status);
+            _impl::resume_on(scheduler, handle);
+        };
+        if (m_direction == Direction::upload)
+            m_session.wait_for_upload_completion(std::move(callback));
+        else
+            m_session.wait_for_download_completion(std::move(callback));
+    }
+
+    Status await_resume() noexcept
+    {
+        return std::move(m_status);
+    }
+
+private:
+    SyncSession& m_session;
+    Direction m_direction;
+    std::shared_ptr<Scheduler> m_scheduler;
+    Status m_status = Status::OK();
+};
+
+inline SyncProgressAwaitable async_upload_completion(SyncSession& session,
+                                                     std::shared_ptr<Scheduler> scheduler = nullptr)
+{
+    return SyncProgressAwaitable(session, SyncProgressAwaitable::Direction::upload, std::move(scheduler));
+}
+
+inline SyncProgressAwaitable async_download_completion(SyncSession& session,
+                                                       std::shared_ptr<Scheduler> scheduler = nullptr)
+{
+    return SyncProgressAwaitable(session, SyncProgressAwaitable::Direction::download, std::move(scheduler));
+}
+#endif // REALM_ENABLE_SYNC
+
+} // namespace realm::util
+
+#endif // REALM_HAVE_COROUTINES
+#endif // REALM_OS_UTIL_COROUTINE_HPP
@@ -19,11 +19,14 @@
 #include "realm/parser/driver.hpp"
 #include "realm/parser/keypath_mapping.hpp"
 #include "realm/parser/query_parser.hpp"
+#include "realm/parser/query_cache.hpp"
 #include "realm/sort_descriptor.hpp"
 #include "realm/decimal128.hpp"
 #include "realm/uuid.hpp"
+#include "realm/util/alloc_tracking.hpp"
 #include "realm/util/base64.hpp"
 #include "realm/util/overload.hpp"
+#include "realm/util/scope_exit.hpp"
 #include "realm/object-store/class.hpp"
 
 #define YY_NO_UNISTD_H 1
@@ -955,8 +958,13 @@ std::unique_ptr<Subexpr> PropertyNode::visit(ParserDriver* drv, DataType)
     path->resolve_arg(drv);
     if (path->path_elems.back().is_key() && path->path_elems.back().get_key() == "@links") {
         identifier = "@links";
-        // This is a backlink aggregate query
+        // This is a backlink aggregate query. The parse tree may be visited
+        // again (see QueryCache), so put the element back afterwards.
+        auto last = std::move(path->path_elems.back());
         path->path_elems.pop_back();
+        auto restore = util::make_scope_exit([&]() noexcept {
+            path->path_elems.push_back(std::move(last));
+        });
         auto link_chain = path->visit(drv, comp_type);
         auto sub = link_chain.get_backlink_count<Int>();
         return sub.clone();
@@ -972,7 +980,7 @@ std::unique_ptr<Subexpr> PropertyNode::visit(ParserDriver* drv, DataType)
 
     Path indexes;
     while (!path->at_end()) {
-        indexes.emplace_back(std::move(*(path->current_path_elem++)));
+        indexes.push_back(*(path->current_path_elem++));
     }
 
     if (!indexes.empty()) {
@@ -1076,14 +1084,15 @@ std::unique_ptr<Subexpr> SubqueryNode::visit(ParserDriver* drv, DataType)
 
     TableRef previous_table = drv->m_base_table;
     drv->m_base_table = lc.get_current_table().cast_away_const();
-    bool did_add = drv->m_mapping.add_mapping(drv->m_base_table, variable_name, "");
-    if (!did_add) {
+    std::pair<TableKey, std::string> variable{drv->m_base_table->get_key(), variable_name};
+    if (drv->m_mapping.has_mapping(drv->m_base_table, variable_name) ||
+        !drv->m_subquery_variables.insert(variable).second) {
         throw InvalidQueryError(util::format("Unable to create a subquery expression with variable '%1' since an "
                                              "identical variable already exists in this context",
                                              variable_name));
     }
     Query sub = subquery->visit(drv);
-    drv->m_mapping.remove_mapping(drv->m_base_table, variable_name);
+    drv->m_subquery_variables.erase(variable);
     drv->m_base_table = previous_table;
 
     return lc.subquery(sub);
@@ -1796,6 +1805,7 @@ ParserDriver::~ParserDriver()
 PathElement ParserDriver::get_arg_for_index(const std::string& i)
 {
     REALM_ASSERT(i[0] == '$');
+    m_args_in_parse_tree = true;
     size_t arg_no = size_t(strtol(i.substr(1).c_str(), nullptr, 10));
     if (m_args.is_argument_null(arg_no) || m_args.is_argument_list(arg_no)) {
         throw InvalidQueryError("Invalid index parameter");
@@ -1815,6 +1825,7 @@ std::string ParserDriver::get_arg_for_key_path(const std::string& i)
 {
     REALM_ASSERT(i[0] == '$');
     REALM_ASSERT(i[1] == 'K');
+    m_args_in_parse_tree = true;
     size_t arg_no = size_t(strtol(i.substr(2).c_str(), nullptr, 10));
     if (m_args.is_argument_null(arg_no) || m_args.is_argument_list(arg_no)) {
         throw InvalidQueryArgError(util::format("Null or list cannot be used for parameter '%1'", i));
@@ -1830,6 +1841,7 @@ std::string ParserDriver::get_arg_for_key_path(const std::string& i)
 double ParserDriver::get_arg_for_coordinate(const std::string& str)
 {
     REALM_ASSERT(str[0] == '$');
+    m_args_in_parse_tree = true;
     size_t arg_no = size_t(strtol(str.substr(1).c_str(), nullptr, 10));
     if (m_args.is_argument_null(arg_no)) {
         throw InvalidQueryError(util::format("NULL cannot be used in coordinate at argument '%1'", str));
@@ -1896,7 +1908,7 @@ auto ParserDriver::column(LinkChain& link_chain, PathNode* path) -> SubexprPtr
         --path->current_path_elem;
         --path->current_path_elem;
     }
-    auto identifier = m_mapping.translate(link_chain, path->next_identifier());
+    auto identifier = translate(link_chain, path->next_identifier());
     if (auto col = link_chain.column(identifier, !path->at_end())) {
         return col;
     }
@@ -1925,6 +1937,11 @@ void ParserDriver::backlink(LinkChain& link_chain, std::string_view raw_table_na
 
 std::string ParserDriver::translate(const LinkChain& link_chain, const std::string& identifier)
 {
+    // A subquery variable stands for the object itself
+    if (!m_subquery_variables.empty() &&
+        m_subquery_variables.count({link_chain.get_current_table()->get_key(), identifier})) {
+        return "";
+    }
     return m_mapping.translate(link_chain, identifier);
 }
 
@@ -2005,12 +2022,207 @@ Query Table::query(const std::string& query_string, const std::vector<MixedArgum
 Query Table::query(const std::string& query_string, query_parser::Arguments& args,
                    const query_parser::KeyPathMapping& mapping) const
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::query};
     ParserDriver driver(m_own_ref, args, mapping);
     driver.parse(query_string);
     driver.result->canonicalize();
     return driver.result->visit(&driver).set_ordering(driver.ordering->visit(&driver));
 }
 
+namespace query_parser {
+
+struct QueryCache::Entry {
+    ParserDriver::ParserNodeStore nodes;
+    QueryNode* result = nullptr;
+    DescriptorOrderingNode* ordering = nullptr;
+    // Visiting the parse tree updates state in some of its nodes, so only
+    // one thread at a time can build a query from it
+    std::mutex mutex;
+};
+
+QueryCache::QueryCache(size_t max_entries)
+    : m_max_entries(max_entries)
+{
+    REALM_ASSERT(max_entries > 0);
+}
+
+QueryCache::~QueryCache() = default;
+
+Query QueryCache::query(ConstTableRef table, const std::string& query_string, const std::vector<Mixed>& args,
+                        const KeyPathMapping& mapping)
+{
+    MixedArguments arguments(args);
+    return query(table, query_string, arguments, mapping);
+}
+
+Query QueryCache::query(ConstTableRef table, const std::string& query_string, Arguments& args,
+                        const KeyPathMapping& mapping)
+{
+    std::string key = normalize(query_string);
+    key += '\0';
+    for (size_t i = 0; i < args.get_num_args(); ++i) {
+        if (args.is_argument_null(i))
+            key += 'n';
+        else if (args.is_argument_list(i))
+            key += 'l';
+        else
+            key += char('A' + int(args.type_for_argument(i)));
+    }
+
+    ParserDriver driver(table.cast_away_const(), args, mapping);
+    if (auto entry = lookup(key)) {
+        std::lock_guard lock(entry->mutex);
+        return entry->result->visit(&driver).set_ordering(entry->ordering->visit(&driver));
+    }
+
+    driver.parse(query_string);
+    driver.result->canonicalize();
+    Query query = driver.result->visit(&driver).set_ordering(driver.ordering->visit(&driver));
+    if (!driver.m_args_in_parse_tree) {
+        auto entry = std::make_shared<Entry>();
+        entry->nodes = std::move(driver.m_parse_nodes);
+        entry->result = driver.result;
+        entry->ordering = driver.ordering;
+        insert(key, std::move(entry));
+    }
+    return query;
+}
+
+auto QueryCache::lookup(const std::string& key) -> std::shared_ptr<Entry>
+{
+    std::lock_guard lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        ++m_metrics.misses;
+        return nullptr;
+    }
+    ++m_metrics.hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->second;
+}
+
+void QueryCache::insert(const std::string& key, std::shared_ptr<Entry> entry)
+{
+    std::lock_guard lock(m_mutex);
+    // Another thread may have parsed the same query in the meantime
+    if (m_entries.count(key))
+        return;
+    m_lru.emplace_front(key, std::move(entry));
+    m_entries.emplace(key, m_lru.begin());
+    while (m_lru.size() > m_max_entries) {
+        m_entries.erase(m_lru.back().first);
+        m_lru.pop_back();
+        ++m_metrics.evictions;
+    }
+}
+
+auto QueryCache::get_metrics() const -> Metrics
+{
+    std::lock_guard lock(m_mutex);
+    Metrics metrics = m_metrics;
+    metrics.size = m_lru.size();
+    return metrics;
+}
+
+void QueryCache::clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+}
+
+std::string QueryCache::normalize(const std::string& query_string)
+{
+    std::string result;
+    result.reserve(query_string.size());
+    char quote = 0;
+    bool pending_space = false;
+    for (size_t i = 0; i < query_string.size(); ++i) {
+        char c = query_string[i];
+        if (quote) {
+            result += c;
+            if (c == '\\' && i + 1 < query_string.size())
+                result += query_string[++i];
+            else if (c == quote)
+                quote = 0;
+            continue;
+        }
+        if (isspace(static_cast<unsigned char>(c))) {
+            pending_space = !result.empty();
+            continue;
+        }
+        if (pending_space) {
+            result += ' ';
+            pending_space = false;
+        }
+        if (c == '\'' || c == '"')
+            quote = c;
+        result += c;
+    }
+    return result;
+}
+
+struct PreparedQuery::Tree {
+    ParserDriver::ParserNodeStore nodes;
+    QueryNode* result = nullptr;
+    DescriptorOrderingNode* ordering = nullptr;
+    std::mutex mutex;
+};
+
+PreparedQuery::PreparedQuery(ConstTableRef table, std::string query_string, Arguments& args, KeyPathMapping mapping)
+    : m_query_string(std::move(query_string))
+    , m_mapping(std::move(mapping))
+{
+    prepare(table, args);
+}
+
+PreparedQuery::PreparedQuery(ConstTableRef table, std::string query_string, const std::vector<Mixed>& args,
+                             KeyPathMapping mapping)
+    : m_query_string(std::move(query_string))
+    , m_mapping(std::move(mapping))
+{
+    MixedArguments arguments(args);
+    prepare(table, arguments);
+}
+
+void PreparedQuery::prepare(ConstTableRef table, Arguments& args)
+{
+    util::AllocTagScope alloc_tag{util::AllocTag::query};
+    ParserDriver driver(table.cast_away_const(), args, m_mapping);
+    driver.parse(m_query_string);
+    driver.result->canonicalize();
+    // Building the query once validates the property names and the argument
+    // types
+    driver.result->visit(&driver).set_ordering(driver.ordering->visit(&driver));
+    if (!driver.m_args_in_parse_tree) {
+        m_tree = std::make_unique<Tree>();
+        m_tree->nodes = std::move(driver.m_parse_nodes);
+        m_tree->result = driver.result;
+        m_tree->ordering = driver.ordering;
+    }
+}
+
+PreparedQuery::~PreparedQuery() = default;
+
+Query PreparedQuery::bind(ConstTableRef table, const std::vector<Mixed>& args) const
+{
+    MixedArguments arguments(args);
+    return bind(table, arguments);
+}
+
+Query PreparedQuery::bind(ConstTableRef table, Arguments& args) const
+{
+    if (!m_tree)
+        return table->query(m_query_string, args, m_mapping);
+
+    util::AllocTagScope alloc_tag{util::AllocTag::query};
+    ParserDriver driver(table.cast_away_const(), args, m_mapping);
+    std::lock_guard lock(m_tree->mutex);
+    return m_tree->result->visit(&driver).set_ordering(m_tree->ordering->visit(&driver));
+}
+
+} // namespace query_parser
+
 std::unique_ptr<Subexpr> LinkChain::column(const std::string& col, bool has_path)
 {
     auto col_key = m_current_table->get_column_key(col);
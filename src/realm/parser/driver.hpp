@@ -2,6 +2,7 @@
 #define DRIVER_HH
 #include <string>
 #include <map>
+#include <set>
 
 #include "realm/query_expression.hpp"
 #include "realm/parser/keypath_mapping.hpp"
@@ -654,9 +655,15 @@ public:
     DescriptorOrderingNode* ordering = nullptr;
     TableRef m_base_table;
     Arguments& m_args;
-    query_parser::KeyPathMapping m_mapping;
+    // Not copied, as it may be large and is shared by all parses for a schema
+    const query_parser::KeyPathMapping& m_mapping;
+    // The variables of the subqueries being visited, with the table they
+    // refer to
+    std::set<std::pair<TableKey, std::string>> m_subquery_variables;
     ParserNodeStore m_parse_nodes;
     void* m_yyscanner;
+    // Set if argument values were used to build the parse tree itself
+    bool m_args_in_parse_tree = false;
 
     // Run the parser on file F.  Return 0 on success.
     int parse(const std::string& str);
@@ -95,7 +95,7 @@ util::Optional<std::string> KeyPathMapping::get_table_mapping(const std::string&
 
 constexpr static size_t max_substitutions_allowed = 50;
 
-std::string KeyPathMapping::translate_table_name(std::string_view identifier)
+std::string KeyPathMapping::translate_table_name(std::string_view identifier) const
 {
     size_t substitutions = 0;
     std::string alias{identifier};
@@ -115,7 +115,7 @@ std::string KeyPathMapping::translate_table_name(std::string_view identifier)
     return alias;
 }
 
-std::string KeyPathMapping::translate(ConstTableRef table, std::string_view identifier)
+std::string KeyPathMapping::translate(ConstTableRef table, std::string_view identifier) const
 {
     size_t substitutions = 0;
     auto tk = table->get_key();
@@ -132,7 +132,7 @@ std::string KeyPathMapping::translate(ConstTableRef table, std::string_view iden
     return alias;
 }
 
-std::string KeyPathMapping::translate(const LinkChain& link_chain, std::string_view identifier)
+std::string KeyPathMapping::translate(const LinkChain& link_chain, std::string_view identifier) const
 {
     auto table = link_chain.get_current_table();
     return translate(table, std::string{identifier});
@@ -74,9 +74,9 @@ public:
     bool has_table_mapping(const std::string& alias) const;
     util::Optional<std::string> get_table_mapping(const std::string& name) const;
 
-    std::string translate(const LinkChain&, std::string_view identifier);
-    std::string translate(ConstTableRef table, std::string_view identifier);
-    std::string translate_table_name(std::string_view identifier);
+    std::string translate(const LinkChain&, std::string_view identifier) const;
+    std::string translate(ConstTableRef table, std::string_view identifier) const;
+    std::string translate_table_name(std::string_view identifier) const;
 
 protected:
     std::unordered_map<std::pair<TableKey, std::string>, std::string, TableAndColHash> m_mapping;
@@ -0,0 +1,135 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_QUERY_CACHE_HPP
+#define REALM_QUERY_CACHE_HPP
+
+#include <realm/parser/keypath_mapping.hpp>
+#include <realm/parser/query_parser.hpp>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace realm::query_parser {
+
+/// A bounded cache of parsed queries.
+///
+/// Parsing a query string produces a parse tree which is then turned into a
+/// Query for a specific table and set of arguments. The cache keeps the parse
+/// trees of the most recently used query strings, so that building the same
+/// query again with new arguments, or against a table in a new transaction,
+/// skips the parser.
+///
+/// Entries are keyed on the query string with insignificant whitespace
+/// removed, together with the types of the arguments. Queries which use
+/// arguments for key paths, list indexes or coordinates of geospatial shapes
+/// are not cached, since their parse trees depend on the argument values.
+///
+/// All functions are thread safe.
+class QueryCache {
+public:
+    struct Metrics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t size = 0;
+
+        double hit_rate() const noexcept
+        {
+            return hits + misses ? double(hits) / (hits + misses) : 0.0;
+        }
+    };
+
+    explicit QueryCache(size_t max_entries = 256);
+    ~QueryCache();
+
+    /// Equivalent to `table->query(query_string, args, mapping)`
+    Query query(ConstTableRef table, const std::string& query_string, Arguments& args,
+                const KeyPathMapping& mapping = {});
+    Query query(ConstTableRef table, const std::string& query_string, const std::vector<Mixed>& args = {},
+                const KeyPathMapping& mapping = {});
+
+    Metrics get_metrics() const;
+    size_t get_max_entries() const noexcept
+    {
+        return m_max_entries;
+    }
+    void clear();
+
+    /// The query string with whitespace outside of string literals collapsed
+    static std::string normalize(const std::string& query_string);
+
+private:
+    struct Entry;
+    using LruList = std::list<std::pair<std::string, std::shared_ptr<Entry>>>;
+
+    const size_t m_max_entries;
+    mutable std::mutex m_mutex;
+    LruList m_lru; // Most recently used first
+    std::unordered_map<std::string, LruList::iterator> m_entries;
+    Metrics m_metrics;
+
+    std::shared_ptr<Entry> lookup(const std::string& key);
+    void insert(const std::string& key, std::shared_ptr<Entry> entry);
+};
+
+/// A query string which is parsed once and then built into a Query with new
+/// argument values any number of times, like a prepared statement.
+///
+/// The table is given again on each bind, so the same prepared query can be
+/// used with the table in newer transactions. As with QueryCache, a query
+/// whose parse tree depends on argument values is parsed again on each bind.
+///
+/// bind() is thread safe.
+class PreparedQuery {
+public:
+    /// Parse `query_string` and check that it can be built for `table` with
+    /// `args`. Throws the same exceptions as Table::query().
+    PreparedQuery(ConstTableRef table, std::string query_string, Arguments& args, KeyPathMapping mapping = {});
+    PreparedQuery(ConstTableRef table, std::string query_string, const std::vector<Mixed>& args = {},
+                  KeyPathMapping mapping = {});
+    ~PreparedQuery();
+
+    PreparedQuery(const PreparedQuery&) = delete;
+    PreparedQuery& operator=(const PreparedQuery&) = delete;
+
+    /// Equivalent to `table->query(get_query_string(), args, mapping)`
+    Query bind(ConstTableRef table, Arguments& args) const;
+    Query bind(ConstTableRef table, const std::vector<Mixed>& args = {}) const;
+
+    const std::string& get_query_string() const noexcept
+    {
+        return m_query_string;
+    }
+
+private:
+    struct Tree;
+
+    const std::string m_query_string;
+    const KeyPathMapping m_mapping;
+    std::unique_ptr<Tree> m_tree; // Null if the query must be parsed on each bind
+
+    void prepare(ConstTableRef table, Arguments& args);
+};
+
+} // namespace realm::query_parser
+
+#endif // REALM_QUERY_CACHE_HPP
@@ -27,8 +27,12 @@
 #include <realm/query_expression.hpp>
 #include <realm/table_view.hpp>
 #include <realm/set.hpp>
+#include <realm/util/alloc_tracking.hpp>
+#include <realm/util/trace.hpp>
 
 #include <algorithm>
+#include <thread>
+#include <unordered_map>
 
 using namespace realm;
 
@@ -87,6 +91,7 @@ Query::Query(const Query& source)
     , m_groups(source.m_groups)
     , m_table(source.m_table)
     , m_ordering(source.m_ordering)
+    , m_parallelism(source.m_parallelism)
 {
     if (source.m_owned_source_table_view) {
         m_owned_source_table_view = source.m_owned_source_table_view->clone();
@@ -133,6 +138,7 @@ Query& Query::operator=(const Query& source)
             m_view = m_source_collection.get();
         }
         m_ordering = source.m_ordering;
+        m_parallelism = source.m_parallelism;
     }
     return *this;
 }
@@ -158,6 +164,7 @@ Query::Query(const Query* source, Transaction* tr, PayloadPolicy policy)
         REALM_ASSERT_DEBUG(m_view);
     }
     m_groups = source->m_groups;
+    m_parallelism = source->m_parallelism;
     if (source->m_table)
         set_table(tr->import_copy_of(source->m_table));
     // otherwise: empty query.
@@ -191,11 +198,6 @@ void Query::set_table(TableRef tr)
 }
 
 
-void Query::add_expression_node(std::unique_ptr<Expression> expression)
-{
-    add_node(std::unique_ptr<ParentNode>(new ExpressionNode(std::move(expression))));
-}
-
 // Binary
 Query& Query::equal(ColKey column_key, BinaryData b, bool case_sensitive)
 {
@@ -461,8 +463,158 @@ std::unique_ptr<ParentNode> make_size_condition_node(const Table& table, ColKey
     }
 }
 
+// The value to compare a column of type `column_type` with instead of `value`, if one exists which every value of
+// the column compares to in the same way as to `value` when both are compared as Mixed
+util::Optional<Mixed> convert_for_column(Mixed value, DataType column_type)
+{
+    constexpr double int64_bound = 9223372036854775808.0; // 2^63
+    if (value.is_null())
+        return util::none;
+    DataType type = value.get_type();
+    if (type == column_type || column_type == type_Mixed)
+        return value;
+    switch (column_type) {
+        case type_Int:
+            if (type == type_Float || type == type_Double) {
+                double d = type == type_Float ? double(value.get_float()) : value.get_double();
+                if (d >= -int64_bound && d < int64_bound && std::trunc(d) == d)
+                    return Mixed(int64_t(d));
+            }
+            break;
+        case type_Float:
+            if (type == type_Int) {
+                float f = float(value.get_int());
+                if (f >= -int64_bound && f < int64_bound && int64_t(f) == value.get_int())
+                    return Mixed(f);
+            }
+            else if (type == type_Double) {
+                float f = float(value.get_double());
+                if (double(f) == value.get_double())
+                    return Mixed(f);
+            }
+            break;
+        case type_Double:
+            if (type == type_Int) {
+                double d = double(value.get_int());
+                if (d >= -int64_bound && d < int64_bound && int64_t(d) == value.get_int())
+                    return Mixed(d);
+            }
+            else if (type == type_Float && !std::isnan(value.get_float())) {
+                return Mixed(double(value.get_float()));
+            }
+            break;
+        default:
+            break;
+    }
+    return util::none;
+}
+
+// Not all nodes can be made from a Mixed, so pass the value as the type of the column
+template <class Cond>
+std::unique_ptr<ParentNode> make_typed_condition_node(const Table& table, ColKey column_key, Mixed value)
+{
+    switch (DataType(column_key.get_type())) {
+        case type_Int: {
+            // The integer nodes only do strict inequalities, see Query::greater_equal()
+            int64_t v = value.get_int();
+            if constexpr (std::is_same_v<Cond, GreaterEqual>) {
+                if (v == std::numeric_limits<int64_t>::min())
+                    return nullptr;
+                return make_condition_node<Greater>(table, column_key, v - 1);
+            }
+            else if constexpr (std::is_same_v<Cond, LessEqual>) {
+                if (v == std::numeric_limits<int64_t>::max())
+                    return nullptr;
+                return make_condition_node<Less>(table, column_key, v + 1);
+            }
+            else {
+                return make_condition_node<Cond>(table, column_key, v);
+            }
+        }
+        case type_Bool:
+            return make_condition_node<Cond>(table, column_key, value.get_bool());
+        case type_Float:
+            return make_condition_node<Cond>(table, column_key, value.get_float());
+        case type_Double:
+            return make_condition_node<Cond>(table, column_key, value.get_double());
+        case type_String:
+            return make_condition_node<Cond>(table, column_key, value.get_string());
+        case type_Binary:
+            return make_condition_node<Cond>(table, column_key, value.get_binary());
+        case type_Timestamp:
+            return make_condition_node<Cond>(table, column_key, value.get_timestamp());
+        case type_Decimal:
+            return make_condition_node<Cond>(table, column_key, value.get_decimal());
+        case type_ObjectId:
+            return make_condition_node<Cond>(table, column_key, value.get_object_id());
+        case type_UUID:
+            return make_condition_node<Cond>(table, column_key, value.get_uuid());
+        default:
+            return make_condition_node<Cond>(table, column_key, value);
+    }
+}
+
+// A Compare between a property of the table and a constant, in either order, is evaluated by the same node as the
+// corresponding condition added through the Query API. `Reversed` is the condition with the operands swapped.
+template <class Cond, class Reversed>
+std::unique_ptr<ParentNode> make_compare_node(ConstTableRef table, const Expression& expression)
+{
+    auto compare = dynamic_cast<const Compare<Cond>*>(&expression);
+    if (!compare)
+        return nullptr;
+
+    const Subexpr* property = &compare->get_left();
+    const Subexpr* constant = &compare->get_right();
+    bool reversed = !constant->has_single_value();
+    if (reversed)
+        std::swap(property, constant);
+    if (!constant->has_single_value() ||
+        constant->get_comparison_type().value_or(ExpressionComparisonType::Any) != ExpressionComparisonType::Any ||
+        property->get_comparison_type().value_or(ExpressionComparisonType::Any) != ExpressionComparisonType::Any)
+        return nullptr;
+
+    auto prop = dynamic_cast<const ObjPropertyBase*>(property);
+    if (!prop || prop->links_exist() || prop->has_path() || prop->column_key().is_collection() ||
+        property->get_base_table() != table)
+        return nullptr;
+    ColKey col_key = prop->column_key();
+    DataType type = DataType(col_key.get_type());
+    if (type == type_Link || type == type_TypedLink)
+        return nullptr;
+    if (!realm::is_any_v<Cond, Equal, NotEqual> && (type == type_Bool || type == type_Binary))
+        return nullptr;
+
+    auto value = convert_for_column(constant->get_mixed(), type);
+    if (!value)
+        return nullptr;
+    if (reversed)
+        return make_typed_condition_node<Reversed>(*table, col_key, *value);
+    return make_typed_condition_node<Cond>(*table, col_key, *value);
+}
+
+std::unique_ptr<ParentNode> make_expression_node(ConstTableRef table, std::unique_ptr<Expression> expression)
+{
+    std::unique_ptr<ParentNode> node;
+    if ((node = make_compare_node<Equal, Equal>(table, *expression)) ||
+        (node = make_compare_node<NotEqual, NotEqual>(table, *expression)) ||
+        (node = make_compare_node<Greater, Less>(table, *expression)) ||
+        (node = make_compare_node<Less, Greater>(table, *expression)) ||
+        (node = make_compare_node<GreaterEqual, LessEqual>(table, *expression)) ||
+        (node = make_compare_node<LessEqual, GreaterEqual>(table, *expression)))
+        return node;
+    return std::unique_ptr<ParentNode>(new ExpressionNode(std::move(expression)));
+}
+
 } // anonymous namespace
 
+void Query::add_expression_node(std::unique_ptr<Expression> expression)
+{
+    if (m_table)
+        add_node(make_expression_node(m_table, std::move(expression)));
+    else
+        add_node(std::unique_ptr<ParentNode>(new ExpressionNode(std::move(expression))));
+}
+
 template <typename TConditionFunction, class T>
 REALM_FORCEINLINE Query& Query::add_condition(ColKey column_key, T value)
 {
@@ -585,6 +737,12 @@ Query& Query::not_links_to(ColKey origin_column_key, const std::vector<ObjKey>&
     return *this;
 }
 
+Query& Query::key_range(ObjKey begin, ObjKey end)
+{
+    add_node(std::unique_ptr<ParentNode>(new KeyRangeNode(begin, end)));
+    return *this;
+}
+
 // int64 constant vs column
 Query& Query::equal(ColKey column_key, int64_t value)
 {
@@ -736,6 +894,14 @@ Query& Query::less(ColKey column_key, Timestamp value)
 {
     return add_condition<Less>(column_key, value);
 }
+Query& Query::between(ColKey column_key, Timestamp from, Timestamp to)
+{
+    group();
+    greater_equal(column_key, from);
+    less_equal(column_key, to);
+    end_group();
+    return *this;
+}
 
 // ------------- ObjectId
 Query& Query::greater(ColKey column_key, ObjectId value)
@@ -1084,6 +1250,20 @@ Query& Query::less_equal(ColKey column_key, StringData value)
 
 // Aggregates =================================================================================
 
+bool Query::follows_links() const
+{
+    ParentNode* root = root_node();
+    return root && root->follows_links();
+}
+
+bool Query::get_condition_columns(std::vector<ColKey>& columns) const
+{
+    if (m_view)
+        return false;
+    ParentNode* root = has_conditions() ? root_node() : nullptr;
+    return !root || root->get_condition_columns(columns);
+}
+
 bool Query::eval_object(const Obj& obj) const
 {
     if (has_conditions())
@@ -1141,7 +1321,9 @@ void Query::aggregate(QueryStateBase& st, ColKey column_key) const
                     return IteratorControl::AdvanceToNext;
                 };
 
-                m_table.unchecked_ptr()->traverse_clusters(f);
+                auto columns = get_scan_columns();
+                columns.push_back(column_key);
+                m_table.unchecked_ptr()->traverse_clusters(f, columns);
             }
         }
         else {
@@ -1156,6 +1338,15 @@ void Query::aggregate(QueryStateBase& st, ColKey column_key) const
     }
 }
 
+std::vector<ColKey> Query::get_scan_columns() const
+{
+    // If the columns of some of the conditions are unknown, the others are still worth prefetching
+    std::vector<ColKey> columns;
+    if (auto root = root_node())
+        root->get_condition_columns(columns);
+    return columns;
+}
+
 size_t Query::find_best_node(ParentNode* pn) const
 {
     auto score_compare = [](const ParentNode* a, const ParentNode* b) {
@@ -1190,14 +1381,28 @@ void Query::aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start,
     // statistics.
     constexpr size_t probe_matches = 4;
 
+    // Only the top level conditions are profiled
+    QueryExplanation* explanation = m_explanation && pn == root_node() ? m_explanation : nullptr;
+    auto record = [&](size_t node, size_t rows, size_t matches) {
+        if (REALM_UNLIKELY(explanation) && node < explanation->nodes.size()) {
+            explanation->nodes[node].rows_visited += rows;
+            explanation->nodes[node].matches += matches;
+        }
+    };
+
     while (start < end) {
         // Executes start...end range of a query and will stay inside the condition loop of the node it was called
         // on. Can be called on any node; yields same result, but different performance. Returns prematurely if
         // condition of called node has evaluated to true local_matches number of times.
         // Return value is the next row for resuming aggregating (next row that caller must call aggregate_local on)
         size_t best = find_best_node(pn);
+        size_t prev_start = start;
+        size_t prev_matches = st->match_count();
         start = pn->m_children[best]->aggregate_local(st, start, end, findlocals, source_column);
         double current_cost = pn->m_children[best]->cost();
+        if (REALM_UNLIKELY(explanation) && best < explanation->nodes.size())
+            explanation->nodes[best].times_chosen++;
+        record(best, start - prev_start, st->match_count() - prev_matches);
 
         // Make remaining conditions compute their m_dD (statistics)
         for (size_t c = 0; c < pn->m_children.size() && start < end; c++) {
@@ -1210,7 +1415,10 @@ void Query::aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start,
                 // Limit to bestdist in order not to skip too large parts of index nodes
                 size_t maxD = pn->m_children[c]->m_dT == 0.0 ? end - start : bestdist;
                 size_t td = pn->m_children[c]->m_dT == 0.0 ? end : (start + maxD > end ? end : start + maxD);
+                prev_start = start;
+                prev_matches = st->match_count();
                 start = pn->m_children[c]->aggregate_local(st, start, td, probe_matches, source_column);
+                record(c, start - prev_start, st->match_count() - prev_matches);
             }
         }
     }
@@ -1238,6 +1446,506 @@ std::optional<Mixed> Query::max(ColKey col_key, ObjKey* return_ndx) const
     return AggregateHelper<Query>::max(*m_table, *this, col_key, return_ndx);
 }
 
+namespace {
+
+// The value of one aggregate for each of the groups of a group_by()
+class GroupAggregator {
+public:
+    virtual ~GroupAggregator() = default;
+    virtual void add_group() = 0;
+    virtual void accumulate(size_t group, Mixed value) = 0;
+    virtual Mixed result(size_t group) const = 0;
+};
+
+template <class Operator>
+class TypedGroupAggregator final : public GroupAggregator {
+public:
+    void add_group() override
+    {
+        m_states.emplace_back();
+    }
+    void accumulate(size_t group, Mixed value) override
+    {
+        if (!value.is_null())
+            m_states[group].accumulate(value);
+    }
+    Mixed result(size_t group) const override
+    {
+        auto& state = m_states[group];
+        return state.is_null() ? Mixed() : Mixed(state.result());
+    }
+
+private:
+    std::vector<Operator> m_states;
+};
+
+// Returns null if the aggregate is not supported on the column type
+template <template <class> class Operator, bool is_minmax>
+std::unique_ptr<GroupAggregator> make_group_aggregator(ColumnType type)
+{
+    switch (type) {
+        case col_type_Int:
+            return std::make_unique<TypedGroupAggregator<Operator<int64_t>>>();
+        case col_type_Float:
+            return std::make_unique<TypedGroupAggregator<Operator<float>>>();
+        case col_type_Double:
+            return std::make_unique<TypedGroupAggregator<Operator<double>>>();
+        case col_type_Decimal:
+            return std::make_unique<TypedGroupAggregator<Operator<Decimal128>>>();
+        case col_type_Mixed:
+            return std::make_unique<TypedGroupAggregator<Operator<Mixed>>>();
+        case col_type_Timestamp:
+            if constexpr (is_minmax)
+                return std::make_unique<TypedGroupAggregator<Operator<Timestamp>>>();
+            break;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+// Values which compare equal must hash the same. That holds within a column of any of the types which can be
+// grouped by, except for the two zeros of floats and doubles.
+struct GroupKeyHash {
+    size_t operator()(Mixed key) const noexcept
+    {
+        if (key.is_null())
+            return 0;
+        switch (key.get_type()) {
+            case type_Link:
+                return size_t(key.get<ObjKey>().value);
+            case type_Float:
+                return key.get_float() == 0 ? 0 : key.hash();
+            case type_Double:
+                return key.get_double() == 0 ? 0 : key.hash();
+            default:
+                return key.hash();
+        }
+    }
+};
+
+struct GroupKeyEqual {
+    bool operator()(Mixed a, Mixed b) const noexcept
+    {
+        return a.compare(b) == 0;
+    }
+};
+
+class QueryStateGroupBy : public QueryStateBase {
+public:
+    QueryStateGroupBy(const Table& table, ColKey group_col, const std::vector<GroupByAggregate>& aggregates)
+        : m_alloc(table.get_alloc())
+        , m_group_col(group_col)
+    {
+        table.check_column(group_col);
+        auto group_type = group_col.get_type();
+        if (group_col.is_collection() || group_type == col_type_Mixed || group_type == col_type_Decimal) {
+            throw IllegalOperation(util::format("Cannot group by '%1'", table.get_column_name(group_col)));
+        }
+        for (auto& aggregate : aggregates) {
+            table.check_column(aggregate.column);
+            std::unique_ptr<GroupAggregator> aggregator;
+            const char* name = "";
+            auto type = aggregate.column.get_type();
+            switch (aggregate.type) {
+                case GroupByAggregate::Type::Sum:
+                    aggregator = make_group_aggregator<aggregate_operations::Sum, false>(type);
+                    name = "sum";
+                    break;
+                case GroupByAggregate::Type::Min:
+                    aggregator = make_group_aggregator<aggregate_operations::Minimum, true>(type);
+                    name = "min";
+                    break;
+                case GroupByAggregate::Type::Max:
+                    aggregator = make_group_aggregator<aggregate_operations::Maximum, true>(type);
+                    name = "max";
+                    break;
+                case GroupByAggregate::Type::Average:
+                    aggregator = make_group_aggregator<aggregate_operations::Average, false>(type);
+                    name = "average";
+                    break;
+            }
+            if (aggregate.column.is_collection())
+                aggregator.reset();
+            if (!aggregator) {
+                throw IllegalOperation(util::format("Operation '%1' not supported for property '%2'", name,
+                                                    table.get_column_name(aggregate.column)));
+            }
+            m_aggregators.push_back(std::move(aggregator));
+            m_columns.push_back(aggregate.column);
+        }
+    }
+
+    // Read the values of the matches from the leaves of `cluster`
+    void set_cluster(const Cluster* cluster)
+    {
+        if (!m_group_leaf) {
+            m_group_leaf = TwoColumnsNodeBase::update_cached_leaf_pointers_for_column(m_alloc, m_group_col);
+            for (auto col : m_columns)
+                m_leaves.push_back(TwoColumnsNodeBase::update_cached_leaf_pointers_for_column(m_alloc, col));
+        }
+        cluster->init_leaf(m_group_col, m_group_leaf.get());
+        for (size_t i = 0; i < m_columns.size(); ++i)
+            cluster->init_leaf(m_columns[i], m_leaves[i].get());
+
+        // The strings of an enumerated column are the same for all leaves, so each one only needs to be looked up
+        // once
+        m_enum_leaf = nullptr;
+        if (m_group_col.get_type() == col_type_String) {
+            auto leaf = static_cast<ArrayString*>(m_group_leaf.get());
+            if (leaf->is_enumerated())
+                m_enum_leaf = leaf;
+        }
+    }
+
+    // Add an object found through a restricting view or a search index
+    void add_object(const Obj& obj)
+    {
+        size_t group = find_group(obj.get_any(m_group_col));
+        for (size_t i = 0; i < m_columns.size(); ++i)
+            m_aggregators[i]->accumulate(group, obj.get_any(m_columns[i]));
+        ++m_match_count;
+    }
+
+    bool match(size_t index, Mixed) noexcept final
+    {
+        add_row(index);
+        return true;
+    }
+    bool match(size_t index) noexcept final
+    {
+        add_row(index);
+        return true;
+    }
+
+    GroupByResult get_result() const
+    {
+        GroupByResult result;
+        result.groups.resize(m_keys.size());
+        for (size_t group = 0; group < m_keys.size(); ++group) {
+            auto& out = result.groups[group];
+            out.key = m_keys[group];
+            out.count = m_counts[group];
+            out.values.reserve(m_aggregators.size());
+            for (auto& aggregator : m_aggregators)
+                out.values.push_back(aggregator->result(group));
+        }
+        return result;
+    }
+
+private:
+    Allocator& m_alloc;
+    ColKey m_group_col;
+    std::vector<ColKey> m_columns;
+    std::vector<std::unique_ptr<GroupAggregator>> m_aggregators;
+
+    std::unique_ptr<ArrayPayload> m_group_leaf;
+    std::vector<std::unique_ptr<ArrayPayload>> m_leaves;
+    ArrayString* m_enum_leaf = nullptr;
+    // The group of each string of an enumerated column, or npos if it has not been seen yet
+    std::vector<size_t> m_enum_groups;
+
+    std::unordered_map<Mixed, size_t, GroupKeyHash, GroupKeyEqual> m_groups;
+    std::vector<Mixed> m_keys;
+    std::vector<size_t> m_counts;
+
+    size_t find_group(Mixed key)
+    {
+        auto [it, inserted] = m_groups.emplace(key, m_keys.size());
+        if (inserted) {
+            m_keys.push_back(key);
+            m_counts.push_back(0);
+            for (auto& aggregator : m_aggregators)
+                aggregator->add_group();
+        }
+        ++m_counts[it->second];
+        return it->second;
+    }
+
+    void add_row(size_t index)
+    {
+        size_t group;
+        if (m_enum_leaf) {
+            size_t enum_ndx = m_enum_leaf->get_enum_index(index);
+            if (enum_ndx >= m_enum_groups.size())
+                m_enum_groups.resize(enum_ndx + 1, npos);
+            if (m_enum_groups[enum_ndx] == npos) {
+                m_enum_groups[enum_ndx] = group = find_group(m_enum_leaf->get(index));
+            }
+            else {
+                group = m_enum_groups[enum_ndx];
+                ++m_counts[group];
+            }
+        }
+        else {
+            group = find_group(m_group_leaf->get_any(index));
+        }
+        for (size_t i = 0; i < m_columns.size(); ++i)
+            m_aggregators[i]->accumulate(group, m_leaves[i]->get_any(index));
+        ++m_match_count;
+    }
+};
+
+// Adds the matching objects to an ExternalSortCursor. match() cannot throw, so an error writing a run stops the
+// search and is rethrown afterwards.
+class QueryStateExternalSort : public QueryStateBase {
+public:
+    QueryStateExternalSort(ExternalSortCursor& cursor)
+        : m_cursor(cursor)
+    {
+    }
+
+    bool match(size_t index, Mixed) noexcept override
+    {
+        return match(index);
+    }
+
+    bool match(size_t index) noexcept override
+    {
+        if (m_error)
+            return false;
+        ++m_match_count;
+        int64_t key_value = (m_key_values ? m_key_values->get(index) : index) + m_key_offset;
+        try {
+            m_cursor.add(ObjKey(key_value)); // Throws
+        }
+        catch (...) {
+            m_error = std::current_exception();
+            return false;
+        }
+        return true;
+    }
+
+    void rethrow_error() const
+    {
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+
+private:
+    ExternalSortCursor& m_cursor;
+    std::exception_ptr m_error;
+};
+
+// Looks up the objects matching the probing side of a join in the hash table of the building side. The matches
+// are looked up in chunks, so that their values are read through one set of leaf accessors per cluster. match()
+// cannot throw, so an error stops the search and is rethrown afterwards.
+class QueryStateJoin : public QueryStateBase {
+public:
+    using Callback = util::FunctionRef<IteratorControl(ObjKey, ObjKey)>;
+
+    QueryStateJoin(const Table& table, ColKey column, std::vector<ObjKey>&& build_keys,
+                   const std::vector<Mixed>& build_values, bool probing_this, Callback func)
+        : m_table(table)
+        , m_column(column)
+        , m_build_keys(std::move(build_keys))
+        , m_next(m_build_keys.size(), npos)
+        , m_probing_this(probing_this)
+        , m_func(func)
+    {
+        // Chain the objects with equal values in the order they were found
+        for (size_t i = m_build_keys.size(); i-- > 0;) {
+            if (build_values[i].is_null())
+                continue;
+            auto [it, inserted] = m_heads.emplace(build_values[i], i);
+            if (!inserted) {
+                m_next[i] = it->second;
+                it->second = i;
+            }
+        }
+        m_pending.reserve(s_chunk_size);
+    }
+
+    bool match(size_t index, Mixed) noexcept override
+    {
+        return match(index);
+    }
+
+    bool match(size_t index) noexcept override
+    {
+        int64_t key_value = (m_key_values ? m_key_values->get(index) : index) + m_key_offset;
+        m_pending.push_back(ObjKey(key_value));
+        ++m_match_count;
+        if (m_pending.size() == s_chunk_size)
+            flush();
+        return !m_stop;
+    }
+
+    // Look up the remaining matches, and rethrow any error
+    void finish()
+    {
+        flush();
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+
+    bool is_empty() const noexcept
+    {
+        return m_heads.empty();
+    }
+
+private:
+    static constexpr size_t s_chunk_size = 1024;
+
+    const Table& m_table;
+    ColKey m_column;
+    std::vector<ObjKey> m_build_keys;
+    // The first building object with each value, and the next one with the same value as each of them
+    std::unordered_map<Mixed, size_t, GroupKeyHash, GroupKeyEqual> m_heads;
+    std::vector<size_t> m_next;
+    bool m_probing_this;
+    Callback m_func;
+
+    std::vector<ObjKey> m_pending;
+    bool m_stop = false;
+    std::exception_ptr m_error;
+
+    void flush() noexcept
+    {
+        if (m_stop || m_pending.empty())
+            return;
+        try {
+            auto values = m_table.get_values(m_pending, {m_column}); // Throws
+            for (size_t i = 0; i < m_pending.size() && !m_stop; ++i) {
+                if (values[i].is_null())
+                    continue;
+                auto it = m_heads.find(values[i]);
+                if (it == m_heads.end())
+                    continue;
+                for (size_t j = it->second; j != npos && !m_stop; j = m_next[j]) {
+                    auto control = m_probing_this ? m_func(m_pending[i], m_build_keys[j])
+                                                  : m_func(m_build_keys[j], m_pending[i]); // Throws
+                    m_stop = control == IteratorControl::Stop;
+                }
+            }
+        }
+        catch (...) {
+            m_error = std::current_exception();
+            m_stop = true;
+        }
+        m_pending.clear();
+    }
+};
+
+} // anonymous namespace
+
+ExternalSortCursor Query::find_all_external(const SortDescriptor& sort, ExternalSortOptions options) const
+{
+    REALM_ASSERT(m_table);
+    if (m_parallelism > 1) {
+        // A parallel search collects all the matches in memory before passing them on
+        Query serial(*this);
+        serial.set_parallelism(1);
+        return serial.find_all_external(sort, std::move(options));
+    }
+
+    ExternalSortCursor cursor(m_table, sort, std::move(options));
+    QueryStateExternalSort st(cursor);
+    do_find_all(st);
+    st.rethrow_error();
+    return cursor;
+}
+
+GroupByResult Query::group_by(ColKey group_col, const std::vector<GroupByAggregate>& aggregates) const
+{
+    if (!m_table)
+        return {};
+    QueryStateGroupBy st(*m_table, group_col, aggregates);
+
+    if (!has_conditions() && !m_view) {
+        m_table->traverse_clusters([&](const Cluster* cluster) {
+            st.set_cluster(cluster);
+            size_t sz = cluster->node_size();
+            for (size_t i = 0; i < sz; i++)
+                st.match(i);
+            return IteratorControl::AdvanceToNext;
+        });
+        return st.get_result();
+    }
+
+    init();
+    if (m_view) {
+        m_view->for_each([&](const Obj& obj) {
+            if (eval_object(obj))
+                st.add_object(obj);
+            return IteratorControl::AdvanceToNext;
+        });
+        return st.get_result();
+    }
+
+    auto pn = root_node();
+    auto best = find_best_node(pn);
+    if (auto keys = pn->m_children[best]->index_based_keys()) {
+        // All the objects found through the index match the condition of that node
+        pn->m_children[best] = pn->m_children.back();
+        pn->m_children.pop_back();
+        const size_t num_keys = keys->size();
+        for (size_t i = 0; i < num_keys; ++i) {
+            auto obj = m_table->get_object(keys->get(i));
+            if (pn->m_children.empty() || eval_object(obj))
+                st.add_object(obj);
+        }
+    }
+    else {
+        m_table->traverse_clusters([&](const Cluster* cluster) {
+            pn->set_cluster(cluster);
+            st.set_cluster(cluster);
+            aggregate_internal(pn, &st, 0, cluster->node_size(), nullptr);
+            return IteratorControl::AdvanceToNext;
+        });
+    }
+    return st.get_result();
+}
+
+void Query::join(ColKey column, const Query& other, ColKey other_column,
+                 util::FunctionRef<IteratorControl(ObjKey, ObjKey)> func) const
+{
+    if (!m_table || !other.m_table)
+        return;
+    m_table->check_column(column);
+    other.m_table->check_column(other_column);
+    for (auto [table, col] : {std::make_pair(m_table, column), std::make_pair(other.m_table, other_column)}) {
+        auto type = col.get_type();
+        if (col.is_collection() || type == col_type_Mixed || type == col_type_Decimal) {
+            throw IllegalOperation(util::format("Cannot join on '%1'", table->get_column_name(col)));
+        }
+    }
+    if (column.get_type() != other_column.get_type() ||
+        (column.get_type() == col_type_Link &&
+         m_table->get_link_target(column) != other.m_table->get_link_target(other_column))) {
+        throw IllegalOperation(util::format("Cannot join '%1' and '%2', which hold different types of values",
+                                            m_table->get_column_name(column),
+                                            other.m_table->get_column_name(other_column)));
+    }
+
+    bool build_this = m_table->size() <= other.m_table->size();
+    const Query& build = build_this ? *this : other;
+    const Query& probe = build_this ? other : *this;
+    ColKey build_column = build_this ? column : other_column;
+    ColKey probe_column = build_this ? other_column : column;
+
+    std::vector<ObjKey> build_keys;
+    QueryStateFindAll<std::vector<ObjKey>> build_st(build_keys);
+    build.do_find_all(build_st);
+    auto build_values = build.m_table->get_values(build_keys, {build_column});
+
+    QueryStateJoin st(*probe.m_table, probe_column, std::move(build_keys), build_values, !build_this, func);
+    if (st.is_empty())
+        return;
+    probe.do_find_all(st);
+    st.finish();
+}
+
+std::vector<std::pair<ObjKey, ObjKey>> Query::join(ColKey column, const Query& other, ColKey other_column) const
+{
+    std::vector<std::pair<ObjKey, ObjKey>> pairs;
+    join(column, other, other_column, [&](ObjKey key, ObjKey other_key) {
+        pairs.emplace_back(key, other_key);
+        return IteratorControl::AdvanceToNext;
+    });
+    return pairs;
+}
+
 // Grouping
 Query& Query::group()
 {
@@ -1305,6 +2013,7 @@ Query& Query::Or()
 
 ObjKey Query::find() const
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::query};
     ObjKey ret;
 
     if (!m_table)
@@ -1368,7 +2077,7 @@ ObjKey Query::find() const
                 return IteratorControl::AdvanceToNext;
             };
 
-            m_table->traverse_clusters(f);
+            m_table->traverse_clusters(f, get_scan_columns());
             ret = key;
         }
     }
@@ -1465,17 +2174,39 @@ void Query::do_find_all(QueryStateBase& st) const
                 // no index on best node (and likely no index at all), descend B+-tree
                 node = pn;
 
-                auto f = [&node, &st, this](const Cluster* cluster) {
-                    size_t e = cluster->node_size();
-                    node->set_cluster(cluster);
-                    st.m_key_offset = cluster->get_offset();
-                    st.m_key_values = cluster->get_key_array();
-                    aggregate_internal(node, &st, 0, e, nullptr);
-                    // Stop if limit is reached
-                    return st.match_count() == st.limit() ? IteratorControl::Stop : IteratorControl::AdvanceToNext;
-                };
-
-                m_table->traverse_clusters(f);
+                size_t num_leaves;
+                if (size_t ranges = parallel_ranges(st.limit(), num_leaves)) {
+                    std::vector<std::vector<ObjKey>> keys(ranges);
+                    std::vector<QueryStateFindAll<std::vector<ObjKey>>> range_states;
+                    range_states.reserve(ranges);
+                    std::vector<QueryStateBase*> states;
+                    for (auto& k : keys)
+                        states.push_back(&range_states.emplace_back(k));
+                    find_parallel(states, num_leaves);
+
+                    // The ranges are in table order, so appending them gives the same result as a serial run
+                    st.m_key_values = nullptr;
+                    for (auto& range : keys) {
+                        for (auto key : range) {
+                            st.m_key_offset = key.value;
+                            st.match(0, Mixed());
+                        }
+                    }
+                }
+                else {
+                    auto f = [&node, &st, this](const Cluster* cluster) {
+                        size_t e = cluster->node_size();
+                        node->set_cluster(cluster);
+                        st.m_key_offset = cluster->get_offset();
+                        st.m_key_values = cluster->get_key_array();
+                        aggregate_internal(node, &st, 0, e, nullptr);
+                        // Stop if limit is reached
+                        return st.match_count() == st.limit() ? IteratorControl::Stop
+                                                              : IteratorControl::AdvanceToNext;
+                    };
+
+                    m_table->traverse_clusters(f, get_scan_columns());
+                }
             }
         }
     }
@@ -1490,6 +2221,8 @@ void Query::do_find_all(QueryStateBase& st) const
 
 TableView Query::find_all(size_t limit) const
 {
+    REALM_TRACE_SCOPE("Query::find_all");
+    util::AllocTagScope alloc_tag{util::AllocTag::query};
     TableView ret(*this, limit);
     if (m_ordering) {
         // apply_descriptor_ordering will call do_sync
@@ -1501,6 +2234,113 @@ TableView Query::find_all(size_t limit) const
     return ret;
 }
 
+bool Query::resume_find_all(std::vector<ObjKey>& keys, size_t limit, ObjKey& next_key, size_t& next_ndx) const
+{
+    QueryStateFindAll<std::vector<ObjKey>> st(keys, limit);
+    init();
+
+    if (m_view) {
+        size_t sz = m_view->size();
+        for (; next_ndx < sz && st.match_count() < st.limit(); ++next_ndx) {
+            const Obj obj = m_view->get_object(next_ndx);
+            if (eval_object(obj)) {
+                st.m_key_offset = obj.get_key().value;
+                st.match(0, Mixed());
+            }
+        }
+        return next_ndx == sz;
+    }
+
+    ParentNode* node = nullptr;
+    if (has_conditions()) {
+        auto pn = root_node();
+        auto best = find_best_node(pn);
+        if (auto index_keys = pn->m_children[best]->index_based_keys()) {
+            // As in do_find_all(), the indexed condition is satisfied by every key it produces. The position is
+            // then the index into the list of keys, which is stable as long as the data is not modified.
+            pn->m_children[best] = pn->m_children.back();
+            pn->m_children.pop_back();
+
+            size_t num_keys = index_keys->size();
+            for (; next_ndx < num_keys && st.match_count() < st.limit(); ++next_ndx) {
+                ObjKey key = index_keys->get(next_ndx);
+                if (pn->m_children.empty() || eval_object(m_table->get_object(key))) {
+                    st.m_key_offset = key.value;
+                    st.match(0, Mixed());
+                }
+            }
+            return next_ndx == num_keys;
+        }
+        node = pn;
+    }
+
+    // Descend the cluster tree from the leaf holding `next_key`, or the first leaf after it if that object is gone
+    const ClusterTree& tree = m_table->m_clusters;
+    Cluster leaf(0, m_table->get_alloc(), tree);
+    ClusterNode::IteratorState state(leaf);
+    while (tree.get_leaf(next_key, state)) {
+        size_t begin = state.m_current_index;
+        size_t end = leaf.node_size();
+        st.m_key_offset = leaf.get_offset();
+        st.m_key_values = leaf.get_key_array();
+        if (node) {
+            node->set_cluster(&leaf);
+            aggregate_internal(node, &st, begin, end, nullptr);
+        }
+        else {
+            for (size_t i = begin; i < end; i++) {
+                if (!st.match(i, Mixed()))
+                    break;
+            }
+        }
+        if (st.match_count() == st.limit()) {
+            // The last match is the last object evaluated
+            next_key = ObjKey(keys.back().value + 1);
+            return false;
+        }
+        next_key = ObjKey(leaf.get_real_key(end - 1).value + 1);
+    }
+    return true;
+}
+
+QueryCursor::QueryCursor(const Query& query)
+    : m_query(query)
+{
+    reset();
+}
+
+size_t QueryCursor::next(std::vector<ObjKey>& keys, size_t max_count)
+{
+    if (m_at_end || max_count == 0)
+        return 0;
+    if (is_stale())
+        throw StaleAccessor("Stale query cursor");
+
+    size_t old_size = keys.size();
+    m_at_end = m_query.resume_find_all(keys, max_count, m_next_key, m_next_ndx);
+    size_t count = keys.size() - old_size;
+    m_position += count;
+    return count;
+}
+
+bool QueryCursor::is_stale() const
+{
+    TableVersions versions;
+    m_query.get_outside_versions(versions);
+    return !(versions == m_versions);
+}
+
+void QueryCursor::reset()
+{
+    m_versions.clear();
+    if (m_query.m_table)
+        m_query.get_outside_versions(m_versions);
+    m_next_key = ObjKey(0);
+    m_next_ndx = 0;
+    m_position = 0;
+    m_at_end = !m_query.m_table;
+}
+
 
 size_t Query::do_count(size_t limit) const
 {
@@ -1517,6 +2357,8 @@ size_t Query::do_count(size_t limit) const
 
     if (!has_conditions()) {
         // User created query with no criteria; count all
+        if (m_explanation)
+            m_explanation->strategy = "all objects";
         size_t cnt_all;
         if (m_view) {
             cnt_all = std::min(m_view->size(), limit);
@@ -1541,7 +2383,13 @@ size_t Query::do_count(size_t limit) const
 
     init();
 
+    std::vector<ParentNode*> explained_nodes;
+    if (m_explanation)
+        explained_nodes = explain_nodes();
+
     if (m_view) {
+        if (m_explanation)
+            m_explanation->strategy = "view";
         m_view->for_each([&](const Obj& obj) {
             if (eval_object(obj)) {
                 cnt++;
@@ -1554,6 +2402,13 @@ size_t Query::do_count(size_t limit) const
         auto best = find_best_node(pn);
         auto node = pn->m_children[best];
         if (auto keys = node->index_based_keys()) {
+            if (m_explanation) {
+                m_explanation->strategy = "index";
+                if (best < m_explanation->nodes.size()) {
+                    m_explanation->nodes[best].times_chosen = 1;
+                    m_explanation->nodes[best].rows_visited = keys->size();
+                }
+            }
             if (pn->m_children.size() > 1) {
                 // The node having the search index can be removed from the query as we know that
                 // all the objects will match this condition
@@ -1580,22 +2435,41 @@ size_t Query::do_count(size_t limit) const
             node = pn;
             QueryStateCount st(limit);
 
-            auto f = [&node, &st, this](const Cluster* cluster) {
-                size_t e = cluster->node_size();
-                node->set_cluster(cluster);
-                st.m_key_offset = cluster->get_offset();
-                st.m_key_values = cluster->get_key_array();
-                aggregate_internal(node, &st, 0, e, nullptr);
-                // Stop if limit or end is reached
-                return st.match_count() == st.limit() ? IteratorControl::Stop : IteratorControl::AdvanceToNext;
-            };
+            size_t num_leaves;
+            if (size_t ranges = parallel_ranges(limit, num_leaves)) {
+                std::vector<QueryStateCount> range_states(ranges);
+                std::vector<QueryStateBase*> states;
+                for (auto& s : range_states)
+                    states.push_back(&s);
+                find_parallel(states, num_leaves);
+                for (auto& s : range_states)
+                    cnt += s.get_count();
+            }
+            else {
+                if (m_explanation)
+                    m_explanation->strategy = "cluster scan";
+                auto f = [&node, &st, this](const Cluster* cluster) {
+                    size_t e = cluster->node_size();
+                    node->set_cluster(cluster);
+                    st.m_key_offset = cluster->get_offset();
+                    st.m_key_values = cluster->get_key_array();
+                    if (m_explanation)
+                        m_explanation->clusters++;
+                    aggregate_internal(node, &st, 0, e, nullptr);
+                    // Stop if limit or end is reached
+                    return st.match_count() == st.limit() ? IteratorControl::Stop : IteratorControl::AdvanceToNext;
+                };
 
-            m_table->traverse_clusters(f);
+                m_table->traverse_clusters(f, get_scan_columns());
 
-            cnt = st.get_count();
+                cnt = st.get_count();
+            }
         }
     }
 
+    for (size_t i = 0; i < explained_nodes.size(); ++i)
+        m_explanation->nodes[i].final_cost = explained_nodes[i]->cost();
+
     if (do_log) {
         auto t2 = std::chrono::steady_clock::now();
         logger->log(util::LogCategory::query, util::Logger::Level::debug, "Query matches: %1, Duration: %2 us", cnt,
@@ -1605,8 +2479,70 @@ size_t Query::do_count(size_t limit) const
     return cnt;
 }
 
+size_t Query::parallel_ranges(size_t limit, size_t& num_leaves) const
+{
+    // Only frozen tables may be read from several threads at once
+    if (m_parallelism < 2 || limit != size_t(-1) || m_view || m_explanation || !m_table->is_frozen())
+        return 0;
+
+    num_leaves = 0;
+    m_table->traverse_clusters([&num_leaves](const Cluster*) {
+        ++num_leaves;
+        return IteratorControl::AdvanceToNext;
+    });
+    size_t ranges = std::min(m_parallelism, num_leaves);
+    return ranges > 1 ? ranges : 0;
+}
+
+void Query::find_parallel(const std::vector<QueryStateBase*>& states, size_t num_leaves) const
+{
+    const size_t ranges = states.size();
+    // Every range gets its own copy of the node tree. The copies are made up front, as they read from this query.
+    std::vector<Query> queries(ranges, *this);
+    std::vector<std::exception_ptr> errors(ranges);
+    std::vector<std::thread> threads;
+    threads.reserve(ranges);
+
+    for (size_t r = 0; r < ranges; ++r) {
+        size_t begin = num_leaves * r / ranges;
+        size_t end = num_leaves * (r + 1) / ranges;
+        threads.emplace_back([&, r, begin, end] {
+            try {
+                const Query& query = queries[r];
+                QueryStateBase& st = *states[r];
+                query.init();
+                ParentNode* node = query.root_node();
+                size_t leaf_ndx = 0;
+                m_table->traverse_clusters([&](const Cluster* cluster) {
+                    size_t ndx = leaf_ndx++;
+                    if (ndx < begin)
+                        return IteratorControl::AdvanceToNext;
+                    if (ndx >= end)
+                        return IteratorControl::Stop;
+                    node->set_cluster(cluster);
+                    st.m_key_offset = cluster->get_offset();
+                    st.m_key_values = cluster->get_key_array();
+                    query.aggregate_internal(node, &st, 0, cluster->node_size(), nullptr);
+                    return IteratorControl::AdvanceToNext;
+                });
+            }
+            catch (...) {
+                errors[r] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& t : threads)
+        t.join();
+    for (auto& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+
 size_t Query::count() const
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::query};
     if (!m_table)
         return 0;
     return do_count();
@@ -1614,6 +2550,8 @@ size_t Query::count() const
 
 TableView Query::find_all(const DescriptorOrdering& descriptor) const
 {
+    REALM_TRACE_SCOPE("Query::find_all");
+    util::AllocTagScope alloc_tag{util::AllocTag::query};
     if (descriptor.is_empty()) {
         return find_all();
     }
@@ -1644,6 +2582,7 @@ TableView Query::find_all(const DescriptorOrdering& descriptor) const
 
 size_t Query::count(const DescriptorOrdering& descriptor) const
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::query};
     if (!m_table)
         return 0;
     realm::util::Optional<size_t> min_limit = descriptor.get_min_limit();
@@ -1849,6 +2788,56 @@ util::bind_ptr<DescriptorOrdering> Query::get_ordering()
     return std::move(m_ordering);
 }
 
+QueryExplanation Query::explain_analyze() const
+{
+    QueryExplanation explanation;
+    explanation.description = get_description();
+
+    m_explanation = &explanation;
+    auto t1 = std::chrono::steady_clock::now();
+    try {
+        explanation.num_results = do_count();
+    }
+    catch (...) {
+        m_explanation = nullptr;
+        throw;
+    }
+    explanation.elapsed = std::chrono::steady_clock::now() - t1;
+    m_explanation = nullptr;
+    return explanation;
+}
+
+std::vector<ParentNode*> Query::explain_nodes() const
+{
+    // The list of children is copied, as the index strategy removes the driving node from it
+    std::vector<ParentNode*> nodes = root_node()->m_children;
+    util::serializer::SerialisationState state(m_table->get_parent_group());
+    for (auto node : nodes) {
+        QueryExplanation::Node& n = m_explanation->nodes.emplace_back();
+        n.description = node->describe(state);
+        if (n.description.empty())
+            n.description = "(query planner node)";
+        n.has_index = node->has_search_index();
+        n.is_expression = dynamic_cast<ExpressionNode*>(node) != nullptr;
+        n.initial_cost = node->cost();
+    }
+    return nodes;
+}
+
+std::string QueryExplanation::to_string() const
+{
+    std::string out = util::format("%1\nstrategy: %2, results: %3, clusters: %4, elapsed: %5 us\n", description,
+                                   strategy, num_results, clusters,
+                                   std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        auto& n = nodes[i];
+        out += util::format("  #%1 %2%3%4: chosen: %5, visited: %6, matches: %7, cost: %8 -> %9\n", i,
+                            n.description, n.is_expression ? " (expression)" : "", n.has_index ? " (indexed)" : "",
+                            n.times_chosen, n.rows_visited, n.matches, n.initial_cost, n.final_cost);
+    }
+    return out;
+}
+
 std::string Query::get_description() const
 {
     util::serializer::SerialisationState state(m_table->get_parent_group());
@@ -1869,13 +2858,20 @@ std::string Query::get_description_safe() const noexcept
     return "Unknown Query";
 }
 
-void Query::init() const
+void Query::init(bool will_query_ranges) const
 {
     m_table.check();
     if (ParentNode* root = root_node()) {
-        root->init(m_view == nullptr);
+        bool use_indexes = will_query_ranges && m_view == nullptr;
+        CompoundIndexNode::remove(*root);
+        root->init(use_indexes);
         std::vector<ParentNode*> vec;
         root->gather_children(vec);
+        if (use_indexes) {
+            CompoundIndexNode::add(*root, m_table);
+            GeoIndexNode::add(*root, m_table);
+            apply_column_statistics(*root, *m_table);
+        }
     }
 }
 
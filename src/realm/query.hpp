@@ -23,6 +23,7 @@
 #include <cstdio>
 #include <climits>
 #include <algorithm>
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include <realm/aggregate_ops.hpp>
 #include <realm/binary_data.hpp>
 #include <realm/column_type_traits.hpp>
+#include <realm/external_sort.hpp>
 #include <realm/handover_defs.hpp>
 #include <realm/obj_list.hpp>
 #include <realm/table_ref.hpp>
@@ -78,6 +80,62 @@ struct QueryGroup {
     State m_state = State::Default;
 };
 
+// Execution statistics of a single evaluation of a query, as produced by Query::explain_analyze()
+struct QueryExplanation {
+    struct Node {
+        std::string description;
+        // Whether the condition can be answered from a search index
+        bool has_index = false;
+        // Whether the condition is evaluated by the generic expression engine rather than by a node specialized
+        // for the type of the property
+        bool is_expression = false;
+        // The estimated cost per match before and after the evaluation. The query engine lets the cheapest node
+        // drive the search and has the others verify its matches.
+        double initial_cost = 0;
+        double final_cost = 0;
+        // Number of times the node was picked as the driving node
+        size_t times_chosen = 0;
+        // Number of rows traversed while this node was driving or probing
+        size_t rows_visited = 0;
+        // Number of rows matching the entire query found while this node was driving or probing
+        size_t matches = 0;
+    };
+
+    std::string description;
+    // One of "all objects", "view", "index" or "cluster scan"
+    std::string strategy;
+    // The top level conditions, in evaluation order
+    std::vector<Node> nodes;
+    size_t clusters = 0;
+    size_t num_results = 0;
+    std::chrono::nanoseconds elapsed{0};
+
+    std::string to_string() const;
+};
+
+// An aggregate to compute for each group of Query::group_by()
+struct GroupByAggregate {
+    enum class Type { Sum, Min, Max, Average };
+    Type type;
+    ColKey column;
+};
+
+// The result of Query::group_by(). Strings and binary values refer to the Realm, so they are only valid as long as
+// the transaction stays at the version the query was evaluated on.
+struct GroupByResult {
+    struct Group {
+        // The value of the grouping property shared by the objects of the group
+        Mixed key;
+        // The number of matching objects in the group
+        size_t count = 0;
+        // One value for each of the requested aggregates, in the order they were requested. As for the aggregates
+        // of Query, sums of no values are zero and the others are null.
+        std::vector<Mixed> values;
+    };
+    // In the order of the first matching object of each group
+    std::vector<Group> groups;
+};
+
 class Query final {
 public:
     Query(ConstTableRef table, TableView* tv = nullptr);
@@ -104,6 +162,9 @@ public:
     // Find links that does not point to specific target objects
     Query& not_links_to(ColKey column_key, const std::vector<ObjKey>& target_obj);
 
+    // Find the objects with keys in [begin, end), without scanning the rest of the table
+    Query& key_range(ObjKey begin, ObjKey end);
+
     // Conditions: null
     Query& equal(ColKey column_key, null);
     Query& not_equal(ColKey column_key, null);
@@ -151,6 +212,7 @@ public:
     Query& greater_equal(ColKey column_key, Timestamp value);
     Query& less_equal(ColKey column_key, Timestamp value);
     Query& less(ColKey column_key, Timestamp value);
+    Query& between(ColKey column_key, Timestamp from, Timestamp to);
 
     // Conditions: ObjectId
     Query& equal(ColKey column_key, ObjectId value);
@@ -264,6 +326,10 @@ public:
     size_t count() const;
     TableView find_all(const DescriptorOrdering& descriptor) const;
     size_t count(const DescriptorOrdering& descriptor) const;
+    // Sort the matching objects without holding them all in memory, by writing sorted runs of them to temporary
+    // files once they exceed the memory budget of `options`. The cursor is only valid as long as the table stays at
+    // the same version.
+    ExternalSortCursor find_all_external(const SortDescriptor& sort, ExternalSortOptions options = {}) const;
 
     // Aggregates return nullopt if the operation is not supported on the given column
     // Everything but `sum` returns `some(null)` if there are no non-null values
@@ -273,6 +339,24 @@ public:
     std::optional<Mixed> max(ColKey col_key, ObjKey* = nullptr) const;
     std::optional<Mixed> avg(ColKey col_key, size_t* value_count = nullptr) const;
 
+    // Group the matching objects by the value of `group_col`, and compute the given aggregates for each group in a
+    // single pass over the objects. Throws IllegalOperation if the objects cannot be grouped by the column, which
+    // must be a non-collection property which is not of type Mixed or Decimal128, or if one of the aggregates is
+    // not supported on its column.
+    GroupByResult group_by(ColKey group_col, const std::vector<GroupByAggregate>& aggregates) const;
+
+    // Find the pairs of an object matching this query and an object matching `other` which have equal values in
+    // `column` and `other_column`, such as a foreign key and the primary key it refers to, without a link between
+    // them. The matches of the query on the table with fewer objects are put in a hash table, and the matches of
+    // the other query are looked up in it as they are found. `func` is called with the key of the object matching
+    // this query and the key of the object matching `other` for each pair, until it returns IteratorControl::Stop.
+    // Null values match nothing. Throws IllegalOperation if the columns cannot be joined on, which must be
+    // non-collection properties of the same type which is not Mixed or Decimal128. The tables must not be modified
+    // by `func`.
+    void join(ColKey column, const Query& other, ColKey other_column,
+              util::FunctionRef<IteratorControl(ObjKey, ObjKey)> func) const;
+    std::vector<std::pair<ObjKey, ObjKey>> join(ColKey column, const Query& other, ColKey other_column) const;
+
     // Deletion
     size_t remove() const;
 
@@ -299,6 +383,12 @@ public:
     }
     void get_outside_versions(TableVersions&) const;
 
+    // Add the columns of the table which the conditions read to `columns`.
+    // Returns false if they are not known, e.g. because the query has
+    // expressions or a restricting view, in which case the results may change
+    // when other columns do.
+    bool get_condition_columns(std::vector<ColKey>& columns) const;
+
     // True if matching rows are guaranteed to be returned in table order.
     bool produces_results_in_table_order() const
     {
@@ -326,12 +416,31 @@ public:
     // This will remove the ordering from the Query object
     util::bind_ptr<DescriptorOrdering> get_ordering();
 
+    // Allow find_all() and count() to use up to `num_threads` threads, each evaluating a contiguous range of the
+    // table's clusters with its own copy of the query. This only takes effect for queries on frozen tables without
+    // a restricting view and without a limit; everything else is evaluated on the calling thread. Large results of
+    // find_all() on frozen tables are also sorted on up to `num_threads` threads.
+    Query& set_parallelism(size_t num_threads) noexcept
+    {
+        m_parallelism = num_threads;
+        return *this;
+    }
+    size_t get_parallelism() const noexcept
+    {
+        return m_parallelism;
+    }
+
     bool eval_object(const Obj& obj) const;
 
+    // Count the matching objects the same way as count() does, recording which strategy was used and how much
+    // work each condition did. This is meant for diagnosing slow queries, and is not thread safe with respect to
+    // other evaluations of the same Query object.
+    QueryExplanation explain_analyze() const;
+
 private:
     void create();
 
-    void init() const;
+    void init(bool will_query_ranges = true) const;
     size_t find_internal(size_t start = 0, size_t end = size_t(-1)) const;
     void handle_pending_not();
     void set_table(TableRef tr);
@@ -362,11 +471,25 @@ private:
     void aggregate(QueryStateBase& st, ColKey column_key) const;
 
     size_t find_best_node(ParentNode* pn) const;
+    // The columns read to match the objects of a cluster, for the cluster traversal to prefetch
+    std::vector<ColKey> get_scan_columns() const;
     void aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start, size_t end,
                             ArrayPayload* source_column) const;
 
     void do_find_all(QueryStateBase& st) const;
+    // Continue a find_all() from the position recorded in `next_key` / `next_ndx`, appending at most `limit` matches
+    // to `keys`, and advance that position past the last object evaluated. Returns true if there are no more
+    // objects to evaluate.
+    bool resume_find_all(std::vector<ObjKey>& keys, size_t limit, ObjKey& next_key, size_t& next_ndx) const;
     size_t do_count(size_t limit = size_t(-1)) const;
+    // Add the top level conditions to `m_explanation` and return them
+    std::vector<ParentNode*> explain_nodes() const;
+
+    // Returns the number of ranges to split a cluster traversal into, or 0 if it should run serially. On success
+    // `num_leaves` is the number of clusters in the table.
+    size_t parallel_ranges(size_t limit, size_t& num_leaves) const;
+    // Evaluate the conditions over `states.size()` contiguous ranges of clusters, one thread per range
+    void find_parallel(const std::vector<QueryStateBase*>& states, size_t num_leaves) const;
     void delete_nodes() noexcept;
 
     ParentNode* root_node() const
@@ -374,6 +497,8 @@ private:
         REALM_ASSERT(m_groups.size());
         return m_groups[0].m_root_node.get();
     }
+    // Whether matching an object may depend on other objects
+    bool follows_links() const;
 
     void add_node(std::unique_ptr<ParentNode>);
 
@@ -381,6 +506,7 @@ private:
     friend class TableView;
     friend class SubQueryCount;
     friend class PrimitiveListCount;
+    friend class QueryCursor;
     template <class>
     friend class AggregateHelper;
 
@@ -405,6 +531,56 @@ private:
     TableView* m_source_table_view = nullptr; // table views are not refcounted, and not owned by the query.
     std::unique_ptr<TableView> m_owned_source_table_view; // <--- except when indicated here
     util::bind_ptr<DescriptorOrdering> m_ordering;
+    size_t m_parallelism = 1;
+    // Only set while explain_analyze() is running
+    mutable QueryExplanation* m_explanation = nullptr;
+};
+
+/// A QueryCursor streams the matches of a query in batches. It remembers how
+/// far into the table (or restricting view) the previous batch got, so asking
+/// for the next batch resumes the search there instead of evaluating the
+/// query from the start again.
+///
+/// Matches are produced in the same order as Query::find_all() would produce
+/// them without a sort/distinct/limit ordering; any such ordering on the query
+/// is ignored. The cursor operates on the version of the data it was created
+/// (or last reset) on. Once the table, or a table the query depends on, has
+/// been modified, the cursor is stale, and next() throws StaleAccessor until
+/// reset() is called.
+class QueryCursor {
+public:
+    explicit QueryCursor(const Query& query);
+
+    /// Append up to `max_count` further matches to `keys`, and return the
+    /// number of keys appended. Fewer than `max_count` keys are only appended
+    /// when the end has been reached.
+    size_t next(std::vector<ObjKey>& keys, size_t max_count);
+
+    /// True when every match has been produced.
+    bool at_end() const noexcept
+    {
+        return m_at_end;
+    }
+
+    /// The number of matches produced since the cursor was created or reset,
+    /// which is also the index in the full result of the next match.
+    size_t get_position() const noexcept
+    {
+        return m_position;
+    }
+
+    bool is_stale() const;
+
+    /// Rewind the cursor to the beginning on the current version of the data.
+    void reset();
+
+private:
+    Query m_query;
+    TableVersions m_versions;
+    ObjKey m_next_key;
+    size_t m_next_ndx = 0;
+    size_t m_position = 0;
+    bool m_at_end = false;
 };
 
 // Implementation:
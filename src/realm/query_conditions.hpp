@@ -63,11 +63,6 @@ struct Contains : public HackClass {
     {
         return v2.contains(v1);
     }
-    bool operator()(StringData v1, const std::array<uint8_t, 256>& charmap, StringData v2) const
-    {
-        return v2.contains(v1, charmap);
-    }
-
     bool operator()(const QueryValue& m1, const QueryValue& m2) const
     {
         if (m1.is_null())
@@ -388,19 +383,6 @@ struct ContainsIns : public HackClass {
         return this->operator()(s1, s2, false, false);
     }
 
-    // Case insensitive Boyer-Moore version
-    bool operator()(StringData v1, const char* v1_upper, const char* v1_lower,
-                    const std::array<uint8_t, 256>& charmap, StringData v2) const
-    {
-        if (v2.is_null() && !v1.is_null())
-            return false;
-
-        if (v1.size() == 0 && !v2.is_null())
-            return true;
-
-        return contains_ins(v2, v1_upper, v1_lower, v1.size(), charmap);
-    }
-
     bool operator()(const QueryValue& m1, const QueryValue& m2) const
     {
         if (m1.is_null())
@@ -59,6 +59,16 @@ public:
         }
         return (m_limit > m_match_count);
     }
+    // Accumulate all elements of a leaf in one go. This is used when aggregating over a whole table, where every
+    // row matches, so there is no need to go through match() for each of them.
+    template <class LeafType>
+    void accumulate_leaf(const LeafType& leaf)
+    {
+        size_t count;
+        auto sum = leaf.sum(0, leaf.size(), count);
+        m_state.accumulate_bulk(sum, count);
+        m_match_count += count;
+    }
     ResultType result_sum() const
     {
         return m_state.result();
@@ -106,6 +116,19 @@ public:
         }
         return m_limit > m_match_count;
     }
+    // See QueryStateSum::accumulate_leaf()
+    template <class LeafType>
+    void accumulate_leaf(const LeafType& leaf)
+    {
+        using Value = typename util::RemoveOptional<R>::type;
+        constexpr bool max = std::is_same_v<State<Value>, aggregate_operations::Maximum<Value>>;
+        Value v;
+        size_t index;
+        if (leaf.template minmax<max>(0, leaf.size(), &v, &index) && m_state.accumulate(v)) {
+            ++m_match_count;
+            m_minmax_key = (m_key_values ? m_key_values->get(index) : index) + m_key_offset;
+        }
+    }
     Mixed get_result() const
     {
         return m_state.is_null() ? Mixed() : m_state.result();
@@ -329,6 +329,20 @@ void IndexEvaluator::init(SearchIndex* index, Mixed value)
     m_results_ndx = m_results_start;
 }
 
+void IndexEvaluator::init(SearchIndex* index, const std::vector<Mixed>& values)
+{
+    REALM_ASSERT(index);
+    auto keys = std::make_shared<std::vector<ObjKey>>();
+    std::vector<ObjKey> matches;
+    for (auto& value : values) {
+        index->find_all(matches, value);
+        keys->insert(keys->end(), matches.begin(), matches.end());
+        matches.clear();
+    }
+    std::sort(keys->begin(), keys->end());
+    init(std::move(keys));
+}
+
 void IndexEvaluator::init(std::vector<ObjKey>* storage)
 {
     REALM_ASSERT(storage);
@@ -343,6 +357,135 @@ void IndexEvaluator::init(std::vector<ObjKey>* storage)
     }
 }
 
+void IndexEvaluator::init(std::shared_ptr<std::vector<ObjKey>> keys)
+{
+    m_shared_keys = std::move(keys);
+    init(m_shared_keys.get());
+}
+
+void CompoundIndexNode::remove(ParentNode& root)
+{
+    for (ParentNode* node = &root; node->m_child;) {
+        if (dynamic_cast<CompoundIndexNode*>(node->m_child.get())) {
+            node->m_child = std::move(node->m_child->m_child);
+        }
+        else {
+            node = node->m_child.get();
+        }
+    }
+}
+
+void CompoundIndexNode::add(ParentNode& root, ConstTableRef table)
+{
+    auto& indexes = table->get_compound_indexes();
+    if (indexes.empty())
+        return;
+
+    // Pick the index with the longest prefix of columns having equality conditions
+    const CompoundIndex* best = nullptr;
+    std::vector<Mixed> best_values;
+    for (auto& index : indexes) {
+        std::vector<Mixed> values;
+        for (auto col : index->get_columns()) {
+            std::optional<Mixed> value;
+            for (auto child : root.m_children) {
+                if (child->m_condition_column_key == col && (value = child->get_equality_value()))
+                    break;
+            }
+            if (!value)
+                break;
+            values.push_back(*value);
+        }
+        if (values.size() > best_values.size()) {
+            best = index.get();
+            best_values = std::move(values);
+        }
+    }
+    // A single condition is better served by an index on that column, if any
+    if (best_values.empty() || (best_values.size() == 1 && table->get_search_index(best->get_columns()[0])))
+        return;
+
+    auto [begin, end] = best->find_prefix(best_values);
+    auto keys = std::make_shared<std::vector<ObjKey>>();
+    keys->reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        keys->push_back(best->get(i));
+    }
+    std::sort(keys->begin(), keys->end());
+
+    auto node = std::make_unique<CompoundIndexNode>(std::move(keys));
+    node->set_table(table);
+    node->init(true);
+    root.add_child(std::move(node));
+    std::vector<ParentNode*> v;
+    root.gather_children(v);
+}
+
+void GeoIndexNode::add(ParentNode& root, ConstTableRef table)
+{
+#if REALM_ENABLE_GEOSPATIAL
+    // Use the condition having the fewest candidates
+    std::shared_ptr<std::vector<ObjKey>> best;
+    for (auto child : root.m_children) {
+        auto node = dynamic_cast<ExpressionNode*>(child);
+        auto geo = node ? dynamic_cast<const GeoWithinCompare*>(&node->get_expression()) : nullptr;
+        if (!geo)
+            continue;
+        auto keys = geo->get_index_candidates();
+        if (keys && (!best || keys->size() < best->size()))
+            best = std::move(keys);
+    }
+    if (!best)
+        return;
+
+    auto node = std::make_unique<GeoIndexNode>(std::move(best));
+    node->set_table(table);
+    node->init(true);
+    root.add_child(std::move(node));
+    std::vector<ParentNode*> v;
+    root.gather_children(v);
+#else
+    static_cast<void>(root);
+    static_cast<void>(table);
+#endif
+}
+
+void apply_column_statistics(ParentNode& root, const Table& table)
+{
+    const size_t table_size = table.size();
+    if (table_size < TableStatistics::min_table_size || root.m_children.size() < 2)
+        return;
+
+    for (ParentNode* node : root.m_children) {
+        if (auto keys = node->index_based_keys()) {
+            // The number of matches is known. An index lookup is still assumed
+            // to be at least as good as a scan of unknown selectivity.
+            node->m_dD = std::max(node->m_dD, double(table_size + 1) / (keys->size() + 1));
+            continue;
+        }
+        if (node->m_dT == 0 || !node->m_condition_column_key)
+            continue;
+        auto statistics = table.get_column_statistics(node->m_condition_column_key);
+        if (!statistics)
+            continue;
+        if (auto fraction = node->estimate_selectivity(*statistics)) {
+            // A condition that never matched in the sample may still match now and then
+            double min_fraction = 1.0 / (2 * table_size);
+            node->m_dD = 1.0 / std::min(std::max(*fraction, min_fraction), 1.0);
+        }
+    }
+
+    // Every node tests the other conditions in the order of its m_children,
+    // with the node itself first
+    auto by_cost = [](const ParentNode* a, const ParentNode* b) {
+        return a->cost() < b->cost();
+    };
+    for (ParentNode* node : root.m_children) {
+        REALM_ASSERT(node->m_children.front() == node);
+        std::stable_sort(node->m_children.begin() + 1, node->m_children.end(), by_cost);
+    }
+}
+
 size_t IndexEvaluator::do_search_index(const Cluster* cluster, size_t start, size_t end)
 {
     if (start >= end) {
@@ -383,10 +526,6 @@ size_t IndexEvaluator::do_search_index(const Cluster* cluster, size_t start, siz
 StringNode<Equal>::StringNode(ColKey col, const Mixed* begin, const Mixed* end)
     : StringNodeEqualBase(StringData(), col)
 {
-    // Don't use the search index if present since we're in a scenario where
-    // it'd be slower
-    m_index_evaluator.reset();
-
     for (const Mixed* it = begin; it != end; ++it) {
         if (it->is_null()) {
             m_needles.emplace();
@@ -402,19 +541,34 @@ StringNode<Equal>::StringNode(ColKey col, const Mixed* begin, const Mixed* end)
     }
 }
 
+void StringNode<Equal>::init(bool will_query_ranges)
+{
+    if (!m_needles.empty()) {
+        // Whether the index is used depends on the number of needles
+        const bool use_index =
+            m_table.unchecked_ptr()->search_index_type(m_condition_column_key) == IndexType::General &&
+            use_index_for_needles(m_needles.size(), m_table.unchecked_ptr()->size());
+        m_index_evaluator = use_index ? std::make_optional(IndexEvaluator{}) : std::nullopt;
+    }
+    StringNodeEqualBase::init(will_query_ranges);
+    m_enum_resolved = false;
+}
+
 void StringNode<Equal>::_search_index_init()
 {
     REALM_ASSERT(bool(m_index_evaluator));
     auto index = ParentNode::m_table.unchecked_ptr()->get_search_index(ParentNode::m_condition_column_key);
-    m_index_evaluator->init(index, StringNodeBase::m_string_value);
+    if (m_needles.empty()) {
+        m_index_evaluator->init(index, StringNodeBase::m_string_value);
+    }
+    else {
+        std::vector<Mixed> values(m_needles.begin(), m_needles.end());
+        m_index_evaluator->init(index, values);
+    }
 }
 
 bool StringNode<Equal>::do_consume_condition(ParentNode& node)
 {
-    // Don't use the search index if present since we're in a scenario where
-    // it'd be slower
-    m_index_evaluator.reset();
-
     auto& other = static_cast<StringNode<Equal>&>(node);
     REALM_ASSERT(m_condition_column_key == other.m_condition_column_key);
 
@@ -446,8 +600,46 @@ bool StringNode<Equal>::do_consume_condition(ParentNode& node)
     return true;
 }
 
+void StringNode<Equal>::resolve_enum_indexes()
+{
+    m_enum_needles.clear();
+    if (m_needles.empty()) {
+        m_enum_index = m_leaf->find_enum_index(m_string_value);
+    }
+    else {
+        for (auto& needle : m_needles) {
+            size_t ndx = m_leaf->find_enum_index(needle);
+            if (ndx == realm::not_found)
+                continue;
+            if (ndx >= m_enum_needles.size())
+                m_enum_needles.resize(ndx + 1);
+            m_enum_needles[ndx] = true;
+        }
+    }
+    m_enum_resolved = true;
+}
+
 size_t StringNode<Equal>::_find_first_local(size_t start, size_t end)
 {
+    if (m_leaf->is_enumerated()) {
+        REALM_ASSERT_DEBUG(m_enum_resolved);
+        if (m_needles.empty()) {
+            if (m_enum_index == realm::not_found)
+                return not_found;
+            return m_leaf->find_first_enum_index(m_enum_index, start, end);
+        }
+        if (m_enum_needles.empty())
+            return not_found;
+        if (end == npos)
+            end = m_leaf->size();
+        for (size_t i = start; i < end; ++i) {
+            size_t ndx = m_leaf->get_enum_index(i);
+            if (ndx < m_enum_needles.size() && m_enum_needles[ndx])
+                return i;
+        }
+        return not_found;
+    }
+
     if (m_needles.empty()) {
         return m_leaf->find_first(m_string_value, start, end);
     }
@@ -520,6 +712,12 @@ StringNodeFulltext::StringNodeFulltext(const StringNodeFulltext& other)
     m_link_map = std::make_unique<LinkMap>(*other.m_link_map);
 }
 
+bool StringNodeFulltext::collect_condition_columns_local(std::vector<ColKey>& columns) const
+{
+    // The condition column is a column of the target table if the condition follows links
+    return !m_link_map->has_links() && ParentNode::collect_condition_columns_local(columns);
+}
+
 void StringNodeFulltext::_search_index_init()
 {
     StringIndex* index = m_link_map->get_target_table()->get_string_index(ParentNode::m_condition_column_key);
@@ -86,6 +86,7 @@ TConditionValue:    Type of values in condition column. That is, int64_t, float,
 #include <realm/array_timestamp.hpp>
 #include <realm/column_integer.hpp>
 #include <realm/column_type_traits.hpp>
+#include <realm/index_sorted.hpp>
 #include <realm/index_string.hpp>
 #include <realm/query_conditions.hpp>
 #include <realm/query_expression.hpp>
@@ -120,6 +121,17 @@ public:
     {
         return nullptr;
     }
+    // If the condition is equality with a single value, return that value
+    virtual std::optional<Mixed> get_equality_value() const
+    {
+        return {};
+    }
+    // Estimate the fraction of the objects matching this condition from the
+    // statistics of the condition column, if the condition allows it
+    virtual std::optional<double> estimate_selectivity(const ColumnStatistics&) const
+    {
+        return {};
+    }
 
     void gather_children(std::vector<ParentNode*>& v)
     {
@@ -161,6 +173,20 @@ public:
             m_child->get_link_dependencies(tables);
     }
 
+    // Whether matching an object may depend on other objects than the one
+    // being matched, because the condition follows links
+    bool follows_links() const
+    {
+        return follows_links_local() || (m_child && m_child->follows_links());
+    }
+
+    // Add the columns of the table which matching an object reads to
+    // `columns`. Returns false if they are not known, e.g. for expressions.
+    bool get_condition_columns(std::vector<ColKey>& columns) const
+    {
+        return collect_condition_columns_local(columns) && (!m_child || m_child->get_condition_columns(columns));
+    }
+
     void set_table(ConstTableRef table)
     {
         if (table == m_table)
@@ -181,6 +207,18 @@ public:
     }
 
     virtual void collect_dependencies(std::vector<TableKey>&) const {}
+    virtual bool follows_links_local() const
+    {
+        return false;
+    }
+    // Nodes which read other columns than the condition column must override this
+    virtual bool collect_condition_columns_local(std::vector<ColKey>& columns) const
+    {
+        if (!m_condition_column_key)
+            return false;
+        columns.push_back(m_condition_column_key);
+        return true;
+    }
 
     virtual size_t find_first_local(size_t start, size_t end) = 0;
     virtual size_t find_all_local(size_t start, size_t end);
@@ -220,12 +258,15 @@ public:
         std::string s;
         s = describe(state);
         if (m_child) {
-            s = s + " and " + m_child->describe_expression(state);
+            // Nodes added by the query planner don't describe themselves
+            std::string rest = m_child->describe_expression(state);
+            if (!rest.empty())
+                s = s + " and " + rest;
         }
         return s;
     }
 
-    bool consume_condition(ParentNode& other, bool ignore_indexes, std::optional<size_t> num_identical_conditions)
+    bool consume_condition(ParentNode& other)
     {
         // We can only combine conditions if they're the same operator on the
         // same column and there's no additional conditions ANDed on
@@ -236,32 +277,12 @@ public:
         if (typeid(*this) != typeid(other))
             return false;
 
-        // If a search index is present, don't try to combine conditions since index search is most likely faster.
-        // Assuming N elements to search and M conditions to check:
-        // 1) search index present:                     O(log(N)*M)
-        // 2) no search index, combine conditions:      O(N)
-        // 3) no search index, conditions not combined: O(N*M)
-        // In practice N is much larger than M, so if we have a search index, choose 1, otherwise if possible
-        // choose 2. The exception is if we're inside a Not group or if the query is restricted to a view, as in those
-        // cases end will always be start+1 and we'll have O(N*M) runtime even with a search index, so we want to
-        // combine even with an index.
-        //
-        // If the column is not a string type, then as the number of conditions increases, the cost of using the index
-        // for each condition rises faster than using a hash set to check if each value in a leaf matches a condition.
-        // So if there are _many_ conditions (as defined below), combine conditions even if an index is present.
-        if (has_search_index() && !ignore_indexes &&
-            (m_condition_column_key.get_type() == col_type_String || !num_identical_conditions ||
-             *num_identical_conditions < c_threshold_of_conditions_overwhelming_index))
-            return false;
+        // This is done even if the column has a search index, as the combined
+        // node looks up each of its values in the index when that is cheaper
+        // than checking every value of the column against the set of values
         return do_consume_condition(other);
     }
 
-    constexpr static size_t c_threshold_of_conditions_overwhelming_index = 100;
-    bool num_conditions_may_need_combination_counts(size_t num_total_conditions)
-    {
-        return num_total_conditions >= c_threshold_of_conditions_overwhelming_index;
-    }
-
     std::unique_ptr<ParentNode> m_child;
     std::vector<ParentNode*> m_children;
     mutable ColKey m_condition_column_key = ColKey(); // Column of search criteria
@@ -309,10 +330,71 @@ protected:
     }
 };
 
+// Estimate the fraction of the objects for which `Cond` holds between the
+// column value and `value`
+template <class Cond>
+std::optional<double> estimate_condition(const ColumnStatistics& stats, Mixed value)
+{
+    if constexpr (std::is_same_v<Cond, Equal>) {
+        return stats.estimate_equal(value);
+    }
+    else if constexpr (std::is_same_v<Cond, NotEqual>) {
+        return 1.0 - stats.estimate_equal(value);
+    }
+    else if constexpr (std::is_same_v<Cond, Greater>) {
+        return stats.estimate_greater(value, false);
+    }
+    else if constexpr (std::is_same_v<Cond, GreaterEqual>) {
+        return stats.estimate_greater(value, true);
+    }
+    else if constexpr (std::is_same_v<Cond, Less>) {
+        return stats.estimate_less(value, false);
+    }
+    else if constexpr (std::is_same_v<Cond, LessEqual>) {
+        return stats.estimate_less(value, true);
+    }
+    return {};
+}
+
+// Sum the estimated fractions of the objects equal to each of the needles of an
+// IN condition
+template <class NeedleContainer, class ToMixed>
+double estimate_needles(const ColumnStatistics& stats, const NeedleContainer& needles, ToMixed to_mixed)
+{
+    double fraction = 0;
+    for (auto& needle : needles) {
+        fraction += stats.estimate_equal(to_mixed(needle));
+    }
+    return std::min(fraction, 1.0);
+}
+
+// Looking up each needle of an IN condition in a search index beats testing
+// every value of the column against the set of needles, unless there are many
+// needles compared to the number of objects
+inline bool use_index_for_needles(size_t num_needles, size_t table_size)
+{
+    constexpr size_t min_objects_per_needle = 16;
+    return num_needles * min_objects_per_needle <= table_size;
+}
+
+// Use the column statistics of the table to set the initial match distance
+// estimates of the conditions ANDed together at `root`, and order them so the
+// cheapest and most selective conditions are tested first.
+void apply_column_statistics(ParentNode& root, const Table& table);
+
 class IndexEvaluator {
 public:
     void init(SearchIndex* index, Mixed value);
+    // Match the objects having any of `values`, looking up each of them
+    void init(SearchIndex* index, const std::vector<Mixed>& values);
     void init(std::vector<ObjKey>* storage);
+    // Iterate `keys`, which must be sorted. The evaluator shares ownership.
+    void init(std::shared_ptr<std::vector<ObjKey>> keys);
+    // Match the objects for which the indexed value satisfies `Cond` against a
+    // non-null `value`. Returns false, leaving the evaluator unusable, if the
+    // condition matches too large a part of the table for this to beat a scan.
+    template <class Cond>
+    bool init_range(const SortedIndex* index, Mixed value);
 
     size_t do_search_index(const Cluster* cluster, size_t start, size_t end);
 
@@ -352,6 +434,163 @@ private:
     size_t m_results_end = 0;
 
     std::vector<ObjKey>* m_matching_keys = nullptr;
+    // Owns the storage m_matching_keys points to, if shared with the evaluator
+    std::shared_ptr<std::vector<ObjKey>> m_shared_keys;
+};
+
+template <class Cond>
+bool IndexEvaluator::init_range(const SortedIndex* index, Mixed value)
+{
+    // Collecting and sorting the keys is only worth it for selective conditions
+    constexpr size_t max_fraction = 16;
+    auto [begin, end] = index->find_range<Cond>(value);
+    if ((end - begin) * max_fraction > index->size())
+        return false;
+
+    auto keys = std::make_shared<std::vector<ObjKey>>();
+    keys->reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        keys->push_back(index->get(i));
+    }
+    std::sort(keys->begin(), keys->end());
+    init(std::move(keys));
+    return true;
+}
+
+// Produces the objects matching equality conditions on a prefix of the
+// columns of a compound index. It is added to the end of a query by the query
+// planner when the query is initialized, and removed again before the next
+// initialization. The conditions it covers are left in place. The node never
+// shows up in the description of a query, nor in copies of it.
+class CompoundIndexNode : public ParentNode {
+public:
+    CompoundIndexNode(std::shared_ptr<std::vector<ObjKey>> keys)
+        : m_keys(std::move(keys))
+    {
+    }
+
+    // Remove any node added by a previous call to add(), or to GeoIndexNode::add()
+    static void remove(ParentNode& root);
+    // Add a node if `table` has a compound index matching the top level
+    // conditions of `root`, the children of which must have been gathered.
+    static void add(ParentNode& root, ConstTableRef table);
+
+    void init(bool will_query_ranges) override
+    {
+        ParentNode::init(will_query_ranges);
+        m_index_evaluator.init(m_keys);
+        m_dD = double(m_table->size() + 1) / (m_keys->size() + 1);
+        m_dT = 0;
+    }
+
+    bool has_search_index() const override
+    {
+        return true;
+    }
+
+    const IndexEvaluator* index_based_keys() override
+    {
+        return &m_index_evaluator;
+    }
+
+    size_t find_first_local(size_t start, size_t end) override
+    {
+        return m_index_evaluator.do_search_index(m_cluster, start, end);
+    }
+
+    std::string describe_expression(util::serializer::SerialisationState& state) const override
+    {
+        return m_child ? m_child->describe_expression(state) : "";
+    }
+
+    std::unique_ptr<ParentNode> clone() const override
+    {
+        return m_child ? m_child->clone() : nullptr;
+    }
+
+private:
+    std::shared_ptr<std::vector<ObjKey>> m_keys;
+    IndexEvaluator m_index_evaluator;
+};
+
+// Produces the objects linking to points which may be inside the region of a
+// top level geoWithin condition, as found by the geospatial index of the
+// linked table. It is managed by the query planner like CompoundIndexNode,
+// and the condition is left in place to test the candidates exactly.
+class GeoIndexNode : public CompoundIndexNode {
+public:
+    using CompoundIndexNode::CompoundIndexNode;
+
+    // Add a node if a top level condition of `root`, the children of which
+    // must have been gathered, can use a geospatial index.
+    static void add(ParentNode& root, ConstTableRef table);
+};
+
+// Matches the objects with keys in [begin, end). The keys are found with
+// Table::scan_key_range(), which only visits the part of the cluster tree
+// holding the range, and the node then works like a search index condition.
+class KeyRangeNode : public ParentNode {
+public:
+    KeyRangeNode(ObjKey begin, ObjKey end)
+        : m_begin(begin)
+        , m_end(end)
+    {
+    }
+
+    void init(bool will_query_ranges) override
+    {
+        ParentNode::init(will_query_ranges);
+        auto keys = std::make_shared<std::vector<ObjKey>>();
+        m_table->scan_key_range(m_begin, m_end, [&](const Obj& obj) {
+            keys->push_back(obj.get_key());
+            return IteratorControl::AdvanceToNext;
+        });
+        m_dD = double(m_table->size() + 1) / (keys->size() + 1);
+        m_dT = 0;
+        m_index_evaluator.init(std::move(keys));
+    }
+
+    bool has_search_index() const override
+    {
+        return true;
+    }
+
+    const IndexEvaluator* index_based_keys() override
+    {
+        return &m_index_evaluator;
+    }
+
+    bool collect_condition_columns_local(std::vector<ColKey>&) const override
+    {
+        return true;
+    }
+
+    size_t find_first_local(size_t start, size_t end) override
+    {
+        return m_index_evaluator.do_search_index(m_cluster, start, end);
+    }
+
+    std::string describe(util::serializer::SerialisationState&) const override
+    {
+        return util::format("KEY RANGE [%1, %2)", m_begin.value, m_end.value);
+    }
+
+    std::unique_ptr<ParentNode> clone() const override
+    {
+        return std::unique_ptr<ParentNode>(new KeyRangeNode(*this));
+    }
+
+private:
+    ObjKey m_begin;
+    ObjKey m_end;
+    IndexEvaluator m_index_evaluator;
+
+    KeyRangeNode(const KeyRangeNode& from)
+        : ParentNode(from)
+        , m_begin(from.m_begin)
+        , m_end(from.m_end)
+    {
+    }
 };
 
 template <class LeafType>
@@ -392,6 +631,15 @@ protected:
         return end;
     }
 
+    // Consult the zone map of the current leaf to see if it can be skipped entirely
+    template <class TConditionFunction>
+    void update_leaf_pruning()
+    {
+        ZoneMap::Synopsis synopsis;
+        m_leaf_pruned = m_table.unchecked_ptr()->get_zone_map().get(*m_leaf, synopsis) &&
+                        !synopsis.template may_match<TConditionFunction>(m_value);
+    }
+
     std::string describe(util::serializer::SerialisationState& state) const override
     {
         return state.describe_column(ParentNode::m_table, ColumnNodeBase::m_condition_column_key) + " " +
@@ -403,6 +651,8 @@ protected:
 
     // Leaf cache
     std::optional<LeafType> m_leaf;
+    // True if the zone map shows that no element of the current leaf can match
+    bool m_leaf_pruned = false;
 };
 
 
@@ -423,13 +673,57 @@ public:
     {
     }
 
+    void init(bool will_query_ranges) override
+    {
+        BaseType::init(will_query_ranges);
+        m_index_evaluator.reset();
+        if constexpr (is_any_v<TConditionFunction, Greater, GreaterEqual, Less, LessEqual>) {
+            auto index = dynamic_cast<const SortedIndex*>(
+                ParentNode::m_table->get_search_index(ParentNode::m_condition_column_key));
+            if (index && will_query_ranges && !Mixed(this->m_value).is_null()) {
+                m_index_evaluator.emplace();
+                if (m_index_evaluator->template init_range<TConditionFunction>(index, Mixed(this->m_value)))
+                    this->m_dT = 0;
+                else
+                    m_index_evaluator.reset();
+            }
+        }
+    }
+
+    bool has_search_index() const override
+    {
+        return bool(m_index_evaluator);
+    }
+
+    const IndexEvaluator* index_based_keys() override
+    {
+        return m_index_evaluator ? &*m_index_evaluator : nullptr;
+    }
+
+    std::optional<double> estimate_selectivity(const ColumnStatistics& stats) const override
+    {
+        return estimate_condition<TConditionFunction>(stats, Mixed(this->m_value));
+    }
+
+    void cluster_changed() override
+    {
+        BaseType::cluster_changed();
+        this->template update_leaf_pruning<TConditionFunction>();
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (m_index_evaluator)
+            return m_index_evaluator->do_search_index(this->m_cluster, start, end);
+        if (this->m_leaf_pruned)
+            return not_found;
         return this->m_leaf->template find_first<TConditionFunction>(this->m_value, start, end);
     }
 
     size_t find_all_local(size_t start, size_t end) override
     {
+        if (this->m_leaf_pruned)
+            return end;
         return BaseType::template find_all_local<TConditionFunction>(start, end);
     }
 
@@ -442,6 +736,10 @@ public:
     {
         return std::unique_ptr<ParentNode>(new ThisType(*this));
     }
+
+private:
+    // Set if a sorted index is used to find the matches
+    std::optional<IndexEvaluator> m_index_evaluator;
 };
 
 template <size_t linear_search_threshold, class LeafType, class NeedleContainer>
@@ -519,12 +817,21 @@ public:
     {
         BaseType::init(will_query_ranges);
         m_nb_needles = m_needles.size();
+        m_index_evaluator.reset();
 
-        if (has_search_index() && m_nb_needles == 0) {
+        if (has_search_index()) {
             SearchIndex* index = ParentNode::m_table->get_search_index(ParentNode::m_condition_column_key);
-            m_index_evaluator = IndexEvaluator();
-            m_index_evaluator->init(index, BaseType::m_value);
-            IntegerNodeBase<LeafType>::m_dT = 0;
+            if (m_nb_needles == 0) {
+                m_index_evaluator = IndexEvaluator();
+                m_index_evaluator->init(index, BaseType::m_value);
+                IntegerNodeBase<LeafType>::m_dT = 0;
+            }
+            else if (use_index_for_needles(m_nb_needles, ParentNode::m_table->size())) {
+                std::vector<Mixed> values(m_needles.begin(), m_needles.end());
+                m_index_evaluator = IndexEvaluator();
+                m_index_evaluator->init(index, values);
+                IntegerNodeBase<LeafType>::m_dT = 0;
+            }
         }
     }
 
@@ -557,18 +864,48 @@ public:
         return m_index_evaluator ? &(*m_index_evaluator) : nullptr;
     }
 
+    std::optional<Mixed> get_equality_value() const override
+    {
+        if (!m_needles.empty())
+            return {};
+        if constexpr (std::is_same_v<TConditionValue, std::optional<int64_t>>) {
+            return this->m_value ? Mixed(*this->m_value) : Mixed();
+        }
+        else {
+            return Mixed(this->m_value);
+        }
+    }
+
+    std::optional<double> estimate_selectivity(const ColumnStatistics& stats) const override
+    {
+        if (m_needles.empty())
+            return stats.estimate_equal(*get_equality_value());
+        return estimate_needles(stats, m_needles, [](const TConditionValue& needle) {
+            return Mixed(needle);
+        });
+    }
+
+    void cluster_changed() override
+    {
+        BaseType::cluster_changed();
+        this->m_leaf_pruned = false;
+        if (!m_nb_needles && !m_index_evaluator) {
+            this->template update_leaf_pruning<Equal>();
+        }
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
         REALM_ASSERT(this->m_table);
         size_t s = realm::npos;
 
-        if (start < end) {
-            if (m_nb_needles) {
-                s = find_first_haystack<22>(*this->m_leaf, m_needles, start, end);
-            }
-            else if (m_index_evaluator) {
+        if (start < end && !this->m_leaf_pruned) {
+            if (m_index_evaluator) {
                 return m_index_evaluator->do_search_index(BaseType::m_cluster, start, end);
             }
+            else if (m_nb_needles) {
+                s = find_first_haystack<22>(*this->m_leaf, m_needles, start, end);
+            }
             else if (end - start == 1) {
                 if (this->m_leaf->get(start) == this->m_value) {
                     s = start;
@@ -587,6 +924,8 @@ public:
         if (m_nb_needles) {
             return find_all_haystack<22>(*this->m_leaf, m_needles, start, end, ParentNode::m_state);
         }
+        if (this->m_leaf_pruned)
+            return end;
         return BaseType::template find_all_local<Equal>(start, end);
     }
 
@@ -677,6 +1016,11 @@ public:
             return find(false);
     }
 
+    std::optional<double> estimate_selectivity(const ColumnStatistics& stats) const override
+    {
+        return estimate_condition<TConditionFunction>(stats, null::is_null_float(m_value) ? Mixed() : Mixed(m_value));
+    }
+
     std::string describe(util::serializer::SerialisationState& state) const override
     {
         REALM_ASSERT(m_condition_column_key);
@@ -922,6 +1266,19 @@ public:
         return bool(m_index_evaluator);
     }
 
+    std::optional<Mixed> get_equality_value() const override
+    {
+        if constexpr (std::is_same_v<TConditionFunction, Equal>) {
+            return m_value ? Mixed(*m_value) : Mixed();
+        }
+        return {};
+    }
+
+    std::optional<double> estimate_selectivity(const ColumnStatistics& stats) const override
+    {
+        return estimate_condition<TConditionFunction>(stats, m_value ? Mixed(*m_value) : Mixed());
+    }
+
     void cluster_changed() override
     {
         m_leaf.emplace(m_table.unchecked_ptr()->get_alloc());
@@ -1014,6 +1371,18 @@ public:
                 this->m_dT = 0;
             }
         }
+        else if constexpr (is_any_v<TConditionFunction, Greater, GreaterEqual, Less, LessEqual>) {
+            m_index_evaluator.reset();
+            auto index = dynamic_cast<const SortedIndex*>(
+                TimestampNodeBase::m_table->get_search_index(TimestampNodeBase::m_condition_column_key));
+            if (index && will_query_ranges && !m_value.is_null()) {
+                m_index_evaluator.emplace();
+                if (m_index_evaluator->template init_range<TConditionFunction>(index, m_value))
+                    this->m_dT = 0;
+                else
+                    m_index_evaluator.reset();
+            }
+        }
     }
 
     void table_changed() override
@@ -1025,6 +1394,12 @@ public:
         }
     }
 
+    void cluster_changed() override
+    {
+        TimestampNodeBase::cluster_changed();
+        update_leaf_pruning();
+    }
+
     const IndexEvaluator* index_based_keys() override
     {
         return m_index_evaluator ? &*m_index_evaluator : nullptr;
@@ -1035,13 +1410,28 @@ public:
         return bool(m_index_evaluator);
     }
 
-    size_t find_first_local(size_t start, size_t end) override
+    std::optional<Mixed> get_equality_value() const override
     {
         if constexpr (std::is_same_v<TConditionFunction, Equal>) {
-            if (m_index_evaluator) {
-                return m_index_evaluator->do_search_index(this->m_cluster, start, end);
-            }
+            return Mixed(m_value);
         }
+        return {};
+    }
+
+    std::optional<double> estimate_selectivity(const ColumnStatistics& stats) const override
+    {
+        return estimate_condition<TConditionFunction>(stats, Mixed(m_value));
+    }
+
+    size_t find_first_local(size_t start, size_t end) override
+    {
+        if (m_index_evaluator) {
+            return m_index_evaluator->do_search_index(this->m_cluster, start, end);
+        }
+        if (m_leaf_pruned)
+            return not_found;
+        if (m_leaf_covered)
+            return start < end ? start : not_found;
         return m_leaf->find_first<TConditionFunction>(m_value, start, end);
     }
 
@@ -1059,6 +1449,38 @@ public:
 
 protected:
     std::optional<IndexEvaluator> m_index_evaluator;
+
+private:
+    // True if the zone map shows that no element of the current leaf can match
+    bool m_leaf_pruned = false;
+    // True if the zone map shows that every element of the current leaf matches
+    bool m_leaf_covered = false;
+
+    // The synopsis of a timestamp leaf only covers the seconds, so a leaf is
+    // only skipped or taken as a whole when the seconds alone decide the
+    // condition for all of its elements
+    void update_leaf_pruning()
+    {
+        m_leaf_pruned = m_leaf_covered = false;
+        ZoneMap::Synopsis synopsis;
+        if (m_index_evaluator || !m_table.unchecked_ptr()->get_zone_map().get(*m_leaf, synopsis))
+            return;
+        std::optional<int64_t> seconds;
+        if (!m_value.is_null())
+            seconds = m_value.get_seconds();
+        const bool no_nulls = synopsis.null_count == 0;
+        if constexpr (std::is_same_v<TConditionFunction, Equal>) {
+            m_leaf_pruned = !synopsis.may_match<Equal>(seconds);
+        }
+        else if constexpr (is_any_v<TConditionFunction, Greater, GreaterEqual>) {
+            m_leaf_pruned = seconds && !synopsis.may_match<GreaterEqual>(seconds);
+            m_leaf_covered = seconds && no_nulls && synopsis.size > 0 && synopsis.min > *seconds;
+        }
+        else if constexpr (is_any_v<TConditionFunction, Less, LessEqual>) {
+            m_leaf_pruned = seconds && !synopsis.may_match<LessEqual>(seconds);
+            m_leaf_covered = seconds && no_nulls && synopsis.size > 0 && synopsis.max < *seconds;
+        }
+    }
 };
 
 class DecimalNodeBase : public ParentNode {
@@ -1206,6 +1628,12 @@ public:
                                       : util::serializer::print_value(this->m_value));
     }
 
+    std::optional<double> estimate_selectivity(const ColumnStatistics& stats) const override
+    {
+        return estimate_condition<TConditionFunction>(stats,
+                                                      this->m_value_is_null ? Mixed() : Mixed(this->m_value));
+    }
+
     std::unique_ptr<ParentNode> clone() const override
     {
         return std::unique_ptr<ParentNode>(new FixedBytesNode(*this));
@@ -1246,18 +1674,28 @@ public:
         if (!this->m_value_is_null) {
             m_optional_value = this->m_value;
         }
-        if (m_index_evaluator && m_nb_needles == 0) {
+        m_index_evaluator.reset();
+        if (m_has_index) {
             SearchIndex* index = BaseType::m_table->get_search_index(BaseType::m_condition_column_key);
-            m_index_evaluator->init(index, m_optional_value);
-            this->m_dT = 0;
+            if (m_nb_needles == 0) {
+                m_index_evaluator = IndexEvaluator();
+                m_index_evaluator->init(index, m_optional_value);
+                this->m_dT = 0;
+            }
+            else if (use_index_for_needles(m_nb_needles, BaseType::m_table->size())) {
+                std::vector<Mixed> values;
+                for (auto& needle : m_needles)
+                    values.push_back(needle ? Mixed(*needle) : Mixed());
+                m_index_evaluator = IndexEvaluator();
+                m_index_evaluator->init(index, values);
+                this->m_dT = 0;
+            }
         }
     }
 
     void table_changed() override
     {
-        const bool has_index =
-            this->m_table->search_index_type(BaseType::m_condition_column_key) == IndexType::General;
-        m_index_evaluator = has_index ? std::make_optional(IndexEvaluator{}) : std::nullopt;
+        m_has_index = this->m_table->search_index_type(BaseType::m_condition_column_key) == IndexType::General;
     }
 
     const IndexEvaluator* index_based_keys() override
@@ -1267,7 +1705,23 @@ public:
 
     bool has_search_index() const override
     {
-        return bool(m_index_evaluator);
+        return m_has_index;
+    }
+
+    std::optional<Mixed> get_equality_value() const override
+    {
+        if (!m_needles.empty())
+            return {};
+        return this->m_value_is_null ? Mixed() : Mixed(this->m_value);
+    }
+
+    std::optional<double> estimate_selectivity(const ColumnStatistics& stats) const override
+    {
+        if (m_needles.empty())
+            return stats.estimate_equal(*get_equality_value());
+        return estimate_needles(stats, m_needles, [](const std::optional<ObjectType>& needle) {
+            return needle ? Mixed(*needle) : Mixed();
+        });
     }
 
     size_t find_first_local(size_t start, size_t end) override
@@ -1276,12 +1730,12 @@ public:
         size_t s = realm::npos;
 
         if (start < end) {
-            if (m_nb_needles) {
-                return find_first_haystack<22>(*this->m_leaf, m_needles, start, end);
-            }
             if (m_index_evaluator) {
                 return m_index_evaluator->do_search_index(this->m_cluster, start, end);
             }
+            if (m_nb_needles) {
+                return find_first_haystack<22>(*this->m_leaf, m_needles, start, end);
+            }
 
             if (end - start == 1) {
                 if (this->m_leaf->get(start) == m_optional_value) {
@@ -1343,6 +1797,7 @@ protected:
     std::optional<IndexEvaluator> m_index_evaluator;
     std::unordered_set<std::optional<ObjectType>> m_needles;
     size_t m_nb_needles = 0;
+    bool m_has_index = false;
 };
 
 
@@ -1436,6 +1891,18 @@ public:
     size_t find_first_local(size_t start, size_t end) override
     {
         TConditionFunction cond;
+        if constexpr (realm::is_any_v<TConditionFunction, NotEqual, Greater, GreaterEqual, Less, LessEqual>) {
+            if (m_value.is_type(type_Int)) {
+                // Integer elements are compared as integers, anything else as Mixed
+                int64_t value = m_value.get_int();
+                for (size_t i = start; i < end; i++) {
+                    int64_t v;
+                    if (m_leaf->get_int(i, v) ? cond(v, value) : cond(QueryValue(m_leaf->get(i)), m_value))
+                        return i;
+                }
+                return realm::npos;
+            }
+        }
         for (size_t i = start; i < end; i++) {
             QueryValue val(m_leaf->get(i));
             if constexpr (realm::is_any_v<TConditionFunction, BeginsWith, BeginsWithIns, EndsWith, EndsWithIns, Like,
@@ -1675,10 +2142,54 @@ public:
     {
         StringNodeBase::init(will_query_ranges);
         clear_leaf_state();
+        m_index_evaluator.reset();
+        if constexpr (std::is_same_v<TConditionFunction, BeginsWithIns>) {
+            // The strings starting with the prefix are adjacent in a case
+            // insensitive index
+            auto index = dynamic_cast<const SortedIndex*>(m_table->get_search_index(m_condition_column_key));
+            if (index && index->is_case_insensitive() && m_string_value.size() != 0) {
+                auto [begin, end] = index->find_prefix_range(m_string_value);
+                auto keys = std::make_shared<std::vector<ObjKey>>();
+                TConditionFunction cond;
+                for (size_t i = begin; i < end; ++i) {
+                    if (cond(m_string_value, m_ucase.c_str(), m_lcase.c_str(), index->get_value(i).get_string()))
+                        keys->push_back(index->get(i));
+                }
+                std::sort(keys->begin(), keys->end());
+                m_index_evaluator.emplace();
+                m_index_evaluator->init(std::move(keys));
+                m_dT = 0;
+            }
+        }
+        if constexpr (std::is_same_v<TConditionFunction, BeginsWith>) {
+            // The keys of a string index are the leading bytes of the strings
+            auto index = dynamic_cast<const StringIndex*>(m_table->get_search_index(m_condition_column_key));
+            if (index && !index->is_fulltext_index() && m_value && m_string_value.size() != 0) {
+                auto keys = std::make_shared<std::vector<ObjKey>>();
+                index->find_all_prefix(*keys, m_string_value);
+                std::sort(keys->begin(), keys->end());
+                m_index_evaluator.emplace();
+                m_index_evaluator->init(std::move(keys));
+                m_dT = 0;
+            }
+        }
+    }
+
+    bool has_search_index() const override
+    {
+        return bool(m_index_evaluator);
+    }
+
+    const IndexEvaluator* index_based_keys() override
+    {
+        return m_index_evaluator ? &*m_index_evaluator : nullptr;
     }
 
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (m_index_evaluator)
+            return m_index_evaluator->do_search_index(m_cluster, start, end);
+
         TConditionFunction cond;
 
         for (size_t s = start; s < end; ++s) {
@@ -1702,6 +2213,11 @@ public:
         return TConditionFunction::description();
     }
 
+    std::optional<double> estimate_selectivity(const ColumnStatistics& stats) const override
+    {
+        return estimate_condition<TConditionFunction>(stats, Mixed(m_string_value));
+    }
+
     std::unique_ptr<ParentNode> clone() const override
     {
         return std::unique_ptr<ParentNode>(new StringNode<TConditionFunction>(*this));
@@ -1717,29 +2233,21 @@ public:
 protected:
     std::string m_ucase;
     std::string m_lcase;
+    // Set if a case insensitive index is used to find the matches
+    std::optional<IndexEvaluator> m_index_evaluator;
 };
 
-// Specialization for Contains condition on Strings - we specialize because we can utilize Boyer-Moore
+// Specialization for Contains condition on Strings - the substring search
+// (see search_substring()) is vectorized, which makes this cheaper than the
+// generic string node
 template <>
 class StringNode<Contains> : public StringNodeBase {
 public:
     StringNode(StringData v, ColKey column)
         : StringNodeBase(v, column)
-        , m_charmap()
     {
         if (v.size() == 0)
             return;
-
-        // Build a dictionary of char-to-last distances in the search string
-        // (zero indicates that the char is not in needle)
-        size_t last_char_pos = v.size() - 1;
-        for (size_t i = 0; i < last_char_pos; ++i) {
-            // we never jump longer increments than 255 chars, even if needle is longer (to fit in one byte)
-            uint8_t jump = last_char_pos - i < 255 ? static_cast<uint8_t>(last_char_pos - i) : 255;
-
-            unsigned char c = v[i];
-            m_charmap[c] = jump;
-        }
         m_dT = 50.0;
     }
 
@@ -1757,7 +2265,7 @@ public:
         for (size_t s = start; s < end; ++s) {
             StringData t = get_string(s);
 
-            if (cond(m_string_value, m_charmap, t))
+            if (cond(m_string_value, t))
                 return s;
         }
         return not_found;
@@ -1776,21 +2284,18 @@ public:
 
     StringNode(const StringNode& from)
         : StringNodeBase(from)
-        , m_charmap(from.m_charmap)
     {
     }
-
-protected:
-    std::array<uint8_t, 256> m_charmap;
 };
 
-// Specialization for ContainsIns condition on Strings - we specialize because we can utilize Boyer-Moore
+// Specialization for ContainsIns condition on Strings - we specialize to keep
+// the upper and lower case needle, which search_case_fold() scans for in both
+// cases at once
 template <>
 class StringNode<ContainsIns> : public StringNodeBase {
 public:
     StringNode(StringData v, ColKey column)
         : StringNodeBase(v, column)
-        , m_charmap()
     {
         auto upper = case_map(v, true);
         auto lower = case_map(v, false);
@@ -1804,19 +2309,6 @@ public:
 
         if (v.size() == 0)
             return;
-
-        // Build a dictionary of char-to-last distances in the search string
-        // (zero indicates that the char is not in needle)
-        size_t last_char_pos = m_ucase.size() - 1;
-        for (size_t i = 0; i < last_char_pos; ++i) {
-            // we never jump longer increments than 255 chars, even if needle is longer (to fit in one byte)
-            uint8_t jump = last_char_pos - i < 255 ? static_cast<uint8_t>(last_char_pos - i) : 255;
-
-            unsigned char uc = m_ucase[i];
-            unsigned char lc = m_lcase[i];
-            m_charmap[uc] = jump;
-            m_charmap[lc] = jump;
-        }
         m_dT = 75.0;
     }
 
@@ -1838,7 +2330,7 @@ public:
             if (!bool(m_value)) {
                 return s;
             }
-            if (cond(m_string_value, m_ucase.c_str(), m_lcase.c_str(), m_charmap, t))
+            if (cond(m_string_value, m_ucase.c_str(), m_lcase.c_str(), t))
                 return s;
         }
         return not_found;
@@ -1856,14 +2348,12 @@ public:
 
     StringNode(const StringNode& from)
         : StringNodeBase(from)
-        , m_charmap(from.m_charmap)
         , m_ucase(from.m_ucase)
         , m_lcase(from.m_lcase)
     {
     }
 
 protected:
-    std::array<uint8_t, 256> m_charmap;
     std::string m_ucase;
     std::string m_lcase;
 };
@@ -1942,8 +2432,35 @@ public:
 
     void _search_index_init() override;
 
+    void init(bool will_query_ranges) override;
+
+    void cluster_changed() override
+    {
+        StringNodeEqualBase::cluster_changed();
+        // The keys of an enumerated column are shared by all leaves, so the
+        // arguments are translated to key indexes once per query run
+        if (m_leaf && m_leaf->is_enumerated() && !m_enum_resolved)
+            resolve_enum_indexes();
+    }
+
     bool do_consume_condition(ParentNode& other) override;
 
+    std::optional<Mixed> get_equality_value() const override
+    {
+        if (!m_needles.empty())
+            return {};
+        return Mixed(m_string_value);
+    }
+
+    std::optional<double> estimate_selectivity(const ColumnStatistics& stats) const override
+    {
+        if (m_needles.empty())
+            return stats.estimate_equal(Mixed(m_string_value));
+        return estimate_needles(stats, m_needles, [](StringData needle) {
+            return Mixed(needle);
+        });
+    }
+
     std::unique_ptr<ParentNode> clone() const override
     {
         return std::unique_ptr<ParentNode>(new StringNode<Equal>(*this));
@@ -1968,8 +2485,14 @@ public:
 
 private:
     size_t _find_first_local(size_t start, size_t end) override;
+    void resolve_enum_indexes();
     std::unordered_set<StringData> m_needles;
     std::vector<std::unique_ptr<char[]>> m_needle_storage;
+
+    // Only used when the column is enumerated
+    bool m_enum_resolved = false;
+    size_t m_enum_index = realm::not_found;
+    std::vector<bool> m_enum_needles;
 };
 
 
@@ -1992,6 +2515,15 @@ public:
         }
     }
 
+    void table_changed() override
+    {
+        StringNodeEqualBase::table_changed();
+        // Strings equal regardless of case are adjacent in a case insensitive
+        // index
+        if (m_table.unchecked_ptr()->search_index_type(m_condition_column_key) == IndexType::CaseInsensitive)
+            m_index_evaluator.emplace();
+    }
+
     void _search_index_init() override;
 
     std::string describe_condition() const override
@@ -2033,6 +2565,8 @@ public:
         return true; // it's a required precondition for fulltext queries
     }
 
+    bool collect_condition_columns_local(std::vector<ColKey>& columns) const override;
+
     std::unique_ptr<ParentNode> clone() const override
     {
         return std::unique_ptr<ParentNode>(new StringNodeFulltext(*this));
@@ -2125,10 +2659,24 @@ public:
         }
     }
 
+    bool follows_links_local() const override
+    {
+        return std::any_of(m_conditions.begin(), m_conditions.end(), [](auto& cond) {
+            return cond->follows_links();
+        });
+    }
+
+    bool collect_condition_columns_local(std::vector<ColKey>& columns) const override
+    {
+        return std::all_of(m_conditions.begin(), m_conditions.end(), [&](auto& cond) {
+            return cond->get_condition_columns(columns);
+        });
+    }
+
     void init(bool will_query_ranges) override
     {
         ParentNode::init(will_query_ranges);
-        combine_conditions(!will_query_ranges);
+        combine_conditions();
 
         m_start.clear();
         m_start.resize(m_conditions.size(), 0);
@@ -2145,6 +2693,13 @@ public:
             v.clear();
             condition->gather_children(v);
         }
+        m_dT = 50.0;
+        union_index_based_keys();
+    }
+
+    const IndexEvaluator* index_based_keys() override
+    {
+        return m_index_evaluator ? &(*m_index_evaluator) : nullptr;
     }
 
     size_t find_first_local(size_t start, size_t end) override
@@ -2152,6 +2707,9 @@ public:
         if (start >= end)
             return not_found;
 
+        if (m_index_evaluator)
+            return m_index_evaluator->do_search_index(m_cluster, start, end);
+
         size_t index = not_found;
 
         for (size_t c = 0; c < m_conditions.size(); ++c) {
@@ -2219,69 +2777,66 @@ private:
         std::type_index m_type;
         bool operator<(const ConditionType& other) const
         {
-            return this->m_col < other.m_col && this->m_type < other.m_type;
-        }
-        bool operator!=(const ConditionType& other) const
-        {
-            return this->m_col != other.m_col || this->m_type != other.m_type;
+            return this->m_col < other.m_col || (this->m_col == other.m_col && this->m_type < other.m_type);
         }
     };
 
-    void combine_conditions(bool ignore_indexes)
+    void combine_conditions()
     {
         // Although ColKey is not unique per table, it is not important to consider
         // the table when sorting here because ParentNode::m_condition_column_key
         // is only a valid ColKey when the node has a direct condition on a column
         // of the table this query is running on. Any link query nodes use a special
         // LinkChain state to store the column path.
-        std::sort(m_conditions.begin(), m_conditions.end(), [](auto& a, auto& b) {
+        std::stable_sort(m_conditions.begin(), m_conditions.end(), [](auto& a, auto& b) {
             return ConditionType(*a) < ConditionType(*b);
         });
 
-        bool compute_condition_counts = num_conditions_may_need_combination_counts(m_conditions.size());
-        util::FlatMap<ConditionType, size_t> condition_type_counts;
-        if (compute_condition_counts) {
-            for (auto it = m_conditions.begin(); it != m_conditions.end();) {
-                // no need to try to combine anything other than simple nodes that
-                // filter directly on a top-level column since the only nodes that
-                // support combinations are string/int/uuid/oid <Equal> types
-                if (!(*it)->m_condition_column_key) {
-                    ++it;
-                    continue;
-                }
-                ConditionType cur_type(*(*it));
-                auto next = std::upper_bound(it, m_conditions.end(), cur_type,
-                                             [](const ConditionType& a, const std::unique_ptr<ParentNode>& b) {
-                                                 return a < ConditionType(*b);
-                                             });
-                condition_type_counts[cur_type] = next - it;
-                it = next;
-            }
-        }
-
         ParentNode* prev = m_conditions.begin()->get();
-        std::optional<size_t> cur_type_count;
-        if (compute_condition_counts) {
-            cur_type_count = condition_type_counts[ConditionType{*prev}];
-        }
         auto cond = [&](auto& node) {
-            if (prev->consume_condition(*node, ignore_indexes, cur_type_count))
+            if (prev->consume_condition(*node))
                 return true;
             prev = &*node;
-            if (compute_condition_counts) {
-                cur_type_count = condition_type_counts[ConditionType{*prev}];
-            }
             return false;
         };
         m_conditions.erase(std::remove_if(m_conditions.begin() + 1, m_conditions.end(), cond), m_conditions.end());
     }
 
+    // Merge the keys found through the search indexes of the conditions, if
+    // all of them have one, so that the objects matching any of them are
+    // visited without scanning the table
+    void union_index_based_keys()
+    {
+        m_index_evaluator.reset();
+        size_t num_keys = 0;
+        for (auto& condition : m_conditions) {
+            auto keys = condition->m_child ? nullptr : condition->index_based_keys();
+            if (!keys)
+                return;
+            num_keys += keys->size();
+        }
+
+        auto keys = std::make_shared<std::vector<ObjKey>>();
+        keys->reserve(num_keys);
+        for (auto& condition : m_conditions) {
+            auto condition_keys = condition->index_based_keys();
+            for (size_t i = 0, n = condition_keys->size(); i < n; ++i)
+                keys->push_back(condition_keys->get(i));
+        }
+        std::sort(keys->begin(), keys->end());
+        keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
+        m_index_evaluator = IndexEvaluator();
+        m_index_evaluator->init(std::move(keys));
+        m_dT = 0;
+    }
+
     // start index of the last find for each cond
     std::vector<size_t> m_start;
     // last looked at index of the last find for each cond
     // is a matching index if m_was_match is true
     std::vector<size_t> m_last;
     std::vector<bool> m_was_match;
+    std::optional<IndexEvaluator> m_index_evaluator;
 };
 
 
@@ -2337,6 +2892,16 @@ public:
         }
     }
 
+    bool follows_links_local() const override
+    {
+        return m_condition && m_condition->follows_links();
+    }
+
+    bool collect_condition_columns_local(std::vector<ColKey>& columns) const override
+    {
+        return m_condition && m_condition->get_condition_columns(columns);
+    }
+
     std::unique_ptr<ParentNode> clone() const override
     {
         return std::unique_ptr<ParentNode>(new NotNode(*this));
@@ -2394,6 +2959,13 @@ public:
         }
     }
 
+    bool collect_condition_columns_local(std::vector<ColKey>& columns) const override
+    {
+        columns.push_back(m_condition_column_key1);
+        columns.push_back(m_condition_column_key2);
+        return true;
+    }
+
     static std::unique_ptr<ArrayPayload> update_cached_leaf_pointers_for_column(Allocator& alloc,
                                                                                 const ColKey& col_key);
     void cluster_changed() override
@@ -2473,11 +3045,22 @@ public:
     void table_changed() override;
     void cluster_changed() override;
     void collect_dependencies(std::vector<TableKey>&) const override;
+    // Expressions may follow links, even to the table itself, which cannot
+    // be told from their dependencies
+    bool follows_links_local() const override
+    {
+        return true;
+    }
 
     std::string describe(util::serializer::SerialisationState& state) const override;
 
     std::unique_ptr<ParentNode> clone() const override;
 
+    const Expression& get_expression() const noexcept
+    {
+        return *m_expression;
+    }
+
 private:
     ExpressionNode(const ExpressionNode& from);
 
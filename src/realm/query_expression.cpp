@@ -19,6 +19,7 @@
 #include <realm/query_expression.hpp>
 #include <realm/group.hpp>
 #include <realm/dictionary.hpp>
+#include <realm/table_view.hpp>
 
 namespace realm {
 
@@ -31,6 +32,7 @@ void LinkMap::set_base_table(ConstTableRef table)
     m_tables.push_back(table);
     m_link_types.clear();
     m_only_unary_links = true;
+    m_resolve_by_cluster = m_link_column_keys.size() > 1;
 
     for (size_t i = 0; i < m_link_column_keys.size(); i++) {
         ColKey link_column_key = m_link_column_keys[i];
@@ -40,6 +42,9 @@ void LinkMap::set_base_table(ConstTableRef table)
         if (type == col_type_BackLink || (type == col_type_Link && link_column_key.is_collection())) {
             m_only_unary_links = false;
         }
+        if (type != col_type_Link || link_column_key.is_collection()) {
+            m_resolve_by_cluster = false;
+        }
 
         m_link_types.push_back(type);
         REALM_ASSERT(table->valid_column(link_column_key));
@@ -221,6 +226,71 @@ void LinkMap::map_links(size_t column, size_t row, LinkMapFunction lm) const
     }
 }
 
+void LinkMap::resolve_targets() const
+{
+    auto& leaf = mpark::get<ArrayKey>(m_leaf);
+    size_t sz = leaf.size();
+    m_targets.resize(sz);
+    for (size_t row = 0; row < sz; row++) {
+        m_targets[row] = leaf.get(row);
+    }
+
+    // Sorting the keys of each hop lets consecutive keys be read from the same cluster
+    std::vector<std::pair<ObjKey, size_t>> keys;
+    for (size_t column = 1; column < m_link_column_keys.size(); column++) {
+        keys.clear();
+        for (size_t row = 0; row < sz; row++) {
+            ObjKey key = m_targets[row];
+            if (key && !key.is_unresolved()) {
+                keys.emplace_back(key, row);
+            }
+            m_targets[row] = ObjKey();
+        }
+        std::sort(keys.begin(), keys.end());
+
+        const ClusterTree& tree = m_tables[column].unchecked_ptr()->m_clusters;
+        Cluster cluster(0, tree.get_alloc(), tree);
+        ClusterNode::IteratorState state(cluster);
+        ArrayKey links(tree.get_alloc());
+        ObjKey last_key_in_cluster;
+        for (auto& [key, row] : keys) {
+            size_t ndx;
+            if (last_key_in_cluster && key <= last_key_in_cluster) {
+                ndx = cluster.lower_bound_key(ObjKey(key.value - cluster.get_offset()));
+            }
+            else {
+                if (!tree.get_leaf(key, state)) {
+                    break;
+                }
+                cluster.init_leaf(m_link_column_keys[column], &links);
+                last_key_in_cluster = cluster.get_real_key(cluster.node_size() - 1);
+                ndx = state.m_current_index;
+            }
+            if (cluster.get_real_key(ndx) == key) {
+                m_targets[row] = links.get(ndx);
+            }
+        }
+    }
+
+    for (auto& key : m_targets) {
+        if (key.is_unresolved()) {
+            key = ObjKey();
+        }
+    }
+    m_targets_resolved = true;
+}
+
+void SubQueryCount::count_links_from_matches()
+{
+    m_counts.clear();
+    TableView matches = m_query.find_all();
+    for (size_t i = 0; i < matches.size(); i++) {
+        for (auto origin : m_link_map.get_origin_objkeys(matches.get_key(i))) {
+            ++m_counts[origin.value];
+        }
+    }
+}
+
 std::vector<ObjKey> LinkMap::get_origin_objkeys(ObjKey key, size_t column) const
 {
     if (column == m_link_types.size()) {
@@ -263,6 +333,32 @@ std::vector<ObjKey> LinkMap::get_origin_objkeys(ObjKey key, size_t column) const
     return ret;
 }
 
+#if REALM_ENABLE_GEOSPATIAL
+std::shared_ptr<std::vector<ObjKey>> GeoWithinCompare::get_index_candidates() const
+{
+    // An object linking to no points matches 'NONE' while the index has no
+    // entries for it.
+    if (m_comp_type.value_or(ExpressionComparisonType::Any) == ExpressionComparisonType::None)
+        return {};
+    const GeoIndex* index = m_link_map.get_target_table()->get_geospatial_index();
+    if (!index || !m_link_map.links_exist())
+        return {};
+
+    std::vector<ObjKey> points;
+    for (auto& [first, last] : m_region.get_covering(s_max_covering_cells)) {
+        index->find_range(first, last, points);
+    }
+    auto keys = std::make_shared<std::vector<ObjKey>>();
+    for (auto key : points) {
+        auto origin_keys = m_link_map.get_origin_objkeys(key);
+        keys->insert(keys->end(), origin_keys.begin(), origin_keys.end());
+    }
+    std::sort(keys->begin(), keys->end());
+    keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
+    return keys;
+}
+#endif
+
 ColumnDictionaryKeys Columns<Dictionary>::keys()
 {
     return ColumnDictionaryKeys(*this);
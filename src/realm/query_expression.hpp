@@ -154,6 +154,7 @@ The Columns class encapsulates all this into a simple class that, for any type T
 #include <external/mpark/variant.hpp>
 
 #include <numeric>
+#include <unordered_map>
 #include <algorithm>
 
 // Normally, if a next-generation-syntax condition is supported by the old query_engine.hpp, a query_engine node is
@@ -177,6 +178,11 @@ struct Plus {
     {
         return v1 + v2;
     }
+    template <class T>
+    T operator()(T v1, T v2) const
+    {
+        return v1 + v2;
+    }
     static std::string description()
     {
         return "+";
@@ -188,6 +194,11 @@ struct Minus {
     {
         return v1 - v2;
     }
+    template <class T>
+    T operator()(T v1, T v2) const
+    {
+        return v1 - v2;
+    }
     static std::string description()
     {
         return "-";
@@ -199,6 +210,16 @@ struct Div {
     {
         return v1 / v2;
     }
+    template <class T>
+    T operator()(T v1, T v2) const
+    {
+        if constexpr (std::is_integral_v<T>) {
+            // Same as for Mixed: no match rather than an exception
+            if (v2 == 0)
+                return v1 < 0 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+        }
+        return v1 / v2;
+    }
     static std::string description()
     {
         return "/";
@@ -210,6 +231,11 @@ struct Mul {
     {
         return v1 * v2;
     }
+    template <class T>
+    T operator()(T v1, T v2) const
+    {
+        return v1 * v2;
+    }
     static std::string description()
     {
         return "*";
@@ -643,6 +669,220 @@ private:
     }
 };
 
+// The values of a numeric expression for a range of rows of the current cluster, as produced by
+// Subexpr::evaluate_batch(). Unlike ValueBase, which holds a QueryValue per row, the values are stored unboxed in
+// an array of a single type (Int, Float or Double), so that arithmetic and comparisons are tight loops over the
+// whole range rather than a virtual call and a Mixed operation per row.
+class ValueBatch {
+public:
+    // compare() returns one bit per row
+    static constexpr size_t max_size = std::numeric_limits<size_t>::digits;
+
+    DataType get_type() const noexcept
+    {
+        return m_type;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool is_null(size_t ndx) const noexcept
+    {
+        return m_has_nulls && m_nulls[ndx];
+    }
+
+    QueryValue get(size_t ndx) const noexcept
+    {
+        QueryValue value;
+        if (!is_null(ndx)) {
+            visit([&](auto tag) {
+                value = QueryValue(values<decltype(tag)>()[ndx]);
+            });
+        }
+        return value;
+    }
+
+    template <class T>
+    T* values() noexcept
+    {
+        if constexpr (std::is_same_v<T, int64_t>)
+            return m_ints;
+        else if constexpr (std::is_same_v<T, float>)
+            return m_floats;
+        else
+            return m_doubles;
+    }
+
+    template <class T>
+    const T* values() const noexcept
+    {
+        return const_cast<ValueBatch*>(this)->values<T>();
+    }
+
+    // Prepare for `size` values of type T, which are not null until set_null() is called
+    template <class T>
+    T* init(size_t size) noexcept
+    {
+        REALM_ASSERT_DEBUG(size <= max_size);
+        if constexpr (std::is_same_v<T, int64_t>)
+            m_type = type_Int;
+        else if constexpr (std::is_same_v<T, float>)
+            m_type = type_Float;
+        else
+            m_type = type_Double;
+        m_size = size;
+        m_has_nulls = false;
+        return values<T>();
+    }
+
+    void set_null(size_t ndx) noexcept
+    {
+        if (!m_has_nulls) {
+            std::fill(m_nulls, m_nulls + m_size, false);
+            m_has_nulls = true;
+        }
+        m_nulls[ndx] = true;
+    }
+
+    // Set all `size` values to `value`, which must be a non-null Int, Float or Double
+    void fill(Mixed value, size_t size) noexcept
+    {
+        switch (value.get_type()) {
+            case type_Int:
+                std::fill_n(init<int64_t>(size), size, value.get_int());
+                break;
+            case type_Float:
+                std::fill_n(init<float>(size), size, value.get_float());
+                break;
+            case type_Double:
+                std::fill_n(init<double>(size), size, value.get_double());
+                break;
+            default:
+                REALM_UNREACHABLE();
+        }
+    }
+
+    // Set this to TOperator applied to each pair of values of `left` and `right`. As for Mixed, the operation is
+    // done in the wider of the two types, and the result is null if either value is null.
+    template <class TOperator>
+    void fun(const ValueBatch& left, const ValueBatch& right)
+    {
+        REALM_ASSERT_DEBUG(left.size() == right.size());
+        const size_t sz = left.size();
+        left.visit([&](auto left_tag) {
+            right.visit([&](auto right_tag) {
+                using L = decltype(left_tag);
+                using R = decltype(right_tag);
+                using T = std::conditional_t<realm::is_any_v<double, L, R>, double,
+                                             std::conditional_t<realm::is_any_v<float, L, R>, float, int64_t>>;
+                const L* a = left.values<L>();
+                const R* b = right.values<R>();
+                T* res = init<T>(sz);
+                TOperator o;
+                for (size_t i = 0; i < sz; i++)
+                    res[i] = o(T(a[i]), T(b[i]));
+                if constexpr (!std::is_same_v<T, int64_t>) {
+                    // A result which happens to be the null float is null when boxed in a Mixed
+                    for (size_t i = 0; i < sz; i++) {
+                        if (null::is_null_float(res[i]))
+                            set_null(i);
+                    }
+                }
+            });
+        });
+        if (left.m_has_nulls || right.m_has_nulls) {
+            for (size_t i = 0; i < sz; i++) {
+                if (left.is_null(i) || right.is_null(i))
+                    set_null(i);
+            }
+        }
+    }
+
+    // Return a mask with a bit set for each row where the values of `left` and `right` satisfy TCond, which must
+    // be one of ==, !=, >, <, >= and <=. The result is the same as when comparing them as Mixed.
+    template <class TCond>
+    static size_t compare(const ValueBatch& left, const ValueBatch& right)
+    {
+        REALM_ASSERT_DEBUG(left.size() == right.size());
+        const size_t sz = left.size();
+        size_t matches = 0;
+        left.visit([&](auto left_tag) {
+            right.visit([&](auto right_tag) {
+                const auto* a = left.values<decltype(left_tag)>();
+                const auto* b = right.values<decltype(right_tag)>();
+                TCond c;
+                for (size_t i = 0; i < sz; i++) {
+                    bool match;
+                    if (REALM_UNLIKELY(left.is_null(i) || right.is_null(i)))
+                        match = c(left.get(i), right.get(i));
+                    else
+                        match = c(compare_values(a[i], b[i]), 0);
+                    matches |= size_t(match) << i;
+                }
+            });
+        });
+        return matches;
+    }
+
+private:
+    DataType m_type = type_Int;
+    size_t m_size = 0;
+    bool m_has_nulls = false;
+    union {
+        int64_t m_ints[max_size];
+        float m_floats[max_size];
+        double m_doubles[max_size];
+    };
+    bool m_nulls[max_size];
+
+    template <class F>
+    void visit(F&& f) const
+    {
+        switch (m_type) {
+            case type_Int:
+                f(int64_t());
+                break;
+            case type_Float:
+                f(float());
+                break;
+            case type_Double:
+                f(double());
+                break;
+            default:
+                REALM_UNREACHABLE();
+        }
+    }
+
+    // Same result as Mixed::compare() for non-null values
+    template <class L, class R>
+    static int compare_values(L a, R b) noexcept
+    {
+        if constexpr (std::is_same_v<L, int64_t> && std::is_same_v<R, int64_t>) {
+            return a == b ? 0 : a < b ? -1 : 1;
+        }
+        else {
+            // Compare as doubles when that is exact, and leave NaNs and large integers to Mixed
+            auto exact = [](auto v) {
+                if constexpr (std::is_same_v<decltype(v), int64_t>) {
+                    constexpr int64_t end_of_precise_doubles = int64_t(1) << 53;
+                    return v <= end_of_precise_doubles && v >= -end_of_precise_doubles;
+                }
+                else {
+                    return !std::isnan(v);
+                }
+            };
+            if (REALM_LIKELY(exact(a) && exact(b))) {
+                double x = double(a);
+                double y = double(b);
+                return x == y ? 0 : x < y ? -1 : 1;
+            }
+            return Mixed(a).compare(Mixed(b));
+        }
+    }
+};
+
 class Expression {
 public:
     virtual ~Expression() = default;
@@ -774,6 +1014,20 @@ public:
 
     virtual void evaluate(Subexpr::Index& index, ValueBase& destination) = 0;
 
+    // True if evaluate_batch() can be used instead of evaluate(), which is the case for numeric expressions with
+    // a single value per object of the base table.
+    virtual bool has_batch_evaluation() const
+    {
+        return false;
+    }
+
+    // Evaluate the expression for the rows [start, end) of the current cluster. There may be at most
+    // ValueBatch::max_size rows.
+    virtual void evaluate_batch(size_t, size_t, ValueBatch&)
+    {
+        REALM_UNREACHABLE();
+    }
+
     virtual Mixed get_mixed() const
     {
         return {};
@@ -1361,6 +1615,19 @@ public:
         destination = *this;
     }
 
+    bool has_batch_evaluation() const override
+    {
+        if (m_from_list || size() != 1 || get(0).is_null())
+            return false;
+        auto type = get(0).get_type();
+        return type == type_Int || type == type_Float || type == type_Double;
+    }
+
+    void evaluate_batch(size_t start, size_t end, ValueBatch& destination) override
+    {
+        destination.fill(get(0), end - start);
+    }
+
     std::unique_ptr<Subexpr> clone() const override
     {
         return make_subexpr<Value<T>>(*this);
@@ -1547,6 +1814,7 @@ public:
         m_tables = other.m_tables;
         m_link_types = other.m_link_types;
         m_only_unary_links = other.m_only_unary_links;
+        m_resolve_by_cluster = other.m_resolve_by_cluster;
     }
 
     size_t get_nb_hops() const
@@ -1567,6 +1835,14 @@ public:
         return false;
     }
 
+    // Whether a condition on the target table is expected to be answered faster by finding the matching
+    // targets first and then their origins through the backlinks, rather than by following the links of
+    // every origin. That is when there are no more targets than origins to look at.
+    bool prefer_semi_join() const
+    {
+        return has_links() && !has_indexes() && get_target_table()->size() <= get_base_table()->size();
+    }
+
     ColKey get_first_column_key() const
     {
         REALM_ASSERT(has_links());
@@ -1598,6 +1874,7 @@ public:
                 REALM_UNREACHABLE();
         }
         cluster->init_leaf(m_link_column_keys[0], array_ptr);
+        m_targets_resolved = false;
     }
 
     void collect_dependencies(std::vector<TableKey>& tables) const;
@@ -1647,6 +1924,15 @@ public:
 
     void map_links(size_t row, LinkMapFunction lm) const
     {
+        if (m_resolve_by_cluster) {
+            if (!m_targets_resolved) {
+                resolve_targets();
+            }
+            if (ObjKey key = m_targets[row]) {
+                lm(key);
+            }
+            return;
+        }
         map_links(0, row, lm);
     }
 
@@ -1682,6 +1968,7 @@ public:
 private:
     bool map_links(size_t column, ObjKey key, LinkMapFunction lm) const;
     void map_links(size_t column, size_t row, LinkMapFunction lm) const;
+    void resolve_targets() const;
 
     void get_links(size_t row, std::vector<ObjKey>& result) const
     {
@@ -1695,6 +1982,11 @@ private:
     std::vector<ColumnType> m_link_types;
     std::vector<ConstTableRef> m_tables;
     bool m_only_unary_links = true;
+    // Set for a chain of two or more single links. The targets of all rows in the current cluster are then
+    // found together, one hop at a time, visiting the objects of each table in key order.
+    bool m_resolve_by_cluster = false;
+    mutable bool m_targets_resolved = false;
+    mutable std::vector<ObjKey> m_targets;
 
     mpark::variant<mpark::monostate, ArrayKey, ArrayInteger, ArrayList, ArrayBacklink> m_leaf;
 
@@ -2409,7 +2701,14 @@ public:
             m_link_map.set_cluster(cluster);
         }
         else {
-            m_cluster = cluster;
+            // The counts are read from the backlink columns of the cluster, so that no object has to be looked up
+            m_backlink_leaves.clear();
+            auto table = m_link_map.get_base_table();
+            table->for_each_backlink_column([&](ColKey backlink_col_key) {
+                auto& leaf = m_backlink_leaves.emplace_back(std::make_unique<ArrayBacklink>(table->get_alloc()));
+                cluster->init_leaf(backlink_col_key, leaf.get());
+                return IteratorControl::AdvanceToNext;
+            });
         }
     }
 
@@ -2425,8 +2724,10 @@ public:
             count = m_link_map.count_all_backlinks(index);
         }
         else {
-            const Obj obj = m_link_map.get_base_table()->get_object(m_cluster->get_real_key(index));
-            count = obj.get_backlink_count();
+            count = 0;
+            for (auto& leaf : m_backlink_leaves) {
+                count += leaf->get_backlink_count(index);
+            }
         }
         destination = Value<int64_t>(count);
     }
@@ -2442,7 +2743,7 @@ public:
     }
 
 private:
-    const Cluster* m_cluster = nullptr;
+    std::vector<std::unique_ptr<ArrayBacklink>> m_backlink_leaves;
     LinkMap m_link_map;
 };
 
@@ -2562,7 +2863,15 @@ public:
         return std::unique_ptr<Expression>(new GeoWithinCompare(*this));
     }
 
+    // Return the sorted keys of the objects linking to a point which may be
+    // in the region, or null if the linked table has no geospatial index or
+    // the comparison type does not allow using it.
+    std::shared_ptr<std::vector<ObjKey>> get_index_candidates() const;
+
 private:
+    // Budget of cells approximating the region in an index lookup
+    static constexpr size_t s_max_covering_cells = 16;
+
     LinkMap m_link_map;
     Geospatial m_bounds;
     GeoRegion m_region;
@@ -3979,6 +4288,46 @@ public:
         }
     }
 
+    bool has_batch_evaluation() const override
+    {
+        return realm::is_any_v<T, int64_t, float, double> && !links_exist();
+    }
+
+    void evaluate_batch(size_t start, size_t end, ValueBatch& destination) override
+    {
+        if constexpr (realm::is_any_v<T, int64_t, float, double>) {
+            T* values = destination.template init<T>(end - start);
+            if constexpr (requires_null_column) {
+                if (auto leaf = mpark::get_if<NullableLeafType>(&m_leaf)) {
+                    for (size_t i = 0; start + i < end; i++) {
+                        auto value = leaf->get(start + i);
+                        values[i] = value.value_or(0);
+                        if (!value)
+                            destination.set_null(i);
+                    }
+                    return;
+                }
+                auto leaf = mpark::get_if<LeafType>(&m_leaf);
+                REALM_ASSERT(leaf);
+                // ValueBatch::max_size is a multiple of the chunk size, so the last chunk fits
+                for (size_t i = 0; start + i < end; i += ValueBase::chunk_size)
+                    static_cast<const Array*>(leaf)->get_chunk(start + i, values + i);
+            }
+            else {
+                auto leaf = mpark::get_if<LeafType>(&m_leaf);
+                REALM_ASSERT(leaf);
+                for (size_t i = 0; start + i < end; i++) {
+                    values[i] = leaf->get(start + i);
+                    if (leaf->is_null(start + i))
+                        destination.set_null(i);
+                }
+            }
+        }
+        else {
+            REALM_UNREACHABLE();
+        }
+    }
+
     void evaluate(ObjKey key, ValueBase& destination)
     {
         destination.init(false, 1);
@@ -4218,6 +4567,7 @@ public:
 
     void set_cluster(const Cluster* cluster) override
     {
+        m_cluster = cluster;
         m_link_map.set_cluster(cluster);
     }
 
@@ -4228,12 +4578,21 @@ public:
 
     void evaluate(Subexpr::Index& index, ValueBase& destination) override
     {
-        std::vector<ObjKey> links = m_link_map.get_links(index);
-        // std::sort(links.begin(), links.end());
         if (!m_initialized) {
             m_query.init();
+            m_use_semi_join = m_link_map.prefer_semi_join();
+            if (m_use_semi_join) {
+                count_links_from_matches();
+            }
             m_initialized = true;
         }
+        if (m_use_semi_join) {
+            auto it = m_counts.find(m_cluster->get_real_key(index).value);
+            destination = Value<int64_t>(it == m_counts.end() ? 0 : it->second);
+            return;
+        }
+
+        std::vector<ObjKey> links = m_link_map.get_links(index);
 
         size_t count = std::accumulate(links.begin(), links.end(), size_t(0), [this](size_t running_count, ObjKey k) {
             const Obj obj = m_link_map.get_target_table()->get_object(k);
@@ -4270,7 +4629,13 @@ public:
 private:
     Query m_query;
     LinkMap m_link_map;
+    const Cluster* m_cluster = nullptr;
     bool m_initialized = false;
+    bool m_use_semi_join = false;
+    // Number of links from the objects matching the subquery, by origin key
+    std::unordered_map<int64_t, size_t> m_counts;
+
+    void count_links_from_matches();
 };
 
 // The unused template parameter is a hack to avoid a circular dependency between table.hpp and query_expression.hpp.
@@ -4387,6 +4752,18 @@ public:
         destination = result;
     }
 
+    bool has_batch_evaluation() const override
+    {
+        return m_left->has_batch_evaluation() && m_right->has_batch_evaluation();
+    }
+
+    void evaluate_batch(size_t start, size_t end, ValueBatch& destination) override
+    {
+        m_left->evaluate_batch(start, end, m_left_batch);
+        m_right->evaluate_batch(start, end, m_right_batch);
+        destination.fun<oper>(m_left_batch, m_right_batch);
+    }
+
     std::string description(util::serializer::SerialisationState& state) const override
     {
         std::string s = "(";
@@ -4423,6 +4800,8 @@ private:
     bool m_left_is_const;
     bool m_right_is_const;
     Mixed m_const_value;
+    ValueBatch m_left_batch;
+    ValueBatch m_right_batch;
 };
 
 class CompareBase : public Expression {
@@ -4455,6 +4834,8 @@ public:
         else {
             m_left->set_cluster(cluster);
             m_right->set_cluster(cluster);
+            m_cluster_size = cluster->node_size();
+            m_batch_start = npos;
         }
     }
 
@@ -4478,6 +4859,16 @@ public:
         m_right->collect_dependencies(tables);
     }
 
+    const Subexpr& get_left() const noexcept
+    {
+        return *m_left;
+    }
+
+    const Subexpr& get_right() const noexcept
+    {
+        return *m_right;
+    }
+
     size_t find_first_with_matches(size_t start, size_t end) const
     {
         if (m_index_end == 0 || start >= end)
@@ -4539,6 +4930,15 @@ protected:
     std::vector<ObjKey> m_matches;
     mutable size_t m_index_get = 0;
     size_t m_index_end = 0;
+
+    // When both sides support batch evaluation, the comparison is done for up to ValueBatch::max_size rows at a
+    // time starting at m_batch_start, and the results kept as a bit mask for the following calls to find_first()
+    bool m_use_batches = false;
+    size_t m_cluster_size = 0;
+    mutable size_t m_batch_start = npos;
+    mutable size_t m_batch_matches = 0;
+    mutable ValueBatch m_left_batch;
+    mutable ValueBatch m_right_batch;
 };
 
 template <class TCond>
@@ -4549,6 +4949,9 @@ public:
     double init() override
     {
         double dT = 50.0;
+        m_has_matches = false;
+        m_use_batches = realm::is_any_v<TCond, Equal, NotEqual, Greater, Less, GreaterEqual, LessEqual> &&
+                        m_left->has_batch_evaluation() && m_right->has_batch_evaluation();
         if ((m_left->has_single_value()) || (m_right->has_single_value())) {
             dT = 10.0;
             if constexpr (std::is_same_v<TCond, Equal>) {
@@ -4602,6 +5005,9 @@ public:
                     dT = 0;
                 }
             }
+            if (!m_has_matches && find_matches_by_semi_join()) {
+                dT = 0;
+            }
         }
 
         return dT;
@@ -4612,6 +5018,9 @@ public:
         if (m_has_matches) {
             return find_first_with_matches(start, end);
         }
+        if (m_use_batches) {
+            return find_first_in_batches(start, end);
+        }
 
         size_t match;
         ValueBase left_buf;
@@ -4670,6 +5079,73 @@ public:
     {
         return std::unique_ptr<Expression>(new Compare(*this));
     }
+
+private:
+    // A property reached through a list of links matches if any of the linked objects matches. Compared with
+    // a constant, the objects matching can be found in the target table first, and the matching origins from
+    // their backlinks.
+    bool find_matches_by_semi_join()
+    {
+        bool const_on_left = m_left_const_values && m_left->has_single_value();
+        bool const_on_right = m_right_const_values && m_right->has_single_value();
+        if (const_on_left == const_on_right) {
+            return false;
+        }
+        Subexpr* column = const_on_left ? m_right.get() : m_left.get();
+        ValueBase* const_values = const_on_left ? m_left_const_values : m_right_const_values;
+        auto prop = dynamic_cast<const ObjPropertyBase*>(column);
+        if (!prop || prop->only_unary_links() || prop->has_path() || prop->column_key().is_collection() ||
+            !prop->get_link_map().prefer_semi_join()) {
+            return false;
+        }
+        if (column->get_comparison_type().value_or(ExpressionComparisonType::Any) != ExpressionComparisonType::Any ||
+            (const_on_left ? m_left : m_right)->get_comparison_type().value_or(ExpressionComparisonType::Any) !=
+                ExpressionComparisonType::Any) {
+            return false;
+        }
+
+        auto& link_map = prop->get_link_map();
+        ColKey col_key = prop->column_key();
+        ValueBase value;
+        value.init(false, 1);
+        m_matches.clear();
+        for (auto obj : *link_map.get_target_table()) {
+            value.set(0, obj.get_any(col_key));
+            size_t match = const_on_left ? ValueBase::template compare<TCond>(*const_values, value, {}, {})
+                                         : ValueBase::template compare<TCond>(value, *const_values, {}, {});
+            if (match != not_found) {
+                auto origins = link_map.get_origin_objkeys(obj.get_key());
+                m_matches.insert(m_matches.end(), origins.begin(), origins.end());
+            }
+        }
+        std::sort(m_matches.begin(), m_matches.end());
+        m_matches.erase(std::unique(m_matches.begin(), m_matches.end()), m_matches.end());
+
+        m_has_matches = true;
+        m_index_get = 0;
+        m_index_end = m_matches.size();
+        return true;
+    }
+
+    size_t find_first_in_batches(size_t start, size_t end) const
+    {
+        while (start < end) {
+            if (start < m_batch_start || start >= m_batch_start + ValueBatch::max_size) {
+                // Evaluate beyond `end` as long as the cluster lasts, as the next call is likely to continue there
+                size_t batch_end = std::min(start + ValueBatch::max_size, m_cluster_size);
+                m_left->evaluate_batch(start, batch_end, m_left_batch);
+                m_right->evaluate_batch(start, batch_end, m_right_batch);
+                m_batch_matches = ValueBatch::compare<TCond>(m_left_batch, m_right_batch);
+                m_batch_start = start;
+            }
+            if (size_t matches = m_batch_matches >> (start - m_batch_start)) {
+                size_t match = start + ctz(matches);
+                return match < end ? match : not_found;
+            }
+            start = m_batch_start + ValueBatch::max_size;
+        }
+        return not_found;
+    }
 };
 } // namespace realm
 #endif // REALM_QUERY_EXPRESSION_HPP
@@ -75,6 +75,11 @@ public:
         m_source_column = payload;
     }
 
+    inline bool has_payload_column() const noexcept
+    {
+        return m_source_column != nullptr;
+    }
+
 protected:
     size_t m_match_count = 0;
     size_t m_limit;
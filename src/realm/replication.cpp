@@ -51,15 +51,26 @@ void Replication::initialize(DB&)
 
 void Replication::do_initiate_transact(Group&, version_type, bool)
 {
+    constexpr size_t summary_size = _impl::TransactLogEncoder::max_summary_size;
     char* data = m_stream.get_data();
-    size_t size = m_stream.get_size();
-    m_encoder.set_buffer(data, data + size);
+    char* end;
+    m_stream.transact_log_reserve(summary_size, &data, &end); // Throws
+    m_encoder.set_buffer(data + summary_size, end);
+    m_encoder.reset_summary();
 }
 
 Replication::version_type Replication::prepare_commit(version_type orig_version)
 {
-    char* data = m_stream.get_data();
+    char* data = const_cast<char*>(changes_begin());
     size_t size = m_encoder.write_position() - data;
+    // Readers which are only interested in some tables skip the changeset
+    // when the summary shows that it does not touch them
+    if (size != 0) {
+        if (char* summary = m_encoder.write_summary(data, size)) {
+            size += data - summary;
+            data = summary;
+        }
+    }
     version_type new_version = prepare_changeset(data, size, orig_version); // Throws
     return new_version;
 }
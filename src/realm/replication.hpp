@@ -210,6 +210,12 @@ public:
     /// until initiation of the commit operation).
     BinaryData get_uncommitted_changes() const noexcept;
 
+    /// Get the uncommitted changes made since the previous call to this
+    /// function in the current write transaction. The returned changes can be
+    /// parsed on their own, since the selection of tables and collections is
+    /// reset.
+    BinaryData get_unrecorded_changes() noexcept;
+
     /// CAUTION: These values are stored in Realm files, so value reassignment
     /// is not allowed.
     enum HistoryType {
@@ -425,7 +431,9 @@ private:
     mutable const Table* m_selected_table = nullptr;
     mutable ObjKey m_selected_obj;
     mutable CollectionId m_selected_list;
+    size_t m_recorded_size = 0;
 
+    const char* changes_begin() const noexcept;
     void unselect_all() noexcept;
     void select_table(const Table*); // unselects link list and obj
     void select_obj(ObjKey key);
@@ -466,6 +474,7 @@ inline void Replication::initiate_transact(Group& group, version_type current_ve
     }
     do_initiate_transact(group, current_version, history_updated);
     unselect_all();
+    m_recorded_size = 0;
 }
 
 inline void Replication::finalize_commit() noexcept
@@ -473,16 +482,33 @@ inline void Replication::finalize_commit() noexcept
     finalize_changeset();
 }
 
-inline BinaryData Replication::get_uncommitted_changes() const noexcept
+inline const char* Replication::changes_begin() const noexcept
 {
+    // Room for the changeset summary is left in front of the instructions by
+    // do_initiate_transact()
     const char* data = m_stream.get_data();
+    return data ? data + _impl::TransactLogEncoder::max_summary_size : data;
+}
+
+inline BinaryData Replication::get_uncommitted_changes() const noexcept
+{
+    const char* data = changes_begin();
     size_t size = m_encoder.write_position() - data;
     return BinaryData(data, size);
 }
 
+inline BinaryData Replication::get_unrecorded_changes() noexcept
+{
+    BinaryData changes = get_uncommitted_changes();
+    size_t begin = std::min(m_recorded_size, changes.size());
+    m_recorded_size = changes.size();
+    unselect_all();
+    return BinaryData(changes.data() + begin, changes.size() - begin);
+}
+
 inline size_t Replication::transact_log_size()
 {
-    return m_encoder.write_position() - m_stream.get_data();
+    return m_encoder.write_position() - changes_begin();
 }
 
 
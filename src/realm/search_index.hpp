@@ -68,6 +68,8 @@ public:
         return m_full_word;
     }
     Mixed get_value(ObjKey key) const;
+    /// The value of the object `key`, or none if there is no such object.
+    std::optional<Mixed> try_get_value(ObjKey key) const;
     Lst<String> get_list(ObjKey key) const;
     std::vector<ObjKey> get_all_keys() const;
 
@@ -92,6 +94,14 @@ public:
     virtual void insert(ObjKey value, const Mixed& key) = 0;
     virtual void set(ObjKey value, const Mixed& key) = 0;
     virtual ObjKey find_first(const Mixed&) const = 0;
+    /// Like find_first(), for columns in which each value occurs at most once,
+    /// such as primary key columns. The index may keep lookup structures in
+    /// memory to answer these faster, so this must not be called on an index
+    /// which is shared between threads.
+    virtual ObjKey find_unique(const Mixed& value) const
+    {
+        return find_first(value);
+    }
     virtual void find_all(std::vector<ObjKey>& result, Mixed value, bool case_insensitive = false) const = 0;
     virtual FindRes find_all_no_copy(Mixed value, InternalFindResult& result) const = 0;
     virtual size_t count(const Mixed&) const = 0;
@@ -117,8 +127,8 @@ public:
     void set_parent(ArrayParent* parent, size_t ndx_in_parent) noexcept;
     size_t get_ndx_in_parent() const noexcept;
     void set_ndx_in_parent(size_t ndx_in_parent) noexcept;
-    void update_from_parent() noexcept;
-    void refresh_accessor_tree(const ClusterColumn& target_column);
+    virtual void update_from_parent() noexcept;
+    virtual void refresh_accessor_tree(const ClusterColumn& target_column);
     ref_type get_ref() const noexcept;
 
     // SearchIndex common base methods
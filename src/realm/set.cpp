@@ -42,6 +42,15 @@ void SetBase::insert_repl(Replication* repl, size_t index, Mixed value) const
     repl->set_insert(*this, index, value);
 }
 
+size_t SetBase::insert_many_any(const std::vector<Mixed>& values)
+{
+    size_t num_inserted = 0;
+    for (auto& value : values) {
+        num_inserted += insert_any(value).second;
+    }
+    return num_inserted;
+}
+
 void SetBase::erase_repl(Replication* repl, size_t index, Mixed value) const
 {
     repl->set_erase(*this, index, value);
@@ -149,6 +158,9 @@ void SetBase::assign_union(const CollectionBase& rhs)
     if (*this == rhs) {
         return;
     }
+    if (assign_by_merge(rhs, SetOperation::Union)) {
+        return;
+    }
     if (auto other_set = dynamic_cast<const SetBase*>(&rhs)) {
         return assign_union(other_set->begin(), other_set->end());
     }
@@ -173,6 +185,9 @@ void SetBase::assign_intersection(const CollectionBase& rhs)
     if (*this == rhs) {
         return;
     }
+    if (assign_by_merge(rhs, SetOperation::Intersection)) {
+        return;
+    }
     if (auto other_set = dynamic_cast<const SetBase*>(&rhs)) {
         return assign_intersection(other_set->begin(), other_set->end());
     }
@@ -198,6 +213,9 @@ void SetBase::assign_difference(const CollectionBase& rhs)
         clear();
         return;
     }
+    if (assign_by_merge(rhs, SetOperation::Difference)) {
+        return;
+    }
     if (auto other_set = dynamic_cast<const SetBase*>(&rhs)) {
         return assign_difference(other_set->begin(), other_set->end());
     }
@@ -223,6 +241,9 @@ void SetBase::assign_symmetric_difference(const CollectionBase& rhs)
         clear();
         return;
     }
+    if (assign_by_merge(rhs, SetOperation::SymmetricDifference)) {
+        return;
+    }
     if (auto other_set = dynamic_cast<const SetBase*>(&rhs)) {
         return assign_symmetric_difference(other_set->begin(), other_set->end());
     }
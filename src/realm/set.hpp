@@ -22,6 +22,7 @@
 #include <realm/collection.hpp>
 #include <realm/bplustree.hpp>
 #include <realm/array_key.hpp>
+#include <realm/impl/destroy_guard.hpp>
 
 namespace realm {
 class SetBase : public CollectionBase {
@@ -37,6 +38,8 @@ public:
     virtual std::pair<size_t, bool> erase_null() = 0;
     virtual std::pair<size_t, bool> insert_any(Mixed value) = 0;
     virtual std::pair<size_t, bool> erase_any(Mixed value) = 0;
+    // Insert those of 'values' not already in the set, returning the number inserted
+    virtual size_t insert_many_any(const std::vector<Mixed>& values);
 
     bool is_subset_of(const CollectionBase&) const;
     bool is_strict_subset_of(const CollectionBase& rhs) const;
@@ -58,6 +61,15 @@ protected:
     void clear_repl(Replication* repl) const;
     static std::vector<Mixed> convert_to_mixed_set(const CollectionBase& rhs);
 
+    enum class SetOperation { Union, Intersection, Difference, SymmetricDifference };
+
+    // Assign the result of 'op' by walking this set and 'rhs' side by side once. Returns false if that is not
+    // possible for this kind of set or for 'rhs', in which case the element by element version is used.
+    virtual bool assign_by_merge(const CollectionBase&, SetOperation)
+    {
+        return false;
+    }
+
     void resort_range(size_t from, size_t to);
 
     REALM_COLD REALM_NORETURN void throw_invalid_null()
@@ -157,6 +169,11 @@ public:
     /// or the index of the already-existing value.
     std::pair<size_t, bool> insert(T value);
 
+    /// Insert those of 'values' not already in the set, returning the number of values inserted. The values are
+    /// sorted first so that the positions to insert at are found in a single pass, and the values greater than
+    /// all elements of the set are added at the end in one go.
+    size_t insert_many(std::vector<T> values);
+
     /// Find the index of a value in the set, or `size_t(-1)` if it is not in the set.
     size_t find(T value) const;
 
@@ -188,6 +205,7 @@ public:
     std::pair<size_t, bool> erase_null() final;
     std::pair<size_t, bool> insert_any(Mixed value) final;
     std::pair<size_t, bool> erase_any(Mixed value) final;
+    size_t insert_many_any(const std::vector<Mixed>& values) final;
 
     const BPlusTree<T>& get_tree() const
     {
@@ -215,7 +233,13 @@ private:
         return static_cast<BPlusTree<T>&>(*m_tree);
     }
 
+    // When a merge changes at least one in this many elements of the result, the tree is rebuilt from the
+    // result rather than changed in place.
+    static constexpr size_t s_merge_rebuild_factor = 8;
+
     UpdateStatus init_from_parent(bool allow_create) const;
+    bool assign_by_merge(const CollectionBase& rhs, SetOperation op) final;
+    void replace_content(const std::vector<T>& values);
 
     /// Update the accessor and return true if it is attached after the update.
     inline bool update() const
@@ -641,6 +665,221 @@ std::pair<size_t, bool> Set<T>::insert_any(Mixed value)
     }
 }
 
+template <class T>
+size_t Set<T>::insert_many(std::vector<T> values)
+{
+    if constexpr (std::is_floating_point_v<typename util::RemoveOptional<T>::type>) {
+        // NaN does not sort, so leave the ordering to insert()
+        size_t num_inserted = 0;
+        for (const T& value : values) {
+            num_inserted += insert(value).second;
+        }
+        return num_inserted;
+    }
+    else {
+        ensure_created();
+
+        if (!m_nullable) {
+            for (const T& value : values) {
+                if (value_is_null(value))
+                    throw_invalid_null();
+            }
+        }
+
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+
+        Replication* repl = Base::get_replication();
+        size_t num_inserted = 0;
+        size_t ndx = 0;
+        auto value_it = values.begin();
+        for (; value_it != values.end(); ++value_it) {
+            const T& value = *value_it;
+            // As the values are sorted, each one goes after the previous one
+            ndx = std::lower_bound(iterator{this, ndx}, this->end(), value).index();
+            if (ndx == tree().size()) {
+                break;
+            }
+            if (get(ndx) == value) {
+                continue;
+            }
+            if (repl) {
+                this->insert_repl(repl, ndx, value);
+            }
+            do_insert(ndx, value);
+            ++num_inserted;
+        }
+
+        // The remaining values are greater than all elements
+        if (value_it != values.end()) {
+            size_t sz = tree().size();
+            std::vector<T> tail(value_it, values.end());
+            if (repl) {
+                for (size_t i = 0; i < tail.size(); ++i) {
+                    this->insert_repl(repl, sz + i, T(tail[i]));
+                }
+            }
+            if constexpr (std::is_same_v<T, ObjKey> || std::is_same_v<T, ObjLink> || std::is_same_v<T, Mixed>) {
+                // Links need their backlinks
+                for (const T& value : tail) {
+                    do_insert(sz++, value);
+                }
+            }
+            else {
+                tree().append(tail);
+            }
+            num_inserted += tail.size();
+        }
+
+        if (num_inserted) {
+            bump_content_version();
+        }
+        return num_inserted;
+    }
+}
+
+template <class T>
+size_t Set<T>::insert_many_any(const std::vector<Mixed>& values)
+{
+    if constexpr (std::is_same_v<T, Mixed>) {
+        return insert_many(values);
+    }
+    else {
+        std::vector<T> typed_values;
+        typed_values.reserve(values.size());
+        for (auto& value : values) {
+            if (value.is_null()) {
+                typed_values.push_back(BPlusTree<T>::default_value(this->m_nullable));
+            }
+            else {
+                typed_values.push_back(value.get<typename util::RemoveOptional<T>::type>());
+            }
+        }
+        return insert_many(std::move(typed_values));
+    }
+}
+
+template <class T>
+bool Set<T>::assign_by_merge(const CollectionBase& rhs, SetOperation op)
+{
+    if constexpr (std::is_same_v<T, ObjKey> || std::is_same_v<T, ObjLink> || std::is_same_v<T, Mixed> ||
+                  std::is_floating_point_v<typename util::RemoveOptional<T>::type>) {
+        // Links need their backlinks updated one by one, and NaN does not sort consistently
+        static_cast<void>(rhs);
+        static_cast<void>(op);
+        return false;
+    }
+    else {
+        auto other = dynamic_cast<const Set<T>*>(&rhs);
+        if (!other) {
+            return false;
+        }
+
+        std::vector<T> lhs_values;
+        if (size() > 0) {
+            lhs_values = tree().get_all();
+        }
+        std::vector<T> rhs_values;
+        if (other->size() > 0) {
+            rhs_values = other->get_tree().get_all();
+        }
+        if (op == SetOperation::Union || op == SetOperation::SymmetricDifference) {
+            if (rhs_values.empty()) {
+                return true;
+            }
+            ensure_created();
+        }
+        else if (lhs_values.empty()) {
+            return true;
+        }
+
+        // The instructions are emitted in order of position, so the part of the set before the position of each
+        // change already matches the result.
+        struct Change {
+            size_t ndx;
+            T value;
+            bool is_insert;
+        };
+        Replication* repl = Base::get_replication();
+        std::vector<T> result;
+        result.reserve(op == SetOperation::Union ? lhs_values.size() + rhs_values.size() : lhs_values.size());
+        std::vector<Change> changes;
+        auto keep = [&](const T& value) {
+            result.push_back(value);
+        };
+        auto add = [&](const T& value) {
+            if (repl) {
+                this->insert_repl(repl, result.size(), value);
+            }
+            changes.push_back({result.size(), value, true});
+            result.push_back(value);
+        };
+        auto drop = [&](const T& value) {
+            if (repl) {
+                this->erase_repl(repl, result.size(), value);
+            }
+            changes.push_back({result.size(), value, false});
+        };
+
+        bool keep_only_in_lhs = op != SetOperation::Intersection;
+        bool add_only_in_rhs = op == SetOperation::Union || op == SetOperation::SymmetricDifference;
+        bool keep_in_both = op == SetOperation::Union || op == SetOperation::Intersection;
+        size_t i = 0;
+        size_t j = 0;
+        while (i < lhs_values.size() || j < rhs_values.size()) {
+            if (j == rhs_values.size() || (i < lhs_values.size() && lhs_values[i] < rhs_values[j])) {
+                keep_only_in_lhs ? keep(lhs_values[i]) : drop(lhs_values[i]);
+                ++i;
+            }
+            else if (i == lhs_values.size() || rhs_values[j] < lhs_values[i]) {
+                if (add_only_in_rhs) {
+                    add(rhs_values[j]);
+                }
+                ++j;
+            }
+            else {
+                keep_in_both ? keep(lhs_values[i]) : drop(lhs_values[i]);
+                ++i;
+                ++j;
+            }
+        }
+
+        if (changes.empty()) {
+            return true;
+        }
+        if (changes.size() * s_merge_rebuild_factor < result.size()) {
+            for (auto& change : changes) {
+                change.is_insert ? do_insert(change.ndx, change.value) : do_erase(change.ndx);
+            }
+        }
+        else {
+            replace_content(result);
+        }
+        bump_content_version();
+        return true;
+    }
+}
+
+template <class T>
+void Set<T>::replace_content(const std::vector<T>& values)
+{
+    if (values.empty()) {
+        tree().clear();
+        return;
+    }
+    // The values may refer to memory owned by the current tree, so the new tree is built before the current one
+    // is destroyed
+    BPlusTree<T> new_tree(get_alloc());
+    new_tree.create();
+    new_tree.append(values);
+    ref_type ref = new_tree.get_ref();
+    _impl::DeepArrayRefDestroyGuard destroy_guard{ref, get_alloc()};
+    Base::update_child_ref(0, ref); // Throws
+    destroy_guard.release();
+    tree().destroy();
+    tree().init_from_ref(ref);
+}
+
 template <class T>
 std::pair<size_t, bool> Set<T>::erase(T value)
 {
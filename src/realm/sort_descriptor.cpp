@@ -23,6 +23,11 @@
 #include <realm/util/assert.hpp>
 #include <realm/list.hpp>
 #include <realm/dictionary.hpp>
+#include <realm/util/function_ref.hpp>
+#include <realm/util/thread.hpp>
+
+#include <thread>
+#include <unordered_set>
 
 using namespace realm;
 
@@ -97,6 +102,24 @@ ColumnsDescriptor::ColumnsDescriptor(std::vector<std::vector<ExtendedColumnKey>>
 {
 }
 
+ColKey ColumnsDescriptor::get_single_column() const noexcept
+{
+    if (m_column_keys.size() != 1 || m_column_keys[0].size() != 1 || m_column_keys[0][0].has_index())
+        return {};
+    return m_column_keys[0][0];
+}
+
+std::vector<ColKey> ColumnsDescriptor::get_table_columns() const
+{
+    std::vector<ColKey> columns;
+    for (auto& chain : m_column_keys) {
+        if (chain.size() != 1 || chain[0].has_index())
+            return {};
+        columns.push_back(chain[0]);
+    }
+    return columns;
+}
+
 std::unique_ptr<BaseDescriptor> DistinctDescriptor::clone() const
 {
     return std::unique_ptr<DistinctDescriptor>(new DistinctDescriptor(*this));
@@ -264,7 +287,10 @@ BaseDescriptor::Sorter::Sorter(std::vector<std::vector<ExtendedColumnKey>> const
             translated_keys[index_in_view] = translated_key;
         }
     }
-    m_cache.resize(column_lists.size() - 1);
+    for (size_t i = 1; i < m_columns.size(); ++i) {
+        m_columns[i].values.resize(translated_size);
+        m_columns[i].has_value.resize(translated_size);
+    }
 }
 
 BaseDescriptor::Sorter DistinctDescriptor::sorter(Table const& table, const IndexPairs& indexes) const
@@ -285,6 +311,33 @@ void DistinctDescriptor::execute(IndexPairs& v, const Sorter& predicate, const B
         v.erase(nulls, v.end());
     }
 
+    // The rows are in the order of the view, or of the previous sort, so the
+    // first row of each set of duplicates is the one to keep. Finding them by
+    // hash is linear and leaves that order intact.
+    bool in_view_order = std::is_sorted(v.begin(), v.end(), [](const IP& a, const IP& b) {
+        return a.index_in_view < b.index_in_view;
+    });
+    if (in_view_order && predicate.can_hash()) {
+        std::vector<size_t> hashes(v.size());
+        auto hasher = [&](size_t ndx) {
+            return hashes[ndx];
+        };
+        auto equal = [&](size_t a, size_t b) {
+            return predicate.equal(v[a], v[b]);
+        };
+        std::unordered_set<size_t, decltype(hasher), decltype(equal)> seen(v.size(), hasher, equal);
+        size_t kept = 0;
+        for (size_t i = 0; i < v.size(); ++i) {
+            if (kept != i)
+                v[kept] = v[i];
+            hashes[kept] = predicate.hash(v[kept]);
+            if (seen.insert(kept).second)
+                ++kept;
+        }
+        v.erase(v.begin() + kept, v.end());
+        return;
+    }
+
     // Sort by the columns to distinct on
     std::sort(v.begin(), v.end(), std::ref(predicate));
 
@@ -310,31 +363,86 @@ BaseDescriptor::Sorter SortDescriptor::sorter(Table const& table, const IndexPai
     return Sorter(m_column_keys, m_ascending, table, indexes);
 }
 
+namespace {
+
+// Views smaller than this are sorted on the calling thread, as starting threads would take longer than the sort
+constexpr size_t c_parallel_sort_threshold = 100'000;
+
+// Sort by sorting one contiguous part of `v` per thread, and then merging neighbouring parts in parallel until one
+// is left. The predicate is a total ordering, so the result is the same as that of std::sort().
+void parallel_sort(BaseDescriptor::IndexPairs& v, const BaseDescriptor::Sorter& predicate)
+{
+    const size_t parts = std::min(predicate.get_parallelism(), v.size() / (c_parallel_sort_threshold / 4));
+    if (parts < 2) {
+        std::sort(v.begin(), v.end(), std::ref(predicate));
+        return;
+    }
+    std::vector<size_t> bounds(parts + 1);
+    for (size_t i = 0; i <= parts; ++i)
+        bounds[i] = v.size() * i / parts;
+
+    std::vector<std::exception_ptr> errors(parts);
+    auto run = [&](size_t num_tasks, util::FunctionRef<void(size_t)> task) {
+        std::vector<std::thread> threads;
+        threads.reserve(num_tasks);
+        for (size_t i = 0; i < num_tasks; ++i) {
+            threads.emplace_back([&, i] {
+                util::on_thread_start(util::ThreadRole::sort_worker);
+                try {
+                    task(i);
+                }
+                catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        for (auto& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    };
+
+    run(parts, [&](size_t i) {
+        predicate.cache_values(v.data() + bounds[i], v.data() + bounds[i + 1]);
+        std::sort(v.begin() + bounds[i], v.begin() + bounds[i + 1], std::ref(predicate));
+    });
+    for (size_t width = 1; width < parts; width *= 2) {
+        size_t merges = (parts + 2 * width - 1) / (2 * width);
+        run(merges, [&](size_t i) {
+            size_t first = 2 * width * i;
+            size_t middle = std::min(first + width, parts);
+            size_t last = std::min(first + 2 * width, parts);
+            if (middle < last) {
+                std::inplace_merge(v.begin() + bounds[first], v.begin() + bounds[middle], v.begin() + bounds[last],
+                                   std::ref(predicate));
+            }
+        });
+    }
+}
+
+} // anonymous namespace
+
 void SortDescriptor::execute(IndexPairs& v, const Sorter& predicate, const BaseDescriptor* next) const
 {
     size_t limit = size_t(-1);
     if (next && next->get_type() == DescriptorType::Limit) {
         limit = static_cast<const LimitDescriptor*>(next)->get_limit();
     }
-    // Measurements shows that if limit is smaller than size / 16, then
-    // it is quicker to make a sorted insert into a smaller vector
-    if (limit < (v.size() >> 4)) {
-        IndexPairs buffer;
-        buffer.reserve(limit + 1);
-        for (auto& elem : v) {
-            auto it = std::lower_bound(buffer.begin(), buffer.end(), elem, std::ref(predicate));
-            buffer.insert(it, elem);
-            if (buffer.size() > limit) {
-                buffer.pop_back();
-            }
-        }
+    if (limit < v.size()) {
+        // Only the first `limit` elements are needed. Partition them out in
+        // linear time and sort just those, giving O(n + k log k) rather than
+        // sorting everything. The predicate is a total ordering, so the
+        // result is the same as that of a stable full sort.
+        std::nth_element(v.begin(), v.begin() + limit, v.end(), std::ref(predicate));
         v.m_removed_by_limit += v.size() - limit;
         v.erase(v.begin() + limit, v.end());
-        std::move(buffer.begin(), buffer.end(), v.begin());
     }
-    else {
+    if (predicate.get_parallelism() > 1 && v.size() >= c_parallel_sort_threshold)
+        parallel_sort(v, predicate);
+    else
         std::sort(v.begin(), v.end(), std::ref(predicate));
-    }
 
     // not doing this on the last step is an optimisation
     if (next) {
@@ -361,7 +469,8 @@ std::unique_ptr<BaseDescriptor> LimitDescriptor::clone() const
 void LimitDescriptor::execute(const Table&, KeyValues& key_values, const BaseDescriptor*) const
 {
     if (key_values.size() > m_limit) {
-        key_values.erase(key_values.begin() + m_limit, key_values.end());
+        auto& keys = key_values.modify();
+        keys.erase(keys.begin() + m_limit, keys.end());
     }
 }
 
@@ -397,17 +506,13 @@ bool BaseDescriptor::Sorter::operator()(IndexPair i, IndexPair j, bool total_ord
 {
     // Sorting can be specified by multiple columns, so that if two entries in the first column are
     // identical, then the rows are ordered according to the second column, and so forth. For the
-    // first column, all the payload of the View is cached in IndexPair::cached_value.
+    // first column, all the payload of the View is cached in IndexPair::cached_value. The values of the other
+    // columns are read once per row, when they are first needed.
     for (size_t t = 0; t < m_columns.size(); t++) {
-        ObjKey key_i = i.key_for_object;
-        ObjKey key_j = j.key_for_object;
-
-        if (!m_columns[t].translated_keys.empty()) {
-            key_i = m_columns[t].translated_keys[i.index_in_view];
-            key_j = m_columns[t].translated_keys[j.index_in_view];
-
-            bool null_i = !key_i;
-            bool null_j = !key_j;
+        auto& translated_keys = m_columns[t].translated_keys;
+        if (!translated_keys.empty()) {
+            bool null_i = !translated_keys[i.index_in_view];
+            bool null_j = !translated_keys[j.index_in_view];
 
             if (null_i && null_j) {
                 continue;
@@ -424,30 +529,7 @@ bool BaseDescriptor::Sorter::operator()(IndexPair i, IndexPair j, bool total_ord
             c = i.cached_value.compare(j.cached_value);
         }
         else {
-            if (m_cache[t - 1].empty()) {
-                m_cache[t - 1].resize(256);
-            }
-            ObjCache& cache_i = m_cache[t - 1][key_i.value & 0xFF];
-            ObjCache& cache_j = m_cache[t - 1][key_j.value & 0xFF];
-
-            if (cache_i.key != key_i) {
-                const auto& obj = m_columns[t].table->get_object(key_i);
-                const auto& col_key = m_columns[t].col_key;
-
-                cache_i.value = col_key.get_value(obj);
-                cache_i.key = key_i;
-            }
-            Mixed val_i = cache_i.value;
-
-            if (cache_j.key != key_j) {
-                const auto& obj = m_columns[t].table->get_object(key_j);
-                const auto& col_key = m_columns[t].col_key;
-
-                cache_j.value = col_key.get_value(obj);
-                cache_j.key = key_j;
-            }
-
-            c = val_i.compare(cache_j.value);
+            c = get_value(t, i).compare(get_value(t, j));
         }
         // if c is negative i comes before j
         if (c) {
@@ -458,6 +540,75 @@ bool BaseDescriptor::Sorter::operator()(IndexPair i, IndexPair j, bool total_ord
     return total_ordering ? i.index_in_view < j.index_in_view : 0;
 }
 
+Mixed BaseDescriptor::Sorter::get_value(size_t t, IndexPair i) const
+{
+    REALM_ASSERT_DEBUG(t > 0);
+    auto& col = m_columns[t];
+    if (!col.has_value[i.index_in_view]) {
+        ObjKey key = col.translated_keys.empty() ? i.key_for_object : col.translated_keys[i.index_in_view];
+        col.values[i.index_in_view] = col.col_key.get_value(col.table->get_object(key));
+        col.has_value[i.index_in_view] = true;
+    }
+    return col.values[i.index_in_view];
+}
+
+void BaseDescriptor::Sorter::cache_values(const IndexPair* begin, const IndexPair* end) const
+{
+    for (size_t t = 1; t < m_columns.size(); t++) {
+        auto& translated_keys = m_columns[t].translated_keys;
+        for (auto i = begin; i != end; ++i) {
+            // Rows with a null link are ordered without reading the value
+            if (translated_keys.empty() || translated_keys[i->index_in_view])
+                get_value(t, *i);
+        }
+    }
+}
+
+bool BaseDescriptor::Sorter::can_hash() const
+{
+    // Values which compare equal must have the same hash. Decimals have several
+    // representations of the same number, and values of different types compare
+    // equal in Mixed and dictionary columns, so those are left to the sort.
+    return std::all_of(m_columns.begin(), m_columns.end(), [](auto&& col) {
+        auto type = ColKey(col.col_key).get_type();
+        return !col.col_key.has_index() && type != col_type_Mixed && type != col_type_Decimal;
+    });
+}
+
+size_t BaseDescriptor::Sorter::hash(IndexPair i) const
+{
+    auto hash_value = [](Mixed val) -> size_t {
+        if (val.is_null())
+            return 0;
+        switch (val.get_type()) {
+            case type_Link:
+                return size_t(val.get<ObjKey>().value);
+            // -0 and 0 compare equal, but are different bit patterns
+            case type_Float:
+                return val.get_float() == 0 ? 0 : val.hash();
+            case type_Double:
+                return val.get_double() == 0 ? 0 : val.hash();
+            default:
+                return val.hash();
+        }
+    };
+    size_t h = hash_value(i.cached_value);
+    for (size_t t = 1; t < m_columns.size(); t++)
+        h = h * 31 + hash_value(get_value(t, i));
+    return h;
+}
+
+bool BaseDescriptor::Sorter::equal(IndexPair i, IndexPair j) const
+{
+    if (i.cached_value.compare(j.cached_value) != 0)
+        return false;
+    for (size_t t = 1; t < m_columns.size(); t++) {
+        if (get_value(t, i).compare(get_value(t, j)) != 0)
+            return false;
+    }
+    return true;
+}
+
 void BaseDescriptor::Sorter::cache_first_column(IndexPairs& v)
 {
     if (m_columns.empty())
@@ -97,6 +97,27 @@ public:
         }
         void cache_first_column(IndexPairs& v);
 
+        // Distinct can find duplicates by hash rather than by sorting if the
+        // hash of the columns is consistent with their ordering. The first
+        // column must have been cached.
+        bool can_hash() const;
+        size_t hash(IndexPair i) const;
+        bool equal(IndexPair i, IndexPair j) const;
+
+        // Sort on up to this many threads. This is only set for frozen tables, which may be read from several
+        // threads at once.
+        void set_parallelism(size_t num_threads) noexcept
+        {
+            m_parallelism = num_threads;
+        }
+        size_t get_parallelism() const noexcept
+        {
+            return m_parallelism;
+        }
+        // Read the values of all but the first column for the given rows, so that comparing them later does not
+        // modify the sorter. Different threads may do this for different rows at the same time.
+        void cache_values(const IndexPair* begin, const IndexPair* end) const;
+
     private:
         struct SortColumn {
             SortColumn(const Table* t, ExtendedColumnKey c, bool a)
@@ -106,18 +127,20 @@ public:
             {
             }
             std::vector<ObjKey> translated_keys;
+            // The values of all but the first column, by index_in_view. They are read the first time they are
+            // needed to break a tie, and kept for the remaining comparisons.
+            mutable std::vector<Mixed> values;
+            // Not a vector<bool>, so that threads may set the flags of different rows at the same time
+            mutable std::vector<uint8_t> has_value;
 
             const Table* table;
             ExtendedColumnKey col_key;
             bool ascending;
         };
         std::vector<SortColumn> m_columns;
-        struct ObjCache {
-            ObjKey key;
-            Mixed value;
-        };
-        using TableCache = std::vector<ObjCache>;
-        mutable std::vector<TableCache> m_cache;
+        size_t m_parallelism = 1;
+
+        Mixed get_value(size_t column, IndexPair i) const;
 
         friend class ObjList;
     };
@@ -164,6 +187,18 @@ public:
     }
     void collect_dependencies(const Table* table, std::vector<TableKey>& table_keys) const override;
 
+    // If this descriptor refers to exactly one column of the table itself (not
+    // following links or into a collection), return it. Otherwise return a
+    // null key.
+    ColKey get_single_column() const noexcept;
+    // If all the columns of this descriptor are columns of the table itself,
+    // return them. Otherwise return an empty vector.
+    std::vector<ColKey> get_table_columns() const;
+    const std::vector<std::vector<ExtendedColumnKey>>& get_column_keys() const noexcept
+    {
+        return m_column_keys;
+    }
+
 protected:
     std::vector<std::vector<ExtendedColumnKey>> m_column_keys;
 };
@@ -28,6 +28,7 @@ Spec::~Spec() noexcept {}
 void Spec::detach() noexcept
 {
     m_top.detach();
+    m_name_index.clear();
 }
 
 bool Spec::init(ref_type ref) noexcept
@@ -75,6 +76,7 @@ void Spec::init(MemRef mem) noexcept
 
 
     update_internals();
+    update_name_index();
 }
 
 void Spec::update_internals() noexcept
@@ -90,6 +92,13 @@ void Spec::update_internals() noexcept
     }
 }
 
+void Spec::update_name_index() noexcept
+{
+    m_name_index.build(m_names.size(), [this](size_t ndx) {
+        return m_names.get(ndx);
+    });
+}
+
 void Spec::update_from_parent() noexcept
 {
     m_top.update_from_parent();
@@ -198,6 +207,7 @@ void Spec::insert_column(size_t column_ndx, ColKey col_key, ColumnType type, Str
     if (type != col_type_BackLink) {
         m_names.insert(column_ndx, name); // Throws
         m_num_public_columns++;
+        update_name_index();
     }
 
     m_types.insert(column_ndx, int(type)); // Throws
@@ -240,6 +250,7 @@ void Spec::erase_column(size_t column_ndx)
         }
         m_num_public_columns--;
         m_names.erase(column_ndx); // Throws
+        update_name_index();
     }
 
     // Delete the entries common for all columns
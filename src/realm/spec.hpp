@@ -25,6 +25,7 @@
 #include <realm/data_type.hpp>
 #include <realm/column_type.hpp>
 #include <realm/keys.hpp>
+#include <realm/util/name_index.hpp>
 
 namespace realm {
 
@@ -104,12 +105,16 @@ private:
     Array m_enumkeys;         // 5th slot in m_top
     Array m_keys;             // 6th slot in m_top
     size_t m_num_public_columns = 0;
+    // Speeds up get_column_index() for tables with many columns. Rebuilt
+    // whenever the names may have changed.
+    util::NameIndex m_name_index;
 
     Spec(Allocator&) noexcept; // Unattached
 
     bool init(ref_type) noexcept;
     void init(MemRef) noexcept;
     void update_internals() noexcept;
+    void update_name_index() noexcept;
 
     // Returns true in case the ref has changed.
     bool init_from_parent() noexcept;
@@ -196,6 +201,7 @@ inline void Spec::rename_column(size_t column_ndx, StringData new_name)
 {
     REALM_ASSERT(column_ndx < m_types.size());
     m_names.set(column_ndx, new_name);
+    update_name_index();
 }
 
 inline size_t Spec::get_column_count() const noexcept
@@ -252,6 +258,11 @@ inline StringData Spec::get_column_name(size_t ndx) const noexcept
 
 inline size_t Spec::get_column_index(StringData name) const noexcept
 {
+    if (m_name_index.is_built() && name.size() != 0) {
+        return m_name_index.find(name, [this](size_t ndx) {
+            return m_names.get(ndx);
+        });
+    }
     return m_names.find_first(name);
 }
 
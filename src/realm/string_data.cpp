@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include "string_data.hpp"
+#include "string_search.hpp"
 
 #include <vector>
 
@@ -128,6 +129,22 @@ bool StringData::matchlike_ins(const StringData& text, const StringData& pattern
     return ::matchlike<true>(text, pattern_upper, &pattern_lower);
 }
 
+size_t realm::search_substring(StringData haystack, StringData needle) noexcept
+{
+    REALM_ASSERT_DEBUG(needle.size() > 0);
+    const char* data = haystack.data();
+    const char* n = needle.data();
+    size_t needle_size = needle.size();
+    char first = n[0];
+    char last = n[needle_size - 1];
+    // The first and the last byte have been matched by the filter
+    auto verify = [&](size_t pos) {
+        return needle_size <= 2 || std::memcmp(data + pos + 1, n + 1, needle_size - 2) == 0;
+    };
+    size_t pos = string_search::find(data, haystack.size(), needle_size, {first, first, last, last}, verify);
+    return pos == npos ? haystack.size() : pos;
+}
+
 
 namespace {
 template <size_t = sizeof(void*)>
@@ -0,0 +1,235 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_STRING_SEARCH_HPP
+#define REALM_STRING_SEARCH_HPP
+
+#include <realm/node.hpp>
+#include <realm/utilities.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef REALM_COMPILER_SSE
+#include <emmintrin.h> // SSE2
+#endif
+#ifdef REALM_COMPILER_AVX
+#include <immintrin.h> // AVX2, only used from functions marked REALM_TARGET_AVX2
+#endif
+#ifdef REALM_COMPILER_NEON
+#include <arm_neon.h>
+#endif
+
+// Substring search kernels shared by the case sensitive and the case
+// insensitive string conditions. Only to be included from .cpp files.
+//
+// A position can only hold the needle if the byte there matches the first
+// byte of the needle, and the byte `needle_size - 1` further on matches its
+// last byte. Those two tests are done for a whole vector of positions at a
+// time, and the few positions passing both are then verified in full. Each
+// byte may match one of two values, which are the upper and lower case form
+// of the byte for the case insensitive search, and the same value twice
+// otherwise.
+
+namespace realm::string_search {
+
+struct Filter {
+    char first_1;
+    char first_2;
+    char last_1;
+    char last_2;
+};
+
+namespace detail {
+
+template <class Verify>
+REALM_FORCEINLINE size_t find_scalar(const char* data, size_t begin, size_t end, size_t needle_size,
+                                     const Filter& filter, Verify& verify)
+{
+    for (size_t pos = begin; pos < end; ++pos) {
+        char first = data[pos];
+        char last = data[pos + needle_size - 1];
+        if ((first == filter.first_1 || first == filter.first_2) &&
+            (last == filter.last_1 || last == filter.last_2) && verify(pos))
+            return pos;
+    }
+    return npos;
+}
+
+// Calls `verify` for each candidate in `mask`, where bit i is position pos + i
+template <class Verify>
+REALM_FORCEINLINE size_t verify_candidates(uint32_t mask, size_t pos, Verify& verify)
+{
+    while (mask) {
+        size_t candidate = pos + ctz(mask);
+        if (verify(candidate))
+            return candidate;
+        mask &= mask - 1;
+    }
+    return npos;
+}
+
+#ifdef REALM_COMPILER_SSE
+template <class Verify>
+size_t find_sse2(const char* data, size_t& pos, size_t end, size_t needle_size, const Filter& filter,
+                 Verify& verify)
+{
+    const __m128i first_1 = _mm_set1_epi8(filter.first_1);
+    const __m128i first_2 = _mm_set1_epi8(filter.first_2);
+    const __m128i last_1 = _mm_set1_epi8(filter.last_1);
+    const __m128i last_2 = _mm_set1_epi8(filter.last_2);
+    for (; pos + 16 <= end; pos += 16) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + needle_size - 1));
+        __m128i match_first = _mm_or_si128(_mm_cmpeq_epi8(first, first_1), _mm_cmpeq_epi8(first, first_2));
+        __m128i match_last = _mm_or_si128(_mm_cmpeq_epi8(last, last_1), _mm_cmpeq_epi8(last, last_2));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(_mm_and_si128(match_first, match_last)));
+        size_t found = verify_candidates(mask, pos, verify);
+        if (found != npos)
+            return found;
+    }
+    return npos;
+}
+#endif
+
+#ifdef REALM_COMPILER_AVX
+template <class Verify>
+REALM_TARGET_AVX2 size_t find_avx2(const char* data, size_t& pos, size_t end, size_t needle_size,
+                                   const Filter& filter, Verify& verify)
+{
+    const __m256i first_1 = _mm256_set1_epi8(filter.first_1);
+    const __m256i first_2 = _mm256_set1_epi8(filter.first_2);
+    const __m256i last_1 = _mm256_set1_epi8(filter.last_1);
+    const __m256i last_2 = _mm256_set1_epi8(filter.last_2);
+    for (; pos + 32 <= end; pos += 32) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + needle_size - 1));
+        __m256i match_first =
+            _mm256_or_si256(_mm256_cmpeq_epi8(first, first_1), _mm256_cmpeq_epi8(first, first_2));
+        __m256i match_last = _mm256_or_si256(_mm256_cmpeq_epi8(last, last_1), _mm256_cmpeq_epi8(last, last_2));
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(_mm256_and_si256(match_first, match_last)));
+        size_t found = verify_candidates(mask, pos, verify);
+        if (found != npos)
+            return found;
+    }
+    return npos;
+}
+#endif
+
+#ifdef REALM_COMPILER_NEON
+template <class Verify>
+size_t find_neon(const char* data, size_t& pos, size_t end, size_t needle_size, const Filter& filter,
+                 Verify& verify)
+{
+    const uint8x16_t first_1 = vdupq_n_u8(uint8_t(filter.first_1));
+    const uint8x16_t first_2 = vdupq_n_u8(uint8_t(filter.first_2));
+    const uint8x16_t last_1 = vdupq_n_u8(uint8_t(filter.last_1));
+    const uint8x16_t last_2 = vdupq_n_u8(uint8_t(filter.last_2));
+    for (; pos + 16 <= end; pos += 16) {
+        uint8x16_t first = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+        uint8x16_t last = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos + needle_size - 1));
+        uint8x16_t match = vandq_u8(vorrq_u8(vceqq_u8(first, first_1), vceqq_u8(first, first_2)),
+                                    vorrq_u8(vceqq_u8(last, last_1), vceqq_u8(last, last_2)));
+        // Narrow each byte to 4 bits, giving a 64 bit mask with 4 bits per position
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+        while (nibbles) {
+            size_t candidate = pos + size_t(ctz(size_t(nibbles)) / 4);
+            if (verify(candidate))
+                return candidate;
+            nibbles &= ~(uint64_t(0xf) << ((candidate - pos) * 4));
+        }
+    }
+    return npos;
+}
+#endif
+
+} // namespace detail
+
+/// Returns the first position in `[0, size - needle_size]` that passes the
+/// filter and for which `verify(pos)` returns true, or npos if there is none.
+/// `needle_size` must be at least 1.
+template <class Verify>
+size_t find(const char* data, size_t size, size_t needle_size, const Filter& filter, Verify verify)
+{
+    if (needle_size > size)
+        return npos;
+    // Positions in [0, end) may hold the needle. A vector of first bytes at
+    // `pos` is loaded along with the one of last bytes `needle_size - 1`
+    // further on, so the vector loops process whole vectors of positions
+    // while `pos + vector size <= end`.
+    size_t end = size - needle_size + 1;
+    size_t pos = 0;
+    size_t found = npos;
+#if defined(REALM_COMPILER_AVX)
+    if (sseavx<2>())
+        found = detail::find_avx2(data, pos, end, needle_size, filter, verify);
+#endif
+#if defined(REALM_COMPILER_SSE)
+    if (found == npos)
+        found = detail::find_sse2(data, pos, end, needle_size, filter, verify);
+#elif defined(REALM_COMPILER_NEON)
+    found = detail::find_neon(data, pos, end, needle_size, filter, verify);
+#endif
+    if (found != npos)
+        return found;
+    return detail::find_scalar(data, pos, end, needle_size, filter, verify);
+}
+
+/// Returns true if each byte of `data` equals the byte at the same position
+/// in either `a` or `b`. If it returns true, `ascii` tells whether all bytes of
+/// `data` are 7 bit ASCII.
+inline bool equal_either(const char* data, const char* a, const char* b, size_t size, bool& ascii) noexcept
+{
+    size_t i = 0;
+    unsigned high = 0;
+#if defined(REALM_COMPILER_SSE)
+    __m128i high_bits = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i eq_a = _mm_cmpeq_epi8(d, _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        __m128i eq_b = _mm_cmpeq_epi8(d, _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if (_mm_movemask_epi8(_mm_or_si128(eq_a, eq_b)) != 0xffff)
+            return false;
+        high_bits = _mm_or_si128(high_bits, d);
+    }
+    high = unsigned(_mm_movemask_epi8(high_bits));
+#elif defined(REALM_COMPILER_NEON)
+    uint8x16_t high_bits = vdupq_n_u8(0);
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t d = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        uint8x16_t eq = vorrq_u8(vceqq_u8(d, vld1q_u8(reinterpret_cast<const uint8_t*>(a + i))),
+                                 vceqq_u8(d, vld1q_u8(reinterpret_cast<const uint8_t*>(b + i))));
+        if (vminvq_u8(eq) != 0xff)
+            return false;
+        high_bits = vorrq_u8(high_bits, d);
+    }
+    high = vmaxvq_u8(high_bits) & 0x80;
+#endif
+    for (; i < size; ++i) {
+        char c = data[i];
+        if (c != a[i] && c != b[i])
+            return false;
+        high |= unsigned(static_cast<unsigned char>(c)) & 0x80;
+    }
+    ascii = (high == 0);
+    return true;
+}
+
+} // namespace realm::string_search
+
+#endif // REALM_STRING_SEARCH_HPP
@@ -216,6 +216,107 @@ void Changeset::print() const
 }
 
 
+void Changeset::append(const Changeset& other)
+{
+    std::vector<InternString> strings;
+    strings.reserve(other.m_strings.size()); // Throws
+    for (size_t i = 0; i < other.m_strings.size(); ++i)
+        strings.push_back(intern_string(other.get_string(other.m_strings[i]))); // Throws
+
+    auto translate_intern_string = [&](InternString& str) {
+        if (str != InternString::npos)
+            str = strings[str.value];
+    };
+
+    auto translate_key = [&](Instruction::PrimaryKey& key) {
+        mpark::visit(util::overload{[&](InternString& str) {
+                                        translate_intern_string(str);
+                                    },
+                                    [](auto&&) {}},
+                     key);
+    };
+
+    auto translate_payload = [&](Instruction::Payload& payload) {
+        using Type = Instruction::Payload::Type;
+        switch (payload.type) {
+            case Type::String:
+                payload.data.str = append_string(other.get_string(payload.data.str)); // Throws
+                return;
+            case Type::Binary:
+                payload.data.binary = append_string(other.get_string(payload.data.binary)); // Throws
+                return;
+            case Type::Link:
+                translate_intern_string(payload.data.link.target_table);
+                translate_key(payload.data.link.target);
+                return;
+            default:
+                return;
+        }
+    };
+
+    auto translate_path = [&](Instruction::Path& path) {
+        for (size_t i = 0; i < path.size(); ++i) {
+            mpark::visit(util::overload{[&](InternString& str) {
+                                            translate_intern_string(str);
+                                        },
+                                        [](auto&&) {}},
+                         path[i]);
+        }
+    };
+
+    for (auto other_instr : other) {
+        if (!other_instr)
+            continue;
+        Instruction instr = *other_instr;
+
+        if (auto table_instr = instr.get_if<Instruction::TableInstruction>()) {
+            translate_intern_string(table_instr->table);
+            if (auto object_instr = instr.get_if<Instruction::ObjectInstruction>()) {
+                translate_key(object_instr->object);
+
+                if (auto path_instr = instr.get_if<Instruction::PathInstruction>()) {
+                    translate_intern_string(path_instr->field);
+                    translate_path(path_instr->path);
+                }
+
+                if (auto set_instr = instr.get_if<Instruction::Update>()) {
+                    translate_payload(set_instr->value);
+                }
+                else if (auto insert_instr = instr.get_if<Instruction::ArrayInsert>()) {
+                    translate_payload(insert_instr->value);
+                }
+                else if (auto set_insert_instr = instr.get_if<Instruction::SetInsert>()) {
+                    translate_payload(set_insert_instr->value);
+                }
+                else if (auto set_erase_instr = instr.get_if<Instruction::SetErase>()) {
+                    translate_payload(set_erase_instr->value);
+                }
+            }
+            else if (auto add_table_instr = instr.get_if<Instruction::AddTable>()) {
+                mpark::visit(util::overload{
+                                 [&](Instruction::AddTable::TopLevelTable& spec) {
+                                     translate_intern_string(spec.pk_field);
+                                 },
+                                 [](Instruction::AddTable::EmbeddedTable&) {},
+                             },
+                             add_table_instr->type);
+            }
+            else if (auto add_column_instr = instr.get_if<Instruction::AddColumn>()) {
+                translate_intern_string(add_column_instr->field);
+                translate_intern_string(add_column_instr->link_target_table);
+            }
+            else if (auto erase_column_instr = instr.get_if<Instruction::EraseColumn>()) {
+                translate_intern_string(erase_column_instr->field);
+            }
+        }
+        else {
+            REALM_TERMINATE("Corrupt instruction type");
+        }
+
+        push_back(instr); // Throws
+    }
+}
+
 void Changeset::verify() const
 {
     for (size_t i = 0; i < m_strings.size(); ++i) {
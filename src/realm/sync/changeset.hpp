@@ -89,6 +89,11 @@ struct Changeset {
     /// Insert an instruction at the end, invalidating all iterators.
     void push_back(const Instruction&);
 
+    /// Insert the instructions of \a other at the end, translating their
+    /// interned strings and string values into this changeset. Invalidates
+    /// all iterators. The version and origin of this changeset are unchanged.
+    void append(const Changeset& other);
+
     //@{
     /// Insert instructions at \a position without invalidating other
     /// iterators.
@@ -123,6 +128,9 @@ struct Changeset {
     /// subsequent element if that element was previously inserted with
     /// `insert_stable()`, or otherwise it will be turned into a tombstone.
     iterator erase_stable(const_iterator position);
+    /// Same as above, but tombstones are only skipped up to \a end, and the
+    /// instructions beyond it are not accessed.
+    iterator erase_stable(const_iterator position, const_iterator end);
 
 #if REALM_DEBUG
     struct Reflector;
@@ -595,10 +603,16 @@ inline Changeset::iterator Changeset::insert_stable(const_iterator cpos, InputIt
 }
 
 inline Changeset::iterator Changeset::erase_stable(const_iterator cpos)
+{
+    return erase_stable(cpos, cend());
+}
+
+inline Changeset::iterator Changeset::erase_stable(const_iterator cpos, const_iterator cend)
 {
     auto pos = const_iterator_to_iterator(cpos);
     auto begin = m_instructions.begin();
-    auto end = m_instructions.end();
+    // The slot containing `cend` is accessed only if `cend` is not at its start
+    auto end = const_iterator_to_iterator(cend).m_inner + (cend.m_pos == 0 ? 0 : 1);
     REALM_ASSERT(pos.m_inner >= begin);
     REALM_ASSERT(pos.m_inner < end);
     pos.m_inner->erase(pos.m_pos);
@@ -7,9 +7,12 @@
 #include <realm/sync/instructions.hpp>
 #include <realm/sync/noinst/integer_codec.hpp>
 #include <realm/table.hpp>
+#include <realm/util/alloc_tracking.hpp>
 #include <realm/util/base64.hpp>
 
+#include <string_view>
 #include <unordered_set>
+#include <vector>
 
 using namespace realm;
 using namespace realm::sync;
@@ -23,9 +26,13 @@ struct State {
     explicit State(util::InputStream& input, InstructionHandler& handler)
         : m_input(input)
         , m_handler(handler)
+        , m_intern_strings(0, InternStringHash{*this}, InternStringEqual{*this})
     {
     }
 
+    State(const State&) = delete;
+    State& operator=(const State&) = delete;
+
     // pointer into transaction log, each instruction is parsed from m_input_begin and onwards.
     // Each instruction are assumed to be contiguous in memory.
     const char* m_input_begin = nullptr;
@@ -36,9 +43,34 @@ struct State {
     const char* m_input_end = nullptr;
 
     std::string m_buffer;
-    // Cannot use StringData as key type since m_input_begin may start pointing
-    // to a new chunk of memory.
-    std::unordered_set<std::string> m_intern_strings;
+
+    // The interned strings are only kept to detect duplicates. Since
+    // m_input_begin may start pointing to a new chunk of memory, they are
+    // copied back to back into a single buffer, and the set holds their
+    // indices, which avoids an allocation per interned string.
+    std::string m_intern_string_data;
+    std::vector<size_t> m_intern_string_ends;
+    struct InternStringHash {
+        const State& state;
+        size_t operator()(uint32_t index) const noexcept
+        {
+            return std::hash<std::string_view>{}(state.get_intern_string(index));
+        }
+    };
+    struct InternStringEqual {
+        const State& state;
+        bool operator()(uint32_t a, uint32_t b) const noexcept
+        {
+            return state.get_intern_string(a) == state.get_intern_string(b);
+        }
+    };
+    std::unordered_set<uint32_t, InternStringHash, InternStringEqual> m_intern_strings;
+
+    std::string_view get_intern_string(uint32_t index) const noexcept
+    {
+        size_t begin = index == 0 ? 0 : m_intern_string_ends[index - 1];
+        return std::string_view(m_intern_string_data).substr(begin, m_intern_string_ends[index] - begin);
+    }
 
 
     void parse_one(); // Throws
@@ -340,11 +372,13 @@ void State::parse_one()
 
     if (t == InstrTypeInternString) {
         uint32_t index = read_int<uint32_t>();
-        if (index != m_intern_strings.size()) {
+        if (index != m_intern_string_ends.size()) {
             parser_error(util::format("Unexpected intern index: %1", index));
         }
         StringData str = read_string();
-        if (!m_intern_strings.insert(str).second) {
+        m_intern_string_data.append(str.data(), str.size());
+        m_intern_string_ends.push_back(m_intern_string_data.size());
+        if (!m_intern_strings.insert(index).second) {
             parser_error(util::format("Unexpected intern string: %1", str));
         }
         StringBufferRange range = m_handler.add_string_range(str);
@@ -527,8 +561,19 @@ template <class T>
 T State::read_int()
 {
     T value = 0;
-    if (REALM_LIKELY(_impl::decode_int(*this, value)))
+    // Most integers are decoded straight from the current chunk, which only
+    // needs to be checked for the maximum encoded size once rather than for
+    // each byte. Only integers near the end of a chunk take the slow path.
+    constexpr size_t max_bytes = _impl::encode_int_max_bytes<T>();
+    if (REALM_LIKELY(size_t(m_input_end - m_input_begin) >= max_bytes)) {
+        if (size_t n = _impl::decode_int_unchecked(m_input_begin, value); REALM_LIKELY(n != 0)) {
+            m_input_begin += n;
+            return value;
+        }
+    }
+    else if (REALM_LIKELY(_impl::decode_int(*this, value))) {
         return value;
+    }
     parser_error("bad changeset - integer decoding failure");
 }
 
@@ -585,7 +630,7 @@ double State::read_double()
 InternString State::read_intern_string()
 {
     uint32_t index = read_int<uint32_t>(); // Throws
-    if (index >= m_intern_strings.size())
+    if (index >= m_intern_string_ends.size())
         parser_error("Invalid interned string");
     return InternString{index};
 }
@@ -682,6 +727,7 @@ namespace realm::sync {
 
 void parse_changeset(util::InputStream& input, Changeset& out_log)
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::sync_parse};
     InstructionBuilder builder{out_log};
     State state{input, builder};
 
@@ -1,4 +1,5 @@
 
+#include <future>
 #include <memory>
 #include <tuple>
 #include <atomic>
@@ -157,6 +158,7 @@ private:
     const Optional<std::string> m_ssl_trust_certificate_path;
     const std::function<SyncConfig::SSLVerifyCallback> m_ssl_verify_callback;
     const size_t m_flx_bootstrap_batch_size_bytes;
+    const bool m_flx_streaming_bootstrap;
 
     // This one is different from null when, and only when the session wrapper
     // is in ClientImpl::m_abandoned_session_wrappers.
@@ -769,6 +771,8 @@ void SessionImpl::initiate_integrate_changesets(std::uint_fast64_t downloadable_
         }
         version_type client_version;
         if (REALM_LIKELY(!get_client().is_dry_run())) {
+            if (initiate_background_integration(downloadable_bytes, batch_state, progress, changesets)) // Throws
+                return;
             VersionInfo version_info;
             integrate_changesets(progress, downloadable_bytes, changesets, version_info, batch_state); // Throws
             client_version = version_info.realm_version;
@@ -785,6 +789,79 @@ void SessionImpl::initiate_integrate_changesets(std::uint_fast64_t downloadable_
 }
 
 
+bool SessionImpl::initiate_background_integration(std::uint_fast64_t downloadable_bytes,
+                                                  DownloadBatchState batch_state, const SyncProgress& progress,
+                                                  const ReceivedChangesets& changesets)
+{
+    // Bootstrap batches stay on the event loop thread, as do sessions with a debug hook, which expects to observe
+    // the integration synchronously.
+    IntegrationWorkerPool* workers = get_client().m_integration_workers.get();
+    if (!workers || changesets.empty() || batch_state == DownloadBatchState::MoreToCome || m_wrapper.m_debug_hook)
+        return false;
+    REALM_ASSERT(!m_background_integration);
+
+    auto job = std::make_shared<BackgroundIntegration>();
+    job->progress = progress;
+    job->downloadable_bytes = downloadable_bytes;
+    job->batch_state = batch_state;
+
+    // The changesets point into the input buffer of the connection, which is reused for the next message. Received
+    // changesets always consist of a single chunk.
+    size_t total_size = 0;
+    for (const auto& changeset : changesets)
+        total_size += changeset.data.get_first_chunk().size();
+    job->changeset_data = std::make_unique<char[]>(total_size); // Throws
+    job->changesets.reserve(changesets.size());                 // Throws
+    char* data = job->changeset_data.get();
+    for (const auto& changeset : changesets) {
+        BinaryData chunk = changeset.data.get_first_chunk();
+        std::copy(chunk.data(), chunk.data() + chunk.size(), data);
+        auto& copy = job->changesets.emplace_back(changeset);
+        copy.data = BinaryData(data, chunk.size());
+        data += chunk.size();
+    }
+
+    // The completion is posted before the job is marked as done, so that a session waiting for it in its
+    // destructor cannot let the client drain its event loop before the post is accounted for.
+    auto completion = [self = util::bind_ptr<SessionWrapper>(&m_wrapper), job](Status status) {
+        if (status == ErrorCodes::OperationAborted)
+            return;
+        else if (!status.is_ok())
+            throw Exception(status);
+        if (REALM_UNLIKELY(!self->m_sess))
+            return; // Already finalized
+        SessionImpl& sess = *self->m_sess;
+        // The outcome may already have been processed by wait_for_background_integration().
+        if (sess.m_background_integration == job)
+            sess.complete_background_integration(true); // Throws
+    };
+    m_background_integration = job;
+    workers->submit([db = get_db(), history = &get_history(), logger = &logger, job,
+                     completion = std::move(completion), client = &get_client()]() mutable {
+        try {
+            auto transact = db->start_read();
+            history->integrate_server_changesets(job->progress, &job->downloadable_bytes, job->changesets,
+                                                 job->version_info, job->batch_state, *logger,
+                                                 transact); // Throws
+            job->integration_metrics = history->get_last_integration_metrics();
+        }
+        catch (const IntegrationException& e) {
+            job->error = e;
+        }
+        catch (...) {
+            job->unexpected_error = std::current_exception();
+        }
+        client->post(std::move(completion));
+        {
+            std::lock_guard lock(job->mutex);
+            job->done = true;
+        }
+        job->cv.notify_all();
+    });
+    return true;
+}
+
+
 void SessionImpl::on_upload_completion()
 {
     // Ignore the call if the session is not active
@@ -848,6 +925,19 @@ bool SessionImpl::process_flx_bootstrap_message(const SyncProgress& progress, Do
         return false;
     }
 
+    if (m_wrapper.m_flx_streaming_bootstrap) {
+        try {
+            process_streaming_flx_bootstrap_message(progress, batch_state, query_version, received_changesets);
+        }
+        catch (const IntegrationException& e) {
+            on_integration_failure(e);
+        }
+        catch (...) {
+            on_integration_failure(IntegrationException(exception_to_status()));
+        }
+        return true;
+    }
+
     auto bootstrap_store = m_wrapper.get_flx_pending_bootstrap_store();
     util::Optional<SyncProgress> maybe_progress;
     if (batch_state == DownloadBatchState::LastInBatch) {
@@ -909,6 +999,106 @@ bool SessionImpl::process_flx_bootstrap_message(const SyncProgress& progress, Do
 }
 
 
+void SessionImpl::process_streaming_flx_bootstrap_message(const SyncProgress& progress,
+                                                          DownloadBatchState batch_state, int64_t query_version,
+                                                          const ReceivedChangesets& received_changesets)
+{
+    auto& bootstrap = m_streaming_bootstrap;
+    if (bootstrap.transact && bootstrap.query_version != query_version) {
+        logger.info("Incomplete streaming bootstrap found for query version %1", bootstrap.query_version);
+        abort_streaming_flx_bootstrap();
+    }
+
+    if (!bootstrap.transact) {
+        // Marking the subscription as bootstrapping writes to the subscription store, so it must happen before the
+        // write lock is taken for the rest of the bootstrap.
+        if (batch_state == DownloadBatchState::MoreToCome) {
+            on_flx_sync_progress(query_version, DownloadBatchState::MoreToCome);
+        }
+        logger.info("Begin streaming FLX bootstrap for query version %1 (resume point: server version %2)",
+                    query_version, m_progress.download.server_version);
+        bootstrap.transact = get_db()->start_write(); // Throws
+        bootstrap.query_version = query_version;
+    }
+
+    if (m_wrapper.m_simulate_integration_error && !received_changesets.empty()) {
+        throw IntegrationException(ErrorCodes::BadChangeset, "simulated failure", ProtocolError::bad_changeset);
+    }
+
+    call_debug_hook(SyncClientHookEvent::BootstrapBatchAboutToProcess, progress, query_version, batch_state,
+                    received_changesets.size());
+
+    auto start_time = std::chrono::steady_clock::now();
+    auto& history = get_repl().get_history();
+    bootstrap.downloaded_bytes +=
+        history.integrate_streaming_bootstrap_batch(received_changesets, logger, bootstrap.transact); // Throws
+    bootstrap.changesets_integrated += received_changesets.size();
+    if (!received_changesets.empty()) {
+        bootstrap.last_changeset = received_changesets.back();
+        bootstrap.last_changeset->data = {};
+    }
+    auto duration = std::chrono::steady_clock::now() - start_time;
+    logger.info("Integrated %1 changesets of streaming bootstrap for query version %2 in %3 ms (uncommitted)",
+                received_changesets.size(), query_version,
+                std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+
+    auto hook_action = call_debug_hook(SyncClientHookEvent::BootstrapMessageProcessed, progress, query_version,
+                                       batch_state, received_changesets.size());
+    if (hook_action == SyncClientHookAction::EarlyReturn) {
+        // Nothing of the bootstrap is durable until it is committed, so not committing the last batch amounts to
+        // discarding the bootstrap.
+        if (batch_state == DownloadBatchState::LastInBatch) {
+            abort_streaming_flx_bootstrap();
+        }
+        return;
+    }
+    REALM_ASSERT_EX(hook_action == SyncClientHookAction::NoAction, hook_action);
+
+    if (batch_state == DownloadBatchState::MoreToCome) {
+        notify_download_progress(bootstrap.downloaded_bytes);
+        return;
+    }
+    m_wrapper.m_bootstrap_store_bytes.reset();
+
+    VersionInfo new_version;
+    uint64_t downloadable_bytes = 0;
+    history.commit_streaming_bootstrap(progress, &downloadable_bytes,
+                                       bootstrap.last_changeset ? &*bootstrap.last_changeset : nullptr, new_version,
+                                       bootstrap.transact); // Throws
+    auto changesets_processed = bootstrap.changesets_integrated;
+    bootstrap = {};
+
+    auto action = call_debug_hook(SyncClientHookEvent::DownloadMessageIntegrated, progress, query_version,
+                                  batch_state, changesets_processed);
+    REALM_ASSERT_EX(action == SyncClientHookAction::NoAction, action);
+
+    logger.info("Committed streaming bootstrap of %1 changesets for query version %2, producing client version %3",
+                changesets_processed, query_version, new_version.realm_version);
+
+    on_changesets_integrated(new_version.realm_version, progress, changesets_processed > 0);
+    on_flx_sync_progress(query_version, DownloadBatchState::LastInBatch);
+
+    action = call_debug_hook(SyncClientHookEvent::BootstrapProcessed, progress, query_version,
+                             DownloadBatchState::LastInBatch, changesets_processed);
+    // NoAction/EarlyReturn are both valid no-op actions to take here.
+    REALM_ASSERT_EX(action == SyncClientHookAction::NoAction || action == SyncClientHookAction::EarlyReturn, action);
+}
+
+
+void SessionImpl::abort_streaming_flx_bootstrap()
+{
+    auto& bootstrap = m_streaming_bootstrap;
+    if (!bootstrap.transact) {
+        return;
+    }
+    logger.debug("Discarding %1 changesets of streaming bootstrap for query version %2",
+                 bootstrap.changesets_integrated, bootstrap.query_version);
+    get_repl().get_history().abort_streaming_bootstrap(bootstrap.transact); // Throws
+    bootstrap = {};
+    m_wrapper.m_bootstrap_store_bytes.reset();
+}
+
+
 void SessionImpl::process_pending_flx_bootstrap()
 {
     // Ignore the call if not a flx session or session is not active
@@ -933,11 +1123,29 @@ void SessionImpl::process_pending_flx_bootstrap()
     int64_t query_version = -1;
     size_t changesets_processed = 0;
 
+    // While a batch is transformed and applied, the next one is read, decompressed and parsed on a worker thread.
+    // Only one batch is read ahead, so at most two batches are held in memory at a time.
+    struct ParsedBatch {
+        PendingBootstrapStore::PendingBatch batch;
+        std::vector<Changeset> changesets;
+    };
+    auto read_batch = [bootstrap_store, batch_size = m_wrapper.m_flx_bootstrap_batch_size_bytes](
+                          const TransactionRef& tr, size_t skip) {
+        ParsedBatch ret;
+        ret.batch = bootstrap_store->peek_pending(tr, batch_size, skip);
+        if (ret.batch.progress) {
+            ret.changesets = ClientHistory::parse_server_changesets(ret.batch.changesets); // Throws
+        }
+        return ret;
+    };
+    std::future<ParsedBatch> next_batch;
+
     // Used to commit each batch after it was transformed.
     TransactionRef transact = get_db()->start_write();
     while (bootstrap_store->has_pending()) {
         auto start_time = std::chrono::steady_clock::now();
-        auto pending_batch = bootstrap_store->peek_pending(m_wrapper.m_flx_bootstrap_batch_size_bytes);
+        auto parsed_batch = next_batch.valid() ? next_batch.get() : read_batch(get_db()->start_read(), 0); // Throws
+        auto& pending_batch = parsed_batch.batch;
         if (!pending_batch.progress) {
             logger.info("Incomplete pending bootstrap found for query version %1", pending_batch.query_version);
             // Close the write transation before clearing the bootstrap store to avoid a deadlock because the
@@ -960,9 +1168,17 @@ void SessionImpl::process_pending_flx_bootstrap()
         call_debug_hook(SyncClientHookEvent::BootstrapBatchAboutToProcess, *pending_batch.progress, query_version,
                         batch_state, pending_batch.changesets.size());
 
+        // The batch is at the front of the store until it has been integrated, so the next batch follows it in
+        // the current version
+        if (pending_batch.remaining_changesets > 0) {
+            next_batch = std::async(std::launch::async, read_batch, get_db()->start_frozen(),
+                                    pending_batch.changesets.size());
+        }
+
         history.integrate_server_changesets(
-            *pending_batch.progress, &downloadable_bytes, pending_batch.changesets, new_version, batch_state, logger,
-            transact, [&](const TransactionRef& tr, util::Span<Changeset> changesets_applied) {
+            *pending_batch.progress, &downloadable_bytes, pending_batch.changesets,
+            std::move(parsed_batch.changesets), new_version, batch_state, logger, transact,
+            [&](const TransactionRef& tr, util::Span<Changeset> changesets_applied) {
                 REALM_ASSERT_3(changesets_applied.size(), <=, pending_batch.changesets.size());
                 bootstrap_store->pop_front_pending(tr, changesets_applied.size());
             });
@@ -1220,6 +1436,7 @@ SessionWrapper::SessionWrapper(ClientImpl& client, DBRef db, std::shared_ptr<Sub
     , m_ssl_trust_certificate_path{std::move(config.ssl_trust_certificate_path)}
     , m_ssl_verify_callback{std::move(config.ssl_verify_callback)}
     , m_flx_bootstrap_batch_size_bytes(config.flx_bootstrap_batch_size_bytes)
+    , m_flx_streaming_bootstrap(config.flx_streaming_bootstrap)
     , m_http_request_path_prefix{std::move(config.service_identifier)}
     , m_virt_path{std::move(config.realm_identifier)}
     , m_signed_access_token{std::move(config.signed_user_token)}
@@ -1234,6 +1451,11 @@ SessionWrapper::SessionWrapper(ClientImpl& client, DBRef db, std::shared_ptr<Sub
     REALM_ASSERT(m_db);
     REALM_ASSERT(m_db->get_replication());
     REALM_ASSERT(dynamic_cast<ClientReplication*>(m_db->get_replication()));
+    auto& replication = static_cast<ClientReplication&>(*m_db->get_replication());
+    replication.set_transform_threads(config.transform_threads);
+    replication.set_history_compression_dictionary(config.history_compression_dictionary);
+    replication.get_history().get_reciprocal_transform_cache().set_budget(
+        m_client.m_reciprocal_transform_cache_budget);
     if (m_client_reset_config) {
         m_session_reason = SessionReason::ClientReset;
     }
@@ -2069,6 +2291,7 @@ ClientImpl::Connection::Connection(ClientImpl& client, connection_ident_type ide
     , m_proxy_config{std::move(proxy_config)}                             // DEPRECATED
     , m_reconnect_info{reconnect_info}
     , m_session_history{}
+    , m_output_buffers{std::make_unique<OutputBuffer[]>(client.m_max_batched_messages)} // Throws
     , m_ident{ident}
     , m_server_endpoint{std::move(endpoint)}
     , m_authorization_header_name{authorization_header_name} // DEPRECATED
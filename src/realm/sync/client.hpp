@@ -334,6 +334,25 @@ public:
         /// changeset data in a single integration attempt.
         size_t flx_bootstrap_batch_size_bytes = 1024 * 1024;
 
+        /// Integrate each DOWNLOAD message of a flexible sync bootstrap as it
+        /// arrives, instead of first storing them all in the pending
+        /// bootstrap store. The batches are applied to a single write
+        /// transaction that is only committed once the last one has been
+        /// received, so the bootstrap still becomes visible atomically, but
+        /// local writes are blocked while it is being downloaded.
+        bool flx_streaming_bootstrap = false;
+
+        /// Transform the local changesets through the changesets received
+        /// from the server on up to this many threads. Changes to unrelated
+        /// objects are transformed concurrently, which helps when many local
+        /// changes were made while offline.
+        size_t transform_threads = 1;
+
+        /// Compress the changesets stored in the history with a dictionary
+        /// trained from the first ones (see
+        /// ClientReplication::set_history_compression_dictionary()).
+        bool history_compression_dictionary = false;
+
         /// Set to true to cause the integration of the first received changeset
         /// (in a DOWNLOAD message) to fail.
         ///
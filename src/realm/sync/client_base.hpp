@@ -75,6 +75,62 @@ static constexpr milliseconds_type default_fast_reconnect_limit = 60000;    // 1
 
 using RoundtripTimeHandler = void(milliseconds_type roundtrip_time);
 
+/// \brief Where the time went when a session processed a DOWNLOAD or an UPLOAD
+/// message.
+///
+/// Reported through ClientConfig::session_telemetry_handler once for every
+/// DOWNLOAD message after its changesets have been integrated, and once for
+/// every UPLOAD message after it has been handed to the socket. The fields
+/// which do not apply to the direction of the message are zero, as are the
+/// integration fields of the messages of an FLX bootstrap, whose integration
+/// spans several messages.
+struct SessionTelemetry {
+    enum class Message { download, upload };
+    Message message = Message::download;
+
+    /// The local Realm file of the session.
+    std::string realm_path;
+
+    std::size_t num_changesets = 0;
+    /// The size of the message on the wire, and of its body before
+    /// compression.
+    std::size_t message_size = 0;
+    std::size_t uncompressed_body_size = 0;
+    /// Time spent decompressing (DOWNLOAD) or compressing (UPLOAD) the body.
+    std::chrono::microseconds compression_time{0};
+
+    /// DOWNLOAD: time from the receipt of the message until the session
+    /// started processing it, which is spent waiting for the integration of
+    /// the previous message when that happens in the background.
+    std::chrono::microseconds queue_time{0};
+    /// DOWNLOAD: time spent parsing the message and its changesets,
+    /// transforming them against the local changes, applying them to the
+    /// Realm, and committing the result.
+    std::chrono::microseconds parse_time{0};
+    std::chrono::microseconds transform_time{0};
+    std::chrono::microseconds apply_time{0};
+    std::chrono::microseconds commit_time{0};
+    /// DOWNLOAD: the number of local changesets the downloaded ones were
+    /// transformed against, and how many of those conflicted with them, i.e.
+    /// were modified by the transformation.
+    std::size_t reciprocal_changesets = 0;
+    std::size_t conflicting_changesets = 0;
+
+    /// UPLOAD: time spent finding the changesets to upload in the history,
+    /// encoding the message (excluding compression), and sending it, from
+    /// handing it to the connection until the socket reported the write as
+    /// complete.
+    std::chrono::microseconds find_time{0};
+    std::chrono::microseconds encode_time{0};
+    std::chrono::microseconds send_time{0};
+
+    /// The time from the receipt of the DOWNLOAD message, or from the start of
+    /// the preparation of the UPLOAD message, until it was fully processed.
+    std::chrono::microseconds total_time{0};
+};
+
+using SessionTelemetryHandler = void(const SessionTelemetry&);
+
 struct ClientConfig {
     /// An optional logger to be used by the client. If no logger is
     /// specified, the client will use an instance of util::StderrLogger
@@ -197,6 +253,19 @@ struct ClientConfig {
     /// consumption.
     bool disable_upload_compaction = false;
 
+    /// If nonzero, consecutive local changesets whose commit times are at most
+    /// this many milliseconds apart are merged into a single changeset before
+    /// they are uploaded, as long as their combined size does not exceed
+    /// `upload_coalescing_max_size`. This reduces the protocol overhead and the
+    /// work of the server for applications that make many small commits. The
+    /// merged changeset is uploaded with the commit time of the last of them,
+    /// which is used to resolve conflicting writes.
+    milliseconds_type upload_coalescing_window = 0;
+
+    /// The maximum combined size in bytes of the changesets merged into one
+    /// by `upload_coalescing_window`.
+    size_t upload_coalescing_max_size = 65536;
+
     /// The specified function will be called whenever a PONG message is
     /// received on any connection. The round-trip time in milliseconds will
     /// be pased to the function. The specified function will always be
@@ -204,6 +273,12 @@ struct ClientConfig {
     /// calls `Client::run()`. This feature is mainly for testing purposes.
     std::function<RoundtripTimeHandler> roundtrip_time_handler;
 
+    /// If set, called with the timings of every DOWNLOAD and UPLOAD message
+    /// processed by a session, so that it can be told whether slow
+    /// synchronization is due to the network, the CPU or the disk. Always
+    /// called by the client's event loop thread, which it should not block.
+    std::function<SessionTelemetryHandler> session_telemetry_handler;
+
     /// Disable sync to disk (fsync(), msync()) for all realm files managed
     /// by this client.
     ///
@@ -217,6 +292,36 @@ struct ClientConfig {
     /// requires pks for all tables, so this is now only applicable to old sync
     /// tests and so is disabled by default.
     bool fix_up_object_ids = false;
+
+    /// The number of bytes of memory that each Realm file may use to keep the
+    /// parsed reciprocal transforms of its unuploaded changesets between
+    /// integrations of downloaded changesets, so that they do not have to be
+    /// read and parsed again every time. The least recently used ones are
+    /// evicted when the budget is exceeded. Zero disables the cache.
+    size_t reciprocal_transform_cache_budget = 0;
+
+    /// Write transactions trim only a bounded number of obsolete history
+    /// entries each, so that small commits stay fast. Any backlog beyond that
+    /// is trimmed by the sync client in write transactions of its own, each
+    /// using at most this many milliseconds, with pauses of ten times that
+    /// length in between to leave the write lock to the application. Zero
+    /// disables this background trimming.
+    milliseconds_type history_maintenance_slice = 5;
+
+    /// The number of threads used to integrate downloaded changesets. When
+    /// zero, every session integrates on the event loop thread of the client.
+    /// Otherwise, changesets received outside of FLX bootstraps are integrated
+    /// by a pool of this many threads, so that sessions for different Realm
+    /// files integrate in parallel while all network I/O stays on the event
+    /// loop thread.
+    size_t integration_worker_threads = 0;
+
+    /// The maximum number of messages, each from a different session, that a
+    /// connection hands to the socket provider in a single write, using
+    /// WebSocketInterface::async_write_binary_batch(). When many sessions
+    /// share a connection, this saves a round through the event loop, and
+    /// typically a system call, per message. One (or zero) disables batching.
+    size_t max_batched_messages = 1;
 };
 
 /// \brief Information about an error causing a session to be temporarily
@@ -188,6 +188,20 @@ struct SyncConfig {
     // attempt. This many bytes of changesets will be uncompressed and held in memory while being applied.
     size_t flx_bootstrap_batch_size_bytes = 1024 * 1024;
 
+    // Apply the DOWNLOAD messages of a flexible sync bootstrap as they arrive rather than staging them in the pending
+    // bootstrap store first. This avoids writing the bootstrap twice, but holds the write lock until the whole
+    // bootstrap has been downloaded, so local writes block for that long.
+    bool flx_streaming_bootstrap = false;
+
+    // Transform local changes against the changes received from the server on up to this many threads. Changes to
+    // unrelated objects are transformed concurrently, which speeds up reconnecting after many offline changes.
+    size_t transform_threads = 1;
+
+    // Compress the changesets stored in the sync history of the Realm with a preset dictionary trained from its
+    // first changesets. This makes the history of apps which make many small writes much smaller on disk. The
+    // dictionary is stored in the Realm, so it keeps being used once it has been trained.
+    bool history_compression_dictionary = false;
+
     // {@
     /// DEPRECATED - Will be removed in a future release
     // The following parameters are only used by the default SyncSocket implementation. Custom SyncSocket
@@ -235,6 +249,11 @@ struct SyncConfig {
     // in this case.
     bool rerun_init_subscription_on_open{false};
 
+    // If true, an async open of a Realm with a subscription initializer completes as soon as the server starts
+    // sending the data of the subscriptions rather than once all of it has been downloaded. The rest of the data is
+    // added to the Realm as it arrives.
+    bool async_open_complete_on_first_bootstrap_batch{false};
+
     SyncConfig() = default;
     explicit SyncConfig(std::shared_ptr<SyncUser> user, bson::Bson partition);
     explicit SyncConfig(std::shared_ptr<SyncUser> user, std::string partition);
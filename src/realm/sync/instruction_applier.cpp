@@ -166,6 +166,7 @@ void InstructionApplier::operator()(const Instruction::EraseTable& instr)
     }
 
     m_transaction.remove_table(table_name);
+    m_resolved_objects.clear();
 }
 
 void InstructionApplier::operator()(const Instruction::CreateObject& instr)
@@ -233,6 +234,8 @@ void InstructionApplier::operator()(const Instruction::CreateObject& instr)
                      },
                  },
                  instr.object);
+    // The object may have been resurrected from a tombstone with a new key
+    set_resolved_object(instr.table, instr.object, m_last_object->get_key());
 }
 
 void InstructionApplier::operator()(const Instruction::EraseObject& instr)
@@ -244,6 +247,8 @@ void InstructionApplier::operator()(const Instruction::EraseObject& instr)
         obj->invalidate();
     }
     m_last_object.reset();
+    if (auto pk = get_primary_key_value(instr.object))
+        m_resolved_objects.erase(ObjectRef{instr.table, *pk});
 }
 
 template <class F>
@@ -298,7 +303,16 @@ void InstructionApplier::visit_payload(const Instruction::Payload& payload, F&&
             if (target_table->is_embedded()) {
                 bad_transaction_log("Link to embedded table '%1'", target_table_name);
             }
-            ObjKey target = get_object_key(*target_table, data.link.target);
+            ObjKey target;
+            if (Obj obj = find_resolved_object(*target_table, data.link.target_table, data.link.target)) {
+                target = obj.get_key();
+            }
+            else {
+                target = get_object_key(*target_table, data.link.target);
+                // A tombstone is not remembered, as it is replaced if the object is created
+                if (!target.is_unresolved() && target_table->is_valid(target))
+                    set_resolved_object(data.link.target_table, data.link.target, target);
+            }
             ObjLink link = ObjLink{target_table->get_key(), target};
             return visitor(link);
         }
@@ -1318,22 +1332,124 @@ util::Optional<Obj> InstructionApplier::get_top_object(const Instruction::Object
     }
     else {
         TableRef table = get_table(instr, name);
-        ObjKey key = get_object_key(*table, instr.object, name);
-        if (!key) {
-            return util::none;
-        }
-        if (!table->is_valid(key)) {
-            // Check if the object is deleted or is a tombstone.
-            return util::none;
+        Obj obj = find_resolved_object(*table, instr.table, instr.object);
+        if (!obj) {
+            ObjKey key = get_object_key(*table, instr.object, name);
+            if (!key) {
+                return util::none;
+            }
+            // The object may be deleted or be a tombstone.
+            obj = table->try_get_object(key);
+            if (!obj) {
+                return util::none;
+            }
+            set_resolved_object(instr.table, instr.object, key);
         }
 
-        Obj obj = table->get_object(key);
         m_last_object_key = instr.object;
         m_last_object = obj;
         return obj;
     }
 }
 
+void InstructionApplier::resolve_objects(const Changeset& changeset)
+{
+    // Collect the distinct primary keys per table
+    std::map<InternString, std::vector<Mixed>> primary_keys;
+    auto add = [&](InternString table, const Instruction::PrimaryKey& object) {
+        if (auto pk = get_primary_key_value(object))
+            primary_keys[table].push_back(*pk);
+    };
+    for (auto instr : changeset) {
+        if (!instr)
+            continue;
+        instr->visit([&](const auto& i) {
+            using T = std::decay_t<decltype(i)>;
+            if constexpr (std::is_base_of_v<Instruction::ObjectInstruction, T>) {
+                add(i.table, i.object);
+            }
+            if constexpr (std::is_same_v<T, Instruction::Update> || std::is_same_v<T, Instruction::ArrayInsert> ||
+                          std::is_same_v<T, Instruction::SetInsert> || std::is_same_v<T, Instruction::SetErase>) {
+                if (i.value.type == Instruction::Payload::Type::Link)
+                    add(i.value.data.link.target_table, i.value.data.link.target);
+            }
+        });
+    }
+
+    for (auto& [class_name, pks] : primary_keys) {
+        // Tables which are added by the changeset and instructions which do
+        // not match the schema are left to the instructions
+        auto name = m_log->try_get_string(class_name);
+        if (!name)
+            continue;
+        TableRef table = m_transaction.get_table(Group::class_name_to_table_name(*name, m_table_name_buffer));
+        if (!table)
+            continue;
+        ColKey pk_col = table->get_primary_key_column();
+        if (!pk_col)
+            continue;
+        DataType pk_type = table->get_column_type(pk_col);
+        bool nullable = pk_col.is_nullable();
+
+        // Looking the keys up in order visits the search index in order
+        std::sort(pks.begin(), pks.end());
+        pks.erase(std::unique(pks.begin(), pks.end()), pks.end());
+        for (auto& pk : pks) {
+            if (pk.is_null() ? !nullable : pk.get_type() != pk_type)
+                continue;
+            if (ObjKey key = table->find_primary_key(pk))
+                m_resolved_objects.emplace(ObjectRef{class_name, pk}, key);
+        }
+    }
+}
+
+util::Optional<Mixed> InstructionApplier::get_primary_key_value(const Instruction::PrimaryKey& primary_key) const
+{
+    return mpark::visit(util::overload{
+                            [](mpark::monostate) -> util::Optional<Mixed> {
+                                return Mixed();
+                            },
+                            [](GlobalKey) -> util::Optional<Mixed> {
+                                return util::none;
+                            },
+                            [&](InternString pk) -> util::Optional<Mixed> {
+                                if (auto str = m_log->try_get_string(pk))
+                                    return Mixed(*str);
+                                return util::none;
+                            },
+                            [](const auto& pk) -> util::Optional<Mixed> {
+                                return Mixed(pk);
+                            },
+                        },
+                        primary_key);
+}
+
+Obj InstructionApplier::find_resolved_object(const Table& table, InternString class_name,
+                                             const Instruction::PrimaryKey& primary_key) const
+{
+    if (m_resolved_objects.empty())
+        return {};
+    auto pk = get_primary_key_value(primary_key);
+    if (!pk)
+        return {};
+    auto it = m_resolved_objects.find(ObjectRef{class_name, *pk});
+    if (it == m_resolved_objects.end())
+        return {};
+    // Objects may also be removed other than by EraseObject, by appliers
+    // which override it, so the object is checked before it is used
+    Obj obj = table.try_get_object(it->second);
+    if (!obj || obj.get_primary_key() != *pk)
+        return {};
+    return obj;
+}
+
+void InstructionApplier::set_resolved_object(InternString class_name, const Instruction::PrimaryKey& primary_key,
+                                             ObjKey key)
+{
+    if (auto pk = get_primary_key_value(primary_key))
+        m_resolved_objects[ObjectRef{class_name, *pk}] = key;
+}
+
 LstBasePtr InstructionApplier::get_list_from_path(Obj& obj, ColKey col)
 {
     // For link columns, `Obj::get_listbase_ptr()` always returns an instance whose concrete type is
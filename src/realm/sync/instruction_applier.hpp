@@ -26,6 +26,7 @@
 #include <realm/dictionary.hpp>
 
 #include <tuple>
+#include <unordered_map>
 
 namespace realm {
 namespace sync {
@@ -45,6 +46,13 @@ struct InstructionApplier {
     void begin_apply(const Changeset&) noexcept;
     void end_apply() noexcept;
 
+    /// Look up all objects which the changeset refers to by primary key, one
+    /// table at a time and in the order of the primary keys, so that applying
+    /// the instructions does not have to look up the same objects repeatedly.
+    /// Called by apply() after begin_apply(). Objects which are not found are
+    /// left to be resolved by the instructions as usual.
+    void resolve_objects(const Changeset&);
+
 protected:
     util::Optional<Obj> get_top_object(const Instruction::ObjectInstruction&,
                                        const std::string_view& instr = "(unspecified)");
@@ -125,11 +133,35 @@ private:
     util::Optional<Obj> m_last_object;
     std::unique_ptr<LstBase> m_last_list;
 
+    // The keys of the objects which the current changeset refers to, by class
+    // name and primary key, for the objects which have been found to exist
+    struct ObjectRef {
+        InternString table;
+        Mixed pk;
+        bool operator==(const ObjectRef& other) const noexcept
+        {
+            return table == other.table && pk == other.pk;
+        }
+    };
+    struct ObjectRefHash {
+        size_t operator()(const ObjectRef& ref) const noexcept
+        {
+            return ref.pk.hash() ^ (size_t(ref.table.value) * 0x9e3779b97f4a7c15ULL);
+        }
+    };
+    std::unordered_map<ObjectRef, ObjKey, ObjectRefHash> m_resolved_objects;
+
     StringData get_table_name(const Instruction::TableInstruction&, const std::string_view& instr = "(unspecified)");
 
     // Note: This may return a non-invalid ObjKey if the key is dangling.
     ObjKey get_object_key(Table& table, const Instruction::PrimaryKey&,
                           const std::string_view& instr = "(unspecified)") const;
+    // The value of a primary key, or none for a GlobalKey
+    util::Optional<Mixed> get_primary_key_value(const Instruction::PrimaryKey&) const;
+    // The object with the given primary key if it has been resolved before in
+    // the current changeset, or an invalid Obj
+    Obj find_resolved_object(const Table&, InternString table, const Instruction::PrimaryKey&) const;
+    void set_resolved_object(InternString table, const Instruction::PrimaryKey&, ObjKey);
 
     template <class F>
     void visit_payload(const Instruction::Payload&, F&& visitor);
@@ -162,12 +194,14 @@ inline void InstructionApplier::end_apply() noexcept
     m_last_object.reset();
     m_last_object_key.reset();
     m_last_list.reset();
+    m_resolved_objects.clear();
 }
 
 template <class A>
 inline void InstructionApplier::apply(A& applier, const Changeset& changeset)
 {
     applier.begin_apply(changeset);
+    applier.resolve_objects(changeset); // Throws
     for (auto instr : changeset) {
         if (!instr)
             continue;
@@ -180,6 +214,7 @@ template <class A>
 inline void InstructionApplier::apply(A& applier, Changeset& changeset)
 {
     applier.begin_apply(changeset);
+    applier.resolve_objects(changeset); // Throws
     for (auto instr : changeset) {
         if (!instr)
             continue;
@@ -6,9 +6,22 @@
 namespace realm {
 namespace sync {
 
+namespace {
+
+bool is_same_path(const Instruction::PathInstruction& a, const Instruction::PathInstruction& b) noexcept
+{
+    return a.table == b.table && a.object == b.object && a.field == b.field && a.path == b.path;
+}
+
+} // unnamed namespace
+
 void SyncReplication::reset()
 {
     m_encoder.reset();
+    m_last_instruction.reset();
+    m_last_instruction_begin = 0;
+    m_emitted_end = 0;
+    m_created_object_begin = npos;
 
     m_last_table = nullptr;
     m_last_object = ObjKey();
@@ -696,6 +709,114 @@ void SyncReplication::link_list_nullify(const Lst<ObjKey>& view, size_t ndx)
     }
 }
 
+bool SyncReplication::follows_last_instruction() noexcept
+{
+    return m_last_instruction && m_encoder.buffer().size() == m_emitted_end;
+}
+
+void SyncReplication::discard_last_instruction()
+{
+    REALM_ASSERT(m_last_instruction);
+    m_encoder.buffer().resize(m_last_instruction_begin);
+    m_emitted_end = m_last_instruction_begin;
+    m_last_instruction.reset();
+}
+
+void SyncReplication::track_instruction(Instruction instr, size_t begin)
+{
+    bool contiguous = (begin == m_emitted_end);
+    if (auto create = instr.get_if<Instruction::CreateObject>()) {
+        // Another client may create an object with the same primary key, and
+        // the erasure must then win over that creation when merging. Only an
+        // object identified by a GlobalKey is unknown to everyone else.
+        m_created_object = *create;
+        m_created_object_begin = mpark::holds_alternative<GlobalKey>(create->object) ? begin : npos;
+    }
+    else if (m_created_object_begin != npos) {
+        auto path_instr = instr.get_if<Instruction::PathInstruction>();
+        if (!contiguous || !path_instr || path_instr->table != m_created_object.table ||
+            path_instr->object != m_created_object.object) {
+            m_created_object_begin = npos;
+        }
+    }
+    m_last_instruction = std::move(instr);
+    m_last_instruction_begin = begin;
+    m_emitted_end = m_encoder.buffer().size();
+}
+
+bool SyncReplication::coalesce(Instruction::Update& instr)
+{
+    if (!follows_last_instruction())
+        return false;
+
+    if (auto last = m_last_instruction->get_if<Instruction::Update>()) {
+        // The new value of a property or element replaces the previous one
+        if (is_same_path(*last, instr))
+            discard_last_instruction();
+    }
+    else if (auto last = m_last_instruction->get_if<Instruction::ArrayInsert>()) {
+        // An element set right after it was inserted is inserted with the new
+        // value instead
+        if (instr.is_array_update() && is_same_path(*last, instr)) {
+            Instruction::ArrayInsert insert = *last;
+            insert.value = instr.value;
+            discard_last_instruction();
+            emit(std::move(insert)); // Throws
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SyncReplication::coalesce(Instruction::AddInteger& instr)
+{
+    if (!follows_last_instruction())
+        return false;
+
+    // Consecutive additions to the same property are emitted as one. Addition
+    // wraps around, so the result is the same.
+    if (auto last = m_last_instruction->get_if<Instruction::AddInteger>()) {
+        if (is_same_path(*last, instr)) {
+            instr.value = int64_t(uint64_t(last->value) + uint64_t(instr.value));
+            discard_last_instruction();
+        }
+    }
+    return false;
+}
+
+bool SyncReplication::coalesce(Instruction::ArrayErase& instr)
+{
+    if (!follows_last_instruction())
+        return false;
+
+    // An element erased right after it was inserted leaves the list as it was
+    if (auto last = m_last_instruction->get_if<Instruction::ArrayInsert>()) {
+        if (is_same_path(*last, instr) && instr.prior_size == last->prior_size + 1) {
+            discard_last_instruction();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SyncReplication::coalesce(Instruction::EraseObject& instr)
+{
+    if (m_created_object_begin == npos || m_encoder.buffer().size() != m_emitted_end)
+        return false;
+
+    // An object which is erased in the same transaction as it was created,
+    // without anything but the object itself having been changed since, is
+    // left out along with all the changes to it
+    if (instr.table == m_created_object.table && instr.object == m_created_object.object) {
+        m_encoder.buffer().resize(m_created_object_begin);
+        m_emitted_end = m_created_object_begin;
+        m_created_object_begin = npos;
+        m_last_instruction.reset();
+        return true;
+    }
+    return false;
+}
+
 void SyncReplication::unsupported_instruction() const
 {
     throw realm::sync::TransformError{"Unsupported instruction"};
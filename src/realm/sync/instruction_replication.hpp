@@ -108,6 +108,25 @@ private:
     template <class T>
     void emit(T instruction);
 
+    // Instructions made redundant by the one about to be emitted are removed
+    // from the encoder's buffer while it is still the last thing in it, so that
+    // repeated changes within a transaction do not grow the changeset. An
+    // overload returns true if the instruction cancels out the earlier ones
+    // and should not be emitted either. It may also modify the instruction to
+    // include the effect of the ones it replaces.
+    template <class T>
+    bool coalesce(T&) noexcept
+    {
+        return false;
+    }
+    bool coalesce(Instruction::Update&);
+    bool coalesce(Instruction::AddInteger&);
+    bool coalesce(Instruction::ArrayErase&);
+    bool coalesce(Instruction::EraseObject&);
+    bool follows_last_instruction() noexcept;
+    void discard_last_instruction();
+    void track_instruction(Instruction, size_t begin);
+
     // Returns true and populates m_last_table_name if instructions for the
     // table should be emitted.
     bool select_table(const Table&);
@@ -143,6 +162,20 @@ private:
     util::Optional<Instruction::PrimaryKey> m_last_primary_key;
     InternString m_last_interned_field_name;
     util::UniqueFunction<WriteValidator> m_write_validator;
+
+    // The last instruction emitted, where it begins in the encoder's buffer,
+    // and where the buffer ended after it. Anything added to the buffer since,
+    // such as the definition of an interned string, prevents the instruction
+    // from being replaced.
+    util::Optional<Instruction> m_last_instruction;
+    size_t m_last_instruction_begin = 0;
+    size_t m_emitted_end = 0;
+    // An object without a primary key created in this transaction, and where
+    // its CreateObject instruction begins, as long as all instructions emitted
+    // since then were for that object. Otherwise `m_created_object_begin` is
+    // npos.
+    Instruction::CreateObject m_created_object;
+    size_t m_created_object_begin = npos;
 };
 
 inline void SyncReplication::set_short_circuit(bool b) noexcept
@@ -169,7 +202,11 @@ template <class T>
 inline void SyncReplication::emit(T instruction)
 {
     REALM_ASSERT(!m_short_circuit);
-    m_encoder(instruction);
+    if (coalesce(instruction)) // Throws
+        return;
+    size_t begin = m_encoder.buffer().size();
+    m_encoder(instruction);                           // Throws
+    track_instruction(std::move(instruction), begin); // Throws
 }
 
 
@@ -7,9 +7,57 @@
 #include <realm/util/basic_system_errors.hpp>
 #include <realm/util/random.hpp>
 #include <realm/util/scope_exit.hpp>
+#include <realm/util/thread.hpp>
+
+#include <tuple>
 
 namespace realm::sync::websocket {
 
+///
+/// SSLContextCache - SSL contexts shared by the connections of a DefaultSocketProvider
+///
+/// Creating a context is expensive, since loading the trust store parses every certificate in it, and
+/// the context also holds the client session cache, which lets reconnects to a server resume the TLS
+/// session instead of performing a full handshake. Connections with the same certificate verification
+/// settings therefore share a context.
+class SSLContextCache {
+public:
+    std::shared_ptr<network::ssl::Context> get(const WebSocketEndpoint& endpoint)
+    {
+        Key key{endpoint.verify_servers_ssl_certificate, endpoint.ssl_trust_certificate_path.value_or(""),
+                bool(endpoint.ssl_verify_callback)};
+        std::shared_ptr<network::ssl::Context>& context = m_contexts[key]; // Throws
+        if (!context)
+            context = make_context(endpoint); // Throws
+        return context;
+    }
+
+private:
+    using Key = std::tuple<bool, std::string, bool>;
+    std::map<Key, std::shared_ptr<network::ssl::Context>> m_contexts;
+
+    static std::shared_ptr<network::ssl::Context> make_context(const WebSocketEndpoint& endpoint)
+    {
+        auto context = std::make_shared<network::ssl::Context>(); // Throws
+        if (endpoint.verify_servers_ssl_certificate) {
+            if (endpoint.ssl_trust_certificate_path) {
+                context->use_verify_file(*endpoint.ssl_trust_certificate_path); // Throws
+            }
+            else if (!endpoint.ssl_verify_callback) {
+                context->use_default_verify(); // Throws
+#if REALM_INCLUDE_CERTS
+                // On platforms like Windows or Android where OpenSSL is not normally found
+                // `use_default_verify()` won't actually be able to load any default certificates.
+                // That's why we bundle a set of trusted certificates ourselves.
+                context->use_included_certificate_roots(); // Throws
+#endif
+            }
+        }
+        context->enable_client_session_cache(); // Throws
+        return context;
+    }
+};
+
 namespace {
 
 ///
@@ -18,13 +66,16 @@ namespace {
 class DefaultWebSocketImpl final : public DefaultWebSocket, public Config {
 public:
     DefaultWebSocketImpl(const std::shared_ptr<util::Logger>& logger_ptr, network::Service& service,
-                         std::mt19937_64& random, const std::string user_agent,
-                         std::unique_ptr<WebSocketObserver> observer, WebSocketEndpoint&& endpoint)
+                         std::mt19937_64& random, const std::string user_agent, bool permessage_deflate,
+                         std::shared_ptr<SSLContextCache> ssl_contexts, std::unique_ptr<WebSocketObserver> observer,
+                         WebSocketEndpoint&& endpoint)
         : m_logger_ptr{logger_ptr}
         , m_network_logger{*m_logger_ptr}
         , m_random{random}
         , m_service{service}
         , m_user_agent{user_agent}
+        , m_permessage_deflate{permessage_deflate}
+        , m_ssl_contexts{std::move(ssl_contexts)}
         , m_observer{std::move(observer)}
         , m_endpoint{std::move(endpoint)}
         , m_websocket(*this)
@@ -68,6 +119,10 @@ private:
     {
         return m_random;
     }
+    bool websocket_permessage_deflate_enabled() noexcept override
+    {
+        return m_permessage_deflate;
+    }
 
     void websocket_handshake_completion_handler(const HTTPHeaders& headers) override
     {
@@ -219,6 +274,8 @@ private:
     std::mt19937_64& m_random;
     network::Service& m_service;
     const std::string m_user_agent;
+    const bool m_permessage_deflate;
+    const std::shared_ptr<SSLContextCache> m_ssl_contexts;
     std::string m_app_services_coid;
 
     std::unique_ptr<WebSocketObserver> m_observer;
@@ -226,7 +283,7 @@ private:
     const WebSocketEndpoint m_endpoint;
     util::Optional<network::Resolver> m_resolver;
     util::Optional<network::Socket> m_socket;
-    util::Optional<network::ssl::Context> m_ssl_context;
+    std::shared_ptr<network::ssl::Context> m_ssl_context;
     util::Optional<network::ssl::Stream> m_ssl_stream;
     network::ReadAheadBuffer m_read_ahead_buffer;
     websocket::Socket m_websocket;
@@ -404,27 +461,13 @@ void DefaultWebSocketImpl::initiate_ssl_handshake()
 {
     using namespace network::ssl;
 
-    if (!m_ssl_context) {
-        m_ssl_context.emplace(); // Throws
-        if (m_endpoint.verify_servers_ssl_certificate) {
-            if (m_endpoint.ssl_trust_certificate_path) {
-                m_ssl_context->use_verify_file(*m_endpoint.ssl_trust_certificate_path); // Throws
-            }
-            else if (!m_endpoint.ssl_verify_callback) {
-                m_ssl_context->use_default_verify(); // Throws
-#if REALM_INCLUDE_CERTS
-                // On platforms like Windows or Android where OpenSSL is not normally found
-                // `use_default_verify()` won't actually be able to load any default certificates.
-                // That's why we bundle a set of trusted certificates ourselves.
-                m_ssl_context->use_included_certificate_roots(); // Throws
-#endif
-            }
-        }
-    }
+    if (!m_ssl_context)
+        m_ssl_context = m_ssl_contexts->get(m_endpoint); // Throws
 
     m_ssl_stream.emplace(*m_socket, *m_ssl_context, Stream::client); // Throws
     m_ssl_stream->set_logger(m_logger_ptr.get());
     m_ssl_stream->set_host_name(m_endpoint.address); // Throws
+    m_ssl_stream->set_session_key(util::format("%1:%2", m_endpoint.address, m_endpoint.port)); // Throws
     if (m_endpoint.verify_servers_ssl_certificate) {
         m_ssl_stream->set_verify_mode(VerifyMode::peer); // Throws
         m_ssl_stream->set_server_port(m_endpoint.port);
@@ -464,6 +507,8 @@ void DefaultWebSocketImpl::handle_ssl_handshake(std::error_code ec)
         return;
     }
 
+    m_network_logger.debug("TLS handshake completed (%1)",
+                           m_ssl_stream->session_reused() ? "session resumed" : "full handshake"); // Throws
     initiate_websocket_handshake(); // Throws
 }
 
@@ -499,10 +544,12 @@ void DefaultWebSocketImpl::initiate_websocket_handshake()
 DefaultSocketProvider::DefaultSocketProvider(const std::shared_ptr<util::Logger>& logger,
                                              const std::string& user_agent,
                                              const std::shared_ptr<BindingCallbackThreadObserver>& observer_ptr,
-                                             AutoStart auto_start)
+                                             AutoStart auto_start, PermessageDeflate permessage_deflate)
     : m_logger_ptr{std::make_shared<util::CategoryLogger>(util::LogCategory::network, logger)}
     , m_observer_ptr{observer_ptr}
     , m_user_agent{user_agent}
+    , m_permessage_deflate{permessage_deflate}
+    , m_ssl_contexts{std::make_shared<SSLContextCache>()}
     , m_state{State::Stopped}
 {
     REALM_ASSERT(m_logger_ptr);                     // Make sure the logger is valid
@@ -537,7 +584,10 @@ void DefaultSocketProvider::start()
     REALM_ASSERT(m_state == State::Stopped);
 
     do_state_update(lock, State::Starting);
-    m_thread = std::thread{&DefaultSocketProvider::event_loop, this};
+    m_thread = std::thread{[this] {
+        util::on_thread_start(util::ThreadRole::sync_event_loop);
+        event_loop();
+    }};
     // Wait for the thread to start before continuing
     state_wait_for(lock, State::Running);
 }
@@ -686,7 +736,8 @@ std::unique_ptr<WebSocketInterface> DefaultSocketProvider::connect(std::unique_p
                                                                    WebSocketEndpoint&& endpoint)
 {
     return std::make_unique<DefaultWebSocketImpl>(m_logger_ptr, m_service, m_random, m_user_agent,
-                                                  std::move(observer), std::move(endpoint));
+                                                  m_permessage_deflate, m_ssl_contexts, std::move(observer),
+                                                  std::move(endpoint));
 }
 
 } // namespace realm::sync::websocket
@@ -18,6 +18,7 @@ class Service;
 } // namespace realm::sync::network
 
 namespace realm::sync::websocket {
+class SSLContextCache;
 using port_type = sync::port_type;
 
 class DefaultSocketProvider : public SyncSocketProvider {
@@ -49,9 +50,18 @@ public:
     struct AutoStartTag {};
 
     using AutoStart = util::TaggedBool<AutoStartTag>;
+
+    struct PermessageDeflateTag {};
+
+    /// Offer the permessage-deflate WebSocket extension (RFC 7692) when connecting. If the
+    /// server accepts it, sync messages are compressed with a window that is kept across
+    /// messages, so that small messages benefit from the content of earlier ones.
+    using PermessageDeflate = util::TaggedBool<PermessageDeflateTag>;
+
     DefaultSocketProvider(const std::shared_ptr<util::Logger>& logger, const std::string& user_agent,
                           const std::shared_ptr<BindingCallbackThreadObserver>& observer_ptr = nullptr,
-                          AutoStart auto_start = AutoStart{true});
+                          AutoStart auto_start = AutoStart{true},
+                          PermessageDeflate permessage_deflate = PermessageDeflate{false});
 
     ~DefaultSocketProvider();
 
@@ -101,6 +111,9 @@ private:
     network::Service m_service;
     std::mt19937_64 m_random;
     const std::string m_user_agent;
+    const bool m_permessage_deflate;
+    // SSL contexts and TLS sessions shared by the connections, only accessed on the event loop thread
+    const std::shared_ptr<SSLContextCache> m_ssl_contexts;
     std::mutex m_mutex;
     uint64_t m_event_loop_generation = 0;
     State m_state;                      // protected by m_mutex
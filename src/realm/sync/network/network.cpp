@@ -49,6 +49,13 @@
 #if REALM_NETWORK_USE_EPOLL
 #include <linux/version.h>
 #include <sys/epoll.h>
+#if REALM_NETWORK_USE_IO_URING
+#include <unordered_map>
+#include <endian.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
 #elif REALM_HAVE_KQUEUE
 #include <sys/types.h>
 #include <sys/event.h>
@@ -458,7 +465,56 @@ public:
 #endif
 
 private:
-#if REALM_NETWORK_USE_EPOLL
+#if REALM_NETWORK_USE_IO_URING
+
+    // A memory mapped region shared with the kernel
+    class RingMapping {
+    public:
+        RingMapping() noexcept = default;
+        RingMapping(const RingMapping&) = delete;
+        ~RingMapping() noexcept;
+        void map(int ring_fd, std::size_t size, off_t offset);
+        char* data() const noexcept;
+
+    private:
+        void* m_addr = MAP_FAILED;
+        std::size_t m_size = 0;
+    };
+
+    static constexpr unsigned s_ring_size = 256;
+
+    // `user_data` of the poll request for the wakeup pipe, and of requests
+    // removing a poll request. Poll requests for descriptors use identifiers
+    // starting at 1, which are never reused, so a completion that arrives
+    // after its descriptor was deregistered is recognized and ignored.
+    static constexpr std::uint64_t s_wakeup_pipe_user_data = 0;
+    static constexpr std::uint64_t s_poll_remove_user_data = std::uint64_t(-1);
+
+    CloseGuard m_ring_fd;
+    RingMapping m_sq_ring, m_cq_ring, m_sqe_array;
+    unsigned m_sq_entries = 0;
+    unsigned m_sq_mask = 0, m_cq_mask = 0;
+    unsigned* m_sq_head = nullptr;
+    unsigned* m_sq_tail = nullptr;
+    unsigned* m_sq_flags = nullptr;
+    unsigned* m_sq_index_array = nullptr;
+    io_uring_sqe* m_sqes = nullptr;
+    unsigned* m_cq_head = nullptr;
+    unsigned* m_cq_tail = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+
+    std::uint64_t m_next_poll_id = 1;
+    std::unordered_map<std::uint64_t, Descriptor*> m_registered_descs;
+
+    void setup_ring();
+    io_uring_sqe& get_sqe();
+    void arm_poll(int fd, std::uint64_t user_data, unsigned events);
+    unsigned num_unsubmitted() const noexcept;
+    int enter(unsigned min_complete, const __kernel_timespec* timeout) noexcept;
+    // Returns true if a wakeup pipe signal was received.
+    bool reap_completions();
+
+#elif REALM_NETWORK_USE_EPOLL
 
     static constexpr int s_epoll_event_buffer_size = 256;
     const std::unique_ptr<epoll_event[]> m_epoll_event_buffer;
@@ -543,7 +599,314 @@ inline void Service::IoReactor::interrupt() noexcept
 }
 
 
-#if REALM_NETWORK_USE_EPOLL
+#if REALM_NETWORK_USE_IO_URING
+
+inline Service::IoReactor::RingMapping::~RingMapping() noexcept
+{
+    if (m_addr != MAP_FAILED)
+        ::munmap(m_addr, m_size);
+}
+
+
+inline void Service::IoReactor::RingMapping::map(int ring_fd, std::size_t size, off_t offset)
+{
+    REALM_ASSERT(m_addr == MAP_FAILED);
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+    if (REALM_UNLIKELY(addr == MAP_FAILED)) {
+        std::error_code ec = make_basic_system_error_code(errno);
+        throw std::system_error(ec);
+    }
+    m_addr = addr;
+    m_size = size;
+}
+
+
+inline char* Service::IoReactor::RingMapping::data() const noexcept
+{
+    return static_cast<char*>(m_addr);
+}
+
+
+inline Service::IoReactor::IoReactor()
+    : m_wakeup_pipe{} // Throws
+{
+    setup_ring(); // Throws
+
+    arm_poll(m_wakeup_pipe.wait_fd(), s_wakeup_pipe_user_data, EPOLLIN); // Throws
+    int ret = enter(0, nullptr);
+    if (REALM_UNLIKELY(ret < 0)) {
+        std::error_code ec = make_basic_system_error_code(-ret);
+        throw std::system_error(ec);
+    }
+    // Kernels that predate multishot poll requests (Linux 5.13) reject the
+    // request right away, and that is the only way to detect them.
+    unsigned head = *m_cq_head;
+    unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+        if (cqe.user_data == s_wakeup_pipe_user_data && cqe.res < 0)
+            throw std::system_error(make_error_code(MiscExtErrors::operation_not_supported));
+    }
+}
+
+
+inline Service::IoReactor::~IoReactor() noexcept {}
+
+
+void Service::IoReactor::setup_ring()
+{
+    io_uring_params params = io_uring_params(); // Clear
+    params.flags = IORING_SETUP_CLAMP;
+    long ret = ::syscall(__NR_io_uring_setup, s_ring_size, &params);
+    if (REALM_UNLIKELY(ret == -1)) {
+        int err = errno;
+        if (err == ENOSYS)
+            throw std::system_error(make_error_code(MiscExtErrors::operation_not_supported));
+        std::error_code ec = make_basic_system_error_code(err);
+        throw std::system_error(ec);
+    }
+    m_ring_fd.reset(int(ret));
+    // Waiting with a timeout, and not losing completions when the completion
+    // queue overflows, are both required.
+    constexpr unsigned required_features = IORING_FEAT_EXT_ARG | IORING_FEAT_NODROP | IORING_FEAT_POLL_32BITS;
+    if (REALM_UNLIKELY((params.features & required_features) != required_features))
+        throw std::system_error(make_error_code(MiscExtErrors::operation_not_supported));
+
+    std::size_t sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    std::size_t cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        sq_ring_size = std::max(sq_ring_size, cq_ring_size);
+        m_sq_ring.map(m_ring_fd, sq_ring_size, IORING_OFF_SQ_RING); // Throws
+    }
+    else {
+        m_sq_ring.map(m_ring_fd, sq_ring_size, IORING_OFF_SQ_RING); // Throws
+        m_cq_ring.map(m_ring_fd, cq_ring_size, IORING_OFF_CQ_RING); // Throws
+    }
+    char* sq = m_sq_ring.data();
+    char* cq = ((params.features & IORING_FEAT_SINGLE_MMAP) != 0 ? sq : m_cq_ring.data());
+    m_sqe_array.map(m_ring_fd, params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES); // Throws
+
+    m_sq_entries = params.sq_entries;
+    m_sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    m_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    m_sq_flags = reinterpret_cast<unsigned*>(sq + params.sq_off.flags);
+    m_sq_index_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    m_sqes = reinterpret_cast<io_uring_sqe*>(m_sqe_array.data());
+    m_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+
+inline unsigned Service::IoReactor::num_unsubmitted() const noexcept
+{
+    // Only this thread advances the tail, but the kernel advances the head
+    return *m_sq_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+}
+
+
+int Service::IoReactor::enter(unsigned min_complete, const __kernel_timespec* timeout) noexcept
+{
+    io_uring_getevents_arg arg = io_uring_getevents_arg(); // Clear
+    arg.ts = reinterpret_cast<std::uint64_t>(timeout);
+    unsigned flags = IORING_ENTER_EXT_ARG;
+    if (min_complete > 0 || (__atomic_load_n(m_sq_flags, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW) != 0)
+        flags |= IORING_ENTER_GETEVENTS;
+    long ret = ::syscall(__NR_io_uring_enter, int(m_ring_fd), num_unsubmitted(), min_complete, flags, &arg,
+                         sizeof arg);
+    if (ret == -1)
+        return -errno;
+    return int(ret);
+}
+
+
+io_uring_sqe& Service::IoReactor::get_sqe()
+{
+    if (REALM_UNLIKELY(num_unsubmitted() == m_sq_entries)) {
+        // The submission queue is full, so hand it over to the kernel now
+        int ret = enter(0, nullptr);
+        if (REALM_UNLIKELY(ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY)) {
+            std::error_code ec = make_basic_system_error_code(-ret);
+            throw std::system_error(ec);
+        }
+        if (REALM_UNLIKELY(num_unsubmitted() == m_sq_entries))
+            throw std::system_error(make_basic_system_error_code(EBUSY));
+    }
+    unsigned tail = *m_sq_tail;
+    unsigned index = tail & m_sq_mask;
+    io_uring_sqe& sqe = m_sqes[index];
+    sqe = io_uring_sqe(); // Clear
+    m_sq_index_array[index] = index;
+    // Publish the entry. It is submitted by the next call to enter().
+    __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+
+void Service::IoReactor::arm_poll(int fd, std::uint64_t user_data, unsigned events)
+{
+#if __BYTE_ORDER == __BIG_ENDIAN
+    events = (events << 16) | (events >> 16);
+#endif
+    // Filling in the entry before it is published by get_sqe() is not
+    // necessary, as the kernel only reads it during io_uring_enter().
+    io_uring_sqe& sqe = get_sqe(); // Throws
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = events;
+    sqe.len = IORING_POLL_ADD_MULTI;
+    sqe.user_data = user_data;
+}
+
+
+inline void Service::IoReactor::register_desc(Descriptor& desc)
+{
+    std::uint64_t poll_id = m_next_poll_id;
+    m_registered_descs.emplace(poll_id, &desc); // Throws
+    try {
+        arm_poll(desc.m_fd, poll_id, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET); // Throws
+    }
+    catch (...) {
+        m_registered_descs.erase(poll_id);
+        throw;
+    }
+    desc.m_poll_id = poll_id;
+    ++m_next_poll_id;
+}
+
+
+inline void Service::IoReactor::deregister_desc(Descriptor& desc) noexcept
+{
+    m_registered_descs.erase(desc.m_poll_id);
+    // The poll request holds a reference to the file, so it must be removed
+    // right away for a close of the descriptor to take effect.
+    try {
+        io_uring_sqe& sqe = get_sqe(); // Throws
+        sqe.opcode = IORING_OP_POLL_REMOVE;
+        sqe.fd = -1;
+        sqe.addr = desc.m_poll_id;
+        sqe.user_data = s_poll_remove_user_data;
+    }
+    catch (const std::system_error&) {
+        REALM_TERMINATE("Failed to queue removal of io_uring poll request");
+    }
+    int ret = enter(0, nullptr);
+    REALM_ASSERT(ret >= 0 || ret == -EINTR || ret == -EAGAIN || ret == -EBUSY);
+}
+
+
+bool Service::IoReactor::reap_completions()
+{
+    bool got_wakeup_pipe_signal = false;
+    unsigned head = *m_cq_head;
+    unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+        std::uint64_t user_data = cqe.user_data;
+        int res = cqe.res;
+        bool more = ((cqe.flags & IORING_CQE_F_MORE) != 0);
+        if (user_data == s_poll_remove_user_data)
+            continue;
+        if (REALM_UNLIKELY(user_data == s_wakeup_pipe_user_data)) {
+            if (res > 0) {
+                m_wakeup_pipe.acknowledge_signal();
+                got_wakeup_pipe_signal = true;
+            }
+            if (!more)
+                arm_poll(m_wakeup_pipe.wait_fd(), s_wakeup_pipe_user_data, EPOLLIN); // Throws
+            continue;
+        }
+        auto i = m_registered_descs.find(user_data);
+        if (i == m_registered_descs.end())
+            continue; // Descriptor was deregistered
+        Descriptor& desc = *i->second;
+        // A failed poll request is reported as an error condition, which
+        // makes the suspended operations discover the cause themselves.
+        unsigned events = (res >= 0 ? unsigned(res) : unsigned(EPOLLERR));
+        if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+            if (!desc.m_read_ready) {
+                desc.m_read_ready = true;
+                m_active_ops.push_back(desc.m_suspended_read_ops);
+            }
+        }
+        if ((events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0) {
+            if (!desc.m_write_ready) {
+                desc.m_write_ready = true;
+                m_active_ops.push_back(desc.m_suspended_write_ops);
+            }
+        }
+        if ((events & EPOLLRDHUP) != 0)
+            desc.m_imminent_end_of_input = true;
+        // The kernel may terminate a multishot request, for example when it
+        // runs short of memory. Rearming it reports the current readiness.
+        if (!more)
+            arm_poll(desc.m_fd, user_data, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET); // Throws
+    }
+    __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+    return got_wakeup_pipe_signal;
+}
+
+
+bool Service::IoReactor::wait_and_activate(clock::time_point timeout, clock::time_point now)
+{
+    unsigned min_complete = 0;
+    __kernel_timespec max_wait_time{};
+    const __kernel_timespec* max_wait_time_ptr = nullptr;
+    bool allow_blocking_wait = m_active_ops.empty();
+    if (allow_blocking_wait) {
+        if (timeout.time_since_epoch().count() <= 0) {
+            min_complete = 1; // Allow indefinite blocking
+        }
+        else if (now < timeout) {
+            auto diff = timeout - now;
+            auto secs = std::chrono::duration_cast<std::chrono::seconds>(diff);
+            auto nsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(diff - secs);
+            max_wait_time.tv_sec = secs.count();
+            max_wait_time.tv_nsec = nsecs.count();
+            max_wait_time_ptr = &max_wait_time;
+            min_complete = 1;
+        }
+    }
+    // Registrations queued since the previous wait are submitted by the same
+    // system call that waits for completions.
+    for (int i = 0; i < 4; ++i) {
+        bool need_enter = (min_complete > 0 || num_unsubmitted() > 0 ||
+                           (__atomic_load_n(m_sq_flags, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW) != 0);
+        if (need_enter) {
+#ifdef REALM_UTIL_NETWORK_EVENT_LOOP_METRICS
+            clock::time_point sleep_start_time = clock::now();
+#endif
+            int ret = enter(min_complete, max_wait_time_ptr);
+            if (REALM_UNLIKELY(ret < 0)) {
+                // ETIME means that the timeout was reached, and EBUSY that
+                // completions must be reaped before more can be delivered.
+                int err = -ret;
+                if (err == EINTR)
+                    return false; // Infrequent premature return is ok
+                if (err != ETIME && err != EBUSY && err != EAGAIN) {
+                    std::error_code ec = make_basic_system_error_code(err);
+                    throw std::system_error(ec);
+                }
+            }
+#ifdef REALM_UTIL_NETWORK_EVENT_LOOP_METRICS
+            m_sleep_time += clock::now() - sleep_start_time;
+#endif
+        }
+        if (reap_completions()) // Throws
+            return true;
+        bool overflowed = ((__atomic_load_n(m_sq_flags, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW) != 0);
+        if (!overflowed)
+            break;
+        min_complete = 0;
+        max_wait_time_ptr = nullptr;
+    }
+    return false;
+}
+
+
+#elif REALM_NETWORK_USE_EPOLL
 
 inline Service::IoReactor::IoReactor()
     : m_epoll_event_buffer{make_epoll_event_buffer()} // Throws
@@ -2315,7 +2678,10 @@ void SocketBase::get_option(opt_enum opt, void* value_data, std::size_t& value_s
 {
     int level = 0;
     int option_name = 0;
-    map_option(opt, level, option_name);
+    if (REALM_UNLIKELY(!map_option(opt, level, option_name))) {
+        ec = MiscExtErrors::operation_not_supported;
+        return;
+    }
 
     native_handle_type sock_fd = m_desc.native_handle();
     socklen_t option_len = socklen_t(value_size);
@@ -2331,7 +2697,10 @@ void SocketBase::set_option(opt_enum opt, const void* value_data, std::size_t va
 {
     int level = 0;
     int option_name = 0;
-    map_option(opt, level, option_name);
+    if (REALM_UNLIKELY(!map_option(opt, level, option_name))) {
+        ec = MiscExtErrors::operation_not_supported;
+        return;
+    }
 
     native_handle_type sock_fd = m_desc.native_handle();
     int ret = ::setsockopt(sock_fd, level, option_name, static_cast<const char*>(value_data), socklen_t(value_size));
@@ -2341,13 +2710,13 @@ void SocketBase::set_option(opt_enum opt, const void* value_data, std::size_t va
 }
 
 
-void SocketBase::map_option(opt_enum opt, int& level, int& option_name) const
+bool SocketBase::map_option(opt_enum opt, int& level, int& option_name) const
 {
     switch (opt) {
         case opt_ReuseAddr:
             level = SOL_SOCKET;
             option_name = SO_REUSEADDR;
-            return;
+            return true;
         case opt_Linger:
             level = SOL_SOCKET;
 #if REALM_PLATFORM_APPLE
@@ -2357,13 +2726,22 @@ void SocketBase::map_option(opt_enum opt, int& level, int& option_name) const
 #else
             option_name = SO_LINGER;
 #endif // REALM_PLATFORM_APPLE
-            return;
+            return true;
         case opt_NoDelay:
             level = IPPROTO_TCP;
             option_name = TCP_NODELAY; // Specified by POSIX.1-2001
-            return;
+            return true;
+        case opt_ReusePort:
+#ifdef SO_REUSEPORT
+            level = SOL_SOCKET;
+            option_name = SO_REUSEPORT;
+            return true;
+#else
+            return false;
+#endif
     }
     REALM_ASSERT(false);
+    return false;
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <chrono>
 #include <string>
@@ -31,8 +32,20 @@
 #include <realm/util/misc_ext_errors.hpp>
 #include <realm/util/scope_exit.hpp>
 
+// Linux io_uring
+//
+// Readiness notifications are delivered through multishot poll requests on an
+// io_uring instance rather than through epoll, which lets registrations and
+// the wait for events share a single system call. Everything else is shared
+// with the epoll backend, which is therefore implied. Requires Linux 5.13.
+#if defined(REALM_USE_IO_URING) && defined(__linux__) && !REALM_ANDROID
+#define REALM_NETWORK_USE_IO_URING 1
+#else
+#define REALM_NETWORK_USE_IO_URING 0
+#endif
+
 // Linux epoll
-#if defined(REALM_USE_EPOLL) && !REALM_ANDROID
+#if (defined(REALM_USE_EPOLL) || REALM_NETWORK_USE_IO_URING) && !REALM_ANDROID
 #define REALM_NETWORK_USE_EPOLL 1
 #else
 #define REALM_NETWORK_USE_EPOLL 0
@@ -509,6 +522,9 @@ private:
     bool m_imminent_end_of_input; // Kernel has seen the end of input
     bool m_is_registered;
     OperQueue<IoOper> m_suspended_read_ops, m_suspended_write_ops;
+#if REALM_NETWORK_USE_IO_URING
+    std::uint64_t m_poll_id; // Identifies the poll request while registered
+#endif
 
     void deregister_for_async() noexcept;
 #endif
@@ -720,6 +736,7 @@ private:
         opt_ReuseAddr, ///< `SOL_SOCKET`, `SO_REUSEADDR`
         opt_Linger,    ///< `SOL_SOCKET`, `SO_LINGER`
         opt_NoDelay,   ///< `IPPROTO_TCP`, `TCP_NODELAY` (disable the Nagle algorithm)
+        opt_ReusePort, ///< `SOL_SOCKET`, `SO_REUSEPORT`
     };
 
     template <class, int, class>
@@ -729,6 +746,12 @@ public:
     using reuse_address = Option<bool, opt_ReuseAddr, int>;
     using no_delay = Option<bool, opt_NoDelay, int>;
 
+    /// Allow several sockets, typically one acceptor per event loop, to bind
+    /// to the same address and port. Setting this option fails with
+    /// `util::MiscExtErrors::operation_not_supported` on platforms that do not
+    /// provide `SO_REUSEPORT`.
+    using reuse_port = Option<bool, opt_ReusePort, int>;
+
     // linger struct defined by POSIX sys/socket.h.
     struct linger_opt;
     using linger = Option<linger_opt, opt_Linger, struct linger>;
@@ -751,7 +774,7 @@ protected:
 
     void get_option(opt_enum, void* value_data, std::size_t& value_size, std::error_code&) const;
     void set_option(opt_enum, const void* value_data, std::size_t value_size, std::error_code&);
-    void map_option(opt_enum, int& level, int& option_name) const;
+    bool map_option(opt_enum, int& level, int& option_name) const;
 
     friend class Acceptor;
 };
@@ -3475,6 +3498,8 @@ inline std::error_code Acceptor::accept(Socket& socket, Endpoint* ep, std::error
         throw util::runtime_error("Socket is already open");
     m_desc.ensure_blocking_mode(); // Throws
     m_desc.accept(socket.m_desc, m_protocol, ep, ec);
+    if (!ec)
+        socket.m_protocol = m_protocol;
     return ec;
 }
 
@@ -3484,6 +3509,8 @@ inline Acceptor::Want Acceptor::do_accept_async(Socket& socket, Endpoint* ep, st
     m_desc.accept(socket.m_desc, m_protocol, ep, ec_2);
     if (ec_2 == util::error::resource_unavailable_try_again)
         return Want::read;
+    if (!ec_2)
+        socket.m_protocol = m_protocol;
     ec = ec_2;
     return Want::nothing;
 }
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <list>
 #include <mutex>
 
 #include <realm/string_data.hpp>
@@ -296,6 +297,117 @@ void Context::ssl_destroy() noexcept
 }
 
 
+// Client side TLS sessions by session key (Stream::set_session_key()). A context
+// may be shared by streams on different threads, so access is synchronized.
+class Context::SessionCache {
+public:
+    explicit SessionCache(std::size_t max_sessions) noexcept
+        : m_max_sessions{max_sessions}
+    {
+    }
+
+    ~SessionCache() noexcept
+    {
+        for (auto& entry : m_sessions)
+            SSL_SESSION_free(entry.second);
+    }
+
+    // Returns a new reference to the session stored under `key`, or null.
+    SSL_SESSION* get(const std::string& key) noexcept
+    {
+        std::lock_guard lock{m_mutex};
+        for (auto& entry : m_sessions) {
+            if (entry.first == key) {
+                session_up_ref(entry.second);
+                return entry.second;
+            }
+        }
+        return nullptr;
+    }
+
+    // Takes ownership of `session`, replacing any session stored under `key`.
+    void store(const std::string& key, SSL_SESSION* session)
+    {
+        std::lock_guard lock{m_mutex};
+        remove_locked(key);
+        try {
+            m_sessions.emplace_back(key, session); // Throws
+        }
+        catch (...) {
+            SSL_SESSION_free(session);
+            throw;
+        }
+        if (m_sessions.size() > m_max_sessions) {
+            SSL_SESSION_free(m_sessions.front().second);
+            m_sessions.pop_front();
+        }
+    }
+
+    void remove(const std::string& key) noexcept
+    {
+        std::lock_guard lock{m_mutex};
+        remove_locked(key);
+    }
+
+private:
+    const std::size_t m_max_sessions;
+    std::mutex m_mutex;
+    std::list<std::pair<std::string, SSL_SESSION*>> m_sessions; // Least recently stored first
+
+    void remove_locked(const std::string& key) noexcept
+    {
+        for (auto i = m_sessions.begin(); i != m_sessions.end(); ++i) {
+            if (i->first == key) {
+                SSL_SESSION_free(i->second);
+                m_sessions.erase(i);
+                return;
+            }
+        }
+    }
+
+    static void session_up_ref(SSL_SESSION* session) noexcept
+    {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L && !defined(LIBRESSL_VERSION_NUMBER)
+        SSL_SESSION_up_ref(session);
+#else
+        CRYPTO_add(&session->references, 1, CRYPTO_LOCK_SSL_SESSION);
+#endif
+    }
+};
+
+
+void Context::ssl_enable_client_session_cache(std::size_t max_sessions)
+{
+    m_session_cache = std::make_shared<SessionCache>(max_sessions); // Throws
+
+    // Sessions are only stored in, and looked up from our own cache, since the
+    // internal cache of OpenSSL is not keyed by server.
+    SSL_CTX_set_session_cache_mode(m_ssl_ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(m_ssl_ctx, &Context::new_session_callback);
+}
+
+
+// Called by OpenSSL when a session has been established. With TLS 1.3, this
+// happens when a session ticket is received after the handshake, which may be
+// more than once per connection. Returning 1 takes ownership of the session.
+int Context::new_session_callback(SSL* ssl, SSL_SESSION* session) noexcept
+{
+    Stream* stream = static_cast<Stream*>(SSL_get_ex_data(ssl, 0));
+    if (!stream || stream->m_session_key.empty())
+        return 0;
+    SessionCache* cache = stream->m_ssl_context.m_session_cache.get();
+    if (!cache)
+        return 0;
+    try {
+        cache->store(stream->m_session_key, session); // Throws
+    }
+    catch (...) {
+        // Resumption is an optimization, so failure to store is not an error
+    }
+    return 1;
+}
+
+
 void Context::ssl_use_certificate_chain_file(const std::string& path, std::error_code& ec)
 {
     ERR_clear_error();
@@ -688,16 +800,55 @@ void Stream::ssl_init()
 #endif
 
     SSL_set_bio(ssl, bio, bio);
+
+    // Allows the callbacks to find the stream
+    if (REALM_UNLIKELY(SSL_set_ex_data(ssl, 0, this) == 0)) {
+        SSL_free(ssl);
+        std::error_code ec(int(ERR_get_error()), openssl_error_category);
+        throw std::system_error(ec);
+    }
+
     m_ssl = ssl;
 }
 
 
 void Stream::ssl_destroy() noexcept
 {
+    // Connections are usually closed without sending a shutdown alert, and
+    // OpenSSL would then invalidate the session. Since TLS 1.1 that is no longer
+    // required, and a session that was involved in a fatal error is still
+    // invalidated when the error occurs.
+    if (m_ssl_context.m_session_cache && !m_session_key.empty())
+        SSL_set_shutdown(m_ssl, SSL_get_shutdown(m_ssl) | SSL_SENT_SHUTDOWN);
     SSL_free(m_ssl);
 }
 
 
+void Stream::ssl_set_session_key(const std::string& key, std::error_code& ec)
+{
+    ec = std::error_code();
+    Context::SessionCache* cache = m_ssl_context.m_session_cache.get();
+    if (!cache || m_handshake_type != client || key.empty())
+        return;
+    if (SSL_SESSION* session = cache->get(key)) {
+        int ret = SSL_set_session(m_ssl, session);
+        SSL_SESSION_free(session);
+        if (ret == 0)
+            ec = std::error_code(int(ERR_get_error()), openssl_error_category);
+    }
+}
+
+
+void Stream::ssl_forget_session() noexcept
+{
+    // A session that was involved in a failed handshake must not be offered again
+    if (Context::SessionCache* cache = m_ssl_context.m_session_cache.get()) {
+        if (!m_session_key.empty())
+            cache->remove(m_session_key);
+    }
+}
+
+
 int Stream::bio_write(BIO* bio, const char* data, int size) noexcept
 {
 #if OPENSSL_VERSION_NUMBER >= 0x10100000L && !defined(LIBRESSL_VERSION_NUMBER)
@@ -811,6 +962,11 @@ int Stream::bio_destroy(BIO*) noexcept
 
 void Context::ssl_init() {}
 
+void Context::ssl_enable_client_session_cache(std::size_t)
+{
+    m_session_cache_enabled = true;
+}
+
 void Context::ssl_destroy() noexcept
 {
 #if REALM_HAVE_KEYCHAIN_APIS
@@ -1109,6 +1265,22 @@ void Stream::ssl_set_host_name(const std::string& host_name, std::error_code& ec
 
 void Stream::ssl_use_verify_callback(const std::function<SSLVerifyCallback>&, std::error_code&) {}
 
+// Secure Transport caches sessions itself, keyed by the peer ID.
+void Stream::ssl_set_session_key(const std::string& key, std::error_code& ec)
+{
+    if (!m_ssl_context.m_session_cache_enabled || m_handshake_type != client || key.empty())
+        return;
+    if (OSStatus status = SSLSetPeerID(m_ssl.get(), key.data(), key.size()))
+        ec = std::error_code(status, secure_transport_error_category);
+}
+
+void Stream::ssl_forget_session() noexcept {}
+
+bool Stream::session_reused() const noexcept
+{
+    return false;
+}
+
 void Stream::ssl_handshake(std::error_code& ec, Want& want) noexcept
 {
     auto perform = [this]() noexcept {
@@ -1401,6 +1573,9 @@ void Context::ssl_init()
 void Context::ssl_destroy() noexcept {}
 
 
+void Context::ssl_enable_client_session_cache(std::size_t) {}
+
+
 void Stream::ssl_init() {}
 
 
@@ -1428,6 +1603,18 @@ void Stream::ssl_set_host_name(const std::string&, std::error_code&) {}
 void Stream::ssl_use_verify_callback(const std::function<SSLVerifyCallback>&, std::error_code&) {}
 
 
+void Stream::ssl_set_session_key(const std::string&, std::error_code&) {}
+
+
+void Stream::ssl_forget_session() noexcept {}
+
+
+bool Stream::session_reused() const noexcept
+{
+    return false;
+}
+
+
 void Stream::ssl_handshake(std::error_code&, Want&) noexcept {}
 
 
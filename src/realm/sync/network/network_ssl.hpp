@@ -145,9 +145,23 @@ public:
     void use_included_certificate_roots();
 #endif
 
+    /// Make client streams that use this context remember the TLS sessions
+    /// they establish, and offer them to the server on the next handshake
+    /// with the same key (Stream::set_session_key()). A resumed handshake
+    /// skips the certificate exchange and the public key operations of a full
+    /// handshake. At most \p max_sessions sessions are kept, and the least
+    /// recently stored one is evicted first.
+    ///
+    /// This must be called before any stream is created from the context, and
+    /// only on contexts that are used for client streams. With Secure
+    /// Transport, sessions are cached by the system, and \p max_sessions is
+    /// ignored.
+    void enable_client_session_cache(std::size_t max_sessions = 64);
+
 private:
     void ssl_init();
     void ssl_destroy() noexcept;
+    void ssl_enable_client_session_cache(std::size_t max_sessions);
     void ssl_use_certificate_chain_file(const std::string& path, std::error_code&);
     void ssl_use_private_key_file(const std::string& path, std::error_code&);
     void ssl_use_default_verify(std::error_code&);
@@ -157,7 +171,13 @@ private:
 #if REALM_HAVE_OPENSSL
     SSL_CTX* m_ssl_ctx = nullptr;
 
+    class SessionCache;
+    std::shared_ptr<SessionCache> m_session_cache;
+
+    static int new_session_callback(SSL*, SSL_SESSION*) noexcept;
+
 #elif REALM_HAVE_SECURE_TRANSPORT
+    bool m_session_cache_enabled = false;
 
 #if REALM_HAVE_KEYCHAIN_APIS
     std::error_code open_temporary_keychain_if_needed();
@@ -295,6 +315,24 @@ public:
     /// independent verification.
     void use_verify_callback(const std::function<SSLVerifyCallback>& callback);
 
+    /// \brief Identify the server for the purpose of TLS session resumption.
+    ///
+    /// If the context has a client session cache
+    /// (Context::enable_client_session_cache()), a session that was previously
+    /// established by a stream with the same key is offered to the server,
+    /// and the sessions established by this stream are stored under the key.
+    /// The key would normally be the host name and port of the server. Streams
+    /// with no key never resume sessions.
+    ///
+    /// It is an error if this function is called after the handshake operation
+    /// is initiated.
+    void set_session_key(std::string key);
+
+    /// Returns true if the handshake resumed an earlier session rather than
+    /// performing a full handshake. Always false with Secure Transport, which
+    /// does not report it.
+    bool session_reused() const noexcept;
+
     /// @{
     ///
     /// Read and write operations behave the same way as they do on \ref
@@ -414,6 +452,9 @@ private:
 
     bool m_valid_certificate_in_chain = false;
 
+    // See set_session_key().
+    std::string m_session_key;
+
 
     // See Service::BasicStreamOps for details on these these 6 functions.
     void do_init_read_async(std::error_code&, Want&) noexcept;
@@ -453,6 +494,8 @@ private:
     void ssl_set_verify_mode(VerifyMode, std::error_code&);
     void ssl_set_host_name(const std::string&, std::error_code&);
     void ssl_use_verify_callback(const std::function<SSLVerifyCallback>&, std::error_code&);
+    void ssl_set_session_key(const std::string&, std::error_code&);
+    void ssl_forget_session() noexcept;
 
     void ssl_handshake(std::error_code&, Want& want) noexcept;
     bool ssl_shutdown(std::error_code& ec, Want& want) noexcept;
@@ -526,6 +569,7 @@ private:
     OSStatus verify_peer() noexcept;
 #endif
 
+    friend class Context;
     friend class Service::BasicStreamOps<Stream>;
     friend class network::ReadAheadBuffer;
 #if REALM_HAVE_SECURE_TRANSPORT
@@ -636,6 +680,12 @@ inline void Context::use_included_certificate_roots()
 }
 #endif
 
+inline void Context::enable_client_session_cache(std::size_t max_sessions)
+{
+    REALM_ASSERT(max_sessions > 0);
+    ssl_enable_client_session_cache(max_sessions); // Throws
+}
+
 class Stream::HandshakeOperBase : public Service::IoOper {
 public:
     HandshakeOperBase(std::size_t size, Stream& stream)
@@ -822,6 +872,15 @@ inline void Stream::use_verify_callback(const std::function<SSLVerifyCallback>&
         throw std::system_error(ec);
 }
 
+inline void Stream::set_session_key(std::string key)
+{
+    m_session_key = std::move(key);
+    std::error_code ec;
+    ssl_set_session_key(m_session_key, ec);
+    if (ec)
+        throw std::system_error(ec);
+}
+
 inline void Stream::handshake()
 {
     std::error_code ec;
@@ -1046,6 +1105,13 @@ inline void Stream::ssl_handshake(std::error_code& ec, Want& want) noexcept
         // End of input on TCP socket
         ec = util::MiscExtErrors::premature_end_of_input;
     }
+    if (ec)
+        ssl_forget_session();
+}
+
+inline bool Stream::session_reused() const noexcept
+{
+    return SSL_session_reused(m_ssl) == 1;
 }
 
 inline std::size_t Stream::ssl_read(char* buffer, std::size_t size, std::error_code& ec, Want& want) noexcept
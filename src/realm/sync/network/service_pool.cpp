@@ -0,0 +1,173 @@
+#include <realm/sync/network/service_pool.hpp>
+
+#include <realm/util/thread.hpp>
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace realm;
+using namespace realm::sync::network;
+
+namespace {
+
+// Owns a native socket handle while it is in transit between event loops, so
+// that it is closed if the handler that would adopt it is never executed.
+class InTransitHandle {
+public:
+    using native_handle_type = SocketBase::native_handle_type;
+
+    explicit InTransitHandle(native_handle_type handle) noexcept
+        : m_handle{handle}
+        , m_owned{true}
+    {
+    }
+
+    InTransitHandle(InTransitHandle&& other) noexcept
+        : m_handle{other.m_handle}
+        , m_owned{other.m_owned}
+    {
+        other.m_owned = false;
+    }
+
+    ~InTransitHandle() noexcept
+    {
+        if (!m_owned)
+            return;
+#ifdef _WIN32
+        ::closesocket(m_handle);
+#else
+        ::close(m_handle);
+#endif
+    }
+
+    native_handle_type release() noexcept
+    {
+        REALM_ASSERT(m_owned);
+        m_owned = false;
+        return m_handle;
+    }
+
+private:
+    native_handle_type m_handle;
+    bool m_owned;
+};
+
+void pin_current_thread(std::size_t index) noexcept
+{
+    unsigned ncpus = std::thread::hardware_concurrency();
+    if (ncpus == 0)
+        return;
+    try {
+        util::Thread::set_affinity({unsigned(index % ncpus)}); // Throws
+    }
+    catch (...) {
+        // Pinning is a best-effort optimization, so failure is not an error
+    }
+}
+
+} // unnamed namespace
+
+
+ServicePool::ServicePool(Config config)
+    : m_config{std::move(config)}
+{
+    std::size_t num_threads = m_config.num_threads;
+    if (num_threads == 0)
+        num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    m_loops.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i)
+        m_loops.push_back(std::make_unique<Loop>()); // Throws
+}
+
+
+ServicePool::~ServicePool() noexcept
+{
+    stop();
+    for (auto& loop : m_loops) {
+        if (loop->thread.joinable())
+            loop->thread.join();
+    }
+}
+
+
+void ServicePool::start()
+{
+    REALM_ASSERT(!m_started);
+    m_started = true;
+    for (std::size_t i = 0; i < m_loops.size(); ++i) {
+        m_loops[i]->thread = std::thread([this, i] {
+            run(i);
+        }); // Throws
+    }
+}
+
+
+void ServicePool::stop() noexcept
+{
+    for (auto& loop : m_loops)
+        loop->service.stop();
+}
+
+
+void ServicePool::join()
+{
+    for (auto& loop : m_loops) {
+        if (loop->thread.joinable())
+            loop->thread.join();
+    }
+    std::exception_ptr exception;
+    {
+        std::lock_guard lock{m_mutex};
+        exception = std::exchange(m_exception, nullptr);
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+
+void ServicePool::hand_off(Socket& sock, Service& target, util::UniqueFunction<HandOffHandler> handler)
+{
+    StreamProtocol protocol = sock.local_endpoint().protocol(); // Throws
+    InTransitHandle handle{sock.release_native_handle()};
+    auto adopt = [handle = std::move(handle), handler = std::move(handler), protocol, &target](Status status) mutable {
+        if (status == ErrorCodes::OperationAborted)
+            return;
+        auto new_sock = std::make_unique<Socket>(target, protocol, handle.release()); // Throws
+        handler(std::move(new_sock));                                                  // Throws
+    };
+    target.post(std::move(adopt)); // Throws
+}
+
+
+void ServicePool::run(std::size_t index) noexcept
+{
+    if (!m_config.thread_name_prefix.empty()) {
+        try {
+            util::Thread::set_name(m_config.thread_name_prefix + "-" + std::to_string(index)); // Throws
+        }
+        catch (...) {
+            // Thread names are only a debugging aid
+        }
+    }
+    if (m_config.pin_threads)
+        pin_current_thread(index);
+    util::on_thread_start(util::ThreadRole::sync_event_loop);
+
+    try {
+        m_loops[index]->service.run_until_stopped(); // Throws
+    }
+    catch (...) {
+        {
+            std::lock_guard lock{m_mutex};
+            if (!m_exception)
+                m_exception = std::current_exception();
+        }
+        stop();
+    }
+}
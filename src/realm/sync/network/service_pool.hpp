@@ -0,0 +1,127 @@
+#pragma once
+
+#include <realm/sync/network/network.hpp>
+#include <realm/util/functional.hpp>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace realm::sync::network {
+
+/// \brief A fixed set of event loops, each run by its own thread.
+///
+/// A single Service is driven by one thread, so a server built on it cannot
+/// use more than one core for network I/O and completion handlers. A
+/// ServicePool owns several independent Service objects and runs each of them
+/// on a dedicated thread (optionally pinned to a CPU), which lets a server
+/// spread its connections across cores, either by letting one acceptor hand
+/// accepted sockets off to the other loops (hand_off()), or by giving every
+/// loop its own acceptor bound with Acceptor::reuse_port.
+///
+/// Objects associated with a particular Service (sockets, timers, resolvers)
+/// must still only be accessed from the thread that runs that Service. The
+/// only operations that may be invoked from any thread are Service::post(),
+/// Service::stop(), and the functions of this class that are documented as
+/// thread-safe.
+class ServicePool {
+public:
+    struct Config {
+        /// The number of event loops. Zero means one per hardware thread.
+        std::size_t num_threads = 0;
+
+        /// Pin the thread that runs the Nth event loop to CPU `N % ncpus`.
+        /// This is only supported on Linux, and is ignored elsewhere.
+        bool pin_threads = false;
+
+        /// If nonempty, the threads are named `<thread_name_prefix>-<N>`.
+        std::string thread_name_prefix = "realm-net";
+    };
+
+    explicit ServicePool(Config);
+    ServicePool();
+
+    /// Stops the event loops and joins the threads. Any exception thrown by a
+    /// completion handler that was not picked up by join() is discarded.
+    ~ServicePool() noexcept;
+
+    std::size_t size() const noexcept;
+
+    /// The Nth event loop. The returned reference remains valid for the
+    /// lifetime of the pool. Thread-safe.
+    Service& get(std::size_t index) noexcept;
+
+    /// Pick the next event loop in round-robin order. Thread-safe.
+    Service& next() noexcept;
+
+    /// Start a thread for each event loop. Each thread executes
+    /// Service::run_until_stopped(), so the loops keep running while idle. May
+    /// only be called once.
+    void start();
+
+    /// Ask every event loop to stop. Thread-safe.
+    void stop() noexcept;
+
+    /// Wait for every thread to exit. If a completion handler on any of the
+    /// loops threw, all loops are stopped, and the first such exception is
+    /// rethrown here once every thread has been joined.
+    void join();
+
+    using HandOffHandler = void(std::unique_ptr<Socket>);
+
+    /// Move the connected socket \p sock to the event loop \p target. The
+    /// socket object must be associated with the calling thread's event loop
+    /// and must have no incomplete asynchronous operations. On return, \p sock
+    /// is closed. \p handler is executed by the thread that runs \p target,
+    /// and is passed a new socket object that is associated with \p target
+    /// and owns the connection. If \p target is destroyed before it gets to
+    /// execute the handler, the connection is closed.
+    static void hand_off(Socket& sock, Service& target, util::UniqueFunction<HandOffHandler> handler);
+
+private:
+    struct Loop {
+        Service service;
+        std::thread thread;
+    };
+
+    const Config m_config;
+    std::vector<std::unique_ptr<Loop>> m_loops;
+    std::atomic<std::size_t> m_next_loop{0};
+    bool m_started = false;
+
+    std::mutex m_mutex;
+    std::exception_ptr m_exception; // Protected by `m_mutex`
+
+    void run(std::size_t index) noexcept;
+};
+
+
+// Implementation
+
+inline ServicePool::ServicePool()
+    : ServicePool(Config{})
+{
+}
+
+inline std::size_t ServicePool::size() const noexcept
+{
+    return m_loops.size();
+}
+
+inline Service& ServicePool::get(std::size_t index) noexcept
+{
+    REALM_ASSERT(index < m_loops.size());
+    return m_loops[index]->service;
+}
+
+inline Service& ServicePool::next() noexcept
+{
+    std::size_t index = m_next_loop.fetch_add(1, std::memory_order_relaxed);
+    return get(index % m_loops.size());
+}
+
+} // namespace realm::sync::network
@@ -1,11 +1,15 @@
 #include <cctype>
+#include <cstring>
 
 #include <realm/sync/network/network.hpp>
 #include <realm/sync/network/websocket.hpp>
+#include <realm/util/alloc_tracking.hpp>
 #include <realm/util/buffer.hpp>
 #include <realm/util/base64.hpp>
 #include <realm/util/sha_crypto.hpp>
 
+#include <zlib.h>
+
 using namespace realm;
 using namespace realm::sync;
 using HttpError = websocket::HttpError;
@@ -167,14 +171,33 @@ util::Optional<HTTPResponse> do_make_http_response(const HTTPRequest& request,
 }
 
 // mask_payload masks (and demasks) the payload sent from the client to the server.
-void mask_payload(char* masking_key, const char* payload, size_t payload_len, char* output)
+// \param key_offset is the position of \param payload within the frame payload, which
+// determines the byte of the masking key that is applied to the first byte. The payload
+// and output buffers may be the same buffer.
+void mask_payload(const char* masking_key, size_t key_offset, const char* payload, size_t payload_len,
+                  char* output)
 {
-    for (size_t i = 0; i < payload_len; ++i) {
-        output[i] = payload[i] ^ masking_key[i % 4];
+    char key[8];
+    for (size_t i = 0; i < 8; ++i)
+        key[i] = masking_key[(key_offset + i) % 4];
+
+    // Apply the key eight bytes at a time. The loop is simple enough for the compiler to
+    // vectorize, and memcpy() keeps it free of alignment and aliasing issues.
+    uint64_t key_word;
+    std::memcpy(&key_word, key, 8);
+    size_t i = 0;
+    for (; i + 8 <= payload_len; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, payload + i, 8);
+        word ^= key_word;
+        std::memcpy(output + i, &word, 8);
     }
+    for (; i < payload_len; ++i)
+        output[i] = payload[i] ^ key[i % 4];
 }
 
-// make_frame() creates a WebSocket frame according to the WebSocket standard.
+// make_frame_header() creates the header of a WebSocket frame according to the WebSocket
+// standard.
 // \param fin indicates whether the frame is the final fragment in a message.
 // Sync clients and servers will only send unfragmented messages, but they must be
 // prepared to receive fragmented messages.
@@ -188,14 +211,13 @@ void mask_payload(char* masking_key, const char* payload, size_t payload_len, ch
 // Sync clients and server will only send the last four, but must be prepared to
 // receive all.
 // \param mask indicates whether the payload of the frame should be masked. Frames
-// are masked if and only if they originate from the client.
-// The payload is located in the buffer \param payload, and has size \param payload_size.
-// \param output is the output buffer. It must be large enough to contain the frame.
-// The frame size can at most be payload_size + 14.
-// \param random is used to create a random masking key.
-// The return value is the size of the frame.
-size_t make_frame(bool fin, int opcode, bool mask, const char* payload, size_t payload_size, char* output,
-                  std::mt19937_64& random)
+// are masked if and only if they originate from the client. In that case a random
+// masking key is generated using \param random, placed in the header, and also stored
+// in \param masking_key, so that the caller can mask the payload.
+// \param output is the output buffer. The header size is at most 14.
+// The return value is the size of the header.
+size_t make_frame_header(bool fin, int opcode, bool mask, size_t payload_size, char* output, char* masking_key,
+                         std::mt19937_64& random)
 {
     int index = 0; // used to keep track of position within the header.
     using uchar = unsigned char;
@@ -228,7 +250,6 @@ size_t make_frame(bool fin, int opcode, bool mask, const char* payload, size_t p
         index = 10;
     }
     if (mask) {
-        char masking_key[4];
         std::uniform_int_distribution<> dis(0, 255);
         for (int i = 0; i < 4; ++i) {
             masking_key[i] = dis(random);
@@ -237,15 +258,205 @@ size_t make_frame(bool fin, int opcode, bool mask, const char* payload, size_t p
         output[index++] = masking_key[1];
         output[index++] = masking_key[2];
         output[index++] = masking_key[3];
-        mask_payload(masking_key, payload, payload_size, output + index);
     }
-    else {
-        std::copy(payload, payload + payload_size, output + index);
+
+    return index;
+}
+
+// Parameters of an RFC 7692 permessage-deflate extension offer or response. A window
+// size of zero means that the parameter is absent.
+struct DeflateParams {
+    bool server_no_context_takeover = false;
+    bool client_no_context_takeover = false;
+    int server_max_window_bits = 0;
+    bool client_max_window_bits = false; // Present, with or without a value
+    int client_max_window_bits_value = 0;
+};
+
+std::string_view trim_whitespace(std::string_view str)
+{
+    while (!str.empty() && (str.front() == ' ' || str.front() == '\t'))
+        str.remove_prefix(1);
+    while (!str.empty() && (str.back() == ' ' || str.back() == '\t'))
+        str.remove_suffix(1);
+    return str;
+}
+
+// Splits the value of a Sec-WebSocket-Extensions header into its comma separated
+// extensions, each of which is an extension name followed by semicolon separated
+// parameters.
+std::vector<std::string_view> split_header_list(std::string_view str, char delim)
+{
+    std::vector<std::string_view> items;
+    for (;;) {
+        size_t pos = str.find(delim);
+        items.push_back(trim_whitespace(str.substr(0, pos)));
+        if (pos == std::string_view::npos)
+            return items;
+        str.remove_prefix(pos + 1);
     }
+}
+
+// parse_window_bits() parses the value of a *_max_window_bits parameter, which must be
+// an integer between 8 and 15, possibly quoted. Zero is returned if the value is invalid.
+int parse_window_bits(std::string_view value)
+{
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+        value = value.substr(1, value.size() - 2);
+    if (value.size() == 1 && value[0] >= '8' && value[0] <= '9')
+        return value[0] - '0';
+    if (value.size() == 2 && value[0] == '1' && value[1] >= '0' && value[1] <= '5')
+        return 10 + (value[1] - '0');
+    return 0;
+}
 
-    return payload_size + index;
+// parse_deflate_params() parses the parameters of one permessage-deflate extension
+// (everything after the extension name). None is returned if a parameter is unknown,
+// duplicated or has an invalid value, as required by RFC 7692.
+util::Optional<DeflateParams> parse_deflate_params(const std::vector<std::string_view>& params)
+{
+    DeflateParams result;
+    bool seen_server_no_context_takeover = false, seen_client_no_context_takeover = false;
+    for (size_t i = 1; i < params.size(); ++i) {
+        std::string_view param = params[i];
+        size_t eq = param.find('=');
+        std::string_view name = trim_whitespace(param.substr(0, eq));
+        bool has_value = (eq != std::string_view::npos);
+        std::string_view value = (has_value ? trim_whitespace(param.substr(eq + 1)) : std::string_view{});
+        if (name == "server_no_context_takeover" && !has_value && !seen_server_no_context_takeover) {
+            result.server_no_context_takeover = seen_server_no_context_takeover = true;
+        }
+        else if (name == "client_no_context_takeover" && !has_value && !seen_client_no_context_takeover) {
+            result.client_no_context_takeover = seen_client_no_context_takeover = true;
+        }
+        else if (name == "server_max_window_bits" && has_value && result.server_max_window_bits == 0) {
+            result.server_max_window_bits = parse_window_bits(value);
+            if (result.server_max_window_bits == 0)
+                return none;
+        }
+        else if (name == "client_max_window_bits" && !result.client_max_window_bits) {
+            result.client_max_window_bits = true;
+            if (has_value) {
+                result.client_max_window_bits_value = parse_window_bits(value);
+                if (result.client_max_window_bits_value == 0)
+                    return none;
+            }
+        }
+        else {
+            return none;
+        }
+    }
+    return result;
 }
 
+constexpr std::string_view permessage_deflate_name = "permessage-deflate";
+
+// PermessageDeflate compresses outgoing and decompresses incoming messages according
+// to RFC 7692. Unless no context takeover was negotiated, the LZ77 window is kept
+// across messages, so that a message can refer back to earlier messages in the same
+// direction.
+class PermessageDeflate {
+public:
+    // \param deflate_window_bits is the base-two logarithm of the window size used for
+    // compression. zlib cannot produce raw streams with a window of 256 bytes, so it
+    // must be at least 9. Incoming messages are always decompressed with the maximum
+    // window, which accepts any window the peer can legally use.
+    PermessageDeflate(int deflate_window_bits, bool deflate_no_context_takeover)
+        : m_deflate_no_context_takeover{deflate_no_context_takeover}
+    {
+        REALM_ASSERT(deflate_window_bits >= 9 && deflate_window_bits <= 15);
+        // Negative window bits select raw deflate streams without zlib header
+        int ret = deflateInit2(&m_deflate, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -deflate_window_bits, 8,
+                               Z_DEFAULT_STRATEGY);
+        if (ret != Z_OK)
+            throw std::bad_alloc();
+        ret = inflateInit2(&m_inflate, -15);
+        if (ret != Z_OK) {
+            deflateEnd(&m_deflate);
+            throw std::bad_alloc();
+        }
+    }
+
+    ~PermessageDeflate() noexcept
+    {
+        deflateEnd(&m_deflate);
+        inflateEnd(&m_inflate);
+    }
+
+    // compress() replaces the contents of \param out with the compressed form of the
+    // message. The capacity of \param out is reused across messages.
+    void compress(const char* data, size_t size, std::vector<char>& out)
+    {
+        util::AllocTagScope alloc_tag{util::AllocTag::websocket};
+        size_t bound = size_t(deflateBound(&m_deflate, uLong(size))) + 16;
+        if (out.size() < bound)
+            out.resize(bound);
+        m_deflate.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        m_deflate.avail_in = uInt(size);
+        size_t out_size = 0;
+        for (;;) {
+            m_deflate.next_out = reinterpret_cast<Bytef*>(out.data() + out_size);
+            m_deflate.avail_out = uInt(out.size() - out_size);
+            int ret = deflate(&m_deflate, Z_SYNC_FLUSH);
+            REALM_ASSERT_RELEASE(ret == Z_OK || ret == Z_BUF_ERROR);
+            out_size = out.size() - m_deflate.avail_out;
+            if (m_deflate.avail_out != 0)
+                break;
+            out.resize(out.size() * 2);
+        }
+        // The flush ends with an empty stored block (00 00 ff ff), which is left out
+        // of the message as required by RFC 7692.
+        REALM_ASSERT(out_size >= 4);
+        out.resize(out_size - 4);
+        if (m_deflate_no_context_takeover)
+            deflateReset(&m_deflate);
+    }
+
+    // decompress() replaces the contents of \param out with the decompressed form of
+    // the message. False is returned if the message is not a valid deflate stream.
+    bool decompress(const char* data, size_t size, std::vector<char>& out)
+    {
+        util::AllocTagScope alloc_tag{util::AllocTag::websocket};
+        static const char tail[4] = {0, 0, char(0xFF), char(0xFF)};
+        if (out.size() < 2 * size + 256)
+            out.resize(2 * size + 256);
+        size_t out_size = 0;
+        const char* input = data;
+        size_t input_size = size;
+        for (int pass = 0; pass < 2; ++pass) {
+            m_inflate.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input));
+            m_inflate.avail_in = uInt(input_size);
+            for (;;) {
+                if (out_size == out.size())
+                    out.resize(out.size() * 2);
+                m_inflate.next_out = reinterpret_cast<Bytef*>(out.data() + out_size);
+                m_inflate.avail_out = uInt(out.size() - out_size);
+                int ret = inflate(&m_inflate, Z_SYNC_FLUSH);
+                out_size = out.size() - m_inflate.avail_out;
+                if (ret == Z_STREAM_END) {
+                    // The peer ended the stream with a final block, so the next
+                    // message starts a new one.
+                    inflateReset(&m_inflate);
+                    break;
+                }
+                if (ret != Z_OK && ret != Z_BUF_ERROR)
+                    return false;
+                if (m_inflate.avail_in == 0 && m_inflate.avail_out != 0)
+                    break;
+            }
+            input = tail;
+            input_size = sizeof tail;
+        }
+        out.resize(out_size);
+        return true;
+    }
+
+private:
+    z_stream m_deflate = z_stream();
+    z_stream m_inflate = z_stream();
+    const bool m_deflate_no_context_takeover;
+};
+
 // class FrameReader takes care of parsing the incoming bytes and
 // constructing the received WebSocket messages. FrameReader manages
 // read buffers internally. FrameReader handles fragmented messages as
@@ -287,10 +498,13 @@ public:
     bool protocol_error = false;
     bool delivery_ready = false;
     websocket::Opcode delivery_opcode = websocket::Opcode::continuation;
+    // The delivered message was compressed with permessage-deflate (RSV1 was set).
+    bool delivery_compressed = false;
 
-    FrameReader(util::Logger& logger, bool& is_client)
+    FrameReader(util::Logger& logger, bool& is_client, bool& permessage_deflate)
         : logger(logger)
         , m_is_client(is_client)
+        , m_permessage_deflate(permessage_deflate)
     {
     }
 
@@ -328,6 +542,7 @@ public:
 
 private:
     bool& m_is_client;
+    bool& m_permessage_deflate;
 
     char header_buffer[14];
     char* m_masking_key;
@@ -346,6 +561,9 @@ private:
     // The opcode of the message.
     websocket::Opcode m_message_opcode = websocket::Opcode::continuation;
 
+    // Whether the first frame of the message had RSV1 set.
+    bool m_message_compressed = false;
+
     // The size of the stored Websocket message.
     // This size is not the same as the size of the buffer.
     size_t m_message_size = 0;
@@ -374,8 +592,10 @@ private:
         }
         else {
             size_t required_size = m_message_size + m_payload_size;
-            if (m_message_buffer.size() < required_size)
+            if (m_message_buffer.size() < required_size) {
+                util::AllocTagScope alloc_tag{util::AllocTag::websocket};
                 m_message_buffer.resize(required_size);
+            }
 
             read_buffer = m_message_buffer.data() + m_message_size;
         }
@@ -383,9 +603,12 @@ private:
 
     void reset_message_buffer()
     {
-        if (m_message_buffer.size() != s_message_buffer_min_size)
+        if (m_message_buffer.size() != s_message_buffer_min_size) {
+            util::AllocTagScope alloc_tag{util::AllocTag::websocket};
             m_message_buffer.resize(s_message_buffer_min_size);
+        }
         m_message_opcode = websocket::Opcode::continuation;
+        m_message_compressed = false;
         m_message_size = 0;
     }
 
@@ -400,6 +623,7 @@ private:
         delivery_buffer = nullptr;
         delivery_size = 0;
         delivery_opcode = websocket::Opcode::continuation;
+        delivery_compressed = false;
         m_stage = Stage::header_beginning;
         reset_message_buffer();
         read_buffer = header_buffer;
@@ -414,9 +638,10 @@ private:
         // bit 1.
         m_fin = ((header_buffer[0] & 128) == 128);
 
-        // bit 2,3, and 4.
-        char rsv = (header_buffer[0] & 112) >> 4;
-        if (rsv != 0)
+        // bit 2, 3, and 4. RSV1 marks a compressed message when permessage-deflate has
+        // been negotiated.
+        bool rsv1 = ((header_buffer[0] & 64) == 64);
+        if ((header_buffer[0] & 48) != 0)
             return set_protocol_error();
 
         // bit 5, 6, 7, and 8.
@@ -427,6 +652,11 @@ private:
 
         m_opcode = websocket::Opcode(op);
 
+        // RSV1 is only allowed on the first frame of a text or binary message.
+        if (rsv1 && (!m_permessage_deflate || (m_opcode != websocket::Opcode::text &&
+                                               m_opcode != websocket::Opcode::binary)))
+            return set_protocol_error();
+
         // bit 9.
         m_mask = ((header_buffer[1] & 128) == 128);
         if ((m_mask && m_is_client) || (!m_mask && !m_is_client))
@@ -444,6 +674,7 @@ private:
                 return set_protocol_error();
 
             m_message_opcode = m_opcode;
+            m_message_compressed = rsv1;
         }
         else { // close, ping, pong.
             if (!m_fin || m_short_payload_size > 125)
@@ -521,7 +752,7 @@ private:
     void stage_payload()
     {
         if (m_mask)
-            mask_payload(m_masking_key, read_buffer, m_payload_size, read_buffer);
+            mask_payload(m_masking_key, 0, read_buffer, m_payload_size, read_buffer);
 
         if (m_opcode == websocket::Opcode::close || m_opcode == websocket::Opcode::ping ||
             m_opcode == websocket::Opcode::pong) {
@@ -537,6 +768,7 @@ private:
                 m_stage = Stage::delivery;
                 delivery_ready = true;
                 delivery_opcode = m_message_opcode;
+                delivery_compressed = m_message_compressed;
                 delivery_buffer = m_message_buffer.data();
                 delivery_size = m_message_size;
             }
@@ -557,6 +789,7 @@ private:
         delivery_buffer = nullptr;
         delivery_size = 0;
         delivery_opcode = websocket::Opcode::continuation;
+        delivery_compressed = false;
 
         if (m_opcode == websocket::Opcode::continuation || m_opcode == websocket::Opcode::text ||
             m_opcode == websocket::Opcode::binary)
@@ -571,7 +804,7 @@ public:
         : m_config(config)
         , m_logger_ptr(config.websocket_get_logger())
         , m_logger{*m_logger_ptr}
-        , m_frame_reader(m_logger, m_is_client)
+        , m_frame_reader(m_logger, m_is_client, m_permessage_deflate)
     {
         m_logger.debug(util::LogCategory::network, "WebSocket::Websocket()");
     }
@@ -583,6 +816,7 @@ public:
 
         m_stopped = false;
         m_is_client = true;
+        reset_permessage_deflate();
 
         m_sec_websocket_key = make_random_sec_websocket_key(m_config.websocket_get_random());
 
@@ -609,6 +843,8 @@ public:
         req.headers["Sec-WebSocket-Key"] = m_sec_websocket_key;
         req.headers["Sec-WebSocket-Version"] = sec_websocket_version;
         req.headers["Sec-WebSocket-Protocol"] = sec_websocket_protocol;
+        if (m_config.websocket_permessage_deflate_enabled())
+            req.headers["Sec-WebSocket-Extensions"] = std::string(permessage_deflate_name);
 
         m_logger.trace(util::LogCategory::network, "HTTP request =\n%1", req);
 
@@ -640,6 +876,7 @@ public:
     {
         m_stopped = false;
         m_is_client = false;
+        reset_permessage_deflate();
         m_frame_reader.reset();
         frame_reader_loop(); // Throws
     }
@@ -650,6 +887,7 @@ public:
 
         m_stopped = false;
         m_is_client = false;
+        reset_permessage_deflate();
         m_http_server.reset(new HTTPServer<websocket::Config>(m_config, m_logger_ptr));
         m_frame_reader.reset();
 
@@ -678,17 +916,79 @@ public:
     {
         REALM_ASSERT(!m_stopped);
 
-        bool mask = m_is_client;
+        // Only complete messages are compressed, since RSV1 must be set on the first frame
+        // of a message, and the compressed size is not known until the whole message has
+        // been compressed.
+        bool compressed = (m_deflate && fin &&
+                           (opcode == int(websocket::Opcode::text) || opcode == int(websocket::Opcode::binary)));
+        if (compressed) {
+            m_deflate->compress(data, size, m_deflate_buffer); // Throws
+            data = m_deflate_buffer.data();
+            size = m_deflate_buffer.size();
+        }
 
-        // 14 is the maximum header length of a Websocket frame.
-        size_t required_size = size + 14;
-        if (m_write_buffer.size() < required_size)
+        m_write_payload = data;
+        m_write_payload_size = size;
+        m_write_payload_offset = 0;
+        m_write_masked = m_is_client;
+
+        // The buffer is reused across frames, and never needs to hold more than one chunk of
+        // payload, so it is never shrunk again.
+        bool payload_is_copied = (m_write_masked || size <= s_write_chunk_size);
+        size_t required_size = s_max_header_size + (payload_is_copied ? std::min(size, s_write_chunk_size) : 0);
+        if (m_write_buffer.size() < required_size) {
+            util::AllocTagScope alloc_tag{util::AllocTag::websocket};
             m_write_buffer.resize(required_size);
+        }
+
+        size_t header_size = make_frame_header(fin, opcode, m_write_masked, size, m_write_buffer.data(),
+                                               m_write_masking_key, m_config.websocket_get_random());
+        if (compressed)
+            m_write_buffer[0] |= 64; // RSV1
+        m_write_frame_size = header_size + size;
+        initiate_write_step(header_size, std::move(write_completion_handler));
+    }
 
-        size_t message_size =
-            make_frame(fin, opcode, mask, data, size, m_write_buffer.data(), m_config.websocket_get_random());
+    // Writes the next part of the frame, of which the first `header_size` bytes of
+    // `m_write_buffer` may be the header. Small payloads are copied into `m_write_buffer`
+    // behind the header, so that the frame is sent by a single write. An unmasked large
+    // payload is written directly from the caller's buffer after the header, and a
+    // masked one is masked into `m_write_buffer` one chunk at a time. No buffer is ever
+    // allocated in proportion to the payload size.
+    void initiate_write_step(size_t header_size, sync::websocket::WriteCompletionHandler write_completion_handler)
+    {
+        const char* payload = m_write_payload + m_write_payload_offset;
+        size_t remaining = m_write_payload_size - m_write_payload_offset;
+        const char* data;
+        size_t size;
+        size_t payload_size;
+        if (!m_write_masked && remaining > s_write_chunk_size) {
+            if (header_size > 0) {
+                data = m_write_buffer.data();
+                size = header_size;
+                payload_size = 0;
+            }
+            else {
+                data = payload;
+                size = remaining;
+                payload_size = remaining;
+            }
+        }
+        else {
+            payload_size = std::min(remaining, s_write_chunk_size);
+            char* out = m_write_buffer.data() + header_size;
+            if (m_write_masked) {
+                mask_payload(m_write_masking_key, m_write_payload_offset, payload, payload_size, out);
+            }
+            else {
+                std::copy(payload, payload + payload_size, out);
+            }
+            data = m_write_buffer.data();
+            size = header_size + payload_size;
+        }
 
-        auto handler = [this, handler = std::move(write_completion_handler)](std::error_code ec, size_t) mutable {
+        auto handler = [this, payload_size,
+                        handler = std::move(write_completion_handler)](std::error_code ec, size_t) mutable {
             // If the operation is aborted, then the write operation was canceled and we should ignore this callback.
             if (ec == util::error::operation_aborted) {
                 return handler(ec, 0);
@@ -710,20 +1010,15 @@ public:
                 return m_config.websocket_write_error_handler(ec);
             }
 
-            handle_write_message(std::move(handler));
+            m_write_payload_offset += payload_size;
+            if (m_write_payload_offset < m_write_payload_size) {
+                initiate_write_step(0, std::move(handler)); // Throws
+                return;
+            }
+            handler(std::error_code(), m_write_frame_size);
         };
 
-        m_config.async_write(m_write_buffer.data(), message_size, std::move(handler));
-    }
-
-    void handle_write_message(sync::websocket::WriteCompletionHandler write_handler)
-    {
-        if (m_write_buffer.size() > s_write_buffer_stable_size) {
-            m_write_buffer.resize(s_write_buffer_stable_size);
-            m_write_buffer.shrink_to_fit();
-        }
-
-        write_handler(std::error_code(), m_write_buffer.size());
+        m_config.async_write(data, size, std::move(handler));
     }
 
     void stop() noexcept
@@ -747,6 +1042,14 @@ private:
     bool m_stopped = false;
     bool m_is_client;
 
+    // Set when permessage-deflate was negotiated during the handshake.
+    bool m_permessage_deflate = false;
+    std::unique_ptr<PermessageDeflate> m_deflate;
+    // Compressed form of the message being written, and decompressed form of the
+    // message being delivered. Both are reused across messages.
+    std::vector<char> m_deflate_buffer;
+    std::vector<char> m_inflate_buffer;
+
     // Allocated on demand.
     std::unique_ptr<HTTPClient<websocket::Config>> m_http_client;
     std::unique_ptr<HTTPServer<websocket::Config>> m_http_server;
@@ -754,8 +1057,18 @@ private:
     std::string m_sec_websocket_key;
     std::string m_sec_websocket_accept;
 
+    // Frame header, followed by at most one chunk of payload.
     std::vector<char> m_write_buffer;
-    static const size_t s_write_buffer_stable_size = 2048;
+    static constexpr size_t s_max_header_size = 14;
+    static constexpr size_t s_write_chunk_size = 64 * 1024;
+
+    // State of the frame being written.
+    const char* m_write_payload = nullptr;
+    size_t m_write_payload_size = 0;
+    size_t m_write_payload_offset = 0;
+    size_t m_write_frame_size = 0;
+    bool m_write_masked = false;
+    char m_write_masking_key[4];
 
     std::optional<int> m_test_handshake_response;
     std::string m_test_handshake_response_body;
@@ -855,6 +1168,77 @@ private:
         m_config.websocket_handshake_error_handler(ec, &request.headers, {}); // Throws
     }
 
+    void reset_permessage_deflate() noexcept
+    {
+        m_permessage_deflate = false;
+        m_deflate.reset();
+    }
+
+    void enable_permessage_deflate(int deflate_window_bits, bool deflate_no_context_takeover)
+    {
+        m_deflate = std::make_unique<PermessageDeflate>(deflate_window_bits, deflate_no_context_takeover); // Throws
+        m_permessage_deflate = true;
+    }
+
+    // accept_permessage_deflate_response() checks the extensions accepted by the server.
+    // False is returned if the server accepted an extension that was not offered, or
+    // parameters that the client cannot honor.
+    bool accept_permessage_deflate_response(const HTTPHeaders& headers)
+    {
+        util::Optional<StringData> header_value = find_http_header_value(headers, "Sec-WebSocket-Extensions");
+        if (!header_value)
+            return true;
+        if (!m_config.websocket_permessage_deflate_enabled())
+            return false;
+        std::vector<std::string_view> extensions = split_header_list(std::string_view(*header_value), ',');
+        if (extensions.size() != 1)
+            return false;
+        std::vector<std::string_view> params = split_header_list(extensions[0], ';');
+        if (params[0] != permessage_deflate_name)
+            return false;
+        util::Optional<DeflateParams> deflate_params = parse_deflate_params(params);
+        // The client did not offer client_max_window_bits, so the server must not
+        // limit the client's window.
+        if (!deflate_params || deflate_params->client_max_window_bits)
+            return false;
+        enable_permessage_deflate(15, deflate_params->client_no_context_takeover); // Throws
+        return true;
+    }
+
+    // accept_permessage_deflate_offer() accepts the first permessage-deflate offer in
+    // the request that the server can honor, and adds the response header for it.
+    void accept_permessage_deflate_offer(const HTTPRequest& request, HTTPResponse& response)
+    {
+        if (!m_config.websocket_permessage_deflate_enabled())
+            return;
+        util::Optional<StringData> header_value =
+            find_http_header_value(request.headers, "Sec-WebSocket-Extensions");
+        if (!header_value)
+            return;
+        for (std::string_view extension : split_header_list(std::string_view(*header_value), ',')) {
+            std::vector<std::string_view> params = split_header_list(extension, ';');
+            if (params[0] != permessage_deflate_name)
+                continue;
+            util::Optional<DeflateParams> deflate_params = parse_deflate_params(params);
+            // zlib cannot produce raw deflate streams with a window of 256 bytes
+            if (!deflate_params || deflate_params->server_max_window_bits == 8)
+                continue;
+            std::string value{permessage_deflate_name};
+            if (deflate_params->server_no_context_takeover)
+                value += "; server_no_context_takeover";
+            if (deflate_params->client_no_context_takeover)
+                value += "; client_no_context_takeover";
+            int window_bits = 15;
+            if (deflate_params->server_max_window_bits != 0) {
+                window_bits = deflate_params->server_max_window_bits;
+                value += "; server_max_window_bits=" + std::to_string(window_bits);
+            }
+            enable_permessage_deflate(window_bits, deflate_params->server_no_context_takeover); // Throws
+            response.headers["Sec-WebSocket-Extensions"] = std::move(value);
+            return;
+        }
+    }
+
     void protocol_error(std::error_code ec)
     {
         m_stopped = true;
@@ -874,7 +1258,7 @@ private:
 
         bool valid = (find_sec_websocket_accept(response.headers) &&
                       m_sec_websocket_accept == make_sec_websocket_accept(m_sec_websocket_key));
-        if (!valid) {
+        if (!valid || !accept_permessage_deflate_response(response.headers)) {
             error_client_response_websocket_headers_invalid(response);
             return;
         }
@@ -902,6 +1286,7 @@ private:
             return;
         }
         REALM_ASSERT(response);
+        accept_permessage_deflate_offer(request, *response); // Throws
 
         auto handler = [request, this](std::error_code ec) {
             // If the operation is aborted, the socket object may have been destroyed.
@@ -1005,6 +1390,17 @@ private:
         if (m_frame_reader.delivery_ready) {
             bool should_continue = true;
 
+            if (m_frame_reader.delivery_compressed) {
+                REALM_ASSERT(m_deflate);
+                if (!m_deflate->decompress(m_frame_reader.delivery_buffer, m_frame_reader.delivery_size,
+                                           m_inflate_buffer)) { // Throws
+                    protocol_error(HttpError::bad_message);
+                    return;
+                }
+                m_frame_reader.delivery_buffer = m_inflate_buffer.data();
+                m_frame_reader.delivery_size = m_inflate_buffer.size();
+            }
+
             switch (m_frame_reader.delivery_opcode) {
                 case websocket::Opcode::text:
                     should_continue = m_config.websocket_text_message_received(m_frame_reader.delivery_buffer,
@@ -1214,6 +1610,11 @@ std::ostream& operator<<(std::ostream& os, WebSocketError code)
 
 } // namespace realm::sync::websocket
 
+bool websocket::Config::websocket_permessage_deflate_enabled() noexcept
+{
+    return false;
+}
+
 bool websocket::Config::websocket_text_message_received(const char*, size_t)
 {
     return true;
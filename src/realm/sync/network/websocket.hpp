@@ -25,6 +25,13 @@ public:
     /// The caller must supply a random number generator.
     virtual std::mt19937_64& websocket_get_random() noexcept = 0;
 
+    /// If websocket_permessage_deflate_enabled() returns true, the Socket negotiates the
+    /// permessage-deflate extension (RFC 7692) during the handshake. When the peer agrees,
+    /// complete text and binary messages are compressed with a window that is kept across
+    /// messages, unless the peer asks for no context takeover. Fragmented messages are
+    /// sent uncompressed. The default implementation returns false.
+    virtual bool websocket_permessage_deflate_enabled() noexcept;
+
     //@{
     /// The three functions below are used by the Socket to read and write to the underlying
     /// stream. The functions will typically be implemented as wrappers to a TCP/TLS stream,
@@ -126,6 +133,8 @@ public:
     /// meaning that the user must wait for the handler to be called before sending the next frame.
     /// The handler is type util::UniqueFunction<void()> and is called when the frame has been successfully
     /// sent. In case of errors, the Config::websocket_write_error_handler() is called.
+    /// The payload is not copied up front, so the buffer must stay valid and unmodified until the handler is
+    /// called.
 
     /// async_write_frame() sends a single frame with this content:
     /// \param fin The fin bit set to 0 or 1
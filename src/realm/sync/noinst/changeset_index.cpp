@@ -306,7 +306,9 @@ auto ChangesetIndex::erase_instruction(RangeIterator pos) -> RangeIterator
     Changeset* changeset = pos.m_outer->first;
     pos.check();
     auto new_pos = pos;
-    new_pos.m_pos = changeset->erase_stable(pos.m_pos);
+    // Instructions outside of the range may belong to other conflict groups,
+    // which may be transformed concurrently, so they must not be looked at
+    new_pos.m_pos = changeset->erase_stable(pos.m_pos, pos.m_inner->end);
 
     if (new_pos.m_pos >= new_pos.m_inner->end) {
         // erased the last instruction in the range, move to the next range.
@@ -96,6 +96,13 @@ struct ChangesetIndex {
         return m_num_conflict_groups;
     }
 
+    /// If true, every instruction is in the same conflict group (see
+    /// get_everything()).
+    bool contains_destructive_schema_changes() const noexcept
+    {
+        return m_contains_destructive_schema_changes;
+    }
+
     struct RangeIterator;
 
     RangeIterator erase_instruction(RangeIterator);
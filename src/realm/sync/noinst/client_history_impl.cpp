@@ -19,6 +19,7 @@
 #include <realm/sync/noinst/client_history_impl.hpp>
 
 #include <realm/sync/changeset.hpp>
+#include <realm/sync/changeset_encoder.hpp>
 #include <realm/sync/changeset_parser.hpp>
 #include <realm/sync/instruction_applier.hpp>
 #include <realm/sync/instruction_replication.hpp>
@@ -29,6 +30,7 @@
 #include <realm/util/features.h>
 #include <realm/util/functional.hpp>
 #include <realm/util/scope_exit.hpp>
+#include <realm/util/trace.hpp>
 #include <realm/version.hpp>
 
 #include <algorithm>
@@ -45,6 +47,10 @@ void ClientHistory::set_history_adjustments(
     ensure_updated(current_version); // Throws
     prepare_for_write();             // Throws
 
+    // The local history is rewritten, so cached reciprocal transforms may no
+    // longer match it
+    m_reciprocal_transform_cache.clear();
+
     version_type client_version = m_sync_history_base_version + sync_history_size();
     REALM_ASSERT(client_version == current_version); // For now
     Array& root = m_arrays->root;
@@ -78,10 +84,11 @@ void ClientHistory::set_history_adjustments(
 
         util::compression::CompressMemoryArena arena;
         util::AppendBuffer<char> compressed;
+        auto dictionary = m_arrays->get_changeset_dictionary();
         for (auto& [changeset, version] : recovered_changesets) {
             uploadable_bytes += changeset.size();
             auto i = size_t(version - m_sync_history_base_version);
-            util::compression::allocate_and_compress_nonportable(arena, changeset, compressed);
+            util::compression::allocate_and_compress_nonportable(arena, changeset, compressed, dictionary);
             m_arrays->changesets.set(i, BinaryData{compressed.data(), compressed.size()}); // Throws
             m_arrays->reciprocal_transforms.set(i, BinaryData());
         }
@@ -158,7 +165,7 @@ std::vector<ClientHistory::LocalChange> ClientHistory::get_local_changes(version
             // otherwise adds 1 to the version, and then get_reciprocal_transform()
             // subtracts 1 from the version
             if (auto changeset = get_reciprocal_transform(version + 1, compressed); changeset.size()) {
-                changesets.push_back({version, changeset});
+                changesets.push_back({version, changeset, m_arrays->get_changeset_dictionary()});
             }
         }
     }
@@ -195,7 +202,7 @@ int ClientReplication::get_history_schema_version() const noexcept
 // Overriding member function in realm::Replication
 bool ClientReplication::is_upgradable_history_schema(int stored_schema_version) const noexcept
 {
-    if (stored_schema_version == 11) {
+    if (stored_schema_version == 11 || stored_schema_version == 12) {
         return true;
     }
     return false;
@@ -214,11 +221,20 @@ void ClientReplication::upgrade_history_schema(int stored_schema_version)
     int orig_schema_version = stored_schema_version;
     int schema_version = orig_schema_version;
 
+    // The history arrays can only be attached once the root array has its
+    // current size, so the slot added by version 13 must be added before the
+    // other migration steps
+    if (schema_version < 13)
+        m_history.add_changeset_dictionary_column(); // Throws
+
     if (schema_version < 12) {
         m_history.compress_stored_changesets();
         schema_version = 12;
     }
 
+    if (schema_version < 13)
+        schema_version = 13;
+
     // NOTE: Future migration steps go here.
 
     REALM_ASSERT(schema_version == get_client_history_schema_version());
@@ -250,6 +266,21 @@ void ClientHistory::compress_stored_changesets()
     }
 }
 
+void ClientHistory::add_changeset_dictionary_column()
+{
+    using gf = _impl::GroupFriend;
+    Allocator& alloc = gf::get_alloc(*m_group);
+    Array root{alloc};
+    root.init_from_ref(gf::get_history_ref(*m_group));
+    gf::set_history_parent(*m_group, root);
+    REALM_ASSERT(root.size() == s_changeset_dictionary_iip);
+    root.add(0); // Throws
+
+    BinaryColumn changeset_dictionary{alloc};
+    changeset_dictionary.set_parent(&root, s_changeset_dictionary_iip);
+    changeset_dictionary.create(); // Throws
+}
+
 // Overriding member function in realm::Replication
 auto ClientReplication::prepare_changeset(const char* data, size_t size, version_type orig_version) -> version_type
 {
@@ -330,6 +361,7 @@ void ClientHistory::set_client_file_ident(SaltedFileIdent client_file_ident, boo
     root.set(s_progress_upload_client_version_iip, RefOrTagged::make_tagged(0));
 
     if (fix_up_object_ids) {
+        m_reciprocal_transform_cache.clear();
         fix_up_client_file_ident_in_stored_changesets(*wt, client_file_ident.ident); // Throws
     }
 
@@ -357,9 +389,69 @@ void ClientHistory::set_sync_progress(const SyncProgress& progress, const std::u
     version_info.sync_version = {new_version, 0};
 }
 
+namespace {
+
+// Decompresses a changeset while reading it from its chunks in the history
+class CompressedChangesetInputStream final : public util::InputStream {
+public:
+    CompressedChangesetInputStream(const std::vector<BinaryData>& chunks, util::Span<const char> dictionary)
+        : m_source(chunks)
+    {
+        std::size_t size;
+        m_decompressed = util::compression::decompress_nonportable_input_stream(m_source, size, dictionary); // Throws
+    }
+
+    // False if the changeset was compressed with an algorithm which is not
+    // available on this platform
+    bool is_supported() const noexcept
+    {
+        return bool(m_decompressed);
+    }
+
+    util::Span<const char> next_block() override
+    {
+        return m_decompressed->next_block();
+    }
+
+private:
+    class Chunks final : public util::InputStream {
+    public:
+        Chunks(const std::vector<BinaryData>& chunks)
+            : m_chunks(chunks)
+        {
+        }
+
+        util::Span<const char> next_block() override
+        {
+            if (m_next == m_chunks.size())
+                return {};
+            BinaryData chunk = m_chunks[m_next++];
+            return {chunk.data(), chunk.size()};
+        }
+
+    private:
+        const std::vector<BinaryData>& m_chunks;
+        std::size_t m_next = 0;
+    };
+
+    Chunks m_source;
+    std::unique_ptr<util::InputStream> m_decompressed;
+};
+
+} // unnamed namespace
+
+std::unique_ptr<util::InputStream> ClientHistory::UploadChangeset::open() const
+{
+    if (!snapshot)
+        return std::make_unique<ChunkedBinaryInputStream>(changeset); // Throws
+    auto stream = std::make_unique<CompressedChangesetInputStream>(compressed_chunks, dictionary); // Throws
+    REALM_ASSERT(stream->is_supported());
+    return stream;
+}
+
 void ClientHistory::find_uploadable_changesets(UploadCursor& upload_progress, version_type end_version,
                                                std::vector<UploadChangeset>& uploadable_changesets,
-                                               version_type& locked_server_version) const
+                                               version_type& locked_server_version, bool decompress) const
 {
     TransactionRef rt = m_db->start_read(); // Throws
     auto& alloc = m_db->get_alloc();
@@ -370,6 +462,7 @@ void ClientHistory::find_uploadable_changesets(UploadCursor& upload_progress, ve
     Arrays arrays(alloc, rt.get(), ref);
     const auto sync_history_size = arrays.changesets.size();
     const auto sync_history_base_version = rt->get_version() - sync_history_size;
+    const auto dictionary = arrays.get_changeset_dictionary();
 
     std::size_t accum_byte_size_soft_limit = 131072;   // 128 KB
     std::size_t accum_byte_size_hard_limit = 16777216; // server-imposed limit
@@ -400,18 +493,36 @@ void ClientHistory::find_uploadable_changesets(UploadCursor& upload_progress, ve
         begin_version_2 = version;
 
         UploadChangeset uc;
+        uc.origin_timestamp = entry.origin_timestamp;
+        uc.origin_file_ident = entry.origin_file_ident;
+        uc.progress = UploadCursor{version, entry.remote_version};
+        uc.size = size;
+
+        if (!decompress) {
+            // The chunks point into the file, which stays mapped for as long
+            // as the read transaction is kept
+            BinaryIterator chunks = entry.changeset.iterator();
+            for (BinaryData chunk = chunks.get_next(); chunk.size() != 0; chunk = chunks.get_next())
+                uc.compressed_chunks.push_back(chunk); // Throws
+            uc.dictionary = dictionary;
+            if (!CompressedChangesetInputStream(uc.compressed_chunks, uc.dictionary).is_supported()) {
+                REALM_TERMINATE(
+                    "Synchronized Realm files with unuploaded local changes cannot be copied between platforms.");
+            }
+            uc.snapshot = rt;
+            uploadable_changesets.push_back(std::move(uc)); // Throws
+            continue;
+        }
+
         util::AppendBuffer<char> decompressed;
         ChunkedBinaryInputStream is_2(entry.changeset);
-        auto ec = util::compression::decompress_nonportable(is_2, decompressed);
+        auto ec = util::compression::decompress_nonportable(is_2, decompressed, dictionary);
         if (ec == util::compression::error::decompress_unsupported) {
             REALM_TERMINATE(
                 "Synchronized Realm files with unuploaded local changes cannot be copied between platforms.");
         }
         REALM_ASSERT_3(ec, ==, std::error_code{});
 
-        uc.origin_timestamp = entry.origin_timestamp;
-        uc.origin_file_ident = entry.origin_file_ident;
-        uc.progress = UploadCursor{version, entry.remote_version};
         uc.changeset = BinaryData{decompressed.data(), decompressed.size()};
         uc.buffer = decompressed.release().release();
         uploadable_changesets.push_back(std::move(uc)); // Throws
@@ -423,20 +534,84 @@ void ClientHistory::find_uploadable_changesets(UploadCursor& upload_progress, ve
 }
 
 
+std::size_t ClientHistory::coalesce_uploadable_changesets(std::vector<UploadChangeset>& uploadable_changesets,
+                                                          timestamp_type time_window, std::size_t size_limit)
+{
+    auto can_merge = [&](const UploadChangeset& first, const UploadChangeset& next, std::size_t accum_size) {
+        return next.progress.last_integrated_server_version == first.progress.last_integrated_server_version &&
+               next.origin_timestamp >= first.origin_timestamp &&
+               next.origin_timestamp - first.origin_timestamp <= time_window &&
+               accum_size + next.changeset.size() <= size_limit;
+    };
+
+    std::size_t num_changesets = uploadable_changesets.size();
+    std::vector<UploadChangeset> result;
+    std::size_t begin = 0;
+    while (begin < uploadable_changesets.size()) {
+        const UploadChangeset& first = uploadable_changesets[begin];
+        std::size_t end = begin + 1;
+        std::size_t accum_size = first.changeset.size();
+        while (end < uploadable_changesets.size() && can_merge(first, uploadable_changesets[end], accum_size)) {
+            accum_size += uploadable_changesets[end].changeset.size();
+            ++end;
+        }
+
+        if (end - begin == 1) {
+            result.push_back(std::move(uploadable_changesets[begin])); // Throws
+            begin = end;
+            continue;
+        }
+
+        Changeset merged;
+        for (std::size_t i = begin; i < end; ++i) {
+            REALM_ASSERT(!uploadable_changesets[i].snapshot);
+            ChunkedBinaryInputStream in{uploadable_changesets[i].changeset};
+            Changeset changeset;
+            parse_changeset(in, changeset); // Throws
+            merged.append(changeset);       // Throws
+        }
+
+        UploadChangeset& last = uploadable_changesets[end - 1];
+        ChangesetEncoder::Buffer encode_buffer;
+        encode_changeset(merged, encode_buffer); // Throws
+        std::size_t size = encode_buffer.size();
+        UploadChangeset uc;
+        uc.origin_timestamp = last.origin_timestamp;
+        uc.origin_file_ident = last.origin_file_ident;
+        uc.progress = last.progress;
+        uc.buffer = encode_buffer.release().release();
+        uc.changeset = BinaryData{uc.buffer.get(), size};
+        uc.size = size;
+        result.push_back(std::move(uc)); // Throws
+        begin = end;
+    }
+
+    uploadable_changesets = std::move(result);
+    return num_changesets - uploadable_changesets.size();
+}
+
+
 void ClientHistory::integrate_server_changesets(
     const SyncProgress& progress, const std::uint_fast64_t* downloadable_bytes,
     util::Span<const RemoteChangeset> incoming_changesets, VersionInfo& version_info, DownloadBatchState batch_state,
     util::Logger& logger, const TransactionRef& transact,
     util::UniqueFunction<void(const TransactionRef&, util::Span<Changeset>)> run_in_write_tr)
 {
-    REALM_ASSERT(incoming_changesets.size() != 0);
-    REALM_ASSERT(
-        (transact->get_transact_stage() == DB::transact_Writing && batch_state != DownloadBatchState::SteadyState) ||
-        (transact->get_transact_stage() == DB::transact_Reading && batch_state == DownloadBatchState::SteadyState));
+    REALM_TRACE_SCOPE("ClientHistory::integrate_server_changesets");
+    // Parse incoming changesets without holding the write lock unless 'transact' is specified.
+    auto parse_start = std::chrono::steady_clock::now();
+    auto changesets = parse_server_changesets(incoming_changesets); // Throws
+    auto parse_time = std::chrono::steady_clock::now() - parse_start;
+    integrate_server_changesets(progress, downloadable_bytes, incoming_changesets, std::move(changesets),
+                                version_info, batch_state, logger, transact, std::move(run_in_write_tr)); // Throws
+    m_last_integration_metrics.parse_time = std::chrono::duration_cast<std::chrono::microseconds>(parse_time);
+}
+
+
+std::vector<Changeset> ClientHistory::parse_server_changesets(util::Span<const RemoteChangeset> incoming_changesets)
+{
     std::vector<Changeset> changesets;
     changesets.resize(incoming_changesets.size()); // Throws
-
-    // Parse incoming changesets without holding the write lock unless 'transact' is specified.
     try {
         for (std::size_t i = 0; i < incoming_changesets.size(); ++i) {
             const RemoteChangeset& changeset = incoming_changesets[i];
@@ -449,12 +624,36 @@ void ClientHistory::integrate_server_changesets(
                                    util::format("Failed to parse received changeset: %1", e.what()),
                                    ProtocolError::bad_changeset);
     }
+    return changesets;
+}
+
+
+void ClientHistory::integrate_server_changesets(
+    const SyncProgress& progress, const std::uint_fast64_t* downloadable_bytes,
+    util::Span<const RemoteChangeset> incoming_changesets, std::vector<Changeset> changesets,
+    VersionInfo& version_info, DownloadBatchState batch_state, util::Logger& logger, const TransactionRef& transact,
+    util::UniqueFunction<void(const TransactionRef&, util::Span<Changeset>)> run_in_write_tr)
+{
+    REALM_ASSERT(incoming_changesets.size() != 0);
+    REALM_ASSERT_3(changesets.size(), ==, incoming_changesets.size());
+    REALM_ASSERT(
+        (transact->get_transact_stage() == DB::transact_Writing && batch_state != DownloadBatchState::SteadyState) ||
+        (transact->get_transact_stage() == DB::transact_Reading && batch_state == DownloadBatchState::SteadyState));
 
     VersionID new_version{0, 0};
     auto num_changesets = incoming_changesets.size();
     util::Span<Changeset> changesets_to_integrate(changesets);
+    m_last_integration_metrics = {};
     const bool allow_lock_release = batch_state == DownloadBatchState::SteadyState;
 
+    // If the integration fails, the reciprocal transforms written by the
+    // current transaction are rolled back, but the cache would still hold them
+    bool integrated = false;
+    auto clear_cache_on_failure = util::make_scope_exit([&]() noexcept {
+        if (!integrated)
+            m_reciprocal_transform_cache.clear();
+    });
+
     // Ideally, this loop runs only once, but it can run up to `incoming_changesets.size()` times, depending on the
     // number of times the sync client yields the write lock to allow the user to commit their changes.
     // In each iteration, at least one changeset is transformed and committed.
@@ -526,6 +725,7 @@ void ClientHistory::integrate_server_changesets(
         REALM_ASSERT(!m_applying_server_changeset);
         m_applying_server_changeset = true;
         // Commit and continue to write if in bootstrap phase and there are still changes to integrate.
+        auto commit_start = std::chrono::steady_clock::now();
         if (batch_state == DownloadBatchState::MoreToCome ||
             (batch_state == DownloadBatchState::LastInBatch && !changesets_to_integrate.empty())) {
             new_version = transact->commit_and_continue_writing(); // Throws
@@ -533,11 +733,15 @@ void ClientHistory::integrate_server_changesets(
         else {
             new_version = transact->commit_and_continue_as_read(); // Throws
         }
+        m_last_integration_metrics.commit_time +=
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - commit_start);
 
         logger.debug(util::LogCategory::changeset, "Integrated %1 changesets out of %2", changesets_transformed_count,
                      num_changesets);
     }
 
+    integrated = true;
+
     REALM_ASSERT(new_version.version > 0);
     REALM_ASSERT(
         (batch_state == DownloadBatchState::MoreToCome && transact->get_transact_stage() == DB::transact_Writing) ||
@@ -547,6 +751,76 @@ void ClientHistory::integrate_server_changesets(
 }
 
 
+std::uint64_t ClientHistory::integrate_streaming_bootstrap_batch(util::Span<const RemoteChangeset> incoming_changesets,
+                                                                util::Logger& logger, const TransactionRef& transact)
+{
+    REALM_ASSERT(transact->get_transact_stage() == DB::transact_Writing);
+    if (incoming_changesets.empty())
+        return 0;
+
+    auto changesets = parse_server_changesets(incoming_changesets); // Throws
+    ensure_updated(transact->get_version_of_current_transaction().version); // Throws
+    prepare_for_write();                                                     // Throws
+
+    std::uint64_t downloaded_bytes_in_batch = 0;
+    auto changesets_transformed_count =
+        transform_and_apply_server_changesets(changesets, transact, logger, downloaded_bytes_in_batch,
+                                              /* allow_lock_release */ false); // Throws
+    REALM_ASSERT_3(changesets_transformed_count, ==, changesets.size());
+
+    Array& root = m_arrays->root;
+    auto downloaded_bytes = std::uint64_t(root.get_as_ref_or_tagged(s_progress_downloaded_bytes_iip).get_as_int());
+    downloaded_bytes += downloaded_bytes_in_batch;
+    root.set(s_progress_downloaded_bytes_iip, RefOrTagged::make_tagged(downloaded_bytes)); // Throws
+
+    logger.debug(util::LogCategory::changeset, "Integrated %1 changesets from streaming bootstrap (uncommitted)",
+                 changesets_transformed_count);
+    return downloaded_bytes_in_batch;
+}
+
+
+void ClientHistory::commit_streaming_bootstrap(const SyncProgress& progress,
+                                               const std::uint_fast64_t* downloadable_bytes,
+                                               const RemoteChangeset* last_changeset, VersionInfo& version_info,
+                                               const TransactionRef& transact)
+{
+    REALM_ASSERT(transact->get_transact_stage() == DB::transact_Writing);
+    ensure_updated(transact->get_version_of_current_transaction().version); // Throws
+    prepare_for_write();                                                     // Throws
+
+    update_sync_progress(progress, downloadable_bytes, transact); // Throws
+
+    // As in integrate_server_changesets(), the whole transaction gets a single
+    // history entry of remote origin. Without any changesets, the transaction
+    // only updates the progress and produces an empty changeset of local
+    // origin, which is not uploaded.
+    if (last_changeset) {
+        HistoryEntry entry;
+        entry.origin_timestamp = last_changeset->origin_timestamp;
+        entry.origin_file_ident = last_changeset->origin_file_ident;
+        entry.remote_version = last_changeset->remote_version;
+        add_sync_history_entry(entry); // Throws
+
+        REALM_ASSERT(!m_applying_server_changeset);
+        m_applying_server_changeset = true;
+    }
+    VersionID new_version = transact->commit_and_continue_as_read(); // Throws
+    version_info.realm_version = new_version.version;
+    version_info.sync_version = {new_version.version, 0};
+}
+
+
+void ClientHistory::abort_streaming_bootstrap(const TransactionRef& transact)
+{
+    if (transact->get_transact_stage() == DB::transact_Writing)
+        transact->rollback(); // Throws
+
+    // The reciprocal transforms written by the rolled back transaction may
+    // still be held by the cache
+    m_reciprocal_transform_cache.clear();
+}
+
+
 size_t ClientHistory::transform_and_apply_server_changesets(util::Span<Changeset> changesets_to_integrate,
                                                             TransactionRef transact, util::Logger& logger,
                                                             std::uint64_t& downloaded_bytes, bool allow_lock_release)
@@ -597,8 +871,23 @@ size_t ClientHistory::transform_and_apply_server_changesets(util::Span<Changeset
                      transact->get_commit_size() >= commit_byte_size_limit);
         };
         sync::Transformer transformer;
+        transformer.set_max_threads(m_replication.get_transform_threads());
+        transformer.set_reciprocal_transform_cache(&m_reciprocal_transform_cache);
         auto changesets_transformed_count = transformer.transform_remote_changesets(
             *this, sync_file_id, local_version, changesets_to_integrate, changeset_applier, logger); // Throws
+        const auto& stats = transformer.get_stats();
+        using std::chrono::duration_cast, std::chrono::microseconds;
+        m_last_integration_metrics.transform_time += duration_cast<microseconds>(stats.transform_time);
+        m_last_integration_metrics.apply_time += duration_cast<microseconds>(stats.apply_time);
+        m_last_integration_metrics.reciprocal_changesets += stats.reciprocal_changesets;
+        m_last_integration_metrics.modified_reciprocal_changesets += stats.modified_reciprocal_changesets;
+        if (m_reciprocal_transform_cache.get_budget() > 0) {
+            auto metrics = m_reciprocal_transform_cache.get_metrics();
+            logger.trace(util::LogCategory::changeset,
+                         "Reciprocal transform cache: %1 hits, %2 misses, %3 evictions, %4 changesets using %5 bytes",
+                         metrics.hits, metrics.misses, metrics.evictions, metrics.num_changesets,
+                         metrics.memory_used);
+        }
         return changesets_transformed_count;
     }
     catch (const BadChangesetError& e) {
@@ -640,6 +929,63 @@ void ClientHistory::get_upload_download_bytes(DB* db, std::uint_fast64_t& downlo
     }
 }
 
+auto ClientHistory::get_maintenance_metrics() const noexcept -> MaintenanceMetrics
+{
+    MaintenanceMetrics metrics;
+    metrics.entries_trimmed_inline = m_entries_trimmed_inline;
+    metrics.entries_trimmed_in_background = m_entries_trimmed_in_background;
+    metrics.slices = m_maintenance_slices;
+    metrics.slice_time_us = m_maintenance_slice_time_us;
+    metrics.entries_pending = m_ct_entries_pending + m_sync_entries_pending;
+    return metrics;
+}
+
+
+bool ClientHistory::run_maintenance_slice(std::chrono::milliseconds budget)
+{
+    // Never wait for the write lock, the backlog will still be there later
+    TransactionRef wt = m_db->start_write(/* nonblocking */ true); // Throws
+    if (!wt)
+        return true;
+
+    auto start_time = std::chrono::steady_clock::now();
+    ensure_updated(wt->get_version()); // Throws
+    if (!m_arrays)
+        return false;
+
+    std::size_t num_trimmed = 0;
+    std::size_t num_ct_pending, num_sync_pending;
+    for (;;) {
+        num_ct_pending = num_trimmable_ct_history_entries();
+        num_sync_pending = num_trimmable_sync_history_entries();
+        if (num_ct_pending + num_sync_pending == 0 || std::chrono::steady_clock::now() - start_time >= budget)
+            break;
+        std::size_t ct_n = std::min(num_ct_pending, s_maintenance_chunk_size);
+        std::size_t sync_n = std::min(num_sync_pending, s_maintenance_chunk_size);
+        do_trim_ct_history(ct_n);     // Throws
+        do_trim_sync_history(sync_n); // Throws
+        num_trimmed += ct_n + sync_n;
+    }
+
+    if (num_trimmed == 0) {
+        wt->rollback();
+    }
+    else {
+        // Note: This transaction produces an empty changeset. Empty changesets
+        // are not uploaded to the server.
+        wt->commit(); // Throws
+        auto duration = std::chrono::steady_clock::now() - start_time;
+        m_entries_trimmed_in_background += num_trimmed;
+        m_maintenance_slices += 1;
+        m_maintenance_slice_time_us +=
+            std::uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    }
+    m_ct_entries_pending = num_ct_pending;
+    m_sync_entries_pending = num_sync_pending;
+    return num_ct_pending + num_sync_pending > 0;
+}
+
+
 auto ClientHistory::find_history_entry(version_type begin_version, version_type end_version,
                                        HistoryEntry& entry) const noexcept -> version_type
 {
@@ -664,6 +1010,12 @@ ChunkedBinaryData ClientHistory::get_reciprocal_transform(version_type version,
 }
 
 
+util::Span<const char> ClientHistory::get_changeset_dictionary() const
+{
+    return m_arrays ? m_arrays->get_changeset_dictionary() : util::Span<const char>{};
+}
+
+
 void ClientHistory::set_reciprocal_transform(version_type version, BinaryData data)
 {
     REALM_ASSERT(version > m_sync_history_base_version);
@@ -676,7 +1028,7 @@ void ClientHistory::set_reciprocal_transform(version_type version, BinaryData da
         return;
     }
 
-    auto compressed = util::compression::allocate_and_compress_nonportable(data);
+    auto compressed = util::compression::allocate_and_compress_nonportable(data, get_changeset_dictionary());
     m_arrays->reciprocal_transforms.set(index, BinaryData{compressed.data(), compressed.size()}); // Throws
 }
 
@@ -819,7 +1171,9 @@ void ClientHistory::add_sync_history_entry(const HistoryEntry& entry)
 
     if (!entry.changeset.is_null()) {
         auto changeset = entry.changeset.get_first_chunk();
-        auto compressed = util::compression::allocate_and_compress_nonportable(changeset);
+        sample_for_changeset_dictionary(changeset); // Throws
+        auto compressed =
+            util::compression::allocate_and_compress_nonportable(changeset, m_arrays->get_changeset_dictionary());
         m_arrays->changesets.add(BinaryData{compressed.data(), compressed.size()}); // Throws
     }
     else {
@@ -833,6 +1187,26 @@ void ClientHistory::add_sync_history_entry(const HistoryEntry& entry)
 }
 
 
+void ClientHistory::sample_for_changeset_dictionary(BinaryData changeset)
+{
+    if (!m_replication.get_history_compression_dictionary() || m_arrays->changeset_dictionary.size() != 0)
+        return;
+    if (changeset.size() != 0) {
+        m_dictionary_samples.emplace_back(changeset.data(), changeset.size()); // Throws
+        m_dictionary_sample_bytes += changeset.size();
+    }
+    if (m_dictionary_samples.size() < s_dictionary_training_samples &&
+        m_dictionary_sample_bytes < s_dictionary_training_bytes)
+        return;
+
+    std::vector<util::Span<const char>> samples(m_dictionary_samples.begin(), m_dictionary_samples.end());
+    auto dictionary = util::compression::train_dictionary(samples, s_max_dictionary_size); // Throws
+    m_arrays->changeset_dictionary.add(BinaryData{dictionary.data(), dictionary.size()});  // Throws
+    m_dictionary_samples = {};
+    m_dictionary_sample_bytes = 0;
+}
+
+
 void ClientHistory::update_sync_progress(const SyncProgress& progress, const std::uint_fast64_t* downloadable_bytes,
                                          TransactionRef)
 {
@@ -928,6 +1302,30 @@ void ClientHistory::trim_ct_history()
     // history empty.
     REALM_ASSERT(n < ct_history_size());
 
+    // A large backlog, such as after a long lived read transaction has ended,
+    // is left for run_maintenance_slice()
+    std::size_t num_trimmed = std::min(n, s_max_entries_trimmed_inline);
+    do_trim_ct_history(num_trimmed); // Throws
+    m_entries_trimmed_inline += num_trimmed;
+    m_ct_entries_pending = n - num_trimmed;
+}
+
+
+std::size_t ClientHistory::num_trimmable_ct_history_entries() const
+{
+    version_type begin = m_ct_history_base_version;
+    version_type end = m_version_of_oldest_bound_snapshot;
+    if (end <= begin || ct_history_size() == 0)
+        return 0;
+    // Unlike in trim_ct_history(), the oldest bound snapshot may be the
+    // latest one, so one entry is kept to not leave the history empty.
+    return std::min(std::size_t(end - begin), ct_history_size() - 1);
+}
+
+
+void ClientHistory::do_trim_ct_history(std::size_t n)
+{
+    REALM_ASSERT(n < ct_history_size() || n == 0);
     for (std::size_t i = 0; i < n; ++i) {
         std::size_t j = (n - 1) - i;
         m_arrays->ct_history.erase(j);
@@ -961,6 +1359,16 @@ void ClientHistory::trim_ct_history()
 // Note that C corresponds to the earliest possible beginning of the merge
 // window for the next incoming changeset from the server.
 void ClientHistory::trim_sync_history()
+{
+    std::size_t n = num_trimmable_sync_history_entries();
+    std::size_t num_trimmed = std::min(n, s_max_entries_trimmed_inline);
+    do_trim_sync_history(num_trimmed); // Throws
+    m_entries_trimmed_inline += num_trimmed;
+    m_sync_entries_pending = n - num_trimmed;
+}
+
+
+std::size_t ClientHistory::num_trimmable_sync_history_entries() const
 {
     version_type begin = m_sync_history_base_version;
     version_type end = std::max(m_progress_download.last_integrated_client_version, s_initial_version + 0);
@@ -1005,8 +1413,7 @@ void ClientHistory::trim_sync_history()
         end += i;
     }
 
-    std::size_t n = std::size_t(end - begin);
-    do_trim_sync_history(n); // Throws
+    return std::size_t(end - begin);
 }
 
 bool ClientHistory::no_pending_local_changes(version_type version) const
@@ -1087,6 +1494,7 @@ void ClientHistory::fix_up_client_file_ident_in_stored_changesets(Transaction& g
 
     util::compression::CompressMemoryArena arena;
     util::AppendBuffer<char> compressed;
+    auto dictionary = m_arrays->get_changeset_dictionary();
 
     // Fix up changesets.
     Array& root = m_arrays->root;
@@ -1100,7 +1508,7 @@ void ClientHistory::fix_up_client_file_ident_in_stored_changesets(Transaction& g
         ChunkedBinaryData changeset{m_arrays->changesets, i};
         ChunkedBinaryInputStream is{changeset};
         size_t decompressed_size;
-        auto decompressed = util::compression::decompress_nonportable_input_stream(is, decompressed_size);
+        auto decompressed = util::compression::decompress_nonportable_input_stream(is, decompressed_size, dictionary);
         if (!decompressed)
             continue;
         Changeset log;
@@ -1146,7 +1554,7 @@ void ClientHistory::fix_up_client_file_ident_in_stored_changesets(Transaction& g
         if (did_modify) {
             ChangesetEncoder::Buffer modified;
             encode_changeset(log, modified);
-            util::compression::allocate_and_compress_nonportable(arena, modified, compressed);
+            util::compression::allocate_and_compress_nonportable(arena, modified, compressed, dictionary);
             m_arrays->changesets.set(i, BinaryData{compressed.data(), compressed.size()}); // Throws
 
             uploadable_bytes += modified.size() - decompressed_size;
@@ -1335,6 +1743,7 @@ ClientHistory::Arrays::Arrays(Allocator& alloc) noexcept
     , remote_versions(alloc)
     , origin_file_idents(alloc)
     , origin_timestamps(alloc)
+    , changeset_dictionary(alloc)
 {
 }
 
@@ -1361,6 +1770,8 @@ ClientHistory::Arrays::Arrays(DB& db, Group& group)
     origin_file_idents.create(); // Throws
     origin_timestamps.set_parent(&root, s_origin_timestamps_iip);
     origin_timestamps.create(); // Throws
+    changeset_dictionary.set_parent(&root, s_changeset_dictionary_iip);
+    changeset_dictionary.create(); // Throws
 
     { // `schema_versions` table
         Array schema_versions{alloc};
@@ -1408,6 +1819,7 @@ ClientHistory::Arrays::Arrays(Allocator& alloc, Group* parent, ref_type ref)
     remote_versions.set_parent(&root, s_remote_versions_iip);
     origin_file_idents.set_parent(&root, s_origin_file_idents_iip);
     origin_timestamps.set_parent(&root, s_origin_timestamps_iip);
+    changeset_dictionary.set_parent(&root, s_changeset_dictionary_iip);
 
     init_from_ref(ref); // Throws
 
@@ -1436,6 +1848,18 @@ void ClientHistory::Arrays::Arrays::init_from_ref(ref_type ref)
     remote_versions.init_from_parent();    // Throws
     origin_file_idents.init_from_parent(); // Throws
     origin_timestamps.init_from_parent();  // Throws
+    {
+        ref_type ref_2 = root.get_as_ref(s_changeset_dictionary_iip);
+        changeset_dictionary.init_from_ref(ref_2); // Throws
+    }
+}
+
+util::Span<const char> ClientHistory::Arrays::get_changeset_dictionary() const
+{
+    if (changeset_dictionary.size() == 0)
+        return {};
+    BinaryData dictionary = changeset_dictionary.get(0);
+    return {dictionary.data(), dictionary.size()};
 }
 
 void ClientHistory::Arrays::verify() const
@@ -1448,7 +1872,9 @@ void ClientHistory::Arrays::verify() const
     remote_versions.verify();
     origin_file_idents.verify();
     origin_timestamps.verify();
+    changeset_dictionary.verify();
     REALM_ASSERT(root.size() == s_root_size);
+    REALM_ASSERT(changeset_dictionary.size() <= 1);
     REALM_ASSERT(reciprocal_transforms.size() == changesets.size());
     REALM_ASSERT(remote_versions.size() == changesets.size());
     REALM_ASSERT(origin_file_idents.size() == changesets.size());
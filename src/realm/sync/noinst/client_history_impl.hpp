@@ -23,8 +23,12 @@
 #include <realm/sync/client_base.hpp>
 #include <realm/sync/history.hpp>
 #include <realm/util/functional.hpp>
+#include <realm/util/input_stream.hpp>
 #include <realm/util/optional.hpp>
 
+#include <atomic>
+#include <chrono>
+
 namespace realm::_impl::client_reset {
 struct RecoveredChange;
 }
@@ -65,10 +69,13 @@ class ClientReplication;
 //       Cooked history was removed, except to verify that there is no cooked history.
 //
 //  12   History entries are compressed.
+//
+//  13   History entries may be compressed with a preset dictionary stored in
+//       the history compartment.
 
 constexpr int get_client_history_schema_version() noexcept
 {
-    return 12;
+    return 13;
 }
 
 class IntegrationException : public Exception {
@@ -99,6 +106,19 @@ public:
         UploadCursor progress;
         ChunkedBinaryData changeset;
         std::unique_ptr<char[]> buffer;
+        // The size of the uncompressed changeset
+        std::size_t size = 0;
+        // If the changeset was left compressed in the history, `changeset` is
+        // null, and these are the chunks of the compressed changeset and the
+        // dictionary it may be compressed with, which point into the file and
+        // stay valid for as long as `snapshot` is held
+        std::vector<BinaryData> compressed_chunks;
+        util::Span<const char> dictionary;
+        TransactionRef snapshot;
+
+        /// Returns a stream producing the uncompressed changeset, decompressing
+        /// it on the fly if it was left in the history.
+        std::unique_ptr<util::InputStream> open() const;
     };
 
     /// set_history_adjustments() is used by client reset to adjust the
@@ -112,6 +132,9 @@ public:
     struct LocalChange {
         version_type version;
         ChunkedBinaryData changeset;
+        // The dictionary the changeset may be compressed with, which points
+        // into the file like the changeset
+        util::Span<const char> dictionary;
     };
     /// get_local_changes returns a list of changes which have not been uploaded yet
     /// 'current_version' is the version that the history should be updated to.
@@ -209,9 +232,28 @@ public:
     ///
     /// For changesets of local origin, UploadChangeset::origin_file_ident will
     /// be zero.
+    ///
+    /// If \a decompress is false, the changesets are not copied out of the
+    /// history, and must be read through UploadChangeset::open(). They cannot
+    /// be coalesced.
     void find_uploadable_changesets(UploadCursor& upload_progress, version_type end_version,
                                     std::vector<UploadChangeset>& uploadable_changesets,
-                                    version_type& locked_server_version) const;
+                                    version_type& locked_server_version, bool decompress = true) const;
+
+    /// Merge runs of consecutive changesets found by
+    /// find_uploadable_changesets() into single changesets, to
+    /// reduce the protocol overhead and the work of the server when the
+    /// application makes many small commits.
+    ///
+    /// A run only contains changesets based on the same server version, whose
+    /// origin timestamps are at most \a time_window milliseconds apart, and
+    /// whose combined size is at most \a size_limit. The merged changeset
+    /// takes the upload cursor and origin timestamp of the last changeset in
+    /// the run, so the upload progress is the same as without merging.
+    ///
+    /// Returns the number of changesets that were removed.
+    static std::size_t coalesce_uploadable_changesets(std::vector<UploadChangeset>& uploadable_changesets,
+                                                      timestamp_type time_window, std::size_t size_limit);
 
     /// \brief Integrate a sequence of changesets received from the server using
     /// a single Realm transaction.
@@ -252,12 +294,109 @@ public:
         util::Logger&, const TransactionRef& transact,
         util::UniqueFunction<void(const TransactionRef&, util::Span<Changeset>)> run_in_write_tr = nullptr);
 
+    /// Same as above, but with the changesets already parsed by
+    /// parse_server_changesets(). Parsing does not touch the Realm, so it can
+    /// be done on another thread ahead of the integration.
+    void integrate_server_changesets(
+        const SyncProgress& progress, const std::uint_fast64_t* downloadable_bytes,
+        util::Span<const RemoteChangeset> changesets, std::vector<Changeset> parsed_changesets,
+        VersionInfo& new_version, DownloadBatchState download_type, util::Logger&, const TransactionRef& transact,
+        util::UniqueFunction<void(const TransactionRef&, util::Span<Changeset>)> run_in_write_tr = nullptr);
+
+    /// Parse changesets received from the server. Throws IntegrationException
+    /// if any of them are malformed.
+    static std::vector<Changeset> parse_server_changesets(util::Span<const RemoteChangeset> changesets);
+
+    /// \brief Integrate one batch of a streaming FLX bootstrap without
+    /// committing it.
+    ///
+    /// The changesets are transformed and applied as by
+    /// integrate_server_changesets(), but \a transact is left in the writing
+    /// state, so none of the bootstrap is visible to other transactions until
+    /// commit_streaming_bootstrap() is called after the last batch. Nothing is
+    /// staged in the PendingBootstrapStore, so each changeset is written only
+    /// once.
+    ///
+    /// Returns the number of downloaded bytes added by the batch.
+    std::uint64_t integrate_streaming_bootstrap_batch(util::Span<const RemoteChangeset> changesets, util::Logger&,
+                                                      const TransactionRef& transact);
+
+    /// \brief Make a streaming FLX bootstrap visible.
+    ///
+    /// Persists \a progress and a history entry for the bootstrap, and commits
+    /// \a transact, leaving it in the reading state. \a last_changeset is the
+    /// last changeset integrated by integrate_streaming_bootstrap_batch(), or
+    /// null if the bootstrap contained no changesets.
+    void commit_streaming_bootstrap(const SyncProgress& progress, const std::uint_fast64_t* downloadable_bytes,
+                                    const RemoteChangeset* last_changeset, VersionInfo& new_version,
+                                    const TransactionRef& transact);
+
+    /// \brief Discard a streaming FLX bootstrap that was not completed.
+    ///
+    /// Rolls back \a transact. Since the download progress is only advanced by
+    /// commit_streaming_bootstrap(), the Realm is left at the last durable
+    /// resume point, from which the server will resend the bootstrap.
+    void abort_streaming_bootstrap(const TransactionRef& transact);
+
+    /// The cache of parsed reciprocal transforms shared by the transform
+    /// rounds of integrate_server_changesets(). It is disabled until it is
+    /// given a budget.
+    ReciprocalTransformCache& get_reciprocal_transform_cache() noexcept
+    {
+        return m_reciprocal_transform_cache;
+    }
+
     static void get_upload_download_bytes(DB*, std::uint_fast64_t&, std::uint_fast64_t&, std::uint_fast64_t&,
                                           std::uint_fast64_t&, std::uint_fast64_t&);
 
+    /// Statistics about the trimming of the history.
+    struct MaintenanceMetrics {
+        /// History entries trimmed by ordinary write transactions.
+        std::uint64_t entries_trimmed_inline = 0;
+        /// History entries trimmed by run_maintenance_slice().
+        std::uint64_t entries_trimmed_in_background = 0;
+        /// Calls of run_maintenance_slice() that trimmed anything, and the
+        /// time spent in them.
+        std::uint64_t slices = 0;
+        std::uint64_t slice_time_us = 0;
+        /// Trimmable history entries that were left for later by the last
+        /// trimming of each history.
+        std::uint64_t entries_pending = 0;
+    };
+    MaintenanceMetrics get_maintenance_metrics() const noexcept;
+
+    /// Where the time of an integration of downloaded changesets went.
+    struct IntegrationMetrics {
+        std::chrono::microseconds parse_time{0};
+        std::chrono::microseconds transform_time{0};
+        std::chrono::microseconds apply_time{0};
+        std::chrono::microseconds commit_time{0};
+        /// See Transformer::Stats.
+        std::size_t reciprocal_changesets = 0;
+        std::size_t modified_reciprocal_changesets = 0;
+    };
+    /// The metrics of the last call to integrate_server_changesets(). Must be
+    /// called on the thread that made that call.
+    const IntegrationMetrics& get_last_integration_metrics() const noexcept
+    {
+        return m_last_integration_metrics;
+    }
+
+    /// \brief Trim the history in a write transaction of its own.
+    ///
+    /// Other write transactions trim at most s_max_entries_trimmed_inline
+    /// entries of each history, so that a small commit does not pay for
+    /// trimming a large backlog. This function trims the rest in chunks until
+    /// \a budget has been used up. It does nothing if another write
+    /// transaction is in progress.
+    ///
+    /// Returns true if trimmable entries remain.
+    bool run_maintenance_slice(std::chrono::milliseconds budget);
+
     // Overriding member functions in realm::TransformHistory
     version_type find_history_entry(version_type, version_type, HistoryEntry&) const noexcept override;
     ChunkedBinaryData get_reciprocal_transform(version_type, bool&) const override;
+    util::Span<const char> get_changeset_dictionary() const override;
     void set_reciprocal_transform(version_type, BinaryData) override;
 
 public: // Stuff in this section is only used by CLI tools.
@@ -278,6 +417,37 @@ private:
     ClientReplication& m_replication;
     DB* m_db = nullptr;
 
+    ReciprocalTransformCache m_reciprocal_transform_cache;
+    IntegrationMetrics m_last_integration_metrics;
+
+    // The maximum number of entries of each history that are trimmed by a
+    // write transaction other than those of run_maintenance_slice().
+    static constexpr std::size_t s_max_entries_trimmed_inline = 64;
+    // The number of entries of each history trimmed at a time by
+    // run_maintenance_slice() between checks of its time budget.
+    static constexpr std::size_t s_maintenance_chunk_size = 256;
+
+    // A changeset dictionary is trained from the first changesets added to
+    // the history once there are this many of them, or this many bytes of
+    // them, and is at most this large.
+    static constexpr std::size_t s_dictionary_training_samples = 128;
+    static constexpr std::size_t s_dictionary_training_bytes = 256 * 1024;
+    static constexpr std::size_t s_max_dictionary_size = 16 * 1024;
+
+    // The changesets added since the file was opened, until a changeset
+    // dictionary has been trained from them. Guarded by the write lock.
+    std::vector<std::string> m_dictionary_samples;
+    std::size_t m_dictionary_sample_bytes = 0;
+
+    // Trimming happens under the write lock, but the metrics may be read from
+    // any thread.
+    std::atomic<std::uint64_t> m_entries_trimmed_inline{0};
+    std::atomic<std::uint64_t> m_entries_trimmed_in_background{0};
+    std::atomic<std::uint64_t> m_maintenance_slices{0};
+    std::atomic<std::uint64_t> m_maintenance_slice_time_us{0};
+    std::atomic<std::uint64_t> m_ct_entries_pending{0};
+    std::atomic<std::uint64_t> m_sync_entries_pending{0};
+
     /// The version on which the first changeset in the continuous transactions
     /// history is based, or if that history is empty, the version associated
     /// with currently bound snapshot. In general, `m_ct_history_base_version +
@@ -321,6 +491,13 @@ private:
         IntegerBpTree origin_file_idents;
         IntegerBpTree origin_timestamps;
 
+        /// Empty until a dictionary has been trained, and then holds the
+        /// dictionary that history entries are compressed with, which is
+        /// empty if training failed to find anything worth putting in it.
+        BinaryColumn changeset_dictionary;
+
+        util::Span<const char> get_changeset_dictionary() const;
+
     private:
         Arrays(Allocator&) noexcept;
     };
@@ -328,7 +505,7 @@ private:
     // clang-format off
 
     // Sizes of fixed-size arrays
-    static constexpr int s_root_size            = 21;
+    static constexpr int s_root_size            = 22;
     static constexpr int s_schema_versions_size =  4;
 
     // Slots in root array of history compartment
@@ -353,6 +530,7 @@ private:
     static constexpr int s_object_id_history_state_iip = 18;            // ref
     static constexpr int s_cooked_history_iip = 19;                     // ref (removed)
     static constexpr int s_schema_versions_iip = 20;                    // table ref
+    static constexpr int s_changeset_dictionary_iip = 21;               // column ref
 
     // Slots in root array of `schema_versions` table
     static constexpr int s_sv_schema_versions_iip = 0;   // integer
@@ -411,12 +589,17 @@ private:
     void update_sync_progress(const SyncProgress&, const std::uint_fast64_t* downloadable_bytes, TransactionRef);
     void trim_ct_history();
     void trim_sync_history();
+    std::size_t num_trimmable_ct_history_entries() const;
+    std::size_t num_trimmable_sync_history_entries() const;
+    void do_trim_ct_history(std::size_t n);
     void do_trim_sync_history(std::size_t n);
     void clamp_sync_version_range(version_type& begin, version_type& end) const noexcept;
     void fix_up_client_file_ident_in_stored_changesets(Transaction&, file_ident_type);
     void record_current_schema_version();
     static void record_current_schema_version(Array& schema_versions, version_type snapshot_version);
     void compress_stored_changesets();
+    void add_changeset_dictionary_column();
+    void sample_for_changeset_dictionary(BinaryData changeset);
 
     size_t sync_history_size() const noexcept
     {
@@ -490,12 +673,39 @@ public:
         return m_apply_server_changes;
     }
 
+    // The number of threads to transform incoming changesets on (see
+    // Transformer::set_max_threads()).
+    void set_transform_threads(size_t num_threads) noexcept
+    {
+        m_transform_threads = num_threads;
+    }
+    size_t get_transform_threads() const noexcept
+    {
+        return m_transform_threads;
+    }
+
+    // Train a dictionary from the changesets added to the history, once there
+    // are enough of them, and compress the history entries with it. Files
+    // without a dictionary get one the next time enough changesets have been
+    // added after this is enabled. Once a file has a dictionary, it is used
+    // whether or not this is enabled.
+    void set_history_compression_dictionary(bool enable) noexcept
+    {
+        m_history_compression_dictionary = enable;
+    }
+    bool get_history_compression_dictionary() const noexcept
+    {
+        return m_history_compression_dictionary;
+    }
+
 protected:
     util::UniqueFunction<WriteValidator> make_write_validator(Transaction& tr) override;
 
 private:
     ClientHistory m_history;
     const bool m_apply_server_changes;
+    size_t m_transform_threads = 1;
+    bool m_history_compression_dictionary = false;
     util::UniqueFunction<WriteValidatorFactory> m_write_validator_factory;
 };
 
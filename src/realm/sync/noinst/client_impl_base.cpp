@@ -18,11 +18,13 @@
 #include <realm/util/safe_int_ops.hpp>
 #include <realm/util/scope_exit.hpp>
 #include <realm/util/to_string.hpp>
+#include <realm/util/trace.hpp>
 #include <realm/util/uri.hpp>
 #include <realm/version.hpp>
 
 #include <realm/sync/network/websocket.hpp> // Only for websocket::Error TODO remove
 
+#include <algorithm>
 #include <system_error>
 #include <sstream>
 
@@ -151,8 +153,17 @@ ClientImpl::ClientImpl(ClientConfig config)
     , m_dry_run{config.dry_run}
     , m_enable_default_port_hack{config.enable_default_port_hack}
     , m_disable_upload_compaction{config.disable_upload_compaction}
+    , m_upload_coalescing_window{config.upload_coalescing_window}
+    , m_upload_coalescing_max_size{config.upload_coalescing_max_size}
     , m_fix_up_object_ids{config.fix_up_object_ids}
+    , m_reciprocal_transform_cache_budget{config.reciprocal_transform_cache_budget}
+    , m_history_maintenance_slice{config.history_maintenance_slice}
+    , m_max_batched_messages{std::max(config.max_batched_messages, size_t(1))}
+    , m_integration_workers{config.integration_worker_threads > 0
+                                ? std::make_unique<IntegrationWorkerPool>(config.integration_worker_threads)
+                                : nullptr}
     , m_roundtrip_time_handler{std::move(config.roundtrip_time_handler)}
+    , m_session_telemetry_handler{std::move(config.session_telemetry_handler)}
     , m_socket_provider{std::move(config.socket_provider)}
     , m_client_protocol{} // Throws
     , m_one_connection_per_session{config.one_connection_per_session}
@@ -188,6 +199,10 @@ ClientImpl::ClientImpl(ClientConfig config)
                  config.disable_upload_compaction); // Throws
     logger.debug("Config param: disable_sync_to_disk = %1",
                  config.disable_sync_to_disk); // Throws
+    logger.debug("Config param: integration_worker_threads = %1",
+                 config.integration_worker_threads); // Throws
+    logger.debug("Config param: max_batched_messages = %1",
+                 m_max_batched_messages); // Throws
     logger.debug(
         "Config param: reconnect backoff info: max_delay: %1 ms, initial_delay: %2 ms, multiplier: %3, jitter: 1/%4",
         m_reconnect_backoff_info.max_resumption_delay_interval.count(),
@@ -974,7 +989,18 @@ void Connection::initiate_write_message(const OutputBuffer& out, Session* sess)
     if (m_websocket_error_received)
         return;
 
-    m_websocket->async_write_binary(out.as_span(), [this, sentinel = m_websocket_sentinel](Status status) {
+    // The message is written by initiate_write_batch() once
+    // send_next_message() has collected as many messages as it can.
+    REALM_ASSERT(&out == &m_output_buffers[m_sending_sessions.size()]);
+    m_sending_sessions.push_back(sess); // Throws
+}
+
+
+void Connection::initiate_write_batch()
+{
+    REALM_ASSERT(!m_sending_sessions.empty());
+    REALM_ASSERT(!m_sending);
+    auto handler = [this, sentinel = m_websocket_sentinel](Status status) {
         if (sentinel->destroyed) {
             return;
         }
@@ -986,19 +1012,31 @@ void Connection::initiate_write_message(const OutputBuffer& out, Session* sess)
             return;
         }
         handle_write_message(); // Throws
-    });                         // Throws
-    m_sending_session = sess;
+    };
+    std::size_t num_messages = m_sending_sessions.size();
+    if (num_messages == 1) {
+        m_websocket->async_write_binary(m_output_buffers[0].as_span(), std::move(handler)); // Throws
+    }
+    else {
+        std::vector<util::Span<const char>> messages;
+        messages.reserve(num_messages); // Throws
+        for (std::size_t i = 0; i < num_messages; ++i)
+            messages.push_back(m_output_buffers[i].as_span());
+        m_websocket->async_write_binary_batch(std::move(messages), std::move(handler)); // Throws
+    }
     m_sending = true;
 }
 
 
 void Connection::handle_write_message()
 {
-    m_sending_session->message_sent(); // Throws
-    if (m_sending_session->m_state == Session::Deactivated) {
-        finish_session_deactivation(m_sending_session);
+    for (Session* sess : m_sending_sessions) {
+        sess->message_sent(); // Throws
+        if (sess->m_state == Session::Deactivated) {
+            finish_session_deactivation(sess);
+        }
     }
-    m_sending_session = nullptr;
+    m_sending_sessions.clear();
     m_sending = false;
     send_next_message(); // Throws
 }
@@ -1007,7 +1045,7 @@ void Connection::handle_write_message()
 void Connection::send_next_message()
 {
     REALM_ASSERT_EX(m_state == ConnectionState::connected, m_state);
-    REALM_ASSERT(!m_sending_session);
+    REALM_ASSERT(m_sending_sessions.empty());
     REALM_ASSERT(!m_sending);
     if (m_send_ping) {
         send_ping(); // Throws
@@ -1019,7 +1057,13 @@ void Connection::send_next_message()
         // provided by Websocket::async_write_text(), and friends.
         REALM_ASSERT_EX(m_state == ConnectionState::connected, m_state);
 
-        Session& sess = *m_sessions_enlisted_to_send.front();
+        // A session may have only one message in flight, so a session that
+        // has already contributed to this batch must wait for the next one.
+        Session* next = m_sessions_enlisted_to_send.front();
+        if (std::find(m_sending_sessions.begin(), m_sending_sessions.end(), next) != m_sending_sessions.end())
+            break;
+
+        Session& sess = *next;
         m_sessions_enlisted_to_send.pop_front();
         sess.send_message(); // Throws
 
@@ -1028,10 +1072,13 @@ void Connection::send_next_message()
         }
 
         // An enlisted session may choose to not send a message. In that case,
-        // we should pass the opportunity to the next enlisted session.
-        if (m_sending)
+        // we should pass the opportunity to the next enlisted session. Otherwise
+        // keep collecting messages until the batch is full.
+        if (m_sending_sessions.size() == m_client.m_max_batched_messages)
             break;
     }
+    if (!m_sending_sessions.empty())
+        initiate_write_batch(); // Throws
 }
 
 
@@ -1079,7 +1126,7 @@ void Connection::initiate_write_ping(const OutputBuffer& out)
 void Connection::handle_write_ping()
 {
     REALM_ASSERT(m_sending);
-    REALM_ASSERT(!m_sending_session);
+    REALM_ASSERT(m_sending_sessions.empty());
     m_sending = false;
     send_next_message(); // Throws
 }
@@ -1214,7 +1261,7 @@ void Connection::disconnect(const SessionErrorInfo& info)
     m_websocket_sentinel.reset();
     m_websocket.reset();
     m_input_body_buffer.reset();
-    m_sending_session = nullptr;
+    m_sending_sessions.clear();
     m_sessions_enlisted_to_send.clear();
     m_sending = false;
 
@@ -1302,6 +1349,9 @@ void Connection::receive_error_message(const ProtocolErrorInfo& info, session_id
         if (REALM_UNLIKELY(!sess)) {
             return;
         }
+
+        sess->wait_for_background_integration(); // Throws
+
         if (auto status = sess->receive_error_message(info); !status.is_ok()) {
             close_due_to_protocol_error(std::move(status)); // Throws
             return;
@@ -1355,6 +1405,8 @@ void Connection::receive_query_error_message(int raw_error_code, std::string_vie
         return;
     }
 
+    sess->wait_for_background_integration(); // Throws
+
     if (auto status = sess->receive_query_error_message(raw_error_code, message, query_version); !status.is_ok()) {
         close_due_to_protocol_error(std::move(status));
     }
@@ -1368,6 +1420,8 @@ void Connection::receive_ident_message(session_ident_type session_ident, SaltedF
         return;
     }
 
+    sess->wait_for_background_integration(); // Throws
+
     if (auto status = sess->receive_ident_message(client_file_ident); !status.is_ok())
         close_due_to_protocol_error(std::move(status)); // Throws
 }
@@ -1379,6 +1433,8 @@ void Connection::receive_download_message(session_ident_type session_ident, cons
         return;
     }
 
+    sess->wait_for_background_integration(); // Throws
+
     if (auto status = sess->receive_download_message(message); !status.is_ok()) {
         close_due_to_protocol_error(std::move(status));
     }
@@ -1391,6 +1447,8 @@ void Connection::receive_mark_message(session_ident_type session_ident, request_
         return;
     }
 
+    sess->wait_for_background_integration(); // Throws
+
     if (auto status = sess->receive_mark_message(request_ident); !status.is_ok())
         close_due_to_protocol_error(std::move(status)); // Throws
 }
@@ -1403,6 +1461,8 @@ void Connection::receive_unbound_message(session_ident_type session_ident)
         return;
     }
 
+    sess->wait_for_background_integration(); // Throws
+
     if (auto status = sess->receive_unbound_message(); !status.is_ok()) {
         close_due_to_protocol_error(std::move(status)); // Throws
         return;
@@ -1422,6 +1482,8 @@ void Connection::receive_test_command_response(session_ident_type session_ident,
         return;
     }
 
+    sess->wait_for_background_integration(); // Throws
+
     if (auto status = sess->receive_test_command_response(request_ident, body); !status.is_ok()) {
         close_due_to_protocol_error(std::move(status));
     }
@@ -1544,6 +1606,120 @@ void Session::gather_pending_compensating_writes(util::Span<Changeset> changeset
 }
 
 
+void Session::gather_pending_compensating_writes(version_type last_server_version,
+                                                 std::vector<ProtocolErrorInfo>* out)
+{
+    while (!m_pending_compensating_write_errors.empty() &&
+           *m_pending_compensating_write_errors.front().compensating_write_server_version <= last_server_version) {
+        out->push_back(std::move(m_pending_compensating_write_errors.front()));
+        m_pending_compensating_write_errors.pop_front();
+    }
+}
+
+
+void Session::BackgroundIntegration::wait()
+{
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [&] {
+        return done;
+    });
+}
+
+
+void Session::wait_for_background_integration(bool may_send)
+{
+    if (!m_background_integration) {
+        return;
+    }
+    m_background_integration->wait();
+    complete_background_integration(may_send); // Throws
+}
+
+
+void Session::complete_background_integration(bool may_send)
+{
+    REALM_ASSERT(m_background_integration);
+    auto job = std::move(m_background_integration);
+    if (m_state != Active) {
+        return;
+    }
+    if (job->unexpected_error) {
+        std::rethrow_exception(job->unexpected_error);
+    }
+    if (job->error) {
+        if (!may_send) {
+            logger.error("Failed to integrate downloaded changesets: %1", job->error->to_status());
+            return;
+        }
+        on_integration_failure(*job->error);
+        return;
+    }
+
+    if (job->changesets.size() == 1) {
+        logger.debug("1 remote changeset integrated in the background, producing client version %1",
+                     job->version_info.sync_version.version); // Throws
+    }
+    else {
+        logger.debug("%2 remote changesets integrated in the background, producing client version %1",
+                     job->version_info.sync_version.version, job->changesets.size()); // Throws
+    }
+
+    std::vector<ProtocolErrorInfo> pending_compensating_write_errors;
+    gather_pending_compensating_writes(job->changesets.back().remote_version, &pending_compensating_write_errors);
+    report_compensating_writes(pending_compensating_write_errors);
+
+    on_changesets_integrated(job->version_info.realm_version, job->progress, true, may_send); // Throws
+
+    if (job->telemetry && m_state == Active)
+        report_download_telemetry(*job->telemetry, job->received_at, &job->integration_metrics); // Throws
+}
+
+
+SessionTelemetry Session::make_download_telemetry(const DownloadMessage& message) const
+{
+    SessionTelemetry telemetry;
+    telemetry.message = SessionTelemetry::Message::download;
+    telemetry.realm_path = get_realm_path(); // Throws
+    telemetry.num_changesets = message.changesets.size();
+    telemetry.message_size = message.message_size;
+    telemetry.uncompressed_body_size = message.uncompressed_body_size;
+    telemetry.compression_time = message.decompression_time;
+    telemetry.parse_time = message.parse_time;
+    auto since_receipt = std::chrono::steady_clock::now() - message.received_at;
+    telemetry.queue_time = std::chrono::duration_cast<std::chrono::microseconds>(since_receipt) -
+                           message.decompression_time - message.parse_time;
+    return telemetry;
+}
+
+
+void Session::report_download_telemetry(SessionTelemetry& telemetry, std::chrono::steady_clock::time_point received_at,
+                                        const ClientHistory::IntegrationMetrics* metrics)
+{
+    if (metrics) {
+        telemetry.parse_time += metrics->parse_time;
+        telemetry.transform_time = metrics->transform_time;
+        telemetry.apply_time = metrics->apply_time;
+        telemetry.commit_time = metrics->commit_time;
+        telemetry.reciprocal_changesets = metrics->reciprocal_changesets;
+        telemetry.conflicting_changesets = metrics->modified_reciprocal_changesets;
+    }
+    telemetry.total_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - received_at);
+    get_client().m_session_telemetry_handler(telemetry); // Throws
+}
+
+
+void Session::report_upload_telemetry()
+{
+    SessionTelemetry telemetry = std::move(*m_upload_telemetry);
+    m_upload_telemetry = util::none;
+    auto now = std::chrono::steady_clock::now();
+    telemetry.send_time = std::chrono::duration_cast<std::chrono::microseconds>(now - m_upload_sent_at);
+    telemetry.total_time = std::chrono::duration_cast<std::chrono::microseconds>(now - m_upload_started_at);
+    get_client().m_session_telemetry_handler(telemetry); // Throws
+}
+
+
 void Session::integrate_changesets(const SyncProgress& progress, std::uint_fast64_t downloadable_bytes,
                                    const ReceivedChangesets& received_changesets, VersionInfo& version_info,
                                    DownloadBatchState download_batch_state)
@@ -1575,7 +1751,13 @@ void Session::integrate_changesets(const SyncProgress& progress, std::uint_fast6
                      version_info.sync_version.version, received_changesets.size()); // Throws
     }
 
-    for (const auto& pending_error : pending_compensating_write_errors) {
+    report_compensating_writes(pending_compensating_write_errors);
+}
+
+
+void Session::report_compensating_writes(const std::vector<ProtocolErrorInfo>& compensating_writes)
+{
+    for (const auto& pending_error : compensating_writes) {
         logger.info("Reporting compensating write for client version %1 in server version %2: %3",
                     pending_error.compensating_write_rejected_client_version,
                     *pending_error.compensating_write_server_version, pending_error.message);
@@ -1599,6 +1781,8 @@ void Session::on_integration_failure(const IntegrationException& error)
     REALM_ASSERT(!m_client_error && !m_error_to_send);
     logger.error("Failed to integrate downloaded changesets: %1", error.to_status());
 
+    abort_streaming_flx_bootstrap(); // Throws
+
     m_client_error = util::make_optional<IntegrationException>(error);
     m_error_to_send = true;
     SessionErrorInfo error_info{error.to_status(), IsFatal{false}};
@@ -1615,7 +1799,7 @@ void Session::on_integration_failure(const IntegrationException& error)
 }
 
 void Session::on_changesets_integrated(version_type client_version, const SyncProgress& progress,
-                                       bool changesets_integrated)
+                                       bool changesets_integrated, bool may_send)
 {
     REALM_ASSERT_EX(m_state == Active, m_state);
     REALM_ASSERT_3(progress.download.server_version, >=, m_download_progress.server_version);
@@ -1644,6 +1828,8 @@ void Session::on_changesets_integrated(version_type client_version, const SyncPr
 
     check_for_download_completion(); // Throws
 
+    schedule_history_maintenance(); // Throws
+
     // If the client migrated from PBS to FLX, create subscriptions when new tables are received from server.
     if (auto migration_store = get_migration_store(); migration_store && m_is_flx_sync_session) {
         auto& flx_subscription_store = *get_flx_subscription_store();
@@ -1653,7 +1839,7 @@ void Session::on_changesets_integrated(version_type client_version, const SyncPr
     // Since the deactivation process has not been initiated, the UNBIND
     // message cannot have been sent unless an ERROR message was received.
     REALM_ASSERT(m_suspended || m_error_message_received || !m_unbind_message_sent);
-    if (m_ident_message_sent && !m_error_message_received && !m_suspended) {
+    if (may_send && m_ident_message_sent && !m_error_message_received && !m_suspended) {
         ensure_enlisted_to_send(); // Throws
     }
 }
@@ -1662,6 +1848,10 @@ void Session::on_changesets_integrated(version_type client_version, const SyncPr
 Session::~Session()
 {
     //    REALM_ASSERT_EX(m_state == Unactivated || m_state == Deactivated, m_state);
+
+    // The worker may still be using the logger and the history of this session.
+    if (m_background_integration)
+        m_background_integration->wait();
 }
 
 
@@ -1739,6 +1929,9 @@ void Session::initiate_deactivation()
 
     logger.debug("Initiating deactivation"); // Throws
 
+    wait_for_background_integration(false); // Throws
+    abort_streaming_flx_bootstrap();         // Throws
+
     m_state = Deactivating;
 
     if (!m_suspended)
@@ -2013,6 +2206,7 @@ void Session::send_query_change_message()
 
 void Session::send_upload_message()
 {
+    REALM_TRACE_SCOPE("sync::Session::send_upload_message");
     REALM_ASSERT_EX(m_state == Active, m_state);
     REALM_ASSERT(m_ident_message_sent);
     REALM_ASSERT(!m_unbind_message_sent);
@@ -2026,10 +2220,17 @@ void Session::send_upload_message()
         target_upload_version = m_pending_flx_sub_set->snapshot_version;
     }
 
+    // Unless they are to be coalesced or logged, the changesets are streamed
+    // from the history into the message instead of first being decompressed
+    // into buffers of their own
+    bool decompress = get_client().m_upload_coalescing_window > 0 || logger.would_log(util::Logger::Level::trace);
+
+    auto start_time = std::chrono::steady_clock::now();
     std::vector<UploadChangeset> uploadable_changesets;
     version_type locked_server_version = 0;
     get_history().find_uploadable_changesets(m_upload_progress, target_upload_version, uploadable_changesets,
-                                             locked_server_version); // Throws
+                                             locked_server_version, decompress); // Throws
+    auto find_end_time = std::chrono::steady_clock::now();
 
     if (uploadable_changesets.empty()) {
         // Nothing more to upload right now
@@ -2045,6 +2246,17 @@ void Session::send_upload_message()
     }
     else {
         m_last_version_selected_for_upload = uploadable_changesets.back().progress.client_version;
+
+        if (get_client().m_upload_coalescing_window > 0 && uploadable_changesets.size() > 1) {
+            std::size_t num_changesets = uploadable_changesets.size();
+            std::size_t num_removed = ClientHistory::coalesce_uploadable_changesets(
+                uploadable_changesets, timestamp_type(get_client().m_upload_coalescing_window),
+                get_client().m_upload_coalescing_max_size); // Throws
+            if (num_removed > 0) {
+                logger.debug(util::LogCategory::changeset, "Coalesced %1 changesets into %2 for upload",
+                             num_changesets, uploadable_changesets.size()); // Throws
+            }
+        }
     }
 
     if (m_pending_flx_sub_set && target_upload_version < m_last_version_available) {
@@ -2067,9 +2279,9 @@ void Session::send_upload_message()
         logger.debug(util::LogCategory::changeset,
                      "Fetching changeset for upload (client_version=%1, server_version=%2, "
                      "changeset_size=%3, origin_timestamp=%4, origin_file_ident=%5)",
-                     uc.progress.client_version, uc.progress.last_integrated_server_version, uc.changeset.size(),
+                     uc.progress.client_version, uc.progress.last_integrated_server_version, uc.size,
                      uc.origin_timestamp, uc.origin_file_ident); // Throws
-        if (logger.would_log(util::Logger::Level::trace)) {
+        if (!uc.snapshot && logger.would_log(util::Logger::Level::trace)) {
             BinaryData changeset_data = uc.changeset.get_first_chunk();
             if (changeset_data.size() < 1024) {
                 logger.trace(util::LogCategory::changeset, "Changeset: %1",
@@ -2125,10 +2337,10 @@ void Session::send_upload_message()
         else
 #endif
         {
+            auto changeset = uc.open(); // Throws
             upload_message_builder.add_changeset(uc.progress.client_version,
                                                  uc.progress.last_integrated_server_version, uc.origin_timestamp,
-                                                 uc.origin_file_ident,
-                                                 uc.changeset); // Throws
+                                                 uc.origin_file_ident, uc.size, *changeset); // Throws
         }
     }
 
@@ -2138,7 +2350,31 @@ void Session::send_upload_message()
     upload_message_builder.make_upload_message(protocol_version, out, session_ident, progress_client_version,
                                                progress_server_version,
                                                locked_server_version); // Throws
-    m_conn.initiate_write_message(out, this);                          // Throws
+    const auto& compression = upload_message_builder.get_compression_info();
+    if (compression.compressed_body_size != 0) {
+        logger.debug(util::LogCategory::changeset,
+                     "Upload message compression: uncompressed_body_size=%1, compressed_body_size=%2, "
+                     "ratio=%3, used_dictionary=%4, compression_time=%5us",
+                     compression.uncompressed_body_size, compression.compressed_body_size,
+                     double(compression.uncompressed_body_size) / compression.compressed_body_size,
+                     compression.used_dictionary, compression.duration.count()); // Throws
+    }
+    if (get_client().m_session_telemetry_handler) {
+        auto now = std::chrono::steady_clock::now();
+        auto& telemetry = m_upload_telemetry.emplace();
+        telemetry.message = SessionTelemetry::Message::upload;
+        telemetry.realm_path = get_realm_path(); // Throws
+        telemetry.num_changesets = uploadable_changesets.size();
+        telemetry.message_size = out.size();
+        telemetry.uncompressed_body_size = compression.uncompressed_body_size;
+        telemetry.compression_time = compression.duration;
+        telemetry.find_time = std::chrono::duration_cast<std::chrono::microseconds>(find_end_time - start_time);
+        telemetry.encode_time =
+            std::chrono::duration_cast<std::chrono::microseconds>(now - find_end_time) - compression.duration;
+        m_upload_started_at = start_time;
+        m_upload_sent_at = now;
+    }
+    m_conn.initiate_write_message(out, this); // Throws
 
     // Other messages may be waiting to be sent
     enlist_to_send(); // Throws
@@ -2463,7 +2699,15 @@ Status Session::receive_download_message(const DownloadMessage& message)
     if (is_flx)
         update_download_estimate(message.progress_estimate);
 
+    util::Optional<SessionTelemetry> telemetry;
+    if (get_client().m_session_telemetry_handler)
+        telemetry = make_download_telemetry(message); // Throws
+
     if (process_flx_bootstrap_message(progress, batch_state, query_version, message.changesets)) {
+        // The integration of a bootstrap spans several messages, so its breakdown is not attributed to any one of
+        // them.
+        if (telemetry && m_state == Active && !m_client_error)
+            report_download_telemetry(*telemetry, message.received_at, nullptr); // Throws
         clear_resumption_delay_state();
         return Status::OK();
     }
@@ -2471,6 +2715,21 @@ Status Session::receive_download_message(const DownloadMessage& message)
     uint64_t downloadable_bytes = is_flx ? 0 : message.downloadable_bytes;
     initiate_integrate_changesets(downloadable_bytes, batch_state, progress, message.changesets); // Throws
 
+    if (telemetry && m_state == Active && !m_client_error) {
+        if (m_background_integration) {
+            // Reported by complete_background_integration(). The worker does not access the telemetry.
+            m_background_integration->telemetry = std::move(telemetry);
+            m_background_integration->received_at = message.received_at;
+        }
+        else if (!message.changesets.empty() && !get_client().is_dry_run()) {
+            report_download_telemetry(*telemetry, message.received_at,
+                                      &get_history().get_last_integration_metrics()); // Throws
+        }
+        else {
+            report_download_telemetry(*telemetry, message.received_at, nullptr); // Throws
+        }
+    }
+
     hook_action = call_debug_hook(SyncClientHookEvent::DownloadMessageIntegrated, progress, query_version,
                                   batch_state, message.changesets.size());
     if (hook_action == SyncClientHookAction::EarlyReturn) {
@@ -2603,6 +2862,7 @@ Status Session::receive_error_message(const ProtocolErrorInfo& info)
     if (protocol_error == ProtocolError::schema_version_changed) {
         // Enable upload immediately if the session is still active.
         if (m_state == Active) {
+            abort_streaming_flx_bootstrap();
             auto wt = get_db()->start_write();
             _impl::sync_schema_migration::track_sync_schema_migration(*wt, *info.previous_schema_version);
             wt->commit();
@@ -2624,6 +2884,9 @@ void Session::suspend(const SessionErrorInfo& info)
     REALM_ASSERT_EX(m_state == Active || m_state == Deactivating, m_state);
     logger.debug("Suspended"); // Throws
 
+    wait_for_background_integration(false); // Throws
+    abort_streaming_flx_bootstrap();         // Throws
+
     m_suspended = true;
 
     // Detect completion of the unbinding process
@@ -2699,6 +2962,35 @@ void Session::begin_resumption_delay(const ProtocolErrorInfo& error_info)
     });
 }
 
+void Session::schedule_history_maintenance()
+{
+    auto slice = get_client().m_history_maintenance_slice;
+    if (slice <= 0 || m_history_maintenance_timer)
+        return;
+    if (get_history().get_maintenance_metrics().entries_pending == 0)
+        return;
+
+    m_history_maintenance_timer =
+        get_client().create_timer(std::chrono::milliseconds(10 * slice), [this, slice](Status status) {
+            if (status == ErrorCodes::OperationAborted)
+                return;
+            else if (!status.is_ok())
+                throw Exception(status);
+
+            m_history_maintenance_timer.reset();
+            if (m_state != Active)
+                return;
+            auto& history = get_history();
+            bool more = history.run_maintenance_slice(std::chrono::milliseconds(slice)); // Throws
+            auto metrics = history.get_maintenance_metrics();
+            logger.trace("History maintenance: %1 entries trimmed inline, %2 in %3 slices taking %4 us, %5 pending",
+                         metrics.entries_trimmed_inline, metrics.entries_trimmed_in_background, metrics.slices,
+                         metrics.slice_time_us, metrics.entries_pending);
+            if (more)
+                schedule_history_maintenance(); // Throws
+        });
+}
+
 void Session::clear_resumption_delay_state()
 {
     if (m_try_again_activation_timer) {
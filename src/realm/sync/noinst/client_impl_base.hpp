@@ -9,6 +9,7 @@
 #include <realm/sync/network/default_socket.hpp>
 #include <realm/sync/network/network_ssl.hpp>
 #include <realm/sync/noinst/client_history_impl.hpp>
+#include <realm/sync/noinst/integration_worker_pool.hpp>
 #include <realm/sync/noinst/migration_store.hpp>
 #include <realm/sync/noinst/migration_store.hpp>
 #include <realm/sync/noinst/protocol_codec.hpp>
@@ -20,6 +21,7 @@
 #include <realm/util/optional.hpp>
 #include <realm/util/span.hpp>
 
+#include <condition_variable>
 #include <cstdint>
 #include <deque>
 #include <functional>
@@ -28,6 +30,7 @@
 #include <random>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace realm::sync {
 
@@ -249,8 +252,18 @@ private:
     const bool m_dry_run; // For testing purposes only
     const bool m_enable_default_port_hack;
     const bool m_disable_upload_compaction;
+    const milliseconds_type m_upload_coalescing_window;
+    const size_t m_upload_coalescing_max_size;
     const bool m_fix_up_object_ids;
+    const size_t m_reciprocal_transform_cache_budget;
+    const milliseconds_type m_history_maintenance_slice;
+    // Never zero
+    const size_t m_max_batched_messages;
+    // Null unless ClientConfig::integration_worker_threads is nonzero. Declared before the server slots, so that it
+    // outlives the sessions which may be waiting for its jobs.
+    const std::unique_ptr<IntegrationWorkerPool> m_integration_workers;
     const std::function<RoundtripTimeHandler> m_roundtrip_time_handler;
+    const std::function<SessionTelemetryHandler> m_session_telemetry_handler;
     const std::string m_user_agent_string;
     std::shared_ptr<SyncSocketProvider> m_socket_provider;
     ClientProtocol m_client_protocol;
@@ -542,6 +555,7 @@ private:
     void initiate_pong_timeout();
     void handle_pong_timeout();
     void initiate_write_message(const OutputBuffer&, Session*);
+    void initiate_write_batch();
     void handle_write_message();
     void send_next_message();
     void send_ping();
@@ -686,10 +700,17 @@ private:
     // then granted an opportunity to send a message.
     std::deque<Session*> m_sessions_enlisted_to_send;
 
-    Session* m_sending_session = nullptr;
+    // The sessions whose messages are part of the write that is currently in
+    // progress (or being assembled by send_next_message()), in the order in
+    // which the messages occur in the write. A session occurs at most once.
+    std::vector<Session*> m_sending_sessions;
 
     std::unique_ptr<char[]> m_input_body_buffer;
-    OutputBuffer m_output_buffer;
+
+    // One output buffer per message that can be part of a single batched
+    // write (ClientConfig::max_batched_messages). The Nth message of a batch
+    // is built in the Nth buffer.
+    std::unique_ptr<OutputBuffer[]> m_output_buffers;
 
     const connection_ident_type m_ident;
     ServerEndpoint m_server_endpoint;
@@ -849,7 +870,7 @@ public:
     /// (Connection::activate_session()), or after initiation of deactivation
     /// (Connection::initiate_session_deactivation()).
     void on_changesets_integrated(version_type client_version, const SyncProgress& progress,
-                                  bool changesets_integrated);
+                                  bool changesets_integrated, bool may_send = true);
 
     void on_integration_failure(const IntegrationException& e);
 
@@ -991,16 +1012,40 @@ private:
     // Processes any pending FLX bootstraps, if one exists. Otherwise this is a noop.
     void process_pending_flx_bootstrap();
 
+    // Integrates a bootstrap message into the streaming bootstrap, and commits the bootstrap if it was the last
+    // message of it.
+    void process_streaming_flx_bootstrap_message(const SyncProgress& progress, DownloadBatchState batch_state,
+                                                 int64_t query_version, const ReceivedChangesets& received_changesets);
+
+    // Rolls back the streaming bootstrap, if one is in progress. Otherwise this is a noop.
+    void abort_streaming_flx_bootstrap();
+
     bool client_reset_if_needed();
     void handle_pending_client_reset_acknowledgement();
 
     void update_subscription_version_info();
 
     void gather_pending_compensating_writes(util::Span<Changeset> changesets, std::vector<ProtocolErrorInfo>* out);
+    void gather_pending_compensating_writes(version_type last_server_version, std::vector<ProtocolErrorInfo>* out);
+    void report_compensating_writes(const std::vector<ProtocolErrorInfo>& compensating_writes);
+
+    // Hands the integration of the changesets of a DOWNLOAD message to the integration worker pool. Returns false,
+    // without doing anything, if they have to be integrated on the event loop thread instead.
+    bool initiate_background_integration(std::uint_fast64_t downloadable_bytes, DownloadBatchState batch_state,
+                                         const SyncProgress& progress, const ReceivedChangesets& changesets);
+    // Blocks until the background integration in progress, if any, is done, and processes its outcome. Must be
+    // called before anything else that depends on the state of the session's Realm file. `may_send` is false when
+    // the session is being disconnected, suspended or deactivated, in which case no message is enlisted and a
+    // failed integration is dropped, as the server will send the changesets again.
+    void wait_for_background_integration(bool may_send = true);
+    void complete_background_integration(bool may_send);
 
     void begin_resumption_delay(const ProtocolErrorInfo& error_info);
     void clear_resumption_delay_state();
 
+    // Schedules a slice of trimming of the history, if write transactions left a backlog of it.
+    void schedule_history_maintenance();
+
 private:
     Connection& m_conn;
     const session_ident_type m_ident;
@@ -1018,6 +1063,9 @@ private:
     SyncSocketProvider::SyncTimer m_try_again_activation_timer;
     ErrorBackoffState<sync::ProtocolError, RandomEngine> m_try_again_delay_info;
 
+    // Runs the next slice of history trimming, see schedule_history_maintenance().
+    SyncSocketProvider::SyncTimer m_history_maintenance_timer;
+
     // Set to true when download completion is reached. Set to false after a
     // slow reconnect, such that the upload process will become suspended until
     // download completion is reached again.
@@ -1044,10 +1092,56 @@ private:
     util::Optional<SubscriptionStore::PendingSubscription> m_pending_flx_sub_set;
     int64_t m_last_sent_flx_query_version = 0;
 
+    // The FLX bootstrap that is being integrated as it is downloaded when streaming bootstraps are enabled. The
+    // write transaction is only committed once the last batch has been integrated, so until then the bootstrap is
+    // invisible to other transactions.
+    struct StreamingBootstrap {
+        TransactionRef transact;
+        int64_t query_version = 0;
+        size_t changesets_integrated = 0;
+        uint64_t downloaded_bytes = 0;
+        // Only the metadata is kept, the data belongs to an earlier DOWNLOAD message.
+        util::Optional<RemoteChangeset> last_changeset;
+    } m_streaming_bootstrap;
+
+    // The changesets being integrated by the integration worker pool. There is at most one batch in flight per
+    // session, and its outcome is processed on the event loop thread, either when the worker posts it back, or
+    // earlier when wait_for_background_integration() is called.
+    struct BackgroundIntegration {
+        SyncProgress progress;
+        std::uint_fast64_t downloadable_bytes = 0;
+        DownloadBatchState batch_state = DownloadBatchState::SteadyState;
+        // Owns the data of `changesets`, which otherwise belongs to the input buffer of the connection.
+        std::unique_ptr<char[]> changeset_data;
+        ReceivedChangesets changesets;
+
+        VersionInfo version_info;
+        util::Optional<IntegrationException> error;
+        std::exception_ptr unexpected_error;
+
+        // Set by the worker, reported on the event loop thread if `telemetry` was attached to the job.
+        ClientHistory::IntegrationMetrics integration_metrics;
+        util::Optional<SessionTelemetry> telemetry;
+        std::chrono::steady_clock::time_point received_at;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done = false;
+
+        void wait();
+    };
+    std::shared_ptr<BackgroundIntegration> m_background_integration;
+
     std::deque<ProtocolErrorInfo> m_pending_compensating_write_errors;
 
     util::Optional<IntegrationException> m_client_error;
 
+    // The telemetry of the UPLOAD message whose sending is in progress. Only
+    // used when ClientConfig::session_telemetry_handler is set.
+    util::Optional<SessionTelemetry> m_upload_telemetry;
+    std::chrono::steady_clock::time_point m_upload_started_at;
+    std::chrono::steady_clock::time_point m_upload_sent_at;
+
     // `ident == 0` means unassigned.
     SaltedFileIdent m_client_file_ident = {0, 0};
 
@@ -1184,6 +1278,11 @@ private:
     Status receive_query_error_message(int error_code, std::string_view message, int64_t query_version);
     Status receive_test_command_response(request_ident_type, std::string_view body);
 
+    SessionTelemetry make_download_telemetry(const DownloadMessage&) const;
+    void report_download_telemetry(SessionTelemetry&, std::chrono::steady_clock::time_point received_at,
+                                   const ClientHistory::IntegrationMetrics*);
+    void report_upload_telemetry();
+
     void initiate_rebind();
     void reset_protocol_state() noexcept;
     void ensure_enlisted_to_send();
@@ -1341,8 +1440,10 @@ inline void ClientImpl::Connection::one_less_active_unsuspended_session()
 // after which they call initiate_write_output_buffer(Session* sess).
 inline auto ClientImpl::Connection::get_output_buffer() noexcept -> OutputBuffer&
 {
-    m_output_buffer.reset();
-    return m_output_buffer;
+    REALM_ASSERT(m_sending_sessions.size() < m_client.m_max_batched_messages);
+    OutputBuffer& out = m_output_buffers[m_sending_sessions.size()];
+    out.reset();
+    return out;
 }
 
 inline auto ClientImpl::Connection::get_session(session_ident_type ident) const noexcept -> Session*
@@ -1404,6 +1505,7 @@ inline void ClientImpl::Session::recognize_sync_version(version_type version)
         if (m_ident_message_sent && !m_suspended)
             ensure_enlisted_to_send(); // Throws
     }
+    schedule_history_maintenance(); // Throws
 }
 
 inline void ClientImpl::Session::request_upload_completion_notification()
@@ -1492,6 +1594,7 @@ inline void ClientImpl::Session::connection_established(bool fast_reconnect)
 inline void ClientImpl::Session::connection_lost()
 {
     REALM_ASSERT(m_state == Active || m_state == Deactivating);
+    wait_for_background_integration(false); // Throws
     // If the deactivation process has been initiated, it can now be immediately
     // completed.
     if (m_state == Deactivating) {
@@ -1499,6 +1602,8 @@ inline void ClientImpl::Session::connection_lost()
         REALM_ASSERT(m_state == Deactivated);
         return;
     }
+    // The server restarts the bootstrap after reconnecting
+    abort_streaming_flx_bootstrap(); // Throws
     reset_protocol_state();
 }
 
@@ -1515,6 +1620,9 @@ inline void ClientImpl::Session::message_sent()
     // No message will be sent after the UNBIND message
     REALM_ASSERT(!m_unbind_message_send_complete);
 
+    if (m_upload_telemetry)
+        report_upload_telemetry(); // Throws
+
     if (m_unbind_message_sent) {
         REALM_ASSERT(!m_enlisted_to_send);
 
@@ -1567,6 +1675,7 @@ inline void ClientImpl::Session::reset_protocol_state() noexcept
     m_error_message_received = false;
     m_unbound_message_received = false;
     m_client_error = util::none;
+    m_upload_telemetry = util::none;
 
     m_upload_progress = m_progress.upload;
     m_last_version_selected_for_upload = m_upload_progress.client_version;
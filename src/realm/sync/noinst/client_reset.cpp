@@ -34,6 +34,8 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <thread>
 #include <vector>
 
 using namespace realm;
@@ -70,9 +72,187 @@ static inline bool should_skip_table(const Transaction& group, TableKey key)
     return !group.table_is_public(key);
 }
 
+namespace {
+
+// Compare two node structures by their content. Nodes which are equal but
+// encoded differently are reported as different.
+bool nodes_are_equal(Allocator& alloc_1, ref_type ref_1, Allocator& alloc_2, ref_type ref_2)
+{
+    if (!ref_1 || !ref_2)
+        return ref_1 == ref_2;
+    const char* header_1 = alloc_1.translate(ref_1);
+    const char* header_2 = alloc_2.translate(ref_2);
+    if (!NodeHeader::get_hasrefs_from_header(header_1) || !NodeHeader::get_hasrefs_from_header(header_2)) {
+        // The first four bytes of the header hold the capacity, which may
+        // differ. The rest holds the flags and the size, followed by the data.
+        size_t byte_size = NodeHeader::get_byte_size_from_header(header_1);
+        return byte_size == NodeHeader::get_byte_size_from_header(header_2) &&
+               std::memcmp(header_1 + 4, header_2 + 4, byte_size - 4) == 0;
+    }
+
+    Array node_1(alloc_1);
+    Array node_2(alloc_2);
+    node_1.init_from_ref(ref_1);
+    node_2.init_from_ref(ref_2);
+    size_t size = node_1.size();
+    if (size != node_2.size() || node_1.is_inner_bptree_node() != node_2.is_inner_bptree_node() ||
+        node_1.get_context_flag() != node_2.get_context_flag())
+        return false;
+    for (size_t i = 0; i < size; ++i) {
+        RefOrTagged value_1 = node_1.get_as_ref_or_tagged(i);
+        RefOrTagged value_2 = node_2.get_as_ref_or_tagged(i);
+        if (value_1.is_tagged() || value_2.is_tagged()) {
+            if (!value_1.is_tagged() || !value_2.is_tagged() || value_1.get_as_int() != value_2.get_as_int())
+                return false;
+        }
+        else if (!nodes_are_equal(alloc_1, value_1.get_as_ref(), alloc_2, value_2.get_as_ref())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool has_same_columns(const Table& table_1, const Table& table_2)
+{
+    if (table_1.get_column_count() != table_2.get_column_count())
+        return false;
+    for (ColKey col_key : table_1.get_column_keys()) {
+        // Equal keys put the values in the same places of the clusters
+        if (table_2.get_column_key(table_1.get_column_name(col_key)) != col_key)
+            return false;
+        auto type = col_key.get_type();
+        if (type == col_type_Link || type == col_type_Mixed || type == col_type_TypedLink)
+            return false;
+    }
+    return true;
+}
+
+struct ClusterLocation {
+    ObjKey first;
+    ObjKey last;
+    ref_type ref;
+};
+
+std::vector<ClusterLocation> get_clusters(const Table& table)
+{
+    std::vector<ClusterLocation> clusters;
+    table.traverse_clusters([&](const Cluster* cluster) {
+        if (size_t size = cluster->node_size())
+            clusters.push_back({cluster->get_real_key(0), cluster->get_real_key(size - 1), cluster->get_ref()});
+        return IteratorControl::AdvanceToNext;
+    });
+    return clusters;
+}
+
+UnchangedObjects find_unchanged_objects(const Table& table_src, const Table& table_dst)
+{
+    UnchangedObjects unchanged;
+    auto clusters_dst = get_clusters(table_dst);
+    table_src.traverse_clusters([&](const Cluster* cluster) {
+        size_t size = cluster->node_size();
+        if (size == 0)
+            return IteratorControl::AdvanceToNext;
+        ObjKey first = cluster->get_real_key(0);
+        auto it = std::lower_bound(clusters_dst.begin(), clusters_dst.end(), first, [](auto& c, ObjKey key) {
+            return c.first < key;
+        });
+        // The keys of a cluster are stored relative to its first one, so the
+        // clusters hold the same keys if they start with the same one and
+        // their nodes are equal
+        if (it != clusters_dst.end() && it->first == first &&
+            nodes_are_equal(table_src.get_alloc(), cluster->get_ref(), table_dst.get_alloc(), it->ref)) {
+            unchanged.ranges.emplace_back(first, it->last);
+            unchanged.count += size;
+        }
+        return IteratorControl::AdvanceToNext;
+    });
+    return unchanged;
+}
+
+} // unnamed namespace
+
+bool UnchangedObjects::contains(ObjKey key) const noexcept
+{
+    auto it = std::upper_bound(ranges.begin(), ranges.end(), key, [](ObjKey key, auto& range) {
+        return key < range.first;
+    });
+    return it != ranges.begin() && key <= std::prev(it)->second;
+}
+
+UnchangedTables find_unchanged_objects(const Transaction& group_src, const Transaction& group_dst,
+                                       util::Logger& logger)
+{
+    auto t1 = std::chrono::steady_clock::now();
+    std::vector<std::pair<ConstTableRef, ConstTableRef>> tables;
+    for (auto table_key : group_src.get_table_keys()) {
+        if (should_skip_table(group_src, table_key))
+            continue;
+        ConstTableRef table_src = group_src.get_table(table_key);
+        ConstTableRef table_dst = group_dst.get_table(table_src->get_name());
+        if (table_dst && !table_src->is_embedded() && has_same_columns(*table_src, *table_dst))
+            tables.emplace_back(table_src, table_dst);
+    }
+
+    std::vector<UnchangedObjects> results(tables.size());
+    auto compare_tables = [&](size_t begin, size_t step) {
+        for (size_t i = begin; i < tables.size(); i += step)
+            results[i] = find_unchanged_objects(*tables[i].first, *tables[i].second);
+    };
+    // Only frozen transactions may be read from several threads at once
+    size_t num_threads = 1;
+    if (group_src.is_frozen() && group_dst.is_frozen())
+        num_threads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), tables.size());
+    if (num_threads > 1) {
+        std::vector<std::exception_ptr> errors(num_threads);
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (size_t t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&, t] {
+                try {
+                    compare_tables(t, num_threads);
+                }
+                catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        for (auto& error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+    else {
+        compare_tables(0, 1);
+    }
+
+    UnchangedTables unchanged;
+    size_t total = 0;
+    for (size_t i = 0; i < tables.size(); ++i) {
+        total += results[i].count;
+        unchanged.emplace(tables[i].first->get_name(), std::move(results[i]));
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    logger.debug(util::LogCategory::reset, "Found %1 unchanged objects in %2 tables using %3 threads in %4 ms",
+                 total, tables.size(), num_threads,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count());
+    return unchanged;
+}
+
 void transfer_group(const Transaction& group_src, Transaction& group_dst, util::Logger& logger,
-                    bool allow_schema_additions)
+                    bool allow_schema_additions, const UnchangedTables* unchanged)
 {
+    static const UnchangedObjects no_unchanged_objects;
+    auto get_unchanged = [&](StringData table_name) -> const UnchangedObjects& {
+        if (unchanged) {
+            auto it = unchanged->find(std::string_view(table_name));
+            if (it != unchanged->end())
+                return it->second;
+        }
+        return no_unchanged_objects;
+    };
+
     logger.debug(util::LogCategory::reset,
                  "transfer_group, src size = %1, dst size = %2, allow_schema_additions = %3", group_src.size(),
                  group_dst.size(), allow_schema_additions);
@@ -331,8 +511,11 @@ void transfer_group(const Transaction& group_src, Transaction& group_dst, util::
 
         auto pk_col = table_dst->get_primary_key_column();
         REALM_ASSERT_DEBUG(pk_col); // sync realms always have a pk
+        auto& unchanged_objects = get_unchanged(table_name);
         std::vector<std::pair<Mixed, ObjKey>> objects_to_remove;
         for (auto obj : *table_dst) {
+            if (unchanged_objects.contains(obj.get_key()))
+                continue;
             auto pk = obj.get_any(pk_col);
             if (!table_src->find_primary_key(pk)) {
                 objects_to_remove.emplace_back(pk, obj.get_key());
@@ -359,7 +542,10 @@ void transfer_group(const Transaction& group_src, Transaction& group_dst, util::
                      "Creating missing objects for table '%1', number of rows = %2, "
                      "primary_key_col = %3, primary_key_type = %4",
                      table_name, table_src->size(), pk_col.get_index().val, pk_col.get_type());
+        auto& unchanged_objects = get_unchanged(table_name);
         for (const Obj& src : *table_src) {
+            if (unchanged_objects.contains(src.get_key()))
+                continue;
             bool created = false;
             table_dst->create_object_with_primary_key(src.get_primary_key(), &created);
             if (created) {
@@ -395,7 +581,12 @@ void transfer_group(const Transaction& group_src, Transaction& group_dst, util::
 
         converters::InterRealmObjectConverter converter(table_src, table_dst, &embedded_tracker);
 
+        auto& unchanged_objects = get_unchanged(table_name);
+        if (unchanged_objects.count)
+            logger.debug(util::LogCategory::reset, "Skipping %1 unchanged objects", unchanged_objects.count);
         for (const Obj& src : *table_src) {
+            if (unchanged_objects.contains(src.get_key()))
+                continue;
             auto src_pk = src.get_primary_key();
             // create the object - it should have been created above.
             auto dst = table_dst->get_object_with_primary_key(src_pk);
@@ -608,11 +799,15 @@ bool perform_client_reset_diff(DB& db_local, DB& db_remote, sync::SaltedFileIden
         recovered = process_recovered_changesets(*tr_remote, *frozen_pre_local_state, logger, local_changes);
     }
     else {
-        tr_remote = db_remote.start_read();
+        // Frozen, so that the tables can be compared from several threads
+        tr_remote = db_remote.start_frozen();
     }
 
+    // Objects which are the same in both Realms need not be compared one by one
+    auto unchanged = find_unchanged_objects(*tr_remote, *db_local.start_frozen(old_version_local), logger);
+
     // transform the local Realm such that all public tables become identical to the remote Realm
-    transfer_group(*tr_remote, *wt_local, logger, false);
+    transfer_group(*tr_remote, *wt_local, logger, false, &unchanged);
 
     // now that the state of the fresh and local Realms are identical,
     // reset the local sync history and steal the fresh Realm's ident
@@ -24,7 +24,10 @@
 #include <realm/sync/config.hpp>
 #include <realm/sync/protocol.hpp>
 
+#include <map>
 #include <ostream>
+#include <string>
+#include <vector>
 
 namespace realm {
 
@@ -50,16 +53,43 @@ struct ClientResetFailed : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
+// The objects of a table which are identical in two Realms, as ranges of
+// object keys. The bounds of each range are included.
+struct UnchangedObjects {
+    std::vector<std::pair<ObjKey, ObjKey>> ranges;
+    size_t count = 0;
+
+    bool contains(ObjKey key) const noexcept;
+};
+using UnchangedTables = std::map<std::string, UnchangedObjects, std::less<>>;
+
+// find_unchanged_objects() finds the objects of the public tables which are
+// identical in src and dst, by comparing the nodes of the clusters holding them
+// rather than the values of each object. A cluster is only considered when it
+// holds the same object keys in both, so the result is exact in one direction:
+// an object which is not found may still be identical.
+//
+// Only tables with the same columns in both, and without links or mixed
+// values, are compared, as equal object keys in two Realms do not mean that
+// links point to the same objects. If both transactions are frozen, the tables
+// are compared in parallel.
+UnchangedTables find_unchanged_objects(const Transaction& tr_src, const Transaction& tr_dst, util::Logger& logger);
+
 // transfer_group() transfers all tables, columns, objects and values from the src
 // group to the dst group and deletes everything in the dst group that is absent in
 // the src group. An update is only performed when a comparison shows that a
 // change is needed. In this way, the continuous transaction history of changes
 // is minimal.
 //
+// If `unchanged` is given, the objects listed in it are assumed to be equal in
+// src and dst, and are not compared. It must have been found by
+// find_unchanged_objects() from the state of dst in which its public tables
+// were before this call.
+//
 // The result is that src group is unchanged and the dst group is equal to src
 // when this function returns.
 void transfer_group(const Transaction& tr_src, Transaction& tr_dst, util::Logger& logger,
-                    bool allow_schema_additions);
+                    bool allow_schema_additions, const UnchangedTables* unchanged = nullptr);
 
 struct PendingReset {
     ClientResyncMode type;
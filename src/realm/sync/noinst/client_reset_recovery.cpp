@@ -165,9 +165,47 @@ private:
     ObjKey m_obj_key;
 };
 
+// Finds the updates of top-level properties in the changesets to recover which
+// are overwritten by a later update of the same property, with nothing else
+// touching the property in between, so that they need not be recovered. The
+// result of the recovery is the same, as all of the recovered changesets are
+// uploaded.
+//
+// An update which sets a link does not overwrite the earlier ones, as it is
+// discarded if the target has been deleted on the server, and neither does an
+// update of a default value, as it may not be applied either.
+class SupersededUpdates {
+public:
+    using Instruction = sync::Instruction;
+
+    void add_changeset(const Changeset& changeset);
+
+    bool contains(size_t changeset_ndx, size_t instr_ndx) const noexcept
+    {
+        return m_superseded[changeset_ndx][instr_ndx];
+    }
+    size_t count() const noexcept
+    {
+        return m_count;
+    }
+
+private:
+    using Position = std::pair<size_t, size_t>;
+
+    // Last update of each property, keyed by table, primary key and property
+    std::map<std::string, Position> m_last_updates;
+    std::vector<std::vector<bool>> m_superseded;
+    size_t m_count = 0;
+
+    static std::string object_key(const Changeset&, const Instruction::ObjectInstruction&);
+    void forget_object(const std::string& object_key);
+};
+
 struct RecoverLocalChangesetsHandler : public sync::InstructionApplier {
     RecoverLocalChangesetsHandler(Transaction& dest_wt, Transaction& frozen_pre_local_state, util::Logger& logger);
-    util::AppendBuffer<char> process_changeset(const ChunkedBinaryData& changeset);
+    // Instructions for which `skip` returns true are not recovered
+    util::AppendBuffer<char> process_changeset(const Changeset& changeset,
+                                               util::FunctionRef<bool(size_t instr_ndx)> skip);
 
 private:
     using Instruction = sync::Instruction;
@@ -539,27 +577,24 @@ REALM_NORETURN void RecoverLocalChangesetsHandler::handle_error(const std::strin
     throw realm::_impl::client_reset::ClientResetFailed(full_message);
 }
 
-util::AppendBuffer<char> RecoverLocalChangesetsHandler::process_changeset(const ChunkedBinaryData& changeset)
+util::AppendBuffer<char> RecoverLocalChangesetsHandler::process_changeset(const Changeset& changeset,
+                                                                          util::FunctionRef<bool(size_t)> skip)
 {
-    ChunkedBinaryInputStream in{changeset};
-    size_t decompressed_size;
-    auto decompressed = util::compression::decompress_nonportable_input_stream(in, decompressed_size);
-    if (!decompressed)
-        return {};
-
-    sync::Changeset parsed_changeset;
-    sync::parse_changeset(*decompressed, parsed_changeset); // Throws
 #if REALM_DEBUG
     if (m_logger.would_log(util::Logger::Level::trace)) {
         std::stringstream dumped_changeset;
-        parsed_changeset.print(dumped_changeset);
+        changeset.print(dumped_changeset);
         m_logger.trace(util::LogCategory::reset, "Recovering changeset: %1", dumped_changeset.str());
     }
 #endif
 
-    InstructionApplier::begin_apply(parsed_changeset);
-    for (auto instr : parsed_changeset) {
-        if (!instr)
+    InstructionApplier::begin_apply(changeset);
+    // Look up the objects of the changeset in one go rather than one
+    // instruction at a time
+    InstructionApplier::resolve_objects(changeset); // Throws
+    size_t instr_ndx = 0;
+    for (auto instr : changeset) {
+        if (!instr || skip(instr_ndx++))
             continue;
         instr->visit(*this); // Throws
     }
@@ -1176,16 +1211,118 @@ void RecoverLocalChangesetsHandler::operator()(const Instruction::SetErase& inst
     }
 }
 
+void SupersededUpdates::add_changeset(const Changeset& changeset)
+{
+    size_t changeset_ndx = m_superseded.size();
+    auto& superseded = m_superseded.emplace_back();
+    for (auto instr : changeset) {
+        size_t instr_ndx = superseded.size();
+        superseded.push_back(false);
+        if (!instr)
+            continue;
+        instr->visit([&](const auto& i) {
+            using T = std::decay_t<decltype(i)>;
+            if constexpr (std::is_base_of_v<Instruction::PathInstruction, T>) {
+                std::string key = object_key(changeset, i);
+                key += changeset.get_string(i.field);
+                if constexpr (std::is_same_v<T, Instruction::Update>) {
+                    if (i.path.size() == 0 && !i.is_default && i.value.type != Instruction::Payload::Type::Link) {
+                        auto [it, inserted] = m_last_updates.try_emplace(std::move(key), changeset_ndx, instr_ndx);
+                        if (!inserted) {
+                            m_superseded[it->second.first][it->second.second] = true;
+                            ++m_count;
+                            it->second = {changeset_ndx, instr_ndx};
+                        }
+                        return;
+                    }
+                }
+                // Anything else which touches the property depends on the
+                // updates before it
+                m_last_updates.erase(key);
+            }
+            else if constexpr (std::is_base_of_v<Instruction::ObjectInstruction, T>) {
+                forget_object(object_key(changeset, i));
+            }
+            else {
+                // Schema changes are rare, so there is no need to be precise
+                m_last_updates.clear();
+            }
+        });
+    }
+}
+
+std::string SupersededUpdates::object_key(const Changeset& changeset,
+                                          const Instruction::ObjectInstruction& instr)
+{
+    std::string key = changeset.get_string(instr.table);
+    key += '\0';
+    key += mpark::visit(util::overload{
+                            [](mpark::monostate) {
+                                return std::string("null");
+                            },
+                            [&](InternString pk) {
+                                return util::format("%1", changeset.get_string(pk));
+                            },
+                            [](const auto& pk) {
+                                return util::format("%1", pk);
+                            },
+                        },
+                        instr.object);
+    // The type of the key is included, as the string "1" must not be taken
+    // for the integer 1
+    key += char('0' + instr.object.index());
+    key += '\0';
+    return key;
+}
+
+void SupersededUpdates::forget_object(const std::string& object_key)
+{
+    // The keys of all properties of the object begin with the key of the
+    // object, which ends with a zero, so they sort before `end`
+    std::string end = object_key;
+    end.back() = '\1';
+    m_last_updates.erase(m_last_updates.lower_bound(object_key), m_last_updates.lower_bound(end));
+}
+
 } // anonymous namespace
 
 std::vector<client_reset::RecoveredChange>
 client_reset::process_recovered_changesets(Transaction& dest_tr, Transaction& pre_reset_state, util::Logger& logger,
                                            const std::vector<sync::ClientHistory::LocalChange>& local_changes)
 {
+    auto parse = [](const sync::ClientHistory::LocalChange& local_change, Changeset& parsed) {
+        ChunkedBinaryInputStream in{local_change.changeset};
+        size_t decompressed_size;
+        auto decompressed =
+            util::compression::decompress_nonportable_input_stream(in, decompressed_size, local_change.dictionary);
+        if (!decompressed)
+            return false;
+        sync::parse_changeset(*decompressed, parsed); // Throws
+        return true;
+    };
+
+    // The changesets are parsed twice rather than kept in memory, as there
+    // may be a lot of them after a long time offline
+    SupersededUpdates superseded;
+    for (auto& local_change : local_changes) {
+        Changeset parsed;
+        parse(local_change, parsed);      // Throws
+        superseded.add_changeset(parsed); // Throws
+    }
+    if (superseded.count())
+        logger.debug(util::LogCategory::reset, "Skipping %1 superseded updates", superseded.count());
+
     RecoverLocalChangesetsHandler handler(dest_tr, pre_reset_state, logger);
     std::vector<RecoveredChange> encoded;
-    for (auto& local_change : local_changes) {
-        encoded.push_back({handler.process_changeset(local_change.changeset), local_change.version});
+    for (size_t i = 0; i < local_changes.size(); ++i) {
+        Changeset parsed;
+        util::AppendBuffer<char> recovered;
+        if (parse(local_changes[i], parsed)) {
+            recovered = handler.process_changeset(parsed, [&](size_t instr_ndx) {
+                return superseded.contains(i, instr_ndx);
+            });
+        }
+        encoded.push_back({std::move(recovered), local_changes[i].version});
     }
     return encoded;
 }
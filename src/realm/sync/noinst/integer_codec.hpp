@@ -35,6 +35,14 @@ std::size_t encode_int(T value, char* buffer) noexcept;
 template <class T>
 std::size_t decode_int(const char* buffer, std::size_t size, T& value) noexcept;
 
+/// Same as decode_int(const char*, std::size_t, T&), but the caller must
+/// guarantee that at least encode_int_max_bytes<T>() bytes can be read from
+/// \a buffer. This allows the end of input check to be skipped for each byte,
+/// and values below 64, which are encoded as a single byte, to be decoded
+/// without entering the loop.
+template <class T>
+std::size_t decode_int_unchecked(const char* buffer, T& value) noexcept;
+
 /// \tparam I Must have member function `bool read_char(char&)`.
 ///
 /// If decoding succeeds, the decoded value is assigned to \a value and `true`
@@ -232,6 +240,32 @@ std::size_t decode_int(const char* buffer, std::size_t size, T& value) noexcept
     return 0; // Failure
 }
 
+template <class T>
+std::size_t decode_int_unchecked(const char* buffer, T& value) noexcept
+{
+    using uchar = unsigned char;
+    unsigned part = uchar(*buffer);
+    if (REALM_LIKELY((part & 0xC0) == 0)) {
+        // Neither the continuation bit nor the sign bit is set
+        value = T(part);
+        return 1; // Success
+    }
+    struct Input {
+        const char* ptr;
+        bool read_char(char& c) noexcept
+        {
+            c = *ptr++;
+            return true;
+        }
+    };
+    Input input{buffer};
+    if (REALM_LIKELY(decode_int(input, value))) {
+        REALM_ASSERT(input.ptr > buffer);
+        return std::size_t(input.ptr - buffer); // Success
+    }
+    return 0; // Failure
+}
+
 } // namespace _impl
 } // namespace realm
 
@@ -0,0 +1,79 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "realm/sync/noinst/integration_worker_pool.hpp"
+
+#include "realm/util/assert.hpp"
+#include "realm/util/thread.hpp"
+
+namespace realm::sync {
+
+IntegrationWorkerPool::IntegrationWorkerPool(size_t num_threads)
+{
+    REALM_ASSERT(num_threads > 0);
+    m_threads.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        m_threads.emplace_back([this] {
+            util::on_thread_start(util::ThreadRole::sync_integration_worker);
+            run();
+        });
+    }
+}
+
+IntegrationWorkerPool::~IntegrationWorkerPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+    REALM_ASSERT(m_jobs.empty());
+}
+
+void IntegrationWorkerPool::submit(util::UniqueFunction<void()> job)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        REALM_ASSERT(!m_stopping);
+        m_jobs.push_back(std::move(job));
+    }
+    m_cv.notify_one();
+}
+
+void IntegrationWorkerPool::run()
+{
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [&] {
+            return m_stopping || !m_jobs.empty();
+        });
+        if (m_jobs.empty()) {
+            return;
+        }
+        auto job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+} // namespace realm::sync
@@ -0,0 +1,65 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#pragma once
+
+#include "realm/util/functional.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace realm::sync {
+
+// A fixed set of threads which run the integration of downloaded changesets
+// off the sync client event loop, so that sessions for different Realm files
+// can integrate in parallel. Jobs are run in submission order by whichever
+// worker is free; ordering between the jobs of a single session is the
+// responsibility of the caller.
+//
+// All jobs submitted before destruction are run before the destructor
+// returns, as the sessions waiting for them would otherwise never resume.
+class IntegrationWorkerPool {
+public:
+    explicit IntegrationWorkerPool(size_t num_threads);
+    ~IntegrationWorkerPool();
+
+    IntegrationWorkerPool(const IntegrationWorkerPool&) = delete;
+    IntegrationWorkerPool& operator=(const IntegrationWorkerPool&) = delete;
+
+    // May be called from any thread.
+    void submit(util::UniqueFunction<void()> job);
+
+    size_t num_threads() const noexcept
+    {
+        return m_threads.size();
+    }
+
+private:
+    void run();
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<util::UniqueFunction<void()>> m_jobs;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace realm::sync
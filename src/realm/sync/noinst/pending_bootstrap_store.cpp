@@ -212,7 +212,12 @@ void PendingBootstrapStore::clear(Transaction& wt)
 
 PendingBootstrapStore::PendingBatch PendingBootstrapStore::peek_pending(size_t limit_in_bytes)
 {
-    auto tr = m_db->start_read();
+    return peek_pending(m_db->start_read(), limit_in_bytes, 0);
+}
+
+PendingBootstrapStore::PendingBatch PendingBootstrapStore::peek_pending(const TransactionRef& tr,
+                                                                        size_t limit_in_bytes, size_t skip)
+{
     auto bootstrap_table = tr->get_table(m_table);
     if (bootstrap_table->is_empty()) {
         return {};
@@ -240,7 +245,8 @@ PendingBootstrapStore::PendingBatch PendingBootstrapStore::peek_pending(size_t l
 
     auto changeset_list = bootstrap_obj.get_linklist(m_changesets);
     size_t bytes_so_far = 0;
-    for (size_t idx = 0; idx < changeset_list.size() && bytes_so_far < limit_in_bytes; ++idx) {
+    REALM_ASSERT_3(skip, <=, changeset_list.size());
+    for (size_t idx = skip; idx < changeset_list.size() && bytes_so_far < limit_in_bytes; ++idx) {
         auto cur_changeset = changeset_list.get_object(idx);
         ret.changeset_data.push_back(util::AppendBuffer<char>());
         auto& uncompressed_buffer = ret.changeset_data.back();
@@ -266,7 +272,7 @@ PendingBootstrapStore::PendingBatch PendingBootstrapStore::peek_pending(size_t l
         bytes_so_far += parsed_changeset.data.size();
         ret.changesets.push_back(std::move(parsed_changeset));
     }
-    ret.remaining_changesets = changeset_list.size() - ret.changesets.size();
+    ret.remaining_changesets = changeset_list.size() - skip - ret.changesets.size();
 
     return ret;
 }
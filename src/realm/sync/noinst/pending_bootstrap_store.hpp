@@ -65,6 +65,9 @@ public:
     // Returns the next batch (download message) of changesets if it exists. The transaction must be in the reading
     // state.
     PendingBatch peek_pending(size_t limit_in_bytes);
+    // Returns the batch which follows the first `skip` changesets, as of the version of `tr`. Only reads through
+    // `tr`, so it can be called on any thread if `tr` is frozen.
+    PendingBatch peek_pending(const TransactionRef& tr, size_t limit_in_bytes, size_t skip);
 
     struct PendingBatchStats {
         int64_t query_version = 0;
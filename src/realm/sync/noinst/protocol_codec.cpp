@@ -7,6 +7,29 @@ namespace realm::_impl {
 
 using OutputBuffer = util::ResettableExpandableBufferOutputStream;
 
+namespace {
+
+// Version 1 of the preset dictionary for message bodies. It holds the names
+// which appear in the interned strings of most changesets. zlib finds matches
+// near the end of the dictionary with the shortest distances, so the most
+// common names come last. The dictionary is identified by its checksum in the
+// zlib header, so its contents must never change; a new dictionary requires a
+// new protocol version.
+constexpr char g_message_compression_dictionary_v1[] =
+    "description" "completed" "isComplete" "summary" "timestamp" "location" "category" "priority" "quantity"
+    "price" "title" "email" "count" "value" "text" "date" "items" "tags" "updatedAt" "createdAt" "owner"
+    "userId" "user_id" "realm_id" "_partition" "type" "status" "name" "owner_id" "class_" "_id";
+
+} // unnamed namespace
+
+util::Span<const char> get_message_compression_dictionary(int protocol_version) noexcept
+{
+    if (protocol_version < 13)
+        return {};
+    // Exclude the terminating null character
+    return {g_message_compression_dictionary_v1, sizeof(g_message_compression_dictionary_v1) - 1};
+}
+
 // Client protocol
 
 void ClientProtocol::make_pbs_bind_message(int protocol_version, OutputBuffer& out, session_ident_type session_ident,
@@ -106,26 +129,51 @@ void ClientProtocol::UploadMessageBuilder::add_changeset(version_type client_ver
     ++m_num_changesets;
 }
 
+void ClientProtocol::UploadMessageBuilder::add_changeset(version_type client_version, version_type server_version,
+                                                         timestamp_type origin_timestamp,
+                                                         file_ident_type origin_file_ident, std::size_t size,
+                                                         util::InputStream& changeset)
+{
+    m_body_buffer << client_version << " " << server_version << " " << origin_timestamp << " " << origin_file_ident
+                  << " " << size << " "; // Throws
+    std::size_t written = 0;
+    for (auto block = changeset.next_block(); block.size() != 0; block = changeset.next_block()) {
+        m_body_buffer.write(block.data(), block.size()); // Throws
+        written += block.size();
+    }
+    REALM_ASSERT_3(written, ==, size);
+    REALM_ASSERT(!m_body_buffer.fail());
+
+    ++m_num_changesets;
+}
+
 void ClientProtocol::UploadMessageBuilder::make_upload_message(int protocol_version, OutputBuffer& out,
                                                                session_ident_type session_ident,
                                                                version_type progress_client_version,
                                                                version_type progress_server_version,
                                                                version_type locked_server_version)
 {
-    static_cast<void>(protocol_version);
     BinaryData body = {m_body_buffer.data(), std::size_t(m_body_buffer.size())};
 
     constexpr std::size_t g_max_uncompressed = 1024;
 
+    auto dictionary = get_message_compression_dictionary(protocol_version);
     bool is_body_compressed = false;
+    m_compression_info = {};
     if (body.size() > g_max_uncompressed) {
-        util::compression::allocate_and_compress(m_compress_memory_arena, body,
-                                                 m_compression_buffer); // Throws
+        auto start = std::chrono::steady_clock::now();
+        util::compression::allocate_and_compress(m_compress_memory_arena, body, m_compression_buffer,
+                                                 dictionary); // Throws
+        m_compression_info.duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
         is_body_compressed = m_compression_buffer.size() < body.size();
     }
 
     // The compressed body is only sent if it is smaller than the uncompressed body.
     std::size_t compressed_body_size = is_body_compressed ? m_compression_buffer.size() : 0;
+    m_compression_info.uncompressed_body_size = body.size();
+    m_compression_info.compressed_body_size = compressed_body_size;
+    m_compression_info.used_dictionary = is_body_compressed && dictionary.size() != 0;
 
     // The header of the upload message.
     out << "upload " << session_ident << " " << int(is_body_compressed) << " " << body.size() << " "
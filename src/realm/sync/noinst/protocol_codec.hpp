@@ -3,10 +3,12 @@
 
 #include <cstdint>
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <string>
 
+#include <realm/util/alloc_tracking.hpp>
 #include <realm/util/buffer_stream.hpp>
 #include <realm/util/compression.hpp>
 #include <realm/util/from_chars.hpp>
@@ -28,6 +30,12 @@ namespace realm::_impl {
 struct ProtocolCodecException : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
+
+/// The preset zlib dictionary used to compress the bodies of UPLOAD and
+/// DOWNLOAD messages with the specified protocol version, or an empty span if
+/// that version does not use one.
+util::Span<const char> get_message_compression_dictionary(int protocol_version) noexcept;
+
 class HeaderLineParser {
 public:
     explicit HeaderLineParser(std::string_view line)
@@ -202,13 +210,33 @@ public:
 
         void add_changeset(version_type client_version, version_type server_version, timestamp_type origin_timestamp,
                            file_ident_type origin_file_ident, ChunkedBinaryData changeset);
+        /// Add a changeset of `size` bytes, copying it directly from `changeset`
+        /// into the body of the message.
+        void add_changeset(version_type client_version, version_type server_version, timestamp_type origin_timestamp,
+                           file_ident_type origin_file_ident, std::size_t size, util::InputStream& changeset);
 
         void make_upload_message(int protocol_version, OutputBuffer&, session_ident_type session_ident,
                                  version_type progress_client_version, version_type progress_server_version,
                                  version_type locked_server_version);
 
+        /// The outcome of compressing the body in the last call to
+        /// make_upload_message().
+        struct CompressionInfo {
+            std::size_t uncompressed_body_size = 0;
+            // Zero if the body was sent uncompressed
+            std::size_t compressed_body_size = 0;
+            bool used_dictionary = false;
+            std::chrono::microseconds duration{0};
+        };
+
+        const CompressionInfo& get_compression_info() const noexcept
+        {
+            return m_compression_info;
+        }
+
     private:
         std::size_t m_num_changesets = 0;
+        CompressionInfo m_compression_info;
         OutputBuffer& m_body_buffer;
         std::vector<char>& m_compression_buffer;
         util::compression::CompressMemoryArena& m_compress_memory_arena;
@@ -249,7 +277,7 @@ public:
 
         try {
             if (message_type == "download") {
-                parse_download_message(connection, msg);
+                parse_download_message(connection, msg, msg_data.size());
             }
             else if (message_type == "pong") {
                 auto timestamp = msg.read_next<milliseconds_type>('\n');
@@ -410,12 +438,21 @@ public:
             double progress_estimate;
         };
         ReceivedChangesets changesets;
+
+        // Where the time went, for SessionTelemetry
+        std::chrono::steady_clock::time_point received_at;
+        std::size_t message_size = 0;
+        std::size_t uncompressed_body_size = 0;
+        std::chrono::microseconds decompression_time{0};
+        std::chrono::microseconds parse_time{0};
     };
 
 private:
     template <typename Connection>
-    void parse_download_message(Connection& connection, HeaderLineParser& msg)
+    void parse_download_message(Connection& connection, HeaderLineParser& msg, std::size_t message_size)
     {
+        util::AllocTagScope alloc_tag{util::AllocTag::sync_parse};
+        auto received_at = std::chrono::steady_clock::now();
         bool is_flx = connection.is_flx_sync_connection();
 
         util::Logger& logger = connection.logger;
@@ -462,12 +499,17 @@ private:
         }
 
         std::unique_ptr<char[]> uncompressed_body_buffer;
+        std::chrono::microseconds decompression_time{0};
         // if is_body_compressed == true, we must decompress the received body.
         if (is_body_compressed) {
             uncompressed_body_buffer = std::make_unique<char[]>(uncompressed_body_size);
-            std::error_code ec =
-                util::compression::decompress({msg.remaining().data(), compressed_body_size},
-                                              {uncompressed_body_buffer.get(), uncompressed_body_size});
+            auto dictionary = get_message_compression_dictionary(connection.get_negotiated_protocol_version());
+            auto start = std::chrono::steady_clock::now();
+            std::error_code ec = util::compression::decompress(
+                {msg.remaining().data(), compressed_body_size},
+                {uncompressed_body_buffer.get(), uncompressed_body_size}, dictionary);
+            decompression_time =
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
 
             if (ec) {
                 return report_error(ErrorCodes::RuntimeError, "compression::inflate: %1", ec.message());
@@ -478,8 +520,9 @@ private:
 
         logger.debug(util::LogCategory::changeset,
                      "Download message compression: session_ident=%1, is_body_compressed=%2, "
-                     "compressed_body_size=%3, uncompressed_body_size=%4",
-                     session_ident, is_body_compressed, compressed_body_size, uncompressed_body_size);
+                     "compressed_body_size=%3, uncompressed_body_size=%4, decompression_time=%5us",
+                     session_ident, is_body_compressed, compressed_body_size, uncompressed_body_size,
+                     decompression_time.count());
 
         // Loop through the body and find the changesets.
         while (!msg.at_end()) {
@@ -530,6 +573,13 @@ private:
             message.changesets.push_back(std::move(cur_changeset)); // Throws
         }
 
+        message.received_at = received_at;
+        message.message_size = message_size;
+        message.uncompressed_body_size = uncompressed_body_size;
+        message.decompression_time = decompression_time;
+        message.parse_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - received_at) -
+                             decompression_time;
         connection.receive_download_message(session_ident, message); // Throws
     }
 
@@ -761,8 +811,9 @@ public:
                     uncompressed_body_buffer = std::make_unique<char[]>(uncompressed_body_size);
                     auto compressed_body = msg.read_sized_data<BinaryData>(compressed_body_size);
 
+                    auto dictionary = get_message_compression_dictionary(connection.get_client_protocol_version());
                     std::error_code ec = util::compression::decompress(
-                        compressed_body, {uncompressed_body_buffer.get(), uncompressed_body_size});
+                        compressed_body, {uncompressed_body_buffer.get(), uncompressed_body_size}, dictionary);
 
                     if (ec) {
                         return report_error(ErrorCodes::RuntimeError, "compression::inflate: %1", ec.message());
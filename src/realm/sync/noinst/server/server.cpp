@@ -48,6 +48,7 @@
 #include <cstdio>
 #include <cstring>
 #include <functional>
+#include <list>
 #include <locale>
 #include <map>
 #include <memory>
@@ -55,6 +56,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 // NOTE: The protocol specification is in `/doc/protocol.md`
@@ -190,6 +192,8 @@ bool determine_try_again(ProtocolError error_code) noexcept
 
 
 class ServerFile;
+class Worker;
+class BootstrapSnapshotter;
 class ServerImpl;
 class HTTPConnection;
 class SyncConnection;
@@ -224,6 +228,9 @@ struct DownloadCache {
     std::size_t uncompressed_body_size;
     std::size_t compressed_body_size;
     bool body_is_compressed;
+    // Whether the body was compressed with the preset dictionary of the
+    // protocol version negotiated with the client that generated it
+    bool body_uses_dictionary;
     version_type end_version;
     DownloadCursor download_progress;
     std::uint_fast64_t downloadable_bytes;
@@ -233,6 +240,100 @@ struct DownloadCache {
 };
 
 
+// A memory-bounded cache of DOWNLOAD message bodies that is shared by all
+// sessions of the server. When many clients of the same file catch up from the
+// same point in the history, the body only has to be fetched, encoded, and
+// compressed once. An entry is only valid for a client if none of the
+// changesets in the range originate from that client (see
+// Session::continue_history_scan()), which makes the body independent of the
+// client. Least recently used entries are evicted first when the accumulated
+// size of the cached bodies exceeds the limit.
+//
+// Must only be accessed by the network event loop thread.
+class SharedDownloadCache {
+public:
+    struct Key {
+        std::string virt_path;
+        DownloadCursor download_progress;
+        version_type end_version;
+        salt_type end_version_salt;
+        bool body_uses_dictionary;
+
+        bool operator<(const Key& other) const noexcept
+        {
+            return std::tie(virt_path, download_progress.server_version,
+                            download_progress.last_integrated_client_version, end_version, end_version_salt,
+                            body_uses_dictionary) <
+                   std::tie(other.virt_path, other.download_progress.server_version,
+                            other.download_progress.last_integrated_client_version, other.end_version,
+                            other.end_version_salt, other.body_uses_dictionary);
+        }
+    };
+
+    explicit SharedDownloadCache(std::size_t max_size) noexcept
+        : m_max_size{max_size}
+    {
+    }
+
+    bool is_enabled() const noexcept
+    {
+        return m_max_size != 0;
+    }
+
+    // The returned pointer is invalidated by the next call to insert().
+    const DownloadCache* find(const Key& key) noexcept
+    {
+        auto i = m_index.find(key);
+        if (i == m_index.end())
+            return nullptr;
+        m_entries.splice(m_entries.begin(), m_entries, i->second);
+        return &i->second->second;
+    }
+
+    // Bodies larger than the limit are not cached.
+    void insert(const Key& key, DownloadCache entry)
+    {
+        std::size_t size = body_size(entry);
+        if (size > m_max_size || m_index.count(key) != 0)
+            return;
+        while (m_size + size > m_max_size) {
+            REALM_ASSERT(!m_entries.empty());
+            auto& back = m_entries.back();
+            m_size -= body_size(back.second);
+            m_index.erase(back.first);
+            m_entries.pop_back();
+        }
+        m_entries.emplace_front(key, std::move(entry)); // Throws
+        try {
+            m_index.emplace(key, m_entries.begin()); // Throws
+        }
+        catch (...) {
+            m_entries.pop_front();
+            throw;
+        }
+        m_size += size;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+private:
+    using Entries = std::list<std::pair<Key, DownloadCache>>;
+
+    const std::size_t m_max_size;
+    std::size_t m_size = 0;
+    Entries m_entries; // Most recently used first
+    std::map<Key, Entries::iterator> m_index;
+
+    static std::size_t body_size(const DownloadCache& entry) noexcept
+    {
+        return (entry.body_is_compressed ? entry.compressed_body_size : entry.uncompressed_body_size);
+    }
+};
+
+
 // An unblocked work unit is comprised of one Work object for each of the files
 // that contribute work to the work unit, generally one reference file and a
 // number of partial files.
@@ -432,8 +533,8 @@ public:
     // Logger to be used by the worker thread
     util::PrefixLogger wlogger;
 
-    ServerFile(ServerImpl& server, ServerFileAccessCache& cache, const std::string& virt_path, std::string real_path,
-               bool disable_sync_to_disk);
+    ServerFile(ServerImpl& server, ServerFileAccessCache& cache, Worker& worker, const std::string& virt_path,
+               std::string real_path, bool disable_sync_to_disk);
     ~ServerFile() noexcept;
 
     void initialize();
@@ -464,6 +565,18 @@ public:
         return m_worker_file.access(); // Throws
     }
 
+    ServerFileAccessCache::File& snapshotter_access()
+    {
+        return m_snapshotter_file.access(); // Throws
+    }
+
+    // Start opening the Realm file on behalf of the network event loop
+    // thread ahead of the first call to access().
+    void prefetch() noexcept
+    {
+        m_file.prefetch();
+    }
+
     version_type get_realm_version() const noexcept
     {
         return m_version_info.realm_version;
@@ -481,6 +594,23 @@ public:
 
     DownloadCache& get_download_cache() noexcept;
 
+    // A compacted DOWNLOAD body that takes a client from scratch to
+    // `end_version`, produced in the background by the bootstrap
+    // snapshotter. `body` is null if no snapshot has been produced yet.
+    const DownloadCache& get_bootstrap_snapshot() const noexcept
+    {
+        return m_bootstrap_snapshot;
+    }
+
+    // Hand this file to the bootstrap snapshotter if its history has grown
+    // since the last snapshot, and no snapshot is in progress.
+    void schedule_bootstrap_snapshot();
+
+    // Install the snapshot produced after a call to
+    // schedule_bootstrap_snapshot(). A snapshot with a null body leaves the
+    // current one in place.
+    void set_bootstrap_snapshot(DownloadCache);
+
     void register_client_access(file_ident_type client_file_ident);
 
     using file_ident_request_type = std::int_fast64_t;
@@ -540,6 +670,11 @@ private:
     ServerImpl& m_server;
     ServerFileAccessCache::Slot m_file;
 
+    // The worker that integrates the changes of this file. A file is always
+    // handled by the same worker, so its work units are executed in order, and
+    // only one worker opens it.
+    Worker& m_worker;
+
     // In general, `m_version_info` refers to the last snapshot of the Realm
     // file that is supposed to be visible to remote peers engaging in regular
     // Realm file synchronization.
@@ -639,7 +774,7 @@ private:
     // (group_postprocess_stage_3()). Always zero for partial files.
     bool m_has_work_in_progress = 0;
 
-    // This one must only be accessed by the worker thread.
+    // This one must only be accessed by the thread of `m_worker`.
     //
     // More specifically, `m_worker_file.access()` must only be called by the
     // worker thread, and if it was ever called, it must be closed by the worker
@@ -647,10 +782,16 @@ private:
     // before the destruction of the server object itself.
     ServerFileAccessCache::Slot m_worker_file;
 
+    // This one must only be accessed by the bootstrap snapshotter thread.
+    ServerFileAccessCache::Slot m_snapshotter_file;
+
     std::vector<std::int_fast64_t> m_deleting_connections;
 
     DownloadCache m_download_cache;
 
+    DownloadCache m_bootstrap_snapshot;
+    bool m_bootstrap_snapshot_in_progress = false;
+
     void on_changesets_from_downstream_added(std::size_t num_changesets, std::size_t num_bytes);
     void on_work_added();
     void group_unblock_work();
@@ -695,11 +836,16 @@ inline void ServerFile::group_finalize_work_stage_2()
 // ============================ Worker ============================
 
 // All write transaction on server-side Realm files performed on behalf of the
-// server, must be performed by the worker thread, not the network event loop
+// server, must be performed by a worker thread, not the network event loop
 // thread. This is to ensure that the network event loop thread never gets
 // blocked waiting for the worker thread to end a long running write
 // transaction.
 //
+// The server runs Server::Config::num_integration_workers workers, each with
+// its own thread and cache of open files. Every ServerFile is assigned to one
+// worker when it is created, so different files are integrated concurrently,
+// while the work units of a file are executed in order by the same thread.
+//
 // FIXME: Currently, the event loop thread does perform a number of write
 // transactions, but only on subtier nodes of a star topology server cluster.
 class Worker : public ServerHistory::Context {
@@ -707,7 +853,7 @@ public:
     std::shared_ptr<util::Logger> logger_ptr;
     util::Logger& logger;
 
-    explicit Worker(ServerImpl&);
+    Worker(ServerImpl&, std::size_t index, std::size_t num_workers);
 
     ServerFileAccessCache& get_file_access_cache() noexcept;
 
@@ -743,6 +889,60 @@ inline ServerFileAccessCache& Worker::get_file_access_cache() noexcept
 }
 
 
+// ============================ BootstrapSnapshotter ============================
+
+// Produces bootstrap snapshots on a background thread. A bootstrap snapshot of
+// a file is a single compacted DOWNLOAD message body that takes a client from
+// scratch to a particular server version. Clients that bootstrap from scratch
+// are served the latest snapshot, followed by the tail of the history, rather
+// than having the entire history fetched, compacted, and compressed on the
+// network event loop thread on their behalf.
+class BootstrapSnapshotter : public ServerHistory::Context {
+public:
+    std::shared_ptr<util::Logger> logger_ptr;
+    util::Logger& logger;
+
+    explicit BootstrapSnapshotter(ServerImpl&);
+
+    ServerFileAccessCache& get_file_access_cache() noexcept
+    {
+        return m_file_access_cache;
+    }
+
+    void enqueue(ServerFile*, version_type end_version);
+
+    // Overriding members of ServerHistory::Context
+    std::mt19937_64& server_history_get_random() noexcept override final;
+
+private:
+    struct Job {
+        ServerFile* file;
+        version_type end_version;
+    };
+
+    ServerImpl& m_server;
+    std::mt19937_64 m_random;
+    ServerFileAccessCache m_file_access_cache;
+    ServerProtocol m_server_protocol;
+    compression::CompressMemoryArena m_compress_memory_arena;
+    OutputBuffer m_body;
+    std::vector<char> m_compress_buffer;
+
+    util::Mutex m_mutex;
+    util::CondVar m_cond; // Protected by `m_mutex`
+
+    bool m_stop = false; // Protected by `m_mutex`
+
+    util::CircularBuffer<Job> m_queue; // Protected by `m_mutex`
+
+    void run();
+    void stop() noexcept;
+    void produce_snapshot(ServerFile&, version_type end_version);
+
+    friend class util::ThreadExecGuardWithParent<BootstrapSnapshotter, ServerImpl>;
+};
+
+
 // ============================ ServerImpl ============================
 
 class ServerImpl : public ServerImplBase, public ServerHistory::Context {
@@ -817,6 +1017,11 @@ public:
         return m_misc_buffers;
     }
 
+    SharedDownloadCache& get_shared_download_cache() noexcept
+    {
+        return m_shared_download_cache;
+    }
+
     int_fast64_t get_current_server_session_ident() const noexcept
     {
         return m_current_server_session_ident;
@@ -827,9 +1032,17 @@ public:
         return m_scratch_memory;
     }
 
-    Worker& get_worker() noexcept
+    // Pick the worker for a new file, in round-robin order
+    BootstrapSnapshotter& get_bootstrap_snapshotter() noexcept
     {
-        return m_worker;
+        return m_bootstrap_snapshotter;
+    }
+
+    Worker& assign_worker() noexcept
+    {
+        std::size_t index = m_next_worker;
+        m_next_worker = (m_next_worker + 1) % m_workers.size();
+        return *m_workers[index];
     }
 
     void get_workunit_timers(milliseconds_type& parallel_section, milliseconds_type& sequential_section)
@@ -838,6 +1051,14 @@ public:
         sequential_section = m_seq_time;
     }
 
+    ServerFileAccessCache::Stats get_file_access_cache_stats() const noexcept
+    {
+        ServerFileAccessCache::Stats stats = m_file_access_cache.get_stats();
+        for (const auto& worker : m_workers)
+            stats += worker->get_file_access_cache().get_stats();
+        return stats;
+    }
+
     ServerImpl(const std::string& root_dir, util::Optional<sync::PKey>, Server::Config);
     ~ServerImpl() noexcept;
 
@@ -900,8 +1121,8 @@ public:
         m_realm_names.insert(virt_path);         // Throws
         {
             bool disable_sync_to_disk = m_config.disable_sync_to_disk;
-            file.reset(new ServerFile(*this, m_file_access_cache, virt_path, virt_path_components.real_realm_path,
-                                      disable_sync_to_disk)); // Throws
+            file.reset(new ServerFile(*this, m_file_access_cache, assign_worker(), virt_path,
+                                      virt_path_components.real_realm_path, disable_sync_to_disk)); // Throws
         }
 
         file->initialize();
@@ -998,7 +1219,9 @@ private:
 
     std::unique_ptr<network::ssl::Context> m_ssl_context;
     ServerFileAccessCache m_file_access_cache;
-    Worker m_worker;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::size_t m_next_worker = 0;
+    BootstrapSnapshotter m_bootstrap_snapshotter;
     std::map<std::string, util::bind_ptr<ServerFile>> m_files; // Key is virtual path
     network::Acceptor m_acceptor;
     std::int_fast64_t m_next_conn_id = 0;
@@ -1009,8 +1232,10 @@ private:
     ServerProtocol m_server_protocol;
     compression::CompressMemoryArena m_compress_memory_arena;
     MiscBuffers m_misc_buffers;
+    SharedDownloadCache m_shared_download_cache;
     int_fast64_t m_current_server_session_ident;
     Optional<network::DeadlineTimer> m_connection_reaper_timer;
+    Optional<network::DeadlineTimer> m_bootstrap_snapshot_timer;
     bool m_allow_load_balancing = false;
 
     util::Mutex m_mutex;
@@ -1035,6 +1260,7 @@ private:
 
     void reap_connections();
     void initiate_connection_reaper_timer(milliseconds_type timeout);
+    void initiate_bootstrap_snapshot_timer(milliseconds_type interval);
     void do_close_connections();
 
     static std::size_t determine_max_upload_backlog(Server::Config& config) noexcept
@@ -2309,6 +2535,9 @@ public:
 
         m_server_file->add_unidentified_session(this); // Throws
 
+        if (server.get_config().prefetch_files_on_bind)
+            m_server_file->prefetch();
+
         logger.info("Client info: (path='%1', from=%2, protocol=%3) %4", path, m_connection.get_remote_endpoint(),
                     m_connection.get_client_protocol_version(),
                     m_connection.get_client_user_agent()); // Throws
@@ -2886,10 +3115,46 @@ private:
             std::size_t accum_compacted_size;
             ServerProtocol& protocol = get_server_protocol();
             bool disable_download_compaction = config.disable_download_compaction;
-            bool enable_cache = (config.enable_download_bootstrap_cache && m_download_progress.server_version == 0 &&
-                                 m_upload_progress.client_version == 0 && m_upload_threshold.client_version == 0);
+            bool is_bootstrapping = (m_download_progress.server_version == 0 && m_upload_progress.client_version == 0 &&
+                                     m_upload_threshold.client_version == 0);
+            bool enable_cache = (config.enable_download_bootstrap_cache && is_bootstrapping);
+            auto dictionary = _impl::get_message_compression_dictionary(m_connection.get_client_protocol_version());
+            bool use_dictionary = dictionary.size() != 0;
             DownloadCache& cache = m_server_file->get_download_cache();
-            bool fetch_from_cache = (enable_cache && cache.body && end_version == cache.end_version);
+            bool fetch_from_cache = (enable_cache && cache.body && end_version == cache.end_version &&
+                                     cache.body_uses_dictionary == use_dictionary);
+            // The bootstrap snapshot may end before `end_version`, in which
+            // case the remaining part of the history is sent in subsequent
+            // DOWNLOAD messages.
+            const DownloadCache& snapshot = m_server_file->get_bootstrap_snapshot();
+            bool fetch_from_snapshot = (!fetch_from_cache && is_bootstrapping && snapshot.body &&
+                                        snapshot.end_version <= end_version &&
+                                        snapshot.body_uses_dictionary == use_dictionary);
+            SharedDownloadCache& shared_cache = server.get_shared_download_cache();
+            bool use_shared_cache = (!enable_cache && !fetch_from_snapshot && shared_cache.is_enabled());
+            SharedDownloadCache::Key shared_cache_key;
+            const DownloadCache* shared_entry = nullptr;
+            if (use_shared_cache) {
+                shared_cache_key = {m_server_file->get_virt_path(), m_download_progress, end_version,
+                                    last_server_version.salt, use_dictionary}; // Throws
+                shared_entry = shared_cache.find(shared_cache_key);
+                if (shared_entry) {
+                    // A shared body omits nothing that this client needs only
+                    // if none of the changesets in the range originate from
+                    // this client, i.e., if no changesets from this client
+                    // have been integrated after the beginning of the range.
+                    if (REALM_UNLIKELY(!history.get_upload_progress(m_client_file_ident, upload_progress))) {
+                        logger.debug("History scanning failed: Client file entry "
+                                     "expired during session"); // Throws
+                        get_connection().protocol_error(ProtocolError::client_file_expired, this);
+                        // Session object may have been destroyed at this point
+                        // (suicide).
+                        return;
+                    }
+                    if (upload_progress.client_version != m_download_progress.last_integrated_client_version)
+                        shared_entry = nullptr;
+                }
+            }
             if (fetch_from_cache) {
                 body = cache.body.get();
                 uncompressed_body_size = cache.uncompressed_body_size;
@@ -2901,6 +3166,32 @@ private:
                 accum_original_size = cache.accum_original_size;
                 accum_compacted_size = cache.accum_compacted_size;
             }
+            else if (fetch_from_snapshot) {
+                body = snapshot.body.get();
+                uncompressed_body_size = snapshot.uncompressed_body_size;
+                compressed_body_size = snapshot.compressed_body_size;
+                body_is_compressed = snapshot.body_is_compressed;
+                download_progress = snapshot.download_progress;
+                downloadable_bytes = snapshot.downloadable_bytes;
+                num_changesets = snapshot.num_changesets;
+                accum_original_size = snapshot.accum_original_size;
+                accum_compacted_size = snapshot.accum_compacted_size;
+                logger.debug("Serving bootstrap snapshot (end_version=%1, latest_server_version=%2)",
+                             snapshot.end_version, end_version); // Throws
+            }
+            else if (shared_entry) {
+                body = shared_entry->body.get();
+                uncompressed_body_size = shared_entry->uncompressed_body_size;
+                compressed_body_size = shared_entry->compressed_body_size;
+                body_is_compressed = shared_entry->body_is_compressed;
+                download_progress = shared_entry->download_progress;
+                downloadable_bytes = shared_entry->downloadable_bytes;
+                num_changesets = shared_entry->num_changesets;
+                accum_original_size = shared_entry->accum_original_size;
+                accum_compacted_size = shared_entry->accum_compacted_size;
+                logger.debug("Reusing DOWNLOAD body from shared cache (server_version=%1, end_version=%2)",
+                             m_download_progress.server_version, end_version); // Throws
+            }
             else {
                 // Discard the old cached DOWNLOAD body before generating a new
                 // one to be cached. This can make a big difference because the
@@ -2939,7 +3230,7 @@ private:
                     if (uncompressed.size() > max_uncompressed) {
                         compression::CompressMemoryArena& arena = server.get_compress_memory_arena();
                         std::vector<char>& buffer = server.get_misc_buffers().compress;
-                        compression::allocate_and_compress(arena, uncompressed, buffer); // Throws
+                        compression::allocate_and_compress(arena, uncompressed, buffer, dictionary); // Throws
                         if (buffer.size() < uncompressed.size()) {
                             body = buffer.data();
                             compressed_body_size = buffer.size();
@@ -2965,6 +3256,7 @@ private:
                     cache.uncompressed_body_size = uncompressed_body_size;
                     cache.compressed_body_size = compressed_body_size;
                     cache.body_is_compressed = body_is_compressed;
+                    cache.body_uses_dictionary = use_dictionary;
                     cache.end_version = end_version;
                     cache.download_progress = download_progress;
                     cache.downloadable_bytes = downloadable_bytes;
@@ -2979,6 +3271,26 @@ private:
                         // (suicide).
                         return;
                     }
+                    bool shareable = (use_shared_cache && num_changesets != 0 &&
+                                      upload_progress.client_version ==
+                                          m_download_progress.last_integrated_client_version);
+                    if (shareable) {
+                        DownloadCache entry;
+                        std::size_t body_size = (body_is_compressed ? compressed_body_size : uncompressed_body_size);
+                        entry.body = std::make_unique<char[]>(body_size); // Throws
+                        std::copy(body, body + body_size, entry.body.get());
+                        entry.uncompressed_body_size = uncompressed_body_size;
+                        entry.compressed_body_size = compressed_body_size;
+                        entry.body_is_compressed = body_is_compressed;
+                        entry.body_uses_dictionary = use_dictionary;
+                        entry.end_version = end_version;
+                        entry.download_progress = download_progress;
+                        entry.downloadable_bytes = downloadable_bytes;
+                        entry.num_changesets = num_changesets;
+                        entry.accum_original_size = accum_original_size;
+                        entry.accum_compacted_size = accum_compacted_size;
+                        shared_cache.insert(shared_cache_key, std::move(entry)); // Throws
+                    }
                 }
             }
 
@@ -3210,13 +3522,16 @@ void SessionQueue::clear() noexcept
 
 // ============================ ServerFile implementation ============================
 
-ServerFile::ServerFile(ServerImpl& server, ServerFileAccessCache& cache, const std::string& virt_path,
+ServerFile::ServerFile(ServerImpl& server, ServerFileAccessCache& cache, Worker& worker, const std::string& virt_path,
                        std::string real_path, bool disable_sync_to_disk)
-    : logger{util::LogCategory::server, "ServerFile[" + virt_path + "]: ", server.logger_ptr}               // Throws
-    , wlogger{util::LogCategory::server, "ServerFile[" + virt_path + "]: ", server.get_worker().logger_ptr} // Throws
+    : logger{util::LogCategory::server, "ServerFile[" + virt_path + "]: ", server.logger_ptr}  // Throws
+    , wlogger{util::LogCategory::server, "ServerFile[" + virt_path + "]: ", worker.logger_ptr} // Throws
     , m_server{server}
     , m_file{cache, real_path, virt_path, false, disable_sync_to_disk} // Throws
-    , m_worker_file{server.get_worker().get_file_access_cache(), real_path, virt_path, true, disable_sync_to_disk}
+    , m_worker{worker}
+    , m_worker_file{worker.get_file_access_cache(), real_path, virt_path, true, disable_sync_to_disk}
+    , m_snapshotter_file{server.get_bootstrap_snapshotter().get_file_access_cache(), real_path, virt_path, false,
+                         disable_sync_to_disk}
 {
 }
 
@@ -3444,6 +3759,31 @@ void ServerFile::worker_process_work_unit(WorkerState& state)
 }
 
 
+void ServerFile::schedule_bootstrap_snapshot()
+{
+    if (m_bootstrap_snapshot_in_progress)
+        return;
+    version_type end_version = get_sync_version();
+    version_type snapshot_version = (m_bootstrap_snapshot.body ? m_bootstrap_snapshot.end_version : 0);
+    if (end_version <= snapshot_version)
+        return;
+    m_server.get_bootstrap_snapshotter().enqueue(this, end_version); // Throws
+    m_bootstrap_snapshot_in_progress = true;
+}
+
+
+void ServerFile::set_bootstrap_snapshot(DownloadCache snapshot)
+{
+    REALM_ASSERT(m_bootstrap_snapshot_in_progress);
+    m_bootstrap_snapshot_in_progress = false;
+    if (snapshot.body) {
+        logger.detail("New bootstrap snapshot (end_version=%1, num_changesets=%2)", snapshot.end_version,
+                      snapshot.num_changesets); // Throws
+        m_bootstrap_snapshot = std::move(snapshot);
+    }
+}
+
+
 void ServerFile::on_changesets_from_downstream_added(std::size_t num_changesets, std::size_t num_bytes)
 {
     m_num_changesets_from_downstream += num_changesets;
@@ -3478,8 +3818,7 @@ void ServerFile::group_unblock_work()
         if (REALM_LIKELY(work.has_primary_work)) {
             logger.trace("Work unit unblocked"); // Throws
             m_has_work_in_progress = true;
-            Worker& worker = m_server.get_worker();
-            worker.enqueue(this); // Throws
+            m_worker.enqueue(this); // Throws
         }
     }
 }
@@ -3747,12 +4086,15 @@ void ServerFile::finalize_work_stage_2()
 
 // ============================ Worker implementation ============================
 
-Worker::Worker(ServerImpl& server)
-    : logger_ptr{std::make_shared<util::PrefixLogger>(util::LogCategory::server, "Worker: ", server.logger_ptr)}
+Worker::Worker(ServerImpl& server, std::size_t index, std::size_t num_workers)
+    : logger_ptr{std::make_shared<util::PrefixLogger>(
+          util::LogCategory::server, (num_workers == 1 ? "Worker: " : util::format("Worker[%1]: ", index)),
+          server.logger_ptr)}
     // Throws
     , logger(*logger_ptr)
     , m_server{server}
-    , m_file_access_cache{server.get_config().max_open_files, logger, *this, server.get_config().encryption_key}
+    , m_file_access_cache{server.get_config().max_open_files, logger, *this, server.get_config().encryption_key,
+                          server.get_config().max_open_files_size} // Throws
 {
     util::seed_prng_nondeterministically(m_random); // Throws
 }
@@ -3802,6 +4144,127 @@ void Worker::stop() noexcept
 }
 
 
+// ============================ BootstrapSnapshotter implementation ============================
+
+BootstrapSnapshotter::BootstrapSnapshotter(ServerImpl& server)
+    : logger_ptr{std::make_shared<util::PrefixLogger>(util::LogCategory::server, "Snapshotter: ",
+                                                       server.logger_ptr)} // Throws
+    , logger(*logger_ptr)
+    , m_server{server}
+    , m_file_access_cache{1, logger, *this, server.get_config().encryption_key} // Throws
+{
+    util::seed_prng_nondeterministically(m_random); // Throws
+}
+
+
+void BootstrapSnapshotter::enqueue(ServerFile* file, version_type end_version)
+{
+    util::LockGuard lock{m_mutex};
+    m_queue.push_back(Job{file, end_version}); // Throws
+    m_cond.notify_all();
+}
+
+
+std::mt19937_64& BootstrapSnapshotter::server_history_get_random() noexcept
+{
+    return m_random;
+}
+
+
+void BootstrapSnapshotter::run()
+{
+    for (;;) {
+        Job job;
+        {
+            util::LockGuard lock{m_mutex};
+            for (;;) {
+                if (REALM_UNLIKELY(m_stop))
+                    return;
+                if (!m_queue.empty()) {
+                    job = m_queue.front();
+                    m_queue.pop_front();
+                    break;
+                }
+                m_cond.wait(lock);
+            }
+        }
+        produce_snapshot(*job.file, job.end_version); // Throws
+    }
+}
+
+
+void BootstrapSnapshotter::stop() noexcept
+{
+    util::LockGuard lock{m_mutex};
+    m_stop = true;
+    m_cond.notify_all();
+}
+
+
+void BootstrapSnapshotter::produce_snapshot(ServerFile& file, version_type end_version)
+{
+    const Server::Config& config = m_server.get_config();
+    int protocol_version = m_server.get_protocol_version_range().second;
+    auto dictionary = _impl::get_message_compression_dictionary(protocol_version);
+
+    DownloadCache snapshot;
+    {
+        const ServerHistory& history = file.snapshotter_access().history; // Throws
+        m_body.reset();
+        DownloadHistoryEntryHandler handler{m_server_protocol, m_body, logger};
+        DownloadCursor download_progress = {0, 0};
+        std::uint_fast64_t cumulative_byte_size_current;
+        std::uint_fast64_t cumulative_byte_size_total;
+        bool good = history.fetch_bootstrap_download_info(download_progress, end_version, handler,
+                                                          cumulative_byte_size_current, cumulative_byte_size_total,
+                                                          config.disable_download_compaction); // Throws
+        if (good) {
+            BinaryData uncompressed = {m_body.data(), m_body.size()};
+            const char* body = uncompressed.data();
+            std::size_t body_size = uncompressed.size();
+            snapshot.body_is_compressed = false;
+            snapshot.compressed_body_size = 0;
+            std::size_t max_uncompressed = 1024;
+            if (uncompressed.size() > max_uncompressed) {
+                compression::allocate_and_compress(m_compress_memory_arena, uncompressed, m_compress_buffer,
+                                                   dictionary); // Throws
+                if (m_compress_buffer.size() < uncompressed.size()) {
+                    body = m_compress_buffer.data();
+                    body_size = m_compress_buffer.size();
+                    snapshot.body_is_compressed = true;
+                    snapshot.compressed_body_size = body_size;
+                }
+            }
+            snapshot.body = std::make_unique<char[]>(body_size); // Throws
+            std::copy(body, body + body_size, snapshot.body.get());
+            snapshot.uncompressed_body_size = uncompressed.size();
+            snapshot.body_uses_dictionary = (dictionary.size() != 0);
+            snapshot.end_version = end_version;
+            snapshot.download_progress = download_progress;
+            snapshot.downloadable_bytes = cumulative_byte_size_total - cumulative_byte_size_current;
+            snapshot.num_changesets = handler.num_changesets;
+            snapshot.accum_original_size = handler.accum_original_size;
+            snapshot.accum_compacted_size = handler.accum_compacted_size;
+        }
+        else {
+            logger.detail("Skipping bootstrap snapshot of '%1': History does not start at version zero",
+                          file.get_virt_path()); // Throws
+        }
+    }
+
+    // Pass control back to the network event loop thread
+    network::Service& service = m_server.get_service();
+    service.post([&file, snapshot = std::move(snapshot)](Status status) mutable {
+        if (status == ErrorCodes::OperationAborted)
+            return;
+        // FIXME: The safety of capturing `file` here, relies on the fact that
+        // ServerFile objects currently are not destroyed until the server
+        // object is destroyed.
+        file.set_bootstrap_snapshot(std::move(snapshot)); // Throws
+    }); // Throws
+}
+
+
 // ============================ ServerImpl implementation ============================
 
 ServerImpl::ServerImpl(const std::string& root_dir, util::Optional<sync::PKey> pkey, Server::Config config)
@@ -3812,12 +4275,21 @@ ServerImpl::ServerImpl(const std::string& root_dir, util::Optional<sync::PKey> p
     , m_root_dir{root_dir} // Throws
     , m_access_control{std::move(pkey)}
     , m_protocol_version_range{determine_protocol_version_range(config)}                 // Throws
-    , m_file_access_cache{m_config.max_open_files, logger, *this, config.encryption_key} // Throws
-    , m_worker{*this}                                                                    // Throws
+    , m_file_access_cache{m_config.max_open_files, logger, *this, config.encryption_key,
+                          m_config.max_open_files_size} // Throws
+    , m_bootstrap_snapshotter{*this}                    // Throws
     , m_acceptor{get_service()}
     , m_server_protocol{}       // Throws
     , m_compress_memory_arena{} // Throws
+    , m_shared_download_cache{m_config.shared_download_cache_max_size}
 {
+    std::size_t num_workers = m_config.num_integration_workers;
+    if (num_workers == 0)
+        num_workers = std::max(std::thread::hardware_concurrency(), 1U);
+    m_workers.reserve(num_workers); // Throws
+    for (std::size_t i = 0; i < num_workers; ++i)
+        m_workers.push_back(std::make_unique<Worker>(*this, i, num_workers)); // Throws
+
     if (m_config.ssl) {
         m_ssl_context = std::make_unique<network::ssl::Context>();                // Throws
         m_ssl_context->use_certificate_chain_file(m_config.ssl_certificate_path); // Throws
@@ -3860,6 +4332,9 @@ void ServerImpl::start()
     }
     logger.info("Directory holding persistent state: %1", m_root_dir);        // Throws
     logger.info("Maximum number of open files: %1", m_config.max_open_files); // Throws
+    logger.info("Maximum size of open files: %1 bytes", m_config.max_open_files_size); // Throws
+    logger.info("Prefetch files on BIND: %1", (m_config.prefetch_files_on_bind ? "Yes" : "No")); // Throws
+    logger.info("Integration workers: %1", m_workers.size());                 // Throws
     {
         const char* lead_text = "Encryption";
         if (m_config.encryption_key) {
@@ -3888,6 +4363,8 @@ void ServerImpl::start()
     logger.info("Download bootstrap caching: %1",
                 (m_config.enable_download_bootstrap_cache ? "Yes" : "No"));                // Throws
     logger.info("Max download size: %1 bytes", m_config.max_download_size);                // Throws
+    logger.info("Bootstrap snapshot interval: %1 ms", m_config.bootstrap_snapshot_interval); // Throws
+    logger.info("Shared download cache size: %1 bytes", m_config.shared_download_cache_max_size); // Throws
     logger.info("Max upload backlog: %1 bytes", m_max_upload_backlog);                     // Throws
     logger.info("HTTP request timeout: %1 ms", m_config.http_request_timeout);             // Throws
     logger.info("HTTP response timeout: %1 ms", m_config.http_response_timeout);           // Throws
@@ -3900,6 +4377,9 @@ void ServerImpl::start()
 
     initiate_connection_reaper_timer(m_config.connection_reaper_interval); // Throws
 
+    if (m_config.bootstrap_snapshot_interval > 0)
+        initiate_bootstrap_snapshot_timer(m_config.bootstrap_snapshot_interval); // Throws
+
     listen(); // Throws
 }
 
@@ -3909,19 +4389,43 @@ void ServerImpl::run()
     auto ta = util::make_temp_assign(m_running, true);
 
     {
-        auto worker_thread = util::make_thread_exec_guard(m_worker, *this); // Throws
+        using WorkerThread = util::ThreadExecGuardWithParent<Worker, ServerImpl>;
+        std::vector<WorkerThread> worker_threads;
+        worker_threads.reserve(m_workers.size()); // Throws
         std::string name;
-        if (util::Thread::get_name(name)) {
-            name += "-worker";
-            worker_thread.start_with_signals_blocked(name); // Throws
+        bool has_name = util::Thread::get_name(name);
+        for (std::size_t i = 0; i < m_workers.size(); ++i) {
+            WorkerThread& worker_thread =
+                worker_threads.emplace_back(util::make_thread_exec_guard(*m_workers[i], *this)); // Throws
+            if (has_name) {
+                std::string worker_name = name + "-worker";
+                if (m_workers.size() > 1)
+                    worker_name += "-" + std::to_string(i);
+                worker_thread.start_with_signals_blocked(worker_name); // Throws
+            }
+            else {
+                worker_thread.start_with_signals_blocked(); // Throws
+            }
         }
-        else {
-            worker_thread.start_with_signals_blocked(); // Throws
+
+        using SnapshotterThread = util::ThreadExecGuardWithParent<BootstrapSnapshotter, ServerImpl>;
+        util::Optional<SnapshotterThread> snapshotter_thread;
+        if (m_config.bootstrap_snapshot_interval > 0) {
+            snapshotter_thread.emplace(util::make_thread_exec_guard(m_bootstrap_snapshotter, *this)); // Throws
+            if (has_name) {
+                snapshotter_thread->start_with_signals_blocked(name + "-snapshotter"); // Throws
+            }
+            else {
+                snapshotter_thread->start_with_signals_blocked(); // Throws
+            }
         }
 
         m_service.run(); // Throws
 
-        worker_thread.stop_and_rethrow(); // Throws
+        for (WorkerThread& worker_thread : worker_threads)
+            worker_thread.stop_and_rethrow(); // Throws
+        if (snapshotter_thread)
+            snapshotter_thread->stop_and_rethrow(); // Throws
     }
 
     logger.info("Realm sync server stopped");
@@ -4139,6 +4643,19 @@ void ServerImpl::initiate_connection_reaper_timer(milliseconds_type timeout)
 }
 
 
+void ServerImpl::initiate_bootstrap_snapshot_timer(milliseconds_type interval)
+{
+    m_bootstrap_snapshot_timer.emplace(get_service());
+    m_bootstrap_snapshot_timer->async_wait(std::chrono::milliseconds(interval), [this, interval](Status status) {
+        if (status != ErrorCodes::OperationAborted) {
+            for (auto& pair : m_files)
+                pair.second->schedule_bootstrap_snapshot(); // Throws
+            initiate_bootstrap_snapshot_timer(interval);    // Throws
+        }
+    }); // Throws
+}
+
+
 void ServerImpl::reap_connections()
 {
     logger.debug("Discarding dead connections"); // Throws
@@ -4867,3 +5384,9 @@ void Server::get_workunit_timers(milliseconds_type& parallel_section, millisecon
 {
     m_impl->get_workunit_timers(parallel_section, sequential_section);
 }
+
+
+auto Server::get_file_access_cache_stats() const noexcept -> _impl::ServerFileAccessCache::Stats
+{
+    return m_impl->get_file_access_cache_stats();
+}
@@ -14,6 +14,7 @@
 #include <realm/sync/network/network.hpp>
 #include <realm/sync/noinst/server/clock.hpp>
 #include <realm/sync/noinst/server/crypto_server.hpp>
+#include <realm/sync/noinst/server/server_file_access_cache.hpp>
 #include <realm/sync/client.hpp>
 
 namespace realm {
@@ -71,11 +72,33 @@ public:
 
         /// The maximum number of Realm files that will be kept open
         /// concurrently by each major thread inside the server. The server
-        /// currently has two major threads (foreground and background). The
-        /// server keeps a cache of open Realm files for efficiency reasons (one
-        /// for each major thread).
+        /// has one foreground thread, and one background thread per
+        /// integration worker (see `num_integration_workers`). The server
+        /// keeps a cache of open Realm files for efficiency reasons (one for
+        /// each major thread).
         long max_open_files = 256;
 
+        /// If nonzero, each cache of open Realm files (see `max_open_files`)
+        /// also closes its least recently used files while their accumulated
+        /// size exceeds this number of bytes. This way, the number of files
+        /// that are kept open adapts to their size, and the amount of memory
+        /// that is mapped by each cache stays bounded.
+        std::uint_fast64_t max_open_files_size = 0;
+
+        /// If set to true, the server starts opening the Realm file of a
+        /// session on a background thread as soon as the BIND message is
+        /// received, rather than when it is first needed, which takes the
+        /// cost of opening the file off the critical path of the session
+        /// handshake. This applies to the cache of open Realm files of the
+        /// foreground thread.
+        bool prefetch_files_on_bind = false;
+
+        /// The number of background threads that integrate changesets
+        /// uploaded by clients. Each Realm file is assigned to one of them, so
+        /// the changes of a file are integrated in order, while different files
+        /// are integrated concurrently. Zero means one per hardware thread.
+        std::size_t num_integration_workers = 1;
+
         /// An optional custom clock to be used for token expiration checks. If
         /// no clock is specified, the server will use the system clock.
         Clock* token_expiration_clock = nullptr;
@@ -179,6 +202,24 @@ public:
         /// for the need to resend the same changes after network disconnects.
         std::size_t max_download_size = 0x1000000; // 16 MiB
 
+        /// The maximum accumulated size in bytes of the DOWNLOAD message
+        /// bodies kept in a cache that is shared by all sessions. When several
+        /// clients of the same file download the same range of the history,
+        /// the body is only fetched, encoded, and compressed for the first of
+        /// them. Zero disables the cache.
+        std::size_t shared_download_cache_max_size = 0;
+
+        /// If nonzero, a background thread produces a bootstrap snapshot of
+        /// each Realm file whose history has grown since its last snapshot,
+        /// with this interval in milliseconds. A bootstrap snapshot is a
+        /// compacted and compressed DOWNLOAD message body that takes a client
+        /// from scratch to the server version at which it was produced.
+        /// Clients that bootstrap from scratch are served the latest snapshot
+        /// followed by the remaining tail of the history. This keeps the
+        /// expensive compaction of big histories off the network event loop
+        /// thread, and out of the critical path of bootstrapping clients.
+        milliseconds_type bootstrap_snapshot_interval = 0;
+
         /// The maximum number of connections that can be queued up waiting to
         /// be accepted by the server. This corresponds to the `backlog`
         /// argument of the `listen()` function as described by POSIX.
@@ -355,6 +396,14 @@ public:
     /// of the server.
     void get_workunit_timers(milliseconds_type& parallel_section, milliseconds_type& sequential_section);
 
+    /// Get the accumulated access counters of the caches of open Realm files
+    /// (see Config::max_open_files). The hit rate is `hits / (hits +
+    /// misses)`.
+    ///
+    /// This function is fully thread-safe and may be called at any time during
+    /// the life of the server object.
+    _impl::ServerFileAccessCache::Stats get_file_access_cache_stats() const noexcept;
+
 private:
     class Implementation;
     std::unique_ptr<Implementation> m_impl;
@@ -15,6 +15,7 @@ void ServerFileAccessCache::access(Slot& slot)
 {
     if (slot.is_open()) {
         m_logger.trace(util::LogCategory::server, "Using already open Realm file: %1", slot.realm_path); // Throws
+        increment(m_num_hits);
 
         // Move to front
         REALM_ASSERT(m_first_open_file);
@@ -25,17 +26,32 @@ void ServerFileAccessCache::access(Slot& slot)
         }
         return;
     }
+    increment(m_num_misses);
 
     // Close least recently accessed Realm file
-    if (m_num_open_files == m_max_open_files) {
-        REALM_ASSERT(m_first_open_file);
-        Slot& least_recently_accessed = *m_first_open_file->m_prev_open_file;
-        least_recently_accessed.proper_close(); // Throws
-    }
+    if (m_num_open_files == m_max_open_files)
+        evict_least_recently_accessed(); // Throws
 
     slot.open(); // Throws
+
+    // Close further Realm files while the open ones take up too much space,
+    // but never the one that was just opened
+    if (m_max_open_bytes != 0) {
+        while (m_num_open_bytes > m_max_open_bytes && m_num_open_files > 1)
+            evict_least_recently_accessed(); // Throws
+    }
 }
 
+
+void ServerFileAccessCache::evict_least_recently_accessed()
+{
+    REALM_ASSERT(m_first_open_file);
+    Slot& least_recently_accessed = *m_first_open_file->m_prev_open_file;
+    least_recently_accessed.proper_close(); // Throws
+    increment(m_num_evictions);
+}
+
+
 void ServerFileAccessCache::Slot::proper_close()
 {
     if (is_open()) {
@@ -45,15 +61,70 @@ void ServerFileAccessCache::Slot::proper_close()
 }
 
 
+bool ServerFileAccessCache::Slot::prefetch() noexcept
+{
+    if (is_open() || m_prefetched_file.valid() ||
+        m_cache.m_num_pending_prefetches >= ServerFileAccessCache::max_pending_prefetches)
+        return false;
+
+    try {
+        // The prefetching thread must not access the slot object, since it
+        // may be moved in the meantime.
+        auto open_file = [&history_context = m_cache.m_history_context, realm_path = realm_path,
+                          options = make_shared_group_options(), claim_sync_agent = m_claim_sync_agent] {
+            return std::unique_ptr<File>(new File{history_context, realm_path, options, claim_sync_agent}); // Throws
+        };
+        m_prefetched_file = std::async(std::launch::async, std::move(open_file)); // Throws
+    }
+    catch (const std::exception&) {
+        // Prefetching is only an optimization
+        return false;
+    }
+    ++m_cache.m_num_pending_prefetches;
+    return true;
+}
+
+
 void ServerFileAccessCache::Slot::open()
 {
     REALM_ASSERT(!is_open());
 
-    m_cache.m_logger.detail("Opening Realm file: %1", realm_path); // Throws
+    std::unique_ptr<File> file;
+    if (m_prefetched_file.valid()) {
+        --m_cache.m_num_pending_prefetches;
+        try {
+            file = m_prefetched_file.get(); // Throws
+        }
+        catch (const std::exception& e) {
+            // Try again below, and let that attempt report the error
+            m_cache.m_logger.detail("Failed to prefetch Realm file: %1: %2", realm_path, e.what()); // Throws
+        }
+        if (file) {
+            m_cache.m_logger.detail("Adopting prefetched Realm file: %1", realm_path); // Throws
+            increment(m_cache.m_num_prefetch_hits);
+        }
+    }
+    if (!file) {
+        m_cache.m_logger.detail("Opening Realm file: %1", realm_path); // Throws
 
-    m_file.reset(new File{*this}); // Throws
+        file.reset(new File{*this}); // Throws
+    }
+    m_file_size = file->m_size;
+    m_file = std::move(file);
 
     m_cache.insert(*this);
     m_cache.m_first_open_file = this;
     ++m_cache.m_num_open_files;
+    m_cache.m_num_open_bytes += m_file_size;
+}
+
+
+void ServerFileAccessCache::Slot::discard_prefetched_file() noexcept
+{
+    if (!m_prefetched_file.valid())
+        return;
+    --m_cache.m_num_pending_prefetches;
+    // Waits for the prefetching thread to complete. The prefetched file, or
+    // the exception, is discarded along with the shared state.
+    m_prefetched_file = {};
 }
@@ -2,12 +2,16 @@
 #ifndef REALM_NOINST_SERVER_FILE_ACCESS_CACHE_HPP
 #define REALM_NOINST_SERVER_FILE_ACCESS_CACHE_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <future>
 #include <utility>
 #include <memory>
 #include <string>
 #include <random>
 
 #include <realm/util/assert.hpp>
+#include <realm/util/file.hpp>
 #include <realm/util/logger.hpp>
 #include <realm/db.hpp>
 #include <realm/util/optional.hpp>
@@ -23,19 +27,52 @@ public:
     class Slot;
     class File;
 
+    struct Stats {
+        /// Number of accesses to a Realm file that was already open.
+        std::uint_fast64_t hits = 0;
+
+        /// Number of accesses that had to open the Realm file, including
+        /// those that found it opened ahead of time by Slot::prefetch().
+        std::uint_fast64_t misses = 0;
+
+        /// Number of misses for which the Realm file had been opened ahead of
+        /// time by Slot::prefetch().
+        std::uint_fast64_t prefetch_hits = 0;
+
+        /// Number of Realm files that were closed to make room for others.
+        std::uint_fast64_t evictions = 0;
+
+        Stats& operator+=(const Stats&) noexcept;
+    };
+
+    /// The maximum number of Realm files that Slot::prefetch() will open
+    /// concurrently.
+    static constexpr long max_pending_prefetches = 4;
+
     /// \param max_open_files The maximum number of Realm files to keep open
     /// concurrently. Must be greater than or equal to 1.
     ///
+    /// \param max_open_bytes If nonzero, the least recently accessed Realm
+    /// files are also closed while the accumulated size of the open files
+    /// exceeds this limit, such that fewer large files than small files are
+    /// kept open, which bounds the amount of memory that is mapped on behalf
+    /// of the cache. The most recently accessed file is never closed for this
+    /// reason. The size of a file is determined when it is opened.
+    ///
     /// The specified history context will not be accessed on behalf of this
     /// cache object before the first invocation of Slot::access() on an
     /// associated file file slot.
     ServerFileAccessCache(long max_open_files, util::Logger&, ServerHistory::Context&,
-                          util::Optional<std::array<char, 64>> encryption_key);
+                          util::Optional<std::array<char, 64>> encryption_key, std::uint_fast64_t max_open_bytes = 0);
 
     ~ServerFileAccessCache() noexcept;
 
     void proper_close_all();
 
+    /// Get a snapshot of the access counters. Unlike the other functions of
+    /// this class, this one may be called by any thread.
+    Stats get_stats() const noexcept;
+
 private:
     /// Null if `m_num_open_files == 0`, otherwise it points to the most
     /// recently accessed open Realm file. `m_first_open_file->m_next_open_file`
@@ -47,15 +84,31 @@ private:
     /// Current number of open Realm files.
     long m_num_open_files = 0;
 
+    /// Accumulated size of the open Realm files.
+    std::uint_fast64_t m_num_open_bytes = 0;
+
+    /// Number of slots with a prefetch in progress, or a prefetched file that
+    /// has not yet been adopted.
+    long m_num_pending_prefetches = 0;
+
     const long m_max_open_files;
+    const std::uint_fast64_t m_max_open_bytes;
     const util::Optional<std::array<char, 64>> m_encryption_key;
     // The ServerFileAccessCache is tied to the lifetime of the Server, so no shared_ptr needed
     util::Logger& m_logger;
     ServerHistory::Context& m_history_context;
 
+    std::atomic<std::uint_fast64_t> m_num_hits{0};
+    std::atomic<std::uint_fast64_t> m_num_misses{0};
+    std::atomic<std::uint_fast64_t> m_num_prefetch_hits{0};
+    std::atomic<std::uint_fast64_t> m_num_evictions{0};
+
     void access(Slot&);
+    void evict_least_recently_accessed();
     void remove(Slot&) noexcept;
     void insert(Slot&) noexcept;
+
+    static void increment(std::atomic<std::uint_fast64_t>&) noexcept;
 };
 
 
@@ -73,7 +126,9 @@ public:
 
     Slot(Slot&&) = default;
 
-    /// Closes the file if it is open (as if by calling close()).
+    /// Closes the file if it is open (as if by calling close()). If a
+    /// prefetch is in progress, this waits for it to complete, and then
+    /// closes the prefetched file.
     ~Slot() noexcept;
 
     /// Returns true if the associated Realm file is currently open.
@@ -89,6 +144,16 @@ public:
     /// objects of the same ServerFileAccessCache object to be closed.
     File& access();
 
+    /// Start opening the Realm file on a separate thread, such that a later
+    /// invocation of access() can adopt the already open file rather than
+    /// having to wait for it to be opened. This does nothing if the file is
+    /// already open, if a prefetch is already in progress for this slot, or
+    /// if the number of pending prefetches has reached
+    /// `max_pending_prefetches`.
+    ///
+    /// \return True if a prefetch was started.
+    bool prefetch() noexcept;
+
     /// Same as close() but also generates a log message. This function throws
     /// if logging throws.
     void proper_close();
@@ -107,8 +172,12 @@ private:
     Slot* m_next_open_file = nullptr;
 
     std::unique_ptr<File> m_file;
+    std::uint_fast64_t m_file_size = 0;
+
+    std::future<std::unique_ptr<File>> m_prefetched_file;
 
     void open();
+    void discard_prefetched_file() noexcept;
     void do_close() noexcept;
 
     friend class ServerFileAccessCache;
@@ -121,7 +190,10 @@ public:
     DBRef shared_group;
 
 private:
+    std::uint_fast64_t m_size;
+
     File(const Slot&);
+    File(ServerHistory::Context&, const std::string& realm_path, const DBOptions&, bool claim_sync_agent);
 
     friend class Slot;
 };
@@ -131,8 +203,10 @@ private:
 
 inline ServerFileAccessCache::ServerFileAccessCache(long max_open_files, util::Logger& logger,
                                                     ServerHistory::Context& history_context,
-                                                    util::Optional<std::array<char, 64>> encryption_key)
+                                                    util::Optional<std::array<char, 64>> encryption_key,
+                                                    std::uint_fast64_t max_open_bytes)
     : m_max_open_files{max_open_files}
+    , m_max_open_bytes{max_open_bytes}
     , m_encryption_key{encryption_key}
     , m_logger{logger}
     , m_history_context{history_context}
@@ -143,6 +217,32 @@ inline ServerFileAccessCache::ServerFileAccessCache(long max_open_files, util::L
 inline ServerFileAccessCache::~ServerFileAccessCache() noexcept
 {
     REALM_ASSERT(!m_first_open_file);
+    REALM_ASSERT(m_num_pending_prefetches == 0);
+}
+
+inline auto ServerFileAccessCache::get_stats() const noexcept -> Stats
+{
+    Stats stats;
+    stats.hits = m_num_hits.load(std::memory_order_relaxed);
+    stats.misses = m_num_misses.load(std::memory_order_relaxed);
+    stats.prefetch_hits = m_num_prefetch_hits.load(std::memory_order_relaxed);
+    stats.evictions = m_num_evictions.load(std::memory_order_relaxed);
+    return stats;
+}
+
+inline auto ServerFileAccessCache::Stats::operator+=(const Stats& other) noexcept -> Stats&
+{
+    hits += other.hits;
+    misses += other.misses;
+    prefetch_hits += other.prefetch_hits;
+    evictions += other.evictions;
+    return *this;
+}
+
+inline void ServerFileAccessCache::increment(std::atomic<std::uint_fast64_t>& counter) noexcept
+{
+    // Only the owning thread modifies the counters
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 }
 
 inline void ServerFileAccessCache::remove(Slot& slot) noexcept
@@ -195,6 +295,7 @@ inline ServerFileAccessCache::Slot::Slot(ServerFileAccessCache& cache, std::stri
 inline ServerFileAccessCache::Slot::~Slot() noexcept
 {
     close();
+    discard_prefetched_file();
 }
 
 inline bool ServerFileAccessCache::Slot::is_open() const noexcept
@@ -236,15 +337,24 @@ inline void ServerFileAccessCache::Slot::do_close() noexcept
 {
     REALM_ASSERT(is_open());
     --m_cache.m_num_open_files;
+    m_cache.m_num_open_bytes -= m_file_size;
     m_cache.remove(*this);
     m_file.reset();
 }
 
 inline ServerFileAccessCache::File::File(const Slot& slot)
-    : history{slot.m_cache.m_history_context}                                              // Throws
-    , shared_group{DB::create(history, slot.realm_path, slot.make_shared_group_options())} // Throws
+    : File{slot.m_cache.m_history_context, slot.realm_path, slot.make_shared_group_options(),
+           slot.m_claim_sync_agent} // Throws
+{
+}
+
+inline ServerFileAccessCache::File::File(ServerHistory::Context& history_context, const std::string& realm_path,
+                                         const DBOptions& options, bool claim_sync_agent)
+    : history{history_context}                                            // Throws
+    , shared_group{DB::create(history, realm_path, options)}              // Throws
+    , m_size{std::uint_fast64_t(util::File::get_size_static(realm_path))} // Throws
 {
-    if (slot.m_claim_sync_agent) {
+    if (claim_sync_agent) {
         shared_group->claim_sync_agent();
     }
 }
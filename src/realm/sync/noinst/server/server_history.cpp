@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cstring>
+#include <limits>
 #include <stack>
 
 #include <realm/sync/changeset_encoder.hpp>
@@ -813,6 +814,46 @@ bool ServerHistory::fetch_download_info(file_ident_type client_file_ident, Downl
             return false;
     }
 
+    fetch_changesets(client_file_ident, download_progress, end_version, handler, cumulative_byte_size_current,
+                     cumulative_byte_size_total, disable_download_compaction, accum_byte_size_soft_limit); // Throws
+
+    version_type upload_client_version = version_type(m_acc->cf_client_versions.get(client_file_index));
+    version_type upload_server_version = version_type(m_acc->cf_rh_base_versions.get(client_file_index));
+    upload_progress = UploadCursor{upload_client_version, upload_server_version};
+
+    return true;
+}
+
+
+bool ServerHistory::fetch_bootstrap_download_info(DownloadCursor& download_progress, version_type end_version,
+                                                  HistoryEntryHandler& handler,
+                                                  std::uint_fast64_t& cumulative_byte_size_current,
+                                                  std::uint_fast64_t& cumulative_byte_size_total,
+                                                  bool disable_download_compaction) const
+{
+    REALM_ASSERT(download_progress.server_version <= end_version);
+
+    TransactionRef tr = m_db->start_read(); // Throws
+    version_type realm_version = tr->get_version();
+    const_cast<ServerHistory*>(this)->set_group(tr.get());
+    ensure_updated(realm_version); // Throws
+
+    if (download_progress.server_version < m_history_base_version || end_version > get_server_version())
+        return false;
+
+    std::size_t accum_byte_size_soft_limit = std::numeric_limits<std::size_t>::max();
+    fetch_changesets(0, download_progress, end_version, handler, cumulative_byte_size_current,
+                     cumulative_byte_size_total, disable_download_compaction, accum_byte_size_soft_limit); // Throws
+    return true;
+}
+
+
+void ServerHistory::fetch_changesets(file_ident_type client_file_ident, DownloadCursor& download_progress,
+                                     version_type end_version, HistoryEntryHandler& handler,
+                                     std::uint_fast64_t& cumulative_byte_size_current,
+                                     std::uint_fast64_t& cumulative_byte_size_total,
+                                     bool disable_download_compaction, std::size_t accum_byte_size_soft_limit) const
+{
     std::size_t accum_byte_size = 0;
     DownloadCursor download_progress_2 = download_progress;
 
@@ -827,8 +868,14 @@ bool ServerHistory::fetch_download_info(file_ident_type client_file_ident, Downl
     for (;;) {
         version_type begin_version = download_progress_2.server_version;
         HistoryEntry entry;
-        version_type version = find_history_entry(client_file_ident, begin_version, end_version, entry,
-                                                  download_progress_2.last_integrated_client_version);
+        version_type version;
+        if (client_file_ident != 0) {
+            version = find_history_entry(client_file_ident, begin_version, end_version, entry,
+                                         download_progress_2.last_integrated_client_version);
+        }
+        else {
+            version = find_nonempty_history_entry(begin_version, end_version, entry);
+        }
         if (version == 0) {
             // End of history reached
             download_progress_2.server_version = end_version;
@@ -894,14 +941,30 @@ bool ServerHistory::fetch_download_info(file_ident_type client_file_ident, Downl
     }
     REALM_ASSERT(cumulative_byte_size_current_2 <= cumulative_byte_size_total_2);
 
-    version_type upload_client_version = version_type(m_acc->cf_client_versions.get(client_file_index));
-    version_type upload_server_version = version_type(m_acc->cf_rh_base_versions.get(client_file_index));
-
     download_progress = download_progress_2;
     cumulative_byte_size_current = std::uint_fast64_t(cumulative_byte_size_current_2);
     cumulative_byte_size_total = std::uint_fast64_t(cumulative_byte_size_total_2);
-    upload_progress = UploadCursor{upload_client_version, upload_server_version};
+}
 
+
+bool ServerHistory::get_upload_progress(file_ident_type client_file_ident, UploadCursor& upload_progress) const
+{
+    REALM_ASSERT(client_file_ident != 0);
+
+    TransactionRef tr = m_db->start_read(); // Throws
+    version_type realm_version = tr->get_version();
+    const_cast<ServerHistory*>(this)->set_group(tr.get());
+    ensure_updated(realm_version); // Throws
+
+    std::size_t client_file_index = std::size_t(client_file_ident);
+    std::int_fast64_t last_seen_timestamp = m_acc->cf_last_seen_timestamps.get(client_file_index);
+    bool expired = (last_seen_timestamp == 0);
+    if (REALM_UNLIKELY(expired))
+        return false;
+
+    version_type upload_client_version = version_type(m_acc->cf_client_versions.get(client_file_index));
+    version_type upload_server_version = version_type(m_acc->cf_rh_base_versions.get(client_file_index));
+    upload_progress = UploadCursor{upload_client_version, upload_server_version};
     return true;
 }
 
@@ -2005,6 +2068,24 @@ auto ServerHistory::find_history_entry(file_ident_type remote_file_ident, versio
 }
 
 
+auto ServerHistory::find_nonempty_history_entry(version_type begin_version, version_type end_version,
+                                                HistoryEntry& entry) const noexcept -> version_type
+{
+    REALM_ASSERT(begin_version >= m_history_base_version);
+    REALM_ASSERT(begin_version <= end_version);
+    auto server_version = begin_version;
+    while (server_version < end_version) {
+        ++server_version;
+        HistoryEntry entry_2 = get_history_entry(server_version);
+        if (entry_2.changeset.size() == 0)
+            continue; // Empty
+        entry = entry_2;
+        return server_version;
+    }
+    return 0;
+}
+
+
 auto ServerHistory::get_history_entry(version_type server_version) const noexcept -> HistoryEntry
 {
     REALM_ASSERT(server_version > m_history_base_version && server_version <= get_server_version());
@@ -388,6 +388,28 @@ public:
                              std::uint_fast64_t& cumulative_byte_size_total, bool disable_download_compaction,
                              std::size_t accum_byte_size_soft_limit = 0x20000) const;
 
+    /// Same as fetch_download_info(), but on behalf of a client that has not
+    /// uploaded any changesets, rather than a particular client file, and
+    /// without a limit on the accumulated size of the fetched changesets. The
+    /// result is therefore valid for every bootstrapping client, and can be
+    /// prepared before any such client connects.
+    ///
+    /// \return False if `download_progress` refers to a server version that
+    /// precedes the base version of the history, or if `end_version` is
+    /// greater than the current server version. Otherwise true.
+    bool fetch_bootstrap_download_info(DownloadCursor& download_progress, version_type end_version,
+                                       HistoryEntryHandler&, std::uint_fast64_t& cumulative_byte_size_current,
+                                       std::uint_fast64_t& cumulative_byte_size_total,
+                                       bool disable_download_compaction) const;
+
+    /// Get the upload progress of the specified client file, i.e., the value
+    /// that fetch_download_info() would report through its `upload_progress`
+    /// argument, without fetching any changesets.
+    ///
+    /// \return False if the client file entry of the specified client file has
+    /// expired. Otherwise true.
+    bool get_upload_progress(file_ident_type client_file_ident, UploadCursor& upload_progress) const;
+
     /// The application must call this function before using the history as an
     /// upstream client history.
     ///
@@ -680,7 +702,14 @@ private:
     version_type find_history_entry(file_ident_type remote_file_ident, version_type begin_version,
                                     version_type end_version, HistoryEntry&,
                                     version_type& last_integrated_remote_version) const noexcept;
+    version_type find_nonempty_history_entry(version_type begin_version, version_type end_version,
+                                             HistoryEntry&) const noexcept;
     HistoryEntry get_history_entry(version_type server_version) const noexcept;
+    void fetch_changesets(file_ident_type client_file_ident, DownloadCursor& download_progress,
+                          version_type end_version, HistoryEntryHandler&,
+                          std::uint_fast64_t& cumulative_byte_size_current,
+                          std::uint_fast64_t& cumulative_byte_size_total, bool disable_download_compaction,
+                          std::size_t accum_byte_size_soft_limit) const;
     bool received_from(const HistoryEntry&, file_ident_type remote_file_ident) const noexcept;
 
     SaltedFileIdent allocate_file_ident(file_ident_type proxy_file_ident, ClientType);
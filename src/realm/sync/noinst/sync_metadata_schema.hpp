@@ -36,6 +36,7 @@ namespace internal_schema_groups {
 constexpr static std::string_view c_flx_subscription_store("flx_subscription_store");
 constexpr static std::string_view c_pending_bootstraps("pending_bootstraps");
 constexpr static std::string_view c_flx_migration_store("flx_migration_store");
+constexpr static std::string_view c_standby("standby");
 } // namespace internal_schema_groups
 
 /*
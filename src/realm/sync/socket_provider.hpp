@@ -21,6 +21,7 @@
 #include <realm/status.hpp>
 #include <realm/sync/config.hpp>
 #include <realm/sync/network/websocket_error.hpp>
+#include <realm/util/assert.hpp>
 #include <realm/util/functional.hpp>
 #include <realm/util/optional.hpp>
 #include <realm/util/span.hpp>
@@ -28,6 +29,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace realm::sync {
 namespace websocket {
@@ -126,6 +128,25 @@ public:
     /// @param handler The handler function to be queued on the event loop.
     virtual void post(FunctionHandler&& handler) = 0;
 
+    /// Submit several handler functions to be executed by the event loop, in
+    /// the order in which they appear in \a handlers.
+    ///
+    /// This has the same effect as calling post() for each of the handlers in
+    /// turn, but it lets the Sync Client hand off a group of handlers with a
+    /// single call into the event loop implementation, which matters when
+    /// every such call is expensive, e.g., because it crosses a language
+    /// boundary. The default implementation posts a single handler function
+    /// that executes all of them, passing each the status it was called with.
+    ///
+    /// @param handlers The handler functions to be queued on the event loop.
+    virtual void post_batch(std::vector<FunctionHandler>&& handlers)
+    {
+        post([handlers = std::move(handlers)](Status status) mutable {
+            for (auto& handler : handlers)
+                handler(status);
+        });
+    }
+
     /// Create and register a new timer whose handler function will be posted
     /// to the event loop when the provided delay expires.
     ///
@@ -202,6 +223,23 @@ struct WebSocketInterface {
     ///                write operation, the websocket will be closed and the error
     ///                will be provided via the websocket_closed_handler() function.
     virtual void async_write_binary(util::Span<const char> data, SyncSocketProvider::FunctionHandler&& handler) = 0;
+
+    /// Write several messages asynchronously to the WebSocket connection. Each
+    /// element of \a messages is sent as a separate binary message, in order.
+    ///
+    /// This has the same effect as calling async_write_binary() for each of
+    /// the messages in turn, each after the previous one has completed, but it
+    /// lets implementations for which every call into the networking stack is
+    /// expensive hand off the entire batch at once. The default implementation
+    /// does exactly that, and needs no support from the implementation.
+    ///
+    /// @param messages The data of the messages to be sent. The buffers must
+    ///                 remain valid until the handler is called.
+    /// @param handler The handler function to be called once all the messages
+    ///                have been sent successfully, or when the first of them
+    ///                fails or is aborted, with the status of that write.
+    virtual void async_write_binary_batch(std::vector<util::Span<const char>> messages,
+                                          SyncSocketProvider::FunctionHandler&& handler);
 };
 
 
@@ -253,4 +291,41 @@ struct WebSocketObserver {
                                           std::string_view message) = 0;
 };
 
+
+// Implementation
+
+namespace detail {
+
+struct WebSocketWriteBatch {
+    std::vector<util::Span<const char>> messages;
+    std::size_t num_written = 0;
+    SyncSocketProvider::FunctionHandler handler;
+
+    static void write_next(WebSocketInterface& websocket, std::unique_ptr<WebSocketWriteBatch> batch)
+    {
+        util::Span<const char> data = batch->messages[batch->num_written];
+        websocket.async_write_binary(data, [&websocket, batch = std::move(batch)](Status status) mutable {
+            // The websocket may have been destroyed if the status is not OK
+            ++batch->num_written;
+            if (!status.is_ok() || batch->num_written == batch->messages.size()) {
+                batch->handler(status);
+                return;
+            }
+            write_next(websocket, std::move(batch));
+        });
+    }
+};
+
+} // namespace detail
+
+inline void WebSocketInterface::async_write_binary_batch(std::vector<util::Span<const char>> messages,
+                                                         SyncSocketProvider::FunctionHandler&& handler)
+{
+    REALM_ASSERT(!messages.empty());
+    auto batch = std::make_unique<detail::WebSocketWriteBatch>();
+    batch->messages = std::move(messages);
+    batch->handler = std::move(handler);
+    detail::WebSocketWriteBatch::write_next(*this, std::move(batch));
+}
+
 } // namespace realm::sync
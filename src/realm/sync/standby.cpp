@@ -0,0 +1,174 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/sync/standby.hpp>
+
+#include <realm/sync/changeset.hpp>
+#include <realm/sync/changeset_parser.hpp>
+#include <realm/sync/instruction_applier.hpp>
+#include <realm/sync/noinst/sync_metadata_schema.hpp>
+#include <realm/transaction.hpp>
+#include <realm/util/input_stream.hpp>
+
+namespace realm::sync {
+namespace {
+constexpr static int c_schema_version = 1;
+constexpr static std::string_view c_standby_table("standby_state");
+constexpr static std::string_view c_standby_applied_version("applied_version");
+} // namespace
+
+StandbyReplication::StandbyReplication(Sink sink)
+    : m_sink(std::move(sink))
+{
+    REALM_ASSERT(m_sink);
+}
+
+void StandbyReplication::initialize(DB& db)
+{
+    SyncReplication::initialize(db); // Throws
+    m_history.initialize(&db.get_alloc());
+}
+
+auto StandbyReplication::get_history_type() const noexcept -> HistoryType
+{
+    return hist_InRealm;
+}
+
+int StandbyReplication::get_history_schema_version() const noexcept
+{
+    return _impl::InRealmHistory::schema_version;
+}
+
+bool StandbyReplication::is_upgradable_history_schema(int) const noexcept
+{
+    return true;
+}
+
+void StandbyReplication::upgrade_history_schema(int)
+{
+    // No need to upgrade, because the old entries will not be used
+}
+
+_impl::History* StandbyReplication::_get_history_write()
+{
+    return &m_history;
+}
+
+std::unique_ptr<_impl::History> StandbyReplication::_create_history_read()
+{
+    auto hist = std::make_unique<_impl::InRealmHistory>();
+    hist->initialize(m_history.get_alloc());
+    return hist;
+}
+
+auto StandbyReplication::prepare_changeset(const char* data, size_t size, version_type orig_version)
+    -> version_type
+{
+    m_history.ensure_updated(orig_version);
+    m_prepared_version = m_history.add_changeset(BinaryData(data, size)); // Throws
+    return m_prepared_version;
+}
+
+void StandbyReplication::finalize_changeset() noexcept
+{
+    // The instructions of the transaction stay in the encoder until the next
+    // one is initiated
+    auto& buffer = get_instruction_encoder().buffer();
+    m_sink(m_prepared_version, BinaryData(buffer.data(), buffer.size()));
+}
+
+
+StandbyApplier::StandbyApplier(DBRef standby)
+    : m_db(std::move(standby))
+{
+    std::vector<SyncMetadataTable> internal_tables{
+        {&m_table,
+         c_standby_table,
+         {
+             {&m_version_col, c_standby_applied_version, type_Int},
+         }},
+    };
+
+    auto tr = m_db->start_read();
+    SyncMetadataSchemaVersions schema_versions(tr);
+    if (auto schema_version = schema_versions.get_version_for(tr, internal_schema_groups::c_standby)) {
+        if (*schema_version != c_schema_version) {
+            throw RuntimeError(ErrorCodes::UnsupportedFileFormatVersion,
+                               "Invalid schema version for standby state table group");
+        }
+        load_sync_metadata_schema(tr, &internal_tables);
+    }
+    else {
+        tr->promote_to_write();
+        create_sync_metadata_schema(tr, &internal_tables);
+        schema_versions.set_version_for(tr, internal_schema_groups::c_standby, c_schema_version);
+        tr->commit();
+    }
+}
+
+Obj StandbyApplier::get_state_object(Transaction& tr)
+{
+    auto table = tr.get_table(m_table);
+    if (table->is_empty())
+        return table->create_object();
+    return *table->begin();
+}
+
+auto StandbyApplier::get_applied_version() -> version_type
+{
+    auto tr = m_db->start_read();
+    auto table = tr->get_table(m_table);
+    if (table->is_empty())
+        return 0;
+    return version_type(table->begin()->get<Int>(m_version_col));
+}
+
+void StandbyApplier::set_applied_version(version_type version)
+{
+    auto tr = m_db->start_write();
+    get_state_object(*tr).set(m_version_col, int64_t(version));
+    tr->commit();
+}
+
+bool StandbyApplier::apply(version_type version, BinaryData changeset)
+{
+    auto tr = m_db->start_write();
+    Obj state = get_state_object(*tr);
+    auto applied_version = version_type(state.get<Int>(m_version_col));
+    if (applied_version != 0) {
+        if (version <= applied_version)
+            return false;
+        if (version != applied_version + 1) {
+            throw IllegalOperation(util::format("Cannot apply the changeset of version %1 to a standby which holds "
+                                                "version %2, as the versions in between are missing",
+                                                version, applied_version));
+        }
+    }
+
+    Changeset parsed;
+    util::SimpleInputStream stream{{changeset.data(), changeset.size()}};
+    parse_changeset(stream, parsed); // Throws
+    InstructionApplier applier{*tr};
+    applier.apply(parsed); // Throws
+
+    state.set(m_version_col, int64_t(version));
+    tr->commit();
+    return true;
+}
+
+} // namespace realm::sync
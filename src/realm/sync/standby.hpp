@@ -0,0 +1,122 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_SYNC_STANDBY_HPP
+#define REALM_SYNC_STANDBY_HPP
+
+#include <realm/db.hpp>
+#include <realm/impl/in_realm_history.hpp>
+#include <realm/sync/instruction_replication.hpp>
+#include <realm/util/functional.hpp>
+
+namespace realm::sync {
+
+/// Replication for a Realm whose commits are streamed to one or more standby
+/// Realms, which are kept up to date by applying them with StandbyApplier.
+///
+/// The Realm gets the same in-Realm history as with make_in_realm_history(),
+/// so a file can be opened with either. In addition, each commit is encoded as
+/// a changeset of sync instructions, which carry the new values, and passed to
+/// the sink along with the version produced by the commit. This is the same
+/// encoding as for Device Sync, so the same restrictions apply to the schema:
+/// only tables of the object store (those whose names begin with "class_") are
+/// streamed, and top-level tables need a primary key.
+///
+/// The sink is called once per commit, in the order of the commits, by the
+/// thread which made the commit while it still holds the write lock, and after
+/// the commit has been made durable. It must not throw, and should do little
+/// more than queue the changeset for sending, as further writes to the Realm
+/// are blocked until it returns. The changeset is only valid during the call.
+class StandbyReplication final : public SyncReplication {
+public:
+    using Sink = util::UniqueFunction<void(version_type version, BinaryData changeset)>;
+
+    explicit StandbyReplication(Sink sink);
+
+    void initialize(DB&) override;
+    HistoryType get_history_type() const noexcept override;
+    int get_history_schema_version() const noexcept override;
+    bool is_upgradable_history_schema(int) const noexcept override;
+    void upgrade_history_schema(int) override;
+    _impl::History* _get_history_write() override;
+    std::unique_ptr<_impl::History> _create_history_read() override;
+
+protected:
+    version_type prepare_changeset(const char*, size_t, version_type) override;
+    void finalize_changeset() noexcept override;
+
+private:
+    Sink m_sink;
+    _impl::InRealmHistory m_history;
+    version_type m_prepared_version = 0;
+};
+
+/// Applies the changesets produced by a StandbyReplication to a standby Realm,
+/// in a write transaction per changeset.
+///
+/// The version of the primary Realm which the standby holds is stored in the
+/// standby Realm, in the same transaction as the changes, so that applying can
+/// be resumed after a restart or a crash without losing or repeating any
+/// changes. The standby must start out either empty or as a copy of the
+/// primary (see set_applied_version()), and must not be written to other than
+/// through an applier. It can be read through any number of other DB
+/// instances, which see each applied changeset as a separate commit.
+///
+/// The standby Realm may itself be opened with a StandbyReplication, to stream
+/// on to further standbys.
+class StandbyApplier {
+public:
+    using version_type = Replication::version_type;
+
+    explicit StandbyApplier(DBRef standby);
+
+    StandbyApplier(const StandbyApplier&) = delete;
+    StandbyApplier& operator=(const StandbyApplier&) = delete;
+
+    /// The version of the primary Realm which the standby holds, or zero if no
+    /// changeset has been applied to it yet.
+    version_type get_applied_version();
+
+    /// Record that the standby holds the given version of the primary, because
+    /// it was made as a copy of that version, for example with
+    /// Transaction::copy_to() or DB::write_incremental_backup(). The changesets
+    /// of later versions are then applied from the version after that.
+    void set_applied_version(version_type version);
+
+    /// Apply the changeset which produced `version` of the primary Realm.
+    ///
+    /// If the standby already holds this version, nothing is done and false
+    /// is returned, so that changesets may be delivered more than once. If no
+    /// version has been applied yet, any version is accepted.
+    ///
+    /// Throws IllegalOperation if a version between the one held by the
+    /// standby and `version` is missing. Throws BadChangesetError if the
+    /// changeset cannot be decoded or applied.
+    bool apply(version_type version, BinaryData changeset);
+
+private:
+    DBRef m_db;
+    TableKey m_table;
+    ColKey m_version_col;
+
+    Obj get_state_object(Transaction&);
+};
+
+} // namespace realm::sync
+
+#endif // REALM_SYNC_STANDBY_HPP
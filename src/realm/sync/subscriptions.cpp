@@ -32,14 +32,16 @@
 
 #include <algorithm>
 #include <initializer_list>
+#include <limits>
 #include <stdexcept>
 
 namespace realm::sync {
 namespace {
 // Schema version history:
 //   v2: Initial public beta.
+//   v3: Added subscription priorities and the priority band of subscription sets.
 
-constexpr static int c_flx_schema_version = 2;
+constexpr static int c_flx_schema_version = 3;
 constexpr static std::string_view c_flx_subscription_sets_table("flx_subscription_sets");
 constexpr static std::string_view c_flx_subscriptions_table("flx_subscriptions");
 
@@ -48,6 +50,7 @@ constexpr static std::string_view c_flx_sub_sets_version_field("version");
 constexpr static std::string_view c_flx_sub_sets_error_str_field("error");
 constexpr static std::string_view c_flx_sub_sets_subscriptions_field("subscriptions");
 constexpr static std::string_view c_flx_sub_sets_snapshot_version_field("snapshot_version");
+constexpr static std::string_view c_flx_sub_sets_priority_band_field("priority_band");
 
 constexpr static std::string_view c_flx_sub_id_field("id");
 constexpr static std::string_view c_flx_sub_created_at_field("created_at");
@@ -55,6 +58,7 @@ constexpr static std::string_view c_flx_sub_updated_at_field("updated_at");
 constexpr static std::string_view c_flx_sub_name_field("name");
 constexpr static std::string_view c_flx_sub_object_class_field("object_class");
 constexpr static std::string_view c_flx_sub_query_str_field("query");
+constexpr static std::string_view c_flx_sub_priority_field("priority");
 
 using OptionalString = util::Optional<std::string>;
 
@@ -154,16 +158,19 @@ Subscription::Subscription(const SubscriptionStore* parent, Obj obj)
                                            : OptionalString{obj.get<String>(parent->m_sub_name)})
     , object_class_name(obj.get<String>(parent->m_sub_object_class_name))
     , query_string(obj.get<String>(parent->m_sub_query_str))
+    , priority(obj.get<Int>(parent->m_sub_priority))
 {
 }
 
-Subscription::Subscription(util::Optional<std::string> name, std::string object_class_name, std::string query_str)
+Subscription::Subscription(util::Optional<std::string> name, std::string object_class_name, std::string query_str,
+                           int64_t priority)
     : id(ObjectId::gen())
     , created_at(std::chrono::system_clock::now())
     , updated_at(created_at)
     , name(std::move(name))
     , object_class_name(std::move(object_class_name))
     , query_string(std::move(query_str))
+    , priority(priority)
 {
 }
 
@@ -195,6 +202,7 @@ void SubscriptionSet::load_from_database(const Obj& obj)
     m_state = state_from_storage(obj.get<int64_t>(mgr->m_sub_set_state));
     m_error_str = obj.get<String>(mgr->m_sub_set_error_str);
     m_snapshot_version = static_cast<DB::version_type>(obj.get<int64_t>(mgr->m_sub_set_snapshot_version));
+    m_priority_band = obj.get<int64_t>(mgr->m_sub_set_priority_band);
     auto sub_list = obj.get_linklist(mgr->m_sub_set_subscriptions);
     m_subs.clear();
     for (size_t idx = 0; idx < sub_list.size(); ++idx) {
@@ -225,6 +233,11 @@ SubscriptionSet::State SubscriptionSet::state() const
     return m_state;
 }
 
+int64_t SubscriptionSet::priority_band() const
+{
+    return m_priority_band;
+}
+
 StringData SubscriptionSet::error_str() const
 {
     if (m_error_str.empty()) {
@@ -295,6 +308,10 @@ MutableSubscriptionSet::iterator MutableSubscriptionSet::erase(const_iterator it
 {
     check_is_mutable();
     REALM_ASSERT(it != end());
+    size_t ndx = it - m_subs.begin();
+    m_index_valid = m_index_valid && !m_index_has_duplicates;
+    if (m_index_valid)
+        unindex_sub(ndx);
     if (it == std::prev(m_subs.end())) {
         m_subs.pop_back();
         return end();
@@ -304,17 +321,21 @@ MutableSubscriptionSet::iterator MutableSubscriptionSet::erase(const_iterator it
     auto iterator = m_subs.erase(it, it);
     std::swap(*iterator, *back);
     m_subs.pop_back();
+    if (m_index_valid) {
+        // The last subscription was moved into the position of the erased one
+        unindex_sub(ndx);
+        index_sub(ndx);
+    }
     return iterator;
 }
 
 bool MutableSubscriptionSet::erase(StringData name)
 {
     check_is_mutable();
-    auto ptr = find(name);
-    if (!ptr)
+    size_t ndx = find_named(std::string_view(name.data(), name.size()));
+    if (ndx == m_subs.size())
         return false;
-    auto it = m_subs.begin() + (ptr - &m_subs.front());
-    erase(it);
+    erase(m_subs.begin() + ndx);
     return true;
 }
 
@@ -337,6 +358,7 @@ bool MutableSubscriptionSet::erase_by_class_name(StringData object_class_name)
     });
     auto erased = end() - it;
     m_subs.erase(it, end());
+    m_index_valid = false;
     return erased > 0;
 }
 
@@ -356,60 +378,140 @@ void MutableSubscriptionSet::clear()
 {
     check_is_mutable();
     m_subs.clear();
+    m_index_valid = false;
 }
 
 void MutableSubscriptionSet::insert_sub(const Subscription& sub)
 {
     check_is_mutable();
     m_subs.push_back(sub);
+    if (m_index_valid)
+        index_sub(m_subs.size() - 1);
+}
+
+void MutableSubscriptionSet::ensure_index()
+{
+    if (m_index_valid)
+        return;
+    m_name_index.clear();
+    m_query_index.clear();
+    m_index_has_duplicates = false;
+    m_index_valid = true;
+    for (size_t i = 0; i < m_subs.size(); ++i)
+        index_sub(i);
+}
+
+void MutableSubscriptionSet::index_sub(size_t ndx)
+{
+    auto& sub = m_subs[ndx];
+    bool inserted = sub.name ? m_name_index.try_emplace(*sub.name, ndx).second
+                             : m_query_index.try_emplace({sub.object_class_name, sub.query_string}, ndx).second;
+    if (!inserted)
+        m_index_has_duplicates = true;
+}
+
+void MutableSubscriptionSet::unindex_sub(size_t ndx)
+{
+    auto& sub = m_subs[ndx];
+    if (sub.name)
+        m_name_index.erase(*sub.name);
+    else
+        m_query_index.erase({sub.object_class_name, sub.query_string});
+}
+
+size_t MutableSubscriptionSet::find_named(std::string_view name)
+{
+    ensure_index();
+    auto it = m_name_index.find(std::string(name));
+    return it == m_name_index.end() ? m_subs.size() : it->second;
+}
+
+size_t MutableSubscriptionSet::find_unnamed(const std::string& object_class_name, const std::string& query_str)
+{
+    ensure_index();
+    auto it = m_query_index.find({object_class_name, query_str});
+    return it == m_query_index.end() ? m_subs.size() : it->second;
 }
 
 std::pair<SubscriptionSet::iterator, bool>
 MutableSubscriptionSet::insert_or_assign_impl(iterator it, util::Optional<std::string> name,
-                                              std::string object_class_name, std::string query_str)
+                                              std::string object_class_name, std::string query_str,
+                                              int64_t priority)
 {
     check_is_mutable();
     if (it != end()) {
         auto& sub = m_subs[it - begin()];
         sub.object_class_name = std::move(object_class_name);
         sub.query_string = std::move(query_str);
+        sub.priority = priority;
         sub.updated_at = Timestamp{std::chrono::system_clock::now()};
 
         return {it, false};
     }
     it = m_subs.insert(m_subs.end(),
-                       Subscription(std::move(name), std::move(object_class_name), std::move(query_str)));
+                       Subscription(std::move(name), std::move(object_class_name), std::move(query_str), priority));
+    if (m_index_valid)
+        index_sub(m_subs.size() - 1);
 
     return {it, true};
 }
 
-std::pair<SubscriptionSet::iterator, bool> MutableSubscriptionSet::insert_or_assign(std::string_view name,
-                                                                                    const Query& query)
+std::pair<SubscriptionSet::iterator, bool>
+MutableSubscriptionSet::insert_or_assign(std::string_view name, const Query& query, int64_t priority)
 {
     auto table_name = Group::table_name_to_class_name(query.get_table()->get_name());
     auto query_str = query.get_description();
-    auto it = std::find_if(begin(), end(), [&](const Subscription& sub) {
-        return sub.name == name;
-    });
+    auto it = begin() + find_named(name);
 
-    return insert_or_assign_impl(it, std::string{name}, std::move(table_name), std::move(query_str));
+    return insert_or_assign_impl(it, std::string{name}, std::move(table_name), std::move(query_str), priority);
 }
 
-std::pair<SubscriptionSet::iterator, bool> MutableSubscriptionSet::insert_or_assign(const Query& query)
+std::pair<SubscriptionSet::iterator, bool> MutableSubscriptionSet::insert_or_assign(const Query& query,
+                                                                                    int64_t priority)
 {
     auto table_name = Group::table_name_to_class_name(query.get_table()->get_name());
     auto query_str = query.get_description();
-    auto it = std::find_if(begin(), end(), [&](const Subscription& sub) {
-        return (!sub.name && sub.object_class_name == table_name && sub.query_string == query_str);
-    });
+    auto it = begin() + find_unnamed(table_name, query_str);
+
+    return insert_or_assign_impl(it, util::none, std::move(table_name), std::move(query_str), priority);
+}
 
-    return insert_or_assign_impl(it, util::none, std::move(table_name), std::move(query_str));
+bool MutableSubscriptionSet::is_pending(const Subscription& sub) const
+{
+    auto it = m_base_sub_ids.find(sub.id);
+    if (it == m_base_sub_ids.end())
+        return true;
+    auto& base = m_base_subs[it->second];
+    return base.object_class_name != sub.object_class_name || base.query_string != sub.query_string;
+}
+
+void MutableSubscriptionSet::set_base_subs(std::vector<Subscription> subs)
+{
+    m_base_subs = std::move(subs);
+    m_base_sub_ids.clear();
+    m_base_sub_ids.reserve(m_base_subs.size());
+    for (size_t i = 0; i < m_base_subs.size(); ++i)
+        m_base_sub_ids.emplace(m_base_subs[i].id, i);
+}
+
+std::vector<int64_t> MutableSubscriptionSet::pending_priority_bands() const
+{
+    std::vector<int64_t> bands;
+    for (const auto& sub : m_subs) {
+        if (is_pending(sub)) {
+            bands.push_back(sub.priority);
+        }
+    }
+    std::sort(bands.begin(), bands.end(), std::greater<>());
+    bands.erase(std::unique(bands.begin(), bands.end()), bands.end());
+    return bands;
 }
 
 void MutableSubscriptionSet::import(SubscriptionSet&& src_subs)
 {
     check_is_mutable();
     SubscriptionSet::import(std::move(src_subs));
+    m_index_valid = false;
 }
 
 void SubscriptionSet::import(SubscriptionSet&& src_subs)
@@ -473,6 +575,17 @@ util::Future<SubscriptionSet::State> SubscriptionSet::get_state_change_notificat
     return std::move(future);
 }
 
+util::Future<SubscriptionSet::State> SubscriptionSet::get_priority_band_notification(int64_t priority,
+                                                                                     State notify_when) const
+{
+    auto mgr = get_flx_subscription_store(); // Throws
+    auto band_version = mgr->get_version_for_priority_band(*this, priority);
+    if (band_version == version()) {
+        return get_state_change_notification(notify_when);
+    }
+    return mgr->get_by_version(band_version).get_state_change_notification(notify_when);
+}
+
 void SubscriptionSet::get_state_change_notification(
     State notify_when, util::UniqueFunction<void(util::Optional<State>, util::Optional<Status>)> cb) const
 {
@@ -522,24 +635,28 @@ SubscriptionSet MutableSubscriptionSet::commit()
     }
     auto mgr = get_flx_subscription_store(); // Throws
 
+    std::vector<int64_t> bands;
     if (m_state == State::Uncommitted) {
         m_state = State::Pending;
+        bands = pending_priority_bands();
     }
-    m_obj.set(mgr->m_sub_set_snapshot_version, static_cast<int64_t>(m_tr->get_version()));
 
-    auto obj_sub_list = m_obj.get_linklist(mgr->m_sub_set_subscriptions);
-    obj_sub_list.clear();
-    for (const auto& sub : m_subs) {
-        auto new_sub = obj_sub_list.create_and_insert_linked_object(obj_sub_list.size());
-        new_sub.set(mgr->m_sub_id, sub.id);
-        new_sub.set(mgr->m_sub_created_at, sub.created_at);
-        new_sub.set(mgr->m_sub_updated_at, sub.updated_at);
-        if (sub.name) {
-            new_sub.set(mgr->m_sub_name, StringData(*sub.name));
+    // Every priority band but the lowest one gets a subscription set version of its own, containing the
+    // subscriptions of that band and of all the bands above it. The server bootstraps query versions in order,
+    // so the high-priority subscriptions are delivered without waiting for the low-priority ones.
+    if (bands.size() > 1) {
+        auto sub_sets = m_tr->get_table(mgr->m_sub_set_table);
+        for (size_t i = 0; i + 1 < bands.size(); ++i) {
+            write_subscriptions(m_obj, bands[i]);
+            m_obj.set(mgr->m_sub_set_state, state_to_storage(State::Pending));
+            m_obj = sub_sets->create_object_with_primary_key(Mixed{m_version + 1});
+            m_obj_key = m_obj.get_key();
+            m_version = m_obj.get_primary_key().get_int();
         }
-        new_sub.set(mgr->m_sub_object_class_name, StringData(sub.object_class_name));
-        new_sub.set(mgr->m_sub_query_str, StringData(sub.query_string));
     }
+    write_subscriptions(m_obj, std::numeric_limits<int64_t>::min());
+    m_priority_band = bands.empty() ? 0 : bands.back();
+    m_obj.set(mgr->m_sub_set_priority_band, m_priority_band);
     m_obj.set(mgr->m_sub_set_state, state_to_storage(m_state));
     if (!m_error_str.empty()) {
         m_obj.set(mgr->m_sub_set_error_str, StringData(m_error_str));
@@ -553,21 +670,45 @@ SubscriptionSet MutableSubscriptionSet::commit()
     return mgr->get_refreshed(m_obj.get_key(), flx_version, m_tr->get_version_of_current_transaction());
 }
 
+void MutableSubscriptionSet::write_subscriptions(Obj& obj, int64_t min_pending_priority) const
+{
+    auto mgr = get_flx_subscription_store(); // Throws
+
+    obj.set(mgr->m_sub_set_snapshot_version, static_cast<int64_t>(m_tr->get_version()));
+    obj.set(mgr->m_sub_set_priority_band, min_pending_priority);
+
+    auto obj_sub_list = obj.get_linklist(mgr->m_sub_set_subscriptions);
+    obj_sub_list.clear();
+    for (const auto& sub : m_subs) {
+        if (sub.priority < min_pending_priority && is_pending(sub)) {
+            continue;
+        }
+        auto new_sub = obj_sub_list.create_and_insert_linked_object(obj_sub_list.size());
+        new_sub.set(mgr->m_sub_id, sub.id);
+        new_sub.set(mgr->m_sub_created_at, sub.created_at);
+        new_sub.set(mgr->m_sub_updated_at, sub.updated_at);
+        if (sub.name) {
+            new_sub.set(mgr->m_sub_name, StringData(*sub.name));
+        }
+        new_sub.set(mgr->m_sub_object_class_name, StringData(sub.object_class_name));
+        new_sub.set(mgr->m_sub_query_str, StringData(sub.query_string));
+        new_sub.set(mgr->m_sub_priority, sub.priority);
+    }
+}
+
 std::string SubscriptionSet::to_ext_json() const
 {
     if (m_subs.empty()) {
         return "{}";
     }
 
-    util::FlatMap<std::string, std::vector<std::string>> table_to_query;
+    // We want to make sure that the queries appear in some kind of canonical order so that if there are
+    // two subscription sets with the same subscriptions in different orders, the server doesn't have to
+    // waste a bunch of time re-running the queries for that table. The sets also drop duplicates.
+    util::FlatMap<std::string, std::set<std::string>> table_to_query;
     for (const auto& sub : *this) {
         std::string table_name(sub.object_class_name);
-        auto& queries_for_table = table_to_query.at(table_name);
-        auto query_it = std::find(queries_for_table.begin(), queries_for_table.end(), sub.query_string);
-        if (query_it != queries_for_table.end()) {
-            continue;
-        }
-        queries_for_table.emplace_back(sub.query_string);
+        table_to_query.at(table_name).insert(sub.query_string);
     }
 
     if (table_to_query.empty()) {
@@ -578,11 +719,6 @@ std::string SubscriptionSet::to_ext_json() const
     // query strings into a json object.
     nlohmann::json output_json;
     for (auto& table : table_to_query) {
-        // We want to make sure that the queries appear in some kind of canonical order so that if there are
-        // two subscription sets with the same subscriptions in different orders, the server doesn't have to
-        // waste a bunch of time re-running the queries for that table.
-        std::stable_sort(table.second.begin(), table.second.end());
-
         bool is_first = true;
         std::ostringstream obuf;
         for (const auto& query_str : table.second) {
@@ -615,6 +751,7 @@ SubscriptionStore::SubscriptionStore(Private, DBRef db)
              {&m_sub_set_snapshot_version, c_flx_sub_sets_snapshot_version_field, type_Int},
              {&m_sub_set_error_str, c_flx_sub_sets_error_str_field, type_String, true},
              {&m_sub_set_subscriptions, c_flx_sub_sets_subscriptions_field, c_flx_subscriptions_table, true},
+             {&m_sub_set_priority_band, c_flx_sub_sets_priority_band_field, type_Int},
          }},
         {&m_sub_table,
          c_flx_subscriptions_table,
@@ -626,6 +763,7 @@ SubscriptionStore::SubscriptionStore(Private, DBRef db)
              {&m_sub_name, c_flx_sub_name_field, type_String, true},
              {&m_sub_object_class_name, c_flx_sub_object_class_field, type_String},
              {&m_sub_query_str, c_flx_sub_query_str_field, type_String},
+             {&m_sub_priority, c_flx_sub_priority_field, type_Int},
          }},
     };
 
@@ -640,7 +778,16 @@ SubscriptionStore::SubscriptionStore(Private, DBRef db)
         tr->commit_and_continue_as_read();
     }
     else {
-        if (*schema_version != c_flx_schema_version) {
+        if (*schema_version == 2) {
+            // v3 only added columns whose default value of zero is the priority of pre-existing subscriptions.
+            tr->promote_to_write();
+            tr->get_table(c_flx_subscription_sets_table)->add_column(type_Int, c_flx_sub_sets_priority_band_field);
+            tr->get_table(c_flx_subscriptions_table)->add_column(type_Int, c_flx_sub_priority_field);
+            schema_versions.set_version_for(tr, internal_schema_groups::c_flx_subscription_store,
+                                            c_flx_schema_version);
+            tr->commit_and_continue_as_read();
+        }
+        else if (*schema_version != c_flx_schema_version) {
             throw RuntimeError(ErrorCodes::UnsupportedFileFormatVersion,
                                "Invalid schema version for flexible sync metadata");
         }
@@ -927,10 +1074,36 @@ MutableSubscriptionSet SubscriptionStore::make_mutable_copy(const SubscriptionSe
     for (const auto& sub : set) {
         new_set_obj.insert_sub(sub);
     }
+    new_set_obj.set_base_subs(set.m_subs);
 
     return new_set_obj;
 }
 
+int64_t SubscriptionStore::get_version_for_priority_band(const SubscriptionSet& set, int64_t priority) const
+{
+    if (set.state() == State::Uncommitted || set.state() == State::Superseded) {
+        return set.version();
+    }
+
+    // All the versions created by a single commit share its snapshot version. Versions of bands which have
+    // already been trimmed are covered by the first later version still present.
+    auto tr = m_db->start_read();
+    auto sub_sets = tr->get_table(m_sub_set_table);
+    DescriptorOrdering descriptor_ordering;
+    descriptor_ordering.append_sort(SortDescriptor{{{sub_sets->get_primary_key_column()}}, {true}});
+    auto res = sub_sets->where()
+                   .equal(m_sub_set_snapshot_version, static_cast<int64_t>(set.snapshot_version()))
+                   .less_equal(sub_sets->get_primary_key_column(), set.version())
+                   .find_all(descriptor_ordering);
+    for (size_t i = 0; i < res.size(); ++i) {
+        auto obj = res.get_object(i);
+        if (obj.get<int64_t>(m_sub_set_priority_band) <= priority) {
+            return obj.get_primary_key().get_int();
+        }
+    }
+    return set.version();
+}
+
 bool SubscriptionStore::would_refresh(DB::version_type version) const noexcept
 {
     return version < m_db->get_version_of_latest_snapshot();
@@ -32,6 +32,7 @@
 #include <list>
 #include <set>
 #include <string_view>
+#include <unordered_map>
 
 namespace realm::sync {
 
@@ -61,6 +62,10 @@ public:
     // A stringified version of the query associated with this subscription.
     std::string query_string;
 
+    // The priority of this subscription. When a single commit adds subscriptions with different priorities, the
+    // ones with a higher priority are bootstrapped and delivered before those with a lower priority.
+    int64_t priority = 0;
+
     // Returns whether the 2 subscriptions passed have the same id.
     friend bool operator==(const Subscription& lhs, const Subscription& rhs)
     {
@@ -69,7 +74,8 @@ public:
 
     Subscription() = default;
     Subscription(const SubscriptionStore* parent, Obj obj);
-    Subscription(util::Optional<std::string> name, std::string object_class_name, std::string query_str);
+    Subscription(util::Optional<std::string> name, std::string object_class_name, std::string query_str,
+                 int64_t priority = 0);
 };
 
 // SubscriptionSets contain a set of unique queries by either name or Query object that will be constructed into a
@@ -164,6 +170,16 @@ public:
     // The current state of this subscription set
     State state() const;
 
+    // The lowest priority of the subscriptions which are first bootstrapped by this subscription set. When a
+    // commit adds subscriptions with several distinct priorities, one subscription set version is created per
+    // priority band, in descending order of priority, so that the server bootstraps the high-priority ones first.
+    int64_t priority_band() const;
+
+    // Returns a future that resolves when every subscription of this commit with a priority of at least `priority`
+    // has reached at least `notify_when`. This allows observing the bootstrap of the high-priority subscriptions
+    // without waiting for the low-priority ones which were committed together with them.
+    util::Future<State> get_priority_band_notification(int64_t priority, State notify_when) const;
+
     // The error string for this subscription set if any.
     StringData error_str() const;
 
@@ -210,6 +226,7 @@ protected:
     State m_state = State::Uncommitted;
     std::string m_error_str;
     DB::version_type m_snapshot_version = -1;
+    int64_t m_priority_band = 0;
     std::vector<Subscription> m_subs;
     ObjKey m_obj_key;
 };
@@ -226,20 +243,20 @@ public:
     // The Query portion of the subscription is mutable, however the name portion is immutable after the
     // subscription is inserted.
     //
-    // If insert is called twice for the same name, the Query portion and updated_at timestamp for that named
-    // subscription will be updated to match the new Query.
-    std::pair<iterator, bool> insert_or_assign(std::string_view name, const Query& query);
+    // If insert is called twice for the same name, the Query portion, priority and updated_at timestamp for that
+    // named subscription will be updated to match the new Query.
+    std::pair<iterator, bool> insert_or_assign(std::string_view name, const Query& query, int64_t priority = 0);
 
     // Inserts a new subscription into the set if one does not exist already - returns an iterator to the
     // subscription and a bool that is true if a new subscription was actually created. The SubscriptionSet
     // must be in the Uncommitted state to call this - otherwise this will throw.
     //
-    // If insert is called twice for the same query, then the updated_at timestamp for that subscription will
-    // be updated.
+    // If insert is called twice for the same query, then the priority and updated_at timestamp for that
+    // subscription will be updated.
     //
     // The inserted subscription will have an empty name - to update this Subscription's query, the caller
     // will have
-    std::pair<iterator, bool> insert_or_assign(const Query& query);
+    std::pair<iterator, bool> insert_or_assign(const Query& query, int64_t priority = 0);
 
     void import(SubscriptionSet&&);
 
@@ -277,15 +294,58 @@ private:
     void refresh() = delete;
 
     std::pair<iterator, bool> insert_or_assign_impl(iterator it, util::Optional<std::string> name,
-                                                    std::string object_class_name, std::string query_str);
+                                                    std::string object_class_name, std::string query_str,
+                                                    int64_t priority);
+    // Returns the distinct priorities of the subscriptions which need to be bootstrapped by this commit, in
+    // descending order.
+    std::vector<int64_t> pending_priority_bands() const;
+    bool is_pending(const Subscription& sub) const;
+    void write_subscriptions(Obj& obj, int64_t min_pending_priority) const;
     // Throws is m_tr is in the wrong state.
     void check_is_mutable() const;
 
     void insert_sub_impl(ObjectId id, Timestamp created_at, Timestamp updated_at, StringData name,
                          StringData object_class_name, StringData query_str);
 
+    // Returns the position of the named subscription, or of the unnamed subscription with the given query, or
+    // the size of the set if there is none.
+    size_t find_named(std::string_view name);
+    size_t find_unnamed(const std::string& object_class_name, const std::string& query_str);
+    void ensure_index();
+    void index_sub(size_t ndx);
+    void unindex_sub(size_t ndx);
+    void set_base_subs(std::vector<Subscription> subs);
+
     TransactionRef m_tr;
     Obj m_obj;
+    // The subscriptions of the set this was copied from, which the server has already been asked to bootstrap,
+    // and their positions by id.
+    std::vector<Subscription> m_base_subs;
+    std::unordered_map<ObjectId, size_t> m_base_sub_ids;
+
+    // The positions in m_subs of the named subscriptions by name, and of the unnamed ones by class name and
+    // query, so that inserting many subscriptions doesn't compare each with all the others. Built on first use.
+    struct QueryKey {
+        std::string object_class_name;
+        std::string query_str;
+        bool operator==(const QueryKey& other) const noexcept
+        {
+            return object_class_name == other.object_class_name && query_str == other.query_str;
+        }
+    };
+    struct QueryKeyHash {
+        size_t operator()(const QueryKey& key) const noexcept
+        {
+            size_t h = std::hash<std::string>()(key.object_class_name);
+            return h ^ (std::hash<std::string>()(key.query_str) + 0x9e3779b9 + (h << 6) + (h >> 2));
+        }
+    };
+    std::unordered_map<std::string, size_t> m_name_index;
+    std::unordered_map<QueryKey, size_t, QueryKeyHash> m_query_index;
+    bool m_index_valid = false;
+    // Only the first of subscriptions with the same name or query is indexed, so erasing one of them requires
+    // rebuilding the index
+    bool m_index_has_duplicates = false;
 };
 
 class SubscriptionStore;
@@ -390,6 +450,7 @@ private:
     void supercede_prior_to(TransactionRef tr, int64_t version_id) const;
 
     Obj get_active(const Transaction& tr);
+    int64_t get_version_for_priority_band(const SubscriptionSet& set, int64_t priority) const;
     SubscriptionSet get_refreshed(ObjKey, int64_t flx_version, std::optional<DB::VersionID> version = util::none);
     MutableSubscriptionSet make_mutable_copy(const SubscriptionSet& set);
 
@@ -409,6 +470,7 @@ private:
     ColKey m_sub_name;
     ColKey m_sub_object_class_name;
     ColKey m_sub_query_str;
+    ColKey m_sub_priority;
 
     TableKey m_sub_set_table;
     ColKey m_sub_set_version_num;
@@ -416,6 +478,7 @@ private:
     ColKey m_sub_set_state;
     ColKey m_sub_set_error_str;
     ColKey m_sub_set_subscriptions;
+    ColKey m_sub_set_priority_band;
 
     util::CheckedMutex m_pending_notifications_mutex;
     int64_t m_min_outstanding_version GUARDED_BY(m_pending_notifications_mutex) = 0;
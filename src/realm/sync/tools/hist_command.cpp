@@ -481,6 +481,11 @@ public:
     virtual void print_info(std::ostream&) const = 0;
     virtual void print_annotated_info(std::ostream&, TimestampFormatter&) const = 0;
     virtual void get_changeset(util::AppendBuffer<char>&) const = 0;
+    // The dictionary that the changesets may be compressed with
+    virtual util::Span<const char> get_changeset_dictionary() const
+    {
+        return {};
+    }
 };
 
 
@@ -796,13 +801,13 @@ public:
     ClientHistoryCursor(Allocator& alloc, ref_type root_ref, int schema_version,
                         version_type current_snapshot_version)
     {
-        REALM_ASSERT(schema_version == 12);
+        REALM_ASSERT(schema_version == 12 || schema_version == 13);
 
         if (root_ref == 0)
             return;
 
         // Size of fixed-size arrays
-        std::size_t root_size = 21;
+        std::size_t root_size = (schema_version < 13 ? 21 : 22);
 
         // Slots in root array of history compartment
         std::size_t changesets_iip = 13;
@@ -810,6 +815,7 @@ public:
         std::size_t remote_versions_iip = 15;
         std::size_t origin_file_idents_iip = 16;
         std::size_t origin_timestamps_iip = 17;
+        std::size_t changeset_dictionary_iip = 21;
 
         Array root{alloc};
         root.init_from_ref(root_ref);
@@ -840,6 +846,14 @@ public:
             m_origin_timestamps->set_parent(&root, origin_timestamps_iip); // Throws
             m_origin_timestamps->init_from_parent();
         }
+        if (schema_version >= 13) {
+            BinaryColumn changeset_dictionary{alloc};
+            changeset_dictionary.init_from_ref(root.get_as_ref(changeset_dictionary_iip));
+            if (changeset_dictionary.size() != 0) {
+                BinaryData dictionary = changeset_dictionary.get(0);
+                m_changeset_dictionary.assign(dictionary.data(), dictionary.data() + dictionary.size()); // Throws
+            }
+        }
         std::size_t history_size = m_changesets->size();
         m_base_version = version_type(current_snapshot_version - history_size);
         m_last_version = current_snapshot_version;
@@ -921,12 +935,18 @@ public:
         ::get_changeset(*m_changesets, index, buffer); // Throws
     }
 
+    util::Span<const char> get_changeset_dictionary() const override final
+    {
+        return m_changeset_dictionary;
+    }
+
 private:
     std::unique_ptr<BinaryColumn> m_changesets;
     std::unique_ptr<BinaryColumn> m_reciprocal_transforms;
     std::unique_ptr<IntegerBpTree> m_remote_versions;
     std::unique_ptr<IntegerBpTree> m_origin_file_idents;
     std::unique_ptr<IntegerBpTree> m_origin_timestamps;
+    std::vector<char> m_changeset_dictionary;
     bool m_reciprocal = false;
 
     std::size_t get_changeset_size(std::size_t index) const noexcept
@@ -1595,7 +1615,8 @@ void inspect_history(SyncHistoryCursor& cursor, util::Optional<file_ident_type>
             cursor.get_changeset(buffer); // Throws
             util::SimpleInputStream in{buffer};
             size_t decompressed_size;
-            auto decompressed = util::compression::decompress_nonportable_input_stream(in, decompressed_size);
+            auto decompressed = util::compression::decompress_nonportable_input_stream(
+                in, decompressed_size, cursor.get_changeset_dictionary());
             sync::Changeset changeset;
             sync::parse_changeset(*decompressed, changeset); // Throws
             expression->reset(changeset);
@@ -1641,7 +1662,8 @@ void inspect_history(SyncHistoryCursor& cursor, util::Optional<file_ident_type>
                 cursor.get_changeset(buffer); // Throws
                 util::SimpleInputStream in{buffer};
                 size_t decompressed_size;
-                auto decompressed = util::compression::decompress_nonportable_input_stream(in, decompressed_size);
+                auto decompressed = util::compression::decompress_nonportable_input_stream(
+                in, decompressed_size, cursor.get_changeset_dictionary());
                 sync::Changeset changeset;
                 sync::parse_changeset(*decompressed, changeset); // Throws
 #if REALM_DEBUG
@@ -2263,7 +2285,7 @@ int main(int argc, char* argv[])
         int history_schema_version;
         gf::get_version_and_history_info(alloc, top_ref, version, history_type, history_schema_version);
         if (history_type == Replication::hist_SyncClient) {
-            if (history_schema_version == 12) {
+            if (history_schema_version == 12 || history_schema_version == 13) {
                 factory = std::make_unique<ClientCursorFactory>(alloc, history_ref, history_schema_version,
                                                                 version); // Throws
             }
@@ -2,6 +2,11 @@
 
 #include <realm/sync/noinst/changeset_index.hpp>
 #include <realm/sync/noinst/protocol_codec.hpp>
+#include <realm/util/alloc_tracking.hpp>
+
+#include <future>
+#include <set>
+#include <unordered_map>
 
 #if REALM_DEBUG
 #include <sstream>
@@ -144,10 +149,10 @@ struct MajorSide : Side {
     void init_with_instruction(Changeset::iterator position) noexcept
     {
         REALM_ASSERT(position >= m_changeset->begin());
-        REALM_ASSERT(position != m_changeset->end());
+        REALM_ASSERT(position != m_end);
         m_position = position;
         skip_tombstones();
-        REALM_ASSERT(position != m_changeset->end());
+        REALM_ASSERT(position != m_end);
 
         m_discriminant = Discriminant{m_changeset->origin_timestamp, m_changeset->origin_file_ident};
 
@@ -156,17 +161,17 @@ struct MajorSide : Side {
 
     void skip_tombstones() noexcept final
     {
-        while (m_position != m_changeset->end() && !*m_position) {
+        while (m_position != m_end && !*m_position) {
             ++m_position;
         }
     }
 
     void next_instruction() noexcept final
     {
-        REALM_ASSERT(m_position != m_changeset->end());
+        REALM_ASSERT(m_position != m_end);
         do {
             ++m_position;
-        } while (m_position != m_changeset->end() && !*m_position);
+        } while (m_position != m_end && !*m_position);
     }
 
     Instruction& get() noexcept final
@@ -180,6 +185,10 @@ struct MajorSide : Side {
     }
 
     Changeset::iterator m_position;
+    // The end of the instructions to transform. Either the end of the
+    // changeset, or of a single slot when transforming in parallel, so that
+    // the instructions beyond it are never looked at.
+    Changeset::iterator m_end;
 };
 
 struct MinorSide : Side {
@@ -560,12 +569,33 @@ struct TransformerImpl {
     {
     }
 
+    // When transforming in parallel, changesets are not marked as dirty
+    // directly, as they are shared between the threads. They are collected
+    // here and marked once all threads are done.
+    bool m_defer_dirty = false;
+    std::set<Changeset*> m_dirty_changesets;
+
     void transform()
     {
         m_major_side.m_position = m_major_side.m_changeset->begin();
+        transform_range();
+    }
+
+    // Transform only the instructions in the slot of `changeset` at `slot`.
+    // Instructions prepended to it stay in the same slot.
+    void transform_slot(Changeset* changeset, Changeset::iterator slot)
+    {
+        m_major_side.m_changeset = changeset;
+        m_major_side.m_position = slot;
+        m_major_side.m_end = Changeset::iterator{slot.m_inner + 1};
+        transform_range();
+    }
+
+    void transform_range()
+    {
         m_major_side.skip_tombstones();
 
-        while (m_major_side.m_position != m_major_side.m_changeset->end()) {
+        while (m_major_side.m_position != m_major_side.m_end) {
             m_major_side.init_with_instruction(m_major_side.m_position);
 
             set_conflict_ranges();
@@ -642,21 +672,31 @@ struct TransformerImpl {
     {
         m_major_side.m_changeset = changeset;
         m_major_side.m_position = changeset->begin();
+        m_major_side.m_end = changeset->end();
         m_major_side.skip_tombstones();
     }
 
+    void set_dirty(Changeset& changeset)
+    {
+        if (m_defer_dirty)
+            m_dirty_changesets.insert(&changeset);
+        else
+            changeset.set_dirty(true);
+    }
+
     void discard_major()
     {
-        m_major_side.m_position = m_major_side.m_changeset->erase_stable(m_major_side.m_position);
+        m_major_side.m_position =
+            m_major_side.m_changeset->erase_stable(m_major_side.m_position, m_major_side.m_end);
         m_major_side.was_discarded = true; // This terminates the loop in transform_major();
-        m_major_side.m_changeset->set_dirty(true);
+        set_dirty(*m_major_side.m_changeset);
     }
 
     void discard_minor()
     {
         m_minor_side.was_discarded = true;
+        set_dirty(*m_minor_side.m_changeset);
         m_minor_side.m_position = m_minor_side.m_changeset_index->erase_instruction(m_minor_side.m_position);
-        m_minor_side.m_changeset->set_dirty(true);
         m_minor_side.update_changeset_pointer();
     }
 
@@ -666,7 +706,7 @@ struct TransformerImpl {
         REALM_ASSERT(*m_major_side.m_position); // cannot prepend a tombstone
         auto insert_position = m_major_side.m_position;
         m_major_side.m_position = m_major_side.m_changeset->insert_stable(insert_position, instr_begin, instr_end);
-        m_major_side.m_changeset->set_dirty(true);
+        set_dirty(*m_major_side.m_changeset);
         size_t num_prepended = instr_end - instr_begin;
         transform_prepended_major(num_prepended);
     }
@@ -685,7 +725,7 @@ struct TransformerImpl {
         auto insert_position = m_minor_side.m_position.m_pos;
         m_minor_side.m_position.m_pos =
             m_minor_side.m_changeset->insert_stable(insert_position, instr_begin, instr_end);
-        m_minor_side.m_changeset->set_dirty(true);
+        set_dirty(*m_minor_side.m_changeset);
         size_t num_prepended = instr_end - instr_begin;
         // Go back to the instruction that initiated this prepend
         for (size_t i = 0; i < num_prepended; ++i) {
@@ -710,7 +750,7 @@ struct TransformerImpl {
         // instructions in the below, not the instruction that instigated the
         // prepend.
         m_major_side.was_discarded = false;
-        REALM_ASSERT(m_major_side.m_position != m_major_side.m_changeset->end());
+        REALM_ASSERT(m_major_side.m_position != m_major_side.m_end);
 
 #if defined(REALM_DEBUG) // LCOV_EXCL_START
         if (m_trace) {
@@ -732,16 +772,16 @@ struct TransformerImpl {
                 m_minor_side.next_instruction();
             }
 
-            REALM_ASSERT(m_major_side.m_position != m_major_side.m_changeset->end());
+            REALM_ASSERT(m_major_side.m_position != m_major_side.m_end);
             m_major_side.init_with_instruction(m_major_side.m_position);
             REALM_ASSERT(!m_major_side.was_discarded);
-            REALM_ASSERT(m_major_side.m_position != m_major_side.m_changeset->end());
+            REALM_ASSERT(m_major_side.m_position != m_major_side.m_end);
             transform_major();
             if (!m_major_side.was_discarded) {
                 // Discarding an instruction moves to the next.
                 m_major_side.next_instruction();
             }
-            REALM_ASSERT(m_major_side.m_position != m_major_side.m_changeset->end());
+            REALM_ASSERT(m_major_side.m_position != m_major_side.m_end);
 
             m_minor_side.m_position = orig_minor_index;
             m_minor_side.was_discarded = orig_minor_was_discarded;
@@ -2363,16 +2403,100 @@ void TransformerImpl::merge_instructions(MajorSide& their_side, MinorSide& our_s
     if (!their_side.was_discarded && !their_side.was_replaced) {
         const auto& their_after = their_side.get();
         if (!(their_after == their_before)) {
-            their_side.m_changeset->set_dirty(true);
+            set_dirty(*their_side.m_changeset);
         }
     }
 
     if (!our_side.was_discarded && !our_side.was_replaced) {
         const auto& our_after = our_side.get();
         if (!(our_after == our_before)) {
-            our_side.m_changeset->set_dirty(true);
+            set_dirty(*our_side.m_changeset);
+        }
+    }
+}
+
+// Transform the local changesets on several threads, each taking a share of
+// the conflict groups of the incoming changesets. The instructions of
+// different conflict groups never meet, so the result is the same as if the
+// changesets were transformed sequentially. Returns false without having
+// transformed anything if some local instruction conflicts with more than one
+// conflict group, such as a schema change.
+bool transform_in_parallel(util::Span<Changeset*> our_changesets, _impl::ChangesetIndex& their_index,
+                           size_t num_threads)
+{
+    if (their_index.contains_destructive_schema_changes())
+        return false;
+
+    // The slots of the local changesets to transform on each thread. Every
+    // instruction in a slot, including those prepended to it during the
+    // transform, is in the same conflict group.
+    struct Slot {
+        Changeset* changeset;
+        Changeset::iterator position;
+    };
+    std::vector<std::vector<Slot>> partitions(num_threads);
+    std::unordered_map<const _impl::ChangesetIndex::Ranges*, size_t> partition_of_group;
+    for (Changeset* changeset : our_changesets) {
+        auto end = changeset->end();
+        for (auto it = changeset->begin(); it != end;) {
+            Changeset::iterator slot{it.m_inner};
+            const _impl::ChangesetIndex::Ranges* group = nullptr;
+            for (; it != end && it.m_inner == slot.m_inner; ++it) {
+                if (!*it)
+                    continue;
+                const Instruction& instr = **it;
+                if (_impl::is_schema_change(instr))
+                    return false;
+                _impl::ChangesetIndex::GlobalID ids[2];
+                size_t num_ids = _impl::get_object_ids_in_instruction(*changeset, instr, ids, 2);
+                REALM_ASSERT(num_ids >= 1);
+                auto ranges = their_index.get_modifications_for_object(ids[0]);
+                if (ranges->empty())
+                    continue;
+                if (group && group != ranges)
+                    return false;
+                group = ranges;
+            }
+            if (!group)
+                continue; // Nothing to transform against
+
+            auto [entry, inserted] = partition_of_group.emplace(group, 0);
+            if (inserted) {
+                auto smallest = std::min_element(partitions.begin(), partitions.end(), [](auto& a, auto& b) {
+                    return a.size() < b.size();
+                });
+                entry->second = size_t(smallest - partitions.begin());
+            }
+            partitions[entry->second].push_back({changeset, slot});
         }
     }
+
+    auto transform_partition = [&their_index](const std::vector<Slot>& slots) {
+        TransformerImpl transformer{false};
+        transformer.m_defer_dirty = true;
+        transformer.m_minor_side.m_changeset_index = &their_index;
+        for (auto& slot : slots) {
+            transformer.transform_slot(slot.changeset, slot.position); // Throws
+        }
+        return std::move(transformer.m_dirty_changesets);
+    };
+    std::vector<std::future<std::set<Changeset*>>> workers;
+    for (size_t i = 1; i < partitions.size(); ++i) {
+        if (!partitions[i].empty())
+            workers.push_back(std::async(std::launch::async, transform_partition, std::cref(partitions[i])));
+    }
+    auto dirty_changesets = transform_partition(partitions[0]); // Throws
+    for (auto& worker : workers) {
+        worker.wait();
+    }
+    for (auto& worker : workers) {
+        auto dirty = worker.get(); // Throws
+        dirty_changesets.insert(dirty.begin(), dirty.end());
+    }
+    for (Changeset* changeset : dirty_changesets) {
+        changeset->set_dirty(true);
+    }
+    return true;
 }
 
 } // anonymous namespace
@@ -2476,17 +2600,26 @@ void Transformer::merge_changesets(file_ident_type local_file_ident, util::Span<
     static_cast<void>(local_file_ident);
 #endif // REALM_DEBUG LCOV_EXCL_STOP
 
-    for (size_t i = 0; i < our_changesets.size(); ++i) {
-        logger.trace(
-            util::LogCategory::changeset,
-            "Transforming local changeset [%1/%2] through %3 incoming changeset(s) with %4 conflict group(s)", i + 1,
-            our_changesets.size(), their_changesets.size(), their_index.get_num_conflict_groups());
-        Changeset* our_changeset = our_changesets[i];
-
-        transformer.m_major_side.set_next_changeset(our_changeset);
-        // MinorSide uses the index to find the Changeset.
-        transformer.m_minor_side.m_changeset_index = &their_index;
-        transformer.transform(); // Throws
+    size_t num_threads = trace ? 1 : std::min(m_max_threads, their_index.get_num_conflict_groups());
+    if (num_threads > 1 && transform_in_parallel(our_changesets, their_index, num_threads)) { // Throws
+        logger.trace(util::LogCategory::changeset,
+                     "Transformed %1 local changeset(s) through %2 incoming changeset(s) on %3 threads",
+                     our_changesets.size(), their_changesets.size(), num_threads);
+    }
+    else {
+        for (size_t i = 0; i < our_changesets.size(); ++i) {
+            logger.trace(util::LogCategory::changeset,
+                         "Transforming local changeset [%1/%2] through %3 incoming changeset(s) with %4 conflict "
+                         "group(s)",
+                         i + 1, our_changesets.size(), their_changesets.size(),
+                         their_index.get_num_conflict_groups());
+            Changeset* our_changeset = our_changesets[i];
+
+            transformer.m_major_side.set_next_changeset(our_changeset);
+            // MinorSide uses the index to find the Changeset.
+            transformer.m_minor_side.m_changeset_index = &their_index;
+            transformer.transform(); // Throws
+        }
     }
 
     logger.debug(util::LogCategory::changeset,
@@ -2522,6 +2655,7 @@ size_t Transformer::transform_remote_changesets(TransformHistory& history, file_
                                                 util::FunctionRef<bool(const Changeset*)> changeset_applier,
                                                 util::Logger& logger)
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::sync_transform};
     REALM_ASSERT(local_file_ident != 0);
 
     std::vector<Changeset*> our_changesets;
@@ -2556,7 +2690,9 @@ size_t Transformer::transform_remote_changesets(TransformHistory& history, file_
         bool must_apply_all = false;
 
         if (!our_changesets.empty()) {
+            auto merge_start = std::chrono::steady_clock::now();
             merge_changesets(local_file_ident, {&*p, same_base_range_end}, our_changesets, logger); // Throws
+            m_stats.transform_time += std::chrono::steady_clock::now() - merge_start;
             // We need to apply all transformed changesets if at least one reciprocal changeset was modified
             // during OT.
             must_apply_all = std::any_of(our_changesets.begin(), our_changesets.end(), [](const Changeset* c) {
@@ -2565,12 +2701,14 @@ size_t Transformer::transform_remote_changesets(TransformHistory& history, file_
         }
 
         auto continue_applying = true;
+        auto apply_start = std::chrono::steady_clock::now();
         for (; p != same_base_range_end && continue_applying; ++p) {
             // It is safe to stop applying the changesets if:
             //      1. There are no reciprocal changesets
             //      2. No reciprocal changeset was modified
             continue_applying = changeset_applier(p) || must_apply_all;
         }
+        m_stats.apply_time += std::chrono::steady_clock::now() - apply_start;
         if (!continue_applying) {
             break;
         }
@@ -2591,17 +2729,22 @@ Changeset& Transformer::get_reciprocal_transform(TransformHistory& history, file
 {
     auto& changeset = m_reciprocal_transform_cache[version]; // Throws
     if (changeset.empty()) {
-        bool is_compressed = false;
-        ChunkedBinaryData data = history.get_reciprocal_transform(version, is_compressed);
-        ChunkedBinaryInputStream in{data};
-        if (is_compressed) {
-            size_t total_size;
-            auto decompressed = util::compression::decompress_nonportable_input_stream(in, total_size);
-            REALM_ASSERT(decompressed);
-            sync::parse_changeset(*decompressed, changeset); // Throws
-        }
-        else {
-            sync::parse_changeset(in, changeset); // Throws
+        bool cached = m_shared_reciprocal_transform_cache &&
+                      m_shared_reciprocal_transform_cache->take(version, changeset); // Throws
+        if (!cached) {
+            bool is_compressed = false;
+            ChunkedBinaryData data = history.get_reciprocal_transform(version, is_compressed);
+            ChunkedBinaryInputStream in{data};
+            if (is_compressed) {
+                size_t total_size;
+                auto decompressed = util::compression::decompress_nonportable_input_stream(
+                    in, total_size, history.get_changeset_dictionary());
+                REALM_ASSERT(decompressed);
+                sync::parse_changeset(*decompressed, changeset); // Throws
+            }
+            else {
+                sync::parse_changeset(in, changeset); // Throws
+            }
         }
 
         changeset.version = version;
@@ -2621,14 +2764,110 @@ void Transformer::flush_reciprocal_transform_cache(TransformHistory& history)
     auto changesets = std::move(m_reciprocal_transform_cache);
     m_reciprocal_transform_cache.clear();
     ChangesetEncoder::Buffer output_buffer;
+    m_stats.reciprocal_changesets += changesets.size();
     for (const auto& [version, changeset] : changesets) {
         if (changeset.is_dirty()) {
+            ++m_stats.modified_reciprocal_changesets;
             encode_changeset(changeset, output_buffer); // Throws
             BinaryData data{output_buffer.data(), output_buffer.size()};
             history.set_reciprocal_transform(version, data); // Throws
             output_buffer.clear();
         }
     }
+
+    if (m_shared_reciprocal_transform_cache) {
+        for (auto& [version, changeset] : changesets) {
+            // The changeset now matches the history
+            changeset.set_dirty(false);
+            m_shared_reciprocal_transform_cache->put(version, std::move(changeset));
+        }
+    }
+}
+
+
+void ReciprocalTransformCache::set_budget(std::size_t budget)
+{
+    util::CheckedLockGuard lock(m_mutex);
+    m_budget = budget;
+    evict_to_budget();
+}
+
+std::size_t ReciprocalTransformCache::get_budget() const noexcept
+{
+    util::CheckedLockGuard lock(m_mutex);
+    return m_budget;
+}
+
+auto ReciprocalTransformCache::get_metrics() const noexcept -> Metrics
+{
+    util::CheckedLockGuard lock(m_mutex);
+    Metrics metrics = m_metrics;
+    metrics.num_changesets = m_entries.size();
+    return metrics;
+}
+
+void ReciprocalTransformCache::clear() noexcept
+{
+    util::CheckedLockGuard lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_metrics.memory_used = 0;
+}
+
+bool ReciprocalTransformCache::take(version_type version, Changeset& changeset)
+{
+    util::CheckedLockGuard lock(m_mutex);
+    auto it = m_entries.find(version);
+    if (it == m_entries.end()) {
+        if (m_budget > 0)
+            ++m_metrics.misses;
+        return false;
+    }
+    ++m_metrics.hits;
+    changeset = std::move(it->second.changeset);
+    m_metrics.memory_used -= it->second.size;
+    m_lru.erase(it->second.lru_position);
+    m_entries.erase(it);
+    return true;
+}
+
+void ReciprocalTransformCache::put(version_type version, Changeset&& changeset)
+{
+    util::CheckedLockGuard lock(m_mutex);
+    if (m_budget == 0)
+        return;
+    auto it = m_entries.find(version);
+    if (it != m_entries.end()) {
+        m_metrics.memory_used -= it->second.size;
+        m_lru.erase(it->second.lru_position);
+        m_entries.erase(it);
+    }
+    size_t size = estimate_size(changeset);
+    m_lru.push_front(version);                                                    // Throws
+    m_entries.emplace(version, Entry{std::move(changeset), size, m_lru.begin()}); // Throws
+    m_metrics.memory_used += size;
+    evict_to_budget();
+}
+
+void ReciprocalTransformCache::evict_to_budget()
+{
+    while (m_metrics.memory_used > m_budget) {
+        REALM_ASSERT(!m_lru.empty());
+        auto it = m_entries.find(m_lru.back());
+        m_metrics.memory_used -= it->second.size;
+        m_entries.erase(it);
+        m_lru.pop_back();
+        ++m_metrics.evictions;
+    }
+}
+
+std::size_t ReciprocalTransformCache::estimate_size(const Changeset& changeset) noexcept
+{
+    // Instructions which own heap memory, such as paths, are only counted by
+    // their inline size
+    std::size_t num_slots = std::size_t(changeset.cend().m_inner - changeset.cbegin().m_inner);
+    return sizeof(Entry) + num_slots * sizeof(Instruction) + changeset.string_buffer().capacity() +
+           changeset.interned_strings().capacity() * sizeof(StringBufferRange);
 }
 
 void parse_remote_changeset(const RemoteChangeset& remote_changeset, Changeset& parsed_changeset)
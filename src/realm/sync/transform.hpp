@@ -3,8 +3,14 @@
 #define REALM_SYNC_TRANSFORM_HPP
 
 #include <realm/chunked_binary.hpp>
+#include <realm/sync/changeset.hpp>
 #include <realm/sync/instructions.hpp>
 #include <realm/sync/protocol.hpp>
+#include <realm/util/checked_mutex.hpp>
+
+#include <chrono>
+#include <list>
+#include <map>
 
 namespace realm {
 namespace sync {
@@ -103,6 +109,13 @@ public:
     /// the one whose untransformed changeset produced the specified version.
     virtual ChunkedBinaryData get_reciprocal_transform(version_type version, bool& is_compressed) const = 0;
 
+    /// The preset dictionary that compressed reciprocal changesets may be
+    /// compressed with, if any.
+    virtual util::Span<const char> get_changeset_dictionary() const
+    {
+        return {};
+    }
+
     /// Replace the specified reciprocally transformed changeset. The targeted
     /// history entry is the one whose untransformed changeset produced the
     /// specified version.
@@ -116,6 +129,64 @@ public:
 
 class TransformError; // Exception
 
+/// A cache of parsed reciprocal changesets which outlives the Transformer of
+/// a single transform round, so that the local changesets do not have to be
+/// read from the history and parsed again in every round. When the estimated
+/// memory used by the cached changesets exceeds the budget, the least recently
+/// used ones are evicted. A budget of zero disables the cache.
+///
+/// The cached changesets are only valid as long as the reciprocal transforms in
+/// the history are changed by nothing but Transformers using this cache. The
+/// cache must be cleared if a write transaction in which a Transformer flushed
+/// its changesets to it is rolled back, or if the history is rewritten.
+class ReciprocalTransformCache {
+public:
+    using Changeset = sync::Changeset;
+    using version_type = sync::version_type;
+
+    struct Metrics {
+        std::uint_fast64_t hits = 0;
+        std::uint_fast64_t misses = 0;
+        std::uint_fast64_t evictions = 0;
+        std::size_t num_changesets = 0;
+        std::size_t memory_used = 0;
+    };
+
+    explicit ReciprocalTransformCache(std::size_t budget = 0) noexcept
+        : m_budget(budget)
+    {
+    }
+
+    void set_budget(std::size_t budget) REQUIRES(!m_mutex);
+    std::size_t get_budget() const noexcept REQUIRES(!m_mutex);
+    Metrics get_metrics() const noexcept REQUIRES(!m_mutex);
+    void clear() noexcept REQUIRES(!m_mutex);
+
+    /// Move the reciprocal changeset of \a version out of the cache into \a
+    /// changeset. Returns false if it was not in the cache.
+    bool take(version_type version, Changeset& changeset) REQUIRES(!m_mutex);
+    /// Add the reciprocal changeset of \a version to the cache as the most
+    /// recently used one, and evict changesets until the budget is met.
+    void put(version_type version, Changeset&& changeset) REQUIRES(!m_mutex);
+
+private:
+    struct Entry {
+        Changeset changeset;
+        std::size_t size;
+        std::list<version_type>::iterator lru_position;
+    };
+
+    mutable util::CheckedMutex m_mutex;
+    std::size_t m_budget GUARDED_BY(m_mutex);
+    std::map<version_type, Entry> m_entries GUARDED_BY(m_mutex);
+    // Most recently used first
+    std::list<version_type> m_lru GUARDED_BY(m_mutex);
+    Metrics m_metrics GUARDED_BY(m_mutex);
+
+    void evict_to_budget() REQUIRES(m_mutex);
+    static std::size_t estimate_size(const Changeset&) noexcept;
+};
+
 class Transformer {
 public:
     using Changeset = sync::Changeset;
@@ -177,8 +248,47 @@ public:
                                        util::Span<Changeset>,
                                        util::FunctionRef<bool(const Changeset*)> changeset_applier, util::Logger&);
 
+    /// Transform on up to this many threads. The incoming changesets are
+    /// indexed by conflict group, i.e. by sets of objects whose instructions
+    /// can affect each other, and local instructions of different conflict
+    /// groups are transformed concurrently. Local changesets with schema
+    /// changes, and incoming changesets with destructive schema changes, are
+    /// always transformed on a single thread. The default is 1.
+    void set_max_threads(size_t max_threads) noexcept
+    {
+        m_max_threads = std::max<size_t>(max_threads, 1);
+    }
+
+    /// Look up reciprocal changesets in \a cache before reading them from
+    /// the history, and keep them there once they have been flushed to the
+    /// history at the end of transform_remote_changesets().
+    void set_reciprocal_transform_cache(ReciprocalTransformCache* cache) noexcept
+    {
+        m_shared_reciprocal_transform_cache = cache;
+    }
+
+    /// Statistics of the calls to transform_remote_changesets() on this
+    /// Transformer.
+    struct Stats {
+        /// The number of local changesets the remote changesets were
+        /// transformed against, and how many of those were modified by the
+        /// transformation, i.e. conflicted with the remote changes.
+        std::size_t reciprocal_changesets = 0;
+        std::size_t modified_reciprocal_changesets = 0;
+        /// Time spent transforming and applying the changesets.
+        std::chrono::nanoseconds transform_time{0};
+        std::chrono::nanoseconds apply_time{0};
+    };
+    const Stats& get_stats() const noexcept
+    {
+        return m_stats;
+    }
+
 private:
     std::map<version_type, Changeset> m_reciprocal_transform_cache;
+    Stats m_stats;
+    ReciprocalTransformCache* m_shared_reciprocal_transform_cache = nullptr;
+    size_t m_max_threads = 1;
 
     Changeset& get_reciprocal_transform(TransformHistory&, file_ident_type local_file_ident, version_type version,
                                         const HistoryEntry&);
@@ -20,15 +20,19 @@
 
 #include <realm/alloc_slab.hpp>
 #include <realm/array_binary.hpp>
+#include <realm/array_basic.hpp>
 #include <realm/array_bool.hpp>
 #include <realm/array_decimal128.hpp>
 #include <realm/array_fixed_bytes.hpp>
+#include <realm/array_key.hpp>
+#include <realm/array_mixed.hpp>
 #include <realm/array_string.hpp>
 #include <realm/array_timestamp.hpp>
 #include <realm/db.hpp>
 #include <realm/dictionary.hpp>
 #include <realm/exceptions.hpp>
 #include <realm/impl/destroy_guard.hpp>
+#include <realm/index_sorted.hpp>
 #include <realm/index_string.hpp>
 #include <realm/query_conditions_tpl.hpp>
 #include <realm/replication.hpp>
@@ -356,6 +360,7 @@ Table::Table(Allocator& alloc)
     , m_index_refs(m_alloc)
     , m_opposite_table(m_alloc)
     , m_opposite_column(m_alloc)
+    , m_compound_index_refs(m_alloc)
     , m_repl(&g_dummy_replication)
     , m_own_ref(this, alloc.get_instance_version())
 {
@@ -363,6 +368,7 @@ Table::Table(Allocator& alloc)
     m_index_refs.set_parent(&m_top, top_position_for_search_indexes);
     m_opposite_table.set_parent(&m_top, top_position_for_opposite_table);
     m_opposite_column.set_parent(&m_top, top_position_for_opposite_column);
+    m_compound_index_refs.set_parent(&m_top, top_position_for_compound_indexes);
 
     ref_type ref = create_empty_table(m_alloc); // Throws
     ArrayParent* parent = nullptr;
@@ -378,6 +384,7 @@ Table::Table(Replication* const* repl, Allocator& alloc)
     , m_index_refs(m_alloc)
     , m_opposite_table(m_alloc)
     , m_opposite_column(m_alloc)
+    , m_compound_index_refs(m_alloc)
     , m_repl(repl)
     , m_own_ref(this, alloc.get_instance_version())
 {
@@ -385,6 +392,7 @@ Table::Table(Replication* const* repl, Allocator& alloc)
     m_index_refs.set_parent(&m_top, top_position_for_search_indexes);
     m_opposite_table.set_parent(&m_top, top_position_for_opposite_table);
     m_opposite_column.set_parent(&m_top, top_position_for_opposite_column);
+    m_compound_index_refs.set_parent(&m_top, top_position_for_compound_indexes);
     m_cookie = cookie_created;
 }
 
@@ -567,11 +575,25 @@ TableKey Table::get_key_direct(Allocator& alloc, ref_type top_ref)
     }
 }
 
+uint64_t Table::get_version_direct(Allocator& alloc, ref_type top_ref)
+{
+    Array table_top(alloc);
+    table_top.init_from_ref(top_ref);
+    if (table_top.size() > top_position_for_version) {
+        RefOrTagged rot = table_top.get_as_ref_or_tagged(top_position_for_version);
+        if (rot.is_tagged())
+            return uint64_t(rot.get_as_int());
+    }
+    return 0;
+}
+
 
 void Table::init(ref_type top_ref, ArrayParent* parent, size_t ndx_in_parent, bool is_writable, bool is_frzn)
 {
     REALM_ASSERT(!(is_writable && is_frzn));
     m_is_frozen = is_frzn;
+    // Frozen tables may be read from several threads at once
+    m_clusters.set_lookup_cache_enabled(!is_frzn);
     m_alloc.set_read_only(!is_writable);
     // Load from allocated memory
     m_top.set_parent(parent, ndx_in_parent);
@@ -634,13 +656,7 @@ void Table::init(ref_type top_ref, ArrayParent* parent, size_t ndx_in_parent, bo
     auto rot_pk_key = m_top.get_as_ref_or_tagged(top_position_for_pk_col);
     m_primary_key_col = rot_pk_key.is_tagged() ? ColKey(rot_pk_key.get_as_int()) : ColKey();
 
-    if (m_top.size() <= top_position_for_flags) {
-        m_table_type = Type::TopLevel;
-    }
-    else {
-        uint64_t flags = m_top.get_as_ref_or_tagged(top_position_for_flags).get_as_int();
-        m_table_type = Type(flags & table_type_mask);
-    }
+    load_flags();
     m_has_any_embedded_objects.reset();
 
     if (m_top.size() > top_position_for_tombstones && m_top.get_as_ref(top_position_for_tombstones)) {
@@ -653,6 +669,8 @@ void Table::init(ref_type top_ref, ArrayParent* parent, size_t ndx_in_parent, bo
     else {
         m_tombstones = nullptr;
     }
+    refresh_compound_index_accessors();
+    refresh_geospatial_index_accessor();
     m_cookie = cookie_initialized;
 }
 
@@ -678,8 +696,10 @@ ColKey Table::do_insert_column(ColKey col_key, DataType type, StringData name, T
     return col_key;
 }
 
+using ClusterTraversal = util::FunctionRef<void(ClusterTree::TraverseFunction)>;
+
 template <typename Type>
-static void do_bulk_insert_index(Table* table, SearchIndex* index, ColKey col_key, Allocator& alloc)
+static void do_bulk_insert_index(ClusterTraversal traverse, SearchIndex* index, ColKey col_key, Allocator& alloc)
 {
     using LeafType = typename ColumnTypeTraits<Type>::cluster_leaf_type;
     LeafType leaf(alloc);
@@ -690,11 +710,11 @@ static void do_bulk_insert_index(Table* table, SearchIndex* index, ColKey col_ke
         return IteratorControl::AdvanceToNext;
     };
 
-    table->traverse_clusters(f);
+    traverse(f);
 }
 
 
-static void do_bulk_insert_index_list(Table* table, SearchIndex* index, ColKey col_key, Allocator& alloc)
+static void do_bulk_insert_index_list(ClusterTraversal traverse, SearchIndex* index, ColKey col_key, Allocator& alloc)
 {
     ArrayInteger leaf(alloc);
 
@@ -704,66 +724,105 @@ static void do_bulk_insert_index_list(Table* table, SearchIndex* index, ColKey c
         return IteratorControl::AdvanceToNext;
     };
 
-    table->traverse_clusters(f);
+    traverse(f);
 }
 
-void Table::populate_search_index(ColKey col_key)
+static void do_populate_search_index(ClusterTraversal traverse, SearchIndex* index, ColKey col_key, DataType type,
+                                     Allocator& alloc)
 {
-    auto col_ndx = col_key.get_index().val;
-    SearchIndex* index = m_index_accessors[col_ndx].get();
-    DataType type = get_column_type(col_key);
-
     if (type == type_Int) {
-        if (is_nullable(col_key)) {
-            do_bulk_insert_index<Optional<int64_t>>(this, index, col_key, get_alloc());
+        if (col_key.is_nullable()) {
+            do_bulk_insert_index<Optional<int64_t>>(traverse, index, col_key, alloc);
         }
         else {
-            do_bulk_insert_index<int64_t>(this, index, col_key, get_alloc());
+            do_bulk_insert_index<int64_t>(traverse, index, col_key, alloc);
         }
     }
     else if (type == type_Bool) {
-        if (is_nullable(col_key)) {
-            do_bulk_insert_index<Optional<bool>>(this, index, col_key, get_alloc());
+        if (col_key.is_nullable()) {
+            do_bulk_insert_index<Optional<bool>>(traverse, index, col_key, alloc);
         }
         else {
-            do_bulk_insert_index<bool>(this, index, col_key, get_alloc());
+            do_bulk_insert_index<bool>(traverse, index, col_key, alloc);
         }
     }
     else if (type == type_String) {
         if (col_key.is_list()) {
-            do_bulk_insert_index_list(this, index, col_key, get_alloc());
+            do_bulk_insert_index_list(traverse, index, col_key, alloc);
         }
         else {
-            do_bulk_insert_index<StringData>(this, index, col_key, get_alloc());
+            do_bulk_insert_index<StringData>(traverse, index, col_key, alloc);
         }
     }
     else if (type == type_Timestamp) {
-        do_bulk_insert_index<Timestamp>(this, index, col_key, get_alloc());
+        do_bulk_insert_index<Timestamp>(traverse, index, col_key, alloc);
+    }
+    else if (type == type_Float) {
+        if (col_key.is_nullable()) {
+            do_bulk_insert_index<Optional<float>>(traverse, index, col_key, alloc);
+        }
+        else {
+            do_bulk_insert_index<float>(traverse, index, col_key, alloc);
+        }
+    }
+    else if (type == type_Double) {
+        if (col_key.is_nullable()) {
+            do_bulk_insert_index<Optional<double>>(traverse, index, col_key, alloc);
+        }
+        else {
+            do_bulk_insert_index<double>(traverse, index, col_key, alloc);
+        }
     }
     else if (type == type_ObjectId) {
-        if (is_nullable(col_key)) {
-            do_bulk_insert_index<Optional<ObjectId>>(this, index, col_key, get_alloc());
+        if (col_key.is_nullable()) {
+            do_bulk_insert_index<Optional<ObjectId>>(traverse, index, col_key, alloc);
         }
         else {
-            do_bulk_insert_index<ObjectId>(this, index, col_key, get_alloc());
+            do_bulk_insert_index<ObjectId>(traverse, index, col_key, alloc);
         }
     }
     else if (type == type_UUID) {
-        if (is_nullable(col_key)) {
-            do_bulk_insert_index<Optional<UUID>>(this, index, col_key, get_alloc());
+        if (col_key.is_nullable()) {
+            do_bulk_insert_index<Optional<UUID>>(traverse, index, col_key, alloc);
         }
         else {
-            do_bulk_insert_index<UUID>(this, index, col_key, get_alloc());
+            do_bulk_insert_index<UUID>(traverse, index, col_key, alloc);
         }
     }
     else if (type == type_Mixed) {
-        do_bulk_insert_index<Mixed>(this, index, col_key, get_alloc());
+        do_bulk_insert_index<Mixed>(traverse, index, col_key, alloc);
     }
     else {
         REALM_ASSERT_RELEASE(false && "Data type does not support search index");
     }
 }
 
+void Table::populate_search_index(ColKey col_key)
+{
+    populate_search_index(col_key, [this](ClusterTree::TraverseFunction func) {
+        traverse_clusters(func);
+    });
+}
+
+void Table::populate_search_index(ColKey col_key, util::FunctionRef<void(ClusterTree::TraverseFunction)> traverse)
+{
+    auto col_ndx = col_key.get_index().val;
+    SearchIndex* index = m_index_accessors[col_ndx].get();
+    DataType type = get_column_type(col_key);
+    auto populate = [&] {
+        do_populate_search_index(traverse, index, col_key, type, get_alloc());
+    };
+
+    // An empty string index is built from all the values at once
+    StringIndex* string_index = dynamic_cast<StringIndex*>(index);
+    if (string_index && string_index->is_empty()) {
+        string_index->build(populate);
+    }
+    else {
+        populate();
+    }
+}
+
 void Table::erase_from_search_indexes(ObjKey key)
 {
     // Tombstones do not use index - will crash if we try to erase values
@@ -773,6 +832,11 @@ void Table::erase_from_search_indexes(ObjKey key)
                 index->erase(key);
             }
         }
+        for (auto&& index : m_compound_indexes) {
+            index->erase(key);
+        }
+        if (m_geo_index)
+            m_geo_index->erase(key);
     }
 }
 
@@ -844,6 +908,22 @@ void Table::update_indexes(ObjKey key, const FieldValues& values)
                         index->insert(key, init_value.get<ObjectId>());
                     }
                     break;
+                case col_type_Float:
+                    if (init_value.is_null()) {
+                        index->insert(key, ArrayFloatNull::default_value(nullable));
+                    }
+                    else {
+                        index->insert(key, init_value.get<float>());
+                    }
+                    break;
+                case col_type_Double:
+                    if (init_value.is_null()) {
+                        index->insert(key, ArrayDoubleNull::default_value(nullable));
+                    }
+                    else {
+                        index->insert(key, init_value.get<double>());
+                    }
+                    break;
                 case col_type_Mixed:
                     index->insert(key, init_value);
                     break;
@@ -860,6 +940,30 @@ void Table::update_indexes(ObjKey key, const FieldValues& values)
             }
         }
     }
+
+    // The object is already in the cluster tree, so its values can be read from there
+    for (auto&& index : m_compound_indexes) {
+        index->insert(key);
+    }
+    if (m_geo_index)
+        m_geo_index->insert(key);
+}
+
+void Table::bulk_update_indexes(const std::vector<ObjKey>& keys, size_t begin,
+                                util::FunctionRef<void(ClusterTree::TraverseFunction)> traverse)
+{
+    for (size_t column_ndx = 0; column_ndx < m_index_accessors.size(); column_ndx++) {
+        if (m_index_accessors[column_ndx])
+            populate_search_index(m_leaf_ndx2colkey[column_ndx], traverse);
+    }
+    for (auto&& index : m_compound_indexes) {
+        for (size_t i = begin; i < keys.size(); ++i)
+            index->insert(keys[i]);
+    }
+    if (m_geo_index) {
+        for (size_t i = begin; i < keys.size(); ++i)
+            m_geo_index->insert(keys[i]);
+    }
 }
 
 void Table::clear_indexes()
@@ -869,6 +973,11 @@ void Table::clear_indexes()
             index->clear();
         }
     }
+    for (auto&& index : m_compound_indexes) {
+        index->clear();
+    }
+    if (m_geo_index)
+        m_geo_index->clear();
 }
 
 void Table::do_add_search_index(ColKey col_key, IndexType type)
@@ -879,9 +988,19 @@ void Table::do_add_search_index(ColKey col_key, IndexType type)
     if (m_index_accessors[column_ndx] != nullptr)
         return;
 
-    if (!StringIndex::type_supported(DataType(col_key.get_type())) ||
-        (col_key.is_collection() && !(col_key.is_list() && col_key.get_type() == col_type_String)) ||
-        (type == IndexType::Fulltext && col_key.get_type() != col_type_String)) {
+    if (type == IndexType::Sorted) {
+        if (!SortedIndex::type_supported(DataType(col_key.get_type())) || col_key.is_collection())
+            throw IllegalOperation(
+                util::format("Sorted index not supported for this property: %1", get_column_name(col_key)));
+    }
+    else if (type == IndexType::CaseInsensitive) {
+        if (col_key.get_type() != col_type_String || col_key.is_collection())
+            throw IllegalOperation(util::format("Case insensitive index not supported for this property: %1",
+                                                get_column_name(col_key)));
+    }
+    else if (!StringIndex::type_supported(DataType(col_key.get_type())) ||
+             (col_key.is_collection() && !(col_key.is_list() && col_key.get_type() == col_type_String)) ||
+             (type == IndexType::Fulltext && col_key.get_type() != col_type_String)) {
         // Not ideal, but this is what we used to throw, so keep throwing that for compatibility reasons, even though
         // it should probably be a type mismatch exception instead.
         throw IllegalOperation(util::format("Index not supported for this property: %1", get_column_name(col_key)));
@@ -893,8 +1012,15 @@ void Table::do_add_search_index(ColKey col_key, IndexType type)
     REALM_ASSERT(m_index_accessors[column_ndx] == nullptr);
 
     // Create the index
-    m_index_accessors[column_ndx] =
-        std::make_unique<StringIndex>(ClusterColumn(&m_clusters, col_key, type), get_alloc()); // Throws
+    if (type == IndexType::Sorted || type == IndexType::CaseInsensitive) {
+        bool case_insensitive = type == IndexType::CaseInsensitive;
+        m_index_accessors[column_ndx] = std::make_unique<SortedIndex>(ClusterColumn(&m_clusters, col_key, type),
+                                                                      get_alloc(), case_insensitive); // Throws
+    }
+    else {
+        m_index_accessors[column_ndx] =
+            std::make_unique<StringIndex>(ClusterColumn(&m_clusters, col_key, type), get_alloc()); // Throws
+    }
     SearchIndex* index = m_index_accessors[column_ndx].get();
     // Insert ref to index
     index->set_parent(&m_index_refs, column_ndx);
@@ -902,6 +1028,17 @@ void Table::do_add_search_index(ColKey col_key, IndexType type)
     m_index_refs.set(column_ndx, index->get_ref()); // Throws
 
     populate_search_index(col_key);
+    if (auto string_index = dynamic_cast<StringIndex*>(index))
+        string_index->set_deferred(m_defer_index_updates && col_key != m_primary_key_col);
+}
+
+void Table::check_file_format_version(int version, const char* feature) const
+{
+    // Tables outside a group are never stored in a file of an older format
+    if (Group* group = get_parent_group()) {
+        if (group->get_file_format_version() < version)
+            throw IllegalOperation(util::format("%1 requires file format version %2 or later", feature, version));
+    }
 }
 
 void Table::add_search_index(ColKey col_key, IndexType type)
@@ -914,28 +1051,27 @@ void Table::add_search_index(ColKey col_key, IndexType type)
 
     if (col_key == m_primary_key_col && type == IndexType::Fulltext)
         throw InvalidColumnKey("primary key cannot have a full text index");
+    if (col_key == m_primary_key_col && (type == IndexType::Sorted || type == IndexType::CaseInsensitive))
+        throw InvalidColumnKey("primary key cannot have a sorted index");
+    if (type == IndexType::Sorted && search_index_type(col_key) != type)
+        check_file_format_version(25, "Sorted index"); // Throws
+    if (type == IndexType::CaseInsensitive && search_index_type(col_key) != type)
+        check_file_format_version(25, "Case insensitive index"); // Throws
 
     switch (type) {
         case IndexType::None:
             remove_search_index(col_key);
             return;
         case IndexType::Fulltext:
-            // Early-out if already indexed
-            if (attr.test(col_attr_FullText_Indexed)) {
-                REALM_ASSERT(search_index_type(col_key) == IndexType::Fulltext);
-                return;
-            }
-            if (attr.test(col_attr_Indexed)) {
-                this->remove_search_index(col_key);
-            }
-            break;
         case IndexType::General:
-            if (attr.test(col_attr_Indexed)) {
-                REALM_ASSERT(search_index_type(col_key) == IndexType::General);
+        case IndexType::Sorted:
+        case IndexType::CaseInsensitive:
+            // Early-out if already indexed
+            if (search_index_type(col_key) == type)
                 return;
-            }
-            if (attr.test(col_attr_FullText_Indexed)) {
+            if (m_index_accessors[col_key.get_index().val]) {
                 this->remove_search_index(col_key);
+                attr = m_spec.get_column_attr(spec_ndx);
             }
             break;
     }
@@ -943,7 +1079,20 @@ void Table::add_search_index(ColKey col_key, IndexType type)
     do_add_search_index(col_key, type);
 
     // Update spec
-    attr.set(type == IndexType::Fulltext ? col_attr_FullText_Indexed : col_attr_Indexed);
+    switch (type) {
+        case IndexType::Fulltext:
+            attr.set(col_attr_FullText_Indexed);
+            break;
+        case IndexType::Sorted:
+            attr.set(col_attr_Sorted_Indexed);
+            break;
+        case IndexType::CaseInsensitive:
+            attr.set(col_attr_CaseInsensitive_Indexed);
+            break;
+        default:
+            attr.set(col_attr_Indexed);
+            break;
+    }
     m_spec.set_column_attr(spec_ndx, attr); // Throws
 }
 
@@ -969,9 +1118,113 @@ void Table::remove_search_index(ColKey col_key)
     auto attr = m_spec.get_column_attr(spec_ndx);
     attr.reset(col_attr_Indexed);
     attr.reset(col_attr_FullText_Indexed);
+    attr.reset(col_attr_Sorted_Indexed);
+    attr.reset(col_attr_CaseInsensitive_Indexed);
     m_spec.set_column_attr(spec_ndx, attr); // Throws
 }
 
+void Table::add_compound_index(const std::vector<ColKey>& columns)
+{
+    if (columns.size() < CompoundIndex::min_columns || columns.size() > CompoundIndex::max_columns)
+        throw InvalidArgument(util::format("A compound index must have between %1 and %2 properties",
+                                           CompoundIndex::min_columns, CompoundIndex::max_columns));
+    for (auto it = columns.begin(); it != columns.end(); ++it) {
+        check_column(*it);
+        if (!CompoundIndex::type_supported(*it))
+            throw IllegalOperation(
+                util::format("Compound index not supported for this property: %1", get_column_name(*it)));
+        if (std::find(columns.begin(), it, *it) != it)
+            throw InvalidArgument(
+                util::format("Property '%1' appears more than once in compound index", get_column_name(*it)));
+    }
+
+    // Early-out if already indexed
+    if (has_compound_index(columns))
+        return;
+    check_file_format_version(25, "Compound index"); // Throws
+
+    if (!m_compound_index_refs.is_attached()) {
+        while (m_top.size() <= top_position_for_compound_indexes)
+            m_top.add(0); // Throws
+        MemRef mem = Array::create_empty_array(Array::type_HasRefs, false, m_alloc); // Throws
+        m_top.set_as_ref(top_position_for_compound_indexes, mem.get_ref());
+        m_compound_index_refs.init_from_parent();
+    }
+
+    auto index = std::make_unique<CompoundIndex>(*this, columns, get_alloc()); // Throws
+    index->set_parent(&m_compound_index_refs, m_compound_index_refs.size());
+    m_compound_index_refs.add(from_ref(index->get_ref())); // Throws
+    index->build();                                        // Throws
+    m_compound_indexes.push_back(std::move(index));
+}
+
+void Table::remove_compound_index(const std::vector<ColKey>& columns)
+{
+    auto it = std::find_if(m_compound_indexes.begin(), m_compound_indexes.end(), [&](auto& index) {
+        return index->get_columns() == columns;
+    });
+    if (it == m_compound_indexes.end())
+        return;
+
+    size_t ndx = it - m_compound_indexes.begin();
+    (*it)->destroy();
+    m_compound_indexes.erase(it);
+    m_compound_index_refs.erase(ndx);
+    for (size_t i = ndx; i < m_compound_indexes.size(); ++i) {
+        m_compound_indexes[i]->set_parent(&m_compound_index_refs, i);
+    }
+
+    // Go back to the table layout without compound indexes
+    if (m_compound_indexes.empty()) {
+        m_compound_index_refs.destroy();
+        m_top.set(top_position_for_compound_indexes, 0);
+    }
+}
+
+bool Table::has_compound_index(const std::vector<ColKey>& columns) const noexcept
+{
+    return std::any_of(m_compound_indexes.begin(), m_compound_indexes.end(), [&](auto& index) {
+        return index->get_columns() == columns;
+    });
+}
+
+void Table::add_geospatial_index()
+{
+#if REALM_ENABLE_GEOSPATIAL
+    ColKey type_col = get_column_key(Geospatial::c_geo_point_type_col_name);
+    ColKey coords_col = get_column_key(Geospatial::c_geo_point_coords_col_name);
+    if (!is_embedded() || !type_col || type_col.is_collection() || type_col.get_type() != col_type_String ||
+        !coords_col || !coords_col.is_list() || coords_col.get_type() != col_type_Double || coords_col.is_nullable())
+        throw IllegalOperation(
+            util::format("Class '%1' does not hold geospatial points, which a geospatial index requires",
+                         get_class_name()));
+
+    // Early-out if already indexed
+    if (m_geo_index)
+        return;
+    check_file_format_version(25, "Geospatial index"); // Throws
+
+    while (m_top.size() <= top_position_for_geospatial_index)
+        m_top.add(0); // Throws
+    auto index = std::make_unique<GeoIndex>(*this, type_col, coords_col, get_alloc()); // Throws
+    index->set_parent(&m_top, top_position_for_geospatial_index);
+    m_top.set_as_ref(top_position_for_geospatial_index, index->get_ref()); // Throws
+    index->build();                                                        // Throws
+    m_geo_index = std::move(index);
+#else
+    throw IllegalOperation("Geospatial indexes are not supported in this build");
+#endif
+}
+
+void Table::remove_geospatial_index()
+{
+    if (!m_geo_index)
+        return;
+    m_geo_index->destroy();
+    m_geo_index.reset();
+    m_top.set(top_position_for_geospatial_index, 0);
+}
+
 void Table::enumerate_string_column(ColKey col_key)
 {
     check_column(col_key);
@@ -988,6 +1241,33 @@ bool Table::is_enumerated(ColKey col_key) const noexcept
     return m_spec.is_string_enum_type(col_ndx);
 }
 
+void Table::set_compression(ColKey col_key, bool enable)
+{
+    check_column(col_key);
+    ColumnType type = col_key.get_type();
+    if ((type != col_type_String && type != col_type_Binary) || col_key.is_collection())
+        throw IllegalOperation("Only string and binary properties can be compressed");
+
+    size_t spec_ndx = colkey2spec_ndx(col_key);
+    auto attr = m_spec.get_column_attr(spec_ndx);
+    if (attr.test(col_attr_Compressed) == enable)
+        return;
+    if (enable) {
+        check_file_format_version(25, "Compression"); // Throws
+        attr.set(col_attr_Compressed);
+    }
+    else {
+        attr.reset(col_attr_Compressed);
+    }
+    m_spec.set_column_attr(spec_ndx, attr); // Throws
+}
+
+bool Table::is_compressed(ColKey col_key) const noexcept
+{
+    size_t spec_ndx = colkey2spec_ndx(col_key);
+    return m_spec.get_column_attr(spec_ndx).test(col_attr_Compressed);
+}
+
 size_t Table::get_num_unique_values(ColKey col_key) const
 {
     if (!is_enumerated(col_key))
@@ -1074,6 +1354,15 @@ void Table::do_erase_root_column(ColKey col_key)
     m_opposite_table.set(col_ndx, TableKey().value);
     m_opposite_column.set(col_ndx, ColKey().value);
     m_index_accessors[col_ndx] = nullptr;
+    for (size_t i = m_compound_indexes.size(); i > 0; --i) {
+        if (m_compound_indexes[i - 1]->covers(col_key)) {
+            auto columns = m_compound_indexes[i - 1]->get_columns();
+            remove_compound_index(columns);
+        }
+    }
+    if (get_geospatial_index(col_key))
+        remove_geospatial_index();
+    m_statistics.erase(col_key);
     m_clusters.remove_column(col_key);
     if (m_tombstones)
         m_tombstones->remove_column(col_key);
@@ -1220,6 +1509,44 @@ void Table::set_embedded(bool embedded, bool handle_backlinks)
     do_set_table_type(Type::Embedded);
 }
 
+void Table::load_flags() noexcept
+{
+    uint64_t flags = 0;
+    if (m_top.size() > top_position_for_flags)
+        flags = m_top.get_as_ref_or_tagged(top_position_for_flags).get_as_int();
+    m_table_type = Type(flags & table_type_mask);
+    m_cluster_node_shift = uint8_t((flags & cluster_node_shift_mask) >> cluster_node_shift_offset);
+}
+
+void Table::set_cluster_node_size(size_t size)
+{
+    uint8_t shift = 0;
+    if (size != 0) {
+        if (size < min_cluster_node_size || size > max_cluster_node_size || (size & (size - 1)) != 0) {
+            throw InvalidArgument(util::format("Cluster node size must be zero or a power of two between %1 and %2",
+                                               min_cluster_node_size, max_cluster_node_size));
+        }
+        while ((size_t(1) << shift) < size)
+            ++shift;
+    }
+
+    while (m_top.size() <= top_position_for_flags)
+        m_top.add(0);
+
+    uint64_t flags = m_top.get_as_ref_or_tagged(top_position_for_flags).get_as_int();
+    flags &= ~cluster_node_shift_mask;
+    flags |= uint64_t(shift) << cluster_node_shift_offset;
+    m_top.set(top_position_for_flags, RefOrTagged::make_tagged(flags));
+    m_cluster_node_shift = shift;
+}
+
+size_t Table::get_cluster_node_size() const noexcept
+{
+    if (m_cluster_node_shift)
+        return size_t(1) << m_cluster_node_shift;
+    return ClusterTree::get_default_node_size(get_column_count());
+}
+
 void Table::do_set_table_type(Type table_type)
 {
     while (m_top.size() <= top_position_for_flags)
@@ -1239,6 +1566,9 @@ void Table::detach(LifeCycleCookie cookie) noexcept
 {
     m_cookie = cookie;
     m_alloc.bump_instance_version();
+    m_zone_map.clear();
+    m_statistics.clear();
+    m_change_journal.reset();
 }
 
 void Table::fully_detach() noexcept
@@ -1249,6 +1579,30 @@ void Table::fully_detach() noexcept
     m_opposite_table.detach();
     m_opposite_column.detach();
     m_index_accessors.clear();
+    m_compound_index_refs.detach();
+    m_compound_indexes.clear();
+    m_geo_index.reset();
+}
+
+size_t Table::get_accessor_memory() const noexcept
+{
+    // The array accessors embedded in the table accessor are covered by its
+    // size, so only the separately allocated ones are added
+    size_t bytes = sizeof(Table);
+    bytes += m_leaf_ndx2colkey.capacity() * sizeof(ColKey);
+    bytes += m_spec_ndx2leaf_ndx.capacity() * sizeof(ColKey::Idx);
+    bytes += m_leaf_ndx2spec_ndx.capacity() * sizeof(size_t);
+    bytes += m_index_accessors.capacity() * sizeof(std::unique_ptr<SearchIndex>);
+    for (auto& index : m_index_accessors) {
+        if (index)
+            bytes += std::max(sizeof(StringIndex), sizeof(SortedIndex));
+    }
+    bytes += m_compound_indexes.size() * sizeof(CompoundIndex);
+    if (m_clusters.is_attached())
+        bytes += sizeof(Cluster);
+    if (m_tombstones)
+        bytes += sizeof(ClusterTree) + sizeof(Cluster);
+    return bytes;
 }
 
 
@@ -1272,6 +1626,10 @@ IndexType Table::search_index_type(ColKey col_key) const noexcept
 {
     if (m_index_accessors[col_key.get_index().val].get()) {
         auto attr = m_spec.get_column_attr(m_leaf_ndx2spec_ndx[col_key.get_index().val]);
+        if (attr.test(col_attr_Sorted_Indexed))
+            return IndexType::Sorted;
+        if (attr.test(col_attr_CaseInsensitive_Indexed))
+            return IndexType::CaseInsensitive;
         bool fulltext = attr.test(col_attr_FullText_Indexed);
         return fulltext ? IndexType::Fulltext : IndexType::General;
     }
@@ -1384,6 +1742,8 @@ const char* Table::get_state() const noexcept
             return "void";
         case cookie_deleted:
             return "deleted";
+        case cookie_evicted:
+            return "evicted";
     }
     return "";
 }
@@ -1471,6 +1831,66 @@ ref_type Table::create_empty_table(Allocator& alloc, TableKey key)
     return top.get_ref();
 }
 
+
+ref_type Table::typed_write(ref_type ref, _impl::ArrayWriterBase& out, Allocator& alloc, bool encode_integers)
+{
+    if (alloc.is_read_only(ref))
+        return ref;
+
+    Array top(alloc);
+    top.init_from_ref(ref);
+
+    // Select the leaves of the columns that hold plain integers, and of the
+    // compressed columns
+    using LeafEncoding = ClusterTree::LeafEncoding;
+    std::vector<LeafEncoding> encoding;
+    {
+        Spec spec(alloc);
+        spec.init(top.get_as_ref(top_position_for_spec));
+        for (size_t spec_ndx = 0, n = spec.get_column_count(); spec_ndx < n; ++spec_ndx) {
+            ColKey col_key = spec.get_key(spec_ndx);
+            auto leaf_encoding = LeafEncoding::Plain;
+            if (spec.get_column_attr(spec_ndx).test(col_attr_Compressed)) {
+                leaf_encoding = LeafEncoding::CompressedBlobs;
+            }
+            else if (encode_integers && col_key.get_type() == col_type_Int && !col_key.is_nullable() &&
+                     !col_key.is_collection()) {
+                leaf_encoding = LeafEncoding::Integers;
+            }
+            else {
+                continue;
+            }
+            size_t leaf_ndx = col_key.get_index().val;
+            if (leaf_ndx >= encoding.size())
+                encoding.resize(leaf_ndx + 1, LeafEncoding::Plain);
+            encoding[leaf_ndx] = leaf_encoding;
+        }
+    }
+
+    // Temp array for updated refs
+    Array new_top(Allocator::get_default());
+    new_top.create(top.get_type(), top.get_context_flag()); // Throws
+    _impl::ShallowArrayDestroyGuard dg(&new_top);
+
+    for (size_t i = 0, n = top.size(); i < n; ++i) {
+        int64_t value = top.get(i);
+        bool is_ref = (value != 0 && (value & 1) == 0);
+        if (is_ref) {
+            ref_type subref = to_ref(value);
+            if (i == top_position_for_cluster_tree || i == top_position_for_tombstones) {
+                subref = ClusterTree::typed_write(subref, out, alloc, encoding); // Throws
+            }
+            else {
+                subref = Array::write(subref, alloc, out, true); // Throws
+            }
+            value = from_ref(subref);
+        }
+        new_top.add(value); // Throws
+    }
+
+    return new_top.write(out, false, false); // Throws
+}
+
 void Table::ensure_graveyard()
 {
     if (!m_tombstones) {
@@ -1511,6 +1931,20 @@ void Table::batch_erase_objects(std::vector<ObjKey>& keys)
     Group* g = get_parent_group();
     bool maybe_has_incoming_links = g && !is_asymmetric();
 
+    // Erasing all the objects of the table is done a cluster at a time rather
+    // than an object at a time. The keys are all valid, but a view may hold
+    // the same key more than once.
+    if (keys.size() == size() && !is_embedded() && !(g && g->has_cascade_notification_handler())) {
+        std::sort(keys.begin(), keys.end());
+        auto duplicates = std::unique(keys.begin(), keys.end());
+        if (duplicates == keys.end()) {
+            clear();
+            keys.clear();
+            return;
+        }
+        keys.erase(duplicates, keys.end());
+    }
+
     if (has_any_embedded_objects() || (g && g->has_cascade_notification_handler())) {
         CascadeState state(CascadeState::Mode::Strong, g);
         std::for_each(keys.begin(), keys.end(), [this, &state](ObjKey k) {
@@ -1650,6 +2084,30 @@ void Table::aggregate(QueryStateBase& st, ColKey column_key) const
     using LeafType = typename ColumnTypeTraits<T>::cluster_leaf_type;
     LeafType leaf(get_alloc());
 
+    if constexpr (realm::is_any_v<T, int64_t, std::optional<int64_t>, float, double, Decimal128>) {
+        // Every row matches when aggregating a whole table, so sum, min and max can reduce each leaf in bulk
+        using Value = typename util::RemoveOptional<T>::type;
+        auto sum_state = dynamic_cast<QueryStateSum<Value>*>(&st);
+        auto min_state = dynamic_cast<QueryStateMin<Value>*>(&st);
+        auto max_state = dynamic_cast<QueryStateMax<Value>*>(&st);
+        if ((sum_state || min_state || max_state) && st.limit() == size_t(-1)) {
+            auto f = [&](const Cluster* cluster) {
+                cluster->init_leaf(column_key, &leaf);
+                st.m_key_offset = cluster->get_offset();
+                st.m_key_values = cluster->get_key_array();
+                if (sum_state)
+                    sum_state->accumulate_leaf(leaf);
+                else if (min_state)
+                    min_state->accumulate_leaf(leaf);
+                else
+                    max_state->accumulate_leaf(leaf);
+                return IteratorControl::AdvanceToNext;
+            };
+            traverse_clusters(f, {column_key});
+            return;
+        }
+    }
+
     auto f = [&leaf, column_key, &st](const Cluster* cluster) {
         // direct aggregate on the leaf
         cluster->init_leaf(column_key, &leaf);
@@ -1664,7 +2122,7 @@ void Table::aggregate(QueryStateBase& st, ColKey column_key) const
         return IteratorControl::AdvanceToNext;
     };
 
-    traverse_clusters(f);
+    traverse_clusters(f, {column_key});
 }
 
 // This template is also used by the query engine
@@ -1927,6 +2385,17 @@ TableView Table::find_all_fulltext(ColKey col_key, StringData terms) const
     return where().fulltext(col_key, terms).find_all();
 }
 
+std::vector<double> Table::get_fulltext_scores(ColKey col_key, StringData terms,
+                                               const std::vector<ObjKey>& keys) const
+{
+    check_column(col_key);
+    auto index = get_string_index(col_key);
+    if (!(index && index->is_fulltext_index())) {
+        throw IllegalOperation{"Column has no fulltext index"};
+    }
+    return index->fulltext_scores(keys, terms);
+}
+
 TableView Table::get_sorted_view(ColKey col_key, bool ascending)
 {
     TableView tv = where().find_all();
@@ -1974,18 +2443,21 @@ void Table::update_from_parent() noexcept
 
         m_opposite_table.update_from_parent();
         m_opposite_column.update_from_parent();
-        if (m_top.size() > top_position_for_flags) {
-            uint64_t flags = m_top.get_as_ref_or_tagged(top_position_for_flags).get_as_int();
-            m_table_type = Type(flags & table_type_mask);
-        }
-        else {
-            m_table_type = Type::TopLevel;
-        }
+        load_flags();
         if (m_tombstones)
             m_tombstones->update_from_parent();
+        if (m_compound_index_refs.is_attached()) {
+            m_compound_index_refs.update_from_parent();
+            for (auto&& index : m_compound_indexes) {
+                index->update_from_parent();
+            }
+        }
+        if (m_geo_index)
+            m_geo_index->update_from_parent();
 
         refresh_content_version();
         m_has_any_embedded_objects.reset();
+        m_zone_map.advance();
     }
     m_alloc.bump_storage_version();
 }
@@ -2038,6 +2510,12 @@ void Table::schema_to_json(std::ostream& out) const
         if (index_type == IndexType::Fulltext) {
             out << ",\"isFulltextIndexed\":true";
         }
+        if (index_type == IndexType::Sorted) {
+            out << ",\"isSortedIndexed\":true";
+        }
+        if (index_type == IndexType::CaseInsensitive) {
+            out << ",\"isCaseInsensitiveIndexed\":true";
+        }
         out << "}";
         if (i < sz - 1) {
             out << ",";
@@ -2083,6 +2561,8 @@ bool Table::operator==(const Table& t) const
 
 void Table::flush_for_commit()
 {
+    if (m_defer_index_updates)
+        apply_deferred_index_updates(); // Throws
     if (m_top.is_attached() && m_top.size() >= top_position_for_version) {
         if (!m_top.is_read_only()) {
             ++m_in_file_version_at_transaction_boundary;
@@ -2127,13 +2607,7 @@ void Table::refresh_accessor_tree()
     m_opposite_column.init_from_parent();
     auto rot_pk_key = m_top.get_as_ref_or_tagged(top_position_for_pk_col);
     m_primary_key_col = rot_pk_key.is_tagged() ? ColKey(rot_pk_key.get_as_int()) : ColKey();
-    if (m_top.size() > top_position_for_flags) {
-        auto rot_flags = m_top.get_as_ref_or_tagged(top_position_for_flags);
-        m_table_type = Type(rot_flags.get_as_int() & table_type_mask);
-    }
-    else {
-        m_table_type = Type::TopLevel;
-    }
+    load_flags();
     if (m_top.size() > top_position_for_tombstones && m_top.get_as_ref(top_position_for_tombstones)) {
         // Tombstones exists
         if (!m_tombstones) {
@@ -2146,8 +2620,30 @@ void Table::refresh_accessor_tree()
     }
     refresh_content_version();
     bump_storage_version();
+    m_zone_map.advance();
     build_column_mapping();
     refresh_index_accessors();
+    refresh_compound_index_accessors();
+    refresh_geospatial_index_accessor();
+}
+
+bool Table::is_attached_at(ref_type ref) const noexcept
+{
+    if (!m_top.is_attached() || m_top.get_ref() != ref)
+        return false;
+    // A node written to the slab may later have been written to the file at
+    // the same ref
+    char* header = m_alloc.translate(ref);
+    if (header != m_top.get_mem().get_addr())
+        return false;
+    // The node may also have been freed and reused for a later version of
+    // the table, which then has a different version number
+    Array top(m_alloc);
+    top.init_from_mem(MemRef(header, ref, m_alloc));
+    if (top.size() <= top_position_for_version)
+        return false;
+    auto rot_version = top.get_as_ref_or_tagged(top_position_for_version);
+    return rot_version.is_tagged() && uint64_t(rot_version.get_as_int()) == m_in_file_version_at_transaction_boundary;
 }
 
 void Table::refresh_index_accessors()
@@ -2171,20 +2667,89 @@ void Table::refresh_index_accessors()
         else {
             auto attr = m_spec.get_column_attr(m_leaf_ndx2spec_ndx[col_ndx]);
             bool fulltext = attr.test(col_attr_FullText_Indexed);
+            bool case_insensitive = attr.test(col_attr_CaseInsensitive_Indexed);
+            bool sorted = attr.test(col_attr_Sorted_Indexed) || case_insensitive;
             auto col_key = m_leaf_ndx2colkey[col_ndx];
-            ClusterColumn virtual_col(&m_clusters, col_key, fulltext ? IndexType::Fulltext : IndexType::General);
+            ClusterColumn virtual_col(&m_clusters, col_key,
+                                      case_insensitive ? IndexType::CaseInsensitive
+                                      : sorted         ? IndexType::Sorted
+                                      : fulltext       ? IndexType::Fulltext
+                                                       : IndexType::General);
+
+            // The index may have been replaced by one of another type
+            auto& accessor = m_index_accessors[col_ndx];
+            if (accessor) {
+                auto sorted_index = dynamic_cast<SortedIndex*>(accessor.get());
+                if (sorted != bool(sorted_index) ||
+                    (sorted_index && sorted_index->is_case_insensitive() != case_insensitive))
+                    accessor.reset();
+            }
 
-            if (m_index_accessors[col_ndx]) { // still there, refresh:
-                m_index_accessors[col_ndx]->refresh_accessor_tree(virtual_col);
+            if (accessor) { // still there, refresh:
+                accessor->refresh_accessor_tree(virtual_col);
+            }
+            else if (sorted) { // new index!
+                accessor = std::make_unique<SortedIndex>(ref, &m_index_refs, col_ndx, virtual_col, get_alloc(),
+                                                         case_insensitive);
             }
-            else { // new index!
-                m_index_accessors[col_ndx] =
-                    std::make_unique<StringIndex>(ref, &m_index_refs, col_ndx, virtual_col, get_alloc());
+            else {
+                auto index = std::make_unique<StringIndex>(ref, &m_index_refs, col_ndx, virtual_col, get_alloc());
+                index->set_deferred(m_defer_index_updates && col_key != m_primary_key_col);
+                accessor = std::move(index);
             }
         }
     }
 }
 
+void Table::set_deferred_index_updates(bool deferred)
+{
+    m_defer_index_updates = deferred;
+    for (size_t col_ndx = 0; col_ndx < m_index_accessors.size(); ++col_ndx) {
+        if (auto index = dynamic_cast<StringIndex*>(m_index_accessors[col_ndx].get()))
+            index->set_deferred(deferred && m_leaf_ndx2colkey[col_ndx] != m_primary_key_col); // Throws
+    }
+}
+
+void Table::apply_deferred_index_updates()
+{
+    for (auto& accessor : m_index_accessors) {
+        if (auto index = dynamic_cast<StringIndex*>(accessor.get()))
+            index->apply_pending_updates(); // Throws
+    }
+}
+
+void Table::refresh_compound_index_accessors()
+{
+    m_compound_indexes.clear();
+    if (m_top.size() <= top_position_for_compound_indexes || !m_top.get_as_ref(top_position_for_compound_indexes)) {
+        m_compound_index_refs.detach();
+        return;
+    }
+
+    m_compound_index_refs.init_from_parent();
+    for (size_t i = 0; i < m_compound_index_refs.size(); ++i) {
+        m_compound_indexes.push_back(std::make_unique<CompoundIndex>(m_compound_index_refs.get_as_ref(i),
+                                                                     &m_compound_index_refs, i, *this, get_alloc()));
+    }
+}
+
+void Table::refresh_geospatial_index_accessor()
+{
+    ref_type ref = 0;
+    if (m_top.size() > top_position_for_geospatial_index)
+        ref = m_top.get_as_ref(top_position_for_geospatial_index);
+    if (!ref) {
+        m_geo_index.reset();
+        return;
+    }
+    if (m_geo_index) {
+        m_geo_index->refresh_accessor_tree();
+    }
+    else {
+        m_geo_index = std::make_unique<GeoIndex>(ref, &m_top, top_position_for_geospatial_index, *this, get_alloc());
+    }
+}
+
 bool Table::is_cross_table_link_target() const noexcept
 {
     auto is_cross_link = [this](ColKey col_key) {
@@ -2208,6 +2773,11 @@ void Table::verify() const
     m_clusters.verify();
     if (nb_unresolved())
         m_tombstones->verify();
+    for (auto&& index : m_compound_indexes) {
+        index->verify();
+    }
+    if (m_geo_index)
+        m_geo_index->verify();
 #endif
 }
 
@@ -2322,7 +2892,7 @@ Obj Table::create_object_with_primary_key(const Mixed& primary_key, FieldValues&
         *did_create = false;
 
     // Check for existing object
-    if (ObjKey key = m_index_accessors[primary_key_col.get_index().val]->find_first(primary_key)) {
+    if (ObjKey key = m_index_accessors[primary_key_col.get_index().val]->find_unique(primary_key)) {
         if (mode == UpdateMode::never) {
             throw ObjectAlreadyExists(this->get_class_name(), primary_key);
         }
@@ -2390,7 +2960,8 @@ ObjKey Table::find_primary_key(Mixed primary_key) const
                  primary_key.get_type() == type);
 
     if (auto&& index = m_index_accessors[primary_key_col.get_index().val]) {
-        return index->find_first(primary_key);
+        // The accessors of frozen transactions may be used by several threads
+        return m_is_frozen ? index->find_first(primary_key) : index->find_unique(primary_key);
     }
 
     // This must be file format 11, 20 or 21 as those are the ones we can open in read-only mode
@@ -2487,6 +3058,170 @@ Mixed Table::get_primary_key(ObjKey key) const
     }
 }
 
+namespace {
+
+std::unique_ptr<ArrayPayload> make_leaf_accessor(Allocator& alloc, ColKey col_key)
+{
+    if (col_key.is_collection()) {
+        return std::make_unique<ArrayInteger>(alloc);
+    }
+    switch (col_key.get_type()) {
+        case col_type_Int:
+            if (col_key.is_nullable()) {
+                return std::make_unique<ArrayIntNull>(alloc);
+            }
+            return std::make_unique<ArrayInteger>(alloc);
+        case col_type_Bool:
+            return std::make_unique<ArrayBoolNull>(alloc);
+        case col_type_String:
+            return std::make_unique<ArrayString>(alloc);
+        case col_type_Binary:
+            return std::make_unique<ArrayBinary>(alloc);
+        case col_type_Mixed:
+            return std::make_unique<ArrayMixed>(alloc);
+        case col_type_Timestamp:
+            return std::make_unique<ArrayTimestamp>(alloc);
+        case col_type_Float:
+            return std::make_unique<ArrayFloatNull>(alloc);
+        case col_type_Double:
+            return std::make_unique<ArrayDoubleNull>(alloc);
+        case col_type_Decimal:
+            return std::make_unique<ArrayDecimal128>(alloc);
+        case col_type_Link:
+            return std::make_unique<ArrayKey>(alloc);
+        case col_type_ObjectId:
+            return std::make_unique<ArrayObjectIdNull>(alloc);
+        case col_type_UUID:
+            return std::make_unique<ArrayUUIDNull>(alloc);
+        case col_type_TypedLink:
+        case col_type_BackLink:
+            break;
+    }
+    REALM_UNREACHABLE();
+    return {};
+}
+
+} // namespace
+
+std::vector<Mixed> Table::get_values(const std::vector<ObjKey>& keys, const std::vector<ColKey>& col_keys) const
+{
+    for (auto col_key : col_keys) {
+        check_column(col_key);
+    }
+
+    const size_t num_objects = keys.size();
+    std::vector<Mixed> values(num_objects * col_keys.size());
+
+    std::vector<std::pair<ObjKey, size_t>> sorted_keys;
+    sorted_keys.reserve(num_objects);
+    for (size_t i = 0; i < num_objects; ++i) {
+        if (keys[i]) {
+            sorted_keys.emplace_back(keys[i], i);
+        }
+    }
+    std::sort(sorted_keys.begin(), sorted_keys.end());
+
+    Allocator& alloc = get_alloc();
+    std::vector<std::unique_ptr<ArrayPayload>> leaves;
+    leaves.reserve(col_keys.size());
+    for (auto col_key : col_keys) {
+        leaves.push_back(make_leaf_accessor(alloc, col_key));
+    }
+
+    Cluster cluster(0, alloc, m_clusters);
+    ClusterNode::IteratorState state(cluster);
+    ObjKey last_key_in_cluster;
+    for (auto& [key, i] : sorted_keys) {
+        size_t ndx;
+        if (last_key_in_cluster && key <= last_key_in_cluster) {
+            ndx = cluster.lower_bound_key(ObjKey(key.value - cluster.get_offset()));
+        }
+        else {
+            if (key.is_unresolved() || !m_clusters.get_leaf(key, state)) {
+                throw KeyNotFound(util::format("No object with key '%1' in '%2'", key.value, get_name()));
+            }
+            for (size_t c = 0; c < col_keys.size(); ++c) {
+                cluster.init_leaf(col_keys[c], leaves[c].get());
+            }
+            last_key_in_cluster = cluster.get_real_key(cluster.node_size() - 1);
+            ndx = state.m_current_index;
+        }
+        if (cluster.get_real_key(ndx) != key) {
+            throw KeyNotFound(util::format("No object with key '%1' in '%2'", key.value, get_name()));
+        }
+
+        for (size_t c = 0; c < col_keys.size(); ++c) {
+            ColKey col_key = col_keys[c];
+            Mixed& value = values[c * num_objects + i];
+            if (col_key.is_collection()) {
+                ref_type ref = to_ref(static_cast<ArrayInteger*>(leaves[c].get())->get(ndx));
+                value = Mixed(ref, get_collection_type(col_key));
+            }
+            else {
+                value = leaves[c]->get_any(ndx);
+                if (value.is_type(type_Link) && value.get<ObjKey>().is_unresolved()) {
+                    value = Mixed();
+                }
+            }
+        }
+    }
+    return values;
+}
+
+std::vector<Obj> Table::get_objects(const std::vector<ObjKey>& keys) const
+{
+    const size_t num_objects = keys.size();
+    std::vector<Obj> objects(num_objects);
+
+    std::vector<std::pair<ObjKey, size_t>> sorted_keys;
+    sorted_keys.reserve(num_objects);
+    for (size_t i = 0; i < num_objects; ++i) {
+        if (keys[i]) {
+            sorted_keys.emplace_back(keys[i], i);
+        }
+    }
+    std::sort(sorted_keys.begin(), sorted_keys.end());
+
+    Cluster cluster(0, get_alloc(), m_clusters);
+    ClusterNode::IteratorState state(cluster);
+    ObjKey last_key_in_cluster;
+    for (auto& [key, i] : sorted_keys) {
+        size_t ndx;
+        if (last_key_in_cluster && key <= last_key_in_cluster) {
+            ndx = cluster.lower_bound_key(ObjKey(key.value - cluster.get_offset()));
+        }
+        else {
+            if (key.is_unresolved() || !m_clusters.get_leaf(key, state)) {
+                throw KeyNotFound(util::format("No object with key '%1' in '%2'", key.value, get_name()));
+            }
+            last_key_in_cluster = cluster.get_real_key(cluster.node_size() - 1);
+            ndx = state.m_current_index;
+        }
+        if (cluster.get_real_key(ndx) != key) {
+            throw KeyNotFound(util::format("No object with key '%1' in '%2'", key.value, get_name()));
+        }
+        objects[i] = Obj(m_own_ref, cluster.get_mem(), key, ndx);
+    }
+    return objects;
+}
+
+void Table::scan_key_range(ObjKey begin, ObjKey end, util::FunctionRef<IteratorControl(const Obj&)> func) const
+{
+    m_clusters.traverse(begin, end, [&](const Cluster* cluster) {
+        int64_t offset = cluster->get_offset();
+        size_t sz = cluster->node_size();
+        size_t ndx = begin.value > offset ? cluster->lower_bound_key(ObjKey(begin.value - offset)) : 0;
+        for (; ndx < sz; ++ndx) {
+            ObjKey key = cluster->get_real_key(ndx);
+            if (key.value >= end.value)
+                return IteratorControl::Stop;
+            if (func(Obj(m_own_ref, cluster->get_mem(), key, ndx)) == IteratorControl::Stop)
+                return IteratorControl::Stop;
+        }
+        return IteratorControl::AdvanceToNext;
+    });
+}
+
 GlobalKey Table::allocate_object_id_squeezed()
 {
     // m_client_file_ident will be zero if we haven't been in contact with
@@ -2698,6 +3433,114 @@ void Table::create_objects(const std::vector<ObjKey>& keys)
     }
 }
 
+std::vector<const Mixed*> Table::check_bulk_columns(size_t num_objects, const std::vector<BulkColumn>& columns) const
+{
+    if (is_embedded())
+        throw IllegalOperation(util::format("Explicit creation of embedded object not allowed in: %1", get_name()));
+    if (m_primary_key_col)
+        throw IllegalOperation(util::format("Table has primary key: %1", get_name()));
+
+    std::vector<const Mixed*> values(m_leaf_ndx2colkey.size(), nullptr);
+    for (auto& column : columns) {
+        ColKey col_key = column.col_key;
+        check_column(col_key);
+        auto col_ndx = col_key.get_index().val;
+        if (col_key.is_collection() || col_key.get_type() == col_type_BackLink)
+            throw IllegalOperation(util::format("Cannot bulk create values of property: %1", get_column_name(col_key)));
+        if (values[col_ndx])
+            throw InvalidArgument(util::format("Values of property '%1' given twice", get_column_name(col_key)));
+        if (column.values.size() != num_objects)
+            throw InvalidArgument(util::format("Expected %1 values of property '%2', got %3", num_objects,
+                                               get_column_name(col_key), column.values.size()));
+        auto type = col_key.get_type();
+        for (auto& value : column.values) {
+            if (value.is_null()) {
+                if (!col_key.is_nullable() && type != col_type_Mixed)
+                    throw NotNullable(Group::table_name_to_class_name(get_name()), get_column_name(col_key));
+                continue;
+            }
+            bool type_ok;
+            if (type == col_type_Mixed)
+                type_ok = value.get_type() != type_Link;
+            else
+                type_ok = value.get_type() == DataType(type);
+            if (!type_ok)
+                throw InvalidArgument(ErrorCodes::TypeMismatch,
+                                      util::format("Wrong type of value for property '%1': %2",
+                                                   get_column_name(col_key), value.get_type()));
+        }
+        if (num_objects)
+            values[col_ndx] = column.values.data();
+    }
+    return values;
+}
+
+void Table::do_bulk_create_objects(const std::vector<ObjKey>& keys, const std::vector<BulkColumn>& columns,
+                                   const std::vector<GlobalKey>* object_ids)
+{
+    auto values = check_bulk_columns(keys.size(), columns);
+    if (keys.empty())
+        return;
+    m_clusters.bulk_insert(keys, values);
+
+    if (Replication* repl = get_repl()) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (object_ids)
+                repl->create_object(this, (*object_ids)[i]);
+            for (auto& column : columns)
+                repl->set(this, column.col_key, keys[i], column.values[i], _impl::instr_Set);
+        }
+    }
+}
+
+void Table::bulk_create_objects(const std::vector<ObjKey>& keys, const std::vector<BulkColumn>& columns)
+{
+    int64_t last_key = m_clusters.is_empty() ? -1 : m_clusters.get_last_key_value();
+    for (auto key : keys) {
+        if (key.value <= last_key)
+            throw InvalidArgument(util::format("Keys must be ascending and greater than the keys of existing "
+                                               "objects: %1",
+                                               key));
+        last_key = key.value;
+    }
+    do_bulk_create_objects(keys, columns, nullptr);
+}
+
+std::vector<ObjKey> Table::bulk_create_objects(size_t number, const std::vector<BulkColumn>& columns)
+{
+    check_bulk_columns(number, columns);
+
+    std::vector<GlobalKey> object_ids;
+    std::vector<ObjKey> keys;
+    object_ids.reserve(number);
+    keys.reserve(number);
+    int64_t last_key = m_clusters.is_empty() ? -1 : m_clusters.get_last_key_value();
+    bool ascending = true;
+    for (size_t i = 0; i < number; ++i) {
+        GlobalKey object_id = allocate_object_id_squeezed();
+        ObjKey key = object_id.get_local_key(get_sync_file_id());
+        ascending = ascending && key.value > last_key;
+        last_key = key.value;
+        object_ids.push_back(object_id);
+        keys.push_back(key);
+    }
+    if (ascending) {
+        do_bulk_create_objects(keys, columns, &object_ids);
+        return keys;
+    }
+
+    // Objects with greater keys have been created already, so the new keys may
+    // collide with existing ones. Create the objects one at a time.
+    keys.clear();
+    for (size_t i = 0; i < number; ++i) {
+        FieldValues values;
+        for (auto& column : columns)
+            values.insert(column.col_key, column.values[i]);
+        keys.push_back(create_object(ObjKey(), values).get_key());
+    }
+    return keys;
+}
+
 void Table::dump_objects()
 {
     m_clusters.dump_objects();
@@ -2924,6 +3767,9 @@ void Table::do_set_primary_key_column(ColKey col_key)
         if (attr.test(col_attr_FullText_Indexed)) {
             throw InvalidColumnKey("primary key cannot have a full text index");
         }
+        if (attr.test(col_attr_Sorted_Indexed)) {
+            throw InvalidColumnKey("primary key cannot have a sorted index");
+        }
     }
 
     if (m_primary_key_col) {
@@ -2944,12 +3790,16 @@ void Table::do_set_primary_key_column(ColKey col_key)
     }
 
     m_primary_key_col = col_key;
+    if (m_defer_index_updates)
+        set_deferred_index_updates(true); // Throws
 }
 
 bool Table::contains_unique_values(ColKey col) const
 {
     if (search_index_type(col) == IndexType::General) {
         auto search_index = get_search_index(col);
+        if (auto string_index = dynamic_cast<StringIndex*>(search_index))
+            string_index->apply_pending_updates(); // Throws
         return !search_index->has_duplicate_values();
     }
     else {
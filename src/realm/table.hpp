@@ -36,6 +36,11 @@
 #include <realm/cluster_tree.hpp>
 #include <realm/keys.hpp>
 #include <realm/global_key.hpp>
+#include <realm/zone_map.hpp>
+#include <realm/table_statistics.hpp>
+#include <realm/change_journal.hpp>
+#include <realm/index_compound.hpp>
+#include <realm/index_geo.hpp>
 
 // Only set this to one when testing the code paths that exercise object ID
 // hash collisions. It artificially limits the "optimistic" local ID to use
@@ -153,6 +158,24 @@ public:
     std::vector<std::pair<TableKey, ColKey>> get_incoming_link_columns() const noexcept;
     //@}
 
+    /// Bounds of the number of objects a cluster may hold, see
+    /// set_cluster_node_size().
+    static constexpr size_t min_cluster_node_size = 16;
+    static constexpr size_t max_cluster_node_size = 4096;
+
+    /// Set the number of objects a cluster (a leaf of the tree holding the
+    /// objects of the table) may hold before it is split. It must be a power
+    /// of two between min_cluster_node_size and max_cluster_node_size, or zero
+    /// to have it chosen from the number of columns. It also bounds the number
+    /// of children of the inner nodes of the tree. Smaller nodes make small
+    /// updates cheaper, as less is copied on write and written by the commit,
+    /// while larger nodes make scans of narrow tables faster. Existing nodes
+    /// keep their size until they are split or merged.
+    ///
+    /// The setting is stored in the file, but it is not replicated.
+    void set_cluster_node_size(size_t size);
+    size_t get_cluster_node_size() const noexcept;
+
     // Primary key columns
     ColKey get_primary_key_column() const;
     void set_primary_key_column(ColKey col);
@@ -248,10 +271,64 @@ public:
     }
     void remove_search_index(ColKey col_key);
 
+    /// set_deferred_index_updates() makes the general search indexes of this
+    /// table record which objects changed, rather than updating the index on
+    /// every change. The recorded changes are applied in one batch when the
+    /// transaction is committed, or before the index is next read, so queries
+    /// see the same results either way. This saves work when objects are
+    /// changed several times, or many objects are changed between reads of
+    /// the index. The primary key column, full text indexes and indexes of
+    /// lists are always updated right away. The setting belongs to this
+    /// accessor, so it lasts for the lifetime of the transaction.
+    void set_deferred_index_updates(bool deferred);
+    bool get_deferred_index_updates() const noexcept
+    {
+        return m_defer_index_updates;
+    }
+    /// Apply the recorded changes of all the search indexes of this table.
+    void apply_deferred_index_updates();
+
+    /// add_compound_index() adds an index over the specified columns, in the
+    /// given order. Queries with equality conditions on a prefix of the
+    /// columns use it to find the matching objects. Between 2 and 4 columns
+    /// of type int, bool, string, timestamp, ObjectId or UUID are supported.
+    /// It has no effect if an index over the same columns already exists.
+    ///
+    /// remove_compound_index() removes the index over the specified columns.
+    /// It has no effect if there is no such index. Removing one of the columns
+    /// also removes the index.
+    void add_compound_index(const std::vector<ColKey>& columns);
+    void remove_compound_index(const std::vector<ColKey>& columns);
+    bool has_compound_index(const std::vector<ColKey>& columns) const noexcept;
+
+    /// add_geospatial_index() adds an index over the points stored in this
+    /// table, which must be an embedded table with the "type" and
+    /// "coordinates" columns of a geospatial point. geoWithin queries over
+    /// links to this table use it to find the points inside the region. It
+    /// has no effect if the table already has the index.
+    ///
+    /// remove_geospatial_index() removes the index, and has no effect if there
+    /// is none. Removing one of the columns also removes the index.
+    void add_geospatial_index();
+    void remove_geospatial_index();
+    bool has_geospatial_index() const noexcept
+    {
+        return bool(m_geo_index);
+    }
+
     void enumerate_string_column(ColKey col_key);
     bool is_enumerated(ColKey col_key) const noexcept;
     bool contains_unique_values(ColKey col_key) const;
 
+    /// set_compression() makes commits store the values of the specified
+    /// string or binary column which are at least
+    /// ArrayBlob::compression_threshold bytes compressed in the file. The
+    /// values are decompressed when read, and the decompressed data remains
+    /// valid as long as data read from the file would. Values that are
+    /// already in the file are compressed when they are next modified.
+    void set_compression(ColKey col_key, bool enable = true);
+    bool is_compressed(ColKey col_key) const noexcept;
+
     //@}
 
     /// If the specified column is optimized to store only unique values, then
@@ -323,6 +400,15 @@ public:
     void create_objects(size_t number, std::vector<ObjKey>& keys);
     /// Create a number of objects with keys supplied
     void create_objects(const std::vector<ObjKey>& keys);
+    /// Create objects from values given a column at a time. Each entry of
+    /// `columns` holds the values of one column for all the objects, and the
+    /// other columns get their default values. The objects are added to the
+    /// table in full clusters rather than one at a time, and the search
+    /// indexes are updated when all objects have been created. The keys must
+    /// be ascending and greater than the keys of all existing objects.
+    void bulk_create_objects(const std::vector<ObjKey>& keys, const std::vector<BulkColumn>& columns);
+    /// Create `number` objects as above, generating their keys. Returns the keys.
+    std::vector<ObjKey> bulk_create_objects(size_t number, const std::vector<BulkColumn>& columns);
     /// Does the key refer to an object within the table?
     bool is_valid(ObjKey key) const noexcept
     {
@@ -346,6 +432,17 @@ public:
     Obj get_object_with_primary_key(Mixed pk) const;
     // Get primary key based on ObjKey
     Mixed get_primary_key(ObjKey key) const;
+    /// Read the values of the columns `col_keys` for each of the objects
+    /// `keys`. The result is column-major: the value of column `c` for object
+    /// `i` is at index `c * keys.size() + i`. The objects are read in key
+    /// order, so all objects in one cluster are read through a single set of
+    /// leaf accessors. Null keys give null values; collection columns give the
+    /// collection ref, as Obj::get_any() does.
+    std::vector<Mixed> get_values(const std::vector<ObjKey>& keys, const std::vector<ColKey>& col_keys) const;
+    /// Get the objects `keys`, in the same order. As for get_values(), the
+    /// objects are found in key order, so all objects in one cluster are found
+    /// in a single descent of the tree. Null keys give invalid objects.
+    std::vector<Obj> get_objects(const std::vector<ObjKey>& keys) const;
     // Get logical index for object. This function is not very efficient
     size_t get_object_ndx(ObjKey key) const noexcept
     {
@@ -354,11 +451,19 @@ public:
 
     void dump_objects();
 
-    bool traverse_clusters(ClusterTree::TraverseFunction func) const
+    bool traverse_clusters(ClusterTree::TraverseFunction func, const std::vector<ColKey>& prefetch_columns = {}) const
     {
-        return m_clusters.traverse(func);
+        return m_clusters.traverse(func, prefetch_columns);
     }
 
+    /// Call `func` for each of the objects with keys in [begin, end), in key
+    /// order, until it returns IteratorControl::Stop. Only the part of the
+    /// cluster tree holding the range is visited, so when keys are allocated in
+    /// increasing order, e.g. for a table of events, the objects created in a
+    /// period are found without a query. The table must not be modified by
+    /// `func`.
+    void scan_key_range(ObjKey begin, ObjKey end, util::FunctionRef<IteratorControl(const Obj&)> func) const;
+
     /// remove_object() removes the specified object from the table.
     /// Any links from the specified object into objects residing in an embedded
     /// table will cause those objects to be deleted as well, and so on recursively.
@@ -423,6 +528,9 @@ public:
 
     // Get the key of this table directly, without needing a Table accessor.
     static TableKey get_key_direct(Allocator& alloc, ref_type top_ref);
+    // Get the version of this table directly, which is bumped by every commit
+    // which modifies the table.
+    static uint64_t get_version_direct(Allocator& alloc, ref_type top_ref);
 
     // Aggregate functions
     size_t count_int(ColKey col_key, int64_t value) const;
@@ -442,6 +550,40 @@ public:
     // Will return pointer to search index accessor. Will return nullptr if no index
     SearchIndex* get_search_index(ColKey col) const noexcept;
     StringIndex* get_string_index(ColKey col) const noexcept;
+    const std::vector<std::unique_ptr<CompoundIndex>>& get_compound_indexes() const noexcept
+    {
+        return m_compound_indexes;
+    }
+    const GeoIndex* get_geospatial_index() const noexcept
+    {
+        return m_geo_index.get();
+    }
+    // Return the geospatial index if it covers the column. The point of an
+    // object must be erased from the index before the column is changed, and
+    // inserted again afterwards.
+    GeoIndex* get_geospatial_index(ColKey col_key) const noexcept
+    {
+        return (m_geo_index && m_geo_index->covers(col_key)) ? m_geo_index.get() : nullptr;
+    }
+
+    // Per-leaf value synopses used by the query engine to skip clusters
+    const ZoneMap& get_zone_map() const noexcept
+    {
+        return m_zone_map;
+    }
+
+    // Value statistics used by the query planner to order conditions. Returns
+    // null if the table is too small or the column type is not supported.
+    std::shared_ptr<const ColumnStatistics> get_column_statistics(ColKey col_key) const
+    {
+        return m_statistics.get(*this, col_key);
+    }
+
+    // Keys of the objects changed while a table view is tracking changes
+    ChangeJournal& get_change_journal() const noexcept
+    {
+        return m_change_journal;
+    }
 
     template <class T>
     ObjKey find_first(ColKey col_key, T value) const;
@@ -475,6 +617,11 @@ public:
     TableView find_all_null(ColKey col_key) const;
 
     TableView find_all_fulltext(ColKey col_key, StringData value) const;
+    /// The BM25 relevance of each of the objects `keys` for the fulltext
+    /// search `value` on the column, which must have a fulltext index. Higher
+    /// is more relevant. Objects without any of the words, and null keys,
+    /// score 0.
+    std::vector<double> get_fulltext_scores(ColKey col_key, StringData value, const std::vector<ObjKey>& keys) const;
 
     TableView get_sorted_view(ColKey col_key, bool ascending = true);
     TableView get_sorted_view(ColKey col_key, bool ascending = true) const;
@@ -562,6 +709,7 @@ private:
     // not have a primary key and all objects must have exactly 1 backlink.
     void set_embedded(bool embedded, bool handle_backlinks);
     /// Changes type unconditionally. Called only from Group::do_get_or_add_table()
+    void load_flags() noexcept;
     void do_set_table_type(Type table_type);
 
 public:
@@ -699,6 +847,7 @@ private:
         cookie_removed = 0xbabe,
         cookie_void = 0x5678,
         cookie_deleted = 0xdead,
+        cookie_evicted = 0xe71c,
     };
 
     // This is only used for debugging checks, so relaxed operations are fine.
@@ -735,20 +884,51 @@ private:
     Array m_opposite_table;                    // 7th slot in m_top
     Array m_opposite_column;                   // 8th slot in m_top
     std::vector<std::unique_ptr<SearchIndex>> m_index_accessors;
+    Array m_compound_index_refs; // 15th slot in m_top
+    std::vector<std::unique_ptr<CompoundIndex>> m_compound_indexes;
+    std::unique_ptr<GeoIndex> m_geo_index; // 16th slot in m_top
+    ZoneMap m_zone_map;
+    TableStatistics m_statistics;
+    mutable ChangeJournal m_change_journal;
     ColKey m_primary_key_col;
     Replication* const* m_repl;
     static Replication* g_dummy_replication;
     bool m_is_frozen = false;
+    bool m_defer_index_updates = false;
     util::Optional<bool> m_has_any_embedded_objects;
     TableRef m_own_ref;
+    // Value of the group's accessor clock when this accessor was last looked up
+    mutable std::atomic<uint64_t> m_last_used{0};
 
     void batch_erase_rows(const KeyColumn& keys);
     size_t do_set_link(ColKey col_key, size_t row_ndx, size_t target_row_ndx);
 
+    std::vector<const Mixed*> check_bulk_columns(size_t num_objects, const std::vector<BulkColumn>& columns) const;
+    void do_bulk_create_objects(const std::vector<ObjKey>& keys, const std::vector<BulkColumn>& columns,
+                                const std::vector<GlobalKey>* object_ids);
     void populate_search_index(ColKey col_key);
+    // Insert the values of the clusters visited by `traverse` into the index
+    void populate_search_index(ColKey col_key, util::FunctionRef<void(ClusterTree::TraverseFunction)> traverse);
     void erase_from_search_indexes(ObjKey key);
     void update_indexes(ObjKey key, const FieldValues& values);
+    // Add the objects keys[begin..] to the search indexes, reading the values
+    // from the clusters visited by `traverse`
+    void bulk_update_indexes(const std::vector<ObjKey>& keys, size_t begin,
+                             util::FunctionRef<void(ClusterTree::TraverseFunction)> traverse);
     void clear_indexes();
+    // Must be called before the value is changed
+    void update_compound_indexes(ObjKey key, ColKey col_key, Mixed new_value)
+    {
+        // Tombstones are not indexed
+        if (key.is_unresolved())
+            return;
+        for (auto& index : m_compound_indexes) {
+            if (index->covers(col_key))
+                index->set(key, col_key, new_value);
+        }
+    }
+    void refresh_compound_index_accessors();
+    void refresh_geospatial_index_accessor();
     template <typename T>
     void do_populate_index(StringIndex* index, ColKey::Idx col_ndx);
 
@@ -785,6 +965,8 @@ private:
     ColKey do_insert_root_column(ColKey col_key, ColumnType, StringData name, DataType key_type = DataType(0));
     void do_erase_root_column(ColKey col_key);
     void do_add_search_index(ColKey col_key, IndexType type);
+    // Throws if the file format of the parent group is older than `version`
+    void check_file_format_version(int version, const char* feature) const;
 
     bool has_any_embedded_objects();
     void set_opposite_column(ColKey col_key, TableKey opposite_table, ColKey opposite_column);
@@ -827,6 +1009,8 @@ private:
     // accessors become invalid.
     void detach(LifeCycleCookie) noexcept;
     void fully_detach() noexcept;
+    // Estimate of the heap memory used by this accessor and its subordinates
+    size_t get_accessor_memory() const noexcept;
 
     ColumnType get_real_column_type(ColKey col_key) const noexcept;
 
@@ -836,6 +1020,12 @@ private:
     /// the reference to the underlying memory.
     static ref_type create_empty_table(Allocator&, TableKey = TableKey());
 
+    /// Write a modified table in the same way as `Array::write(ref, alloc,
+    /// out, true)`, but compress the large values of compressed columns and,
+    /// if `encode_integers` is true, write the leaves of the integer columns
+    /// that can hold neither null nor collections with `Array::write_encoded()`.
+    static ref_type typed_write(ref_type ref, _impl::ArrayWriterBase& out, Allocator& alloc, bool encode_integers);
+
     void nullify_links(CascadeState&);
     void remove_recursive(CascadeState&);
 
@@ -846,6 +1036,10 @@ private:
     /// Refresh the part of the accessor tree that is rooted at this
     /// table.
     void refresh_accessor_tree();
+    /// Returns true if this accessor is attached to the table at `ref` as it
+    /// is now, so that it does not need to be refreshed. This assumes that
+    /// the memory mapping has not changed since the accessor was refreshed.
+    bool is_attached_at(ref_type ref) const noexcept;
     void refresh_index_accessors();
     void refresh_content_version();
     void flush_for_commit();
@@ -859,6 +1053,8 @@ private:
     std::vector<ColKey::Idx> m_spec_ndx2leaf_ndx;
     std::vector<size_t> m_leaf_ndx2spec_ndx;
     Type m_table_type = Type::TopLevel;
+    // Log2 of the cluster node size set for the table, or zero if none is set
+    uint8_t m_cluster_node_shift = 0;
     uint64_t m_in_file_version_at_transaction_boundary = 0;
     AtomicLifeCycleCookie m_cookie;
 
@@ -876,8 +1072,16 @@ private:
     static constexpr int top_position_for_pk_col = 11;
     static constexpr int top_position_for_flags = 12;
     // flags contents: bit 0-1 - table type
+    //                 bit 2-5 - log2 of the cluster node size, or zero if not set
     static constexpr int top_position_for_tombstones = 13;
     static constexpr int top_array_size = 14;
+    // Only present if the table has compound indexes
+    static constexpr int top_position_for_compound_indexes = 14;
+    // Only present if the table has a geospatial index
+    static constexpr int top_position_for_geospatial_index = 15;
+
+    static constexpr int cluster_node_shift_offset = 2;
+    static constexpr uint64_t cluster_node_shift_mask = 0xf << cluster_node_shift_offset;
 
     enum { s_collision_map_lo = 0, s_collision_map_hi = 1, s_collision_map_local_id = 2, s_collision_map_num_slots };
 
@@ -894,6 +1098,7 @@ private:
     friend class LinkMap;
     friend class LinkView;
     friend class Group;
+    friend class GroupWriter;
     friend class Transaction;
     friend class Cluster;
     friend class ClusterTree;
@@ -906,6 +1111,7 @@ private:
     friend class IncludeDescriptor;
     template <class T>
     friend class AggregateHelper;
+    friend class ArrowExporter;
 };
 
 std::ostream& operator<<(std::ostream& o, Table::Type table_type);
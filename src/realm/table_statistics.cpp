@@ -0,0 +1,235 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/table_statistics.hpp>
+#include <realm/table.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace realm;
+
+namespace {
+
+// Position of a value on a linear scale, if it has one
+std::optional<double> to_double(Mixed value)
+{
+    switch (value.get_type()) {
+        case type_Int:
+            return double(value.get_int());
+        case type_Float:
+            return double(value.get_float());
+        case type_Double:
+            return value.get_double();
+        case type_Timestamp: {
+            auto ts = value.get_timestamp();
+            return double(ts.get_seconds()) + double(ts.get_nanoseconds()) / 1e9;
+        }
+        default:
+            return {};
+    }
+}
+
+} // anonymous namespace
+
+ColumnStatistics::ColumnStatistics(const Table& table, ColKey col)
+    : m_table_size(table.size())
+{
+    m_sample_size = std::min(m_table_size, max_sample_size);
+    if (m_sample_size == 0)
+        return;
+
+    // Take the objects in the middle of evenly sized ranges of the table
+    std::vector<Mixed> values;
+    values.reserve(m_sample_size);
+    for (size_t i = 0; i < m_sample_size; ++i) {
+        size_t ndx = (2 * i + 1) * m_table_size / (2 * m_sample_size);
+        Mixed value = table.get_object(ndx).get_any(col);
+        if (value.is_null()) {
+            ++m_null_count;
+            continue;
+        }
+        values.push_back(value);
+    }
+    if (values.empty())
+        return;
+
+    std::sort(values.begin(), values.end());
+
+    // Count the distinct values, and find the most frequent ones
+    std::vector<std::pair<size_t, size_t>> runs; // (count, start position)
+    size_t num_distinct = 0;
+    size_t num_singles = 0;
+    for (size_t begin = 0; begin < values.size();) {
+        size_t end = begin + 1;
+        while (end < values.size() && values[end] == values[begin])
+            ++end;
+        ++num_distinct;
+        if (end - begin == 1)
+            ++num_singles;
+        else
+            runs.emplace_back(end - begin, begin);
+        begin = end;
+    }
+    std::sort(runs.begin(), runs.end(), [](auto& a, auto& b) {
+        return a.first > b.first;
+    });
+    for (size_t i = 0; i < runs.size() && i < max_frequent_values; ++i) {
+        m_frequent_values.emplace_back(OwnedMixed(values[runs[i].second]), runs[i].first);
+        m_frequent_count += runs[i].first;
+    }
+
+    // If everything was sampled, the number of distinct values is known.
+    // Otherwise use the GEE estimator, which scales up the number of values
+    // seen only once.
+    size_t non_null_sampled = values.size();
+    if (m_sample_size == m_table_size) {
+        m_cardinality = double(num_distinct);
+    }
+    else {
+        double non_null_rows = double(m_table_size) * non_null_sampled / m_sample_size;
+        m_cardinality = std::sqrt(non_null_rows / non_null_sampled) * num_singles + (num_distinct - num_singles);
+        m_cardinality = std::min(std::max(m_cardinality, double(num_distinct)), non_null_rows);
+    }
+
+    size_t buckets = std::min(num_buckets, non_null_sampled);
+    m_bounds.reserve(buckets + 1);
+    for (size_t i = 0; i <= buckets; ++i) {
+        m_bounds.emplace_back(values[std::min(i * non_null_sampled / buckets, non_null_sampled - 1)]);
+    }
+}
+
+double ColumnStatistics::get_null_fraction() const noexcept
+{
+    return m_sample_size ? double(m_null_count) / m_sample_size : 0;
+}
+
+double ColumnStatistics::non_null_fraction() const noexcept
+{
+    return m_sample_size ? double(m_sample_size - m_null_count) / m_sample_size : 0;
+}
+
+double ColumnStatistics::estimate_equal(Mixed value) const
+{
+    if (value.is_null())
+        return get_null_fraction();
+    if (m_sample_size == 0)
+        return 0;
+    for (auto& [v, count] : m_frequent_values) {
+        if (v == value)
+            return double(count) / m_sample_size;
+    }
+    if (m_bounds.empty() || value < m_bounds.front() || m_bounds.back() < value)
+        return 0;
+    // Assume the remaining values to be equally frequent
+    double remaining = double(m_sample_size - m_null_count - m_frequent_count) / m_sample_size;
+    double remaining_distinct = std::max(1.0, m_cardinality - m_frequent_values.size());
+    return remaining / remaining_distinct;
+}
+
+double ColumnStatistics::estimate_less(Mixed value, bool inclusive) const
+{
+    if (value.is_null() || m_bounds.empty())
+        return 0;
+    if (value < m_bounds.front())
+        return 0;
+    if (m_bounds.back() < value)
+        return non_null_fraction();
+
+    // Find the bucket holding the value, and assume the values to be
+    // distributed evenly within it
+    size_t buckets = m_bounds.size() - 1;
+    auto it = std::upper_bound(m_bounds.begin(), m_bounds.end(), value);
+    size_t bucket = std::min(size_t(it - m_bounds.begin()), buckets) - 1;
+    double position = 0.5;
+    auto lo = to_double(m_bounds[bucket]);
+    auto hi = to_double(m_bounds[bucket + 1]);
+    auto v = to_double(value);
+    if (lo && hi && v && *hi > *lo)
+        position = std::min(std::max((*v - *lo) / (*hi - *lo), 0.0), 1.0);
+    double fraction = (bucket + position) / buckets * non_null_fraction();
+
+    // Values equal to the bound are covered by the buckets above it
+    double equal = estimate_equal(value);
+    if (!inclusive)
+        fraction -= equal / 2;
+    else
+        fraction += equal / 2;
+    return std::min(std::max(fraction, 0.0), non_null_fraction());
+}
+
+double ColumnStatistics::estimate_greater(Mixed value, bool inclusive) const
+{
+    if (value.is_null())
+        return 0;
+    return std::max(non_null_fraction() - estimate_less(value, !inclusive), 0.0);
+}
+
+bool TableStatistics::type_supported(ColKey col) noexcept
+{
+    if (col.is_collection())
+        return false;
+    switch (col.get_type()) {
+        case col_type_Int:
+        case col_type_Bool:
+        case col_type_String:
+        case col_type_Timestamp:
+        case col_type_Float:
+        case col_type_Double:
+        case col_type_ObjectId:
+        case col_type_UUID:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::shared_ptr<const ColumnStatistics> TableStatistics::get(const Table& table, ColKey col) const
+{
+    size_t table_size = table.size();
+    if (table_size < min_table_size || !type_supported(col))
+        return nullptr;
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_columns.find(col);
+        if (it != m_columns.end()) {
+            size_t size = it->second->get_table_size();
+            size_t drift = size > table_size ? size - table_size : table_size - size;
+            if (drift <= size / 8)
+                return it->second;
+        }
+    }
+
+    auto statistics = std::make_shared<const ColumnStatistics>(table, col);
+
+    std::lock_guard lock(m_mutex);
+    m_columns[col] = statistics;
+    return statistics;
+}
+
+void TableStatistics::erase(ColKey col) noexcept
+{
+    std::lock_guard lock(m_mutex);
+    m_columns.erase(col);
+}
+
+void TableStatistics::clear() noexcept
+{
+    std::lock_guard lock(m_mutex);
+    m_columns.clear();
+}
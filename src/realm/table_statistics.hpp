@@ -0,0 +1,116 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_TABLE_STATISTICS_HPP
+#define REALM_TABLE_STATISTICS_HPP
+
+#include <realm/keys.hpp>
+#include <realm/mixed.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace realm {
+
+class Table;
+
+/// Statistics of the values in a column, used by the query planner to
+/// estimate how many objects a condition matches.
+///
+/// The statistics are computed from an evenly spaced sample of the objects of
+/// the table. They consist of the fraction of null values, an estimate of the
+/// number of distinct values, the most frequent values in the sample, and an
+/// equi-depth histogram of the non-null values.
+class ColumnStatistics {
+public:
+    static constexpr size_t max_sample_size = 1024;
+    static constexpr size_t num_buckets = 32;
+    static constexpr size_t max_frequent_values = 8;
+
+    ColumnStatistics(const Table& table, ColKey col);
+
+    /// Number of objects in the table when the statistics were computed
+    size_t get_table_size() const noexcept
+    {
+        return m_table_size;
+    }
+    size_t get_sample_size() const noexcept
+    {
+        return m_sample_size;
+    }
+    double get_null_fraction() const noexcept;
+    /// Estimated number of distinct non-null values in the column
+    double get_cardinality() const noexcept
+    {
+        return m_cardinality;
+    }
+
+    /// Estimated fraction of the objects having the given value (which may be
+    /// null).
+    double estimate_equal(Mixed value) const;
+    /// Estimated fraction of the objects having a non-null value ordered
+    /// before `value` (or equal to it if `inclusive`).
+    double estimate_less(Mixed value, bool inclusive) const;
+    /// Estimated fraction of the objects having a non-null value ordered
+    /// after `value` (or equal to it if `inclusive`).
+    double estimate_greater(Mixed value, bool inclusive) const;
+
+private:
+    size_t m_table_size = 0;
+    size_t m_sample_size = 0;
+    size_t m_null_count = 0;
+    double m_cardinality = 0;
+    // The most frequent values of the sample, and their number of occurrences
+    std::vector<std::pair<OwnedMixed, size_t>> m_frequent_values;
+    size_t m_frequent_count = 0;
+    // Bucket boundaries of the histogram. Each bucket holds the same number of
+    // sampled values.
+    std::vector<OwnedMixed> m_bounds;
+
+    double non_null_fraction() const noexcept;
+};
+
+/// The column statistics of a table.
+///
+/// Statistics are only collected for tables with at least `min_table_size`
+/// objects, and only for columns that are actually queried. They are computed
+/// when first requested, and computed again when the number of objects in the
+/// table has changed by more than an eighth since then.
+class TableStatistics {
+public:
+    static constexpr size_t min_table_size = 1000;
+
+    /// Return the statistics of `col`, or null if the table is too small for
+    /// them to be useful, or the column type is not supported.
+    std::shared_ptr<const ColumnStatistics> get(const Table& table, ColKey col) const;
+
+    static bool type_supported(ColKey col) noexcept;
+
+    void erase(ColKey col) noexcept;
+    void clear() noexcept;
+
+private:
+    mutable std::mutex m_mutex;
+    mutable std::map<ColKey, std::shared_ptr<const ColumnStatistics>> m_columns;
+};
+
+} // namespace realm
+
+#endif // REALM_TABLE_STATISTICS_HPP
@@ -18,9 +18,12 @@
 
 #include <realm/table_view.hpp>
 #include <realm/column_integer.hpp>
+#include <realm/index_sorted.hpp>
 #include <realm/index_string.hpp>
 #include <realm/transaction.hpp>
+#include <realm/util/alloc_tracking.hpp>
 
+#include <algorithm>
 #include <unordered_set>
 
 using namespace realm;
@@ -65,6 +68,8 @@ TableView::TableView(TableView& src, Transaction* tr, PayloadPolicy policy_mode)
     }
     m_descriptor_ordering = src.m_descriptor_ordering;
     m_limit = src.m_limit;
+    m_incremental = src.m_incremental;
+    add_change_tracker();
 }
 
 // Aggregates ----------------------------------------------------
@@ -331,10 +336,126 @@ void TableView::sync_if_needed() const
 {
     if (!is_in_sync()) {
         // FIXME: Is this a reasonable handling of constness?
-        const_cast<TableView*>(this)->do_sync();
+        auto self = const_cast<TableView*>(this);
+        if (!self->do_incremental_sync())
+            self->do_sync();
     }
 }
 
+void TableView::set_incremental_sync(bool enable)
+{
+    if (enable == m_incremental)
+        return;
+    remove_change_tracker();
+    m_incremental = enable;
+    add_change_tracker();
+    m_journal_position = ChangeJournal::npos;
+    if (is_in_sync())
+        record_journal_position();
+}
+
+void TableView::record_journal_position()
+{
+    m_journal_position = ChangeJournal::npos;
+    if (!m_incremental || !m_table)
+        return;
+    // Changes are only recorded for transactions with a transaction log
+    auto tr = dynamic_cast<Transaction*>(m_table->get_parent_group());
+    if (!tr || !tr->get_replication())
+        return;
+    tr->record_local_changes(); // Throws
+    m_journal_position = m_table->get_change_journal().get_position();
+}
+
+bool TableView::can_sync_incrementally() const
+{
+    if (!m_incremental || m_journal_position == ChangeJournal::npos || !m_table || !m_query ||
+        m_collection_source || m_source_column_key || m_query->m_view || m_limit != size_t(-1))
+        return false;
+    // The query and the sort order must not depend on other objects than the
+    // one being evaluated, so links, even to the table itself, are excluded
+    if (m_last_seen_versions.size() != 1 || m_last_seen_versions[0].first != m_table->get_key())
+        return false;
+    if (m_query->follows_links())
+        return false;
+    if (m_descriptor_ordering.is_empty())
+        return true;
+    return m_descriptor_ordering.size() == 1 && m_descriptor_ordering.get_type(0) == DescriptorType::Sort &&
+           !static_cast<const SortDescriptor*>(m_descriptor_ordering[0])->get_table_columns().empty();
+}
+
+// Update the view by evaluating the query on the objects which have changed
+// since the view was last synchronized. Returns false if the view must be
+// synchronized by running the query instead.
+bool TableView::do_incremental_sync()
+{
+    if (!can_sync_incrementally())
+        return false;
+    util::CriticalSection cs(m_race_detector);
+
+    static_cast<Transaction*>(m_table->get_parent_group())->record_local_changes(); // Throws
+    auto& journal = m_table->get_change_journal();
+    std::vector<ObjKey> changed;
+    if (!journal.get_changes(m_journal_position, changed))
+        return false;
+    // Evaluating many objects one by one is slower than running the query
+    if (changed.size() * 4 > m_table->size())
+        return false;
+
+    // Unsorted views are in key order, and a view sorted with equal values
+    // keeps the objects of those in key order.
+    std::vector<ColKey> columns;
+    std::vector<bool> ascending;
+    if (!m_descriptor_ordering.is_empty()) {
+        auto sort = static_cast<const SortDescriptor*>(m_descriptor_ordering[0]);
+        columns = sort->get_table_columns();
+        for (size_t i = 0; i < columns.size(); ++i)
+            ascending.push_back(sort->is_ascending(i).value_or(true));
+    }
+    else if (!std::is_sorted(m_key_values.begin(), m_key_values.end())) {
+        return false;
+    }
+    auto less = [&](ObjKey a, ObjKey b) {
+        const Obj obj_a = m_table->get_object(a);
+        const Obj obj_b = m_table->get_object(b);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            int c = obj_a.get_any(columns[i]).compare(obj_b.get_any(columns[i]));
+            if (c)
+                return ascending[i] ? c < 0 : c > 0;
+        }
+        return a < b;
+    };
+
+    auto& keys = m_key_values.modify();
+    auto end = std::remove_if(keys.begin(), keys.end(), [&](ObjKey key) {
+        return std::binary_search(changed.begin(), changed.end(), key);
+    });
+    keys.erase(end, keys.end());
+
+    m_query->init(false);
+    std::vector<ObjKey> added;
+    for (auto key : changed) {
+        if (auto obj = m_table->try_get_object(key); obj && m_query->eval_object(obj))
+            added.push_back(key);
+    }
+    if (columns.empty()) {
+        size_t old_size = keys.size();
+        keys.insert(keys.end(), added.begin(), added.end());
+        std::inplace_merge(keys.begin(), keys.begin() + old_size, keys.end());
+    }
+    else {
+        for (auto key : added) {
+            auto pos = std::upper_bound(keys.begin(), keys.end(), key, less);
+            keys.insert(pos, key);
+        }
+    }
+
+    m_last_seen_versions.clear();
+    get_dependencies(m_last_seen_versions);
+    m_journal_position = journal.get_position();
+    return true;
+}
+
 void TableView::update_query(const Query& q)
 {
     REALM_ASSERT(m_query);
@@ -356,12 +477,13 @@ void TableView::clear()
         m_last_seen_versions == get_dependency_versions() && !m_descriptor_ordering.will_apply_distinct();
 
     // Remove all invalid keys
-    auto it = std::remove_if(m_key_values.begin(), m_key_values.end(), [this](const ObjKey& key) {
+    auto& keys = m_key_values.modify();
+    auto it = std::remove_if(keys.begin(), keys.end(), [this](const ObjKey& key) {
         return !m_table->is_valid(key);
     });
-    m_key_values.erase(it, m_key_values.end());
+    keys.erase(it, keys.end());
 
-    _impl::TableFriend::batch_erase_objects(*get_parent(), m_key_values); // Throws
+    _impl::TableFriend::batch_erase_objects(*get_parent(), keys); // Throws
 
     // It is important to not accidentally bring us in sync, if we were
     // not in sync to start with:
@@ -396,6 +518,16 @@ void TableView::filter(FilterDescriptor filter)
     do_sync();
 }
 
+std::vector<double> TableView::get_fulltext_scores(ColKey column, StringData terms) const
+{
+    std::vector<ObjKey> keys;
+    keys.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        keys.push_back(is_obj_valid(i) ? get_key(i) : ObjKey());
+    }
+    return m_table->get_fulltext_scores(column, terms, keys);
+}
+
 void TableView::apply_descriptor_ordering(const DescriptorOrdering& new_ordering)
 {
     m_descriptor_ordering = new_ordering;
@@ -404,6 +536,24 @@ void TableView::apply_descriptor_ordering(const DescriptorOrdering& new_ordering
     do_sync();
 }
 
+void TableView::apply_descriptor_ordering(const DescriptorOrdering& new_ordering, const std::vector<ObjKey>& keys)
+{
+    REALM_ASSERT(m_query);
+    m_descriptor_ordering = new_ordering;
+    m_descriptor_ordering.collect_dependencies(m_table.unchecked_ptr());
+
+    util::CriticalSection cs(m_race_detector);
+    if (m_key_values.is_attached())
+        m_key_values.clear();
+    else
+        m_key_values.create();
+    for (auto key : keys)
+        m_key_values.add(key);
+    m_last_seen_versions.clear();
+    get_dependencies(m_last_seen_versions);
+    record_journal_position();
+}
+
 std::string TableView::get_descriptor_ordering_description() const
 {
     return m_descriptor_ordering.get_description(m_table);
@@ -427,6 +577,7 @@ void TableView::sort(SortDescriptor order)
 
 void TableView::do_sync()
 {
+    util::AllocTagScope alloc_tag{util::AllocTag::query};
     util::CriticalSection cs(m_race_detector);
     // This TableView can be "born" from 4 different sources:
     // - LinkView
@@ -469,6 +620,22 @@ void TableView::do_sync()
 
         if (m_query->m_view)
             m_query->m_view->sync_if_needed();
+
+        if (find_all_using_sorted_index()) {
+            // The first descriptor has already been applied
+            apply_descriptors(m_descriptor_ordering, 1);
+            get_dependencies(m_last_seen_versions);
+            record_journal_position();
+            return;
+        }
+        if (find_all_top_k()) {
+            // The sort and the limit have already been applied
+            apply_descriptors(m_descriptor_ordering, 2);
+            get_dependencies(m_last_seen_versions);
+            record_journal_position();
+            return;
+        }
+
         size_t limit = m_limit;
         if (!m_descriptor_ordering.is_empty()) {
             auto type = m_descriptor_ordering[0]->get_type();
@@ -478,16 +645,203 @@ void TableView::do_sync()
                     limit = l;
             }
         }
-        QueryStateFindAll<std::vector<ObjKey>> st(m_key_values, limit);
+        QueryStateFindAll<std::vector<ObjKey>> st(m_key_values.modify(), limit);
         m_query->do_find_all(st);
     }
 
     apply_descriptors(m_descriptor_ordering);
 
     get_dependencies(m_last_seen_versions);
+    record_journal_position();
+}
+
+namespace {
+
+// Keeps the first `limit` matches of a query in sort order in a bounded heap,
+// so that the full set of matches is never stored. Equal objects are ordered
+// by the order in which they are matched, like a stable sort would do.
+class QueryStateTopK : public QueryStateBase {
+public:
+    QueryStateTopK(const Table& table, std::vector<ColKey> columns, const SortDescriptor& sort, size_t limit)
+        : m_table(table)
+        , m_columns(std::move(columns))
+        , m_max_size(limit)
+    {
+        for (size_t i = 0; i < m_columns.size(); ++i)
+            m_ascending.push_back(sort.is_ascending(i).value_or(true));
+        m_heap.reserve(limit);
+    }
+
+    bool match(size_t index, Mixed) noexcept final
+    {
+        return match(index);
+    }
+    bool match(size_t index) noexcept final
+    {
+        ++m_match_count;
+        ObjKey key((m_key_values ? m_key_values->get(index) : index) + m_key_offset);
+        Entry entry{key, m_match_count, m_table.try_get_object(key).get_any(m_columns[0])};
+        if (m_heap.size() < m_max_size) {
+            m_heap.push_back(entry);
+            std::push_heap(m_heap.begin(), m_heap.end(), std::ref(*this));
+        }
+        else if (m_max_size && (*this)(entry, m_heap.front())) {
+            // Replace the last of the objects kept so far
+            std::pop_heap(m_heap.begin(), m_heap.end(), std::ref(*this));
+            m_heap.back() = entry;
+            std::push_heap(m_heap.begin(), m_heap.end(), std::ref(*this));
+        }
+        return true;
+    }
+
+    std::vector<ObjKey> get_keys()
+    {
+        std::sort_heap(m_heap.begin(), m_heap.end(), std::ref(*this));
+        std::vector<ObjKey> keys;
+        keys.reserve(m_heap.size());
+        for (auto& entry : m_heap)
+            keys.push_back(entry.key);
+        return keys;
+    }
+
+    struct Entry {
+        ObjKey key;
+        size_t sequence;
+        Mixed first_value;
+    };
+
+    bool operator()(const Entry& a, const Entry& b) const noexcept
+    {
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            int c = i == 0 ? a.first_value.compare(b.first_value)
+                           : m_table.try_get_object(a.key)
+                                 .get_any(m_columns[i])
+                                 .compare(m_table.try_get_object(b.key).get_any(m_columns[i]));
+            if (c)
+                return m_ascending[i] ? c < 0 : c > 0;
+        }
+        return a.sequence < b.sequence;
+    }
+
+private:
+    const Table& m_table;
+    std::vector<ColKey> m_columns;
+    std::vector<bool> m_ascending;
+    size_t m_max_size;
+    std::vector<Entry> m_heap; // The last object in sort order at the front
+};
+
+} // anonymous namespace
+
+// If the view is sorted on columns of the table and then limited to a number
+// of objects which is small compared to the size of the table, only keep the
+// objects which can make it into the result while running the query.
+bool TableView::find_all_top_k()
+{
+    if (m_limit != size_t(-1) || m_descriptor_ordering.size() < 2 ||
+        m_descriptor_ordering.get_type(0) != DescriptorType::Sort ||
+        m_descriptor_ordering.get_type(1) != DescriptorType::Limit)
+        return false;
+    auto sort = static_cast<const SortDescriptor*>(m_descriptor_ordering[0]);
+    auto columns = sort->get_table_columns();
+    if (columns.empty())
+        return false;
+    for (auto col : columns) {
+        if (!m_table->valid_column(col) || col.is_collection())
+            return false;
+    }
+    // Unless the limit is small, storing all the matches and partitioning
+    // them is just as quick
+    size_t limit = static_cast<const LimitDescriptor*>(m_descriptor_ordering[1])->get_limit();
+    if (limit >= (m_table->size() >> 4))
+        return false;
+
+    m_key_values.clear();
+    if (limit == 0)
+        return true;
+
+    QueryStateTopK st(*m_table, std::move(columns), *sort, limit);
+    m_query->do_find_all(st);
+    for (auto key : st.get_keys())
+        m_key_values.add(key);
+    return true;
+}
+
+// If the view is sorted on a single column with a sorted index, the objects can
+// be produced directly in sorted order by walking the index. With a limit, the
+// walk stops as soon as enough objects have been found.
+bool TableView::find_all_using_sorted_index()
+{
+    if (m_limit != size_t(-1) || m_query->m_view || m_descriptor_ordering.is_empty() ||
+        m_descriptor_ordering.get_type(0) != DescriptorType::Sort)
+        return false;
+    auto sort = static_cast<const SortDescriptor*>(m_descriptor_ordering[0]);
+    ColKey col = sort->get_single_column();
+    if (!col || !m_table->valid_column(col))
+        return false;
+    auto index = dynamic_cast<const SortedIndex*>(m_table->get_search_index(col));
+    // A case insensitive index does not order strings like the sort does
+    if (!index || index->is_case_insensitive())
+        return false;
+
+    size_t limit = size_t(-1);
+    if (m_descriptor_ordering.size() > 1 && m_descriptor_ordering.get_type(1) == DescriptorType::Limit)
+        limit = static_cast<const LimitDescriptor*>(m_descriptor_ordering[1])->get_limit();
+
+    bool has_conditions = m_query->has_conditions();
+    // Evaluating the conditions object by object is only worth it if we are
+    // likely to reach the limit early. Otherwise fall back to find_all + sort.
+    size_t max_examined = size_t(-1);
+    if (has_conditions) {
+        if (limit == size_t(-1))
+            return false;
+        max_examined = std::max(limit * 64, size_t(1000));
+        m_query->init(false);
+    }
+
+    std::vector<ObjKey> keys;
+    size_t examined = 0;
+    auto add = [&](ObjKey key) {
+        ++examined;
+        if (!has_conditions || m_query->eval_object(m_table->get_object(key)))
+            keys.push_back(key);
+        return keys.size() < limit;
+    };
+
+    size_t sz = index->size();
+    bool ascending = sort->is_ascending(0).value_or(true);
+    if (ascending) {
+        for (size_t i = 0; i < sz && examined < max_examined; ++i) {
+            if (!add(index->get(i)))
+                break;
+        }
+    }
+    else {
+        // Sorting is stable, so objects with equal values must still come in
+        // ascending key order. Emit them one group of equal values at a time.
+        size_t end = sz;
+        bool more = true;
+        while (end > 0 && more && examined < max_examined) {
+            size_t begin = end - 1;
+            Mixed value = index->get_value(begin);
+            while (begin > 0 && index->get_value(begin - 1) == value)
+                --begin;
+            for (size_t i = begin; i < end && more; ++i)
+                more = add(index->get(i));
+            end = begin;
+        }
+    }
+
+    if (keys.size() < limit && examined < sz && examined >= max_examined)
+        return false;
+
+    m_key_values.clear();
+    for (auto key : keys)
+        m_key_values.add(key);
+    return true;
 }
 
-void TableView::apply_descriptors(const DescriptorOrdering& ordering)
+void TableView::apply_descriptors(const DescriptorOrdering& ordering, size_t first_descriptor)
 {
     if (ordering.is_empty())
         return;
@@ -529,7 +883,7 @@ void TableView::apply_descriptors(const DescriptorOrdering& ordering)
     };
 
     const int num_descriptors = int(ordering.size());
-    for (int desc_ndx = 0; desc_ndx < num_descriptors; ++desc_ndx) {
+    for (int desc_ndx = int(first_descriptor); desc_ndx < num_descriptors; ++desc_ndx) {
         const BaseDescriptor* base_descr = ordering[desc_ndx];
         const BaseDescriptor* next = ((desc_ndx + 1) < num_descriptors) ? ordering[desc_ndx + 1] : nullptr;
 
@@ -546,6 +900,9 @@ void TableView::apply_descriptors(const DescriptorOrdering& ordering)
             // identical, then the rows are ordered according to the second column, and so forth. For the
             // first column, we cache all the payload of fields of the view in a std::vector<Mixed>
             predicate.cache_first_column(index_pairs);
+            // Frozen tables may be read from several threads at once
+            if (m_query && m_table->is_frozen())
+                predicate.set_parallelism(m_query->get_parallelism());
 
             base_descr->execute(index_pairs, predicate, next);
         }
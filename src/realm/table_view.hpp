@@ -147,8 +147,13 @@ namespace realm {
 // However, these are problems that you should expect, since the activity is spread over multiple
 // transactions.
 
-class KeyValues : public std::vector<ObjKey> {
+// The keys of the objects in a TableView. Copies share the same buffer, which
+// is only copied when one of them is modified, so that snapshots, frozen copies
+// and handed over views of large results do not duplicate the keys.
+class KeyValues {
 public:
+    using const_iterator = std::vector<ObjKey>::const_iterator;
+
     KeyValues() = default;
     void create()
     {
@@ -158,13 +163,30 @@ public:
     {
         return m_attached;
     }
-    void add(ObjKey k)
+    size_t size() const noexcept
     {
-        push_back(k);
+        return m_keys ? m_keys->size() : 0;
+    }
+    bool empty() const noexcept
+    {
+        return size() == 0;
     }
     ObjKey get(size_t n) const
     {
-        return operator[](n);
+        return (*m_keys)[n];
+    }
+    const std::vector<ObjKey>& values() const noexcept
+    {
+        static const std::vector<ObjKey> no_keys;
+        return m_keys ? *m_keys : no_keys;
+    }
+    const_iterator begin() const noexcept
+    {
+        return values().begin();
+    }
+    const_iterator end() const noexcept
+    {
+        return values().end();
     }
     size_t find_first(ObjKey k) const
     {
@@ -175,7 +197,37 @@ public:
         return realm::not_found;
     }
 
+    void add(ObjKey k)
+    {
+        modify().push_back(k);
+    }
+    void clear() noexcept
+    {
+        // Keep the capacity of an unshared buffer for reuse
+        if (m_keys && m_keys.use_count() == 1)
+            m_keys->clear();
+        else
+            m_keys.reset();
+    }
+    /// Returns the keys for modification, copying them first if the buffer is
+    /// shared with other copies.
+    std::vector<ObjKey>& modify()
+    {
+        if (!m_keys)
+            m_keys = std::make_shared<std::vector<ObjKey>>();
+        else if (m_keys.use_count() > 1)
+            m_keys = std::make_shared<std::vector<ObjKey>>(*m_keys);
+        return *m_keys;
+    }
+
+    /// Returns true if this and `other` share the same buffer.
+    bool shares_keys_with(const KeyValues& other) const noexcept
+    {
+        return m_keys && m_keys == other.m_keys;
+    }
+
 private:
+    std::shared_ptr<std::vector<ObjKey>> m_keys;
     bool m_attached = false;
 };
 
@@ -201,7 +253,10 @@ public:
 
     TableView(TableView& source, Transaction* tr, PayloadPolicy mode);
 
-    ~TableView() {}
+    ~TableView()
+    {
+        remove_change_tracker();
+    }
 
     TableRef get_parent() const noexcept
     {
@@ -342,6 +397,22 @@ public:
     // before any of the other access-methods whenever the view may have become
     // outdated.
     void sync_if_needed() const final;
+
+    // Let sync_if_needed() update the view from the changes made to the
+    // objects of the table since it was last synchronized, instead of rerunning
+    // the query. Only the changed objects are evaluated against the query,
+    // and then removed, inserted or moved in the view. This is done when the
+    // view is backed by a query which only depends on the table itself, and is
+    // at most sorted on properties of the table. In other cases, and when
+    // too many objects have changed, the query is rerun as usual.
+    //
+    // Changes are collected from the transaction logs, so the view must belong
+    // to a transaction with a history.
+    void set_incremental_sync(bool enable);
+    bool is_incremental_sync() const noexcept
+    {
+        return m_incremental;
+    }
     // Return the version of the source it was created from.
     TableVersions get_dependency_versions() const
     {
@@ -371,10 +442,21 @@ public:
     void limit(LimitDescriptor limit);
     void filter(FilterDescriptor filter);
 
+    // The BM25 relevance of each object in the view for the fulltext search
+    // `terms` on `column`, in the order of the view. Objects that are no
+    // longer valid score 0.
+    std::vector<double> get_fulltext_scores(ColKey column, StringData terms) const;
+
     // Replace the order of sort and distinct operations, bypassing manually
     // calling sort and distinct. This is a convenience method for bindings.
     void apply_descriptor_ordering(const DescriptorOrdering& new_ordering);
 
+    // Same as above, but rather than running the query, take the objects in
+    // `keys` as the result. For use when the result is already known, e.g.
+    // because nothing which could change it has changed since the query was
+    // last run. The view is then in sync with the current versions.
+    void apply_descriptor_ordering(const DescriptorOrdering& new_ordering, const std::vector<ObjKey>& keys);
+
     // Gets a readable and parsable string which completely describes the sort and
     // distinct operations applied to this view.
     std::string get_descriptor_ordering_description() const;
@@ -400,7 +482,12 @@ protected:
     void get_dependencies(TableVersions&) const final;
 
     void do_sync();
-    void apply_descriptors(const DescriptorOrdering&);
+    void apply_descriptors(const DescriptorOrdering&, size_t first_descriptor = 0);
+    bool find_all_using_sorted_index();
+    bool find_all_top_k();
+    bool can_sync_incrementally() const;
+    bool do_incremental_sync();
+    void record_journal_position();
 
     mutable ConstTableRef m_table;
     // The source column index that this view contain backlinks for.
@@ -422,6 +509,10 @@ protected:
     mutable TableVersions m_last_seen_versions;
     KeyValues m_key_values;
 
+    // Position in the change journal of the table the view has been synchronized to
+    bool m_incremental = false;
+    uint64_t m_journal_position = ChangeJournal::npos;
+
 private:
     ObjKey find_first_integer(ColKey column_key, int64_t value) const;
     template <Action action>
@@ -429,6 +520,17 @@ private:
 
     util::RaceDetector m_race_detector;
 
+    void add_change_tracker() const noexcept
+    {
+        if (m_incremental && m_table)
+            m_table->get_change_journal().add_tracker();
+    }
+    void remove_change_tracker() const noexcept
+    {
+        if (m_incremental && m_table)
+            m_table->get_change_journal().remove_tracker();
+    }
+
     friend class Table;
     friend class Obj;
     friend class Query;
@@ -492,7 +594,10 @@ inline TableView::TableView(const TableView& tv)
     , m_limit(tv.m_limit)
     , m_last_seen_versions(tv.m_last_seen_versions)
     , m_key_values(tv.m_key_values)
+    , m_incremental(tv.m_incremental)
+    , m_journal_position(tv.m_journal_position)
 {
+    add_change_tracker();
 }
 
 inline TableView::TableView(TableView&& tv) noexcept
@@ -507,11 +612,15 @@ inline TableView::TableView(TableView&& tv) noexcept
     // version number so that we can later trigger a sync if needed.
     , m_last_seen_versions(std::move(tv.m_last_seen_versions))
     , m_key_values(std::move(tv.m_key_values))
+    , m_incremental(tv.m_incremental)
+    , m_journal_position(tv.m_journal_position)
 {
+    tv.m_incremental = false;
 }
 
 inline TableView& TableView::operator=(TableView&& tv) noexcept
 {
+    remove_change_tracker();
     m_table = std::move(tv.m_table);
 
     m_key_values = std::move(tv.m_key_values);
@@ -522,6 +631,9 @@ inline TableView& TableView::operator=(TableView&& tv) noexcept
     m_linked_obj = tv.m_linked_obj;
     m_collection_source = std::move(tv.m_collection_source);
     m_descriptor_ordering = std::move(tv.m_descriptor_ordering);
+    m_incremental = tv.m_incremental;
+    m_journal_position = tv.m_journal_position;
+    tv.m_incremental = false;
 
     return *this;
 }
@@ -531,6 +643,7 @@ inline TableView& TableView::operator=(const TableView& tv)
     if (this == &tv)
         return *this;
 
+    remove_change_tracker();
     m_key_values = tv.m_key_values;
 
     m_query = tv.m_query;
@@ -540,6 +653,9 @@ inline TableView& TableView::operator=(const TableView& tv)
     m_linked_obj = tv.m_linked_obj;
     m_collection_source = tv.m_collection_source ? tv.m_collection_source->clone_obj_list() : LinkCollectionPtr{};
     m_descriptor_ordering = tv.m_descriptor_ordering;
+    m_incremental = tv.m_incremental;
+    m_journal_position = m_table == tv.m_table ? tv.m_journal_position : ChangeJournal::npos;
+    add_change_tracker();
 
     return *this;
 }
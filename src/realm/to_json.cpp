@@ -23,8 +23,72 @@
 #include <external/json/json.hpp>
 #include "realm/util/base64.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
 namespace realm {
 
+namespace {
+
+// These write directly to the stream without building temporary strings, and
+// without touching the formatting state of the stream, as exporting a large
+// file spends most of its time here.
+
+void out_int(std::ostream& out, int64_t value)
+{
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof buffer, value);
+    out.write(buffer, result.ptr - buffer);
+}
+
+template <class T>
+void out_floats(std::ostream& out, T value)
+{
+    // Same as streaming with std::scientific and a precision of digits10 + 1
+    char buffer[32];
+    int size = std::snprintf(buffer, sizeof buffer, "%.*e", std::numeric_limits<T>::digits10 + 1, double(value));
+    out.write(buffer, std::min(size_t(size), sizeof buffer - 1));
+}
+
+void out_string(std::ostream& out, StringData str)
+{
+    static constexpr char to_be_escaped[] = "\"\n\r\t\f\\\b";
+    static constexpr char encoding[] = "\"nrtf\\b";
+
+    const char* begin = str.data();
+    const char* end = begin + str.size();
+    const char* pos = begin;
+    for (; pos != end; ++pos) {
+        // A null character terminates the search in strchr(), so must be
+        // excluded explicitly
+        const char* found = *pos ? std::strchr(to_be_escaped, *pos) : nullptr;
+        if (!found)
+            continue;
+        out.write(begin, pos - begin);
+        char escaped[2] = {'\\', encoding[found - to_be_escaped]};
+        out.write(escaped, 2);
+        begin = pos + 1;
+    }
+    out.write(begin, pos - begin);
+}
+
+void out_binary(std::ostream& out, BinaryData bin)
+{
+    // Encode in chunks which are a multiple of 3 bytes, so that no padding is
+    // added except at the end
+    constexpr size_t chunk_size = 3 * 1024;
+    char encode_buffer[4 * 1024];
+    for (size_t offset = 0; offset < bin.size(); offset += chunk_size) {
+        size_t size = std::min(chunk_size, bin.size() - offset);
+        size_t encoded_size = util::base64_encode({bin.data() + offset, size}, encode_buffer);
+        out.write(encode_buffer, encoded_size);
+    }
+}
+
+} // anonymous namespace
+
 void Group::schema_to_json(std::ostream& out) const
 {
     check_attached();
@@ -230,7 +294,8 @@ void Obj::to_json(std::ostream& out, JSONOutputMode output_mode) const
     out << "{";
     if (output_mode == output_mode_json && !m_table->get_primary_key_column() && !m_table->is_embedded()) {
         prefixComma = true;
-        out << "\"_key\":" << this->m_key.value;
+        out << "\"_key\":";
+        out_int(out, m_key.value);
     }
 
     auto col_keys = m_table->get_column_keys();
@@ -259,7 +324,7 @@ void Obj::to_json(std::ostream& out, JSONOutputMode output_mode) const
                 typed_link = true;
             }
             auto obj_key = val.get<ObjKey>();
-            std::string closing;
+            const char* closing = "";
 
             if (tt->is_embedded()) {
                 if (output_mode == output_mode_xjson_plus) {
@@ -280,7 +345,7 @@ void Obj::to_json(std::ostream& out, JSONOutputMode output_mode) const
                     tt->get_primary_key(obj_key).to_json(out, output_mode);
                 }
                 else {
-                    out << obj_key.value;
+                    out_int(out, obj_key.value);
                 }
             }
             out << closing;
@@ -318,49 +383,13 @@ void Obj::to_json(std::ostream& out, JSONOutputMode output_mode) const
     out << "}";
 }
 
-namespace {
-const char to_be_escaped[] = "\"\n\r\t\f\\\b";
-const char encoding[] = "\"nrtf\\b";
-
-template <class T>
-inline void out_floats(std::ostream& out, T value)
-{
-    std::streamsize old = out.precision();
-    out.precision(std::numeric_limits<T>::digits10 + 1);
-    out << std::scientific << value;
-    out.precision(old);
-}
-
-void out_string(std::ostream& out, std::string str)
-{
-    size_t p = str.find_first_of(to_be_escaped);
-    while (p != std::string::npos) {
-        char c = str[p];
-        auto found = strchr(to_be_escaped, c);
-        REALM_ASSERT(found);
-        out << str.substr(0, p) << '\\' << encoding[found - to_be_escaped];
-        str = str.substr(p + 1);
-        p = str.find_first_of(to_be_escaped);
-    }
-    out << str;
-}
-
-void out_binary(std::ostream& out, BinaryData bin)
-{
-    std::string encode_buffer;
-    encode_buffer.resize(util::base64_encoded_size(bin.size()));
-    util::base64_encode(bin, encode_buffer);
-    out << encode_buffer;
-}
-} // anonymous namespace
-
 
 void Mixed::to_xjson(std::ostream& out) const noexcept
 {
     switch (get_type()) {
         case type_Int:
             out << "{\"$numberLong\": \"";
-            out << int_val;
+            out_int(out, int_val);
             out << "\"}";
             break;
         case type_Bool:
@@ -391,7 +420,7 @@ void Mixed::to_xjson(std::ostream& out) const noexcept
         case type_Timestamp: {
             out << "{\"$date\": {\"$numberLong\": \"";
             int64_t timeMillis = date_val.get_seconds() * 1000 + date_val.get_nanoseconds() / 1000000;
-            out << timeMillis;
+            out_int(out, timeMillis);
             out << "\"}}";
             break;
         }
@@ -456,7 +485,7 @@ void Mixed::to_json(std::ostream& out, JSONOutputMode output_mode) const noexcep
         case output_mode_json: {
             switch (get_type()) {
                 case type_Int:
-                    out << int_val;
+                    out_int(out, int_val);
                     break;
                 case type_Bool:
                     out << (bool_val ? "true" : "false");
@@ -19,6 +19,8 @@
 #include <realm/tokenizer.hpp>
 #include <realm/exceptions.hpp>
 
+#include <algorithm>
+
 namespace realm {
 
 Tokenizer::~Tokenizer() {}
@@ -41,10 +43,12 @@ std::set<std::string> Tokenizer::get_all_tokens()
     }
     return tokens;
 }
-std::pair<std::set<std::string>, std::set<std::string>> Tokenizer::get_search_tokens()
+SearchTokens Tokenizer::get_search_tokens()
 {
     std::vector<std::string_view> incl;
     std::vector<std::string_view> excl;
+    std::vector<std::string_view> incl_phrases;
+    std::vector<std::string_view> excl_phrases;
 
     const char* begin = nullptr;
     const char* end = nullptr;
@@ -61,7 +65,23 @@ std::pair<std::set<std::string>, std::set<std::string>> Tokenizer::get_search_to
         }
     };
     for (; m_cur_pos != m_end_pos; m_cur_pos++) {
-        if (isspace(*m_cur_pos)) {
+        if (*m_cur_pos == '"') {
+            // A phrase, optionally preceded by '-' to exclude it
+            bool exclude = begin && end - begin == 1 && *begin == '-';
+            if (exclude) {
+                begin = nullptr;
+            }
+            else {
+                add_token();
+            }
+            const char* phrase_begin = m_cur_pos + 1;
+            m_cur_pos = std::find(phrase_begin, m_end_pos, '"');
+            if (m_cur_pos == m_end_pos) {
+                throw InvalidArgument("Unterminated phrase in search string");
+            }
+            (exclude ? excl_phrases : incl_phrases).emplace_back(phrase_begin, m_cur_pos - phrase_begin);
+        }
+        else if (isspace(*m_cur_pos)) {
             add_token();
         }
         else {
@@ -76,8 +96,9 @@ std::pair<std::set<std::string>, std::set<std::string>> Tokenizer::get_search_to
     }
     add_token();
 
-    std::set<std::string> includes;
-    std::set<std::string> excludes;
+    SearchTokens tokens;
+    auto& includes = tokens.includes;
+    auto& excludes = tokens.excludes;
 
     for (auto& tok : incl) {
         reset(tok);
@@ -94,10 +115,32 @@ std::pair<std::set<std::string>, std::set<std::string>> Tokenizer::get_search_to
             throw InvalidArgument("Non alphanumeric characters not allowed inside search word");
         }
     }
+
+    // Punctuation inside a phrase just separates its words, as it does in
+    // the text searched
+    auto get_phrase = [&](std::string_view text) {
+        Phrase phrase;
+        reset(text);
+        while (next()) {
+            phrase.emplace_back(get_token());
+        }
+        return phrase;
+    };
+    for (auto& text : incl_phrases) {
+        auto phrase = get_phrase(text);
+        includes.insert(phrase.begin(), phrase.end());
+        if (phrase.size() > 1) {
+            tokens.phrases.push_back(std::move(phrase));
+        }
+    }
+
     for (auto& tok : excl) {
         reset(tok);
         next();
         std::string t(get_token());
+        if (tok.back() == '*') {
+            t += '*';
+        }
         if (includes.count(t)) {
             throw InvalidArgument("You can't include and exclude the same token");
         }
@@ -106,8 +149,20 @@ std::pair<std::set<std::string>, std::set<std::string>> Tokenizer::get_search_to
             throw InvalidArgument("Non alphanumeric characters not allowed inside search word");
         }
     }
+    for (auto& text : excl_phrases) {
+        auto phrase = get_phrase(text);
+        if (phrase.size() == 1) {
+            if (includes.count(phrase[0])) {
+                throw InvalidArgument("You can't include and exclude the same token");
+            }
+            excludes.insert(phrase[0]);
+        }
+        else if (phrase.size() > 1) {
+            tokens.excluded_phrases.push_back(std::move(phrase));
+        }
+    }
 
-    return {includes, excludes};
+    return tokens;
 }
 
 TokenInfoMap Tokenizer::get_token_info()
@@ -48,6 +48,17 @@ struct TokenInfo {
 
 using TokenInfoMap = std::map<std::string, TokenInfo>;
 
+using Phrase = std::vector<std::string>;
+
+struct SearchTokens {
+    std::set<std::string> includes;
+    std::set<std::string> excludes;
+    // Words given in double quotes, which must appear next to each other in
+    // the text. The words of the included phrases are in `includes` as well.
+    std::vector<Phrase> phrases;
+    std::vector<Phrase> excluded_phrases;
+};
+
 class Tokenizer {
 public:
     virtual ~Tokenizer();
@@ -60,7 +71,7 @@ public:
         return {m_buffer, m_size};
     }
     std::set<std::string> get_all_tokens();
-    std::pair<std::set<std::string>, std::set<std::string>> get_search_tokens();
+    SearchTokens get_search_tokens();
     TokenInfoMap get_token_info();
 
     static std::unique_ptr<Tokenizer> get_instance();
@@ -188,6 +188,8 @@ Transaction::~Transaction()
 
 void Transaction::close()
 {
+    if (m_is_shared)
+        return;
     if (m_transact_stage == DB::transact_Writing) {
         rollback();
     }
@@ -215,9 +217,10 @@ DB::version_type Transaction::commit()
     REALM_ASSERT(is_attached());
 
     // before committing, allow any accessors at group level or below to sync
+    record_local_changes();
     flush_accessors_for_commit();
 
-    DB::version_type new_version = db->do_commit(*this); // Throws
+    DB::version_type new_version = db->do_commit(*this, true, true); // Throws
 
     // We need to set m_read_lock in order for wait_for_change to work.
     // To set it, we grab a readlock on the latest available snapshot
@@ -227,9 +230,12 @@ DB::version_type Transaction::commit()
 
     db->end_write_on_correct_thread();
 
+    DBRef db_ref = db; // Ending the read transaction releases the DB
     do_end_read();
     m_read_lock = lock_after_commit;
 
+    db_ref->wait_for_group_commit(*this, new_version); // Throws
+
     return new_version;
 }
 
@@ -254,7 +260,7 @@ void Transaction::rollback()
 
 void Transaction::end_read()
 {
-    if (m_transact_stage == DB::transact_Ready)
+    if (m_transact_stage == DB::transact_Ready || m_is_shared)
         return;
     if (m_transact_stage == DB::transact_Writing)
         throw WrongTransactionState("Illegal end_read when in write mode");
@@ -267,9 +273,16 @@ VersionID Transaction::commit_and_continue_as_read(bool commit_to_disk)
     if (m_transact_stage != DB::transact_Writing)
         throw WrongTransactionState("Not a write transaction");
 
+    record_local_changes();
     flush_accessors_for_commit();
 
-    DB::version_type version = db->do_commit(*this, commit_to_disk); // Throws
+    bool allow_group_commit;
+    {
+        // Group commit needs the write lock to be released by the commit
+        util::CheckedLockGuard lock(m_async_mutex);
+        allow_group_commit = commit_to_disk && m_async_stage != AsyncState::Requesting;
+    }
+    DB::version_type version = db->do_commit(*this, commit_to_disk, allow_group_commit); // Throws
 
     // advance read lock but dont update accessors:
     // As this is done under lock, along with the addition above of the newest commit,
@@ -294,6 +307,7 @@ VersionID Transaction::commit_and_continue_as_read(bool commit_to_disk)
             // We are not commiting to disk and there is no older
             // version not persisted, so hold onto this one
             m_oldest_version_not_persisted = m_read_lock;
+            db->keep_read_lock(*m_oldest_version_not_persisted);
         }
 
         if (commit_to_disk && m_oldest_version_not_persisted) {
@@ -328,6 +342,8 @@ VersionID Transaction::commit_and_continue_as_read(bool commit_to_disk)
 
         // Remap file if it has grown, and update refs in underlying node structure.
         remap_and_update_refs(m_read_lock.m_top_ref, m_read_lock.m_file_size, false); // Throws
+        if (allow_group_commit)
+            db->wait_for_group_commit(*this, version); // Throws
         return VersionID{version, new_read_lock.m_reader_idx};
     }
     catch (std::exception& e) {
@@ -368,6 +384,45 @@ VersionID Transaction::commit_and_continue_writing()
     return VersionID{version, lock_after_commit.m_reader_idx};
 }
 
+void Transaction::flush_changes()
+{
+    check_attached();
+    if (m_transact_stage != DB::transact_Writing)
+        throw WrongTransactionState("Not a write transaction");
+
+    // allow any accessors at group level or below to sync
+    flush_accessors_for_commit();
+    db->flush_write_transaction(*this); // Throws
+    if (m_history)
+        m_history->update_from_parent(m_read_lock.m_version); // Throws
+}
+
+bool Transaction::flush_changes_if_needed()
+{
+    size_t limit = db->m_write_transaction_memory_limit;
+    if (limit == 0 || get_commit_size() <= limit)
+        return false;
+    flush_changes(); // Throws
+    return true;
+}
+
+bool Transaction::yield_write()
+{
+    check_attached();
+    if (m_transact_stage != DB::transact_Writing)
+        throw WrongTransactionState("Not a write transaction");
+    if (is_async() || !db->writers_waiting_for_lock(m_write_priority))
+        return false;
+
+    if (db->m_logger) {
+        db->m_logger->log(util::LogCategory::transaction, util::Logger::Level::trace,
+                          "Tr %1: Yield write lock", m_log_id);
+    }
+    commit_and_continue_as_read(); // Throws
+    promote_to_write();            // Throws
+    return true;
+}
+
 TransactionRef Transaction::freeze()
 {
     if (m_transact_stage != DB::transact_Reading)
@@ -376,6 +431,13 @@ TransactionRef Transaction::freeze()
     return db->start_frozen(version);
 }
 
+void Transaction::evict_table_accessors(size_t max_accessors)
+{
+    if (m_transact_stage != DB::transact_Reading)
+        throw WrongTransactionState("Can only evict table accessors of a read transaction");
+    Group::evict_table_accessors(max_accessors);
+}
+
 TransactionRef Transaction::duplicate()
 {
     auto version = VersionID(m_read_lock.m_version, m_read_lock.m_reader_idx);
@@ -401,6 +463,48 @@ void Transaction::copy_to(TransactionRef dest) const
     replicate(dest.get(), repl);
 }
 
+std::vector<Transaction::TableDiff> Transaction::diff(const Transaction& newer) const
+{
+    check_attached();
+    newer.check_attached();
+
+    std::vector<TableDiff> result;
+    std::vector<TableKey> newer_keys;
+    for (auto key : newer.get_table_keys()) {
+        newer_keys.push_back(key);
+    }
+    std::sort(newer_keys.begin(), newer_keys.end());
+    auto all_objects = [](const Table& table, std::vector<ObjKey>& keys) {
+        for (auto& obj : table) {
+            keys.push_back(obj.get_key());
+        }
+    };
+
+    for (auto key : get_table_keys()) {
+        TableDiff table_diff;
+        table_diff.table_key = key;
+        auto table = get_table(key);
+        auto it = std::lower_bound(newer_keys.begin(), newer_keys.end(), key);
+        if (it != newer_keys.end() && *it == key) {
+            newer_keys.erase(it);
+            static_cast<ClusterTree::Diff&>(table_diff) = table->m_clusters.diff(newer.get_table(key)->m_clusters);
+            if (table_diff.empty())
+                continue;
+        }
+        else {
+            all_objects(*table, table_diff.deletions);
+        }
+        result.push_back(std::move(table_diff));
+    }
+    for (auto key : newer_keys) {
+        TableDiff table_diff;
+        table_diff.table_key = key;
+        all_objects(*newer.get_table(key), table_diff.insertions);
+        result.push_back(std::move(table_diff));
+    }
+    return result;
+}
+
 _impl::History* Transaction::get_history() const
 {
     if (!m_history) {
@@ -534,7 +638,7 @@ void Transaction::upgrade_file_format(int target_file_format_version)
     // Be sure to revisit the following upgrade logic when a new file format
     // version is introduced. The following assert attempt to help you not
     // forget it.
-    REALM_ASSERT_EX(target_file_format_version == 24, target_file_format_version);
+    REALM_ASSERT_EX(target_file_format_version == 25, target_file_format_version);
 
     // DB::do_open() must ensure that only supported version are allowed.
     // It does that by asking backup if the current file format version is
@@ -548,34 +652,55 @@ void Transaction::upgrade_file_format(int target_file_format_version)
         logger->info("Upgrading from file format version %1 to %2", current_file_format_version,
                      target_file_format_version);
     }
-    // Ensure we have search index on all primary key columns.
     auto table_keys = get_table_keys();
-    if (current_file_format_version < 22) {
+    bool add_pk_indexes = current_file_format_version < 22;
+    bool clear_asymmetric_tables = current_file_format_version == 22;
+    bool migrate_sets_and_dictionaries = current_file_format_version >= 21 && current_file_format_version < 23;
+    bool migrate_set_orderings = current_file_format_version < 24;
+
+    // Each step is done for all tables before the next one starts, as a step may depend on the previous ones
+    // having been done for the tables linked to. After each table, the changes are written to the file if they
+    // hold too much memory, and the progress is reported.
+    size_t steps_done = 0;
+    size_t step_count = table_keys.size() * (size_t(add_pk_indexes) + size_t(clear_asymmetric_tables) +
+                                             size_t(migrate_sets_and_dictionaries) + size_t(migrate_set_orderings));
+    auto table_done = [&] {
+        flush_changes_if_needed(); // Throws
+        ++steps_done;
+        if (db->m_upgrade_progress_callback)
+            db->m_upgrade_progress_callback(steps_done, step_count); // Throws
+    };
+
+    // Ensure we have search index on all primary key columns.
+    if (add_pk_indexes) {
         for (auto k : table_keys) {
             auto t = get_table(k);
             if (auto col = t->get_primary_key_column()) {
                 t->do_add_search_index(col, IndexType::General);
             }
+            table_done();
         }
     }
 
-    if (current_file_format_version == 22) {
+    if (clear_asymmetric_tables) {
         // Check that asymmetric table are empty
         for (auto k : table_keys) {
             auto t = get_table(k);
             if (t->is_asymmetric() && t->size() > 0) {
                 t->clear();
             }
+            table_done();
         }
     }
-    if (current_file_format_version >= 21 && current_file_format_version < 23) {
+    if (migrate_sets_and_dictionaries) {
         // Upgrade Set and Dictionary columns
         for (auto k : table_keys) {
             auto t = get_table(k);
             t->migrate_sets_and_dictionaries();
+            table_done();
         }
     }
-    if (current_file_format_version < 24) {
+    if (migrate_set_orderings) {
         for (auto k : table_keys) {
             auto t = get_table(k);
             t->migrate_set_orderings(); // rewrite sets to use the new string/binary order
@@ -583,11 +708,28 @@ void Transaction::upgrade_file_format(int target_file_format_version)
             // avoid upgrading them because it affects a small niche case. Instead, there is a
             // workaround in the String Index search code for not relying on items being ordered.
             t->migrate_col_keys();
+            table_done();
         }
     }
+    // Version 25 only added structures that are created on demand, so a file
+    // of version 24 needs no further changes.
+
     // NOTE: Additional future upgrade steps go here.
 }
 
+void Transaction::record_local_changes()
+{
+    if (m_transact_stage != DB::transact_Writing || get_tracked_change_journals().empty())
+        return;
+    if (auto repl = db->get_replication()) {
+        BinaryData changes = repl->get_unrecorded_changes();
+        if (changes.size()) {
+            util::SimpleInputStream in(changes);
+            record_changes(in); // Throws
+        }
+    }
+}
+
 void Transaction::promote_to_async()
 {
     util::CheckedLockGuard lck(m_async_mutex);
@@ -666,18 +808,25 @@ void Transaction::replicate(Transaction* dest, Replication& repl) const
     }
 }
 
-void Transaction::complete_async_commit()
+void Transaction::complete_async_commit(VersionID version)
 {
     // sync to disk:
     DB::ReadLockInfo read_lock;
     try {
-        read_lock = db->grab_read_lock(DB::ReadLockInfo::Live, VersionID());
-        if (db->m_logger) {
-            db->m_logger->log(util::LogCategory::transaction, util::Logger::Level::trace,
-                              "Tr %1: Committing ref %2 to disk", m_log_id, read_lock.m_top_ref);
+        read_lock = db->grab_read_lock(DB::ReadLockInfo::Live, version);
+        {
+            // A sync of a newer version made while this one waited covers it
+            std::lock_guard lock(db->m_async_sync_mutex);
+            if (read_lock.m_version > db->m_async_synced_version) {
+                if (db->m_logger) {
+                    db->m_logger->log(util::LogCategory::transaction, util::Logger::Level::trace,
+                                      "Tr %1: Committing ref %2 to disk", m_log_id, read_lock.m_top_ref);
+                }
+                GroupCommitter out(*this);
+                out.commit(read_lock.m_top_ref); // Throws
+                db->m_async_synced_version = read_lock.m_version;
+            }
         }
-        GroupCommitter out(*this);
-        out.commit(read_lock.m_top_ref); // Throws
         // we must release the write mutex before the callback, because the callback
         // is allowed to re-request it.
         db->release_read_lock(read_lock);
@@ -708,9 +857,12 @@ void Transaction::async_complete_writes(util::UniqueFunction<void()> when_synchr
     else if (m_async_stage == AsyncState::HasCommits) {
         m_async_stage = AsyncState::Syncing;
         m_commit_exception = std::exception_ptr();
-        // get a callback on the helper thread, in which to sync to disk
-        db->async_sync_to_disk([this, cb = std::move(when_synchronized)]() noexcept {
-            complete_async_commit();
+        // get a callback on the helper thread, in which to sync to disk. With
+        // pipelining, other transactions may have committed by then, so sync
+        // the version of our own last commit.
+        db->async_sync_to_disk([this, cb = std::move(when_synchronized),
+                                version = get_version_of_current_transaction()]() noexcept {
+            complete_async_commit(version);
             util::CheckedLockGuard lck(m_async_mutex);
             m_async_stage = AsyncState::Idle;
             if (m_waiting_for_sync) {
@@ -781,7 +933,7 @@ void Transaction::acquire_write_lock()
     switch (m_async_stage) {
         case AsyncState::Idle:
             lck.unlock();
-            db->do_begin_possibly_async_write();
+            db->do_begin_possibly_async_write(m_write_priority);
             return;
 
         case AsyncState::Requesting:
@@ -801,7 +953,7 @@ void Transaction::acquire_write_lock()
                 return !m_waiting_for_sync;
             });
             lck.unlock();
-            db->do_begin_possibly_async_write();
+            db->do_begin_possibly_async_write(m_write_priority);
             break;
     }
 }
@@ -834,6 +986,55 @@ void Transaction::do_end_read() noexcept
     db.reset();
 }
 
+bool Transaction::end_read_for_reuse() noexcept
+{
+    if (m_transact_stage != DB::transact_Reading || m_is_shared)
+        return false;
+    {
+        util::CheckedLockGuard lck(m_async_mutex);
+        if (m_async_stage != AsyncState::Idle || m_async_commit_has_failed)
+            return false;
+    }
+    if (m_oldest_version_not_persisted)
+        return false;
+
+    if (db->m_logger)
+        db->m_logger->log(util::LogCategory::transaction, util::Logger::Level::trace, "End transaction %1", m_log_id);
+
+    detach_for_reuse();
+    db->release_read_lock(m_read_lock);
+    m_alloc.note_reader_end(this);
+    set_transact_stage(DB::transact_Ready);
+    m_history = nullptr;
+    m_write_priority = DB::WritePriority::Normal;
+    db.reset();
+    return true;
+}
+
+void Transaction::resume_read(DBRef _db, DB::ReadLockInfo& rli)
+{
+    db = std::move(_db);
+    m_read_lock = rli;
+    m_log_id = util::gen_log_id(this);
+    set_transact_stage(DB::transact_Reading);
+    m_alloc.note_reader_start(this);
+    try {
+        attach_reused(m_read_lock.m_top_ref, m_read_lock.m_file_size,
+                      VersionID{rli.m_version, rli.m_reader_idx}); // Throws
+    }
+    catch (...) {
+        detach();
+        m_alloc.note_reader_end(this);
+        set_transact_stage(DB::transact_Ready);
+        db.reset();
+        throw;
+    }
+    if (db->m_logger) {
+        db->m_logger->log(util::LogCategory::transaction, util::Logger::Level::trace, "Start %1 %2: %3 ref %4",
+                          log_stage[DB::transact_Reading], m_log_id, rli.m_version, m_read_lock.m_top_ref);
+    }
+}
+
 // This is the same as do_end_read() above, but with the requirement that
 // 1) This is called with the db->mutex locked already
 // 2) No async commits outstanding
@@ -45,7 +45,7 @@ public:
     void close() REQUIRES(!m_async_mutex);
     bool is_attached()
     {
-        return m_transact_stage != DB::transact_Ready && db->is_attached();
+        return m_transact_stage != DB::transact_Ready && db->is_attached() && !db->is_read_lock_expired(m_read_lock);
     }
 
     /// Get the approximate size of the data that would be written to the file if
@@ -54,6 +54,18 @@ public:
     /// what will be needed.
     size_t get_commit_size() const;
 
+    /// Write the changes made so far in this write transaction to free space in
+    /// the file, and release the memory held for them. The changes stay
+    /// invisible to other transactions until the transaction is committed, and
+    /// are discarded if it is rolled back. This bounds the memory used by very
+    /// large write transactions. Accessors stay valid as across
+    /// commit_and_continue_writing(). If this throws, the transaction must be
+    /// rolled back.
+    void flush_changes();
+    /// Call flush_changes() if the memory held for the changes exceeds
+    /// DBOptions::write_transaction_memory_limit. Returns true if it did.
+    bool flush_changes_if_needed();
+
     DB::version_type commit() REQUIRES(!m_async_mutex);
     void rollback() REQUIRES(!m_async_mutex);
     void end_read() REQUIRES(!m_async_mutex);
@@ -81,6 +93,22 @@ public:
         _impl::NullInstructionObserver* o = nullptr;
         return promote_to_write(o, nonblocking);
     }
+    // The priority with which this transaction asks for the write lock, in
+    // promote_to_write() and DB::async_request_write_mutex().
+    void set_write_priority(DB::WritePriority priority) noexcept
+    {
+        m_write_priority = priority;
+    }
+    DB::WritePriority get_write_priority() const noexcept
+    {
+        return m_write_priority;
+    }
+    // If writers of the same or higher priority are waiting for the write
+    // lock, commit the changes made so far, let them write, and continue
+    // writing once the lock has been reacquired. For breaking up long writes
+    // into parts. Returns false if no one was waiting, or if the write lock
+    // was obtained with DB::async_request_write_mutex().
+    bool yield_write() REQUIRES(!m_async_mutex);
     TransactionRef freeze();
     // Frozen transactions are created by freeze() or DB::start_frozen()
     bool is_frozen() const noexcept override
@@ -94,8 +122,29 @@ public:
     }
     TransactionRef duplicate();
 
+    // Release the table accessors of all but the `max_accessors` most recently
+    // used tables, to bound the memory held by a long-lived read transaction
+    // over a large schema. The accessors are created again when the tables
+    // are next accessed, but TableRefs, objects, collections and queries
+    // obtained from the evicted ones become invalid, as if the tables had been
+    // removed. Only allowed in a read transaction which is not frozen, as
+    // other threads may be using the accessors of a frozen one.
+    void evict_table_accessors(size_t max_accessors);
+
     void copy_to(TransactionRef dest) const;
 
+    struct TableDiff : ClusterTree::Diff {
+        TableKey table_key;
+    };
+    /// Compare the snapshot of this transaction with `newer`, a transaction
+    /// on a newer version of the same file, and return the changes of every
+    /// table which differs (see ClusterTree::diff()). All objects of a table
+    /// which is only in one of the snapshots are reported as inserted or
+    /// deleted. Unlike parse_history() this does not need the history of the
+    /// versions in between, and it costs time in proportion to the parts of
+    /// the tables which have changed.
+    std::vector<TableDiff> diff(const Transaction& newer) const;
+
     _impl::History* get_history() const;
 
     // direct handover of accessor instances
@@ -122,6 +171,11 @@ public:
 
     void upgrade_file_format(int target_file_format_version);
 
+    /// Record the objects changed so far in the current write transaction in
+    /// the change journals of the tables (see ChangeJournal). Called
+    /// implicitly when the write transaction is committed or rolled back.
+    void record_local_changes();
+
     /// Task oriented/async interface for continuous transactions.
     // true if this transaction already holds the write mutex
     bool holds_write_mutex() const noexcept REQUIRES(!m_async_mutex)
@@ -186,10 +240,15 @@ private:
     bool internal_advance_read(O* observer, VersionID target_version, _impl::History&, bool) REQUIRES(!db->m_mutex);
     void set_transact_stage(DB::TransactStage stage) noexcept;
     void do_end_read() noexcept REQUIRES(!m_async_mutex);
+    // End a read transaction, keeping the table accessors for resume_read().
+    // Returns false without doing anything if the transaction cannot be
+    // reused this way.
+    bool end_read_for_reuse() noexcept REQUIRES(!m_async_mutex);
+    void resume_read(DBRef db, DB::ReadLockInfo& rli);
     void initialize_replication();
 
     void replicate(Transaction* dest, Replication& repl) const;
-    void complete_async_commit();
+    void complete_async_commit(VersionID version = VersionID());
     void acquire_write_lock() REQUIRES(!m_async_mutex);
 
     void cow_outliers(std::vector<size_t>& progress, size_t evac_limit, size_t work_limit);
@@ -213,10 +272,15 @@ private:
     bool m_waiting_for_sync GUARDED_BY(m_async_mutex) = false;
 
     DB::TransactStage m_transact_stage = DB::transact_Ready;
+    DB::WritePriority m_write_priority = DB::WritePriority::Normal;
+    // Frozen transaction shared by DB::start_frozen(). Closed by the deleter.
+    bool m_is_shared = false;
     unsigned m_log_id;
 
     friend class DB;
     friend class DisableReplication;
+    friend class ArrowExporter;
+    friend class ExternalSortCursor;
 };
 
 /*
@@ -352,7 +416,8 @@ inline void Transaction::advance_read(O* observer, VersionID version_id)
     if (!hist)
         throw IllegalOperation("No transaction log when advancing");
 
-    internal_advance_read(observer, version_id, *hist, false); // Throws
+    if (internal_advance_read(observer, version_id, *hist, false)) // Throws
+        db->update_hot_tables(*this);                             // Throws
 }
 
 template <class O>
@@ -363,7 +428,7 @@ inline bool Transaction::promote_to_write(O* observer, bool nonblocking)
 
     if (!holds_write_mutex()) {
         if (nonblocking) {
-            bool succes = db->do_try_begin_write();
+            bool succes = db->do_try_begin_write(m_write_priority);
             if (!succes) {
                 return false;
             }
@@ -443,6 +508,12 @@ inline void Transaction::rollback_and_continue_as_read()
     if (!repl)
         throw IllegalOperation("No transaction log when rolling back");
 
+    // All objects changed in this transaction are changed back
+    if (!get_tracked_change_journals().empty()) {
+        util::SimpleInputStream in(repl->get_uncommitted_changes());
+        record_changes(in); // Throws
+    }
+
     // Mark all managed space (beyond the attached file) as free.
     db->reset_free_space_tracking(); // Throws
 
@@ -469,6 +540,8 @@ inline void Transaction::rollback_and_continue_as_read()
 template <class O>
 inline bool Transaction::internal_advance_read(O* observer, VersionID version_id, _impl::History& hist, bool writable)
 {
+    if (db->is_read_lock_expired(m_read_lock))
+        throw StaleAccessor("Read transaction was older than the maximum age");
     DB::ReadLockInfo new_read_lock = db->grab_read_lock(DB::ReadLockInfo::Live, version_id); // Throws
     REALM_ASSERT(new_read_lock.m_version >= m_read_lock.m_version);
     if (new_read_lock.m_version == m_read_lock.m_version) {
@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <realm/unicode.hpp>
+#include <realm/string_search.hpp>
 
 #include <algorithm>
 #include <clocale>
@@ -241,17 +242,18 @@ std::string case_map(StringData source, bool upper, IgnoreErrorsTag)
 
 // If needle == haystack, return true. NOTE: This function first
 // performs a case insensitive *byte* compare instead of one whole
-// UTF-8 character at a time. This is very fast, but not enough to
-// guarantee that the strings are identical, so we need to finish off
-// with a slower but rigorous comparison. The signature is similar in
-// spirit to std::equal().
+// UTF-8 character at a time. This is very fast, and enough when the
+// haystack is all ASCII, but otherwise it does not guarantee that the
+// strings are identical, so we need to finish off with a slower but
+// rigorous comparison. The signature is similar in spirit to
+// std::equal().
 bool equal_case_fold(StringData haystack, const char* needle_upper, const char* needle_lower)
 {
-    for (size_t i = 0; i != haystack.size(); ++i) {
-        char c = haystack[i];
-        if (needle_lower[i] != c && needle_upper[i] != c)
-            return false;
-    }
+    bool ascii;
+    if (!string_search::equal_either(haystack.data(), needle_lower, needle_upper, haystack.size(), ascii))
+        return false;
+    if (ascii)
+        return true;
 
     const char* begin = haystack.data();
     const char* end = begin + haystack.size();
@@ -266,53 +268,19 @@ bool equal_case_fold(StringData haystack, const char* needle_upper, const char*
 
 
 // Test if needle is a substring of haystack. The signature is similar
-// in spirit to std::search().
+// in spirit to std::search(). Only positions where the first and the
+// last byte of the needle match in either case are compared fully,
+// and those are found a vector of positions at a time.
 size_t search_case_fold(StringData haystack, const char* needle_upper, const char* needle_lower, size_t needle_size)
-{
-    // FIXME: This solution is very inefficient. Consider deploying the Boyer-Moore algorithm.
-    size_t i = 0;
-    while (needle_size <= haystack.size() - i) {
-        if (equal_case_fold(haystack.substr(i, needle_size), needle_upper, needle_lower)) {
-            return i;
-        }
-        ++i;
-    }
-    return haystack.size(); // Not found
-}
-
-/// This method takes an array that maps chars (both upper- and lowercase) to distance that can be moved
-/// (and zero for chars not in needle), allowing the method to apply Boyer-Moore for quick substring search
-/// The map is calculated in the StringNode<ContainsIns> class (so it can be reused across searches)
-bool contains_ins(StringData haystack, const char* needle_upper, const char* needle_lower, size_t needle_size,
-                  const std::array<uint8_t, 256>& charmap)
 {
     if (needle_size == 0)
-        return haystack.size() != 0;
-
-    // Prepare vars to avoid lookups in loop
-    size_t last_char_pos = needle_size - 1;
-    unsigned char lastCharU = needle_upper[last_char_pos];
-    unsigned char lastCharL = needle_lower[last_char_pos];
-
-    // Do Boyer-Moore search
-    size_t p = last_char_pos;
-    while (p < haystack.size()) {
-        unsigned char c = haystack.data()[p]; // Get candidate for last char
-
-        if (c == lastCharU || c == lastCharL) {
-            StringData candidate = haystack.substr(p - needle_size + 1, needle_size);
-            if (equal_case_fold(candidate, needle_upper, needle_lower))
-                return true; // text found!
-        }
-
-        // If we don't have a match, see how far we can move char_pos
-        if (charmap[c] == 0)
-            p += needle_size; // char was not present in search string
-        else
-            p += charmap[c];
-    }
-
-    return false;
+        return 0;
+    size_t last = needle_size - 1;
+    string_search::Filter filter{needle_upper[0], needle_lower[0], needle_upper[last], needle_lower[last]};
+    size_t pos = string_search::find(haystack.data(), haystack.size(), needle_size, filter, [&](size_t i) {
+        return equal_case_fold(haystack.substr(i, needle_size), needle_upper, needle_lower);
+    });
+    return pos == npos ? haystack.size() : pos; // Not found
 }
 
 bool string_like_ins(StringData text, StringData upper, StringData lower) noexcept
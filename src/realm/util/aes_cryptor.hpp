@@ -28,6 +28,7 @@
 
 #include <realm/util/file.hpp>
 #include <realm/util/flat_map.hpp>
+#include <realm/util/sha_crypto.hpp>
 
 namespace realm::util {
 class WriteObserver {
@@ -74,6 +75,10 @@ public:
 
     size_t read(FileDesc fd, off_t pos, char* dst, size_t size, WriteObserver* observer = nullptr);
     void try_read_block(FileDesc fd, off_t pos, char* dst) noexcept;
+    // Encrypt and write a range of whole blocks. The blocks sharing a metadata
+    // block are written with one write for their IVs and one for their data,
+    // so writing many adjacent blocks at once is much cheaper than writing
+    // them one at a time.
     void write(FileDesc fd, off_t pos, const char* src, size_t size, WriteMarker* marker = nullptr) noexcept;
     util::FlatMap<size_t, IVRefreshState> refresh_ivs(FileDesc fd, off_t data_pos, size_t page_ndx_in_file_expected,
                                                       size_t end_page_ndx_in_file);
@@ -102,17 +107,22 @@ private:
 #elif defined(_WIN32)
     BCRYPT_KEY_HANDLE m_aes_key_handle;
 #else
-    EVP_CIPHER_CTX* m_ctx;
+    // The key schedule of each context is set up once, and only the IV is
+    // changed for each block
+    EVP_CIPHER_CTX* m_encr_ctx;
+    EVP_CIPHER_CTX* m_decr_ctx;
 #endif
 
     std::array<uint8_t, 32> m_aesKey;
     std::array<uint8_t, 32> m_hmacKey;
+    HmacSha224 m_hmac;
     std::vector<iv_table> m_iv_buffer;
     std::unique_ptr<char[]> m_rw_buffer;
     std::unique_ptr<char[]> m_dst_buffer;
+    std::unique_ptr<char[]> m_write_buffer; // Encrypted blocks of a batched write
     std::vector<iv_table> m_iv_buffer_cache;
 
-    bool check_hmac(const void* data, size_t len, const std::array<uint8_t, 28>& hmac) const;
+    bool check_hmac(const void* data, size_t len, const std::array<uint8_t, 28>& hmac);
     void crypt(EncryptionMode mode, off_t pos, char* dst, const char* src, const char* stored_iv) noexcept;
     iv_table& get_iv_table(FileDesc fd, off_t data_pos, IVLookupMode mode = IVLookupMode::UseCache) noexcept;
     void handle_error();
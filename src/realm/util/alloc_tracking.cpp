@@ -0,0 +1,216 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/alloc_tracking.hpp>
+
+#if REALM_ENABLE_ALLOC_TRACKING
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#endif
+
+using namespace realm;
+using namespace realm::util;
+
+const char* util::get_alloc_tag_name(AllocTag tag) noexcept
+{
+    switch (tag) {
+        case AllocTag::other:
+            return "other";
+        case AllocTag::query:
+            return "query";
+        case AllocTag::accessor:
+            return "accessor";
+        case AllocTag::notifier:
+            return "notifier";
+        case AllocTag::sync_parse:
+            return "sync_parse";
+        case AllocTag::sync_transform:
+            return "sync_transform";
+        case AllocTag::websocket:
+            return "websocket";
+    }
+    return "unknown";
+}
+
+#if REALM_ENABLE_ALLOC_TRACKING
+
+namespace {
+
+struct Counters {
+    std::atomic<size_t> live_bytes{0};
+    std::atomic<size_t> peak_bytes{0};
+    std::atomic<size_t> num_allocations{0};
+};
+
+// Constant-initialized, so they can be used by allocations made during static
+// initialization.
+Counters g_counters[num_alloc_tags];
+
+thread_local AllocTag g_current_tag = AllocTag::other;
+
+// Every block is preceded by a header which records what to credit back when
+// the block is freed. The header is padded to the alignment that `operator
+// new` guarantees, so that the block itself stays suitably aligned.
+struct Header {
+    size_t size;
+    AllocTag tag;
+};
+
+constexpr size_t header_size = ((sizeof(Header) + __STDCPP_DEFAULT_NEW_ALIGNMENT__ - 1) /
+                                __STDCPP_DEFAULT_NEW_ALIGNMENT__) *
+                               __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+void record_alloc(AllocTag tag, size_t size) noexcept
+{
+    Counters& counters = g_counters[size_t(tag)];
+    counters.num_allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t live = counters.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = counters.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void* tracked_alloc(size_t size) noexcept
+{
+    void* block = std::malloc(header_size + size);
+    if (!block)
+        return nullptr;
+    Header* header = static_cast<Header*>(block);
+    header->size = size;
+    header->tag = g_current_tag;
+    record_alloc(header->tag, size);
+    return static_cast<char*>(block) + header_size;
+}
+
+void* tracked_alloc_or_throw(size_t size)
+{
+    for (;;) {
+        if (void* p = tracked_alloc(size))
+            return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler(); // Throws
+    }
+}
+
+void* tracked_alloc_nothrow(size_t size) noexcept
+{
+    try {
+        return tracked_alloc_or_throw(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void tracked_free(void* p) noexcept
+{
+    if (!p)
+        return;
+    void* block = static_cast<char*>(p) - header_size;
+    Header* header = static_cast<Header*>(block);
+    g_counters[size_t(header->tag)].live_bytes.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // unnamed namespace
+
+AllocTagScope::AllocTagScope(AllocTag tag) noexcept
+    : m_previous(g_current_tag)
+{
+    g_current_tag = tag;
+}
+
+AllocTagScope::~AllocTagScope() noexcept
+{
+    g_current_tag = m_previous;
+}
+
+AllocStats util::get_alloc_stats(AllocTag tag) noexcept
+{
+    const Counters& counters = g_counters[size_t(tag)];
+    AllocStats stats;
+    stats.live_bytes = counters.live_bytes.load(std::memory_order_relaxed);
+    stats.peak_bytes = counters.peak_bytes.load(std::memory_order_relaxed);
+    stats.num_allocations = counters.num_allocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void util::reset_alloc_peaks() noexcept
+{
+    for (auto& counters : g_counters)
+        counters.peak_bytes.store(counters.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// The replaceable global allocation functions. The overloads that take an
+// alignment are not replaced, as they are paired with their own deallocation
+// functions.
+
+void* operator new(std::size_t size)
+{
+    return tracked_alloc_or_throw(size); // Throws
+}
+
+void* operator new[](std::size_t size)
+{
+    return tracked_alloc_or_throw(size); // Throws
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return tracked_alloc_nothrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return tracked_alloc_nothrow(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    tracked_free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    tracked_free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    tracked_free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    tracked_free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    tracked_free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    tracked_free(p);
+}
+
+#endif // REALM_ENABLE_ALLOC_TRACKING
@@ -0,0 +1,112 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_UTIL_ALLOC_TRACKING_HPP
+#define REALM_UTIL_ALLOC_TRACKING_HPP
+
+#include <realm/util/features.h>
+
+#include <cstddef>
+
+#ifndef REALM_ENABLE_ALLOC_TRACKING
+#define REALM_ENABLE_ALLOC_TRACKING 0
+#endif
+
+namespace realm::util {
+
+/// The subsystem that heap allocations are attributed to.
+///
+/// Allocation tracking is enabled at compile time with the CMake option
+/// `REALM_ENABLE_ALLOC_TRACKING`. When it is enabled, the global `operator
+/// new` and `operator delete` are replaced by versions which attribute every
+/// allocation to the tag of the innermost AllocTagScope that is active on the
+/// allocating thread (or to `other`), and which keep live and peak byte
+/// counters per tag. The bytes of an allocation are credited back to the tag it
+/// was attributed to when it is freed, regardless of which thread frees it.
+///
+/// Memory that is mapped from the Realm file, and allocations made with
+/// std::malloc() directly, are not tracked.
+enum class AllocTag {
+    other,
+    query,          ///< Query evaluation and the query parser
+    accessor,       ///< Table, object and collection accessors
+    notifier,       ///< Change calculation by the object store notifiers
+    sync_parse,     ///< Decoding of sync changesets and messages
+    sync_transform, ///< Operational transformation of sync changesets
+    websocket,      ///< Websocket frame buffers
+};
+
+constexpr size_t num_alloc_tags = size_t(AllocTag::websocket) + 1;
+
+const char* get_alloc_tag_name(AllocTag) noexcept;
+
+struct AllocStats {
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;
+    size_t num_allocations = 0; ///< Total number of allocations, including freed ones
+};
+
+/// True if allocation tracking is compiled in. If it is not, all statistics
+/// are zero.
+constexpr bool alloc_tracking_enabled() noexcept
+{
+    return REALM_ENABLE_ALLOC_TRACKING;
+}
+
+/// Thread-safe.
+AllocStats get_alloc_stats(AllocTag) noexcept;
+
+/// Set the peak byte counter of every tag to its current live byte count.
+/// Thread-safe.
+void reset_alloc_peaks() noexcept;
+
+/// Attribute the allocations made by the current thread to `tag` for the
+/// lifetime of this object. Scopes may be nested, in which case the innermost
+/// one applies.
+class AllocTagScope {
+public:
+#if REALM_ENABLE_ALLOC_TRACKING
+    explicit AllocTagScope(AllocTag tag) noexcept;
+    ~AllocTagScope() noexcept;
+
+private:
+    AllocTag m_previous;
+#else
+    explicit AllocTagScope(AllocTag) noexcept {}
+#endif
+
+public:
+    AllocTagScope(const AllocTagScope&) = delete;
+    AllocTagScope& operator=(const AllocTagScope&) = delete;
+};
+
+
+// Implementation
+
+#if !REALM_ENABLE_ALLOC_TRACKING
+inline AllocStats get_alloc_stats(AllocTag) noexcept
+{
+    return {};
+}
+
+inline void reset_alloc_peaks() noexcept {}
+#endif
+
+} // namespace realm::util
+
+#endif // REALM_UTIL_ALLOC_TRACKING_HPP
@@ -0,0 +1,194 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/async_logger.hpp>
+#include <realm/util/thread.hpp>
+
+namespace realm::util {
+
+namespace {
+size_t round_up_to_power_of_two(size_t n)
+{
+    size_t capacity = 2;
+    while (capacity < n)
+        capacity <<= 1;
+    return capacity;
+}
+} // anonymous namespace
+
+AsyncLogger::AsyncLogger(const std::shared_ptr<Logger>& base_logger, size_t capacity)
+    : Logger(*base_logger)
+    , m_base_logger_ptr(base_logger)
+    , m_entries(new Entry[round_up_to_power_of_two(capacity)])
+    , m_mask(round_up_to_power_of_two(capacity) - 1)
+{
+    // An entry is free for the producer claiming position `pos` when its
+    // sequence is `pos`, and ready for the background thread when it is
+    // `pos + 1`
+    for (size_t i = 0; i <= m_mask; ++i)
+        m_entries[i].sequence.store(i, std::memory_order_relaxed);
+    for (auto& policy : m_policies)
+        policy.store(OverflowPolicy::block, std::memory_order_relaxed);
+    m_thread = std::thread([this] {
+        on_thread_start(ThreadRole::logger);
+        run();
+    });
+}
+
+AsyncLogger::~AsyncLogger() noexcept
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_cv.notify_one();
+    m_thread.join();
+}
+
+void AsyncLogger::set_overflow_policy(const LogCategory& category, OverflowPolicy policy) noexcept
+{
+    m_policies[category.get_index()].store(policy, std::memory_order_relaxed);
+    for (auto child : category.m_children)
+        set_overflow_policy(*child, policy);
+}
+
+auto AsyncLogger::get_overflow_policy(const LogCategory& category) const noexcept -> OverflowPolicy
+{
+    return m_policies[category.get_index()].load(std::memory_order_relaxed);
+}
+
+void AsyncLogger::do_log(const LogCategory& category, Level level, const std::string& message)
+{
+    // Copy the message before claiming an entry, so that nothing can throw
+    // while the entry is claimed but not yet published
+    std::string copy = message; // Throws
+    if (!try_push(category, level, copy)) {
+        if (get_overflow_policy(category) == OverflowPolicy::drop) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::unique_lock lock(m_mutex);
+        while (!try_push(category, level, copy)) {
+            m_work_cv.notify_one();
+            m_progress_cv.wait(lock);
+        }
+    }
+    wake_up();
+}
+
+bool AsyncLogger::try_push(const LogCategory& category, Level level, std::string& message) noexcept
+{
+    size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    Entry* entry;
+    for (;;) {
+        entry = &m_entries[pos & m_mask];
+        size_t sequence = entry->sequence.load(std::memory_order_acquire);
+        auto diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+        if (diff == 0) {
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0) {
+            // The entry still holds a message from the previous lap
+            return false;
+        }
+        else {
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    entry->category = &category;
+    entry->level = level;
+    entry->message = std::move(message);
+    entry->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsyncLogger::is_empty() const noexcept
+{
+    auto& entry = m_entries[m_dequeue_pos & m_mask];
+    return entry.sequence.load(std::memory_order_acquire) != m_dequeue_pos + 1;
+}
+
+void AsyncLogger::wake_up() noexcept
+{
+    // Pairs with the fence in run(): either the background thread sees the
+    // new entry before going to sleep, or this sees that it is sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard lock(m_mutex);
+        m_work_cv.notify_one();
+    }
+}
+
+size_t AsyncLogger::write_queued()
+{
+    size_t n = 0;
+    while (!is_empty()) {
+        auto& entry = m_entries[m_dequeue_pos & m_mask];
+        try {
+            Logger::do_log(*m_base_logger_ptr, *entry.category, entry.level, entry.message); // Throws
+        }
+        catch (...) {
+            // There is nobody to report the error to, and the message must
+            // not block the ones after it
+        }
+        entry.message.clear();
+        entry.sequence.store(m_dequeue_pos + m_mask + 1, std::memory_order_release);
+        ++m_dequeue_pos;
+        ++n;
+    }
+    return n;
+}
+
+void AsyncLogger::run()
+{
+    for (;;) {
+        if (size_t n = write_queued()) {
+            m_written.fetch_add(n, std::memory_order_release);
+            {
+                // Producers waiting for room and flush() check their
+                // condition with the mutex held, so this cannot be missed
+                std::lock_guard lock(m_mutex);
+            }
+            m_progress_cv.notify_all();
+            continue;
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_work_cv.wait(lock, [&] {
+            return m_stop || !is_empty();
+        });
+        m_sleeping.store(false, std::memory_order_relaxed);
+        if (m_stop && is_empty())
+            return;
+    }
+}
+
+void AsyncLogger::flush()
+{
+    size_t target = m_enqueue_pos.load(std::memory_order_acquire);
+    std::unique_lock lock(m_mutex);
+    m_work_cv.notify_one();
+    m_progress_cv.wait(lock, [&] {
+        return m_written.load(std::memory_order_acquire) >= target;
+    });
+}
+
+} // namespace realm::util
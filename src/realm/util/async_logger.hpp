@@ -0,0 +1,113 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_UTIL_ASYNC_LOGGER_HPP
+#define REALM_UTIL_ASYNC_LOGGER_HPP
+
+#include <realm/util/logger.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace realm::util {
+
+/// A thread-safe logger which hands the messages over to a background thread,
+/// which writes them to the base logger, so that the threads logging do not
+/// wait for the output, nor for each other.
+///
+/// Messages are formatted by the thread logging them, as their parameters may
+/// not outlive the call, and then queued in a fixed size lock-free ring buffer.
+/// Only one thread ever calls the base logger, so it does not need to be
+/// thread safe itself. Messages are written in the order in which they were
+/// queued. As with ThreadSafeLogger, the log level threshold is shared with
+/// the base logger.
+///
+/// When the buffer is full, a message of a category with the `block` overflow
+/// policy (the default) waits for the background thread to make room, while a
+/// message of a category with the `drop` policy is discarded and counted.
+class AsyncLogger : public Logger {
+public:
+    enum class OverflowPolicy { block, drop };
+
+    static constexpr size_t default_capacity = 4096;
+
+    /// The capacity is rounded up to a power of two.
+    explicit AsyncLogger(const std::shared_ptr<Logger>& base_logger, size_t capacity = default_capacity);
+
+    /// Writes the messages which are still queued before returning.
+    ~AsyncLogger() noexcept override;
+
+    /// Set the overflow policy of a category and all of its children.
+    void set_overflow_policy(const LogCategory& category, OverflowPolicy policy) noexcept;
+    OverflowPolicy get_overflow_policy(const LogCategory& category) const noexcept;
+
+    /// Wait until all the messages queued before the call have been written.
+    void flush();
+
+    /// The number of messages discarded because the buffer was full.
+    uint64_t get_dropped_count() const noexcept
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+protected:
+    void do_log(const LogCategory& category, Level, const std::string& message) final;
+
+private:
+    struct Entry {
+        std::atomic<size_t> sequence;
+        const LogCategory* category;
+        Level level;
+        std::string message;
+    };
+
+    std::shared_ptr<Logger> m_base_logger_ptr;
+    const std::unique_ptr<Entry[]> m_entries;
+    const size_t m_mask;
+    std::array<std::atomic<OverflowPolicy>, LogCategory::nb_categories> m_policies;
+
+    // Position of the next entry to be claimed by a producer
+    alignas(64) std::atomic<size_t> m_enqueue_pos{0};
+    // Position of the next entry to be written by the background thread, which
+    // is the only one to access it
+    alignas(64) size_t m_dequeue_pos = 0;
+    std::atomic<size_t> m_written{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<bool> m_sleeping{false};
+
+    // Only used for waking the background thread when it has nothing to do,
+    // and producers or flush() when they are waiting for it
+    std::mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_progress_cv;
+    bool m_stop = false;
+    std::thread m_thread;
+
+    bool try_push(const LogCategory&, Level, std::string&) noexcept;
+    bool is_empty() const noexcept;
+    size_t write_queued();
+    void wake_up() noexcept;
+    void run();
+};
+
+} // namespace realm::util
+
+#endif // REALM_UTIL_ASYNC_LOGGER_HPP
@@ -277,6 +277,7 @@ public:
     using iterator = IndexedMap<Bson>::iterator;
     using IndexedMap<Bson>::begin;
     using IndexedMap<Bson>::end;
+    using IndexedMap<Bson>::keys;
 
     BsonDocument() {}
     BsonDocument(BsonDocument&& other)
@@ -0,0 +1,624 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/bson/bson_view.hpp>
+
+#include <realm/exceptions.hpp>
+#include <realm/util/to_string.hpp>
+
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+namespace realm {
+namespace bson {
+
+namespace {
+
+// The element types of the BSON specification which Bson can represent
+enum ElementType : uint8_t {
+    type_Double = 0x01,
+    type_String = 0x02,
+    type_Document = 0x03,
+    type_Array = 0x04,
+    type_Binary = 0x05,
+    type_ObjectId = 0x07,
+    type_Bool = 0x08,
+    type_Datetime = 0x09,
+    type_Null = 0x0A,
+    type_RegularExpression = 0x0B,
+    type_Int32 = 0x10,
+    type_Timestamp = 0x11,
+    type_Int64 = 0x12,
+    type_Decimal128 = 0x13,
+    type_MaxKey = 0x7F,
+    type_MinKey = 0xFF,
+};
+
+constexpr uint8_t binary_subtype_generic = 0x00;
+constexpr uint8_t binary_subtype_uuid = 0x04;
+
+// The nesting limit imposed by the MongoDB server
+constexpr int max_nesting_depth = 100;
+
+// BSON is little-endian regardless of the platform
+template <class T>
+T read_le(const char* p) noexcept
+{
+    std::make_unsigned_t<T> value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+        value |= std::make_unsigned_t<T>(uint8_t(p[i])) << (8 * i);
+    return T(value);
+}
+
+template <class T>
+void write_le(std::vector<char>& out, T value)
+{
+    auto bits = std::make_unsigned_t<T>(value);
+    for (size_t i = 0; i < sizeof(T); ++i)
+        out.push_back(char(uint8_t(bits >> (8 * i))));
+}
+
+double read_double(const char* p) noexcept
+{
+    uint64_t bits = read_le<uint64_t>(p);
+    double value;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+// The size of the value of an element which has already been validated
+size_t value_size(uint8_t tag, const char* p) noexcept
+{
+    switch (tag) {
+        case type_Double:
+        case type_Datetime:
+        case type_Timestamp:
+        case type_Int64:
+            return 8;
+        case type_String:
+            return 4 + read_le<uint32_t>(p);
+        case type_Document:
+        case type_Array:
+            return read_le<uint32_t>(p);
+        case type_Binary:
+            return 5 + read_le<uint32_t>(p);
+        case type_ObjectId:
+            return 12;
+        case type_Bool:
+            return 1;
+        case type_RegularExpression: {
+            size_t pattern_size = std::strlen(p) + 1;
+            return pattern_size + std::strlen(p + pattern_size) + 1;
+        }
+        case type_Int32:
+            return 4;
+        case type_Decimal128:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+[[noreturn]] void invalid(std::string_view reason)
+{
+    throw LogicError(ErrorCodes::BadBsonParse, util::format("Invalid binary BSON: %1", reason));
+}
+
+size_t validate_value(uint8_t tag, const char* p, size_t available, int depth);
+
+// Validate the document (or array) which begins at `p`, and return its size
+size_t validate_document(const char* p, size_t available, int depth)
+{
+    if (depth > max_nesting_depth)
+        invalid("documents are nested too deeply");
+    if (available < 5)
+        invalid("truncated document");
+    int32_t size = read_le<int32_t>(p);
+    if (size < 5 || size_t(size) > available)
+        invalid("bad document size");
+    const char* end = p + size - 1;
+    if (*end != 0)
+        invalid("missing document terminator");
+
+    const char* pos = p + 4;
+    while (pos < end) {
+        uint8_t tag = uint8_t(*pos++);
+        if (tag == 0)
+            invalid("document terminator before end of document");
+        auto key_end = static_cast<const char*>(std::memchr(pos, 0, size_t(end - pos)));
+        if (!key_end)
+            invalid("unterminated key");
+        pos = key_end + 1;
+        pos += validate_value(tag, pos, size_t(end - pos), depth);
+    }
+    return size_t(size);
+}
+
+// Validate the value of an element, and return its size
+size_t validate_value(uint8_t tag, const char* p, size_t available, int depth)
+{
+    auto require = [&](size_t size) {
+        if (size > available)
+            invalid("truncated value");
+        return size;
+    };
+    switch (tag) {
+        case type_Double:
+        case type_Datetime:
+        case type_Timestamp:
+        case type_Int64:
+            return require(8);
+        case type_Int32:
+            return require(4);
+        case type_ObjectId:
+            return require(12);
+        case type_Decimal128:
+            return require(16);
+        case type_Null:
+        case type_MinKey:
+        case type_MaxKey:
+            return 0;
+        case type_Bool:
+            require(1);
+            if (uint8_t(*p) > 1)
+                invalid("bad boolean value");
+            return 1;
+        case type_String: {
+            require(4);
+            int32_t size = read_le<int32_t>(p);
+            if (size < 1 || size_t(size) > available - 4)
+                invalid("bad string size");
+            if (p[4 + size - 1] != 0)
+                invalid("unterminated string");
+            return 4 + size_t(size);
+        }
+        case type_Binary: {
+            require(5);
+            int32_t size = read_le<int32_t>(p);
+            if (size < 0 || size_t(size) > available - 5)
+                invalid("bad binary size");
+            if (uint8_t(p[4]) == binary_subtype_uuid && size != int32_t(realm::UUID::num_bytes))
+                invalid("bad UUID size");
+            return 5 + size_t(size);
+        }
+        case type_Document:
+        case type_Array:
+            return validate_document(p, available, depth + 1);
+        case type_RegularExpression: {
+            auto pattern_end = static_cast<const char*>(std::memchr(p, 0, available));
+            if (!pattern_end)
+                invalid("unterminated regular expression");
+            const char* options = pattern_end + 1;
+            auto options_end = static_cast<const char*>(std::memchr(options, 0, size_t(p + available - options)));
+            if (!options_end)
+                invalid("unterminated regular expression options");
+            for (const char* c = options; c != options_end; ++c) {
+                if (!std::strchr("imsx", *c))
+                    invalid("unsupported regular expression option");
+            }
+            return size_t(options_end + 1 - p);
+        }
+        default:
+            invalid(util::format("unsupported element type %1", int(tag)));
+    }
+}
+
+class Encoder {
+public:
+    explicit Encoder(std::vector<char>& out)
+        : m_out(out)
+    {
+    }
+
+    void document(const BsonDocument& document)
+    {
+        size_t start = begin_document();
+        for (const std::string& key : document.keys())
+            element(key, document.at(key));
+        end_document(start);
+    }
+
+    void array(const BsonArray& array)
+    {
+        size_t start = begin_document();
+        char key[24];
+        for (size_t i = 0; i < array.size(); ++i) {
+            auto result = std::to_chars(key, key + sizeof key, i);
+            element(std::string_view(key, size_t(result.ptr - key)), array[i]);
+        }
+        end_document(start);
+    }
+
+private:
+    std::vector<char>& m_out;
+
+    size_t begin_document()
+    {
+        size_t start = m_out.size();
+        write_le(m_out, int32_t(0));
+        return start;
+    }
+
+    void end_document(size_t start)
+    {
+        m_out.push_back(0);
+        size_t size = m_out.size() - start;
+        if (size > size_t(std::numeric_limits<int32_t>::max()))
+            throw InvalidArgument("Document is too large to be encoded as BSON");
+        for (size_t i = 0; i < 4; ++i)
+            m_out[start + i] = char(uint8_t(size >> (8 * i)));
+    }
+
+    void cstring(std::string_view str)
+    {
+        if (str.find('\0') != std::string_view::npos)
+            throw InvalidArgument("BSON keys and regular expressions cannot contain null characters");
+        m_out.insert(m_out.end(), str.begin(), str.end());
+        m_out.push_back(0);
+    }
+
+    void binary(const char* data, size_t size, uint8_t subtype)
+    {
+        write_le(m_out, int32_t(size));
+        m_out.push_back(char(subtype));
+        m_out.insert(m_out.end(), data, data + size);
+    }
+
+    void element(std::string_view key, const Bson& value)
+    {
+        size_t tag_pos = m_out.size();
+        m_out.push_back(0);
+        cstring(key);
+        m_out[tag_pos] = char(this->value(value));
+    }
+
+    // Write the value, and return its element type
+    ElementType value(const Bson& value)
+    {
+        switch (value.type()) {
+            case Bson::Type::Null:
+                return type_Null;
+            case Bson::Type::Int32:
+                write_le(m_out, int32_t(value));
+                return type_Int32;
+            case Bson::Type::Int64:
+                write_le(m_out, int64_t(value));
+                return type_Int64;
+            case Bson::Type::Bool:
+                m_out.push_back(bool(value) ? 1 : 0);
+                return type_Bool;
+            case Bson::Type::Double: {
+                double d = double(value);
+                uint64_t bits;
+                std::memcpy(&bits, &d, sizeof bits);
+                write_le(m_out, bits);
+                return type_Double;
+            }
+            case Bson::Type::String: {
+                const std::string& str = static_cast<const std::string&>(value);
+                write_le(m_out, int32_t(str.size() + 1));
+                m_out.insert(m_out.end(), str.begin(), str.end());
+                m_out.push_back(0);
+                return type_String;
+            }
+            case Bson::Type::Binary: {
+                const std::vector<char>& data = static_cast<const std::vector<char>&>(value);
+                binary(data.data(), data.size(), binary_subtype_generic);
+                return type_Binary;
+            }
+            case Bson::Type::Timestamp: {
+                MongoTimestamp ts = MongoTimestamp(value);
+                write_le(m_out, uint64_t(ts.seconds) << 32 | ts.increment);
+                return type_Timestamp;
+            }
+            case Bson::Type::Datetime: {
+                realm::Timestamp ts = realm::Timestamp(value);
+                write_le(m_out, ts.get_seconds() * 1000 + ts.get_nanoseconds() / 1'000'000);
+                return type_Datetime;
+            }
+            case Bson::Type::ObjectId: {
+                auto bytes = ObjectId(value).to_bytes();
+                m_out.insert(m_out.end(), bytes.begin(), bytes.end());
+                return type_ObjectId;
+            }
+            case Bson::Type::Decimal128: {
+                Decimal128 d = Decimal128(value);
+                write_le(m_out, d.raw()->w[0]);
+                write_le(m_out, d.raw()->w[1]);
+                return type_Decimal128;
+            }
+            case Bson::Type::RegularExpression: {
+                const RegularExpression& regex = static_cast<const RegularExpression&>(value);
+                cstring(regex.pattern());
+                std::ostringstream options;
+                options << regex.options();
+                cstring(options.str());
+                return type_RegularExpression;
+            }
+            case Bson::Type::MaxKey:
+                return type_MaxKey;
+            case Bson::Type::MinKey:
+                return type_MinKey;
+            case Bson::Type::Document:
+                document(static_cast<const BsonDocument&>(value));
+                return type_Document;
+            case Bson::Type::Array:
+                array(static_cast<const BsonArray&>(value));
+                return type_Array;
+            case Bson::Type::Uuid: {
+                auto bytes = realm::UUID(value).to_bytes();
+                binary(reinterpret_cast<const char*>(bytes.data()), bytes.size(), binary_subtype_uuid);
+                return type_Binary;
+            }
+        }
+        REALM_UNREACHABLE();
+    }
+};
+
+} // anonymous namespace
+
+Bson::Type BsonView::type() const noexcept
+{
+    switch (m_tag) {
+        case type_Double:
+            return Bson::Type::Double;
+        case type_String:
+            return Bson::Type::String;
+        case type_Document:
+            return Bson::Type::Document;
+        case type_Array:
+            return Bson::Type::Array;
+        case type_Binary:
+            return uint8_t(m_data[4]) == binary_subtype_uuid ? Bson::Type::Uuid : Bson::Type::Binary;
+        case type_ObjectId:
+            return Bson::Type::ObjectId;
+        case type_Bool:
+            return Bson::Type::Bool;
+        case type_Datetime:
+            return Bson::Type::Datetime;
+        case type_RegularExpression:
+            return Bson::Type::RegularExpression;
+        case type_Int32:
+            return Bson::Type::Int32;
+        case type_Timestamp:
+            return Bson::Type::Timestamp;
+        case type_Int64:
+            return Bson::Type::Int64;
+        case type_Decimal128:
+            return Bson::Type::Decimal128;
+        case type_MaxKey:
+            return Bson::Type::MaxKey;
+        case type_MinKey:
+            return Bson::Type::MinKey;
+        default:
+            return Bson::Type::Null;
+    }
+}
+
+int32_t BsonView::get_int32() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Int32);
+    return read_le<int32_t>(m_data);
+}
+
+int64_t BsonView::get_int64() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Int64);
+    return read_le<int64_t>(m_data);
+}
+
+bool BsonView::get_bool() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Bool);
+    return *m_data != 0;
+}
+
+double BsonView::get_double() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Double);
+    return read_double(m_data);
+}
+
+std::string_view BsonView::get_string() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_String);
+    return std::string_view(m_data + 4, read_le<uint32_t>(m_data) - 1);
+}
+
+BinaryData BsonView::get_binary() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Binary);
+    return BinaryData(m_data + 5, read_le<uint32_t>(m_data));
+}
+
+MongoTimestamp BsonView::get_timestamp() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Timestamp);
+    uint64_t value = read_le<uint64_t>(m_data);
+    return MongoTimestamp(uint32_t(value >> 32), uint32_t(value));
+}
+
+realm::Timestamp BsonView::get_datetime() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Datetime);
+    int64_t millis_since_epoch = read_le<int64_t>(m_data);
+    return realm::Timestamp(millis_since_epoch / 1000, int32_t(millis_since_epoch % 1000) * 1'000'000);
+}
+
+ObjectId BsonView::get_object_id() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_ObjectId);
+    ObjectId::ObjectIdBytes bytes;
+    std::memcpy(bytes.data(), m_data, bytes.size());
+    return ObjectId(bytes);
+}
+
+Decimal128 BsonView::get_decimal() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Decimal128);
+    Decimal128::Bid128 value;
+    value.w[0] = read_le<uint64_t>(m_data);
+    value.w[1] = read_le<uint64_t>(m_data + 8);
+    return Decimal128(value);
+}
+
+RegularExpression BsonView::get_regular_expression() const
+{
+    REALM_ASSERT_DEBUG(m_tag == type_RegularExpression);
+    std::string pattern = m_data;
+    return RegularExpression(pattern, std::string(m_data + pattern.size() + 1));
+}
+
+BsonDocumentView BsonView::get_document() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Document);
+    return BsonDocumentView(m_data);
+}
+
+BsonArrayView BsonView::get_array() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_tag == type_Array);
+    return BsonArrayView(m_data);
+}
+
+realm::UUID BsonView::get_uuid() const noexcept
+{
+    REALM_ASSERT_DEBUG(type() == Bson::Type::Uuid);
+    realm::UUID::UUIDBytes bytes;
+    std::memcpy(bytes.data(), m_data + 5, bytes.size());
+    return realm::UUID(bytes);
+}
+
+Bson BsonView::materialize() const
+{
+    switch (type()) {
+        case Bson::Type::Null:
+            return Bson();
+        case Bson::Type::Int32:
+            return get_int32();
+        case Bson::Type::Int64:
+            return get_int64();
+        case Bson::Type::Bool:
+            return get_bool();
+        case Bson::Type::Double:
+            return get_double();
+        case Bson::Type::String:
+            return std::string(get_string());
+        case Bson::Type::Binary: {
+            BinaryData data = get_binary();
+            return std::vector<char>(data.data(), data.data() + data.size());
+        }
+        case Bson::Type::Timestamp:
+            return get_timestamp();
+        case Bson::Type::Datetime:
+            return get_datetime();
+        case Bson::Type::ObjectId:
+            return get_object_id();
+        case Bson::Type::Decimal128:
+            return get_decimal();
+        case Bson::Type::RegularExpression:
+            return get_regular_expression();
+        case Bson::Type::MaxKey:
+            return MaxKey();
+        case Bson::Type::MinKey:
+            return MinKey();
+        case Bson::Type::Document:
+            return get_document().materialize();
+        case Bson::Type::Array:
+            return get_array().materialize();
+        case Bson::Type::Uuid:
+            return get_uuid();
+    }
+    REALM_UNREACHABLE();
+}
+
+BsonElementsView::BsonElementsView(const char* data) noexcept
+    : m_data(data)
+    , m_size(read_le<uint32_t>(data))
+{
+}
+
+size_t BsonElementsView::size() const noexcept
+{
+    size_t size = 0;
+    for (iterator_base it(first_element()), end(end_of_elements()); it != end; it.next())
+        ++size;
+    return size;
+}
+
+BsonView BsonElementsView::iterator_base::value() const noexcept
+{
+    return BsonView(uint8_t(*m_pos), m_pos + 1 + key().size() + 1);
+}
+
+void BsonElementsView::iterator_base::next() noexcept
+{
+    uint8_t tag = uint8_t(*m_pos);
+    const char* value = m_pos + 1 + key().size() + 1;
+    m_pos = value + value_size(tag, value);
+}
+
+std::optional<BsonView> BsonDocumentView::find(std::string_view key) const noexcept
+{
+    for (auto [k, v] : *this) {
+        if (k == key)
+            return v;
+    }
+    return std::nullopt;
+}
+
+BsonDocument BsonDocumentView::materialize() const
+{
+    BsonDocument document;
+    for (auto [key, value] : *this)
+        document[std::string(key)] = value.materialize();
+    return document;
+}
+
+BsonArray BsonArrayView::materialize() const
+{
+    BsonArray array;
+    for (auto value : *this)
+        array.push_back(value.materialize());
+    return array;
+}
+
+BsonDocumentView parse_binary(util::Span<const char> buffer)
+{
+    size_t size = validate_document(buffer.data(), buffer.size(), 0);
+    if (size != buffer.size())
+        invalid("trailing data after document");
+    return BsonDocumentView(buffer.data());
+}
+
+void encode_binary(const BsonDocument& document, std::vector<char>& out)
+{
+    Encoder(out).document(document);
+}
+
+std::vector<char> encode_binary(const BsonDocument& document)
+{
+    std::vector<char> out;
+    encode_binary(document, out);
+    return out;
+}
+
+} // namespace bson
+} // namespace realm
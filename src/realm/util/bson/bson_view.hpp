@@ -0,0 +1,241 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_BSON_VIEW_HPP
+#define REALM_BSON_VIEW_HPP
+
+#include <realm/util/bson/bson.hpp>
+
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace realm {
+namespace bson {
+
+class BsonDocumentView;
+class BsonArrayView;
+
+/// A value inside a buffer of binary BSON (https://bsonspec.org), which is
+/// decoded only when it is accessed. Strings and binary values are returned as
+/// views into the buffer, so the buffer must outlive the view.
+///
+/// Views are only handed out for buffers that have been validated by
+/// parse_binary(), so the accessors do not check the encoding again. Calling
+/// an accessor which does not match type() is a logic error.
+class BsonView {
+public:
+    Bson::Type type() const noexcept;
+
+    int32_t get_int32() const noexcept;
+    int64_t get_int64() const noexcept;
+    bool get_bool() const noexcept;
+    double get_double() const noexcept;
+    std::string_view get_string() const noexcept;
+    BinaryData get_binary() const noexcept;
+    MongoTimestamp get_timestamp() const noexcept;
+    realm::Timestamp get_datetime() const noexcept;
+    ObjectId get_object_id() const noexcept;
+    Decimal128 get_decimal() const noexcept;
+    RegularExpression get_regular_expression() const;
+    BsonDocumentView get_document() const noexcept;
+    BsonArrayView get_array() const noexcept;
+    realm::UUID get_uuid() const noexcept;
+
+    /// Decode this value and everything it contains into a Bson.
+    Bson materialize() const;
+
+private:
+    uint8_t m_tag = 0;
+    const char* m_data = nullptr;
+
+    BsonView(uint8_t tag, const char* data) noexcept
+        : m_tag(tag)
+        , m_data(data)
+    {
+    }
+
+    friend class BsonElementsView;
+};
+
+/// An embedded document or array in a buffer of binary BSON, which iterates
+/// over its elements in place.
+class BsonElementsView {
+public:
+    /// The encoded document, including its length prefix and terminator.
+    util::Span<const char> data() const noexcept
+    {
+        return {m_data, size_t(m_size)};
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size <= 5;
+    }
+
+    /// The number of elements. This is linear in the size of the document.
+    size_t size() const noexcept;
+
+protected:
+    const char* m_data;
+    uint32_t m_size;
+
+    explicit BsonElementsView(const char* data) noexcept;
+
+    class iterator_base {
+    public:
+        bool operator==(const iterator_base& other) const noexcept
+        {
+            return m_pos == other.m_pos;
+        }
+        bool operator!=(const iterator_base& other) const noexcept
+        {
+            return m_pos != other.m_pos;
+        }
+
+    protected:
+        const char* m_pos;
+
+        friend class BsonElementsView;
+
+        explicit iterator_base(const char* pos) noexcept
+            : m_pos(pos)
+        {
+        }
+
+        std::string_view key() const noexcept
+        {
+            return m_pos + 1;
+        }
+        BsonView value() const noexcept;
+        void next() noexcept;
+    };
+
+    const char* first_element() const noexcept
+    {
+        return m_data + 4;
+    }
+    const char* end_of_elements() const noexcept
+    {
+        return m_data + m_size - 1;
+    }
+};
+
+class BsonDocumentView : public BsonElementsView {
+public:
+    class iterator : public iterator_base {
+    public:
+        using value_type = std::pair<std::string_view, BsonView>;
+
+        value_type operator*() const noexcept
+        {
+            return {key(), value()};
+        }
+        iterator& operator++() noexcept
+        {
+            next();
+            return *this;
+        }
+
+    private:
+        using iterator_base::iterator_base;
+        friend class BsonDocumentView;
+    };
+
+    iterator begin() const noexcept
+    {
+        return iterator(first_element());
+    }
+    iterator end() const noexcept
+    {
+        return iterator(end_of_elements());
+    }
+
+    /// The value of the first element named `key`. This is a linear search.
+    std::optional<BsonView> find(std::string_view key) const noexcept;
+
+    BsonDocument materialize() const;
+
+private:
+    using BsonElementsView::BsonElementsView;
+    friend class BsonView;
+    friend BsonDocumentView parse_binary(util::Span<const char>);
+};
+
+class BsonArrayView : public BsonElementsView {
+public:
+    class iterator : public iterator_base {
+    public:
+        using value_type = BsonView;
+
+        value_type operator*() const noexcept
+        {
+            return value();
+        }
+        iterator& operator++() noexcept
+        {
+            next();
+            return *this;
+        }
+
+    private:
+        using iterator_base::iterator_base;
+        friend class BsonArrayView;
+    };
+
+    iterator begin() const noexcept
+    {
+        return iterator(first_element());
+    }
+    iterator end() const noexcept
+    {
+        return iterator(end_of_elements());
+    }
+
+    BsonArray materialize() const;
+
+private:
+    using BsonElementsView::BsonElementsView;
+    friend class BsonView;
+};
+
+/// Validate a binary BSON document and return a view of it, without copying
+/// or decoding any of its values. Nothing is allocated, so large documents of
+/// which only a few fields are used are much cheaper to read this way than
+/// through Bson. `buffer` must contain exactly one document and outlive the
+/// view.
+///
+/// Throws LogicError with ErrorCodes::BadBsonParse if the buffer is not a
+/// well-formed document, or if it uses one of the deprecated element types,
+/// which Bson does not represent.
+BsonDocumentView parse_binary(util::Span<const char> buffer);
+
+/// Append the binary BSON encoding of `document` to `out`. The subtype of
+/// binary values other than UUIDs is not kept by Bson, so they are encoded as
+/// generic binary data.
+///
+/// Throws InvalidArgument if a key or a regular expression contains a null
+/// character, or if a document is too large to be encoded.
+void encode_binary(const BsonDocument& document, std::vector<char>& out);
+std::vector<char> encode_binary(const BsonDocument& document);
+
+} // namespace bson
+} // namespace realm
+
+#endif // REALM_BSON_VIEW_HPP
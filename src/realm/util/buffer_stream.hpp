@@ -20,8 +20,10 @@
 #define REALM_UTIL_BUFFER_STREAM_HPP
 
 #include <cstddef>
+#include <memory>
 #include <sstream>
 
+#include <realm/util/function_ref.hpp>
 #include <realm/util/span.hpp>
 
 namespace realm {
@@ -85,6 +87,50 @@ private:
 using ResettableExpandableBufferOutputStream = BasicResettableExpandableBufferOutputStream<char>;
 
 
+/// A stream buffer which collects the output in a fixed-size buffer, and
+/// passes it on to a callback every time the buffer is full, and when it is
+/// flushed. This makes it possible to produce output of any size, for example
+/// with Table::to_json(), in constant memory and without a copy through an
+/// intermediate string.
+class CallbackOutputStreambuf : public std::streambuf {
+public:
+    using Callback = FunctionRef<void(Span<const char>)>;
+
+    static constexpr std::size_t default_buffer_size = 64 * 1024;
+
+    explicit CallbackOutputStreambuf(Callback callback, std::size_t buffer_size = default_buffer_size);
+    ~CallbackOutputStreambuf() noexcept override;
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* data, std::streamsize size) override;
+    int sync() override;
+
+private:
+    Callback m_callback;
+    std::unique_ptr<char[]> m_buffer;
+    std::size_t m_buffer_size;
+
+    void flush_buffer();
+};
+
+
+/// An output stream which passes its output on to a callback in chunks of
+/// `buffer_size` bytes, except that a single write which is larger than the
+/// buffer is passed on directly. The remaining output is passed on when the
+/// stream is flushed or destroyed. The callback must outlive the stream.
+class CallbackOutputStream : public std::ostream {
+public:
+    using Callback = CallbackOutputStreambuf::Callback;
+
+    explicit CallbackOutputStream(Callback callback,
+                                  std::size_t buffer_size = CallbackOutputStreambuf::default_buffer_size);
+
+private:
+    CallbackOutputStreambuf m_streambuf;
+};
+
+
 // Implementation
 
 template <class C, class T, class A>
@@ -172,6 +218,70 @@ inline util::Span<const C> BasicResettableExpandableBufferOutputStream<C, T, A>:
     return util::Span<const C>(m_streambuf.data(), m_streambuf.size());
 }
 
+inline CallbackOutputStreambuf::CallbackOutputStreambuf(Callback callback, std::size_t buffer_size)
+    : m_callback(callback)
+    , m_buffer(new char[buffer_size]) // Throws
+    , m_buffer_size(buffer_size)
+{
+    setp(m_buffer.get(), m_buffer.get() + m_buffer_size);
+}
+
+inline CallbackOutputStreambuf::~CallbackOutputStreambuf() noexcept
+{
+    try {
+        flush_buffer(); // Throws
+    }
+    catch (...) {
+    }
+}
+
+inline auto CallbackOutputStreambuf::overflow(int_type ch) -> int_type
+{
+    flush_buffer(); // Throws
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+        sputc(traits_type::to_char_type(ch));
+    return traits_type::not_eof(ch);
+}
+
+inline std::streamsize CallbackOutputStreambuf::xsputn(const char* data, std::streamsize size)
+{
+    auto available = std::streamsize(epptr() - pptr());
+    if (size <= available) {
+        traits_type::copy(pptr(), data, std::size_t(size));
+        pbump(int(size));
+        return size;
+    }
+    // Large writes bypass the buffer
+    flush_buffer(); // Throws
+    if (std::size_t(size) >= m_buffer_size) {
+        m_callback(Span<const char>(data, std::size_t(size))); // Throws
+        return size;
+    }
+    traits_type::copy(pptr(), data, std::size_t(size));
+    pbump(int(size));
+    return size;
+}
+
+inline int CallbackOutputStreambuf::sync()
+{
+    flush_buffer(); // Throws
+    return 0;
+}
+
+inline void CallbackOutputStreambuf::flush_buffer()
+{
+    if (pptr() != pbase())
+        m_callback(Span<const char>(pbase(), std::size_t(pptr() - pbase()))); // Throws
+    setp(m_buffer.get(), m_buffer.get() + m_buffer_size);
+}
+
+inline CallbackOutputStream::CallbackOutputStream(Callback callback, std::size_t buffer_size)
+    : std::ostream(nullptr)
+    , m_streambuf(callback, buffer_size) // Throws
+{
+    rdbuf(&m_streambuf);
+}
+
 } // namespace util
 } // namespace realm
 
@@ -20,9 +20,12 @@
 #include <realm/util/safe_int_ops.hpp>
 #include <realm/util/scope_exit.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <zlib.h>
 #include <zconf.h> // for zlib
 
@@ -40,6 +43,8 @@ enum class Algorithm {
     None = 0,
     Deflate = 1,
     Lzfse = 2,
+    // A complete zlib stream, compressed with a preset dictionary
+    DeflateDictionary = 3,
 };
 
 using stream_avail_size_t = std::conditional_t<sizeof(uInt) < sizeof(size_t), uInt, size_t>;
@@ -216,8 +221,10 @@ struct DecompressInputStreamNone final : public InputStream {
 
 class DecompressInputStreamZlib final : public InputStream {
 public:
-    DecompressInputStreamZlib(InputStream& s, Span<const char> b, size_t total_size)
+    DecompressInputStreamZlib(InputStream& s, Span<const char> b, size_t total_size, bool has_header = false,
+                              Span<const char> dictionary = {})
         : m_source(s)
+        , m_dictionary(dictionary)
     {
         // Arbitrary upper limit to reduce peak memory usage
         constexpr const size_t max_out_buffer_size = 1024 * 1024;
@@ -226,7 +233,8 @@ public:
         int rc = inflateInit(&m_strm);
         if (rc != Z_OK)
             throw std::system_error(make_error_code(compression::error::decompress_error), m_strm.msg);
-        inflate_zlib_header(m_strm);
+        if (!has_header)
+            inflate_zlib_header(m_strm);
 
         m_strm.avail_in = bounded_avail(b.size());
         m_strm.next_in = to_bytef(b.data());
@@ -258,6 +266,14 @@ public:
 
             m_strm.total_out = 0;
             auto rc = inflate(&m_strm, m_strm.avail_in ? Z_SYNC_FLUSH : Z_FINISH);
+            if (rc == Z_NEED_DICT) {
+                // inflateSetDictionary() fails if the dictionary does not
+                // match the dictionary id in the zlib header
+                if (m_dictionary.size() == 0 ||
+                    inflateSetDictionary(&m_strm, to_bytef(m_dictionary.data()), uInt(m_dictionary.size())) != Z_OK)
+                    throw std::system_error(make_error_code(compression::error::decompress_unsupported));
+                continue;
+            }
             REALM_ASSERT(rc == Z_OK || rc == Z_STREAM_END || rc == Z_BUF_ERROR);
 
             if (m_strm.total_out) {
@@ -282,6 +298,7 @@ public:
 
 private:
     InputStream& m_source;
+    Span<const char> m_dictionary;
     Span<const char> m_current_block;
     z_stream m_strm = {};
     AppendBuffer<char> m_buffer;
@@ -397,7 +414,7 @@ std::error_code decompress_none(InputStream& compressed, Span<const char> compre
 }
 
 std::error_code decompress_zlib(InputStream& compressed, Span<const char> compressed_buf, Span<char> decompressed_buf,
-                                bool has_header)
+                                bool has_header, Span<const char> dictionary)
 {
     using namespace compression;
 
@@ -449,8 +466,15 @@ std::error_code decompress_zlib(InputStream& compressed, Span<const char> compre
                 return std::error_code{};
             }
             if (rc == Z_NEED_DICT) {
-                // We don't support custom dictionaries
-                return error::decompress_unsupported;
+                // inflateSetDictionary() fails if the dictionary does not
+                // match the dictionary id in the zlib header
+                if (dictionary.size() == 0 ||
+                    inflateSetDictionary(&strm, to_bytef(dictionary.data()), uInt(dictionary.size())) != Z_OK)
+                    return error::decompress_unsupported;
+                // inflate() does not update total_in when it stops to ask for
+                // the dictionary
+                in_offset = size_t(strm.next_in - to_bytef(compressed_buf.data()));
+                continue;
             }
             if (rc == Z_DATA_ERROR) {
                 return error::corrupt_input;
@@ -581,7 +605,7 @@ API_AVAILABLE_END
 #endif
 
 std::error_code decompress(InputStream& compressed, Span<const char> compressed_buf, Span<char> decompressed_buf,
-                           Algorithm algorithm, bool has_header)
+                           Algorithm algorithm, bool has_header, Span<const char> dictionary = {})
 {
     using namespace compression;
 
@@ -593,7 +617,8 @@ std::error_code decompress(InputStream& compressed, Span<const char> compressed_
     }
 
 #if REALM_USE_LIBCOMPRESSION
-    if (algorithm != Algorithm::None)
+    // libcompression does not support preset dictionaries
+    if (algorithm == Algorithm::Lzfse || (algorithm == Algorithm::Deflate && dictionary.size() == 0))
         return decompress_libcompression(compressed, compressed_buf, decompressed_buf, algorithm, has_header);
 #endif
 
@@ -601,7 +626,9 @@ std::error_code decompress(InputStream& compressed, Span<const char> compressed_
         case Algorithm::None:
             return decompress_none(compressed, compressed_buf, decompressed_buf);
         case Algorithm::Deflate:
-            return decompress_zlib(compressed, compressed_buf, decompressed_buf, has_header);
+            return decompress_zlib(compressed, compressed_buf, decompressed_buf, has_header, dictionary);
+        case Algorithm::DeflateDictionary:
+            return decompress_zlib(compressed, compressed_buf, decompressed_buf, true, dictionary);
         default:
             return error::decompress_unsupported;
     }
@@ -703,6 +730,22 @@ std::error_code compress_lzfse_or_zlib(Span<const char> uncompressed_buf, Span<c
     }
     return ec;
 }
+
+std::error_code compress_zlib_with_dictionary(Span<const char> uncompressed_buf, Span<char> compressed_buf,
+                                              std::size_t& compressed_size, int compression_level,
+                                              compression::Alloc* custom_allocator, Span<const char> dictionary)
+{
+    using namespace compression;
+    // The zlib header is kept, as it identifies the dictionary
+    size_t len = header_width(uncompressed_buf.size());
+    if (compressed_buf.size() <= len)
+        return error::compress_buffer_too_small;
+    auto ec = compress(uncompressed_buf, compressed_buf.sub_span(len), compressed_size, compression_level,
+                       custom_allocator, dictionary);
+    if (!ec)
+        write_header({Algorithm::DeflateDictionary, uncompressed_buf.size()}, compressed_buf);
+    return ec;
+}
 } // unnamed namespace
 
 
@@ -733,7 +776,8 @@ std::size_t compression::compress_bound(std::size_t size) noexcept
 
 // zlib deflate()
 std::error_code compression::compress(Span<const char> uncompressed_buf, Span<char> compressed_buf,
-                                      std::size_t& compressed_size, int compression_level, Alloc* custom_allocator)
+                                      std::size_t& compressed_size, int compression_level, Alloc* custom_allocator,
+                                      Span<const char> dictionary)
 {
     auto uncompressed_ptr = to_bytef(uncompressed_buf.data());
     auto uncompressed_size = uncompressed_buf.size();
@@ -754,6 +798,14 @@ std::error_code compression::compress(Span<const char> uncompressed_buf, Span<ch
     if (rc != Z_OK)
         return error::compress_error;
 
+    if (dictionary.size()) {
+        rc = deflateSetDictionary(&strm, to_bytef(dictionary.data()), uInt(dictionary.size()));
+        if (rc != Z_OK) {
+            deflateEnd(&strm);
+            return error::compress_error;
+        }
+    }
+
     strm.next_in = uncompressed_ptr;
     strm.avail_in = 0;
     strm.next_out = compressed_ptr;
@@ -807,18 +859,21 @@ std::error_code compression::compress(Span<const char> uncompressed_buf, Span<ch
     return std::error_code{};
 }
 
-std::error_code compression::decompress(InputStream& compressed, Span<char> decompressed_buf)
+std::error_code compression::decompress(InputStream& compressed, Span<char> decompressed_buf,
+                                        Span<const char> dictionary)
 {
-    return ::decompress(compressed, compressed.next_block(), decompressed_buf, Algorithm::Deflate, true);
+    return ::decompress(compressed, compressed.next_block(), decompressed_buf, Algorithm::Deflate, true, dictionary);
 }
 
-std::error_code compression::decompress(Span<const char> compressed_buf, Span<char> decompressed_buf)
+std::error_code compression::decompress(Span<const char> compressed_buf, Span<char> decompressed_buf,
+                                        Span<const char> dictionary)
 {
     SimpleInputStream adapter(compressed_buf);
-    return ::decompress(adapter, adapter.next_block(), decompressed_buf, Algorithm::Deflate, true);
+    return ::decompress(adapter, adapter.next_block(), decompressed_buf, Algorithm::Deflate, true, dictionary);
 }
 
-std::error_code compression::decompress_nonportable(InputStream& compressed, AppendBuffer<char>& decompressed)
+std::error_code compression::decompress_nonportable(InputStream& compressed, AppendBuffer<char>& decompressed,
+                                                    Span<const char> dictionary)
 {
     auto compressed_buf = compressed.next_block();
     auto header = read_header(compressed, compressed_buf);
@@ -827,12 +882,12 @@ std::error_code compression::decompress_nonportable(InputStream& compressed, App
     decompressed.resize(header.size);
     if (header.size == 0)
         return std::error_code{};
-    return ::decompress(compressed, compressed_buf, decompressed, header.algorithm, false);
+    return ::decompress(compressed, compressed_buf, decompressed, header.algorithm, false, dictionary);
 }
 
 std::error_code compression::allocate_and_compress(CompressMemoryArena& compress_memory_arena,
                                                    Span<const char> uncompressed_buf,
-                                                   std::vector<char>& compressed_buf)
+                                                   std::vector<char>& compressed_buf, Span<const char> dictionary)
 {
     const int compression_level = 1;
     std::size_t compressed_size = 0;
@@ -843,7 +898,7 @@ std::error_code compression::allocate_and_compress(CompressMemoryArena& compress
     for (;;) {
         init_arena(compress_memory_arena);
         std::error_code ec = compression::compress(uncompressed_buf, compressed_buf, compressed_size,
-                                                   compression_level, &compress_memory_arena);
+                                                   compression_level, &compress_memory_arena, dictionary);
 
         if (REALM_UNLIKELY(ec)) {
             if (ec == compression::error::compress_buffer_too_small) {
@@ -866,8 +921,98 @@ std::error_code compression::allocate_and_compress(CompressMemoryArena& compress
     return std::error_code{};
 }
 
+uint32_t compression::dictionary_id(Span<const char> dictionary) noexcept
+{
+    uLong adler = adler32(0, Z_NULL, 0);
+    return uint32_t(adler32(adler, to_bytef(dictionary.data()), uInt(dictionary.size())));
+}
+
+std::vector<char> compression::train_dictionary(const std::vector<Span<const char>>& samples, size_t max_size)
+{
+    // The length of the byte strings which are counted, and the length of the
+    // pieces of the samples which the dictionary is made of and how far apart
+    // they start
+    constexpr size_t string_size = 8;
+    constexpr size_t piece_size = 64;
+    constexpr size_t piece_stride = 16;
+
+    auto string_at = [](const char* data) {
+        uint64_t string;
+        std::memcpy(&string, data, string_size);
+        return string;
+    };
+
+    // The number of samples each string occurs in
+    struct Count {
+        uint32_t samples = 0;
+        uint32_t last_sample = 0;
+    };
+    std::unordered_map<uint64_t, Count> counts;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        auto sample = samples[i];
+        for (size_t j = 0; j + string_size <= sample.size(); ++j) {
+            Count& count = counts[string_at(sample.data() + j)]; // Throws
+            if (count.last_sample != i + 1) {
+                ++count.samples;
+                count.last_sample = uint32_t(i + 1);
+            }
+        }
+    }
+
+    // A piece scores a point for each other sample each of its strings occurs
+    // in, leaving out the strings which are already in the dictionary
+    std::unordered_set<uint64_t> taken;
+    auto get_score = [&](const char* data, size_t size) {
+        size_t score = 0;
+        for (size_t j = 0; j + string_size <= size; ++j) {
+            uint64_t string = string_at(data + j);
+            if (!taken.count(string))
+                score += counts.find(string)->second.samples - 1;
+        }
+        return score;
+    };
+
+    struct Piece {
+        size_t score;
+        const char* data;
+        size_t size;
+    };
+    std::vector<Piece> pieces;
+    for (auto sample : samples) {
+        for (size_t offset = 0; offset + string_size <= sample.size(); offset += piece_stride) {
+            size_t size = std::min(piece_size, sample.size() - offset);
+            if (size_t score = get_score(sample.data() + offset, size))
+                pieces.push_back({score, sample.data() + offset, size}); // Throws
+        }
+    }
+    std::stable_sort(pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b) {
+        return a.score > b.score;
+    });
+
+    // Take the best pieces, skipping those which mostly repeat strings that
+    // were taken with a better piece, such as the pieces overlapping it
+    std::vector<const Piece*> chosen;
+    size_t total_size = 0;
+    for (auto& piece : pieces) {
+        if (total_size + piece.size > max_size)
+            continue;
+        if (get_score(piece.data, piece.size) * 2 < piece.score)
+            continue;
+        for (size_t j = 0; j + string_size <= piece.size; ++j)
+            taken.insert(string_at(piece.data + j)); // Throws
+        chosen.push_back(&piece); // Throws
+        total_size += piece.size;
+    }
+
+    std::vector<char> dictionary;
+    dictionary.reserve(total_size); // Throws
+    for (auto i = chosen.rbegin(); i != chosen.rend(); ++i)
+        dictionary.insert(dictionary.end(), (*i)->data, (*i)->data + (*i)->size);
+    return dictionary;
+}
+
 void compression::allocate_and_compress_nonportable(CompressMemoryArena& arena, Span<const char> uncompressed,
-                                                    util::AppendBuffer<char>& compressed)
+                                                    util::AppendBuffer<char>& compressed, Span<const char> dictionary)
 {
     if (uncompressed.size() == 0) {
         compressed.resize(0);
@@ -879,11 +1024,16 @@ void compression::allocate_and_compress_nonportable(CompressMemoryArena& arena,
     size_t compressed_size = 0;
     // zlib is ineffective for very small sizes. Measured results indicate that
     // it only manages to compress at all past 100 bytes and the compression
-    // ratio becomes interesting around 200 bytes.
-    while (uncompressed.size() > 256) {
+    // ratio becomes interesting around 200 bytes. That does not hold when
+    // there is a dictionary to refer to.
+    size_t min_size = dictionary.size() ? 0 : 256;
+    while (uncompressed.size() > min_size) {
         init_arena(arena);
         const int compression_level = 1;
-        auto ec = compress_lzfse_or_zlib(uncompressed, compressed, compressed_size, compression_level, &arena);
+        auto ec = dictionary.size() ? compress_zlib_with_dictionary(uncompressed, compressed, compressed_size,
+                                                                    compression_level, &arena, dictionary)
+                                    : compress_lzfse_or_zlib(uncompressed, compressed, compressed_size,
+                                                             compression_level, &arena);
         if (ec == error::compress_buffer_too_small) {
             // Compressed result was larger than uncompressed, so just store the
             // uncompressed
@@ -913,15 +1063,17 @@ void compression::allocate_and_compress_nonportable(CompressMemoryArena& arena,
     }
 }
 
-util::AppendBuffer<char> compression::allocate_and_compress_nonportable(Span<const char> uncompressed_buf)
+util::AppendBuffer<char> compression::allocate_and_compress_nonportable(Span<const char> uncompressed_buf,
+                                                                        Span<const char> dictionary)
 {
     util::compression::CompressMemoryArena arena;
     util::AppendBuffer<char> compressed;
-    allocate_and_compress_nonportable(arena, uncompressed_buf, compressed);
+    allocate_and_compress_nonportable(arena, uncompressed_buf, compressed, dictionary);
     return compressed;
 }
 
-std::unique_ptr<InputStream> compression::decompress_nonportable_input_stream(InputStream& source, size_t& total_size)
+std::unique_ptr<InputStream> compression::decompress_nonportable_input_stream(InputStream& source, size_t& total_size,
+                                                                              Span<const char> dictionary)
 {
     auto first_block = source.next_block();
     auto header = read_header(source, first_block);
@@ -937,6 +1089,8 @@ std::unique_ptr<InputStream> compression::decompress_nonportable_input_stream(In
 #endif
     if (header.algorithm == Algorithm::Deflate)
         return std::make_unique<DecompressInputStreamZlib>(source, first_block, total_size);
+    if (header.algorithm == Algorithm::DeflateDictionary && dictionary.size())
+        return std::make_unique<DecompressInputStreamZlib>(source, first_block, total_size, true, dictionary);
     return nullptr;
 }
 
@@ -134,36 +134,65 @@ size_t compress_bound(size_t uncompressed_size) noexcept;
 /// error code is of category compression::error_category. If \a Alloc is
 /// non-null, it is used for all memory allocations inside compress() and
 /// compress() will not throw any exceptions.
+///
+/// If \a dictionary is nonempty, it is used as a preset dictionary, and the
+/// compressed data can only be decompressed by passing the same dictionary
+/// to decompress(). The zlib header identifies the dictionary by its
+/// dictionary_id().
 std::error_code compress(Span<const char> uncompressed_buf, Span<char> compressed_buf, size_t& compressed_size,
-                         int compression_level = 1, Alloc* custom_allocator = nullptr);
+                         int compression_level = 1, Alloc* custom_allocator = nullptr,
+                         Span<const char> dictionary = {});
 
 /// decompress() decompresses zlib-compressed the data in \a compressed_buf into \a decompressed_buf.
 /// decompress may throw std::bad_alloc, but all other errors (including the
 /// target buffer being too small) are reported by returning an error code of
 /// category compression::error_code.
-std::error_code decompress(Span<const char> compressed_buf, Span<char> decompressed_buf);
+///
+/// \a dictionary is only used if the data was compressed with a preset
+/// dictionary. If it was, and \a dictionary is not that dictionary,
+/// error::decompress_unsupported is returned.
+std::error_code decompress(Span<const char> compressed_buf, Span<char> decompressed_buf,
+                           Span<const char> dictionary = {});
 
 /// decompress() decompresses zlib-compressed data in \a compressed into \a
 /// decompressed_buf. decompress may throw std::bad_alloc or any exceptions
 /// thrown by \a compressed, but all other errors (including the target buffer
 /// being too small) are reported by returning an error code of category
-/// compression::error_code.
-std::error_code decompress(InputStream& compressed, Span<char> decompressed_buf);
+/// compression::error_code. \a dictionary is used as described above.
+std::error_code decompress(InputStream& compressed, Span<char> decompressed_buf, Span<const char> dictionary = {});
 
 /// allocate_and_compress() compresses the data in \a uncompressed_buf using
 /// zlib, storing the result in \a compressed_buf. \a compressed_buf is resized
 /// to the required size, and on non-error return has size equal to the
 /// compressed size. All errors other than std::bad_alloc are returned as an
-/// error code of categrory compression::error_code.
+/// error code of categrory compression::error_code. If \a dictionary is
+/// nonempty, it is used as a preset dictionary as for compress().
 std::error_code allocate_and_compress(CompressMemoryArena& compress_memory_arena, Span<const char> uncompressed_buf,
-                                      std::vector<char>& compressed_buf);
+                                      std::vector<char>& compressed_buf, Span<const char> dictionary = {});
+
+/// The identifier stored in the zlib header of data compressed with \a
+/// dictionary as a preset dictionary (the Adler-32 checksum of the
+/// dictionary).
+uint32_t dictionary_id(Span<const char> dictionary) noexcept;
+
+/// train_dictionary() builds a preset dictionary of at most \a max_size bytes
+/// for compressing data which resembles \a samples. It is made of the pieces
+/// of the samples with the most byte strings which occur in several samples,
+/// with the most common ones at the end, where they are cheapest to refer to.
+/// The returned dictionary is empty if the samples have nothing in common.
+std::vector<char> train_dictionary(const std::vector<Span<const char>>& samples, size_t max_size);
 
 /// decompress() decompresses data produced by
 /// allocate_and_compress_nonportable() in \a compressed into \a decompressed.
 /// \a decompressed is resized to the required size, and on non-error return
 /// has size equal to the compressed size. All errors other than std::bad_alloc
 /// are returned as an error code of categrory compression::error_code.
-std::error_code decompress_nonportable(InputStream& compressed, AppendBuffer<char>& decompressed);
+///
+/// \a dictionary must be the dictionary the data was compressed with, if any.
+/// If it was compressed with a dictionary and \a dictionary is not that
+/// dictionary, error::decompress_unsupported is returned.
+std::error_code decompress_nonportable(InputStream& compressed, AppendBuffer<char>& decompressed,
+                                       Span<const char> dictionary = {});
 
 /// decompress_nonportable_input_stream() returns an input stream which wraps
 /// the \a source input stream and decompresses data produced by
@@ -173,7 +202,12 @@ std::error_code decompress_nonportable(InputStream& compressed, AppendBuffer<cha
 /// code of category compression::error_code. If this returns a non-nullptr
 /// input stream, \a total_size is set to the decompressed size of the data
 /// which will be produced by fully consuming the returned input stream.
-std::unique_ptr<InputStream> decompress_nonportable_input_stream(InputStream& source, size_t& total_size);
+///
+/// \a dictionary is used as for decompress_nonportable(). The returned input
+/// stream is nullptr if the data was compressed with a dictionary and none is
+/// given, and reading it throws if the wrong dictionary is given.
+std::unique_ptr<InputStream> decompress_nonportable_input_stream(InputStream& source, size_t& total_size,
+                                                                 Span<const char> dictionary = {});
 
 /// allocate_and_compress_nonportable() compresses the data stored in \a
 /// uncompressed_buf, writing it to \a compressed_buf.
@@ -184,11 +218,15 @@ std::unique_ptr<InputStream> decompress_nonportable_input_stream(InputStream& so
 /// of compression algorithms available is platform-specific, so data
 /// compressed with this function must only be used locally.
 ///
+/// If \a dictionary is nonempty, the data is compressed with zlib using it as
+/// a preset dictionary, which makes compressing small inputs worthwhile, and
+/// the same dictionary must be passed to decompress it.
+///
 /// This function reports errors by throwing a std::system_error containing an
 /// error code of category compression::error_code. It may additionally throw
 /// std::bad_alloc.
 void allocate_and_compress_nonportable(CompressMemoryArena& compress_memory_arena, Span<const char> uncompressed_buf,
-                                       util::AppendBuffer<char>& compressed_buf);
+                                       util::AppendBuffer<char>& compressed_buf, Span<const char> dictionary = {});
 
 /// allocate_and_compress_nonportable() compresses the data stored in \a
 /// uncompressed_buf, returning a buffer of the appropriate size.
@@ -202,7 +240,8 @@ void allocate_and_compress_nonportable(CompressMemoryArena& compress_memory_aren
 /// This function reports errors by throwing a std::system_error containing an
 /// error code of category compression::error_code. It may additionally throw
 /// std::bad_alloc.
-util::AppendBuffer<char> allocate_and_compress_nonportable(Span<const char> uncompressed_buf);
+util::AppendBuffer<char> allocate_and_compress_nonportable(Span<const char> uncompressed_buf,
+                                                           Span<const char> dictionary = {});
 
 /// Get the decompressed size of the data produced by
 /// allocate_and_compress_nonportable() which is stored in \a source.
@@ -20,6 +20,7 @@
 
 #include <realm/util/file_mapper.hpp>
 
+#include <atomic>
 #include <sstream>
 
 #if REALM_ENABLE_ENCRYPTION
@@ -109,6 +110,8 @@ namespace {
 const int aes_block_size = 16;
 const size_t block_size = 4096;
 
+std::atomic<uint64_t> num_page_decryptions(0); // for statistical purposes
+
 const size_t metadata_size = sizeof(iv_table);
 const size_t blocks_per_metadata_block = block_size / metadata_size;
 static_assert(metadata_size == 64,
@@ -168,7 +171,8 @@ static_assert(c_min_encrypted_file_size == 2 * block_size,
               "chaging the block size breaks encrypted file portability");
 
 AESCryptor::AESCryptor(const uint8_t* key)
-    : m_rw_buffer(new char[block_size])
+    : m_hmac(Span<const uint8_t, 32>(key + 32, 32))
+    , m_rw_buffer(new char[block_size])
     , m_dst_buffer(new char[block_size])
 {
     memcpy(m_aesKey.data(), key, 32);
@@ -196,8 +200,14 @@ AESCryptor::AESCryptor(const uint8_t* key)
     ret = BCryptGenerateSymmetricKey(hAesAlg, &m_aes_key_handle, nullptr, 0, (PBYTE)key, 32, 0);
     REALM_ASSERT_RELEASE_EX(ret == 0 && "BCryptGenerateSymmetricKey()", ret);
 #else
-    m_ctx = EVP_CIPHER_CTX_new();
-    if (!m_ctx)
+    m_encr_ctx = EVP_CIPHER_CTX_new();
+    m_decr_ctx = EVP_CIPHER_CTX_new();
+    if (!m_encr_ctx || !m_decr_ctx)
+        handle_error();
+    // Expanding the key is as costly as encrypting a few hundred bytes, so do
+    // it once here rather than for every block in crypt()
+    if (!EVP_CipherInit_ex(m_encr_ctx, EVP_aes_256_cbc(), NULL, m_aesKey.data(), NULL, mode_Encrypt) ||
+        !EVP_CipherInit_ex(m_decr_ctx, EVP_aes_256_cbc(), NULL, m_aesKey.data(), NULL, mode_Decrypt))
         handle_error();
 #endif
 }
@@ -209,8 +219,8 @@ AESCryptor::~AESCryptor() noexcept
     CCCryptorRelease(m_decr);
 #elif defined(_WIN32)
 #else
-    EVP_CIPHER_CTX_cleanup(m_ctx);
-    EVP_CIPHER_CTX_free(m_ctx);
+    EVP_CIPHER_CTX_free(m_encr_ctx);
+    EVP_CIPHER_CTX_free(m_decr_ctx);
 #endif
 }
 
@@ -260,10 +270,10 @@ iv_table& AESCryptor::get_iv_table(FileDesc fd, off_t data_pos, IVLookupMode mod
     return m_iv_buffer[idx];
 }
 
-bool AESCryptor::check_hmac(const void* src, size_t len, const std::array<uint8_t, 28>& hmac) const
+bool AESCryptor::check_hmac(const void* src, size_t len, const std::array<uint8_t, 28>& hmac)
 {
     std::array<uint8_t, 224 / 8> buffer;
-    hmac_sha224(Span(reinterpret_cast<const uint8_t*>(src), len), buffer, m_hmacKey);
+    m_hmac(Span(reinterpret_cast<const uint8_t*>(src), len), buffer);
 
     // Constant-time memcmp to avoid timing attacks
     uint8_t result = 0;
@@ -500,32 +510,58 @@ void AESCryptor::write(FileDesc fd, off_t pos, const char* src, size_t size, Wri
 {
     REALM_ASSERT(size % block_size == 0);
     while (size > 0) {
-        iv_table& iv = get_iv_table(fd, pos);
+        // The IVs of the blocks covered by one metadata block are adjacent in
+        // the file, and so are their data blocks. Encrypt the blocks up to the
+        // end of that group first, and then write all the IVs and all the data
+        // with one write each.
+        const size_t block_ndx = size_t(pos) / block_size;
+        const size_t group_end = (block_ndx / blocks_per_metadata_block + 1) * blocks_per_metadata_block;
+        size_t num_blocks = std::min(size / block_size, group_end - block_ndx);
+        char* dst = m_rw_buffer.get();
+        if (num_blocks > 1) {
+            if (!m_write_buffer)
+                m_write_buffer.reset(new (std::nothrow) char[blocks_per_metadata_block * block_size]);
+            if (m_write_buffer)
+                dst = m_write_buffer.get();
+            else
+                num_blocks = 1;
+        }
 
-        memcpy(&iv.iv2, &iv.iv1, 32); // this is also copying the hmac
-        do {
-            ++iv.iv1;
-            // 0 is reserved for never-been-used, so bump if we just wrapped around
-            if (iv.iv1 == 0)
+        iv_table* first_iv = nullptr;
+        for (size_t i = 0; i < num_blocks; ++i) {
+            const off_t block_pos = pos + off_t(i * block_size);
+            char* block_dst = dst + i * block_size;
+            iv_table& iv = get_iv_table(fd, block_pos);
+            if (i == 0)
+                first_iv = &iv;
+            REALM_ASSERT_DEBUG(&iv == first_iv + i);
+
+            memcpy(&iv.iv2, &iv.iv1, 32); // this is also copying the hmac
+            do {
                 ++iv.iv1;
-
-            crypt(mode_Encrypt, pos, m_rw_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
-            hmac_sha224(Span(reinterpret_cast<uint8_t*>(m_rw_buffer.get()), block_size), iv.hmac1, m_hmacKey);
-            // In the extremely unlikely case that both the old and new versions have
-            // the same hash we won't know which IV to use, so bump the IV until
-            // they're different.
-        } while (REALM_UNLIKELY(iv.hmac1 == iv.hmac2));
+                // 0 is reserved for never-been-used, so bump if we just wrapped around
+                if (iv.iv1 == 0)
+                    ++iv.iv1;
+
+                crypt(mode_Encrypt, block_pos, block_dst, src + i * block_size,
+                      reinterpret_cast<const char*>(&iv.iv1));
+                m_hmac(Span(reinterpret_cast<uint8_t*>(block_dst), block_size), iv.hmac1);
+                // In the extremely unlikely case that both the old and new versions have
+                // the same hash we won't know which IV to use, so bump the IV until
+                // they're different.
+            } while (REALM_UNLIKELY(iv.hmac1 == iv.hmac2));
+        }
 
         if (marker)
             marker->mark(pos);
-        check_write(fd, iv_table_pos(pos), &iv, sizeof(iv));
-        check_write(fd, real_offset(pos), m_rw_buffer.get(), block_size);
+        check_write(fd, iv_table_pos(pos), first_iv, num_blocks * sizeof(iv_table));
+        check_write(fd, real_offset(pos), dst, num_blocks * block_size);
         if (marker)
             marker->unmark();
 
-        pos += block_size;
-        src += block_size;
-        size -= block_size;
+        pos += off_t(num_blocks * block_size);
+        src += num_blocks * block_size;
+        size -= num_blocks * block_size;
     }
 }
 
@@ -564,19 +600,21 @@ void AESCryptor::crypt(EncryptionMode mode, off_t pos, char* dst, const char* sr
     }
 
 #else
-    if (!EVP_CipherInit_ex(m_ctx, EVP_aes_256_cbc(), NULL, m_aesKey.data(), iv, mode))
+    EVP_CIPHER_CTX* ctx = mode == mode_Encrypt ? m_encr_ctx : m_decr_ctx;
+    // Keep the cipher and key schedule, and only set the IV
+    if (!EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, -1))
         handle_error();
 
     int len;
     // Use zero padding - we always write a whole page
-    EVP_CIPHER_CTX_set_padding(m_ctx, 0);
+    EVP_CIPHER_CTX_set_padding(ctx, 0);
 
-    if (!EVP_CipherUpdate(m_ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
+    if (!EVP_CipherUpdate(ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
                           block_size))
         handle_error();
 
     // Finalize the encryption. Should not output further data.
-    if (!EVP_CipherFinal_ex(m_ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
+    if (!EVP_CipherFinal_ex(ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
         handle_error();
 #endif
 }
@@ -653,6 +691,11 @@ bool EncryptedFileMapping::copy_up_to_date_page(size_t local_page_ndx) noexcept
     return false;
 }
 
+uint64_t get_num_decryption_page_faults() noexcept
+{
+    return num_page_decryptions.load(std::memory_order_relaxed);
+}
+
 void EncryptedFileMapping::refresh_page(size_t local_page_ndx, size_t required)
 {
     REALM_ASSERT_EX(local_page_ndx < m_page_state.size(), local_page_ndx, m_page_state.size());
@@ -693,6 +736,7 @@ void EncryptedFileMapping::refresh_page(size_t local_page_ndx, size_t required)
         }
         size_t size = static_cast<size_t>(1ULL << m_page_shift);
         size_t actual = m_file.cryptor.read(m_file.fd, data_pos, addr, size, m_observer);
+        num_page_decryptions.fetch_add(1, std::memory_order_relaxed);
         if (actual < size) {
             if (actual >= required) {
                 memset(addr + actual, 0x55, size - actual);
@@ -851,7 +895,7 @@ void EncryptedFileMapping::reclaim_untouched(size_t& progress_index, size_t& wor
     auto visit_and_potentially_reclaim = [&](size_t page_ndx) {
         PageState& ps = m_page_state[page_ndx];
         if (is(ps, UpToDate)) {
-            if (is_not(ps, Touched) && is_not(ps, Dirty) && is_not(ps, Writable)) {
+            if (is_not(ps, Touched) && is_not(ps, Dirty) && is_not(ps, Writable) && is_not(ps, Pinned)) {
                 clear(ps, UpToDate);
                 reclaim_page(page_ndx);
                 m_num_decrypted--;
@@ -911,19 +955,54 @@ void EncryptedFileMapping::reclaim_untouched(size_t& progress_index, size_t& wor
     return;
 }
 
+size_t EncryptedFileMapping::pin(const void* addr, size_t size) noexcept
+{
+    size_t first_idx = get_local_index_of_address(addr);
+    size_t last_idx = get_local_index_of_address(addr, size == 0 ? 0 : size - 1);
+    size_t pinned = 0;
+    for (size_t idx = first_idx; idx <= last_idx && idx < m_page_state.size(); ++idx) {
+        PageState& ps = m_page_state[idx];
+        if (is_not(ps, Pinned)) {
+            set(ps, Pinned);
+            ++pinned;
+        }
+    }
+    return pinned;
+}
+
+size_t EncryptedFileMapping::unpin_all() noexcept
+{
+    size_t unpinned = 0;
+    for (auto& ps : m_page_state) {
+        if (is(ps, Pinned)) {
+            clear(ps, Pinned);
+            ++unpinned;
+        }
+    }
+    return unpinned;
+}
+
 void EncryptedFileMapping::flush() noexcept
 {
-    const size_t num_dirty_pages = m_page_state.size();
-    for (size_t local_page_ndx = 0; local_page_ndx < num_dirty_pages; ++local_page_ndx) {
+    const size_t num_pages = m_page_state.size();
+    size_t local_page_ndx = 0;
+    while (local_page_ndx < num_pages) {
         if (is_not(m_page_state[local_page_ndx], Dirty)) {
             validate_page(local_page_ndx);
+            ++local_page_ndx;
             continue;
         }
 
+        // Hand runs of dirty pages to the cryptor at once, so that it can
+        // batch the writes
+        size_t end_ndx = local_page_ndx + 1;
+        while (end_ndx < num_pages && is(m_page_state[end_ndx], Dirty))
+            ++end_ndx;
         size_t page_ndx_in_file = local_page_ndx + m_first_page;
         m_file.cryptor.write(m_file.fd, off_t(page_ndx_in_file << m_page_shift), page_addr(local_page_ndx),
-                             static_cast<size_t>(1ULL << m_page_shift), m_marker);
-        clear(m_page_state[local_page_ndx], Dirty);
+                             (end_ndx - local_page_ndx) << m_page_shift, m_marker);
+        for (; local_page_ndx < end_ndx; ++local_page_ndx)
+            clear(m_page_state[local_page_ndx], Dirty);
     }
 
     validate();
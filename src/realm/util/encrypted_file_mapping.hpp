@@ -84,6 +84,15 @@ public:
     // concurrent access/touching of pages - but must be called with the mutex locked.
     void reclaim_untouched(size_t& progress_ptr, size_t& accumulated_savings) noexcept;
 
+    // Exempt the pages in the specified range from being reclaimed until
+    // unpin_all() is called. The range must have passed a read barrier. Returns
+    // the number of pages which were not pinned already. Must be called with
+    // the mutex locked.
+    size_t pin(const void* addr, size_t size) noexcept;
+    // Returns the number of pages which were pinned. Must be called with the
+    // mutex locked.
+    size_t unpin_all() noexcept;
+
     bool contains_page(size_t page_in_file) const;
     size_t get_local_index_of_address(const void* addr, size_t offset = 0) const;
     size_t get_offset_of_address(const void* addr) const;
@@ -125,7 +134,8 @@ private:
         UpToDate = 2, // the page is fully up to date
         StaleIV = 4,  // the page needs to check the on disk IV for changes by other processes
         Writable = 8, // the page is open for writing
-        Dirty = 16    // the page has been modified with respect to what's on file.
+        Dirty = 16,   // the page has been modified with respect to what's on file.
+        Pinned = 32   // the page is not to be reclaimed
     };
     std::vector<PageState> m_page_state;
     // little helpers:
@@ -215,6 +225,9 @@ inline std::string EncryptedFileMapping::print_debug()
         if (s & PageState::Dirty) {
             state += "Dirty";
         }
+        if (s & PageState::Pinned) {
+            state += "Pinned";
+        }
         state += "}";
         return state;
     };
@@ -161,6 +161,14 @@
 #define REALM_LIKELY(expr) (expr)
 #endif
 
+/* Hint that the memory at `addr` will be read soon, so that it can be loaded into the cache while other work is
+ * done. It never faults, so it may be given any address. */
+#if __GNUC__ || defined __INTEL_COMPILER
+#define REALM_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define REALM_PREFETCH(addr) static_cast<void>(addr)
+#endif
+
 
 #if defined(__GNUC__) || defined(__HP_aCC)
 #define REALM_FORCEINLINE inline __attribute__((always_inline))
@@ -732,6 +732,111 @@ error:
 #endif
 }
 
+void File::write_at_static(FileDesc fd, int_fast64_t pos, const char* data, size_t size)
+{
+#ifdef _WIN32
+    while (0 < size) {
+        DWORD n = std::numeric_limits<DWORD>::max();
+        if (int_less_than(size, n))
+            n = static_cast<DWORD>(size);
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = DWORD(uint64_t(pos));
+        overlapped.OffsetHigh = DWORD(uint64_t(pos) >> 32);
+        DWORD r = 0;
+        if (!WriteFile(fd, data, n, &r, &overlapped))
+            goto error;
+        REALM_ASSERT_RELEASE(r == n); // Partial writes are not possible.
+        size -= size_t(r);
+        data += size_t(r);
+        pos += r;
+    }
+    return;
+
+error:
+    DWORD err = GetLastError(); // Eliminate any risk of clobbering
+    if (err == ERROR_HANDLE_DISK_FULL || err == ERROR_DISK_FULL) {
+        std::string msg = get_last_error_msg("WriteFile() failed: ", err);
+        throw OutOfDiskSpace(msg);
+    }
+    throw SystemError(err, "WriteFile() failed");
+#else
+    while (0 < size) {
+        // POSIX requires that 'n' is less than or equal to SSIZE_MAX
+        size_t n = std::min(size, size_t(SSIZE_MAX));
+        ssize_t r = ::pwrite(fd, data, n, off_t(pos));
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            goto error; // LCOV_EXCL_LINE
+        }
+        REALM_ASSERT_RELEASE(r != 0);
+        REALM_ASSERT_RELEASE(size_t(r) <= n);
+        size -= size_t(r);
+        data += size_t(r);
+        pos += r;
+    }
+    return;
+
+error:
+    // LCOV_EXCL_START
+    int err = errno; // Eliminate any risk of clobbering
+    auto msg = format_errno("pwrite() failed: %1", err);
+    if (err == ENOSPC || err == EDQUOT) {
+        throw OutOfDiskSpace(msg);
+    }
+    throw SystemError(err, msg);
+    // LCOV_EXCL_STOP
+#endif
+}
+
+size_t File::read_at_static(FileDesc fd, int_fast64_t pos, char* data, size_t size)
+{
+#ifdef _WIN32
+    char* const data_0 = data;
+    while (0 < size) {
+        DWORD n = std::numeric_limits<DWORD>::max();
+        if (int_less_than(size, n))
+            n = static_cast<DWORD>(size);
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = DWORD(uint64_t(pos));
+        overlapped.OffsetHigh = DWORD(uint64_t(pos) >> 32);
+        DWORD r = 0;
+        if (!ReadFile(fd, data, n, &r, &overlapped)) {
+            DWORD err = GetLastError(); // Eliminate any risk of clobbering
+            if (err == ERROR_HANDLE_EOF)
+                break;
+            throw SystemError(int(err), "ReadFile() failed");
+        }
+        if (r == 0)
+            break;
+        REALM_ASSERT_RELEASE(r <= n);
+        size -= size_t(r);
+        data += size_t(r);
+        pos += r;
+    }
+    return data - data_0;
+#else
+    char* const data_0 = data;
+    while (0 < size) {
+        // POSIX requires that 'n' is less than or equal to SSIZE_MAX
+        size_t n = std::min(size, size_t(SSIZE_MAX));
+        ssize_t r = ::pread(fd, data, n, off_t(pos));
+        if (r == 0)
+            break;
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            throw SystemError(errno, "pread() failed"); // LCOV_EXCL_LINE
+        }
+        REALM_ASSERT_RELEASE(size_t(r) <= n);
+        size -= size_t(r);
+        data += size_t(r);
+        pos += r;
+    }
+    return data - data_0;
+#endif
+}
+
 void File::write(const char* data, size_t size)
 {
     REALM_ASSERT_RELEASE(is_attached());
@@ -234,6 +234,16 @@ public:
     void write(const char* data, size_t size);
     static void write_static(FileDesc fd, const char* data, size_t size);
 
+    /// Write the specified data at the specified position in the file,
+    /// without changing the file pointer, and bypassing the encryption layer.
+    static void write_at_static(FileDesc fd, int_fast64_t pos, const char* data, size_t size);
+
+    /// Read data at the specified position in the file into the specified
+    /// buffer, without changing the file pointer, and bypassing the
+    /// encryption layer. Returns the number of bytes read, which is less than
+    /// \a size if the end of the file has been reached.
+    static size_t read_at_static(FileDesc fd, int_fast64_t pos, char* data, size_t size);
+
     // Tells current file pointer of fd
     static uint64_t get_file_pos(FileDesc fd);
 
@@ -665,6 +665,42 @@ void* mmap_anon(size_t size)
 #endif
 }
 
+void advise_mapping(void* addr, size_t size, MappingAdvice advice) noexcept
+{
+#ifndef _WIN32
+    int native_advice = MADV_NORMAL;
+    switch (advice) {
+        case MappingAdvice::Normal:
+            native_advice = MADV_NORMAL;
+            break;
+        case MappingAdvice::Random:
+            native_advice = MADV_RANDOM;
+            break;
+        case MappingAdvice::Sequential:
+            native_advice = MADV_SEQUENTIAL;
+            break;
+        case MappingAdvice::WillNeed:
+            native_advice = MADV_WILLNEED;
+            break;
+    }
+    ::madvise(addr, size, native_advice);
+#else
+    static_cast<void>(addr);
+    static_cast<void>(size);
+    static_cast<void>(advice);
+#endif
+}
+
+void advise_huge_pages(void* addr, size_t size) noexcept
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    ::madvise(addr, size, MADV_HUGEPAGE);
+#else
+    static_cast<void>(addr);
+    static_cast<void>(size);
+#endif
+}
+
 void* mmap_fixed(FileDesc fd, void* address_request, size_t size, File::AccessMode access, size_t offset,
                  const char* enc_key)
 {
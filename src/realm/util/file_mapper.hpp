@@ -47,6 +47,19 @@ void* mremap(const FileAttributes& file, size_t file_offset, void* old_addr, siz
 void msync(FileDesc fd, void* addr, size_t size);
 void* mmap_anon(size_t size);
 
+/// The expected pattern of access to a mapping, passed on to the OS to tune
+/// readahead and paging.
+enum class MappingAdvice { Normal, Random, Sequential, WillNeed };
+
+/// Advise the OS of how a mapping will be accessed. The address must be page
+/// aligned. This is only a hint, so failures are ignored, and it does
+/// nothing on platforms without madvise().
+void advise_mapping(void* addr, size_t size, MappingAdvice advice) noexcept;
+
+/// Ask for transparent huge pages to back the anonymous mapping. This only
+/// has an effect on Linux. The address must be page aligned.
+void advise_huge_pages(void* addr, size_t size) noexcept;
+
 // A function which may be given to encryption_read_barrier. If present, the read barrier is a
 // a barrier for a full array. If absent, the read barrier is a barrier only for the address
 // range give as argument. If the barrier is for a full array, it will read the array header
@@ -84,6 +97,10 @@ inline void set_page_reclaim_governor_to_default()
 // Retrieves the number of in memory decrypted pages, across all open files.
 size_t get_num_decrypted_pages();
 
+// Retrieves the number of pages which had to be read from disk and decrypted
+// when accessed, across all open files, since the process started.
+uint64_t get_num_decryption_page_faults() noexcept;
+
 #if REALM_ENABLE_ENCRYPTION
 
 void encryption_note_reader_start(SharedFileInfo& info, const void* reader_id);
@@ -137,6 +154,18 @@ void inline encryption_flush(EncryptedFileMapping* mapping)
     mapping->flush();
 }
 
+size_t inline encryption_pin(const void* addr, size_t size, EncryptedFileMapping* mapping)
+{
+    LockGuard lock(mapping_mutex);
+    return mapping->pin(addr, size);
+}
+
+size_t inline encryption_unpin_all(EncryptedFileMapping* mapping)
+{
+    LockGuard lock(mapping_mutex);
+    return mapping->unpin_all();
+}
+
 inline void do_encryption_read_barrier(const void* addr, size_t size, HeaderToSize header_to_size,
                                        EncryptedFileMapping* mapping, bool to_modify)
 {
@@ -158,6 +187,11 @@ size_t inline get_num_decrypted_pages()
     return 0;
 }
 
+uint64_t inline get_num_decryption_page_faults() noexcept
+{
+    return 0;
+}
+
 void inline set_page_reclaim_governor(PageReclaimGovernor*) {}
 void inline encryption_read_barrier(const void*, size_t, EncryptedFileMapping*, HeaderToSize = nullptr) {}
 void inline encryption_read_barrier_for_write(const void*, size_t, EncryptedFileMapping*) {}
@@ -294,22 +294,11 @@ void InterprocessCondVar::set_shared_part(SharedPart& shared_part, std::string b
 #ifndef _WIN32
 
 #if !REALM_TVOS
+    // The fifo is created and opened by open_fifo() on first use, as most
+    // condition variables are never waited on, and creating them makes up a
+    // noticeable part of the time taken to open a Realm file
     m_resource_path = base_path + "." + condvar_name + ".cv";
-    if (!try_create_fifo(m_resource_path)) {
-        // Filesystem doesn't support named pipes, so try putting it in tmp_dir instead
-        // Hash collisions are okay here because they just result in doing
-        // extra work, as opposed to correctness problems.
-        std::ostringstream ss;
-        ss << normalize_dir(tmp_path);
-        ss << "realm_" << std::hash<std::string>()(m_resource_path) << ".cv";
-        m_resource_path = ss.str();
-        create_fifo(m_resource_path);
-    }
-    m_fd_read = open(m_resource_path.c_str(), O_RDWR);
-    if (m_fd_read == -1) {
-        throw std::system_error(errno, std::system_category());
-    }
-    m_fd_write = -1;
+    m_tmp_path = std::move(tmp_path);
 
 #else // !REALM_TVOS
 
@@ -322,16 +311,11 @@ void InterprocessCondVar::set_shared_part(SharedPart& shared_part, std::string b
 
     m_fd_read = notification_pipe[0];
     m_fd_write = notification_pipe[1];
+    make_non_blocking(m_fd_read);
+    make_non_blocking(m_fd_write);
 
 #endif // REALM_TVOS
 
-    if (m_fd_read != -1) {
-        make_non_blocking(m_fd_read);
-    }
-    if (m_fd_write != -1) {
-        make_non_blocking(m_fd_write);
-    }
-
 #else // _WIN32
     // If the named objects are alive in the Windows kernel space, then their handles are cloned and
     // you get returned a new HANDLE number (differs from that of other processes) which represents the
@@ -416,11 +400,44 @@ void InterprocessCondVar::init_shared_part(SharedPart& shared_part)
 }
 
 
+#if defined(REALM_CONDVAR_EMULATION) && !defined(_WIN32)
+std::string InterprocessCondVar::get_fallback_fifo_path() const
+{
+    // Hash collisions are okay here because they just result in doing
+    // extra work, as opposed to correctness problems.
+    std::ostringstream ss;
+    ss << normalize_dir(m_tmp_path);
+    ss << "realm_" << std::hash<std::string>()(m_resource_path) << ".cv";
+    return ss.str();
+}
+
+void InterprocessCondVar::open_fifo()
+{
+    REALM_ASSERT(m_fd_read == -1);
+    if (!try_create_fifo(m_resource_path)) {
+        // Filesystem doesn't support named pipes, so try putting it in tmp_dir instead
+        m_resource_path = get_fallback_fifo_path();
+        create_fifo(m_resource_path);
+    }
+    m_fd_read = open(m_resource_path.c_str(), O_RDWR);
+    if (m_fd_read == -1) {
+        throw std::system_error(errno, std::system_category());
+    }
+    make_non_blocking(m_fd_read);
+}
+#endif
+
 void InterprocessCondVar::release_shared_part()
 {
 #ifdef REALM_CONDVAR_EMULATION
 #ifndef _WIN32
     File::try_remove(m_resource_path);
+#if !REALM_TVOS
+    // If nobody in this process has used it, the fifo may have been created
+    // in tmp_dir by another process
+    if (m_fd_read == -1)
+        File::try_remove(get_fallback_fifo_path());
+#endif
 #endif
 #else
     // For future platforms, remember to check if additional code should go here.
@@ -499,6 +516,8 @@ void InterprocessCondVar::wait(InterprocessMutex& m, const struct timespec* tp)
     // signaling process can buffer up. This is needed because a condition
     // variable is supposed to be state-less, so any signals sent before a
     // waiter has arrived must be lost.
+    if (m_fd_read == -1)
+        open_fifo(); // Throws
     uint64_t my_wait_counter = ++m_shared_part->wait_counter;
     for (;;) {
 
@@ -622,6 +641,19 @@ void InterprocessCondVar::notify_all() noexcept
         ev.set();
     }
 #else
+    if (m_shared_part->wait_counter == m_shared_part->signal_counter)
+        return;
+    if (m_fd_read == -1) {
+        // Someone is waiting, so the fifo exists already, but this instance
+        // has not used it before. Failing to open it here would leave the
+        // waiter hanging, and we cannot report it to the caller.
+        try {
+            open_fifo(); // Throws
+        }
+        catch (const std::exception& e) {
+            util::terminate("Failed to open condition variable fifo", __FILE__, __LINE__, {e.what()});
+        }
+    }
     while (m_shared_part->wait_counter > m_shared_part->signal_counter) {
         m_shared_part->signal_counter++;
         notify_fd(m_fd_write != -1 ? m_fd_write : m_fd_read);
@@ -87,6 +87,9 @@ public:
     /// You need to bind the emulation to a SharedPart in shared/mmapped memory.
     /// The SharedPart is assumed to have been initialized (possibly by another process)
     /// earlier through a call to init_shared_part.
+    /// When emulating with a named pipe, the pipe is not created and opened
+    /// until it is first needed, which is never for condition variables that
+    /// nobody waits on.
     void set_shared_part(SharedPart& shared_part, std::string path, std::string condvar_name, std::string tmp_path);
 
     /// Initialize the shared part of a process shared condition variable.
@@ -149,6 +152,12 @@ private:
     // When using an anonymous pipe (currently only for tvOS) m_fd_read is read-only and m_fd_write is write-only.
     int m_fd_read = -1;
     int m_fd_write = -1;
+#ifndef _WIN32
+    std::string m_tmp_path;
+
+    void open_fifo();
+    std::string get_fallback_fifo_path() const;
+#endif
 #endif
 
 #ifdef _WIN32
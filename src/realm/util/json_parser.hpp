@@ -317,6 +317,7 @@ std::error_condition JSONParser::parse_number(F&& f) noexcept(noexcept(f(std::de
         return Error::unexpected_token;
     }
     size_t num_bytes_consumed = endp - buffer;
+    event.range = Range(m_current, num_bytes_consumed);
     m_current += num_bytes_consumed;
     return f(event);
 }
@@ -330,7 +331,7 @@ std::error_condition JSONParser::parse_string(F&& f) noexcept(noexcept(f(std::de
 
     auto count_num_escapes_backwards = [](const char* p, const char* begin) -> size_t {
         size_t result = 0;
-        for (; p > begin && *p == Token::escape; ++p)
+        for (; p > begin && *p == Token::escape; --p)
             ++result;
         return result;
     };
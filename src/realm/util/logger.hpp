@@ -103,6 +103,7 @@ public:
 
 private:
     friend class Logger;
+    friend class AsyncLogger;
     static size_t s_next_index;
     size_t m_index = 0;
     std::string m_name;
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_UTIL_NAME_INDEX_HPP
+#define REALM_UTIL_NAME_INDEX_HPP
+
+#include <realm/node.hpp>
+#include <realm/string_data.hpp>
+
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace realm::util {
+
+/// A hash index over a list of names, such as the table names of a group or
+/// the column names of a table, for looking up the position of a name without
+/// scanning the list. The names themselves are not copied, so a lookup
+/// compares the candidate against the list, and the owner must rebuild the
+/// index whenever the list changes.
+///
+/// Short lists are not indexed, as scanning them is just as fast. The empty
+/// name is never indexed.
+class NameIndex {
+public:
+    static constexpr size_t min_names = 8;
+
+    bool is_built() const noexcept
+    {
+        return !m_slots.empty();
+    }
+
+    void clear() noexcept
+    {
+        m_slots.clear();
+    }
+
+    /// Index the `count` names returned by `get_name(ndx)`. If memory cannot
+    /// be allocated the index is left unbuilt.
+    template <class F>
+    void build(size_t count, F&& get_name) noexcept;
+
+    /// Returns the position of the first name in the list which is equal to
+    /// `name`, or npos. Must only be called if is_built() and `name` is not
+    /// empty.
+    template <class F>
+    size_t find(StringData name, F&& get_name) const noexcept;
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t pos_plus_one; // Zero if the slot is free
+    };
+    std::vector<Slot> m_slots;
+};
+
+template <class F>
+void NameIndex::build(size_t count, F&& get_name) noexcept
+{
+    m_slots.clear();
+    if (count < min_names || count > UINT32_MAX / 2)
+        return;
+
+    size_t capacity = min_names * 2;
+    while (capacity < count * 2)
+        capacity <<= 1;
+    try {
+        m_slots.resize(capacity); // Throws
+    }
+    catch (const std::bad_alloc&) {
+        return;
+    }
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < count; ++i) {
+        StringData name = get_name(i);
+        if (name.size() == 0)
+            continue;
+        auto hash = uint32_t(name.hash());
+        for (size_t ndx = hash & mask;; ndx = (ndx + 1) & mask) {
+            Slot& slot = m_slots[ndx];
+            if (slot.pos_plus_one == 0) {
+                slot = {hash, uint32_t(i + 1)};
+                break;
+            }
+            // Keep the first occurrence of a duplicated name
+            if (slot.hash == hash && get_name(slot.pos_plus_one - 1) == name)
+                break;
+        }
+    }
+}
+
+template <class F>
+size_t NameIndex::find(StringData name, F&& get_name) const noexcept
+{
+    REALM_ASSERT_DEBUG(is_built() && name.size() != 0);
+    size_t mask = m_slots.size() - 1;
+    auto hash = uint32_t(name.hash());
+    for (size_t ndx = hash & mask;; ndx = (ndx + 1) & mask) {
+        const Slot& slot = m_slots[ndx];
+        if (slot.pos_plus_one == 0)
+            return npos;
+        if (slot.hash == hash && get_name(slot.pos_plus_one - 1) == name)
+            return slot.pos_plus_one - 1;
+    }
+}
+
+} // namespace realm::util
+
+#endif // REALM_UTIL_NAME_INDEX_HPP
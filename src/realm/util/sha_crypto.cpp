@@ -20,6 +20,8 @@
 #include <realm/util/backtrace.hpp>
 #include <realm/util/assert.hpp>
 
+#include <algorithm>
+
 #if REALM_PLATFORM_APPLE
 #include <CommonCrypto/CommonCrypto.h>
 #elif defined(_WIN32)
@@ -258,5 +260,102 @@ void hmac_sha256(Span<const uint8_t> in_buffer, Span<uint8_t, 32> out_buffer, Sp
 #endif
 }
 
+#if REALM_HAVE_OPENSSL && !REALM_PLATFORM_APPLE
+struct HmacSha224::Impl {
+    EVP_MD_CTX* inner = EVP_MD_CTX_new();
+    EVP_MD_CTX* outer = EVP_MD_CTX_new();
+    EVP_MD_CTX* work = EVP_MD_CTX_new();
+
+    ~Impl()
+    {
+        EVP_MD_CTX_free(inner);
+        EVP_MD_CTX_free(outer);
+        EVP_MD_CTX_free(work);
+    }
+};
+
+HmacSha224::HmacSha224(Span<const uint8_t, 32> key)
+    : m_impl(std::make_unique<Impl>())
+{
+    if (!m_impl->inner || !m_impl->outer || !m_impl->work)
+        throw realm::util::runtime_error("EVP_MD_CTX_new() failed");
+
+    uint8_t ipad[64];
+    uint8_t opad[64];
+    for (size_t i = 0; i < 64; ++i) {
+        uint8_t k = i < key.size() ? key[i] : 0;
+        ipad[i] = k ^ 0x36;
+        opad[i] = k ^ 0x5C;
+    }
+    if (!EVP_DigestInit_ex(m_impl->inner, EVP_sha224(), nullptr) || !EVP_DigestUpdate(m_impl->inner, ipad, 64) ||
+        !EVP_DigestInit_ex(m_impl->outer, EVP_sha224(), nullptr) || !EVP_DigestUpdate(m_impl->outer, opad, 64))
+        throw realm::util::runtime_error("EVP_DigestInit() failed");
+}
+
+void HmacSha224::operator()(Span<const uint8_t> in_buffer, Span<uint8_t, 28> out_buffer)
+{
+    // Full hmac operation is sha_alg(opad + sha_alg(ipad + data))
+    unsigned int len;
+    int rc = EVP_MD_CTX_copy_ex(m_impl->work, m_impl->inner);
+    rc = rc && EVP_DigestUpdate(m_impl->work, in_buffer.data(), in_buffer.size());
+    rc = rc && EVP_DigestFinal_ex(m_impl->work, out_buffer.data(), &len);
+    rc = rc && EVP_MD_CTX_copy_ex(m_impl->work, m_impl->outer);
+    rc = rc && EVP_DigestUpdate(m_impl->work, out_buffer.data(), out_buffer.size());
+    rc = rc && EVP_DigestFinal_ex(m_impl->work, out_buffer.data(), &len);
+    if (!rc)
+        throw realm::util::runtime_error("HMAC computation failed");
+    REALM_ASSERT_DEBUG(len == out_buffer.size());
+}
+#elif defined(REALM_USE_BUNDLED_SHA2)
+struct HmacSha224::Impl {
+    sha224_state inner;
+    sha224_state outer;
+};
+
+HmacSha224::HmacSha224(Span<const uint8_t, 32> key)
+    : m_impl(std::make_unique<Impl>())
+{
+    uint8_t ipad[64];
+    uint8_t opad[64];
+    for (size_t i = 0; i < 64; ++i) {
+        uint8_t k = i < key.size() ? key[i] : 0;
+        ipad[i] = k ^ 0x36;
+        opad[i] = k ^ 0x5C;
+    }
+    sha_init(m_impl->inner);
+    sha_process(m_impl->inner, ipad, 64);
+    sha_init(m_impl->outer);
+    sha_process(m_impl->outer, opad, 64);
+}
+
+void HmacSha224::operator()(Span<const uint8_t> in_buffer, Span<uint8_t, 28> out_buffer)
+{
+    sha224_state s = m_impl->inner;
+    sha_process(s, in_buffer.data(), std::uint32_t(in_buffer.size()));
+    sha_done(s, out_buffer.data());
+
+    s = m_impl->outer;
+    sha_process(s, out_buffer.data(), std::uint32_t(out_buffer.size()));
+    sha_done(s, out_buffer.data());
+}
+#else
+struct HmacSha224::Impl {
+    std::array<uint8_t, 32> key;
+};
+
+HmacSha224::HmacSha224(Span<const uint8_t, 32> key)
+    : m_impl(std::make_unique<Impl>())
+{
+    std::copy(key.begin(), key.end(), m_impl->key.begin());
+}
+
+void HmacSha224::operator()(Span<const uint8_t> in_buffer, Span<uint8_t, 28> out_buffer)
+{
+    hmac_sha224(in_buffer, out_buffer, m_impl->key);
+}
+#endif
+
+HmacSha224::~HmacSha224() = default;
+
 } // namespace util
 } // namespace realm
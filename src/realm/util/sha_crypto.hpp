@@ -19,7 +19,9 @@
 #ifndef REALM_SHA_CRYPTO_HPP
 #define REALM_SHA_CRYPTO_HPP
 
+#include <array>
 #include <cstddef>
+#include <memory>
 #include <realm/util/span.hpp>
 
 namespace realm {
@@ -41,6 +43,25 @@ void sha256(const char* in_buffer, size_t in_buffer_size, unsigned char* out_buf
 void hmac_sha224(Span<const uint8_t> in_buffer, Span<uint8_t, 28> out_buffer, Span<const uint8_t, 32> key);
 void hmac_sha256(Span<const uint8_t> in_buffer, Span<uint8_t, 32> out_buffer, Span<const uint8_t, 32> key);
 
+/// Calculates HMAC-SHA224 with a fixed key, giving the same result as
+/// hmac_sha224(). The hash state after processing the padded key is computed
+/// once, which saves most of the setup of each call when hashing many small
+/// inputs. Not thread safe.
+class HmacSha224 {
+public:
+    explicit HmacSha224(Span<const uint8_t, 32> key);
+    ~HmacSha224();
+
+    HmacSha224(const HmacSha224&) = delete;
+    HmacSha224& operator=(const HmacSha224&) = delete;
+
+    void operator()(Span<const uint8_t> in_buffer, Span<uint8_t, 28> out_buffer);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
 } // namespace util
 } // namespace realm
 
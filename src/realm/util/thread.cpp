@@ -17,6 +17,8 @@
  **************************************************************************/
 
 #include <cstring>
+#include <fstream>
+#include <mutex>
 #include <stdexcept>
 #include <system_error>
 
@@ -27,6 +29,10 @@
 #include <unistd.h>
 #endif
 
+#if REALM_LINUX || REALM_ANDROID
+#include <sched.h>
+#endif
+
 // "Process shared mutexes" are not officially supported on Android,
 // but they appear to work anyway.
 #if (defined(_POSIX_THREAD_PROCESS_SHARED) && _POSIX_THREAD_PROCESS_SHARED > 0) || REALM_ANDROID
@@ -131,6 +137,79 @@ bool Thread::get_name(std::string& name) noexcept
 }
 
 
+bool Thread::set_affinity(const std::vector<unsigned>& cpus)
+{
+#if REALM_LINUX || REALM_ANDROID
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned cpu : cpus) {
+        if (cpu >= CPU_SETSIZE)
+            throw std::invalid_argument("CPU number out of range");
+        CPU_SET(cpu, &set);
+    }
+    // On Linux, a pid of zero denotes the calling thread, not the whole process
+    if (sched_setaffinity(0, sizeof set, &set) != 0)
+        throw std::system_error(errno, std::system_category(), "sched_setaffinity() failed");
+    return true;
+#else
+    static_cast<void>(cpus);
+    return false;
+#endif
+}
+
+
+std::vector<unsigned> Thread::get_numa_node_cpus(unsigned node)
+{
+    std::vector<unsigned> cpus;
+#if REALM_LINUX || REALM_ANDROID
+    // The list looks like "0-7,16-23"
+    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    unsigned first, last;
+    while (in >> first) {
+        last = first;
+        if (in.peek() == '-') {
+            in.get();
+            in >> last;
+        }
+        for (unsigned cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+        if (in.peek() != ',')
+            break;
+        in.get();
+    }
+#else
+    static_cast<void>(node);
+#endif
+    return cpus;
+}
+
+
+namespace {
+std::mutex g_thread_start_callback_mutex;
+std::shared_ptr<std::function<void(ThreadRole)>> g_thread_start_callback;
+} // unnamed namespace
+
+void realm::util::set_thread_start_callback(std::function<void(ThreadRole)> callback)
+{
+    std::shared_ptr<std::function<void(ThreadRole)>> new_callback;
+    if (callback)
+        new_callback = std::make_shared<std::function<void(ThreadRole)>>(std::move(callback));
+    std::lock_guard lock(g_thread_start_callback_mutex);
+    g_thread_start_callback = std::move(new_callback);
+}
+
+void realm::util::on_thread_start(ThreadRole role) noexcept
+{
+    std::shared_ptr<std::function<void(ThreadRole)>> callback;
+    {
+        std::lock_guard lock(g_thread_start_callback_mutex);
+        callback = g_thread_start_callback;
+    }
+    if (callback)
+        (*callback)(role);
+}
+
+
 REALM_NORETURN void Thread::create_failed(int)
 {
     throw std::runtime_error("pthread_create() failed");
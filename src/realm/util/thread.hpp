@@ -35,7 +35,9 @@
 
 #include <cerrno>
 #include <cstddef>
+#include <functional>
 #include <string>
+#include <vector>
 
 #include <realm/util/features.h>
 #include <realm/util/assert.hpp>
@@ -92,6 +94,15 @@ public:
     // and returns false.
     static bool get_name(std::string& name) noexcept;
 
+    // If supported by the platform, restrict the calling thread to run on the
+    // given CPUs and return true, otherwise do nothing and return false.
+    static bool set_affinity(const std::vector<unsigned>& cpus);
+
+    // The CPUs of the given NUMA node, if the platform tells, otherwise an
+    // empty vector. Memory is allocated on the node of the CPU touching it
+    // first, so a thread pinned to these CPUs works on memory local to them.
+    static std::vector<unsigned> get_numa_node_cpus(unsigned node);
+
 private:
 #ifdef _WIN32
     std::thread m_std_thread;
@@ -111,6 +122,30 @@ private:
 };
 
 
+/// The kinds of background threads started by Realm.
+enum class ThreadRole {
+    async_commit,            ///< Performs the async writes and commits of a DB
+    compaction,              ///< Compacts a DB file in the background
+    commit_listener,         ///< Waits for commits by other processes to run notifiers
+    notifier_worker,         ///< Runs a share of the async notifiers in parallel
+    sort_worker,             ///< Sorts a part of a large view
+    logger,                  ///< Writes the messages of an AsyncLogger
+    sync_event_loop,         ///< Runs a sync client event loop
+    sync_integration_worker, ///< Integrates downloaded changesets
+};
+
+/// Set a function to be called on each background thread started by Realm,
+/// from that thread and before it does any work. It can pin the thread to
+/// cores (see Thread::set_affinity()), bind it to a NUMA node (see
+/// Thread::get_numa_node_cpus()) or set its priority, according to its role.
+/// The function is called concurrently from the threads starting, and must
+/// not throw. Pass an empty function to stop calling it.
+void set_thread_start_callback(std::function<void(ThreadRole)> callback);
+
+/// Called by Realm at the start of each of its background threads.
+void on_thread_start(ThreadRole role) noexcept;
+
+
 /// Low-level mutual exclusion device.
 class Mutex {
 public:
@@ -0,0 +1,226 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/trace.hpp>
+
+#if REALM_ENABLE_TRACING
+#if REALM_ANDROID
+#include <android/api-level.h>
+#if __ANDROID_API__ >= 23
+#include <android/trace.h>
+#define REALM_HAVE_ATRACE 1
+#endif
+#elif REALM_PLATFORM_APPLE
+#include <os/signpost.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#include <TraceLoggingProvider.h>
+#elif defined(__linux__)
+#include <algorithm>
+#include <cstdio>
+#include <initializer_list>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#endif // REALM_ENABLE_TRACING
+
+using namespace realm;
+using namespace realm::util;
+
+std::atomic<TraceBackend*> TraceScope::s_backend{nullptr};
+
+void util::set_trace_backend(TraceBackend* backend) noexcept
+{
+    TraceScope::s_backend.store(backend, std::memory_order_release);
+}
+
+#if REALM_ENABLE_TRACING
+
+namespace {
+
+#if REALM_ANDROID
+
+#if REALM_HAVE_ATRACE
+class ATraceBackend final : public TraceBackend {
+public:
+    uint64_t begin(const char* name) noexcept override
+    {
+        ATrace_beginSection(name);
+        return 0;
+    }
+
+    void end(const char*, uint64_t) noexcept override
+    {
+        ATrace_endSection();
+    }
+};
+#endif
+
+#elif REALM_PLATFORM_APPLE
+
+class API_AVAILABLE(macos(10.14), ios(12.0), tvos(12.0), watchos(5.0)) SignpostBackend final : public TraceBackend {
+public:
+    SignpostBackend() noexcept
+        : m_log(os_log_create("io.realm", "Realm"))
+    {
+    }
+
+    uint64_t begin(const char* name) noexcept override
+    {
+        os_signpost_id_t id = os_signpost_id_generate(m_log);
+        // The signpost name must be a string literal, so the region name is
+        // passed as the message
+        os_signpost_interval_begin(m_log, id, "Realm", "%{public}s", name);
+        return id;
+    }
+
+    void end(const char*, uint64_t token) noexcept override
+    {
+        os_signpost_interval_end(m_log, os_signpost_id_t(token), "Realm");
+    }
+
+private:
+    os_log_t m_log;
+};
+
+#elif defined(_WIN32)
+
+// {de5c44e8-96c1-40d3-ab08-8b785706308c}
+TRACELOGGING_DEFINE_PROVIDER(g_realm_trace_provider, "Realm",
+                             (0xde5c44e8, 0x96c1, 0x40d3, 0xab, 0x08, 0x8b, 0x78, 0x57, 0x06, 0x30, 0x8c));
+
+class EtwBackend final : public TraceBackend {
+public:
+    EtwBackend() noexcept
+    {
+        TraceLoggingRegister(g_realm_trace_provider);
+    }
+
+    ~EtwBackend()
+    {
+        TraceLoggingUnregister(g_realm_trace_provider);
+    }
+
+    uint64_t begin(const char* name) noexcept override
+    {
+        TraceLoggingWrite(g_realm_trace_provider, "Region", TraceLoggingOpcode(WINEVENT_OPCODE_START),
+                          TraceLoggingString(name, "Name"));
+        return 0;
+    }
+
+    void end(const char* name, uint64_t) noexcept override
+    {
+        TraceLoggingWrite(g_realm_trace_provider, "Region", TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+                          TraceLoggingString(name, "Name"));
+    }
+};
+
+#elif defined(__linux__)
+
+// Writes markers in the format used by Android's atrace ("B|<pid>|<name>" and
+// "E|<pid>"), which Perfetto and other ftrace consumers turn into slices.
+class TraceMarkerBackend final : public TraceBackend {
+public:
+    TraceMarkerBackend() noexcept
+        : m_pid(::getpid())
+    {
+        for (const char* path : {"/sys/kernel/tracing/trace_marker", "/sys/kernel/debug/tracing/trace_marker"}) {
+            m_fd = ::open(path, O_WRONLY | O_CLOEXEC);
+            if (m_fd >= 0)
+                break;
+        }
+    }
+
+    ~TraceMarkerBackend()
+    {
+        if (m_fd >= 0)
+            ::close(m_fd);
+    }
+
+    bool is_open() const noexcept
+    {
+        return m_fd >= 0;
+    }
+
+    uint64_t begin(const char* name) noexcept override
+    {
+        char buffer[256];
+        int size = std::snprintf(buffer, sizeof buffer, "B|%d|%s", int(m_pid), name);
+        if (size > 0)
+            write(buffer, std::min(size_t(size), sizeof buffer - 1));
+        return 0;
+    }
+
+    void end(const char*, uint64_t) noexcept override
+    {
+        char buffer[32];
+        int size = std::snprintf(buffer, sizeof buffer, "E|%d", int(m_pid));
+        if (size > 0)
+            write(buffer, size_t(size));
+    }
+
+private:
+    int m_fd = -1;
+    pid_t m_pid;
+
+    void write(const char* data, size_t size) noexcept
+    {
+        // Tracing is best-effort, so a failed write is ignored
+        ssize_t ret = ::write(m_fd, data, size);
+        static_cast<void>(ret);
+    }
+};
+
+#endif
+
+} // unnamed namespace
+
+TraceBackend* util::get_platform_trace_backend() noexcept
+{
+#if REALM_ANDROID
+#if REALM_HAVE_ATRACE
+    static ATraceBackend backend;
+    return &backend;
+#else
+    return nullptr;
+#endif
+#elif REALM_PLATFORM_APPLE
+    if (__builtin_available(macOS 10.14, iOS 12.0, tvOS 12.0, watchOS 5.0, *)) {
+        static SignpostBackend backend;
+        return &backend;
+    }
+    return nullptr;
+#elif defined(_WIN32)
+    static EtwBackend backend;
+    return &backend;
+#elif defined(__linux__)
+    static TraceMarkerBackend backend;
+    return backend.is_open() ? &backend : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+#else // REALM_ENABLE_TRACING
+
+TraceBackend* util::get_platform_trace_backend() noexcept
+{
+    return nullptr;
+}
+
+#endif // REALM_ENABLE_TRACING
@@ -0,0 +1,117 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_UTIL_TRACE_HPP
+#define REALM_UTIL_TRACE_HPP
+
+#include <realm/util/features.h>
+
+#include <atomic>
+#include <cstdint>
+
+#ifndef REALM_ENABLE_TRACING
+#define REALM_ENABLE_TRACING 0
+#endif
+
+namespace realm::util {
+
+/// A destination for trace events, which mark the beginning and end of a
+/// region of work on the current thread so that it can be shown on a timeline
+/// by a system profiler.
+///
+/// Trace events are compiled in with the CMake option `REALM_ENABLE_TRACING`,
+/// and are emitted to the backend installed with set_trace_backend(). Without
+/// that option, REALM_TRACE_SCOPE() expands to nothing.
+class TraceBackend {
+public:
+    virtual ~TraceBackend() = default;
+
+    /// Called when a region named `name` begins on the current thread. `name`
+    /// is a string literal. The returned value is passed to the matching
+    /// end().
+    virtual uint64_t begin(const char* name) noexcept = 0;
+
+    /// Called on the same thread as the matching begin(). Regions are
+    /// properly nested on each thread.
+    virtual void end(const char* name, uint64_t token) noexcept = 0;
+};
+
+/// The backend of the system profiler of the current platform, or null if
+/// there is none:
+///
+///  - On Android, ATrace sections (API level 23 and later), which are
+///    recorded by Perfetto and systrace.
+///  - On Linux, atrace-style markers written to the ftrace `trace_marker` file,
+///    which are recorded by Perfetto's `linux.ftrace` data source. This
+///    requires write access to tracefs.
+///  - On Apple platforms, os_signpost intervals in the `io.realm` subsystem,
+///    which are shown by Instruments.
+///  - On Windows, ETW events with start and stop opcodes from the
+///    TraceLogging provider `Realm`.
+TraceBackend* get_platform_trace_backend() noexcept;
+
+/// Install the backend that trace events are emitted to. Null, which is the
+/// default, disables tracing. The backend must outlive every trace event that
+/// could begin while it is installed. Thread-safe.
+void set_trace_backend(TraceBackend*) noexcept;
+
+
+/// Marks the lifetime of the object as a region of work named `name`. Use
+/// REALM_TRACE_SCOPE() rather than using this class directly.
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) noexcept
+        : m_name(name)
+        , m_backend(s_backend.load(std::memory_order_acquire))
+    {
+        if (m_backend)
+            m_token = m_backend->begin(name);
+    }
+
+    ~TraceScope() noexcept
+    {
+        if (m_backend)
+            m_backend->end(m_name, m_token);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    TraceBackend* m_backend;
+    uint64_t m_token = 0;
+
+    static std::atomic<TraceBackend*> s_backend;
+    friend void set_trace_backend(TraceBackend*) noexcept;
+};
+
+} // namespace realm::util
+
+#define REALM_TRACE_CONCAT_2(a, b) a##b
+#define REALM_TRACE_CONCAT(a, b) REALM_TRACE_CONCAT_2(a, b)
+
+/// Trace the rest of the enclosing scope as a region named `name`, which must
+/// be a string literal.
+#if REALM_ENABLE_TRACING
+#define REALM_TRACE_SCOPE(name) realm::util::TraceScope REALM_TRACE_CONCAT(realm_trace_scope_, __LINE__)(name)
+#else
+#define REALM_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+#endif // REALM_UTIL_TRACE_HPP
@@ -116,15 +116,31 @@ void cpuid_init()
     }
 #endif
 
+    bool avx2Supported = false;
     if (avxSupported) {
+        // AVX2 is reported in EBX bit 5 of CPUID leaf 7, subleaf 0
+        int ebx7;
+#ifdef _MSC_VER
+        __cpuidex(CPUInfo, 7, 0);
+        ebx7 = CPUInfo[1];
+#else
+        unsigned int eax7 = 7, ecx7 = 0, ebx7u, edx7;
+        __asm__ __volatile__("cpuid" : "+a"(eax7), "=b"(ebx7u), "+c"(ecx7), "=d"(edx7));
+        ebx7 = int(ebx7u);
+#endif
+        avx2Supported = (ebx7 & (1 << 5)) != 0;
+    }
+
+    if (avx2Supported) {
+        avx_support = 1; // AVX2 supported
+    }
+    else if (avxSupported) {
         avx_support = 0; // AVX1 supported
     }
     else {
         avx_support = -1; // No AVX supported
     }
 
-    // 1 is reserved for AVX2
-
 #endif
 }
 } // namespace realm
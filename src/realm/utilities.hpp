@@ -73,6 +73,21 @@ typedef SSIZE_T ssize_t;
 #define REALM_COMPILER_AVX
 #endif
 
+// AVX2 kernels are compiled with a per-function target attribute so that the rest of the binary can still run on
+// CPUs without AVX2. They are only ever called after sseavx<2>() has confirmed runtime support.
+#if defined(REALM_COMPILER_AVX)
+#if defined(__GNUC__) || defined(__clang__)
+#define REALM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define REALM_TARGET_AVX2
+#endif
+#endif
+
+// NEON is a mandatory part of ARMv8-A, so no runtime detection is needed on 64-bit ARM
+#if REALM_ARCHITECTURE_ARM64 && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define REALM_COMPILER_NEON
+#endif
+
 namespace realm {
 
 using StringCompareCallback = util::UniqueFunction<bool(const char* string1, const char* string2)>;
@@ -93,7 +108,7 @@ REALM_FORCEINLINE bool sseavx()
 
     avx_support = -1: No AVX support
     avx_support = 0: AVX1 supported
-    sse_support = 1: AVX2 supported (not yet implemented for detection in our cpuid_init(), todo)
+    avx_support = 1: AVX2 supported
 
     This lets us test very rapidly at runtime because we just need 1 compare instruction (with 0) to test both for
     SSE 3 and 4.2 by caller (compiler optimizes if calls are concecutive), and can decide branch with ja/jl/je because
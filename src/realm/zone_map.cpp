@@ -0,0 +1,144 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/zone_map.hpp>
+#include <realm/array_integer.hpp>
+#include <realm/array_timestamp.hpp>
+
+#include <algorithm>
+
+using namespace realm;
+
+namespace {
+
+// Single pass over the elements [begin, end) of `leaf`, reading them in chunks
+// of 8. Elements equal to `null_value` are counted as nulls.
+void add_to_synopsis(const Array& leaf, size_t begin, size_t end, std::optional<int64_t> null_value,
+                     ZoneMap::Synopsis& s)
+{
+    bool first = true;
+    int64_t chunk[8];
+    for (size_t i = begin; i < end; i += 8) {
+        leaf.get_chunk(i, chunk);
+        const size_t n = std::min(end - i, size_t(8));
+        for (size_t j = 0; j < n; ++j) {
+            const int64_t v = chunk[j];
+            if (v == null_value) {
+                ++s.null_count;
+                continue;
+            }
+            if (first) {
+                s.min = s.max = v;
+                first = false;
+            }
+            else if (v < s.min) {
+                s.min = v;
+            }
+            else if (v > s.max) {
+                s.max = v;
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+bool ZoneMap::get(const ArrayInteger& leaf, Synopsis& result) const
+{
+    return lookup(leaf, result);
+}
+
+bool ZoneMap::get(const ArrayIntNull& leaf, Synopsis& result) const
+{
+    return lookup(leaf, result);
+}
+
+bool ZoneMap::get(const ArrayTimestamp& leaf, Synopsis& result) const
+{
+    return lookup(leaf, result);
+}
+
+void ZoneMap::advance() noexcept
+{
+    std::lock_guard lock(m_mutex);
+    for (auto it = m_synopses.begin(); it != m_synopses.end();) {
+        if (it->second.generation != m_generation)
+            it = m_synopses.erase(it);
+        else
+            ++it;
+    }
+    ++m_generation;
+}
+
+void ZoneMap::clear() noexcept
+{
+    std::lock_guard lock(m_mutex);
+    m_synopses.clear();
+}
+
+template <class LeafType>
+bool ZoneMap::lookup(const LeafType& leaf, Synopsis& result) const
+{
+    Allocator& alloc = leaf.get_alloc();
+    ref_type ref = leaf.get_ref();
+    // Leaves that may still be modified in place can't be cached by ref
+    if (!alloc.is_read_only(ref))
+        return false;
+
+    uint_fast64_t generation;
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_synopses.find(ref);
+        if (it != m_synopses.end()) {
+            it->second.generation = m_generation;
+            result = it->second.synopsis;
+            return true;
+        }
+        generation = m_generation;
+    }
+
+    result = compute(leaf);
+
+    std::lock_guard lock(m_mutex);
+    if (generation == m_generation)
+        m_synopses.emplace(ref, Entry{result, generation});
+    return true;
+}
+
+ZoneMap::Synopsis ZoneMap::compute(const ArrayInteger& leaf)
+{
+    Synopsis s;
+    s.size = leaf.size();
+    add_to_synopsis(leaf, 0, s.size, std::nullopt, s);
+    return s;
+}
+
+ZoneMap::Synopsis ZoneMap::compute(const ArrayIntNull& leaf)
+{
+    Synopsis s;
+    s.size = leaf.size();
+    // The null value is stored in front of the elements, and is only read once
+    // here rather than for every element as by ArrayIntNull::get()
+    add_to_synopsis(leaf, 1, s.size + 1, leaf.null_value(), s);
+    return s;
+}
+ZoneMap::Synopsis ZoneMap::compute(const ArrayTimestamp& leaf)
+{
+    // The nanoseconds are ignored, and nulls are recorded in the seconds
+    return compute(leaf.m_seconds);
+}
@@ -0,0 +1,129 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_ZONE_MAP_HPP
+#define REALM_ZONE_MAP_HPP
+
+#include <realm/keys.hpp>
+#include <realm/query_conditions.hpp>
+
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace realm {
+
+class ArrayInteger;
+class ArrayIntNull;
+class ArrayTimestamp;
+
+/// Per-leaf value synopses ("zone maps") for integer and timestamp columns.
+///
+/// A synopsis records the smallest and largest non-null value of a column
+/// leaf together with its number of nulls. The query engine uses them to
+/// skip whole clusters for which a range condition cannot match.
+///
+/// Synopses are computed lazily on first use and are only kept for leaves
+/// that are part of a committed snapshot (i.e. read-only leaves). Such a leaf
+/// never changes, so its synopsis is keyed on its ref alone and stays valid
+/// across commits and transaction boundaries. A ref can only be reused for
+/// another leaf once no reader refers to a version in which it was in use.
+/// As the owning table accessor holds on to its version until it moves to a
+/// new one, an entry that was looked up in the previous version can be kept
+/// by advance(), while older entries are dropped as their refs may have been
+/// reused in the meantime.
+///
+/// For a timestamp leaf, the synopsis covers the seconds part only, so a
+/// condition on a timestamp must be checked against it with the inclusive
+/// variant of its range condition.
+class ZoneMap {
+public:
+    struct Synopsis {
+        int64_t min = 0;
+        int64_t max = 0;
+        size_t null_count = 0;
+        size_t size = 0;
+
+        /// Returns false if no element of the leaf can satisfy `cond` against
+        /// `value`. A null `value` is never used for pruning except by Equal.
+        template <class Cond>
+        bool may_match(std::optional<int64_t> value) const noexcept;
+    };
+
+    /// Fetch the synopsis of `leaf`, computing it if needed. Returns false if
+    /// the leaf is not eligible for caching.
+    bool get(const ArrayInteger& leaf, Synopsis& result) const;
+    bool get(const ArrayIntNull& leaf, Synopsis& result) const;
+    bool get(const ArrayTimestamp& leaf, Synopsis& result) const;
+
+    /// Called when the owning table accessor has moved to another version.
+    /// Drops the entries that were not looked up since the previous call.
+    void advance() noexcept;
+
+    void clear() noexcept;
+
+private:
+    struct Entry {
+        Synopsis synopsis;
+        // The value of m_generation when the entry was last looked up
+        uint_fast64_t generation;
+    };
+
+    mutable std::mutex m_mutex;
+    mutable std::map<ref_type, Entry> m_synopses;
+    uint_fast64_t m_generation = 0;
+
+    template <class LeafType>
+    bool lookup(const LeafType& leaf, Synopsis& result) const;
+    static Synopsis compute(const ArrayInteger& leaf);
+    static Synopsis compute(const ArrayIntNull& leaf);
+    static Synopsis compute(const ArrayTimestamp& leaf);
+};
+
+template <class Cond>
+inline bool ZoneMap::Synopsis::may_match(std::optional<int64_t> value) const noexcept
+{
+    const size_t value_count = size - null_count;
+    if constexpr (std::is_same_v<Cond, Equal>) {
+        if (!value)
+            return null_count > 0;
+        return value_count > 0 && min <= *value && *value <= max;
+    }
+    if (!value)
+        return true;
+    if constexpr (std::is_same_v<Cond, NotEqual>) {
+        return null_count > 0 || (value_count > 0 && (min != *value || max != *value));
+    }
+    else if constexpr (std::is_same_v<Cond, Greater>) {
+        return value_count > 0 && max > *value;
+    }
+    else if constexpr (std::is_same_v<Cond, GreaterEqual>) {
+        return value_count > 0 && max >= *value;
+    }
+    else if constexpr (std::is_same_v<Cond, Less>) {
+        return value_count > 0 && min < *value;
+    }
+    else if constexpr (std::is_same_v<Cond, LessEqual>) {
+        return value_count > 0 && min <= *value;
+    }
+    return true;
+}
+
+} // namespace realm
+
+#endif // REALM_ZONE_MAP_HPP
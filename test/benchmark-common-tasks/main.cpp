@@ -76,11 +76,6 @@ namespace {
   - And yet other has been added to reflect change in idiomatic use (e.g. core5->core6)
 */
 
-const size_t min_repetitions = 5;
-const size_t max_repetitions = 1000;
-const double min_duration_s = 0.5;
-const double min_warmup_time_s = 0.1;
-
 const char* to_lead_cstr(DBOptions::Durability level);
 const char* to_ident_cstr(DBOptions::Durability level);
 
@@ -2162,6 +2157,85 @@ struct BenchmarkInitiatorOpen : public BenchmarkNonInitiatorOpen {
     }
 };
 
+// Writing and reading blobs that span many pages, which with encryption
+// enabled is dominated by encrypting and decrypting the file.
+struct BenchmarkWithBlobs : Benchmark {
+    static constexpr size_t num_blobs = 64;
+    static constexpr size_t blob_size = 64 * 1024;
+
+    void before_all(DBRef group)
+    {
+        WriteTransaction tr(group);
+        TableRef t = tr.add_table(name());
+        m_col = t->add_column(type_Binary, "blob");
+        tr.commit();
+        m_blob.resize(blob_size);
+        for (size_t i = 0; i < blob_size; ++i) {
+            m_blob[i] = char(i * 31 + 7);
+        }
+    }
+
+    void after_all(DBRef group)
+    {
+        WriteTransaction tr(group);
+        tr.get_group().remove_table(name());
+        tr.commit();
+    }
+
+    void write_blobs(DBRef group)
+    {
+        WriteTransaction tr(group);
+        TableRef t = tr.get_table(name());
+        t->clear();
+        for (size_t i = 0; i < num_blobs; ++i) {
+            t->create_object().set(m_col, BinaryData(m_blob.data(), m_blob.size()));
+        }
+        tr.commit();
+    }
+
+    std::string m_blob;
+};
+
+struct BenchmarkWriteBlobs : BenchmarkWithBlobs {
+    const char* name() const
+    {
+        return "WriteBlobs";
+    }
+    void before_each(DBRef) {}
+    void after_each(DBRef) {}
+    void operator()(DBRef group)
+    {
+        write_blobs(group);
+    }
+};
+
+struct BenchmarkReadBlobs : BenchmarkWithBlobs {
+    const char* name() const
+    {
+        return "ReadBlobs";
+    }
+    void before_all(DBRef group)
+    {
+        BenchmarkWithBlobs::before_all(group);
+        write_blobs(group);
+    }
+    void before_each(DBRef) {}
+    void after_each(DBRef) {}
+    void operator()(DBRef group)
+    {
+        auto rt = group->start_read();
+        ConstTableRef t = rt->get_table(name());
+        size_t checksum = 0;
+        for (auto& obj : *t) {
+            BinaryData blob = obj.get<BinaryData>(m_col);
+            for (size_t i = 0; i < blob.size(); i += 4096) {
+                checksum += size_t(blob[i]);
+            }
+        }
+        REALM_ASSERT_RELEASE(checksum != 0);
+    }
+};
+
 struct IterateTableByIterator : Benchmark {
     const char* name() const override
     {
@@ -2603,32 +2677,10 @@ void run_benchmark(BenchmarkResults& results, bool force_full = false)
         group = DB::create(realm_path, DBOptions(level, key));
         benchmark.before_all(group);
 
-        // Warm-up and initial measuring:
-        size_t num_warmup_reps = 1;
-        double time_to_execute_warmup_reps = 0;
-        while (time_to_execute_warmup_reps < min_warmup_time_s && num_warmup_reps < max_repetitions) {
-            num_warmup_reps *= 3;
-            Timer t(Timer::type_UserTime);
-            for (size_t i = 0; i < num_warmup_reps; ++i) {
-                run_benchmark_once(benchmark, group, t);
-            }
-            time_to_execute_warmup_reps = t.get_elapsed_time();
-        }
-        double time_to_execute_one_rep = time_to_execute_warmup_reps / num_warmup_reps;
-        size_t required_reps = size_t(min_duration_s / time_to_execute_one_rep);
-        if (required_reps < min_repetitions) {
-            required_reps = min_repetitions;
-        }
-        if (required_reps > max_repetitions) {
-            required_reps = max_repetitions;
-        }
-        std::cout << "Req runs: " << std::setw(4) << required_reps << "  ";
-        for (size_t rep = 0; rep < required_reps; ++rep) {
-            Timer t;
+        size_t required_reps = results.measure(ident, [&](Timer& t) {
             run_benchmark_once(benchmark, group, t);
-            double s = t.get_elapsed_time();
-            results.submit(ident.c_str(), s);
-        }
+        });
+        std::cout << "Req runs: " << std::setw(4) << required_reps << "  ";
 
         benchmark.after_all(group);
 
@@ -2656,6 +2708,8 @@ int benchmark_common_tasks_main()
     BENCH2(BenchmarkInitiatorOpen, true);
     BENCH2(AddTable, true);
     BENCH2(AddTable, false);
+    BENCH2(BenchmarkWriteBlobs, true);
+    BENCH2(BenchmarkReadBlobs, true);
 
     BENCH(IterateTableByIndexNoPrimaryKey);
     BENCH(IterateTableByIndexIntPrimaryKey);
@@ -2791,7 +2845,7 @@ int benchmark_common_tasks_main()
 
 #undef BENCH
 #undef BENCH2
-    return 0;
+    return results.get_regressions().empty() ? 0 : 1;
 }
 
 int main(int argc, const char** argv)
@@ -231,7 +231,7 @@ int benchmark_crud_main()
 
     std::cout << "dummy = " << dummy << " (to avoid over-optimization)\n";
 
-    return 0;
+    return results.get_regressions().empty() ? 0 : 1;
 }
 
 int main(int argc, const char** argv)
@@ -0,0 +1,207 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include <realm.hpp>
+#include <realm/util/file.hpp>
+
+#include "../util/benchmark_results.hpp"
+#include "../util/crypt_key.hpp"
+#include "../util/timer.hpp"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace realm;
+using namespace realm::test_util;
+
+// Measures opening and reading a large file with a cold and a warm page
+// cache, with and without encryption.
+//
+// The files are generated on the first run, which takes a while, and are kept
+// in the target directory so that later runs can reuse them. The page cache is
+// dropped for the file before every cold run, which does not require any
+// privileges on Linux, as long as nothing else has the file mapped. On other
+// platforms the cold runs are only cold for the decrypted pages of encrypted
+// files.
+//
+// Usage: realm-benchmark-cold-access [SIZE_GB [DIR]]
+
+namespace {
+
+constexpr size_t note_size = 1024;
+constexpr size_t objects_per_transaction = 10000;
+constexpr size_t num_lookups = 1000;
+constexpr size_t num_runs = 3;
+
+std::string customer_name(size_t i)
+{
+    return util::format("customer %1", i % 100000);
+}
+
+void generate(const std::string& path, const char* key, size_t size_gb)
+{
+    DBRef db = DB::create(make_in_realm_history(), path, DBOptions(key));
+    size_t num_objects = size_gb * 1024 * 1024 * 1024 / (note_size + 64);
+    std::mt19937 g(4711);
+
+    std::cout << "Generating " << path << " with " << num_objects << " objects" << std::endl;
+    {
+        WriteTransaction wt(db);
+        auto t = wt.get_group().add_table_with_primary_key("class_Order", type_Int, "id");
+        t->add_column(type_String, "customer");
+        t->add_search_index(t->get_column_key("customer"));
+        t->add_column(type_Double, "amount");
+        t->add_column(type_Timestamp, "created");
+        t->add_column(type_String, "note");
+        wt.commit();
+    }
+    std::string note(note_size, ' ');
+    for (size_t i = 0; i < num_objects; i += objects_per_transaction) {
+        WriteTransaction wt(db);
+        auto t = wt.get_table("class_Order");
+        auto col_customer = t->get_column_key("customer");
+        auto col_amount = t->get_column_key("amount");
+        auto col_created = t->get_column_key("created");
+        auto col_note = t->get_column_key("note");
+        for (size_t j = i; j < std::min(i + objects_per_transaction, num_objects); ++j) {
+            for (auto& c : note)
+                c = char('a' + g() % 26);
+            t->create_object_with_primary_key(int64_t(j))
+                .set(col_customer, customer_name(j))
+                .set(col_amount, double(g() % 100000) / 100)
+                .set(col_created, Timestamp(int64_t(1600000000 + j), 0))
+                .set(col_note, note);
+        }
+        wt.commit();
+    }
+}
+
+// Ask the kernel to evict the pages of the file from the page cache
+void drop_page_cache(const std::string& path)
+{
+#if defined(__linux__)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+#else
+    static_cast<void>(path);
+#endif
+}
+
+void run(BenchmarkResults& results, const std::string& dir, const char* key, size_t size_gb)
+{
+    std::string suffix = key ? "EncryptionOn" : "EncryptionOff";
+    std::string path = util::format("%1/cold-access-%2gb-%3.realm", dir, size_gb, suffix);
+    if (!util::File::exists(path))
+        generate(path, key, size_gb);
+
+    // Pick the objects to look up while the file is open, so that finding
+    // them is not part of what is measured
+    std::vector<ObjKey> keys;
+    std::vector<int64_t> primary_keys;
+    {
+        DBRef db = DB::create(make_in_realm_history(), path, DBOptions(key));
+        auto rt = db->start_read();
+        auto t = rt->get_table("class_Order");
+        std::mt19937 g(1234);
+        for (size_t i = 0; i < num_lookups; ++i) {
+            size_t ndx = g() % t->size();
+            keys.push_back(t->get_object(ndx).get_key());
+            primary_keys.push_back(int64_t(g() % t->size()));
+        }
+    }
+
+    for (const char* cache : {"Cold", "Warm"}) {
+        bool cold = cache[0] == 'C';
+        auto ident = [&](const char* step) {
+            return util::format("%1_%2_%3", step, cache, suffix);
+        };
+        for (size_t i = 0; i < num_runs; ++i) {
+            if (cold)
+                drop_page_cache(path);
+
+            Timer timer(Timer::type_RealTime);
+            DBRef db = DB::create(make_in_realm_history(), path, DBOptions(key));
+            auto rt = db->start_read();
+            auto t = rt->get_table("class_Order");
+            results.submit(ident("Open").c_str(), timer.get_elapsed_time());
+
+            auto col_customer = t->get_column_key("customer");
+            auto col_amount = t->get_column_key("amount");
+            std::string customer = customer_name(4711);
+            timer.reset();
+            size_t count = t->where().equal(col_customer, StringData(customer)).count();
+            results.submit(ident("FirstQuery").c_str(), timer.get_elapsed_time());
+            REALM_ASSERT_RELEASE(count > 0);
+
+            double sum = 0;
+            timer.reset();
+            for (auto key : keys)
+                sum += t->get_object(key).get<double>(col_amount);
+            results.submit(ident("LookupByObjKey").c_str(), timer.get_elapsed_time() / num_lookups);
+
+            timer.reset();
+            for (auto pk : primary_keys)
+                sum += t->get_object_with_primary_key(pk).get<double>(col_amount);
+            results.submit(ident("LookupByPrimaryKey").c_str(), timer.get_elapsed_time() / num_lookups);
+
+            timer.reset();
+            for (auto& obj : *t)
+                sum += obj.get<double>(col_amount);
+            results.submit(ident("FullScan").c_str(), timer.get_elapsed_time());
+            REALM_ASSERT_RELEASE(sum > 0);
+        }
+        results.finish(ident("Open"), ident("Open"), "runtime_secs");
+        results.finish(ident("FirstQuery"), ident("FirstQuery"), "runtime_secs");
+        results.finish(ident("LookupByObjKey"), ident("LookupByObjKey"), "runtime_secs_per_lookup");
+        results.finish(ident("LookupByPrimaryKey"), ident("LookupByPrimaryKey"), "runtime_secs_per_lookup");
+        results.finish(ident("FullScan"), ident("FullScan"), "runtime_secs");
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, const char** argv)
+{
+    size_t size_gb = 5;
+    std::string dir = ".";
+    if (argc > 1)
+        size_gb = size_t(std::atoi(argv[1]));
+    if (argc > 2)
+        dir = argv[2];
+    if (size_gb == 0 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " [SIZE_GB [DIR]]" << std::endl;
+        return 1;
+    }
+
+    BenchmarkResults results(40, "benchmark-cold-access", (dir + "/results").c_str());
+    run(results, dir, nullptr, size_gb);
+    if (const char* key = crypt_key(true))
+        run(results, dir, key, size_gb);
+
+    return results.get_regressions().empty() ? 0 : 1;
+}
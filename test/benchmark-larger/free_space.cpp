@@ -0,0 +1,96 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <realm.hpp>
+
+#include "../test.hpp"
+
+using namespace realm;
+using namespace realm::test_util;
+
+// Measures the time spent committing small write transactions to a file with
+// a fragmented free list. The file is fragmented by updating and removing
+// random objects holding strings of random length, so that the arrays freed
+// by copy-on-write are scattered all over the file.
+int main()
+{
+    std::mt19937 g(4711);
+
+    auto run = [&](size_t num_objects, size_t num_commits) {
+        TestPathGuard guard("benchmark-free-space.realm");
+        std::string path(guard);
+        auto history = make_in_realm_history();
+        DBRef db = DB::create(*history, path);
+        ColKey col;
+        {
+            WriteTransaction wt(db);
+            auto t = wt.add_table("table");
+            col = t->add_column(type_String, "str");
+            wt.commit();
+        }
+        auto random_string = [&] {
+            return std::string(g() % 200, 'x');
+        };
+        for (size_t i = 0; i < num_objects; i += 10000) {
+            WriteTransaction wt(db);
+            auto t = wt.get_table("table");
+            for (size_t j = 0; j < 10000; ++j)
+                t->create_object().set(col, random_string());
+            wt.commit();
+        }
+
+        // Fragment the free space
+        for (size_t i = 0; i < 1000; ++i) {
+            WriteTransaction wt(db);
+            auto t = wt.get_table("table");
+            for (size_t j = 0; j < 20; ++j) {
+                auto obj = t->get_object(g() % t->size());
+                if (j % 4)
+                    obj.set(col, random_string());
+                else
+                    obj.remove();
+            }
+            wt.commit();
+        }
+
+        std::chrono::nanoseconds total{0};
+        for (size_t i = 0; i < num_commits; ++i) {
+            WriteTransaction wt(db);
+            auto t = wt.get_table("table");
+            for (size_t j = 0; j < 10; ++j)
+                t->get_object(g() % t->size()).set(col, random_string());
+            auto start = std::chrono::steady_clock::now();
+            wt.commit();
+            total += std::chrono::steady_clock::now() - start;
+        }
+
+        size_t free_space = 0;
+        size_t used_space = 0;
+        db->get_stats(free_space, used_space);
+        std::cout << "Commit " << num_objects << " objects, " << free_space << " bytes free: "
+                  << total.count() / num_commits << " ns" << std::endl;
+    };
+
+    run(100000, 1000);
+    run(1000000, 1000);
+    run(10000000, 100);
+}
@@ -23,6 +23,7 @@
 
 #include <realm.hpp>
 
+#include "../util/benchmark_results.hpp"
 #include "../util/timer.hpp"
 #include "../util/random.hpp"
 #include "../util/unit_test.hpp"
@@ -50,9 +51,22 @@ int main()
     std::mt19937 g(rd());
     volatile int64_t sum = 0; // prevent optimization
 
+    std::string results_file_stem = get_test_path_prefix() + "results";
+    BenchmarkResults results(40, "benchmark-larger", results_file_stem.c_str());
+
     auto run_steps = [&](int num_steps, int step_size, step_type st, const char* step_layout,
                          std::vector<int> rw_probes = {}) {
         bool test_rw = rw_probes.size() != 0;
+        // Every step is a sample of the time per object of its operation
+        std::vector<std::string> idents;
+        auto submit = [&](const char* op, size_t probe_size, std::chrono::nanoseconds diff, size_t num_objects) {
+            std::string ident = util::format("%1_%2_%3", op, step_names[st], step_layout);
+            if (probe_size)
+                ident += util::format("_%1", probe_size);
+            if (std::find(idents.begin(), idents.end(), ident) == idents.end())
+                idents.push_back(ident);
+            results.submit(ident.c_str(), std::chrono::duration<double>(diff).count() / num_objects);
+        };
         TestPathGuard guard("benchmark-insertion.realm");
         std::string path(guard);
         auto history = make_in_realm_history();
@@ -128,6 +142,7 @@ int main()
                 auto print_diff = std::chrono::duration_cast<std::chrono::nanoseconds>(diff);
                 std::cout << "Insert " << step_names[st] << " " << step_layout << " ";
                 std::cout << j << " _ " << print_diff.count() / step_size << std::endl;
+                submit("Insert", 0, print_diff, step_size);
             }
             else {
                 // doing r/w tests:
@@ -160,6 +175,7 @@ int main()
                     std::cout << "Obj " << step_names[st] << " " << step_layout << " ";
                     std::cout << j + step_size << " _ " << probe_size << " " << print_diff.count() / probe_size
                               << std::endl;
+                    submit("Obj", probe_size, print_diff, probe_size);
                     start = end;
                     for (size_t i = 0; i < probe_size; ++i) {
                         sum += objects[i].get<Int>(col2);
@@ -170,6 +186,7 @@ int main()
                     std::cout << "Prop_rd " << step_names[st] << " " << step_layout << " ";
                     std::cout << j + step_size << " _ " << probe_size << " " << print_diff.count() / probe_size
                               << std::endl;
+                    submit("Prop_rd", probe_size, print_diff, probe_size);
 
                     // std::cout << " " << print_diff.count() / probe_size;
                     start = end;
@@ -183,6 +200,7 @@ int main()
                     std::cout << "Prop_wr " << step_names[st] << " " << step_layout << " ";
                     std::cout << j + step_size << " _ " << probe_size << " " << print_diff.count() / probe_size
                               << std::endl;
+                    submit("Prop_wr", probe_size, print_diff, probe_size);
 
                     // std::cout << " " << print_diff.count() / probe_size << std::endl;
                 }
@@ -191,6 +209,8 @@ int main()
                 }
             }
         }
+        for (auto& ident : idents)
+            results.finish(ident, ident, "runtime_secs_per_obj");
     };
     auto run_type = [&](step_type st, bool test_rw = false) {
         if (!test_rw) {
@@ -220,4 +240,6 @@ int main()
     run_type(INDEXED_BEST, true);
     run_type(INDEXED_WORST, true);
     run_type(PK, true);
+
+    return results.get_regressions().empty() ? 0 : 1;
 }
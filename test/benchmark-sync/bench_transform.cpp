@@ -5,6 +5,18 @@
 #include "../test_all.hpp"
 #include "../sync_fixtures.hpp"
 
+#include <realm/sync/changeset_encoder.hpp>
+#include <realm/sync/changeset_parser.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 using namespace realm;
 using namespace realm::test_util::unit_test;
 using namespace realm::fixtures;
@@ -267,6 +279,266 @@ void connected_objects(TestContext& test_context)
     results->finish(ident, ident, "runtime_secs");
 }
 
+// One peer has 1000 transactions which the other peer, which has no local
+// changes, downloads and integrates. This measures integration without any
+// operational transformation.
+template <size_t num_transactions>
+void integrate_transactions(TestContext& test_context)
+{
+    std::string ident = test_context.test_details.test_name;
+
+    for (size_t i = 0; i < 3; ++i) {
+        TEST_CLIENT_DB(db_1);
+        TEST_CLIENT_DB(db_2);
+
+        ColKey col_key;
+        {
+            WriteTransaction wt(db_2);
+            TableRef t = wt.get_group().add_table_with_primary_key("class_t", type_Int, "pk");
+            col_key = t->add_column(type_String, "s");
+            wt.commit();
+        }
+        for (size_t j = 0; j < num_transactions; ++j) {
+            WriteTransaction wt(db_2);
+            TableRef t = wt.get_table("class_t");
+            t->create_object_with_primary_key(int64_t(j)).set(col_key, std::string(100, char('a' + j % 26)));
+            wt.commit();
+        }
+
+        TEST_DIR(dir);
+
+        MultiClientServerFixture::Config config;
+        config.server_public_key_path = "";
+        MultiClientServerFixture fixture(2, 1, dir, test_context, config);
+        Timer t{Timer::type_RealTime};
+
+        Session::Config session_config;
+        session_config.on_sync_client_event_hook = [&](const SyncClientHookData& data) {
+            if (data.num_changesets == 0) {
+                return SyncClientHookAction::NoAction;
+            }
+
+            switch (data.event) {
+                case realm::SyncClientHookEvent::DownloadMessageReceived:
+                    t.reset();
+                    break;
+                case realm::SyncClientHookEvent::DownloadMessageIntegrated:
+                    results->submit(ident.c_str(), t.get_elapsed_time());
+                    break;
+                default:
+                    break;
+            }
+
+            return SyncClientHookAction::NoAction;
+        };
+        Session session_1 = fixture.make_session(0, 0, db_1, "/test", std::move(session_config));
+        session_1.bind();
+        Session session_2 = fixture.make_session(1, 0, db_2, "/test");
+        session_2.bind();
+
+        // Start server and upload changes of second client.
+        fixture.start_server(0);
+        fixture.start_client(1);
+        session_2.wait_for_upload_complete_or_client_stopped();
+        session_2.detach();
+        fixture.stop_client(1);
+
+        // Download and integrate the changes of the second client.
+        fixture.start_client(0);
+        session_1.wait_for_download_complete_or_client_stopped();
+
+        ReadTransaction rt(db_1);
+        CHECK_EQUAL(rt.get_table("class_t")->size(), num_transactions);
+    }
+
+    results->finish(ident, ident, "runtime_secs");
+}
+
+struct LoadConfig {
+    // May be overridden with the environment variable REALM_BENCH_LOAD_CLIENTS
+    size_t num_clients = 4;
+    size_t num_transactions = 200; // Per client
+    size_t objects_per_transaction = 10;
+    // Every Nth transaction of every client also modifies one of a small set
+    // of objects which are shared by all clients, so those edits conflict.
+    size_t conflict_interval = 4;
+    size_t num_shared_objects = 10;
+};
+
+// Resident set size of the process in bytes, or zero if unknown.
+size_t get_resident_memory()
+{
+#if defined(__linux__)
+    std::ifstream in("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (in >> total_pages >> resident_pages)
+        return resident_pages * size_t(sysconf(_SC_PAGESIZE));
+#endif
+    return 0;
+}
+
+// N clients which are all connected to the same server Realm concurrently
+// upload transactions which create objects and which (every
+// `conflict_interval` transactions) update objects that every client edits,
+// while downloading and integrating the changes of all the other clients.
+// This reports the time per uploaded changeset until all clients have
+// converged (the inverse of the throughput), the latency of integrating
+// each download message, and the memory used per client.
+//
+// The in-repo server only supports partition based sync, so this does not
+// exercise flexible sync subscriptions.
+void sync_load(TestContext& test_context, LoadConfig load)
+{
+    if (const char* num_clients = std::getenv("REALM_BENCH_LOAD_CLIENTS"))
+        load.num_clients = size_t(std::atoi(num_clients));
+    std::string ident = test_context.test_details.test_name;
+    std::string latency_ident = ident + "_IntegrationLatency";
+    const size_t num_iterations = 3;
+
+    for (size_t i = 0; i < num_iterations; ++i) {
+        size_t memory_before = get_resident_memory();
+
+        std::vector<std::unique_ptr<test_util::DBTestPathGuard>> paths;
+        std::vector<DBRef> dbs;
+        for (size_t j = 0; j < load.num_clients; ++j) {
+            paths.push_back(std::make_unique<test_util::DBTestPathGuard>(
+                test_util::get_test_path(test_context.get_test_name(), util::format(".client_%1.realm", j))));
+            dbs.push_back(DB::create(make_client_replication(), *paths.back()));
+            WriteTransaction wt(dbs.back());
+            TableRef t = wt.get_group().add_table_with_primary_key("class_t", type_Int, "pk");
+            t->add_column(type_Int, "i");
+            wt.commit();
+        }
+
+        TEST_DIR(dir);
+
+        MultiClientServerFixture::Config config;
+        config.server_public_key_path = "";
+        MultiClientServerFixture fixture(int(load.num_clients), 1, dir, test_context, config);
+
+        // The hooks are executed by the event loop threads of all the clients
+        std::mutex mutex;
+        std::vector<double> latencies;
+        std::vector<std::unique_ptr<Timer>> timers;
+        std::vector<Session> sessions;
+        for (size_t j = 0; j < load.num_clients; ++j) {
+            timers.push_back(std::make_unique<Timer>(Timer::type_RealTime));
+            Session::Config session_config;
+            session_config.on_sync_client_event_hook = [&, timer = timers.back().get()](
+                                                           const SyncClientHookData& data) {
+                if (data.num_changesets == 0) {
+                    return SyncClientHookAction::NoAction;
+                }
+                if (data.event == realm::SyncClientHookEvent::DownloadMessageReceived) {
+                    timer->reset();
+                }
+                else if (data.event == realm::SyncClientHookEvent::DownloadMessageIntegrated) {
+                    std::lock_guard lock(mutex);
+                    latencies.push_back(timer->get_elapsed_time());
+                }
+                return SyncClientHookAction::NoAction;
+            };
+            sessions.push_back(fixture.make_session(int(j), 0, dbs[j], "/test", std::move(session_config)));
+            sessions.back().bind();
+        }
+        fixture.start();
+
+        Timer t{Timer::type_RealTime};
+        std::vector<std::thread> writers;
+        for (size_t j = 0; j < load.num_clients; ++j) {
+            writers.emplace_back([&, j] {
+                DBRef& db = dbs[j];
+                for (size_t k = 0; k < load.num_transactions; ++k) {
+                    WriteTransaction wt(db);
+                    TableRef table = wt.get_table("class_t");
+                    ColKey col = table->get_column_key("i");
+                    // Primary keys below `num_shared_objects` are shared
+                    size_t first_pk =
+                        load.num_shared_objects + (j * load.num_transactions + k) * load.objects_per_transaction;
+                    for (size_t l = 0; l < load.objects_per_transaction; ++l) {
+                        table->create_object_with_primary_key(int64_t(first_pk + l)).set(col, int64_t(k));
+                    }
+                    if (load.conflict_interval && k % load.conflict_interval == 0) {
+                        size_t pk = k / load.conflict_interval % load.num_shared_objects;
+                        table->create_object_with_primary_key(int64_t(pk)).set(col, int64_t(j));
+                    }
+                    wt.commit();
+                }
+            });
+        }
+        for (auto& writer : writers)
+            writer.join();
+        for (auto& session : sessions)
+            session.wait_for_upload_complete_or_client_stopped();
+        for (auto& session : sessions)
+            session.wait_for_download_complete_or_client_stopped();
+        double elapsed = t.get_elapsed_time();
+
+        size_t total_transactions = load.num_clients * load.num_transactions;
+        results->submit(ident.c_str(), elapsed / total_transactions);
+        {
+            std::lock_guard lock(mutex);
+            for (double latency : latencies)
+                results->submit(latency_ident.c_str(), latency);
+        }
+
+        size_t memory_after = get_resident_memory();
+        std::cout << ident << ": " << load.num_clients << " clients, " << size_t(total_transactions / elapsed)
+                  << " changesets/s";
+        if (memory_after > memory_before) {
+            std::cout << ", " << (memory_after - memory_before) / load.num_clients / 1024 << " KiB per client";
+        }
+        std::cout << std::endl;
+
+        size_t num_shared_objects = 0;
+        if (load.conflict_interval) {
+            size_t num_conflicting_transactions =
+                (load.num_transactions + load.conflict_interval - 1) / load.conflict_interval;
+            num_shared_objects = std::min(load.num_shared_objects, num_conflicting_transactions);
+        }
+        for (auto& db : dbs) {
+            ReadTransaction rt(db);
+            CHECK_EQUAL(rt.get_table("class_t")->size(),
+                        num_shared_objects + total_transactions * load.objects_per_transaction);
+        }
+    }
+
+    results->finish(ident, ident, "runtime_secs_per_changeset");
+    results->finish(latency_ident, latency_ident, "runtime_secs");
+}
+
+// A changeset with many small instructions, the way bootstraps are received,
+// is parsed. Most of the parse time is spent decoding integers and interned
+// strings.
+template <size_t num_instructions>
+void parse_changeset(TestContext& test_context)
+{
+    std::string ident = test_context.test_details.test_name;
+
+    sync::Changeset changeset;
+    for (size_t i = 0; i < num_instructions; ++i) {
+        sync::instr::Update instr;
+        instr.table = changeset.intern_string("class_t");
+        instr.object = sync::instr::PrimaryKey{int64_t(i)};
+        instr.field = changeset.intern_string(i % 2 ? "small" : "large");
+        instr.value = sync::instr::Payload{int64_t(i % 2 ? i % 50 : i * 1000003)};
+        changeset.push_back(instr);
+    }
+    sync::ChangesetEncoder::Buffer buffer;
+    encode_changeset(changeset, buffer);
+
+    for (size_t i = 0; i < 10; ++i) {
+        Timer t{Timer::type_RealTime};
+        util::SimpleInputStream stream{buffer};
+        sync::Changeset parsed;
+        sync::parse_changeset(stream, parsed);
+        results->submit(ident.c_str(), t.get_elapsed_time());
+        CHECK_EQUAL(parsed.size(), num_instructions);
+    }
+
+    results->finish(ident, ident, "runtime_secs");
+}
+
 } // namespace bench
 
 const int max_lead_text_width = 40;
@@ -331,11 +603,53 @@ TEST(BenchMerge16000x16000Transactions)
     bench::transform_transactions<16000>(test_context);
 }
 
+TEST(BenchIntegrate1000Transactions)
+{
+    bench::integrate_transactions<1000>(test_context);
+}
+
+TEST(BenchIntegrate10000Transactions)
+{
+    bench::integrate_transactions<10000>(test_context);
+}
+
+TEST(BenchLoad4Clients)
+{
+    bench::sync_load(test_context, {});
+}
+
+TEST(BenchLoad16ClientsNoConflicts)
+{
+    bench::LoadConfig config;
+    config.num_clients = 16;
+    config.num_transactions = 100;
+    config.conflict_interval = 0;
+    bench::sync_load(test_context, config);
+}
+
+TEST(BenchLoad16Clients)
+{
+    bench::LoadConfig config;
+    config.num_clients = 16;
+    config.num_transactions = 100;
+    bench::sync_load(test_context, config);
+}
+
 TEST(BenchMergeManyConnectedObjects)
 {
     bench::connected_objects<1000>(test_context);
 }
 
+TEST(BenchParse100000Instructions)
+{
+    bench::parse_changeset<100000>(test_context);
+}
+
+TEST(BenchParse1000000Instructions)
+{
+    bench::parse_changeset<1000000>(test_context);
+}
+
 #if !REALM_IOS
 int main()
 {
@@ -343,6 +657,8 @@ int main()
     bench::results =
         std::make_unique<BenchmarkResults>(max_lead_text_width, "benchmark-sync", results_file_stem.c_str());
     auto exit_status = test_all();
+    if (exit_status == 0 && !bench::results->get_regressions().empty())
+        exit_status = 1;
     // Save to file when deallocated.
     bench::results.reset();
     return exit_status;
@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include <util/test_file.hpp>
+
+#include <realm.h>
+#include <realm/object-store/c_api/types.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstring>
+#include <memory>
+
+using namespace realm;
+
+// These benchmark the calls which the SDKs make through the C API on their hot
+// paths. Where it makes sense, the same operation is also measured directly
+// through the object store, so that the difference is the per-call overhead of
+// the C API itself: translating arguments and values, and catching exceptions.
+
+namespace {
+
+struct RealmReleaseDeleter {
+    void operator()(void* ptr)
+    {
+        realm_release(ptr);
+    }
+};
+
+template <class T>
+using CPtr = std::unique_ptr<T, RealmReleaseDeleter>;
+
+template <class T>
+CPtr<T> cptr_checked(T* ptr)
+{
+    REQUIRE(ptr);
+    return CPtr<T>{ptr};
+}
+
+constexpr size_t num_objects = 1000;
+
+CPtr<realm_t> open_realm(TestFile& test_file)
+{
+    realm_property_info_t properties[] = {
+        {"_id", "", RLM_PROPERTY_TYPE_INT, RLM_COLLECTION_TYPE_NONE, "", "", RLM_INVALID_PROPERTY_KEY,
+         RLM_PROPERTY_INDEXED | RLM_PROPERTY_PRIMARY_KEY},
+        {"int", "", RLM_PROPERTY_TYPE_INT, RLM_COLLECTION_TYPE_NONE, "", "", RLM_INVALID_PROPERTY_KEY,
+         RLM_PROPERTY_NORMAL},
+        {"string", "", RLM_PROPERTY_TYPE_STRING, RLM_COLLECTION_TYPE_NONE, "", "", RLM_INVALID_PROPERTY_KEY,
+         RLM_PROPERTY_NORMAL},
+    };
+    realm_class_info_t classes[] = {
+        {"Item", "_id", 3, 0, RLM_INVALID_CLASS_KEY, RLM_CLASS_NORMAL},
+    };
+    const realm_property_info_t* class_properties[] = {properties};
+    auto schema = cptr_checked(realm_schema_new(classes, 1, class_properties));
+
+    auto config = cptr_checked(realm_config_new());
+    realm_config_set_path(config.get(), test_file.path.c_str());
+    realm_config_set_schema(config.get(), schema.get());
+    realm_config_set_schema_version(config.get(), 0);
+    realm_config_set_schema_mode(config.get(), RLM_SCHEMA_MODE_AUTOMATIC);
+    realm_config_set_automatic_change_notifications(config.get(), false);
+    return cptr_checked(realm_open(config.get()));
+}
+
+realm_value_t int_value(int64_t value)
+{
+    realm_value_t val;
+    val.type = RLM_TYPE_INT;
+    val.integer = value;
+    return val;
+}
+
+realm_value_t string_value(const char* value)
+{
+    realm_value_t val;
+    val.type = RLM_TYPE_STRING;
+    val.string = realm_string_t{value, strlen(value)};
+    return val;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Benchmark C API", "[benchmark][c_api]") {
+    TestFile test_file;
+    auto realm = open_realm(test_file);
+
+    bool found = false;
+    realm_class_info_t class_info;
+    REQUIRE(realm_find_class(realm.get(), "Item", &found, &class_info));
+    REQUIRE(found);
+    realm_property_info_t int_prop, string_prop;
+    REQUIRE(realm_find_property(realm.get(), class_info.key, "int", &found, &int_prop));
+    REQUIRE(realm_find_property(realm.get(), class_info.key, "string", &found, &string_prop));
+
+    REQUIRE(realm_begin_write(realm.get()));
+    for (size_t i = 0; i < num_objects; ++i) {
+        auto obj = cptr_checked(realm_object_create_with_primary_key(realm.get(), class_info.key, int_value(i)));
+        REQUIRE(realm_set_value(obj.get(), int_prop.key, int_value(i % 100), false));
+        REQUIRE(realm_set_value(obj.get(), string_prop.key, string_value("a string value"), false));
+    }
+    REQUIRE(realm_commit(realm.get()));
+
+    SECTION("object accessors") {
+        auto obj = cptr_checked(realm_object_find_with_primary_key(realm.get(), class_info.key, int_value(0), &found));
+        Obj& cpp_obj = obj->get_obj();
+        ColKey int_col(int_prop.key);
+
+        BENCHMARK("realm_get_value int") {
+            realm_value_t val;
+            realm_get_value(obj.get(), int_prop.key, &val);
+            return val.integer;
+        };
+
+        BENCHMARK("realm_get_value string") {
+            realm_value_t val;
+            realm_get_value(obj.get(), string_prop.key, &val);
+            return val.string.size;
+        };
+
+        BENCHMARK("Obj::get int (without C API)") {
+            return cpp_obj.get<Int>(int_col);
+        };
+
+        REQUIRE(realm_begin_write(realm.get()));
+
+        int64_t i = 0;
+        BENCHMARK("realm_set_value int") {
+            return realm_set_value(obj.get(), int_prop.key, int_value(++i), false);
+        };
+
+        BENCHMARK("realm_set_value string") {
+            return realm_set_value(obj.get(), string_prop.key, string_value("another string value"), false);
+        };
+
+        BENCHMARK("Obj::set int (without C API)") {
+            return cpp_obj.set<Int>(int_col, ++i).get_key();
+        };
+
+        int64_t pk = num_objects;
+        BENCHMARK("realm_object_create_with_primary_key") {
+            auto new_obj = realm_object_create_with_primary_key(realm.get(), class_info.key, int_value(pk++));
+            realm_release(new_obj);
+            return new_obj;
+        };
+
+        REQUIRE(realm_rollback(realm.get()));
+    }
+
+    SECTION("results") {
+        auto results = cptr_checked(realm_object_find_all(realm.get(), class_info.key));
+        size_t count = 0;
+        REQUIRE(realm_results_count(results.get(), &count));
+        REQUIRE(count == num_objects);
+        Results& cpp_results = *results;
+
+        BENCHMARK("realm_results_get") {
+            realm_value_t val;
+            for (size_t i = 0; i < num_objects; ++i)
+                realm_results_get(results.get(), i, &val);
+            return val.link.target;
+        };
+
+        BENCHMARK("realm_results_get_object") {
+            realm_object_t* obj = nullptr;
+            for (size_t i = 0; i < num_objects; ++i) {
+                obj = realm_results_get_object(results.get(), i);
+                realm_release(obj);
+            }
+            return obj;
+        };
+
+        BENCHMARK("Results::get (without C API)") {
+            Obj obj;
+            for (size_t i = 0; i < num_objects; ++i)
+                obj = cpp_results.get(i);
+            return obj.get_key();
+        };
+    }
+
+    SECTION("queries") {
+        realm_value_t arg_value = int_value(50);
+        realm_query_arg_t arg{1, false, &arg_value};
+
+        BENCHMARK("realm_query_parse") {
+            auto query = realm_query_parse(realm.get(), class_info.key, "int > $0 AND string == 'a string value'", 1,
+                                           &arg);
+            realm_release(query);
+            return query;
+        };
+
+        BENCHMARK("realm_query_parse and execute") {
+            auto query = realm_query_parse(realm.get(), class_info.key, "int > $0 AND string == 'a string value'", 1,
+                                           &arg);
+            auto results = realm_query_find_all(query);
+            size_t count = 0;
+            realm_results_count(results, &count);
+            realm_release(results);
+            realm_release(query);
+            return count;
+        };
+    }
+
+    SECTION("notifications") {
+        auto results = cptr_checked(realm_object_find_all(realm.get(), class_info.key));
+        auto on_change = [](realm_userdata_t userdata, const realm_collection_changes_t*) {
+            ++*static_cast<size_t*>(userdata);
+        };
+        size_t calls = 0;
+
+        BENCHMARK("realm_results_add_notification_callback") {
+            auto token = realm_results_add_notification_callback(results.get(), &calls, nullptr, nullptr, on_change);
+            realm_release(token);
+            return token;
+        };
+
+        auto obj = cptr_checked(realm_object_find_with_primary_key(realm.get(), class_info.key, int_value(0), &found));
+        auto token = cptr_checked(
+            realm_results_add_notification_callback(results.get(), &calls, nullptr, nullptr, on_change));
+        advance_and_notify(**realm);
+
+        int64_t i = 0;
+        BENCHMARK("commit and deliver notification") {
+            realm_begin_write(realm.get());
+            realm_set_value(obj.get(), int_prop.key, int_value(++i), false);
+            realm_commit(realm.get());
+            advance_and_notify(**realm);
+            return calls;
+        };
+        REQUIRE(calls > 0);
+    }
+}
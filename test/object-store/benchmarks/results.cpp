@@ -333,6 +333,35 @@ TEST_CASE("Benchmark results notifier", "[benchmark][results]") {
             coordinator.on_change();
         };
     }
+
+    SECTION("many queries on one table") {
+        config.schema = Schema{{"object", {{"value", PropertyType::Int}}}};
+        auto realm = Realm::get_shared_realm(config);
+        auto table = realm->read_group().get_table("class_object");
+        auto col = table->get_column_key("value");
+
+        realm->begin_transaction();
+        for (int i = 0; i < 1000; ++i) {
+            table->create_object().set(col, i);
+        }
+        realm->commit_transaction();
+
+        std::vector<Results> results;
+        std::vector<NotificationToken> tokens;
+        for (int i = 0; i < 100; ++i) {
+            results.push_back(Results(realm, table->where().greater_equal(col, i * 10)));
+            tokens.push_back(results.back().add_notification_callback([](CollectionChangeSet) {}));
+        }
+        auto& coordinator = *_impl::RealmCoordinator::get_coordinator(config.path);
+        coordinator.on_change();
+
+        BENCHMARK("modify one object", iteration) {
+            realm->begin_transaction();
+            table->get_object(iteration % 1000).set(col, 1000 + iteration);
+            realm->commit_transaction();
+            coordinator.on_change();
+        };
+    }
 }
 
 TEST_CASE("aggregates", "[benchmark][aggregate]") {
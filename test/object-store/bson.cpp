@@ -24,6 +24,7 @@
 #include "util/test_utils.hpp"
 #include "util/test_file.hpp"
 #include <realm/util/bson/bson.hpp>
+#include <realm/util/bson/bson_view.hpp>
 
 using namespace nlohmann;
 using namespace realm;
@@ -746,3 +747,87 @@ TEST_CASE("nested types parsing", "[bson]") {
         CHECK(nested_document2_str.str() == nested_document2_expectation);
     }
 }
+
+TEST_CASE("binary bson", "[bson]") {
+    SECTION("Specification example") {
+        auto encoded = "\x16\x00\x00\x00\x02hello\x00\x06\x00\x00\x00world\x00\x00"sv;
+        auto view = bson::parse_binary(encoded);
+        REQUIRE(view.size() == 1);
+        auto value = view.find("hello");
+        REQUIRE(value);
+        REQUIRE(value->type() == Bson::Type::String);
+        CHECK(value->get_string() == "world");
+        // Strings are read in place
+        CHECK(value->get_string().data() == encoded.data() + 15);
+        CHECK(!view.find("world"));
+
+        auto encoded_again = bson::encode_binary(BsonDocument{{"hello", "world"}});
+        CHECK(std::string_view(encoded_again.data(), encoded_again.size()) == encoded);
+    }
+
+    SECTION("Round trip of all types") {
+        BsonDocument document{
+            {"null", util::none},
+            {"int32", int32_t(-42)},
+            {"int64", int64_t(1) << 40},
+            {"bool", true},
+            {"double", 3.25},
+            {"string", std::string("with an embedded \0 null", 23)},
+            {"binary", std::vector<char>{1, 0, 2}},
+            {"timestamp", MongoTimestamp(123456789, 42)},
+            {"datetime", realm::Timestamp(-1, -500'000'000)},
+            {"oid", ObjectId("507f1f77bcf86cd799439011")},
+            {"decimal", Decimal128("-1.5E+10")},
+            {"regex", RegularExpression("^a.*b$", "imx")},
+            {"max", MaxKey()},
+            {"min", MinKey()},
+            {"uuid", realm::UUID("3b241101-e2bb-4255-8caf-4136c566a962")},
+            {"document", BsonDocument{{"nested", BsonArray{1, "two", BsonDocument{}}}}},
+            {"array", BsonArray{}},
+        };
+        auto encoded = bson::encode_binary(document);
+        auto view = bson::parse_binary(encoded);
+        CHECK(view.size() == document.size());
+        CHECK(view.materialize() == document);
+
+        std::vector<std::string_view> keys;
+        for (auto [key, value] : view)
+            keys.push_back(key);
+        CHECK(keys.size() == document.keys().size());
+        CHECK(std::equal(keys.begin(), keys.end(), document.keys().begin()));
+
+        CHECK(view.find("int64")->get_int64() == int64_t(1) << 40);
+        CHECK(view.find("datetime")->get_datetime() == realm::Timestamp(-1, -500'000'000));
+        CHECK(view.find("binary")->get_binary() == BinaryData("\1\0\2", 3));
+        CHECK(view.find("uuid")->type() == Bson::Type::Uuid);
+        auto nested = view.find("document")->get_document().find("nested")->get_array();
+        CHECK(nested.size() == 3);
+        CHECK((*nested.begin()).get_int32() == 1);
+        CHECK(view.find("array")->get_array().empty());
+    }
+
+    SECTION("Malformed documents are rejected") {
+        auto check_invalid = [](std::string_view encoded, const std::string& reason) {
+            REQUIRE_EXCEPTION(bson::parse_binary(encoded), BadBsonParse, "Invalid binary BSON: " + reason);
+        };
+        check_invalid("\x05\x00\x00"sv, "truncated document");
+        check_invalid("\x06\x00\x00\x00\x00"sv, "bad document size");
+        check_invalid("\x05\x00\x00\x00\x00\x00"sv, "trailing data after document");
+        check_invalid("\x05\x00\x00\x00\x01"sv, "missing document terminator");
+        check_invalid("\x0f\x00\x00\x00\x02"
+                      "a\x00\x10\x00\x00\x00"
+                      "bc\x00\x00"sv,
+                      "bad string size");
+        check_invalid("\x08\x00\x00\x00\x06"
+                      "a\x00\x00"sv,
+                      "unsupported element type 6");
+        check_invalid("\x09\x00\x00\x00\x08"
+                      "a\x00\x02\x00"sv,
+                      "bad boolean value");
+    }
+
+    SECTION("Keys containing null characters cannot be encoded") {
+        REQUIRE_EXCEPTION(bson::encode_binary(BsonDocument{{std::string("a\0b", 3), 1}}), InvalidArgument,
+                          "BSON keys and regular expressions cannot contain null characters");
+    }
+}
@@ -2329,6 +2329,54 @@ TEST_CASE("C API - properties", "[c_api]") {
             CHECK_ERR(RLM_ERR_INVALIDATED_OBJECT);
         }
 
+        SECTION("realm_object_create_many() and realm_results_get_values()") {
+            realm_property_key_t props[2] = {foo_int_key, foo_str_key};
+            realm_value_t values[6] = {rlm_int_val(1),     rlm_int_val(2),     rlm_int_val(3),
+                                       rlm_str_val("one"), rlm_str_val("two"), rlm_str_val("three")};
+            realm_object_key_t keys[3];
+
+            CHECK(!realm_object_create_many(realm, class_foo.key, 3, 2, props, values, keys));
+            CHECK_ERR(RLM_ERR_WRONG_TRANSACTION_STATE);
+
+            write([&]() {
+                CHECK(checked(realm_object_create_many(realm, class_foo.key, 3, 2, props, values, keys)));
+            });
+            CHECK(checked(realm_get_num_objects(realm, class_foo.key, &foo_count)));
+            CHECK(foo_count == 6);
+            auto obj = cptr_checked(realm_get_object(realm, class_foo.key, keys[1]));
+            realm_value_t value;
+            CHECK(checked(realm_get_value(obj.get(), foo_str_key, &value)));
+            CHECK(value.string.data == std::string{"two"});
+
+            auto results = cptr_checked(realm_object_find_all(realm, class_foo.key));
+            realm_value_t out[6];
+            CHECK(checked(realm_results_get_values(results.get(), 3, 6, 2, props, out)));
+            for (size_t i = 0; i < 3; ++i) {
+                CHECK(out[i].type == RLM_TYPE_INT);
+                CHECK(out[i].integer == values[i].integer);
+                CHECK(out[3 + i].type == RLM_TYPE_STRING);
+                CHECK(std::string(out[3 + i].string.data, out[3 + i].string.size) ==
+                      std::string(values[3 + i].string.data, values[3 + i].string.size));
+            }
+
+            CHECK(!realm_results_get_values(results.get(), 3, 7, 2, props, out));
+            CHECK_ERR(RLM_ERR_INDEX_OUT_OF_BOUNDS);
+            realm_property_key_t list_prop = foo_links_key;
+            CHECK(!realm_results_get_values(results.get(), 0, 1, 1, &list_prop, out));
+            CHECK_ERR(RLM_ERR_PROPERTY_TYPE_MISMATCH);
+
+            // Nothing is created if any value is of the wrong type
+            realm_value_t wrong[2] = {rlm_int_val(4), rlm_str_val("five")};
+            write([&]() {
+                CHECK(!realm_object_create_many(realm, class_foo.key, 2, 1, props, wrong, nullptr));
+                CHECK_ERR(RLM_ERR_PROPERTY_TYPE_MISMATCH);
+                CHECK(!realm_object_create_many(realm, class_bar.key, 2, 1, props, wrong, nullptr));
+                CHECK_ERR(RLM_ERR_MISSING_PRIMARY_KEY);
+            });
+            CHECK(checked(realm_get_num_objects(realm, class_foo.key, &foo_count)));
+            CHECK(foo_count == 6);
+        }
+
         SECTION("realm_set_value() errors") {
             CHECK(!realm_set_value(obj1.get(), foo_int_key, rlm_int_val(456), false));
             CHECK_ERR(RLM_ERR_WRONG_TRANSACTION_STATE);
@@ -2649,6 +2697,25 @@ TEST_CASE("C API - properties", "[c_api]") {
                     });
                 }
 
+                SECTION("insert many, then get") {
+                    write([&]() {
+                        realm_value_t values[] = {a, b, c};
+                        CHECK(checked(realm_list_insert_many(strings.get(), 0, values, 3)));
+                        CHECK(checked(realm_list_insert_many(strings.get(), 1, values, 2)));
+
+                        size_t size;
+                        CHECK(checked(realm_list_size(strings.get(), &size)));
+                        CHECK(size == 5);
+                        realm_value_t value;
+                        CHECK(checked(realm_list_get(strings.get(), 1, &value)));
+                        CHECK(rlm_stdstr(value) == "a");
+                        CHECK(checked(realm_list_get(strings.get(), 3, &value)));
+                        CHECK(rlm_stdstr(value) == "b");
+                        CHECK(checked(realm_list_get(strings.get(), 4, &value)));
+                        CHECK(value.type == RLM_TYPE_NULL);
+                    });
+                }
+
                 SECTION("equality") {
                     auto strings2 = cptr_checked(realm_get_list(obj2.get(), bar_strings_key));
                     CHECK(strings2);
@@ -3280,6 +3347,26 @@ TEST_CASE("C API - properties", "[c_api]") {
                     CHECK(strings.get() != set2.get());
                 }
 
+                SECTION("insert many, then get") {
+                    write([&]() {
+                        realm_value_t values[] = {b, a, c, a};
+                        size_t num_inserted = 0;
+                        CHECK(checked(realm_set_insert_many(strings.get(), values, 4, &num_inserted)));
+                        CHECK(num_inserted == 3);
+                        CHECK(checked(realm_set_insert_many(strings.get(), values, 2, &num_inserted)));
+                        CHECK(num_inserted == 0);
+
+                        size_t size;
+                        CHECK(checked(realm_set_size(strings.get(), &size)));
+                        CHECK(size == 3);
+                        realm_value_t value;
+                        CHECK(checked(realm_set_get(strings.get(), 0, &value)));
+                        CHECK(value.type == RLM_TYPE_NULL);
+                        CHECK(checked(realm_set_get(strings.get(), 2, &value)));
+                        CHECK(rlm_stdstr(value) == "b");
+                    });
+                }
+
                 SECTION("insert, then get, then erase") {
                     write([&]() {
                         bool inserted = false;
@@ -3712,6 +3799,29 @@ TEST_CASE("C API - properties", "[c_api]") {
                     CHECK(strings.get() != dict2.get());
                 }
 
+                SECTION("insert many, then get") {
+                    write([&]() {
+                        realm_value_t keys[] = {key_b, key_a, key_c, key_a};
+                        realm_value_t values[] = {b, a, c, b};
+                        size_t num_inserted = 0;
+                        CHECK(checked(realm_dictionary_insert_many(strings.get(), keys, values, 4, &num_inserted)));
+                        CHECK(num_inserted == 3);
+
+                        realm_value_t a2, c2;
+                        bool found = false;
+                        CHECK(checked(realm_dictionary_find(strings.get(), key_a, &a2, &found)));
+                        CHECK(found);
+                        CHECK(rlm_stdstr(a2) == "b");
+                        CHECK(checked(realm_dictionary_find(strings.get(), key_c, &c2, &found)));
+                        CHECK(found);
+                        CHECK(c2.type == RLM_TYPE_NULL);
+
+                        realm_value_t int_keys[] = {rlm_int_val(1)};
+                        CHECK(!realm_dictionary_insert_many(strings.get(), int_keys, values, 1, nullptr));
+                        CHECK_ERR(RLM_ERR_INVALID_ARGUMENT);
+                    });
+                }
+
                 SECTION("insert, then get, then erase") {
                     write([&]() {
                         bool inserted = false;
@@ -4815,6 +4925,41 @@ TEST_CASE("C API - queries", "[c_api]") {
             CHECK_ERR_CAT(RLM_ERR_INVALID_QUERY_ARG, (RLM_ERR_CAT_INVALID_ARG | RLM_ERR_CAT_LOGIC));
         }
 
+        SECTION("realm_query_prepare()") {
+            realm_value_t prepare_arg = rlm_int_val(0);
+            realm_query_arg_t prepare_args[1] = {realm_query_arg_t{1, false, &prepare_arg}};
+            auto prepared = cptr_checked(
+                realm_query_prepare(realm, class_foo.key, "int == $0 SORT(string ASCENDING)", 1, prepare_args));
+
+            auto count_for = [&](realm_value_t value) {
+                realm_query_arg_t arg{1, false, &value};
+                auto r = cptr_checked(realm_query_bind_and_run(prepared.get(), 1, &arg));
+                size_t count;
+                CHECK(checked(realm_results_count(r.get(), &count)));
+                return count;
+            };
+            CHECK(count_for(int_val1) == 2);
+            CHECK(count_for(int_val2) == 1);
+            CHECK(count_for(rlm_int_val(789)) == 0);
+
+            // Each run sees the current version of the Realm
+            write([&]() {
+                auto obj = cptr_checked(realm_object_create(realm, class_foo.key));
+                CHECK(checked(realm_set_value(obj.get(), foo_int_key, rlm_int_val(789), false)));
+            });
+            CHECK(count_for(rlm_int_val(789)) == 1);
+
+            // Invalid number of arguments
+            CHECK(!realm_query_bind_and_run(prepared.get(), 0, nullptr));
+            CHECK_ERR_CAT(RLM_ERR_INVALID_QUERY_ARG, (RLM_ERR_CAT_INVALID_ARG | RLM_ERR_CAT_LOGIC));
+
+            // Errors in the query are reported when preparing
+            CHECK(!realm_query_prepare(realm, class_foo.key, "lel", 0, nullptr));
+            CHECK_ERR_CAT(RLM_ERR_INVALID_QUERY_STRING, (RLM_ERR_CAT_INVALID_ARG | RLM_ERR_CAT_LOGIC));
+            CHECK(!realm_query_prepare(realm, class_foo.key, "strong == $0", 1, prepare_args));
+            CHECK_ERR_CAT(RLM_ERR_INVALID_QUERY, (RLM_ERR_CAT_INVALID_ARG | RLM_ERR_CAT_LOGIC));
+        }
+
         SECTION("string in list") {
             char foo[] = "foo";
             realm_value_t str = rlm_str_val(foo);
@@ -5189,6 +5334,29 @@ TEST_CASE("C API - queries", "[c_api]") {
                 CHECK(count == 0);
             }
 
+            SECTION("realm_results_get_range() and realm_results_get_objects()") {
+                auto r_all = cptr_checked(realm_object_find_all(realm, class_foo.key));
+                size_t count;
+                CHECK(checked(realm_results_count(r_all.get(), &count)));
+                std::vector<realm_value_t> values(count);
+                CHECK(checked(realm_results_get_range(r_all.get(), 0, count, values.data())));
+                std::vector<realm_object_t*> objects(count);
+                CHECK(checked(realm_results_get_objects(r_all.get(), 0, count, objects.data())));
+                for (size_t i = 0; i < count; ++i) {
+                    auto p = cptr_checked(realm_results_get_object(r_all.get(), i));
+                    auto obj = cptr(objects[i]);
+                    CHECK(realm_equals(obj.get(), p.get()));
+                    CHECK(values[i].type == RLM_TYPE_LINK);
+                    CHECK(values[i].link.target == realm_object_get_key(p.get()));
+                }
+
+                CHECK(checked(realm_results_get_range(r_all.get(), count, 0, nullptr)));
+                CHECK(!realm_results_get_range(r_all.get(), 0, count + 1, values.data()));
+                CHECK_ERR(RLM_ERR_INDEX_OUT_OF_BOUNDS);
+                CHECK(!realm_results_get_objects(r_all.get(), 1, count, objects.data()));
+                CHECK_ERR(RLM_ERR_INDEX_OUT_OF_BOUNDS);
+            }
+
             SECTION("realm_results_sort()") {
                 auto r_all = cptr_checked(realm_object_find_all(realm, class_foo.key));
                 auto p = cptr_checked(realm_results_get_object(r_all.get(), 0));
@@ -5286,6 +5454,30 @@ TEST_CASE("C API - queries", "[c_api]") {
                 CHECK_ERR(RLM_ERR_INVALID_PROPERTY);
             }
 
+            SECTION("realm_results_group_by()") {
+                auto r_all = cptr_checked(realm_object_find_all(realm, class_foo.key));
+                realm_aggregate_t aggregates[] = {{RLM_AGGREGATE_SUM, foo_int_key}, {RLM_AGGREGATE_MAX, foo_int_key}};
+                auto groups = cptr_checked(realm_results_group_by(r_all.get(), foo_int_key, aggregates, 2));
+                CHECK(realm_group_by_result_size(groups.get()) == 2);
+                size_t total = 0;
+                for (size_t i = 0; i < 2; ++i) {
+                    realm_value_t key, values[2];
+                    size_t count;
+                    CHECK(checked(realm_group_by_result_get(groups.get(), i, &key, &count, values)));
+                    CHECK(key.type == RLM_TYPE_INT);
+                    CHECK(values[0].type == RLM_TYPE_INT);
+                    CHECK(values[0].integer == key.integer * int64_t(count));
+                    CHECK(values[1].integer == key.integer);
+                    total += count;
+                }
+                CHECK(total == 3);
+
+                CHECK(!realm_group_by_result_get(groups.get(), 2, nullptr, nullptr, nullptr));
+                CHECK_ERR(RLM_ERR_INDEX_OUT_OF_BOUNDS);
+                CHECK(!realm_results_group_by(r_all.get(), RLM_INVALID_PROPERTY_KEY, nullptr, 0));
+                CHECK_ERR(RLM_ERR_INVALID_PROPERTY);
+            }
+
             SECTION("realm_results_delete_all()") {
                 CHECK(!realm_results_delete_all(r.get()));
                 CHECK_ERR(RLM_ERR_WRONG_TRANSACTION_STATE);
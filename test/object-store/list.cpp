@@ -538,6 +538,31 @@ TEST_CASE("list", "[list]") {
             REQUIRE_INDICES(change.deletions, 5);
         }
 
+        SECTION("changes are sent in initial notification to several notifiers added at the same version") {
+            // These share the change info calculated for the version range, including for the
+            // duplicate entries for the same list
+            List lst2(r, obj, col_link);
+            List other_lst(r, other_obj, other_col_link);
+            CollectionChangeSet change2, other_change;
+            auto token = lst.add_notification_callback([&](CollectionChangeSet c) {
+                change = c;
+            });
+            auto token2 = lst2.add_notification_callback([&](CollectionChangeSet c) {
+                change2 = c;
+            });
+            auto other_token = other_lst.add_notification_callback([&](CollectionChangeSet c) {
+                other_change = c;
+            });
+            r2->begin_transaction();
+            r2_lv->remove(5);
+            r2->read_group().get_table("class_other_origin")->begin()->get_linklist(other_col_link).remove(2);
+            r2->commit_transaction();
+            advance_and_notify(*r);
+            REQUIRE_INDICES(change.deletions, 5);
+            REQUIRE_INDICES(change2.deletions, 5);
+            REQUIRE_INDICES(other_change.deletions, 2);
+        }
+
         SECTION("changes are sent in initial notification after removing and then re-adding callback") {
             auto token = lst.add_notification_callback([&](CollectionChangeSet) {
                 REQUIRE(false);
@@ -2180,6 +2180,31 @@ TEST_CASE("migration: Additive", "[migration]") {
         REQUIRE(ObjectStore::table_for_object_type(realm->read_group(), "object 2"));
     }
 
+    SECTION("changes to large tables can be committed in chunks") {
+        realm->begin_transaction();
+        auto table = ObjectStore::table_for_object_type(realm->read_group(), "object");
+        for (int i = 0; i < 20; ++i)
+            table->create_object();
+        realm->commit_transaction();
+        auto version = realm->read_transaction_version();
+
+        std::vector<std::pair<size_t, size_t>> progress;
+        auto config2 = config;
+        config2.schema_change_objects_per_commit = 10;
+        config2.schema_change_progress_function = [&](size_t applied, size_t total) {
+            progress.emplace_back(applied, total);
+        };
+        config2.schema = add_property(add_property(schema, "object", {"value 3", PropertyType::Int}), "object",
+                                      {"value 4", PropertyType::String | PropertyType::Nullable});
+        auto realm2 = Realm::get_shared_realm(config2);
+
+        // Each added column touches all 20 objects, so the first one is
+        // committed on its own before the second one is applied
+        REQUIRE(progress == std::vector<std::pair<size_t, size_t>>{{1, 2}, {2, 2}});
+        REQUIRE(realm2->read_transaction_version().version == version.version + 2);
+        REQUIRE(ObjectStore::table_for_object_type(realm2->read_group(), "object")->get_column_count() == 4);
+    }
+
     SECTION("embedded orphan types") {
         if (config.schema_mode == SchemaMode::AdditiveDiscovered) {
             // in discovered mode, adding embedded orphan types is allowed but ignored
@@ -494,6 +494,49 @@ TEST_CASE("object") {
                               "Accessing object of type table which has been invalidated or deleted");
         }
 
+        SECTION("observing multiple objects with a MultiObjectObserver") {
+            MultiObjectObserver observer(r, table);
+            std::vector<CollectionChangeSet> changes(3);
+            std::vector<int> calls(3);
+            std::vector<NotificationToken> tokens;
+            for (size_t i = 0; i < 3; ++i) {
+                tokens.push_back(observer.add_notification_callback(table->get_object(i).get_key(),
+                                                                    [&, i](CollectionChangeSet c) {
+                                                                        changes[i] = c;
+                                                                        ++calls[i];
+                                                                    }));
+            }
+            advance_and_notify(*r);
+            REQUIRE(calls == std::vector<int>{1, 1, 1});
+
+            write([&] {
+                table->get_object(1).set(col_keys[0], 10);
+                table->get_object(5).set(col_keys[0], 10);
+            });
+            REQUIRE(calls == std::vector<int>{1, 2, 1});
+            REQUIRE_INDICES(changes[1].modifications, 0);
+            REQUIRE(changes[1].columns.size() == 1);
+            REQUIRE_INDICES(changes[1].columns[col_keys[0].value], 0);
+
+            write([&] {
+                table->get_object(2).remove();
+                table->get_object(0).set(col_keys[1], 10);
+            });
+            REQUIRE(calls == std::vector<int>{2, 2, 2});
+            REQUIRE_INDICES(changes[0].columns[col_keys[1].value], 0);
+            REQUIRE_INDICES(changes[2].deletions, 0);
+
+            tokens[0].unregister();
+            write([&] {
+                table->get_object(0).set(col_keys[0], 20);
+                table->get_object(1).set(col_keys[1], 20);
+            });
+            REQUIRE(calls == std::vector<int>{2, 3, 2});
+
+            REQUIRE_THROWS_AS(observer.add_notification_callback(ObjKey(12345), [](CollectionChangeSet) {}),
+                              KeyNotFound);
+        }
+
         SECTION("keypath filtered notifications") {
             auto table_origin = r->read_group().get_table("class_table2");
             auto col_origin_value = table_origin->get_column_key("value");
@@ -36,6 +36,7 @@
 #include <realm/object-store/class.hpp>
 #include <realm/object-store/thread_safe_reference.hpp>
 #include <realm/object-store/impl/realm_coordinator.hpp>
+#include <realm/object-store/impl/weak_realm_notifier.hpp>
 #include <realm/object-store/util/event_loop_dispatcher.hpp>
 #include <realm/object-store/util/scheduler.hpp>
 
@@ -923,6 +924,68 @@ TEST_CASE("SharedRealm: schema_subset_mode") {
     }
 }
 
+TEST_CASE("SharedRealm: cache_schema_fingerprint") {
+    TestFile config;
+    config.cache = false;
+    config.cache_schema_fingerprint = true;
+    config.schema_version = 1;
+    config.schema = Schema{
+        {"object", {{"_id", PropertyType::Int, Property::IsPrimary{true}}, {"value", PropertyType::Int}}},
+    };
+
+    // The first open creates the schema, and the second one finds that no
+    // changes are needed and stores the fingerprint
+    Realm::get_shared_realm(config);
+    auto realm = Realm::get_shared_realm(config);
+    uint64_t fingerprint = ObjectStore::get_schema_fingerprint(realm->read_group());
+    REQUIRE(fingerprint != 0);
+    auto version = realm->read_transaction_version();
+    realm->close();
+
+    SECTION("reopening with the same schema does not write") {
+        realm = Realm::get_shared_realm(config);
+        REQUIRE(realm->read_transaction_version() == version);
+        REQUIRE(ObjectStore::get_schema_fingerprint(realm->read_group()) == fingerprint);
+
+        auto table = realm->read_group().get_table("class_object");
+        auto& object_schema = *realm->schema().find("object");
+        REQUIRE(object_schema.table_key == table->get_key());
+        REQUIRE(object_schema.property_for_name("value")->column_key == table->get_column_key("value"));
+    }
+
+    SECTION("a changed schema is still applied") {
+        config.schema_version = 2;
+        config.schema = Schema{
+            {"object",
+             {{"_id", PropertyType::Int, Property::IsPrimary{true}},
+              {"value", PropertyType::Int},
+              {"value 2", PropertyType::String}}},
+        };
+        realm = Realm::get_shared_realm(config);
+        REQUIRE(realm->read_group().get_table("class_object")->get_column_key("value 2"));
+        REQUIRE(ObjectStore::get_schema_version(realm->read_group()) == 2);
+    }
+
+    SECTION("a change made by someone else invalidates the fingerprint") {
+        {
+            auto db = DB::create(make_in_realm_history(), config.path);
+            auto tr = db->start_write();
+            tr->add_table("class_external")->add_column(type_Int, "value");
+            tr->commit();
+        }
+        realm = Realm::get_shared_realm(config);
+        REQUIRE(realm->read_transaction_version().version == version.version + 2);
+        REQUIRE(ObjectStore::get_schema_fingerprint(realm->read_group()) != fingerprint);
+    }
+
+    SECTION("an invalid schema is rejected") {
+        config.schema = Schema{
+            {"object", {{"_id", PropertyType::Int, Property::IsPrimary{true}}, {"value", PropertyType::Object}}},
+        };
+        REQUIRE_THROWS(Realm::get_shared_realm(config));
+    }
+}
+
 #if REALM_ENABLE_SYNC
 TEST_CASE("Get Realm using Async Open", "[sync][pbs][async open]") {
     if (!util::EventLoop::has_implementation())
@@ -2607,6 +2670,51 @@ TEST_CASE("SharedRealm: async writes") {
         });
     }
 
+    SECTION("async write batching") {
+        realm->set_async_write_batching(Realm::AsyncWriteBatching{10, std::chrono::hours(1)});
+        auto initial_version = realm->read_transaction_version().version;
+        size_t completion_calls = 0;
+        for (size_t i = 0; i < 25; ++i) {
+            realm->async_begin_transaction([&, i] {
+                // Every batch of 10 blocks is a single write transaction
+                REQUIRE(table->size() == i);
+                REQUIRE(realm->read_transaction_version().version == initial_version + i / 10);
+                table->create_object();
+                realm->async_commit_transaction([&](std::exception_ptr error) {
+                    REQUIRE_FALSE(error);
+                    ++completion_calls;
+                });
+            });
+        }
+        util::EventLoop::main().run_until([&] {
+            return completion_calls == 25;
+        });
+        REQUIRE(table->size() == 25);
+        REQUIRE(realm->read_transaction_version().version == initial_version + 3);
+    }
+
+    SECTION("async write batching with a block which cancels") {
+        realm->set_async_write_batching(Realm::AsyncWriteBatching{});
+        size_t aborted = 0;
+        for (size_t i = 0; i < 2; ++i) {
+            realm->async_begin_transaction([&] {
+                table->create_object();
+                realm->async_commit_transaction([&](std::exception_ptr error) {
+                    REQUIRE_THROWS_AS(std::rethrow_exception(error), Exception);
+                    ++aborted;
+                });
+            });
+        }
+        realm->async_begin_transaction([&] {
+            table->create_object();
+            realm->cancel_transaction();
+            done = true;
+        });
+        wait_for_done();
+        REQUIRE(aborted == 2);
+        REQUIRE(table->size() == 0);
+    }
+
     SECTION("async writes scheduled inside sync write") {
         realm->begin_transaction();
         realm->async_begin_transaction([&] {
@@ -2761,6 +2869,67 @@ TEST_CASE("Call run_async_completions after realm has been closed") {
         cb();
 }
 
+TEST_CASE("SharedRealm: notifications are coalesced") {
+    struct ManualScheduler : util::Scheduler {
+        std::vector<util::UniqueFunction<void()>> callbacks;
+
+        void invoke(util::UniqueFunction<void()>&& cb) override
+        {
+            callbacks.push_back(std::move(cb));
+        }
+        bool is_on_thread() const noexcept override
+        {
+            return true;
+        }
+        bool is_same_as(const Scheduler*) const noexcept override
+        {
+            return false;
+        }
+        bool can_invoke() const noexcept override
+        {
+            return true;
+        }
+    };
+
+    auto scheduler = std::make_shared<ManualScheduler>();
+    TestFile config;
+    config.schema_version = 0;
+    config.schema = Schema{{"object", {{"value", PropertyType::Int}}}};
+    config.scheduler = scheduler;
+    config.automatic_change_notifications = false;
+    auto realm = Realm::get_shared_realm(config);
+    realm->read_group();
+    auto initial_version = realm->read_transaction_version();
+
+    auto write = [&] {
+        RealmConfig other_config = config;
+        other_config.scheduler = util::Scheduler::make_dummy();
+        auto other = Realm::get_shared_realm(other_config);
+        other->begin_transaction();
+        other->read_group().get_table("class_object")->create_object();
+        other->commit_transaction();
+    };
+
+    _impl::WeakRealmNotifier notifier(realm, false);
+    for (int i = 0; i < 5; ++i) {
+        write();
+        notifier.notify();
+    }
+    // The pending invocation is shared by all of the notifications, and
+    // advances straight to the newest version
+    REQUIRE(scheduler->callbacks.size() == 1);
+    scheduler->callbacks[0]();
+    REQUIRE(realm->read_transaction_version().version == initial_version.version + 5);
+    REQUIRE(realm->read_group().get_table("class_object")->size() == 5);
+
+    // Once it has run, the next notification is invoked again
+    write();
+    notifier.notify();
+    REQUIRE(scheduler->callbacks.size() == 2);
+    scheduler->callbacks[1]();
+    REQUIRE(realm->read_group().get_table("class_object")->size() == 6);
+}
+
 // Our libuv scheduler currently does not support background threads, so we can
 // only run this on apple platforms
 #if REALM_PLATFORM_APPLE
@@ -4526,6 +4695,28 @@ TEST_CASE("KeyPathMapping generation") {
         auto q = table->query("parents.value = $0", args, mapping);
         REQUIRE(q.count() == 0);
     }
+
+    SECTION("shared by the Realm until the schema changes") {
+        config.schema = Schema{
+            {"object", {{"value", PropertyType::Int, Property::IsPrimary{false}, Property::IsIndexed{false}, "v"}}},
+        };
+        auto realm = Realm::get_shared_realm(config);
+        auto shared_mapping = realm->get_keypath_mapping();
+        REQUIRE(shared_mapping->get_mapping(realm->schema().find("object")->table_key, "v") == "value");
+        REQUIRE(realm->get_keypath_mapping() == shared_mapping);
+
+        auto table = realm->read_group().get_table("class_object");
+        std::vector<Mixed> args{0};
+        REQUIRE(table->query("v > $0", args, *shared_mapping).count() == 0);
+
+        realm->update_schema(Schema{{"object", {{"value", PropertyType::Int}}},
+                                    {"other", {{"value", PropertyType::Int}}, {}, "Other"}},
+                             1);
+        auto new_mapping = realm->get_keypath_mapping();
+        REQUIRE(new_mapping != shared_mapping);
+        REQUIRE(new_mapping->has_table_mapping("Other"));
+        REQUIRE_FALSE(new_mapping->get_mapping(realm->schema().find("object")->table_key, "v"));
+    }
 }
 
 TEST_CASE("Concurrent operations") {
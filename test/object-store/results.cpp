@@ -898,6 +898,58 @@ TEST_CASE("notifications: async delivery", "[notifications]") {
     }
 }
 
+TEST_CASE("notifications: delivery on commit", "[notifications]") {
+    _impl::RealmCoordinator::assert_no_open_realms();
+    TestFile config;
+    config.in_memory = true;
+    config.automatic_change_notifications = false;
+    config.deliver_notifications_on_commit = true;
+
+    auto r = Realm::get_shared_realm(config);
+    r->update_schema({
+        {"object", {{"value", PropertyType::Int}}},
+    });
+    auto table = r->read_group().get_table("class_object");
+    auto col = table->get_column_key("value");
+
+    Results results(r, table->where().greater(col, 0));
+    int notification_calls = 0;
+    CollectionChangeSet saved_changes;
+    auto token = results.add_notification_callback([&](CollectionChangeSet changes) {
+        ++notification_calls;
+        saved_changes = changes;
+    });
+    advance_and_notify(*r);
+    REQUIRE(notification_calls == 1);
+
+    SECTION("local changes are delivered before commit_transaction() returns") {
+        r->begin_transaction();
+        table->create_object().set(col, 1);
+        r->commit_transaction();
+        REQUIRE(notification_calls == 2);
+        REQUIRE_INDICES(saved_changes.insertions, 0);
+
+        // and are not delivered a second time by notify()
+        advance_and_notify(*r);
+        REQUIRE(notification_calls == 2);
+    }
+
+    SECTION("changes not matching the query do not call the callback") {
+        r->begin_transaction();
+        table->create_object().set(col, 0);
+        r->commit_transaction();
+        REQUIRE(notification_calls == 1);
+    }
+
+    SECTION("skipped changes are not delivered") {
+        r->begin_transaction();
+        table->create_object().set(col, 1);
+        token.suppress_next();
+        r->commit_transaction();
+        REQUIRE(notification_calls == 1);
+    }
+}
+
 TEST_CASE("notifications: skip", "[notifications]") {
     _impl::RealmCoordinator::assert_no_open_realms();
     InMemoryTestFile config;
@@ -1422,6 +1474,46 @@ TEST_CASE("notifications: TableView delivery", "[notifications]") {
 }
 
 
+TEST_CASE("notifications: many notifiers", "[notifications]") {
+    _impl::RealmCoordinator::assert_no_open_realms();
+    TestFile config;
+    config.automatic_change_notifications = false;
+
+    auto r = Realm::get_shared_realm(config);
+    r->update_schema({
+        {"object", {{"value", PropertyType::Int}}},
+    });
+    auto table = r->read_group().get_table("class_object");
+    auto col = table->get_column_key("value");
+
+    // Enough notifiers to be spread over several threads
+    const int64_t count = 100;
+    std::vector<Results> results;
+    std::vector<NotificationToken> tokens;
+    std::vector<size_t> insertions(count);
+    results.reserve(count);
+    for (int64_t i = 0; i < count; ++i) {
+        results.emplace_back(r, table->where().greater_equal(col, i));
+        tokens.push_back(results.back().add_notification_callback([&, i](CollectionChangeSet c) {
+            insertions[i] += c.insertions.count();
+        }));
+    }
+    advance_and_notify(*r);
+
+    for (int64_t round = 0; round < 5; ++round) {
+        r->begin_transaction();
+        for (int64_t i = 0; i < 50; ++i)
+            table->create_object().set(col, (round * 50 + i) % 120);
+        r->commit_transaction();
+        advance_and_notify(*r);
+    }
+
+    for (int64_t i = 0; i < count; ++i) {
+        REQUIRE(insertions[i] == table->where().greater_equal(col, i).count());
+        REQUIRE(results[i].size() == insertions[i]);
+    }
+}
+
 #if REALM_ENABLE_SYNC
 TEST_CASE("notifications: sync", "[sync][pbs][notifications]") {
     _impl::RealmCoordinator::assert_no_open_realms();
@@ -1622,6 +1714,27 @@ TEST_CASE("notifications: results", "[notifications][results]") {
             REQUIRE_INDICES(change.deletions, 1);
         }
 
+        SECTION("modifying a column which the query doesn't read marks matching rows as modified") {
+            write([&] {
+                table->get_object(object_keys[1]).set(col_link, target_keys[5]);
+                table->get_object(object_keys[6]).set(col_link, target_keys[5]);
+            });
+            REQUIRE(notification_calls == 2);
+            REQUIRE(change.insertions.empty());
+            REQUIRE(change.deletions.empty());
+            REQUIRE_INDICES(change.modifications, 0);
+            REQUIRE(results.size() == 4);
+            REQUIRE(results.get<Obj>(0).get<ObjKey>(col_link) == target_keys[5]);
+
+            // and the results stay up to date when the column which is read changes next
+            write([&] {
+                table->get_object(object_keys[1]).set(col_value, 0);
+            });
+            REQUIRE(notification_calls == 3);
+            REQUIRE_INDICES(change.deletions, 0);
+            REQUIRE(results.size() == 3);
+        }
+
         SECTION("modifying a non-matching row to match marks that row as inserted, but not modified") {
             write([&] {
                 table->get_object(object_keys[7]).set(col_value, 3);
@@ -2361,6 +2474,18 @@ TEST_CASE("notifications: results", "[notifications][results]") {
                         other_table->get_object(other_table_obj_key).set(column_key_other_table_value, 43);
                     });
 
+                    REQUIRE(notification_calls_linked_to_value == 1);
+                    REQUIRE(collection_change_set_linked_to_value.empty());
+                }
+                SECTION("modifying related table 'linked to object', property 'value' of an unlinked object "
+                        "-> does NOT send a notification") {
+                    write([&] {
+                        linked_to_table->create_object().set(column_key_linked_to_table_value, 42);
+                        table->get_object(object_keys[1])
+                            .get_linked_object(col_link)
+                            .set(column_key_linked_to_table_value2, 42);
+                    });
+
                     REQUIRE(notification_calls_linked_to_value == 1);
                     REQUIRE(collection_change_set_linked_to_value.empty());
                 }
@@ -4963,6 +5088,182 @@ TEST_CASE("results: filter", "[results]") {
     }
 }
 
+TEST_CASE("results: evaluation window", "[results]") {
+    InMemoryTestFile config;
+    config.automatic_change_notifications = false;
+
+    auto r = Realm::get_shared_realm(config);
+    r->update_schema({{"object", {{"id", PropertyType::Int}}}});
+
+    auto t = r->read_group().get_table("class_object");
+    ColKey col_id = t->get_column_key("id");
+    r->begin_transaction();
+    for (int i = 0; i < 1000; ++i)
+        t->create_object().set(col_id, i);
+    r->commit_transaction();
+
+    Results res(r, t->where().greater(col_id, 0));
+    res.set_evaluation_window(10);
+
+    SECTION("get() evaluates only a prefix") {
+        REQUIRE(res.get(0).get<Int>(col_id) == 1);
+        REQUIRE(res.get(50).get<Int>(col_id) == 51);
+        REQUIRE(res.get_any(998).get_link().get_obj_key() == t->get_object(999).get_key());
+        REQUIRE(res.get_mode() == Results::Mode::Query);
+        REQUIRE(res.first()->get<Int>(col_id) == 1);
+        REQUIRE_THROWS_AS(res.get(999), OutOfBounds);
+        REQUIRE(res.size() == 999);
+    }
+
+    SECTION("the prefix follows changes") {
+        REQUIRE(res.get(0).get<Int>(col_id) == 1);
+        r->begin_transaction();
+        t->get_object(1).set(col_id, 0);
+        r->commit_transaction();
+        REQUIRE(res.get(0).get<Int>(col_id) == 2);
+        REQUIRE(res.size() == 998);
+    }
+
+    SECTION("sorted results are evaluated in full") {
+        auto sorted = res.sort({{"id", false}});
+        sorted.set_evaluation_window(10);
+        REQUIRE(sorted.get(0).get<Int>(col_id) == 999);
+        REQUIRE(sorted.get_mode() == Results::Mode::TableView);
+    }
+}
+
+TEST_CASE("results: live aggregates", "[results][aggregate]") {
+    InMemoryTestFile config;
+    config.automatic_change_notifications = false;
+
+    auto r = Realm::get_shared_realm(config);
+    r->update_schema({{"object", {{"int", PropertyType::Int}, {"double", PropertyType::Double}}}});
+
+    auto table = r->read_group().get_table("class_object");
+    ColKey col_int = table->get_column_key("int");
+    ColKey col_double = table->get_column_key("double");
+    r->begin_transaction();
+    for (int i = 0; i < 10; ++i)
+        table->create_object().set_all(i, i * 1.5);
+    r->commit_transaction();
+
+    Results results(r, table->where().greater(col_int, 2));
+    results.track_aggregates(col_int);
+    results.track_aggregates("double");
+    auto token = results.add_notification_callback([](CollectionChangeSet) {});
+    advance_and_notify(*r);
+
+    auto check = [&] {
+        Results fresh(r, table->where().greater(col_int, 2));
+        REQUIRE(results.size() == fresh.size());
+        REQUIRE(results.sum(col_int) == fresh.sum(col_int));
+        REQUIRE(results.min(col_int) == fresh.min(col_int));
+        REQUIRE(results.max(col_int) == fresh.max(col_int));
+        REQUIRE(results.average(col_int) == fresh.average(col_int));
+        REQUIRE(results.sum(col_double) == fresh.sum(col_double));
+        REQUIRE(results.min(col_double) == fresh.min(col_double));
+        REQUIRE(results.max(col_double) == fresh.max(col_double));
+    };
+
+    SECTION("initial values") {
+        REQUIRE(results.sum(col_int) == Mixed(42));
+        REQUIRE(results.min(col_int) == Mixed(3));
+        REQUIRE(results.max(col_int) == Mixed(9));
+        REQUIRE(results.max(col_double) == Mixed(13.5));
+        check();
+    }
+
+    SECTION("insertions") {
+        r->begin_transaction();
+        table->create_object().set_all(20, 0.5);
+        table->create_object().set_all(1, 100.0);
+        r->commit_transaction();
+        advance_and_notify(*r);
+        REQUIRE(results.max(col_int) == Mixed(20));
+        REQUIRE(results.min(col_double) == Mixed(0.5));
+        check();
+    }
+
+    SECTION("modifications") {
+        r->begin_transaction();
+        table->get_object(5).set(col_double, -1.0);
+        table->get_object(6).set(col_int, 100);
+        r->commit_transaction();
+        advance_and_notify(*r);
+        REQUIRE(results.min(col_double) == Mixed(-1.0));
+        REQUIRE(results.max(col_int) == Mixed(100));
+        check();
+    }
+
+    SECTION("deleting the current max") {
+        r->begin_transaction();
+        table->get_object(9).remove();
+        r->commit_transaction();
+        advance_and_notify(*r);
+        REQUIRE(results.max(col_int) == Mixed(8));
+        REQUIRE(results.max(col_double) == Mixed(12.0));
+        check();
+    }
+
+    SECTION("objects leaving the query") {
+        r->begin_transaction();
+        for (int i = 3; i < 10; ++i)
+            table->get_object(i).set(col_int, 0);
+        r->commit_transaction();
+        advance_and_notify(*r);
+        REQUIRE(results.size() == 0);
+        REQUIRE(results.sum(col_int) == Mixed(0));
+        REQUIRE(!results.max(col_int));
+        REQUIRE(!results.average(col_double));
+    }
+
+    SECTION("values read inside a write transaction are not stale") {
+        r->begin_transaction();
+        table->get_object(9).set(col_int, 50);
+        REQUIRE(results.max(col_int) == Mixed(50));
+        r->cancel_transaction();
+    }
+
+}
+
+TEST_CASE("results: notifier stats", "[results][notifications]") {
+    InMemoryTestFile config;
+    config.automatic_change_notifications = false;
+    config.slow_notifier_threshold = std::chrono::hours(1);
+
+    auto r = Realm::get_shared_realm(config);
+    r->update_schema({{"object", {{"value", PropertyType::Int}}}});
+    auto table = r->read_group().get_table("class_object");
+    ColKey col = table->get_column_key("value");
+    r->begin_transaction();
+    for (int i = 0; i < 10; ++i)
+        table->create_object().set(col, i);
+    r->commit_transaction();
+
+    Results results(r, table->where().greater(col, 4));
+    int calls = 0;
+    auto token = results.add_notification_callback([&](CollectionChangeSet) {
+        ++calls;
+    });
+    advance_and_notify(*r);
+
+    r->begin_transaction();
+    table->create_object().set(col, 100);
+    r->commit_transaction();
+    advance_and_notify(*r);
+    REQUIRE(calls == 2);
+
+    auto stats = _impl::RealmCoordinator::get_coordinator(config.path)->get_notifier_stats();
+    REQUIRE(stats.size() == 1);
+    REQUIRE(stats[0].name == "ResultsNotifier");
+    REQUIRE(stats[0].description == "'object' where \"value > 4\"");
+    REQUIRE(stats[0].runs >= 2);
+    REQUIRE(stats[0].slow_runs == 0);
+    REQUIRE(stats[0].callbacks_delivered == 2);
+    REQUIRE(stats[0].max_run_time <= stats[0].run_time);
+    REQUIRE(stats[0].query_time + stats[0].change_calculation_time <= stats[0].run_time);
+}
+
 TEST_CASE("results: public name declared", "[results]") {
     InMemoryTestFile config;
     config.automatic_change_notifications = false;
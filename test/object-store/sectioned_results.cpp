@@ -1004,6 +1004,48 @@ TEST_CASE("sectioned results", "[sectioned results]") {
         REQUIRE_INDICES(changes.deletions[0], 0, 1, 2);
     }
 
+    SECTION("notifications with cached section keys") {
+        sectioned_results.set_cache_section_keys(true);
+        SectionedResultsChangeSet changes;
+        auto token = sectioned_results.add_notification_callback([&](SectionedResultsChangeSet c) {
+            changes = c;
+        });
+
+        coordinator->on_change();
+        r->begin_transaction();
+        REQUIRE(algo_run_count == 5); // Initial evaluation will be kicked off.
+        algo_run_count = 0;
+        table->create_object().set(name_col, "safari");
+        auto o2 = table->create_object().set(name_col, "cake");
+        r->commit_transaction();
+        advance_and_notify(*r);
+        // Only the inserted objects need their section key computed
+        REQUIRE(algo_run_count == 2);
+        REQUIRE_INDICES(changes.sections_to_insert, 2, 4);
+        REQUIRE(sectioned_results.size() == 5);
+
+        algo_run_count = 0;
+        // Move "apples" from section 'A' to 'C'
+        r->begin_transaction();
+        o5.set(name_col, "cherry");
+        r->commit_transaction();
+        advance_and_notify(*r);
+        REQUIRE(algo_run_count == 1);
+        REQUIRE(changes.sections_to_insert.empty());
+        REQUIRE(changes.sections_to_delete.empty());
+        REQUIRE(sectioned_results[0].size() == 2);
+        REQUIRE(sectioned_results[2].size() == 2);
+
+        algo_run_count = 0;
+        r->begin_transaction();
+        table->remove_object(o2.get_key());
+        r->commit_transaction();
+        advance_and_notify(*r);
+        REQUIRE(sectioned_results.size() == 5);
+        REQUIRE(sectioned_results[2].size() == 1);
+        REQUIRE(algo_run_count == 0);
+    }
+
     SECTION("notifications ascending / descending") {
         // Ascending
         SectionedResultsChangeSet changes;
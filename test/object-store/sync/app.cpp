@@ -5293,6 +5293,80 @@ TEST_CASE("app: refresh access token unit tests", "[sync][app][user][token]") {
         auto app = oas.app();
         REQUIRE(log_in(app));
     }
+
+    SECTION("concurrent requests share the location and refresh requests") {
+        // Holds back the responses to the location and session requests until released
+        static bool hold_requests = false;
+        static std::vector<std::pair<Request, util::UniqueFunction<void(const Response&)>>> held_requests;
+        static int location_requests = 0;
+        static int session_requests = 0;
+        hold_requests = false;
+        location_requests = 0;
+        session_requests = 0;
+
+        struct transport : UnitTestTransport {
+            void send_request_to_server(const Request& request,
+                                        util::UniqueFunction<void(const Response&)>&& completion) override
+            {
+                if (hold_requests && request.url.find("/location") != std::string::npos) {
+                    ++location_requests;
+                    held_requests.emplace_back(request, std::move(completion));
+                }
+                else if (hold_requests && request.url.find("/session") != std::string::npos) {
+                    ++session_requests;
+                    held_requests.emplace_back(request, std::move(completion));
+                }
+                else {
+                    UnitTestTransport::send_request_to_server(request, std::move(completion));
+                }
+            }
+
+            void release_held_requests()
+            {
+                auto requests = std::move(held_requests);
+                held_requests.clear();
+                for (auto& [request, completion] : requests) {
+                    if (request.url.find("/session") != std::string::npos) {
+                        nlohmann::json json{{"access_token", good_access_token}};
+                        completion({200, 0, {}, json.dump()});
+                    }
+                    else {
+                        UnitTestTransport::send_request_to_server(request, std::move(completion));
+                    }
+                }
+            }
+        };
+        auto transport_ptr = std::make_shared<transport>();
+        OfflineAppSession oas(OfflineAppSession::Config{transport_ptr});
+        auto app = oas.app();
+        auto user = oas.make_user();
+        hold_requests = true;
+
+        int processed = 0;
+        auto completion = [&](const Optional<AppError>& error) {
+            REQUIRE_FALSE(error);
+            ++processed;
+        };
+        // Requests the location again, and is not shared with the refreshes which do not
+        app->refresh_custom_data(user, true, completion);
+        app->refresh_custom_data(user, completion);
+        app->refresh_custom_data(user, completion);
+        app->call_function(user, "function", {}, [&](auto&&, const Optional<AppError>&) {
+            ++processed;
+        });
+        CHECK(location_requests == 1);
+        CHECK(session_requests == 0);
+
+        // All of them wait for the single location request
+        transport_ptr->release_held_requests();
+        CHECK(location_requests == 1);
+        CHECK(session_requests == 2);
+        CHECK(processed == 1);
+
+        transport_ptr->release_held_requests();
+        CHECK(session_requests == 2);
+        CHECK(processed == 4);
+    }
 }
 
 TEST_CASE("app: app released during async operation", "[app][user]") {
@@ -2583,7 +2583,7 @@ TEST_CASE("flx: writes work without waiting for sync", "[sync][flx][baas]") {
 TEST_CASE("flx: verify websocket protocol number and prefixes", "[sync][protocol]") {
     // Update the expected value whenever the protocol version is updated - this ensures
     // that the current protocol version does not change unexpectedly.
-    REQUIRE(12 == sync::get_current_protocol_version());
+    REQUIRE(13 == sync::get_current_protocol_version());
     // This was updated in Protocol V8 to use '#' instead of '/' to support the Web SDK
     REQUIRE("com.mongodb.realm-sync#" == sync::get_pbs_websocket_protocol_prefix());
     REQUIRE("com.mongodb.realm-query-sync#" == sync::get_flx_websocket_protocol_prefix());
@@ -4442,6 +4442,33 @@ TEST_CASE("flx: open realm + register subscription callback while bootstrapping"
             }
         }
 
+        SECTION("Initial async open completing on the first bootstrap batch") {
+            ThreadSafeReference opened_realm;
+            auto open_realm_pf = util::make_promise_future<bool>();
+            auto open_realm_completed_callback =
+                [&, promise_holder = util::CopyablePromiseHolder(std::move(open_realm_pf.promise))](
+                    ThreadSafeReference ref, std::exception_ptr err) mutable {
+                    opened_realm = std::move(ref);
+                    promise_holder.get_promise().emplace_value(!err);
+                };
+
+            config.sync_config->subscription_initializer = init_subscription_callback_with_promise;
+            config.sync_config->async_open_complete_on_first_bootstrap_batch = true;
+            auto async_open = Realm::get_synchronized_realm(config);
+            async_open->start(open_realm_completed_callback);
+            REQUIRE(open_realm_pf.future.get());
+            REQUIRE(subscription_pf.future.get());
+
+            // The rest of the data arrives after the Realm has been handed back
+            auto realm = Realm::get_shared_realm(std::move(opened_realm));
+            auto sub_set = realm->get_latest_subscription_set();
+            REQUIRE(sub_set.version() == 1);
+            REQUIRE(sub_set.state() != realm::sync::SubscriptionSet::State::Pending);
+            sub_set.get_state_change_notification(realm::sync::SubscriptionSet::State::Complete).get();
+            realm->refresh();
+            REQUIRE(verify_subscription(realm));
+        }
+
         SECTION("rerun on open set for multiple async open tasks (subscription runs only once)") {
             auto init_subscription = [](std::shared_ptr<Realm> realm) mutable {
                 REQUIRE(realm);
@@ -472,6 +472,47 @@ TEST_CASE("thread safe reference") {
             REQUIRE(results.get(1).get<StringData>(col) == "B");
         }
 
+        SECTION("evaluated object results") {
+            auto& table = *get_table(*r, "int object");
+            auto col = table.get_column_key("value");
+            r->begin_transaction();
+            for (int64_t i = 0; i < 10; ++i)
+                create_object(r, "int object", {{"value", i}});
+            r->commit_transaction();
+
+            auto results = Results(r, table.where().greater(col, 4)).sort({{{col}}, {false}});
+            REQUIRE(results.get(0).get<Int>(col) == 9);
+            REQUIRE(results.get_mode() == Results::Mode::TableView);
+            auto ref = ThreadSafeReference(results);
+
+            SECTION("are handed over without rerunning the query at the same version") {
+                SharedRealm r2 = Realm::get_shared_realm(config);
+                Results resolved = ref.resolve<Results>(r2);
+                REQUIRE(resolved.get_mode() == Results::Mode::TableView);
+                REQUIRE(resolved.size() == 5);
+                REQUIRE(resolved.get(0).get<Int>(col) == 9);
+                REQUIRE(resolved.get(4).get<Int>(col) == 5);
+
+                r2->begin_transaction();
+                resolved.get(0).remove();
+                r2->commit_transaction();
+                REQUIRE(resolved.size() == 4);
+                REQUIRE(resolved.get(0).get<Int>(col) == 8);
+            }
+
+            SECTION("rerun the query at a different version") {
+                SharedRealm r2 = Realm::get_shared_realm(config);
+                r2->begin_transaction();
+                create_object(r2, "int object", {{"value", INT64_C(20)}});
+                r2->commit_transaction();
+
+                Results resolved = ref.resolve<Results>(r2);
+                REQUIRE(resolved.get_mode() == Results::Mode::Query);
+                REQUIRE(resolved.size() == 6);
+                REQUIRE(resolved.get(0).get<Int>(col) == 20);
+            }
+        }
+
         SECTION("distinct object results") {
             auto& table = *get_table(*r, "string object");
             auto col = table.get_column_key("value");
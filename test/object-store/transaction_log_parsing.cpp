@@ -329,6 +329,22 @@ TEST_CASE("Transaction log parsing: changeset calcuation") {
             REQUIRE(info.tables[table_key].modifications_contains(ObjKey(1), {}));
         }
 
+        SECTION("modified columns are summarized per table") {
+            auto info = track_changes({table_key}, [&] {
+                table.get_object(objects[1]).set(cols[1], 2);
+                table.get_object(objects[2]).set(cols[1], 3);
+            });
+            auto& changes = info.tables[table_key];
+            REQUIRE(changes.any_modifications_in({cols[1]}));
+            REQUIRE(changes.any_modifications_in({cols[0], cols[1]}));
+            REQUIRE_FALSE(changes.any_modifications_in({cols[0]}));
+            REQUIRE(changes.modifications_contains(ObjKey(1), {cols[1]}));
+            REQUIRE_FALSE(changes.modifications_contains(ObjKey(1), {cols[0]}));
+            REQUIRE(changes.modifications_contains_column(ObjKey(2), cols[1]));
+            REQUIRE_FALSE(changes.modifications_contains_column(ObjKey(2), cols[0]));
+            REQUIRE_FALSE(changes.modifications_contains_column(ObjKey(3), cols[1]));
+        }
+
         SECTION("modifications to untracked tables are ignored") {
             auto info = track_changes({}, [&] {
                 table.get_object(objects[1]).set(cols[1], 2);
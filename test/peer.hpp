@@ -230,6 +230,8 @@ public:
         m_disable_compaction = b;
     }
 
+    void set_transform_threads(size_t num_threads);
+
     std::map<TableKey, std::unordered_map<GlobalKey, ObjKey>> m_optimistic_object_id_collisions;
 
     ShortCircuitHistory(file_ident_type local_file_ident, TestDirNameGenerator* changeset_dump_dir_gen);
@@ -453,6 +455,11 @@ inline ShortCircuitHistory::ShortCircuitHistory(file_ident_type local_file_ident
 {
 }
 
+inline void ShortCircuitHistory::set_transform_threads(size_t num_threads)
+{
+    m_transformer->set_max_threads(num_threads);
+}
+
 inline auto ShortCircuitHistory::integrate_remote_changesets(file_ident_type remote_file_ident, DB& sg,
                                                              const RemoteChangeset* incoming_changesets,
                                                              size_t num_changesets, util::Logger& logger)
@@ -425,6 +425,12 @@ public:
 
         long server_max_open_files = 64;
 
+        std::size_t server_num_integration_workers = 1;
+        std::size_t server_shared_download_cache_max_size = 0;
+        std::uint_fast64_t server_max_open_files_size = 0;
+        bool server_prefetch_files_on_bind = false;
+        milliseconds_type server_bootstrap_snapshot_interval = 0;
+
         bool enable_server_ssl = false;
 
         std::string server_ssl_certificate_path = get_test_resource_path() + "test_sync_ca.pem";
@@ -448,6 +454,12 @@ public:
 
         bool disable_upload_activation_delay = false;
 
+        size_t client_integration_worker_threads = 0;
+
+        size_t client_max_batched_messages = 1;
+
+        std::function<SessionTelemetryHandler> client_session_telemetry_handler;
+
         ClusterTopology cluster_topology = ClusterTopology::separate_nodes;
 
         std::string authorization_header_name = "Authorization";
@@ -516,6 +528,11 @@ public:
                 public_key = PKey::load_public(config.server_public_key_path);
             Server::Config config_2;
             config_2.max_open_files = config.server_max_open_files;
+            config_2.num_integration_workers = config.server_num_integration_workers;
+            config_2.shared_download_cache_max_size = config.server_shared_download_cache_max_size;
+            config_2.max_open_files_size = config.server_max_open_files_size;
+            config_2.prefetch_files_on_bind = config.server_prefetch_files_on_bind;
+            config_2.bootstrap_snapshot_interval = config.server_bootstrap_snapshot_interval;
             config_2.logger = m_server_loggers[i];
             config_2.token_expiration_clock = &m_fake_token_expiration_clock;
             config_2.ssl = m_enable_server_ssl;
@@ -550,6 +567,9 @@ public:
             config_2.disable_upload_compaction = config.disable_upload_compaction;
             config_2.one_connection_per_session = config.one_connection_per_session;
             config_2.disable_upload_activation_delay = config.disable_upload_activation_delay;
+            config_2.integration_worker_threads = config.client_integration_worker_threads;
+            config_2.max_batched_messages = config.client_max_batched_messages;
+            config_2.session_telemetry_handler = config.client_session_telemetry_handler;
             config_2.fix_up_object_ids = true;
             m_clients[i] = std::make_unique<Client>(std::move(config_2));
         }
@@ -134,6 +134,54 @@ TEST(Alloc_1)
 }
 
 
+TEST(Alloc_SmallBlockReuse)
+{
+    SlabAlloc alloc;
+    alloc.attach_empty();
+
+    std::vector<MemRef> refs;
+    for (size_t size : {8, 40, 64, 200, 1000, 1024}) {
+        MemRef mr = alloc.alloc(size);
+        set_capacity(mr.get_addr(), size);
+        refs.push_back(mr);
+    }
+    for (auto& mr : refs)
+        alloc.free_(mr.get_ref(), mr.get_addr());
+    auto counters = alloc.get_counters();
+    CHECK_EQUAL(counters.allocs, 6);
+    CHECK_EQUAL(counters.frees, 6);
+    CHECK_EQUAL(counters.small_block_hits, 0);
+    CHECK_EQUAL(counters.small_block_parks, 6);
+    CHECK_EQUAL(counters.merges, 0);
+    alloc.verify();
+
+    // Blocks of the same size class are handed out again, most recently freed first
+    MemRef mr = alloc.alloc(48);
+    CHECK_EQUAL(mr.get_ref(), refs[2].get_ref());
+    set_capacity(mr.get_addr(), 48);
+    MemRef mr2 = alloc.alloc(40);
+    CHECK_EQUAL(mr2.get_ref(), refs[1].get_ref());
+    set_capacity(mr2.get_addr(), 40);
+    CHECK_EQUAL(alloc.get_counters().small_block_hits, 2);
+    alloc.free_(mr.get_ref(), mr.get_addr());
+    alloc.free_(mr2.get_ref(), mr2.get_addr());
+
+    // A large allocation which does not fit in the remaining free space merges
+    // the blocks kept for reuse rather than growing the slab area
+    uint64_t slabs = alloc.get_counters().slab_grows;
+    CHECK_EQUAL(slabs, 1);
+    MemRef large = alloc.alloc(0x20000 - 64);
+    set_capacity(large.get_addr(), 0x20000 - 64);
+    CHECK_EQUAL(alloc.get_counters().slab_grows, slabs);
+    CHECK_GREATER(alloc.get_counters().merges, 0);
+    alloc.free_(large.get_ref(), large.get_addr());
+    alloc.verify();
+
+    alloc.reset_counters();
+    CHECK_EQUAL(alloc.get_counters().allocs, 0);
+}
+
+
 TEST(Alloc_AttachFile)
 {
     GROUP_TEST_PATH(path);
@@ -1014,6 +1014,58 @@ TEST(Array_find_sse)
 }
 
 
+namespace {
+
+template <class Cond>
+void check_find_all_matches(TestContext& test_context, const Array& a, const std::vector<int64_t>& values,
+                            int64_t needle, size_t begin)
+{
+    Cond c;
+    size_t pos = begin;
+    for (size_t i = begin; i < values.size(); ++i) {
+        if (c(values[i], needle)) {
+            size_t t = a.find_first<Cond>(needle, pos, a.size());
+            CHECK_EQUAL(i, t);
+            pos = i + 1;
+        }
+    }
+    if (pos <= a.size())
+        CHECK_EQUAL(realm::not_found, a.find_first<Cond>(needle, pos, a.size()));
+}
+
+} // anonymous namespace
+
+// Exercise the vectorized (SSE/AVX2/NEON) finders on every byte-multiple width, with start offsets that are not
+// aligned to a vector boundary
+TEST(Array_FindVectorizedAllWidths)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    const int64_t magnitudes[] = {100, 30000, 2000000000, 8000000000LL};
+
+    for (int64_t magnitude : magnitudes) {
+        Array a(Allocator::get_default());
+        a.create(Array::type_Normal);
+        std::vector<int64_t> values;
+        for (size_t i = 0; i < 300; ++i) {
+            int64_t v = random.draw_int_mod(5) - 2;
+            if (random.draw_int_mod(4) == 0)
+                v = (v < 0 ? -magnitude : magnitude);
+            values.push_back(v);
+            a.add(v);
+        }
+
+        for (size_t begin : {size_t(0), size_t(1), size_t(3), size_t(7), size_t(13)}) {
+            for (int64_t needle : {int64_t(-2), int64_t(0), int64_t(1), magnitude}) {
+                check_find_all_matches<Equal>(test_context, a, values, needle, begin);
+                check_find_all_matches<NotEqual>(test_context, a, values, needle, begin);
+                check_find_all_matches<Greater>(test_context, a, values, needle, begin);
+                check_find_all_matches<Less>(test_context, a, values, needle, begin);
+            }
+        }
+        a.destroy();
+    }
+}
+
 TEST(Array_Greater)
 {
     Array a(Allocator::get_default());
@@ -222,6 +222,127 @@ TEST(ArrayIntNull_Find)
     a.destroy();
 }
 
+TEST(ArrayIntNull_NullKeepsWidth)
+{
+    ArrayIntNull a(Allocator::get_default());
+    a.create();
+
+    // A counter reaching the top of the range of its width moves the null
+    // value rather than widening the array
+    a.add(util::none);
+    for (int64_t i = 0; i < 128; ++i)
+        a.add(i);
+    CHECK_EQUAL(a.get_width(), 8);
+    CHECK(a.is_null(0));
+    for (int64_t i = 0; i < 128; ++i)
+        CHECK_EQUAL(a.get(size_t(i + 1)), i);
+
+    // Adding the value used for null picks another free value of the width
+    for (int64_t i = -100; i < 0; ++i)
+        a.add(i);
+    int64_t null = a.null_value();
+    a.add(null);
+    CHECK_EQUAL(a.get_width(), 8);
+    CHECK_NOT_EQUAL(a.null_value(), null);
+    CHECK(a.is_null(0));
+    CHECK_EQUAL(a.back(), null);
+    for (int64_t i = 0; i < 128; ++i)
+        CHECK_EQUAL(a.get(size_t(i + 1)), i);
+
+    a.destroy();
+}
+
+TEST(ArrayIntNull_FindConditions)
+{
+    ArrayIntNull a(Allocator::get_default());
+    a.create();
+
+    std::vector<util::Optional<int64_t>> values;
+    for (int64_t i = 0; i < 200; ++i) {
+        util::Optional<int64_t> v;
+        if (i % 5 != 2)
+            v = (i * 37) % 101 - 20;
+        values.push_back(v);
+        a.add(v);
+    }
+
+    auto check = [&](auto cond, util::Optional<int64_t> value) {
+        size_t start = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            bool expected = cond(values[i].value_or(0), value.value_or(0), !values[i], !value);
+            if (!expected)
+                continue;
+            CHECK_EQUAL(a.find_first<decltype(cond)>(value, start), i);
+            start = i + 1;
+        }
+        CHECK_EQUAL(a.find_first<decltype(cond)>(value, start), not_found);
+    };
+    // The null value is the upper bound of the width of the array, so it
+    // compares greater than all the values
+    for (int64_t value : {-30, -20, 0, 40, 80, 127, 200}) {
+        check(Greater(), value);
+        check(Less(), value);
+        check(NotEqual(), value);
+    }
+    check(Greater(), util::none);
+    check(Less(), util::none);
+    check(NotEqual(), util::none);
+    check(NotEqual(), a.null_value());
+    check(NotNull(), util::none);
+
+    a.destroy();
+}
+
+TEST(ArrayIntNull_SumMinMax)
+{
+    ArrayIntNull a(Allocator::get_default());
+    a.create();
+
+    size_t count = npos;
+    int64_t v;
+    size_t ndx = npos;
+    CHECK_EQUAL(a.sum(0, npos, count), 0);
+    CHECK_EQUAL(count, 0);
+    CHECK_NOT(a.minmax<false>(0, npos, &v, &ndx));
+
+    int64_t expected_sum = 0;
+    for (int64_t i = 0; i < 300; ++i) {
+        if (i % 7 == 3) {
+            a.add(util::none);
+        }
+        else {
+            a.add(i * 1000 - 150000);
+            expected_sum += i * 1000 - 150000;
+        }
+    }
+    CHECK_EQUAL(a.sum(0, npos, count), expected_sum);
+    CHECK_EQUAL(count, 300 - 43);
+
+    CHECK(a.minmax<false>(0, npos, &v, &ndx));
+    CHECK_EQUAL(v, -150000);
+    CHECK_EQUAL(ndx, 0);
+    CHECK(a.minmax<true>(0, npos, &v, &ndx));
+    CHECK_EQUAL(v, 299000 - 150000);
+    CHECK_EQUAL(ndx, 299);
+
+    // Ranges starting and ending on nulls
+    CHECK_EQUAL(a.sum(3, 4, count), 0);
+    CHECK_EQUAL(count, 0);
+    CHECK_NOT(a.minmax<true>(3, 4, &v, &ndx));
+    CHECK(a.minmax<false>(3, 11, &v, &ndx));
+    CHECK_EQUAL(v, 4000 - 150000);
+    CHECK_EQUAL(ndx, 4);
+
+    // Ties resolve to the first occurrence
+    a.set(100, 1000000);
+    a.set(200, 1000000);
+    CHECK(a.minmax<true>(0, npos, &v, &ndx));
+    CHECK_EQUAL(v, 1000000);
+    CHECK_EQUAL(ndx, 100);
+
+    a.destroy();
+}
+
 TEST(ArrayRef_Basic)
 {
     ArrayRef a(Allocator::get_default());
@@ -0,0 +1,317 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_ARROW_EXPORT
+
+#include <cstring>
+#include <string>
+
+#include <realm.hpp>
+#include <realm/arrow_export.hpp>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::test_util;
+using unit_test::TestContext;
+
+namespace {
+
+bool arrow_is_null(const ArrowArray& array, size_t ndx)
+{
+    auto validity = static_cast<const uint8_t*>(array.buffers[0]);
+    return validity && !(validity[ndx / 8] & (1 << (ndx % 8)));
+}
+
+template <class T>
+T arrow_value(const ArrowArray& array, size_t ndx)
+{
+    return static_cast<const T*>(array.buffers[1])[array.offset + ndx];
+}
+
+bool arrow_bool(const ArrowArray& array, size_t ndx)
+{
+    ndx += size_t(array.offset);
+    return static_cast<const uint8_t*>(array.buffers[1])[ndx / 8] & (1 << (ndx % 8));
+}
+
+std::string arrow_string(const ArrowArray& array, size_t ndx)
+{
+    auto offsets = static_cast<const int64_t*>(array.buffers[1]);
+    auto data = static_cast<const char*>(array.buffers[2]);
+    return std::string(data + offsets[ndx], size_t(offsets[ndx + 1] - offsets[ndx]));
+}
+
+struct ArrowTable {
+    ColKey col_int, col_int_null, col_bool, col_bool_null, col_float, col_double_null, col_date, col_string, col_binary,
+        col_oid, col_uuid_null, col_list, col_decimal;
+};
+
+ArrowTable fill_table(Transaction& tr, size_t num_objects)
+{
+    auto t = tr.add_table("table");
+    ArrowTable cols;
+    cols.col_int = t->add_column(type_Int, "int");
+    cols.col_int_null = t->add_column(type_Int, "int?", true);
+    cols.col_bool = t->add_column(type_Bool, "bool");
+    cols.col_bool_null = t->add_column(type_Bool, "bool?", true);
+    cols.col_float = t->add_column(type_Float, "float");
+    cols.col_double_null = t->add_column(type_Double, "double?", true);
+    cols.col_date = t->add_column(type_Timestamp, "date");
+    cols.col_string = t->add_column(type_String, "string", true);
+    cols.col_binary = t->add_column(type_Binary, "binary");
+    cols.col_oid = t->add_column(type_ObjectId, "oid");
+    cols.col_uuid_null = t->add_column(type_UUID, "uuid?", true);
+    cols.col_list = t->add_column_list(type_Int, "list");
+    cols.col_decimal = t->add_column(type_Decimal, "decimal");
+    for (size_t i = 0; i < num_objects; ++i) {
+        auto obj = t->create_object();
+        int64_t v = int64_t(i);
+        // Large values make the integer leaves 64 bit wide
+        obj.set(cols.col_int, v * 0x100000001);
+        if (i % 3)
+            obj.set(cols.col_int_null, -v);
+        obj.set(cols.col_bool, i % 2 == 0);
+        if (i % 5)
+            obj.set(cols.col_bool_null, i % 4 == 0);
+        obj.set(cols.col_float, float(i) / 2);
+        if (i % 7)
+            obj.set(cols.col_double_null, double(i) * 1.5);
+        obj.set(cols.col_date, Timestamp(v, int32_t(i % 1000)));
+        if (i % 11)
+            obj.set(cols.col_string, std::string(i % 20, 'a' + char(i % 26)));
+        std::string bin(i % 10, char(i));
+        obj.set(cols.col_binary, BinaryData(bin.data(), bin.size()));
+        obj.set(cols.col_oid, ObjectId(Timestamp(v, 0), int(i), 0));
+        if (i % 13)
+            obj.set(cols.col_uuid_null, UUID(util::format("%1-0000-0000-0000-000000000000", 10000000 + i)));
+    }
+    return cols;
+}
+
+// Check that row `ndx` of `batch` has the values of `obj`
+void check_row(TestContext& test_context, const ArrowTable& cols, const ArrowArray& batch, size_t ndx, const Obj& obj)
+{
+    REALM_ASSERT(batch.n_children == 11);
+    auto& a = *batch.children[0];
+    CHECK_EQUAL(arrow_value<int64_t>(a, ndx), obj.get<Int>(cols.col_int));
+
+    auto& b = *batch.children[1];
+    auto int_null = obj.get<util::Optional<Int>>(cols.col_int_null);
+    CHECK_EQUAL(arrow_is_null(b, ndx), !int_null);
+    if (int_null)
+        CHECK_EQUAL(arrow_value<int64_t>(b, ndx), *int_null);
+
+    CHECK_EQUAL(arrow_bool(*batch.children[2], ndx), obj.get<Bool>(cols.col_bool));
+
+    auto& d = *batch.children[3];
+    auto bool_null = obj.get<util::Optional<Bool>>(cols.col_bool_null);
+    CHECK_EQUAL(arrow_is_null(d, ndx), !bool_null);
+    if (bool_null)
+        CHECK_EQUAL(arrow_bool(d, ndx), *bool_null);
+
+    CHECK_EQUAL(arrow_value<float>(*batch.children[4], ndx), obj.get<Float>(cols.col_float));
+
+    auto& f = *batch.children[5];
+    auto double_null = obj.get<util::Optional<Double>>(cols.col_double_null);
+    CHECK_EQUAL(arrow_is_null(f, ndx), !double_null);
+    if (double_null)
+        CHECK_EQUAL(arrow_value<double>(f, ndx), *double_null);
+
+    Timestamp ts = obj.get<Timestamp>(cols.col_date);
+    CHECK_EQUAL(arrow_value<int64_t>(*batch.children[6], ndx),
+                ts.get_seconds() * 1000000000 + ts.get_nanoseconds());
+
+    auto& h = *batch.children[7];
+    StringData str = obj.get<String>(cols.col_string);
+    CHECK_EQUAL(arrow_is_null(h, ndx), str.is_null());
+    CHECK_EQUAL(arrow_string(h, ndx), std::string(str));
+
+    BinaryData bin = obj.get<Binary>(cols.col_binary);
+    CHECK_EQUAL(arrow_string(*batch.children[8], ndx), std::string(bin.data(), bin.size()));
+
+    auto oid = obj.get<ObjectId>(cols.col_oid).to_bytes();
+    CHECK_EQUAL(memcmp(static_cast<const char*>(batch.children[9]->buffers[1]) + ndx * 12, oid.data(), 12), 0);
+
+    auto& k = *batch.children[10];
+    auto uuid = obj.get<util::Optional<UUID>>(cols.col_uuid_null);
+    CHECK_EQUAL(arrow_is_null(k, ndx), !uuid);
+    if (uuid) {
+        auto bytes = uuid->to_bytes();
+        CHECK_EQUAL(memcmp(static_cast<const char*>(k.buffers[1]) + ndx * 16, bytes.data(), 16), 0);
+    }
+}
+
+} // anonymous namespace
+
+TEST_TYPES(ArrowExport_Table, std::true_type, std::false_type)
+{
+    constexpr bool encrypt = TEST_TYPE::value;
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path, DBOptions(encrypt ? crypt_key(true) : nullptr));
+    size_t num_objects = 2500;
+    ArrowTable cols;
+    {
+        auto tr = db->start_write();
+        cols = fill_table(*tr, num_objects);
+        tr->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("table");
+    auto exporter = std::make_unique<ArrowExporter>(rt, table);
+    // Lists and decimals are not exported
+    CHECK_EQUAL(exporter->get_columns().size(), 11);
+    CHECK_NOT(ArrowExporter::type_supported(cols.col_list));
+    CHECK_NOT(ArrowExporter::type_supported(cols.col_decimal));
+    CHECK_THROW(ArrowExporter(rt, table, {cols.col_decimal}), IllegalOperation);
+
+    ArrowSchema schema;
+    exporter->get_schema(&schema);
+    CHECK_EQUAL(std::string(schema.format), "+s");
+    CHECK_EQUAL(schema.n_children, 11);
+    const char* formats[] = {"l", "l", "b", "b", "f", "g", "tsn:", "U", "Z", "w:12", "w:16"};
+    for (int64_t i = 0; i < schema.n_children; ++i) {
+        CHECK_EQUAL(std::string(schema.children[i]->format), formats[i]);
+        CHECK_EQUAL(StringData(schema.children[i]->name), table->get_column_name(exporter->get_columns()[i]));
+    }
+    CHECK_EQUAL(schema.children[0]->flags, 0);
+    CHECK_EQUAL(schema.children[1]->flags, ARROW_FLAG_NULLABLE);
+    schema.release(&schema);
+    CHECK(schema.release == nullptr);
+
+    std::vector<ArrowArray> batches;
+    ArrowArray batch;
+    while (exporter->get_next(&batch))
+        batches.push_back(batch);
+    CHECK(batch.release == nullptr);
+    CHECK_EQUAL(batches.size(), exporter->get_num_batches());
+    CHECK_GREATER(batches.size(), 1);
+
+    // The batches reference the snapshot, which outlives the exporter and
+    // changes made to the table later
+    exporter.reset();
+    {
+        auto tr = db->start_write();
+        auto t = tr->get_table("table");
+        for (auto obj : *t)
+            obj.set(cols.col_int, 0);
+        t->create_object();
+        tr->commit();
+    }
+
+    auto it = table->begin();
+    size_t total = 0;
+    for (auto& b : batches) {
+        CHECK_EQUAL(b.n_buffers, 1);
+        for (size_t i = 0; i < size_t(b.length); ++i, ++it)
+            check_row(test_context, cols, b, i, *it);
+        total += size_t(b.length);
+        b.release(&b);
+        CHECK(b.release == nullptr);
+    }
+    CHECK_EQUAL(total, num_objects);
+}
+
+TEST(ArrowExport_TableView)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path);
+    ArrowTable cols;
+    {
+        auto tr = db->start_write();
+        cols = fill_table(*tr, 1000);
+        tr->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("table");
+    auto tv = table->where().greater(cols.col_float, 100.f).find_all();
+    tv.sort(cols.col_double_null, false);
+    ArrowExporter exporter(rt, tv, {cols.col_string, cols.col_double_null}, 100);
+    CHECK_EQUAL(exporter.get_num_batches(), (tv.size() + 99) / 100);
+
+    ArrowSchema schema;
+    exporter.get_schema(&schema);
+    CHECK_EQUAL(schema.n_children, 2);
+    CHECK_EQUAL(std::string(schema.children[0]->name), "string");
+    schema.release(&schema);
+
+    size_t ndx = 0;
+    ArrowArray batch;
+    while (exporter.get_next(&batch)) {
+        CHECK_LESS_EQUAL(batch.length, 100);
+        auto& strings = *batch.children[0];
+        auto& doubles = *batch.children[1];
+        for (size_t i = 0; i < size_t(batch.length); ++i, ++ndx) {
+            auto obj = tv.get_object(ndx);
+            StringData str = obj.get<String>(cols.col_string);
+            CHECK_EQUAL(arrow_is_null(strings, i), str.is_null());
+            CHECK_EQUAL(arrow_string(strings, i), std::string(str));
+            auto d = obj.get<util::Optional<Double>>(cols.col_double_null);
+            CHECK_EQUAL(arrow_is_null(doubles, i), !d);
+            if (d)
+                CHECK_EQUAL(arrow_value<double>(doubles, i), *d);
+        }
+        batch.release(&batch);
+    }
+    CHECK_EQUAL(ndx, tv.size());
+}
+
+TEST(ArrowExport_Stream)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path);
+    ArrowTable cols;
+    {
+        auto tr = db->start_write();
+        cols = fill_table(*tr, 1500);
+        tr->commit();
+    }
+
+    auto rt = db->start_read();
+    ArrowArrayStream stream;
+    ArrowExporter::export_stream(std::make_unique<ArrowExporter>(rt, rt->get_table("table")), &stream);
+    // The stream keeps the snapshot alive
+    rt.reset();
+
+    ArrowSchema schema;
+    CHECK_EQUAL(stream.get_schema(&stream, &schema), 0);
+    CHECK_EQUAL(schema.n_children, 11);
+    schema.release(&schema);
+
+    size_t total = 0;
+    while (true) {
+        ArrowArray batch;
+        CHECK_EQUAL(stream.get_next(&stream, &batch), 0);
+        if (!batch.release)
+            break;
+        total += size_t(batch.length);
+        batch.release(&batch);
+    }
+    CHECK_EQUAL(total, 1500);
+    CHECK(stream.get_last_error(&stream) == nullptr);
+    stream.release(&stream);
+    CHECK(stream.release == nullptr);
+}
+
+#endif // TEST_ARROW_EXPORT
@@ -431,6 +431,76 @@ TEST(BPlusTree_LeafCache)
     tree.destroy();
 }
 
+TEST(BPlusTree_Append)
+{
+    auto check_append = [&](BPlusTree<Int>& tree, size_t num_values) {
+        std::vector<Int> expected = tree.get_all();
+        std::vector<Int> values;
+        for (size_t i = 0; i < num_values; i++) {
+            values.push_back(Int(expected.size() + i));
+        }
+        tree.append(values);
+        expected.insert(expected.end(), values.begin(), values.end());
+
+        CHECK_EQUAL(tree.size(), expected.size());
+        tree.verify();
+        CHECK(tree.get_all() == expected);
+        for (size_t i = 0; i < expected.size(); i++) {
+            if (tree.get(i) != expected[i]) {
+                CHECK_EQUAL(tree.get(i), expected[i]);
+                break;
+            }
+        }
+    };
+
+    // Compact tree, built by appending only
+    {
+        BPlusTree<Int> tree(Allocator::get_default());
+        tree.create();
+        check_append(tree, 0);
+        check_append(tree, 5);
+        check_append(tree, 3 * REALM_MAX_BPNODE_SIZE);
+        check_append(tree, 1);
+        tree.add(-1);
+        check_append(tree, REALM_MAX_BPNODE_SIZE * REALM_MAX_BPNODE_SIZE + 17);
+        tree.insert(7, -2);
+        tree.erase(REALM_MAX_BPNODE_SIZE + 3);
+        check_append(tree, 2 * REALM_MAX_BPNODE_SIZE);
+        tree.destroy();
+    }
+
+    // General form, where the leaves are not all full
+    {
+        BPlusTree<Int> tree(Allocator::get_default());
+        tree.create();
+        for (int i = 0; i < 3 * REALM_MAX_BPNODE_SIZE; i++) {
+            tree.insert(0, -i);
+        }
+        check_append(tree, 7);
+        check_append(tree, 5 * REALM_MAX_BPNODE_SIZE + 3);
+        tree.destroy();
+    }
+
+    // Strings
+    {
+        BPlusTree<String> tree(Allocator::get_default());
+        tree.create();
+        tree.add("a");
+        std::vector<std::string> strings;
+        for (int i = 0; i < 2 * REALM_MAX_BPNODE_SIZE + 5; i++) {
+            strings.push_back(std::string(i % 100, 'x'));
+        }
+        tree.append(std::vector<StringData>(strings.begin(), strings.end()));
+        CHECK_EQUAL(tree.size(), strings.size() + 1);
+        tree.verify();
+        CHECK_EQUAL(tree.get(0), "a");
+        for (size_t i = 0; i < strings.size(); i++) {
+            CHECK_EQUAL(tree.get(i + 1), strings[i]);
+        }
+        tree.destroy();
+    }
+}
+
 TEST(BPlusTree_UpgradeFromArray)
 {
     // This test is only effective when node size is 4
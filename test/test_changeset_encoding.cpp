@@ -298,6 +298,55 @@ TEST(ChangesetEncoding_AccentWords)
     CHECK_NOTHROW(parse_changeset(stream, parsed));
 }
 
+TEST(ChangesetEncoding_Append)
+{
+    Changeset changeset;
+    {
+        CreateObject create;
+        create.table = changeset.intern_string("Foo");
+        create.object = changeset.intern_string("abc");
+        changeset.push_back(create);
+        sync::instr::Update update;
+        update.table = changeset.intern_string("Foo");
+        update.object = changeset.intern_string("abc");
+        update.field = changeset.intern_string("name");
+        update.value = Payload{changeset.append_string("hello")};
+        changeset.push_back(update);
+    }
+
+    Changeset other;
+    {
+        sync::instr::Update update;
+        update.table = other.intern_string("Bar");
+        update.object = PrimaryKey{1};
+        update.field = other.intern_string("link");
+        update.value = Payload{Payload::Link{other.intern_string("Foo"), other.intern_string("abc")}};
+        other.push_back(update);
+        update.field = other.intern_string("name");
+        update.value = Payload{other.append_string("world")};
+        other.push_back(update);
+    }
+
+    changeset.append(other);
+    CHECK_EQUAL(changeset.size(), 4);
+    // Strings already interned in the changeset are reused
+    CHECK_EQUAL(changeset.interned_strings().size(), 5);
+
+    auto parsed = encode_then_parse(changeset);
+    CHECK_EQUAL(changeset, parsed);
+    auto it = parsed.begin();
+    std::advance(it, 2);
+    auto& link = (*it)->get_as<sync::instr::Update>();
+    CHECK_EQUAL(parsed.get_string(link.table), "Bar");
+    CHECK_EQUAL(parsed.get_string(link.field), "link");
+    CHECK_EQUAL(parsed.get_string(link.value.data.link.target_table), "Foo");
+    CHECK_EQUAL(parsed.get_string(mpark::get<sync::InternString>(link.value.data.link.target)), "abc");
+    ++it;
+    auto& name = (*it)->get_as<sync::instr::Update>();
+    CHECK_EQUAL(parsed.get_string(name.field), "name");
+    CHECK_EQUAL(parsed.get_string(name.value.data.str), "world");
+}
+
 void encode_instruction(util::AppendBuffer<char>& buffer, char instr)
 {
     buffer.append(&instr, 1);
@@ -326,6 +375,46 @@ void encode_string(util::AppendBuffer<char>& buffer, uint32_t index, std::string
                        StringData(e.what()).contains(msg));                                                          \
     } while (0)
 
+TEST(ChangesetParser_IntegersAcrossChunks)
+{
+    // Integers which are entirely within the current chunk are decoded
+    // without per-byte end of input checks, all others byte by byte
+    Changeset changeset;
+    const int64_t values[] = {0, 1, 63, 64, -1, -64, -65, 8191, -8192, int64_t(1) << 40, -(int64_t(1) << 40),
+                              std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+    for (auto value : values) {
+        sync::instr::Update instr;
+        instr.table = changeset.intern_string("Foo");
+        instr.object = PrimaryKey{value};
+        instr.field = changeset.intern_string("bar");
+        instr.value = Payload{value};
+        changeset.push_back(instr);
+    }
+    sync::ChangesetEncoder::Buffer buffer;
+    encode_changeset(changeset, buffer);
+
+    struct ChunkedInputStream : util::InputStream {
+        util::Span<const char> data;
+        size_t chunk_size;
+        util::Span<const char> next_block() override
+        {
+            auto block = data.first(std::min(chunk_size, data.size()));
+            data = data.sub_span(block.size());
+            return block;
+        }
+    };
+    for (size_t chunk_size = 1; chunk_size <= 12; ++chunk_size) {
+        ChunkedInputStream stream;
+        stream.data = util::Span<const char>(buffer.data(), buffer.size());
+        stream.chunk_size = chunk_size;
+        Changeset parsed;
+        parse_changeset(stream, parsed);
+        CHECK_EQUAL(changeset, parsed);
+    }
+    auto parsed = encode_then_parse(changeset);
+    CHECK_EQUAL(changeset, parsed);
+}
+
 TEST(ChangesetParser_BadInstruction)
 {
     util::AppendBuffer<char> buffer;
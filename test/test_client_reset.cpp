@@ -3,6 +3,7 @@
 #include <realm/object_converter.hpp>
 #include <realm/sync/noinst/client_reset.hpp>
 #include <realm/sync/noinst/client_reset_operation.hpp>
+#include <realm/sync/noinst/client_reset_recovery.hpp>
 #include <realm/sync/subscriptions.hpp>
 #include <realm/table_view.hpp>
 #include <realm/util/random.hpp>
@@ -66,6 +67,128 @@ TEST(ClientReset_TransferGroupWithDanglingLinks)
     _impl::client_reset::transfer_group(*rt, *wt, *test_context.logger, allow_schema_additions);
 }
 
+TEST(ClientReset_TransferGroupSkipsUnchangedObjects)
+{
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+
+    auto setup_realm = [](auto& path) {
+        DBRef sg = DB::create(make_client_replication(), path);
+        auto wt = sg->start_write();
+        auto table = wt->add_table_with_primary_key("class_table", type_Int, "_id");
+        auto origin = wt->add_table_with_primary_key("class_origin", type_Int, "_id");
+        auto col_value = table->add_column(type_String, "value");
+        auto col_list = table->add_column_list(type_Int, "list");
+        auto col_link = origin->add_column(*table, "link");
+        for (int64_t i = 0; i < 2000; ++i) {
+            auto obj = table->create_object_with_primary_key(i).set(col_value, util::format("value %1", i));
+            obj.get_list<Int>(col_list).add(i);
+            origin->create_object_with_primary_key(i).set(col_link, obj.get_key());
+        }
+        wt->commit();
+        return sg;
+    };
+
+    auto sg_1 = setup_realm(path_1);
+    auto sg_2 = setup_realm(path_2);
+    {
+        auto wt = sg_2->start_write();
+        auto table = wt->get_table("class_table");
+        table->get_object_with_primary_key(1500).set("value", "changed");
+        table->get_object_with_primary_key(10).remove();
+        table->create_object_with_primary_key(5000);
+        wt->commit();
+    }
+
+    auto rt = sg_1->start_frozen();
+    auto unchanged = _impl::client_reset::find_unchanged_objects(*rt, *sg_2->start_frozen(), *test_context.logger);
+    // Tables with links are always compared object by object
+    CHECK_EQUAL(unchanged.count("class_origin"), 0);
+    CHECK_EQUAL(unchanged.count("class_table"), 1);
+    auto& objects = unchanged["class_table"];
+    auto table = rt->get_table("class_table");
+    CHECK_GREATER(objects.count, 1000);
+    CHECK_LESS(objects.count, 2000);
+    CHECK_NOT(objects.contains(table->find_primary_key(1500)));
+    CHECK_NOT(objects.contains(table->find_primary_key(10)));
+    size_t count = 0;
+    for (auto& obj : *table) {
+        if (objects.contains(obj.get_key()))
+            ++count;
+    }
+    CHECK_EQUAL(count, objects.count);
+
+    auto wt = sg_2->start_write();
+    constexpr bool allow_schema_additions = false;
+    _impl::client_reset::transfer_group(*rt, *wt, *test_context.logger, allow_schema_additions, &unchanged);
+    wt->commit_and_continue_as_read();
+    CHECK(compare_groups(*rt, *wt, *test_context.logger));
+}
+
+TEST(ClientReset_RecoverySkipsSupersededUpdates)
+{
+    SHARED_GROUP_TEST_PATH(path_local);
+    SHARED_GROUP_TEST_PATH(path_remote);
+
+    auto setup_realm = [](auto& path) {
+        DBRef sg = DB::create(make_client_replication(), path);
+        auto wt = sg->start_write();
+        auto table = wt->add_table_with_primary_key("class_table", type_Int, "_id");
+        table->add_column(type_Int, "value");
+        table->add_column(type_String, "name");
+        table->create_object_with_primary_key(1);
+        wt->commit();
+        return sg;
+    };
+
+    auto sg_local = setup_realm(path_local);
+    auto sg_remote = setup_realm(path_remote);
+    for (int64_t i = 0; i < 10; ++i) {
+        auto wt = sg_local->start_write();
+        auto obj = wt->get_table("class_table")->get_object_with_primary_key(1);
+        obj.set("value", i);
+        if (i == 5)
+            obj.set("name", "five");
+        wt->commit();
+    }
+    {
+        // Updates before the object is erased must not be skipped in favour
+        // of those after it is created again
+        auto wt = sg_local->start_write();
+        auto table = wt->get_table("class_table");
+        table->create_object_with_primary_key(2).set("value", 1);
+        table->get_object_with_primary_key(2).remove();
+        table->create_object_with_primary_key(2).set("value", 2);
+        wt->commit();
+    }
+
+    auto& history = dynamic_cast<ClientReplication&>(*sg_local->get_replication()).get_history();
+    auto rt = sg_local->start_read();
+    auto local_changes = history.get_local_changes(rt->get_version());
+    auto wt = sg_remote->start_write();
+    auto recovered = _impl::client_reset::process_recovered_changesets(*wt, *sg_local->start_frozen(),
+                                                                       *test_context.logger, local_changes);
+    CHECK_EQUAL(recovered.size(), local_changes.size());
+
+    size_t num_updates = 0;
+    for (auto& change : recovered) {
+        Changeset parsed;
+        util::SimpleInputStream in{{change.encoded_changeset.data(), change.encoded_changeset.size()}};
+        parse_changeset(in, parsed);
+        for (auto instr : parsed) {
+            if (instr && instr->get_if<Instruction::Update>())
+                ++num_updates;
+        }
+    }
+    // The last update of each property of each object
+    CHECK_EQUAL(num_updates, 4);
+
+    auto table = wt->get_table("class_table");
+    CHECK_EQUAL(table->get_object_with_primary_key(1).get<Int>("value"), 9);
+    CHECK_EQUAL(table->get_object_with_primary_key(1).get<String>("name"), "five");
+    CHECK_EQUAL(table->get_object_with_primary_key(2).get<Int>("value"), 2);
+}
+
 #if !REALM_MOBILE
 TEST(ClientReset_NoLocalChanges)
 {
@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <chrono>
+#include <thread>
 
 // #include <valgrind/callgrind.h>
 
@@ -203,6 +204,74 @@ TEST_TYPES(Compaction_Large, std::true_type, std::false_type)
     }
 }
 
+TEST(Compaction_Background)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options;
+    options.enable_background_compaction = true;
+    options.background_compaction_duty_cycle = 0.5;
+    options.background_compaction_step_size = 0x10000;
+    DBRef db = DB::create(make_in_realm_history(), path, options);
+    std::string big(1000, 'x');
+    {
+        auto tr = db->start_write();
+        auto t = tr->add_table("table");
+        auto col_bin = t->add_column(type_Binary, "bin", true);
+        auto col_int = t->add_column(type_Int, "int");
+        for (int i = 0; i < 5000; ++i) {
+            auto obj = t->create_object();
+            obj.set(col_bin, BinaryData(big.data(), big.size()));
+            obj.set(col_int, i);
+        }
+        tr->commit();
+    }
+    size_t size_before = size_t(File(path).get_size());
+    {
+        // Free most of the file, and then leave it to the compaction to
+        // move the rest out of the end of the file
+        auto tr = db->start_write();
+        auto t = tr->get_table("table");
+        auto col_bin = t->get_column_key("bin");
+        int i = 0;
+        for (auto obj : *t) {
+            if (i++ % 100)
+                obj.set(col_bin, BinaryData());
+        }
+        tr->commit();
+    }
+    {
+        WriteTransaction wt(db);
+        wt.commit();
+    }
+    CHECK(db->get_evacuation_stage() != DB::EvacStage::idle);
+
+    auto deadline = steady_clock::now() + seconds(30);
+    size_t size_after = size_before;
+    while (steady_clock::now() < deadline) {
+        size_after = size_t(File(path).get_size());
+        if (db->get_evacuation_stage() == DB::EvacStage::idle && size_after < size_before / 4)
+            break;
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+    CHECK(db->get_evacuation_stage() == DB::EvacStage::idle);
+    CHECK_LESS(size_after, size_before / 4);
+
+    auto rt = db->start_read();
+    rt->verify();
+    auto t = rt->get_table("table");
+    auto col_bin = t->get_column_key("bin");
+    auto col_int = t->get_column_key("int");
+    CHECK_EQUAL(t->size(), 5000);
+    for (auto obj : *t) {
+        auto i = obj.get<Int>(col_int);
+        CHECK_EQUAL(obj.get<Binary>(col_bin).size(), i % 100 ? 0 : big.size());
+    }
+    rt->end_read();
+
+    options.background_compaction_duty_cycle = 0;
+    CHECK_THROW(DB::create(make_in_realm_history(), path, options), InvalidArgument);
+}
+
 NONCONCURRENT_TEST(Compaction_Performance)
 {
     auto old_disable_sync_to_disk = get_disable_sync_to_disk();
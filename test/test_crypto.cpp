@@ -105,3 +105,25 @@ TEST(Crypto_SHA256)
 
     CHECK(!std::memcmp(expected_hash, out_buffer, 32));
 }
+
+TEST(Crypto_HmacSha224)
+{
+    std::array<uint8_t, 32> key;
+    for (size_t i = 0; i < key.size(); ++i)
+        key[i] = uint8_t(i * 7 + 1);
+    util::HmacSha224 hmac(key);
+
+    std::vector<uint8_t> in_buffer(4096);
+    for (size_t len : {size_t(0), size_t(3), size_t(64), size_t(4096)}) {
+        for (size_t i = 0; i < len; ++i)
+            in_buffer[i] = uint8_t(i ^ len);
+        std::array<uint8_t, 28> expected;
+        std::array<uint8_t, 28> actual;
+        util::hmac_sha224(util::Span(in_buffer.data(), len), expected, key);
+        hmac(util::Span(in_buffer.data(), len), actual);
+        CHECK(expected == actual);
+        // The state is reset for each input
+        hmac(util::Span(in_buffer.data(), len), actual);
+        CHECK(expected == actual);
+    }
+}
@@ -21,6 +21,8 @@
 
 #include "test.hpp"
 
+#include <limits>
+
 using namespace realm;
 
 TEST(Decimal_Basics)
@@ -182,6 +184,35 @@ TEST(Decimal_Arithmetics)
     CHECK_EQUAL(q.to_string(), "200");
 }
 
+TEST(Decimal_ArithmeticsSmallCoefficients)
+{
+    // The exact sum has the smaller exponent
+    CHECK_EQUAL((Decimal128("1.25") + Decimal128("10")).to_string(), "11.25");
+    CHECK_EQUAL((Decimal128("1.25") - Decimal128("3.5")).to_string(), "-2.25");
+    CHECK_EQUAL((Decimal128("1E3") + Decimal128("0")).to_string(), "1000");
+    CHECK_EQUAL((Decimal128("0.00") + Decimal128("5")).to_string(), "5.00");
+    // A difference of zero is positive, while the sum of negative zeros is negative
+    CHECK_EQUAL((Decimal128("-1.5") + Decimal128("1.5")).to_string(), "0E-1");
+    CHECK_EQUAL((Decimal128("-0") + Decimal128("-0")).to_string(), "-0");
+    // Sums which do not fit in 64 bits are left to the library
+    Decimal128 big(std::numeric_limits<uint64_t>::max());
+    CHECK_EQUAL(big + big, Decimal128("36893488147419103230"));
+    CHECK_EQUAL(Decimal128("1E30") + Decimal128("1"), Decimal128("1000000000000000000000000000001"));
+
+    CHECK(Decimal128("1.10") == Decimal128("1.1"));
+    CHECK(Decimal128("-0.0") == Decimal128("0E5"));
+    CHECK(Decimal128("1.1") < Decimal128("1.11"));
+    CHECK(Decimal128("-1.1") > Decimal128("-1.11"));
+    CHECK(Decimal128("1E30") > big);
+    CHECK(Decimal128("-1E30") < Decimal128("-1"));
+    CHECK(Decimal128("0") > Decimal128("-1E-30"));
+    CHECK(Decimal128("0") < Decimal128("1E-30"));
+    CHECK_EQUAL(Decimal128("2E-5").compare(Decimal128("0.00002")), 0);
+    CHECK(Decimal128("NaN") < Decimal128("-1E30"));
+    CHECK(Decimal128("+Inf") > big);
+    CHECK(Decimal128(realm::null()) != Decimal128(0));
+}
+
 TEST(Decimal_Array)
 {
     const char str0[] = "12345.67";
@@ -501,3 +532,67 @@ TEST(Decimal_Aggregates)
         CHECK_EQUAL(table->min(col)->get_decimal(), Decimal128(1));
     }
 }
+
+TEST(Decimal_ArraySumMinMax)
+{
+    ArrayDecimal128 arr(Allocator::get_default());
+    arr.create();
+
+    auto check = [&](size_t expected_count, Decimal128 expected_min, Decimal128 expected_max) {
+        Decimal128 sum;
+        size_t count = 0;
+        for (size_t i = 0; i < arr.size(); ++i) {
+            Decimal128 v = arr.get(i);
+            if (!v.is_nan()) {
+                sum += v;
+                ++count;
+            }
+        }
+        size_t leaf_count;
+        CHECK_EQUAL(arr.sum(0, arr.size(), leaf_count), sum);
+        CHECK_EQUAL(leaf_count, count);
+        CHECK_EQUAL(count, expected_count);
+        Decimal128 m;
+        size_t ndx;
+        CHECK(arr.minmax<false>(0, arr.size(), &m, &ndx));
+        CHECK_EQUAL(m, expected_min);
+        CHECK_EQUAL(arr.get(ndx), expected_min);
+        CHECK(arr.minmax<true>(0, arr.size(), &m, &ndx));
+        CHECK_EQUAL(m, expected_max);
+        CHECK_EQUAL(arr.get(ndx), expected_max);
+    };
+
+    // Zero width
+    arr.add(Decimal128());
+    arr.add(Decimal128());
+    check(2, Decimal128(), Decimal128());
+
+    // 4 bytes wide
+    arr.clear();
+    for (int i = 0; i < 100; ++i)
+        arr.add(i % 7 ? Decimal128(i * 3 - 150) / 100 : Decimal128(realm::null()));
+    CHECK_EQUAL(arr.get_width(), 4);
+    check(85, Decimal128("-1.47"), Decimal128("1.47"));
+
+    // 8 bytes wide
+    arr.add(Decimal128("12345678901.23"));
+    CHECK_EQUAL(arr.get_width(), 8);
+    check(86, Decimal128("-1.47"), Decimal128("12345678901.23"));
+
+    // 16 bytes wide
+    arr.add(Decimal128("-1E-1000"));
+    arr.add(Decimal128("NaN"));
+    CHECK_EQUAL(arr.get_width(), 16);
+    check(87, Decimal128("-1.47"), Decimal128("12345678901.23"));
+
+    // Only null
+    arr.clear();
+    arr.add(Decimal128(realm::null()));
+    size_t count;
+    CHECK_EQUAL(arr.sum(0, 1, count), Decimal128());
+    CHECK_EQUAL(count, 0);
+    Decimal128 m;
+    CHECK_NOT(arr.minmax<true>(0, 1, &m));
+
+    arr.destroy();
+}
@@ -497,6 +497,126 @@ TEST(Dictionary_UseAfterFree)
     CHECK_EQUAL(q.count(), 1);
 }
 
+TEST(Dictionary_KeyIndex)
+{
+    constexpr int64_t nb_entries = 1000;
+    Group g;
+    auto foos = g.add_table("Foo");
+    ColKey col_str = foos->add_column_dictionary(type_Int, "str");
+    ColKey col_int = foos->add_column_dictionary(type_Int, "int", false, type_Int);
+
+    auto foo = foos->create_object();
+    auto str_dict = foo.get_dictionary(col_str);
+    auto int_dict = foo.get_dictionary(col_int);
+    for (int64_t i = 0; i < nb_entries; i++) {
+        str_dict.insert(Mixed("key" + util::to_string(i * 2)), i);
+        int_dict.insert(Mixed(i * 2), i);
+    }
+
+    auto check_all = [&] {
+        for (int64_t i = 0; i < nb_entries; i++) {
+            std::string key = "key" + util::to_string(i * 2);
+            CHECK_EQUAL(str_dict.get(key), Mixed(i));
+            CHECK_EQUAL(str_dict.get_key(str_dict.find_any_key(key)), Mixed(key));
+            CHECK_NOT(str_dict.try_get("key" + util::to_string(i * 2 + 1)));
+            CHECK_EQUAL(int_dict.get(i * 2), Mixed(i));
+            CHECK_EQUAL(int_dict.get_key(int_dict.find_any_key(i * 2)), Mixed(i * 2));
+            CHECK_EQUAL(int_dict.find_any_key(i * 2 + 1), realm::npos);
+        }
+        CHECK_NOT(str_dict.contains(Mixed(5)));
+        CHECK_NOT(int_dict.contains("key2"));
+    };
+    // Repeated lookups build the index, so this checks both with and without it
+    check_all();
+    check_all();
+
+    // Changes must be visible through the index
+    str_dict.insert("key10", -1);
+    int_dict.insert(10, -1);
+    CHECK_EQUAL(str_dict.get("key10"), Mixed(-1));
+    CHECK_EQUAL(int_dict.get(10), Mixed(-1));
+    str_dict.insert("key10", 5);
+    int_dict.insert(10, 5);
+    check_all();
+
+    str_dict.erase("key0");
+    int_dict.erase(0);
+    CHECK_NOT(str_dict.contains("key0"));
+    CHECK_NOT(int_dict.contains(0));
+    CHECK_EQUAL(str_dict.get("key2"), Mixed(1));
+    CHECK_EQUAL(int_dict.get(2), Mixed(1));
+    str_dict.insert("key0", 0);
+    int_dict.insert(0, 0);
+    check_all();
+
+    // Iteration order is unchanged
+    Mixed prev;
+    for (auto [key, value] : int_dict) {
+        CHECK(prev.is_null() || prev < key);
+        prev = key;
+    }
+
+    // Changes made through another accessor
+    auto other = foo.get_dictionary(col_str);
+    other.erase("key4");
+    CHECK_NOT(str_dict.contains("key4"));
+    other.insert("key4", 2);
+    CHECK_EQUAL(str_dict.get("key4"), Mixed(2));
+    check_all();
+}
+
+TEST(Dictionary_InsertMany)
+{
+    Group g;
+    auto foos = g.add_table("Foo");
+    auto bars = g.add_table("Bar");
+    ColKey col_dict = foos->add_column_dictionary(type_Mixed, "dict");
+    ColKey col_int = foos->add_column_dictionary(type_Int, "ints", false, type_Int);
+    auto bar = bars->create_object();
+
+    auto foo = foos->create_object();
+    auto dict = foo.get_dictionary(col_dict);
+    std::vector<std::pair<Mixed, Mixed>> entries;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 3000; i++) {
+        keys.push_back("key" + util::to_string(i));
+    }
+    for (int i = 0; i < 3000; i++) {
+        entries.emplace_back(keys[i], i);
+    }
+    entries.emplace_back(keys[5], -5);
+    CHECK_EQUAL(dict.insert_many(entries), 3000);
+    CHECK_EQUAL(dict.size(), 3000);
+    CHECK_EQUAL(dict.get(keys[5]), Mixed(-5));
+    CHECK_EQUAL(dict.get(keys[2999]), Mixed(2999));
+    Mixed prev;
+    for (auto [key, value] : dict) {
+        CHECK(prev.is_null() || prev < key);
+        prev = key;
+    }
+
+    // Some keys exist already, and links need backlinks
+    CHECK_EQUAL(dict.insert_many({{"key5", 5}, {"a", "b"}, {"zz", bar.get_link()}}), 2);
+    CHECK_EQUAL(dict.size(), 3002);
+    CHECK_EQUAL(dict.get("key5"), Mixed(5));
+    CHECK_EQUAL(dict.get("a"), Mixed("b"));
+    CHECK_EQUAL(bar.get_backlink_count(), 1);
+
+    CHECK_THROW_ANY(dict.insert_many({{"zzz", 1}, {"$a", 2}}));
+    CHECK_THROW_ANY(dict.insert_many({{"zzz", 1}, {7, 2}}));
+    CHECK_EQUAL(dict.size(), 3002);
+
+    auto ints = foo.get_dictionary(col_int);
+    CHECK_EQUAL(ints.insert_many({{3, 30}, {1, 10}, {2, 20}}), 3);
+    CHECK_EQUAL(ints.insert_many({{5, 50}, {4, 40}}), 2);
+    CHECK_THROW_ANY(ints.insert_many({{6, Mixed()}}));
+    CHECK_EQUAL(ints.size(), 5);
+    for (int64_t i = 0; i < 5; i++) {
+        CHECK_EQUAL(ints.get_key(i), Mixed(i + 1));
+        CHECK_EQUAL(ints.get(i + 1), Mixed((i + 1) * 10));
+    }
+}
+
 NONCONCURRENT_TEST(Dictionary_HashCollision)
 {
     constexpr int64_t nb_entries = 100;
@@ -126,6 +126,44 @@ TEST(EncryptedFile_SeparateCryptors)
     CHECK(memcmp(buffer, data, strlen(data)) == 0);
 }
 
+TEST(EncryptedFile_BatchedWrites)
+{
+    TEST_PATH(path);
+
+    // Spans three metadata blocks, and starts and ends in the middle of one
+    const size_t block_size = 4096;
+    const size_t num_blocks = 150;
+    const off_t start = 10 * block_size;
+    std::vector<char> data(num_blocks * block_size);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = char(i * 31 + i / block_size);
+    std::vector<char> buffer(data.size());
+
+    File file(path, realm::util::File::mode_Write);
+    {
+        AESCryptor cryptor(test_key);
+        cryptor.set_file_size(start + data.size());
+        cryptor.write(file.get_descriptor(), start, data.data(), data.size());
+        cryptor.read(file.get_descriptor(), start, buffer.data(), buffer.size());
+        CHECK(buffer == data);
+        // Rewrite a part of it, which must bump the IVs of those blocks only
+        data[5 * block_size] = 'x';
+        cryptor.write(file.get_descriptor(), start + 4 * block_size, data.data() + 4 * block_size,
+                      80 * block_size);
+    }
+    {
+        AESCryptor cryptor(test_key);
+        cryptor.set_file_size(start + data.size());
+        std::fill(buffer.begin(), buffer.end(), 0);
+        for (size_t i = 0; i < num_blocks; ++i) {
+            off_t pos = start + off_t(i * block_size);
+            CHECK_EQUAL(cryptor.read(file.get_descriptor(), pos, buffer.data() + i * block_size, block_size),
+                        block_size);
+        }
+        CHECK(buffer == data);
+    }
+}
+
 TEST(EncryptedFile_InterruptedWrite)
 {
     TEST_PATH(path);
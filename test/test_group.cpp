@@ -636,6 +636,68 @@ TEST(Group_RenameTable)
 }
 
 
+TEST(Group_ManyTableNames)
+{
+    // Enough tables for the table names to be looked up through a hash index
+    SHARED_GROUP_TEST_PATH(path);
+    auto db = DB::create(make_in_realm_history(), path);
+    auto name = [](int i) {
+        return "table_" + util::to_string(i);
+    };
+    {
+        auto wt = db->start_write();
+        for (int i = 0; i < 40; ++i)
+            wt->add_table(name(i));
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    for (int i = 0; i < 40; ++i)
+        CHECK_EQUAL(rt->get_table(name(i))->get_name(), name(i));
+    CHECK_NOT(rt->has_table("table_40"));
+    CHECK_NOT(rt->has_table(""));
+
+    {
+        auto wt = db->start_write();
+        wt->rename_table(name(3), "renamed");
+        wt->remove_table(name(5));
+        wt->add_table("added");
+        CHECK(wt->has_table("renamed"));
+        CHECK_NOT(wt->has_table(name(3)));
+        CHECK_NOT(wt->has_table(name(5)));
+        CHECK(wt->has_table("added"));
+        // A duplicated name is found at its first position
+        TableKey first = wt->find_table(name(7));
+        wt->rename_table(name(8), name(7), false);
+        CHECK_EQUAL(wt->find_table(name(7)), first);
+        wt->rollback_and_continue_as_read();
+        CHECK(wt->has_table(name(3)));
+        CHECK(wt->has_table(name(5)));
+        CHECK(wt->has_table(name(8)));
+        CHECK_NOT(wt->has_table("renamed"));
+        CHECK_NOT(wt->has_table("added"));
+    }
+    {
+        auto wt = db->start_write();
+        wt->rename_table(name(3), "renamed");
+        wt->remove_table(name(5));
+        wt->add_table("added");
+        wt->commit();
+    }
+
+    // The read transaction still sees its own version until advanced
+    CHECK(rt->has_table(name(3)));
+    CHECK_NOT(rt->has_table("renamed"));
+    rt->advance_read();
+    CHECK(rt->has_table("renamed"));
+    CHECK(rt->has_table("added"));
+    CHECK_NOT(rt->has_table(name(3)));
+    CHECK_NOT(rt->has_table(name(5)));
+    for (int i = 6; i < 40; ++i)
+        CHECK_EQUAL(rt->get_table(name(i))->get_name(), name(i));
+}
+
+
 TEST(Group_Equal)
 {
     Group g1, g2, g3;
@@ -997,6 +1059,65 @@ TEST(Group_Serialize_All)
 }
 
 
+TEST(Group_WriteBundle)
+{
+    SHARED_GROUP_TEST_PATH(bundle_path);
+    GROUP_TEST_PATH(plain_path);
+    Group group;
+    TableRef table = group.add_table("test");
+    auto col = table->add_column(type_String, "string");
+    for (int i = 0; i < 1000; ++i)
+        table->create_object(ObjKey(i)).set(col, util::format("Value %1", i));
+
+    group.write_bundle(bundle_path, 4096);
+    CHECK_THROW(group.write_bundle(bundle_path), FileAccessError);
+    CHECK(Group::verify_bundle(bundle_path));
+    group.write(plain_path);
+    CHECK_NOT(Group::verify_bundle(plain_path));
+
+    auto check = [&](const Group& g, size_t size) {
+        ConstTableRef t = g.get_table("test");
+        CHECK_EQUAL(t->size(), size);
+        CHECK_EQUAL(t->get_object(ObjKey(999)).get<String>(col), "Value 999");
+    };
+    DBOptions options;
+    options.is_immutable = true;
+    {
+        auto db = DB::create(bundle_path, options);
+        check(*db->start_read(), 1000);
+    }
+    {
+        Group g(bundle_path);
+        check(g, 1000);
+    }
+
+    // A bundle can be written to, but is no longer a bundle afterwards
+    {
+        auto db = DB::create(bundle_path);
+        auto wt = db->start_write();
+        wt->get_table("test")->create_object(ObjKey(1000));
+        wt->commit();
+    }
+    CHECK_NOT(Group::verify_bundle(bundle_path));
+    {
+        auto db = DB::create(bundle_path, options);
+        check(*db->start_read(), 1001);
+    }
+
+    // Corruption of the data is detected by the checksums
+    File::try_remove(bundle_path);
+    group.write_bundle(bundle_path, 4096);
+    {
+        File file(bundle_path, File::mode_Update);
+        char c;
+        File::read_at_static(file.get_descriptor(), 5000, &c, 1);
+        c ^= 1;
+        File::write_at_static(file.get_descriptor(), 5000, &c, 1);
+    }
+    CHECK_NOT(Group::verify_bundle(bundle_path));
+}
+
+
 TEST(Group_ToJSON)
 {
     Group g;
@@ -0,0 +1,258 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_INDEX_COMPOUND
+
+#include <realm.hpp>
+#include <realm/index_compound.hpp>
+
+#include "test.hpp"
+#include "util/random.hpp"
+
+using namespace realm;
+using namespace realm::test_util;
+using unit_test::TestContext;
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+
+TEST(CompoundIndex_Basic)
+{
+    Group g;
+    auto t = g.add_table("foo");
+    auto col_owner = t->add_column(type_Int, "owner");
+    auto col_status = t->add_column(type_String, "status", true);
+    auto col_flag = t->add_column(type_Bool, "flag");
+    auto col_bin = t->add_column(type_Binary, "bin");
+    auto col_list = t->add_column_list(type_Int, "list");
+
+    CHECK_THROW_ANY(t->add_compound_index({col_owner}));
+    CHECK_THROW_ANY(t->add_compound_index({col_owner, col_owner}));
+    CHECK_THROW_ANY(t->add_compound_index({col_owner, col_bin}));
+    CHECK_THROW_ANY(t->add_compound_index({col_owner, col_list}));
+    CHECK_THROW_ANY(t->add_compound_index({col_owner, col_status, col_flag, col_owner, col_status}));
+
+    for (int i = 0; i < 200; ++i) {
+        auto obj = t->create_object().set(col_owner, i % 10).set(col_flag, i % 3 == 0);
+        if (i % 7)
+            obj.set(col_status, i % 4 ? "open" : "closed");
+    }
+    t->add_compound_index({col_owner, col_status});
+    t->add_compound_index({col_owner, col_status}); // no effect
+    CHECK(t->has_compound_index({col_owner, col_status}));
+    CHECK_NOT(t->has_compound_index({col_status, col_owner}));
+    CHECK_EQUAL(t->get_compound_indexes().size(), 1);
+    t->verify();
+
+    auto& index = *t->get_compound_indexes()[0];
+    auto count = [&](std::vector<Mixed> values) {
+        auto [begin, end] = index.find_prefix(values);
+        return end - begin;
+    };
+    CHECK_EQUAL(count({}), 200);
+    CHECK_EQUAL(count({3}), 20);
+    CHECK_EQUAL(count({3, "open"}), t->where().equal(col_owner, 3).equal(col_status, "open").count());
+    CHECK_EQUAL(count({3, Mixed()}), t->where().equal(col_owner, 3).equal(col_status, realm::null()).count());
+    CHECK_EQUAL(count({11, "open"}), 0);
+
+    // Changes must keep the index ordered
+    auto obj = t->get_object(5);
+    obj.set(col_owner, 100);
+    obj.set(col_status, "archived");
+    obj.set_null(col_status);
+    obj.add_int(col_owner, -50);
+    t->get_object(17).remove();
+    t->create_object().set(col_owner, 3).set(col_status, "open");
+    t->create_object();
+    t->verify();
+    CHECK_EQUAL(count({50, Mixed()}), 1);
+    CHECK_EQUAL(count({0, Mixed()}), t->where().equal(col_owner, 0).equal(col_status, realm::null()).count());
+
+    t->remove_compound_index({col_owner, col_status});
+    CHECK_NOT(t->has_compound_index({col_owner, col_status}));
+    CHECK(t->get_compound_indexes().empty());
+
+    // Removing a column removes the indexes using it
+    t->add_compound_index({col_flag, col_owner});
+    t->add_compound_index({col_owner, col_status});
+    t->remove_column(col_flag);
+    CHECK_EQUAL(t->get_compound_indexes().size(), 1);
+    CHECK(t->has_compound_index({col_owner, col_status}));
+    t->verify();
+
+    t->clear();
+    t->verify();
+}
+
+TEST(CompoundIndex_Queries)
+{
+    Random random(random_int<unsigned long>());
+    Group g;
+    auto t = g.add_table("foo");
+    auto col_owner = t->add_column(type_Int, "owner");
+    auto col_status = t->add_column(type_String, "status");
+    auto col_ts = t->add_column(type_Timestamp, "ts", true);
+    auto col_oid = t->add_column(type_ObjectId, "oid");
+    auto col_val = t->add_column(type_Int, "val");
+    const char* statuses[] = {"new", "open", "closed"};
+
+    for (int i = 0; i < 3000; ++i) {
+        auto obj = t->create_object();
+        obj.set(col_owner, random.draw_int_mod(50));
+        obj.set(col_status, statuses[random.draw_int_mod(3)]);
+        if (random.draw_int_mod(5))
+            obj.set(col_ts, Timestamp(random.draw_int_mod(4), 0));
+        obj.set(col_oid, ObjectId::gen());
+        obj.set(col_val, i);
+    }
+
+    // Evaluate the queries before and after adding the index
+    std::vector<std::function<Query()>> queries = {
+        [&] {
+            return t->where().equal(col_owner, 7).equal(col_status, "open");
+        },
+        [&] {
+            return t->where().equal(col_status, "open").equal(col_owner, 7);
+        },
+        [&] {
+            return t->where().equal(col_owner, 7).equal(col_status, "open").equal(col_ts, Timestamp(2, 0));
+        },
+        [&] {
+            return t->where().equal(col_owner, 7).equal(col_status, "open").equal(col_ts, realm::null());
+        },
+        [&] {
+            return t->where().equal(col_owner, 7).equal(col_status, "open").greater(col_val, 1000);
+        },
+        [&] {
+            return t->where().equal(col_owner, 7);
+        },
+        [&] {
+            return t->where().equal(col_owner, 7).Or().equal(col_status, "new");
+        },
+        [&] {
+            return t->where().equal(col_owner, 70).equal(col_status, "open");
+        },
+        [&] {
+            return t->query("owner == 7 AND status == 'open'");
+        },
+        [&] {
+            return t->query("status == 'open' AND owner == 7 AND val < 2000");
+        },
+    };
+    std::vector<std::vector<ObjKey>> expected;
+    for (auto& make_query : queries) {
+        auto tv = make_query().find_all();
+        std::vector<ObjKey> keys;
+        for (size_t i = 0; i < tv.size(); ++i)
+            keys.push_back(tv.get_key(i));
+        expected.push_back(std::move(keys));
+    }
+
+    t->add_compound_index({col_owner, col_status, col_ts});
+    t->add_compound_index({col_oid, col_owner});
+    for (size_t q = 0; q < queries.size(); ++q) {
+        Query query = queries[q]();
+        auto tv = query.find_all();
+        CHECK_EQUAL(tv.size(), expected[q].size());
+        for (size_t i = 0; i < tv.size() && i < expected[q].size(); ++i) {
+            CHECK_EQUAL(tv.get_key(i), expected[q][i]);
+        }
+        CHECK_EQUAL(query.count(), expected[q].size());
+        CHECK_EQUAL(query.find(), expected[q].empty() ? ObjKey() : expected[q][0]);
+        // The planner must not leave traces in the description or in copies
+        if (q != 6) {
+            CHECK_EQUAL(query.get_description(), queries[q]().get_description());
+            Query copy(query);
+            CHECK_EQUAL(copy.count(), expected[q].size());
+        }
+    }
+
+    auto oid = t->get_object(100).get<ObjectId>(col_oid);
+    CHECK_EQUAL(t->where().equal(col_oid, oid).count(), 1);
+
+    // Results must follow changes to the table
+    Query query = t->where().equal(col_owner, 7).equal(col_status, "open");
+    size_t before = query.count();
+    t->create_object().set(col_owner, 7).set(col_status, "open");
+    CHECK_EQUAL(query.count(), before + 1);
+    t->get_object(query.find()).set(col_status, "closed");
+    CHECK_EQUAL(query.count(), before);
+    t->remove_compound_index({col_owner, col_status, col_ts});
+    CHECK_EQUAL(query.count(), before);
+    t->verify();
+}
+
+TEST(CompoundIndex_Persistence)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    ColKey col_a, col_b;
+    {
+        auto wt = db->start_write();
+        auto t = wt->add_table("foo");
+        col_a = t->add_column(type_Int, "a");
+        col_b = t->add_column(type_String, "b");
+        for (int64_t i = 0; i < 100; ++i) {
+            t->create_object().set(col_a, i % 5).set(col_b, std::string(1, char('a' + i % 3)));
+        }
+        t->add_compound_index({col_a, col_b});
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto t = rt->get_table("foo");
+    CHECK(t->has_compound_index({col_a, col_b}));
+    t->verify();
+    CHECK_EQUAL(t->where().equal(col_a, 2).equal(col_b, "b").count(), 7);
+
+    {
+        auto wt = db->start_write();
+        auto t2 = wt->get_table("foo");
+        for (int64_t i = 0; i < 10; ++i) {
+            t2->create_object().set(col_a, 2).set(col_b, "b");
+        }
+        wt->commit();
+    }
+    rt->advance_read();
+    t->verify();
+    CHECK_EQUAL(t->where().equal(col_a, 2).equal(col_b, "b").count(), 17);
+
+    {
+        auto wt = db->start_write();
+        wt->get_table("foo")->remove_compound_index({col_a, col_b});
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_NOT(t->has_compound_index({col_a, col_b}));
+    CHECK_EQUAL(t->where().equal(col_a, 2).equal(col_b, "b").count(), 17);
+}
+
+#endif // TEST_INDEX_COMPOUND
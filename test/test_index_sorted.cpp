@@ -0,0 +1,441 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_INDEX_SORTED
+
+#include <realm.hpp>
+#include <realm/index_sorted.hpp>
+
+#include "test.hpp"
+#include "util/random.hpp"
+
+using namespace realm;
+using namespace realm::test_util;
+using unit_test::TestContext;
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+
+namespace {
+
+void verify_index(TestContext& test_context, const Table& table, ColKey col)
+{
+    auto index = dynamic_cast<const SortedIndex*>(table.get_search_index(col));
+    CHECK(index);
+    if (!index)
+        return;
+    index->verify();
+    CHECK_EQUAL(index->size(), table.size());
+    for (size_t i = 1; i < index->size(); ++i) {
+        CHECK_LESS_EQUAL(index->get_value(i - 1).compare(index->get_value(i)), 0);
+    }
+}
+
+} // anonymous namespace
+
+TEST(SortedIndex_Basic)
+{
+    Group g;
+    auto t = g.add_table("foo");
+    auto col_int = t->add_column(type_Int, "int", true);
+    auto col_str = t->add_column(type_String, "str");
+    auto col_bin = t->add_column(type_Binary, "bin");
+
+    t->add_search_index(col_int, IndexType::Sorted);
+    t->add_search_index(col_str, IndexType::Sorted);
+    CHECK_EQUAL(t->search_index_type(col_int), IndexType::Sorted);
+    CHECK_EQUAL(t->search_index_type(col_str), IndexType::Sorted);
+    // has_search_index() only reports general indexes, as for full text indexes
+    CHECK_NOT(t->has_search_index(col_int));
+    CHECK_THROW_ANY(t->add_search_index(col_bin, IndexType::Sorted));
+
+    std::vector<Obj> objs;
+    for (int i = 0; i < 30; ++i) {
+        auto obj = t->create_object();
+        if (i % 5)
+            obj.set(col_int, 15 - i % 10);
+        obj.set(col_str, std::string(1, char('z' - i % 7)));
+        objs.push_back(obj);
+    }
+    verify_index(test_context, *t, col_int);
+    verify_index(test_context, *t, col_str);
+
+    auto index = t->get_search_index(col_int);
+    CHECK_EQUAL(index->count(Mixed(14)), 3);
+    CHECK_EQUAL(index->count(Mixed()), 6);
+    CHECK_EQUAL(index->find_first(Mixed(14)), objs[1].get_key());
+    CHECK_NOT(index->find_first(Mixed(100)));
+    CHECK_EQUAL(t->where().equal(col_int, 12).count(), 3);
+    CHECK_EQUAL(t->where().equal(col_str, "z").count(), 5);
+    CHECK_EQUAL(t->where().equal(col_str, "Z", false).count(), 5);
+
+    // Updates must move the entries
+    objs[1].set(col_int, 100);
+    objs[2].set_null(col_int);
+    objs[3].set(col_str, "a");
+    objs[4].remove();
+    verify_index(test_context, *t, col_int);
+    verify_index(test_context, *t, col_str);
+    CHECK_EQUAL(index->find_first(Mixed(100)), objs[1].get_key());
+    CHECK_EQUAL(index->count(Mixed()), 7);
+    CHECK_EQUAL(t->where().equal(col_str, "a").count(), 1);
+
+    // Switching to another kind of index rebuilds it
+    t->add_search_index(col_int, IndexType::General);
+    CHECK_EQUAL(t->search_index_type(col_int), IndexType::General);
+    CHECK_EQUAL(t->where().equal(col_int, 100).count(), 1);
+    t->add_search_index(col_int, IndexType::Sorted);
+    verify_index(test_context, *t, col_int);
+
+    t->remove_search_index(col_int);
+    CHECK_EQUAL(t->search_index_type(col_int), IndexType::None);
+    CHECK_EQUAL(t->where().equal(col_int, 100).count(), 1);
+
+    t->clear();
+    verify_index(test_context, *t, col_str);
+}
+
+TEST(SortedIndex_PrimaryKey)
+{
+    Group g;
+    auto t = g.add_table_with_primary_key("foo", type_Int, "id");
+    CHECK_THROW_ANY(t->add_search_index(t->get_primary_key_column(), IndexType::Sorted));
+    auto col = t->add_column(type_Int, "int");
+    t->add_search_index(col, IndexType::Sorted);
+    CHECK_THROW_ANY(t->set_primary_key_column(col));
+}
+
+TEST(SortedIndex_RandomUpdates)
+{
+    Random random(random_int<unsigned long>());
+    Group g;
+    auto t = g.add_table("foo");
+    auto col_int = t->add_column(type_Int, "int");
+    auto col_dbl = t->add_column(type_Double, "double", true);
+    auto col_ts = t->add_column(type_Timestamp, "ts");
+    t->add_search_index(col_int, IndexType::Sorted);
+    t->add_search_index(col_dbl, IndexType::Sorted);
+    t->add_search_index(col_ts, IndexType::Sorted);
+
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            auto obj = t->create_object();
+            obj.set(col_int, random.draw_int<int64_t>(-50, 50));
+            if (random.draw_int_mod(10))
+                obj.set(col_dbl, random.draw_int<int>(-20, 20) / 4.0);
+            obj.set(col_ts, Timestamp(random.draw_int<int64_t>(0, 100), 0));
+        }
+        size_t sz = t->size();
+        for (int i = 0; i < 20; ++i) {
+            auto obj = t->get_object(random.draw_int_mod(sz));
+            obj.set(col_int, random.draw_int<int64_t>(-50, 50));
+            obj.set_null(col_dbl);
+        }
+        for (int i = 0; i < 30; ++i) {
+            t->get_object(random.draw_int_mod(t->size())).remove();
+        }
+        verify_index(test_context, *t, col_int);
+        verify_index(test_context, *t, col_dbl);
+        verify_index(test_context, *t, col_ts);
+    }
+}
+
+TEST(SortedIndex_RangeQueries)
+{
+    Group g;
+    auto t = g.add_table("foo");
+    auto col_int = t->add_column(type_Int, "int", true);
+    auto col_ts = t->add_column(type_Timestamp, "ts", true);
+    auto col_plain = t->add_column(type_Int, "plain", true);
+    auto col_plain_ts = t->add_column(type_Timestamp, "plain_ts", true);
+    t->add_search_index(col_int, IndexType::Sorted);
+    t->add_search_index(col_ts, IndexType::Sorted);
+
+    for (int64_t i = 0; i < 2000; ++i) {
+        auto obj = t->create_object();
+        if (i % 7) {
+            int64_t v = (i * 7919) % 1000;
+            obj.set(col_int, v).set(col_plain, v);
+            obj.set(col_ts, Timestamp(v, 0)).set(col_plain_ts, Timestamp(v, 0));
+        }
+    }
+
+    // The results must be the same as when evaluated without an index
+    auto check = [&](Query q1, Query q2) {
+        auto tv1 = q1.find_all();
+        auto tv2 = q2.find_all();
+        CHECK_EQUAL(q1.count(), q2.count());
+        CHECK_EQUAL(tv1.size(), tv2.size());
+        for (size_t i = 0; i < tv1.size() && i < tv2.size(); ++i) {
+            CHECK_EQUAL(tv1.get_key(i), tv2.get_key(i));
+        }
+        CHECK_EQUAL(q1.find(), q2.find());
+    };
+    for (int64_t v : {-1, 0, 3, 500, 990, 999, 1000}) {
+        check(t->where().greater(col_int, v), t->where().greater(col_plain, v));
+        check(t->where().greater_equal(col_int, v), t->where().greater_equal(col_plain, v));
+        check(t->where().less(col_int, v), t->where().less(col_plain, v));
+        check(t->where().less_equal(col_int, v), t->where().less_equal(col_plain, v));
+        check(t->where().greater(col_ts, Timestamp(v, 0)), t->where().greater(col_plain_ts, Timestamp(v, 0)));
+        check(t->where().less(col_ts, Timestamp(v, 0)), t->where().less(col_plain_ts, Timestamp(v, 0)));
+        check(t->where().greater(col_int, v).less(col_plain, 995), t->where().greater(col_plain, v).less(col_plain, 995));
+    }
+    check(t->where().equal(col_int, null()), t->where().equal(col_plain, null()));
+    check(t->where().between(col_int, int64_t(10), int64_t(20)), t->where().between(col_plain, int64_t(10), int64_t(20)));
+}
+
+TEST(SortedIndex_Sort)
+{
+    Group g;
+    auto t = g.add_table("foo");
+    auto col_int = t->add_column(type_Int, "int", true);
+    auto col_str = t->add_column(type_String, "str", true);
+    auto col_plain = t->add_column(type_Int, "plain", true);
+    auto col_plain_str = t->add_column(type_String, "plain_str", true);
+    auto col_other = t->add_column(type_Int, "other");
+    t->add_search_index(col_int, IndexType::Sorted);
+    t->add_search_index(col_str, IndexType::Sorted);
+
+    for (int64_t i = 0; i < 1500; ++i) {
+        auto obj = t->create_object();
+        obj.set(col_other, i % 10);
+        if (i % 11) {
+            // Plenty of duplicates to check that ties keep their order
+            int64_t v = (i * 31) % 97;
+            obj.set(col_int, v).set(col_plain, v);
+            std::string s = "s" + util::to_string(v % 13);
+            obj.set(col_str, s).set(col_plain_str, s);
+        }
+    }
+
+    auto check = [&](Query q, ColKey indexed, ColKey plain, bool ascending, size_t limit) {
+        DescriptorOrdering order1;
+        order1.append_sort(SortDescriptor({{indexed}}, {ascending}));
+        DescriptorOrdering order2;
+        order2.append_sort(SortDescriptor({{plain}}, {ascending}));
+        if (limit != size_t(-1)) {
+            order1.append_limit(limit);
+            order2.append_limit(limit);
+        }
+        auto tv1 = q.find_all(order1);
+        auto tv2 = q.find_all(order2);
+        CHECK_EQUAL(tv1.size(), tv2.size());
+        for (size_t i = 0; i < tv1.size() && i < tv2.size(); ++i) {
+            CHECK_EQUAL(tv1.get_key(i), tv2.get_key(i));
+        }
+    };
+    for (bool ascending : {true, false}) {
+        for (size_t limit : {size_t(0), size_t(1), size_t(10), size_t(200), size_t(-1)}) {
+            check(t->where(), col_int, col_plain, ascending, limit);
+            check(t->where(), col_str, col_plain_str, ascending, limit);
+            check(t->where().equal(col_other, 3), col_int, col_plain, ascending, limit);
+            check(t->where().greater(col_int, 50), col_int, col_plain, ascending, limit);
+        }
+    }
+
+    // Sorting a view must keep working after the table has changed
+    DescriptorOrdering order;
+    order.append_sort(SortDescriptor({{col_int}}, {false}));
+    order.append_limit(3);
+    auto tv = t->where().find_all(order);
+    CHECK_EQUAL(tv.size(), 3);
+    auto obj = t->create_object().set(col_int, 1000);
+    tv.sync_if_needed();
+    CHECK_EQUAL(tv.size(), 3);
+    CHECK_EQUAL(tv.get_key(0), obj.get_key());
+}
+
+TEST(SortedIndex_Persistence)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        auto t = wt->add_table("foo");
+        col = t->add_column(type_Int, "int");
+        for (int64_t i = 0; i < 500; ++i) {
+            t->create_object().set(col, 500 - i);
+        }
+        t->add_search_index(col, IndexType::Sorted);
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto t = rt->get_table("foo");
+    CHECK_EQUAL(t->search_index_type(col), IndexType::Sorted);
+    verify_index(test_context, *t, col);
+    CHECK_EQUAL(t->where().less(col, 11).count(), 10);
+
+    {
+        auto wt = db->start_write();
+        auto t2 = wt->get_table("foo");
+        for (int64_t i = 0; i < 100; ++i) {
+            t2->create_object().set(col, -i);
+        }
+        t2->get_object(0).set(col, 10000);
+        wt->commit();
+    }
+    rt->advance_read();
+    verify_index(test_context, *t, col);
+    CHECK_EQUAL(t->where().less(col, 11).count(), 110);
+    CHECK_EQUAL(t->where().greater(col, 500).count(), 1);
+
+    {
+        auto wt = db->start_write();
+        wt->get_table("foo")->remove_search_index(col);
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(t->search_index_type(col), IndexType::None);
+    CHECK_EQUAL(t->where().less(col, 11).count(), 110);
+}
+
+TEST(SortedIndex_CaseInsensitive)
+{
+    Random random(random_int<unsigned long>());
+    Group g;
+    auto t = g.add_table("foo");
+    auto col = t->add_column(type_String, "str", true);
+    auto col_plain = t->add_column(type_String, "plain", true);
+    auto col_int = t->add_column(type_Int, "int");
+    auto col_list = t->add_column_list(type_String, "list");
+    CHECK_THROW_ANY(t->add_search_index(col_int, IndexType::CaseInsensitive));
+    CHECK_THROW_ANY(t->add_search_index(col_list, IndexType::CaseInsensitive));
+    t->add_search_index(col, IndexType::CaseInsensitive);
+    CHECK_EQUAL(t->search_index_type(col), IndexType::CaseInsensitive);
+    auto index = dynamic_cast<const SortedIndex*>(t->get_search_index(col));
+    CHECK(index && index->is_case_insensitive());
+
+    const char* words[] = {"anna", "bob", "bobby", "carl", "caroline", "zoe",
+                           "\xc3\xa6" "ble", "\xc3\x86" "BLE", "", "a"};
+    auto random_case = [&](std::string str) {
+        for (auto& c : str) {
+            if (c >= 'a' && c <= 'z' && random.draw_bool())
+                c = char(c - 'a' + 'A');
+        }
+        return str;
+    };
+    auto set_random = [&](Obj obj) {
+        if (random.draw_int_mod(10) == 0) {
+            obj.set_null(col);
+            obj.set_null(col_plain);
+            return;
+        }
+        auto str = random_case(words[random.draw_int_mod(std::size(words))]);
+        obj.set(col, StringData(str));
+        obj.set(col_plain, StringData(str));
+    };
+    auto check_queries = [&] {
+        t->verify();
+        for (auto word : words) {
+            for (int i = 0; i < 3; ++i) {
+                auto str = random_case(word);
+                StringData value(str);
+                CHECK_EQUAL(t->where().equal(col, value, false).count(),
+                            t->where().equal(col_plain, value, false).count());
+                CHECK_EQUAL(t->where().begins_with(col, value, false).count(),
+                            t->where().begins_with(col_plain, value, false).count());
+                CHECK_EQUAL(t->where().equal(col, value).count(), t->where().equal(col_plain, value).count());
+                CHECK_EQUAL(t->count_string(col, value), t->count_string(col_plain, value));
+                auto key = t->find_first_string(col, value);
+                CHECK_EQUAL(key, t->find_first_string(col_plain, value));
+            }
+        }
+        CHECK_EQUAL(t->where().equal(col, StringData(), false).count(),
+                    t->where().equal(col_plain, StringData(), false).count());
+    };
+
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 100; ++i)
+            set_random(t->create_object());
+        size_t sz = t->size();
+        for (int i = 0; i < 20; ++i)
+            set_random(t->get_object(random.draw_int_mod(sz)));
+        for (int i = 0; i < 30; ++i)
+            t->get_object(random.draw_int_mod(t->size())).remove();
+        check_queries();
+    }
+
+    // Strings equal regardless of case are adjacent
+    auto [begin, end] = index->find_prefix_range("BOB");
+    for (size_t i = begin; i < end; ++i)
+        CHECK(index->get_value(i).get_string().size() >= 3);
+    CHECK_EQUAL(end - begin, t->where().begins_with(col_plain, StringData("bob"), false).count());
+
+    // Sorting is not done through the index, as it orders by case
+    auto tv = t->where().find_all();
+    tv.sort(col_plain);
+    auto tv2 = t->where().find_all();
+    tv2.sort(col);
+    for (size_t i = 0; i < tv.size(); ++i)
+        CHECK_EQUAL(tv.get_object(i).get<String>(col_plain), tv2.get_object(i).get<String>(col));
+
+    // Populating an index on existing values
+    t->add_search_index(col_plain, IndexType::CaseInsensitive);
+    check_queries();
+}
+
+TEST(SortedIndex_CaseInsensitivePersistence)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        auto t = wt->add_table("foo");
+        col = t->add_column(type_String, "email");
+        t->add_search_index(col, IndexType::Sorted);
+        t->create_object().set(col, "john@example.com");
+        t->create_object().set(col, "JOHN@example.com");
+        t->create_object().set(col, "jane@example.com");
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto t = rt->get_table("foo");
+    CHECK_EQUAL(t->where().equal(col, "John@Example.com", false).count(), 2);
+    {
+        auto wt = db->start_write();
+        wt->get_table("foo")->add_search_index(col, IndexType::CaseInsensitive);
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(t->search_index_type(col), IndexType::CaseInsensitive);
+    auto index = dynamic_cast<const SortedIndex*>(t->get_search_index(col));
+    CHECK(index && index->is_case_insensitive());
+    t->verify();
+    CHECK_EQUAL(t->where().equal(col, "John@Example.com", false).count(), 2);
+    CHECK_EQUAL(t->where().begins_with(col, StringData("J"), false).count(), 3);
+    CHECK_EQUAL(t->where().equal(col, "JOHN@example.com").count(), 1);
+}
+
+#endif // TEST_INDEX_SORTED
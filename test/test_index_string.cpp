@@ -283,6 +283,21 @@ TEST(Tokenizer_Basic)
     CHECK(tok->get_all_tokens() == std::set<std::string>({"with", "hyphen", "term", "other", "plus"}));
 }
 
+TEST(Tokenizer_SearchTokens)
+{
+    auto tok = realm::Tokenizer::get_instance();
+
+    tok->reset("Fox \"Quick, brown\" -\"lazy dog\" -cat* dog* -\"mouse\"");
+    auto tokens = tok->get_search_tokens();
+    CHECK(tokens.includes == std::set<std::string>({"fox", "quick", "brown", "dog*"}));
+    CHECK(tokens.excludes == std::set<std::string>({"cat*", "mouse"}));
+    CHECK(tokens.phrases == std::vector<realm::Phrase>({{"quick", "brown"}}));
+    CHECK(tokens.excluded_phrases == std::vector<realm::Phrase>({{"lazy", "dog"}}));
+
+    tok->reset("\"unterminated phrase");
+    CHECK_THROW(tok->get_search_tokens(), InvalidArgument);
+}
+
 TEST(StringIndex_NonIndexable)
 {
     // Create a column with string values
@@ -1836,6 +1851,78 @@ TEST_TYPES(StringIndex_Rover, string_column, nullable_string_column, enum_column
     check_result_order(results, test_context);
 }
 
+TEST(StringIndex_FindAllPrefix)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Group g;
+    auto table = g.add_table("table");
+    auto col = table->add_column(type_String, "str", true);
+    table->add_search_index(col);
+
+    // Few distinct bytes give many shared prefixes. 'X' and 0 are the bytes
+    // which the keys of the index use for the end of a string and for null.
+    const char alphabet[] = {'a', 'b', 'X', '\0'};
+    auto random_string = [&](size_t max_size) {
+        std::string str(random.draw_int<size_t>(0, max_size), 'a');
+        for (auto& c : str)
+            c = alphabet[random.draw_int<size_t>(0, 3)];
+        return str;
+    };
+    // Strings with a common prefix beyond the depth of the index
+    std::string long_prefix(StringIndex::s_max_offset + 10, 'b');
+
+    for (size_t i = 0; i < 2000; ++i) {
+        auto obj = table->create_object();
+        if (i % 50 == 0)
+            continue; // null
+        if (i % 20 == 1)
+            obj.set(col, long_prefix + random_string(3));
+        else
+            obj.set(col, random_string(10));
+    }
+
+    auto check = [&] {
+        auto index = dynamic_cast<const StringIndex*>(table->get_search_index(col));
+        CHECK(index);
+        for (size_t i = 0; i < 200; ++i) {
+            std::string prefix = random_string(9);
+            if (i % 10 == 0)
+                prefix = long_prefix.substr(0, random.draw_int<size_t>(1, long_prefix.size())) + random_string(2);
+            if (prefix.empty())
+                continue;
+            StringData prefix_data(prefix);
+
+            std::vector<ObjKey> expected;
+            for (auto& obj : *table) {
+                StringData str = obj.get<StringData>(col);
+                if (!str.is_null() && str.begins_with(prefix_data))
+                    expected.push_back(obj.get_key());
+            }
+
+            std::vector<ObjKey> found;
+            index->find_all_prefix(found, prefix_data);
+            std::sort(found.begin(), found.end());
+            CHECK(found == expected);
+
+            auto tv = table->where().begins_with(col, prefix_data).find_all();
+            CHECK_EQUAL(tv.size(), expected.size());
+            for (size_t j = 0; j < tv.size() && j < expected.size(); ++j)
+                CHECK_EQUAL(tv.get_key(j), expected[j]);
+        }
+    };
+    check();
+
+    // And after the index has been modified
+    for (size_t i = 0; i < 500; ++i) {
+        auto obj = table->get_object(random.draw_int<size_t>(0, table->size() - 1));
+        if (i % 3 == 0)
+            obj.remove();
+        else
+            obj.set(col, random_string(10));
+    }
+    check();
+}
+
 TEST(StringIndex_QuerySingleObject)
 {
     Group g;
@@ -1912,6 +1999,217 @@ TEST(StringIndex_MixedEqualBitPattern)
     CHECK_EQUAL(tv.get_object(1).get_any(col), val1);
 }
 
+TEST_TYPES(StringIndex_Build, std::true_type, std::false_type)
+{
+    // The index of `built` is built from existing values, the one of
+    // `inserted` gets the values inserted one at a time
+    bool is_large = TEST_TYPE::value;
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Group g;
+    auto built = g.add_table("built");
+    auto inserted = g.add_table("inserted");
+    for (auto table : {built, inserted}) {
+        table->add_column(type_String, "str", true);
+        table->add_column(type_Int, "int");
+        table->add_column(type_Mixed, "mixed");
+    }
+    for (auto col : inserted->get_column_keys())
+        inserted->add_search_index(col);
+
+    // Strings with long common prefixes, also beyond the depth of the index
+    std::string prefix(StringIndex::s_max_offset + 10, 'p');
+    auto make_string = [&](size_t i) -> std::string {
+        switch (i % 4) {
+            case 0:
+                return util::to_string(i % 1000);
+            case 1:
+                return prefix.substr(0, i % prefix.size()) + util::to_string(i % 37);
+            case 2:
+                // Rare, as the list they end up in is slow to insert into
+                if (i % 64 == 2)
+                    return prefix + util::to_string(i % 11);
+                return prefix.substr(0, 40) + util::to_string(i);
+            default:
+                return std::string(i % 6, 'a');
+        }
+    };
+    size_t num_objects = is_large ? 0x11000 : 2000;
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < num_objects; ++i)
+        strings.push_back(make_string(random.draw_int_mod<size_t>(num_objects * 4)));
+    for (auto table : {built, inserted}) {
+        auto col_str = table->get_column_key("str");
+        auto col_int = table->get_column_key("int");
+        auto col_mixed = table->get_column_key("mixed");
+        for (size_t i = 0; i < num_objects; ++i) {
+            // Verification expects keys less than the number of objects
+            auto obj = table->create_object(ObjKey(int64_t(i)));
+            if (i % 13)
+                obj.set(col_str, StringData(strings[i]));
+            obj.set(col_int, int64_t(i % 97) - 50);
+            switch (i % 5) {
+                case 0:
+                    obj.set(col_mixed, Mixed(int64_t(i % 50)));
+                    break;
+                case 1:
+                    obj.set(col_mixed, Mixed(StringData(strings[i])));
+                    break;
+                case 2:
+                    obj.set(col_mixed, Mixed(double(i % 7) + 0.5));
+                    break;
+                case 3:
+                    obj.set(col_mixed, Mixed(Timestamp(int64_t(i % 30), 0)));
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    for (auto col : built->get_column_keys())
+        built->add_search_index(col);
+
+    auto check_equal = [&] {
+        for (auto table : {built, inserted}) {
+            for (auto col : table->get_column_keys())
+                table->get_search_index(col)->verify();
+        }
+        for (size_t c = 0; c < 3; ++c) {
+            auto col_built = built->get_column_keys()[c];
+            auto col_inserted = inserted->get_column_keys()[c];
+            auto index_built = built->get_search_index(col_built);
+            auto index_inserted = inserted->get_search_index(col_inserted);
+            CHECK_EQUAL(index_built->has_duplicate_values(), index_inserted->has_duplicate_values());
+            std::set<Mixed> values;
+            for (auto obj : *built)
+                values.insert(obj.get_any(col_built));
+            values.insert(Mixed("not there"));
+            for (auto& value : values) {
+                std::vector<ObjKey> found_built;
+                std::vector<ObjKey> found_inserted;
+                index_built->find_all(found_built, value);
+                index_inserted->find_all(found_inserted, value);
+                CHECK(found_built == found_inserted);
+                CHECK_EQUAL(index_built->count(value), found_inserted.size());
+                CHECK_EQUAL(index_built->find_first(value), index_inserted->find_first(value));
+            }
+        }
+    };
+    check_equal();
+
+    // The built index can be updated as usual
+    for (size_t i = 0; i < num_objects / 10; ++i) {
+        ObjKey key(int64_t(random.draw_int_mod(num_objects)));
+        std::string str = make_string(random.draw_int_mod<size_t>(num_objects * 4));
+        for (auto table : {built, inserted}) {
+            auto obj = table->get_object(key);
+            if (i % 3)
+                obj.set(table->get_column_key("str"), StringData(str));
+            else
+                obj.set_null(table->get_column_key("str"));
+            obj.set(table->get_column_key("mixed"), Mixed(StringData(str)));
+        }
+    }
+    check_equal();
+}
+
+TEST(StringIndex_DeferredUpdates)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto db = DB::create(make_in_realm_history(), path);
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table_with_primary_key("table", type_Int, "_id");
+        table->add_search_index(table->add_column(type_String, "str", true));
+        table->add_search_index(table->add_column(type_Int, "int"));
+        table->add_search_index(table->add_column(type_Mixed, "mixed"));
+        wt->commit();
+    }
+
+    auto check = [&](ConstTableRef table) {
+        for (auto col : table->get_column_keys()) {
+            auto index = table->get_search_index(col);
+            std::map<Mixed, std::vector<ObjKey>> expected;
+            for (auto obj : *table)
+                expected[obj.get_any(col)].push_back(obj.get_key());
+            for (auto& [value, keys] : expected) {
+                std::vector<ObjKey> found;
+                index->find_all(found, value);
+                std::sort(found.begin(), found.end());
+                CHECK(found == keys);
+            }
+            CHECK_NOT(index->find_first(Mixed("not there")));
+        }
+    };
+
+    auto wt = db->start_write();
+    auto table = wt->get_table("table");
+    auto col_str = table->get_column_key("str");
+    auto col_int = table->get_column_key("int");
+    auto col_mixed = table->get_column_key("mixed");
+    table->set_deferred_index_updates(true);
+    CHECK(table->get_deferred_index_updates());
+    auto string_index = table->get_string_index(col_str);
+    auto change = [&](int64_t id) {
+        auto obj = table->create_object_with_primary_key(id);
+        int64_t n = random.draw_int_mod(20);
+        obj.set(col_str, util::to_string(n));
+        obj.set(col_int, n);
+        obj.set(col_mixed, n % 2 ? Mixed(n) : Mixed(util::to_string(n)));
+        // Changed again before the index is updated
+        if (n % 3 == 0)
+            obj.set(col_str, util::to_string(n + 1));
+        if (n % 5 == 0)
+            obj.set_null(col_str);
+    };
+
+    for (int64_t id = 0; id < 500; ++id)
+        change(id);
+    CHECK(string_index->has_pending_updates());
+    // Queries see the changes
+    size_t count = 0;
+    for (auto obj : *table)
+        count += obj.get<String>(col_str) == "7";
+    CHECK_EQUAL(table->where().equal(col_str, "7").count(), count);
+    CHECK_NOT(string_index->has_pending_updates());
+    check(table);
+
+    for (int64_t id = 0; id < 1000; ++id) {
+        if (id % 4 == 0) {
+            if (ObjKey key = table->find_primary_key(random.draw_int_mod(500)))
+                table->remove_object(key);
+        }
+        change(500 + id);
+        if (id % 7 == 0)
+            table->get_object_with_primary_key(500 + id).remove();
+    }
+    CHECK(string_index->has_pending_updates());
+    wt->commit_and_continue_as_read();
+    CHECK_NOT(string_index->has_pending_updates());
+    check(table);
+
+    // Pending updates are dropped on rollback
+    wt->promote_to_write();
+    for (int64_t id = 0; id < 100; ++id)
+        table->get_object(id % table->size()).set(col_int, 1000 + id);
+    CHECK(table->get_string_index(col_int)->has_pending_updates());
+    wt->rollback_and_continue_as_read();
+    CHECK_NOT(table->get_string_index(col_int)->has_pending_updates());
+    check(table);
+    CHECK_EQUAL(table->where().greater_equal(col_int, 1000).count(), 0);
+
+    // The primary key is never deferred, and turning it off applies the pending updates
+    wt->promote_to_write();
+    table->create_object_with_primary_key(5000).set(col_int, 5000);
+    CHECK_NOT(table->get_string_index(table->get_primary_key_column())->has_pending_updates());
+    table->set_deferred_index_updates(false);
+    CHECK_NOT(table->get_string_index(col_int)->has_pending_updates());
+    table->create_object_with_primary_key(5001).set(col_int, 5000);
+    CHECK_NOT(table->get_string_index(col_int)->has_pending_updates());
+    CHECK_EQUAL(table->where().equal(col_int, 5000).count(), 2);
+    check(table);
+}
+
 TEST(Unicode_Casemap)
 {
     std::string inp = "±ÀÁÂÃÄÅÆÈÉÊËÌÍÎÏÑÒÓÔÕÖØÙÚÛÜÝß×÷";
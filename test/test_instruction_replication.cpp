@@ -420,6 +420,60 @@ TEST(InstructionReplication_SetLink)
     }
 }
 
+TEST(InstructionReplication_RepeatedObjects)
+{
+    Fixture fixture{test_context};
+    {
+        WriteTransaction wt{fixture.sg_1};
+        TableRef foo = wt.get_group().add_table_with_primary_key("class_foo", type_String, "id");
+        TableRef bar = wt.get_group().add_table_with_primary_key("class_bar", type_Int, "id");
+        ColKey foo_i = foo->add_column(type_Int, "i");
+        foo->add_column(*bar, "l");
+        for (int i = 0; i < 100; ++i)
+            foo->create_object_with_primary_key(util::format("foo %1", i)).set(foo_i, i);
+        for (int i = 0; i < 10; ++i)
+            bar->create_object_with_primary_key(i);
+        wt.commit();
+    }
+    fixture.replay_transactions();
+    fixture.check_equal();
+
+    // Each object is referred to by many instructions, and some of them are
+    // erased and created again in between
+    {
+        WriteTransaction wt{fixture.sg_1};
+        TableRef foo = wt.get_table("class_foo");
+        TableRef bar = wt.get_table("class_bar");
+        for (int round = 0; round < 3; ++round) {
+            for (int i = 0; i < 100; ++i) {
+                auto obj = foo->get_object_with_primary_key(util::format("foo %1", i));
+                obj.add_int("i", 1000);
+                obj.set("l", bar->get_object_with_primary_key((i + round) % 10).get_key());
+            }
+            foo->get_object_with_primary_key(util::format("foo %1", round)).remove();
+            foo->create_object_with_primary_key(util::format("foo %1", round)).set("i", -1);
+            bar->get_object_with_primary_key(round).remove();
+            bar->create_object_with_primary_key(round);
+        }
+        foo->create_object_with_primary_key("foo 100").set("l", bar->get_object_with_primary_key(9).get_key());
+        wt.commit();
+    }
+    fixture.replay_transactions();
+    fixture.check_equal();
+    {
+        ReadTransaction rt{fixture.sg_2};
+        ConstTableRef foo = rt.get_table("class_foo");
+        ConstTableRef bar = rt.get_table("class_bar");
+        CHECK_EQUAL(foo->size(), 101);
+        CHECK_EQUAL(foo->get_object_with_primary_key("foo 1").get<Int>("i"), 999);
+        CHECK_EQUAL(foo->get_object_with_primary_key("foo 50").get<Int>("i"), 3050);
+        // The link to bar 2 was removed along with it
+        CHECK_NOT(foo->get_object_with_primary_key("foo 50").get<ObjKey>("l"));
+        auto linked = foo->get_object_with_primary_key("foo 51").get<ObjKey>("l");
+        CHECK_EQUAL(bar->get_object(linked).get_primary_key(), Mixed(3));
+    }
+}
+
 TEST(InstructionReplication_AddInteger)
 {
     Fixture fixture{test_context};
@@ -448,6 +502,93 @@ TEST(InstructionReplication_AddInteger)
     }
 }
 
+TEST(InstructionReplication_Coalesce)
+{
+    Fixture fixture{test_context};
+    {
+        WriteTransaction wt{fixture.sg_1};
+        TableRef foo = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+        foo->add_column(type_String, "s");
+        foo->add_column(type_Int, "i");
+        foo->add_column_list(type_String, "l");
+        foo->create_object_with_primary_key(0).get_list<String>("l").add("first");
+        TableRef bar = wt.get_group().add_table("class_bar");
+        bar->add_column(type_String, "s");
+        bar->add_column_list(type_String, "l");
+        wt.commit();
+    }
+    fixture.replay_transactions();
+    {
+        WriteTransaction wt{fixture.sg_1};
+        TableRef foo = wt.get_table("class_foo");
+        TableRef bar = wt.get_table("class_bar");
+        auto obj = foo->create_object_with_primary_key(1);
+        for (int i = 0; i < 10; ++i)
+            obj.set("s", util::format("value %1", i));
+        for (int i = 0; i < 10; ++i)
+            obj.add_int("i", i);
+        auto list = obj.get_list<String>("l");
+        list.add("a");
+        list.set(0, "b");
+        list.add("c");
+        list.remove(1);
+
+        // An object without a primary key which is removed again before
+        // anything else has referred to it leaves nothing behind
+        auto temp = bar->create_object();
+        temp.set("s", "temporary");
+        temp.get_list<String>("l").add("temporary");
+        temp.remove();
+
+        // Another client may create an object with the same primary key, so
+        // both the creation and the erasure are kept
+        foo->create_object_with_primary_key(2).remove();
+
+        // Changes to another object in between keep the ones before
+        auto existing = foo->get_object_with_primary_key(0);
+        existing.add_int("i", 1);
+        existing.get_list<String>("l").insert(0, "a");
+        existing.set("s", "x");
+        existing.get_list<String>("l").set(0, "b");
+        existing.add_int("i", 1);
+        wt.commit();
+    }
+
+    Changeset changeset;
+    const auto& buffer = fixture.history_1->get_instruction_encoder().buffer();
+    util::SimpleInputStream stream{buffer};
+    sync::parse_changeset(stream, changeset);
+    std::vector<Instruction::Type> types;
+    for (auto instr : changeset) {
+        if (instr)
+            types.push_back(instr->type());
+    }
+    using Type = Instruction::Type;
+    std::vector<Instruction::Type> expected = {
+        Type::CreateObject, Type::Update, Type::AddInteger, Type::ArrayInsert, Type::CreateObject, Type::EraseObject,
+        Type::AddInteger,   Type::ArrayInsert, Type::Update, Type::Update,      Type::AddInteger,
+    };
+    CHECK(types == expected);
+
+    fixture.replay_transactions();
+    fixture.check_equal();
+    {
+        ReadTransaction rt{fixture.sg_2};
+        ConstTableRef foo = rt.get_table("class_foo");
+        CHECK_EQUAL(foo->size(), 2);
+        CHECK_EQUAL(rt.get_table("class_bar")->size(), 0);
+        auto obj = foo->get_object_with_primary_key(1);
+        CHECK_EQUAL(obj.get<String>("s"), "value 9");
+        CHECK_EQUAL(obj.get<Int>("i"), 45);
+        auto list = obj.get_list<String>("l");
+        CHECK_EQUAL(list.size(), 1);
+        CHECK_EQUAL(list.get(0), "b");
+        auto existing = foo->get_object_with_primary_key(0);
+        CHECK_EQUAL(existing.get<Int>("i"), 2);
+        CHECK_EQUAL(existing.get_list<String>("l").get(0), "b");
+    }
+}
+
 TEST(InstructionReplication_ListSwap)
 {
     Fixture fixture{test_context};
@@ -644,6 +785,35 @@ TEST(InstructionReplication_NullablePrimaryKeys)
     }
 }
 
+TEST(InstructionReplication_BulkCreateObjects)
+{
+    Fixture fixture{test_context};
+    const size_t num_objects = 2 * REALM_MAX_BPNODE_SIZE + 3;
+    {
+        WriteTransaction wt{fixture.sg_1};
+        TableRef t = wt.get_group().add_table("class_t");
+        ColKey col_int = t->add_column(type_Int, "i");
+        ColKey col_str = t->add_column(type_String, "s", true);
+        t->add_search_index(col_str);
+        std::vector<BulkColumn> columns{{col_int, {}}, {col_str, {}}};
+        for (size_t i = 0; i < num_objects; ++i) {
+            columns[0].values.push_back(int64_t(i));
+            columns[1].values.push_back(i % 2 ? Mixed("odd") : Mixed());
+        }
+        auto keys = t->bulk_create_objects(num_objects, columns);
+        CHECK_EQUAL(keys.size(), num_objects);
+        wt.commit();
+    }
+    fixture.replay_transactions();
+    fixture.check_equal();
+    {
+        ReadTransaction rt{fixture.sg_2};
+        ConstTableRef t = rt.get_table("class_t");
+        CHECK_EQUAL(t->size(), num_objects);
+        CHECK_EQUAL(t->where().equal(t->get_column_key("s"), "odd").count(), num_objects / 2);
+    }
+}
+
 TEST(InstructionReplication_Dictionary)
 {
     Fixture fixture{test_context};
@@ -27,6 +27,7 @@
 #include <chrono>
 
 #include <realm.hpp>
+#include <realm/util/buffer_stream.hpp>
 #include <external/json/json.hpp>
 #include <external/bson/bson.h>
 
@@ -695,6 +696,45 @@ TEST(Json_Nulls)
     CHECK(json_test(ss.str(), "expected_json_nulls", generate_all));
 }
 
+TEST(Json_CallbackOutputStream)
+{
+    Group group;
+
+    TableRef table = group.add_table("table");
+    ColKey str_col = table->add_column(type_String, "str_col");
+    ColKey bin_col = table->add_column(type_Binary, "bin_col");
+    ColKey double_col = table->add_column(type_Double, "double_col");
+    std::string long_string(5000, 'a');
+    long_string[100] = '"';
+    long_string[4000] = '\n';
+    std::string binary(10000, 'b');
+    for (int i = 0; i < 20; ++i) {
+        table->create_object()
+            .set(str_col, i % 2 ? StringData(long_string) : StringData("tab\tquote\""))
+            .set(bin_col, BinaryData(binary.data(), i * 500))
+            .set(double_col, i / 3.0);
+    }
+
+    for (auto mode : {output_mode_json, output_mode_xjson, output_mode_xjson_plus}) {
+        std::stringstream expected;
+        table->to_json(expected, mode);
+
+        std::string output;
+        size_t num_chunks = 0;
+        {
+            CallbackOutputStream out(
+                [&](Span<const char> chunk) {
+                    output.append(chunk.data(), chunk.size());
+                    ++num_chunks;
+                },
+                1024);
+            table->to_json(out, mode);
+        }
+        CHECK_EQUAL(output, expected.str());
+        CHECK_GREATER(num_chunks, 1);
+    }
+}
+
 TEST(Json_Schema)
 {
     Group group;
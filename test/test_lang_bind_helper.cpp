@@ -2197,6 +2197,60 @@ TEST_TYPES(LangBindHelper_AdvanceReadTransact_TransactLog, AdvanceReadTransact,
     }
 }
 
+TEST(LangBindHelper_AdvanceReadTransact_IgnoredTables)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef sg = DB::create(*hist, path, DBOptions(crypt_key()));
+    std::vector<TableKey> tables;
+    {
+        WriteTransaction wt(sg);
+        for (int i = 0; i < 10; ++i)
+            tables.push_back(wt.add_table(util::format("table %1", i))->get_key());
+        wt.commit();
+    }
+
+    struct Parser : _impl::NoOpTransactionLogParser {
+        std::vector<TableKey> created_in;
+        bool create_object(ObjKey)
+        {
+            created_in.push_back(get_current_table());
+            return true;
+        }
+    };
+    struct FilteringParser : Parser {
+        TableKey ignored;
+        bool ignores_tables(const std::vector<TableKey>& keys) const
+        {
+            return keys.size() == 1 && keys[0] == ignored;
+        }
+    };
+    Parser parser;
+    FilteringParser filtering_parser;
+    filtering_parser.ignored = tables[0];
+    auto tr = sg->start_read();
+    auto filtering_tr = sg->start_read();
+
+    auto create_objects = [&](size_t num_tables) {
+        WriteTransaction wt(sg);
+        for (size_t i = 0; i < num_tables; ++i)
+            wt.get_table(tables[i])->create_object();
+        wt.commit();
+    };
+    create_objects(1);
+    create_objects(2);
+    // Too many tables for the summary, so this is never skipped
+    create_objects(10);
+
+    tr->advance_read(&parser);
+    filtering_tr->advance_read(&filtering_parser);
+    CHECK_EQUAL(parser.created_in.size(), 13);
+    CHECK_EQUAL(filtering_parser.created_in.size(), 12);
+    CHECK(std::equal(filtering_parser.created_in.begin(), filtering_parser.created_in.end(),
+                     parser.created_in.begin() + 1));
+    CHECK_EQUAL(filtering_tr->get_table(tables[0])->size(), 3);
+}
+
 
 TEST(LangBindHelper_AdvanceReadTransact_ErrorInObserver)
 {
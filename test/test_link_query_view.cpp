@@ -958,6 +958,174 @@ TEST(Link_FirstResultPastRow1000)
     CHECK_EQUAL(1, tv.size());
 }
 
+TEST(Link_QueryThroughThreeLinks)
+{
+    Group g;
+    TableRef a = g.add_table("a");
+    TableRef b = g.add_table("b");
+    TableRef c = g.add_table("c");
+    TableRef d = g.add_table("d");
+    auto col_value = d->add_column(type_Int, "value", true);
+    auto col_name = d->add_column(type_String, "name");
+    auto col_d = c->add_column(*d, "d");
+    auto col_c = b->add_column(*c, "c");
+    auto col_b = a->add_column(*b, "b");
+
+    std::mt19937 rng(7);
+    auto random_key = [&](const std::vector<ObjKey>& keys) {
+        size_t ndx = rng() % (keys.size() + 1);
+        return ndx == keys.size() ? ObjKey() : keys[ndx];
+    };
+    std::vector<ObjKey> d_keys, c_keys, b_keys, a_keys;
+    d->create_objects(200, d_keys);
+    for (size_t i = 0; i < d_keys.size(); i++) {
+        Obj obj = d->get_object(d_keys[i]);
+        if (i % 7)
+            obj.set(col_value, int64_t(i));
+        obj.set(col_name, util::format("name %1", i % 10));
+    }
+    c->create_objects(300, c_keys);
+    for (auto key : c_keys) {
+        c->get_object(key).set(col_d, random_key(d_keys));
+    }
+    b->create_objects(500, b_keys);
+    for (auto key : b_keys) {
+        b->get_object(key).set(col_c, random_key(c_keys));
+    }
+    a->create_objects(3000, a_keys);
+    // The links from 'a' go to the objects of 'b' in no particular order
+    for (auto key : a_keys) {
+        a->get_object(key).set(col_b, random_key(b_keys));
+    }
+    // Removed objects leave null links, and a tombstone leaves unresolved links
+    for (size_t i = 0; i < c_keys.size(); i += 13) {
+        c->remove_object(c_keys[i]);
+    }
+    d->get_object(d_keys[3]).invalidate();
+
+    auto target_of = [&](ObjKey key) {
+        Obj obj = a->get_object(key);
+        for (ColKey col : {col_b, col_c, col_d}) {
+            ObjKey next = obj.get<ObjKey>(col);
+            if (!next)
+                return Obj();
+            obj = obj.get_target_table(col)->get_object(next);
+        }
+        return obj;
+    };
+    size_t expected_greater = 0;
+    size_t expected_name = 0;
+    size_t expected_null = 0;
+    for (auto key : a_keys) {
+        Obj target = target_of(key);
+        if (!target) {
+            expected_null++;
+            continue;
+        }
+        if (!target.is_null(col_value) && target.get<util::Optional<Int>>(col_value) > 50)
+            expected_greater++;
+        if (target.get<String>(col_name) == "name 4")
+            expected_name++;
+    }
+    CHECK_GREATER(expected_null, 0);
+
+    CHECK_EQUAL(a->query("b.c.d.value > 50").count(), expected_greater);
+    CHECK_EQUAL(a->query("b.c.d.name == 'name 4'").count(), expected_name);
+    CHECK_EQUAL(a->query("b.c.d == NULL").count(), expected_null);
+    CHECK_EQUAL((a->link(col_b).link(col_c).link(col_d).column<Int>(col_value) > 50).count(), expected_greater);
+
+    TableView tv = a->query("b.c.d.value > 50").find_all();
+    for (size_t i = 0; i < tv.size(); i++) {
+        CHECK_GREATER(*target_of(tv.get_key(i)).get<util::Optional<Int>>(col_value), 50);
+    }
+}
+
+TEST(LinkList_QueryBySemiJoin)
+{
+    Group g;
+    TableRef parents = g.add_table("parents");
+    TableRef targets = g.add_table("targets");
+    auto col_value = targets->add_column(type_Int, "value");
+    auto col_name = targets->add_column(type_String, "name");
+    auto col_list = parents->add_column_list(*targets, "list");
+
+    std::mt19937 rng(3);
+    std::vector<ObjKey> target_keys, parent_keys;
+    targets->create_objects(200, target_keys);
+    for (size_t i = 0; i < target_keys.size(); i++) {
+        targets->get_object(target_keys[i]).set(col_value, int64_t(i)).set(col_name, util::format("n%1", i % 17));
+    }
+    parents->create_objects(1000, parent_keys);
+    for (auto key : parent_keys) {
+        auto list = parents->get_object(key).get_linklist(col_list);
+        // Some lists are empty and some link to the same object more than once
+        size_t len = rng() % 4;
+        for (size_t i = 0; i < len; i++) {
+            list.add(target_keys[rng() % 40]);
+        }
+    }
+
+    auto check = [&](const std::string& query, auto&& pred) {
+        size_t expected = 0;
+        for (auto key : parent_keys) {
+            auto list = parents->get_object(key).get_linklist(col_list);
+            size_t cnt = 0;
+            for (size_t i = 0; i < list.size(); i++) {
+                cnt += pred(list.get_object(i));
+            }
+            expected += cnt > 0;
+        }
+        CHECK_EQUAL(parents->query(query).count(), expected);
+    };
+    auto check_count = [&](const std::string& query, size_t count, auto&& pred) {
+        size_t expected = 0;
+        for (auto key : parent_keys) {
+            auto list = parents->get_object(key).get_linklist(col_list);
+            size_t cnt = 0;
+            for (size_t i = 0; i < list.size(); i++) {
+                cnt += pred(list.get_object(i));
+            }
+            expected += cnt == count;
+        }
+        CHECK_EQUAL(parents->query(query).count(), expected);
+    };
+    auto value = [&](const Obj& obj) {
+        return obj.get<Int>(col_value);
+    };
+
+    // Fewer targets than parents
+    check("list.value > 30", [&](const Obj& obj) {
+        return value(obj) > 30;
+    });
+    check("30 < list.value", [&](const Obj& obj) {
+        return value(obj) > 30;
+    });
+    check("list.value != 5", [&](const Obj& obj) {
+        return value(obj) != 5;
+    });
+    check("list.name BEGINSWITH 'n1'", [&](const Obj& obj) {
+        return obj.get<String>(col_name).begins_with("n1");
+    });
+    check_count("SUBQUERY(list, $x, $x.value < 10).@count == 2", 2, [&](const Obj& obj) {
+        return value(obj) < 10;
+    });
+    check_count("SUBQUERY(list, $x, $x.value < 10 && $x.name == 'n3').@count == 1", 1, [&](const Obj& obj) {
+        return value(obj) < 10 && obj.get<String>(col_name) == "n3";
+    });
+    CHECK_EQUAL(parents->query("ALL list.value < 40").count(), parents->size());
+    CHECK_EQUAL(parents->query("NONE list.value > 40").count(), parents->size());
+
+    // More targets than parents
+    std::vector<ObjKey> more_keys;
+    targets->create_objects(2000, more_keys);
+    check("list.value > 30", [&](const Obj& obj) {
+        return value(obj) > 30;
+    });
+    check_count("SUBQUERY(list, $x, $x.value < 10).@count == 2", 2, [&](const Obj& obj) {
+        return value(obj) < 10;
+    });
+}
+
 // Tests queries on a LinkList
 TEST(LinkList_QueryOnLinkList)
 {
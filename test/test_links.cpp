@@ -369,9 +369,10 @@ TEST(Links_Multi)
 
     // remove a row
     table2->remove_object(k0);
+    // backlinks are ordered by key
     CHECK_EQUAL(2, obj1.get_backlink_count(*table2, col_link));
-    CHECK_EQUAL(k2, obj1.get_backlink(*table2, col_link, 0));
-    CHECK_EQUAL(k1, obj1.get_backlink(*table2, col_link, 1));
+    CHECK_EQUAL(k1, obj1.get_backlink(*table2, col_link, 0));
+    CHECK_EQUAL(k2, obj1.get_backlink(*table2, col_link, 1));
 
     // add some more links and see that they get nullified when the target
     // is removed
@@ -1115,6 +1116,61 @@ TEST(Links_RemoveTargetRows)
 }
 #endif
 
+TEST(Links_HighFanIn)
+{
+    Group group;
+    auto target = group.add_table("target");
+    auto origin = group.add_table("origin");
+    auto col_link = origin->add_column(*target, "link");
+    auto col_links = origin->add_column_list(*target, "links");
+    auto hot = target->create_object();
+    auto cold = target->create_object();
+
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 3000; i++) {
+        keys.push_back(origin->create_object().get_key());
+    }
+    std::vector<ObjKey> shuffled = keys;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+    for (auto key : shuffled) {
+        origin->get_object(key).set(col_link, hot.get_key());
+    }
+    origin->get_object(keys[0]).get_linklist(col_links).add(cold.get_key());
+    origin->get_object(keys[0]).get_linklist(col_links).add(cold.get_key());
+
+    // Backlinks are kept ordered by key whatever the order they were added in
+    CHECK_EQUAL(hot.get_backlink_count(), 3000);
+    auto backlinks = [&] {
+        std::vector<ObjKey> result;
+        for (size_t i = 0; i < hot.get_backlink_count(*origin, col_link); i++) {
+            result.push_back(hot.get_backlink(*origin, col_link, i));
+        }
+        return result;
+    };
+    CHECK(backlinks() == keys);
+
+    std::set<ObjKey> remaining(keys.begin(), keys.end());
+    for (size_t i = 0; i < shuffled.size(); i += 2) {
+        origin->get_object(shuffled[i]).set_null(col_link);
+        remaining.erase(shuffled[i]);
+    }
+    CHECK_EQUAL(hot.get_backlink_count(), remaining.size());
+    CHECK(backlinks() == std::vector<ObjKey>(remaining.begin(), remaining.end()));
+    for (auto key : remaining) {
+        hot.verify_backlink(*origin, col_link, key);
+    }
+    CHECK_EQUAL(cold.get_backlink_count(), 2);
+
+    CHECK_EQUAL(target->query(util::format("@links.@count == %1", remaining.size())).count(), 1);
+    CHECK_EQUAL(target->query("@links.@count == 2").find(), cold.get_key());
+
+    // Removing the sources leaves the target without backlinks
+    origin->clear();
+    CHECK_EQUAL(hot.get_backlink_count(), 0);
+    CHECK_EQUAL(cold.get_backlink_count(), 0);
+    group.verify();
+}
+
 TEST(Links_ClearColumnWithTwoLevelBptree)
 {
     Group group;
@@ -106,6 +106,50 @@ TEST(List_basic)
     table.remove_object(ObjKey(5));
 }
 
+TEST(List_InsertRange)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    auto reader = db->start_read();
+
+    auto tr = db->start_write();
+    auto table = tr->add_table("table");
+    auto col_int = table->add_column_list(type_Int, "ints");
+    auto col_str = table->add_column_list(type_String, "strings", true);
+    auto obj = table->create_object();
+    auto ints = obj.get_list<Int>(col_int);
+    auto strings = obj.get_list<String>(col_str);
+
+    std::vector<Int> values;
+    for (int i = 0; i < 2500; i++) {
+        values.push_back(i * 2);
+    }
+    ints.insert_range(0, values);
+    CHECK_EQUAL(ints.size(), 2500);
+    ints.insert_range(ints.size(), {-1, -2});
+    ints.insert_range(1, {1, 3, 5});
+    CHECK_EQUAL(ints.size(), 2505);
+    CHECK_EQUAL(ints.get(0), 0);
+    CHECK_EQUAL(ints.get(1), 1);
+    CHECK_EQUAL(ints.get(3), 5);
+    CHECK_EQUAL(ints.get(4), 2);
+    CHECK_EQUAL(ints.get(2502), 4998);
+    CHECK_EQUAL(ints.get(2504), -2);
+    CHECK_THROW_ANY(ints.insert_range(ints.size() + 1, {1}));
+
+    strings.insert_range_any(0, {Mixed("a"), Mixed(), Mixed("c")});
+    CHECK_EQUAL(strings.size(), 3);
+    CHECK(strings.is_null(1));
+    CHECK_EQUAL(strings.get(2), "c");
+    tr->commit_and_continue_as_read();
+
+    reader->advance_read();
+    auto list = reader->get_table("table")->get_object(obj.get_key()).get_list<Int>(col_int);
+    CHECK_EQUAL(list.size(), 2505);
+    CHECK_EQUAL(list.get(3), 5);
+    CHECK_EQUAL(list.get(2504), -2);
+}
+
 TEST(List_SimpleTypes)
 {
     Group g;
@@ -1023,6 +1067,40 @@ TEST(List_NestedList_Path)
     }
 }
 
+TEST(List_Nested_MovedCollections)
+{
+    Group g;
+    auto table = g.add_table("foo");
+    auto col_any = table->add_column(type_Mixed, "Any");
+    Obj obj = table->create_object();
+    obj.set_collection(col_any, CollectionType::List);
+    auto list = obj.get_list_ptr<Mixed>(col_any);
+
+    std::vector<std::shared_ptr<Lst<Mixed>>> nested;
+    for (int i = 0; i < 10; i++) {
+        list->insert_collection(i, CollectionType::List);
+        nested.push_back(list->get_list(i));
+        nested.back()->add(Mixed(i));
+    }
+    // Look up every nested list once so that its position is known
+    for (int i = 0; i < 10; i++)
+        CHECK_EQUAL(nested[i]->get(0), Mixed(i));
+
+    // Shifting the nested lists around must not make the accessors find the wrong ones
+    list->insert(0, Mixed("first"));
+    list->remove(5);
+    for (int i = 0; i < 10; i++) {
+        if (i == 4) {
+            CHECK_THROW(nested[i]->size(), StaleAccessor);
+            continue;
+        }
+        CHECK_EQUAL(nested[i]->get(0), Mixed(i));
+        auto path = nested[i]->get_path();
+        CHECK_EQUAL(list->get_list(path.path_from_top[1].get_ndx())->get(0), Mixed(i));
+    }
+    CHECK_EQUAL(list->get_list(8)->get(0), Mixed(8));
+}
+
 TEST(List_Nested_Replication)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -20,6 +20,7 @@
 
 #include <realm.hpp>
 #include <realm/parser/keypath_mapping.hpp>
+#include <realm/parser/query_cache.hpp>
 #include <realm/parser/query_parser.hpp>
 #if defined(TEST_PARSER)
 
@@ -5965,6 +5966,217 @@ TEST(Parser_Threads)
         w.join();
 }
 
+TEST(Parser_QueryCache)
+{
+    Group g;
+    auto persons = g.add_table("class_person");
+    auto col_name = persons->add_column(type_String, "name");
+    auto col_age = persons->add_column(type_Int, "age");
+    auto col_scores = persons->add_column_list(type_Int, "scores");
+    auto col_friend = persons->add_column(*persons, "best_friend");
+    auto col_friends = persons->add_column_list(*persons, "friends");
+    std::vector<Obj> objs;
+    for (int64_t i = 0; i < 20; i++) {
+        auto obj = persons->create_object().set(col_name, util::format("name %1", i % 5)).set(col_age, i * 3);
+        auto scores = obj.get_list<Int>(col_scores);
+        for (int64_t j = 0; j < i % 4; j++)
+            scores.add(i + j);
+        objs.push_back(obj);
+    }
+    for (size_t i = 0; i < objs.size(); i++) {
+        objs[i].set(col_friend, objs[(i * 7) % objs.size()].get_key());
+        auto friends = objs[i].get_linklist(col_friends);
+        for (size_t j = 0; j < i % 3; j++)
+            friends.add(objs[(i + j + 1) % objs.size()].get_key());
+    }
+
+    // Building the same query from the cache must give the same result as parsing it
+    query_parser::QueryCache cache;
+    auto check = [&](const std::string& str, const std::vector<Mixed>& args) {
+        Query expected = persons->query(str, args);
+        Query actual = cache.query(persons, str, args);
+        CHECK_EQUAL(actual.get_description(), expected.get_description());
+        CHECK_EQUAL(actual.find_all().size(), expected.find_all().size());
+    };
+    std::vector<std::pair<std::string, std::vector<std::vector<Mixed>>>> queries = {
+        {"age > $0", {{10}, {40}}},
+        {"name == $0 AND age < $1", {{"name 1", 30}, {"name 3", 100}}},
+        {"friends.@count > $0", {{0}, {1}}},
+        {"@links.person.best_friend.@count > $0", {{0}, {1}}},
+        {"@links.@count > $0", {{1}, {2}}},
+        {"best_friend.friends.age > $0", {{10}, {50}}},
+        {"scores[0] == $0", {{5}, {10}}},
+        {"scores[LAST] >= $0 OR NOT age < $1", {{5, 10}, {20, 3}}},
+        {"SUBQUERY(friends, $x, $x.age > $0).@count > 0", {{10}, {50}}},
+        {"age > $0 SORT(age DESC) LIMIT(3)", {{5}, {20}}},
+        {"best_friend == $0", {{objs[3].get_key()}, {Mixed()}}},
+    };
+    for (int round = 0; round < 2; round++) {
+        for (auto& [str, arg_sets] : queries) {
+            for (auto& args : arg_sets)
+                check(str, args);
+        }
+    }
+    // The last query has arguments of two different types
+    auto metrics = cache.get_metrics();
+    CHECK_EQUAL(metrics.size, 12);
+    CHECK_EQUAL(metrics.misses, 12);
+    CHECK_EQUAL(metrics.hits, 32);
+    CHECK_EQUAL(metrics.evictions, 0);
+    CHECK_EQUAL(metrics.hit_rate(), 32.0 / 44);
+
+    // The least recently used entries are evicted
+    query_parser::QueryCache small_cache(2);
+    CHECK_EQUAL(small_cache.get_max_entries(), 2);
+    small_cache.query(persons, "age > 1");
+    small_cache.query(persons, "age > 2");
+    small_cache.query(persons, "age > 1");
+    small_cache.query(persons, "age > 3");
+    metrics = small_cache.get_metrics();
+    CHECK_EQUAL(metrics.size, 2);
+    CHECK_EQUAL(metrics.evictions, 1);
+    small_cache.query(persons, "age > 1");
+    CHECK_EQUAL(small_cache.get_metrics().hits, 2);
+    small_cache.query(persons, "age > 2");
+    CHECK_EQUAL(small_cache.get_metrics().misses, 4);
+
+    // Whitespace is insignificant, except in string literals
+    cache.clear();
+    CHECK_EQUAL(query_parser::QueryCache::normalize("  age  >\t$0\n AND name == 'a  b' "),
+                "age > $0 AND name == 'a  b'");
+    CHECK_EQUAL(query_parser::QueryCache::normalize("name == \"x\\\"  y\""), "name == \"x\\\"  y\"");
+    cache.query(persons, "age > $0", {1});
+    cache.query(persons, " age>  $0 ", {2});
+    CHECK_EQUAL(cache.get_metrics().size, 2);
+    cache.query(persons, "age   > $0", {3});
+    CHECK_EQUAL(cache.get_metrics().size, 2);
+    CHECK_EQUAL(cache.query(persons, "name == 'name  1'").count(), 0);
+    CHECK_EQUAL(cache.query(persons, "name == 'name 1'").count(), 4);
+
+    // The argument types are part of the key
+    cache.clear();
+    cache.query(persons, "age > $0", {1});
+    cache.query(persons, "age > $0", {1.5});
+    cache.query(persons, "age > $0", {Mixed()});
+    CHECK_EQUAL(cache.get_metrics().size, 3);
+
+    // Key path arguments change the parse tree, so they are not cached
+    cache.clear();
+    CHECK_EQUAL(cache.query(persons, "$K0 > 30", {"age"}).count(), 9);
+    CHECK_EQUAL(cache.query(persons, "$K0 > 30", {"age"}).count(), 9);
+    CHECK_EQUAL(cache.get_metrics().size, 0);
+
+    // Errors are reported as when parsing directly
+    CHECK_THROW_ANY(cache.query(persons, "age >", {}));
+    CHECK_THROW_ANY(cache.query(persons, "agee > 5", {}));
+    CHECK_THROW_ANY(cache.query(persons, "age > $0", {}));
+    CHECK_EQUAL(cache.query(persons, "age > $0", {30}).count(), 9);
+}
+
+TEST(Parser_QueryCacheTransactions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef db = DB::create(*hist, path);
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("Foo");
+        auto col_int = table->add_column(type_Int, "value");
+        for (int i = 0; i < 1000; i++) {
+            table->create_object().set(col_int, i);
+        }
+        wt->commit();
+    }
+
+    // A cached query can be built for tables in later transactions
+    query_parser::QueryCache cache;
+    auto rt = db->start_read();
+    CHECK_EQUAL(cache.query(rt->get_table("Foo"), "value < $0", {100}).count(), 100);
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("Foo");
+        CHECK_EQUAL(cache.query(table, "value < $0", {200}).count(), 200);
+        table->create_object().set("value", 5);
+        CHECK_EQUAL(cache.query(table, "value < $0", {200}).count(), 201);
+        wt->commit();
+    }
+    auto rt2 = db->start_read();
+    CHECK_EQUAL(cache.query(rt2->get_table("Foo"), "value < $0", {10}).count(), 11);
+    CHECK_EQUAL(cache.query(rt->get_table("Foo"), "value < $0", {10}).count(), 10);
+
+    // Several threads may use the cache, and the same entry, at the same time
+    auto frozen = rt2->freeze();
+    auto table = frozen->get_table("Foo");
+    const int num_threads = 4;
+    std::vector<std::thread> workers;
+    for (int j = 0; j < num_threads; ++j) {
+        workers.emplace_back([&, j] {
+            for (int64_t i = 0; i < 200; i++) {
+                auto str = (i + j) % 2 ? "value == $0" : "value == $0 || value == $1";
+                CHECK_EQUAL(cache.query(table, str, {i, 2000}).count(), i == 5 ? 2 : 1);
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    auto metrics = cache.get_metrics();
+    CHECK_EQUAL(metrics.size, 3);
+    CHECK_EQUAL(metrics.hits + metrics.misses, 5 + num_threads * 200);
+    CHECK_GREATER_EQUAL(metrics.hits, 5 + num_threads * 200 - num_threads * 2);
+}
+
+TEST(Parser_PreparedQuery)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef db = DB::create(*hist, path);
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("Foo");
+        auto col_int = table->add_column(type_Int, "value");
+        auto col_str = table->add_column(type_String, "name");
+        for (int i = 0; i < 100; i++) {
+            table->create_object().set(col_int, i).set(col_str, util::format("name %1", i % 10));
+        }
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    std::vector<Mixed> args = {0, "name 3"};
+    query_parser::PreparedQuery prepared(rt->get_table("Foo"), "value >= $0 AND name == $1 SORT(value DESC)", args);
+    CHECK_EQUAL(prepared.get_query_string(), "value >= $0 AND name == $1 SORT(value DESC)");
+    CHECK_EQUAL(prepared.bind(rt->get_table("Foo"), {50, "name 3"}).count(), 5);
+    CHECK_EQUAL(prepared.bind(rt->get_table("Foo"), {0, "name 1"}).count(), 10);
+    // Argument types are checked when binding
+    CHECK_THROW_ANY(prepared.bind(rt->get_table("Foo"), {0, 1}).count());
+    CHECK_THROW_ANY(prepared.bind(rt->get_table("Foo"), {0}));
+    // The ordering is part of the bound query
+    TableView tv = prepared.bind(rt->get_table("Foo"), {90, "name 5"}).find_all();
+    CHECK_EQUAL(tv.size(), 1);
+    CHECK_EQUAL(tv[0].get<Int>("value"), 95);
+
+    // The prepared query can be used with the table in later transactions
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("Foo");
+        table->create_object().set("value", 500).set("name", "name 3");
+        CHECK_EQUAL(prepared.bind(table, {50, "name 3"}).count(), 6);
+        wt->commit();
+    }
+    CHECK_EQUAL(prepared.bind(db->start_read()->get_table("Foo"), {50, "name 3"}).count(), 6);
+    CHECK_EQUAL(prepared.bind(rt->get_table("Foo"), {50, "name 3"}).count(), 5);
+
+    // Errors in the query are reported when preparing
+    CHECK_THROW_ANY(query_parser::PreparedQuery(rt->get_table("Foo"), "missing == $0", args));
+    CHECK_THROW_ANY(query_parser::PreparedQuery(rt->get_table("Foo"), "value == ", args));
+
+    // Queries whose structure depends on the arguments are parsed on each bind
+    std::vector<Mixed> key_path_args = {"value", 10};
+    query_parser::PreparedQuery by_key_path(rt->get_table("Foo"), "$K0 == $1", key_path_args);
+    CHECK_EQUAL(by_key_path.bind(rt->get_table("Foo"), {"value", 10}).count(), 1);
+    CHECK_EQUAL(by_key_path.bind(rt->get_table("Foo"), {"name", "name 1"}).count(), 10);
+}
+
 TEST(Parser_UTF8)
 {
     Group g;
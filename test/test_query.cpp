@@ -3086,6 +3086,43 @@ TEST(Query_StrEnum)
     }
 }
 
+TEST(Query_StrEnumCodes)
+{
+    Table t;
+    auto col_str = t.add_column(type_String, "str", true);
+    const char* values[] = {"red", "green", "blue", "yellow"};
+    size_t counts[5] = {};
+    for (size_t i = 0; i < REALM_MAX_BPNODE_SIZE * 3; ++i) {
+        size_t v = (i * 7) % 5;
+        if (v == 4)
+            t.create_object().set_null(col_str);
+        else
+            t.create_object().set(col_str, values[v]);
+        ++counts[v];
+    }
+    t.enumerate_string_column(col_str);
+    CHECK(t.is_enumerated(col_str));
+
+    for (size_t v = 0; v < 4; ++v)
+        CHECK_EQUAL(t.where().equal(col_str, values[v]).count(), counts[v]);
+    CHECK_EQUAL(t.where().equal(col_str, StringData()).count(), counts[4]);
+    CHECK_EQUAL(t.where().equal(col_str, "purple").count(), 0);
+
+    std::vector<Mixed> needles{"red", "blue", "purple"};
+    CHECK_EQUAL(t.where().in(col_str, needles.data(), needles.data() + needles.size()).count(),
+                counts[0] + counts[2]);
+    CHECK_EQUAL(t.where().equal(col_str, "green").Or().equal(col_str, StringData()).count(), counts[1] + counts[4]);
+    needles = {"purple", "orange"};
+    CHECK_EQUAL(t.where().in(col_str, needles.data(), needles.data() + needles.size()).count(), 0);
+
+    // A value added after the query was created must be found when the query is run again
+    Query q = t.where().equal(col_str, "purple");
+    CHECK_EQUAL(q.count(), 0);
+    t.get_object(5).set(col_str, "purple");
+    CHECK_EQUAL(q.count(), 1);
+    CHECK_EQUAL(q.find(), t.get_object(5).get_key());
+}
+
 TEST(Query_StrIndex)
 {
     Random random(random_int<unsigned long>()); // Seed from slow global generator
@@ -3710,6 +3747,52 @@ TEST(Query_FindAllRangeOr)
 }
 
 
+TEST(Query_Cursor)
+{
+    Group g;
+    auto table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "str");
+    for (int i = 0; i < 3000; i++)
+        table->create_object().set_all(i % 7, i % 3 ? "a" : "b");
+    table->add_search_index(col_str);
+
+    auto check_batches = [&](const Query& q, size_t batch_size) {
+        TableView tv = q.find_all();
+        QueryCursor cursor(q);
+        std::vector<ObjKey> keys;
+        while (cursor.next(keys, batch_size) == batch_size)
+            CHECK_EQUAL(keys.size(), cursor.get_position());
+        CHECK(cursor.at_end());
+        CHECK_EQUAL(cursor.next(keys, batch_size), 0);
+        CHECK_EQUAL(keys.size(), tv.size());
+        for (size_t i = 0; i < keys.size() && i < tv.size(); i++)
+            CHECK_EQUAL(keys[i], tv.get_key(i));
+    };
+
+    for (size_t batch_size : {1, 10, 300, 5000}) {
+        check_batches(table->where(), batch_size);
+        check_batches(table->where().equal(col_int, 3), batch_size);
+        check_batches(table->where().equal(col_int, 3).greater(col_int, 2), batch_size);
+        check_batches(table->where().equal(col_str, "b").less(col_int, 4), batch_size);
+        check_batches(table->where().equal(col_int, 8), batch_size);
+    }
+
+    QueryCursor cursor(table->where().equal(col_int, 0));
+    std::vector<ObjKey> keys;
+    CHECK_EQUAL(cursor.next(keys, 10), 10);
+    CHECK_NOT(cursor.is_stale());
+    table->remove_object(keys.back());
+    CHECK(cursor.is_stale());
+    CHECK_THROW(cursor.next(keys, 10), StaleAccessor);
+    cursor.reset();
+    keys.clear();
+    CHECK_EQUAL(cursor.get_position(), 0);
+    CHECK_EQUAL(cursor.next(keys, 10), 10);
+    CHECK_EQUAL(keys.front(), ObjKey(0));
+}
+
+
 TEST(Query_SimpleStr)
 {
     Table ttt;
@@ -5715,6 +5798,399 @@ TEST(Query_AsymmetricObjects)
                       ErrorCodes::IllegalOperation);
 }
 
+TEST(Query_ExplainAnalyze)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "str");
+    table->add_search_index(col_str);
+    for (int i = 0; i < 3000; ++i) {
+        table->create_object().set(col_int, i).set(col_str, i % 10 ? "common" : "rare");
+    }
+
+    auto explanation = table->where().explain_analyze();
+    CHECK_EQUAL(explanation.strategy, "all objects");
+    CHECK_EQUAL(explanation.num_results, 3000);
+    CHECK(explanation.nodes.empty());
+
+    auto q = table->where().greater(col_int, 100).less(col_int, 2100);
+    explanation = q.explain_analyze();
+    CHECK_EQUAL(explanation.strategy, "cluster scan");
+    CHECK_EQUAL(explanation.num_results, q.count());
+    CHECK_EQUAL(explanation.num_results, 1999);
+    CHECK_GREATER(explanation.clusters, 1);
+    CHECK_EQUAL(explanation.nodes.size(), 2);
+    size_t matches = 0;
+    size_t chosen = 0;
+    for (auto& node : explanation.nodes) {
+        CHECK_NOT(node.has_index);
+        CHECK_NOT(node.description.empty());
+        matches += node.matches;
+        chosen += node.times_chosen;
+    }
+    CHECK_EQUAL(matches, explanation.num_results);
+    CHECK_GREATER_EQUAL(chosen, explanation.clusters);
+    CHECK_NOT_EQUAL(explanation.to_string().find("strategy: cluster scan"), std::string::npos);
+
+    q = table->where().equal(col_str, "rare").greater(col_int, 1000);
+    explanation = q.explain_analyze();
+    CHECK_EQUAL(explanation.strategy, "index");
+    CHECK_EQUAL(explanation.num_results, 199);
+    CHECK_EQUAL(explanation.nodes.size(), 2);
+    auto& index_node = explanation.nodes[0];
+    CHECK(index_node.has_index);
+    CHECK_EQUAL(index_node.times_chosen, 1);
+    CHECK_EQUAL(index_node.rows_visited, 300);
+
+    // The query is still usable afterwards
+    CHECK_EQUAL(q.count(), 199);
+}
+
+TEST(Query_CompareWithConstantUsesNodes)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_float = table->add_column(type_Float, "float");
+    auto col_double = table->add_column(type_Double, "double", true);
+    for (int i = 0; i < 100; ++i) {
+        table->create_object().set(col_int, i).set(col_float, i / 2.0f).set(col_double, double(i));
+    }
+
+    auto uses_expression = [](const Query& q) {
+        auto explanation = q.explain_analyze();
+        return explanation.nodes.size() != 1 || explanation.nodes[0].is_expression;
+    };
+
+    // A constant on the left, or of another numeric type which converts exactly to the type of the property,
+    // gives the same node as the Query API
+    auto q = table->query("5 < int");
+    CHECK_NOT(uses_expression(q));
+    CHECK_EQUAL(q.count(), table->where().greater(col_int, 5).count());
+    q = table->query("int >= 5.0");
+    CHECK_NOT(uses_expression(q));
+    CHECK_EQUAL(q.count(), 95);
+    q = table->query("float == $0", std::vector<Mixed>{Mixed(int64_t(7))});
+    CHECK_NOT(uses_expression(q));
+    CHECK_EQUAL(q.count(), 1);
+    q = table->query("$0 > double", std::vector<Mixed>{Mixed(10.0f)});
+    CHECK_NOT(uses_expression(q));
+    CHECK_EQUAL(q.count(), 10);
+    q = Query(make_expression<Compare<LessEqual>>(make_subexpr<Value<Int>>(90), table->column<Int>(col_int).clone()));
+    CHECK_NOT(uses_expression(q));
+    CHECK_EQUAL(q.count(), 10);
+
+    // Constants which no value of the property's type is equal to are left to the expression
+    q = table->query("int > $0", std::vector<Mixed>{Mixed(5.5)});
+    CHECK(uses_expression(q));
+    CHECK_EQUAL(q.count(), 94);
+    q = table->query("float != $0", std::vector<Mixed>{Mixed((int64_t(1) << 24) + 1)});
+    CHECK(uses_expression(q));
+    CHECK_EQUAL(q.count(), 100);
+    q = table->query("int + 1 > 5");
+    CHECK(uses_expression(q));
+    CHECK_EQUAL(q.count(), 95);
+    CHECK_NOT_EQUAL(q.explain_analyze().to_string().find("(expression)"), std::string::npos);
+}
+
+TEST(Query_GroupBy)
+{
+    Group g;
+    auto target = g.add_table("target");
+    target->add_column(type_Int, "id");
+    auto table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int", true);
+    auto col_str = table->add_column(type_String, "str");
+    auto col_double = table->add_column(type_Double, "double", true);
+    auto col_date = table->add_column(type_Timestamp, "date");
+    auto col_link = table->add_column(*target, "link");
+    auto col_list = table->add_column_list(type_Int, "list");
+    table->add_search_index(col_int);
+
+    std::vector<ObjKey> targets;
+    for (int i = 0; i < 3; ++i)
+        targets.push_back(target->create_object().get_key());
+    const char* strings[] = {"a", "b", "c", "d"};
+    for (int i = 0; i < 2000; ++i) {
+        Obj obj = table->create_object();
+        if (i % 7)
+            obj.set(col_int, i % 5);
+        if (i % 3)
+            obj.set(col_double, i * 0.5);
+        obj.set(col_str, strings[i % 4]);
+        obj.set(col_date, Timestamp(i, 0));
+        if (i % 4)
+            obj.set(col_link, targets[i % 3]);
+    }
+
+    std::vector<GroupByAggregate> aggregates = {{GroupByAggregate::Type::Sum, col_double},
+                                                {GroupByAggregate::Type::Min, col_date},
+                                                {GroupByAggregate::Type::Max, col_int},
+                                                {GroupByAggregate::Type::Average, col_double}};
+    // Compare with the aggregates of a query for each group
+    auto check = [&](const Query& q, ColKey group_col) {
+        auto result = q.group_by(group_col, aggregates);
+        size_t total = 0;
+        ObjKey prev_first;
+        for (auto& group : result.groups) {
+            Query group_query(q);
+            if (group.key.is_null() && group_col == col_link)
+                group_query.and_query(table->column<Link>(col_link).is_null());
+            else if (group.key.is_null())
+                group_query.equal(group_col, null());
+            else if (group.key.is_type(type_Int))
+                group_query.equal(group_col, group.key.get_int());
+            else if (group.key.is_type(type_String))
+                group_query.equal(group_col, group.key.get_string());
+            else
+                group_query.links_to(group_col, group.key.get<ObjKey>());
+            auto tv = group_query.find_all();
+            CHECK_EQUAL(group.count, tv.size());
+            // The groups are in the order of their first object
+            CHECK_GREATER(tv.get_key(0), prev_first);
+            prev_first = tv.get_key(0);
+            CHECK_EQUAL(group.values[0], *group_query.sum(col_double));
+            CHECK_EQUAL(group.values[1], *group_query.min(col_date));
+            CHECK_EQUAL(group.values[2], *group_query.max(col_int));
+            CHECK_EQUAL(group.values[3], *group_query.avg(col_double));
+            total += group.count;
+        }
+        CHECK_EQUAL(total, q.count());
+        return result.groups.size();
+    };
+
+    CHECK_EQUAL(check(table->where(), col_int), 6);
+    CHECK_EQUAL(check(table->where(), col_str), 4);
+    CHECK_EQUAL(check(table->where(), col_link), 4);
+    CHECK_EQUAL(check(table->where().greater(col_double, 300.0), col_str), 4);
+    // Answered from the search index
+    CHECK_EQUAL(check(table->where().equal(col_int, 3), col_str), 4);
+    auto tv = table->where().less(col_date, Timestamp(100, 0)).find_all();
+    CHECK_EQUAL(check(table->where(&tv), col_link), 4);
+
+    // Enumerated strings are grouped by their index into the column's keys
+    table->enumerate_string_column(col_str);
+    CHECK_EQUAL(check(table->where(), col_str), 4);
+    CHECK_EQUAL(check(table->where().not_equal(col_str, "b"), col_str), 3);
+
+    CHECK(table->where().equal(col_int, 100).group_by(col_str, aggregates).groups.empty());
+    auto result = table->where().equal(col_str, "a").group_by(col_str, {});
+    CHECK_EQUAL(result.groups.size(), 1);
+    CHECK_EQUAL(result.groups[0].key, Mixed("a"));
+    CHECK_EQUAL(result.groups[0].count, 500);
+
+    CHECK_THROW(table->where().group_by(col_list, {}), IllegalOperation);
+    CHECK_THROW(table->where().group_by(col_int, {{GroupByAggregate::Type::Sum, col_str}}), IllegalOperation);
+    CHECK_THROW(table->where().group_by(col_int, {{GroupByAggregate::Type::Average, col_date}}), IllegalOperation);
+    CHECK_THROW(table->where().group_by(col_int, {{GroupByAggregate::Type::Max, col_list}}), IllegalOperation);
+}
+
+TEST(Query_FindAllExternal)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path, DBOptions(crypt_key()));
+    auto tr = db->start_write();
+    auto target = tr->add_table("target");
+    auto col_value = target->add_column(type_Int, "value");
+    auto table = tr->add_table("table");
+    auto col_int = table->add_column(type_Int, "int", true);
+    auto col_str = table->add_column(type_String, "str");
+    auto col_link = table->add_column(*target, "link");
+
+    std::vector<ObjKey> target_keys;
+    for (int i = 0; i < 10; ++i)
+        target_keys.push_back(target->create_object().set(col_value, i % 5).get_key());
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    for (int i = 0; i < 2000; ++i) {
+        Obj obj = table->create_object();
+        if (i % 7)
+            obj.set(col_int, random.draw_int_mod(100));
+        obj.set(col_str, std::string(1, char('a' + random.draw_int_mod(26))));
+        if (i % 3)
+            obj.set(col_link, target_keys[random.draw_int_mod(10)]);
+    }
+    tr->commit_and_continue_as_read();
+
+    // Compare with sorting the matches in memory
+    auto check = [&](const Query& q, const SortDescriptor& sort, ExternalSortOptions options) {
+        auto cursor = q.find_all_external(sort, options);
+        DescriptorOrdering ordering;
+        ordering.append_sort(sort);
+        if (options.distinct)
+            ordering.append_distinct(DistinctDescriptor(sort.get_column_keys()));
+        auto tv = q.find_all(ordering);
+        for (size_t i = 0; i < tv.size(); ++i)
+            CHECK_EQUAL(cursor.next(), tv.get_key(i));
+        CHECK_NOT(cursor.next());
+        return cursor.get_num_spilled_runs();
+    };
+
+    ExternalSortOptions large;
+    ExternalSortOptions small;
+    small.memory_budget = 4096;
+
+    SortDescriptor by_int({{col_int}}, {true});
+    SortDescriptor by_str_int({{col_str}, {col_int}}, {false, true});
+    SortDescriptor by_link({{col_link, col_value}, {col_str}}, {true, false});
+
+    // Everything fits in memory
+    CHECK_EQUAL(check(table->where(), by_int, large), 0);
+    // Several passes of merging two runs at a time
+    CHECK_GREATER(check(table->where(), by_int, small), 2);
+    check(table->where().greater(col_int, 50), by_str_int, small);
+    check(table->where(), by_link, small);
+
+    small.distinct = true;
+    large.distinct = true;
+    check(table->where(), by_int, large);
+    check(table->where(), by_int, small);
+    check(table->where(), by_str_int, small);
+    check(table->where(), by_link, small);
+
+    // No temporary files are left behind
+    size_t num_files = 0;
+    DirScanner scanner(File::parent_dir(path));
+    std::string name;
+    while (scanner.next(name)) {
+        if (StringData(name).begins_with("realm_sort_"))
+            ++num_files;
+    }
+    CHECK_EQUAL(num_files, 0);
+
+    // Tables which are not in a Realm file need a directory for the temporary files
+    Group g;
+    auto standalone = g.add_table("table");
+    auto col = standalone->add_column(type_Int, "int");
+    for (int i = 0; i < 100; ++i)
+        standalone->create_object().set(col, 100 - i);
+    CHECK_THROW(standalone->where().find_all_external(SortDescriptor({{col}})), InvalidArgument);
+    TEST_DIR(dir);
+    ExternalSortOptions options;
+    options.memory_budget = 0;
+    options.temp_directory = dir;
+    auto cursor = standalone->where().find_all_external(SortDescriptor({{col}}), options);
+    int64_t last = 0;
+    while (ObjKey key = cursor.next()) {
+        int64_t value = standalone->get_object(key).get<Int>(col);
+        CHECK_GREATER(value, last);
+        last = value;
+    }
+    CHECK_EQUAL(last, 100);
+    CHECK_EQUAL(cursor.get_num_spilled_runs(), 7);
+}
+
+TEST(Query_KeyRange)
+{
+    Table table;
+    auto col_int = table.add_column(type_Int, "int");
+    auto col_str = table.add_column(type_String, "str");
+    table.add_search_index(col_str);
+    std::vector<ObjKey> keys;
+    for (int64_t i = 0; i < 3000; i++) {
+        keys.push_back(table.create_object().set(col_int, i % 10).set(col_str, i % 2 ? "odd" : "even").get_key());
+    }
+    ObjKey end_key(keys.back().value + 1);
+
+    auto range = table.where().key_range(keys[1000], keys[1100]);
+    CHECK_EQUAL(range.count(), 100);
+    auto tv = range.find_all();
+    CHECK_EQUAL(tv.size(), 100);
+    for (size_t i = 0; i < tv.size(); i++) {
+        CHECK_EQUAL(tv.get_key(i), keys[1000 + i]);
+    }
+    CHECK_EQUAL(range.find(), keys[1000]);
+    CHECK_EQUAL(range.sum(col_int)->get_int(), 450);
+
+    // Combined with other conditions
+    CHECK_EQUAL(table.where().key_range(keys[1000], keys[1100]).equal(col_int, 3).count(), 10);
+    CHECK_EQUAL(table.where().equal(col_str, "odd").key_range(keys[1000], keys[1100]).count(), 50);
+    CHECK_EQUAL(table.where()
+                    .group()
+                    .key_range(keys[0], keys[10])
+                    .Or()
+                    .key_range(keys[2990], end_key)
+                    .end_group()
+                    .count(),
+                20);
+    CHECK_EQUAL(table.where().Not().key_range(keys[10], end_key).count(), 10);
+    CHECK_EQUAL(table.where().key_range(keys[500], keys[500]).count(), 0);
+
+    // The range is found again when the query is rerun
+    table.remove_object(keys[1050]);
+    CHECK_EQUAL(range.count(), 99);
+    tv.sync_if_needed();
+    CHECK_EQUAL(tv.size(), 99);
+
+    CHECK_EQUAL(range.get_description(), util::format("KEY RANGE [%1, %2)", keys[1000].value, keys[1100].value));
+}
+
+TEST(Query_Join)
+{
+    Group g;
+    auto authors = g.add_table("authors");
+    auto col_id = authors->add_column(type_String, "id", true);
+    auto col_country = authors->add_column(type_Int, "country");
+    auto col_tags = authors->add_column_list(type_String, "tags");
+    auto books = g.add_table("books");
+    auto col_author = books->add_column(type_String, "author_id", true);
+    auto col_year = books->add_column(type_Int, "year");
+
+    for (int i = 0; i < 60; i++) {
+        // Two authors share an id, and one has none
+        std::string id = "a" + util::to_string(i == 59 ? 0 : i);
+        authors->create_object().set(col_id, i == 58 ? StringData() : StringData(id)).set(col_country, i % 3);
+    }
+    for (int i = 0; i < 3000; i++) {
+        auto book = books->create_object().set(col_year, 1900 + i % 120);
+        if (i % 17 == 0)
+            book.set(col_author, "unknown");
+        else if (i % 13)
+            book.set(col_author, "a" + util::to_string(i % 70));
+    }
+
+    auto expected = [](Query left, ColKey left_col, Query right, ColKey right_col) {
+        std::vector<std::pair<ObjKey, ObjKey>> pairs;
+        auto left_tv = left.find_all();
+        auto right_tv = right.find_all();
+        for (size_t i = 0; i < left_tv.size(); i++) {
+            Mixed value = left_tv.get_object(i).get_any(left_col);
+            for (size_t j = 0; j < right_tv.size(); j++) {
+                if (!value.is_null() && value == right_tv.get_object(j).get_any(right_col))
+                    pairs.emplace_back(left_tv.get_key(i), right_tv.get_key(j));
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    };
+    auto sorted = [](std::vector<std::pair<ObjKey, ObjKey>> pairs) {
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    };
+
+    // The authors are put in the hash table when joining in either direction
+    auto pairs = books->where().join(col_author, authors->where(), col_id);
+    CHECK_GREATER(pairs.size(), 1000);
+    CHECK(sorted(pairs) == expected(books->where(), col_author, authors->where(), col_id));
+    pairs = authors->where().join(col_id, books->where(), col_author);
+    CHECK(sorted(pairs) == expected(authors->where(), col_id, books->where(), col_author));
+
+    auto recent = books->where().greater_equal(col_year, 2000);
+    auto country = authors->where().equal(col_country, 1);
+    CHECK(sorted(recent.join(col_author, country, col_id)) == expected(recent, col_author, country, col_id));
+    CHECK(sorted(country.join(col_id, recent, col_author)) == expected(country, col_id, recent, col_author));
+    CHECK(books->where().join(col_author, authors->where().equal(col_country, 7), col_id).empty());
+
+    size_t count = 0;
+    books->where().join(col_author, authors->where(), col_id, [&](ObjKey, ObjKey) {
+        return ++count == 5 ? IteratorControl::Stop : IteratorControl::AdvanceToNext;
+    });
+    CHECK_EQUAL(count, 5);
+
+    CHECK_THROW(books->where().join(col_year, authors->where(), col_id), IllegalOperation);
+    CHECK_THROW(books->where().join(col_author, authors->where(), col_tags), IllegalOperation);
+}
+
 TEST(Query_NestedLinkCount)
 {
     Group g;
@@ -5167,6 +5167,57 @@ TEST(Query_MixedTypeQuery)
     CHECK_EQUAL(tv1.size(), 49);
 }
 
+TEST(Query_MixedMostlyIntegers)
+{
+    Group g;
+    auto table = g.add_table("Foo");
+    auto col = table->add_column(type_Mixed, "mixed", true);
+    // The first clusters hold only small integers, the later ones also other types
+    for (int64_t i = 0; i < 3000; i++) {
+        Mixed value = i % 100 - 50;
+        if (i >= 1500) {
+            switch (i % 13) {
+                case 0:
+                    value = double(i % 100 - 50);
+                    break;
+                case 1:
+                    value = Decimal128(i % 100 - 50);
+                    break;
+                case 2:
+                    value = int64_t(1) << 40;
+                    break;
+                case 3:
+                    value = "7";
+                    break;
+                case 4:
+                    value = Mixed();
+                    break;
+            }
+        }
+        table->create_object().set_any(col, value);
+    }
+
+    for (Mixed value : {Mixed(7), Mixed(-50), Mixed(1000), Mixed(int64_t(1) << 40), Mixed(7.0), Mixed("7")}) {
+        auto check = [&](Query q, Query expected) {
+            CHECK_EQUAL(q.count(), expected.count());
+        };
+        check(table->where().equal(col, value), table->column<Mixed>(col) == value);
+        check(table->where().not_equal(col, value), table->column<Mixed>(col) != value);
+        check(table->where().greater(col, value), table->column<Mixed>(col) > value);
+        check(table->where().greater_equal(col, value), table->column<Mixed>(col) >= value);
+        check(table->where().less(col, value), table->column<Mixed>(col) < value);
+        check(table->where().less_equal(col, value), table->column<Mixed>(col) <= value);
+    }
+    size_t sevens = 0;
+    for (auto& obj : *table) {
+        Mixed v = obj.get_any(col);
+        if (Mixed::types_are_comparable(v, Mixed(7)) && v == Mixed(7))
+            sevens++;
+    }
+    CHECK_GREATER(sevens, 15);
+    CHECK_EQUAL(table->where().equal(col, Mixed(7)).count(), sevens);
+}
+
 TEST(Query_LinkListIntPastOneIsNull)
 {
     Group g;
@@ -6017,6 +6068,131 @@ TEST_TYPES(Query_ManyIn, Prop<Int>, Prop<String>, Prop<Float>, Prop<Double>, Pro
     CHECK_EQUAL(count_of_two_ins, 2);
 }
 
+TEST(Query_InIndexed)
+{
+    Group g;
+    auto t = g.add_table("foo");
+    auto col_int = t->add_column(type_Int, "int", true);
+    auto col_str = t->add_column(type_String, "str", true);
+    auto col_other = t->add_column(type_Int, "other");
+    constexpr int64_t num_objects = 10000;
+    for (int64_t i = 0; i < num_objects; ++i) {
+        t->create_object().set(col_int, i % 1000).set(col_str, util::format("s%1", i % 1000)).set(col_other, i);
+    }
+    t->create_object().set(col_other, num_objects);
+
+    auto check = [&](size_t num_needles, int64_t step) {
+        std::vector<Mixed> ints, strings;
+        std::vector<std::string> string_storage(num_needles);
+        for (size_t i = 0; i < num_needles; ++i) {
+            ints.push_back(int64_t(i) * step);
+            string_storage[i] = util::format("s%1", int64_t(i) * step);
+            strings.push_back(string_storage[i]);
+        }
+        ints.push_back(Mixed());
+        strings.push_back(Mixed());
+        size_t expected = 1;
+        for (size_t i = 0; i < num_needles; ++i) {
+            if (int64_t(i) * step < 1000)
+                expected += num_objects / 1000;
+        }
+
+        for (auto [col, needles] : {std::make_pair(col_int, &ints), std::make_pair(col_str, &strings)}) {
+            Query q = t->where().in(col, needles->data(), needles->data() + needles->size());
+            CHECK_EQUAL(q.count(), expected);
+            auto tv = q.find_all();
+            CHECK_EQUAL(tv.size(), expected);
+            for (size_t i = 1; i < tv.size(); ++i)
+                CHECK_LESS(tv.get_key(i - 1), tv.get_key(i));
+            // Combined with another condition
+            Query q2 = t->where().less(col_other, 5000).in(col, needles->data(), needles->data() + needles->size());
+            CHECK_EQUAL(q2.count(), (expected - 1) / 2);
+            Query q3 = t->where().in(col, needles->data(), needles->data() + needles->size()).less(col_other, 5000);
+            CHECK_EQUAL(q3.count(), (expected - 1) / 2);
+        }
+    };
+
+    check(10, 7);
+    check(5000, 1);
+    t->add_search_index(col_int);
+    t->add_search_index(col_str);
+    check(10, 7);
+    check(5000, 1);
+
+    // A few needles are looked up in the index, while many are tested
+    // against each value in the column
+    std::vector<Mixed> needles{1, 2, 3};
+    CHECK_EQUAL(t->where().in(col_int, needles.data(), needles.data() + needles.size()).explain_analyze().strategy,
+                "index");
+    needles.clear();
+    for (int64_t i = 0; i < 5000; ++i)
+        needles.push_back(i);
+    CHECK_EQUAL(t->where().in(col_int, needles.data(), needles.data() + needles.size()).explain_analyze().strategy,
+                "cluster scan");
+}
+
+TEST(Query_OrIndexed)
+{
+    Group g;
+    auto t = g.add_table("foo");
+    auto col_int = t->add_column(type_Int, "int");
+    auto col_str = t->add_column(type_String, "str", true);
+    auto col_oid = t->add_column(type_ObjectId, "oid");
+    auto col_other = t->add_column(type_Int, "other");
+    constexpr int64_t num_objects = 10000;
+    std::vector<ObjectId> oids;
+    for (int64_t i = 0; i < 100; ++i)
+        oids.push_back(ObjectId::gen());
+    for (int64_t i = 0; i < num_objects; ++i) {
+        t->create_object()
+            .set(col_int, i % 1000)
+            .set(col_str, util::format("s%1", i % 100))
+            .set(col_oid, oids[i % 100])
+            .set(col_other, i);
+    }
+
+    auto check = [&](const char* strategy) {
+        // Twenty conditions on the same column
+        Query q = t->where();
+        for (int64_t i = 0; i < 20; ++i) {
+            if (i)
+                q.Or();
+            q.equal(col_int, i * 3);
+        }
+        CHECK_EQUAL(q.count(), 200);
+        CHECK_EQUAL(q.find_all().size(), 200);
+        CHECK_EQUAL(q.explain_analyze().strategy, strategy);
+
+        // Conditions on different columns
+        Query q2 = t->where().equal(col_int, 5).Or().equal(col_str, "s5").Or().equal(col_oid, oids[7]);
+        CHECK_EQUAL(q2.count(), 200);
+        auto tv = q2.find_all();
+        CHECK_EQUAL(tv.size(), 200);
+        for (size_t i = 1; i < tv.size(); ++i)
+            CHECK_LESS(tv.get_key(i - 1), tv.get_key(i));
+        CHECK_EQUAL(q2.explain_analyze().strategy, strategy);
+
+        // Combined with another condition
+        Query q3 = t->where().less(col_other, 5000).group().equal(col_int, 5).Or().equal(col_str, "s7").end_group();
+        CHECK_EQUAL(q3.count(), 55);
+        CHECK_EQUAL(q3.find_all().size(), 55);
+
+        // A condition on a column without an index makes it a scan
+        Query q4 = t->where().equal(col_int, 5).Or().equal(col_other, 7);
+        CHECK_EQUAL(q4.count(), 11);
+        CHECK_EQUAL(q4.explain_analyze().strategy, "cluster scan");
+
+        std::vector<Mixed> needles{oids[1], oids[2]};
+        CHECK_EQUAL(t->where().in(col_oid, needles.data(), needles.data() + needles.size()).count(), 200);
+    };
+
+    check("cluster scan");
+    t->add_search_index(col_int);
+    t->add_search_index(col_str);
+    t->add_search_index(col_oid);
+    check("index");
+}
+
 TEST(Query_ManyIntConditionsAgg)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -6061,6 +6237,444 @@ TEST(Query_ManyIntConditionsAgg)
     }
 }
 
+TEST(Query_Parallel)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+
+    ColKey col_int, col_str, col_link;
+    {
+        auto wt = db->start_write();
+        auto target = wt->add_table("Target");
+        auto col_target_int = target->add_column(type_Int, "value");
+        auto table = wt->add_table("Foo");
+        col_int = table->add_column(type_Int, "int");
+        col_str = table->add_column(type_String, "str");
+        col_link = table->add_column(*target, "link");
+        for (int64_t i = 0; i < 10; ++i)
+            target->create_object().set(col_target_int, i);
+        for (int64_t i = 0; i < 20000; i++) {
+            table->create_object().set_all(i % 1000, util::to_string(i % 7).c_str(),
+                                           target->get_object(size_t(i % 10)).get_key());
+        }
+        wt->commit();
+    }
+
+    auto frozen = db->start_frozen();
+    auto table = frozen->get_table("Foo");
+    auto col_target_int = frozen->get_table("Target")->get_column_key("value");
+
+    auto check = [&](Query q) {
+        TableView expected = q.find_all();
+        size_t expected_count = q.count();
+        q.set_parallelism(4);
+        TableView tv = q.find_all();
+        CHECK_EQUAL(q.count(), expected_count);
+        CHECK_EQUAL(tv.size(), expected.size());
+        CHECK_EQUAL(tv.size(), expected_count);
+        for (size_t i = 0; i < tv.size() && i < expected.size(); ++i)
+            CHECK_EQUAL(tv.get_key(i), expected.get_key(i));
+    };
+
+    check(table->where().greater(col_int, 500));
+    check(table->where().equal(col_str, "3").less(col_int, 100));
+    check(table->where().equal(col_int, 999).Or().equal(col_str, "6"));
+    check(table->link(col_link).column<Int>(col_target_int) == 4);
+    check(table->where().equal(col_int, 12345));
+
+    // Not frozen: evaluated serially, but must of course give the same result
+    auto rt = db->start_read();
+    auto live_table = rt->get_table("Foo");
+    CHECK_EQUAL(live_table->where().greater(col_int, 500).set_parallelism(4).count(),
+                table->where().greater(col_int, 500).count());
+}
+
+TEST(Query_ParallelSort)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+
+    ColKey col_int, col_str, col_link, col_target_int;
+    {
+        auto wt = db->start_write();
+        auto target = wt->add_table("Target");
+        col_target_int = target->add_column(type_Int, "value");
+        auto table = wt->add_table("Foo");
+        col_int = table->add_column(type_Int, "int");
+        col_str = table->add_column(type_String, "str");
+        col_link = table->add_column(*target, "link");
+        for (int64_t i = 0; i < 10; ++i)
+            target->create_object().set(col_target_int, i % 3);
+        Random random(random_int<unsigned long>()); // Seed from slow global generator
+        for (int64_t i = 0; i < 250000; i++) {
+            auto obj = table->create_object().set_all(random.draw_int_mod(1000), util::to_string(i % 7).c_str());
+            if (i % 11)
+                obj.set(col_link, target->get_object(size_t(i % 10)).get_key());
+        }
+        wt->commit();
+    }
+
+    auto frozen = db->start_frozen();
+    auto table = frozen->get_table("Foo");
+
+    auto check = [&](const DescriptorOrdering& ordering) {
+        Query q = table->where().not_equal(col_int, 500);
+        TableView expected = q.find_all(ordering);
+        q.set_parallelism(4);
+        TableView tv = q.find_all(ordering);
+        CHECK_EQUAL(tv.size(), expected.size());
+        for (size_t i = 0; i < tv.size() && i < expected.size(); ++i) {
+            if (tv.get_key(i) != expected.get_key(i)) {
+                CHECK_EQUAL(tv.get_key(i), expected.get_key(i));
+                break;
+            }
+        }
+    };
+
+    DescriptorOrdering ordering;
+    ordering.append_sort(SortDescriptor({{col_int}}, {false}));
+    check(ordering);
+
+    ordering = {};
+    ordering.append_sort(SortDescriptor({{col_str}, {col_link, col_target_int}, {col_int}}, {true, false, true}));
+    check(ordering);
+
+    ordering = {};
+    ordering.append_sort(SortDescriptor({{col_link, col_target_int}, {col_str}}));
+    ordering.append_limit(200000);
+    check(ordering);
+}
+
+TEST(Query_ZoneMapPruning)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+
+    ColKey col_int, col_null;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("Foo");
+        col_int = table->add_column(type_Int, "int");
+        col_null = table->add_column(type_Int, "nullable", true);
+        // Ascending values so that most clusters can be skipped by range conditions
+        for (int64_t i = 0; i < 5000; i++) {
+            auto obj = table->create_object().set(col_int, i);
+            if (i % 3)
+                obj.set(col_null, i);
+        }
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("Foo");
+
+    auto check = [&](Query q, auto pred) {
+        size_t expected = 0;
+        for (auto& obj : *table) {
+            if (pred(obj))
+                ++expected;
+        }
+        CHECK_EQUAL(q.count(), expected);
+        CHECK_EQUAL(q.find_all().size(), expected);
+    };
+    auto run_checks = [&](int64_t offset) {
+        auto val = [&](const Obj& o) {
+            return o.get<Int>(col_int);
+        };
+        auto opt = [&](const Obj& o) {
+            return o.get<std::optional<Int>>(col_null);
+        };
+        check(table->where().greater(col_int, 4000 + offset), [&](const Obj& o) {
+            return val(o) > 4000 + offset;
+        });
+        check(table->where().less_equal(col_int, 1200 + offset), [&](const Obj& o) {
+            return val(o) <= 1200 + offset;
+        });
+        check(table->where().between(col_int, int64_t(2000), 2100 + offset), [&](const Obj& o) {
+            return val(o) >= 2000 && val(o) <= 2100 + offset;
+        });
+        check(table->where().equal(col_int, 3333 + offset), [&](const Obj& o) {
+            return val(o) == 3333 + offset;
+        });
+        check(table->where().not_equal(col_int, 17), [&](const Obj& o) {
+            return val(o) != 17;
+        });
+        check(table->where().greater_equal(col_null, 4500 + offset), [&](const Obj& o) {
+            return opt(o) && *opt(o) >= 4500 + offset;
+        });
+        check(table->where().less(col_null, 100 + offset), [&](const Obj& o) {
+            return opt(o) && *opt(o) < 100 + offset;
+        });
+        check(table->where().equal(col_null, realm::null()), [&](const Obj& o) {
+            return !opt(o);
+        });
+        check(table->where().equal(col_null, 4001 + offset), [&](const Obj& o) {
+            return opt(o) == 4001 + offset;
+        });
+    };
+    // The second round uses the synopses cached by the first one
+    run_checks(0);
+    run_checks(0);
+
+    // Modify values in other transactions. The synopses of the leaves that are
+    // left alone are kept when advancing, while those of the replaced leaves
+    // must not be used, also not once their refs have been reused by later commits.
+    for (int64_t round = 0; round < 3; ++round) {
+        for (int64_t commit = 0; commit < 3; ++commit) {
+            auto wt = db->start_write();
+            auto t = wt->get_table("Foo");
+            for (auto& obj : *t) {
+                auto v = obj.get<Int>(col_int);
+                if (v % 100 == round * 10 + commit)
+                    obj.set(col_int, v + 20000);
+                if (v % 7 == round && commit == 0)
+                    obj.set_null(col_null);
+            }
+            wt->commit();
+        }
+        rt->advance_read();
+        run_checks(0);
+        run_checks(20000);
+    }
+}
+
+TEST(Query_ZoneMapPruningTimestamp)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+
+    ColKey col_date, col_null;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("Foo");
+        col_date = table->add_column(type_Timestamp, "date");
+        col_null = table->add_column(type_Timestamp, "nullable", true);
+        // Four values per second in ascending order, so that most clusters are
+        // either entirely inside or entirely outside of a time window
+        for (int64_t i = 0; i < 5000; i++) {
+            Timestamp ts(i / 4, int32_t(i % 4) * 250'000'000);
+            auto obj = table->create_object().set(col_date, ts);
+            if (i % 3)
+                obj.set(col_null, ts);
+        }
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("Foo");
+
+    auto check = [&](Query q, auto pred) {
+        size_t expected = 0;
+        for (auto& obj : *table) {
+            if (pred(obj))
+                ++expected;
+        }
+        CHECK_EQUAL(q.count(), expected);
+        CHECK_EQUAL(q.find_all().size(), expected);
+    };
+    auto run_checks = [&] {
+        auto val = [&](const Obj& o) {
+            return o.get<Timestamp>(col_date);
+        };
+        auto opt = [&](const Obj& o) {
+            return o.get<Timestamp>(col_null);
+        };
+        Timestamp from(300, 250'000'000);
+        Timestamp to(700, 500'000'000);
+        check(table->where().greater(col_date, from), [&](const Obj& o) {
+            return val(o) > from;
+        });
+        check(table->where().greater_equal(col_date, from), [&](const Obj& o) {
+            return val(o) >= from;
+        });
+        check(table->where().less(col_date, to), [&](const Obj& o) {
+            return val(o) < to;
+        });
+        check(table->where().less_equal(col_date, to), [&](const Obj& o) {
+            return val(o) <= to;
+        });
+        check(table->where().between(col_date, from, to), [&](const Obj& o) {
+            return val(o) >= from && val(o) <= to;
+        });
+        check(table->where().equal(col_date, Timestamp(1000, 750'000'000)), [&](const Obj& o) {
+            return val(o) == Timestamp(1000, 750'000'000);
+        });
+        check(table->where().not_equal(col_date, Timestamp(0, 0)), [&](const Obj& o) {
+            return val(o) != Timestamp(0, 0);
+        });
+        check(table->where().greater(col_null, to), [&](const Obj& o) {
+            return !opt(o).is_null() && opt(o) > to;
+        });
+        check(table->where().less_equal(col_null, from), [&](const Obj& o) {
+            return !opt(o).is_null() && opt(o) <= from;
+        });
+        check(table->where().equal(col_null, Timestamp()), [&](const Obj& o) {
+            return opt(o).is_null();
+        });
+        check(table->where().equal(col_null, Timestamp(1200, 500'000'000)), [&](const Obj& o) {
+            return opt(o) == Timestamp(1200, 500'000'000);
+        });
+    };
+    // The second round uses the synopses cached by the first one
+    run_checks();
+    run_checks();
+
+    // The synopses of replaced leaves must not be used once their refs have
+    // been reused by later commits
+    for (int64_t round = 0; round < 3; ++round) {
+        for (int64_t commit = 0; commit < 3; ++commit) {
+            auto wt = db->start_write();
+            auto t = wt->get_table("Foo");
+            for (auto& obj : *t) {
+                auto v = obj.get<Timestamp>(col_date);
+                if (v.get_seconds() % 100 == round * 10 + commit)
+                    obj.set(col_date, Timestamp(v.get_seconds() + 5000, v.get_nanoseconds()));
+                if (v.get_seconds() % 7 == round && commit == 0)
+                    obj.set_null(col_null);
+            }
+            wt->commit();
+        }
+        rt->advance_read();
+        run_checks();
+    }
+}
+
+TEST(Query_ColumnStatistics)
+{
+    Group g;
+    auto table = g.add_table("Foo");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "str", true);
+    auto col_date = table->add_column(type_Timestamp, "date");
+    auto col_list = table->add_column_list(type_Int, "list");
+
+    for (int64_t i = 0; i < 500; i++) {
+        table->create_object().set(col_int, i % 100);
+    }
+    // Too small to be worth it
+    CHECK_NOT(table->get_column_statistics(col_int));
+
+    for (int64_t i = 500; i < 10000; i++) {
+        auto obj = table->create_object().set(col_int, i % 100).set(col_date, Timestamp(i, 0));
+        // 20% null, 40% "common", the rest unique. The first 500 are all null.
+        if (i % 5 == 0)
+            continue;
+        obj.set(col_str, i % 5 < 3 ? std::string("common") : util::format("unique %1", i));
+    }
+    CHECK_NOT(table->get_column_statistics(col_list));
+
+    auto ints = table->get_column_statistics(col_int);
+    CHECK(ints);
+    CHECK_EQUAL(ints->get_table_size(), 10000);
+    CHECK_EQUAL(ints->get_sample_size(), ColumnStatistics::max_sample_size);
+    CHECK_EQUAL(ints->get_null_fraction(), 0.0);
+    CHECK_APPROXIMATELY_EQUAL(ints->get_cardinality(), 100, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(ints->estimate_equal(42), 0.01, 0.1);
+    CHECK_EQUAL(ints->estimate_equal(1000), 0.0);
+    CHECK_APPROXIMATELY_EQUAL(ints->estimate_less(50, false), 0.5, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(ints->estimate_greater(89, true), 0.1, 0.2);
+    CHECK_EQUAL(ints->estimate_less(-1, true), 0.0);
+    CHECK_EQUAL(ints->estimate_greater(99, false), 0.0);
+    CHECK_EQUAL(ints->estimate_less(realm::null(), false), 0.0);
+
+    auto strings = table->get_column_statistics(col_str);
+    CHECK(strings);
+    CHECK_APPROXIMATELY_EQUAL(strings->get_null_fraction(), 0.24, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(strings->estimate_equal(realm::null()), 0.24, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(strings->estimate_equal("common"), 0.38, 0.1);
+    CHECK_LESS(strings->estimate_equal("unique 8"), 0.001);
+    CHECK_GREATER(strings->get_cardinality(), 1000);
+
+    auto dates = table->get_column_statistics(col_date);
+    CHECK_APPROXIMATELY_EQUAL(dates->estimate_less(Timestamp(5000, 0), false), 0.5, 0.1);
+
+    // The statistics are kept until the table has changed significantly
+    CHECK_EQUAL(table->get_column_statistics(col_int), ints);
+    for (int64_t i = 0; i < 500; i++) {
+        table->create_object().set(col_int, 1000);
+    }
+    CHECK_EQUAL(table->get_column_statistics(col_int), ints);
+    for (int64_t i = 0; i < 1500; i++) {
+        table->create_object().set(col_int, 1000);
+    }
+    auto updated = table->get_column_statistics(col_int);
+    CHECK_NOT_EQUAL(updated, ints);
+    CHECK_EQUAL(updated->get_table_size(), 12000);
+    CHECK_APPROXIMATELY_EQUAL(updated->estimate_equal(1000), 2000.0 / 12000, 0.1);
+
+    table->remove_column(col_str);
+    table->clear();
+    CHECK_NOT(table->get_column_statistics(col_int));
+}
+
+TEST(Query_StatisticsOrdering)
+{
+    Random random(random_int<unsigned long>());
+    Group g;
+    auto table = g.add_table("Foo");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_rare = table->add_column(type_Int, "rare", true);
+    auto col_str = table->add_column(type_String, "str");
+    auto col_indexed = table->add_column(type_String, "indexed");
+    auto col_double = table->add_column(type_Double, "double");
+    auto col_oid = table->add_column(type_ObjectId, "oid");
+    table->add_search_index(col_indexed);
+    std::vector<ObjectId> oids;
+    for (int i = 0; i < 5; i++)
+        oids.push_back(ObjectId::gen());
+
+    for (int64_t i = 0; i < 20000; i++) {
+        auto obj = table->create_object();
+        obj.set(col_int, random.draw_int_mod(4));
+        if (random.draw_int_mod(1000) == 0)
+            obj.set(col_rare, random.draw_int_mod(3));
+        obj.set(col_str, random.draw_int_mod(2) ? "a" : "b");
+        obj.set(col_indexed, random.draw_int_mod(3) ? "frequent" : "other");
+        obj.set(col_double, random.draw_float<double>());
+        obj.set(col_oid, oids[random.draw_int_mod(5)]);
+    }
+
+    // The conditions are badly ordered: the most selective one comes last.
+    // Whichever order the planner picks, the results must be the same as
+    // when checking each object.
+    auto check = [&](Query q, auto pred) {
+        std::vector<ObjKey> expected;
+        for (auto& obj : *table) {
+            if (pred(obj))
+                expected.push_back(obj.get_key());
+        }
+        CHECK_EQUAL(q.count(), expected.size());
+        auto tv = q.find_all();
+        CHECK_EQUAL(tv.size(), expected.size());
+        for (size_t i = 0; i < tv.size() && i < expected.size(); ++i) {
+            CHECK_EQUAL(tv.get_key(i), expected[i]);
+        }
+        CHECK_EQUAL(q.find(), expected.empty() ? ObjKey() : expected[0]);
+    };
+
+    check(table->where().equal(col_str, "a").greater(col_int, 0).equal(col_rare, 1), [&](const Obj& o) {
+        return o.get<String>(col_str) == "a" && o.get<Int>(col_int) > 0 && o.get<std::optional<Int>>(col_rare) == 1;
+    });
+    check(table->where().equal(col_indexed, "frequent").less(col_double, 0.01), [&](const Obj& o) {
+        return o.get<String>(col_indexed) == "frequent" && o.get<double>(col_double) < 0.01;
+    });
+    check(table->where().equal(col_indexed, "other").not_equal(col_rare, realm::null()), [&](const Obj& o) {
+        return o.get<String>(col_indexed) == "other" && o.get<std::optional<Int>>(col_rare);
+    });
+    check(table->where().not_equal(col_int, 2).equal(col_oid, oids[3]).less_equal(col_double, 0.5),
+          [&](const Obj& o) {
+              return o.get<Int>(col_int) != 2 && o.get<ObjectId>(col_oid) == oids[3] &&
+                     o.get<double>(col_double) <= 0.5;
+          });
+    check(table->query("str == 'b' AND int IN {1, 3} AND rare == 2"), [&](const Obj& o) {
+        auto v = o.get<Int>(col_int);
+        return o.get<String>(col_str) == "b" && (v == 1 || v == 3) && o.get<std::optional<Int>>(col_rare) == 2;
+    });
+    check(table->where().equal(col_str, "a").Or().equal(col_rare, 0), [&](const Obj& o) {
+        return o.get<String>(col_str) == "a" || o.get<std::optional<Int>>(col_rare) == 0;
+    });
+}
+
 TEST(Query_FullText)
 {
     Group g;
@@ -6368,4 +6982,206 @@ TEST(Query_FullTextPrefix)
     CHECK_EQUAL(q.count(), 1);
 }
 
+TEST(Query_FullTextPhrase)
+{
+    Group g;
+    auto table = g.add_table("table");
+    auto col = table->add_column(type_String, "text");
+    table->add_fulltext_index(col);
+
+    auto k0 = table->create_object().set(col, "The quick brown fox jumps over the lazy dog").get_key();
+    auto k1 = table->create_object().set(col, "A brown dog and a quick fox").get_key();
+    auto k2 = table->create_object().set(col, "Quick, Brown: Fox!").get_key();
+    auto k3 = table->create_object().set(col, "The fox is quick").get_key();
+
+    auto find = [&](const char* terms) {
+        auto tv = table->find_all_fulltext(col, terms);
+        std::vector<ObjKey> keys;
+        for (size_t i = 0; i < tv.size(); ++i)
+            keys.push_back(tv.get_key(i));
+        return keys;
+    };
+    using Keys = std::vector<ObjKey>;
+    CHECK(find("quick fox") == Keys({k0, k1, k2, k3}));
+    CHECK(find("\"quick brown fox\"") == Keys({k0, k2}));
+    CHECK(find("\"brown fox\" lazy") == Keys({k0}));
+    CHECK(find("\"fox quick\"") == Keys());
+    CHECK(find("\"quick fox\"") == Keys({k1}));
+    // Punctuation in the phrase only separates the words
+    CHECK(find("\"quick-brown\"") == Keys({k0, k2}));
+    // A phrase of one word is just that word
+    CHECK(find("\"lazy\"") == Keys({k0}));
+    CHECK(find("fox -\"quick brown\"") == Keys({k1, k3}));
+    CHECK(find("-\"quick brown\"") == Keys({k1, k3}));
+    CHECK(find("fox -qu*") == Keys());
+    CHECK(find("fox -la*") == Keys({k1, k2, k3}));
+    CHECK(find("\"quick brown\" -do*") == Keys({k2}));
+
+    auto q = table->query("text TEXT '\"the quick brown\"'");
+    CHECK_EQUAL(q.count(), 1);
+
+    CHECK_THROW(find("\"quick brown"), InvalidArgument);
+    CHECK_THROW(find("\"quick\" -quick"), InvalidArgument);
+}
+
+TEST(Query_FullTextScores)
+{
+    Group g;
+    auto table = g.add_table("table");
+    auto col = table->add_column(type_String, "text", true);
+    auto col_plain = table->add_column(type_String, "plain");
+    table->add_fulltext_index(col);
+
+    auto k0 = table->create_object().set(col, "realm database").get_key();
+    auto k1 = table->create_object().set(col, "realm realm realm database").get_key();
+    auto k2 = table->create_object()
+                  .set(col, "a long text that mentions the realm database only once among many other words")
+                  .get_key();
+    auto k3 = table->create_object().set(col, "sqlite").get_key();
+    auto k4 = table->create_object().get_key();
+    table->create_object().set(col, "database");
+
+    std::vector<ObjKey> keys{k0, k1, k2, k3, k4};
+    auto scores = table->get_fulltext_scores(col, "realm", keys);
+    CHECK_EQUAL(scores.size(), 5);
+    // More occurrences score higher, longer texts lower
+    CHECK_GREATER(scores[1], scores[0]);
+    CHECK_GREATER(scores[0], scores[2]);
+    CHECK_GREATER(scores[2], 0);
+    CHECK_EQUAL(scores[3], 0);
+    CHECK_EQUAL(scores[4], 0);
+
+    // A rare word is worth more than a common one
+    scores = table->get_fulltext_scores(col, "realm database", {k0});
+    auto both = scores[0];
+    scores = table->get_fulltext_scores(col, "realm", {k0});
+    auto realm_only = scores[0];
+    scores = table->get_fulltext_scores(col, "database", {k0});
+    auto database_only = scores[0];
+    CHECK_APPROXIMATELY_EQUAL(both, realm_only + database_only, 1e-9);
+    CHECK_GREATER(realm_only, database_only);
+
+    // Check one score against the formula
+    double num_objects = 6;
+    double avg_words = (2 + 4 + 14 + 1 + 0 + 1) / num_objects;
+    double idf = std::log((num_objects - 3 + 0.5) / (3 + 0.5) + 1);
+    double expected = idf * 3 * 2.2 / (3 + 1.2 * (1 - 0.75 + 0.75 * 4 / avg_words));
+    CHECK_APPROXIMATELY_EQUAL(table->get_fulltext_scores(col, "realm", {k1})[0], expected, 1e-9);
+
+    // Prefixes match all words starting with them
+    CHECK_APPROXIMATELY_EQUAL(table->get_fulltext_scores(col, "rea*", {k1})[0], expected, 1e-9);
+    // Excluded words don't count
+    CHECK_APPROXIMATELY_EQUAL(table->get_fulltext_scores(col, "realm -sqlite", {k1})[0], expected, 1e-9);
+
+    auto tv = table->find_all_fulltext(col, "realm");
+    scores = tv.get_fulltext_scores(col, "realm");
+    CHECK_EQUAL(scores.size(), 3);
+    CHECK_APPROXIMATELY_EQUAL(scores[1], expected, 1e-9);
+    table->remove_object(k1);
+    scores = tv.get_fulltext_scores(col, "realm");
+    CHECK_EQUAL(scores[1], 0);
+
+    CHECK_THROW(table->get_fulltext_scores(col_plain, "realm", {k0}), IllegalOperation);
+}
+
+
+TEST(Query_BatchEvaluation)
+{
+    // Arithmetic and comparisons of numeric columns are evaluated for many rows at a time, which must give the
+    // same results as evaluating each object through Mixed
+    Table table;
+    auto col_int = table.add_column(type_Int, "i");
+    auto col_nint = table.add_column(type_Int, "ni", true);
+    auto col_float = table.add_column(type_Float, "f", true);
+    auto col_double = table.add_column(type_Double, "d");
+    Random random(random_int<unsigned long>());
+    for (int i = 0; i < 3000; i++) {
+        auto obj = table.create_object();
+        obj.set(col_int, random.draw_int<int64_t>(-20, 20));
+        if (random.draw_int_mod(5) != 0)
+            obj.set(col_nint, random.draw_int<int64_t>(-20, 20));
+        if (random.draw_int_mod(5) != 0)
+            obj.set(col_float, random.draw_int<int>(-40, 40) / 2.0f);
+        obj.set(col_double, random.draw_int<int>(-80, 80) / 4.0);
+    }
+    // Integers which a double cannot represent, and a NaN
+    table.create_object().set(col_int, (int64_t(1) << 53) + 1).set(col_double, double(int64_t(1) << 53));
+    table.create_object().set(col_int, 1).set(col_nint, 0).set(col_float, std::nanf("1"));
+
+    auto check = [&](const char* query_string, auto&& expected) {
+        auto tv = table.query(query_string).find_all();
+        size_t count = 0;
+        for (auto obj : table) {
+            bool match = expected(obj.get_any(col_int), obj.get_any(col_nint), obj.get_any(col_float),
+                                  obj.get_any(col_double));
+            if (match) {
+                CHECK_LESS(count, tv.size());
+                if (count < tv.size())
+                    CHECK_EQUAL(tv.get_key(count), obj.get_key());
+                count++;
+            }
+        }
+        CHECK_EQUAL(tv.size(), count);
+    };
+
+    check("i + d > f", [](Mixed i, Mixed, Mixed f, Mixed d) {
+        return Greater()(QueryValue(i + d), QueryValue(f));
+    });
+    check("ni * 2 == i - 3", [](Mixed i, Mixed ni, Mixed, Mixed) {
+        return Equal()(QueryValue(ni * Mixed(2)), QueryValue(i - Mixed(3)));
+    });
+    check("i / ni < 5", [](Mixed i, Mixed ni, Mixed, Mixed) {
+        return Less()(QueryValue(i / ni), QueryValue(5));
+    });
+    check("f - 1.5 >= ni", [](Mixed, Mixed ni, Mixed f, Mixed) {
+        return GreaterEqual()(QueryValue(f - Mixed(1.5)), QueryValue(ni));
+    });
+    check("ni != i + 1", [](Mixed i, Mixed ni, Mixed, Mixed) {
+        return NotEqual()(QueryValue(ni), QueryValue(i + Mixed(1)));
+    });
+    check("f / ni <= d * f", [](Mixed, Mixed ni, Mixed f, Mixed d) {
+        return LessEqual()(QueryValue(f / ni), QueryValue(d * f));
+    });
+    check("i == d", [](Mixed i, Mixed, Mixed, Mixed d) {
+        return Equal()(QueryValue(i), QueryValue(d));
+    });
+    check("f == f", [](Mixed, Mixed, Mixed f, Mixed) {
+        return Equal()(QueryValue(f), QueryValue(f));
+    });
+}
+
+TEST(Query_ConditionColumns)
+{
+    Group g;
+    auto target = g.add_table("target");
+    auto table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "str");
+    auto col_other = table->add_column(type_Int, "other");
+    auto col_link = table->add_column(*target, "link");
+    static_cast<void>(col_other);
+
+    auto columns = [&](const Query& q) {
+        std::vector<ColKey> cols;
+        if (!q.get_condition_columns(cols))
+            return std::optional<std::set<ColKey>>();
+        return std::optional<std::set<ColKey>>(std::set<ColKey>(cols.begin(), cols.end()));
+    };
+    using Columns = std::set<ColKey>;
+
+    CHECK(*columns(table->where()) == Columns{});
+    CHECK(*columns(table->where().equal(col_int, 5)) == (Columns{col_int}));
+    CHECK(*columns(table->where().equal(col_int, 5).equal(col_str, "a")) == (Columns{col_int, col_str}));
+    CHECK(*columns(table->where().equal(col_int, 5).Or().equal(col_str, "a")) == (Columns{col_int, col_str}));
+    CHECK(*columns(table->where().Not().equal(col_str, "a")) == (Columns{col_str}));
+    CHECK(*columns(table->query("int == 5 AND NOT str == 'a'")) == (Columns{col_int, col_str}));
+    CHECK(*columns(table->where().links_to(col_link, ObjKey(1))) == (Columns{col_link}));
+
+    // Expressions and restricting views may read anything
+    CHECK_NOT(columns(table->query("int + other > 5")));
+    CHECK_NOT(columns(table->query("link.@count > 0 OR int == 5")));
+    auto view = table->where().find_all();
+    CHECK_NOT(columns(table->where(&view).equal(col_int, 5)));
+}
+
 #endif // TEST_QUERY
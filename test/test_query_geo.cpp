@@ -24,12 +24,16 @@
 #undef CHECK
 
 #include "test.hpp"
+#include "util/random.hpp"
 
+#include <realm/db.hpp>
+#include <realm/history.hpp>
 #include <realm/geospatial.hpp>
 #include <realm/group.hpp>
 #include <realm/table.hpp>
 #include <realm/query_expression.hpp>
 #include <realm/table_view.hpp>
+#include <realm/transaction.hpp>
 
 #include <ostream>
 #include <sstream>
@@ -404,4 +408,202 @@ TEST(Geospatial_PolygonValidation)
     CHECK(status.is_ok());
 }
 
+static std::vector<ObjKey> find_keys(Query q)
+{
+    TableView tv = q.find_all();
+    std::vector<ObjKey> keys;
+    for (size_t i = 0; i < tv.size(); ++i) {
+        keys.push_back(tv.get_key(i));
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+TEST(Geospatial_IndexQueries)
+{
+    Random random(random_int<unsigned long>());
+    Group g;
+    std::vector<Geospatial> data;
+    for (size_t i = 0; i < 1000; ++i) {
+        data.push_back(GeoPoint{random.draw_float<double>() * 360 - 180, random.draw_float<double>() * 180 - 90});
+    }
+    // Points on the meridian and on the poles
+    data.push_back(GeoPoint{180, 1});
+    data.push_back(GeoPoint{-180, -1});
+    data.push_back(GeoPoint{0, 90});
+    data.push_back(GeoPoint{0, -90});
+    TableRef table = setup_with_points(g, data);
+    TableRef location_table = g.get_table("Location");
+    ColKey location_col = table->get_column_key("location");
+    ColKey list_col = table->add_column_list(*location_table, "locations");
+    for (auto& obj : *table) {
+        LnkLst list = obj.get_linklist(list_col);
+        for (size_t i = random.draw_int_mod(3); i > 0; --i) {
+            Obj location = list.create_and_insert_linked_object(0);
+            Geospatial{GeoPoint{random.draw_float<double>() * 20, random.draw_float<double>() * 20}}.assign_to(location);
+        }
+    }
+    // Objects without a valid point
+    table->create_object_with_primary_key(-1);
+    table->create_object_with_primary_key(-2).create_and_set_linked_object(location_col);
+
+    std::vector<Geospatial> shapes = {
+        GeoBox{GeoPoint{-10, -10}, GeoPoint{10, 10}},
+        GeoBox{GeoPoint{0.1, 0.2}, GeoPoint{0.3, 0.4}},
+        GeoBox{GeoPoint{-180, -90}, GeoPoint{180, 90}},
+        GeoCircle::from_kms(1000, GeoPoint{5, 5}),
+        GeoCircle::from_kms(3000, GeoPoint{179, 0}),
+        GeoCircle{1, GeoPoint{0, 90}},
+        GeoPolygon{{{{-178.0, 10.0}, {178.0, 10.0}, {178.0, -10.0}, {-178.0, -10.0}, {-178.0, 10.0}}}},
+        GeoPolygon{{{{-5, -5}, {15, -5}, {15, 15}, {-5, 15}, {-5, -5}}, {{0, 0}, {5, 0}, {5, 5}, {0, 5}, {0, 0}}}},
+    };
+    std::vector<util::Optional<ExpressionComparisonType>> comparison_types = {
+        util::none, ExpressionComparisonType::Any, ExpressionComparisonType::All, ExpressionComparisonType::None};
+
+    auto make_queries = [&] {
+        std::vector<Query> queries;
+        for (auto& shape : shapes) {
+            queries.push_back(table->column<Link>(location_col).geo_within(shape));
+            queries.push_back(table->column<Link>(location_col).geo_within(shape) &&
+                              table->column<Int>(table->get_primary_key_column()) > 500);
+            for (auto& type : comparison_types) {
+                queries.push_back(table->column<Link>(list_col, type).geo_within(shape));
+            }
+        }
+        return queries;
+    };
+    std::vector<std::vector<ObjKey>> expected;
+    for (auto& q : make_queries()) {
+        expected.push_back(find_keys(q));
+    }
+    CHECK_EQUAL(expected[0].size(), table->column<Link>(location_col).geo_within(shapes[0]).count());
+
+    CHECK_THROW(table->add_geospatial_index(), IllegalOperation);
+    location_table->add_geospatial_index();
+    CHECK(location_table->has_geospatial_index());
+    location_table->verify();
+
+    auto queries = make_queries();
+    for (size_t i = 0; i < queries.size(); ++i) {
+        CHECK(find_keys(queries[i]) == expected[i]);
+        CHECK_EQUAL(queries[i].count(), expected[i].size());
+    }
+}
+
+TEST(Geospatial_IndexUpdates)
+{
+    Group g;
+    std::vector<Geospatial> data = {GeoPoint{0, 0}, GeoPoint{1, 1}, GeoPoint{2, 2}, GeoPoint{3, 3}};
+    TableRef table = setup_with_points(g, data);
+    TableRef location_table = g.get_table("Location");
+    ColKey location_col = table->get_column_key("location");
+    ColKey type_col = location_table->get_column_key("type");
+    ColKey coords_col = location_table->get_column_key("coordinates");
+    location_table->add_geospatial_index();
+    CHECK_EQUAL(location_table->get_geospatial_index()->size(), 4);
+
+    Geospatial box{GeoBox{GeoPoint{0.5, 0.5}, GeoPoint{2.5, 2.5}}};
+    auto count = [&] {
+        location_table->verify();
+        return table->column<Link>(location_col).geo_within(box).count();
+    };
+    CHECK_EQUAL(count(), 2);
+
+    // Replacing the point
+    Obj obj = table->get_object_with_primary_key(0);
+    obj.set(location_col, Geospatial{GeoPoint{1.5, 1.5}});
+    CHECK_EQUAL(count(), 3);
+
+    // Changing the coordinates
+    Lst<double> coords = obj.get_linked_object(location_col).get_list<double>(coords_col);
+    coords.set(0, 10);
+    CHECK_EQUAL(count(), 2);
+    coords.add(1.2);
+    coords.move(2, 0);
+    CHECK_EQUAL(count(), 2);
+    coords.swap(1, 2);
+    CHECK_EQUAL(count(), 3);
+    coords.remove(0);
+    CHECK_EQUAL(count(), 2);
+    coords.insert(0, 2);
+    CHECK_EQUAL(count(), 3);
+    coords.clear();
+    CHECK_EQUAL(count(), 2);
+    CHECK_EQUAL(location_table->get_geospatial_index()->size(), 3);
+    coords.add(1);
+    coords.add(1);
+    CHECK_EQUAL(count(), 3);
+
+    // Changing the type
+    Obj point = obj.get_linked_object(location_col);
+    point.set(type_col, "Polygon");
+    CHECK_EQUAL(count(), 2);
+    point.set(type_col, "point");
+    CHECK_EQUAL(count(), 3);
+
+    // Removing objects
+    table->get_object_with_primary_key(1).remove();
+    CHECK_EQUAL(count(), 2);
+    obj.set(location_col, Geospatial{});
+    CHECK_EQUAL(count(), 1);
+    CHECK_EQUAL(location_table->get_geospatial_index()->size(), 2);
+    table->clear();
+    CHECK_EQUAL(count(), 0);
+    CHECK_EQUAL(location_table->get_geospatial_index()->size(), 0);
+
+    table->create_object_with_primary_key(7).set(location_col, Geospatial{GeoPoint{1, 2}});
+    CHECK_EQUAL(count(), 1);
+
+    location_table->remove_geospatial_index();
+    CHECK_NOT(location_table->has_geospatial_index());
+    CHECK_EQUAL(count(), 1);
+
+    // Removing a column removes the index
+    location_table->add_geospatial_index();
+    location_table->remove_column(type_col);
+    CHECK_NOT(location_table->has_geospatial_index());
+    CHECK_THROW(location_table->add_geospatial_index(), IllegalOperation);
+}
+
+TEST(Geospatial_IndexPersistence)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    Geospatial box{GeoBox{GeoPoint{-1, -1}, GeoPoint{1, 1}}};
+    {
+        auto wt = db->start_write();
+        setup_with_points(*wt, {GeoPoint{0, 0}, GeoPoint{2, 2}, GeoPoint{0.5, -0.5}});
+        wt->get_table("Location")->add_geospatial_index();
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("Restaurant");
+    auto location_table = rt->get_table("Location");
+    ColKey location_col = table->get_column_key("location");
+    CHECK(location_table->has_geospatial_index());
+    location_table->verify();
+    CHECK_EQUAL(table->column<Link>(location_col).geo_within(box).count(), 2);
+
+    {
+        auto wt = db->start_write();
+        auto t = wt->get_table("Restaurant");
+        t->create_object_with_primary_key(10).set(location_col, Geospatial{GeoPoint{-0.5, 0.5}});
+        t->get_object_with_primary_key(0).remove();
+        wt->commit();
+    }
+    rt->advance_read();
+    location_table->verify();
+    CHECK_EQUAL(table->column<Link>(location_col).geo_within(box).count(), 2);
+
+    {
+        auto wt = db->start_write();
+        wt->get_table("Location")->remove_geospatial_index();
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_NOT(location_table->has_geospatial_index());
+    CHECK_EQUAL(table->column<Link>(location_col).geo_within(box).count(), 2);
+}
+
 #endif
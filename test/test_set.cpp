@@ -98,6 +98,48 @@ TEST(Set_Basics)
 }
 
 
+TEST(Set_InsertMany)
+{
+    Group g;
+    auto t = g.add_table("foo");
+    auto col_int = t->add_column_set(type_Int, "ints");
+    auto col_str = t->add_column_set(type_String, "strings", true);
+    auto col_double = t->add_column_set(type_Double, "doubles");
+    auto obj = t->create_object();
+
+    auto ints = obj.get_set<Int>(col_int);
+    std::vector<Int> values;
+    for (int i = 2000; i > 0; i--) {
+        values.push_back(i * 2);
+        values.push_back(i * 2);
+    }
+    CHECK_EQUAL(ints.insert_many(values), 2000);
+    CHECK_EQUAL(ints.size(), 2000);
+    // Values in between and after the existing ones
+    CHECK_EQUAL(ints.insert_many({4001, 3, 4, 5000, 0, 5000}), 4);
+    CHECK_EQUAL(ints.size(), 2004);
+    CHECK_EQUAL(ints.insert_many({}), 0);
+    for (size_t i = 1; i < ints.size(); i++) {
+        CHECK_LESS(ints.get(i - 1), ints.get(i));
+    }
+    CHECK_EQUAL(ints.get(0), 0);
+    CHECK_EQUAL(ints.get(2), 3);
+    CHECK_EQUAL(ints.get(2003), 5000);
+    CHECK_EQUAL(ints.find(4001), 2002);
+
+    auto strings = obj.get_set<String>(col_str);
+    strings.insert("b");
+    CHECK_EQUAL(strings.insert_many_any({Mixed("c"), Mixed(), Mixed("a"), Mixed("b")}), 3);
+    CHECK_EQUAL(strings.size(), 4);
+    CHECK(strings.is_null(0));
+    CHECK_EQUAL(strings.get(1), "a");
+    CHECK_EQUAL(strings.get(3), "c");
+
+    auto doubles = obj.get_set<Double>(col_double);
+    CHECK_EQUAL(doubles.insert_many({2.5, 1.5, 2.5}), 2);
+    CHECK_EQUAL(doubles.get(0), 1.5);
+}
+
 TEST(Set_Mixed)
 {
     Group g;
@@ -888,6 +930,123 @@ static std::ostream& operator<<(std::ostream& os, const Set<T>& set)
 }
 } // namespace realm
 
+TEST(Set_MergeLarge)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    auto tr = db->start_write();
+    auto foos = tr->add_table("class_Foo");
+    ColKey col_ints = foos->add_column_set(type_Int, "int set");
+    ColKey col_strings = foos->add_column_set(type_String, "string set");
+    auto obj1 = foos->create_object();
+    auto obj2 = foos->create_object();
+    auto set1 = obj1.get_set<Int>(col_ints);
+    auto set2 = obj2.get_set<Int>(col_ints);
+    auto strings1 = obj1.get_set<String>(col_strings);
+    auto strings2 = obj2.get_set<String>(col_strings);
+
+    auto check = [&](auto& set, const auto& expected) {
+        CHECK_EQUAL(set.size(), expected.size());
+        size_t ndx = 0;
+        for (auto& value : expected) {
+            CHECK_EQUAL(set.get(ndx++), value);
+        }
+    };
+    auto reset = [&](const std::set<Int>& s1, const std::set<Int>& s2) {
+        set1.clear();
+        set2.clear();
+        set1.insert_many({s1.begin(), s1.end()});
+        set2.insert_many({s2.begin(), s2.end()});
+    };
+
+    std::set<Int> multiples_of_2, multiples_of_3, single;
+    for (Int i = 0; i < 20000; i += 2) {
+        multiples_of_2.insert(i);
+    }
+    for (Int i = 0; i < 30000; i += 3) {
+        multiples_of_3.insert(i);
+    }
+    single.insert(9);
+
+    auto expect = [&](auto algorithm, const std::set<Int>& s1, const std::set<Int>& s2) {
+        std::set<Int> result;
+        algorithm(s1.begin(), s1.end(), s2.begin(), s2.end(), std::inserter(result, result.end()));
+        return result;
+    };
+    auto set_union = [](auto... args) {
+        return std::set_union(args...);
+    };
+    auto set_intersection = [](auto... args) {
+        return std::set_intersection(args...);
+    };
+    auto set_difference = [](auto... args) {
+        return std::set_difference(args...);
+    };
+    auto set_symmetric_difference = [](auto... args) {
+        return std::set_symmetric_difference(args...);
+    };
+
+    // Rebuilt in one go
+    reset(multiples_of_2, multiples_of_3);
+    set1.assign_union(set2);
+    check(set1, expect(set_union, multiples_of_2, multiples_of_3));
+    reset(multiples_of_2, multiples_of_3);
+    set1.assign_intersection(set2);
+    check(set1, expect(set_intersection, multiples_of_2, multiples_of_3));
+    reset(multiples_of_2, multiples_of_3);
+    set1.assign_difference(set2);
+    check(set1, expect(set_difference, multiples_of_2, multiples_of_3));
+    reset(multiples_of_2, multiples_of_3);
+    set1.assign_symmetric_difference(set2);
+    check(set1, expect(set_symmetric_difference, multiples_of_2, multiples_of_3));
+
+    // Changed in place
+    reset(multiples_of_3, single);
+    set1.assign_union(set2);
+    check(set1, multiples_of_3);
+    set2.insert(10);
+    set1.assign_symmetric_difference(set2);
+    check(set1, expect(set_symmetric_difference, multiples_of_3, {9, 10}));
+    set1.assign_difference(set2);
+    check(set1, expect(set_difference, multiples_of_3, {9, 10}));
+
+    // Empty results and operands
+    set2.clear();
+    set1.assign_intersection(set2);
+    CHECK_EQUAL(set1.size(), 0);
+    set2.insert(5);
+    set1.assign_union(set2);
+    check(set1, std::set<Int>{5});
+
+    // The result refers to strings in both sets until it has been written
+    std::set<std::string> words1, words2;
+    for (int i = 0; i < 3000; i++) {
+        words1.insert(util::format("word %1", i * 2));
+        words2.insert(util::format("word %1", i * 5));
+    }
+    for (auto& word : words1) {
+        strings1.insert(word);
+    }
+    for (auto& word : words2) {
+        strings2.insert(word);
+    }
+    std::set<std::string> expected;
+    std::set_union(words1.begin(), words1.end(), words2.begin(), words2.end(),
+                   std::inserter(expected, expected.end()));
+    strings1.assign_union(strings2);
+    CHECK_EQUAL(strings1.size(), expected.size());
+    size_t ndx = 0;
+    for (auto& word : expected) {
+        CHECK_EQUAL(strings1.get(ndx++), word);
+    }
+
+    tr->verify();
+    tr->commit_and_continue_as_read();
+    auto rt = db->start_read();
+    CHECK_EQUAL(rt->get_table("class_Foo")->get_object(obj1.get_key()).get_set<String>(col_strings).size(),
+                expected.size());
+}
+
 TEST(Set_Equality)
 {
     // Table tries to avoid ColKey collisions, but we specifically want to trigger
@@ -1567,6 +1567,1066 @@ TEST(Shared_WriterThreads)
     }
 }
 
+TEST(Shared_GroupCommit)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    const int thread_count = 8;
+    const int num_commits = 50;
+    {
+        DBOptions options(crypt_key());
+        options.enable_group_commit = true;
+        DBRef sg = DB::create(path, options);
+        {
+            WriteTransaction wt(sg);
+            auto t = wt.add_table("test");
+            t->add_column(type_Int, "value");
+            for (int i = 0; i < thread_count; ++i)
+                t->create_object(ObjKey(i));
+            wt.commit();
+        }
+
+        Thread threads[thread_count];
+        for (int i = 0; i < thread_count; ++i) {
+            threads[i].start([&, i] {
+                for (int j = 0; j < num_commits; ++j) {
+                    auto tr = sg->start_write();
+                    auto t = tr->get_table("test");
+                    t->get_object(ObjKey(i)).add_int(t->get_column_key("value"), 1);
+                    if (j % 2) {
+                        tr->commit();
+                    }
+                    else {
+                        tr->commit_and_continue_as_read();
+                        CHECK_EQUAL(t->get_object(ObjKey(i)).get<Int>("value"), j + 1);
+                    }
+                }
+            });
+        }
+        for (int i = 0; i < thread_count; ++i)
+            threads[i].join();
+
+        auto rt = sg->start_read();
+        rt->verify();
+        auto t = rt->get_table("test");
+        for (int i = 0; i < thread_count; ++i)
+            CHECK_EQUAL(t->get_object(ObjKey(i)).get<Int>("value"), num_commits);
+    }
+
+    // The file header must refer to the last commit
+    Group g(path, crypt_key());
+    auto t = g.get_table("test");
+    for (int i = 0; i < thread_count; ++i)
+        CHECK_EQUAL(t->get_object(ObjKey(i)).get<Int>("value"), num_commits);
+}
+
+TEST(Shared_ReadLockFastPath)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    const int thread_count = 8;
+    const int num_reads = 100;
+    DBRef sg = DB::create(path, DBOptions(crypt_key()));
+    {
+        WriteTransaction wt(sg);
+        wt.add_table("test")->add_column(type_Int, "value");
+        wt.commit();
+    }
+
+    // Further read locks on a version this process holds a read lock on don't
+    // go through the lock file
+    auto rt = sg->start_read();
+    auto stats = sg->get_read_lock_stats();
+    auto rt2 = sg->start_read();
+    auto frozen = sg->start_frozen(rt->get_version_of_current_transaction());
+    auto stats2 = sg->get_read_lock_stats();
+    CHECK_EQUAL(stats2.local_acquisitions, stats.local_acquisitions + 1);
+    CHECK_EQUAL(stats2.lock_file_acquisitions, stats.lock_file_acquisitions + 1);
+    CHECK_EQUAL(rt2->get_version_of_current_transaction(), rt->get_version_of_current_transaction());
+    CHECK_EQUAL(frozen->get_version_of_current_transaction(), rt->get_version_of_current_transaction());
+
+    Thread threads[thread_count];
+    for (int i = 0; i < thread_count; ++i) {
+        threads[i].start([&, i] {
+            for (int j = 0; j < num_reads; ++j) {
+                if (i == 0 && j % 10 == 0) {
+                    auto wt = sg->start_write();
+                    wt->get_table("test")->create_object();
+                    wt->commit();
+                    continue;
+                }
+                auto tr = sg->start_read();
+                CHECK(tr->get_table("test"));
+            }
+        });
+    }
+    for (int i = 0; i < thread_count; ++i)
+        threads[i].join();
+    CHECK_GREATER(sg->get_read_lock_stats().local_acquisitions, stats2.local_acquisitions);
+
+    // Compaction needs all other read transactions to be gone
+    CHECK_NOT(sg->compact());
+    rt.reset();
+    rt2.reset();
+    frozen.reset();
+    CHECK(sg->compact());
+    CHECK_EQUAL(sg->start_read()->get_table("test")->size(), num_reads / 10);
+}
+
+TEST(Shared_PinnedVersions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.track_pinned_versions = true;
+    DBRef sg = DB::create(path, options);
+    {
+        WriteTransaction wt(sg);
+        wt.add_table("test")->add_column(type_Int, "value");
+        wt.commit();
+    }
+
+    TransactionRef rt;
+    {
+        DB::PinTag outer("outer");
+        DB::PinTag inner("inner");
+        rt = sg->start_read();
+    }
+    auto frozen = sg->start_frozen();
+    auto pinned = sg->get_pinned_versions();
+    CHECK_EQUAL(pinned.size(), 2);
+    CHECK_EQUAL(pinned[0].version, rt->get_version());
+    CHECK_NOT(pinned[0].frozen);
+    CHECK_EQUAL(pinned[0].tag, "inner");
+    CHECK(pinned[0].owner_thread == std::this_thread::get_id());
+    CHECK(pinned[0].age >= pinned[1].age);
+    CHECK(pinned[1].frozen);
+    CHECK(pinned[1].tag.empty());
+
+    rt.reset();
+    frozen.reset();
+    CHECK(sg->get_pinned_versions().empty());
+}
+
+TEST(Shared_MaxReadTransactionAge)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.max_read_transaction_age = std::chrono::milliseconds(10);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef sg = DB::create(*hist, path, options);
+    {
+        WriteTransaction wt(sg);
+        wt.add_table("test")->add_column(type_Int, "value");
+        wt.commit();
+    }
+
+    auto rt = sg->start_read();
+    auto frozen = sg->start_frozen();
+    millisleep(50);
+    auto fresh = sg->start_read();
+    {
+        WriteTransaction wt(sg);
+        wt.get_table("test")->create_object();
+        wt.commit();
+    }
+
+    // The old read transaction no longer pins its version, while the frozen
+    // one and the new one are left alone
+    CHECK_NOT(rt->is_attached());
+    CHECK_THROW(rt->advance_read(), StaleAccessor);
+    CHECK(frozen->is_attached());
+    CHECK(fresh->is_attached());
+    auto pinned = sg->get_pinned_versions();
+    CHECK_EQUAL(pinned.size(), 2);
+    CHECK(pinned[0].frozen);
+
+    fresh->advance_read();
+    CHECK_EQUAL(fresh->get_table("test")->size(), 1);
+    rt.reset();
+    frozen.reset();
+    fresh.reset();
+    CHECK(sg->compact());
+}
+
+TEST(Shared_AsyncWritePipeline)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    const int num_writers = 4;
+    {
+        DBOptions options(crypt_key());
+        options.enable_async_writes = true;
+        options.async_write_pipeline_depth = 2;
+        DBRef sg = DB::create(make_in_realm_history(), path, options);
+        {
+            auto wt = sg->start_write();
+            wt->add_table("test")->add_column(type_Int, "value");
+            wt->commit();
+        }
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<int> acquired;
+        std::vector<int> synced;
+        TransactionRef trs[num_writers];
+        for (int i = 0; i < num_writers; ++i) {
+            trs[i] = sg->start_read();
+            sg->async_request_write_mutex(trs[i], [&, i] {
+                std::lock_guard lock(mutex);
+                acquired.push_back(i);
+                cv.notify_all();
+            });
+        }
+
+        // Each writer gets the write lock once the previous one has committed,
+        // without waiting for its commit to be synced
+        for (int n = 0; n < num_writers; ++n) {
+            int i;
+            {
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [&] {
+                    return acquired.size() > size_t(n);
+                });
+                i = acquired[n];
+            }
+            trs[i]->promote_to_write();
+            trs[i]->get_table("test")->create_object().set("value", i);
+            trs[i]->commit_and_continue_as_read(false);
+            trs[i]->async_complete_writes([&, i] {
+                std::lock_guard lock(mutex);
+                synced.push_back(i);
+                cv.notify_all();
+            });
+        }
+
+        {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&] {
+                return synced.size() == num_writers;
+            });
+            // Completions are in commit order
+            CHECK(synced == acquired);
+        }
+        for (auto& tr : trs)
+            tr->close();
+        // The sync queue is popped just after the completion is invoked
+        while (sg->get_async_pipeline_depth() > 0)
+            millisleep(1);
+        CHECK_EQUAL(sg->get_async_pipeline_depth(), 0);
+    }
+
+    // The file header must refer to the last commit
+    Group g(path, crypt_key());
+    CHECK_EQUAL(g.get_table("test")->size(), num_writers);
+}
+
+TEST(Shared_WritePriority)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(make_in_realm_history(), path, DBOptions(crypt_key()));
+    {
+        WriteTransaction wt(sg);
+        wt.add_table("test")->add_column(type_Int, "value");
+        wt.commit();
+    }
+
+    std::mutex mutex;
+    std::vector<DB::WritePriority> order;
+    auto writer = [&](DB::WritePriority priority) {
+        auto wt = sg->start_write(false, priority);
+        {
+            std::lock_guard lock(mutex);
+            order.push_back(priority);
+        }
+        wt->get_table("test")->create_object().set("value", int(priority));
+        wt->commit();
+    };
+
+    uint64_t normal_acquisitions = sg->get_write_lock_wait_stats(DB::WritePriority::Normal).acquisitions;
+    auto wt = sg->start_write();
+    CHECK_NOT(wt->yield_write());
+
+    // The background writer asks first, but has to wait for the interactive one
+    Thread background, interactive;
+    background.start([&] {
+        writer(DB::WritePriority::Background);
+    });
+    while (!sg->writers_waiting_for_lock(DB::WritePriority::Background))
+        millisleep(1);
+    interactive.start([&] {
+        writer(DB::WritePriority::Interactive);
+    });
+    while (!sg->writers_waiting_for_lock(DB::WritePriority::Interactive))
+        millisleep(1);
+
+    wt->get_table("test")->create_object().set("value", -1);
+    CHECK(wt->yield_write());
+    CHECK_EQUAL(wt->get_table("test")->size(), 2);
+    {
+        // We're back in line ahead of the background writer
+        std::lock_guard lock(mutex);
+        CHECK_EQUAL(order.size(), 1);
+        CHECK(order[0] == DB::WritePriority::Interactive);
+    }
+    wt->commit();
+    background.join();
+    interactive.join();
+    CHECK_EQUAL(order.size(), 2);
+    CHECK(order[1] == DB::WritePriority::Background);
+
+    auto interactive_stats = sg->get_write_lock_wait_stats(DB::WritePriority::Interactive);
+    CHECK_EQUAL(interactive_stats.acquisitions, 1);
+    CHECK(interactive_stats.total_wait > std::chrono::nanoseconds(0));
+    CHECK(interactive_stats.max_wait == interactive_stats.total_wait);
+    CHECK_EQUAL(sg->get_write_lock_wait_stats(DB::WritePriority::Background).acquisitions, 1);
+    // Once at the start and once after yielding
+    CHECK_EQUAL(sg->get_write_lock_wait_stats(DB::WritePriority::Normal).acquisitions, normal_acquisitions + 2);
+}
+
+TEST(Shared_StorageMetrics)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(make_in_realm_history(), path, DBOptions(crypt_key()));
+    {
+        auto wt = sg->start_write();
+        auto table = wt->add_table("test");
+        table->add_column(type_Int, "value");
+        wt->commit();
+    }
+    auto before = sg->get_metrics();
+    auto rt = sg->start_read();
+    for (int i = 0; i < 10; ++i) {
+        auto wt = sg->start_write();
+        auto table = wt->get_table("test");
+        for (int j = 0; j < 100; ++j)
+            table->create_object().set("value", j);
+        wt->commit();
+    }
+
+    auto metrics = sg->get_metrics();
+    CHECK_EQUAL(metrics.commits.commits, before.commits.commits + 10);
+    CHECK_GREATER(metrics.commits.bytes_written, before.commits.bytes_written);
+    CHECK_GREATER(metrics.commits.last_bytes_written, 0);
+    CHECK(metrics.commits.write_group_time > before.commits.write_group_time);
+    CHECK(metrics.commits.free_list_time <= metrics.commits.write_group_time);
+    CHECK(metrics.commits.max_commit_time > std::chrono::nanoseconds(0));
+    CHECK_EQUAL(metrics.write_lock_wait.acquisitions, before.write_lock_wait.acquisitions + 10);
+    CHECK_GREATER_EQUAL(metrics.mappings.num_mappings, 1);
+    CHECK_GREATER(metrics.mappings.mapped_size, 0);
+    // The version held by `rt` and the latest one
+    CHECK_GREATER_EQUAL(metrics.live_versions, 2);
+    CHECK_GREATER_EQUAL(metrics.version_list_capacity, metrics.live_versions);
+}
+
+TEST(Shared_FlushChanges)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    const size_t num_objects = 20000;
+    {
+        DBOptions options(crypt_key());
+        options.write_transaction_memory_limit = 0x10000;
+        DBRef sg = DB::create(make_in_realm_history(), path, options);
+        {
+            auto wt = sg->start_write();
+            auto table = wt->add_table("test");
+            table->add_column(type_Int, "value");
+            table->add_column(type_String, "name");
+            wt->commit();
+        }
+        auto version = sg->get_version_of_latest_snapshot();
+        auto rt = sg->start_read();
+
+        auto wt = sg->start_write();
+        auto table = wt->get_table("test");
+        Obj first = table->create_object();
+        size_t num_flushes = 0;
+        for (size_t i = 1; i < num_objects; ++i) {
+            std::string name = util::format("object %1", i);
+            table->create_object().set_all(int64_t(i), StringData(name));
+            if (wt->flush_changes_if_needed())
+                ++num_flushes;
+            CHECK_LESS_EQUAL(wt->get_commit_size(), 2 * options.write_transaction_memory_limit);
+        }
+        CHECK_GREATER(num_flushes, 0);
+
+        // Nothing has been committed yet
+        CHECK_EQUAL(sg->get_version_of_latest_snapshot(), version);
+        rt->advance_read();
+        CHECK_EQUAL(rt->get_table("test")->size(), 0);
+
+        // Accessors survive the flushes
+        first.set("value", -1);
+        CHECK_EQUAL(table->size(), num_objects);
+        wt->commit();
+
+        rt->advance_read();
+        CHECK_EQUAL(rt->get_table("test")->size(), num_objects);
+        CHECK_EQUAL(rt->get_table("test")->get_object(0).get<Int>("value"), -1);
+
+        // Flushed changes are discarded by a rollback
+        wt = sg->start_write();
+        wt->get_table("test")->clear();
+        wt->flush_changes();
+        CHECK_EQUAL(wt->get_table("test")->size(), 0);
+        wt->rollback();
+        rt->advance_read();
+        CHECK_EQUAL(rt->get_table("test")->size(), num_objects);
+        rt->verify();
+    }
+
+    Group g(path, crypt_key());
+    auto table = g.get_table("test");
+    CHECK_EQUAL(table->size(), num_objects);
+    CHECK_EQUAL(table->find_first_int(table->get_column_key("value"), int64_t(num_objects - 1)),
+                table->get_object(num_objects - 1).get_key());
+}
+
+TEST(Shared_ShareFrozenTransactions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.share_frozen_transactions = true;
+    DBRef sg = DB::create(make_in_realm_history(), path, options);
+    {
+        auto wt = sg->start_write();
+        wt->add_table("test")->add_column(type_Int, "value");
+        wt->commit();
+    }
+
+    auto frozen_1 = sg->start_frozen();
+    auto rt = sg->start_read();
+    auto frozen_2 = rt->freeze();
+    CHECK_EQUAL(frozen_1, frozen_2);
+    CHECK_EQUAL(frozen_1, sg->start_frozen(rt->get_version_of_current_transaction()));
+    auto table = frozen_1->get_table("test");
+    CHECK_EQUAL(table, frozen_2->get_table("test"));
+
+    {
+        auto wt = sg->start_write();
+        wt->get_table("test")->create_object();
+        wt->commit();
+    }
+    auto frozen_3 = sg->start_frozen();
+    CHECK_NOT_EQUAL(frozen_3, frozen_1);
+    CHECK_EQUAL(frozen_3->get_table("test")->size(), 1);
+
+    // Closing one reference leaves the transaction open for the others
+    frozen_1->close();
+    CHECK(frozen_2->is_attached());
+    CHECK_EQUAL(table->size(), 0);
+
+    // The version is released with the last reference. Cleanup happens
+    // before a commit, so it takes two commits for it to go away.
+    auto version = rt->get_version_of_current_transaction();
+    rt->close();
+    frozen_1.reset();
+    table = TableRef();
+    frozen_2.reset();
+    for (int i = 0; i < 2; ++i) {
+        auto wt = sg->start_write();
+        wt->commit();
+    }
+    CHECK_THROW(sg->start_frozen(version), DB::BadVersion);
+}
+
+TEST(Shared_AdvanceReadUnchangedTables)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(make_in_realm_history(), path, DBOptions(crypt_key()));
+    ColKey col_a, col_b;
+    {
+        auto wt = sg->start_write();
+        col_a = wt->add_table("a")->add_column(type_Int, "value");
+        col_b = wt->add_table("b")->add_column(type_Int, "value");
+        for (int i = 0; i < 100; ++i) {
+            wt->get_table("a")->create_object().set(col_a, i);
+            wt->get_table("b")->create_object().set(col_b, i);
+        }
+        wt->commit();
+    }
+
+    auto rt = sg->start_read();
+    auto table_a = rt->get_table("a");
+    auto table_b = rt->get_table("b");
+    Obj obj_b = table_b->get_object(50);
+    for (int i = 0; i < 3; ++i) {
+        auto wt = sg->start_write();
+        auto table = wt->get_table("a");
+        table->get_object(50).add_int(col_a, 1000);
+        table->create_object().set(col_a, 100 + i);
+        wt->commit();
+        rt->advance_read();
+        CHECK_EQUAL(table_a->size(), 101 + i);
+        CHECK_EQUAL(table_a->get_object(50).get<Int>(col_a), 50 + 1000 * (i + 1));
+        CHECK_EQUAL(table_b->size(), 100);
+        CHECK_EQUAL(obj_b.get<Int>(col_b), 50);
+        CHECK_EQUAL(table_b->find_first_int(col_b, 99), table_b->get_object(99).get_key());
+    }
+
+    // Tables not modified by a commit of the transaction itself are also kept
+    rt->promote_to_write();
+    table_b->get_object(10).set(col_b, -10);
+    rt->commit_and_continue_as_read();
+    rt->promote_to_write();
+    table_a->get_object(10).set(col_a, -10);
+    rt->commit_and_continue_as_read();
+    CHECK_EQUAL(table_a->get_object(10).get<Int>(col_a), -10);
+    CHECK_EQUAL(table_b->get_object(10).get<Int>(col_b), -10);
+    CHECK_EQUAL(obj_b.get<Int>(col_b), 50);
+    rt->verify();
+}
+
+TEST(Shared_ReuseReadTransactions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.reuse_read_transactions = true;
+    DBRef sg = DB::create(make_in_realm_history(), path, options);
+    ColKey col_a, col_b;
+    {
+        auto wt = sg->start_write();
+        col_a = wt->add_table("a")->add_column(type_Int, "value");
+        col_b = wt->add_table("b")->add_column(type_String, "value");
+        wt->get_table("a")->create_object().set(col_a, 1);
+        wt->get_table("b")->create_object().set(col_b, "one");
+        wt->commit();
+    }
+
+    auto rt = sg->start_read();
+    Transaction* released = rt.get();
+    auto table_a = rt->get_table("a");
+    Obj obj_b = rt->get_table("b")->get_object(0);
+    CHECK_EQUAL(obj_b.get<String>(col_b), "one");
+    rt.reset();
+
+    // Accessors obtained from a released transaction become invalid, even
+    // though the next transaction reuses them
+    CHECK_NOT(table_a);
+    CHECK_NOT(obj_b.is_valid());
+    {
+        auto wt = sg->start_write();
+        wt->get_table("a")->get_object(0).set(col_a, 2);
+        wt->commit();
+    }
+    auto frozen = sg->start_frozen();
+    rt = sg->start_read();
+    CHECK_EQUAL(rt.get(), released);
+    CHECK_NOT(table_a);
+    CHECK_EQUAL(rt->get_table("a")->get_object(0).get<Int>(col_a), 2);
+    CHECK_EQUAL(rt->get_table("b")->get_object(0).get<String>(col_b), "one");
+    frozen.reset();
+
+    // Another transaction started meanwhile is not reused. When both are
+    // released, only one of them is kept.
+    auto rt_2 = sg->start_read();
+    CHECK_NOT_EQUAL(rt_2.get(), released);
+    rt_2.reset();
+    rt.reset();
+
+    // Changes to the schema are picked up by the reused accessors
+    ColKey col_c;
+    {
+        auto wt = sg->start_write();
+        wt->remove_table("a");
+        wt->get_table("b")->add_column(type_Int, "count");
+        col_c = wt->add_table("c")->add_column(type_Int, "value");
+        wt->get_table("c")->create_object().set(col_c, 3);
+        wt->commit();
+    }
+    rt = sg->start_read();
+    CHECK_NOT(rt->has_table("a"));
+    auto table_b = rt->get_table("b");
+    CHECK_EQUAL(table_b->get_column_count(), 2);
+    CHECK_EQUAL(table_b->get_object(0).get<Int>("count"), 0);
+    CHECK_EQUAL(rt->get_table("c")->get_object(0).get<Int>(col_c), 3);
+
+    // A transaction which has written is reused as well
+    rt->promote_to_write();
+    table_b->get_object(0).set("count", 5);
+    rt->commit_and_continue_as_read();
+    rt.reset();
+    rt = sg->start_read();
+    CHECK_EQUAL(rt->get_table("b")->get_object(0).get<Int>("count"), 5);
+    rt->verify();
+
+    // A transaction which is closed first is not reused
+    rt->close();
+    rt.reset();
+    {
+        auto wt = sg->start_write();
+        wt->get_table("c")->create_object().set(col_c, 4);
+        wt->commit();
+    }
+    rt = sg->start_read();
+    CHECK_EQUAL(rt->get_table("c")->size(), 2);
+    rt.reset();
+
+    // The kept transaction holds no read lock, so the DB can be closed
+    sg->close();
+}
+
+TEST(Shared_HotTables)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    const char* key = crypt_key(true);
+    DBOptions options(key);
+    options.hot_tables = {"hot"};
+    options.hot_tables_memory_limit = 1024 * 1024;
+    {
+        DBRef sg = DB::create(path, options);
+        auto wt = sg->start_write();
+        auto hot = wt->add_table("hot");
+        auto cold = wt->add_table("cold");
+        auto col_hot = hot->add_column(type_String, "value");
+        auto col_cold = cold->add_column(type_String, "value");
+        for (int i = 0; i < 1000; ++i) {
+            hot->create_object().set(col_hot, util::format("hot value %1", i));
+            cold->create_object().set(col_cold, util::format("cold value %1", i));
+        }
+        wt->commit();
+    }
+
+    DBRef sg = DB::create(path, options);
+    size_t memory = sg->get_hot_tables_memory();
+    if (!key) {
+        // Only the pages of encrypted files need to be kept in memory
+        CHECK_EQUAL(memory, 0);
+        return;
+    }
+    CHECK_GREATER(memory, 0);
+    CHECK_LESS_EQUAL(memory, options.hot_tables_memory_limit);
+
+    // A commit which grows the table is picked up by the next read
+    {
+        auto wt = sg->start_write();
+        auto hot = wt->get_table("hot");
+        for (int i = 0; i < 1000; ++i)
+            hot->create_object().set("value", util::format("more hot values %1", i));
+        wt->commit();
+    }
+    auto rt = sg->start_read();
+    CHECK_GREATER(sg->get_hot_tables_memory(), memory);
+    CHECK_LESS_EQUAL(sg->get_hot_tables_memory(), options.hot_tables_memory_limit);
+    CHECK_EQUAL(rt->get_table("hot")->size(), 2000);
+    rt->verify();
+
+    // A smaller budget is respected
+    sg->set_hot_tables({"hot"}, 4 * util::page_size());
+    CHECK_LESS_EQUAL(sg->get_hot_tables_memory(), 4 * util::page_size());
+
+    sg->set_hot_tables({}, 0);
+    CHECK_EQUAL(sg->get_hot_tables_memory(), 0);
+}
+
+TEST(Shared_SnapshotDiff)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(make_in_realm_history(), path, DBOptions(crypt_key()));
+    ColKey col_int, col_str;
+    TableKey table_key;
+    {
+        auto wt = sg->start_write();
+        auto table = wt->add_table("test");
+        table_key = table->get_key();
+        col_int = table->add_column(type_Int, "int");
+        col_str = table->add_column(type_String, "str");
+        // Enough objects for several leaves
+        for (int64_t i = 0; i < 1000; ++i) {
+            table->create_object(ObjKey(i)).set(col_int, i).set(col_str, "foo");
+        }
+        wt->commit();
+    }
+    auto frozen_1 = sg->start_frozen();
+    CHECK(frozen_1->diff(*frozen_1).empty());
+
+    TableKey other_key;
+    {
+        auto wt = sg->start_write();
+        auto table = wt->get_table("test");
+        table->get_object(ObjKey(500)).set(col_int, 5);
+        // Setting the current value changes nothing
+        table->get_object(ObjKey(600)).set(col_str, "foo");
+        table->remove_object(ObjKey(10));
+        table->create_object(ObjKey(2000)).set(col_int, 7);
+        other_key = wt->add_table("other")->get_key();
+        wt->commit();
+    }
+    auto frozen_2 = sg->start_frozen();
+
+    auto diff = frozen_1->diff(*frozen_2);
+    CHECK_EQUAL(diff.size(), 2);
+    CHECK_EQUAL(diff[0].table_key, table_key);
+    CHECK(diff[0].insertions == std::vector<ObjKey>{ObjKey(2000)});
+    CHECK(diff[0].deletions == std::vector<ObjKey>{ObjKey(10)});
+    CHECK(diff[0].modifications == std::vector<ObjKey>{ObjKey(500)});
+    CHECK(diff[0].columns == std::vector<ColKey>{col_int});
+    CHECK_EQUAL(diff[1].table_key, other_key);
+    CHECK(diff[1].insertions.empty());
+
+    diff = frozen_2->diff(*frozen_1);
+    CHECK_EQUAL(diff.size(), 2);
+    CHECK(diff[0].insertions == std::vector<ObjKey>{ObjKey(10)});
+    CHECK(diff[0].deletions == std::vector<ObjKey>{ObjKey(2000)});
+    CHECK(diff[0].modifications == std::vector<ObjKey>{ObjKey(500)});
+    CHECK_EQUAL(diff[1].table_key, other_key);
+}
+
+TEST(Shared_MappingAdvice)
+{
+    using Advice = DBOptions::MappingAdvice;
+    for (auto advice : {Advice::Normal, Advice::Random, Advice::Sequential, Advice::WillNeed}) {
+        SHARED_GROUP_TEST_PATH(path);
+        DBOptions options(crypt_key());
+        options.mapping_advice = advice;
+        options.use_huge_pages_for_slabs = true;
+        DBRef sg = DB::create(path, options);
+        const size_t num_objects = 100000;
+        {
+            // Large enough to need a slab backed by huge pages
+            WriteTransaction wt(sg);
+            auto t = wt.add_table("test");
+            auto col_int = t->add_column(type_Int, "int");
+            auto col_str = t->add_column(type_String, "str");
+            for (size_t i = 0; i < num_objects; ++i)
+                t->create_object().set(col_int, int64_t(i)).set(col_str, std::string(20, 'a' + i % 26));
+            wt.commit();
+        }
+        {
+            WriteTransaction wt(sg);
+            auto t = wt.get_table("test");
+            auto col_int = t->get_column_key("int");
+            for (auto& o : *t)
+                o.add_int(col_int, 1);
+            wt.commit();
+        }
+        auto rt = sg->start_read();
+        rt->verify();
+        auto t = rt->get_table("test");
+        CHECK_EQUAL(t->size(), num_objects);
+        CHECK_EQUAL(t->sum(t->get_column_key("int"))->get_int(), int64_t(num_objects * (num_objects + 1) / 2));
+        CHECK_EQUAL(t->begin()->get<String>("str"), std::string(20, 'a'));
+    }
+}
+
+
+TEST(Shared_WarmUp)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    {
+        DBRef sg = DB::create(path, DBOptions(crypt_key()));
+        WriteTransaction wt(sg);
+        for (auto name : {"a", "b"}) {
+            auto t = wt.add_table(name);
+            auto col_int = t->add_column(type_Int, "int");
+            auto col_str = t->add_column(type_String, "str");
+            t->add_search_index(col_str);
+            for (int i = 0; i < 10000; ++i)
+                t->create_object().set(col_int, i).set(col_str, util::to_string(i));
+        }
+        wt.commit();
+    }
+
+    DBOptions options(crypt_key());
+    options.warm_up_on_open = true;
+    DBRef sg = DB::create(path, options);
+
+    std::vector<std::pair<size_t, size_t>> calls;
+    size_t bytes = sg->warm_up({}, [&](size_t tables_done, size_t num_tables, size_t bytes_read) {
+        CHECK_EQUAL(num_tables, 2);
+        calls.emplace_back(tables_done, bytes_read);
+    });
+    CHECK_GREATER(bytes, 2 * 10000 * sizeof(int64_t) / 8);
+    CHECK_EQUAL(calls.size(), 2);
+    CHECK_EQUAL(calls[0].first, 1);
+    CHECK_EQUAL(calls[1].first, 2);
+    CHECK_EQUAL(calls[1].second, bytes);
+    CHECK_EQUAL(sg->warm_up({"a"}) + sg->warm_up({"b"}), bytes);
+    CHECK_THROW(sg->warm_up({"a", "c"}), NoSuchTable);
+
+    auto rt = sg->start_read();
+    CHECK_EQUAL(rt->get_table("b")->where().equal(rt->get_table("b")->get_column_key("str"), "4711").count(), 1);
+}
+
+TEST(Shared_StagedCommitWrites)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.enable_staged_commit_writes = true;
+    ColKey col_int, col_str;
+    {
+        DBRef sg = DB::create(path, options);
+        {
+            WriteTransaction wt(sg);
+            auto t = wt.add_table("table");
+            col_int = t->add_column(type_Int, "int");
+            col_str = t->add_column(type_String, "str");
+            t->add_search_index(col_str);
+            // Enough data for the staging buffer to be written more than once
+            for (int i = 0; i < 100000; ++i)
+                t->create_object(ObjKey(i)).set(col_int, i).set(col_str, util::to_string(i));
+            wt.commit();
+        }
+        // Small commits scattered over the file
+        for (int i = 0; i < 100; ++i) {
+            WriteTransaction wt(sg);
+            auto t = wt.get_table("table");
+            for (int j = 0; j < 10; ++j)
+                t->get_object(ObjKey((i * 4713 + j * 997) % 100000)).set(col_int, -1);
+            wt.commit();
+        }
+        auto rt = sg->start_read();
+        rt->verify();
+    }
+
+    DBRef sg = DB::create(path, DBOptions(crypt_key()));
+    auto rt = sg->start_read();
+    rt->verify();
+    auto t = rt->get_table("table");
+    CHECK_EQUAL(t->size(), 100000);
+    CHECK_EQUAL(t->where().equal(col_int, -1).count(), 1000);
+    CHECK_EQUAL(t->where().equal(col_str, "4711").count(), 1);
+    CHECK_EQUAL(t->get_object(ObjKey(99999)).get<String>(col_str), "99999");
+}
+
+TEST(Shared_IntegerCompression)
+{
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+    const int64_t epoch = 1700000000000;
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    const int num_objects = 10000;
+    ColKey col_time, col_small, col_max, col_null;
+    auto populate = [&](DBRef db) {
+        WriteTransaction wt(db);
+        auto t = wt.add_table("table");
+        col_time = t->add_column(type_Int, "time");
+        col_small = t->add_column(type_Int, "small");
+        col_max = t->add_column(type_Int, "max");
+        col_null = t->add_column(type_Int, "null", true);
+        for (int i = 0; i < num_objects; ++i) {
+            t->create_object(ObjKey(i)).set_all(epoch + i * 7, 1000000 + i % 10, max - i % 100, epoch + i);
+        }
+        wt.commit();
+    };
+
+    DBOptions options(crypt_key());
+    options.enable_integer_compression = true;
+    DBRef db = DB::create(path_1, options);
+    populate(db);
+    {
+        DBRef plain_db = DB::create(path_2, DBOptions(crypt_key()));
+        populate(plain_db);
+        size_t free_1, used_1, free_2, used_2;
+        db->get_stats(free_1, used_1);
+        plain_db->get_stats(free_2, used_2);
+        CHECK_LESS(used_1, used_2);
+    }
+
+    auto check = [&](ConstTableRef t) {
+        CHECK_EQUAL(t->size(), num_objects);
+        CHECK_EQUAL(t->get_object(ObjKey(4711)).get<Int>(col_time), epoch + 4711 * 7);
+        CHECK_EQUAL(t->get_object(ObjKey(4711)).get<Int>(col_small), 1000001);
+        CHECK_EQUAL(t->get_object(ObjKey(4711)).get<Int>(col_max), max - 11);
+        CHECK_EQUAL(t->get_object(ObjKey(4711)).get<util::Optional<Int>>(col_null), epoch + 4711);
+        CHECK_EQUAL(t->find_first_int(col_time, epoch + 4711 * 7), ObjKey(4711));
+        CHECK_EQUAL(t->find_first_int(col_time, epoch + 1), ObjKey());
+        CHECK_EQUAL(t->where().equal(col_small, 1000003).count(), num_objects / 10);
+        CHECK_EQUAL(t->where().equal(col_small, 3).count(), 0);
+        CHECK_EQUAL(t->where().not_equal(col_small, 1000003).count(), num_objects - num_objects / 10);
+        CHECK_EQUAL(t->where().greater(col_time, epoch + 7 * 9000).count(), 999);
+        CHECK_EQUAL(t->where().less(col_time, epoch + 7 * 100).count(), 100);
+        CHECK_EQUAL(t->where().less(col_time, 0).count(), 0);
+        CHECK_EQUAL(t->where().greater(col_max, max - 10).count(), num_objects / 10);
+        CHECK_EQUAL(t->where().equal(col_max, max).count(), num_objects / 100);
+        CHECK_EQUAL(t->where().between(col_time, epoch + 70, epoch + 139).count(), 10);
+        CHECK_EQUAL(t->sum(col_small)->get_int(), 1000000 * int64_t(num_objects) + 45 * num_objects / 10);
+        CHECK_EQUAL(t->min(col_time)->get_int(), epoch);
+        CHECK_EQUAL(t->max(col_time)->get_int(), epoch + (num_objects - 1) * 7);
+        CHECK_EQUAL(t->min(col_max)->get_int(), max - 99);
+        CHECK_EQUAL(t->max(col_max)->get_int(), max);
+        // Aggregates of one column under a condition on another
+        auto q = t->where().less(col_time, epoch + 7 * 100);
+        CHECK_EQUAL(q.sum(col_small)->get_int(), 1000000 * 100 + 45 * 10);
+        CHECK_EQUAL(q.min(col_max)->get_int(), max - 99);
+        CHECK_EQUAL(q.max(col_small)->get_int(), 1000009);
+        CHECK_EQUAL(q.avg(col_small)->get_double(), 1000004.5);
+        q = t->where().greater_equal(col_small, 1000005);
+        CHECK_EQUAL(q.sum(col_time)->get_int(), epoch * (num_objects / 2) + 7 * 25010000);
+        CHECK_EQUAL(q.min(col_time)->get_int(), epoch + 7 * 5);
+        CHECK_EQUAL(q.max(col_null)->get_int(), epoch + num_objects - 1);
+    };
+    {
+        auto rt = db->start_read();
+        rt->verify();
+        check(rt->get_table("table"));
+    }
+
+    // Modifying the leaves decodes them again
+    {
+        WriteTransaction wt(db);
+        auto t = wt.get_table("table");
+        t->get_object(ObjKey(0)).set(col_time, int64_t(1));
+        t->get_object(ObjKey(1)).set(col_small, int64_t(-5));
+        t->get_object(ObjKey(2)).add_int(col_max, -1000);
+        t->create_object(ObjKey(num_objects)).set_all(epoch, 1000000, max, 0);
+        t->remove_object(ObjKey(num_objects));
+        CHECK_EQUAL(t->get_object(ObjKey(0)).get<Int>(col_time), 1);
+        CHECK_EQUAL(t->get_object(ObjKey(3)).get<Int>(col_time), epoch + 21);
+        CHECK_EQUAL(t->get_object(ObjKey(1)).get<Int>(col_small), -5);
+        CHECK_EQUAL(t->get_object(ObjKey(2)).get<Int>(col_max), max - 1002);
+        wt.get_group().verify();
+        wt.commit();
+    }
+
+    db.reset();
+    db = DB::create(path_1, DBOptions(crypt_key()));
+    auto rt = db->start_read();
+    rt->verify();
+    auto t = rt->get_table("table");
+    CHECK_EQUAL(t->get_object(ObjKey(0)).get<Int>(col_time), 1);
+    CHECK_EQUAL(t->get_object(ObjKey(1)).get<Int>(col_small), -5);
+    CHECK_EQUAL(t->get_object(ObjKey(2)).get<Int>(col_max), max - 1002);
+    CHECK_EQUAL(t->where().equal(col_small, -5).count(), 1);
+    CHECK_EQUAL(t->get_object(ObjKey(num_objects - 1)).get<Int>(col_time), epoch + (num_objects - 1) * 7);
+}
+
+TEST(Shared_SetSameBlob)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(path);
+    std::string payload(5000, 'x');
+    for (size_t i = 0; i < payload.size(); i += 7)
+        payload[i] = char('a' + i % 26);
+    ColKey col_str, col_bin;
+    {
+        WriteTransaction wt(db);
+        auto t = wt.add_table("table");
+        col_str = t->add_column(type_String, "str");
+        col_bin = t->add_column(type_Binary, "bin");
+        t->create_object().set(col_str, StringData(payload)).set(col_bin, BinaryData(payload));
+        wt.commit();
+    }
+    TransactionRef rt;
+    auto read = [&] {
+        rt = db->start_read();
+        return rt->get_table("table")->get_object(0);
+    };
+    auto obj = read();
+    const char* str_data = obj.get<StringData>(col_str).data();
+    const char* bin_data = obj.get<BinaryData>(col_bin).data();
+
+    // Storing the same values again does not copy them to a new place in the file
+    {
+        WriteTransaction wt(db);
+        auto obj = wt.get_table("table")->get_object(0);
+        obj.set(col_str, StringData(payload)).set(col_bin, BinaryData(payload));
+        wt.commit();
+    }
+    obj = read();
+    CHECK_EQUAL(obj.get<StringData>(col_str), payload);
+    CHECK_EQUAL(obj.get<StringData>(col_str).data(), str_data);
+    CHECK_EQUAL(obj.get<BinaryData>(col_bin).data(), bin_data);
+
+    payload[10] = '!';
+    {
+        WriteTransaction wt(db);
+        auto obj = wt.get_table("table")->get_object(0);
+        obj.set(col_str, StringData(payload)).set(col_bin, BinaryData(payload));
+        wt.commit();
+    }
+    obj = read();
+    CHECK_EQUAL(obj.get<StringData>(col_str), payload);
+    CHECK_EQUAL(obj.get<BinaryData>(col_bin), BinaryData(payload));
+}
+
+TEST(Shared_CompressedColumns)
+{
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+    const int num_objects = 200;
+    auto payload = [](int i) {
+        std::string json = "[";
+        for (int j = 0; j < 100; ++j)
+            json += util::format("{\"id\": %1, \"status\": \"active\", \"country\": \"DK\"},", i + j);
+        return json + "]";
+    };
+    ColKey col_str, col_bin;
+    auto populate = [&](DBRef db, bool compress) {
+        WriteTransaction wt(db);
+        auto t = wt.add_table("table");
+        col_str = t->add_column(type_String, "str", true);
+        col_bin = t->add_column(type_Binary, "bin", true);
+        if (compress) {
+            t->set_compression(col_str);
+            t->set_compression(col_bin);
+        }
+        for (int i = 0; i < num_objects; ++i) {
+            auto obj = t->create_object(ObjKey(i));
+            if (i % 10 == 0)
+                continue;
+            std::string value = i % 10 == 1 ? std::string("short") : payload(i);
+            obj.set(col_str, StringData(value));
+            obj.set(col_bin, BinaryData(value.data(), value.size()));
+        }
+        wt.commit();
+    };
+
+    DBRef db = DB::create(path_1, DBOptions(crypt_key()));
+    populate(db, true);
+    {
+        DBRef plain_db = DB::create(path_2, DBOptions(crypt_key()));
+        populate(plain_db, false);
+        size_t free_1, used_1, free_2, used_2;
+        db->get_stats(free_1, used_1);
+        plain_db->get_stats(free_2, used_2);
+        CHECK_LESS(used_1 * 4, used_2);
+    }
+
+    auto check = [&](ConstTableRef t, int modified) {
+        CHECK(t->is_compressed(col_str));
+        CHECK(t->is_compressed(col_bin));
+        for (int i = 0; i < num_objects; ++i) {
+            auto obj = t->get_object(ObjKey(i));
+            if (i % 10 == 0) {
+                CHECK(obj.is_null(col_str));
+                CHECK(obj.is_null(col_bin));
+                continue;
+            }
+            std::string value = i == modified ? std::string("modified") : i % 10 == 1 ? std::string("short") : payload(i);
+            CHECK_EQUAL(obj.get<String>(col_str), value);
+            CHECK_EQUAL(obj.get<Binary>(col_bin), BinaryData(value.data(), value.size()));
+        }
+        std::string value = payload(47);
+        CHECK_EQUAL(t->where().equal(col_str, StringData(value)).find(), ObjKey(47));
+        CHECK_EQUAL(t->where().equal(col_bin, BinaryData(value.data(), value.size())).count(), 1);
+        CHECK_EQUAL(t->where().contains(col_str, StringData("\"id\": 150,")).count(), 80);
+        CHECK_EQUAL(t->where().equal(col_str, "short").count(), num_objects / 10);
+    };
+    {
+        auto rt = db->start_read();
+        rt->verify();
+        check(rt->get_table("table"), -1);
+    }
+
+    {
+        WriteTransaction wt(db);
+        auto t = wt.get_table("table");
+        t->get_object(ObjKey(3)).set(col_str, "modified");
+        t->get_object(ObjKey(3)).set(col_bin, BinaryData("modified", 8));
+        check(t, 3);
+        wt.get_group().verify();
+        wt.commit();
+    }
+
+    db.reset();
+    db = DB::create(path_1, DBOptions(crypt_key()));
+    auto rt = db->start_read();
+    rt->verify();
+    check(rt->get_table("table"), 3);
+
+    auto wt = db->start_write();
+    auto t = wt->get_table("table");
+    CHECK_THROW(t->set_compression(t->add_column(type_Int, "int")), IllegalOperation);
+    t->set_compression(col_str, false);
+    CHECK_NOT(t->is_compressed(col_str));
+}
 
 #if !REALM_ENABLE_ENCRYPTION && defined(ENABLE_ROBUST_AGAINST_DEATH_DURING_WRITE)
 // this unittest has issues that has not been fully understood, but could be
@@ -3957,6 +5017,89 @@ TEST(Shared_WriteCopy)
     CHECK_EQUAL(db->start_read()->get_table("foo")->size(), 1);
 }
 
+TEST(Shared_IncrementalBackup)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SHARED_GROUP_TEST_PATH(backup_path);
+    SHARED_GROUP_TEST_PATH(other_backup_path);
+    DBOptions options;
+    options.track_changed_pages = true;
+    DBRef db = DB::create(path, options);
+    ColKey col_int, col_str;
+    {
+        WriteTransaction wt(db);
+        auto t = wt.add_table("table");
+        col_int = t->add_column(type_Int, "int");
+        col_str = t->add_column(type_String, "str");
+        for (int i = 0; i < 100000; ++i)
+            t->create_object(ObjKey(i)).set(col_int, i).set(col_str, util::to_string(i));
+        wt.commit();
+    }
+    auto update = [&](DBRef db, int value) {
+        WriteTransaction wt(db);
+        auto t = wt.get_table("table");
+        for (int j = 0; j < 10; ++j)
+            t->get_object(ObjKey(j * 9973)).set(col_int, value);
+        wt.commit();
+    };
+    auto check_backup = [&](const std::string& path, int value) {
+        Group g(path);
+        g.verify();
+        auto t = g.get_table("table");
+        CHECK_EQUAL(t->size(), 100000);
+        CHECK_EQUAL(t->get_object(ObjKey(9973)).get<Int>(col_int), value);
+        CHECK_EQUAL(t->where().less(col_int, 0).count(), value < 0 ? 10 : 0);
+        CHECK_EQUAL(t->get_object(ObjKey(99999)).get<String>(col_str), "99999");
+    };
+    size_t file_size = size_t(File::get_size_static(path));
+
+    auto result = db->write_incremental_backup(backup_path);
+    CHECK(result.full_copy);
+    CHECK_EQUAL(result.version, db->get_version_of_latest_snapshot());
+    CHECK_GREATER_EQUAL(result.bytes_copied, file_size / 2);
+    check_backup(backup_path, 9973);
+
+    // Only the pages written by the commits since are copied
+    update(db, -1);
+    update(db, -2);
+    result = db->write_incremental_backup(backup_path);
+    CHECK_NOT(result.full_copy);
+    CHECK_EQUAL(result.version, db->get_version_of_latest_snapshot());
+    CHECK_LESS(result.bytes_copied, file_size / 4);
+    check_backup(backup_path, -2);
+
+    // Nothing but the 24 byte file header when nothing was committed
+    result = db->write_incremental_backup(backup_path);
+    CHECK_NOT(result.full_copy);
+    CHECK_EQUAL(result.bytes_copied, 24);
+
+    // A backup to another file starts over, after which the first backup is
+    // no longer the previous one
+    update(db, -3);
+    result = db->write_incremental_backup(other_backup_path);
+    CHECK(result.full_copy);
+    check_backup(other_backup_path, -3);
+    result = db->write_incremental_backup(backup_path);
+    CHECK(result.full_copy);
+    check_backup(backup_path, -3);
+
+    // A commit made without page tracking cannot be copied incrementally
+    {
+        DBRef untracked_db = DB::create(path);
+        CHECK_THROW(untracked_db->write_incremental_backup(other_backup_path), IllegalOperation);
+        update(untracked_db, -4);
+    }
+    update(db, -5);
+    result = db->write_incremental_backup(backup_path);
+    CHECK(result.full_copy);
+    check_backup(backup_path, -5);
+
+    update(db, -6);
+    result = db->write_incremental_backup(backup_path);
+    CHECK_NOT(result.full_copy);
+    check_backup(backup_path, -6);
+}
+
 TEST(Shared_CompareGroups)
 {
     SHARED_GROUP_TEST_PATH(path1);
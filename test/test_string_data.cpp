@@ -444,6 +444,82 @@ TEST(StringData_Substrings)
 }
 
 
+TEST(StringData_SearchSubstring)
+{
+    test_util::Random random(test_util::random_int<unsigned long>());
+    // A small alphabet, including NUL, gives many partial matches
+    const char alphabet[] = {'a', 'b', 'c', '\0'};
+    for (int iter = 0; iter < 2000; ++iter) {
+        std::string haystack(random.draw_int_max(200), 'a');
+        for (auto& c : haystack)
+            c = alphabet[random.draw_int_max(random.chance(1, 2) ? 1 : 3)];
+        std::string needle;
+        size_t needle_size = 1 + random.draw_int_max(40);
+        if (needle_size <= haystack.size() && random.chance(1, 2)) {
+            needle = haystack.substr(random.draw_int_max(haystack.size() - needle_size), needle_size);
+        }
+        else {
+            needle.resize(needle_size);
+            for (auto& c : needle)
+                c = alphabet[random.draw_int_max(1)];
+        }
+        size_t expected = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end()) -
+                          haystack.begin();
+        CHECK_EQUAL(search_substring(haystack, needle), expected);
+        CHECK_EQUAL(StringData(haystack).contains(needle), expected != haystack.size());
+    }
+
+    // Matches at both ends of a haystack spanning several vectors
+    std::string haystack(100, 'x');
+    haystack[0] = 'a';
+    haystack[99] = 'z';
+    CHECK_EQUAL(search_substring(haystack, "ax"), 0);
+    CHECK_EQUAL(search_substring(haystack, "xz"), 98);
+    CHECK_EQUAL(search_substring(haystack, haystack), 0);
+    CHECK_EQUAL(search_substring(haystack, "xa"), haystack.size());
+}
+
+
+TEST(StringData_SearchCaseFold)
+{
+    test_util::Random random(test_util::random_int<unsigned long>());
+    // Each token has the same size in both cases, where "æ" and "Æ" differ in
+    // their second byte only
+    const char* tokens[] = {"a", "A", "b", "B", "æ", "Æ"};
+    auto make_string = [&](size_t num_tokens, size_t num_kinds) {
+        std::string str;
+        for (size_t i = 0; i < num_tokens; ++i)
+            str += tokens[random.draw_int_max(num_kinds - 1)];
+        return str;
+    };
+    for (int iter = 0; iter < 2000; ++iter) {
+        // Make every other haystack ASCII only
+        size_t num_kinds = random.chance(1, 2) ? 4 : 6;
+        std::string haystack = make_string(random.draw_int_max(100), num_kinds);
+        std::string needle = make_string(1 + random.draw_int_max(20), num_kinds);
+        std::string upper = *case_map(needle, true);
+        std::string lower = *case_map(needle, false);
+        std::string haystack_lower = *case_map(haystack, false);
+        size_t expected = haystack_lower.find(lower);
+        if (expected == std::string::npos)
+            expected = haystack.size();
+        CHECK_EQUAL(search_case_fold(haystack, upper.c_str(), lower.c_str(), needle.size()), expected);
+        if (haystack.size() == needle.size()) {
+            CHECK_EQUAL(equal_case_fold(haystack, upper.c_str(), lower.c_str()), expected == 0);
+        }
+    }
+
+    std::string long_text = "The Quick Brown Fox Jumps Over The Lazy Dog, Æsop Wrote";
+    CHECK_EQUAL(search_case_fold(long_text, "ÆSOP", "æsop", 5), 45);
+    CHECK_EQUAL(search_case_fold(long_text, "LAZY DOG", "lazy dog", 8), 35);
+    CHECK_EQUAL(search_case_fold(long_text, "LAZY CAT", "lazy cat", 8), long_text.size());
+    CHECK(equal_case_fold(long_text, case_map(long_text, true)->c_str(), case_map(long_text, false)->c_str()));
+    std::string other_text = long_text;
+    other_text[30] = 'x';
+    CHECK(!equal_case_fold(other_text, case_map(long_text, true)->c_str(), case_map(long_text, false)->c_str()));
+}
+
+
 TEST(StringData_STL_String)
 {
     const char* pre = "hilbert";
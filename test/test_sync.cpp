@@ -24,6 +24,7 @@
 #include <realm/sync/changeset_encoder.hpp>
 #include <realm/sync/client.hpp>
 #include <realm/sync/history.hpp>
+#include <realm/sync/instruction_applier.hpp>
 #include <realm/sync/instructions.hpp>
 #include <realm/sync/network/default_socket.hpp>
 #include <realm/sync/network/http.hpp>
@@ -694,6 +695,316 @@ TEST(Sync_Replication)
 }
 
 
+TEST(Sync_BackgroundIntegration)
+{
+    // Replicate changes in file 1 to files 2 and 3, whose sessions share a
+    // connection and integrate on the worker pool.
+
+    TEST_CLIENT_DB(db_1);
+    TEST_CLIENT_DB(db_2);
+    TEST_CLIENT_DB(db_3);
+
+    {
+        TEST_DIR(dir);
+        ClientServerFixture::Config config;
+        config.client_integration_worker_threads = 2;
+        ClientServerFixture fixture(dir, test_context, std::move(config));
+        fixture.start();
+
+        Session session_1 = fixture.make_bound_session(db_1);
+        Session session_2 = fixture.make_bound_session(db_2);
+        Session session_3 = fixture.make_bound_session(db_3);
+
+        write_transaction(db_1, [](WriteTransaction& wt) {
+            TableRef table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+            table->add_column(type_Int, "i");
+        });
+        for (int i = 0; i < 100; ++i) {
+            WriteTransaction wt(db_1);
+            TableRef table = wt.get_table("class_foo");
+            table->create_object_with_primary_key(i).set<int64_t>("i", i);
+            wt.commit();
+            // Interleave local changes with the downloads being integrated in the background
+            if (i % 10 == 0) {
+                write_transaction(db_2, [&](WriteTransaction& wt) {
+                    TableRef table = wt.get_group().get_or_add_table_with_primary_key("class_bar", type_Int, "id");
+                    table->create_object_with_primary_key(i);
+                });
+            }
+        }
+
+        session_1.wait_for_upload_complete_or_client_stopped();
+        session_2.wait_for_upload_complete_or_client_stopped();
+        session_1.wait_for_download_complete_or_client_stopped();
+        session_2.wait_for_download_complete_or_client_stopped();
+        session_3.wait_for_download_complete_or_client_stopped();
+    }
+
+    ReadTransaction rt_1(db_1);
+    ReadTransaction rt_2(db_2);
+    ReadTransaction rt_3(db_3);
+    rt_1.get_group().verify();
+    rt_2.get_group().verify();
+    rt_3.get_group().verify();
+    CHECK(compare_groups(rt_1, rt_2, *test_context.logger));
+    CHECK(compare_groups(rt_1, rt_3, *test_context.logger));
+    CHECK_EQUAL(100, rt_1.get_table("class_foo")->size());
+    CHECK_EQUAL(10, rt_3.get_table("class_bar")->size());
+}
+
+
+TEST(Sync_SessionTelemetry)
+{
+    TEST_CLIENT_DB(db_1);
+    TEST_CLIENT_DB(db_2);
+
+    // The handler is called on the event loop thread, and read after the fixture is gone
+    std::vector<SessionTelemetry> reports;
+    {
+        TEST_DIR(dir);
+        ClientServerFixture::Config config;
+        config.client_session_telemetry_handler = [&](const SessionTelemetry& telemetry) {
+            reports.push_back(telemetry);
+        };
+        ClientServerFixture fixture(dir, test_context, std::move(config));
+        fixture.start();
+
+        Session session_1 = fixture.make_bound_session(db_1);
+        write_transaction(db_1, [](WriteTransaction& wt) {
+            TableRef table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+            for (int i = 0; i < 10; ++i)
+                table->create_object_with_primary_key(i);
+        });
+        session_1.wait_for_upload_complete_or_client_stopped();
+
+        Session session_2 = fixture.make_bound_session(db_2);
+        session_2.wait_for_download_complete_or_client_stopped();
+    }
+
+    bool found_upload = false, found_download = false;
+    for (const SessionTelemetry& telemetry : reports) {
+        CHECK_GREATER_EQUAL(telemetry.total_time.count(), 0);
+        if (telemetry.num_changesets == 0)
+            continue;
+        CHECK_GREATER(telemetry.message_size, 0);
+        if (telemetry.message == SessionTelemetry::Message::upload) {
+            found_upload = true;
+            CHECK_EQUAL(telemetry.realm_path, db_1->get_path());
+            CHECK_GREATER_EQUAL(telemetry.total_time, telemetry.send_time);
+        }
+        else {
+            found_download = true;
+            CHECK_EQUAL(telemetry.realm_path, db_2->get_path());
+            CHECK_EQUAL(telemetry.reciprocal_changesets, 0);
+            CHECK_EQUAL(telemetry.conflicting_changesets, 0);
+        }
+    }
+    CHECK(found_upload);
+    CHECK(found_download);
+}
+
+
+TEST(Sync_ServerIntegrationWorkers)
+{
+    // Upload to several server files at once, which are spread over the
+    // integration workers of the server, and download each of them to a
+    // second client file.
+
+    constexpr int num_files = 6;
+    std::unique_ptr<DBTestPathGuard> path_guards[2 * num_files];
+    DBRef upload_dbs[num_files], download_dbs[num_files];
+    for (int i = 0; i < 2 * num_files; ++i) {
+        std::string suffix = util::format(".client_%1.realm", i);
+        std::string test_path = get_test_path(test_context.get_test_name(), suffix);
+        path_guards[i].reset(new DBTestPathGuard(test_path));
+        DBRef db = DB::create(make_client_replication(), test_path);
+        if (i < num_files)
+            upload_dbs[i] = db;
+        else
+            download_dbs[i - num_files] = db;
+    }
+
+    {
+        TEST_DIR(dir);
+        ClientServerFixture::Config config;
+        config.server_num_integration_workers = 3;
+        ClientServerFixture fixture(dir, test_context, std::move(config));
+        fixture.start();
+
+        std::vector<std::unique_ptr<Session>> sessions;
+        for (int i = 0; i < num_files; ++i) {
+            std::string server_path = util::format("/test_%1", i);
+            sessions.push_back(std::make_unique<Session>(fixture.make_bound_session(upload_dbs[i], server_path)));
+            sessions.push_back(std::make_unique<Session>(fixture.make_bound_session(download_dbs[i], server_path)));
+            write_transaction(upload_dbs[i], [](WriteTransaction& wt) {
+                TableRef table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+                table->add_column(type_Int, "i");
+            });
+        }
+        for (int j = 0; j < 20; ++j) {
+            for (int i = 0; i < num_files; ++i) {
+                WriteTransaction wt(upload_dbs[i]);
+                TableRef table = wt.get_table("class_foo");
+                table->create_object_with_primary_key(j).set<int64_t>("i", i);
+                wt.commit();
+            }
+        }
+        for (auto& session : sessions)
+            session->wait_for_upload_complete_or_client_stopped();
+        for (auto& session : sessions)
+            session->wait_for_download_complete_or_client_stopped();
+    }
+
+    for (int i = 0; i < num_files; ++i) {
+        ReadTransaction rt_1(upload_dbs[i]);
+        ReadTransaction rt_2(download_dbs[i]);
+        CHECK(compare_groups(rt_1, rt_2, *test_context.logger));
+        ConstTableRef table = rt_2.get_table("class_foo");
+        CHECK(table);
+        if (table)
+            CHECK_EQUAL(20, table->size());
+    }
+}
+
+
+TEST(Sync_SharedDownloadCache)
+{
+    // Several clients download the same history from the same point, so all
+    // but the first of them are served from the shared download cache.
+
+    constexpr int num_readers = 4;
+    TEST_CLIENT_DB(db);
+    std::unique_ptr<DBTestPathGuard> path_guards[num_readers];
+    DBRef reader_dbs[num_readers];
+    for (int i = 0; i < num_readers; ++i) {
+        std::string suffix = util::format(".reader_%1.realm", i);
+        std::string test_path = get_test_path(test_context.get_test_name(), suffix);
+        path_guards[i].reset(new DBTestPathGuard(test_path));
+        reader_dbs[i] = DB::create(make_client_replication(), test_path);
+    }
+
+    TEST_DIR(dir);
+    ClientServerFixture::Config config;
+    config.server_shared_download_cache_max_size = 0x100000;
+    ClientServerFixture fixture(dir, test_context, std::move(config));
+    fixture.start();
+
+    {
+        Session session = fixture.make_bound_session(db);
+        write_transaction(db, [](WriteTransaction& wt) {
+            TableRef table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+            table->add_column(type_String, "s");
+        });
+        for (int i = 0; i < 100; ++i) {
+            WriteTransaction wt(db);
+            TableRef table = wt.get_table("class_foo");
+            table->create_object_with_primary_key(i).set("s", "Lorem ipsum dolor sit amet");
+            wt.commit();
+        }
+        session.wait_for_upload_complete_or_client_stopped();
+    }
+
+    std::vector<std::unique_ptr<Session>> sessions;
+    for (int i = 0; i < num_readers; ++i)
+        sessions.push_back(std::make_unique<Session>(fixture.make_bound_session(reader_dbs[i])));
+    for (auto& session : sessions)
+        session->wait_for_download_complete_or_client_stopped();
+
+    ReadTransaction rt_1(db);
+    for (int i = 0; i < num_readers; ++i) {
+        ReadTransaction rt_2(reader_dbs[i]);
+        CHECK(compare_groups(rt_1, rt_2, *test_context.logger));
+    }
+}
+
+
+TEST(Sync_ServerFileAccessCache)
+{
+    // Open the server files ahead of time on BIND, and keep no more than one
+    // of them open per thread, because they do not fit in the size limit
+    // together.
+
+    constexpr int num_files = 3;
+    std::unique_ptr<DBTestPathGuard> path_guards[num_files];
+    DBRef dbs[num_files];
+    for (int i = 0; i < num_files; ++i) {
+        std::string suffix = util::format(".client_%1.realm", i);
+        std::string test_path = get_test_path(test_context.get_test_name(), suffix);
+        path_guards[i].reset(new DBTestPathGuard(test_path));
+        dbs[i] = DB::create(make_client_replication(), test_path);
+    }
+
+    TEST_DIR(dir);
+    ClientServerFixture::Config config;
+    config.server_max_open_files_size = 1;
+    config.server_prefetch_files_on_bind = true;
+    ClientServerFixture fixture(dir, test_context, std::move(config));
+    fixture.start();
+
+    for (int i = 0; i < num_files; ++i) {
+        Session session = fixture.make_bound_session(dbs[i], util::format("/test_%1", i));
+        write_transaction(dbs[i], [](WriteTransaction& wt) {
+            TableRef table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+            table->create_object_with_primary_key(1);
+        });
+        session.wait_for_upload_complete_or_client_stopped();
+        session.wait_for_download_complete_or_client_stopped();
+    }
+
+    auto stats = fixture.get_server().get_file_access_cache_stats();
+    CHECK_GREATER_EQUAL(stats.prefetch_hits, num_files);
+    CHECK_GREATER_EQUAL(stats.misses, stats.prefetch_hits);
+    CHECK_GREATER_EQUAL(stats.evictions, 2 * (num_files - 1));
+    CHECK_GREATER(stats.hits, 0);
+}
+
+
+TEST(Sync_BootstrapSnapshot)
+{
+    // Let the server produce a bootstrap snapshot, then extend the history,
+    // and check that a new client ends up with the complete state, whether it
+    // was served the snapshot and the tail of the history, or the history
+    // alone.
+
+    TEST_CLIENT_DB(db_1);
+    TEST_CLIENT_DB(db_2);
+
+    TEST_DIR(dir);
+    ClientServerFixture::Config config;
+    config.server_bootstrap_snapshot_interval = 10;
+    ClientServerFixture fixture(dir, test_context, std::move(config));
+    fixture.start();
+
+    Session session_1 = fixture.make_bound_session(db_1);
+    write_transaction(db_1, [](WriteTransaction& wt) {
+        TableRef table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+        table->add_column(type_Int, "i");
+    });
+    for (int i = 0; i < 50; ++i) {
+        WriteTransaction wt(db_1);
+        wt.get_table("class_foo")->create_object_with_primary_key(i % 10).set<int64_t>("i", i);
+        wt.commit();
+    }
+    session_1.wait_for_upload_complete_or_client_stopped();
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+
+    for (int i = 0; i < 10; ++i) {
+        WriteTransaction wt(db_1);
+        wt.get_table("class_foo")->create_object_with_primary_key(100 + i);
+        wt.commit();
+    }
+    session_1.wait_for_upload_complete_or_client_stopped();
+
+    Session session_2 = fixture.make_bound_session(db_2);
+    session_2.wait_for_download_complete_or_client_stopped();
+
+    ReadTransaction rt_1(db_1);
+    ReadTransaction rt_2(db_2);
+    CHECK(compare_groups(rt_1, rt_2, *test_context.logger));
+    CHECK_EQUAL(20, rt_2.get_table("class_foo")->size());
+}
+
+
 TEST(Sync_Merge)
 {
 
@@ -6835,6 +7146,57 @@ TEST(Sync_DifferentUsersMultiplexing)
                     user_2_sess_2.sess.get_appservices_connection_id());
 }
 
+TEST(Sync_BatchedMessagesMultiplexing)
+{
+    // Sessions for several files share one connection, which writes the
+    // messages of up to four of them at a time.
+
+    constexpr int num_files = 6;
+    std::unique_ptr<DBTestPathGuard> path_guards[2 * num_files];
+    DBRef dbs[2 * num_files];
+    for (int i = 0; i < 2 * num_files; ++i) {
+        std::string suffix = util::format(".%1.realm", i);
+        std::string test_path = get_test_path(test_context.get_test_name(), suffix);
+        path_guards[i].reset(new DBTestPathGuard(test_path));
+        dbs[i] = DB::create(make_client_replication(), test_path);
+    }
+
+    TEST_DIR(dir);
+    ClientServerFixture::Config config;
+    config.one_connection_per_session = false;
+    config.client_max_batched_messages = 4;
+    ClientServerFixture fixture(dir, test_context, std::move(config));
+    fixture.start();
+
+    std::vector<std::unique_ptr<Session>> sessions;
+    for (int i = 0; i < num_files; ++i) {
+        std::string server_path = util::format("/test_%1", i);
+        sessions.push_back(std::make_unique<Session>(fixture.make_bound_session(dbs[i], server_path)));
+        write_transaction(dbs[i], [i](WriteTransaction& wt) {
+            TableRef table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+            for (int j = 0; j < 10; ++j)
+                table->create_object_with_primary_key(i * 100 + j);
+        });
+    }
+    for (int i = 0; i < num_files; ++i)
+        sessions[i]->wait_for_upload_complete_or_client_stopped();
+    for (int i = 0; i < num_files; ++i) {
+        std::string server_path = util::format("/test_%1", i);
+        sessions.push_back(
+            std::make_unique<Session>(fixture.make_bound_session(dbs[num_files + i], server_path)));
+    }
+    for (int i = 0; i < num_files; ++i)
+        sessions[num_files + i]->wait_for_download_complete_or_client_stopped();
+
+    CHECK_EQUAL(sessions.front()->get_appservices_connection_id(),
+                sessions.back()->get_appservices_connection_id());
+    for (int i = 0; i < num_files; ++i) {
+        ReadTransaction rt_1(dbs[i]);
+        ReadTransaction rt_2(dbs[num_files + i]);
+        CHECK(compare_groups(rt_1, rt_2, *test_context.logger));
+    }
+}
+
 TEST(Sync_TransformAgainstEmptyReciprocalChangeset)
 {
     TEST_CLIENT_DB(seed_db);
@@ -7255,6 +7617,281 @@ TEST(Sync_DanglingLinksCountInPriorSize)
     CHECK_EQUAL(arr_insert_instr.prior_size, 2);
 }
 
+TEST(Sync_CoalesceUploadableChangesets)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    ClientReplication repl;
+    auto db = realm::DB::create(repl, path);
+    auto& history = repl.get_history();
+    history.set_client_file_ident(sync::SaltedFileIdent{1, 123456}, true);
+
+    version_type last_version;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table_with_primary_key("class_table", type_Int, "_id");
+        table->add_column(type_Int, "value");
+        table->create_object_with_primary_key(1);
+        last_version = wt->commit();
+    }
+    for (int i = 0; i < 5; ++i) {
+        auto wt = db->start_write();
+        auto table = wt->get_table("class_table");
+        table->get_object_with_primary_key(1).set("value", i);
+        last_version = wt->commit();
+    }
+
+    auto find_uploadable = [&] {
+        UploadCursor upload_cursor{0, 0};
+        std::vector<sync::ClientHistory::UploadChangeset> changesets;
+        version_type locked_server_version = 0;
+        history.find_uploadable_changesets(upload_cursor, last_version, changesets, locked_server_version);
+        return changesets;
+    };
+
+    // The size limit prevents any merging
+    auto changesets = find_uploadable();
+    CHECK_EQUAL(changesets.size(), 6);
+    CHECK_EQUAL(sync::ClientHistory::coalesce_uploadable_changesets(changesets, 60000, 1), 0);
+    CHECK_EQUAL(changesets.size(), 6);
+
+    changesets = find_uploadable();
+    auto last_timestamp = changesets.back().origin_timestamp;
+    CHECK_EQUAL(sync::ClientHistory::coalesce_uploadable_changesets(changesets, 60000, 65536), 5);
+    CHECK_EQUAL(changesets.size(), 1);
+    CHECK_EQUAL(changesets[0].progress.client_version, last_version);
+    CHECK_EQUAL(changesets[0].origin_timestamp, last_timestamp);
+
+    // The merged changeset holds every update of the field, in commit order
+    Changeset merged;
+    ChunkedBinaryInputStream in{changesets[0].changeset};
+    parse_changeset(in, merged);
+    int64_t num_updates = 0;
+    for (auto instr : merged) {
+        if (auto update = instr->get_if<Instruction::Update>()) {
+            CHECK_EQUAL(mpark::get<int64_t>(update->object), 1);
+            CHECK_EQUAL(update->value.data.integer, num_updates);
+            ++num_updates;
+        }
+    }
+    CHECK_EQUAL(num_updates, 5);
+
+    // Applying the merged changeset gives the same state as the original ones
+    SHARED_GROUP_TEST_PATH(path_2);
+    auto db_2 = DB::create(make_client_replication(), path_2);
+    {
+        auto wt = db_2->start_write();
+        InstructionApplier applier{*wt};
+        applier.apply(merged);
+        wt->commit();
+    }
+    auto rt_1 = db->start_read();
+    auto rt_2 = db_2->start_read();
+    CHECK(compare_groups(*rt_1, *rt_2));
+}
+
+TEST(Sync_UploadChangesetsLeftInHistory)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    ClientReplication repl;
+    auto db = realm::DB::create(repl, path);
+    auto& history = repl.get_history();
+    history.set_client_file_ident(sync::SaltedFileIdent{1, 123456}, true);
+
+    // Changesets which are stored uncompressed, compressed, and too large to
+    // compress well
+    version_type last_version;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table_with_primary_key("class_table", type_Int, "_id");
+        table->add_column(type_String, "value");
+        table->create_object_with_primary_key(1);
+        last_version = wt->commit();
+    }
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    for (size_t size : {10, 10000, 60000}) {
+        auto wt = db->start_write();
+        auto table = wt->get_table("class_table");
+        std::string value(size, 'a');
+        if (size > 50000) {
+            for (auto& c : value)
+                c = random.draw_int<char>('a', 'z');
+        }
+        table->get_object_with_primary_key(1).set("value", value);
+        last_version = wt->commit();
+    }
+
+    auto find_uploadable = [&](bool decompress) {
+        UploadCursor upload_cursor{0, 0};
+        std::vector<sync::ClientHistory::UploadChangeset> changesets;
+        version_type locked_server_version = 0;
+        history.find_uploadable_changesets(upload_cursor, last_version, changesets, locked_server_version,
+                                           decompress);
+        return changesets;
+    };
+    auto read_all = [](util::InputStream& in) {
+        std::string result;
+        for (auto block = in.next_block(); block.size() != 0; block = in.next_block())
+            result.append(block.data(), block.size());
+        return result;
+    };
+
+    auto decompressed = find_uploadable(true);
+    auto in_history = find_uploadable(false);
+    CHECK_EQUAL(decompressed.size(), 4);
+    CHECK_EQUAL(in_history.size(), decompressed.size());
+    for (size_t i = 0; i < decompressed.size() && i < in_history.size(); ++i) {
+        CHECK(!decompressed[i].snapshot);
+        CHECK(in_history[i].snapshot);
+        CHECK(in_history[i].changeset.is_null());
+        CHECK_EQUAL(in_history[i].progress.client_version, decompressed[i].progress.client_version);
+        CHECK_EQUAL(in_history[i].size, decompressed[i].size);
+        CHECK_EQUAL(decompressed[i].size, decompressed[i].changeset.size());
+
+        ChunkedBinaryInputStream expected_in{decompressed[i].changeset};
+        std::string expected = read_all(expected_in);
+        CHECK_EQUAL(read_all(*decompressed[i].open()), expected);
+        // The history may change while the changesets are uploaded
+        auto wt = db->start_write();
+        wt->get_table("class_table")->get_object_with_primary_key(1).set("value", "x");
+        wt->commit();
+        CHECK_EQUAL(read_all(*in_history[i].open()), expected);
+    }
+}
+
+TEST(Sync_HistoryMaintenanceSlices)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    ClientReplication repl;
+    auto db = realm::DB::create(repl, path);
+    auto& history = repl.get_history();
+    history.set_client_file_ident(sync::SaltedFileIdent{1, 123456}, true);
+    {
+        auto wt = db->start_write();
+        wt->add_table_with_primary_key("class_table", type_Int, "_id");
+        wt->commit();
+    }
+
+    // A long lived read transaction prevents the history from being trimmed
+    auto rt = db->start_read();
+    for (int i = 0; i < 500; ++i) {
+        auto wt = db->start_write();
+        wt->get_table("class_table")->create_object_with_primary_key(i);
+        wt->commit();
+    }
+    rt = nullptr;
+
+    // The commit following its end only trims a bounded part of the backlog
+    auto inline_before = history.get_maintenance_metrics().entries_trimmed_inline;
+    {
+        auto wt = db->start_write();
+        wt->get_table("class_table")->create_object_with_primary_key(500);
+        wt->commit();
+    }
+    auto metrics = history.get_maintenance_metrics();
+    CHECK_LESS_EQUAL(metrics.entries_trimmed_inline - inline_before, 2 * 64);
+    CHECK_GREATER(metrics.entries_pending, 0);
+    CHECK_EQUAL(metrics.slices, 0);
+
+    // The rest is trimmed by the maintenance slices
+    int num_slices = 0;
+    while (history.run_maintenance_slice(std::chrono::milliseconds(1000))) {
+        CHECK_LESS(++num_slices, 100);
+    }
+    metrics = history.get_maintenance_metrics();
+    CHECK_EQUAL(metrics.entries_pending, 0);
+    CHECK_GREATER(metrics.entries_trimmed_in_background, 0);
+    CHECK_GREATER_EQUAL(metrics.slices, 1);
+
+    // Nothing is left to do
+    CHECK_NOT(history.run_maintenance_slice(std::chrono::milliseconds(1000)));
+    CHECK_EQUAL(history.get_maintenance_metrics().slices, metrics.slices);
+
+    auto rt_2 = db->start_read();
+    CHECK_EQUAL(rt_2->get_table("class_table")->size(), 501);
+}
+
+TEST(Sync_StreamingBootstrap)
+{
+    // Produce the changesets of the bootstrap on another client
+    SHARED_GROUP_TEST_PATH(path_1);
+    ClientReplication repl_1;
+    auto db_1 = realm::DB::create(repl_1, path_1);
+    auto& history_1 = repl_1.get_history();
+    history_1.set_client_file_ident(sync::SaltedFileIdent{2, 123456}, true);
+    version_type last_version;
+    {
+        auto wt = db_1->start_write();
+        wt->add_table_with_primary_key("class_table", type_Int, "_id");
+        last_version = wt->commit();
+    }
+    for (int i = 1; i <= 3; ++i) {
+        auto wt = db_1->start_write();
+        wt->get_table("class_table")->create_object_with_primary_key(i);
+        last_version = wt->commit();
+    }
+    UploadCursor upload_cursor{0, 0};
+    std::vector<sync::ClientHistory::UploadChangeset> uploadable;
+    version_type locked_server_version = 0;
+    history_1.find_uploadable_changesets(upload_cursor, last_version, uploadable, locked_server_version);
+    CHECK_EQUAL(uploadable.size(), 4);
+    std::vector<RemoteChangeset> server_changesets;
+    for (auto& uc : uploadable) {
+        server_changesets.emplace_back(server_changesets.size() + 1, 0, uc.changeset, uc.origin_timestamp, 2);
+    }
+    auto batch = [&](size_t begin, size_t end) {
+        return util::Span<const RemoteChangeset>(server_changesets).sub_span(begin, end - begin);
+    };
+
+    SHARED_GROUP_TEST_PATH(path_2);
+    ClientReplication repl_2;
+    auto db_2 = realm::DB::create(repl_2, path_2);
+    auto& history_2 = repl_2.get_history();
+    history_2.set_client_file_ident(sync::SaltedFileIdent{1, 654321}, true);
+    auto count_objects = [&] {
+        auto rt = db_2->start_read();
+        auto table = rt->get_table("class_table");
+        return table ? table->size() : 0;
+    };
+
+    // The batches are not visible until the bootstrap is committed
+    auto transact = db_2->start_write();
+    history_2.integrate_streaming_bootstrap_batch(batch(0, 2), *test_context.logger, transact);
+    CHECK_EQUAL(count_objects(), 0);
+    history_2.integrate_streaming_bootstrap_batch(batch(2, 3), *test_context.logger, transact);
+    CHECK_EQUAL(count_objects(), 0);
+
+    SyncProgress progress;
+    progress.download.server_version = 3;
+    progress.latest_server_version.version = 3;
+    progress.latest_server_version.salt = 0x7876543217654321;
+    VersionInfo version_info;
+    history_2.commit_streaming_bootstrap(progress, nullptr, &server_changesets[2], version_info, transact);
+    CHECK_EQUAL(transact->get_transact_stage(), DB::transact_Reading);
+    CHECK_EQUAL(count_objects(), 2);
+    {
+        version_type current_client_version;
+        SaltedFileIdent client_file_ident;
+        SyncProgress stored_progress;
+        history_2.get_status(current_client_version, client_file_ident, stored_progress);
+        CHECK_EQUAL(current_client_version, version_info.realm_version);
+        CHECK_EQUAL(stored_progress.download.server_version, 3);
+    }
+
+    // An aborted bootstrap leaves the Realm at the last committed progress
+    transact = db_2->start_write();
+    history_2.integrate_streaming_bootstrap_batch(batch(3, 4), *test_context.logger, transact);
+    history_2.abort_streaming_bootstrap(transact);
+    CHECK_EQUAL(count_objects(), 2);
+    {
+        version_type current_client_version;
+        SaltedFileIdent client_file_ident;
+        SyncProgress stored_progress;
+        history_2.get_status(current_client_version, client_file_ident, stored_progress);
+        CHECK_EQUAL(current_client_version, version_info.realm_version);
+        CHECK_EQUAL(stored_progress.download.server_version, 3);
+    }
+}
+
 // This test calls row_for_object_id() for various object ids and tests that
 // the right value is returned including that no assertions are hit.
 TEST(Sync_RowForGlobalKey)
@@ -482,4 +482,78 @@ TEST(Sync_HistoryCompression)
     CHECK_LESS(changesets.get(0).size(), 256);
     CHECK_LESS(changesets.get(1).size(), 1024);
 }
+
+TEST(Sync_HistoryCompressionDictionary)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    sync::version_type last_version;
+    {
+        sync::ClientReplication repl;
+        repl.set_history_compression_dictionary(true);
+        DBRef db = DB::create(repl, path);
+        {
+            WriteTransaction wt(db);
+            auto table = wt.get_group().add_table_with_primary_key("class_person", type_Int, "_id");
+            table->add_column(type_String, "name");
+            table->add_column(type_String, "status");
+            last_version = wt.commit();
+        }
+
+        // Many small changesets, which are too small to compress on their own
+        for (int i = 0; i < 200; ++i) {
+            WriteTransaction wt(db);
+            auto table = wt.get_table("class_person");
+            auto obj = table->create_object_with_primary_key(i);
+            obj.set("name", util::format("Person %1", i));
+            obj.set("status", "active");
+            last_version = wt.commit();
+        }
+
+        // Inspect the history compartment directly to verify that the later
+        // changesets were compressed with a dictionary
+        ReadTransaction rt(db);
+        using gf = _impl::GroupFriend;
+        Allocator& alloc = gf::get_alloc(rt.get_group());
+        Array history_root(alloc);
+        history_root.init_from_ref(gf::get_history_ref(rt.get_group()));
+
+        BinaryColumn changesets(alloc);
+        changesets.set_parent(&history_root, 13); // s_changesets_iip
+        changesets.init_from_parent();
+        BinaryColumn changeset_dictionary(alloc);
+        changeset_dictionary.set_parent(&history_root, 21); // s_changeset_dictionary_iip
+        changeset_dictionary.init_from_parent();
+
+        CHECK_EQUAL(changesets.size(), 201);
+        if (CHECK_EQUAL(changeset_dictionary.size(), 1))
+            CHECK_GREATER(changeset_dictionary.get(0).size(), 0);
+        CHECK_LESS(changesets.get(200).size(), changesets.get(100).size() * 2 / 3);
+    }
+
+    // The dictionary is used by a replication which would not train one
+    sync::ClientReplication repl;
+    DBRef db = DB::create(repl, path);
+    auto& history = repl.get_history();
+    for (bool decompress : {true, false}) {
+        sync::UploadCursor upload_cursor{0, 0};
+        std::vector<sync::ClientHistory::UploadChangeset> uploadable;
+        sync::version_type locked_server_version = 0;
+        while (upload_cursor.client_version < last_version)
+            history.find_uploadable_changesets(upload_cursor, last_version, uploadable, locked_server_version,
+                                               decompress);
+        CHECK_EQUAL(uploadable.size(), 201);
+
+        int num_created = 0;
+        for (auto& changeset : uploadable) {
+            auto in = changeset.open();
+            sync::Changeset parsed;
+            sync::parse_changeset(*in, parsed);
+            for (auto instr : parsed) {
+                if (instr && instr->get_if<sync::Instruction::CreateObject>())
+                    ++num_created;
+            }
+        }
+        CHECK_EQUAL(num_created, 200);
+    }
+}
 } // unnamed namespace
@@ -148,4 +148,49 @@ TEST(Sync_PendingBootstrapStoreClear)
     CHECK_NOT(pending_batch.progress);
 }
 
+TEST(Sync_PendingBootstrapStoreReadAhead)
+{
+    SHARED_GROUP_TEST_PATH(db_path);
+    SyncProgress progress;
+    progress.download = {5, 5};
+    progress.latest_server_version = {5, 123456789};
+    progress.upload = {5, 5};
+    auto db = DB::create(make_client_replication(), db_path);
+    sync::PendingBootstrapStore store(db, *test_context.logger);
+
+    std::vector<RemoteChangeset> changesets;
+    std::vector<std::string> changeset_data;
+    for (char ch : {'a', 'b', 'c'}) {
+        changeset_data.emplace_back(1024, ch);
+    }
+    for (version_type i = 0; i < 3; ++i) {
+        changesets.emplace_back(i + 1, i + 6, BinaryData(changeset_data[i]), i + 1, 1);
+        changesets.back().original_changeset_size = 1024;
+    }
+    bool created_new_batch = false;
+    store.add_batch(1, progress, changesets, &created_new_batch);
+
+    // The batch following the first one is read from a snapshot taken before the first one is popped
+    auto frozen = db->start_frozen();
+    auto pending_batch = store.peek_pending(1024);
+    CHECK_EQUAL(pending_batch.changesets.size(), 1);
+    CHECK_EQUAL(pending_batch.remaining_changesets, 2);
+    auto tr = db->start_write();
+    store.pop_front_pending(tr, pending_batch.changesets.size());
+    tr->commit();
+
+    auto next_batch = store.peek_pending(frozen, 1024, pending_batch.changesets.size());
+    pending_batch = store.peek_pending(1024);
+    CHECK_EQUAL(next_batch.changesets.size(), 1);
+    CHECK_EQUAL(next_batch.remaining_changesets, 1);
+    CHECK_EQUAL(next_batch.query_version, 1);
+    CHECK(next_batch.progress);
+    CHECK_EQUAL(next_batch.changesets[0].remote_version, 2);
+    CHECK_EQUAL(next_batch.changesets[0].remote_version, pending_batch.changesets[0].remote_version);
+    CHECK_EQUAL(next_batch.remaining_changesets, pending_batch.remaining_changesets);
+
+    // Parsing happens outside of the write transaction, and reports malformed changesets as integration errors
+    CHECK_THROW(ClientHistory::parse_server_changesets(next_batch.changesets), IntegrationException);
+}
+
 } // namespace realm::sync
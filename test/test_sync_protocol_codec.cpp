@@ -194,6 +194,36 @@ TEST(Protocol_Codec_Upload)
     }
 }
 
+TEST(Protocol_Codec_Upload_Compression_Dictionary)
+{
+    CHECK_EQUAL(_impl::get_message_compression_dictionary(12).size(), 0);
+    auto dictionary = _impl::get_message_compression_dictionary(13);
+    CHECK_GREATER(dictionary.size(), 0);
+
+    std::string data;
+    for (int i = 0; i < 100; ++i)
+        data += util::format("class_Task _id %1 owner_id name status ", i);
+
+    auto protocol = _impl::ClientProtocol();
+    auto out = _impl::ClientProtocol::OutputBuffer();
+    auto upload_message_builder = protocol.make_upload_message_builder(); // Throws
+    upload_message_builder.add_changeset(4, 2, 259609999999, 123999, BinaryData(data.c_str(), data.size()));
+    upload_message_builder.make_upload_message(13, out, 888123, 4, 2, 0);
+    const auto& info = upload_message_builder.get_compression_info();
+    CHECK(info.used_dictionary);
+    CHECK_GREATER(info.compressed_body_size, 0);
+    CHECK_LESS(info.compressed_body_size, info.uncompressed_body_size);
+
+    auto out_span = out.as_span();
+    auto body = out_span.last(info.compressed_body_size);
+    Buffer<char> decompressed_buf(info.uncompressed_body_size);
+    CHECK_EQUAL(util::compression::decompress(body, decompressed_buf),
+                util::compression::error::decompress_unsupported);
+    CHECK_NOT(util::compression::decompress(body, decompressed_buf, dictionary));
+    std::string expected_body = util::format("4 2 259609999999 123999 %1 ", data.size()) + data;
+    compare_out_string(expected_body, decompressed_buf, test_context);
+}
+
 TEST(Protocol_Codec_Unbind)
 {
     auto protocol = _impl::ClientProtocol();
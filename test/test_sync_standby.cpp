@@ -0,0 +1,197 @@
+#include "realm/db.hpp"
+#include "realm/dictionary.hpp"
+#include "realm/history.hpp"
+#include "realm/list.hpp"
+#include "realm/sync/standby.hpp"
+
+#include "test.hpp"
+#include "util/compare_groups.hpp"
+#include "util/test_path.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace realm;
+using namespace realm::sync;
+
+namespace {
+
+using version_type = StandbyApplier::version_type;
+using Changesets = std::vector<std::pair<version_type, std::string>>;
+
+std::unique_ptr<Replication> make_standby_replication(Changesets& changesets)
+{
+    return std::make_unique<StandbyReplication>([&](version_type version, BinaryData changeset) {
+        changesets.emplace_back(version, std::string(changeset.data(), changeset.size()));
+    });
+}
+
+bool compare_classes(DBRef db_1, DBRef db_2)
+{
+    auto rt_1 = db_1->start_read();
+    auto rt_2 = db_2->start_read();
+    util::StderrLogger logger(util::Logger::Level::off);
+    return test_util::compare_groups(
+        *rt_1, *rt_2,
+        [](StringData name) {
+            return name.begins_with("class_");
+        },
+        logger);
+}
+
+} // unnamed namespace
+
+TEST(Sync_StandbyReplication)
+{
+    SHARED_GROUP_TEST_PATH(primary_path);
+    SHARED_GROUP_TEST_PATH(standby_path);
+    Changesets changesets;
+    auto primary = DB::create(make_standby_replication(changesets), primary_path);
+    auto standby = DB::create(make_in_realm_history(), standby_path);
+    StandbyApplier applier(standby);
+    CHECK_EQUAL(applier.get_applied_version(), 0);
+
+    {
+        auto wt = primary->start_write();
+        auto people = wt->add_table_with_primary_key("class_Person", type_String, "_id");
+        auto dogs = wt->add_table_with_primary_key("class_Dog", type_Int, "_id");
+        people->add_column(type_Int, "age");
+        people->add_column_list(type_String, "nicknames");
+        people->add_column_dictionary(type_Double, "scores");
+        people->add_column(*dogs, "dog");
+        dogs->add_column(type_String, "name", true);
+        wt->commit();
+    }
+    {
+        auto wt = primary->start_write();
+        auto people = wt->get_table("class_Person");
+        auto dogs = wt->get_table("class_Dog");
+        for (int i = 0; i < 100; ++i) {
+            auto dog = dogs->create_object_with_primary_key(i).set("name", util::format("Dog %1", i));
+            auto person = people->create_object_with_primary_key(util::format("Person %1", i));
+            person.set("age", i).set("dog", dog.get_key());
+            person.get_list<String>("nicknames").add(util::format("P%1", i));
+            person.get_dictionary("scores").insert("math", i * 0.5);
+        }
+        wt->commit();
+    }
+    {
+        auto wt = primary->start_write();
+        auto people = wt->get_table("class_Person");
+        auto dogs = wt->get_table("class_Dog");
+        for (int i = 0; i < 100; i += 3) {
+            auto person = people->get_object_with_primary_key(util::format("Person %1", i));
+            person.add_int("age", 100);
+            person.get_list<String>("nicknames").insert(0, "First");
+            person.get_dictionary("scores").erase("math");
+        }
+        for (int i = 0; i < 100; i += 7)
+            dogs->get_object_with_primary_key(i).remove();
+        wt->commit();
+    }
+    // A commit which changes nothing still produces a version to apply
+    primary->start_write()->commit();
+
+    CHECK_EQUAL(changesets.size(), 4);
+    version_type version = changesets.front().first;
+    for (auto& [v, changeset] : changesets)
+        CHECK_EQUAL(v, version++);
+    CHECK_EQUAL(changesets.back().first, primary->get_version_of_latest_snapshot());
+
+    auto standby_version = standby->get_version_of_latest_snapshot();
+    for (auto& [v, changeset] : changesets)
+        CHECK(applier.apply(v, BinaryData(changeset)));
+    CHECK_EQUAL(applier.get_applied_version(), changesets.back().first);
+    // Each changeset is applied in its own transaction
+    CHECK_EQUAL(standby->get_version_of_latest_snapshot(), standby_version + changesets.size());
+    CHECK(compare_classes(primary, standby));
+    {
+        auto rt = standby->start_read();
+        CHECK_EQUAL(rt->get_table("class_Person")->size(), 100);
+        CHECK_EQUAL(rt->get_table("class_Dog")->size(), 85);
+    }
+
+    // Changesets delivered again are ignored, and missing ones are detected
+    CHECK_NOT(applier.apply(changesets.back().first, BinaryData(changesets.back().second)));
+    CHECK_THROW(applier.apply(changesets.back().first + 2, BinaryData(changesets.back().second)), IllegalOperation);
+    CHECK_EQUAL(applier.get_applied_version(), changesets.back().first);
+}
+
+TEST(Sync_StandbyReplication_Resume)
+{
+    SHARED_GROUP_TEST_PATH(primary_path);
+    SHARED_GROUP_TEST_PATH(standby_path);
+    Changesets changesets;
+    auto primary = DB::create(make_standby_replication(changesets), primary_path);
+    auto commit = [&](int64_t i) {
+        auto wt = primary->start_write();
+        auto table = wt->get_table("class_Item");
+        if (!table) {
+            table = wt->add_table_with_primary_key("class_Item", type_Int, "_id");
+            table->add_column(type_Int, "value");
+        }
+        table->create_object_with_primary_key(i).set("value", i * i);
+        wt->commit();
+    };
+    for (int64_t i = 0; i < 10; ++i)
+        commit(i);
+
+    {
+        auto standby = DB::create(make_in_realm_history(), standby_path);
+        StandbyApplier applier(standby);
+        for (size_t i = 0; i < 5; ++i)
+            applier.apply(changesets[i].first, BinaryData(changesets[i].second));
+    }
+
+    // The applied version is stored in the standby Realm, so a new applier
+    // carries on from there
+    auto standby = DB::create(make_in_realm_history(), standby_path);
+    StandbyApplier applier(standby);
+    CHECK_EQUAL(applier.get_applied_version(), changesets[4].first);
+    for (auto& [v, changeset] : changesets)
+        applier.apply(v, BinaryData(changeset));
+    CHECK_EQUAL(applier.get_applied_version(), changesets.back().first);
+    CHECK(compare_classes(primary, standby));
+}
+
+TEST(Sync_StandbyReplication_SeedFromCopy)
+{
+    SHARED_GROUP_TEST_PATH(primary_path);
+    SHARED_GROUP_TEST_PATH(standby_path);
+    Changesets changesets;
+    auto primary = DB::create(make_standby_replication(changesets), primary_path);
+    {
+        auto wt = primary->start_write();
+        auto table = wt->add_table_with_primary_key("class_Item", type_Int, "_id");
+        table->add_column(type_String, "value");
+        for (int64_t i = 0; i < 50; ++i)
+            table->create_object_with_primary_key(i).set("value", "initial");
+        wt->commit();
+    }
+
+    // Start the standby from a copy of the primary rather than from the
+    // beginning of the stream
+    version_type copied_version;
+    {
+        auto rt = primary->start_read();
+        copied_version = rt->get_version();
+        rt->write(standby_path);
+    }
+    changesets.clear();
+    {
+        auto wt = primary->start_write();
+        auto table = wt->get_table("class_Item");
+        table->get_object_with_primary_key(7).set("value", "changed");
+        table->create_object_with_primary_key(50).set("value", "new");
+        wt->commit();
+    }
+
+    auto standby = DB::create(make_in_realm_history(), standby_path);
+    StandbyApplier applier(standby);
+    applier.set_applied_version(copied_version);
+    CHECK_THROW(applier.apply(copied_version + 2, BinaryData()), IllegalOperation);
+    CHECK_EQUAL(changesets.size(), 1);
+    CHECK(applier.apply(changesets[0].first, BinaryData(changesets[0].second)));
+    CHECK(compare_classes(primary, standby));
+}
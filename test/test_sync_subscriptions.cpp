@@ -432,7 +432,8 @@ TEST_IF(Sync_SubscriptionStoreInternalSchemaMigration, REALM_MAX_BPNODE_SIZE ==
     SyncMetadataSchemaVersions versions(tr);
     auto flx_sub_store_version = versions.get_version_for(tr, sync::internal_schema_groups::c_flx_subscription_store);
     CHECK(flx_sub_store_version);
-    CHECK_EQUAL(*flx_sub_store_version, 2);
+    CHECK_EQUAL(*flx_sub_store_version, 3);
+    CHECK_EQUAL(sub.priority, 0);
 
     CHECK(!versions.get_version_for(tr, "non_existent_table"));
 }
@@ -470,6 +471,71 @@ TEST(Sync_SubscriptionStoreNextPendingVersion)
     CHECK(!pending_version);
 }
 
+TEST(Sync_SubscriptionStorePriorityBands)
+{
+    SHARED_GROUP_TEST_PATH(sub_store_path)
+    SubscriptionStoreFixture fixture(sub_store_path);
+    auto store = SubscriptionStore::create(fixture.db);
+
+    auto read_tr = fixture.db->start_read();
+    Query query_a(read_tr->get_table(fixture.a_table_key));
+    query_a.equal(fixture.foo_col, StringData("JBR"));
+    Query query_b(read_tr->get_table(fixture.a_table_key));
+    query_b.greater(fixture.bar_col, int64_t(1));
+    Query query_c(read_tr->get_table(fixture.a_table_key));
+    query_c.less(fixture.bar_col, int64_t(-1));
+
+    // Subscriptions of a single priority are committed as a single version.
+    auto mut_sub_set = store->get_latest().make_mutable_copy();
+    mut_sub_set.insert_or_assign("a", query_a);
+    auto sub_set = mut_sub_set.commit();
+    CHECK_EQUAL(sub_set.version(), 1);
+    CHECK_EQUAL(sub_set.priority_band(), 0);
+
+    // A commit with several priorities creates one version per band, highest priority first.
+    mut_sub_set = sub_set.make_mutable_copy();
+    mut_sub_set.insert_or_assign("b", query_b, -5);
+    mut_sub_set.insert_or_assign("c", query_c, 10);
+    sub_set = mut_sub_set.commit();
+    CHECK_EQUAL(sub_set.version(), 3);
+    CHECK_EQUAL(sub_set.size(), 3);
+    CHECK_EQUAL(sub_set.priority_band(), -5);
+    CHECK_EQUAL(sub_set.find("b")->priority, -5);
+
+    auto high_band = store->get_by_version(2);
+    CHECK_EQUAL(high_band.state(), SubscriptionSet::State::Pending);
+    CHECK_EQUAL(high_band.priority_band(), 10);
+    CHECK_EQUAL(high_band.size(), 2);
+    CHECK(high_band.find("a"));
+    CHECK(high_band.find("c"));
+    CHECK_NOT(high_band.find("b"));
+
+    auto pending_version = store->get_next_pending_version(1);
+    CHECK(pending_version);
+    CHECK_EQUAL(pending_version->query_version, 2);
+
+    // Waiting on the high priority band resolves once its own version is complete.
+    auto high_future = sub_set.get_priority_band_notification(10, SubscriptionSet::State::Complete);
+    auto all_future = sub_set.get_priority_band_notification(0, SubscriptionSet::State::Complete);
+    store->update_state(1, SubscriptionSet::State::Complete);
+    store->update_state(2, SubscriptionSet::State::Complete);
+    CHECK_EQUAL(high_future.get(), SubscriptionSet::State::Complete);
+    CHECK_NOT(all_future.is_ready());
+    store->update_state(3, SubscriptionSet::State::Complete);
+    CHECK_EQUAL(all_future.get(), SubscriptionSet::State::Complete);
+
+    // Once the lower band is complete, the trimmed higher band is covered by it.
+    CHECK_EQUAL(sub_set.get_priority_band_notification(10, SubscriptionSet::State::Complete).get(),
+                SubscriptionSet::State::Complete);
+
+    // Changing only the priority of an existing subscription does not require bootstrapping it again.
+    mut_sub_set = store->get_latest().make_mutable_copy();
+    mut_sub_set.insert_or_assign("a", query_a, 20);
+    sub_set = mut_sub_set.commit();
+    CHECK_EQUAL(sub_set.version(), 4);
+    CHECK_EQUAL(sub_set.find("a")->priority, 20);
+}
+
 TEST(Sync_SubscriptionStoreSubSetHasTable)
 {
     SHARED_GROUP_TEST_PATH(sub_store_path)
@@ -938,4 +1004,60 @@ TEST(Sync_MutableSubscriptionSetOperations)
     }
 }
 
+TEST(Sync_MutableSubscriptionSetManySubscriptions)
+{
+    SHARED_GROUP_TEST_PATH(sub_store_path);
+    SubscriptionStoreFixture fixture(sub_store_path);
+    auto store = SubscriptionStore::create(fixture.db);
+
+    auto read_tr = fixture.db->start_read();
+    auto table = read_tr->get_table(fixture.a_table_key);
+    auto query = [&](int64_t i) {
+        return Query(table).equal(fixture.bar_col, i);
+    };
+
+    auto out = store->get_latest().make_mutable_copy();
+    for (int64_t i = 0; i < 200; ++i) {
+        CHECK(out.insert_or_assign(query(i)).second);
+        CHECK(out.insert_or_assign(util::format("sub %1", i), query(i)).second);
+    }
+    CHECK_EQUAL(out.size(), 400);
+
+    // Erasing moves the last subscription into the erased position, which must still be found afterwards
+    for (int64_t i = 0; i < 200; i += 2) {
+        CHECK(out.erase(util::format("sub %1", i)));
+        CHECK(out.erase_by_id(out.find(query(i))->id));
+    }
+    CHECK_EQUAL(out.size(), 200);
+    for (int64_t i = 0; i < 200; ++i) {
+        auto [it, inserted] = out.insert_or_assign(query(i), 5);
+        CHECK_EQUAL(inserted, i % 2 == 0);
+        CHECK_EQUAL(it->priority, 5);
+        std::tie(it, inserted) = out.insert_or_assign(util::format("sub %1", i), query(i + 1));
+        CHECK_EQUAL(inserted, i % 2 == 0);
+        CHECK_EQUAL(it->query_string, query(i + 1).get_description());
+    }
+    CHECK_EQUAL(out.size(), 400);
+
+    auto set = out.commit();
+    CHECK_EQUAL(set.size(), 400);
+    // The 201 distinct queries are each sent once
+    auto json = set.to_ext_json();
+    size_t ors = 0;
+    for (size_t pos = json.find(" OR "); pos != std::string::npos; pos = json.find(" OR ", pos + 1))
+        ++ors;
+    CHECK_EQUAL(ors, 200);
+
+    // Only the subscriptions which changed since the last commit are pending, so changing the priority of an
+    // existing one doesn't need a version of its own
+    auto version = set.version();
+    auto out2 = set.make_mutable_copy();
+    out2.insert_or_assign(query(1000), 1);
+    out2.insert_or_assign(query(3), 10);
+    set = out2.commit();
+    CHECK_EQUAL(set.size(), 401);
+    CHECK_EQUAL(set.version(), version + 1);
+    CHECK_EQUAL(set.priority_band(), 1);
+}
+
 } // namespace realm::sync
@@ -909,6 +909,60 @@ TEST(Table_ColumnNameTooLong)
     table->add_column(*table, StringData(buf, buf_size - 1));
 }
 
+TEST(Table_ManyColumnNames)
+{
+    // Enough columns for the column names to be looked up through a hash index
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    auto name = [](int i) {
+        return "col_" + util::to_string(i);
+    };
+    std::vector<ColKey> cols;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        for (int i = 0; i < 30; ++i)
+            cols.push_back(table->add_column(type_Int, name(i)));
+        // Adds a backlink column, which has no name
+        table->add_column(*table, "link");
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("table");
+    for (int i = 0; i < 30; ++i)
+        CHECK_EQUAL(table->get_column_key(name(i)), cols[i]);
+    CHECK_NOT(table->get_column_key("col_30"));
+    CHECK_NOT(table->get_column_key(""));
+
+    {
+        auto wt = db->start_write();
+        auto t = wt->get_table("table");
+        t->rename_column(cols[3], "renamed");
+        t->remove_column(cols[5]);
+        auto added = t->add_column(type_String, "added");
+        auto nullable = t->set_nullability(cols[7], true, false);
+        CHECK_EQUAL(t->get_column_key("renamed"), cols[3]);
+        CHECK_NOT(t->get_column_key(name(3)));
+        CHECK_NOT(t->get_column_key(name(5)));
+        CHECK_EQUAL(t->get_column_key("added"), added);
+        CHECK_EQUAL(t->get_column_key(name(7)), nullable);
+        CHECK_THROW_ANY(t->add_column(type_Int, name(9)));
+        wt->commit();
+    }
+
+    CHECK_EQUAL(table->get_column_key(name(3)), cols[3]);
+    rt->advance_read();
+    CHECK_EQUAL(table->get_column_key("renamed"), cols[3]);
+    CHECK(table->get_column_key("added"));
+    CHECK_NOT(table->get_column_key(name(3)));
+    CHECK_NOT(table->get_column_key(name(5)));
+    CHECK(table->get_column_key(name(7)).is_nullable());
+    for (int i = 8; i < 30; ++i)
+        CHECK_EQUAL(table->get_column_key(name(i)), cols[i]);
+    CHECK(table->get_column_key("link"));
+}
+
 TEST(Table_StringOrBinaryTooBig)
 {
     Table table;
@@ -1985,6 +2039,66 @@ TEST(Table_Aggregates2)
     CHECK_EQUAL(s, table.sum(int_col)->get_int());
 }
 
+// Whole-table aggregates reduce each leaf in bulk. Make sure that nulls and NaNs are skipped and that min/max
+// report the first occurrence when spread over many clusters.
+TEST(Table_AggregatesBulkLeaves)
+{
+    Table table;
+    auto int_col = table.add_column(type_Int, "int");
+    auto int_null_col = table.add_column(type_Int, "int_null", true);
+    auto double_col = table.add_column(type_Double, "double", true);
+
+    int64_t int_sum = 0;
+    int64_t int_null_sum = 0;
+    size_t int_null_count = 0;
+    double double_sum = 0;
+    size_t double_count = 0;
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 5000; ++i) {
+        auto obj = table.create_object();
+        keys.push_back(obj.get_key());
+        int64_t v = (i * 7919) % 10007 - 5000;
+        obj.set(int_col, v);
+        int_sum += v;
+        if (i % 5 != 0) {
+            obj.set(int_null_col, v * 3);
+            int_null_sum += v * 3;
+            ++int_null_count;
+        }
+        if (i % 3 == 0) {
+            obj.set(double_col, std::numeric_limits<double>::quiet_NaN());
+        }
+        else if (i % 3 == 1) {
+            obj.set(double_col, v * 0.5);
+            double_sum += v * 0.5;
+            ++double_count;
+        }
+    }
+    table.get_object(keys[4000]).set(int_col, 100000);
+    table.get_object(keys[4500]).set(int_col, 100000);
+    int_sum += 100000 - (4000 * 7919) % 10007 + 5000;
+    int_sum += 100000 - (4500 * 7919) % 10007 + 5000;
+
+    CHECK_EQUAL(table.sum(int_col)->get_int(), int_sum);
+    ObjKey ret;
+    CHECK_EQUAL(table.max(int_col, &ret)->get_int(), 100000);
+    CHECK_EQUAL(ret, keys[4000]);
+
+    size_t count = 0;
+    CHECK_EQUAL(table.sum(int_null_col)->get_int(), int_null_sum);
+    CHECK_APPROXIMATELY_EQUAL(table.avg(int_null_col, &count)->get_double(), double(int_null_sum) / int_null_count,
+                              1e-9);
+    CHECK_EQUAL(count, int_null_count);
+    auto min_val = table.min(int_null_col, &ret)->get_int();
+    CHECK_EQUAL(*table.get_object(ret).get<util::Optional<int64_t>>(int_null_col), min_val);
+
+    CHECK_APPROXIMATELY_EQUAL(table.sum(double_col)->get_double(), double_sum, 1e-9);
+    table.avg(double_col, &count);
+    CHECK_EQUAL(count, double_count);
+    auto max_val = table.max(double_col, &ret)->get_double();
+    CHECK_EQUAL(*table.get_object(ret).get<util::Optional<double>>(double_col), max_val);
+}
+
 // Test Table methods max, min, avg, sum, on both nullable and non-nullable columns
 TEST(Table_Aggregates3)
 {
@@ -2225,6 +2339,250 @@ TEST(Table_ClearWithTwoLevelBptree)
     table.verify();
 }
 
+TEST(Table_BulkCreateObjects)
+{
+    Group g;
+    auto target = g.add_table("target");
+    std::vector<ObjKey> target_keys;
+    target->create_objects(3, target_keys);
+    auto table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_int_null = table->add_column(type_Int, "int_null", true);
+    auto col_str = table->add_column(type_String, "str", true);
+    auto col_double = table->add_column(type_Double, "double");
+    auto col_date = table->add_column(type_Timestamp, "date", true);
+    auto col_mixed = table->add_column(type_Mixed, "mixed");
+    auto col_link = table->add_column(*target, "link");
+    auto col_default = table->add_column(type_Int, "default");
+    auto col_list = table->add_column_list(type_Int, "list");
+    table->add_search_index(col_str);
+    table->add_search_index(col_int);
+
+    auto make_columns = [&](size_t begin, size_t end) {
+        std::vector<BulkColumn> columns{{col_int, {}},    {col_int_null, {}}, {col_str, {}},
+                                        {col_double, {}}, {col_date, {}},     {col_mixed, {}},
+                                        {col_link, {}}};
+        for (size_t i = begin; i < end; ++i) {
+            columns[0].values.push_back(int64_t(i));
+            columns[1].values.push_back(i % 3 ? Mixed(int64_t(i)) : Mixed());
+            columns[2].values.push_back(i % 5 ? Mixed(StringData(i % 2 ? "odd" : "even")) : Mixed());
+            columns[3].values.push_back(double(i) / 2);
+            columns[4].values.push_back(Timestamp(int64_t(i), 0));
+            columns[5].values.push_back(i % 2 ? Mixed(int64_t(i)) : Mixed("mixed"));
+            columns[6].values.push_back(i % 4 ? Mixed(ObjKey(i % 3)) : Mixed());
+        }
+        return columns;
+    };
+    auto check_object = [&](Obj obj, size_t i) {
+        CHECK_EQUAL(obj.get<Int>(col_int), int64_t(i));
+        if (i % 3)
+            CHECK_EQUAL(obj.get<util::Optional<Int>>(col_int_null), int64_t(i));
+        else
+            CHECK(obj.is_null(col_int_null));
+        if (i % 5)
+            CHECK_EQUAL(obj.get<String>(col_str), i % 2 ? "odd" : "even");
+        else
+            CHECK(obj.is_null(col_str));
+        CHECK_EQUAL(obj.get<Double>(col_double), double(i) / 2);
+        CHECK_EQUAL(obj.get<Timestamp>(col_date), Timestamp(int64_t(i), 0));
+        CHECK_EQUAL(obj.get_any(col_mixed), i % 2 ? Mixed(int64_t(i)) : Mixed("mixed"));
+        CHECK_EQUAL(obj.get<ObjKey>(col_link), i % 4 ? ObjKey(i % 3) : ObjKey());
+        CHECK_EQUAL(obj.get<Int>(col_default), 0);
+        CHECK_EQUAL(obj.get_list<Int>(col_list).size(), 0);
+    };
+
+    // Into an empty table, filling several clusters
+    const size_t n1 = 3 * REALM_MAX_BPNODE_SIZE + 17;
+    std::vector<ObjKey> keys;
+    for (size_t i = 0; i < n1; ++i)
+        keys.push_back(ObjKey(i));
+    table->bulk_create_objects(keys, make_columns(0, n1));
+    CHECK_EQUAL(table->size(), n1);
+    table->verify();
+
+    // Topping up the last cluster, followed by sparse keys
+    const size_t n2 = 2 * REALM_MAX_BPNODE_SIZE + 5;
+    keys.clear();
+    for (size_t i = n1; i < n1 + n2; ++i)
+        keys.push_back(ObjKey(i < n1 + 20 ? i : 2 * i));
+    table->bulk_create_objects(keys, make_columns(n1, n1 + n2));
+    CHECK_EQUAL(table->size(), n1 + n2);
+    table->verify();
+
+    for (size_t i = 0; i < n1 + n2; ++i) {
+        ObjKey key(i < n1 + 20 ? i : 2 * i);
+        CHECK(table->is_valid(key));
+        check_object(table->get_object(key), i);
+    }
+
+    // The search indexes must hold the new objects
+    size_t num_odd = 0;
+    for (size_t i = 0; i < n1 + n2; ++i) {
+        if (i % 5 && i % 2)
+            num_odd++;
+    }
+    CHECK_EQUAL(table->where().equal(col_str, "odd").count(), num_odd);
+    CHECK_EQUAL(table->find_first_int(col_int, int64_t(n1 + 30)), ObjKey(2 * (n1 + 30)));
+    CHECK_EQUAL(table->find_first_int(col_int, 7), ObjKey(7));
+
+    // And so must the backlinks
+    size_t num_links = 0;
+    for (size_t i = 0; i < n1 + n2; ++i) {
+        if (i % 4 && i % 3 == 1)
+            num_links++;
+    }
+    CHECK_EQUAL(target->get_object(target_keys[1]).get_backlink_count(*table, col_link), num_links);
+
+    // The objects behave as other objects
+    table->get_object(ObjKey(7)).remove();
+    table->create_object().set(col_int, 5);
+    CHECK_EQUAL(table->size(), n1 + n2);
+    table->verify();
+
+    // Generated keys
+    auto new_keys = table->bulk_create_objects(10, {{col_int, std::vector<Mixed>(10, Mixed(int64_t(-42)))}});
+    CHECK_EQUAL(new_keys.size(), 10);
+    CHECK_EQUAL(table->where().equal(col_int, -42).count(), 10);
+    for (auto key : new_keys)
+        CHECK_EQUAL(table->get_object(key).get<Int>(col_int), -42);
+    table->verify();
+}
+
+TEST(Table_BulkCreateObjectsErrors)
+{
+    Table table;
+    auto col_int = table.add_column(type_Int, "int");
+    auto col_str = table.add_column(type_String, "str", true);
+    auto col_list = table.add_column_list(type_Int, "list");
+    table.create_object(ObjKey(10));
+
+    std::vector<BulkColumn> columns{{col_int, {1, 2}}};
+    // Keys must be ascending and follow the existing keys
+    CHECK_THROW(table.bulk_create_objects({ObjKey(5), ObjKey(20)}, columns), InvalidArgument);
+    CHECK_THROW(table.bulk_create_objects({ObjKey(21), ObjKey(20)}, columns), InvalidArgument);
+    // One value per object
+    CHECK_THROW(table.bulk_create_objects(std::vector<ObjKey>{ObjKey(20)}, columns), InvalidArgument);
+    // Each column only once
+    CHECK_THROW(table.bulk_create_objects({ObjKey(20), ObjKey(21)}, {{col_int, {1, 2}}, {col_int, {1, 2}}}),
+                InvalidArgument);
+    // Values of the type of the column
+    CHECK_THROW(table.bulk_create_objects({ObjKey(20), ObjKey(21)}, {{col_str, {1, 2}}}), InvalidArgument);
+    CHECK_THROW(table.bulk_create_objects({ObjKey(20), ObjKey(21)}, {{col_int, {1, Mixed()}}}), NotNullable);
+    CHECK_THROW(table.bulk_create_objects({ObjKey(20), ObjKey(21)}, {{col_list, {1, 2}}}), IllegalOperation);
+    CHECK_EQUAL(table.size(), 1);
+
+    table.bulk_create_objects({ObjKey(20), ObjKey(21)}, {{col_int, {1, 2}}, {col_str, {Mixed(), "a"}}});
+    CHECK_EQUAL(table.size(), 3);
+    CHECK(table.get_object(ObjKey(20)).is_null(col_str));
+    CHECK_EQUAL(table.get_object(ObjKey(21)).get<String>(col_str), "a");
+    table.verify();
+}
+
+TEST(Table_ClusterNodeSize)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+
+    auto max_leaf_size = [](const Table& table) {
+        size_t max_size = 0;
+        table.traverse_clusters([&](const Cluster* cluster) {
+            max_size = std::max(max_size, cluster->node_size());
+            return IteratorControl::AdvanceToNext;
+        });
+        return max_size;
+    };
+
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        auto col = table->add_column(type_Int, "int");
+        CHECK_EQUAL(table->get_cluster_node_size(), ClusterTree::get_default_node_size(1));
+        CHECK_THROW(table->set_cluster_node_size(24), InvalidArgument);
+        CHECK_THROW(table->set_cluster_node_size(Table::min_cluster_node_size / 2), InvalidArgument);
+        CHECK_THROW(table->set_cluster_node_size(Table::max_cluster_node_size * 2), InvalidArgument);
+        table->set_cluster_node_size(16);
+        CHECK_EQUAL(table->get_cluster_node_size(), 16);
+
+        // Both objects created one at a time, in order and at random keys,
+        // and objects created in bulk go into clusters of the size set
+        for (int64_t i = 0; i < 500; ++i)
+            table->create_object().set(col, i);
+        Random random(random_int<unsigned long>()); // Seed from slow global generator
+        for (int64_t i = 0; i < 500; ++i) {
+            ObjKey key(1000 + random.draw_int<int64_t>(0, 1'000'000));
+            if (!table->is_valid(key))
+                table->create_object(key).set(col, i);
+        }
+        std::vector<ObjKey> keys;
+        for (int64_t i = 0; i < 100; ++i)
+            keys.push_back(ObjKey(2'000'000 + i));
+        table->bulk_create_objects(keys, {{col, std::vector<Mixed>(keys.size(), Mixed(int64_t(7)))}});
+        CHECK_EQUAL(max_leaf_size(*table), 16);
+        table->verify();
+
+        // Clusters which were filled before keep their size until they are split
+        table->set_cluster_node_size(0);
+        for (int64_t i = 0; i < 100; ++i)
+            table->create_object().set(col, i);
+        table->set_cluster_node_size(32);
+        table->verify();
+        wt->commit();
+    }
+
+    // The size is stored in the file
+    {
+        auto rt = db->start_read();
+        auto table = rt->get_table("table");
+        CHECK_EQUAL(table->get_cluster_node_size(), 32);
+    }
+    db->close();
+    db = DB::create(make_in_realm_history(), path);
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        CHECK_EQUAL(table->get_cluster_node_size(), 32);
+        CHECK_EQUAL(table->get_table_type(), Table::Type::TopLevel);
+
+        // Clusters are merged as objects are erased
+        size_t size = table->size();
+        while (table->size() > size / 10)
+            table->begin()->remove();
+        table->verify();
+        wt->commit();
+    }
+
+    // Wide tables get smaller clusters by default
+    CHECK_LESS_EQUAL(ClusterTree::get_default_node_size(100), ClusterTree::get_default_node_size(10));
+}
+
+TEST(Table_ClusterNodeSizeCommitBytes)
+{
+    // A commit updating a single value writes the arrays on the path from the
+    // leaf to the top, so it writes less when the nodes of the table are small
+    auto bytes_per_update = [&](size_t node_size) {
+        SHARED_GROUP_TEST_PATH(path);
+        DBRef db = DB::create(make_in_realm_history(), path);
+        ColKey col;
+        {
+            auto wt = db->start_write();
+            auto table = wt->add_table("table");
+            table->set_cluster_node_size(node_size);
+            col = table->add_column(type_Int, "int");
+            for (int64_t i = 0; i < 20000; ++i)
+                table->create_object().set(col, i * 1000);
+            wt->commit();
+        }
+        uint64_t bytes_written = db->get_metrics().commits.bytes_written;
+        for (size_t i = 0; i < 20; ++i) {
+            auto wt = db->start_write();
+            wt->get_table("table")->get_object(i * 997).set(col, int64_t(i));
+            wt->commit();
+        }
+        return (db->get_metrics().commits.bytes_written - bytes_written) / 20;
+    };
+    CHECK_LESS(bytes_per_update(Table::min_cluster_node_size), bytes_per_update(Table::max_cluster_node_size / 4));
+}
+
 TEST(Table_IndexStringDelete)
 {
     Table t;
@@ -2840,6 +3198,207 @@ TEST(Table_remove_column)
     CHECK_EQUAL(obj.get<int64_t>("int4"), 0);
 }
 
+TEST(Table_object_get_many)
+{
+    Group g;
+    auto target = g.add_table("target");
+    auto table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_int_null = table->add_column(type_Int, "int null", true);
+    auto col_str = table->add_column(type_String, "string", true);
+    auto col_ts = table->add_column(type_Timestamp, "timestamp");
+    auto col_link = table->add_column(*target, "link");
+    auto col_mixed = table->add_column(type_Mixed, "mixed", true);
+
+    auto target_obj = target->create_object();
+    Obj obj = table->create_object();
+    obj.set(col_int, 5).set(col_str, "hello").set(col_ts, Timestamp(10, 0)).set(col_link, target_obj.get_key());
+    obj.set(col_mixed, Mixed(2.5));
+
+    std::vector<ColKey> cols{col_str, col_int, col_int_null, col_ts, col_link, col_mixed, col_int};
+    auto values = obj.get_many(cols);
+    CHECK_EQUAL(values.size(), cols.size());
+    for (size_t i = 0; i < cols.size(); i++) {
+        CHECK_EQUAL(values[i], obj.get_any(cols[i]));
+    }
+    CHECK_EQUAL(values[0], Mixed("hello"));
+    CHECK(values[2].is_null());
+    CHECK(obj.get_many({}).empty());
+
+    // The accessor is brought up to date before the values are read
+    Obj other = table->get_object(obj.get_key());
+    table->create_object().set(col_int, 1);
+    obj.set(col_int, 6);
+    CHECK_EQUAL(other.get_many({col_int})[0], Mixed(6));
+
+    table->remove_column(col_ts);
+    CHECK_THROW(obj.get_many({col_int, col_ts}), InvalidColumnKey);
+    obj.remove();
+    CHECK_THROW(other.get_many({col_int}), KeyNotFound);
+}
+
+TEST(Table_get_values)
+{
+    Group g;
+    auto target = g.add_table("target");
+    auto table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "string", true);
+    auto col_double = table->add_column(type_Double, "double", true);
+    auto col_link = table->add_column(*target, "link");
+    auto col_list = table->add_column_list(type_Int, "list");
+
+    auto target_obj = target->create_object();
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 3000; i++) {
+        Obj obj = table->create_object();
+        obj.set(col_int, i).set(col_str, util::to_string(i % 7));
+        if (i % 3)
+            obj.set(col_double, i * 0.5);
+        if (i % 5 == 0)
+            obj.set(col_link, target_obj.get_key());
+        if (i % 11 == 0)
+            obj.get_list<Int>(col_list).add(i);
+        keys.push_back(obj.get_key());
+    }
+    std::reverse(keys.begin() + 1000, keys.end());
+    keys.push_back(ObjKey());
+    keys.push_back(keys[17]);
+
+    std::vector<ColKey> cols{col_str, col_int, col_double, col_link, col_list};
+    auto values = table->get_values(keys, cols);
+    CHECK_EQUAL(values.size(), keys.size() * cols.size());
+    for (size_t c = 0; c < cols.size(); c++) {
+        for (size_t i = 0; i < keys.size(); i++) {
+            Mixed expected = keys[i] ? table->get_object(keys[i]).get_any(cols[c]) : Mixed();
+            CHECK_EQUAL(values[c * keys.size() + i], expected);
+        }
+    }
+    CHECK(table->get_values({}, cols).empty());
+    CHECK(table->get_values(keys, {}).empty());
+
+    target->remove_object(target_obj.get_key());
+    values = table->get_values({keys[0]}, {col_link});
+    CHECK(values[0].is_null());
+
+    table->remove_object(keys[5]);
+    CHECK_THROW(table->get_values(keys, cols), KeyNotFound);
+    table->remove_column(col_double);
+    CHECK_THROW(table->get_values({keys[0]}, {col_int, col_double}), InvalidColumnKey);
+}
+
+TEST(Table_get_objects)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    auto wt = db->start_write();
+    auto table = wt->add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 3000; i++) {
+        keys.push_back(table->create_object().set(col_int, i).get_key());
+    }
+    std::reverse(keys.begin() + 1000, keys.end());
+    keys.push_back(ObjKey());
+    keys.push_back(keys[17]);
+
+    auto objects = table->get_objects(keys);
+    CHECK_EQUAL(objects.size(), keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i]) {
+            CHECK_EQUAL(objects[i].get_key(), keys[i]);
+            CHECK_EQUAL(objects[i].get<Int>(col_int), table->get_object(keys[i]).get<Int>(col_int));
+        }
+        else {
+            CHECK_NOT(objects[i]);
+        }
+    }
+    CHECK(table->get_objects({}).empty());
+
+    // Objects looked up again after the tree has changed must be found where they are now
+    ObjKey key = keys[2000];
+    CHECK_EQUAL(table->get_object(key).get<Int>(col_int), 1999);
+    for (int i = 0; i < 10; i++) {
+        table->remove_object(keys[i]);
+    }
+    CHECK_EQUAL(table->get_object(key).get<Int>(col_int), 1999);
+    CHECK_EQUAL(table->get_object(key).get_key(), key);
+    CHECK_NOT(table->try_get_object(keys[0]));
+    CHECK_THROW(table->get_object(keys[0]), KeyNotFound);
+    CHECK_THROW(table->get_objects({keys[20], keys[0]}), KeyNotFound);
+    table->get_object(key).set(col_int, -1);
+    CHECK_EQUAL(table->get_object(key).get<Int>(col_int), -1);
+    wt->commit_and_continue_as_read();
+
+    auto rt = db->start_read();
+    CHECK_EQUAL(rt->get_table("table")->get_object(key).get<Int>(col_int), -1);
+
+    wt->promote_to_write();
+    table->get_object(key).set(col_int, 7);
+    table->create_object(ObjKey(0));
+    CHECK_EQUAL(table->get_object(ObjKey(0)).get<Int>(col_int), 0);
+    wt->rollback_and_continue_as_read();
+    CHECK_EQUAL(table->get_object(key).get<Int>(col_int), -1);
+    CHECK_NOT(table->try_get_object(ObjKey(0)));
+    CHECK_EQUAL(rt->get_table("table")->get_object(key).get<Int>(col_int), -1);
+
+    auto frozen = wt->freeze();
+    CHECK_EQUAL(frozen->get_table("table")->get_objects({key})[0].get<Int>(col_int), -1);
+}
+
+TEST(Table_scan_key_range)
+{
+    Table table;
+    auto col = table.add_column(type_Int, "int");
+
+    // Keys with gaps, so that the inner nodes of the tree store their keys
+    std::vector<int64_t> keys;
+    for (int64_t i = 0; i < 5000; i++) {
+        int64_t key = i * 3 + (i % 7 == 0 ? 10000 : 0);
+        table.create_object(ObjKey(key)).set(col, key);
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    auto scan = [&](int64_t begin, int64_t end) {
+        std::vector<int64_t> found;
+        table.scan_key_range(ObjKey(begin), ObjKey(end), [&](const Obj& obj) {
+            CHECK_EQUAL(obj.get<Int>(col), obj.get_key().value);
+            found.push_back(obj.get_key().value);
+            return IteratorControl::AdvanceToNext;
+        });
+        return found;
+    };
+    auto expected = [&](int64_t begin, int64_t end) {
+        std::vector<int64_t> result;
+        std::copy_if(keys.begin(), keys.end(), std::back_inserter(result), [&](int64_t key) {
+            return key >= begin && key < end;
+        });
+        return result;
+    };
+
+    std::vector<std::pair<int64_t, int64_t>> ranges{
+        {0, 1}, {1, 3}, {0, 100}, {2998, 3005}, {7000, 26000}, {14990, 15000}, {-10, 5}, {20000, 30000}, {5, 5}};
+    for (auto [begin, end] : ranges) {
+        CHECK(scan(begin, end) == expected(begin, end));
+    }
+
+    for (int64_t i = 100; i < 4000; i++) {
+        table.remove_object(ObjKey(keys[i]));
+    }
+    keys.erase(keys.begin() + 100, keys.begin() + 4000);
+    for (auto [begin, end] : ranges) {
+        CHECK(scan(begin, end) == expected(begin, end));
+    }
+
+    size_t count = 0;
+    table.scan_key_range(ObjKey(0), ObjKey(30000), [&](const Obj&) {
+        return ++count == 10 ? IteratorControl::Stop : IteratorControl::AdvanceToNext;
+    });
+    CHECK_EQUAL(count, 10);
+}
+
 TEST(Table_object_merge_nodes)
 {
     // This test works best for REALM_MAX_BPNODE_SIZE == 8.
@@ -3554,6 +4113,92 @@ TEST(Table_CreateObjectWithPrimaryKeyDidCreate)
     CHECK_NOT(did_create);
 }
 
+TEST_TYPES(Table_PrimaryKeyLookup, Prop<Int>, Prop<StringData>, Prop<ObjectId>)
+{
+    using underlying_type = typename TEST_TYPE::underlying_type;
+    // Each value is only used until the next one is made
+    std::string buffer;
+    auto pk = [&](int i) -> Mixed {
+        if constexpr (std::is_same_v<underlying_type, Int>) {
+            return int64_t(i) * 1024;
+        }
+        else if constexpr (std::is_same_v<underlying_type, StringData>) {
+            buffer = util::format("key %1", i);
+            return StringData(buffer);
+        }
+        else {
+            char hex[25];
+            snprintf(hex, sizeof(hex), "%024x", i);
+            return ObjectId(hex);
+        }
+    };
+
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    std::map<int, ObjKey> keys;
+    const int num_objects = 500;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table_with_primary_key("class_t", TEST_TYPE::data_type, "pk");
+        for (int i = 0; i < num_objects; ++i)
+            keys[i] = table->create_object_with_primary_key(pk(i)).get_key();
+        wt->commit();
+    }
+
+    auto check_all = [&](const Table& table) {
+        for (int i = 0; i < 2 * num_objects; ++i) {
+            auto it = keys.find(i);
+            CHECK_EQUAL(table.find_primary_key(pk(i)), it == keys.end() ? ObjKey() : it->second);
+        }
+    };
+
+    auto wt = db->start_write();
+    auto table = wt->get_table("class_t");
+    // Enough lookups to build the hash table, which must then be kept up to
+    // date by the changes below
+    check_all(*table);
+    check_all(*table);
+    for (int i = 0; i < num_objects; i += 3) {
+        table->remove_object(keys[i]);
+        keys.erase(i);
+    }
+    for (int i = num_objects; i < 2 * num_objects; i += 2)
+        keys[i] = table->create_object_with_primary_key(pk(i)).get_key();
+    check_all(*table);
+    // Removed objects can be created again
+    for (int i = 0; i < num_objects; i += 6)
+        keys[i] = table->create_object_with_primary_key(pk(i)).get_key();
+    check_all(*table);
+
+    // The changes survive the commit
+    wt->commit_and_continue_as_read();
+    check_all(*table);
+
+    // and are forgotten if rolled back
+    wt->promote_to_write();
+    auto saved = keys;
+    for (int i = num_objects + 1; i < 2 * num_objects; i += 2)
+        keys[i] = table->create_object_with_primary_key(pk(i)).get_key();
+    check_all(*table);
+    wt->rollback_and_continue_as_read();
+    keys = saved;
+    check_all(*table);
+
+    // Changes made by another transaction are picked up when advancing
+    {
+        auto wt_2 = db->start_write();
+        auto table_2 = wt_2->get_table("class_t");
+        table_2->get_object(keys[1]).remove();
+        keys.erase(1);
+        keys[num_objects + 1] = table_2->create_object_with_primary_key(pk(num_objects + 1)).get_key();
+        wt_2->commit();
+    }
+    wt->advance_read();
+    check_all(*table);
+
+    table->verify();
+}
+
 TEST(Table_PrimaryKeyIndexBug)
 {
     Group g;
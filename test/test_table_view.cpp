@@ -32,6 +32,7 @@
 
 #include "test.hpp"
 #include "test_table_helper.hpp"
+#include "util/random.hpp"
 
 using namespace std::chrono;
 
@@ -783,6 +784,45 @@ TEST(TableView_ClearNone)
     v.clear();
 }
 
+TEST(TableView_ClearAll)
+{
+    Group g;
+    auto target = g.add_table("target");
+    auto origin = g.add_table("origin");
+    auto col_int = target->add_column(type_Int, "int");
+    target->add_search_index(col_int);
+    auto col_link = origin->add_column(*target, "link");
+    auto col_list = origin->add_column_list(*target, "list");
+
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 1000; ++i)
+        keys.push_back(target->create_object().set(col_int, i % 10).get_key());
+    auto origin_obj = origin->create_object().set(col_link, keys[0]);
+    auto list = origin_obj.get_linklist(col_list);
+    list.add(keys[0]);
+    list.add(keys[1]);
+
+    // A view which holds as many keys as the table has objects, but not all of them
+    for (size_t i = 1; i < keys.size() - 1; ++i)
+        list.add(keys[0]);
+    TableView v = list.get_sorted_view(col_int);
+    CHECK_EQUAL(v.size(), target->size());
+    v.clear();
+    CHECK_EQUAL(target->size(), 998);
+    CHECK_EQUAL(list.size(), 0);
+    CHECK_NOT(origin_obj.get<ObjKey>(col_link));
+
+    // A view of all of them
+    v = target->where().find_all();
+    v.clear();
+    CHECK_EQUAL(0, v.size());
+    CHECK_EQUAL(target->size(), 0);
+    CHECK_NOT(target->find_first_int(col_int, 5));
+
+    target->create_object().set(col_int, 5);
+    CHECK(target->find_first_int(col_int, 5));
+}
+
 TEST(TableView_MultiColSort)
 {
     Table table;
@@ -821,6 +861,73 @@ TEST(TableView_MultiColSort)
     CHECK_EQUAL(tv[2].get<float>(col_float), 1.f);
 }
 
+TEST(TableView_MultiColSortOverLinks)
+{
+    Group g;
+    auto target = g.add_table("target");
+    auto col_value = target->add_column(type_Int, "value");
+    auto origin = g.add_table("origin");
+    auto col_str = origin->add_column(type_String, "str", true);
+    auto col_link = origin->add_column(*target, "link");
+    auto col_double = origin->add_column(type_Double, "double");
+
+    std::vector<ObjKey> targets;
+    for (int i = 0; i < 10; ++i)
+        targets.push_back(target->create_object().set(col_value, i % 4).get_key());
+
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    const char* strings[] = {"a", "b", "c"};
+    for (int i = 0; i < 1000; ++i) {
+        Obj obj = origin->create_object();
+        size_t s = random.draw_int_mod(4);
+        if (s < 3)
+            obj.set(col_str, strings[s]);
+        size_t t = random.draw_int_mod(11);
+        if (t < 10)
+            obj.set(col_link, targets[t]);
+        obj.set(col_double, double(random.draw_int_mod(5)));
+    }
+
+    for (bool ascending : {true, false}) {
+        auto tv = origin->where().find_all();
+        tv.sort(SortDescriptor({{col_str}, {col_link, col_value}, {col_double}}, {ascending, !ascending, true}));
+        CHECK_EQUAL(tv.size(), 1000);
+
+        // Each object must come after the previous one, or compare equal and come later in table order
+        auto sort_values = [&](const Obj& obj) {
+            Mixed linked;
+            if (auto key = obj.get<ObjKey>(col_link))
+                linked = target->get_object(key).get<Int>(col_value);
+            return std::make_tuple(obj.get_any(col_str), bool(obj.get<ObjKey>(col_link)), linked,
+                                   obj.get<double>(col_double));
+        };
+        for (size_t i = 1; i < tv.size(); ++i) {
+            auto [str_a, has_link_a, linked_a, double_a] = sort_values(tv.get_object(i - 1));
+            auto [str_b, has_link_b, linked_b, double_b] = sort_values(tv.get_object(i));
+            int c = str_a.compare(str_b);
+            if (c) {
+                CHECK(ascending ? c < 0 : c > 0);
+                continue;
+            }
+            if (has_link_a != has_link_b) {
+                // Null links come last when the column is ascending
+                CHECK_EQUAL(has_link_a, !ascending);
+                continue;
+            }
+            c = linked_a.compare(linked_b);
+            if (c) {
+                CHECK(ascending ? c > 0 : c < 0);
+                continue;
+            }
+            if (double_a != double_b) {
+                CHECK_LESS(double_a, double_b);
+                continue;
+            }
+            CHECK_LESS(tv.get_key(i - 1), tv.get_key(i));
+        }
+    }
+}
+
 TEST(TableView_QueryCopy)
 {
     Table table;
@@ -1151,6 +1258,172 @@ TEST(TableView_IsInSync)
     CHECK(ctv1.is_in_sync());
 }
 
+TEST(TableView_IncrementalSync)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto repl = make_in_realm_history();
+    DBRef db = DB::create(*repl, path, DBOptions(DBOptions::Durability::MemOnly));
+    Random random(random_int<unsigned long>());
+    ColKey col_value, col_name, col_link;
+    {
+        auto wt = db->start_write();
+        auto t = wt->add_table("items");
+        col_value = t->add_column(type_Int, "value");
+        col_name = t->add_column(type_String, "name", true);
+        col_link = t->add_column(*t, "link");
+        for (int i = 0; i < 2000; ++i) {
+            t->create_object().set(col_value, random.draw_int_mod(100)).set(col_name, util::to_string(i % 7));
+        }
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto t = rt->get_table("items");
+    auto query_filtered = [&] {
+        return t->where().greater(col_value, 50);
+    };
+    auto query_sorted = [&] {
+        return t->where().less(col_value, 80).Or().equal(col_name, realm::null());
+    };
+    SortDescriptor sort({{col_value}, {col_name}}, {false, true});
+    TableView filtered = query_filtered().find_all();
+    TableView sorted = query_sorted().find_all();
+    sorted.sort(sort);
+    // Conditions over links depend on other objects, and are rerun
+    TableView linked = t->where().greater(col_value, 20).and_query(t->link(col_link).column<Int>(col_value) > 50).find_all();
+    filtered.set_incremental_sync(true);
+    sorted.set_incremental_sync(true);
+    linked.set_incremental_sync(true);
+    CHECK(filtered.is_incremental_sync());
+    CHECK(t->get_change_journal().is_tracking());
+
+    auto check_views = [&] {
+        filtered.sync_if_needed();
+        sorted.sync_if_needed();
+        linked.sync_if_needed();
+        TableView expected_filtered = query_filtered().find_all();
+        TableView expected_sorted = query_sorted().find_all();
+        expected_sorted.sort(sort);
+        TableView expected_linked =
+            t->where().greater(col_value, 20).and_query(t->link(col_link).column<Int>(col_value) > 50).find_all();
+        std::pair<TableView*, TableView*> pairs[] = {
+            {&filtered, &expected_filtered}, {&sorted, &expected_sorted}, {&linked, &expected_linked}};
+        for (auto [tv, expected] : pairs) {
+            CHECK(tv->is_in_sync());
+            if (!CHECK_EQUAL(tv->size(), expected->size()))
+                continue;
+            for (size_t i = 0; i < tv->size(); ++i) {
+                CHECK_EQUAL(tv->get_key(i), expected->get_key(i));
+            }
+        }
+    };
+    auto change = [&](Table& table) {
+        for (int i = 0; i < 10; ++i) {
+            switch (random.draw_int_mod(5)) {
+                case 0:
+                    table.create_object().set(col_value, random.draw_int_mod(100));
+                    break;
+                case 1:
+                    table.get_object(random.draw_int_mod(table.size())).remove();
+                    break;
+                case 2:
+                    table.get_object(random.draw_int_mod(table.size())).set_null(col_name);
+                    break;
+                case 3: {
+                    auto target = table.get_object(random.draw_int_mod(table.size())).get_key();
+                    table.get_object(random.draw_int_mod(table.size())).set(col_link, target);
+                    break;
+                }
+                default:
+                    table.get_object(random.draw_int_mod(table.size())).set(col_value, random.draw_int_mod(100));
+                    break;
+            }
+        }
+    };
+
+    for (int iteration = 0; iteration < 20; ++iteration) {
+        // Changes made by another transaction
+        {
+            auto wt = db->start_write();
+            change(*wt->get_table("items"));
+            wt->commit();
+        }
+        rt->advance_read();
+        check_views();
+
+        // Changes made in the transaction itself, which may be rolled back
+        rt->promote_to_write();
+        change(*t);
+        check_views();
+        change(*t);
+        if (iteration % 2) {
+            rt->commit_and_continue_as_read();
+        }
+        else {
+            rt->rollback_and_continue_as_read();
+        }
+        check_views();
+    }
+
+    // Adding a column cannot be handled incrementally
+    rt->promote_to_write();
+    t->add_column(type_Double, "double");
+    change(*t);
+    rt->commit_and_continue_as_read();
+    check_views();
+
+    // Copies of the view track the changes as well
+    {
+        TableView copy(filtered);
+        filtered.set_incremental_sync(false);
+        sorted.set_incremental_sync(false);
+        linked.set_incremental_sync(false);
+        CHECK(t->get_change_journal().is_tracking());
+        rt->promote_to_write();
+        change(*t);
+        rt->commit_and_continue_as_read();
+        copy.sync_if_needed();
+        TableView expected = query_filtered().find_all();
+        CHECK_EQUAL(copy.size(), expected.size());
+    }
+    CHECK_NOT(t->get_change_journal().is_tracking());
+}
+
+TEST(TableView_ChangeJournal)
+{
+    Table table;
+    auto& journal = table.get_change_journal();
+    journal.add(ObjKey(1)); // Not tracking
+    CHECK_EQUAL(journal.get_position(), 0);
+
+    journal.add_tracker();
+    uint64_t start = journal.get_position();
+    journal.add(ObjKey(5));
+    journal.add(ObjKey(3));
+    journal.add(ObjKey(5));
+    std::vector<ObjKey> keys;
+    CHECK(journal.get_changes(start, keys));
+    CHECK(keys == std::vector<ObjKey>({ObjKey(3), ObjKey(5)}));
+    CHECK(journal.get_changes(journal.get_position(), keys));
+    CHECK(keys.empty());
+    CHECK_NOT(journal.get_changes(ChangeJournal::npos, keys));
+
+    // The oldest changes are dropped when the journal is full
+    uint64_t position = journal.get_position();
+    for (size_t i = 0; i < ChangeJournal::max_size; ++i)
+        journal.add(ObjKey(int64_t(i)));
+    CHECK_NOT(journal.get_changes(start, keys));
+    CHECK(journal.get_changes(position + ChangeJournal::max_size - 10, keys));
+    CHECK_EQUAL(keys.size(), 10);
+
+    position = journal.get_position();
+    journal.invalidate();
+    CHECK_NOT(journal.get_changes(position, keys));
+    CHECK(journal.get_changes(journal.get_position(), keys));
+    journal.remove_tracker();
+    CHECK_NOT(journal.is_tracking());
+}
+
 namespace {
 struct DistinctDirect {
     Table& table;
@@ -1385,6 +1658,77 @@ TEST(TableView_DistinctOverNullLink)
     CHECK_EQUAL(tv.get_object(1).get_linked_object(col_link).get<Int>(col_int), 1);
 }
 
+TEST(TableView_DistinctMultipleColumns)
+{
+    Table t;
+    auto col_int = t.add_column(type_Int, "int", true);
+    auto col_double = t.add_column(type_Double, "double");
+    auto col_str = t.add_column(type_String, "str");
+    auto col_mixed = t.add_column(type_Mixed, "mixed");
+
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    const char* strings[] = {"a", "b", "c"};
+    for (int i = 0; i < 1000; ++i) {
+        Obj obj = t.create_object();
+        int64_t n = random.draw_int_mod(5);
+        if (n == 4)
+            obj.set_null(col_int);
+        else
+            obj.set(col_int, n);
+        // -0.0 and 0.0 are equal and must be treated as the same value
+        obj.set(col_double, random.draw_bool() ? 0.0 : -0.0);
+        obj.set(col_str, strings[random.draw_int_mod(3)]);
+        // Values of different types which compare equal
+        int64_t m = random.draw_int_mod(3);
+        obj.set(col_mixed, random.draw_bool() ? Mixed(m) : Mixed(double(m)));
+    }
+
+    auto check = [&](std::vector<ColKey> cols, const TableView& tv) {
+        // The first object with each combination of values is kept, in the order of the view
+        std::vector<std::vector<Mixed>> expected;
+        std::vector<ObjKey> expected_keys;
+        for (auto& obj : t) {
+            std::vector<Mixed> values;
+            for (auto col : cols)
+                values.push_back(obj.get_any(col));
+            auto equal = [&](const std::vector<Mixed>& other) {
+                for (size_t i = 0; i < values.size(); ++i) {
+                    if (values[i].compare(other[i]) != 0)
+                        return false;
+                }
+                return true;
+            };
+            if (std::none_of(expected.begin(), expected.end(), equal)) {
+                expected.push_back(values);
+                expected_keys.push_back(obj.get_key());
+            }
+        }
+        CHECK_EQUAL(tv.size(), expected_keys.size());
+        for (size_t i = 0; i < expected_keys.size() && i < tv.size(); ++i)
+            CHECK_EQUAL(tv.get_key(i), expected_keys[i]);
+    };
+
+    std::vector<std::vector<ColKey>> column_sets = {
+        {col_int}, {col_double}, {col_mixed}, {col_int, col_str}, {col_str, col_double, col_int}, {col_str, col_mixed}};
+    for (auto& cols : column_sets) {
+        std::vector<std::vector<ExtendedColumnKey>> keys;
+        for (auto col : cols)
+            keys.push_back({col});
+        auto tv = t.where().find_all();
+        tv.distinct(DistinctDescriptor(keys));
+        check(cols, tv);
+    }
+
+    // Followed by a sort, the same objects are kept
+    DescriptorOrdering ordering;
+    ordering.append_distinct(DistinctDescriptor({{col_int}, {col_str}}));
+    ordering.append_sort(SortDescriptor({{col_str}}, {false}));
+    auto tv = t.where().find_all(ordering);
+    CHECK_EQUAL(tv.size(), 15);
+    for (size_t i = 1; i < tv.size(); ++i)
+        CHECK_GREATER_EQUAL(tv.get_object(i - 1).get<String>(col_str), tv.get_object(i).get<String>(col_str));
+}
+
 TEST(TableView_IsRowAttachedAfterClear)
 {
     Table t;
@@ -2308,6 +2652,30 @@ TEST(TableView_CopyKeyValues)
     CHECK_EQUAL(yet_another_view.get_key(0), ObjKey(0));
 }
 
+TEST(TableView_CopiesShareKeyValues)
+{
+    TestTableView view;
+    view.add_values();
+
+    TestTableView copy(view);
+    CHECK(copy.get_keys().shares_keys_with(view.get_keys()));
+    TestTableView assigned;
+    assigned = view;
+    CHECK(assigned.get_keys().shares_keys_with(view.get_keys()));
+
+    // Modifying a copy leaves the others untouched
+    copy.get_keys().add(ObjKey(10));
+    CHECK_NOT(copy.get_keys().shares_keys_with(view.get_keys()));
+    CHECK_EQUAL(copy.size(), 11);
+    CHECK_EQUAL(view.size(), 10);
+    CHECK_EQUAL(assigned.size(), 10);
+
+    assigned.get_keys().clear();
+    CHECK_EQUAL(assigned.size(), 0);
+    CHECK_EQUAL(view.size(), 10);
+    CHECK_EQUAL(view.get_key(9), ObjKey(9));
+}
+
 TEST(TableView_SortFollowedByLimit)
 {
     constexpr int limit = 100;
@@ -2339,6 +2707,70 @@ TEST(TableView_SortFollowedByLimit)
     }
 }
 
+TEST(TableView_SortFollowedByLimitWithTies)
+{
+    Table table;
+    auto col_value = table.add_column(type_Int, "value", true);
+    auto col_name = table.add_column(type_String, "name");
+    std::mt19937 rng(unit_test_random_seed);
+    for (int i = 0; i < 5000; ++i) {
+        auto obj = table.create_object().set(col_name, util::to_string(rng() % 13));
+        if (rng() % 10)
+            obj.set(col_value, int64_t(rng() % 50));
+    }
+
+    auto check = [&](Query q, const SortDescriptor& sort, size_t limit) {
+        // Sorting everything and truncating afterwards gives the expected result
+        TableView expected = q.find_all();
+        expected.sort(sort);
+
+        DescriptorOrdering ordering;
+        ordering.append_sort(sort);
+        ordering.append_limit(limit);
+        TableView tv = q.find_all(ordering);
+        CHECK_EQUAL(tv.size(), std::min(limit, expected.size()));
+        for (size_t i = 0; i < tv.size(); ++i) {
+            CHECK_EQUAL(tv.get_key(i), expected.get_key(i));
+        }
+
+        // Sorting the objects of an existing view
+        TableView tv2 = q.find_all();
+        tv2.apply_descriptor_ordering(ordering);
+        CHECK_EQUAL(tv2.size(), tv.size());
+        for (size_t i = 0; i < tv2.size(); ++i) {
+            CHECK_EQUAL(tv2.get_key(i), expected.get_key(i));
+        }
+    };
+
+    for (size_t limit : {0, 1, 7, 20, 100, 1000, 10000}) {
+        check(table.where(), SortDescriptor({{col_value}}), limit);
+        check(table.where(), SortDescriptor({{col_value}}, {false}), limit);
+        check(table.where(), SortDescriptor({{col_value}, {col_name}}, {false, true}), limit);
+        check(table.where().not_equal(col_name, "3"), SortDescriptor({{col_name}, {col_value}}), limit);
+        check(table.where().less(col_value, 10).Or().equal(col_name, "5"), SortDescriptor({{col_value}}, {false}),
+              limit);
+    }
+
+    // A distinct following the limit is applied to the limited result
+    DescriptorOrdering ordering;
+    ordering.append_sort(SortDescriptor({{col_value}}, {false}));
+    ordering.append_limit(100);
+    ordering.append_distinct(DistinctDescriptor({{col_value}}));
+    TableView tv = table.where().find_all(ordering);
+    TableView expected = table.where().find_all();
+    expected.sort(col_value, false);
+    std::vector<Mixed> values;
+    for (size_t i = 0; i < 100; ++i) {
+        Mixed value = expected.get_object(i).get_any(col_value);
+        if (values.empty() || values.back() != value)
+            values.push_back(value);
+    }
+    CHECK_EQUAL(tv.size(), values.size());
+    for (size_t i = 0; i < tv.size(); ++i) {
+        CHECK_EQUAL(tv.get_object(i).get_any(col_value), values[i]);
+    }
+}
+
 TEST(TableView_Filter)
 {
     Table table;
@@ -2408,4 +2840,41 @@ TEST(TableView_Filter)
     }
 }
 
+TEST(TableView_ApplyDescriptorOrderingWithKnownResults)
+{
+    Table table;
+    auto col_int = table.add_column(type_Int, "int");
+    auto col_other = table.add_column(type_Int, "other");
+    for (int i = 0; i < 10; ++i)
+        table.create_object().set(col_int, i);
+
+    Query q = table.where().greater(col_int, 5);
+    DescriptorOrdering ordering;
+    ordering.append_sort(SortDescriptor({{col_int}}, {false}));
+    TableView tv = q.find_all();
+    tv.apply_descriptor_ordering(ordering);
+    std::vector<ObjKey> keys;
+    for (size_t i = 0; i < tv.size(); ++i)
+        keys.push_back(tv.get_key(i));
+
+    table.get_object(keys[0]).set(col_other, 1);
+    CHECK_NOT(tv.is_in_sync());
+
+    // The view takes the given results and is in sync without running the query
+    TableView known(q, size_t(-1));
+    known.apply_descriptor_ordering(ordering, keys);
+    CHECK(known.is_in_sync());
+    CHECK_EQUAL(known.size(), 4);
+    for (size_t i = 0; i < keys.size(); ++i)
+        CHECK_EQUAL(known.get_key(i), keys[i]);
+    CHECK_EQUAL(known.get_descriptor_ordering_description(), "SORT(int DESC)");
+
+    // Later changes are picked up by running the query as usual
+    table.create_object().set(col_int, 20);
+    CHECK_NOT(known.is_in_sync());
+    known.sync_if_needed();
+    CHECK_EQUAL(known.size(), 5);
+    CHECK_EQUAL(known.get_object(0).get<Int>(col_int), 20);
+}
+
 #endif // TEST_TABLE_VIEW
@@ -40,6 +40,7 @@
 #include <realm/util/thread.hpp>
 #include <realm/util/interprocess_condvar.hpp>
 #include <realm/util/interprocess_mutex.hpp>
+#include <realm/util/async_logger.hpp>
 
 #include <iostream>
 #include "test.hpp"
@@ -957,6 +958,85 @@ NONCONCURRENT_TEST(Thread_Condvar_CreateDestroyDifferentThreads)
     }).join();
 }
 
+NONCONCURRENT_TEST(Thread_StartCallback)
+{
+    std::mutex mutex;
+    std::vector<ThreadRole> roles;
+    set_thread_start_callback([&](ThreadRole role) {
+        std::lock_guard lock(mutex);
+        roles.push_back(role);
+    });
+    {
+        AsyncLogger logger(std::make_shared<NullLogger>());
+        logger.flush();
+    }
+    set_thread_start_callback(nullptr);
+    {
+        AsyncLogger logger(std::make_shared<NullLogger>());
+        logger.flush();
+    }
+    CHECK(roles == std::vector<ThreadRole>{ThreadRole::logger});
+}
+
+TEST(Thread_SetAffinity)
+{
+    // Pin a thread of its own so that the test runner is not affected
+    std::thread([&] {
+        std::vector<unsigned> cpus = Thread::get_numa_node_cpus(0);
+#if REALM_LINUX
+        CHECK(cpus.empty() || Thread::set_affinity(cpus));
+        CHECK(Thread::set_affinity({unsigned(sched_getcpu())}));
+        CHECK_THROW(Thread::set_affinity({unsigned(CPU_SETSIZE)}), std::invalid_argument);
+#else
+        CHECK(cpus.empty());
+        CHECK_NOT(Thread::set_affinity({0}));
+#endif
+    }).join();
+}
+
+#if defined(REALM_CONDVAR_EMULATION) && !defined(_WIN32) && !REALM_TVOS
+NONCONCURRENT_TEST(Thread_CondvarEmulationCreatesFifoOnFirstWait)
+{
+    InterprocessMutex mutex;
+    InterprocessMutex::SharedPart mutex_part;
+    InterprocessCondVar waiter_cv, notifier_cv;
+    InterprocessCondVar::SharedPart condvar_part;
+    InterprocessCondVar::init_shared_part(condvar_part);
+    TEST_PATH(path);
+    DBOptions default_options;
+    std::string fifo_path = std::string(path) + ".Thread_CondvarLazy_CondVar.cv";
+    mutex.set_shared_part(mutex_part, path, "Thread_CondvarLazy_Mutex");
+    waiter_cv.set_shared_part(condvar_part, path, "Thread_CondvarLazy_CondVar", default_options.temp_dir);
+    notifier_cv.set_shared_part(condvar_part, path, "Thread_CondvarLazy_CondVar", default_options.temp_dir);
+    CHECK_NOT(File::exists(fifo_path));
+
+    // Notifying without waiters does not need the fifo
+    {
+        std::lock_guard<InterprocessMutex> l(mutex);
+        notifier_cv.notify_all();
+    }
+    CHECK_NOT(File::exists(fifo_path));
+
+    // A waiter creates it, and a notifier which has not used it before opens it
+    bool signaled = false;
+    std::thread signal_thread([&] {
+        millisleep(10);
+        std::lock_guard<InterprocessMutex> l(mutex);
+        signaled = true;
+        notifier_cv.notify_all();
+    });
+    {
+        std::lock_guard<InterprocessMutex> l(mutex);
+        waiter_cv.wait(mutex, nullptr, [&] {
+            return signaled;
+        });
+    }
+    signal_thread.join();
+    waiter_cv.release_shared_part();
+    mutex.release_shared_part();
+}
+#endif
+
 #ifdef _WIN32
 TEST(Thread_Win32InterprocessBackslashes)
 {
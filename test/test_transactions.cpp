@@ -544,6 +544,62 @@ TEST(Transactions_Continuous_SerialWrites)
     }
 }
 
+TEST(Transactions_EvictTableAccessors)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef sg = DB::create(*hist, path);
+    std::vector<TableKey> keys;
+    std::vector<ColKey> cols;
+    {
+        TransactionRef tr = sg->start_write();
+        for (int i = 0; i < 20; ++i) {
+            auto table = tr->add_table(util::format("table_%1", i));
+            cols.push_back(table->add_column(type_String, "value"));
+            table->add_search_index(cols.back());
+            table->create_object().set(cols.back(), util::format("value %1", i));
+            keys.push_back(table->get_key());
+        }
+        tr->commit();
+    }
+
+    TransactionRef tr = sg->start_read();
+    tr->evict_table_accessors(0);
+    CHECK_EQUAL(tr->get_num_table_accessors(), 0);
+    for (auto key : keys)
+        tr->get_table(key);
+    CHECK_EQUAL(tr->get_num_table_accessors(), 20);
+    size_t memory = tr->get_table_accessor_memory();
+    CHECK_GREATER(memory, 20 * sizeof(Table));
+
+    // Touch the first five tables again, so that they are the ones kept
+    std::vector<ConstTableRef> refs;
+    for (size_t i = 0; i < 5; ++i)
+        refs.push_back(tr->get_table(keys[i]));
+    ConstTableRef evicted = tr->get_table(keys[10]);
+    for (size_t i = 0; i < 5; ++i)
+        tr->get_table(keys[i]);
+    tr->evict_table_accessors(5);
+    CHECK_EQUAL(tr->get_num_table_accessors(), 5);
+    CHECK_LESS(tr->get_table_accessor_memory(), memory);
+    for (size_t i = 0; i < 5; ++i)
+        CHECK_EQUAL(refs[i]->size(), 1);
+    CHECK_THROW(evicted->size(), InvalidTableRef);
+
+    // Evicted tables are brought back on demand
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto table = tr->get_table(keys[i]);
+        CHECK_EQUAL(table->find_first_string(cols[i], util::format("value %1", i)), table->begin()->get_key());
+    }
+    CHECK_EQUAL(tr->get_num_table_accessors(), 20);
+    tr->verify();
+
+    tr->promote_to_write();
+    CHECK_THROW(tr->evict_table_accessors(0), WrongTransactionState);
+    tr->rollback();
+    CHECK_THROW(sg->start_frozen()->evict_table_accessors(0), WrongTransactionState);
+}
+
 
 // Check that enumeration is gone after
 // rolling back the insertion of a string enum column
@@ -838,6 +838,148 @@ TEST(Transform_AddInteger)
     }
 }
 
+TEST(Transform_ParallelConflictGroups)
+{
+    auto changeset_dump_dir_gen = get_changeset_dump_dir_generator(test_context);
+    auto server = Peer::create_server(test_context, changeset_dump_dir_gen.get());
+    auto client_1 = Peer::create_client(test_context, 2, changeset_dump_dir_gen.get());
+    auto client_2 = Peer::create_client(test_context, 3, changeset_dump_dir_gen.get());
+    server->history.set_transform_threads(4);
+    client_1->history.set_transform_threads(4);
+
+    auto schema = [](WriteTransaction& tr) {
+        TableRef t = tr.get_group().add_table_with_primary_key("class_t", type_Int, "id");
+        t->add_column(type_Int, "i");
+        t->add_column(type_Int, "j");
+    };
+    client_1->create_schema(schema);
+    client_2->create_schema(schema);
+    client_1->transaction([](Peer& client_1) {
+        for (int64_t id = 0; id < 20; ++id) {
+            client_1.table("class_t")->create_object_with_primary_key(id);
+        }
+    });
+    synchronize(server.get(), {client_1.get(), client_2.get()});
+
+    // Offline edits touching every object on both sides, with each object in
+    // its own conflict group
+    client_1->history.advance_time(10);
+    for (int64_t id = 0; id < 20; ++id) {
+        client_1->transaction([&](Peer& client_1) {
+            client_1.table("class_t")->get_object_with_primary_key(id).set("i", 100 + id);
+            if (id % 3 == 0)
+                client_1.table("class_t")->get_object_with_primary_key(id).set("j", id);
+        });
+    }
+    client_2->history.advance_time(20);
+    for (int64_t id = 0; id < 20; ++id) {
+        client_2->transaction([&](Peer& client_2) {
+            auto obj = client_2.table("class_t")->get_object_with_primary_key(id);
+            if (id % 2 == 0)
+                obj.set("i", 200 + id);
+            else
+                obj.add_int("i", 1);
+            if (id == 5)
+                obj.remove();
+        });
+    }
+    synchronize(server.get(), {client_1.get(), client_2.get()});
+    {
+        ReadTransaction read_server(server->shared_group);
+        ReadTransaction read_client_1(client_1->shared_group);
+        ReadTransaction read_client_2(client_2->shared_group);
+        auto table = read_server.get_table("class_t");
+        CHECK_EQUAL(table->size(), 19);
+        CHECK_EQUAL(table->get_object_with_primary_key(2).get<Int>("i"), 202);
+        CHECK_EQUAL(table->get_object_with_primary_key(3).get<Int>("i"), 104);
+        CHECK_EQUAL(table->get_object_with_primary_key(3).get<Int>("j"), 3);
+        CHECK(compare_groups(read_server, read_client_1));
+        CHECK(compare_groups(read_server, read_client_2, *test_context.logger));
+    }
+
+    // A schema change on the local side makes the transform sequential
+    client_1->transaction([](Peer& client_1) {
+        client_1.table("class_t")->add_column(type_String, "s");
+        client_1.table("class_t")->get_object_with_primary_key(1).set("i", 1);
+    });
+    client_2->transaction([](Peer& client_2) {
+        client_2.table("class_t")->get_object_with_primary_key(4).set("i", 4);
+    });
+    synchronize(server.get(), {client_1.get(), client_2.get()});
+    {
+        ReadTransaction read_server(server->shared_group);
+        ReadTransaction read_client_1(client_1->shared_group);
+        ReadTransaction read_client_2(client_2->shared_group);
+        CHECK(compare_groups(read_server, read_client_1));
+        CHECK(compare_groups(read_server, read_client_2, *test_context.logger));
+    }
+}
+
+TEST(Transform_ReciprocalTransformCache)
+{
+    auto make_changeset = [](version_type version, size_t num_objects) {
+        Changeset changeset;
+        changeset.version = version;
+        for (size_t i = 0; i < num_objects; ++i) {
+            Instruction::CreateObject instr;
+            instr.table = changeset.intern_string("Foo");
+            instr.object = int64_t(i);
+            changeset.push_back(instr);
+        }
+        return changeset;
+    };
+
+    // A zero budget disables the cache
+    ReciprocalTransformCache cache;
+    Changeset changeset;
+    cache.put(1, make_changeset(1, 10));
+    CHECK_NOT(cache.take(1, changeset));
+    CHECK_EQUAL(cache.get_metrics().num_changesets, 0);
+    CHECK_EQUAL(cache.get_metrics().misses, 0);
+
+    // Entries are moved out when taken
+    cache.set_budget(1024 * 1024);
+    cache.put(1, make_changeset(1, 10));
+    cache.put(2, make_changeset(2, 20));
+    CHECK_EQUAL(cache.get_metrics().num_changesets, 2);
+    size_t memory_used = cache.get_metrics().memory_used;
+    CHECK_GREATER(memory_used, 0);
+    CHECK(cache.take(2, changeset));
+    CHECK_EQUAL(changeset.version, 2);
+    CHECK_EQUAL(changeset.size(), 20);
+    CHECK_NOT(cache.take(2, changeset));
+    CHECK_NOT(cache.take(3, changeset));
+    auto metrics = cache.get_metrics();
+    CHECK_EQUAL(metrics.hits, 1);
+    CHECK_EQUAL(metrics.misses, 2);
+    CHECK_EQUAL(metrics.num_changesets, 1);
+    CHECK_LESS(metrics.memory_used, memory_used);
+
+    // The least recently used entries are evicted to stay within the budget
+    cache.put(2, std::move(changeset));
+    CHECK(cache.take(1, changeset));
+    cache.put(1, std::move(changeset));
+    cache.set_budget(cache.get_metrics().memory_used - 1);
+    metrics = cache.get_metrics();
+    CHECK_EQUAL(metrics.evictions, 1);
+    CHECK_EQUAL(metrics.num_changesets, 1);
+    CHECK_LESS_EQUAL(metrics.memory_used, cache.get_budget());
+    CHECK_NOT(cache.take(2, changeset));
+    CHECK(cache.take(1, changeset));
+    CHECK_EQUAL(changeset.size(), 10);
+
+    // A changeset larger than the whole budget is not kept
+    cache.put(3, make_changeset(3, 1000));
+    CHECK_EQUAL(cache.get_metrics().num_changesets, 0);
+    CHECK_EQUAL(cache.get_metrics().memory_used, 0);
+
+    cache.put(1, std::move(changeset));
+    cache.clear();
+    CHECK_EQUAL(cache.get_metrics().num_changesets, 0);
+    CHECK_EQUAL(cache.get_metrics().memory_used, 0);
+    CHECK_NOT(cache.take(1, changeset));
+}
+
 TEST(Transform_AddIntegerSetNull)
 {
 
@@ -1609,6 +1751,41 @@ TEST(Transform_CreateEraseCreateSequencePreservesObject)
     });
 }
 
+TEST(Transform_CreateAndEraseInOneTransactionVsCreate)
+{
+    // An object created and erased in the same transaction still erases an
+    // object with the same primary key created by another client, as erase
+    // always wins over create.
+
+    auto changeset_dump_dir_gen = get_changeset_dump_dir_generator(test_context);
+    Associativity assoc{test_context, 2, changeset_dump_dir_gen.get()};
+    assoc.for_each_permutation([&](auto& it) {
+        auto server = &*it.server;
+        auto client_1 = &*it.clients[0];
+        auto client_2 = &*it.clients[1];
+
+        client_1->create_schema([](WriteTransaction& tr) {
+            auto table = tr.get_group().add_table_with_primary_key("class_table", type_Int, "pk");
+            table->add_column(type_Int, "int");
+        });
+        it.sync_all();
+
+        client_1->transaction([&](Peer& c) {
+            c.group->get_table("class_table")->create_object_with_primary_key(123).remove();
+        });
+
+        client_2->history.advance_time(1);
+        client_2->transaction([&](Peer& c) {
+            c.group->get_table("class_table")->create_object_with_primary_key(123).set<int64_t>("int", 2);
+        });
+
+        it.sync_all();
+
+        ReadTransaction rt_0(server->shared_group);
+        CHECK_EQUAL(rt_0.get_table("class_table")->size(), 0);
+    });
+}
+
 TEST(Transform_AddIntegerSurvivesSetNull)
 {
     // An AddInteger instruction merged with a Set(null) instruction with a
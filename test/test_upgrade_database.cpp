@@ -125,6 +125,46 @@ TEST_IF(Upgrade_DatabaseWithCallbackWithException, REALM_MAX_BPNODE_SIZE == 1000
     CHECK_NOT(did_upgrade);
 }
 
+TEST_IF(Upgrade_DatabaseWithProgressCallback, REALM_MAX_BPNODE_SIZE == 1000)
+{
+    std::string path = test_util::get_test_resource_path() + "test_upgrade_database_20.realm";
+    CHECK_OR_RETURN(File::exists(path));
+
+    SHARED_GROUP_TEST_PATH(temp_copy);
+    File::copy(path, temp_copy);
+
+    // Make the upgrade write what it has converted to the file after every table
+    DBOptions options;
+    options.no_create = true;
+    options.write_transaction_memory_limit = 1;
+
+    // Aborting the upgrade halfway through must leave the file as it was
+    size_t total = 0;
+    options.upgrade_progress_callback = [&](size_t done, size_t count) {
+        total = count;
+        if (done == count / 2)
+            throw 123;
+    };
+    CHECK_THROW(DB::create(temp_copy, options), int);
+    CHECK_GREATER(total, 1);
+
+    size_t last_done = 0;
+    options.upgrade_progress_callback = [&](size_t done, size_t count) {
+        CHECK_EQUAL(count, total);
+        CHECK_EQUAL(done, last_done + 1);
+        last_done = done;
+    };
+    auto db = DB::create(temp_copy, options);
+    CHECK_EQUAL(last_done, total);
+    db->start_read()->verify();
+    db->close();
+
+    // The file is already upgraded
+    last_done = 0;
+    DB::create(temp_copy, options);
+    CHECK_EQUAL(last_done, 0);
+}
+
 static void compare_files(test_util::unit_test::TestContext& test_context, const std::string& old_path,
                           const std::string& new_path)
 {
@@ -197,6 +237,103 @@ NONCONCURRENT_TEST(Upgrade_DatabaseWithUnsupportedNewFileFormat)
     compare_files(test_context, path, path_2);
 }
 
+NONCONCURRENT_TEST(Upgrade_Database_24_25)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::string prefix = realm::BackupHandler::get_prefix_from_path(path);
+    File::try_remove(prefix + "v24.backup.realm");
+    const int64_t epoch = 1700000000000;
+
+    auto populate = [&](const std::string& p) {
+        DBOptions options;
+        options.enable_integer_compression = true;
+        auto db = DB::create(make_in_realm_history(), p, options);
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        auto col = table->add_column(type_Int, "time");
+        auto col_name = table->add_column(type_String, "name");
+        for (int64_t i = 0; i < 1000; ++i)
+            table->create_object().set(col, epoch + i).set(col_name, std::to_string(i % 10));
+        wt->commit();
+        size_t free_space, used_space;
+        db->get_stats(free_space, used_space);
+        return used_space;
+    };
+
+    // Build a realm file with format 24. Its leaves are not encoded even when
+    // asked for, as that format has no encoded leaves.
+    _impl::GroupFriend::fake_target_file_format(24);
+    size_t used_24 = populate(path);
+    _impl::GroupFriend::fake_target_file_format({});
+    {
+        SHARED_GROUP_TEST_PATH(path_25);
+        CHECK_LESS(populate(path_25), used_24);
+    }
+
+    auto check = [&](const Group& group) {
+        auto table = group.get_table("table");
+        auto col = table->get_column_key("time");
+        CHECK_EQUAL(table->size(), 1000);
+        CHECK_EQUAL(table->where().greater_equal(col, epoch + 500).count(), 500);
+        CHECK_EQUAL(table->max(col)->get_int(), epoch + 999);
+    };
+
+    // Format 24 can be read as it is, but cannot be given structures of format 25
+    {
+        Group group(path);
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(group), 24);
+        check(group);
+        auto table = group.get_table("table");
+        auto col = table->get_column_key("time");
+        CHECK_THROW(table->add_search_index(col, IndexType::Sorted), IllegalOperation);
+        CHECK_EQUAL(table->search_index_type(col), IndexType::None);
+        std::vector<ColKey> columns{col, table->get_column_key("name")};
+        CHECK_THROW(table->add_compound_index(columns), IllegalOperation);
+        CHECK_NOT(table->has_compound_index(columns));
+        CHECK_THROW(table->set_compression(columns[1]), IllegalOperation);
+        CHECK_NOT(table->is_compressed(columns[1]));
+        CHECK_THROW(table->add_search_index(columns[1], IndexType::CaseInsensitive), IllegalOperation);
+        CHECK_EQUAL(table->search_index_type(columns[1]), IndexType::None);
+#if REALM_ENABLE_GEOSPATIAL
+        auto location = group.add_table("Location", Table::Type::Embedded);
+        location->add_column(type_String, Geospatial::c_geo_point_type_col_name);
+        location->add_column_list(type_Double, Geospatial::c_geo_point_coords_col_name);
+        CHECK_THROW(location->add_geospatial_index(), IllegalOperation);
+        CHECK_NOT(location->has_geospatial_index());
+#endif
+    }
+
+    // Opening it for writing upgrades it without changes
+    {
+        auto db = DB::create(make_in_realm_history(), path);
+        auto rt = db->start_read();
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(*rt), 25);
+        rt->verify();
+        check(*rt);
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        auto col = table->get_column_key("time");
+        table->add_search_index(col, IndexType::Sorted);
+        CHECK_EQUAL(table->search_index_type(col), IndexType::Sorted);
+        std::vector<ColKey> columns{col, table->get_column_key("name")};
+        table->add_compound_index(columns);
+        CHECK(table->has_compound_index(columns));
+        table->set_compression(columns[1]);
+        CHECK(table->is_compressed(columns[1]));
+        table->add_search_index(columns[1], IndexType::CaseInsensitive);
+        CHECK_EQUAL(table->search_index_type(columns[1]), IndexType::CaseInsensitive);
+#if REALM_ENABLE_GEOSPATIAL
+        auto location = wt->add_table("Location", Table::Type::Embedded);
+        location->add_column(type_String, Geospatial::c_geo_point_type_col_name);
+        location->add_column_list(type_Double, Geospatial::c_geo_point_coords_col_name);
+        location->add_geospatial_index();
+        CHECK(location->has_geospatial_index());
+#endif
+        wt->commit();
+    }
+    File::try_remove(prefix + "v24.backup.realm");
+}
+
 TEST_IF(Upgrade_Database_10_11, REALM_MAX_BPNODE_SIZE == 4 || REALM_MAX_BPNODE_SIZE == 1000)
 {
     std::string path = test_util::get_test_resource_path() + "test_upgrade_database_" +
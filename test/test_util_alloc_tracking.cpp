@@ -0,0 +1,92 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+
+#include <realm/util/alloc_tracking.hpp>
+
+#include <memory>
+#include <string>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::util;
+
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+//
+//
+// Debugging and the ONLY() macro
+// ------------------------------
+//
+// A simple way of disabling all tests except one called `Foo`, is to
+// replace TEST(Foo) with ONLY(Foo) and then recompile and rerun the
+// test suite. Note that you can also use filtering by setting the
+// environment varible `UNITTEST_FILTER`. See `README.md` for more on
+// this.
+//
+// Another way to debug a particular test, is to copy that test into
+// `experiments/testcase.cpp` and then run `sh build.sh
+// check-testcase` (or one of its friends) from the command line.
+
+namespace {
+
+TEST(Util_AllocTracking_Basics)
+{
+    CHECK_EQUAL(std::string(get_alloc_tag_name(AllocTag::query)), "query");
+    CHECK_EQUAL(std::string(get_alloc_tag_name(AllocTag::websocket)), "websocket");
+
+    // Other threads may allocate concurrently, so only lower bounds can be checked
+    AllocStats before = get_alloc_stats(AllocTag::sync_transform);
+    std::unique_ptr<char[]> block;
+    {
+        AllocTagScope outer{AllocTag::query};
+        AllocTagScope inner{AllocTag::sync_transform};
+        block.reset(new char[100000]);
+    }
+    AllocStats after = get_alloc_stats(AllocTag::sync_transform);
+    if (alloc_tracking_enabled()) {
+        CHECK_GREATER(after.num_allocations, before.num_allocations);
+        CHECK_GREATER_EQUAL(after.live_bytes, 100000);
+        CHECK_GREATER_EQUAL(after.peak_bytes, after.live_bytes);
+        block.reset();
+        reset_alloc_peaks();
+        CHECK_LESS(get_alloc_stats(AllocTag::sync_transform).peak_bytes, after.peak_bytes);
+    }
+    else {
+        CHECK_EQUAL(after.num_allocations, 0);
+        CHECK_EQUAL(after.live_bytes, 0);
+        CHECK_EQUAL(after.peak_bytes, 0);
+    }
+}
+
+} // unnamed namespace
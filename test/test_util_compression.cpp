@@ -246,6 +246,36 @@ TEST_IF(Compression_Allocate_And_Compress_Large, false)
     allocate_and_compress_decompress_compare(test_context, generate_compressible_data(to_size_t(uncompressed_size)));
 }
 
+TEST(Compression_Dictionary)
+{
+    std::string dictionary = "createdAt updatedAt owner_id status name _id";
+    std::string uncompressed;
+    for (int i = 0; i < 50; ++i)
+        uncompressed += util::format("_id %1 owner_id %2 name status createdAt ", i, i * 7);
+
+    std::vector<char> compressed;
+    std::vector<char> compressed_with_dictionary;
+    compression::CompressMemoryArena arena;
+    CHECK_NOT(compression::allocate_and_compress(arena, uncompressed, compressed));
+    CHECK_NOT(compression::allocate_and_compress(arena, uncompressed, compressed_with_dictionary, dictionary));
+    CHECK_LESS(compressed_with_dictionary.size(), compressed.size());
+
+    Buffer<char> decompressed(uncompressed.size());
+    CHECK_NOT(compression::decompress(compressed_with_dictionary, decompressed, dictionary));
+    compare(test_context, uncompressed, decompressed);
+
+    // The dictionary is ignored for data compressed without one
+    CHECK_NOT(compression::decompress(compressed, decompressed, dictionary));
+    compare(test_context, uncompressed, decompressed);
+
+    CHECK_EQUAL(compression::decompress(compressed_with_dictionary, decompressed),
+                compression::error::decompress_unsupported);
+    std::string other_dictionary = dictionary + " email";
+    CHECK_NOT_EQUAL(compression::dictionary_id(dictionary), compression::dictionary_id(other_dictionary));
+    CHECK_EQUAL(compression::decompress(compressed_with_dictionary, decompressed, other_dictionary),
+                compression::error::decompress_unsupported);
+}
+
 namespace {
 struct ChunkingStream : InputStream {
     Span<const char> input;
@@ -427,13 +457,13 @@ static void copy_stream(Span<char> dest, InputStream& stream)
 }
 
 static void test_decompress_stream(test_util::unit_test::TestContext& test_context, Span<const char> uncompressed,
-                                   Span<const char> compressed)
+                                   Span<const char> compressed, Span<const char> dictionary = {})
 {
     Buffer<char> decompressed(uncompressed.size());
 
     for_each_fib_block_size(uncompressed.size(), compressed, [&](InputStream& stream) {
         size_t total_size = 0;
-        auto decompress_stream = compression::decompress_nonportable_input_stream(stream, total_size);
+        auto decompress_stream = compression::decompress_nonportable_input_stream(stream, total_size, dictionary);
         CHECK_EQUAL(total_size, uncompressed.size());
         if (CHECK(decompress_stream)) {
             copy_stream(decompressed, *decompress_stream);
@@ -500,4 +530,69 @@ TEST_IF(Compression_DecompressInputStream_NonCompressible_Large, false)
     test_decompress_stream(test_context, uncompressed, compressed);
 }
 
+TEST(Compression_TrainedDictionary)
+{
+    auto make_record = [](int i) {
+        return util::format("{\"_id\": %1, \"owner_id\": \"user-%2\", \"status\": \"active\", "
+                            "\"createdAt\": %3, \"updatedAt\": %4}",
+                            i, i % 17, 1700000000 + i * 13, 1700000000 + i * 29);
+    };
+    std::vector<std::string> records;
+    for (int i = 0; i < 100; ++i)
+        records.push_back(make_record(i));
+    std::vector<Span<const char>> samples(records.begin(), records.end());
+
+    size_t max_size = 1024;
+    auto dictionary = compression::train_dictionary(samples, max_size);
+    CHECK_GREATER(dictionary.size(), 0);
+    CHECK_LESS_EQUAL(dictionary.size(), max_size);
+
+    // Small records are only compressed if there is a dictionary
+    std::string uncompressed = make_record(1000);
+    auto compressed = compression::allocate_and_compress_nonportable(uncompressed);
+    auto compressed_with_dictionary = compression::allocate_and_compress_nonportable(uncompressed, dictionary);
+    CHECK_GREATER(compressed.size(), uncompressed.size());
+    CHECK_LESS(compressed_with_dictionary.size(), uncompressed.size() * 2 / 3);
+    {
+        std::vector<char> compressed_without_dictionary;
+        compression::CompressMemoryArena arena;
+        CHECK_NOT(compression::allocate_and_compress(arena, uncompressed, compressed_without_dictionary));
+        CHECK_LESS(compressed_with_dictionary.size(), compressed_without_dictionary.size());
+    }
+
+    util::AppendBuffer<char> decompressed;
+    {
+        util::SimpleInputStream compressed_stream(compressed_with_dictionary);
+        CHECK_NOT(compression::decompress_nonportable(compressed_stream, decompressed, dictionary));
+        compare(test_context, uncompressed, decompressed);
+    }
+    test_decompress_stream(test_context, uncompressed, compressed_with_dictionary, dictionary);
+
+    // The dictionary is ignored for data compressed without one
+    {
+        util::SimpleInputStream compressed_stream(compressed);
+        CHECK_NOT(compression::decompress_nonportable(compressed_stream, decompressed, dictionary));
+        compare(test_context, uncompressed, decompressed);
+    }
+
+    // Decompressing fails without the dictionary or with another one
+    {
+        util::SimpleInputStream compressed_stream(compressed_with_dictionary);
+        CHECK_EQUAL(compression::decompress_nonportable(compressed_stream, decompressed),
+                    compression::error::decompress_unsupported);
+    }
+    test_failed_compress_stream(test_context, compressed_with_dictionary);
+    {
+        std::vector<char> other_dictionary(dictionary.begin() + 1, dictionary.end());
+        util::SimpleInputStream compressed_stream(compressed_with_dictionary);
+        CHECK_EQUAL(compression::decompress_nonportable(compressed_stream, decompressed, other_dictionary),
+                    compression::error::decompress_unsupported);
+    }
+
+    // Samples with nothing in common give no dictionary
+    auto noise_1 = generate_non_compressible_data(1000);
+    auto noise_2 = generate_non_compressible_data(1000);
+    CHECK_EQUAL(compression::train_dictionary({noise_1, noise_2}, max_size).size(), 0);
+}
+
 } // anonymous namespace
@@ -239,6 +239,7 @@ TEST(JSONParser_PrimitiveDocuments)
     ec = number_parser.parse([&](auto&& event) noexcept {
         CHECK_EQUAL(event.type, JSONParser::EventType::number);
         CHECK_EQUAL(event.number, 123);
+        CHECK_EQUAL(event.range, "123.0");
         return std::error_condition{};
     });
     CHECK(!ec);
@@ -309,3 +310,19 @@ TEST(JSONParser_StringTermination)
     });
     CHECK(!ec);
 }
+
+TEST(JSONParser_StringEndingWithBackslash)
+{
+    static const char object[] = "{\"a\\\\\":\"b\\\\\"}";
+    JSONParser parser{object};
+    std::vector<std::string> strings;
+    std::error_condition ec = parser.parse([&](auto&& event) noexcept {
+        if (event.type == JSONParser::EventType::string)
+            strings.emplace_back(event.escaped_string_value());
+        return std::error_condition{};
+    });
+    CHECK(!ec);
+    CHECK_EQUAL(strings.size(), 2);
+    CHECK_EQUAL(strings[0], "a\\\\");
+    CHECK_EQUAL(strings[1], "b\\\\");
+}
@@ -20,6 +20,7 @@
 #include <vector>
 #include <locale>
 
+#include <realm/util/async_logger.hpp>
 #include <realm/util/logger.hpp>
 #include <realm/util/hex_dump.hpp>
 #include <realm/binary_data.hpp>
@@ -374,6 +375,82 @@ TEST(Util_Logger_ThreadSafe)
     CHECK(messages_1 == messages_2);
 }
 
+TEST(Util_Logger_Async)
+{
+    // Not thread safe, as only the background thread writes to it
+    struct BalloonLogger : public util::Logger {
+        std::vector<std::string> messages;
+        std::vector<util::Logger::Level> levels;
+
+    protected:
+        void do_log(const util::LogCategory&, util::Logger::Level level, const std::string& message) override
+        {
+            messages.push_back(message);
+            levels.push_back(level);
+        }
+    };
+    auto root_logger = std::make_shared<BalloonLogger>();
+    root_logger->set_level_threshold(util::Logger::Level::all);
+    {
+        util::AsyncLogger logger(root_logger, 100);
+        CHECK(logger.get_overflow_policy(util::LogCategory::session) == util::AsyncLogger::OverflowPolicy::block);
+
+        const long num_iterations = 10000;
+        const int num_threads = 8;
+        std::unique_ptr<test_util::ThreadWrapper[]> threads(new test_util::ThreadWrapper[num_threads]);
+        for (int i = 0; i < num_threads; ++i)
+            threads[i].start([&logger, i] {
+                for (long j = 0; j < num_iterations; ++j)
+                    logger.debug("%1:%2", i, j);
+            });
+        for (int i = 0; i < num_threads; ++i)
+            CHECK_NOT(threads[i].join());
+        logger.flush();
+        CHECK_EQUAL(logger.get_dropped_count(), 0);
+
+        // Nothing is lost when the buffer is full, and the messages of each
+        // thread are written in order
+        std::vector<long> next(num_threads, 0);
+        bool in_order = true;
+        for (auto& message : root_logger->messages) {
+            auto sep = message.find(':');
+            int i = std::stoi(message.substr(0, sep));
+            long j = std::stol(message.substr(sep + 1));
+            in_order = in_order && next[i] == j;
+            next[i] = j + 1;
+        }
+        CHECK(in_order);
+        CHECK_EQUAL(root_logger->messages.size(), num_threads * num_iterations);
+
+        // The threshold is shared with the base logger
+        root_logger->messages.clear();
+        root_logger->levels.clear();
+        root_logger->set_level_threshold(util::Logger::Level::info);
+        logger.debug("Hidden");
+        logger.warn("Shown");
+        logger.flush();
+        CHECK_EQUAL(root_logger->messages.size(), 1);
+        CHECK_EQUAL(root_logger->messages[0], "Shown");
+        CHECK(root_logger->levels[0] == util::Logger::Level::warn);
+
+        // The policy applies to the children of the category
+        logger.set_overflow_policy(util::LogCategory::sync, util::AsyncLogger::OverflowPolicy::drop);
+        CHECK(logger.get_overflow_policy(util::LogCategory::session) == util::AsyncLogger::OverflowPolicy::drop);
+        CHECK(logger.get_overflow_policy(util::LogCategory::storage) == util::AsyncLogger::OverflowPolicy::block);
+        root_logger->messages.clear();
+        for (int i = 0; i < 10000; ++i)
+            logger.info(util::LogCategory::session, "Message %1", i);
+        logger.flush();
+        CHECK_EQUAL(root_logger->messages.size() + logger.get_dropped_count(), 10000);
+
+        // Messages queued before the logger is destroyed are still written
+        root_logger->messages.clear();
+        for (int i = 0; i < 1000; ++i)
+            logger.info("Message %1", i);
+    }
+    CHECK_EQUAL(root_logger->messages.size(), 1000);
+}
+
 TEST(Util_HexDump)
 {
     const unsigned char u_char_data[] = {0x00, 0x05, 0x10, 0x17, 0xff};
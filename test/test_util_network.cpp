@@ -9,6 +9,7 @@
 #include <realm/util/future.hpp>
 #include <realm/util/memory_stream.hpp>
 #include <realm/sync/network/network.hpp>
+#include <realm/sync/network/service_pool.hpp>
 #include <realm/sync/trigger.hpp>
 
 #include "test.hpp"
@@ -319,6 +320,44 @@ TEST(Network_GetSetSocketOption)
     socket.set_option(network::Socket::reuse_address(true));
     socket.get_option(opt_reuse_addr);
     CHECK(opt_reuse_addr.value());
+    std::error_code ec;
+    socket.set_option(network::Socket::reuse_port(true), ec);
+    CHECK(!ec || ec == MiscExtErrors::operation_not_supported);
+}
+
+
+TEST(Network_ServicePoolHandOff)
+{
+    network::ServicePool pool{{2, false, "test-net"}};
+    CHECK_EQUAL(2, pool.size());
+    CHECK_EQUAL(&pool.get(0), &pool.next());
+    CHECK_EQUAL(&pool.get(1), &pool.next());
+    pool.start();
+
+    network::Service service;
+    network::Acceptor acceptor{service};
+    network::Endpoint listening_endpoint = bind_acceptor(acceptor);
+    network::Socket socket_1{service}, socket_2{service};
+    socket_1.connect(listening_endpoint);
+    acceptor.accept(socket_2);
+
+    char data[] = {'X', 'F', 'M'};
+    socket_1.write(data, sizeof data);
+
+    network::Service& target = pool.get(1);
+    auto main_thread = std::this_thread::get_id();
+    network::ServicePool::hand_off(socket_2, target, [&](std::unique_ptr<network::Socket> sock) {
+        CHECK_EQUAL(&target, &sock->get_service());
+        CHECK(std::this_thread::get_id() != main_thread);
+        network::ReadAheadBuffer rab;
+        char buffer[sizeof data];
+        size_t n = sock->read(buffer, sizeof data, rab);
+        if (CHECK_EQUAL(sizeof data, n))
+            CHECK(std::equal(buffer, buffer + n, data));
+        pool.stop();
+    });
+    CHECK_NOT(socket_2.is_open());
+    pool.join();
 }
 
 
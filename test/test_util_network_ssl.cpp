@@ -318,6 +318,43 @@ TEST(Util_Network_SSL_AsyncHandshake)
 }
 
 
+#if REALM_HAVE_OPENSSL
+TEST(Util_Network_SSL_SessionResumption)
+{
+    network::ssl::Context server_context, client_context;
+    configure_server_ssl_context_for_test(server_context);
+    client_context.enable_client_session_cache();
+
+    auto connect = [&](const std::string& session_key, bool expect_reused) {
+        network::Service service;
+        network::Socket socket_1{service}, socket_2{service};
+        network::ssl::Stream server_stream{socket_1, server_context, network::ssl::Stream::server};
+        network::ssl::Stream client_stream{socket_2, client_context, network::ssl::Stream::client};
+        server_stream.set_logger(test_context.logger.get());
+        client_stream.set_logger(test_context.logger.get());
+        client_stream.set_session_key(session_key);
+        connect_ssl_streams(server_stream, client_stream);
+        CHECK_EQUAL(client_stream.session_reused(), expect_reused);
+        CHECK_EQUAL(server_stream.session_reused(), expect_reused);
+
+        // With TLS 1.3, sessions are only established once the client has
+        // processed the session tickets that follow the handshake.
+        char ch = 'x';
+        server_stream.write(&ch, 1);
+        client_stream.read(&ch, 1);
+    };
+
+    connect("server-1:443", false);
+    connect("server-1:443", true);
+    connect("server-1:443", true);
+    // Sessions are not offered to other servers
+    connect("server-2:443", false);
+    connect("server-2:443", true);
+    connect("server-1:443", true);
+}
+#endif
+
+
 TEST(Util_Network_SSL_ReadWriteShutdown)
 {
     network::Service service_1, service_2;
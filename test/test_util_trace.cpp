@@ -0,0 +1,98 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+
+#include <realm/util/trace.hpp>
+
+#include <string>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::util;
+
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+//
+//
+// Debugging and the ONLY() macro
+// ------------------------------
+//
+// A simple way of disabling all tests except one called `Foo`, is to
+// replace TEST(Foo) with ONLY(Foo) and then recompile and rerun the
+// test suite. Note that you can also use filtering by setting the
+// environment varible `UNITTEST_FILTER`. See `README.md` for more on
+// this.
+//
+// Another way to debug a particular test, is to copy that test into
+// `experiments/testcase.cpp` and then run `sh build.sh
+// check-testcase` (or one of its friends) from the command line.
+
+namespace {
+
+struct RecordingTraceBackend : TraceBackend {
+    std::string events;
+
+    uint64_t begin(const char* name) noexcept override
+    {
+        events += std::string("+") + name;
+        return events.size();
+    }
+
+    void end(const char* name, uint64_t token) noexcept override
+    {
+        events += util::format("-%1@%2", name, token);
+    }
+};
+
+// The backend is process-wide, so this must not run concurrently with tests
+// that trace.
+NONCONCURRENT_TEST(Util_Trace_Scopes)
+{
+    RecordingTraceBackend backend;
+    set_trace_backend(&backend);
+    {
+        REALM_TRACE_SCOPE("outer");
+        REALM_TRACE_SCOPE("inner");
+    }
+    set_trace_backend(nullptr);
+    {
+        REALM_TRACE_SCOPE("ignored");
+    }
+
+    if (REALM_ENABLE_TRACING)
+        CHECK_EQUAL(backend.events, "+outer+inner-inner@12-outer@6");
+    else
+        CHECK_EQUAL(backend.events, "");
+}
+
+} // unnamed namespace
@@ -176,6 +176,8 @@ public:
     std::vector<std::string> ping_messages;
     std::vector<std::string> pong_messages;
 
+    bool permessage_deflate = false;
+
     WSConfig(Pipe& pipe_in, Pipe& pipe_out, const std::shared_ptr<util::Logger>& logger_ptr)
         : m_pipe_in(pipe_in)
         , m_pipe_out(pipe_out)
@@ -193,6 +195,11 @@ public:
         return m_random;
     }
 
+    bool websocket_permessage_deflate_enabled() noexcept override
+    {
+        return permessage_deflate;
+    }
+
     void async_write(const char* data, size_t size, WriteCompletionHandler handler) override
     {
         m_pipe_out.async_write(data, size, std::move(handler));
@@ -405,6 +412,152 @@ TEST(WebSocket_Messages)
     }
 }
 
+TEST(WebSocket_LargeMessages)
+{
+    Fixture fixt{test_context.logger};
+    WSConfig& config_1 = fixt.config_1;
+    WSConfig& config_2 = fixt.config_2;
+
+    websocket::Socket& socket_1 = fixt.socket_1;
+    websocket::Socket& socket_2 = fixt.socket_2;
+
+    socket_1.initiate_client_handshake("/uri", "host", "protocol");
+    socket_2.initiate_server_handshake();
+
+    // Sizes around the boundaries of the chunks that payloads are written in, with a
+    // pattern that does not repeat with the period of the masking key.
+    std::vector<size_t> message_sizes{65535, 65536, 65537, 131072, 131075, 1000003};
+    for (size_t i = 0; i < message_sizes.size(); ++i) {
+        size_t size = message_sizes[i];
+        std::vector<char> message(size);
+        for (size_t j = 0; j < size; ++j)
+            message[j] = char(j % 251);
+        std::string str{message.data(), size};
+
+        size_t written_1 = 0, written_2 = 0;
+        // Client to server, masked
+        socket_1.async_write_binary(message.data(), size, [&](std::error_code ec, size_t n) {
+            CHECK_NOT(ec);
+            written_1 = n;
+        });
+        CHECK_GREATER(written_1, size);
+        CHECK_EQUAL(config_2.binary_messages.size(), i + 1);
+        CHECK(config_2.binary_messages[i] == str);
+        // The payload must not be modified by masking
+        CHECK(std::equal(message.begin(), message.end(), str.begin()));
+
+        // Server to client, unmasked
+        socket_2.async_write_binary(message.data(), size, [&](std::error_code ec, size_t n) {
+            CHECK_NOT(ec);
+            written_2 = n;
+        });
+        CHECK_GREATER(written_2, size);
+        CHECK_EQUAL(config_1.binary_messages.size(), i + 1);
+        CHECK(config_1.binary_messages[i] == str);
+    }
+    CHECK_EQUAL(config_1.n_protocol_errors, 0);
+    CHECK_EQUAL(config_2.n_protocol_errors, 0);
+}
+
+TEST(WebSocket_PermessageDeflate)
+{
+    Fixture fixt{test_context.logger};
+    WSConfig& config_1 = fixt.config_1;
+    WSConfig& config_2 = fixt.config_2;
+
+    websocket::Socket& socket_1 = fixt.socket_1;
+    websocket::Socket& socket_2 = fixt.socket_2;
+
+    config_1.permessage_deflate = true;
+    config_2.permessage_deflate = true;
+    socket_1.initiate_client_handshake("/uri", "host", "protocol");
+    socket_2.initiate_server_handshake();
+    CHECK_EQUAL(config_1.n_handshake_completed, 1);
+    CHECK_EQUAL(config_2.n_handshake_completed, 1);
+
+    // The window is kept across messages, so a message that repeats an earlier one is
+    // sent as a back reference that is much smaller than the message itself.
+    std::string small = "IDENT 1 2 3 0 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30";
+    for (int i = 0; i < 10; ++i) {
+        size_t written_1 = 0, written_2 = 0;
+        socket_1.async_write_text(small.data(), small.size(), [&](std::error_code ec, size_t n) {
+            CHECK_NOT(ec);
+            written_1 = n;
+        });
+        socket_2.async_write_binary(small.data(), small.size(), [&](std::error_code ec, size_t n) {
+            CHECK_NOT(ec);
+            written_2 = n;
+        });
+        if (i > 0) {
+            CHECK_LESS(written_1, small.size() / 2);
+            CHECK_LESS(written_2, small.size() / 2);
+        }
+    }
+    CHECK_EQUAL(config_2.text_messages.size(), 10);
+    CHECK_EQUAL(config_1.binary_messages.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        CHECK_EQUAL(config_2.text_messages[i], small);
+        CHECK_EQUAL(config_1.binary_messages[i], small);
+    }
+
+    // A large message that inflates to many times its compressed size
+    std::string large(1000003, 'x');
+    for (size_t i = 0; i < large.size(); i += 97)
+        large[i] = char('a' + i % 26);
+    socket_1.async_write_binary(large.data(), large.size(), [&](std::error_code ec, size_t) {
+        CHECK_NOT(ec);
+    });
+    socket_2.async_write_binary(large.data(), large.size(), [&](std::error_code ec, size_t) {
+        CHECK_NOT(ec);
+    });
+    CHECK_EQUAL(config_2.binary_messages.size(), 1);
+    CHECK(config_2.binary_messages[0] == large);
+    CHECK_EQUAL(config_1.binary_messages.size(), 11);
+    CHECK(config_1.binary_messages[10] == large);
+
+    // Fragmented messages and control messages are sent uncompressed
+    socket_1.async_write_frame(false, websocket::Opcode::text, "abc", 3, [](std::error_code, size_t) {});
+    socket_1.async_write_frame(true, websocket::Opcode::continuation, "def", 3, [](std::error_code, size_t) {});
+    socket_1.async_write_ping("ping", 4, [](std::error_code, size_t) {});
+    CHECK_EQUAL(config_2.text_messages.size(), 11);
+    CHECK_EQUAL(config_2.text_messages[10], "abcdef");
+    CHECK_EQUAL(config_2.ping_messages.size(), 1);
+
+    CHECK_EQUAL(config_1.n_protocol_errors, 0);
+    CHECK_EQUAL(config_2.n_protocol_errors, 0);
+}
+
+TEST(WebSocket_PermessageDeflate_Declined)
+{
+    Fixture fixt{test_context.logger};
+    WSConfig& config_1 = fixt.config_1;
+    WSConfig& config_2 = fixt.config_2;
+
+    websocket::Socket& socket_1 = fixt.socket_1;
+    websocket::Socket& socket_2 = fixt.socket_2;
+
+    // The server does not support the extension, so messages are sent uncompressed
+    config_1.permessage_deflate = true;
+    socket_1.initiate_client_handshake("/uri", "host", "protocol");
+    socket_2.initiate_server_handshake();
+    CHECK_EQUAL(config_1.n_handshake_completed, 1);
+    CHECK_EQUAL(config_2.n_handshake_completed, 1);
+
+    std::string message(1000, 'x');
+    for (int i = 0; i < 2; ++i) {
+        size_t written = 0;
+        socket_1.async_write_binary(message.data(), message.size(), [&](std::error_code ec, size_t n) {
+            CHECK_NOT(ec);
+            written = n;
+        });
+        CHECK_GREATER(written, message.size());
+    }
+    CHECK_EQUAL(config_2.binary_messages.size(), 2);
+    CHECK_EQUAL(config_2.binary_messages[1], message);
+    CHECK_EQUAL(config_1.n_protocol_errors, 0);
+    CHECK_EQUAL(config_2.n_protocol_errors, 0);
+}
+
 TEST(WebSocket_Fragmented_Messages)
 {
     Fixture fixt{test_context.logger};
@@ -45,6 +45,7 @@
 #define TEST_ARRAY_MIXED
 #define TEST_ARRAY_STRING
 #define TEST_ARRAY_STRING_LONG
+#define TEST_ARROW_EXPORT
 #define TEST_COLUMN
 #define TEST_COLUMN_BASIC
 #define TEST_COLUMN_BINARY
@@ -57,6 +58,8 @@
 #define TEST_GEO
 #define TEST_GROUP
 #define TEST_UPGRADE
+#define TEST_INDEX_COMPOUND
+#define TEST_INDEX_SORTED
 #define TEST_INDEX_STRING
 #define TEST_LANG_BIND_HELPER
 #define TEST_PARSER
@@ -91,6 +91,9 @@ BenchmarkResults::Result::Result()
     : min(DBL_MAX)
     , max(DBL_MIN)
     , total(0)
+    , median(0)
+    , p90(0)
+    , p99(0)
     , rep(0)
 {
 }
@@ -146,6 +149,14 @@ BenchmarkResults::Result BenchmarkResults::Measurement::finish() const
             // Odd number of elements: median is the middle element.
             r.median = samples_copy[r.rep / 2];
         }
+
+        // Nearest-rank percentiles
+        auto percentile = [&](size_t p) {
+            size_t rank = (p * r.rep + 99) / 100;
+            return samples_copy[std::max<size_t>(rank, 1) - 1];
+        };
+        r.p90 = percentile(90);
+        r.p99 = percentile(99);
     }
 
     // Calculate standard deviation
@@ -243,24 +254,42 @@ void BenchmarkResults::finish(const std::string& ident, const std::string& lead_
         out << "avg " << std::setw(time_width) << format_elapsed_time(avg) << " "
             << pad_right(format_change(baseline_avg, avg), 15) << "     ";
 
+        out << "p99 " << std::setw(time_width) << format_elapsed_time(r.p99) << "     ";
+
         out << "stddev" << std::setw(time_width) << format_elapsed_time(r.stddev) << " "
             << pad_right(format_change(br.stddev, r.stddev), 15);
+
+        if (is_regression(r, br)) {
+            out << "   REGRESSION";
+            it->second.baseline_median = br.median;
+            if (std::find(m_regressions.begin(), m_regressions.end(), ident) == m_regressions.end())
+                m_regressions.push_back(ident);
+        }
     }
     else {
         out << "min " << std::setw(time_width) << format_elapsed_time(r.min) << "     ";
         out << "max " << std::setw(time_width) << format_elapsed_time(r.max) << "     ";
         out << "median " << std::setw(time_width) << format_elapsed_time(r.median) << "     ";
         out << "avg " << std::setw(time_width) << format_elapsed_time(r.avg()) << "     ";
+        out << "p99 " << std::setw(time_width) << format_elapsed_time(r.p99) << "     ";
         out << "stddev " << std::setw(time_width) << format_elapsed_time(r.stddev);
     }
     out << std::endl;
 }
 
 
+bool BenchmarkResults::is_regression(const Result& r, const Result& baseline) const
+{
+    if (m_regression_threshold <= 0 || baseline.median <= 0)
+        return false;
+    double slowdown = r.median - baseline.median;
+    return slowdown > baseline.median * m_regression_threshold / 100 && slowdown > r.stddev * 2;
+}
+
+
 void BenchmarkResults::try_load_baseline_results()
 {
-    std::string baseline_file = m_results_file_stem;
-    baseline_file += ".baseline";
+    const std::string& baseline_file = m_baseline_file;
     if (util::File::exists(baseline_file)) {
         std::ifstream in(baseline_file.c_str());
         BaselineResults baseline_results;
@@ -287,6 +316,11 @@ void BenchmarkResults::try_load_baseline_results()
                         error = true;
                     }
                 }
+                // Percentiles are optional, as older baselines do not have them
+                if (!error && line_in >> r.p90)
+                    line_in >> r.p99;
+                if (!error && line_in.fail() && line_in.eof())
+                    line_in.clear();
             }
             else {
                 std::cerr << "Expected identifier: line " << lineno << "\n";
@@ -333,7 +367,7 @@ void BenchmarkResults::save_results()
         std::ofstream out(name.c_str());
         std::ofstream csv_out(csv_name.c_str());
 
-        csv_out << "ident,min,max,median,avg,stddev,reps,total" << '\n';
+        csv_out << "ident,min,max,median,avg,stddev,reps,total,p90,p99" << '\n';
         csv_out.setf(std::ios_base::fixed, std::ios_base::floatfield);
 
         typedef Measurements::const_iterator iter;
@@ -342,11 +376,11 @@ void BenchmarkResults::save_results()
 
             out << it->first << ' ';
             out << r.min << " " << r.max << " " << r.median << " " << r.stddev << " " << r.total << " " << r.rep
-                << '\n';
+                << " " << r.p90 << " " << r.p99 << '\n';
 
             csv_out << '"' << it->first << "\",";
             csv_out << r.min << ',' << r.max << ',' << r.median << ',' << r.avg() << ',' << r.stddev << ',' << r.rep
-                    << ',' << r.total << '\n';
+                    << ',' << r.total << ',' << r.p90 << ',' << r.p99 << '\n';
         }
     }
 
@@ -374,14 +408,21 @@ void BenchmarkResults::save_results()
                 metric_objs.push_back(make_result_obj("median", result.median));
                 metric_objs.push_back(make_result_obj("avg", result.avg()));
                 metric_objs.push_back(make_result_obj("stddev", result.stddev));
+                metric_objs.push_back(make_result_obj("p90", result.p90));
+                metric_objs.push_back(make_result_obj("p99", result.p99));
             }
 
-            test_results.push_back(json{{"info",
-                                         json{
-                                             {"test_name", measurement.first},
-                                             {"parent", m_suite_name},
-                                         }},
-                                        {"metrics", std::move(metric_objs)}});
+            json test_result{{"info",
+                              json{
+                                  {"test_name", measurement.first},
+                                  {"parent", m_suite_name},
+                              }},
+                             {"metrics", std::move(metric_objs)}};
+            if (measurement.second.baseline_median) {
+                test_result["regression"] = true;
+                test_result["baseline_median"] = *measurement.second.baseline_median;
+            }
+            test_results.push_back(std::move(test_result));
         }
 
         auto full_results_obj =
@@ -391,9 +432,8 @@ void BenchmarkResults::save_results()
         json_file_stream << full_results_obj << std::endl;
     }
 
-    std::string baseline_file = m_results_file_stem;
+    const std::string& baseline_file = m_baseline_file;
     std::string latest_csv_file = m_results_file_stem + ".latest.csv";
-    baseline_file += ".baseline";
     if (!util::File::exists(baseline_file)) {
         int r = link(name.c_str(), baseline_file.c_str());
         static_cast<void>(r); // FIXME: Display if error
@@ -19,14 +19,30 @@
 #ifndef REALM_TEST_UTIL_BENCHMARK_RESULTS_HPP
 #define REALM_TEST_UTIL_BENCHMARK_RESULTS_HPP
 
+#include <cstdlib>
 #include <vector>
 #include <map>
+#include <optional>
 #include <string>
 
+#include "timer.hpp"
+
 namespace realm {
 namespace test_util {
 
 
+/// Collects the samples of a suite of benchmarks, prints a summary of each
+/// benchmark, compares it to a baseline, and saves the results as
+/// `<results_file_stem>.<timestamp>` (which becomes the baseline if there is
+/// none), as CSV, and as JSON in `<results_file_stem>.latest.json`.
+///
+/// The baseline is read from `<results_file_stem>.baseline`, or from the file
+/// named by the environment variable `REALM_BENCHMARK_BASELINE`. A benchmark
+/// whose median is slower than the baseline by more than the regression
+/// threshold (and by more than twice the standard deviation, to ignore noise)
+/// is reported as a regression. The threshold is taken from the environment
+/// variable `REALM_BENCHMARK_REGRESSION_THRESHOLD`, in percent, and regressions
+/// are not reported if it is unset.
 class BenchmarkResults {
 public:
     BenchmarkResults(int max_lead_text_width, std::string suite_name, const char* results_file_stem = "results");
@@ -39,10 +55,44 @@ public:
     void submit(const char* ident, double seconds);
     void finish(const std::string& ident, const std::string& lead_text, std::string measurement_type);
 
+    struct Repetitions {
+        size_t min_reps = 5;
+        size_t max_reps = 1000;
+        // The measured repetitions take at least this long, unless that
+        // would take more than `max_reps`.
+        double min_duration_s = 0.5;
+        double min_warmup_time_s = 0.1;
+    };
+
+    /// Run `rep` repeatedly until `min_warmup_time_s` has passed, then as many
+    /// times as required to take `min_duration_s`, and submit the time taken
+    /// by each of the latter repetitions. `rep` is passed the Timer of the
+    /// repetition, which it may pause around the setup of the repetition.
+    /// Returns the number of submitted repetitions. Call finish() afterwards.
+    template <class F>
+    size_t measure(const std::string& ident, F&& rep, const Repetitions& = {});
+
+    /// A threshold of zero disables the reporting of regressions.
+    void set_regression_threshold(double percent) noexcept
+    {
+        m_regression_threshold = percent;
+    }
+
+    /// The identifiers of the benchmarks finished so far which regressed
+    /// against the baseline. A benchmark executable which is used to gate a
+    /// build should exit with a nonzero status if this is not empty.
+    const std::vector<std::string>& get_regressions() const noexcept
+    {
+        return m_regressions;
+    }
+
 private:
     int m_max_lead_text_width;
     std::string m_results_file_stem;
     std::string m_suite_name;
+    std::string m_baseline_file;
+    double m_regression_threshold = 0;
+    std::vector<std::string> m_regressions;
 
     struct Result {
         Result();
@@ -51,6 +101,8 @@ private:
         double total;
         double stddev;
         double median;
+        double p90;
+        double p99;
         size_t rep;
 
         double avg() const;
@@ -59,6 +111,8 @@ private:
     struct Measurement {
         std::vector<double> samples;
         std::string type;
+        // Set if the measurement regressed against the baseline
+        std::optional<double> baseline_median;
 
         Result finish() const;
     };
@@ -68,6 +122,7 @@ private:
     typedef std::map<std::string, Result> BaselineResults;
     BaselineResults m_baseline_results;
 
+    bool is_regression(const Result&, const Result& baseline) const;
     void try_load_baseline_results();
     void save_results();
 };
@@ -80,7 +135,12 @@ inline BenchmarkResults::BenchmarkResults(int max_lead_text_width, std::string s
     : m_max_lead_text_width(max_lead_text_width)
     , m_results_file_stem(results_file_stem)
     , m_suite_name(std::move(suite_name))
+    , m_baseline_file(m_results_file_stem + ".baseline")
 {
+    if (const char* baseline_file = std::getenv("REALM_BENCHMARK_BASELINE"))
+        m_baseline_file = baseline_file;
+    if (const char* threshold = std::getenv("REALM_BENCHMARK_REGRESSION_THRESHOLD"))
+        m_regression_threshold = std::atof(threshold);
     try_load_baseline_results();
 }
 
@@ -90,6 +150,36 @@ inline BenchmarkResults::~BenchmarkResults()
         save_results();
 }
 
+template <class F>
+size_t BenchmarkResults::measure(const std::string& ident, F&& rep, const Repetitions& repetitions)
+{
+    // Warm-up and initial measuring:
+    size_t num_warmup_reps = 1;
+    double time_to_execute_warmup_reps = 0;
+    while (time_to_execute_warmup_reps < repetitions.min_warmup_time_s && num_warmup_reps < repetitions.max_reps) {
+        num_warmup_reps *= 3;
+        Timer t(Timer::type_UserTime);
+        for (size_t i = 0; i < num_warmup_reps; ++i) {
+            rep(t);
+        }
+        time_to_execute_warmup_reps = t.get_elapsed_time();
+    }
+    double time_to_execute_one_rep = time_to_execute_warmup_reps / num_warmup_reps;
+    size_t required_reps = size_t(repetitions.min_duration_s / time_to_execute_one_rep);
+    if (required_reps < repetitions.min_reps) {
+        required_reps = repetitions.min_reps;
+    }
+    if (required_reps > repetitions.max_reps) {
+        required_reps = repetitions.max_reps;
+    }
+    for (size_t i = 0; i < required_reps; ++i) {
+        Timer t;
+        rep(t);
+        submit(ident.c_str(), t.get_elapsed_time());
+    }
+    return required_reps;
+}
+
 
 } // namespace test_util
 } // namespace realm